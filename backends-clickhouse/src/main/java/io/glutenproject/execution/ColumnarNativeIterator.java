@@ -19,14 +19,25 @@ package io.glutenproject.execution;
 import io.glutenproject.vectorized.CHColumnVector;
 import io.glutenproject.vectorized.GeneralInIterator;
 
+import org.apache.spark.TaskContext;
 import org.apache.spark.sql.vectorized.ColumnarBatch;
+import org.apache.spark.util.TaskCompletionListener;
 
 import java.util.Iterator;
 
 public class ColumnarNativeIterator extends GeneralInIterator implements Iterator<byte[]> {
+  // Capacity of the ring buffer the batches are pushed to native through, 0 to pull them one by one
+  private final int ringBufferCapacity;
+  private long ringBuffer = 0;
+  private Thread producer = null;
 
   public ColumnarNativeIterator(Iterator<ColumnarBatch> delegated) {
+    this(delegated, 0);
+  }
+
+  public ColumnarNativeIterator(Iterator<ColumnarBatch> delegated, int ringBufferCapacity) {
     super(delegated);
+    this.ringBufferCapacity = ringBufferCapacity;
   }
 
   private static byte[] longtoBytes(long data) {
@@ -52,4 +63,87 @@ public class ColumnarNativeIterator extends GeneralInIterator implements Iterato
       throw new IllegalStateException();
     }
   }
+
+  /**
+   * Called once by the native source. If the ring buffer is enabled, starts a thread pushing the
+   * batches into it and returns its handle, so that the source pulls them without JNI calls.
+   * Returns 0 otherwise.
+   */
+  public long ringBuffer() {
+    if (ringBufferCapacity <= 0) {
+      return 0;
+    }
+    if (ringBuffer == 0) {
+      ringBuffer = nativeCreateRingBuffer(ringBufferCapacity);
+      TaskContext context = TaskContext.get();
+      producer = new Thread(() -> produce(context), "ColumnarNativeIterator-producer");
+      producer.setDaemon(true);
+      producer.start();
+      if (context != null) {
+        context.addTaskCompletionListener(
+            new TaskCompletionListener() {
+              @Override
+              public void onTaskCompletion(TaskContext ctx) {
+                closeRingBuffer();
+              }
+            });
+      }
+    }
+    return ringBuffer;
+  }
+
+  private void produce(TaskContext context) {
+    // The delegated iterators may need the task context, e.g. to read the shuffle
+    if (context != null) {
+      TaskContext.setTaskContext(context);
+    }
+    String error = null;
+    try {
+      while (hasNext()) {
+        CHColumnVector col = (CHColumnVector) nextColumnarBatch().column(0);
+        if (!nativePush(ringBuffer, col.getBlockAddress())) {
+          break;
+        }
+      }
+    } catch (Throwable t) {
+      error = t.toString();
+    } finally {
+      nativeFinish(ringBuffer, error);
+      TaskContext.unset();
+    }
+  }
+
+  @Override
+  public void close() throws Exception {
+    closeRingBuffer();
+  }
+
+  private void closeRingBuffer() {
+    if (ringBuffer == 0) {
+      return;
+    }
+    // Wakes up the producer if it waits for the ring buffer to have room
+    nativeCancel(ringBuffer);
+    try {
+      producer.join();
+    } catch (InterruptedException e) {
+      Thread.currentThread().interrupt();
+      // The producer may still use the ring buffer, which is leaked rather than released
+      ringBuffer = 0;
+      return;
+    }
+    nativeReleaseRingBuffer(ringBuffer);
+    ringBuffer = 0;
+  }
+
+  private static native long nativeCreateRingBuffer(int capacity);
+
+  // Returns false if the native source cancelled the ring buffer
+  private static native boolean nativePush(long ringBuffer, long blockAddress);
+
+  private static native void nativeFinish(long ringBuffer, String error);
+
+  private static native void nativeCancel(long ringBuffer);
+
+  private static native void nativeReleaseRingBuffer(long ringBuffer);
 }
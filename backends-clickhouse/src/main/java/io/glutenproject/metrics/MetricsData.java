@@ -32,6 +32,18 @@ public class MetricsData {
   @JsonProperty("output_wait_time")
   protected long outputWaitTime;
 
+  @JsonProperty("eliminated_expressions")
+  protected long eliminatedExpressions;
+
+  @JsonProperty("spilled_bytes")
+  protected long spilledBytes;
+
+  @JsonProperty("current_memory_bytes")
+  protected long currentMemoryBytes;
+
+  @JsonProperty("peak_memory_bytes")
+  protected long peakMemoryBytes;
+
   protected long inputRows = 0;
   protected long inputVectors = 0;
   protected long inputBytes = 0;
@@ -135,4 +147,36 @@ public class MetricsData {
   public void setOutputWaitTime(long outputWaitTime) {
     this.outputWaitTime = outputWaitTime;
   }
+
+  public long getEliminatedExpressions() {
+    return eliminatedExpressions;
+  }
+
+  public void setEliminatedExpressions(long eliminatedExpressions) {
+    this.eliminatedExpressions = eliminatedExpressions;
+  }
+
+  public long getSpilledBytes() {
+    return spilledBytes;
+  }
+
+  public void setSpilledBytes(long spilledBytes) {
+    this.spilledBytes = spilledBytes;
+  }
+
+  public long getCurrentMemoryBytes() {
+    return currentMemoryBytes;
+  }
+
+  public void setCurrentMemoryBytes(long currentMemoryBytes) {
+    this.currentMemoryBytes = currentMemoryBytes;
+  }
+
+  public long getPeakMemoryBytes() {
+    return peakMemoryBytes;
+  }
+
+  public void setPeakMemoryBytes(long peakMemoryBytes) {
+    this.peakMemoryBytes = peakMemoryBytes;
+  }
 }
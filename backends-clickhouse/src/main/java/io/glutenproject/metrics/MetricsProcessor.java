@@ -39,6 +39,18 @@ public class MetricsProcessor {
   @JsonProperty("output_bytes")
   protected long outputBytes = 0;
 
+  @JsonProperty("pages_read")
+  protected long pagesRead = 0;
+
+  @JsonProperty("pages_skipped")
+  protected long pagesSkipped = 0;
+
+  @JsonProperty("cache_hit_bytes")
+  protected long cacheHitBytes = 0;
+
+  @JsonProperty("cache_miss_bytes")
+  protected long cacheMissBytes = 0;
+
   public String getName() {
     return name;
   }
@@ -102,4 +114,36 @@ public class MetricsProcessor {
   public void setOutputBytes(long outputBytes) {
     this.outputBytes = outputBytes;
   }
+
+  public long getPagesRead() {
+    return pagesRead;
+  }
+
+  public void setPagesRead(long pagesRead) {
+    this.pagesRead = pagesRead;
+  }
+
+  public long getPagesSkipped() {
+    return pagesSkipped;
+  }
+
+  public void setPagesSkipped(long pagesSkipped) {
+    this.pagesSkipped = pagesSkipped;
+  }
+
+  public long getCacheHitBytes() {
+    return cacheHitBytes;
+  }
+
+  public void setCacheHitBytes(long cacheHitBytes) {
+    this.cacheHitBytes = cacheHitBytes;
+  }
+
+  public long getCacheMissBytes() {
+    return cacheMissBytes;
+  }
+
+  public void setCacheMissBytes(long cacheMissBytes) {
+    this.cacheMissBytes = cacheMissBytes;
+  }
 }
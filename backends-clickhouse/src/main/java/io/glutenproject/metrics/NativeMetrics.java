@@ -24,7 +24,9 @@ import org.slf4j.LoggerFactory;
 
 import java.util.ArrayList;
 import java.util.Collections;
+import java.util.HashMap;
 import java.util.List;
+import java.util.Map;
 
 public class NativeMetrics implements IMetrics {
 
@@ -32,10 +34,29 @@ public class NativeMetrics implements IMetrics {
 
   public List<MetricsData> metricsDataList;
   public String metricsJson;
+  // Calls from native into the reservation listener of the task and the time spent in them.
+  public long reservationCalls;
+  public long reservationTimeNs;
+  // Task-wide values, e.g. the percentiles of the latency of pulling a block from the pipeline.
+  public final Map<String, Long> taskValues = new HashMap<>();
 
   public NativeMetrics(String metricsJson) {
+    this(metricsJson, 0L, 0L, new String[0], new long[0]);
+  }
+
+  public NativeMetrics(
+      String metricsJson,
+      long reservationCalls,
+      long reservationTimeNs,
+      String[] taskValueNames,
+      long[] taskValues) {
     this.metricsJson = metricsJson;
     this.metricsDataList = NativeMetrics.deserializeMetricsJson(this.metricsJson);
+    this.reservationCalls = reservationCalls;
+    this.reservationTimeNs = reservationTimeNs;
+    for (int i = 0; i < taskValueNames.length; i++) {
+      this.taskValues.put(taskValueNames[i], taskValues[i]);
+    }
   }
 
   public void setFinalOutputMetrics(long outputRowCount, long outputVectorCount) {
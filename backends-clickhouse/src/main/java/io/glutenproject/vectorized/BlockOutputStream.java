@@ -28,6 +28,9 @@ public class BlockOutputStream implements Closeable {
   private final long instance;
   private final OutputStream outputStream;
 
+  // Referenced weakly by the native writer.
+  private final NativeBufferOutputStream nativeOutputStream;
+
   private final byte[] buffer;
 
   private final int bufferSize;
@@ -57,22 +60,16 @@ public class BlockOutputStream implements Closeable {
     this.defaultCompressionCodec = defaultCompressionCodec;
     this.buffer = buffer;
     this.bufferSize = bufferSize;
+    this.nativeOutputStream = new NativeBufferOutputStream(this.outputStream, this.buffer);
     this.instance =
-        nativeCreate(
-            this.outputStream,
-            this.buffer,
-            this.defaultCompressionCodec,
-            compressionEnable,
-            this.bufferSize);
+        nativeCreate(this.nativeOutputStream, this.defaultCompressionCodec, compressionEnable);
     this.dataSize = dataSize;
   }
 
   private native long nativeCreate(
-      OutputStream outputStream,
-      byte[] buffer,
+      NativeBufferOutputStream outputStream,
       String defaultCompressionCodec,
-      boolean compressionEnable,
-      int bufferSize);
+      boolean compressionEnable);
 
   private native long nativeClose(long instance);
 
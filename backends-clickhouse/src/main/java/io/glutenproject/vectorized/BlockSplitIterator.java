@@ -25,7 +25,16 @@ public class BlockSplitIterator implements Iterator<ColumnarBatch>, AutoCloseabl
 
   private long instance = 0;
 
+  // The blocks of the current batch and their partition ids, at most one block per partition.
+  private final long[] blocks;
+  private final int[] partitionIds;
+  private int batchSize = 0;
+  private int position = 0;
+  private int partitionId = -1;
+
   public BlockSplitIterator(Iterator<Long> in, IteratorOptions options) {
+    this.blocks = new long[Math.max(1, options.getPartitionNum())];
+    this.partitionIds = new int[Math.max(1, options.getPartitionNum())];
     this.instance =
         nativeCreate(
             new IteratorWrapper(in),
@@ -46,25 +55,28 @@ public class BlockSplitIterator implements Iterator<ColumnarBatch>, AutoCloseabl
 
   private native void nativeClose(long instance);
 
-  private native boolean nativeHasNext(long instance);
+  // Fills the next batch, whose blocks stay valid until the next call. Returns its size, 0 at the end.
+  private native int nativeNextBatch(long instance, long[] blocks, int[] partitionIds);
 
   @Override
   public boolean hasNext() {
-    return nativeHasNext(instance);
+    if (position == batchSize) {
+      batchSize = nativeNextBatch(instance, blocks, partitionIds);
+      position = 0;
+    }
+    return position < batchSize;
   }
 
-  private native long nativeNext(long instance);
-
   @Override
   public ColumnarBatch next() {
-    CHNativeBlock block = new CHNativeBlock(nativeNext(instance));
+    partitionId = partitionIds[position];
+    CHNativeBlock block = new CHNativeBlock(blocks[position++]);
     return block.toColumnarBatch();
   }
 
-  private native int nativeNextPartitionId(long instance);
-
+  /** The partition of the last block returned by next. */
   public int nextPartitionId() {
-    return nativeNextPartitionId(instance);
+    return partitionId;
   }
 
   @Override
@@ -21,11 +21,22 @@ import org.apache.spark.sql.types.Decimal;
 import org.apache.spark.sql.vectorized.ColumnVector;
 import org.apache.spark.sql.vectorized.ColumnarArray;
 import org.apache.spark.sql.vectorized.ColumnarMap;
+import org.apache.spark.unsafe.Platform;
 import org.apache.spark.unsafe.types.UTF8String;
 
 public class CHColumnVector extends ColumnVector {
+  // Indices in the buffers of a column, see nativeGetBuffers.
+  private static final int DATA_ADDRESS = 0;
+  private static final int NULL_MAP_ADDRESS = 2;
+  private static final int OFFSETS_ADDRESS = 3;
+  private static final int VALUE_WIDTH = 4;
+
   private final int columnPosition;
   private long blockAddress;
+  // The native buffers the values are read from with Unsafe, null if the column isn't contiguous and is read value
+  // by value through JNI.
+  private long[] buffers;
+  private boolean buffersLoaded = false;
 
   public CHColumnVector(DataType type, long blockAddress, int columnPosition) {
     super(type);
@@ -42,6 +53,28 @@ public class CHColumnVector extends ColumnVector {
     // blockAddress = 0;
   }
 
+  /**
+   * Fills |data address|data bytes|null map address|offsets address|value width| of a numeric or string
+   * column, the null map address is 0 if the column isn't nullable and the offsets address is 0 if it isn't
+   * a string column. Returns false for the other columns.
+   */
+  private native boolean nativeGetBuffers(long blockAddress, int columnPosition, long[] buffers);
+
+  private long[] buffers() {
+    if (!buffersLoaded) {
+      long[] columnBuffers = new long[5];
+      buffers = nativeGetBuffers(blockAddress, columnPosition, columnBuffers) ? columnBuffers : null;
+      buffersLoaded = true;
+    }
+    return buffers;
+  }
+
+  // The buffers if the values are valueWidth bytes wide, a string column has 0.
+  private long[] buffers(int valueWidth) {
+    long[] b = buffers();
+    return b != null && b[VALUE_WIDTH] == valueWidth ? b : null;
+  }
+
   private native boolean nativeHasNull(long blockAddress, int columnPosition);
 
   @Override
@@ -60,6 +93,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public boolean isNullAt(int rowId) {
+    long[] b = buffers();
+    if (b != null) {
+      return b[NULL_MAP_ADDRESS] != 0 && Platform.getByte(null, b[NULL_MAP_ADDRESS] + rowId) != 0;
+    }
     return nativeIsNullAt(rowId, blockAddress, columnPosition);
   }
 
@@ -67,6 +104,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public boolean getBoolean(int rowId) {
+    long[] b = buffers(1);
+    if (b != null) {
+      return Platform.getByte(null, b[DATA_ADDRESS] + rowId) != 0;
+    }
     return nativeGetBoolean(rowId, blockAddress, columnPosition);
   }
 
@@ -74,6 +115,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public byte getByte(int rowId) {
+    long[] b = buffers(1);
+    if (b != null) {
+      return Platform.getByte(null, b[DATA_ADDRESS] + rowId);
+    }
     return nativeGetByte(rowId, blockAddress, columnPosition);
   }
 
@@ -81,6 +126,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public short getShort(int rowId) {
+    long[] b = buffers(2);
+    if (b != null) {
+      return Platform.getShort(null, b[DATA_ADDRESS] + rowId * 2L);
+    }
     return nativeGetShort(rowId, blockAddress, columnPosition);
   }
 
@@ -88,6 +137,15 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public int getInt(int rowId) {
+    long[] b = buffers(4);
+    if (b != null) {
+      return Platform.getInt(null, b[DATA_ADDRESS] + rowId * 4L);
+    }
+    b = buffers(2);
+    if (b != null) {
+      // Date is UInt16 days.
+      return Platform.getShort(null, b[DATA_ADDRESS] + rowId * 2L) & 0xFFFF;
+    }
     return nativeGetInt(rowId, blockAddress, columnPosition);
   }
 
@@ -95,6 +153,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public long getLong(int rowId) {
+    long[] b = buffers(8);
+    if (b != null) {
+      return Platform.getLong(null, b[DATA_ADDRESS] + rowId * 8L);
+    }
     return nativeGetLong(rowId, blockAddress, columnPosition);
   }
 
@@ -102,6 +164,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public float getFloat(int rowId) {
+    long[] b = buffers(4);
+    if (b != null) {
+      return Platform.getFloat(null, b[DATA_ADDRESS] + rowId * 4L);
+    }
     return nativeGetFloat(rowId, blockAddress, columnPosition);
   }
 
@@ -109,6 +175,10 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public double getDouble(int rowId) {
+    long[] b = buffers(8);
+    if (b != null) {
+      return Platform.getDouble(null, b[DATA_ADDRESS] + rowId * 8L);
+    }
     return nativeGetDouble(rowId, blockAddress, columnPosition);
   }
 
@@ -131,6 +201,13 @@ public class CHColumnVector extends ColumnVector {
 
   @Override
   public UTF8String getUTF8String(int rowId) {
+    long[] b = buffers(0);
+    if (b != null && b[OFFSETS_ADDRESS] != 0) {
+      // Row i ends at offsets[i], with a terminating zero byte, and offsets[-1] is 0.
+      long start = Platform.getLong(null, b[OFFSETS_ADDRESS] + (rowId - 1) * 8L);
+      long end = Platform.getLong(null, b[OFFSETS_ADDRESS] + rowId * 8L);
+      return UTF8String.fromAddress(null, b[DATA_ADDRESS] + start, (int) (end - start - 1));
+    }
     return UTF8String.fromString(nativeGetString(rowId, blockAddress, columnPosition));
   }
 
@@ -29,7 +29,8 @@ public class CHShuffleSplitterJniWrapper {
       String codec,
       String dataFile,
       String localDirs,
-      int subDirsPerLocalDir) {
+      int subDirsPerLocalDir,
+      boolean preferSpill) {
     return nativeMake(
         part.getShortName(),
         part.getNumPartitions(),
@@ -41,7 +42,8 @@ public class CHShuffleSplitterJniWrapper {
         codec,
         dataFile,
         localDirs,
-        subDirsPerLocalDir);
+        subDirsPerLocalDir,
+        preferSpill);
   }
 
   public native long nativeMake(
@@ -55,9 +57,14 @@ public class CHShuffleSplitterJniWrapper {
       String codec,
       String dataFile,
       String localDirs,
-      int subDirsPerLocalDir);
+      int subDirsPerLocalDir,
+      boolean preferSpill);
 
-  public native void split(long splitterId, int numRows, long block);
+  /** Returns the bytes buffered by the splitter after the split. */
+  public native long split(long splitterId, int numRows, long block);
+
+  /** Spills the largest partitions to release at least size bytes, returns the bytes released. */
+  public native long evict(long splitterId, long size);
 
   public native SplitResult stop(long splitterId) throws IOException;
 
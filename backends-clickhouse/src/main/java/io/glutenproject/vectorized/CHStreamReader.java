@@ -40,13 +40,24 @@ public class CHStreamReader implements AutoCloseable {
         CHShuffleReadStreamFactory.create(
             inputStream, forceCompress, isCustomizedShuffleCodec, bufferSize);
     this.compressed = this.inputStream.isCompressed();
-    nativeShuffleReader =
-        createNativeShuffleReader(this.inputStream, this.compressed, this.bufferSize);
+    long address = this.inputStream.directAddress();
+    if (address != 0) {
+      nativeShuffleReader =
+          createNativeShuffleReaderFromMemory(
+              address, this.inputStream.directSize(), this.compressed);
+    } else {
+      nativeShuffleReader =
+          createNativeShuffleReader(this.inputStream, this.compressed, this.bufferSize);
+    }
   }
 
   private static native long createNativeShuffleReader(
       ShuffleInputStream inputStream, boolean compressed, int bufferSize);
 
+  // Reads the memory in place, which must stay valid until the reader is closed.
+  private static native long createNativeShuffleReaderFromMemory(
+      long address, long size, boolean compressed);
+
   private native long nativeNext(long nativeShuffleReader);
 
   public CHNativeBlock next() {
@@ -58,9 +69,9 @@ public class CHStreamReader implements AutoCloseable {
 
   @Override
   public void close() throws Exception {
-    // close input stream and release buffer
-    this.inputStream.close();
+    // The native reader may still point into the input's memory, so it goes first.
     nativeClose(nativeShuffleReader);
     nativeShuffleReader = 0L;
+    this.inputStream.close();
   }
 }
@@ -21,15 +21,20 @@ import io.glutenproject.exception.GlutenException;
 import io.netty.util.internal.PlatformDependent;
 import org.apache.spark.network.util.LimitedInputStream;
 import org.apache.spark.storage.CHShuffleReadStreamFactory;
+import org.apache.spark.storage.StorageUtils;
 
 import java.io.FileInputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.nio.ByteBuffer;
+import java.nio.MappedByteBuffer;
 import java.nio.channels.FileChannel;
 
 public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream {
 
+  // Same as the default spark.storage.memoryMapThreshold, smaller segments are cheaper to read.
+  private static final long MEMORY_MAP_THRESHOLD = 2L * 1024 * 1024;
+
   private final InputStream in;
   private final LimitedInputStream limitedInputStream;
   private final FileChannel channel;
@@ -38,6 +43,7 @@ public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream
 
   private long bytesRead = 0L;
   private long left;
+  private MappedByteBuffer mapped = null;
 
   public LowCopyFileSegmentShuffleInputStream(
       InputStream in, InputStream limitedInputStream, int bufferSize, boolean isCompressed) {
@@ -83,6 +89,26 @@ public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream
     }
   }
 
+  @Override
+  public long directAddress() {
+    if (mapped == null) {
+      if (left < MEMORY_MAP_THRESHOLD || left > Integer.MAX_VALUE) {
+        return 0;
+      }
+      try {
+        mapped = channel.map(FileChannel.MapMode.READ_ONLY, channel.position(), left);
+      } catch (IOException e) {
+        throw new GlutenException(e);
+      }
+    }
+    return PlatformDependent.directBufferAddress(mapped);
+  }
+
+  @Override
+  public long directSize() {
+    return mapped == null ? 0 : mapped.capacity();
+  }
+
   @Override
   public long pos() {
     return bytesRead;
@@ -95,6 +121,10 @@ public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream
 
   @Override
   public void close() {
+    if (mapped != null) {
+      StorageUtils.dispose(mapped);
+      mapped = null;
+    }
     try {
       channel.close();
       in.close();
@@ -57,6 +57,19 @@ public class LowCopyNettyShuffleInputStream implements ShuffleInputStream {
     return direct.position();
   }
 
+  @Override
+  public long directAddress() {
+    if (!byteBuf.hasMemoryAddress()) {
+      return 0;
+    }
+    return byteBuf.memoryAddress() + byteBuf.readerIndex();
+  }
+
+  @Override
+  public long directSize() {
+    return byteBuf.readableBytes();
+  }
+
   @Override
   public long pos() {
     return readBytesCount;
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.glutenproject.vectorized;
+
+import io.netty.util.internal.PlatformDependent;
+
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+
+/**
+ * The stream the native writers write their buffers to, handed by address. A file is written
+ * straight from the native buffer through its channel, other streams are written through a
+ * byte[] the buffer is copied into.
+ */
+public class NativeBufferOutputStream extends OutputStream {
+  private final OutputStream out;
+  private final FileChannel channel;
+  private final byte[] buffer;
+
+  public NativeBufferOutputStream(OutputStream out, byte[] buffer) {
+    this.out = out;
+    this.channel = out instanceof FileOutputStream ? ((FileOutputStream) out).getChannel() : null;
+    this.buffer = buffer;
+  }
+
+  /** Called by the native writers. */
+  public void write(long address, int length) throws IOException {
+    if (channel != null) {
+      ByteBuffer direct = PlatformDependent.directBuffer(address, length);
+      while (direct.hasRemaining()) {
+        channel.write(direct);
+      }
+      return;
+    }
+    for (int written = 0; written < length; ) {
+      int n = Math.min(length - written, buffer.length);
+      PlatformDependent.copyMemory(address + written, buffer, 0, n);
+      out.write(buffer, 0, n);
+      written += n;
+    }
+  }
+
+  @Override
+  public void write(int b) throws IOException {
+    out.write(b);
+  }
+
+  @Override
+  public void write(byte[] b, int off, int len) throws IOException {
+    out.write(b, off, len);
+  }
+
+  @Override
+  public void flush() throws IOException {
+    out.flush();
+  }
+
+  @Override
+  public void close() throws IOException {
+    out.close();
+  }
+}
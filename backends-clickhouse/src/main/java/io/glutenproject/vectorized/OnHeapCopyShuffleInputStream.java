@@ -20,12 +20,16 @@ import io.glutenproject.exception.GlutenException;
 
 import io.netty.util.internal.PlatformDependent;
 
+import java.io.FileInputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.channels.FileChannel;
 
 public class OnHeapCopyShuffleInputStream implements ShuffleInputStream {
 
   private InputStream in;
+  // Reads a file straight into the native buffer, without the copy through the heap.
+  private final FileChannel channel;
   private final boolean isCompressed;
   private int bufferSize;
   private long bytesRead = 0L;
@@ -34,6 +38,7 @@ public class OnHeapCopyShuffleInputStream implements ShuffleInputStream {
 
   public OnHeapCopyShuffleInputStream(InputStream in, int bufferSize, boolean isCompressed) {
     this.in = in;
+    this.channel = in instanceof FileInputStream ? ((FileInputStream) in).getChannel() : null;
     this.bufferSize = bufferSize;
     this.isCompressed = isCompressed;
     this.buffer = new byte[this.bufferSize];
@@ -42,6 +47,18 @@ public class OnHeapCopyShuffleInputStream implements ShuffleInputStream {
   @Override
   public long read(long destAddress, long maxReadSize) {
     int maxReadSize32 = Math.toIntExact(maxReadSize);
+    if (channel != null) {
+      try {
+        int read = channel.read(PlatformDependent.directBuffer(destAddress, maxReadSize32));
+        if (read <= 0) {
+          return 0;
+        }
+        bytesRead += read;
+        return read;
+      } catch (IOException e) {
+        throw new GlutenException(e);
+      }
+    }
     if (maxReadSize32 > this.bufferSize) {
       this.bufferSize = maxReadSize32;
       this.buffer = new byte[this.bufferSize];
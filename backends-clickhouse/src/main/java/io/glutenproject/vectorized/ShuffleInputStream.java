@@ -27,6 +27,21 @@ public interface ShuffleInputStream {
 
   boolean isCompressed();
 
+  /**
+   * Off-heap address of the rest of this stream if it's already in native memory, read in place by
+   * the native reader instead of through read. Valid until close.
+   *
+   * @return 0 if the stream can only be read through read.
+   */
+  default long directAddress() {
+    return 0;
+  }
+
+  /** Number of bytes at directAddress. */
+  default long directSize() {
+    return 0;
+  }
+
   /** Position of this stream. */
   long pos();
 
@@ -39,6 +39,9 @@ public class StorageJoinBuilder implements AutoCloseable {
 
   public static native long nativeCloneBuildHashTable(long hashTableData);
 
+  /** Memory held by the hash table, shared with its clones. */
+  public static native long nativeHashTableBytes(long hashTableData);
+
   private ShuffleInputStream in;
 
   private int customizeBufferSize;
@@ -23,7 +23,11 @@ public class CHDatasourceJniWrapper {
 
   public native void write(long instanceId, long blockAddress);
 
-  public native void close(long instanceId);
+  /** The estimated encoded bytes of the file so far. */
+  public native long writtenBytes(long instanceId);
+
+  /** Returns the column statistics of the file as JSON, empty if not collected. */
+  public native String close(long instanceId);
 
   /*-
    * The input block is already sorted by partition columns + bucket expressions. (check
@@ -72,6 +72,26 @@ object CHBackendSettings extends BackendSettingsApi with Logging {
   // unit: SECONDS, default 1 day
   val GLUTEN_CLICKHOUSE_BROADCAST_CACHE_EXPIRED_TIME_DEFAULT: Int = 86400
 
+  // Tables are evicted beyond, the least recently used first.
+  val GLUTEN_CLICKHOUSE_BROADCAST_CACHE_MAX_BYTES: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + GlutenConfig.GLUTEN_CLICKHOUSE_BACKEND +
+      ".broadcast.cache.max.bytes"
+  val GLUTEN_CLICKHOUSE_BROADCAST_CACHE_MAX_BYTES_DEFAULT: String = "8g"
+
+  // Capacity of the ring buffer a thread pushes the input batches of a task to the native pipeline
+  // through, instead of the pipeline pulling each of them through JNI. 0 disables it.
+  val GLUTEN_CLICKHOUSE_INPUT_RING_BUFFER_CAPACITY: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + GlutenConfig.GLUTEN_CLICKHOUSE_BACKEND +
+      ".input.ring.buffer.capacity"
+  val GLUTEN_CLICKHOUSE_INPUT_RING_BUFFER_CAPACITY_DEFAULT: Int = 0
+
+  // Keep the shuffle partition buffers in memory, as long as Spark grants it, rather than spilling
+  // each partition once it buffers a batch of rows.
+  val GLUTEN_CLICKHOUSE_SHUFFLE_CACHE_PARTITION_BUFFERS: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + GlutenConfig.GLUTEN_CLICKHOUSE_BACKEND +
+      ".shuffle.cache.partition.buffers"
+  val GLUTEN_CLICKHOUSE_SHUFFLE_CACHE_PARTITION_BUFFERS_DEFAULT = false
+
   val GLUTNE_CLICKHOUSE_SHUFFLE_SUPPORTED_CODEC: Set[String] = Set("lz4", "zstd", "snappy")
 
   override def supportFileFormatRead(
@@ -120,6 +140,8 @@ object CHBackendSettings extends BackendSettingsApi with Logging {
     false
   }
 
+  override def supportBroadcastNestedLoopJoinExec(): Boolean = true
+
   override def supportWindowExec(windowFunctions: Seq[NamedExpression]): Boolean = {
     var allSupported = true
     breakable {
@@ -56,6 +56,14 @@ class CHContextApi extends ContextApi with Logging {
       s"${CHBackendSettings.getBackendConfigPrefix()}.runtime_config" +
         s".local_engine.settings.log_processors_profiles",
       "true")
+    // Aggregations and sorts spill to the local dirs of Spark, unless a temporary path is set.
+    val tmpPathKey = s"${CHBackendSettings.getBackendConfigPrefix()}.runtime_config.tmp_path"
+    if (!conf.contains(tmpPathKey)) {
+      val localDirs = Option(System.getenv("LOCAL_DIRS"))
+        .orElse(Option(System.getenv("SPARK_LOCAL_DIRS")))
+        .getOrElse(conf.get("spark.local.dir", System.getProperty("java.io.tmpdir")))
+      conf.set(tmpPathKey, localDirs.split(",").head + "/gluten-ch-tmp")
+    }
 
     // Load supported hive/python/scala udfs
     UDFMappings.loadFromSparkConf(conf)
@@ -20,13 +20,14 @@ import io.glutenproject.{GlutenConfig, GlutenNumaBindingInfo}
 import io.glutenproject.backendsapi.IteratorApi
 import io.glutenproject.execution._
 import io.glutenproject.metrics.{GlutenTimeMetric, IMetrics, NativeMetrics}
+import io.glutenproject.sql.shims.SparkShimLoader
 import io.glutenproject.substrait.plan.PlanNode
 import io.glutenproject.substrait.rel.{ExtensionTableBuilder, LocalFilesBuilder}
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 import io.glutenproject.utils.{LogLevelUtil, SubstraitPlanPrinterUtil}
 import io.glutenproject.vectorized.{CHNativeExpressionEvaluator, CloseableCHColumnBatchIterator, GeneralInIterator, GeneralOutIterator}
 
-import org.apache.spark.{InterruptibleIterator, Partition, SparkConf, SparkContext, TaskContext}
+import org.apache.spark.{InterruptibleIterator, Partition, SparkConf, SparkContext, SparkEnv, TaskContext}
 import org.apache.spark.broadcast.Broadcast
 import org.apache.spark.internal.Logging
 import org.apache.spark.rdd.RDD
@@ -48,6 +49,10 @@ import scala.collection.mutable
 
 class CHIteratorApi extends IteratorApi with Logging with LogLevelUtil {
 
+  private def inputRingBufferCapacity: Int = SparkEnv.get.conf.getInt(
+    CHBackendSettings.GLUTEN_CLICKHOUSE_INPUT_RING_BUFFER_CAPACITY,
+    CHBackendSettings.GLUTEN_CLICKHOUSE_INPUT_RING_BUFFER_CAPACITY_DEFAULT)
+
   /**
    * Generate native row partition.
    *
@@ -65,18 +70,28 @@ class CHIteratorApi extends IteratorApi with Logging with LogLevelUtil {
           case p: GlutenMergeTreePartition =>
             (
               ExtensionTableBuilder
-                .makeExtensionTable(p.minParts, p.maxParts, p.database, p.table, p.tablePath),
+                .makeExtensionTable(
+                  p.minParts,
+                  p.maxParts,
+                  p.database,
+                  p.table,
+                  p.tablePath,
+                  p.beginMark,
+                  p.endMark),
               SoftAffinityUtil.getNativeMergeTreePartitionLocations(p))
           case f: FilePartition =>
             val paths = new util.ArrayList[String]()
             val starts = new util.ArrayList[JLong]()
             val lengths = new util.ArrayList[JLong]()
+            val modificationTimes = new util.ArrayList[JLong]()
             val partitionColumns = mutable.ArrayBuffer.empty[Map[String, String]]
             f.files.foreach {
               file =>
                 paths.add(new URI(file.filePath).toASCIIString)
                 starts.add(JLong.valueOf(file.start))
                 lengths.add(JLong.valueOf(file.length))
+                modificationTimes.add(
+                  JLong.valueOf(SparkShimLoader.getSparkShims.getModificationTime(file)))
                 // TODO: Support custom partition location
                 val partitionColumn = mutable.Map.empty[String, String]
                 partitionColumns.append(partitionColumn.toMap)
@@ -87,6 +102,7 @@ class CHIteratorApi extends IteratorApi with Logging with LogLevelUtil {
                 paths,
                 starts,
                 lengths,
+                modificationTimes,
                 partitionColumns.map(_.asJava).asJava,
                 fileFormats(i)),
               SoftAffinityUtil.getFilePartitionLocations(f))
@@ -124,7 +140,10 @@ class CHIteratorApi extends IteratorApi with Logging with LogLevelUtil {
       _ =>
         val transKernel = new CHNativeExpressionEvaluator()
         val inBatchIters = new util.ArrayList[GeneralInIterator](inputIterators.map {
-          iter => new ColumnarNativeIterator(genCloseableColumnBatchIterator(iter).asJava)
+          iter =>
+            new ColumnarNativeIterator(
+              genCloseableColumnBatchIterator(iter).asJava,
+              inputRingBufferCapacity)
         }.asJava)
         transKernel.createKernelWithBatchIterator(
           inputPartition.plan,
@@ -182,7 +201,10 @@ class CHIteratorApi extends IteratorApi with Logging with LogLevelUtil {
         val transKernel = new CHNativeExpressionEvaluator()
         val columnarNativeIterator =
           new java.util.ArrayList[GeneralInIterator](inputIterators.map {
-            iter => new ColumnarNativeIterator(genCloseableColumnBatchIterator(iter).asJava)
+            iter =>
+              new ColumnarNativeIterator(
+                genCloseableColumnBatchIterator(iter).asJava,
+                inputRingBufferCapacity)
           }.asJava)
         // we need to complete dependency RDD's firstly
         transKernel.createKernelWithBatchIterator(
@@ -105,7 +105,14 @@ class CHMetricsApi extends MetricsApi with Logging with LogLevelUtil {
       "pruningTime" ->
         SQLMetrics.createTimingMetric(sparkContext, "dynamic partition pruning time"),
       "numOutputRows" -> SQLMetrics.createMetric(sparkContext, "number of output rows"),
-      "extraTime" -> SQLMetrics.createTimingMetric(sparkContext, "extra operators time")
+      "extraTime" -> SQLMetrics.createTimingMetric(sparkContext, "extra operators time"),
+      "pagesRead" -> SQLMetrics.createMetric(sparkContext, "number of filter column pages read"),
+      "pagesSkipped" ->
+        SQLMetrics.createMetric(sparkContext, "number of filter column pages skipped"),
+      "cacheHitBytes" -> SQLMetrics.createSizeMetric(sparkContext, "bytes read from local cache"),
+      "cacheMissBytes" ->
+        SQLMetrics.createSizeMetric(sparkContext, "bytes read from remote into local cache"),
+      "peakMemoryBytes" -> SQLMetrics.createSizeMetric(sparkContext, "peak memory bytes")
     )
 
   override def genFileSourceScanTransformerMetricsUpdater(
@@ -137,6 +144,8 @@ class CHMetricsApi extends MetricsApi with Logging with LogLevelUtil {
       "extraTime" -> SQLMetrics.createTimingMetric(sparkContext, "extra operators time"),
       "inputWaitTime" -> SQLMetrics.createTimingMetric(sparkContext, "time of waiting for data"),
       "outputWaitTime" -> SQLMetrics.createTimingMetric(sparkContext, "time of waiting for output"),
+      "eliminatedExpressions" ->
+        SQLMetrics.createMetric(sparkContext, "number of repeated expressions computed once"),
       "totalTime" -> SQLMetrics.createTimingMetric(sparkContext, "total time")
     )
 
@@ -162,6 +171,7 @@ class CHMetricsApi extends MetricsApi with Logging with LogLevelUtil {
         SQLMetrics.createTimingMetric(sparkContext, "time of postProjection"),
       "iterReadTime" ->
         SQLMetrics.createTimingMetric(sparkContext, "time of reading from iterator"),
+      "spilledBytes" -> SQLMetrics.createSizeMetric(sparkContext, "number of spilled bytes"),
       "totalTime" -> SQLMetrics.createTimingMetric(sparkContext, "total time")
     )
 
@@ -267,6 +277,7 @@ class CHMetricsApi extends MetricsApi with Logging with LogLevelUtil {
       "extraTime" -> SQLMetrics.createTimingMetric(sparkContext, "extra operators time"),
       "inputWaitTime" -> SQLMetrics.createTimingMetric(sparkContext, "time of waiting for data"),
       "outputWaitTime" -> SQLMetrics.createTimingMetric(sparkContext, "time of waiting for output"),
+      "spilledBytes" -> SQLMetrics.createSizeMetric(sparkContext, "number of spilled bytes"),
       "totalTime" -> SQLMetrics.createTimingMetric(sparkContext, "total time")
     )
 
@@ -321,7 +332,10 @@ class CHMetricsApi extends MetricsApi with Logging with LogLevelUtil {
       "fillingRightJoinSideTime" -> SQLMetrics.createTimingMetric(
         sparkContext,
         "filling right join side time"),
-      "conditionTime" -> SQLMetrics.createTimingMetric(sparkContext, "join condition time")
+      "conditionTime" -> SQLMetrics.createTimingMetric(sparkContext, "join condition time"),
+      "spilledBytes" -> SQLMetrics.createSizeMetric(sparkContext, "number of spilled bytes"),
+      "peakMemoryBytes" -> SQLMetrics.createSizeMetric(sparkContext, "peak memory bytes"),
+      "buildSideSwapped" -> SQLMetrics.createMetric(sparkContext, "build side swapped at runtime")
     )
 
   override def genHashJoinTransformerMetricsUpdater(
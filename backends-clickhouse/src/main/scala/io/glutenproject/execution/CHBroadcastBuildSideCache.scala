@@ -19,16 +19,60 @@ package io.glutenproject.execution
 import io.glutenproject.backendsapi.clickhouse.CHBackendSettings
 import io.glutenproject.vectorized.StorageJoinBuilder
 
-import org.apache.spark.SparkEnv
+import org.apache.spark.{SparkEnv, TaskContext}
 import org.apache.spark.broadcast.Broadcast
 import org.apache.spark.internal.Logging
 import org.apache.spark.sql.execution.joins.{BuildSideRelation, ClickHouseBuildSideRelation}
 
 import com.github.benmanes.caffeine.cache.{Cache, Caffeine, RemovalCause, RemovalListener}
 
-import java.util.concurrent.TimeUnit
+import java.util.concurrent.{ConcurrentHashMap, TimeUnit}
 
-case class BroadcastHashTable(pointer: Long, relation: ClickHouseBuildSideRelation)
+class BroadcastHashTable(
+    val pointer: Long,
+    val relation: ClickHouseBuildSideRelation,
+    val bytes: Long) {
+  // Tasks running with the table, which is only cleaned once they all finish.
+  private var refCount = 0
+  private var removed = false
+  // Tasks that have used the table since it was built.
+  private var numTasks = 0L
+
+  /** False if the table has been removed from the cache. */
+  def acquire(): Boolean = synchronized {
+    if (removed) {
+      false
+    } else {
+      refCount += 1
+      numTasks += 1
+      true
+    }
+  }
+
+  /** True if the table is to be cleaned, by the last task using it after it's removed. */
+  def release(): Boolean = synchronized {
+    refCount -= 1
+    removed && refCount == 0
+  }
+
+  /** True if the table is to be cleaned, as no task is using it. */
+  def remove(): Boolean = synchronized {
+    removed = true
+    refCount == 0
+  }
+
+  /** True if the table is to be cleaned, as no task is using it. Otherwise it stays pinned. */
+  def removeIfUnused(): Boolean = synchronized {
+    if (removed || refCount > 0) {
+      false
+    } else {
+      removed = true
+      true
+    }
+  }
+
+  def reuseCount: Long = synchronized(numTasks)
+}
 
 /**
  * `CHBroadcastBuildSideCache` is used for controlling to build bhj hash table once.
@@ -46,53 +90,175 @@ object CHBroadcastBuildSideCache extends Logging with RemovalListener[String, Br
     CHBackendSettings.GLUTEN_CLICKHOUSE_BROADCAST_CACHE_EXPIRED_TIME_DEFAULT
   )
 
+  private lazy val maxBytes = SparkEnv.get.conf.getSizeAsBytes(
+    CHBackendSettings.GLUTEN_CLICKHOUSE_BROADCAST_CACHE_MAX_BYTES,
+    CHBackendSettings.GLUTEN_CLICKHOUSE_BROADCAST_CACHE_MAX_BYTES_DEFAULT
+  )
+
+  // Times a task looks the table up again after it was evicted before the task could acquire it.
+  private val maxAcquireAttempts = 3
+
   // Use for controlling to build bhj hash table once.
   // key: hashtable id, value is hashtable backend pointer(long to string).
+  // Weighed in KiB, so that tables of more than 2GB aren't underweighted.
   private val buildSideRelationCache: Cache[String, BroadcastHashTable] =
     Caffeine.newBuilder
       .expireAfterAccess(expiredTime, TimeUnit.SECONDS)
+      .maximumWeight(maxBytes >> 10)
+      .weigher[String, BroadcastHashTable](
+        (_: String, table: BroadcastHashTable) => math.max(1L, table.bytes >> 10).toInt)
       .removalListener(this)
       .build[String, BroadcastHashTable]()
 
-  def getOrBuildBroadcastHashTable(
+  // Tables larger than the cache, which would be evicted as soon as they are admitted. They are
+  // kept outside of it while tasks run with them, and cleaned when the last of those finishes.
+  private val oversizedTables = new ConcurrentHashMap[String, BroadcastHashTable]()
+
+  // Tables removed from the cache while tasks still run with them.
+  private val removedTables = new ConcurrentHashMap[String, BroadcastHashTable]()
+
+  /**
+   * Builds the table of the broadcast relation. Unless the cache is to own it, the relation is
+   * detached from the table, so that building again doesn't return the same one.
+   */
+  private def buildTable(
+      broadcast: Broadcast[BuildSideRelation],
+      broadCastContext: BroadCastHashJoinContext,
+      forTask: Boolean): BroadcastHashTable = {
+    val buildSide = broadcast.value.asInstanceOf[ClickHouseBuildSideRelation]
+    buildSide.synchronized {
+      val (pointer, relation) = buildSide.buildHashTable(broadCastContext)
+      val bytes = StorageJoinBuilder.nativeHashTableBytes(pointer)
+      logInfo(
+        s"Built bhj ${broadCastContext.buildHashTableId} = 0x${pointer.toHexString} " +
+          s"of $bytes bytes")
+      if (forTask || bytes > maxBytes) {
+        relation.reset()
+        new BroadcastHashTable(pointer, null, bytes)
+      } else {
+        new BroadcastHashTable(pointer, relation, bytes)
+      }
+    }
+  }
+
+  /** The cached table, or the oversized one if it's too large for the cache. */
+  private def lookup(
       broadcast: Broadcast[BuildSideRelation],
       broadCastContext: BroadCastHashJoinContext): BroadcastHashTable = {
+    val id = broadCastContext.buildHashTableId
+    // Caffeine runs the builder once for concurrent tasks of the same table. Returning null from
+    // it records no entry.
+    val cached = buildSideRelationCache.get(
+      id,
+      (_: String) => {
+        if (oversizedTables.containsKey(id)) {
+          null
+        } else {
+          val table = buildTable(broadcast, broadCastContext, forTask = false)
+          if (table.bytes > maxBytes) {
+            logInfo(s"Keep bhj $id of ${table.bytes} bytes out of the cache of $maxBytes bytes")
+            oversizedTables.put(id, table)
+            null
+          } else {
+            table
+          }
+        }
+      }
+    )
+    Option(cached).getOrElse(oversizedTables.get(id))
+  }
 
-    buildSideRelationCache
-      .get(
-        broadCastContext.buildHashTableId,
-        (broadcast_id: String) => {
-          val (pointer, relation) =
-            broadcast.value
-              .asInstanceOf[ClickHouseBuildSideRelation]
-              .buildHashTable(broadCastContext)
-          threadLog(s"create bhj $broadcast_id = 0x${pointer.toHexString}")
-          BroadcastHashTable(pointer, relation)
+  def getOrBuildBroadcastHashTable(
+      broadcast: Broadcast[BuildSideRelation],
+      broadCastContext: BroadCastHashJoinContext): BroadcastHashTable = {
+    val id = broadCastContext.buildHashTableId
+    val taskContext = TaskContext.get()
+    if (taskContext == null) {
+      return lookup(broadcast, broadCastContext)
+    }
+    // Look up again if the table was evicted between the lookup and here, up to
+    // maxAcquireAttempts times. Then build one for the task only.
+    val table = Iterator
+      .continually(lookup(broadcast, broadCastContext))
+      .take(maxAcquireAttempts)
+      .find(table => table != null && table.acquire())
+      .getOrElse {
+        logWarning(s"Build bhj $id for task ${taskContext.taskAttemptId()} only")
+        val table = buildTable(broadcast, broadCastContext, forTask = true)
+        table.acquire()
+        removedTables.put(id, table)
+        table.remove()
+        table
+      }
+    taskContext.addTaskCompletionListener[Unit] {
+      _ =>
+        if (table.release()) {
+          removedTables.remove(id, table)
+          clean(id, table)
+        } else if ((oversizedTables.get(id) eq table) && table.removeIfUnused()) {
+          oversizedTables.remove(id, table)
+          clean(id, table)
         }
-      )
+    }
+    table
   }
 
   /** This is callback from c++ backend. */
   def get(broadcastHashtableId: String): Long =
     Option(buildSideRelationCache.getIfPresent(broadcastHashtableId))
+      .orElse(Option(oversizedTables.get(broadcastHashtableId)))
+      .orElse(Option(removedTables.get(broadcastHashtableId)))
       .map(_.pointer)
       .getOrElse(0)
 
+  /** Number of tasks that have used the cached table, only used in UT. */
+  def reuseCount(broadcastHashtableId: String): Long =
+    Option(buildSideRelationCache.getIfPresent(broadcastHashtableId))
+      .orElse(Option(oversizedTables.get(broadcastHashtableId)))
+      .map(_.reuseCount)
+      .getOrElse(0)
+
   def invalidateBroadcastHashtable(broadcastHashtableId: String): Unit = {
     // Cleanup operations on the backend are idempotent.
     buildSideRelationCache.invalidate(broadcastHashtableId)
+    Option(oversizedTables.remove(broadcastHashtableId))
+      .foreach(removeOversized(broadcastHashtableId, _))
   }
 
   /** Only used in UT. */
   def size(): Long = buildSideRelationCache.estimatedSize()
 
-  def cleanAll(): Unit = buildSideRelationCache.invalidateAll()
+  def cleanAll(): Unit = {
+    buildSideRelationCache.invalidateAll()
+    oversizedTables.keySet().forEach(
+      id => Option(oversizedTables.remove(id)).foreach(removeOversized(id, _)))
+  }
+
+  /** Cleans the table, or once the tasks running with it finish. */
+  private def removeOversized(key: String, value: BroadcastHashTable): Unit = {
+    removedTables.put(key, value)
+    if (value.remove()) {
+      removedTables.remove(key, value)
+      clean(key, value)
+    }
+  }
 
   override def onRemoval(key: String, value: BroadcastHashTable, cause: RemovalCause): Unit = {
-    threadLog(s"remove bhj $key = 0x${value.pointer.toHexString}")
+    logInfo(
+      s"Remove bhj $key = 0x${value.pointer.toHexString} ($cause), " +
+        s"used by ${value.reuseCount} tasks")
     if (value.relation != null) {
       value.relation.reset()
     }
+    removedTables.put(key, value)
+    if (value.remove()) {
+      removedTables.remove(key, value)
+      clean(key, value)
+    }
+  }
+
+  private def clean(key: String, value: BroadcastHashTable): Unit = {
+    threadLog(s"clean bhj $key = 0x${value.pointer.toHexString}")
     StorageJoinBuilder.nativeCleanBuildHashTable(key, value.pointer)
   }
 }
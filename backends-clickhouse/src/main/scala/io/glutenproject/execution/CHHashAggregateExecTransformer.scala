@@ -30,7 +30,7 @@ import org.apache.spark.sql.execution._
 import org.apache.spark.sql.execution.aggregate.BaseAggregateExec
 import org.apache.spark.sql.types.{DataType, StructField, StructType}
 
-import com.google.protobuf.Any
+import com.google.protobuf.{Any, StringValue}
 
 import java.util
 
@@ -271,11 +271,14 @@ case class CHHashAggregateExecTransformer(
         aggregateFunctionList.add(aggFunctionNode)
       })
     if (!validation) {
+      val extensionNode =
+        ExtensionBuilder.makeAdvancedExtension(genAggregateParametersBuilder().build(), null)
       RelBuilder.makeAggregateRel(
         input,
         groupingList,
         aggregateFunctionList,
         aggFilterList,
+        extensionNode,
         context,
         operatorId)
     } else {
@@ -299,6 +302,39 @@ case class CHHashAggregateExecTransformer(
 
   override def isStreaming: Boolean = false
 
+  // The groups each task aggregates, estimated from the row counts of the logical plans, 0 if
+  // unknown. Below adaptive execution the row counts of the finished query stages are the runtime
+  // ones. A partial aggregation sees all the groups of the rows of its task, a final one its share
+  // of the groups.
+  def estimatedGroupsPerTask: Long = {
+    val numPartitions = BigInt(math.max(1, child.outputPartitioning.numPartitions))
+    val groups = logicalLink.flatMap(_.stats.rowCount)
+    val inputRows =
+      child.find(_.logicalLink.isDefined).flatMap(_.logicalLink).flatMap(_.stats.rowCount)
+    val estimated = if (modes.contains(Partial)) {
+      (groups ++ inputRows.map(_ / numPartitions)).reduceOption(_.min(_))
+    } else {
+      (groups ++ inputRows).reduceOption(_.min(_)).map(_ / numPartitions)
+    }
+    estimated.getOrElse(BigInt(0)).min(BigInt(Long.MaxValue)).toLong
+  }
+
+  // The parameters of the native aggregation, one key=value per line after "AggregateParameters:".
+  def genAggregateParametersBuilder(): Any.Builder = {
+    val aggregateParametersStr = new StringBuffer("AggregateParameters:")
+    aggregateParametersStr
+      .append("estimatedGroups=")
+      .append(if (groupingExpressions.isEmpty) 0 else estimatedGroupsPerTask)
+      .append("\n")
+    val message = StringValue
+      .newBuilder()
+      .setValue(aggregateParametersStr.toString)
+      .build()
+    Any.newBuilder
+      .setValue(message.toByteString)
+      .setTypeUrl("/google.protobuf.StringValue")
+  }
+
   def numShufflePartitions: Option[Int] = Some(0)
 
   // aggResultAttributes is groupkeys ++ aggregate expressions
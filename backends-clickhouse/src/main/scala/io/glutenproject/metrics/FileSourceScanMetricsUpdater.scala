@@ -35,6 +35,11 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
   val extraTime: SQLMetric = metrics("extraTime")
   val inputWaitTime: SQLMetric = metrics("inputWaitTime")
   val outputWaitTime: SQLMetric = metrics("outputWaitTime")
+  val pagesRead: SQLMetric = metrics("pagesRead")
+  val pagesSkipped: SQLMetric = metrics("pagesSkipped")
+  val cacheHitBytes: SQLMetric = metrics("cacheHitBytes")
+  val cacheMissBytes: SQLMetric = metrics("cacheMissBytes")
+  val peakMemoryBytes: SQLMetric = metrics("peakMemoryBytes")
 
   override def updateInputMetrics(inputMetrics: InputMetricsWrapper): Unit = {
     // inputMetrics.bridgeIncBytesRead(metrics("inputBytes").value)
@@ -50,6 +55,7 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
         inputWaitTime += (metricsData.inputWaitTime / 1000L).toLong
         outputWaitTime += (metricsData.outputWaitTime / 1000L).toLong
         outputVectors += metricsData.outputVectors
+        peakMemoryBytes += metricsData.peakMemoryBytes
 
         MetricsUtil.updateExtraTimeMetric(
           metricsData,
@@ -61,6 +67,16 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
           FileSourceScanMetricsUpdater.INCLUDING_PROCESSORS,
           FileSourceScanMetricsUpdater.CH_PLAN_NODE_NAME
         )
+        MetricsUtil
+          .getAllProcessorList(metricsData)
+          .filter(_.name.equals("SubstraitFileSource"))
+          .foreach(
+            processor => {
+              pagesRead += processor.pagesRead
+              pagesSkipped += processor.pagesSkipped
+              cacheHitBytes += processor.cacheHitBytes
+              cacheMissBytes += processor.cacheMissBytes
+            })
       }
     }
   }
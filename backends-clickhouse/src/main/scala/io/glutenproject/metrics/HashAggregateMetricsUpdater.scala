@@ -56,6 +56,7 @@ class HashAggregateMetricsUpdater(val metrics: Map[String, SQLMetric])
           metrics("outputVectors") += aggMetricsData.outputVectors
           metrics("inputWaitTime") += (aggMetricsData.inputWaitTime / 1000L).toLong
           metrics("outputWaitTime") += (aggMetricsData.outputWaitTime / 1000L).toLong
+          metrics("spilledBytes") += aggMetricsData.spilledBytes
           totalTime += aggMetricsData.time
 
           MetricsUtil.updateExtraTimeMetric(
@@ -83,6 +83,8 @@ class HashJoinMetricsUpdater(val metrics: Map[String, SQLMetric])
           metrics("outputVectors") += joinMetricsData.outputVectors
           metrics("inputWaitTime") += (joinMetricsData.inputWaitTime / 1000L).toLong
           metrics("outputWaitTime") += (joinMetricsData.outputWaitTime / 1000L).toLong
+          metrics("spilledBytes") += joinMetricsData.spilledBytes
+          metrics("peakMemoryBytes") += joinMetricsData.peakMemoryBytes
           totalTime += joinMetricsData.time
 
           MetricsUtil
@@ -29,6 +29,7 @@ class ProjectMetricsUpdater(val metrics: Map[String, SQLMetric]) extends Metrics
         metrics("inputWaitTime") += (metricsData.inputWaitTime / 1000L).toLong
         metrics("outputWaitTime") += (metricsData.outputWaitTime / 1000L).toLong
         metrics("outputVectors") += metricsData.outputVectors
+        metrics("eliminatedExpressions") += metricsData.eliminatedExpressions
 
         MetricsUtil.updateExtraTimeMetric(
           metricsData,
@@ -29,6 +29,7 @@ class SortMetricsUpdater(val metrics: Map[String, SQLMetric]) extends MetricsUpd
         metrics("inputWaitTime") += (metricsData.inputWaitTime / 1000L).toLong
         metrics("outputWaitTime") += (metricsData.outputWaitTime / 1000L).toLong
         metrics("outputVectors") += metricsData.outputVectors
+        metrics("spilledBytes") += metricsData.spilledBytes
 
         MetricsUtil.updateExtraTimeMetric(
           metricsData,
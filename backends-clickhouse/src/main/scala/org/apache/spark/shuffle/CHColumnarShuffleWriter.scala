@@ -17,11 +17,14 @@
 package org.apache.spark.shuffle
 
 import io.glutenproject.GlutenConfig
+import io.glutenproject.backendsapi.clickhouse.CHBackendSettings
+import io.glutenproject.memory.memtarget.spark.{GlutenMemoryConsumer, Spiller}
 import io.glutenproject.metrics.GlutenTimeMetric
 import io.glutenproject.vectorized._
 
-import org.apache.spark.SparkEnv
+import org.apache.spark.{SparkEnv, TaskContext}
 import org.apache.spark.internal.Logging
+import org.apache.spark.memory.MemoryConsumer
 import org.apache.spark.scheduler.MapStatus
 import org.apache.spark.sql.vectorized.ColumnarBatch
 import org.apache.spark.util.{SparkDirectoryUtil, Utils}
@@ -51,7 +54,10 @@ class CHColumnarShuffleWriter[K, V](
   private val splitSize = GlutenConfig.getConf.maxBatchSize
   private val customizedCompressCodec =
     GlutenShuffleUtils.getCompressionCodec(conf).toUpperCase(Locale.ROOT)
-  private val preferSpill = GlutenConfig.getConf.columnarShufflePreferSpill
+  // Spill the partitions once they buffer splitSize rows, unless they are to be cached in memory.
+  private val preferSpill = !conf.getBoolean(
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_CACHE_PARTITION_BUFFERS,
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_CACHE_PARTITION_BUFFERS_DEFAULT)
   private val writeSchema = GlutenConfig.getConf.columnarShuffleWriteSchema
   private val jniWrapper = new CHShuffleSplitterJniWrapper
   // Are we in the process of stopping? Because map tasks can call stop() with success = true
@@ -69,6 +75,19 @@ class CHColumnarShuffleWriter[K, V](
 
   private var firstRecordBatch: Boolean = true
 
+  // The partition buffers of the native splitter, unless they are spilled once full.
+  private lazy val memoryConsumer = new GlutenMemoryConsumer(
+    "CHShuffleWriter",
+    TaskContext.get().taskMemoryManager(),
+    new Spiller() {
+      override def spill(size: Long, trigger: MemoryConsumer): Long = evict(size)
+    })
+
+  private lazy val reservation = new BufferedBytesReservation(
+    size => memoryConsumer.borrow(size),
+    size => memoryConsumer.repay(size),
+    size => if (nativeSplitter == 0) 0L else jniWrapper.evict(nativeSplitter, size))
+
   @throws[IOException]
   override def write(records: Iterator[Product2[K, V]]): Unit = {
     internalCHWrite(records)
@@ -97,7 +116,8 @@ class CHColumnarShuffleWriter[K, V](
         customizedCompressCodec,
         dataTmp.getAbsolutePath,
         localDirs,
-        subDirsPerLocalDir)
+        subDirsPerLocalDir,
+        preferSpill)
     }
     while (records.hasNext) {
       val cb = records.next()._2.asInstanceOf[ColumnarBatch]
@@ -109,8 +129,11 @@ class CHColumnarShuffleWriter[K, V](
             firstRecordBatch = false
             val col = cb.column(0).asInstanceOf[CHColumnVector]
             val block = col.getBlockAddress
-            splitterJniWrapper
+            val bufferedBytes = splitterJniWrapper
               .split(nativeSplitter, cb.numRows, block)
+            if (!preferSpill) {
+              reservation.update(bufferedBytes)
+            }
         }
         dep.metrics("numInputRows").add(cb.numRows)
         dep.metrics("inputBatches").add(1)
@@ -121,6 +144,7 @@ class CHColumnarShuffleWriter[K, V](
     splitResult = GlutenTimeMetric.nano(dep.metrics("splitTime")) {
       _ => splitterJniWrapper.stop(nativeSplitter)
     }
+    reservation.releaseAll()
 
     dep.metrics("spillTime").add(splitResult.getTotalSpillTime)
     dep.metrics("compressTime").add(splitResult.getTotalCompressTime)
@@ -167,9 +191,65 @@ class CHColumnarShuffleWriter[K, V](
     }
   }
 
-  private def closeCHSplitter(): Unit = jniWrapper.close(nativeSplitter)
+  private def closeCHSplitter(): Unit = {
+    reservation.releaseAll()
+    jniWrapper.close(nativeSplitter)
+  }
+
+  private def evict(size: Long): Long = {
+    val evicted = reservation.evict(size)
+    logInfo(s"Gluten shuffle writer: Spilled $evicted / $size bytes of data")
+    evicted
+  }
 
   // VisibleForTesting
   def getPartitionLengths: Array[Long] = partitionLengths
 
 }
+
+/**
+ * Keeps the memory borrowed from Spark in line with the bytes buffered by the native splitter,
+ * evicting its largest partitions for what Spark doesn't grant. Only the buffered bytes that are
+ * reserved are repaid once evicted.
+ */
+private[shuffle] class BufferedBytesReservation(
+    borrow: Long => Long,
+    repay: Long => Unit,
+    evictBuffers: Long => Long) {
+  private var bufferedBytes = 0L
+  private var reservedBytes = 0L
+
+  def reserved: Long = reservedBytes
+
+  /** Reserves the bytes buffered after a split. */
+  def update(buffered: Long): Unit = {
+    bufferedBytes = buffered
+    if (bufferedBytes > reservedBytes) {
+      // May call back evict() to spill the splitter itself.
+      reservedBytes += borrow(bufferedBytes - reservedBytes)
+      if (bufferedBytes > reservedBytes) {
+        evict(bufferedBytes - reservedBytes)
+      }
+    }
+    releaseUnbuffered()
+  }
+
+  def evict(size: Long): Long = {
+    val evicted = evictBuffers(size)
+    bufferedBytes = math.max(0L, bufferedBytes - evicted)
+    releaseUnbuffered()
+    evicted
+  }
+
+  def releaseAll(): Unit = {
+    bufferedBytes = 0
+    releaseUnbuffered()
+  }
+
+  private def releaseUnbuffered(): Unit = {
+    if (reservedBytes > bufferedBytes) {
+      repay(reservedBytes - bufferedBytes)
+      reservedBytes = bufferedBytes
+    }
+  }
+}
@@ -29,6 +29,9 @@ import scala.collection.mutable.ArrayBuffer
 
 object MergeTreePartsPartitionsUtil extends Logging {
 
+  // Rows per mark of ClickHouse's default index_granularity, to estimate the marks of a part from its rows.
+  private val ROWS_PER_MARK = 8192L
+
   def getPartsPartitions(
       sparkSession: SparkSession,
       table: ClickHouseTableV2): Seq[InputPartition] = {
@@ -102,15 +105,42 @@ object MergeTreePartsPartitionsUtil extends Logging {
       // Assign files to partitions using "Next Fit Decreasing"
       partsFiles.foreach {
         parts =>
-          if (currentSize + parts.bytesOnDisk > maxSplitBytes) {
+          val estimatedMarks = (parts.rows + ROWS_PER_MARK - 1) / ROWS_PER_MARK
+          if (parts.bytesOnDisk > maxSplitBytes && estimatedMarks > 1) {
+            // A large part is read by several tasks, each on a range of its marks.
             closePartition()
+            val numSplits = math.min(
+              estimatedMarks,
+              (parts.bytesOnDisk + maxSplitBytes - 1) / maxSplitBytes)
+            val marksPerSplit = (estimatedMarks + numSplits - 1) / numSplits
+            var beginMark = 0L
+            while (beginMark < estimatedMarks) {
+              val endMark = beginMark + marksPerSplit
+              partitions += GlutenMergeTreePartition(
+                partitions.size,
+                engine,
+                database,
+                tableName,
+                tablePath,
+                parts.minBlockNumber,
+                parts.maxBlockNumber + 1,
+                beginMark,
+                // The last range reads to the end, the marks are estimated.
+                if (endMark >= estimatedMarks) Long.MaxValue else endMark
+              )
+              beginMark = endMark
+            }
+          } else {
+            if (currentSize + parts.bytesOnDisk > maxSplitBytes) {
+              closePartition()
+            }
+            // Add the given file to the current partition.
+            currentSize += parts.bytesOnDisk + openCostInBytes
+            if (currentMinPartsNum == -1L) {
+              currentMinPartsNum = parts.minBlockNumber
+            }
+            currentMaxPartsNum = parts.maxBlockNumber
           }
-          // Add the given file to the current partition.
-          currentSize += parts.bytesOnDisk + openCostInBytes
-          if (currentMinPartsNum == -1L) {
-            currentMinPartsNum = parts.minBlockNumber
-          }
-          currentMaxPartsNum = parts.maxBlockNumber
       }
     }
     closePartition()
@@ -43,7 +43,7 @@ trait CHFormatWriterInjects extends GlutenFormatWriterInjectsBase {
         dataSchema.fieldNames,
         getFormatName());
 
-    new OutputWriter {
+    new OutputWriter with NativeOutputWriter {
       override def write(row: InternalRow): Unit = {
         assert(row.isInstanceOf[FakeRow])
         val nextBatch = row.asInstanceOf[FakeRow].batch
@@ -55,9 +55,11 @@ trait CHFormatWriterInjects extends GlutenFormatWriterInjectsBase {
       }
 
       override def close(): Unit = {
-        datasourceJniWrapper.close(instance)
+        NativeFileStats.put(originPath, datasourceJniWrapper.close(instance))
       }
 
+      override def writtenBytes(): Long = datasourceJniWrapper.writtenBytes(instance)
+
       // Do NOT add override keyword for compatibility on spark 3.1.
       def path(): String = {
         originPath
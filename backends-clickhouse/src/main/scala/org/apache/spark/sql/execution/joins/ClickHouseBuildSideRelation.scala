@@ -29,7 +29,7 @@ import org.apache.spark.sql.catalyst.plans.physical.BroadcastMode
 import org.apache.spark.sql.execution.utils.CHExecUtil
 import org.apache.spark.sql.vectorized.ColumnarBatch
 
-import java.io.ByteArrayInputStream
+import java.io.{ByteArrayInputStream, InputStream, SequenceInputStream}
 
 import scala.collection.JavaConverters._
 
@@ -51,20 +51,21 @@ case class ClickHouseBuildSideRelation(
   override def asReadOnlyCopy(
       broadCastContext: BroadCastHashJoinContext): ClickHouseBuildSideRelation = this
 
+  // Reads the batches in turn, without concatenating them into another copy of the relation.
+  private def batchesInputStream: InputStream =
+    new SequenceInputStream(
+      batches.iterator.map(batch => new ByteArrayInputStream(batch): InputStream).asJavaEnumeration)
+
   private var hashTableData: Long = 0L
   def buildHashTable(
       broadCastContext: BroadCastHashJoinContext): (Long, ClickHouseBuildSideRelation) =
     synchronized {
       if (hashTableData == 0) {
-        val allBatches = batches.flatten
         logDebug(
           s"BHJ value size: " +
-            s"${broadCastContext.buildHashTableId} = ${allBatches.length}")
+            s"${broadCastContext.buildHashTableId} = ${batches.map(_.length.toLong).sum}")
         val storageJoinBuilder = new StorageJoinBuilder(
-          new OnHeapCopyShuffleInputStream(
-            new ByteArrayInputStream(allBatches),
-            customizeBufferSize,
-            false),
+          new OnHeapCopyShuffleInputStream(batchesInputStream, customizeBufferSize, false),
           broadCastContext,
           customizeBufferSize,
           output.asJava,
@@ -89,10 +90,8 @@ case class ClickHouseBuildSideRelation(
    * @return
    */
   override def transform(key: Expression): Array[InternalRow] = {
-    val allBatches = batches.flatten
     // native block reader
-    val input = new ByteArrayInputStream(allBatches)
-    val blockReader = new CHStreamReader(input, customizeBufferSize)
+    val blockReader = new CHStreamReader(batchesInputStream, customizeBufferSize)
     val broadCastIter = new Iterator[ColumnarBatch] {
       private var current: CHNativeBlock = _
 
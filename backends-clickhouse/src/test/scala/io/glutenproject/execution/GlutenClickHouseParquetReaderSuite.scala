@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.glutenproject.execution
+
+import org.apache.spark.SparkConf
+import org.apache.spark.sql.Row
+import org.apache.spark.sql.execution.adaptive.AdaptiveSparkPlanHelper
+
+import org.apache.commons.io.FileUtils
+
+import java.io.File
+import java.nio.charset.StandardCharsets
+
+class GlutenClickHouseParquetReaderSuite
+  extends GlutenClickHouseTPCHAbstractSuite
+  with AdaptiveSparkPlanHelper {
+
+  override protected val resourcePath: String =
+    "../../../../gluten-core/src/test/resources/tpch-data"
+
+  override protected val tablesPath: String = basePath + "/tpch-data"
+  override protected val tpchQueries: String =
+    rootPath + "../../../../gluten-core/src/test/resources/tpch-queries"
+  override protected val queriesResults: String = rootPath + "queries-output"
+
+  override protected def createTPCHNullableTables(): Unit = {}
+
+  override protected def createTPCHNotNullTables(): Unit = {}
+
+  private val runtimeConfigPrefix = "spark.gluten.sql.columnar.backend.ch.runtime_config"
+
+  override protected def sparkConf: SparkConf = {
+    super.sparkConf
+      .set("spark.sql.adaptive.enabled", "true")
+      .set(s"$runtimeConfigPrefix.parquet.read_strings_as_low_cardinality", "true")
+      .set(s"$runtimeConfigPrefix.file_source.max_parallel_units", "4")
+  }
+
+  test("prune row groups by the page index and bloom filters") {
+    val filePath = basePath + "/parquet_indexes"
+    // Small row groups, each holding strings from all over the range, so the statistics prune none.
+    spark
+      .range(0, 100000, 1, 1)
+      .selectExpr("id", "cast(id * 7919 % 100000 as string) as s")
+      .write
+      .mode("overwrite")
+      .option("parquet.block.size", "65536")
+      .option("parquet.bloom.filter.enabled#s", "true")
+      .parquet(filePath)
+
+    withSQLConf(("spark.gluten.sql.parquet.maxmin.index", "true")) {
+      val df = spark.sql(s"select id from parquet.`$filePath` where s = '7919'")
+      checkAnswer(df, Row(1L))
+      val scans = collect(df.queryExecution.executedPlan) {
+        case scan: FileSourceScanExecTransformer => scan
+      }
+      assert(scans.head.metrics("pagesSkipped").value > 0)
+
+      checkAnswer(
+        spark.sql(s"select id from parquet.`$filePath` where s in ('7919', '15838', 'x')"),
+        Seq(Row(1L), Row(2L)))
+      checkAnswer(
+        spark.sql(s"select count(*) from parquet.`$filePath` where id >= 500 and id < 600"),
+        Row(100L))
+    }
+  }
+
+  test("read the filter columns ahead of the others") {
+    val filePath = basePath + "/parquet_late_materialization"
+    spark
+      .range(0, 100000, 1, 1)
+      .selectExpr(
+        "id",
+        "id % 1000 as k",
+        "if(id % 7 = 0, null, concat('v', cast(id as string))) as v",
+        "cast(id % 3 as int) as p")
+      .write
+      .mode("overwrite")
+      .partitionBy("p")
+      .option("parquet.block.size", "65536")
+      .parquet(filePath)
+    spark.read.parquet(filePath).createOrReplaceTempView("late_materialization")
+
+    // Rows of some row groups, of none, of all, by two filter columns and by the partition column.
+    Seq(
+      "select id, v from late_materialization where id between 30000 and 30100",
+      "select id, v from late_materialization where id < 0",
+      "select count(v), max(v) from late_materialization where k >= 0",
+      "select id, v from late_materialization where k = 7 and id > 90000",
+      "select id, v from late_materialization where p = 1 and id < 100"
+    ).foreach(sql => runQueryAndCompare(sql)(_ => {}))
+  }
+
+  test("read dictionary encoded strings as low cardinality") {
+    val filePath = basePath + "/parquet_dictionary_strings"
+    // Each row group has a dictionary of its own values, some of them null.
+    spark
+      .range(0, 100000, 1, 1)
+      .selectExpr(
+        "id",
+        "if(id % 11 = 0, null, concat('d', id div 5000, '_', id % 13)) as d")
+      .write
+      .mode("overwrite")
+      .option("parquet.block.size", "65536")
+      .parquet(filePath)
+    spark.read.parquet(filePath).createOrReplaceTempView("dictionary_strings")
+
+    Seq(
+      "select d, count(*) from dictionary_strings group by d",
+      "select id, d from dictionary_strings where d = 'd3_5'",
+      "select id, upper(d) from dictionary_strings where d like 'd19%' and id % 3 = 0",
+      "select count(*) from dictionary_strings where d is null"
+    ).foreach(sql => runQueryAndCompare(sql)(_ => {}))
+  }
+
+  test("open the next files of a split ahead") {
+    val filePath = basePath + "/parquet_many_files"
+    spark
+      .range(0, 20000, 1, 20)
+      .selectExpr("id", "concat('s', cast(id as string)) as s")
+      .write
+      .mode("overwrite")
+      .parquet(filePath)
+
+    // All the files in one split, so that the source prefetches the ones after the first.
+    withSQLConf(
+      ("spark.sql.files.maxPartitionBytes", "1g"),
+      ("spark.sql.files.openCostInBytes", "0")) {
+      spark.read.parquet(filePath).createOrReplaceTempView("many_files")
+      Seq(
+        "select count(*), sum(id), max(s) from many_files",
+        "select id, s from many_files where id % 1000 = 1",
+        // Stops reading while prefetches are pending.
+        "select count(*) from (select * from many_files limit 10)"
+      ).foreach(sql => runQueryAndCompare(sql)(_ => {}))
+
+      // A prefetch failure is raised when the broken file's turn comes.
+      val brokenPath = basePath + "/parquet_broken_files"
+      FileUtils.copyDirectory(new File(filePath), new File(brokenPath))
+      FileUtils.writeStringToFile(
+        new File(brokenPath, "part-99999-broken.parquet"),
+        "not a parquet file",
+        StandardCharsets.UTF_8)
+      intercept[Exception] {
+        spark.read.schema("id long, s string").parquet(brokenPath).selectExpr("sum(id)").collect()
+      }
+    }
+  }
+
+  test("decode the row groups and stripes of a split in parallel") {
+    Seq(("parquet", "parquet.block.size"), ("orc", "orc.stripe.size")).foreach {
+      case (format, unitSizeOption) =>
+        val filePath = s"$basePath/${format}_parallel_units"
+        spark
+          .range(0, 100000, 1, 1)
+          .selectExpr("id", "if(id % 5 = 0, null, cast(id as string)) as s")
+          .write
+          .mode("overwrite")
+          .option(unitSizeOption, "65536")
+          .format(format)
+          .save(filePath)
+
+        withSQLConf(("spark.sql.files.maxPartitionBytes", "1g")) {
+          val df = spark.read.format(format).load(filePath)
+          // The units of the one split come back in file order.
+          val ids = df.select("id").collect().map(_.getLong(0))
+          assert(ids.toSeq == (0L until 100000L))
+
+          df.createOrReplaceTempView(s"${format}_parallel_units")
+          runQueryAndCompare(
+            s"select count(s), sum(id), min(s) from ${format}_parallel_units where id % 3 = 0")(
+            _ => {})
+        }
+    }
+  }
+}
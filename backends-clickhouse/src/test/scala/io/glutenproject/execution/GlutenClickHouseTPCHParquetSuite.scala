@@ -1455,6 +1455,46 @@ class GlutenClickHouseTPCHParquetSuite extends GlutenClickHouseTPCHAbstractSuite
     compareResultsAgainstVanillaSpark(sql, true, { _ => })
   }
 
+  test("broadcast nested loop join") {
+    val joinSql =
+      """
+        |select /*+ BROADCAST(t2) */ t1.n_nationkey, t2.r_regionkey
+        |from nation t1 %s join region t2
+        |on t1.n_regionkey < t2.r_regionkey and t2.r_name <> 'ASIA'
+        |order by t1.n_nationkey, t2.r_regionkey
+        |""".stripMargin
+    val existenceJoinSql =
+      """
+        |select /*+ BROADCAST(t2) */ t1.n_nationkey
+        |from nation t1 left %s join region t2
+        |on t1.n_regionkey < t2.r_regionkey and t2.r_name <> 'ASIA'
+        |order by t1.n_nationkey
+        |""".stripMargin
+    // Right outer joins build the left side.
+    val rightJoinSql =
+      """
+        |select /*+ BROADCAST(t1) */ t1.r_regionkey, t2.n_nationkey
+        |from region t1 right join nation t2
+        |on t2.n_regionkey < t1.r_regionkey and t1.r_name <> 'ASIA'
+        |order by t2.n_nationkey, t1.r_regionkey
+        |""".stripMargin
+    val sqls = Seq("inner", "left", "cross").map(joinSql.format(_)) ++
+      Seq("semi", "anti").map(existenceJoinSql.format(_)) :+ rightJoinSql
+    sqls.foreach {
+      sql =>
+        compareResultsAgainstVanillaSpark(
+          sql,
+          true,
+          {
+            df =>
+              val bnlj = df.queryExecution.executedPlan.collect {
+                case j: BroadcastNestedLoopJoinExecTransformer => j
+              }
+              assert(bnlj.size == 1)
+          })
+    }
+  }
+
   test("GLUTEN-2198: Fix wrong schema when there is no aggregate function") {
     val sql =
       """
@@ -24,13 +24,19 @@ import org.apache.spark.sql.SparkSession
 import org.apache.spark.sql.execution.adaptive.AdaptiveSparkPlanHelper
 import org.apache.spark.sql.execution.datasources.v2.clickhouse.ClickHouseLog
 import org.apache.spark.sql.test.SharedSparkSession
+import org.apache.spark.util.Utils
 
 import org.apache.commons.io.FileUtils
+import org.apache.hadoop.fs.Path
+import org.apache.parquet.hadoop.ParquetFileReader
+import org.apache.parquet.hadoop.util.HadoopInputFile
 import org.scalatest.BeforeAndAfterAll
 
 import java.io.File
 import java.sql.{Date, Timestamp}
 
+import scala.collection.JavaConverters._
+
 class GlutenClickHouseWriteParquetTableSuite
   extends GlutenClickHouseTPCHAbstractSuite
   with AdaptiveSparkPlanHelper
@@ -74,6 +80,9 @@ class GlutenClickHouseWriteParquetTableSuite
       .set("spark.gluten.sql.columnar.hashagg.enablefinal", "true")
       .set("spark.gluten.sql.enable.native.validation", "false")
       .set("spark.gluten.sql.columnar.forceshuffledhashjoin", "true")
+      .set(
+        "spark.gluten.sql.columnar.backend.ch.runtime_config.parquet.write.row_group_target_bytes",
+        rowGroupTargetBytes.toString)
       // TODO: support default ANSI policy
       .set("spark.sql.storeAssignmentPolicy", "legacy")
       // .set("spark.gluten.sql.columnar.backend.ch.runtime_config.logger.level", "debug")
@@ -103,6 +112,8 @@ class GlutenClickHouseWriteParquetTableSuite
     }
   }
 
+  private val rowGroupTargetBytes = 1024 * 1024
+
   private val table_name_template = "hive_%s_test"
   private val table_name_vanilla_template = "hive_%s_test_written_by_vanilla"
   private val formats = Array("orc", "parquet")
@@ -919,4 +930,52 @@ class GlutenClickHouseWriteParquetTableSuite
       }
     }
   }
+
+  test("test parquet row groups sized by encoded bytes") {
+    withSQLConf(("spark.gluten.sql.native.writer.enabled", "true")) {
+      val table_name = table_name_template.format("row_group")
+      val df = spark
+        .range(0, 1 << 21, 1, 1)
+        .selectExpr("id % 100 as k", "concat('value-', id % 1000) as s")
+      // The first file cuts its row groups by raw bytes, the next by the encoded ratio it learned.
+      for (_ <- 0 until 2) {
+        spark.sql(s"drop table IF EXISTS $table_name")
+        df.write.format("parquet").saveAsTable(table_name)
+      }
+      checkAnswer(spark.table(table_name), df)
+
+      val sizes = spark.table(table_name).inputFiles.flatMap {
+        file =>
+          val in = HadoopInputFile.fromPath(new Path(file), spark.sessionState.newHadoopConf())
+          Utils.tryWithResource(ParquetFileReader.open(in)) {
+            reader => reader.getFooter.getBlocks.asScala.map(_.getCompressedSize)
+          }
+      }
+      assert(sizes.length > 1, sizes.mkString(","))
+      assert(sizes.max >= rowGroupTargetBytes / 2, sizes.mkString(","))
+      assert(sizes.forall(_ <= 2L * rowGroupTargetBytes), sizes.mkString(","))
+    }
+  }
+
+  test("test parquet files rolled at the max file bytes") {
+    val maxFileBytes = 1024 * 1024
+    withSQLConf(
+      ("spark.gluten.sql.native.writer.enabled", "true"),
+      (GlutenConfig.NATIVE_WRITER_MAX_FILE_BYTES.key, maxFileBytes.toString)) {
+      val table_name = table_name_template.format("rolled")
+      spark.sql(s"drop table IF EXISTS $table_name")
+      // Of one task, hardly compressible.
+      val df = spark
+        .range(0, 200000, 1, 1)
+        .selectExpr("id", "sha2(cast(id as string), 256) as s")
+      df.write.format("parquet").saveAsTable(table_name)
+      checkAnswer(spark.table(table_name), df)
+
+      val files = spark.table(table_name).inputFiles.map(file => new Path(file))
+      val fs = files.head.getFileSystem(spark.sessionState.newHadoopConf())
+      assert(files.length > 1)
+      // Checked between blocks, while the size written grows by the row groups flushed.
+      files.foreach(file => assert(fs.getFileStatus(file).getLen <= 3L * maxFileBytes, file))
+    }
+  }
 }
@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.spark.shuffle
+
+import org.scalatest.funsuite.AnyFunSuite
+
+class BufferedBytesReservationSuite extends AnyFunSuite {
+
+  /** Grants at most available bytes, and evicts all the buffered bytes asked for. */
+  class Memory(var available: Long) {
+    var buffered = 0L
+    var borrowed = 0L
+    val reservation = new BufferedBytesReservation(
+      size => {
+        val granted = math.min(size, available)
+        available -= granted
+        borrowed += granted
+        granted
+      },
+      size => {
+        available += size
+        borrowed -= size
+      },
+      size => {
+        val evicted = math.min(size, buffered)
+        buffered -= evicted
+        evicted
+      }
+    )
+
+    def split(bytes: Long): Unit = {
+      buffered += bytes
+      reservation.update(buffered)
+    }
+  }
+
+  test("reserve the buffered bytes") {
+    val memory = new Memory(100)
+    memory.split(40)
+    memory.split(40)
+    assert(memory.borrowed == 80)
+    assert(memory.buffered == 80)
+    memory.reservation.releaseAll()
+    assert(memory.borrowed == 0)
+    assert(memory.available == 100)
+  }
+
+  test("evict what isn't granted without repaying it") {
+    val memory = new Memory(100)
+    memory.split(80)
+    // 20 bytes granted out of 50, the 30 other bytes are evicted but were never borrowed.
+    memory.split(50)
+    assert(memory.buffered == 100)
+    assert(memory.borrowed == 100)
+    assert(memory.reservation.reserved == 100)
+  }
+
+  test("repay the reserved bytes evicted for another consumer") {
+    val memory = new Memory(100)
+    memory.split(60)
+    assert(memory.reservation.evict(25) == 25)
+    assert(memory.buffered == 35)
+    assert(memory.borrowed == 35)
+    assert(memory.available == 65)
+  }
+}
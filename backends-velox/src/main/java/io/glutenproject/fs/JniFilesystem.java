@@ -48,6 +48,14 @@ public interface JniFilesystem {
   interface ReadFile {
     void pread(long offset, long length, long buf); // uint64_t offset, uint64_t length, void* buf
 
+    // Reads the ranges (offsets[i], lengths[i]) into the buffers at addresses[i], in ascending
+    // order of offset. Lets a coalesced read cross JNI once.
+    default void preadv(long[] offsets, long[] lengths, long[] addresses) {
+      for (int i = 0; i < offsets.length; i++) {
+        pread(offsets[i], lengths[i], addresses[i]);
+      }
+    }
+
     boolean shouldCoalesce();
 
     long size();
@@ -19,6 +19,7 @@ package io.glutenproject.spark.sql.execution.datasources.velox;
 import io.glutenproject.init.JniInitialized;
 import io.glutenproject.init.JniUtils;
 
+import org.apache.spark.sql.execution.datasources.BlockStripes;
 import org.apache.spark.sql.execution.datasources.VeloxColumnarBatchIterator;
 
 import java.io.IOException;
@@ -37,7 +38,18 @@ public class DatasourceJniWrapper extends JniInitialized {
 
   public native void inspectSchema(long instanceId, long cSchemaAddress);
 
-  public native void close(long instanceId);
+  /** Returns the column statistics of the file as JSON, empty if not collected. */
+  public native String close(long instanceId);
 
   public native void write(long instanceId, VeloxColumnarBatchIterator iterator);
+
+  /** The estimated encoded bytes of the file so far. */
+  public native long writtenBytes(long instanceId);
+
+  /**
+   * Splits the batch, sorted by the partition columns, into the runs of rows of the same partition.
+   * The originBlockAddress of the result is the batch of the heading rows of the stripes.
+   */
+  public native BlockStripes splitBlockByPartitionAndBucket(
+      long batchHandle, int[] partitionColIndice, boolean hasBucket);
 }
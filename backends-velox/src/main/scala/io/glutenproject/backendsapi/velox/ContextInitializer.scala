@@ -18,6 +18,7 @@ package io.glutenproject.backendsapi.velox
 
 import io.glutenproject.GlutenConfig
 import io.glutenproject.backendsapi.ContextApi
+import io.glutenproject.cache.CacheJniWrapper
 import io.glutenproject.exception.GlutenException
 import io.glutenproject.execution.datasource.GlutenOrcWriterInjects
 import io.glutenproject.execution.datasource.GlutenParquetWriterInjects
@@ -134,6 +135,10 @@ class ContextInitializer extends ContextApi {
     GlutenRowSplitter.setInstance(new VeloxRowSplitter())
   }
 
+  override def cachedFiles(): Array[String] = new CacheJniWrapper().nativeCachedFiles()
+
+  override def cachedFilesVersion(): Long = new CacheJniWrapper().nativeCachedFilesVersion()
+
   override def shutdown(): Unit = {
     // TODO shutdown implementation in velox to release resources
   }
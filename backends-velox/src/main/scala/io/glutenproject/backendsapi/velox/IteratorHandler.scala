@@ -20,6 +20,7 @@ import io.glutenproject.GlutenNumaBindingInfo
 import io.glutenproject.backendsapi.IteratorApi
 import io.glutenproject.execution._
 import io.glutenproject.metrics.IMetrics
+import io.glutenproject.sql.shims.SparkShimLoader
 import io.glutenproject.substrait.plan.PlanNode
 import io.glutenproject.substrait.rel.LocalFilesBuilder
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
@@ -68,12 +69,15 @@ class IteratorHandler extends IteratorApi with Logging {
       val paths = mutable.ArrayBuffer.empty[String]
       val starts = mutable.ArrayBuffer.empty[java.lang.Long]
       val lengths = mutable.ArrayBuffer.empty[java.lang.Long]
+      val modificationTimes = mutable.ArrayBuffer.empty[java.lang.Long]
       val partitionColumns = mutable.ArrayBuffer.empty[Map[String, String]]
       files.foreach {
         file =>
           paths.append(URLDecoder.decode(file.filePath, StandardCharsets.UTF_8.name()))
           starts.append(java.lang.Long.valueOf(file.start))
           lengths.append(java.lang.Long.valueOf(file.length))
+          modificationTimes.append(
+            java.lang.Long.valueOf(SparkShimLoader.getSparkShims.getModificationTime(file)))
 
           val partitionColumn = mutable.Map.empty[String, String]
           for (i <- 0 until file.partitionValues.numFields) {
@@ -97,7 +101,7 @@ class IteratorHandler extends IteratorApi with Logging {
           }
           partitionColumns.append(partitionColumn.toMap)
       }
-      (paths, starts, lengths, partitionColumns)
+      (paths, starts, lengths, modificationTimes, partitionColumns)
     }
 
     val localFilesNodesWithLocations = partitions.indices.map(
@@ -106,7 +110,7 @@ class IteratorHandler extends IteratorApi with Logging {
           case f: FilePartition =>
             val fileFormat = fileFormats(i)
             val partitionSchema = partitionSchemas(i)
-            val (paths, starts, lengths, partitionColumns) =
+            val (paths, starts, lengths, modificationTimes, partitionColumns) =
               constructSplitInfo(partitionSchema, f.files)
             (
               LocalFilesBuilder.makeLocalFiles(
@@ -114,6 +118,7 @@ class IteratorHandler extends IteratorApi with Logging {
                 paths.asJava,
                 starts.asJava,
                 lengths.asJava,
+                modificationTimes.asJava,
                 partitionColumns.map(_.asJava).asJava,
                 fileFormat),
               SoftAffinityUtil.getFilePartitionLocations(f))
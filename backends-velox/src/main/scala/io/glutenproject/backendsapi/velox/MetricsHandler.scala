@@ -59,7 +59,22 @@ class MetricsHandler extends MetricsApi with Logging {
       "skippedSplits" -> SQLMetrics.createMetric(sparkContext, "number of skipped splits"),
       "processedSplits" -> SQLMetrics.createMetric(sparkContext, "number of processed splits"),
       "skippedStrides" -> SQLMetrics.createMetric(sparkContext, "number of skipped row groups"),
-      "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups")
+      "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups"),
+      "preloadedSplits" -> SQLMetrics.createMetric(sparkContext, "number of preloaded splits"),
+      "preloadHits" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of splits preloaded when needed"),
+      "ioWaitNanos" -> SQLMetrics.createNanoTimingMetric(sparkContext, "time of waiting for IO"),
+      "readAheadBytes" -> SQLMetrics.createSizeMetric(sparkContext, "number of read ahead bytes"),
+      "ramReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of memory cache read bytes"),
+      "localReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of ssd cache read bytes"),
+      "storageReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of storage read bytes")
     )
 
   override def genBatchScanTransformerMetricsUpdater(
@@ -95,7 +110,22 @@ class MetricsHandler extends MetricsApi with Logging {
       "skippedSplits" -> SQLMetrics.createMetric(sparkContext, "number of skipped splits"),
       "processedSplits" -> SQLMetrics.createMetric(sparkContext, "number of processed splits"),
       "skippedStrides" -> SQLMetrics.createMetric(sparkContext, "number of skipped row groups"),
-      "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups")
+      "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups"),
+      "preloadedSplits" -> SQLMetrics.createMetric(sparkContext, "number of preloaded splits"),
+      "preloadHits" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of splits preloaded when needed"),
+      "ioWaitNanos" -> SQLMetrics.createNanoTimingMetric(sparkContext, "time of waiting for IO"),
+      "readAheadBytes" -> SQLMetrics.createSizeMetric(sparkContext, "number of read ahead bytes"),
+      "ramReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of memory cache read bytes"),
+      "localReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of ssd cache read bytes"),
+      "storageReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of storage read bytes")
     )
 
   override def genHiveTableScanTransformerMetricsUpdater(
@@ -131,7 +161,22 @@ class MetricsHandler extends MetricsApi with Logging {
       "skippedSplits" -> SQLMetrics.createMetric(sparkContext, "number of skipped splits"),
       "processedSplits" -> SQLMetrics.createMetric(sparkContext, "number of processed splits"),
       "skippedStrides" -> SQLMetrics.createMetric(sparkContext, "number of skipped row groups"),
-      "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups")
+      "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups"),
+      "preloadedSplits" -> SQLMetrics.createMetric(sparkContext, "number of preloaded splits"),
+      "preloadHits" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of splits preloaded when needed"),
+      "ioWaitNanos" -> SQLMetrics.createNanoTimingMetric(sparkContext, "time of waiting for IO"),
+      "readAheadBytes" -> SQLMetrics.createSizeMetric(sparkContext, "number of read ahead bytes"),
+      "ramReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of memory cache read bytes"),
+      "localReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of ssd cache read bytes"),
+      "storageReadBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of storage read bytes")
     )
 
   override def genFileSourceScanTransformerMetricsUpdater(
@@ -188,6 +233,9 @@ class MetricsHandler extends MetricsApi with Logging {
         "number of spilled partitions"),
       "aggSpilledFiles" -> SQLMetrics.createMetric(sparkContext, "number of spilled files"),
       "flushRowCount" -> SQLMetrics.createMetric(sparkContext, "number of flushed rows"),
+      "abandonedPartialAggregation" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of partial aggregations passing input through"),
       "preProjectionCpuCount" -> SQLMetrics.createMetric(
         sparkContext,
         "preProjection cpu wall time count"),
@@ -244,7 +292,30 @@ class MetricsHandler extends MetricsApi with Logging {
       "spillTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime to spill"),
       "compressTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime to compress"),
       "prepareTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime to prepare"),
+      "computePidTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "time to compute pid"),
+      "createPartition2RowTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to group rows by partition"),
+      "splitFixedWidthTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to split fixed width columns"),
+      "splitValidityTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to split validity buffers"),
+      "splitBinaryTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to split binary columns"),
+      "splitComplexTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to serialize complex columns"),
+      "allocateBuffersTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to allocate partition buffers"),
+      "createPayloadTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "time to create partition payloads"),
+      "maxPartitionBytes" -> SQLMetrics
+        .createSizeMetric(sparkContext, "max partition size of a map task"),
+      "medianPartitionBytes" -> SQLMetrics
+        .createSizeMetric(sparkContext, "median partition size of a map task"),
       "decompressTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime_decompress"),
+      "hardwareDecompressedBytes" -> SQLMetrics
+        .createSizeMetric(sparkContext, "bytes decompressed by accelerator"),
+      "softwareDecompressedBytes" -> SQLMetrics
+        .createSizeMetric(sparkContext, "bytes decompressed by software fallback"),
       "avgReadBatchNumRows" -> SQLMetrics
         .createAverageMetric(sparkContext, "avg read batch num rows"),
       "numInputRows" -> SQLMetrics.createMetric(sparkContext, "number of input rows"),
@@ -468,7 +539,8 @@ class MetricsHandler extends MetricsApi with Logging {
       "finalOutputRows" -> SQLMetrics.createMetric(sparkContext, "number of final output rows"),
       "finalOutputVectors" -> SQLMetrics.createMetric(
         sparkContext,
-        "number of final output vectors")
+        "number of final output vectors"),
+      "buildSideSwapped" -> SQLMetrics.createMetric(sparkContext, "build side swapped at runtime")
     )
 
   override def genHashJoinTransformerMetricsUpdater(
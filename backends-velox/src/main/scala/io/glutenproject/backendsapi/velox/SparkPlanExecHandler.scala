@@ -201,6 +201,15 @@ class SparkPlanExecHandler extends SparkPlanExecApi {
       right,
       isNullAwareAntiJoin)
 
+  /** Generate BroadcastNestedLoopJoinExecTransformer. */
+  override def genBroadcastNestedLoopJoinExecTransformer(
+      left: SparkPlan,
+      right: SparkPlan,
+      buildSide: BuildSide,
+      joinType: JoinType,
+      condition: Option[Expression]): BroadcastNestedLoopJoinExecTransformer =
+    GlutenBroadcastNestedLoopJoinExecTransformer(left, right, buildSide, joinType, condition)
+
   override def genHashExpressionTransformer(
       substraitExprName: String,
       exps: Seq[ExpressionTransformer],
@@ -226,6 +235,7 @@ class SparkPlanExecHandler extends SparkPlanExecApi {
     ExecUtil.genShuffleDependency(
       rdd,
       childOutputAttributes,
+      projectOutputAttributes,
       newPartitioning,
       serializer,
       writeMetrics,
@@ -260,7 +270,13 @@ class SparkPlanExecHandler extends SparkPlanExecApi {
         clazz.getConstructor(classOf[StructType], classOf[SQLMetric], classOf[SQLMetric])
       constructor.newInstance(schema, readBatchNumRows, numOutputRows).asInstanceOf[Serializer]
     } else {
-      new ColumnarBatchSerializer(schema, readBatchNumRows, numOutputRows, decompressTime)
+      new ColumnarBatchSerializer(
+        schema,
+        readBatchNumRows,
+        numOutputRows,
+        decompressTime,
+        metrics("hardwareDecompressedBytes"),
+        metrics("softwareDecompressedBytes"))
     }
   }
 
@@ -22,11 +22,12 @@ import io.glutenproject.expression.WindowFunctionsBuilder
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat.{DwrfReadFormat, OrcReadFormat, ParquetReadFormat}
 
-import org.apache.spark.sql.catalyst.expressions.{Alias, CumeDist, DenseRank, Descending, Expression, Literal, NamedExpression, NthValue, PercentRank, RangeFrame, Rank, RowNumber, SortOrder, SpecialFrameBoundary, SpecifiedWindowFrame}
+import org.apache.spark.sql.catalyst.expressions.{Alias, AttributeReference, CumeDist, DenseRank, Descending, Expression, Literal, NamedExpression, NthValue, PercentRank, RangeFrame, Rank, RowNumber, SortOrder, SpecialFrameBoundary, SpecifiedWindowFrame}
 import org.apache.spark.sql.catalyst.expressions.aggregate.{AggregateExpression, Count, Sum}
 import org.apache.spark.sql.catalyst.plans.JoinType
 import org.apache.spark.sql.execution.SparkPlan
 import org.apache.spark.sql.execution.aggregate.HashAggregateExec
+import org.apache.spark.sql.execution.utils.ExecUtil
 import org.apache.spark.sql.expression.UDFResolver
 import org.apache.spark.sql.types._
 
@@ -108,6 +109,8 @@ object BackendSettings extends BackendSettingsApi {
     GlutenConfig.getConf.enableColumnarSortMergeJoin
   }
 
+  override def supportBroadcastNestedLoopJoinExec(): Boolean = true
+
   override def supportWindowExec(windowFunctions: Seq[NamedExpression]): Boolean = {
     var allSupported = true
     breakable {
@@ -280,6 +283,17 @@ object BackendSettings extends BackendSettingsApi {
 
   override def recreateJoinExecOnFallback(): Boolean = true
   override def removeHashColumnFromColumnarShuffleExchangeExec(): Boolean = true
+
+  override def supportShuffleWriterHashKeys(exprs: Seq[Expression]): Boolean = {
+    exprs.nonEmpty && exprs.forall {
+      case a: AttributeReference => ExecUtil.isShuffleWriterKeyType(a.dataType)
+      case _ => false
+    }
+  }
+
+  override def supportBuildKeyFilterPushdown(): Boolean =
+    GlutenConfig.getConf.enableVeloxBuildKeyFilterPushdown
+
   override def rescaleDecimalLiteral(): Boolean = true
 
   override def replaceSortAggWithHashAgg: Boolean = GlutenConfig.getConf.forceToUseHashAgg
@@ -223,3 +223,17 @@ case class GlutenBroadcastHashJoinExecTransformer(
       newRight: SparkPlan): GlutenBroadcastHashJoinExecTransformer =
     copy(left = newLeft, right = newRight)
 }
+
+case class GlutenBroadcastNestedLoopJoinExecTransformer(
+    left: SparkPlan,
+    right: SparkPlan,
+    buildSide: BuildSide,
+    joinType: JoinType,
+    condition: Option[Expression])
+  extends BroadcastNestedLoopJoinExecTransformer(left, right, buildSide, joinType, condition) {
+
+  override protected def withNewChildrenInternal(
+      newLeft: SparkPlan,
+      newRight: SparkPlan): GlutenBroadcastNestedLoopJoinExecTransformer =
+    copy(left = newLeft, right = newRight)
+}
@@ -0,0 +1,200 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.spark.sql.execution
+
+import io.glutenproject.columnarbatch.ColumnarBatches
+import io.glutenproject.execution.RowToVeloxColumnarExec
+import io.glutenproject.memory.alloc.NativeMemoryAllocators
+import io.glutenproject.memory.arrowalloc.ArrowBufferAllocators
+import io.glutenproject.utils.ArrowAbiUtil
+import io.glutenproject.vectorized.ColumnarBatchSerializerJniWrapper
+
+import org.apache.spark.rdd.RDD
+import org.apache.spark.sql.catalyst.InternalRow
+import org.apache.spark.sql.catalyst.expressions.{Attribute, Expression, GenericInternalRow, UnsafeProjection}
+import org.apache.spark.sql.columnar.{CachedBatch, SimpleMetricsCachedBatch, SimpleMetricsCachedBatchSerializer}
+import org.apache.spark.sql.internal.SQLConf
+import org.apache.spark.sql.types._
+import org.apache.spark.sql.utils.SparkArrowUtil
+import org.apache.spark.sql.vectorized.ColumnarBatch
+import org.apache.spark.storage.StorageLevel
+import org.apache.spark.util.TaskResources
+
+import org.apache.arrow.c.ArrowSchema
+
+import scala.collection.JavaConverters._
+
+/** A batch cached in the compact format of the native ColumnarBatchSerializer. */
+case class CachedColumnarBatch(
+    override val numRows: Int,
+    override val sizeInBytes: Long,
+    bytes: Array[Byte],
+    override val stats: InternalRow)
+  extends SimpleMetricsCachedBatch
+
+/**
+ * Caches the Velox batches of `df.cache()` serialized natively: constant and low cardinality string
+ * columns lightly encoded, buffers compressed, with the bounds and null counts of the columns for
+ * pruning. Enabled with spark.sql.cache.serializer set to this class.
+ */
+class ColumnarCachedBatchSerializer extends SimpleMetricsCachedBatchSerializer {
+
+  override def supportsColumnarInput(schema: Seq[Attribute]): Boolean = true
+
+  override def supportsColumnarOutput(schema: StructType): Boolean = true
+
+  override def convertColumnarBatchToCachedBatch(
+      input: RDD[ColumnarBatch],
+      schema: Seq[Attribute],
+      storageLevel: StorageLevel,
+      conf: SQLConf): RDD[CachedBatch] = {
+    val localSchema = schema
+    input.mapPartitions {
+      iter =>
+        iter.map {
+          batch =>
+            val offloaded = ColumnarBatches.ensureOffloaded(
+              ArrowBufferAllocators.contextInstance(),
+              batch)
+            toCachedBatch(offloaded, localSchema)
+        }
+    }
+  }
+
+  override def convertInternalRowToCachedBatch(
+      input: RDD[InternalRow],
+      schema: Seq[Attribute],
+      storageLevel: StorageLevel,
+      conf: SQLConf): RDD[CachedBatch] = {
+    // Row based plans are cached in the same format.
+    val batches = RowToVeloxColumnarExec(RDDScanExec(schema, input, "CachedRows")).executeColumnar()
+    convertColumnarBatchToCachedBatch(batches, schema, storageLevel, conf)
+  }
+
+  override def convertCachedBatchToColumnarBatch(
+      input: RDD[CachedBatch],
+      cacheAttributes: Seq[Attribute],
+      selectedAttributes: Seq[Attribute],
+      conf: SQLConf): RDD[ColumnarBatch] = {
+    val columnIndices = selectedAttributes.map(a => cacheAttributes.map(_.exprId).indexOf(a.exprId))
+    val cacheSchema = StructType.fromAttributes(cacheAttributes)
+    input.mapPartitions {
+      iter =>
+        if (iter.isEmpty) {
+          Iterator.empty
+        } else {
+          val allocator = ArrowBufferAllocators.contextInstance()
+          val cSchema = ArrowSchema.allocateNew(allocator)
+          val arrowSchema =
+            SparkArrowUtil.toArrowSchema(cacheSchema, SQLConf.get.sessionLocalTimeZone)
+          ArrowAbiUtil.exportSchema(allocator, arrowSchema, cSchema)
+          val handle = ColumnarBatchSerializerJniWrapper.INSTANCE.init(
+            cSchema.memoryAddress(),
+            NativeMemoryAllocators.getDefault
+              .contextInstance("CachedBatchSerializer")
+              .getNativeInstanceId)
+          cSchema.close()
+          TaskResources.addRecycler(s"CachedBatchSerializer_$handle", 50) {
+            ColumnarBatchSerializerJniWrapper.INSTANCE.close(handle)
+          }
+          iter.map {
+            case cached: CachedColumnarBatch =>
+              val batch = ColumnarBatches.create(
+                ColumnarBatchSerializerJniWrapper.INSTANCE.deserialize(handle, cached.bytes))
+              if (columnIndices == cacheAttributes.indices) {
+                batch
+              } else {
+                ColumnarBatches.select(batch, columnIndices.toArray)
+              }
+          }
+        }
+    }
+  }
+
+  override def convertCachedBatchToInternalRow(
+      input: RDD[CachedBatch],
+      cacheAttributes: Seq[Attribute],
+      selectedAttributes: Seq[Attribute],
+      conf: SQLConf): RDD[InternalRow] = {
+    val selectedSchema = StructType.fromAttributes(selectedAttributes)
+    convertCachedBatchToColumnarBatch(input, cacheAttributes, selectedAttributes, conf)
+      .mapPartitions {
+        iter =>
+          val projection = UnsafeProjection.create(selectedSchema)
+          iter.flatMap {
+            batch =>
+              val loaded = ColumnarBatches.ensureLoaded(ArrowBufferAllocators.contextInstance(), batch)
+              loaded.rowIterator().asScala.map(row => projection(row).copy())
+          }
+      }
+  }
+
+  override def buildFilter(
+      predicates: Seq[Expression],
+      cachedAttributes: Seq[Attribute]): (Int, Iterator[CachedBatch]) => Iterator[CachedBatch] = {
+    // Only predicates on columns with bounds prune, the bounds of the others are null.
+    super.buildFilter(
+      predicates.filter(_.references.forall(a => ColumnarCachedBatchSerializer.hasBounds(a.dataType))),
+      cachedAttributes)
+  }
+
+  private def toCachedBatch(batch: ColumnarBatch, schema: Seq[Attribute]): CachedColumnarBatch = {
+    val handles = Array(ColumnarBatches.getNativeHandle(batch))
+    val allocatorId = NativeMemoryAllocators.getDefault
+      .contextInstance("CachedBatchSerializer")
+      .getNativeInstanceId
+    val serialized = ColumnarBatchSerializerJniWrapper.INSTANCE.serialize(handles, allocatorId)
+    val statistics = ColumnarBatchSerializerJniWrapper.INSTANCE.statistics(handles, allocatorId)
+    val numRows = serialized.getNumRows.toInt
+    val bytes = serialized.getSerialized
+    // |lowerBound|upperBound|nullCount|count|sizeInBytes| of each column, see ColumnStatisticsSchema.
+    val stats = new GenericInternalRow(schema.length * 5)
+    schema.zipWithIndex.foreach {
+      case (attribute, i) =>
+        val hasBounds = statistics.length > 0 && statistics(i * 4) == 1
+        if (hasBounds) {
+          stats.update(i * 5, ColumnarCachedBatchSerializer.toBound(attribute.dataType, statistics(i * 4 + 1)))
+          stats.update(i * 5 + 1, ColumnarCachedBatchSerializer.toBound(attribute.dataType, statistics(i * 4 + 2)))
+        }
+        val nullCount = if (statistics.length > 0) statistics(i * 4 + 3).toInt else 0
+        stats.update(i * 5 + 2, nullCount)
+        stats.update(i * 5 + 3, numRows)
+        stats.update(i * 5 + 4, 0L)
+    }
+    CachedColumnarBatch(numRows, bytes.length, bytes, stats)
+  }
+}
+
+object ColumnarCachedBatchSerializer {
+  // The types the native serializer computes bounds for.
+  def hasBounds(dataType: DataType): Boolean = dataType match {
+    case BooleanType | ByteType | ShortType | IntegerType | LongType | FloatType | DoubleType |
+        DateType | TimestampType =>
+      true
+    case _ => false
+  }
+
+  def toBound(dataType: DataType, value: Long): Any = dataType match {
+    case BooleanType => value != 0
+    case ByteType => value.toByte
+    case ShortType => value.toShort
+    case IntegerType | DateType => value.toInt
+    case LongType | TimestampType => value
+    case FloatType => java.lang.Double.longBitsToDouble(value).toFloat
+    case DoubleType => java.lang.Double.longBitsToDouble(value)
+  }
+}
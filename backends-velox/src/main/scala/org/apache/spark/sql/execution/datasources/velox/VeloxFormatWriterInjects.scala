@@ -27,9 +27,11 @@ import org.apache.spark.sql.SparkSession
 import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.execution.datasources._
 import org.apache.spark.sql.execution.datasources.GlutenFormatWriterInjectsBase
+import org.apache.spark.sql.execution.utils.ExecUtil
 import org.apache.spark.sql.internal.SQLConf
 import org.apache.spark.sql.types.StructType
 import org.apache.spark.sql.utils.SparkArrowUtil
+import org.apache.spark.sql.vectorized.ColumnarBatch
 
 import com.google.common.base.Preconditions
 import org.apache.arrow.c.ArrowSchema
@@ -66,7 +68,7 @@ trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase {
     val writeQueue =
       new VeloxWriteQueue(instanceId, arrowSchema, allocator, datasourceJniWrapper, originPath)
 
-    new OutputWriter {
+    new OutputWriter with NativeOutputWriter {
       override def write(row: InternalRow): Unit = {
         val batch = row.asInstanceOf[FakeRow].batch
         Preconditions.checkState(ColumnarBatches.isLightBatch(batch))
@@ -76,9 +78,11 @@ trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase {
 
       override def close(): Unit = {
         writeQueue.close()
-        datasourceJniWrapper.close(instanceId)
+        NativeFileStats.put(originPath, datasourceJniWrapper.close(instanceId))
       }
 
+      override def writtenBytes(): Long = datasourceJniWrapper.writtenBytes(instanceId)
+
       // Do NOT add override keyword for compatibility on spark 3.1.
       def path(): String = {
         originPath
@@ -99,7 +103,44 @@ class VeloxRowSplitter extends GlutenRowSplitter {
       row: FakeRow,
       partitionColIndice: Array[Int],
       hasBucket: Boolean): BlockStripes = {
-    throw new UnsupportedOperationException(
-      "VeloxRowSplitter does not support splitBlockByPartitionAndBucket")
+    val batchHandle = ColumnarBatches.getNativeHandle(row.batch)
+    new VeloxBlockStripes(
+      new DatasourceJniWrapper()
+        .splitBlockByPartitionAndBucket(batchHandle, partitionColIndice, hasBucket))
+  }
+}
+
+class VeloxBlockStripes(bs: BlockStripes)
+  extends BlockStripes(
+    bs.originBlockAddress,
+    bs.blockAddresses,
+    bs.headingRowIndice,
+    bs.originBlockNumColumns,
+    bs.noNeedSplit) {
+  // One heading row per stripe.
+  private val headingRows = ColumnarBatches.create(originBlockAddress)
+  private val headingRowIter = ExecUtil.convertColumnarToRow(headingRows)
+  private val stripes = blockAddresses.map(ColumnarBatches.create)
+  private var index = -1
+
+  override def iterator(): java.util.Iterator[BlockStripe] = new java.util.Iterator[BlockStripe] {
+    override def hasNext: Boolean = headingRowIter.hasNext
+
+    override def next(): BlockStripe = {
+      index += 1
+      val headingRow = headingRowIter.next()
+      val stripe = stripes(index)
+      new BlockStripe {
+        override def getColumnarBatch: ColumnarBatch = stripe
+
+        override def getHeadingRow: InternalRow = headingRow
+      }
+    }
+  }
+
+  // The writers retain the stripes they still queue.
+  override def release(): Unit = {
+    stripes.foreach(_.close())
+    headingRows.close()
   }
 }
@@ -55,4 +55,40 @@ public class OnHeapFileSystemTest {
 
     Assert.assertEquals(text, decoded);
   }
+
+  @Test
+  public void testPreadv() {
+    final String path = "/bar";
+    final byte[] bytes = "HELLO WORLD".getBytes(StandardCharsets.UTF_8);
+    JniFilesystem.WriteFile writeFile = fs.openFileForWrite(path);
+    try {
+      ByteBuffer buf = PlatformDependent.allocateDirectNoCleaner(bytes.length);
+      buf.put(bytes);
+      writeFile.append(bytes.length, PlatformDependent.directBufferAddress(buf));
+      writeFile.flush();
+    } finally {
+      writeFile.close();
+    }
+
+    // "HELLO" and "WORLD", skipping the space between them.
+    JniFilesystem.ReadFile readFile = fs.openFileForRead(path);
+    try {
+      ByteBuffer first = PlatformDependent.allocateDirectNoCleaner(5);
+      ByteBuffer second = PlatformDependent.allocateDirectNoCleaner(5);
+      readFile.preadv(
+          new long[] {0, 6},
+          new long[] {5, 5},
+          new long[] {
+            PlatformDependent.directBufferAddress(first),
+            PlatformDependent.directBufferAddress(second)
+          });
+      byte[] out = new byte[5];
+      first.get(out);
+      Assert.assertEquals("HELLO", new String(out, StandardCharsets.UTF_8));
+      second.get(out);
+      Assert.assertEquals("WORLD", new String(out, StandardCharsets.UTF_8));
+    } finally {
+      readFile.close();
+    }
+  }
 }
@@ -18,9 +18,16 @@ package io.glutenproject.execution
 
 import org.apache.spark.SparkConf
 import org.apache.spark.sql.Row
-import org.apache.spark.sql.execution.RDDScanExec
+import org.apache.spark.sql.catalyst.InternalRow
+import org.apache.spark.sql.catalyst.expressions.{AttributeReference, Expression}
+import org.apache.spark.sql.catalyst.plans.physical.RangePartitioning
+import org.apache.spark.sql.execution.{ColumnarShuffleExchangeExec, RDDScanExec}
+import org.apache.spark.sql.execution.joins.{BuildKeySummary, BuildSideRelation}
 import org.apache.spark.sql.functions.{avg, col}
-import org.apache.spark.sql.types.{DecimalType, StringType, StructField, StructType}
+import org.apache.spark.sql.types.{DecimalType, LongType, StringType, StructField, StructType}
+import org.apache.spark.sql.vectorized.ColumnarBatch
+
+import com.google.protobuf.StringValue
 
 import scala.collection.JavaConverters
 
@@ -510,4 +517,104 @@ class TestOperator extends WholeStageTransformerSuite {
       }
     }
   }
+
+  test("hash partition keys hashed by the shuffle writer") {
+    withSQLConf("spark.sql.shuffle.partitions" -> "5") {
+      // The partition ids must be the ones Spark's murmur3 hash gives.
+      runQueryAndCompare(
+        """
+          |select spark_partition_id(), * from
+          |(select l_orderkey, l_discount, l_shipdate, l_comment from lineitem
+          |distribute by l_orderkey, l_discount, l_shipdate, l_comment)
+          |""".stripMargin,
+        noFallBack = false
+      ) {
+        df =>
+          val shuffles = getExecutedPlan(df).collect { case s: ColumnarShuffleExchangeExec => s }
+          assert(shuffles.size == 1)
+          // No projection of the hash column is inserted.
+          assert(shuffles.head.child.output == shuffles.head.output)
+      }
+    }
+  }
+
+  test("range partition ids computed by the shuffle writer") {
+    withSQLConf("spark.sql.shuffle.partitions" -> "5") {
+      // The order across partitions only holds if the rows land in the right ones.
+      runQueryAndCompare(
+        """
+          |select l_orderkey, l_discount, l_shipdate, l_comment from lineitem
+          |order by l_shipdate desc, l_discount nulls last, l_comment, l_orderkey
+          |""".stripMargin
+      ) {
+        df =>
+          val shuffles = getExecutedPlan(df).collect { case s: ColumnarShuffleExchangeExec => s }
+          assert(shuffles.exists(_.outputPartitioning.isInstanceOf[RangePartitioning]))
+      }
+    }
+  }
+
+  test("build key summary of broadcast hash join") {
+    // Without the empty build side being propagated, the join is planned for it too.
+    withSQLConf(
+      "spark.sql.autoBroadcastJoinThreshold" -> "10MB",
+      "spark.sql.adaptive.enabled" -> "false") {
+      Seq("o_orderkey < 100", "o_orderkey < 0").foreach {
+        buildFilter =>
+          // The probe scan is filtered by the summary, the rows not found on the build side only.
+          val df = runQueryAndCompare(
+            s"""
+               |select l_orderkey, l_partkey from lineitem
+               |join (select o_orderkey from orders where $buildFilter) on l_orderkey = o_orderkey
+               |""".stripMargin
+          ) {
+            checkOperatorMatch[GlutenBroadcastHashJoinExecTransformer]
+          }
+          val join = getExecutedPlan(df).collectFirst {
+            case j: GlutenBroadcastHashJoinExecTransformer => j
+          }.get
+          val parameters = StringValue
+            .parseFrom(join.genJoinParametersBuilder(withBuildKeySummary = true).getValue)
+            .getValue
+          val keys = sql(s"select distinct o_orderkey from orders where $buildFilter")
+            .collect()
+            .map(_.getLong(0))
+            .sorted
+          assert(parameters.contains(s"buildKeyValues0=${keys.mkString(",")}\n"))
+          if (keys.nonEmpty) {
+            assert(parameters.contains(s"buildKeyRange0=${keys.head},${keys.last}\n"))
+          } else {
+            assert(!parameters.contains("buildKeyRange0="))
+          }
+      }
+    }
+  }
+
+  test("build key summary is capped and computed once per relation") {
+    val key = AttributeReference("k", LongType)()
+    class CountingRelation extends BuildSideRelation {
+      var numTransforms = 0
+      override def deserialized: Iterator[ColumnarBatch] = Iterator.empty
+      override def transform(key: Expression): Array[InternalRow] = {
+        numTransforms += 1
+        (Seq(null) ++ (5L to 1L by -1) ++ (1L to 5L)).map(InternalRow(_)).toArray
+      }
+      override def asReadOnlyCopy(context: BroadCastHashJoinContext): BuildSideRelation = this
+    }
+    val relation = new CountingRelation
+    assert(
+      BroadcastHashJoinExecTransformer.summarize(relation, key, 5) ==
+        BuildKeySummary(Some((1L, 5L)), Some(Seq("1", "2", "3", "4", "5"))))
+    // The range is still sent beyond the values.
+    assert(
+      BroadcastHashJoinExecTransformer.summarize(relation, key, 4) ==
+        BuildKeySummary(Some((1L, 5L)), None))
+    Seq(5, 4).foreach {
+      maxValues =>
+        relation.keySummary(key) {
+          BroadcastHashJoinExecTransformer.summarize(relation, key, maxValues)
+        }
+    }
+    assert(relation.numTransforms == 3)
+  }
 }
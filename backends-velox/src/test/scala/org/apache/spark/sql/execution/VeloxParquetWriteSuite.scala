@@ -16,14 +16,21 @@
  */
 package org.apache.spark.sql.execution
 
+import io.glutenproject.GlutenConfig
 import io.glutenproject.execution.WholeStageTransformerSuite
 import io.glutenproject.utils.FallbackUtil
 
 import org.apache.spark.SparkConf
 import org.apache.spark.sql.functions.lit
+import org.apache.spark.util.Utils
 
+import org.apache.hadoop.fs.Path
+import org.apache.parquet.hadoop.ParquetFileReader
+import org.apache.parquet.hadoop.util.HadoopInputFile
 import org.junit.Assert
 
+import scala.collection.JavaConverters._
+
 class VeloxParquetWriteSuite extends WholeStageTransformerSuite {
   override protected val backend: String = "velox"
   override protected val resourcePath: String = "/tpch-data-parquet-velox"
@@ -95,6 +102,27 @@ class VeloxParquetWriteSuite extends WholeStageTransformerSuite {
     }
   }
 
+  test("test parquet partitioned write") {
+    withTable("velox_partitioned") {
+      spark.sql(
+        "CREATE TABLE velox_partitioned (c1 BIGINT, s STRING, p INT, q STRING) USING PARQUET " +
+          "PARTITIONED BY (p, q)")
+      spark
+        .range(1000)
+        .selectExpr(
+          "id as c1",
+          "cast(id as string) as s",
+          "cast(id % 7 as int) as p",
+          "concat('q', id % 3) as q")
+        .createOrReplaceTempView("partitioned_temp")
+      // Split natively into the runs of rows of one partition.
+      val df = spark.sql("INSERT OVERWRITE TABLE velox_partitioned SELECT * FROM partitioned_temp")
+      Assert.assertFalse(FallbackUtil.isFallback(df.queryExecution.executedPlan))
+      checkAnswer(spark.table("velox_partitioned"), spark.table("partitioned_temp"))
+      Assert.assertEquals(21, spark.sql("SHOW PARTITIONS velox_partitioned").count())
+    }
+  }
+
   test("test parquet bucket write") {
     withTable("bucket") {
       spark
@@ -108,6 +136,103 @@ class VeloxParquetWriteSuite extends WholeStageTransformerSuite {
     }
   }
 
+  test("parquet row groups are sized by encoded bytes") {
+    withTempPath {
+      f =>
+        val blockSize = 1024 * 1024
+        val df = spark
+          .range(0, 1 << 21, 1, 1)
+          .selectExpr("id % 100 as k", "concat('value-', id % 1000) as s")
+        df.write
+          .format("parquet")
+          .option(GlutenConfig.PARQUET_BLOCK_SIZE, blockSize.toString)
+          .save(f.getCanonicalPath)
+        checkAnswer(spark.read.parquet(f.getCanonicalPath), df)
+
+        val parquetFile = f.listFiles().filter(_.getName.startsWith("part")).head
+        val in = HadoopInputFile.fromPath(
+          new Path(parquetFile.getCanonicalPath),
+          spark.sessionState.newHadoopConf())
+        val sizes = Utils.tryWithResource(ParquetFileReader.open(in)) {
+          reader => reader.getFooter.getBlocks.asScala.map(_.getCompressedSize)
+        }
+        // The dictionary encoded columns are far smaller than their raw bytes, so a cut by raw
+        // bytes would leave every row group well below the target.
+        assert(sizes.size > 1, sizes)
+        assert(sizes.max >= blockSize / 2, sizes)
+        assert(sizes.forall(_ <= 2L * blockSize), sizes)
+    }
+  }
+
+  test("parquet writes needing bloom filters or page indexes fall back") {
+    def readFooters[T](table: String)(f: ParquetFileReader => T): Seq[T] =
+      spark.table(table).inputFiles.toSeq.map {
+        file =>
+          val in = HadoopInputFile.fromPath(new Path(file), spark.sessionState.newHadoopConf())
+          Utils.tryWithResource(ParquetFileReader.open(in))(f)
+      }
+    val query = "SELECT id as c1, cast(id as string) as s FROM range(1000)"
+
+    withTable("velox_bloom") {
+      spark.sql(
+        "CREATE TABLE velox_bloom (c1 BIGINT, s STRING) USING PARQUET " +
+          "OPTIONS ('parquet.bloom.filter.enabled#s' = 'true')")
+      val df = spark.sql(s"INSERT OVERWRITE TABLE velox_bloom $query")
+      Assert.assertTrue(FallbackUtil.isFallback(df.queryExecution.executedPlan))
+      checkAnswer(spark.table("velox_bloom"), spark.sql(query))
+      val bloomFilters = readFooters("velox_bloom") {
+        reader =>
+          val block = reader.getFooter.getBlocks.get(0)
+          val column = block.getColumns.asScala.find(_.getPath.toDotString == "s").get
+          reader.readBloomFilter(column)
+      }
+      assert(bloomFilters.forall(_ != null))
+    }
+
+    withTable("velox_page_index") {
+      spark.sql("CREATE TABLE velox_page_index (c1 BIGINT, s STRING) USING PARQUET")
+      val native = spark.sql(s"INSERT OVERWRITE TABLE velox_page_index $query")
+      Assert.assertFalse(FallbackUtil.isFallback(native.queryExecution.executedPlan))
+
+      withSQLConf(GlutenConfig.NATIVE_PARQUET_WRITE_PAGE_INDEX.key -> "true") {
+        val df = spark.sql(s"INSERT OVERWRITE TABLE velox_page_index $query")
+        Assert.assertTrue(FallbackUtil.isFallback(df.queryExecution.executedPlan))
+      }
+      checkAnswer(spark.table("velox_page_index"), spark.sql(query))
+      val columnIndexes = readFooters("velox_page_index") {
+        reader =>
+          val columns = reader.getFooter.getBlocks.get(0).getColumns.asScala
+          columns.map(reader.readColumnIndex)
+      }
+      assert(columnIndexes.flatten.forall(_ != null))
+    }
+  }
+
+  test("parquet files rolled at the max file bytes") {
+    val maxFileBytes = 1024 * 1024
+    withSQLConf(GlutenConfig.NATIVE_WRITER_MAX_FILE_BYTES.key -> maxFileBytes.toString) {
+      withTable("velox_rolled") {
+        spark.sql(
+          "CREATE TABLE velox_rolled (c1 BIGINT, s STRING, p INT) USING PARQUET " +
+            "PARTITIONED BY (p)")
+        // Of one task, hardly compressible.
+        val query = "SELECT id as c1, sha2(cast(id as string), 256) as s, " +
+          "cast(id % 2 as int) as p FROM range(0, 200000, 1, 1)"
+        val df = spark.sql(s"INSERT OVERWRITE TABLE velox_rolled $query")
+        Assert.assertFalse(FallbackUtil.isFallback(df.queryExecution.executedPlan))
+        checkAnswer(spark.table("velox_rolled"), spark.sql(query))
+
+        val files = spark.table("velox_rolled").inputFiles.map(file => new Path(file))
+        val fs = files.head.getFileSystem(spark.sessionState.newHadoopConf())
+        files.groupBy(_.getParent).foreach {
+          case (partition, partitionFiles) => assert(partitionFiles.length > 1, partition)
+        }
+        // Checked between batches, so a file overshoots by up to one.
+        files.foreach(file => assert(fs.getFileStatus(file).getLen <= 2L * maxFileBytes, file))
+      }
+    }
+  }
+
   test("parquet write with empty dataframe") {
     withTempPath {
       f =>
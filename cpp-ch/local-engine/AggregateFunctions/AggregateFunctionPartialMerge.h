@@ -91,6 +91,26 @@ public:
         nested_func->merge(place, assert_cast<const ColumnAggregateFunction &>(*columns[0]).getData()[row_num], arena);
     }
 
+    /// Merges the states of the rows through the nested mergeBatch, which calls its merge without a virtual call per row.
+    void addBatch(
+        size_t row_begin,
+        size_t row_end,
+        AggregateDataPtr * places,
+        size_t place_offset,
+        const IColumn ** columns,
+        Arena * arena,
+        ssize_t if_argument_pos) const override
+    {
+        if (if_argument_pos >= 0)
+        {
+            IAggregateFunctionHelper<AggregateFunctionPartialMerge>::addBatch(
+                row_begin, row_end, places, place_offset, columns, arena, if_argument_pos);
+            return;
+        }
+        const auto & states = assert_cast<const ColumnAggregateFunction &>(*columns[0]).getData();
+        nested_func->mergeBatch(row_begin, row_end, places, place_offset, states.data(), arena);
+    }
+
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs, Arena * arena) const override
     {
         nested_func->merge(place, rhs, arena);
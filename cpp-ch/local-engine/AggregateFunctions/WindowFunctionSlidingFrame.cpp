@@ -0,0 +1,289 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <deque>
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <AggregateFunctions/IAggregateFunction.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Processors/Transforms/WindowTransform.h>
+#include <Common/assert_cast.h>
+
+using namespace DB;
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+    extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+    extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+}
+}
+
+namespace local_engine
+{
+namespace
+{
+    /// The states of the aggregates over a frame of integers, which rows enter at the end and leave at the start of.
+
+    template <typename T>
+    struct SlidingSumState
+    {
+        using Result = std::conditional_t<std::is_signed_v<T>, Int64, UInt64>;
+        /// Wraps around as the sum function does, a value removed cancels the one added exactly.
+        UInt64 sum = 0;
+        size_t count = 0;
+
+        void reset() { *this = {}; }
+        void add(T value, const RowNumber &)
+        {
+            sum += static_cast<UInt64>(static_cast<Result>(value));
+            ++count;
+        }
+        void remove(T value, const RowNumber &)
+        {
+            sum -= static_cast<UInt64>(static_cast<Result>(value));
+            --count;
+        }
+        bool empty() const { return count == 0; }
+        Result result() const { return static_cast<Result>(sum); }
+    };
+
+    /// Of the rows whose argument isn't null, of any type.
+    template <typename T>
+    struct SlidingCountState
+    {
+        using Result = UInt64;
+        static constexpr bool is_count = true;
+        UInt64 count = 0;
+
+        void reset() { count = 0; }
+        void add(T, const RowNumber &) { ++count; }
+        void remove(T, const RowNumber &) { --count; }
+        bool empty() const { return false; }
+        Result result() const { return count; }
+    };
+
+    /// The values of the frame that no later value is less (or greater) than, in the order of the rows. The front is
+    /// the minimum (or maximum) of the frame, each row enters and leaves it at most once.
+    template <typename T, bool is_min>
+    struct SlidingExtremeState
+    {
+        using Result = T;
+        std::deque<std::pair<RowNumber, T>> candidates;
+
+        void reset() { candidates.clear(); }
+        void add(T value, const RowNumber & row)
+        {
+            while (!candidates.empty() && (is_min ? value <= candidates.back().second : value >= candidates.back().second))
+                candidates.pop_back();
+            candidates.emplace_back(row, value);
+        }
+        void remove(T, const RowNumber & row)
+        {
+            if (!candidates.empty() && candidates.front().first == row)
+                candidates.pop_front();
+        }
+        bool empty() const { return candidates.empty(); }
+        Result result() const { return candidates.front().second; }
+    };
+
+    template <typename State>
+    constexpr bool isCount()
+    {
+        return requires { State::is_count; };
+    }
+
+    /// Aggregate of a ROWS frame with an offset start, updated by the rows entering and leaving the frame since the frame
+    /// of the previous row rather than computed over the whole frame for each row as WindowTransform does for the
+    /// aggregate functions.
+    template <typename T, typename State>
+    class WindowFunctionSlidingFrame final : public IAggregateFunctionDataHelper<State, WindowFunctionSlidingFrame<T, State>>,
+                                            public IWindowFunction
+    {
+    public:
+        WindowFunctionSlidingFrame(const String & name_, const DataTypes & argument_types_, const DataTypePtr & result_type_)
+            : IAggregateFunctionDataHelper<State, WindowFunctionSlidingFrame<T, State>>(argument_types_, {}, result_type_)
+            , name(name_)
+            , result_nullable(result_type_->isNullable())
+        {
+        }
+
+        String getName() const override { return name; }
+        bool isOnlyWindowFunction() const override { return true; }
+        bool allocatesMemoryInArena() const override { return false; }
+
+        /// Skips the null arguments itself.
+        AggregateFunctionPtr getOwnNullAdapter(
+            const AggregateFunctionPtr &, const DataTypes & arguments, const Array &, const AggregateFunctionProperties &) const override;
+
+        void add(AggregateDataPtr __restrict, const IColumn **, size_t, Arena *) const override { fail(); }
+        void merge(AggregateDataPtr __restrict, ConstAggregateDataPtr, Arena *) const override { fail(); }
+        void serialize(ConstAggregateDataPtr __restrict, WriteBuffer &, std::optional<size_t>) const override { fail(); }
+        void deserialize(AggregateDataPtr __restrict, ReadBuffer &, std::optional<size_t>, Arena *) const override { fail(); }
+        void insertResultInto(AggregateDataPtr __restrict, IColumn &, Arena *) const override { fail(); }
+
+        void windowInsertResultInto(const WindowTransform * transform, size_t function_index) const override
+        {
+            const auto & workspace = transform->workspaces[function_index];
+            auto & state = *static_cast<State *>(static_cast<void *>(workspace.aggregate_function_state.data()));
+            const size_t column_index = workspace.argument_column_indices[0];
+
+            /// Within a partition the start and the end of such frames never move back, the frame of its first row is
+            /// computed entirely.
+            RowNumber row = transform->frame_start;
+            if (transform->prev_frame_start <= transform->frame_start && transform->frame_start < transform->prev_frame_end
+                && transform->prev_frame_end <= transform->frame_end)
+            {
+                for (auto i = transform->prev_frame_start; i < transform->frame_start; transform->advanceRowNumber(i))
+                    if (auto value = valueAt(transform, column_index, i))
+                        state.remove(*value, i);
+                row = transform->prev_frame_end;
+            }
+            else
+                state.reset();
+            for (; row < transform->frame_end; transform->advanceRowNumber(row))
+                if (auto value = valueAt(transform, column_index, row))
+                    state.add(*value, row);
+
+            IColumn & to = *transform->blockAt(transform->current_row).output_columns[function_index];
+            if (!result_nullable)
+            {
+                assert_cast<ColumnVector<typename State::Result> &>(to).getData().push_back(
+                    state.empty() ? typename State::Result{} : state.result());
+                return;
+            }
+            auto & nullable_to = assert_cast<ColumnNullable &>(to);
+            if (state.empty())
+            {
+                nullable_to.insertDefault();
+                return;
+            }
+            assert_cast<ColumnVector<typename State::Result> &>(nullable_to.getNestedColumn()).getData().push_back(state.result());
+            nullable_to.getNullMapData().push_back(0);
+        }
+
+    private:
+        static std::optional<T> valueAt(const WindowTransform * transform, size_t column_index, const RowNumber & row)
+        {
+            const auto * column = transform->blockAt(row).input_columns[column_index].get();
+            if (const auto * nullable = checkAndGetColumn<ColumnNullable>(column))
+            {
+                if (nullable->isNullAt(row.row))
+                    return {};
+                column = &nullable->getNestedColumn();
+            }
+            if constexpr (isCount<State>())
+                return T{};
+            else
+                return assert_cast<const ColumnVector<T> &>(*column).getData()[row.row];
+        }
+
+        [[noreturn]] void fail() const
+        {
+            throw Exception(ErrorCodes::BAD_ARGUMENTS, "The function '{}' can only be used as a window function", name);
+        }
+
+        String name;
+        bool result_nullable;
+    };
+
+    template <template <typename> typename State>
+    AggregateFunctionPtr createSlidingFrame(const String & name, const DataTypes & arguments)
+    {
+        if (arguments.size() != 1)
+            throw Exception(ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH, "Function {} requires one argument", name);
+
+        auto make = [&]<typename T>() -> AggregateFunctionPtr
+        {
+            using Result = typename State<T>::Result;
+            DataTypePtr result_type = std::make_shared<DataTypeNumber<Result>>();
+            if (arguments[0]->isNullable() && !isCount<State<T>>())
+                result_type = makeNullable(result_type);
+            return std::make_shared<WindowFunctionSlidingFrame<T, State<T>>>(name, arguments, result_type);
+        };
+        if constexpr (isCount<State<UInt8>>())
+            return make.template operator()<UInt8>();
+        else
+        {
+            switch (WhichDataType(removeNullable(arguments[0])).idx)
+            {
+                case TypeIndex::UInt8:
+                    return make.template operator()<UInt8>();
+                case TypeIndex::UInt16:
+                    return make.template operator()<UInt16>();
+                case TypeIndex::UInt32:
+                    return make.template operator()<UInt32>();
+                case TypeIndex::UInt64:
+                    return make.template operator()<UInt64>();
+                case TypeIndex::Int8:
+                    return make.template operator()<Int8>();
+                case TypeIndex::Int16:
+                    return make.template operator()<Int16>();
+                case TypeIndex::Int32:
+                    return make.template operator()<Int32>();
+                case TypeIndex::Int64:
+                    return make.template operator()<Int64>();
+                default:
+                    throw Exception(
+                        ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}", arguments[0]->getName(), name);
+            }
+        }
+    }
+
+    template <typename T>
+    using SlidingMinState = SlidingExtremeState<T, true>;
+    template <typename T>
+    using SlidingMaxState = SlidingExtremeState<T, false>;
+
+    template <typename T, typename State>
+    AggregateFunctionPtr WindowFunctionSlidingFrame<T, State>::getOwnNullAdapter(
+        const AggregateFunctionPtr &, const DataTypes & arguments, const Array &, const AggregateFunctionProperties &) const
+    {
+        if constexpr (std::is_same_v<State, SlidingSumState<T>>)
+            return createSlidingFrame<SlidingSumState>(name, arguments);
+        else if constexpr (std::is_same_v<State, SlidingCountState<T>>)
+            return createSlidingFrame<SlidingCountState>(name, arguments);
+        else if constexpr (std::is_same_v<State, SlidingMinState<T>>)
+            return createSlidingFrame<SlidingMinState>(name, arguments);
+        else
+            return createSlidingFrame<SlidingMaxState>(name, arguments);
+    }
+
+    template <template <typename> typename State>
+    void registerSlidingFrame(AggregateFunctionFactory & factory, const String & name)
+    {
+        AggregateFunctionProperties properties;
+        properties.is_order_dependent = true;
+        factory.registerFunction(
+            name,
+            {[](const String & function_name, const DataTypes & arguments, const Array &, const Settings *)
+             { return createSlidingFrame<State>(function_name, arguments); },
+             properties});
+    }
+}
+
+void registerWindowFunctionsSlidingFrame(AggregateFunctionFactory & factory)
+{
+    registerSlidingFrame<SlidingSumState>(factory, "slidingSumInFrame");
+    registerSlidingFrame<SlidingCountState>(factory, "slidingCountInFrame");
+    registerSlidingFrame<SlidingMinState>(factory, "slidingMinInFrame");
+    registerSlidingFrame<SlidingMaxState>(factory, "slidingMaxInFrame");
+}
+}
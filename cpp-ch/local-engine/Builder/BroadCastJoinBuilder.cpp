@@ -24,6 +24,7 @@
 #include <Common/CurrentThread.h>
 #include <Common/JNIUtils.h>
 #include <Common/MemoryTracker.h>
+#include <Common/Stopwatch.h>
 #include <Common/ThreadPool.h>
 #include <Common/logger_useful.h>
 
@@ -78,6 +79,7 @@ namespace BroadCastJoinBuilder
         {
             try
             {
+                Stopwatch watch;
                 result = std::make_shared<StorageJoinFromReadBuffer>(
                     std::make_unique<ReadBufferFromJavaInputStream>(context.input, context.io_buffer_size),
                     context.key_names,
@@ -89,7 +91,13 @@ namespace BroadCastJoinBuilder
                     ConstraintsDescription(),
                     context.key,
                     true);
-                LOG_DEBUG(&Poco::Logger::get("BroadCastJoinBuilder"), "Create broadcast storage join {}.", context.key);
+                LOG_INFO(
+                    &Poco::Logger::get("BroadCastJoinBuilder"),
+                    "Create broadcast storage join {} of {} rows and {} bytes in {} ms.",
+                    context.key,
+                    result->getTotalRowCount(),
+                    result->getTotalByteCount(),
+                    watch.elapsedMilliseconds());
             }
             catch (DB::Exception & e)
             {
@@ -15,9 +15,11 @@
  * limitations under the License.
  */
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <optional>
 #include <AggregateFunctions/AggregateFunctionCombinatorFactory.h>
+#include <AggregateFunctions/AggregateFunctionFactory.h>
 #include <AggregateFunctions/registerAggregateFunctions.h>
 #include <Columns/ColumnArray.h>
 #include <Columns/ColumnConst.h>
@@ -50,11 +52,13 @@
 #include <QueryPipeline/printPipeline.h>
 #include <Storages/Output/WriteBufferBuilder.h>
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
+#include <jni/ReservationListenerWrapper.h>
 #include <Poco/Logger.h>
 #include <Poco/Util/MapConfiguration.h>
 #include <Common/Config/ConfigProcessor.h>
 #include <Common/GlutenSignalHandler.h>
 #include <Common/Logger.h>
+#include <Common/Stopwatch.h>
 #include <Common/logger_useful.h>
 #include <Common/typeid_cast.h>
 
@@ -118,6 +122,29 @@ DB::Block BlockUtil::buildHeader(const DB::NamesAndTypesList & names_types_list)
     return DB::Block(cols);
 }
 
+size_t BlockUtil::estimateRowBytes(const DB::Block & block)
+{
+    size_t rows = block.rows();
+    size_t bytes = 0;
+    for (const auto & elem : block)
+    {
+        if (rows && elem.column)
+            bytes += elem.column->byteSize() / rows;
+        else if (elem.type->haveMaximumSizeOfValue())
+            bytes += elem.type->getMaximumSizeOfValueInMemory();
+        else
+            bytes += ESTIMATED_VARIABLE_VALUE_BYTES;
+    }
+    return std::max<size_t>(bytes, 1);
+}
+
+size_t BlockUtil::adaptiveBlockRows(const DB::Block & block, size_t max_rows, size_t target_bytes)
+{
+    if (!target_bytes)
+        return max_rows;
+    return std::clamp<size_t>(target_bytes / estimateRowBytes(block), 1, std::max<size_t>(max_rows, 1));
+}
+
 /**
  * There is a special case with which we need be careful. In spark, struct/map/list are always
  * wrapped in Nullable, but this should not happen in clickhouse.
@@ -259,6 +286,15 @@ std::string PlanUtil::explainPlan(DB::QueryPlan & plan)
     return plan_str;
 }
 
+namespace
+{
+bool isMergeTreePart(const fs::path & path)
+{
+    auto filename = path.filename();
+    return filename != "format_version.txt" && filename != "detached" && filename != "_delta_log";
+}
+}
+
 std::vector<MergeTreeUtil::Path> MergeTreeUtil::getAllMergeTreeParts(const Path & storage_path)
 {
     if (!fs::exists(storage_path))
@@ -270,14 +306,27 @@ std::vector<MergeTreeUtil::Path> MergeTreeUtil::getAllMergeTreeParts(const Path
     std::vector<fs::path> res;
     for (const auto & entry : fs::directory_iterator(storage_path))
     {
-        auto filename = entry.path().filename();
-        if (filename == "format_version.txt" || filename == "detached" || filename == "_delta_log")
-            continue;
-        res.push_back(entry.path());
+        if (isMergeTreePart(entry.path()))
+            res.push_back(entry.path());
     }
     return res;
 }
 
+std::optional<MergeTreeUtil::Path> MergeTreeUtil::getAnyMergeTreePart(const Path & storage_path)
+{
+    if (!fs::exists(storage_path))
+    {
+        throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Invalid merge tree store path:{}", storage_path.string());
+    }
+
+    for (const auto & entry : fs::directory_iterator(storage_path))
+    {
+        if (isMergeTreePart(entry.path()))
+            return entry.path();
+    }
+    return std::nullopt;
+}
+
 DB::NamesAndTypesList MergeTreeUtil::getSchemaFromMergeTreePart(const fs::path & part_path)
 {
     DB::NamesAndTypesList names_types_list;
@@ -590,6 +639,19 @@ void BackendInitializerUtil::initSettings(std::map<std::string, std::string> & b
         }
     }
 
+    /// Aggregations and sorts spill to the temporary path once they take half of the off-heap memory of a task, unless
+    /// their thresholds are set.
+    if (auto task_memory = backend_conf_map.find(GLUTEN_TASK_OFFHEAP); task_memory != backend_conf_map.end())
+    {
+        /// Also for the shuffled hash joins, see SerializedPlanParser::parseJoin.
+        settings.set(GLUTEN_TASK_OFFHEAP, task_memory->second);
+        UInt64 spill_threshold = std::stoull(task_memory->second) / 2;
+        if (!settings.isChanged("max_bytes_before_external_group_by"))
+            settings.set("max_bytes_before_external_group_by", spill_threshold);
+        if (!settings.isChanged("max_bytes_before_external_sort"))
+            settings.set("max_bytes_before_external_sort", spill_threshold);
+    }
+
     /// Finally apply some fixed kvs to settings.
     settings.set("join_use_nulls", true);
     settings.set("input_format_orc_allow_missing_columns", true);
@@ -651,11 +713,11 @@ void BackendInitializerUtil::updateNewSettings(
 }
 
 extern void registerAggregateFunctionCombinatorPartialMerge(AggregateFunctionCombinatorFactory &);
+extern void registerWindowFunctionsSlidingFrame(AggregateFunctionFactory &);
 extern void registerFunctions(FunctionFactory &);
 
-void registerAllFunctions()
+static void registerAllAggregateFunctions()
 {
-    DB::registerFunctions();
     DB::registerAggregateFunctions();
 
     {
@@ -663,20 +725,46 @@ void registerAllFunctions()
         auto & factory = AggregateFunctionCombinatorFactory::instance();
         registerAggregateFunctionCombinatorPartialMerge(factory);
     }
+
+    {
+        /// register window functions from local_engine
+        auto & factory = AggregateFunctionFactory::instance();
+        registerWindowFunctionsSlidingFrame(factory);
+    }
 }
 
-void BackendInitializerUtil::registerAllFactories()
+void registerAllFunctions()
 {
-    registerReadBufferBuilders();
-    registerWriteBufferBuilders();
-
-    LOG_INFO(logger, "Register read buffer builders.");
+    DB::registerFunctions();
+    registerAllAggregateFunctions();
+}
 
-    registerRelParsers();
-    LOG_INFO(logger, "Register relation parsers.");
+void BackendInitializerUtil::registerAllFactories()
+{
+    /// The factories don't depend on each other. The scalar functions take most of the time, the other factories are
+    /// registered meanwhile.
+    auto others = std::async(
+        std::launch::async,
+        []
+        {
+            Stopwatch watch;
+            registerReadBufferBuilders();
+            registerWriteBufferBuilders();
+            registerRelParsers();
+            registerAllAggregateFunctions();
+            return watch.elapsedMilliseconds();
+        });
 
-    registerAllFunctions();
-    LOG_INFO(logger, "Register all functions.");
+    Stopwatch watch;
+    DB::registerFunctions();
+    auto functions_ms = watch.elapsedMilliseconds();
+    auto others_ms = others.get();
+    LOG_INFO(
+        logger,
+        "Register all factories in {} ms: functions {} ms, aggregate functions, buffer builders and relation parsers {} ms.",
+        watch.elapsedMilliseconds(),
+        functions_ms,
+        others_ms);
 }
 
 void BackendInitializerUtil::initCompiledExpressionCache(DB::Context::ConfigurationPtr config)
@@ -701,18 +789,30 @@ void BackendInitializerUtil::init(std::string * plan)
 
     initLoggers(config);
 
+    /// The time of each phase, logged with it.
+    Stopwatch total_watch;
+    Stopwatch watch;
+    auto log_phase = [&](std::string_view phase)
+    {
+        LOG_INFO(logger, "{} in {} ms.", phase, watch.elapsedMilliseconds());
+        watch.restart();
+    };
+
+    ReservationListenerWrapper::reservation_block_size
+        = config->getInt64("reservation_block_size", ReservationListenerWrapper::reservation_block_size);
+
     initEnvs(config);
-    LOG_INFO(logger, "Init environment variables.");
+    log_phase("Init environment variables");
 
     DB::Settings settings;
     initSettings(backend_conf_map, settings);
-    LOG_INFO(logger, "Init settings.");
+    log_phase("Init settings");
 
     initContexts(config);
-    LOG_INFO(logger, "Init shared context and global context.");
+    log_phase("Init shared context and global context");
 
     applyGlobalConfigAndSettings(config, settings);
-    LOG_INFO(logger, "Apply configuration and setting for global context.");
+    log_phase("Apply configuration and setting for global context");
 
     ReadBufferBuilderFactory::instance().clean();
 
@@ -723,10 +823,10 @@ void BackendInitializerUtil::init(std::string * plan)
             SignalHandler::instance().init();
 
             registerAllFactories();
-            LOG_INFO(logger, "Register all factories.");
+            watch.restart();
 
             initCompiledExpressionCache(config);
-            LOG_INFO(logger, "Init compiled expressions cache factory.");
+            log_phase("Init compiled expressions cache factory");
 
             GlobalThreadPool::initialize();
 
@@ -735,7 +835,9 @@ void BackendInitializerUtil::init(std::string * plan)
                 active_parts_loading_threads,
                 0, // We don't need any threads one all the parts will be loaded
                 active_parts_loading_threads);
+            log_phase("Init thread pools");
         });
+    LOG_INFO(logger, "Init backend in {} ms.", total_watch.elapsedMilliseconds());
 }
 
 void BackendInitializerUtil::updateConfig(DB::ContextMutablePtr context, std::string * plan)
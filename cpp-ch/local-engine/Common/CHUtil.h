@@ -16,6 +16,7 @@
  */
 #pragma once
 #include <filesystem>
+#include <optional>
 #include <Builder/BroadCastJoinBuilder.h>
 #include <Columns/IColumn.h>
 #include <Core/Block.h>
@@ -45,6 +46,13 @@ public:
 
     static DB::Block buildHeader(const DB::NamesAndTypesList & names_types_list);
 
+    /// Estimated bytes of a row, from the columns if the block has rows, or else from the value sizes of the types, taking
+    /// those of variable size as ESTIMATED_VARIABLE_VALUE_BYTES.
+    static constexpr size_t ESTIMATED_VARIABLE_VALUE_BYTES = 32;
+    static size_t estimateRowBytes(const DB::Block & block);
+    /// Rows of blocks of about target_bytes, at most max_rows, or max_rows if target_bytes is 0.
+    static size_t adaptiveBlockRows(const DB::Block & block, size_t max_rows, size_t target_bytes);
+
     static constexpr UInt64 FLAT_STRUCT = 1;
     static constexpr UInt64 FLAT_NESTED_TABLE = 2;
     // flatten the struct and array(struct) columns.
@@ -86,6 +94,8 @@ class MergeTreeUtil
 public:
     using Path = std::filesystem::path;
     static std::vector<Path> getAllMergeTreeParts(const Path & storage_path);
+    /// The first part directory found, without listing the others.
+    static std::optional<Path> getAnyMergeTreePart(const Path & storage_path);
     static DB::NamesAndTypesList getSchemaFromMergeTreePart(const Path & part_path);
 };
 
@@ -132,6 +142,7 @@ public:
     inline static const String CH_RUNTIME_SETTINGS_PREFIX = CH_BACKEND_PREFIX + "." + CH_RUNTIME_SETTINGS + ".";
 
     inline static const String SETTINGS_PATH = "local_engine.settings";
+    inline static const String GLUTEN_TASK_OFFHEAP = "spark.gluten.memory.task.offHeap.size.in.bytes";
     inline static const String LIBHDFS3_CONF_KEY = "hdfs.libhdfs3_conf";
     inline static const std::string HADOOP_S3_ACCESS_KEY = "fs.s3a.access.key";
     inline static const std::string HADOOP_S3_SECRET_KEY = "fs.s3a.secret.key";
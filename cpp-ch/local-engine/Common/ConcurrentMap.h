@@ -16,26 +16,30 @@
  */
 #pragma once
 
+#include <array>
 #include <mutex>
 #include <unordered_map>
 
 namespace local_engine
 {
+/// Keys are spread over shards with their own lock, so that concurrent tasks working on different keys don't contend.
 template <typename K, typename V>
 class ConcurrentMap
 {
 public:
     void insert(const K & key, const V & value)
     {
-        std::lock_guard lock{mutex};
-        map.insert({key, value});
+        auto & shard = shardOf(key);
+        std::lock_guard lock{shard.mutex};
+        shard.map.insert({key, value});
     }
 
     V get(const K & key)
     {
-        std::lock_guard lock{mutex};
-        auto it = map.find(key);
-        if (it == map.end())
+        auto & shard = shardOf(key);
+        std::lock_guard lock{shard.mutex};
+        auto it = shard.map.find(key);
+        if (it == shard.map.end())
         {
             return nullptr;
         }
@@ -44,24 +48,42 @@ public:
 
     void erase(const K & key)
     {
-        std::lock_guard lock{mutex};
-        map.erase(key);
+        auto & shard = shardOf(key);
+        std::lock_guard lock{shard.mutex};
+        shard.map.erase(key);
     }
 
     void clear()
     {
-        std::lock_guard lock{mutex};
-        map.clear();
+        for (auto & shard : shards)
+        {
+            std::lock_guard lock{shard.mutex};
+            shard.map.clear();
+        }
     }
 
     size_t size() const
     {
-        std::lock_guard lock{mutex};
-        return map.size();
+        size_t result = 0;
+        for (const auto & shard : shards)
+        {
+            std::lock_guard lock{shard.mutex};
+            result += shard.map.size();
+        }
+        return result;
     }
 
 private:
-    std::unordered_map<K, V> map;
-    mutable std::mutex mutex;
+    static constexpr size_t num_shards = 64;
+
+    struct alignas(64) Shard
+    {
+        std::unordered_map<K, V> map;
+        mutable std::mutex mutex;
+    };
+
+    Shard & shardOf(const K & key) { return shards[std::hash<K>{}(key) % num_shards]; }
+
+    std::array<Shard, num_shards> shards;
 };
 }
@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FragmentResultCache.h"
+#include <filesystem>
+#include <Interpreters/Context.h>
+#include <Poco/URI.h>
+#include <Common/SipHash.h>
+#include <Common/logger_useful.h>
+
+namespace local_engine
+{
+namespace
+{
+/// A remote file without the modification time from the plan isn't told apart from a changed one, as getting it costs a
+/// request per file.
+std::optional<String> getFileIdentity(const FragmentResultCache::File & file)
+{
+    const auto & uri = file.uri;
+    if (file.modification_time)
+        return uri + "#" + std::to_string(file.modification_time);
+    Poco::URI file_uri(uri);
+    if (file_uri.getScheme() != "file")
+        return std::nullopt;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(file_uri.getPath(), ec);
+    if (ec)
+        return std::nullopt;
+    auto modification_time = std::filesystem::last_write_time(file_uri.getPath(), ec);
+    if (ec)
+        return std::nullopt;
+    return uri + "#" + std::to_string(size) + "#" + std::to_string(modification_time.time_since_epoch().count());
+}
+}
+
+FragmentResultCache::FragmentResultCache(size_t max_size, size_t max_entry_size_) : cache(max_size), max_entry_size(max_entry_size_)
+{
+}
+
+FragmentResultCache * FragmentResultCache::instance(const DB::ContextPtr & context)
+{
+    const auto & config = context->getConfigRef();
+    static size_t max_size = config.getUInt64("fragment_result_cache.max_size", 0);
+    if (!max_size)
+        return nullptr;
+    static FragmentResultCache cache(max_size, config.getUInt64("fragment_result_cache.max_entry_size", max_size / 16));
+    return &cache;
+}
+
+std::optional<FragmentResultCache::Key>
+FragmentResultCache::getKey(const String & plan, const String & conf, const std::vector<File> & files)
+{
+    SipHash hash;
+    hash.update(plan);
+    hash.update(conf);
+    for (const auto & file : files)
+    {
+        auto identity = getFileIdentity(file);
+        if (!identity)
+            return std::nullopt;
+        hash.update(*identity);
+    }
+    Key key;
+    hash.get128(key);
+    return key;
+}
+
+FragmentResultReader::FragmentResultReader(FragmentResultCache::Entry entry_)
+    : entry(std::move(entry_)), in(*entry), compressed_in(in), reader(compressed_in, 0)
+{
+}
+
+FragmentResultWriter::FragmentResultWriter(FragmentResultCache & cache_, FragmentResultCache::Key key_)
+    : cache(cache_)
+    , key(key_)
+    , out(std::make_unique<DB::WriteBufferFromOwnString>())
+    , compressed_out(std::make_unique<DB::CompressedWriteBuffer>(*out))
+{
+}
+
+FragmentResultWriter::~FragmentResultWriter()
+{
+    /// The fragment didn't finish.
+    reset();
+}
+
+void FragmentResultWriter::write(const DB::Block & block)
+{
+    if (!out || !block.rows())
+        return;
+    if (!writer)
+        writer = std::make_unique<DB::NativeWriter>(*compressed_out, 0, block.cloneEmpty());
+    writer->write(block);
+    if (out->count() + compressed_out->offset() > cache.getMaxEntrySize())
+        reset();
+}
+
+void FragmentResultWriter::finish()
+{
+    if (!out)
+        return;
+    compressed_out->finalize();
+    out->finalize();
+    auto entry = std::make_shared<const String>(std::move(out->str()));
+    LOG_DEBUG(&Poco::Logger::get("FragmentResultCache"), "Cached the output of a fragment in {} bytes", entry->size());
+    cache.set(key, entry);
+    reset();
+}
+
+void FragmentResultWriter::reset()
+{
+    if (!out)
+        return;
+    writer.reset();
+    compressed_out->finalize();
+    compressed_out.reset();
+    out->finalize();
+    out.reset();
+}
+}
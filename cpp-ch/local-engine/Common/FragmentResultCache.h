@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <optional>
+#include <Compression/CompressedReadBuffer.h>
+#include <Compression/CompressedWriteBuffer.h>
+#include <Core/Block.h>
+#include <Formats/NativeReader.h>
+#include <Formats/NativeWriter.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/WriteBufferFromString.h>
+#include <Interpreters/Context_fwd.h>
+#include <base/types.h>
+#include <Common/CacheBase.h>
+#include <Common/HashTable/Hash.h>
+
+namespace local_engine
+{
+/// Executor wide cache of the output of the fragments reading only files, so that a fragment run again over the same
+/// splits of unchanged files replays its output instead of executing. An entry is the output in the compressed native
+/// format of the shuffle. The cache is bounded by the config fragment_result_cache.max_size, 0 turning it off, and the
+/// output of a fragment over fragment_result_cache.max_entry_size isn't kept.
+class FragmentResultCache
+{
+public:
+    using Key = UInt128;
+    using Entry = std::shared_ptr<const String>;
+
+    /// A file the fragment reads, with the modification time in milliseconds the plan carries, 0 if unknown.
+    struct File
+    {
+        String uri;
+        UInt64 modification_time = 0;
+    };
+
+    /// Null if the cache is off.
+    static FragmentResultCache * instance(const DB::ContextPtr & context);
+
+    /// Only tests make their own, the others use instance().
+    FragmentResultCache(size_t max_size, size_t max_entry_size_);
+
+    /// The key of the fragment of the serialized plan reading the files, with the config the task runs with. Absent
+    /// if a file can't be told apart from a changed one: files are told by the modification time the plan carries, or
+    /// local ones by their size and modification time on disk, others aren't cached.
+    static std::optional<Key> getKey(const String & plan, const String & conf, const std::vector<File> & files);
+
+    Entry get(const Key & key) { return cache.get(key); }
+    void set(const Key & key, const Entry & entry) { cache.set(key, std::const_pointer_cast<String>(entry)); }
+    size_t getMaxEntrySize() const { return max_entry_size; }
+
+private:
+    struct EntryWeight
+    {
+        size_t operator()(const String & entry) const { return entry.size(); }
+    };
+
+    DB::CacheBase<Key, String, UInt128TrivialHash, EntryWeight> cache;
+    size_t max_entry_size;
+};
+
+/// Replays the blocks of an entry.
+class FragmentResultReader
+{
+public:
+    explicit FragmentResultReader(FragmentResultCache::Entry entry_);
+    /// Without columns once done.
+    DB::Block read() { return reader.read(); }
+
+private:
+    FragmentResultCache::Entry entry;
+    DB::ReadBufferFromString in;
+    DB::CompressedReadBuffer compressed_in;
+    DB::NativeReader reader;
+};
+
+/// Writes the blocks of the output of a fragment, set in the cache once the fragment is done unless they got over the
+/// size of an entry.
+class FragmentResultWriter
+{
+public:
+    FragmentResultWriter(FragmentResultCache & cache_, FragmentResultCache::Key key_);
+    ~FragmentResultWriter();
+    void write(const DB::Block & block);
+    void finish();
+
+private:
+    FragmentResultCache & cache;
+    FragmentResultCache::Key key;
+    /// Reset once over the size of an entry.
+    std::unique_ptr<DB::WriteBufferFromOwnString> out;
+    std::unique_ptr<DB::CompressedWriteBuffer> compressed_out;
+    std::unique_ptr<DB::NativeWriter> writer;
+
+    /// Drops what was written.
+    void reset();
+};
+}
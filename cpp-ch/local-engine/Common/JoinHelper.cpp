@@ -39,6 +39,16 @@ JoinOptimizationInfo parseJoinOptimizationInfo(const std::string & optimization)
         readString(info.storage_join_key, in);
         assertChar('\n', in);
     }
+    /// The other parameters, one key=value per line.
+    while (!in.eof())
+    {
+        String line;
+        readString(line, in);
+        assertChar('\n', in);
+        auto pos = line.find('=');
+        if (pos != String::npos && line.substr(0, pos) == "buildSideBytes")
+            info.build_side_bytes = std::max<Int64>(0, std::stoll(line.substr(pos + 1)));
+    }
     return info;
 }
 }
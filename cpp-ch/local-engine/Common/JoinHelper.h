@@ -24,6 +24,8 @@ struct JoinOptimizationInfo
     bool is_broadcast;
     bool is_null_aware_anti_join;
     std::string storage_join_key;
+    /// Estimated bytes of the build side a task hashes, 0 if unknown.
+    size_t build_side_bytes = 0;
 };
 
 
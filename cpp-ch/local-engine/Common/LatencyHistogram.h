@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <base/types.h>
+
+namespace local_engine
+{
+/// Histogram of latencies in nanoseconds, in buckets 1/32 as wide as their lower bound, so that a percentile is within
+/// about 3% of its value, as in an HDR histogram. Not thread safe.
+class LatencyHistogram
+{
+public:
+    void record(UInt64 nanos)
+    {
+        ++buckets[bucketOf(nanos)];
+        ++total;
+        max_value = std::max(max_value, nanos);
+    }
+
+    UInt64 count() const { return total; }
+    UInt64 max() const { return max_value; }
+
+    /// The upper bound of the bucket of the percentile-th latency, 0 if none was recorded.
+    UInt64 percentile(double percentile) const
+    {
+        if (total == 0)
+            return 0;
+        auto rank = std::max<UInt64>(1, static_cast<UInt64>(percentile / 100 * total + 0.5));
+        UInt64 seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return std::min(upperBoundOf(i), max_value);
+        }
+        return max_value;
+    }
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr UInt64 SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    /// Values below SUB_BUCKETS get a bucket each, then each power of 2 gets SUB_BUCKETS.
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static size_t bucketOf(UInt64 value)
+    {
+        if (value < SUB_BUCKETS)
+            return value;
+        int msb = 63 - __builtin_clzll(value);
+        return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + ((value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    }
+
+    static UInt64 upperBoundOf(size_t bucket)
+    {
+        size_t group = bucket / SUB_BUCKETS;
+        UInt64 sub_bucket = bucket % SUB_BUCKETS;
+        if (group == 0)
+            return sub_bucket;
+        return ((SUB_BUCKETS + sub_bucket + 1) << (group - 1)) - 1;
+    }
+
+    std::array<UInt64, NUM_BUCKETS> buckets{};
+    UInt64 total = 0;
+    UInt64 max_value = 0;
+};
+}
@@ -19,12 +19,16 @@
 #include <IO/ReadHelpers.h>
 #include <IO/WriteBufferFromString.h>
 #include <IO/WriteHelpers.h>
+#include <Parsers/ParserCreateQuery.h>
+#include <Parsers/parseQuery.h>
+#include <Common/StringUtils/StringUtils.h>
 
 using namespace DB;
 
 namespace local_engine
 {
-std::shared_ptr<DB::StorageInMemoryMetadata> buildMetaData(DB::NamesAndTypesList columns, ContextPtr context)
+std::shared_ptr<DB::StorageInMemoryMetadata>
+buildMetaData(DB::NamesAndTypesList columns, ContextPtr context, const std::vector<String> & skip_indexes)
 {
     std::shared_ptr<DB::StorageInMemoryMetadata> metadata = std::make_shared<DB::StorageInMemoryMetadata>();
     ColumnsDescription columns_description;
@@ -36,6 +40,12 @@ std::shared_ptr<DB::StorageInMemoryMetadata> buildMetaData(DB::NamesAndTypesList
     metadata->partition_key.expression_list_ast = std::make_shared<ASTExpressionList>();
     metadata->sorting_key = KeyDescription::getSortingKeyFromAST(makeASTFunction("tuple"), metadata->getColumns(), context, {});
     metadata->primary_key.expression = std::make_shared<ExpressionActions>(std::make_shared<ActionsDAG>());
+    for (const auto & declaration : skip_indexes)
+    {
+        ParserIndexDeclaration parser;
+        auto ast = parseQuery(parser, declaration, 0, DBMS_DEFAULT_MAX_PARSER_DEPTH);
+        metadata->secondary_indices.push_back(IndexDescription::getIndexFromAST(ast, metadata->getColumns(), context));
+    }
     return metadata;
 }
 
@@ -73,6 +83,21 @@ MergeTreeTable parseMergeTreeTableString(const std::string & info)
     assertChar('\n', in);
     readIntText(table.max_block, in);
     assertChar('\n', in);
+    if (!in.eof() && isNumericASCII(*in.position()))
+    {
+        readIntText(table.begin_mark, in);
+        assertChar('\n', in);
+        readIntText(table.end_mark, in);
+        assertChar('\n', in);
+    }
+    while (!in.eof())
+    {
+        assertString("INDEX ", in);
+        String declaration;
+        readString(declaration, in);
+        assertChar('\n', in);
+        table.skip_indexes.emplace_back(std::move(declaration));
+    }
     assertEOF(in);
     return table;
 }
@@ -91,6 +116,19 @@ std::string MergeTreeTable::toString() const
     writeChar('\n', out);
     writeIntText(max_block, out);
     writeChar('\n', out);
+    if (end_mark > 0)
+    {
+        writeIntText(begin_mark, out);
+        writeChar('\n', out);
+        writeIntText(end_mark, out);
+        writeChar('\n', out);
+    }
+    for (const auto & declaration : skip_indexes)
+    {
+        writeString("INDEX ", out);
+        writeString(declaration, out);
+        writeChar('\n', out);
+    }
     return out.str();
 }
 
@@ -32,7 +32,9 @@
 namespace local_engine
 {
 using namespace DB;
-std::shared_ptr<DB::StorageInMemoryMetadata> buildMetaData(DB::NamesAndTypesList columns, ContextPtr context);
+/// The skip indexes are declared like in a create query, e.g. "idx a TYPE minmax GRANULARITY 1".
+std::shared_ptr<DB::StorageInMemoryMetadata>
+buildMetaData(DB::NamesAndTypesList columns, ContextPtr context, const std::vector<String> & skip_indexes = {});
 
 std::unique_ptr<MergeTreeSettings> buildMergeTreeSettings();
 
@@ -45,6 +47,11 @@ struct MergeTreeTable
     std::string relative_path;
     int min_block;
     int max_block;
+    /// When end_mark > 0 the table is a single part, of which only the marks in [begin_mark, end_mark) are read.
+    size_t begin_mark = 0;
+    size_t end_mark = 0;
+    /// The declarations of the skip indexes of the table, built on insert and used to drop granules on read.
+    std::vector<String> skip_indexes;
 
     std::string toString() const;
 };
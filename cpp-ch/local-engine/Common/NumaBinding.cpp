@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NumaBinding.h"
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace local_engine
+{
+namespace
+{
+/// From linux/mempolicy.h, glibc has no wrappers for the NUMA syscalls.
+constexpr int MPOL_DEFAULT_MODE = 0;
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MAX_NUMA_NODES = 64;
+
+struct NumaNode
+{
+    int id;
+    std::vector<int> cpus;
+};
+
+std::string readSysfs(const std::string & path)
+{
+    std::ifstream in(path);
+    std::string content;
+    std::getline(in, content);
+    return content;
+}
+
+/// Nodes with CPUs, memory-only nodes can't run a task.
+const std::vector<NumaNode> & numaNodes()
+{
+    static const std::vector<NumaNode> nodes = []
+    {
+        std::vector<NumaNode> result;
+        for (auto id : parseCpuList(readSysfs("/sys/devices/system/node/online")))
+        {
+            auto cpus = parseCpuList(readSysfs("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"));
+            if (id < MAX_NUMA_NODES && !cpus.empty())
+                result.push_back({id, std::move(cpus)});
+        }
+        return result;
+    }();
+    return nodes;
+}
+
+thread_local std::weak_ptr<NumaTaskBinding> thread_binding;
+
+std::mutex bound_tasks_mutex;
+std::vector<int> bound_tasks;
+size_t next_node = 0;
+}
+
+std::vector<int> parseCpuList(const std::string & cpu_list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(cpu_list);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+        if (range.empty())
+            continue;
+        auto dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::shared_ptr<NumaTaskBinding> NumaTaskBinding::bindCurrentThread()
+{
+    if (auto binding = thread_binding.lock())
+        return binding;
+    auto binding = std::make_shared<NumaTaskBinding>();
+    thread_binding = binding;
+    return binding;
+}
+
+NumaTaskBinding::NumaTaskBinding()
+{
+    const auto & nodes = numaNodes();
+    if (nodes.size() <= 1)
+        return;
+    {
+        std::lock_guard lock(bound_tasks_mutex);
+        bound_tasks.resize(nodes.size(), 0);
+        /// Rotate the start so that ties are broken in turn.
+        size_t start = next_node++ % nodes.size();
+        node_index = start;
+        for (size_t i = 1; i < nodes.size(); ++i)
+        {
+            size_t index = (start + i) % nodes.size();
+            if (bound_tasks[index] < bound_tasks[node_index])
+                node_index = index;
+        }
+        ++bound_tasks[node_index];
+    }
+    node_id = nodes[node_index].id;
+    tid = static_cast<pid_t>(syscall(SYS_gettid));
+
+    /// Stay within the CPUs the executor is allowed to run on.
+    if (sched_getaffinity(0, sizeof(previous_cpus), &previous_cpus) == 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (auto cpu : nodes[node_index].cpus)
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &previous_cpus))
+                CPU_SET(cpu, &cpus);
+        restore_cpus = CPU_COUNT(&cpus) > 0 && sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+    }
+    unsigned long node_mask = 1UL << node_id;
+    /// The kernel reads one bit less than maxnode.
+    syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, &node_mask, MAX_NUMA_NODES + 1);
+}
+
+NumaTaskBinding::~NumaTaskBinding()
+{
+    if (node_id < 0)
+        return;
+    /// Spark task threads are pooled, the next task on the thread may not be a native one.
+    if (restore_cpus)
+        sched_setaffinity(tid, sizeof(previous_cpus), &previous_cpus);
+    /// The memory policy is per thread and can only be reset from the thread itself.
+    if (static_cast<pid_t>(syscall(SYS_gettid)) == tid)
+        syscall(SYS_set_mempolicy, MPOL_DEFAULT_MODE, nullptr, 0);
+    std::lock_guard lock(bound_tasks_mutex);
+    --bound_tasks[node_index];
+}
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <memory>
+#include <sched.h>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace local_engine
+{
+/// CPUs of a cpulist of sysfs, e.g. "0-3,8-11".
+std::vector<int> parseCpuList(const std::string & cpu_list);
+
+/// Binds the calling thread and the pages it faults in to one NUMA node while alive. The node is the one with the
+/// fewest bound tasks, so that the tasks of the executor spread evenly across sockets. Nothing is bound on single-node
+/// hosts. Enabled with numa.bind_task.
+class NumaTaskBinding
+{
+public:
+    /// The binding of the calling thread, shared by the executors of one task on the thread.
+    static std::shared_ptr<NumaTaskBinding> bindCurrentThread();
+
+    NumaTaskBinding();
+    ~NumaTaskBinding();
+
+    /// -1 if nothing is bound.
+    int node() const { return node_id; }
+
+private:
+    int node_id = -1;
+    size_t node_index = 0;
+    pid_t tid = 0;
+    cpu_set_t previous_cpus;
+    bool restore_cpus = false;
+};
+}
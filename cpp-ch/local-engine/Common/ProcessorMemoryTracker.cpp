@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ProcessorMemoryTracker.h"
+#include <Common/CurrentThread.h>
+#include <Common/ThreadStatus.h>
+
+namespace local_engine
+{
+ProcessorMemoryTracker::Scope::Scope(ProcessorMemoryTracker & tracker)
+{
+    if (!DB::current_thread)
+        return;
+    thread_tracker = DB::CurrentThread::getMemoryTracker();
+    if (!thread_tracker)
+        return;
+    /// The untracked memory of the thread was allocated before, it goes to the previous parent when the scope ends.
+    prev_untracked_memory = DB::current_thread->untracked_memory;
+    DB::current_thread->untracked_memory = 0;
+    prev_parent = thread_tracker->getParent();
+    tracker.tracker.setParent(prev_parent);
+    thread_tracker->setParent(&tracker.tracker);
+}
+
+ProcessorMemoryTracker::Scope::~Scope()
+{
+    if (!thread_tracker)
+        return;
+    DB::CurrentThread::flushUntrackedMemory();
+    DB::current_thread->untracked_memory = prev_untracked_memory;
+    thread_tracker->setParent(prev_parent);
+}
+
+void ProcessorMemoryTracker::release(Int64 bytes)
+{
+    /// set doesn't reach the parent, which keeps counting the bytes.
+    tracker.set(std::max<Int64>(tracker.get() - bytes, 0));
+}
+}
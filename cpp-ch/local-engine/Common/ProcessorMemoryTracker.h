@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <algorithm>
+#include <base/types.h>
+#include <Common/MemoryTracker.h>
+
+namespace local_engine
+{
+/// The memory of a processor, counted by a memory tracker that the memory tracker of the thread reports to while the
+/// processor works, and which reports to the query one as the thread tracker did. Memory allocated while the processor
+/// works is counted into it until released, even if freed by another processor.
+class ProcessorMemoryTracker
+{
+public:
+    /// Counts the allocations of the current thread into the tracker for its lifetime.
+    class Scope
+    {
+    public:
+        explicit Scope(ProcessorMemoryTracker & tracker);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope & operator=(const Scope &) = delete;
+
+    private:
+        MemoryTracker * thread_tracker = nullptr;
+        MemoryTracker * prev_parent = nullptr;
+        Int64 prev_untracked_memory = 0;
+    };
+
+    /// Stops counting bytes handed over to other processors, e.g. those of the chunks generated, without freeing them
+    /// from the query.
+    void release(Int64 bytes);
+
+    Int64 currentBytes() const { return std::max<Int64>(tracker.get(), 0); }
+    Int64 peakBytes() const { return tracker.getPeak(); }
+
+private:
+    MemoryTracker tracker;
+};
+
+/// A processor whose memory is counted by a ProcessorMemoryTracker, reported per rel in the metrics.
+class MemoryTrackedProcessor
+{
+public:
+    virtual ~MemoryTrackedProcessor() = default;
+    const ProcessorMemoryTracker & getMemoryTracker() const { return memory_tracker; }
+
+protected:
+    ProcessorMemoryTracker memory_tracker;
+};
+}
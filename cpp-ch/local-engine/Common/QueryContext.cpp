@@ -84,6 +84,7 @@ void releaseAllocator(int64_t allocator_id)
         listener->free(-status->untracked_memory);
     else if (status->untracked_memory > 0)
         listener->reserve(status->untracked_memory);
+    listener->releaseUnused();
     allocator_map.erase(allocator_id);
 }
 
@@ -0,0 +1,195 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SortKeyEncoder.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <Columns/ColumnDecimal.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <Common/typeid_cast.h>
+
+namespace local_engine
+{
+namespace
+{
+    constexpr UInt8 NULL_FIRST = 0x00;
+    constexpr UInt8 NOT_NULL = 0x01;
+    constexpr UInt8 NULL_LAST = 0x02;
+
+    /// The unsigned integer ordered as the value is by compareAt.
+    template <typename T>
+    auto toOrderedBits(T value, int nan_direction_hint)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            using U = std::conditional_t<sizeof(T) == 4, UInt32, UInt64>;
+            constexpr U sign_bit = U(1) << (sizeof(U) * 8 - 1);
+            if (std::isnan(value))
+                return nan_direction_hint > 0 ? std::numeric_limits<U>::max() : U(0);
+            /// -0.0 equals 0.0.
+            if (value == 0)
+                value = 0;
+            U bits = std::bit_cast<U>(value);
+            return (bits & sign_bit) ? static_cast<U>(~bits) : static_cast<U>(bits | sign_bit);
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            using U = std::make_unsigned_t<T>;
+            return static_cast<U>(static_cast<U>(value) ^ (U(1) << (sizeof(U) * 8 - 1)));
+        }
+        else
+            return static_cast<std::make_unsigned_t<T>>(value);
+    }
+
+    template <typename U>
+    void writeBigEndian(char * pos, U value)
+    {
+        for (size_t i = 0; i < sizeof(U); ++i)
+            pos[i] = static_cast<char>(value >> (8 * (sizeof(U) - 1 - i)));
+    }
+
+    template <typename F>
+    bool visitNested(const DB::IColumn & nested, const DB::NullMap * null_map, F && f)
+    {
+        auto visit = [&]<typename ColumnType>() -> bool
+        {
+            const auto * typed = typeid_cast<const ColumnType *>(&nested);
+            if (typed)
+                f(*typed, null_map);
+            return typed != nullptr;
+        };
+        return visit.template operator()<DB::ColumnUInt8>() || visit.template operator()<DB::ColumnUInt16>()
+            || visit.template operator()<DB::ColumnUInt32>() || visit.template operator()<DB::ColumnUInt64>()
+            || visit.template operator()<DB::ColumnInt8>() || visit.template operator()<DB::ColumnInt16>()
+            || visit.template operator()<DB::ColumnInt32>() || visit.template operator()<DB::ColumnInt64>()
+            || visit.template operator()<DB::ColumnFloat32>() || visit.template operator()<DB::ColumnFloat64>()
+            || visit.template operator()<DB::ColumnDecimal<DB::Decimal32>>()
+            || visit.template operator()<DB::ColumnDecimal<DB::Decimal64>>()
+            || visit.template operator()<DB::ColumnDecimal<DB::DateTime64>>() || visit.template operator()<DB::ColumnString>();
+    }
+
+    /// Calls f with the typed nested column and the null map of column, false if the column isn't supported.
+    template <typename F>
+    bool visitColumn(const DB::IColumn & column, F && f)
+    {
+        if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(&column))
+            return visitNested(nullable->getNestedColumn(), &nullable->getNullMapData(), f);
+        return visitNested(column, nullptr, f);
+    }
+}
+
+bool SortKeyEncoder::isSupported(const DB::IColumn & column)
+{
+    return visitColumn(column, [](const auto &, const DB::NullMap *) {});
+}
+
+void SortKeyEncoder::encode(const DB::Columns & columns, size_t rows)
+{
+    /// The sizes of the keys of the rows first, then their bytes written at the cursor of each row.
+    std::vector<size_t> cursors(rows, 0);
+    for (const auto & column : columns)
+    {
+        visitColumn(
+            *column,
+            [&](const auto & nested, const DB::NullMap * null_map)
+            {
+                using ColumnType = std::decay_t<decltype(nested)>;
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    size_t size = 1;
+                    if (!null_map || !(*null_map)[row])
+                    {
+                        if constexpr (std::is_same_v<ColumnType, DB::ColumnString>)
+                        {
+                            auto value = nested.getDataAt(row);
+                            size += value.size + std::count(value.data, value.data + value.size, '\0') + 2;
+                        }
+                        else
+                            size += sizeof(typename ColumnType::ValueType);
+                    }
+                    cursors[row] += size;
+                }
+            });
+    }
+
+    offsets.resize(rows);
+    size_t end = 0;
+    for (size_t row = 0; row < rows; ++row)
+    {
+        size_t begin = end;
+        end += cursors[row];
+        offsets[row] = end;
+        cursors[row] = begin;
+    }
+    chars.resize(end);
+
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const bool descending = description[i].direction < 0;
+        const int nulls_direction = description[i].nulls_direction;
+        visitColumn(
+            *columns[i],
+            [&](const auto & nested, const DB::NullMap * null_map)
+            {
+                using ColumnType = std::decay_t<decltype(nested)>;
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    char * begin = chars.data() + cursors[row];
+                    char * pos = begin;
+                    if (null_map && (*null_map)[row])
+                        *pos++ = nulls_direction > 0 ? NULL_LAST : NULL_FIRST;
+                    else
+                    {
+                        *pos++ = NOT_NULL;
+                        if constexpr (std::is_same_v<ColumnType, DB::ColumnString>)
+                        {
+                            auto value = nested.getDataAt(row);
+                            for (size_t j = 0; j < value.size; ++j)
+                            {
+                                *pos++ = value.data[j];
+                                if (value.data[j] == '\0')
+                                    *pos++ = '\xFF';
+                            }
+                            *pos++ = '\0';
+                            *pos++ = '\0';
+                        }
+                        else
+                        {
+                            const auto & value = nested.getData()[row];
+                            auto bits = [&]
+                            {
+                                if constexpr (DB::is_decimal<std::decay_t<decltype(value)>>)
+                                    return toOrderedBits(value.value, nulls_direction);
+                                else
+                                    return toOrderedBits(value, nulls_direction);
+                            }();
+                            writeBigEndian(pos, bits);
+                            pos += sizeof(bits);
+                        }
+                    }
+                    if (descending)
+                        for (char * p = begin; p < pos; ++p)
+                            *p = static_cast<char>(~*p);
+                    cursors[row] = pos - chars.data();
+                }
+            });
+    }
+}
+}
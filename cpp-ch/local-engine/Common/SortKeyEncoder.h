@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <string_view>
+#include <vector>
+#include <Columns/IColumn.h>
+#include <Core/SortDescription.h>
+
+namespace local_engine
+{
+/// Encodes the sort keys of rows into byte strings whose memcmp order is the order of the rows by the sort description,
+/// as IColumn::compareAt with nulls_direction times direction compares them. Comparing two rows then takes no call per
+/// key column, and the keys can be bucketed by their bytes.
+///
+/// Each key is a null marker byte placed by nulls_direction, followed for non-null values by the big-endian value with
+/// its sign bit flipped, or by the string with its zero bytes escaped as 0x00 0xFF and terminated by 0x00 0x00. All the
+/// bytes of a descending key are inverted.
+class SortKeyEncoder
+{
+public:
+    explicit SortKeyEncoder(const DB::SortDescription & description_) : description(description_) { }
+
+    /// Integers, dates, Decimal32/64, floats and strings, nullable or not.
+    static bool isSupported(const DB::IColumn & column);
+
+    /// Encodes the keys of rows, columns[i] being the i-th column of the description. All must be supported.
+    void encode(const DB::Columns & columns, size_t rows);
+
+    size_t size() const { return offsets.size(); }
+    std::string_view operator[](size_t row) const
+    {
+        size_t begin = row ? offsets[row - 1] : 0;
+        return {chars.data() + begin, offsets[row] - begin};
+    }
+
+private:
+    DB::SortDescription description;
+    std::vector<char> chars;
+    /// The end of the key of each row in chars.
+    std::vector<size_t> offsets;
+};
+}
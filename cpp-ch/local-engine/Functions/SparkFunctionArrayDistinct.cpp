@@ -79,6 +79,8 @@ public:
 private:
     /// Initially allocate a piece of memory for 512 elements. NOTE: This is just a guess.
     static constexpr size_t INITIAL_SIZE_DEGREE = 9;
+    /// Arrays of primitive types up to this many elements are deduplicated by a linear scan.
+    static constexpr size_t SMALL_ARRAY_SIZE = 16;
 
     template <typename T>
     static bool executeNumber(
@@ -171,6 +173,15 @@ bool FunctionArrayDistinctSpark::executeNumber(
     if (nullable_col)
         src_null_map = &nullable_col->getNullMapData();
 
+    /// The result holds at most all the source elements, so it's allocated once and written in place.
+    ColumnNullable * res_nullable_col = typeid_cast<ColumnNullable *>(&res_data_col);
+    auto & res_values = assert_cast<ColumnVector<T> &>(res_nullable_col ? res_nullable_col->getNestedColumn() : res_data_col).getData();
+    PaddedPODArray<UInt8> * res_null_map = res_nullable_col ? &res_nullable_col->getNullMapData() : nullptr;
+    size_t res_begin = res_values.size();
+    res_values.resize(res_begin + values.size());
+    if (res_null_map)
+        res_null_map->resize_fill(res_begin + values.size(), 0);
+
     using Set = ClearableHashSetWithStackMemory<T, DefaultHash<T>,
         INITIAL_SIZE_DEGREE>;
 
@@ -178,11 +189,17 @@ bool FunctionArrayDistinctSpark::executeNumber(
 
     ColumnArray::Offset prev_src_offset = 0;
     ColumnArray::Offset res_offset = 0;
+    size_t res_pos = res_begin;
 
     for (auto curr_src_offset : src_offsets)
     {
-        set.clear();
+        const size_t row_begin = res_pos;
         bool has_null = false;
+        /// Small arrays are checked against their distinct elements written so far rather than a hash set, with the
+        /// same bitwise equality as the set.
+        const bool use_set = curr_src_offset - prev_src_offset > SMALL_ARRAY_SIZE;
+        if (use_set)
+            set.clear();
 
         for (ColumnArray::Offset j = prev_src_offset; j < curr_src_offset; ++j)
         {
@@ -191,23 +208,40 @@ bool FunctionArrayDistinctSpark::executeNumber(
             {
                 if (has_null)
                     continue;
-                res_data_col.insertDefault();
+                res_values[res_pos] = T();
+                (*res_null_map)[res_pos] = 1;
+                ++res_pos;
                 has_null = true;
                 continue;
             }
 
-            if (!set.find(values[j]))
+            bool found = false;
+            if (use_set)
+            {
+                typename Set::LookupResult it;
+                bool inserted;
+                set.emplace(values[j], it, inserted);
+                found = !inserted;
+            }
+            else
             {
-                res_data_col.insert(values[j]);
-                set.insert(values[j]);
+                for (size_t k = row_begin; k < res_pos && !found; ++k)
+                    found = !(res_null_map && (*res_null_map)[k]) && bitEquals(std::as_const(res_values[k]), values[j]);
             }
+
+            if (!found)
+                res_values[res_pos++] = values[j];
         }
 
-        res_offset += set.size() + has_null;
+        res_offset += res_pos - row_begin;
         res_offsets.emplace_back(res_offset);
 
         prev_src_offset = curr_src_offset;
     }
+
+    res_values.resize(res_pos);
+    if (res_null_map)
+        res_null_map->resize(res_pos);
     return true;
 }
 
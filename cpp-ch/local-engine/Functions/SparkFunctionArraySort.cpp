@@ -16,6 +16,10 @@
  */
 #include <Functions/SparkFunctionArraySort.h>
 #include <Functions/FunctionFactory.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <Common/memcmpSmall.h>
 
 namespace DB
 {
@@ -51,6 +55,111 @@ struct Less
     }
 };
 
+/// The same order as Less over the integers and strings, without the virtual compareAt.
+template <typename T, bool positive>
+struct NumberLess
+{
+    const PaddedPODArray<T> & data;
+    const NullMap * null_map;
+
+    bool operator()(size_t lhs, size_t rhs) const
+    {
+        if (null_map)
+        {
+            bool lhs_null = (*null_map)[lhs];
+            bool rhs_null = (*null_map)[rhs];
+            /// NULL is the least value.
+            if (lhs_null || rhs_null)
+                return positive ? lhs_null && !rhs_null : !lhs_null && rhs_null;
+        }
+        if constexpr (positive)
+            return data[lhs] < data[rhs];
+        else
+            return data[lhs] > data[rhs];
+    }
+};
+
+template <bool positive>
+struct StringLess
+{
+    const ColumnString & column;
+    const NullMap * null_map;
+
+    bool operator()(size_t lhs, size_t rhs) const
+    {
+        if (null_map)
+        {
+            bool lhs_null = (*null_map)[lhs];
+            bool rhs_null = (*null_map)[rhs];
+            if (lhs_null || rhs_null)
+                return positive ? lhs_null && !rhs_null : !lhs_null && rhs_null;
+        }
+        auto lhs_ref = column.getDataAt(lhs);
+        auto rhs_ref = column.getDataAt(rhs);
+        int res = memcmpSmallAllowOverflow15(lhs_ref.data, lhs_ref.size, rhs_ref.data, rhs_ref.size);
+        return positive ? res < 0 : res > 0;
+    }
+};
+
+template <typename Comparator>
+void sortRanges(const ColumnArray::Offsets & offsets, IColumn::Permutation & permutation, Comparator comparator)
+{
+    ColumnArray::Offset current_offset = 0;
+    for (auto next_offset : offsets)
+    {
+        ::sort(&permutation[current_offset], &permutation[next_offset], comparator);
+        current_offset = next_offset;
+    }
+}
+
+template <typename T, bool positive>
+bool trySortNumbers(
+    const IColumn & column, const NullMap * null_map, const ColumnArray::Offsets & offsets, IColumn::Permutation & permutation)
+{
+    const auto * numbers = checkAndGetColumn<ColumnVector<T>>(&column);
+    if (!numbers)
+        return false;
+    sortRanges(offsets, permutation, NumberLess<T, positive>{numbers->getData(), null_map});
+    return true;
+}
+
+/// Sorts the arrays of integers in place when they are sorted by their own values, no permutation needed.
+template <typename T, bool positive>
+ColumnPtr trySortNumbersInPlace(const ColumnArray & array)
+{
+    const auto * numbers = checkAndGetColumn<ColumnVector<T>>(&array.getData());
+    if (!numbers)
+        return nullptr;
+    auto sorted = ColumnVector<T>::create();
+    auto & data = sorted->getData();
+    data.assign(numbers->getData().begin(), numbers->getData().end());
+    ColumnArray::Offset current_offset = 0;
+    for (auto next_offset : array.getOffsets())
+    {
+        if constexpr (positive)
+            ::sort(data.begin() + current_offset, data.begin() + next_offset, std::less<T>());
+        else
+            ::sort(data.begin() + current_offset, data.begin() + next_offset, std::greater<T>());
+        current_offset = next_offset;
+    }
+    return ColumnArray::create(std::move(sorted), array.getOffsetsPtr());
+}
+
+template <bool positive, typename... Ts>
+ColumnPtr trySortAnyNumbersInPlace(const ColumnArray & array)
+{
+    ColumnPtr res;
+    ((res = trySortNumbersInPlace<Ts, positive>(array)) || ...);
+    return res;
+}
+
+template <bool positive, typename... Ts>
+bool trySortAnyNumbers(
+    const IColumn & column, const NullMap * null_map, const ColumnArray::Offsets & offsets, IColumn::Permutation & permutation)
+{
+    return (trySortNumbers<Ts, positive>(column, null_map, offsets, permutation) || ...);
+}
+
 }
 
 template <bool positive>
@@ -59,21 +168,35 @@ ColumnPtr SparkArraySortImpl<positive>::execute(
     ColumnPtr mapped,
     const ColumnWithTypeAndName * fixed_arguments [[maybe_unused]])
 {
+    /// Floats keep the generic comparison, for its order of NaN.
+    if (mapped.get() == &array.getData())
+    {
+        if (auto res = trySortAnyNumbersInPlace<positive, UInt8, UInt16, UInt32, UInt64, Int8, Int16, Int32, Int64>(array))
+            return res;
+    }
+
     const ColumnArray::Offsets & offsets = array.getOffsets();
 
-    size_t size = offsets.size();
     size_t nested_size = array.getData().size();
     IColumn::Permutation permutation(nested_size);
 
     for (size_t i = 0; i < nested_size; ++i)
         permutation[i] = i;
 
-    ColumnArray::Offset current_offset = 0;
-    for (size_t i = 0; i < size; ++i)
+    const IColumn * keys = mapped.get();
+    const NullMap * null_map = nullptr;
+    if (const auto * nullable = checkAndGetColumn<ColumnNullable>(keys))
     {
-        auto next_offset = offsets[i];
-        ::sort(&permutation[current_offset], &permutation[next_offset], Less<positive>(*mapped));
-        current_offset = next_offset;
+        keys = &nullable->getNestedColumn();
+        null_map = &nullable->getNullMapData();
+    }
+
+    if (!trySortAnyNumbers<positive, UInt8, UInt16, UInt32, UInt64, Int8, Int16, Int32, Int64>(*keys, null_map, offsets, permutation))
+    {
+        if (const auto * strings = checkAndGetColumn<ColumnString>(keys))
+            sortRanges(offsets, permutation, StringLess<positive>{*strings, null_map});
+        else
+            sortRanges(offsets, permutation, Less<positive>(*mapped));
     }
 
     return ColumnArray::create(array.getData().permute(permutation, 0), array.getOffsetsPtr());
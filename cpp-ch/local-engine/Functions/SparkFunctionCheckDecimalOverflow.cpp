@@ -23,6 +23,7 @@
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionHelpers.h>
 #include <Functions/IFunction.h>
+#include <optional>
 
 
 namespace DB
@@ -142,7 +143,7 @@ namespace
             }
 
             auto & datas = col_source.getData();
-            for (size_t i = 0; i < input_rows_count; ++i)
+            auto check_row = [&](size_t i)
             {
                 bool overflow = outOfDigits<T>(datas[i], precision, scale_from, scale_to);
                 if (overflow)
@@ -152,6 +153,31 @@ namespace
                     else
                         throw Exception(ErrorCodes::DECIMAL_OVERFLOW, "Decimal value is overflow.");
                 }
+            };
+
+            using NativeT = typename T::NativeType;
+            if (auto bound = fitBound<T>(precision, scale_from, scale_to))
+            {
+                /// Only the rows out of the range, rare, are checked exactly. The range check is branchless.
+                const NativeT upper = *bound;
+                const NativeT lower = -upper;
+                for (size_t begin = 0; begin < input_rows_count; begin += rows_per_check)
+                {
+                    size_t end = std::min(begin + rows_per_check, input_rows_count);
+                    bool all_fit = true;
+                    for (size_t i = begin; i < end; ++i)
+                        all_fit &= (datas[i].value > lower) & (datas[i].value < upper);
+                    if (all_fit) [[likely]]
+                        continue;
+                    for (size_t i = begin; i < end; ++i)
+                        if (!(datas[i].value > lower && datas[i].value < upper))
+                            check_row(i);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < input_rows_count; ++i)
+                    check_row(i);
             }
 
             typename ColumnDecimal<T>::MutablePtr col_to = ColumnDecimal<T>::create(std::move(col_source));
@@ -161,6 +187,20 @@ namespace
                 result_column = std::move(col_to);
         }
 
+        static constexpr size_t rows_per_check = 256;
+
+        /// The values in (-bound, bound) fit precision_to digits once rescaled, those out of it need not. Empty if the bound
+        /// isn't representable in the native type of T.
+        template <is_decimal T>
+        static std::optional<typename T::NativeType> fitBound(UInt32 precision_to, UInt32 scale_from, UInt32 scale_to)
+        {
+            using NativeT = typename T::NativeType;
+            Int64 digits = static_cast<Int64>(precision_to) + scale_from - scale_to;
+            if (digits > static_cast<Int64>(DecimalUtils::max_precision<T>))
+                return {};
+            return digits <= 0 ? NativeT(1) : intExp10OfSize<NativeT>(static_cast<int>(digits));
+        }
+
         template <is_decimal T>
         static bool outOfDigits(T decimal, UInt32 precision_to, UInt32 scale_from, UInt32 scale_to)
         {
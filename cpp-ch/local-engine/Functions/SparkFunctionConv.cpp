@@ -16,13 +16,18 @@
  */
 #include "SparkFunctionConv.h"
 #include <string>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
 #include <DataTypes/DataTypeNullable.h>
+#include <Functions/FunctionHelpers.h>
 #include <Functions/FunctionFactory.h>
 #include <Poco/Logger.h>
 #include <Poco/Types.h>
 #include <Common/Exception.h>
 #include <Common/logger_useful.h>
 #include <DataTypes/IDataType.h>
+#include <Common/assert_cast.h>
+#include <Common/typeid_cast.h>
 #include <base/types.h>
 
 namespace DB
@@ -55,7 +60,19 @@ DB::DataTypePtr SparkFunctionConv::getReturnTypeImpl(const DB::DataTypes & argum
     return std::make_shared<DB::DataTypeNullable>(arg0_type);
 }
 
-/// Taken from mysql-server sql/item_strfunc.cc
+/// The value of a digit character in the bases up to 36, 0xFF for other characters.
+static constexpr auto digit_values = []
+{
+    std::array<UInt8, 256> values{};
+    values.fill(0xFF);
+    for (int c = '0'; c <= '9'; ++c)
+        values[c] = static_cast<UInt8>(c - '0');
+    for (int c = 'A'; c <= 'Z'; ++c)
+        values[c] = values[c - 'A' + 'a'] = static_cast<UInt8>(c - 'A' + 10);
+    return values;
+}();
+
+/// Taken from mysql-server sql/item_strfunc.cc, with the digits looked up in digit_values.
 static unsigned long long my_strntoull_8bit(const char *nptr,
                                      size_t l, int base, const char **endptr,
                                      int *err)
@@ -99,16 +116,7 @@ static unsigned long long my_strntoull_8bit(const char *nptr,
     overflow = 0;
     i = 0;
     for (; s != e; s++) {
-        uint8_t c = *s;
-
-        if (c >= '0' && c <= '9')
-            c -= '0';
-        else if (c >= 'A' && c <= 'Z')
-            c = c - 'A' + 10;
-        else if (c >= 'a' && c <= 'z')
-            c = c - 'a' + 10;
-        else
-            break;
+        uint8_t c = digit_values[static_cast<uint8_t>(*s)];
         if (c >= base) break;
         if (i > cutoff || (i == cutoff && c > cutlim))
             overflow = 1;
@@ -136,6 +144,41 @@ noconv:
     return 0L;
 }
 
+/// Writes the digits backwards before end. The common bases are constants, for the divisions to be shifts and
+/// multiplications.
+template <unsigned radix>
+static char * writeDigits(uint64_t uval, char * end, const char * dig_vec)
+{
+    do
+    {
+        *--end = dig_vec[uval % radix];
+        uval /= radix;
+    } while (uval != 0);
+    return end;
+}
+
+static char * writeDigits(uint64_t uval, char * end, const char * dig_vec, unsigned radix)
+{
+    switch (radix)
+    {
+        case 2:
+            return writeDigits<2>(uval, end, dig_vec);
+        case 8:
+            return writeDigits<8>(uval, end, dig_vec);
+        case 10:
+            return writeDigits<10>(uval, end, dig_vec);
+        case 16:
+            return writeDigits<16>(uval, end, dig_vec);
+        default:
+            do
+            {
+                *--end = dig_vec[uval % radix];
+                uval /= radix;
+            } while (uval != 0);
+            return end;
+    }
+}
+
 static char * ll2str(int64_t val, char * dst, int radix, bool upcase)
 {
     constexpr std::array<const char, 37> dig_vec_upper{"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
@@ -160,12 +203,7 @@ static char * ll2str(int64_t val, char * dst, int radix, bool upcase)
         return nullptr;
     }
 
-    char *p = std::end(buffer);
-    do
-    {
-        *--p = dig_vec[uval % radix];
-        uval /= radix;
-    } while (uval != 0);
+    char *p = writeDigits(uval, std::end(buffer), dig_vec, static_cast<unsigned>(radix));
 
     const size_t length = std::end(buffer) - p;
     memcpy(dst, p, length);
@@ -190,23 +228,47 @@ DB::ColumnPtr SparkFunctionConv::executeImpl(
         return result;
     }
 
-    longlong dec = 0;
-    const char * endptr = nullptr;
-    int err = 0;
-    for (size_t i = 0; i < input_rows_count; ++i)
+    /// Of the converted value, nullptr for null.
+    char ans[CONV_MAX_LENGTH + 1U];
+    auto convert = [&](StringRef value) -> char *
     {
-        auto value_str = arguments[0].column->getDataAt(i).toString();
+        const char * endptr = nullptr;
+        int err = 0;
+        longlong dec;
         if (from_base < 0)
-            dec = my_strntoull_8bit(value_str.data(), value_str.length(), -from_base, &endptr, &err);
+            dec = my_strntoull_8bit(value.data, value.size, -from_base, &endptr, &err);
         else
-            dec = static_cast<longlong>(my_strntoull_8bit(value_str.data(), value_str.length(), from_base, &endptr, &err));
+            dec = static_cast<longlong>(my_strntoull_8bit(value.data, value.size, from_base, &endptr, &err));
         if (err == EDOM)
+            return nullptr;
+        return ll2str(dec, ans, to_base, true);
+    };
+
+    /// Strings are written to the nested column directly, without the virtual calls per row.
+    auto & nullable = assert_cast<DB::ColumnNullable &>(*result);
+    const auto * src = DB::checkAndGetColumn<DB::ColumnString>(arguments[0].column.get());
+    auto * dst = typeid_cast<DB::ColumnString *>(&nullable.getNestedColumn());
+    if (src && dst)
+    {
+        auto & null_map = nullable.getNullMapData();
+        null_map.resize_fill(input_rows_count, 0);
+        for (size_t i = 0; i < input_rows_count; ++i)
         {
-            result->insertData(nullptr, 1);
-            continue;
+            auto * ret_ptr = convert(src->getDataAt(i));
+            if (ret_ptr == nullptr)
+            {
+                dst->insertDefault();
+                null_map[i] = 1;
+            }
+            else
+                dst->insertData(ans, ret_ptr - ans);
         }
-        char ans[CONV_MAX_LENGTH + 1U];
-        auto ret_ptr = ll2str(dec, ans, to_base, true);
+        return result;
+    }
+
+    for (size_t i = 0; i < input_rows_count; ++i)
+    {
+        auto * ret_ptr = convert(arguments[0].column->getDataAt(i));
         if (ret_ptr == nullptr)
             result->insertData(nullptr, 1);
         else
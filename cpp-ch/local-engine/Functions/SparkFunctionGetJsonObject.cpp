@@ -15,13 +15,156 @@
  * limitations under the License.
  */
 #include "SparkFunctionGetJsonObject.h"
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnTuple.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypeTuple.h>
 #include <Functions/FunctionFactory.h>
+#include <Interpreters/Context.h>
+#include <Common/JSONParsers/SimdJSONParser.h>
+#include "config.h"
 
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+    extern const int ILLEGAL_COLUMN;
+    extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+    extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+}
+}
 
 namespace local_engine
 {
+#if USE_SIMDJSON
+/// get_json_objects(json, path_1, ..., path_n) is the tuple of get_json_object(json, path_i) for all i, the document parsed
+/// once rather than by each of them. The plan parser merges the get_json_object calls on the same json into it.
+class FunctionGetJsonObjects : public DB::IFunction
+{
+public:
+    static constexpr auto name = "get_json_objects";
+    static DB::FunctionPtr create(DB::ContextPtr context_) { return std::make_shared<FunctionGetJsonObjects>(context_); }
+    explicit FunctionGetJsonObjects(DB::ContextPtr context_) : context(context_) { }
+
+    String getName() const override { return name; }
+    bool isVariadic() const override { return true; }
+    size_t getNumberOfArguments() const override { return 0; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DB::DataTypesWithConstInfo &) const override { return true; }
+    /// A tuple isn't nullable, the nulls are handled by executeImpl.
+    bool useDefaultImplementationForNulls() const override { return false; }
+
+    DB::DataTypePtr getReturnTypeImpl(const DB::ColumnsWithTypeAndName & arguments) const override
+    {
+        if (arguments.size() < 2)
+            throw DB::Exception(DB::ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH, "Function {} requires at least two arguments", name);
+        for (const auto & argument : arguments)
+            if (!DB::isString(DB::removeNullable(argument.type)))
+                throw DB::Exception(
+                    DB::ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}", argument.type->getName(), name);
+        DB::DataTypes types(arguments.size() - 1, DB::makeNullable(std::make_shared<DB::DataTypeString>()));
+        return std::make_shared<DB::DataTypeTuple>(types);
+    }
+
+    DB::ColumnPtr executeImpl(const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr &, size_t input_rows_count) const override
+    {
+        std::vector<DB::ASTPtr> paths;
+        for (size_t i = 1; i < arguments.size(); ++i)
+            paths.emplace_back(parsePath(arguments[i]));
+
+        const auto json_column = arguments[0].column->convertToFullColumnIfConst();
+        const DB::NullMap * null_map = nullptr;
+        const DB::IColumn * nested_column = json_column.get();
+        if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(json_column.get()))
+        {
+            null_map = &nullable->getNullMapData();
+            nested_column = &nullable->getNestedColumn();
+        }
+        const auto * strings = typeid_cast<const DB::ColumnString *>(nested_column);
+        if (!strings)
+            throw DB::Exception(
+                DB::ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}", json_column->getName(), name);
+
+        DB::MutableColumns results;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            results.emplace_back(DB::ColumnNullable::create(DB::ColumnString::create(), DB::ColumnUInt8::create()));
+            results.back()->reserve(input_rows_count);
+        }
+
+        DB::SimdJSONParser parser;
+        DB::SimdJSONParser::Element document;
+        String buffer;
+        for (size_t row = 0; row < input_rows_count; ++row)
+        {
+            const bool document_ok = !(null_map && (*null_map)[row]) && parser.parse(strings->getDataAt(row).toView(), document);
+            for (size_t i = 0; i < paths.size(); ++i)
+                if (!document_ok || !insertResult(*results[i], document, paths[i], buffer))
+                    results[i]->insertDefault();
+        }
+        return DB::ColumnTuple::create(std::move(results));
+    }
+
+private:
+    DB::ContextPtr context;
+
+    DB::ASTPtr parsePath(const DB::ColumnWithTypeAndName & argument) const
+    {
+        const auto * path_column = typeid_cast<const DB::ColumnConst *>(argument.column.get());
+        if (!path_column)
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "The JSONPaths of function {} must be constant", name);
+        const auto path = path_column->getDataAt(0).toView();
+        DB::Tokens tokens(path.data(), path.data() + path.size());
+        DB::IParser::Pos token_iterator(tokens, static_cast<UInt32>(context->getSettingsRef().max_parser_depth));
+        DB::ParserJSONPath parser;
+        DB::ASTPtr res;
+        DB::Expected expected;
+        if (!parser.parse(token_iterator, res, expected))
+            throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Unable to parse JSONPath {} of function {}", path, name);
+        return res;
+    }
+
+    /// The same result as GetJsonObjectImpl::insertResultToColumn, through a buffer reused by all rows rather than a stream.
+    static bool insertResult(DB::IColumn & dest, const DB::SimdJSONParser::Element & root, const DB::ASTPtr & path, String & buffer)
+    {
+        DB::GeneratorJSONPath<DB::SimdJSONParser> generator_json_path(path);
+        DB::SimdJSONParser::Element current_element = root;
+        DB::VisitorStatus status;
+        size_t element_count = 0;
+        buffer.assign("[");
+        while ((status = generator_json_path.getNextItem(current_element)) != DB::VisitorStatus::Exhausted)
+        {
+            if (status == DB::VisitorStatus::Ok)
+            {
+                if (element_count++)
+                    buffer.append(", ");
+                buffer.append(simdjson::minify(current_element.getElement()));
+            }
+            current_element = root;
+        }
+        buffer.push_back(']');
+        if (!element_count)
+            return false;
+
+        std::string_view result(buffer);
+        if (element_count == 1)
+        {
+            result = result.substr(1, result.size() - 2);
+            if (result.size() >= 2 && result.front() == '"' && result.back() == '"')
+                result = result.substr(1, result.size() - 2);
+        }
+        dest.insertData(result.data(), result.size());
+        return true;
+    }
+};
+#endif
+
 REGISTER_FUNCTION(GetJsonObject)
 {
     factory.registerFunction<DB::FunctionSQLJSON<GetJsonObject, GetJsonObjectImpl>>();
+#if USE_SIMDJSON
+    factory.registerFunction<FunctionGetJsonObjects>();
+#endif
 }
 }
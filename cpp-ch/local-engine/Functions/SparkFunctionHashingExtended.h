@@ -89,9 +89,27 @@ public:
 private:
     using ToType = typename Impl::ReturnType;
 
+    /// An argument with its const and nullable wrappers resolved.
+    struct HashedArgument
+    {
+        const IDataType * type;
+        const IColumn * data_column;
+        const NullMap * null_map;
+        bool from_const;
+    };
+
+    /// The rows are hashed by blocks of this many, all the arguments over one block before the next, so that the hashes
+    /// of a block stay in cache while they are updated by each argument.
+    static constexpr size_t rows_per_block = 1024;
+
     template <typename FromType>
     void executeNumberType(
-        bool from_const, const IColumn * data_column, const NullMap * null_map, typename ColumnVector<ToType>::Container & vec_to) const
+        bool from_const,
+        const IColumn * data_column,
+        const NullMap * null_map,
+        size_t begin,
+        size_t end,
+        typename ColumnVector<ToType>::Container & vec_to) const
     {
         using ColVecType = ColumnVectorOrDecimal<FromType>;
 
@@ -99,7 +117,6 @@ private:
         if (!col_from)
             throw Exception(ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}", data_column->getName(), getName());
 
-        size_t size = vec_to.size();
         const typename ColVecType::Container & vec_from = col_from->getData();
 
         auto update_hash = [&](const FromType & value, ToType & to)
@@ -115,35 +132,48 @@ private:
 
         if (!from_const)
         {
-            for (size_t i = 0; i < size; ++i)
+            if (!null_map)
             {
-                if (!null_map || !(*null_map)[i]) [[likely]]
+                for (size_t i = begin; i < end; ++i)
                     update_hash(vec_from[i], vec_to[i]);
             }
+            else
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (!(*null_map)[i]) [[likely]]
+                        update_hash(vec_from[i], vec_to[i]);
+                }
+            }
         }
         else
         {
             if (!null_map || !(*null_map)[0]) [[likely]]
             {
                 auto value = vec_from[0];
-                for (size_t i = 0; i < size; ++i)
+                for (size_t i = begin; i < end; ++i)
                     update_hash(value, vec_to[i]);
             }
         }
     }
 
-    void executeFixedString(bool from_const, const IColumn * data_column, const NullMap * null_map, typename ColumnVector<ToType>::Container & vec_to) const
+    void executeFixedString(
+        bool from_const,
+        const IColumn * data_column,
+        const NullMap * null_map,
+        size_t begin,
+        size_t end,
+        typename ColumnVector<ToType>::Container & vec_to) const
     {
         const ColumnFixedString * col_from_fixed = checkAndGetColumn<ColumnFixedString>(data_column);
         if (!col_from_fixed)
             throw Exception(ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}", data_column->getName(), getName());
 
-        size_t size = vec_to.size();
         if (!from_const)
         {
             const typename ColumnString::Chars & data = col_from_fixed->getChars();
             size_t n = col_from_fixed->getN();
-            for (size_t i = 0; i < size; ++i)
+            for (size_t i = begin; i < end; ++i)
             {
                 if (!null_map || !(*null_map)[i]) [[likely]]
                     vec_to[i] = applyUnsafeBytes(reinterpret_cast<const char *>(&data[i * n]), n, vec_to[i]);
@@ -155,27 +185,32 @@ private:
             {
                 StringRef ref = col_from_fixed->getDataAt(0);
 
-                for (size_t i = 0; i < size; ++i)
+                for (size_t i = begin; i < end; ++i)
                     vec_to[i] = applyUnsafeBytes(ref.data, ref.size, vec_to[i]);
             }
         }
     }
 
-    void executeString(bool from_const, const IColumn * data_column, const NullMap * null_map, typename ColumnVector<ToType>::Container & vec_to) const
+    void executeString(
+        bool from_const,
+        const IColumn * data_column,
+        const NullMap * null_map,
+        size_t begin,
+        size_t end,
+        typename ColumnVector<ToType>::Container & vec_to) const
     {
         const ColumnString * col_from = checkAndGetColumn<ColumnString>(data_column);
         if (!col_from)
             throw Exception(
                 ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}", data_column->getName(), getName());
 
-        size_t size = vec_to.size();
         if (!from_const)
         {
             const typename ColumnString::Chars & data = col_from->getChars();
             const typename ColumnString::Offsets & offsets = col_from->getOffsets();
 
-            ColumnString::Offset current_offset = 0;
-            for (size_t i = 0; i < size; ++i)
+            ColumnString::Offset current_offset = offsets[begin - 1];
+            for (size_t i = begin; i < end; ++i)
             {
                 if (!null_map || !(*null_map)[i]) [[likely]]
                     vec_to[i] = applyUnsafeBytes(
@@ -190,17 +225,17 @@ private:
             {
                 StringRef ref = col_from->getDataAt(0);
 
-                for (size_t i = 0; i < size; ++i)
+                for (size_t i = begin; i < end; ++i)
                     vec_to[i] = applyUnsafeBytes(ref.data, ref.size, vec_to[i]);
             }
         }
     }
 
-    void executeAny(const IDataType * from_type, const IColumn * column, typename ColumnVector<ToType>::Container & vec_to) const
+    HashedArgument prepareArgument(const IDataType * from_type, const IColumn * column, size_t input_rows_count) const
     {
-        if (column->size() != vec_to.size())
+        if (column->size() != input_rows_count)
             throw Exception(ErrorCodes::LOGICAL_ERROR, "Argument column '{}' size {} doesn't match result column size {} of function {}",
-                    column->getName(), column->size(), vec_to.size(), getName());
+                    column->getName(), column->size(), input_rows_count, getName());
 
         const NullMap * null_map = nullptr;
         const IColumn * data_column = column;
@@ -217,46 +252,55 @@ private:
             null_map = &col_nullable->getNullMapData();
             data_column = &col_nullable->getNestedColumn();
         }
+        return {from_type, data_column, null_map, from_const};
+    }
+
+    void executeAny(const HashedArgument & argument, size_t begin, size_t end, typename ColumnVector<ToType>::Container & vec_to) const
+    {
+        const auto * from_type = argument.type;
+        const auto * data_column = argument.data_column;
+        const auto * null_map = argument.null_map;
+        bool from_const = argument.from_const;
 
         WhichDataType which(removeNullable(from_type->shared_from_this()));
         if (which.isUInt8())
-            executeNumberType<UInt8>(from_const, data_column, null_map, vec_to);
+            executeNumberType<UInt8>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isUInt16())
-            executeNumberType<UInt16>(from_const, data_column, null_map, vec_to);
+            executeNumberType<UInt16>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isUInt32())
-            executeNumberType<UInt32>(from_const, data_column, null_map, vec_to);
+            executeNumberType<UInt32>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isUInt64())
-            executeNumberType<UInt64>(from_const, data_column, null_map, vec_to);
+            executeNumberType<UInt64>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isInt8())
-            executeNumberType<Int8>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Int8>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isInt16())
-            executeNumberType<Int16>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Int16>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isInt32())
-            executeNumberType<Int32>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Int32>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isInt64())
-            executeNumberType<Int64>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Int64>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isFloat32())
-            executeNumberType<Float32>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Float32>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isFloat64())
-            executeNumberType<Float64>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Float64>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDate())
-            executeNumberType<UInt16>(from_const, data_column, null_map, vec_to);
+            executeNumberType<UInt16>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDate32())
-            executeNumberType<Int32>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Int32>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDateTime())
-            executeNumberType<UInt32>(from_const, data_column, null_map, vec_to);
+            executeNumberType<UInt32>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDateTime64())
-            executeNumberType<DateTime64>(from_const, data_column, null_map, vec_to);
+            executeNumberType<DateTime64>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDecimal32())
-            executeNumberType<Decimal32>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Decimal32>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDecimal64())
-            executeNumberType<Decimal64>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Decimal64>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isDecimal128())
-            executeNumberType<Decimal128>(from_const, data_column, null_map, vec_to);
+            executeNumberType<Decimal128>(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isString())
-            executeString(from_const, data_column, null_map, vec_to);
+            executeString(from_const, data_column, null_map, begin, end, vec_to);
         else if (which.isFixedString())
-            executeFixedString(from_const, data_column, null_map, vec_to);
+            executeFixedString(from_const, data_column, null_map, begin, end, vec_to);
         /// TODO(taiyang-li): implement for array and tuple type
         /// Note: No need to implement for big int type in gluten
         /// Note: No need to implement for uuid/ipv4/ipv6/enum* type in gluten
@@ -266,12 +310,6 @@ private:
             throw Exception(ErrorCodes::NOT_IMPLEMENTED, "Function {} hasn't supported type {}", getName(), from_type->getName());
     }
 
-    void executeForArgument(
-        const IDataType * type, const IColumn * column, typename ColumnVector<ToType>::Container & vec_to) const
-    {
-        executeAny(type, column, vec_to);
-    }
-
 public:
     String getName() const override
     {
@@ -298,10 +336,16 @@ public:
             vec_to[i] = 42;
 
         /// The function supports arbitrary number of arguments of arbitrary types.
-        for (size_t i = 0; i < arguments.size(); ++i)
+        std::vector<HashedArgument> hashed_arguments;
+        hashed_arguments.reserve(arguments.size());
+        for (const auto & col : arguments)
+            hashed_arguments.emplace_back(prepareArgument(col.type.get(), col.column.get(), input_rows_count));
+
+        for (size_t begin = 0; begin < input_rows_count; begin += rows_per_block)
         {
-            const auto & col = arguments[i];
-            executeForArgument(col.type.get(), col.column.get(), vec_to);
+            size_t end = std::min(begin + rows_per_block, input_rows_count);
+            for (const auto & argument : hashed_arguments)
+                executeAny(argument, begin, end, vec_to);
         }
 
         return col_to;
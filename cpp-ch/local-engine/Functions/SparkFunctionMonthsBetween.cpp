@@ -16,16 +16,23 @@
  */
 #include "SparkFunctionMonthsBetween.h"
 #include <string>
+#include <Columns/ColumnDecimal.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsDateTime.h>
+#include <Columns/ColumnsNumber.h>
 #include <DataTypes/DataTypeDate32.h>
 #include <DataTypes/DataTypeDateTime.h>
 #include <DataTypes/DataTypeDateTime64.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <Functions/DateTimeTransforms.h>
 #include <Functions/FunctionFactory.h>
+#include <Functions/FunctionHelpers.h>
 #include <Functions/TransformDateTime64.h>
 #include <Poco/Logger.h>
 #include <Common/DateLUT.h>
 #include <Common/Exception.h>
+#include <Common/assert_cast.h>
+#include <Common/typeid_cast.h>
 #include <Common/logger_useful.h>
 #include "Core/Field.h"
 #include "base/Decimal.h"
@@ -75,36 +82,31 @@ ALWAYS_INLINE Float64 roundTo8IfNeed(bool round, Float64 res)
     return round ? std::round(res * 1e8) / 1e8 : res;
 }
 
-Float64 monthsBetween(DateTime64 x, DateTime64 y, const DateLUTImpl & timezone, bool round)
+/// All the fields of a timestamp in seconds come from its one entry in the table of the days of the time zone, instead
+/// of a search of the table per field.
+Float64 monthsBetween(Int64 x, Int64 y, const DateLUTImpl & timezone, bool round)
 {
-    // We know that spark use microseconds, maybe round to 8 digits after point
-    x /= 1000000;
-    y /= 1000000;
-    int x_year = timezone.toYear(x);
-    int y_year = timezone.toYear(y);
-    auto x_month = timezone.toMonth(x);
-    auto y_month = timezone.toMonth(y);
-    auto x_day = timezone.toDayOfMonth(x);
-    auto y_day = timezone.toDayOfMonth(y);
-    auto month_diff = static_cast<Float64>(x_year * 12 + x_month - y_year * 12 - y_month);
-    if (x_day == y_day)
+    const auto & x_values = timezone.getValues(timezone.toLUTIndex(x));
+    const auto & y_values = timezone.getValues(timezone.toLUTIndex(y));
+    auto month_diff = static_cast<Float64>(x_values.year * 12 + x_values.month - y_values.year * 12 - y_values.month);
+    if (x_values.day_of_month == y_values.day_of_month)
         return roundTo8IfNeed(round, month_diff);
 
-    int x_to_month_end = timezone.daysInMonth(x);
-    x_to_month_end -= x_day;
-    int y_to_month_end = timezone.daysInMonth(y);
-    y_to_month_end -= y_day;
-    if (x_to_month_end == 0 && y_to_month_end == 0)
+    if (x_values.day_of_month == x_values.days_in_month && y_values.day_of_month == y_values.days_in_month)
         return roundTo8IfNeed(round, month_diff);
 
-    int day_diff = static_cast<int>(x_day) - y_day;
-    auto x_seconds_in_day= x - timezone.makeDate(x_year, x_month, x_day);
-    auto y_seconds_in_day= y - timezone.makeDate(y_year, y_month, y_day);
-    auto seconds_diff = x_seconds_in_day - y_seconds_in_day;
-    auto res = static_cast<Float64>(day_diff * 86400 + seconds_diff)/2678400.0 + month_diff;
+    int day_diff = static_cast<int>(x_values.day_of_month) - y_values.day_of_month;
+    auto seconds_diff = (x - x_values.date) - (y - y_values.date);
+    auto res = static_cast<Float64>(day_diff * 86400 + seconds_diff) / 2678400.0 + month_diff;
     return roundTo8IfNeed(round, res);
 }
 
+Float64 monthsBetween(DateTime64 x, DateTime64 y, const DateLUTImpl & timezone, bool round)
+{
+    // We know that spark use microseconds, maybe round to 8 digits after point
+    return monthsBetween(x.value / 1000000, y.value / 1000000, timezone, round);
+}
+
 DB::ColumnPtr SparkFunctionMonthsBetween::executeImpl(
     const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr & result_type, size_t input_rows_count) const
 {
@@ -120,6 +122,30 @@ DB::ColumnPtr SparkFunctionMonthsBetween::executeImpl(
         timezone_str = arguments[3].column->getDataAt(0).toString();
     auto & timezone = DateLUT::instance(timezone_str);
 
+    /// Columns of timestamps, e.g. the non null values, straight from and to the arrays.
+    const auto * x_col = checkAndGetColumn<ColumnDateTime64>(&x);
+    const auto * y_col = checkAndGetColumn<ColumnDateTime64>(&y);
+    if (x_col && y_col)
+    {
+        IColumn * res_nested = res.get();
+        if (auto * res_nullable = typeid_cast<ColumnNullable *>(res.get()))
+        {
+            res_nullable->getNullMapData().resize_fill(rows, 0);
+            res_nested = &res_nullable->getNestedColumn();
+        }
+        auto & res_data = assert_cast<ColumnFloat64 &>(*res_nested).getData();
+        res_data.resize(rows);
+        const auto & x_data = x_col->getData();
+        const auto & y_data = y_col->getData();
+        const auto * round_col = checkAndGetColumn<ColumnUInt8>(&round_off);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            bool round = round_col ? round_col->getData()[i] : round_off.getBool(i);
+            res_data[i] = monthsBetween(x_data[i], y_data[i], timezone, round);
+        }
+        return res;
+    }
+
     for (size_t i = 0; i < rows; ++i)
     {
         DB::Field x_value;
@@ -17,16 +17,20 @@
 #include "SparkFunctionNextDay.h"
 #include <unordered_map>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsDateTime.h>
 #include <DataTypes/DataTypeDate32.h>
 #include <DataTypes/DataTypeDateTime.h>
 #include <DataTypes/DataTypeDateTime64.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <Functions/DateTimeTransforms.h>
 #include <Functions/FunctionFactory.h>
+#include <Functions/FunctionHelpers.h>
 #include <Functions/TransformDateTime64.h>
 #include <Poco/Logger.h>
 #include <Common/DateLUT.h>
 #include <Common/Exception.h>
+#include <Common/assert_cast.h>
+#include <Common/typeid_cast.h>
 #include <Common/logger_useful.h>
 #include <boost/algorithm/string/case_conv.hpp>
 
@@ -120,6 +124,33 @@ struct NextDayConstTransformer
 };
 
 
+/// Days since the epoch in a column of Date or Date32, whose weekday is arithmetic on the day number: 1970-01-01 was a
+/// Thursday. The next days are written straight to the result array, without the per row Field and time zone calls.
+template <typename ColumnType>
+static bool executeDays(const DB::IColumn & src_col, UInt8 next_weekday, DB::IColumn & dst_col)
+{
+    const auto * days_col = DB::checkAndGetColumn<ColumnType>(&src_col);
+    if (!days_col)
+        return false;
+    DB::IColumn * dst_nested = &dst_col;
+    if (auto * dst_nullable = typeid_cast<DB::ColumnNullable *>(&dst_col))
+    {
+        dst_nullable->getNullMapData().resize_fill(days_col->size(), 0);
+        dst_nested = &dst_nullable->getNestedColumn();
+    }
+    const auto & days = days_col->getData();
+    auto & res = assert_cast<ColumnType &>(*dst_nested).getData();
+    res.resize(days.size());
+    for (size_t i = 0; i < days.size(); ++i)
+    {
+        /// Monday is 1 as with week mode 0.
+        auto day = static_cast<Int64>(days[i]);
+        auto from_week_day = static_cast<UInt16>((day % 7 + 7 + 3) % 7 + 1);
+        res[i] = static_cast<typename ColumnType::ValueType>(day + NextDayConstTransformer::calDayDelta(from_week_day, next_weekday));
+    }
+    return true;
+}
+
 template <typename DateType>
 class NextDayConstImpl
 {
@@ -197,6 +228,10 @@ DB::ColumnPtr SparkFunctionNextDay::executeConst(const DB::ColumnsWithTypeAndNam
     auto to_date_col = result_type->createColumn();
     to_date_col->reserve(from_date_col->size());
     DB::WhichDataType ty_which(nested_result_type);
+    if ((ty_which.isDate() && executeDays<DB::ColumnDate>(*from_date_col, next_week_day, *to_date_col))
+        || (ty_which.isDate32() && executeDays<DB::ColumnDate32>(*from_date_col, next_week_day, *to_date_col)))
+        return std::move(to_date_col);
+
     if (ty_which.isDate())
     {
         NextDayConstImpl<DB::DataTypeDate>::execute(
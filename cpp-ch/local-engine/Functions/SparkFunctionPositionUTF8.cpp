@@ -18,6 +18,7 @@
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionsStringSearch.h>
 #include <Functions/PositionImpl.h>
+#include <Functions/SparkStringKernels.h>
 
 namespace DB
 {
@@ -32,7 +33,8 @@ namespace local_engine
 {
 using namespace DB;
 
-// Spark-specific version of PositionImpl
+// Spark-specific version of PositionImpl. Characters of all ASCII haystacks are counted as bytes, and the needles
+// differing by row are searched for with findSubstring instead of a searcher set up per row.
 template <typename Name, typename Impl>
 struct PositionSparkImpl
 {
@@ -64,6 +66,7 @@ struct PositionSparkImpl
         size_t i = 0;
 
         typename Impl::SearcherInBigHaystack searcher = Impl::createSearcherInBigHaystack(needle.data(), needle.size(), end - pos);
+        bool ascii = isAllASCII(begin, data.size());
 
         /// We will search for the next occurrence in all strings at once.
         while (pos < end && end != (pos = searcher.search(pos, end - pos)))
@@ -80,12 +83,16 @@ struct PositionSparkImpl
             // The result is 0 if start_pos is 0, in compliance with Spark semantics
             if (start != 0 && pos + needle.size() < begin + offsets[i])
             {
-                auto res_pos
-                    = 1 + Impl::countChars(reinterpret_cast<const char *>(begin + offsets[i - 1]), reinterpret_cast<const char *>(pos));
+                UInt64 res_pos = ascii
+                    ? 1 + static_cast<UInt64>(pos - (begin + offsets[i - 1]))
+                    : 1 + Impl::countChars(reinterpret_cast<const char *>(begin + offsets[i - 1]), reinterpret_cast<const char *>(pos));
                 if (res_pos < start)
                 {
-                    pos = reinterpret_cast<const UInt8 *>(Impl::advancePos(
-                        reinterpret_cast<const char *>(pos), reinterpret_cast<const char *>(begin + offsets[i]), start - res_pos));
+                    if (ascii)
+                        pos += std::min<UInt64>(start - res_pos, begin + offsets[i] - pos);
+                    else
+                        pos = reinterpret_cast<const UInt8 *>(Impl::advancePos(
+                            reinterpret_cast<const char *>(pos), reinterpret_cast<const char *>(begin + offsets[i]), start - res_pos));
                     continue;
                 }
                 // The result is 1 if needle is empty, in compliance with Spark semantics
@@ -191,26 +198,20 @@ struct PositionSparkImpl
             }
             else
             {
-                /// It is assumed that the StringSearcher is not very difficult to initialize.
-                typename Impl::SearcherInSmallHaystack searcher = Impl::createSearcherInSmallHaystack(
-                    reinterpret_cast<const char *>(&needle_data[prev_needle_offset]),
-                    needle_offsets[i] - prev_needle_offset - 1); /// zero byte at the end
-
-                const char * beg = Impl::advancePos(
-                    reinterpret_cast<const char *>(&haystack_data[prev_haystack_offset]),
-                    reinterpret_cast<const char *>(&haystack_data[haystack_offsets[i] - 1]),
-                    start - 1);
-                /// searcher returns a pointer to the found substring or to the end of `haystack`.
-                size_t pos = searcher.search(reinterpret_cast<const UInt8 *>(beg), &haystack_data[haystack_offsets[i] - 1])
-                    - &haystack_data[prev_haystack_offset];
-
-                if (pos != haystack_size)
-                {
+                const UInt8 * haystack = &haystack_data[prev_haystack_offset];
+                const UInt8 * haystack_end = haystack + haystack_size;
+                bool ascii = isAllASCII(haystack, haystack_size);
+                const UInt8 * beg = haystack + (start - 1);
+                if (!ascii)
+                    beg = reinterpret_cast<const UInt8 *>(Impl::advancePos(
+                        reinterpret_cast<const char *>(haystack), reinterpret_cast<const char *>(haystack_end), start - 1));
+                /// Returns a pointer to the found substring or to the end of `haystack`.
+                const UInt8 * found = findSubstring(beg, haystack_end, &needle_data[prev_needle_offset], needle_size);
+
+                if (found != haystack_end)
                     res[i] = 1
-                        + Impl::countChars(
-                                 reinterpret_cast<const char *>(&haystack_data[prev_haystack_offset]),
-                                 reinterpret_cast<const char *>(&haystack_data[prev_haystack_offset + pos]));
-                }
+                        + (ascii ? static_cast<UInt64>(found - haystack)
+                                 : Impl::countChars(reinterpret_cast<const char *>(haystack), reinterpret_cast<const char *>(found)));
                 else
                     res[i] = 0;
             }
@@ -234,6 +235,9 @@ struct PositionSparkImpl
 
         /// NOTE You could use haystack indexing. But this is a rare case.
         ColumnString::Offset prev_needle_offset = 0;
+        const auto * haystack_begin = reinterpret_cast<const UInt8 *>(haystack.data());
+        const auto * haystack_end = haystack_begin + haystack.size();
+        bool ascii = isAllASCII(haystack_begin, haystack.size());
 
         size_t size = needle_offsets.size();
 
@@ -253,18 +257,15 @@ struct PositionSparkImpl
             }
             else
             {
-                typename Impl::SearcherInSmallHaystack searcher = Impl::createSearcherInSmallHaystack(
-                    reinterpret_cast<const char *>(&needle_data[prev_needle_offset]), needle_offsets[i] - prev_needle_offset - 1);
-
-                const char * beg = Impl::advancePos(haystack.data(), haystack.data() + haystack.size(), start - 1);
-                size_t pos = searcher.search(
-                                 reinterpret_cast<const UInt8 *>(beg), reinterpret_cast<const UInt8 *>(haystack.data()) + haystack.size())
-                    - reinterpret_cast<const UInt8 *>(haystack.data());
+                const UInt8 * beg = ascii
+                    ? haystack_begin + (start - 1)
+                    : reinterpret_cast<const UInt8 *>(Impl::advancePos(haystack.data(), haystack.data() + haystack.size(), start - 1));
+                const UInt8 * found = findSubstring(beg, haystack_end, &needle_data[prev_needle_offset], needle_size);
 
-                if (pos != haystack.size())
-                {
-                    res[i] = 1 + Impl::countChars(haystack.data(), haystack.data() + pos);
-                }
+                if (found != haystack_end)
+                    res[i] = 1
+                        + (ascii ? static_cast<UInt64>(found - haystack_begin)
+                                 : Impl::countChars(haystack.data(), reinterpret_cast<const char *>(found)));
                 else
                     res[i] = 0;
             }
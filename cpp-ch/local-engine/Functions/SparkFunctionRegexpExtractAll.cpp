@@ -25,6 +25,7 @@
 #include <Functions/Regexps.h>
 #include <Interpreters/Context.h>
 #include <Common/FunctionDocumentation.h>
+#include <mutex>
 
 namespace DB
 {
@@ -110,10 +111,11 @@ namespace
             ColumnString::Chars & res_strings_chars = res_strings.getChars();
             ColumnString::Offsets & res_strings_offsets = res_strings.getOffsets();
 
+            const auto regexp = getRegexp(col_pattern->getValue<String>());
             if (col_const)
                 constantVector(
                     col_const->getValue<String>(),
-                    col_pattern->getValue<String>(),
+                    *regexp,
                     column_index,
                     res_offsets,
                     res_strings_chars,
@@ -125,7 +127,7 @@ namespace
                 vectorConstant(
                     col->getChars(),
                     col->getOffsets(),
-                    col_pattern->getValue<String>(),
+                    *regexp,
                     index,
                     res_offsets,
                     res_strings_chars,
@@ -135,7 +137,7 @@ namespace
                 vectorVector(
                     col->getChars(),
                     col->getOffsets(),
-                    col_pattern->getValue<String>(),
+                    *regexp,
                     column_index,
                     res_offsets,
                     res_strings_chars,
@@ -145,6 +147,24 @@ namespace
         }
 
     private:
+        using RegexpPtr = std::shared_ptr<const Regexps::Regexp>;
+
+        /// The pattern is constant, so it is compiled once for all the blocks rather than for each of them.
+        mutable std::mutex mutex;
+        mutable String cached_pattern;
+        mutable RegexpPtr cached_regexp;
+
+        RegexpPtr getRegexp(const String & pattern) const
+        {
+            std::lock_guard lock(mutex);
+            if (!cached_regexp || cached_pattern != pattern)
+            {
+                cached_regexp = std::make_shared<const Regexps::Regexp>(Regexps::createRegexp<false, false, false>(pattern));
+                cached_pattern = pattern;
+            }
+            return cached_regexp;
+        }
+
         static void saveMatchs(
             Pos start,
             Pos end,
@@ -193,13 +213,12 @@ namespace
         static void vectorConstant(
             const ColumnString::Chars & data,
             const ColumnString::Offsets & offsets,
-            const std::string & pattern,
+            const Regexps::Regexp & regexp,
             ssize_t index,
             ColumnArray::Offsets & res_offsets,
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const Regexps::Regexp regexp = Regexps::createRegexp<false, false, false>(pattern);
             unsigned capture = regexp.getNumberOfSubpatterns();
             if (index < 0 || index >= capture + 1)
                 throw Exception(
@@ -241,13 +260,12 @@ namespace
         static void vectorVector(
             const ColumnString::Chars & data,
             const ColumnString::Offsets & offsets,
-            const std::string & pattern,
+            const Regexps::Regexp & regexp,
             const ColumnPtr & column_index,
             ColumnArray::Offsets & res_offsets,
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const Regexps::Regexp regexp = Regexps::createRegexp<false, false, false>(pattern);
             unsigned capture = regexp.getNumberOfSubpatterns();
 
             OptimizedRegularExpression::MatchVec matches;
@@ -291,13 +309,12 @@ namespace
 
         static void constantVector(
             const std::string & str,
-            const std::string & pattern,
+            const Regexps::Regexp & regexp,
             const ColumnPtr & column_index,
             ColumnArray::Offsets & res_offsets,
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const Regexps::Regexp regexp = Regexps::createRegexp<false, false, false>(pattern);
             unsigned capture = regexp.getNumberOfSubpatterns();
 
             /// Copy data into padded array to be able to use memcpySmallAllowReadWriteOverflow15.
@@ -16,6 +16,7 @@
  */
 #include <type_traits>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnString.h>
 #include <Core/Field.h>
@@ -88,72 +89,85 @@ public:
     DB::ColumnPtr executeImpl(
         const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr & result_type, size_t /*input_rows_count*/) const override
     {
-        auto map_col = result_type->createColumn();
+        auto res_col = result_type->createColumn();
         auto pair_delim = (*arguments[1].column)[0].safeGet<String>();
-        auto pair_delim_len = pair_delim.size();
         auto kv_delim = (*arguments[2].column)[0].safeGet<String>();
-        auto kv_delim_len = kv_delim.size();
         const DB::IColumn * arg0 = arguments[0].column.get();
-        bool is_nullable = false;
-        if (arg0->isNullable())
+        const DB::NullMap * null_map = nullptr;
+        if (const auto * nullable_col = DB::checkAndGetColumn<DB::ColumnNullable>(arg0))
         {
-            arg0 = DB::checkAndGetColumn<DB::ColumnNullable>(arg0);
-            is_nullable = true;
+            arg0 = &nullable_col->getNestedColumn();
+            null_map = &nullable_col->getNullMapData();
         }
-        const auto * str_col = DB::checkAndGetColumn<DB::ColumnString>(arguments[0].column.get());
+        const auto * str_col = DB::checkAndGetColumn<DB::ColumnString>(arg0);
         if (!str_col) [[unlikely]]
         {
             throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "argument 0 for function {} must be String", getName());
         }
         const DB::ColumnString::Chars & str_vec = str_col->getChars();
         const DB::ColumnString::Offsets & str_offsets = str_col->getOffsets();
-        map_col->reserve(str_offsets.size());
+
+        /// The keys and values are appended to the nested columns of the map, no Field of each.
+        auto * res_nullable_col = typeid_cast<DB::ColumnNullable *>(res_col.get());
+        auto & map_col = assert_cast<DB::ColumnMap &>(res_nullable_col ? res_nullable_col->getNestedColumn() : *res_col);
+        auto & map_offsets = map_col.getNestedColumn().getOffsets();
+        auto & key_col = assert_cast<DB::ColumnString &>(map_col.getNestedData().getColumn(0));
+        auto & value_nullable_col = assert_cast<DB::ColumnNullable &>(map_col.getNestedData().getColumn(1));
+        auto & value_col = assert_cast<DB::ColumnString &>(value_nullable_col.getNestedColumn());
+        auto & value_null_map = value_nullable_col.getNullMapData();
+        map_offsets.reserve(str_offsets.size());
+        key_col.getChars().reserve(str_vec.size());
+        value_col.getChars().reserve(str_vec.size());
+        if (res_nullable_col)
+            res_nullable_col->getNullMapData().resize_fill(str_offsets.size(), 0);
 
         DB::ColumnString::Offset prev_offset = 0;
         for (size_t i = 0, n = str_offsets.size(); i < n; ++i)
         {
-            if (is_nullable && str_col->isNullAt(i))
+            if (null_map && (*null_map)[i])
             {
-                map_col->insertDefault();
+                if (res_nullable_col)
+                    res_nullable_col->getNullMapData()[i] = 1;
             }
             else
             {
-                DB::Map map;
                 Pos pair_begin = reinterpret_cast<const char *>(&str_vec[prev_offset]);
                 Pos str_end = reinterpret_cast<const char *>(&str_vec[str_offsets[i]]);
                 while (pair_begin < str_end)
                 {
                     // Get next pair.
-                    auto next_pair_begin
-                        = static_cast<const char *>(memmem(pair_begin, str_end - pair_begin, pair_delim.c_str(), pair_delim_len));
+                    auto next_pair_begin = find(pair_begin, str_end, pair_delim);
                     if (!next_pair_begin) [[unlikely]]
                         next_pair_begin = str_end - 1;
-                    Pos value_begin
-                        = static_cast<const char *>(memmem(pair_begin, next_pair_begin - pair_begin, kv_delim.c_str(), kv_delim_len));
-                    DB::Field key;
-                    DB::Field value;
+                    Pos value_begin = find(pair_begin, next_pair_begin, kv_delim);
                     if (!value_begin)
                     {
-                        key = std::string_view(pair_begin, next_pair_begin - pair_begin);
-                        value = DB::Null();
+                        key_col.insertData(pair_begin, next_pair_begin - pair_begin);
+                        value_col.insertDefault();
+                        value_null_map.push_back(1);
                     }
                     else
                     {
-                        key = std::string_view(pair_begin, value_begin - pair_begin);
-                        value = std::string_view(value_begin + kv_delim_len, next_pair_begin - value_begin - kv_delim_len);
+                        key_col.insertData(pair_begin, value_begin - pair_begin);
+                        value_col.insertData(value_begin + kv_delim.size(), next_pair_begin - value_begin - kv_delim.size());
+                        value_null_map.push_back(0);
                     }
-                    DB::Tuple tuple(2);
-                    tuple[0] = std::move(key);
-                    tuple[1] = std::move(value);
-                    map.emplace_back(std::move(tuple));
 
-                    pair_begin = next_pair_begin + pair_delim_len;
+                    pair_begin = next_pair_begin + pair_delim.size();
                 }
-                map_col->insert(map);
             }
+            map_offsets.push_back(key_col.size());
             prev_offset = str_offsets[i];
         }
-        return map_col;
+        return res_col;
+    }
+
+private:
+    static Pos find(Pos begin, Pos end, const String & delim)
+    {
+        if (delim.size() == 1)
+            return static_cast<Pos>(memchr(begin, delim[0], end - begin));
+        return static_cast<Pos>(memmem(begin, end - begin, delim.data(), delim.size()));
     }
 };
 REGISTER_FUNCTION(SparkFunctionStrToMap)
@@ -20,7 +20,9 @@
 #include <Functions/FunctionHelpers.h>
 #include <Functions/IFunction.h>
 #include <IO/WriteHelpers.h>
+#include <Functions/SparkStringKernels.h>
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -135,7 +137,8 @@ namespace
             ColumnString::Offsets & res_offsets,
             const String & trim_str) const
         {
-            res_data.reserve(data.size());
+            /// Trimmed rows are never longer.
+            res_data.resize(data.size());
 
             size_t rows = offsets.size();
             res_offsets.resize(rows);
@@ -145,11 +148,19 @@ namespace
 
             const UInt8 * start;
             size_t length;
-            std::unordered_set<char> trim_set(trim_str.begin(), trim_str.end());
+            std::array<bool, 256> trim_set{};
+            for (auto c : trim_str)
+                trim_set[static_cast<UInt8>(c)] = true;
+            /// Mostly a space, skipped 16 bytes at a time.
+            bool single_byte = trim_str.find_first_not_of(trim_str[0]) == String::npos;
             for (size_t i = 0; i < rows; ++i)
             {
-                trim(reinterpret_cast<const UInt8 *>(&data[prev_offset]), offsets[i] - prev_offset - 1, start, length, trim_set);
-                res_data.resize(res_data.size() + length + 1);
+                const auto * row = &data[prev_offset];
+                size_t size = offsets[i] - prev_offset - 1;
+                if (single_byte)
+                    trim(row, size, start, length, static_cast<UInt8>(trim_str[0]));
+                else
+                    trim(row, size, start, length, trim_set);
                 memcpySmallAllowReadWriteOverflow15(&res_data[res_offset], start, length);
                 res_offset += length + 1;
                 res_data[res_offset - 1] = '\0';
@@ -157,24 +168,37 @@ namespace
                 res_offsets[i] = res_offset;
                 prev_offset = offsets[i];
             }
+            res_data.resize(res_offset);
         }
 
-        void
-        trim(const UInt8 * data, size_t size, const UInt8 *& res_data, size_t & res_size, const std::unordered_set<char> & trim_set) const
+        void trim(const UInt8 * data, size_t size, const UInt8 *& res_data, size_t & res_size, const std::array<bool, 256> & trim_set) const
         {
-            const char * char_data = reinterpret_cast<const char *>(data);
-            const char * char_end = char_data + size;
+            const UInt8 * end = data + size;
 
             if constexpr (TrimMode::trim_left)
-                while (char_data < char_end && trim_set.contains(*char_data))
-                    ++char_data;
+                while (data < end && trim_set[*data])
+                    ++data;
 
             if constexpr (TrimMode::trim_right)
-                while (char_data < char_end && trim_set.contains(*(char_end - 1)))
-                    --char_end;
+                while (data < end && trim_set[*(end - 1)])
+                    --end;
 
-            res_data = reinterpret_cast<const UInt8 *>(char_data);
-            res_size = char_end - char_data;
+            res_data = data;
+            res_size = end - data;
+        }
+
+        void trim(const UInt8 * data, size_t size, const UInt8 *& res_data, size_t & res_size, UInt8 trim_byte) const
+        {
+            const UInt8 * end = data + size;
+
+            if constexpr (TrimMode::trim_left)
+                data = skipByteForward(data, end, trim_byte);
+
+            if constexpr (TrimMode::trim_right)
+                end = skipByteBackward(data, end, trim_byte);
+
+            res_data = data;
+            res_size = end - data;
         }
     };
 
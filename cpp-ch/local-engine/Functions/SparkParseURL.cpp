@@ -17,9 +17,12 @@
 #include <algorithm>
 #include <string.h>
 #include <Columns/ColumnFixedString.h>
+#include <Columns/ColumnTuple.h>
 #include <Columns/IColumn.h>
 #include <Core/ColumnsWithTypeAndName.h>
 #include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypeTuple.h>
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionStringToString.h>
 #include <Functions/FunctionsStringArray.h>
@@ -39,6 +42,7 @@ namespace ErrorCodes
 {
     extern const int ILLEGAL_COLUMN;
     extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+    extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
 }
 }
 
@@ -645,4 +649,154 @@ REGISTER_FUNCTION(SparkFunctionURLInvalid)
 {
     factory.registerFunction<SparkFunctionURLInvalid>();
 }
+
+/// spark_parse_url_parts(url, part_1, ..., part_n) is the tuple of parse_url(url, part_i) for all i, each url read once for
+/// all the parts rather than by a function of each. The plan parser merges the parse_url calls on the same url into it.
+/// PROTOCOL and QUERY with a key aren't parts of it, they are computed by their own functions.
+class SparkFunctionURLParts : public DB::IFunction
+{
+public:
+    static constexpr auto name = "spark_parse_url_parts";
+    static DB::FunctionPtr create(DB::ContextPtr) { return std::make_shared<SparkFunctionURLParts>(); }
+
+    String getName() const override { return name; }
+    bool isVariadic() const override { return true; }
+    size_t getNumberOfArguments() const override { return 0; }
+    bool useDefaultImplementationForConstants() const override { return true; }
+    /// A tuple isn't nullable, the nulls are handled by executeImpl.
+    bool useDefaultImplementationForNulls() const override { return false; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DB::DataTypesWithConstInfo & /*arguments*/) const override { return true; }
+
+    DB::DataTypePtr getReturnTypeImpl(const DB::ColumnsWithTypeAndName & arguments) const override
+    {
+        if (arguments.size() < 2)
+            throw DB::Exception(DB::ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH, "Function {} requires at least two arguments", getName());
+        for (const auto & argument : arguments)
+            if (!DB::isString(DB::removeNullable(argument.type)))
+                throw DB::Exception(DB::ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}",
+                    argument.type->getName(), getName());
+
+        DB::DataTypes types;
+        for (size_t i = 1; i < arguments.size(); ++i)
+        {
+            auto type = std::make_shared<DB::DataTypeString>();
+            /// PATH is the only part not null for a non null url, as spark_parse_url_path.
+            if (getPart(arguments[i]).nullable || arguments[0].type->isNullable())
+                types.emplace_back(DB::makeNullable(type));
+            else
+                types.emplace_back(type);
+        }
+        return std::make_shared<DB::DataTypeTuple>(types);
+    }
+
+    DB::ColumnPtr
+    executeImpl(const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr & result_type, size_t input_rows_count) const override
+    {
+        std::vector<Part> parts;
+        for (size_t i = 1; i < arguments.size(); ++i)
+            parts.emplace_back(getPart(arguments[i]));
+
+        const auto column = arguments[0].column->convertToFullColumnIfConst();
+        const DB::NullMap * null_map = nullptr;
+        const DB::IColumn * nested_column = column.get();
+        if (const auto * nullable = DB::checkAndGetColumn<DB::ColumnNullable>(column.get()))
+        {
+            null_map = &nullable->getNullMapData();
+            nested_column = &nullable->getNestedColumn();
+        }
+        const auto * col = DB::checkAndGetColumn<DB::ColumnString>(nested_column);
+        if (!col)
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}",
+                arguments[0].column->getName(), getName());
+
+        const auto & tuple_type = assert_cast<const DB::DataTypeTuple &>(*result_type);
+        std::vector<DB::ColumnString::MutablePtr> res_strings;
+        std::vector<DB::ColumnUInt8::MutablePtr> res_null_maps;
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            res_strings.emplace_back(DB::ColumnString::create());
+            res_strings.back()->getOffsets().resize(input_rows_count);
+            res_strings.back()->getChars().reserve(col->getChars().size() / parts.size());
+            res_null_maps.emplace_back(DB::ColumnUInt8::create(input_rows_count, 0));
+        }
+
+        const auto & data = col->getChars();
+        const auto & offsets = col->getOffsets();
+        DB::Pos start;
+        size_t length;
+        for (size_t row = 0; row < input_rows_count; ++row)
+        {
+            const bool is_null = null_map && (*null_map)[row];
+            const char * url = reinterpret_cast<const char *>(&data[offsets[row - 1]]);
+            const size_t url_size = offsets[row] - offsets[row - 1] - 1;
+            for (size_t i = 0; i < parts.size(); ++i)
+            {
+                if (is_null)
+                    start = nullptr;
+                else
+                    parts[i].execute(url, url_size, start, length);
+
+                auto & res_data = res_strings[i]->getChars();
+                size_t res_offset = res_data.size();
+                if (start)
+                {
+                    res_data.resize(res_offset + length + 1);
+                    memcpySmallAllowReadWriteOverflow15(&res_data[res_offset], start, length);
+                    res_offset += length;
+                }
+                else
+                {
+                    res_data.resize(res_offset + 1);
+                    res_null_maps[i]->getData()[row] = 1;
+                }
+                res_data[res_offset] = 0;
+                res_strings[i]->getOffsets()[row] = res_offset + 1;
+            }
+        }
+
+        DB::Columns res_columns;
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            if (tuple_type.getElement(i)->isNullable())
+                res_columns.emplace_back(DB::ColumnNullable::create(std::move(res_strings[i]), std::move(res_null_maps[i])));
+            else
+                res_columns.emplace_back(std::move(res_strings[i]));
+        }
+        return DB::ColumnTuple::create(std::move(res_columns));
+    }
+
+private:
+    struct Part
+    {
+        void (*execute)(DB::Pos, size_t, DB::Pos &, size_t &);
+        bool nullable;
+    };
+
+    Part getPart(const DB::ColumnWithTypeAndName & argument) const
+    {
+        const auto * part_column = DB::checkAndGetColumnConst<DB::ColumnString>(argument.column.get());
+        if (!part_column)
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "The parts of function {} must be constant strings", getName());
+        const auto part = part_column->getValue<String>();
+        if (part == "HOST")
+            return {&SparkExtractURLHost::execute, true};
+        else if (part == "PATH")
+            return {&SparkExtractURLPath::execute, false};
+        else if (part == "QUERY")
+            return {&SparkExtractURLQuery::execute, true};
+        else if (part == "REF")
+            return {&SparkExtractURLRef::execute, true};
+        else if (part == "FILE")
+            return {&SparkExtractURLFile::execute, true};
+        else if (part == "AUTHORITY")
+            return {&SparkExtractURLAuthority::execute, true};
+        else if (part == "USERINFO")
+            return {&SparkExtractURLUserInfo::execute, true};
+        throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "Unsupported part {} of function {}", part, getName());
+    }
+};
+REGISTER_FUNCTION(SparkFunctionURLParts)
+{
+    factory.registerFunction<SparkFunctionURLParts>();
+}
 }
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <base/types.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+/// Byte kernels of the Spark string functions, 16 bytes at a time with SSE2 and a byte at a time otherwise.
+namespace local_engine
+{
+/// Whether a byte is a character in the UTF-8 string.
+inline bool isAllASCII(const UInt8 * data, size_t size)
+{
+    const UInt8 * end = data + size;
+    UInt8 bits = 0;
+#ifdef __SSE2__
+    __m128i any = _mm_setzero_si128();
+    for (; data + 16 <= end; data += 16)
+        any = _mm_or_si128(any, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)));
+    if (_mm_movemask_epi8(any))
+        return false;
+#endif
+    for (; data < end; ++data)
+        bits |= *data;
+    return !(bits & 0x80);
+}
+
+/// Of the first byte from pos that isn't c, or end.
+inline const UInt8 * skipByteForward(const UInt8 * pos, const UInt8 * end, UInt8 c)
+{
+#ifdef __SSE2__
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(c));
+    for (; pos + 16 <= end; pos += 16)
+    {
+        auto mask = static_cast<UInt16>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)), needle)));
+        if (mask != 0xFFFF)
+            return pos + std::countr_one(mask);
+    }
+#endif
+    while (pos < end && *pos == c)
+        ++pos;
+    return pos;
+}
+
+/// Of the byte after the last one before end that isn't c, or begin.
+inline const UInt8 * skipByteBackward(const UInt8 * begin, const UInt8 * end, UInt8 c)
+{
+#ifdef __SSE2__
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(c));
+    for (; begin + 16 <= end; end -= 16)
+    {
+        auto mask = static_cast<UInt16>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(end - 16)), needle)));
+        if (mask != 0xFFFF)
+            return end - std::countl_one(mask);
+    }
+#endif
+    while (begin < end && *(end - 1) == c)
+        --end;
+    return end;
+}
+
+/// Of the first occurrence of the needle in [pos, end), or end. The positions where both the first and the last byte
+/// of the needle match are compared in full, which is cheap to set up for a needle per row unlike the searchers of
+/// ClickHouse. The needle isn't empty.
+inline const UInt8 * findSubstring(const UInt8 * pos, const UInt8 * end, const UInt8 * needle, size_t needle_size)
+{
+    if (needle_size > static_cast<size_t>(end - pos))
+        return end;
+    /// The last position a match may start at.
+    const UInt8 * last = end - needle_size;
+#ifdef __SSE2__
+    const __m128i first_byte = _mm_set1_epi8(static_cast<char>(needle[0]));
+    const __m128i last_byte = _mm_set1_epi8(static_cast<char>(needle[needle_size - 1]));
+    for (; pos + 16 <= last + 1; pos += 16)
+    {
+        __m128i firsts = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+        __m128i lasts = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos + needle_size - 1));
+        auto mask = static_cast<UInt16>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firsts, first_byte), _mm_cmpeq_epi8(lasts, last_byte))));
+        for (; mask; mask &= mask - 1)
+        {
+            const UInt8 * candidate = pos + std::countr_zero(mask);
+            if (memcmp(candidate, needle, needle_size) == 0)
+                return candidate;
+        }
+    }
+#endif
+    for (; pos <= last; ++pos)
+        if (*pos == needle[0] && memcmp(pos, needle, needle_size) == 0)
+            return pos;
+    return end;
+}
+}
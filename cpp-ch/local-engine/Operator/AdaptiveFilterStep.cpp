@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AdaptiveFilterStep.h"
+#include <algorithm>
+#include <numeric>
+#include <Columns/ColumnsCommon.h>
+#include <Columns/FilterDescription.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <Common/Stopwatch.h>
+
+namespace local_engine
+{
+/// Chunks measured before the first reordering, and between the later ones.
+static constexpr size_t SAMPLE_CHUNKS = 4;
+static constexpr size_t REORDER_INTERVAL_CHUNKS = 64;
+
+static DB::ITransformingStep::Traits getTraits()
+{
+    return DB::ITransformingStep::Traits{
+        {
+            .returns_single_stream = false,
+            .preserves_number_of_streams = true,
+            .preserves_sorting = true,
+        },
+        {
+            .preserves_number_of_rows = false,
+        }};
+}
+
+AdaptiveFilterStep::AdaptiveFilterStep(const DB::DataStream & input_stream_, std::vector<DB::ActionsDAGPtr> conjuncts_)
+    : DB::ITransformingStep(input_stream_, input_stream_.header, getTraits()), conjuncts(std::move(conjuncts_))
+{
+}
+
+void AdaptiveFilterStep::transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings)
+{
+    std::vector<DB::ExpressionActionsPtr> actions;
+    for (const auto & conjunct : conjuncts)
+        actions.emplace_back(std::make_shared<DB::ExpressionActions>(conjunct, settings.getActionsSettings()));
+    pipeline.addSimpleTransform([&](const DB::Block & header) { return std::make_shared<AdaptiveFilterTransform>(header, actions); });
+}
+
+void AdaptiveFilterStep::describeActions(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    String prefix(settings.offset, settings.indent_char);
+    for (const auto & conjunct : conjuncts)
+        settings.out << prefix << "Conjunct: " << conjunct->getOutputs().front()->result_name << '\n';
+}
+
+void AdaptiveFilterStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void AdaptiveFilterStep::updateOutputStream()
+{
+    createOutputStream(input_streams.front(), input_streams.front().header, getDataStreamTraits());
+}
+
+AdaptiveFilterTransform::AdaptiveFilterTransform(const DB::Block & header_, const std::vector<DB::ExpressionActionsPtr> & conjuncts_)
+    : DB::ISimpleTransform(header_, header_, true), order(conjuncts_.size()), next_reorder_chunks(SAMPLE_CHUNKS)
+{
+    for (const auto & actions : conjuncts_)
+    {
+        Conjunct conjunct;
+        conjunct.actions = actions;
+        conjunct.result_name = actions->getActionsDAG().getOutputs().front()->result_name;
+        conjunct.required_columns = actions->getRequiredColumns();
+        conjuncts.emplace_back(std::move(conjunct));
+    }
+    std::iota(order.begin(), order.end(), 0);
+}
+
+void AdaptiveFilterTransform::transform(DB::Chunk & chunk)
+{
+    const auto & header = getInputPort().getHeader();
+    size_t num_rows = chunk.getNumRows();
+    auto columns = chunk.detachColumns();
+    for (auto index : order)
+    {
+        if (!num_rows)
+            break;
+        auto & conjunct = conjuncts[index];
+        Stopwatch watch;
+        DB::Block block;
+        for (const auto & name : conjunct.required_columns)
+        {
+            auto position = header.getPositionByName(name);
+            block.insert({columns[position], header.getByPosition(position).type, name});
+        }
+        size_t rows = num_rows;
+        conjunct.actions->execute(block, rows);
+        auto condition = block.getByName(conjunct.result_name).column->convertToFullColumnIfConst()->convertToFullColumnIfLowCardinality();
+        DB::FilterDescription filter(*condition);
+        size_t passed = DB::countBytesInFilter(*filter.data);
+        if (passed < num_rows)
+        {
+            for (auto & column : columns)
+                column = column->filter(*filter.data, passed);
+        }
+        conjunct.rows_in += num_rows;
+        conjunct.rows_out += passed;
+        conjunct.elapsed_ns += watch.elapsedNanoseconds();
+        num_rows = passed;
+    }
+    chunk.setColumns(std::move(columns), num_rows);
+
+    if (++chunks == next_reorder_chunks)
+    {
+        reorder();
+        next_reorder_chunks += REORDER_INTERVAL_CHUNKS;
+    }
+}
+
+void AdaptiveFilterTransform::reorder()
+{
+    /// The cost per row of a conjunct over the fraction of rows it drops, the least first. The conjuncts not measured
+    /// yet go first.
+    auto rank = [this](size_t index)
+    {
+        const auto & conjunct = conjuncts[index];
+        if (!conjunct.rows_in)
+            return 0.0;
+        double cost = static_cast<double>(conjunct.elapsed_ns) / conjunct.rows_in;
+        double dropped = 1.0 - static_cast<double>(conjunct.rows_out) / conjunct.rows_in;
+        return cost / std::max(dropped, 1e-6);
+    };
+    std::vector<double> ranks(conjuncts.size());
+    for (size_t i = 0; i < conjuncts.size(); ++i)
+        ranks[i] = rank(i);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+
+    for (auto & conjunct : conjuncts)
+    {
+        conjunct.rows_in /= 2;
+        conjunct.rows_out /= 2;
+        conjunct.elapsed_ns /= 2;
+    }
+}
+}
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <Interpreters/ActionsDAG.h>
+#include <Interpreters/ExpressionActions.h>
+#include <Processors/ISimpleTransform.h>
+#include <Processors/QueryPlan/ITransformingStep.h>
+
+namespace local_engine
+{
+/// Filters by the conjuncts of an and one after another, each over the rows the previous ones kept, instead of by the
+/// and at once. The conjuncts dropping the most rows for their cost are evaluated first, as measured on the chunks.
+/// The output has the columns of the input.
+class AdaptiveFilterStep : public DB::ITransformingStep
+{
+public:
+    AdaptiveFilterStep(const DB::DataStream & input_stream_, std::vector<DB::ActionsDAGPtr> conjuncts_);
+    ~AdaptiveFilterStep() override = default;
+
+    String getName() const override { return "AdaptiveFilterStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describeActions(DB::IQueryPlanStep::FormatSettings & settings) const override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+
+private:
+    std::vector<DB::ActionsDAGPtr> conjuncts;
+    void updateOutputStream() override;
+};
+
+class AdaptiveFilterTransform : public DB::ISimpleTransform
+{
+public:
+    AdaptiveFilterTransform(const DB::Block & header_, const std::vector<DB::ExpressionActionsPtr> & conjuncts_);
+    void transform(DB::Chunk & chunk) override;
+    String getName() const override { return "AdaptiveFilterTransform"; }
+
+    /// The positions of the conjuncts in the order they are evaluated.
+    const std::vector<size_t> & getOrder() const { return order; }
+
+private:
+    struct Conjunct
+    {
+        DB::ExpressionActionsPtr actions;
+        String result_name;
+        DB::Names required_columns;
+        /// Since the last reordering, halved at each so that the order follows the data.
+        size_t rows_in = 0;
+        size_t rows_out = 0;
+        UInt64 elapsed_ns = 0;
+    };
+
+    std::vector<Conjunct> conjuncts;
+    std::vector<size_t> order;
+    size_t chunks = 0;
+    size_t next_reorder_chunks;
+
+    void reorder();
+};
+}
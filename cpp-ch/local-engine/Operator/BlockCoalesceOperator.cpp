@@ -29,8 +29,12 @@ bool BlockCoalesceOperator::isFull()
 }
 DB::Block * BlockCoalesceOperator::releaseBlock()
 {
+    auto * block = new DB::Block(block_buffer.releaseColumns());
+    /// The block released before is no longer used, the next one accumulates into its columns.
+    if (cached_block)
+        block_buffer.recycleColumns(std::move(*cached_block));
     clearCache();
-    cached_block = new DB::Block(block_buffer.releaseColumns());
+    cached_block = block;
     return cached_block;
 }
 BlockCoalesceOperator::~BlockCoalesceOperator()
@@ -15,17 +15,21 @@
  * limitations under the License.
  */
 #include "BlocksBufferPoolTransform.h"
+#include <Processors/Executors/PullingPipelineExecutor.h>
 #include <QueryPipeline/Pipe.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
+#include <base/scope_guard.h>
+#include <Common/CurrentThread.h>
+#include <Common/setThreadName.h>
 
 namespace local_engine
 {
-static DB::ITransformingStep::Traits getTraits()
+static DB::ITransformingStep::Traits getTraits(bool async)
 {
     return DB::ITransformingStep::Traits{
         {
-            .returns_single_stream = false,
-            .preserves_number_of_streams = true,
+            .returns_single_stream = async,
+            .preserves_number_of_streams = !async,
             .preserves_sorting = true,
         },
         {
@@ -33,9 +37,10 @@ static DB::ITransformingStep::Traits getTraits()
         }};
 }
 
-BlocksBufferPoolTransform::BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_)
+BlocksBufferPoolTransform::BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_, size_t max_bytes_)
     : DB::IProcessor({header}, {header})
     , buffer_size(buffer_size_)
+    , max_bytes(max_bytes_)
 {
 }
 
@@ -52,6 +57,7 @@ DB::IProcessor::Status BlocksBufferPoolTransform::prepare()
     bool has_output = false;
     if (output.canPush() && !pending_chunks.empty())
     {
+        pending_bytes -= pending_chunks.front().bytes();
         output.push(std::move(pending_chunks.front()));
         pending_chunks.pop_front();
         has_output = true;
@@ -71,7 +77,8 @@ DB::IProcessor::Status BlocksBufferPoolTransform::prepare()
     if (input.hasData())
     {
         pending_chunks.push_back(input.pull(true));
-        if (pending_chunks.size() >= buffer_size)
+        pending_bytes += pending_chunks.back().bytes();
+        if (pending_chunks.size() >= buffer_size || (max_bytes && pending_bytes >= max_bytes))
         {
             return Status::PortFull;
         }
@@ -84,20 +91,119 @@ void BlocksBufferPoolTransform::work()
 {
 }
 
-BlocksBufferPoolStep::BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_)
-    : DB::ITransformingStep(input_stream_, input_stream_.header, getTraits())
+BlocksPrefetchSource::BlocksPrefetchSource(const DB::Block & header, DB::QueryPipeline upstream_, size_t max_bytes_)
+    : DB::ISource(header), upstream(std::move(upstream_)), max_bytes(max_bytes_), thread_group(DB::CurrentThread::getGroup())
+{
+}
+
+BlocksPrefetchSource::~BlocksPrefetchSource()
+{
+    stop();
+}
+
+DB::Chunk BlocksPrefetchSource::generate()
+{
+    if (!thread)
+        thread.emplace([this] { prefetch(); });
+
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [this] { return !queue.empty() || finished || cancelled; });
+    if (!queue.empty())
+    {
+        auto chunk = std::move(queue.front());
+        queue.pop_front();
+        queued_bytes -= chunk.bytes();
+        cv.notify_all();
+        return chunk;
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+    return {};
+}
+
+void BlocksPrefetchSource::onCancel()
+{
+    std::lock_guard lock(mutex);
+    cancelled = true;
+    cv.notify_all();
+}
+
+void BlocksPrefetchSource::prefetch()
+{
+    setThreadName("BlocksPrefetch");
+    if (thread_group)
+        DB::CurrentThread::attachToGroupIfDetached(thread_group);
+    SCOPE_EXIT_SAFE(if (thread_group) DB::CurrentThread::detachFromGroupIfNotDetached(););
+    try
+    {
+        DB::PullingPipelineExecutor executor(upstream);
+        DB::Chunk chunk;
+        while (executor.pull(chunk))
+        {
+            if (!chunk)
+                continue;
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [this] { return cancelled || queue.empty() || queued_bytes < max_bytes; });
+            if (cancelled)
+            {
+                lock.unlock();
+                executor.cancel();
+                break;
+            }
+            queued_bytes += chunk.bytes();
+            queue.push_back(std::move(chunk));
+            cv.notify_all();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard lock(mutex);
+        exception = std::current_exception();
+    }
+    std::lock_guard lock(mutex);
+    finished = true;
+    cv.notify_all();
+}
+
+void BlocksPrefetchSource::stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        cancelled = true;
+        cv.notify_all();
+    }
+    if (thread && thread->joinable())
+        thread->join();
+}
+
+BlocksBufferPoolStep::BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_, size_t max_bytes_, bool async_)
+    : DB::ITransformingStep(input_stream_, input_stream_.header, getTraits(async_))
     , header(input_stream_.header)
     , buffer_size(buffer_size_)
+    , max_bytes(max_bytes_)
+    , async(async_)
 {
 }
 
 void BlocksBufferPoolStep::transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & /*settings*/)
 {
+    if (async)
+    {
+        /// The upstream becomes a pipeline of its own, run by the source on another thread.
+        auto num_threads = pipeline.getNumThreads();
+        pipeline.resize(1);
+        auto upstream = DB::QueryPipelineBuilder::getPipeline(std::move(pipeline));
+        upstream.setNumThreads(num_threads);
+        pipeline = DB::QueryPipelineBuilder();
+        pipeline.init(DB::Pipe(std::make_shared<BlocksPrefetchSource>(header, std::move(upstream), std::max<size_t>(max_bytes, 1))));
+        pipeline.setMaxThreads(num_threads);
+        return;
+    }
     auto build_transform= [&](DB::OutputPortRawPtrs outputs){
         DB::Processors new_processors;
         for (auto & output : outputs)
         {
-            auto buffer_pool_op = std::make_shared<BlocksBufferPoolTransform>(output->getHeader(), buffer_size);
+            auto buffer_pool_op = std::make_shared<BlocksBufferPoolTransform>(output->getHeader(), buffer_size, max_bytes);
             new_processors.push_back(buffer_pool_op);
             DB::connect(*output, buffer_pool_op->getInputs().front());
         }
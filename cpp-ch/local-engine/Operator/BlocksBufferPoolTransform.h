@@ -16,19 +16,30 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <mutex>
+#include <optional>
 #include <Processors/IProcessor.h>
+#include <Processors/ISource.h>
 #include <Processors/Port.h>
 #include <Processors/QueryPlan/IQueryPlanStep.h>
 #include <Processors/QueryPlan/ITransformingStep.h>
+#include <QueryPipeline/QueryPipeline.h>
+#include <Common/ThreadPool.h>
+#include <Common/ThreadStatus.h>
 
 
 namespace local_engine
 {
+/// Buffers the chunks of each stream, up to buffer_size chunks or max_bytes bytes (0 for no byte bound). If async, the
+/// upstream pipeline is run by a BlocksPrefetchSource on its own thread instead, feeding max_bytes ahead of the
+/// downstream operators.
 class BlocksBufferPoolStep : public DB::ITransformingStep
 {
 public:
-    explicit BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_ = 4);
+    explicit BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_ = 4, size_t max_bytes_ = 0, bool async_ = false);
     ~BlocksBufferPoolStep() override = default;
 
     String getName() const override { return "BlocksBufferPoolStep"; }
@@ -38,6 +49,8 @@ public:
 private:
     DB::Block header;
     size_t buffer_size;
+    size_t max_bytes;
+    bool async;
     void updateOutputStream() override;
 };
 
@@ -45,7 +58,7 @@ class BlocksBufferPoolTransform  : public DB::IProcessor
 {
 public:
     using Status = DB::IProcessor::Status;
-    explicit BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_ = 4);
+    explicit BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_ = 4, size_t max_bytes_ = 0);
     ~BlocksBufferPoolTransform() override = default;
 
     Status prepare() override;
@@ -54,6 +67,40 @@ public:
     DB::String getName() const override { return "BlocksBufferPoolTransform"; }
 private:
     std::list<DB::Chunk> pending_chunks;
+    size_t pending_bytes = 0;
     size_t buffer_size;
+    size_t max_bytes;
+};
+
+/// Pulls the chunks of the upstream pipeline on a thread of the global pool, started by the first generate(), and
+/// keeps up to max_bytes of them queued (at least one). The upstream reads and decodes while the downstream computes.
+class BlocksPrefetchSource : public DB::ISource
+{
+public:
+    BlocksPrefetchSource(const DB::Block & header, DB::QueryPipeline upstream_, size_t max_bytes_);
+    ~BlocksPrefetchSource() override;
+
+    String getName() const override { return "BlocksPrefetchSource"; }
+
+protected:
+    DB::Chunk generate() override;
+    void onCancel() override;
+
+private:
+    void prefetch();
+    void stop();
+
+    DB::QueryPipeline upstream;
+    const size_t max_bytes;
+    DB::ThreadGroupPtr thread_group;
+    std::optional<ThreadFromGlobalPool> thread;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<DB::Chunk> queue;
+    size_t queued_bytes = 0;
+    bool finished = false;
+    bool cancelled = false;
+    std::exception_ptr exception;
 };
 }
@@ -53,7 +53,8 @@ ExpandTransform::Status ExpandTransform::prepare()
 
     if (has_output)
     {
-        output.push(nextChunk());
+        output.push(std::move(output_chunk));
+        has_output = false;
         return Status::PortFull;
     }
 
@@ -69,83 +70,66 @@ ExpandTransform::Status ExpandTransform::prepare()
 
         if (!input.hasData())
             return Status::NeedData;
-        
+
         input_chunk = input.pull(true);
         has_input = true;
+        expand_row = 0;
     }
-    
+
     return Status::Ready;
 }
 
 void ExpandTransform::work()
 {
-    assert(expanded_chunks.empty());
+    /// The expanded chunks are built one at a time as the output takes them, and the constant and null columns of the
+    /// grouping sets stay constant, rather than getExpandRows() full copies of the input in memory per input chunk.
     const auto & original_cols = input_chunk.getColumns();
     size_t rows = input_chunk.getNumRows();
 
-    for (size_t i = 0; i < project_set_exprs.getExpandRows(); ++i)
+    DB::Columns cols;
+    cols.reserve(project_set_exprs.getExpandCols());
+    for (size_t j = 0; j < project_set_exprs.getExpandCols(); ++j)
     {
-        DB::Columns cols;
-        for (size_t j = 0; j < project_set_exprs.getExpandCols(); ++j)
-        {
-            const auto & type = project_set_exprs.getTypes()[j];
-            const auto & kind = project_set_exprs.getKinds()[i][j];
-            const auto & field = project_set_exprs.getFields()[i][j];
+        const auto & type = project_set_exprs.getTypes()[j];
+        const auto & kind = project_set_exprs.getKinds()[expand_row][j];
+        const auto & field = project_set_exprs.getFields()[expand_row][j];
 
-            if (kind == EXPAND_FIELD_KIND_SELECTION)
+        if (kind == EXPAND_FIELD_KIND_SELECTION)
+        {
+            const auto & original_col = original_cols[field.get<Int32>()];
+            if (type->isNullable() == original_col->isNullable())
             {
-                const auto & original_col = original_cols[field.get<Int32>()];
-                if (type->isNullable() == original_col->isNullable())
-                {
-                    cols.push_back(original_col);
-                }
-                else if (type->isNullable() && !original_col->isNullable())
-                {
-                    auto null_map = DB::ColumnUInt8::create(rows, 0);
-                    auto col = DB::ColumnNullable::create(original_col, std::move(null_map));
-                    cols.push_back(std::move(col));
-                }
-                else
-                {
-                    throw DB::Exception(
-                        DB::ErrorCodes::LOGICAL_ERROR,
-                        "Miss match nullable, column {} is nullable, but type {} is not nullable",
-                        original_col->getName(),
-                        type->getName());
-                }
+                cols.push_back(original_col);
+            }
+            else if (type->isNullable() && !original_col->isNullable())
+            {
+                auto null_map = DB::ColumnUInt8::create(rows, 0);
+                auto col = DB::ColumnNullable::create(original_col, std::move(null_map));
+                cols.push_back(std::move(col));
             }
             else
             {
-                if (field.isNull())
-                {
-                    // Add null column
-                    auto null_map = DB::ColumnUInt8::create(rows, 1);
-                    auto nested_type = DB::removeNullable(type);
-                    auto col = DB::ColumnNullable::create(nested_type->createColumn()->cloneResized(rows), std::move(null_map));
-                    cols.push_back(std::move(col));
-                }
-                else
-                {
-                    // Add constant column: gid, gpos, etc.
-                    auto col = type->createColumnConst(rows, field);
-                    cols.push_back(col->convertToFullColumnIfConst());
-                }
+                throw DB::Exception(
+                    DB::ErrorCodes::LOGICAL_ERROR,
+                    "Miss match nullable, column {} is nullable, but type {} is not nullable",
+                    original_col->getName(),
+                    type->getName());
             }
         }
-        expanded_chunks.push_back(DB::Chunk(cols, rows));
+        else
+        {
+            // Null or constant column: gid, gpos, etc.
+            const auto & const_type = field.isNull() ? DB::makeNullable(type) : type;
+            cols.push_back(const_type->createColumnConst(rows, field));
+        }
     }
-
+    output_chunk = DB::Chunk(std::move(cols), rows);
     has_output = true;
-    has_input = false;
-}
 
-DB::Chunk ExpandTransform::nextChunk()
-{
-    assert(!expanded_chunks.empty());
-    DB::Chunk ret;
-    ret.swap(expanded_chunks.front());
-    expanded_chunks.pop_front();
-    has_output = !expanded_chunks.empty();
-    return ret;
+    if (++expand_row == project_set_exprs.getExpandRows())
+    {
+        input_chunk.clear();
+        has_input = false;
+    }
 }
 }
@@ -48,7 +48,8 @@ private:
     bool has_output = false;
 
     DB::Chunk input_chunk;
-    std::list<DB::Chunk> expanded_chunks;
-    DB::Chunk nextChunk();
+    /// Of the expanded chunk of input_chunk to build next.
+    size_t expand_row = 0;
+    DB::Chunk output_chunk;
 };
 }
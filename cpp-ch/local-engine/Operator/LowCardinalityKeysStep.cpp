@@ -0,0 +1,314 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LowCardinalityKeysStep.h"
+#include <Columns/ColumnLowCardinality.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeLowCardinality.h>
+#include <DataTypes/DataTypeString.h>
+#include <Interpreters/AggregationCommon.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <Common/Arena.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int LOGICAL_ERROR;
+}
+}
+
+namespace local_engine
+{
+/// Combinations of dictionary positions up to this many are numbered through an array, more through a hash map.
+static constexpr UInt64 MAX_DENSE_COMBINATIONS = 1 << 16;
+
+static DB::ITransformingStep::Traits getTraits()
+{
+    return DB::ITransformingStep::Traits{
+        {
+            .returns_single_stream = false,
+            .preserves_number_of_streams = true,
+            .preserves_sorting = false,
+        },
+        {
+            .preserves_number_of_rows = true,
+        }};
+}
+
+template <typename T>
+static void appendPositions(const DB::IColumn & indexes, UInt64 dictionary_size, DB::PaddedPODArray<UInt64> & combined)
+{
+    const auto & data = assert_cast<const DB::ColumnVector<T> &>(indexes).getData();
+    for (size_t row = 0; row < combined.size(); ++row)
+        combined[row] = combined[row] * dictionary_size + data[row];
+}
+
+CombineLowCardinalityKeysStep::CombineLowCardinalityKeysStep(
+    const DB::DataStream & input_stream_, const DB::Names & keys_, const String & combined_key_)
+    : DB::ITransformingStep(input_stream_, buildOutputHeader(input_stream_.header, keys_, combined_key_), getTraits())
+    , keys(keys_)
+    , combined_key(combined_key_)
+{
+}
+
+DB::Block
+CombineLowCardinalityKeysStep::buildOutputHeader(const DB::Block & input_header, const DB::Names & keys, const String & combined_key)
+{
+    DB::Block header;
+    for (const auto & column : input_header)
+        if (std::find(keys.begin(), keys.end(), column.name) == keys.end())
+            header.insert(column.cloneEmpty());
+    auto combined_type = std::make_shared<DB::DataTypeLowCardinality>(std::make_shared<DB::DataTypeString>());
+    header.insert({combined_type->createColumn(), combined_type, combined_key});
+    return header;
+}
+
+void CombineLowCardinalityKeysStep::transformPipeline(
+    DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & /*settings*/)
+{
+    const auto & output_header = getOutputStream().header;
+    pipeline.addSimpleTransform([&](const DB::Block & header)
+                                { return std::make_shared<CombineLowCardinalityKeysTransform>(header, output_header, keys); });
+}
+
+void CombineLowCardinalityKeysStep::describeActions(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    String prefix(settings.offset, settings.indent_char);
+    for (const auto & key : keys)
+        settings.out << prefix << "Key: " << key << '\n';
+}
+
+void CombineLowCardinalityKeysStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void CombineLowCardinalityKeysStep::updateOutputStream()
+{
+    createOutputStream(
+        input_streams.front(), buildOutputHeader(input_streams.front().header, keys, combined_key), getDataStreamTraits());
+}
+
+CombineLowCardinalityKeysTransform::CombineLowCardinalityKeysTransform(
+    const DB::Block & input_header, const DB::Block & output_header, const DB::Names & keys)
+    : DB::ISimpleTransform(input_header, output_header, false)
+{
+    for (const auto & key : keys)
+    {
+        if (!input_header.getByName(key).type->lowCardinality())
+            throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Key {} to combine isn't LowCardinality", key);
+        key_positions.emplace_back(input_header.getPositionByName(key));
+    }
+    for (size_t i = 0; i < input_header.columns(); ++i)
+        if (std::find(key_positions.begin(), key_positions.end(), i) == key_positions.end())
+            other_positions.emplace_back(i);
+}
+
+void CombineLowCardinalityKeysTransform::transform(DB::Chunk & chunk)
+{
+    size_t rows = chunk.getNumRows();
+    auto columns = chunk.detachColumns();
+    DB::Columns result;
+    for (auto position : other_positions)
+        result.emplace_back(columns[position]);
+    const auto & output_header = getOutputPort().getHeader();
+    const auto & combined_type = output_header.getByPosition(output_header.columns() - 1).type;
+    if (!rows)
+    {
+        result.emplace_back(combined_type->createColumn());
+        chunk.setColumns(std::move(result), 0);
+        return;
+    }
+
+    /// The positions of the keys of a row in their dictionaries, combined into one number below bound.
+    DB::ColumnRawPtrs key_columns;
+    DB::PaddedPODArray<UInt64> combined(rows, 0);
+    DB::PaddedPODArray<UInt32> groups;
+    DB::PaddedPODArray<UInt64> first_rows;
+    UInt64 bound = 1;
+    for (auto position : key_positions)
+    {
+        columns[position] = columns[position]->convertToFullColumnIfConst();
+        const auto & key = assert_cast<const DB::ColumnLowCardinality &>(*columns[position]);
+        key_columns.emplace_back(&key);
+        UInt64 dictionary_size = key.getDictionary().size();
+        /// Numbered again before the combination overflows, there are then no more numbers than rows.
+        if (bound > std::numeric_limits<UInt64>::max() / dictionary_size)
+        {
+            bound = numberGroups(combined, bound, groups, first_rows);
+            std::copy(groups.begin(), groups.end(), combined.begin());
+        }
+        switch (key.getSizeOfIndexType())
+        {
+            case sizeof(UInt8):
+                appendPositions<UInt8>(key.getIndexes(), dictionary_size, combined);
+                break;
+            case sizeof(UInt16):
+                appendPositions<UInt16>(key.getIndexes(), dictionary_size, combined);
+                break;
+            case sizeof(UInt32):
+                appendPositions<UInt32>(key.getIndexes(), dictionary_size, combined);
+                break;
+            case sizeof(UInt64):
+                appendPositions<UInt64>(key.getIndexes(), dictionary_size, combined);
+                break;
+            default:
+                throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Unexpected size of index type {}", key.getSizeOfIndexType());
+        }
+        bound *= dictionary_size;
+    }
+    size_t num_groups = numberGroups(combined, bound, groups, first_rows);
+
+    /// Only the keys of the first row of each group are serialized.
+    DB::Arena arena;
+    auto strings = DB::ColumnString::create();
+    strings->reserve(num_groups);
+    for (size_t group = 0; group < num_groups; ++group)
+    {
+        auto key = DB::serializeKeysToPoolContiguous(first_rows[group], key_columns.size(), key_columns, arena);
+        strings->insertData(key.data, key.size);
+    }
+    auto dictionary = DB::DataTypeLowCardinality::createColumnUnique(*DB::removeLowCardinality(combined_type));
+    auto positions = dictionary->uniqueInsertRangeFrom(*strings, 0, num_groups);
+    auto group_column = DB::ColumnUInt32::create();
+    group_column->getData().swap(groups);
+    auto indexes = DB::IColumn::mutate(positions->index(*group_column, 0));
+    result.emplace_back(DB::ColumnLowCardinality::create(std::move(dictionary), std::move(indexes)));
+    chunk.setColumns(std::move(result), rows);
+}
+
+size_t CombineLowCardinalityKeysTransform::numberGroups(
+    const DB::PaddedPODArray<UInt64> & combined, UInt64 bound, DB::PaddedPODArray<UInt32> & groups, DB::PaddedPODArray<UInt64> & first_rows)
+{
+    static constexpr UInt32 NO_GROUP = std::numeric_limits<UInt32>::max();
+    size_t rows = combined.size();
+    groups.resize(rows);
+    first_rows.clear();
+    if (bound <= MAX_DENSE_COMBINATIONS)
+    {
+        dense_groups.assign(bound, NO_GROUP);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            auto & group = dense_groups[combined[row]];
+            if (group == NO_GROUP)
+            {
+                group = static_cast<UInt32>(first_rows.size());
+                first_rows.push_back(row);
+            }
+            groups[row] = group;
+        }
+    }
+    else
+    {
+        group_map.clear();
+        for (size_t row = 0; row < rows; ++row)
+        {
+            DB::HashMap<UInt64, UInt32>::LookupResult it;
+            bool inserted;
+            group_map.emplace(combined[row], it, inserted);
+            if (inserted)
+            {
+                it->getMapped() = static_cast<UInt32>(first_rows.size());
+                first_rows.push_back(row);
+            }
+            groups[row] = it->getMapped();
+        }
+    }
+    return first_rows.size();
+}
+
+static DB::Block buildSplitOutputHeader(const DB::Block & input_header, const DB::Block & keys_header, const String & combined_key)
+{
+    DB::Block header;
+    for (const auto & column : input_header)
+    {
+        if (column.name != combined_key)
+            header.insert(column.cloneEmpty());
+        else
+            for (const auto & key : keys_header)
+                header.insert(key.cloneEmpty());
+    }
+    return header;
+}
+
+SplitLowCardinalityKeysStep::SplitLowCardinalityKeysStep(
+    const DB::DataStream & input_stream_, const DB::Block & keys_header_, const String & combined_key_)
+    : DB::ITransformingStep(input_stream_, buildSplitOutputHeader(input_stream_.header, keys_header_, combined_key_), getTraits())
+    , keys_header(keys_header_.cloneEmpty())
+    , combined_key(combined_key_)
+{
+}
+
+void SplitLowCardinalityKeysStep::transformPipeline(
+    DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & /*settings*/)
+{
+    const auto & output_header = getOutputStream().header;
+    pipeline.addSimpleTransform(
+        [&](const DB::Block & header)
+        {
+            return std::make_shared<SplitLowCardinalityKeysTransform>(header, output_header, header.getPositionByName(combined_key));
+        });
+}
+
+void SplitLowCardinalityKeysStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void SplitLowCardinalityKeysStep::updateOutputStream()
+{
+    createOutputStream(
+        input_streams.front(), buildSplitOutputHeader(input_streams.front().header, keys_header, combined_key), getDataStreamTraits());
+}
+
+SplitLowCardinalityKeysTransform::SplitLowCardinalityKeysTransform(
+    const DB::Block & input_header, const DB::Block & output_header, size_t combined_position_)
+    : DB::ISimpleTransform(input_header, output_header, false)
+    , combined_position(combined_position_)
+    , num_keys(output_header.columns() + 1 - input_header.columns())
+{
+}
+
+void SplitLowCardinalityKeysTransform::transform(DB::Chunk & chunk)
+{
+    size_t rows = chunk.getNumRows();
+    auto columns = chunk.detachColumns();
+    const auto & output_header = getOutputPort().getHeader();
+    auto combined = columns[combined_position]->convertToFullColumnIfConst();
+    DB::MutableColumns keys;
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+        keys.emplace_back(output_header.getByPosition(combined_position + i).type->createColumn());
+        keys.back()->reserve(rows);
+    }
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const char * pos = combined->getDataAt(row).data;
+        for (auto & key : keys)
+            pos = key->deserializeAndInsertFromArena(pos);
+    }
+
+    DB::Columns result(columns.begin(), columns.begin() + combined_position);
+    for (auto & key : keys)
+        result.emplace_back(std::move(key));
+    result.insert(result.end(), columns.begin() + combined_position + 1, columns.end());
+    chunk.setColumns(std::move(result), rows);
+}
+}
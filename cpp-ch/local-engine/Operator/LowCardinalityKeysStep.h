@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <Processors/ISimpleTransform.h>
+#include <Processors/QueryPlan/ITransformingStep.h>
+#include <Common/HashTable/HashMap.h>
+
+namespace local_engine
+{
+/// Replaces the LowCardinality grouping keys of an aggregation by one LowCardinality key combining them. The rows of a
+/// chunk are grouped by the positions of their keys in the dictionaries, and only the keys of each group are serialized
+/// into the combined key. The aggregation then looks up each group once per chunk in its hash table, instead of
+/// serializing and hashing the keys of every row. SplitLowCardinalityKeysStep restores the keys after the aggregation.
+class CombineLowCardinalityKeysStep : public DB::ITransformingStep
+{
+public:
+    CombineLowCardinalityKeysStep(const DB::DataStream & input_stream_, const DB::Names & keys_, const String & combined_key_);
+    ~CombineLowCardinalityKeysStep() override = default;
+
+    String getName() const override { return "CombineLowCardinalityKeysStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describeActions(DB::IQueryPlanStep::FormatSettings & settings) const override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+
+    /// The input columns other than the keys, followed by the combined key.
+    static DB::Block buildOutputHeader(const DB::Block & input_header, const DB::Names & keys, const String & combined_key);
+
+private:
+    DB::Names keys;
+    String combined_key;
+    void updateOutputStream() override;
+};
+
+class CombineLowCardinalityKeysTransform : public DB::ISimpleTransform
+{
+public:
+    CombineLowCardinalityKeysTransform(const DB::Block & input_header, const DB::Block & output_header, const DB::Names & keys);
+    void transform(DB::Chunk & chunk) override;
+    String getName() const override { return "CombineLowCardinalityKeysTransform"; }
+
+private:
+    std::vector<size_t> key_positions;
+    std::vector<size_t> other_positions;
+    DB::HashMap<UInt64, UInt32> group_map;
+    DB::PaddedPODArray<UInt32> dense_groups;
+
+    /// Numbers the distinct values of combined from 0 in the order they appear, into groups, and returns how many.
+    /// first_rows gets the first row of each.
+    size_t numberGroups(
+        const DB::PaddedPODArray<UInt64> & combined,
+        UInt64 bound,
+        DB::PaddedPODArray<UInt32> & groups,
+        DB::PaddedPODArray<UInt64> & first_rows);
+};
+
+/// Restores the keys combined by CombineLowCardinalityKeysStep, in place of the combined key.
+class SplitLowCardinalityKeysStep : public DB::ITransformingStep
+{
+public:
+    SplitLowCardinalityKeysStep(const DB::DataStream & input_stream_, const DB::Block & keys_header_, const String & combined_key_);
+    ~SplitLowCardinalityKeysStep() override = default;
+
+    String getName() const override { return "SplitLowCardinalityKeysStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+
+private:
+    DB::Block keys_header;
+    String combined_key;
+    void updateOutputStream() override;
+};
+
+class SplitLowCardinalityKeysTransform : public DB::ISimpleTransform
+{
+public:
+    SplitLowCardinalityKeysTransform(const DB::Block & input_header, const DB::Block & output_header, size_t combined_position_);
+    void transform(DB::Chunk & chunk) override;
+    String getName() const override { return "SplitLowCardinalityKeysTransform"; }
+
+private:
+    size_t combined_position;
+    size_t num_keys;
+};
+}
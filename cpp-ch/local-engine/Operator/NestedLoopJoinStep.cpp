@@ -0,0 +1,373 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NestedLoopJoinStep.h"
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsCommon.h>
+#include <Columns/ColumnsNumber.h>
+#include <Columns/FilterDescription.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Functions/IFunction.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+
+namespace local_engine
+{
+namespace
+{
+const DB::ActionsDAG::Node * skipAliases(const DB::ActionsDAG::Node * node)
+{
+    while (node->type == DB::ActionsDAG::ActionType::ALIAS)
+        node = node->children[0];
+    return node;
+}
+
+/// The first conjunct bounding a build column by a probe column of the same type, whose values compare.
+std::optional<NestedLoopJoinBuild::Range>
+findRange(const DB::ActionsDAG::Node * node, const DB::Block & probe_header, const DB::Block & build_header)
+{
+    node = skipAliases(node);
+    if (node->type != DB::ActionsDAG::ActionType::FUNCTION)
+        return std::nullopt;
+    const auto & function_name = node->function_base->getName();
+    if (function_name == "and")
+    {
+        for (const auto * child : node->children)
+            if (auto range = findRange(child, probe_header, build_header))
+                return range;
+        return std::nullopt;
+    }
+    bool less = function_name == "less" || function_name == "lessOrEquals";
+    bool greater = function_name == "greater" || function_name == "greaterOrEquals";
+    if ((!less && !greater) || node->children.size() != 2)
+        return std::nullopt;
+    const auto * left = skipAliases(node->children[0]);
+    const auto * right = skipAliases(node->children[1]);
+    if (left->type != DB::ActionsDAG::ActionType::INPUT || right->type != DB::ActionsDAG::ActionType::INPUT)
+        return std::nullopt;
+
+    /// build < probe bounds the build column from above, like probe > build.
+    bool upper_bound = less;
+    if (!build_header.has(left->result_name))
+    {
+        std::swap(left, right);
+        upper_bound = !upper_bound;
+    }
+    if (!build_header.has(left->result_name) || !probe_header.has(right->result_name))
+        return std::nullopt;
+    auto build_type = DB::removeNullable(build_header.getByName(left->result_name).type);
+    auto probe_type = DB::removeNullable(probe_header.getByName(right->result_name).type);
+    if (!build_type->equals(*probe_type) || !build_type->isComparable() || build_type->lowCardinality())
+        return std::nullopt;
+    return NestedLoopJoinBuild::Range{right->result_name, build_header.getPositionByName(left->result_name), upper_bound, 0};
+}
+
+const DB::IColumn & nestedColumn(const DB::IColumn & column)
+{
+    if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(&column))
+        return nullable->getNestedColumn();
+    return column;
+}
+}
+
+std::shared_ptr<const NestedLoopJoinBuild> NestedLoopJoinBuild::create(
+    DB::Block block_, const DB::Block & probe_header, const DB::ActionsDAGPtr & condition, const String & condition_name)
+{
+    auto build = std::make_shared<NestedLoopJoinBuild>();
+    build->block = std::move(block_);
+    if (condition)
+        build->range = findRange(&condition->findInOutputs(condition_name), probe_header, build->block);
+    if (!build->range)
+        return build;
+
+    /// Nulls last.
+    const auto & key = build->block.getByPosition(build->range->build_position).column;
+    DB::IColumn::Permutation permutation;
+    key->getPermutation(
+        DB::IColumn::PermutationSortDirection::Ascending, DB::IColumn::PermutationSortStability::Unstable, 0, 1, permutation);
+    for (auto & column : build->block)
+        column.column = column.column->permute(permutation, 0);
+    const auto & sorted_key = *build->block.getByPosition(build->range->build_position).column;
+    build->range->non_null_rows = sorted_key.size();
+    if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(&sorted_key))
+    {
+        const auto & null_map = nullable->getNullMapData();
+        build->range->non_null_rows = std::find(null_map.begin(), null_map.end(), 1) - null_map.begin();
+    }
+    return build;
+}
+
+static DB::ITransformingStep::Traits getTraits()
+{
+    return DB::ITransformingStep::Traits{
+        {
+            .returns_single_stream = false,
+            .preserves_number_of_streams = true,
+            .preserves_sorting = false,
+        },
+        {
+            .preserves_number_of_rows = false,
+        }};
+}
+
+static DB::Block buildOutputHeader(const DB::Block & probe_header, const DB::Block & build_block)
+{
+    auto header = probe_header.cloneEmpty();
+    for (const auto & column : build_block)
+        header.insert(column.cloneEmpty());
+    return header;
+}
+
+NestedLoopJoinStep::NestedLoopJoinStep(
+    const DB::DataStream & input_stream_,
+    NestedLoopJoinBuildPtr build_,
+    DB::ActionsDAGPtr condition_,
+    const String & condition_name_,
+    DB::JoinKind kind_,
+    DB::JoinStrictness strictness_,
+    size_t max_block_size_)
+    : DB::ITransformingStep(input_stream_, buildOutputHeader(input_stream_.header, build_->block), getTraits())
+    , build(std::move(build_))
+    , condition(std::move(condition_))
+    , condition_name(condition_name_)
+    , kind(kind_)
+    , strictness(strictness_)
+    , max_block_size(max_block_size_)
+{
+}
+
+void NestedLoopJoinStep::transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings)
+{
+    DB::ExpressionActionsPtr actions;
+    if (condition)
+        actions = std::make_shared<DB::ExpressionActions>(condition, settings.getActionsSettings());
+    const auto & output_header = getOutputStream().header;
+    pipeline.addSimpleTransform(
+        [&](const DB::Block & header)
+        {
+            return std::make_shared<NestedLoopJoinTransform>(
+                header, output_header, build, actions, condition_name, kind, strictness, max_block_size);
+        });
+}
+
+void NestedLoopJoinStep::describeActions(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    String prefix(settings.offset, settings.indent_char);
+    settings.out << prefix << "Kind: " << toString(kind) << ' ' << toString(strictness) << '\n';
+    settings.out << prefix << "Build rows: " << build->block.rows() << '\n';
+    if (condition)
+        settings.out << prefix << "Condition: " << condition_name << '\n';
+    if (build->range)
+        settings.out << prefix << "Range of build column: " << build->block.getByPosition(build->range->build_position).name << '\n';
+}
+
+void NestedLoopJoinStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void NestedLoopJoinStep::updateOutputStream()
+{
+    createOutputStream(input_streams.front(), buildOutputHeader(input_streams.front().header, build->block), getDataStreamTraits());
+}
+
+NestedLoopJoinTransform::NestedLoopJoinTransform(
+    const DB::Block & input_header,
+    const DB::Block & output_header,
+    NestedLoopJoinBuildPtr build_,
+    DB::ExpressionActionsPtr condition_,
+    const String & condition_name_,
+    DB::JoinKind kind_,
+    DB::JoinStrictness strictness_,
+    size_t max_block_size_)
+    : DB::IInflatingTransform(input_header, output_header)
+    , build(std::move(build_))
+    , condition(std::move(condition_))
+    , condition_name(condition_name_)
+    , kind(kind_)
+    , strictness(strictness_)
+    , max_block_size(max_block_size_)
+{
+}
+
+void NestedLoopJoinTransform::consume(DB::Chunk chunk)
+{
+    probe_rows = chunk.getNumRows();
+    probe_columns = chunk.detachColumns();
+    for (auto & column : probe_columns)
+        column = column->convertToFullColumnIfConst();
+    matched.assign(probe_rows, static_cast<UInt8>(0));
+    probe_row = 0;
+    row_started = false;
+    chunk_done = false;
+}
+
+bool NestedLoopJoinTransform::canGenerate()
+{
+    return !chunk_done;
+}
+
+std::pair<size_t, size_t> NestedLoopJoinTransform::candidates(size_t row)
+{
+    size_t build_rows = build->block.rows();
+    if (!build->range)
+        return {0, build_rows};
+
+    const auto & range = *build->range;
+    const auto & probe_column = *probe_columns[getInputPort().getHeader().getPositionByName(range.probe_column)];
+    /// Nothing compares with null.
+    if (probe_column.isNullAt(row))
+        return {0, 0};
+    const auto & probe_key = nestedColumn(probe_column);
+    const auto & build_key = nestedColumn(*build->block.getByPosition(range.build_position).column);
+    /// The first build row past the probe value when bounded from above, else the first at least it.
+    auto first_past = [&](bool inclusive)
+    {
+        size_t low = 0;
+        size_t high = range.non_null_rows;
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            int order = build_key.compareAt(mid, row, probe_key, 1);
+            if (order < 0 || (inclusive && order == 0))
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low;
+    };
+    if (range.upper_bound)
+        return {0, first_past(true)};
+    return {first_past(false), range.non_null_rows};
+}
+
+DB::Chunk NestedLoopJoinTransform::generate()
+{
+    auto result = getOutputPort().getHeader().cloneEmptyColumns();
+    bool semi_or_anti = strictness == DB::JoinStrictness::Semi || strictness == DB::JoinStrictness::Anti;
+    while (!chunk_done && result.front()->size() < max_block_size)
+    {
+        probe_indices.clear();
+        build_indices.clear();
+        while (probe_indices.size() < max_block_size && probe_row < probe_rows)
+        {
+            if (!row_started)
+            {
+                std::tie(build_pos, build_end) = candidates(probe_row);
+                row_started = true;
+            }
+            /// A semi or anti join only needs one match of a row.
+            if (semi_or_anti && matched[probe_row])
+                build_pos = build_end;
+            size_t take = std::min(build_end - build_pos, max_block_size - probe_indices.size());
+            for (size_t i = 0; i < take; ++i)
+            {
+                probe_indices.push_back(probe_row);
+                build_indices.push_back(build_pos + i);
+            }
+            build_pos += take;
+            if (build_pos == build_end)
+            {
+                ++probe_row;
+                row_started = false;
+            }
+        }
+        if (!probe_indices.empty())
+            joinPairs(result);
+        if (probe_row == probe_rows)
+        {
+            finishChunk(result);
+            chunk_done = true;
+        }
+    }
+    size_t rows = result.front()->size();
+    return DB::Chunk(std::move(result), rows);
+}
+
+void NestedLoopJoinTransform::joinPairs(DB::MutableColumns & result)
+{
+    size_t num_pairs = probe_indices.size();
+    auto probe_index = DB::ColumnUInt64::create();
+    probe_index->getData().swap(probe_indices);
+    auto build_index = DB::ColumnUInt64::create();
+    build_index->getData().swap(build_indices);
+
+    const auto & probe_header = getInputPort().getHeader();
+    DB::ColumnsWithTypeAndName pairs;
+    for (size_t i = 0; i < probe_columns.size(); ++i)
+    {
+        const auto & column = probe_header.getByPosition(i);
+        pairs.emplace_back(probe_columns[i]->index(*probe_index, 0), column.type, column.name);
+    }
+    for (const auto & column : build->block)
+        pairs.emplace_back(column.column->index(*build_index, 0), column.type, column.name);
+
+    DB::ColumnPtr filter_column;
+    if (condition)
+    {
+        DB::Block block(pairs);
+        condition->execute(block, num_pairs);
+        filter_column = block.getByName(condition_name).column->convertToFullColumnIfConst()->convertToFullColumnIfLowCardinality();
+    }
+    else
+        filter_column = DB::ColumnUInt8::create(num_pairs, 1);
+    DB::FilterDescription filter(*filter_column);
+    const auto & passed = *filter.data;
+
+    const auto & probe_index_data = probe_index->getData();
+    for (size_t i = 0; i < num_pairs; ++i)
+        if (passed[i])
+            matched[probe_index_data[i]] = 1;
+    if (strictness == DB::JoinStrictness::All)
+    {
+        size_t passed_count = DB::countBytesInFilter(passed);
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            auto column = passed_count == num_pairs ? pairs[i].column : pairs[i].column->filter(passed, passed_count);
+            result[i]->insertRangeFrom(*column, 0, passed_count);
+        }
+    }
+
+    /// Handed back for the next pairs, keeping the memory.
+    probe_indices.swap(probe_index->getData());
+    build_indices.swap(build_index->getData());
+    probe_indices.clear();
+    build_indices.clear();
+}
+
+void NestedLoopJoinTransform::finishChunk(DB::MutableColumns & result)
+{
+    /// Left joins output the probe rows without a match, semi joins those with one, anti joins those without.
+    bool keep_matched;
+    if (strictness == DB::JoinStrictness::Semi)
+        keep_matched = true;
+    else if (strictness == DB::JoinStrictness::Anti || kind == DB::JoinKind::Left)
+        keep_matched = false;
+    else
+        return;
+
+    DB::IColumn::Filter filter(probe_rows);
+    for (size_t i = 0; i < probe_rows; ++i)
+        filter[i] = matched[i] == keep_matched;
+    size_t rows = DB::countBytesInFilter(filter);
+    if (!rows)
+        return;
+    for (size_t i = 0; i < probe_columns.size(); ++i)
+        result[i]->insertRangeFrom(*probe_columns[i]->filter(filter, rows), 0, rows);
+    for (size_t i = probe_columns.size(); i < result.size(); ++i)
+        result[i]->insertManyDefaults(rows);
+}
+}
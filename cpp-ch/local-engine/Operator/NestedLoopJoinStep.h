@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+#include <Core/Joins.h>
+#include <Interpreters/ActionsDAG.h>
+#include <Interpreters/ExpressionActions.h>
+#include <Processors/IInflatingTransform.h>
+#include <Processors/QueryPlan/ITransformingStep.h>
+
+namespace local_engine
+{
+/// The build side of a nested loop join. When a conjunct of the condition bounds a build column by a probe column of
+/// the same type, like b.start <= a.ts, the build rows are sorted by that column, and a probe row only pairs with the
+/// build rows within its bound, found by binary search.
+struct NestedLoopJoinBuild
+{
+    /// Sorted by the bounded column if any, its nulls last.
+    DB::Block block;
+
+    struct Range
+    {
+        String probe_column;
+        size_t build_position;
+        /// Whether the build column is at most the probe column, else at least.
+        bool upper_bound;
+        /// The build rows with a non-null bounded column, the first ones.
+        size_t non_null_rows;
+    };
+    std::optional<Range> range;
+
+    /// The condition is over the probe columns followed by the build columns, its output condition_name.
+    static std::shared_ptr<const NestedLoopJoinBuild> create(
+        DB::Block block_, const DB::Block & probe_header, const DB::ActionsDAGPtr & condition, const String & condition_name);
+};
+using NestedLoopJoinBuildPtr = std::shared_ptr<const NestedLoopJoinBuild>;
+
+/// Joins the probe stream with every row of a broadcast build side passing the condition, which is evaluated over
+/// batches of row pairs at once instead of pair by pair. Inner, left, left semi and left anti joins are supported, the
+/// output has the probe columns followed by the build columns, of default values where no build row is joined.
+class NestedLoopJoinStep : public DB::ITransformingStep
+{
+public:
+    /// Without condition, every pair passes.
+    NestedLoopJoinStep(
+        const DB::DataStream & input_stream_,
+        NestedLoopJoinBuildPtr build_,
+        DB::ActionsDAGPtr condition_,
+        const String & condition_name_,
+        DB::JoinKind kind_,
+        DB::JoinStrictness strictness_,
+        size_t max_block_size_);
+    ~NestedLoopJoinStep() override = default;
+
+    String getName() const override { return "NestedLoopJoinStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describeActions(DB::IQueryPlanStep::FormatSettings & settings) const override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+
+private:
+    NestedLoopJoinBuildPtr build;
+    DB::ActionsDAGPtr condition;
+    String condition_name;
+    DB::JoinKind kind;
+    DB::JoinStrictness strictness;
+    size_t max_block_size;
+
+    void updateOutputStream() override;
+};
+
+class NestedLoopJoinTransform : public DB::IInflatingTransform
+{
+public:
+    NestedLoopJoinTransform(
+        const DB::Block & input_header,
+        const DB::Block & output_header,
+        NestedLoopJoinBuildPtr build_,
+        DB::ExpressionActionsPtr condition_,
+        const String & condition_name_,
+        DB::JoinKind kind_,
+        DB::JoinStrictness strictness_,
+        size_t max_block_size_);
+
+    String getName() const override { return "NestedLoopJoinTransform"; }
+
+protected:
+    void consume(DB::Chunk chunk) override;
+    bool canGenerate() override;
+    DB::Chunk generate() override;
+
+private:
+    NestedLoopJoinBuildPtr build;
+    DB::ExpressionActionsPtr condition;
+    String condition_name;
+    DB::JoinKind kind;
+    DB::JoinStrictness strictness;
+    size_t max_block_size;
+
+    /// Of the probe chunk being joined.
+    DB::Columns probe_columns;
+    size_t probe_rows = 0;
+    DB::PaddedPODArray<UInt8> matched;
+    /// The next pair, of the probe row and the build rows [build_pos, build_end) left for it.
+    size_t probe_row = 0;
+    size_t build_pos = 0;
+    size_t build_end = 0;
+    bool row_started = false;
+    bool chunk_done = true;
+
+    DB::PaddedPODArray<UInt64> probe_indices;
+    DB::PaddedPODArray<UInt64> build_indices;
+
+    /// The build rows [begin, end) the probe row may pair with.
+    std::pair<size_t, size_t> candidates(size_t row);
+    /// Evaluates the condition over the pairs collected, appending the passing ones to the result.
+    void joinPairs(DB::MutableColumns & result);
+    /// Appends the probe rows of the chunk not paired with build rows, for the kinds that output them.
+    void finishChunk(DB::MutableColumns & result);
+};
+}
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StatisticsAggregateStep.h"
+#include <QueryPipeline/QueryPipelineBuilder.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int LOGICAL_ERROR;
+}
+}
+
+namespace local_engine
+{
+static DB::ITransformingStep::Traits getTraits()
+{
+    return DB::ITransformingStep::Traits{
+        {
+            .returns_single_stream = false,
+            .preserves_number_of_streams = true,
+            .preserves_sorting = false,
+        },
+        {
+            .preserves_number_of_rows = false,
+        }};
+}
+
+StatisticsAggregateStep::StatisticsAggregateStep(const DB::DataStream & input_stream_, StatisticsAggregationPtr aggregation_)
+    : DB::ITransformingStep(input_stream_, input_stream_.header, getTraits()), aggregation(std::move(aggregation_))
+{
+}
+
+void StatisticsAggregateStep::transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & /*settings*/)
+{
+    pipeline.addSimpleTransform([&](const DB::Block & header)
+                                { return std::make_shared<StatisticsAggregateTransform>(header, aggregation); });
+}
+
+void StatisticsAggregateStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void StatisticsAggregateStep::updateOutputStream()
+{
+    createOutputStream(input_streams.front(), input_streams.front().header, getDataStreamTraits());
+}
+
+StatisticsAggregateTransform::StatisticsAggregateTransform(const DB::Block & header_, StatisticsAggregationPtr aggregation_)
+    : DB::ISimpleTransform(header_, header_, false), aggregation(std::move(aggregation_))
+{
+    /// Every column gets the row, so that there are only the states of the aggregates.
+    if (header_.columns() != aggregation->getAggregates().size())
+        throw DB::Exception(
+            DB::ErrorCodes::LOGICAL_ERROR, "Aggregates answered from statistics don't match the aggregated result {}", header_.dumpStructure());
+    for (const auto & aggregate : aggregation->getAggregates())
+        positions.emplace_back(header_.getPositionByName(aggregate.result_name));
+}
+
+void StatisticsAggregateTransform::transform(DB::Chunk & chunk)
+{
+    /// Only the first chunk of one of the streams gets the row.
+    if (positions.empty())
+        return;
+    auto rows = chunk.getNumRows();
+    auto columns = chunk.detachColumns();
+    DB::MutableColumns state_columns;
+    for (auto position : positions)
+        state_columns.emplace_back(DB::IColumn::mutate(std::move(columns[position])));
+    if (aggregation->appendTo(state_columns))
+        rows += 1;
+    for (size_t i = 0; i < positions.size(); ++i)
+        columns[positions[i]] = std::move(state_columns[i]);
+    chunk.setColumns(std::move(columns), rows);
+    positions.clear();
+}
+}
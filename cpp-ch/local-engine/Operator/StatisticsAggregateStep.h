@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <Processors/ISimpleTransform.h>
+#include <Processors/QueryPlan/ITransformingStep.h>
+#include <Storages/SubstraitSource/StatisticsAggregation.h>
+
+namespace local_engine
+{
+/// Follows the partial aggregation without grouping keys over a scan answering it from statistics, and appends the
+/// states of the row groups answered to the aggregated result as one more row. The aggregation outputs once its input is
+/// done, after the scan added all of them.
+class StatisticsAggregateStep : public DB::ITransformingStep
+{
+public:
+    StatisticsAggregateStep(const DB::DataStream & input_stream_, StatisticsAggregationPtr aggregation_);
+    ~StatisticsAggregateStep() override = default;
+
+    String getName() const override { return "StatisticsAggregateStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+
+private:
+    StatisticsAggregationPtr aggregation;
+    void updateOutputStream() override;
+};
+
+class StatisticsAggregateTransform : public DB::ISimpleTransform
+{
+public:
+    StatisticsAggregateTransform(const DB::Block & header_, StatisticsAggregationPtr aggregation_);
+    void transform(DB::Chunk & chunk) override;
+    String getName() const override { return "StatisticsAggregateTransform"; }
+
+private:
+    StatisticsAggregationPtr aggregation;
+    /// Of the state column of each aggregate in the header.
+    std::vector<size_t> positions;
+};
+}
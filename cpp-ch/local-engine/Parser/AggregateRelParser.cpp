@@ -22,13 +22,20 @@
 #include <DataTypes/DataTypeTuple.h>
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionHelpers.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/ReadHelpers.h>
 #include <Parser/AggregateFunctionParser.h>
 #include <Processors/QueryPlan/AggregatingStep.h>
 #include <Processors/QueryPlan/ExpressionStep.h>
 #include <Processors/QueryPlan/MergingAggregatedStep.h>
 #include <Common/StringUtils/StringUtils.h>
+#include <google/protobuf/wrappers.pb.h>
 
+#include <Operator/BlocksBufferPoolTransform.h>
 #include <Operator/EmptyHashAggregate.h>
+#include <Operator/LowCardinalityKeysStep.h>
+#include <Operator/StatisticsAggregateStep.h>
+#include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 
 namespace DB
 {
@@ -59,6 +66,7 @@ DB::QueryPlanPtr AggregateRelParser::parse(DB::QueryPlanPtr query_plan, const su
         plan->addStep(std::move(empty_agg));
         return std::move(plan);
     }
+    statistics_source = findStatisticsSource();
     addPreProjection();
     LOG_TRACE(logger, "header after pre-projection is: {}", plan->getCurrentDataStream().header.dumpStructure());
     if (has_final_stage)
@@ -115,6 +123,26 @@ void AggregateRelParser::setup(DB::QueryPlanPtr query_plan, const substrait::Rel
         aggregates.push_back(agg_info);
     }
 
+    /// The hints of the aggregation, one key=value per line after "AggregateParameters:".
+    if (aggregate_rel->has_advanced_extension() && aggregate_rel->advanced_extension().has_optimization())
+    {
+        google::protobuf::StringValue optimization;
+        optimization.ParseFromString(aggregate_rel->advanced_extension().optimization().value());
+        ReadBufferFromString in(optimization.value());
+        if (checkString("AggregateParameters:", in))
+        {
+            while (!in.eof())
+            {
+                String line;
+                readString(line, in);
+                assertChar('\n', in);
+                auto pos = line.find('=');
+                if (pos != String::npos && line.substr(0, pos) == "estimatedGroups")
+                    estimated_groups = std::max<Int64>(0, std::stoll(line.substr(pos + 1)));
+            }
+        }
+    }
+
     if (aggregate_rel->groupings_size() == 1)
     {
         for (const auto & expr : aggregate_rel->groupings(0).grouping_expressions())
@@ -216,23 +244,54 @@ void AggregateRelParser::addAggregatingStep()
     AggregateDescriptions aggregate_descriptions;
     buildAggregateDescriptions(aggregate_descriptions);
     auto settings = getContext()->getSettingsRef();
+    /// The hash table of many groups estimated is two level from the first block, instead of converted once it grows past
+    /// the threshold, and the keys are prefetched while it is larger than the cache.
+    size_t two_level_threshold = settings.group_by_two_level_threshold;
+    bool enable_prefetch = false;
+    if (!grouping_keys.empty() && two_level_threshold && estimated_groups >= two_level_threshold)
+    {
+        LOG_DEBUG(logger, "Aggregating {} estimated groups in a two level hash table", estimated_groups);
+        two_level_threshold = 1;
+        enable_prefetch = settings.enable_software_prefetch_in_aggregation;
+    }
+
+    /// Two or more LowCardinality keys, as read from Parquet dictionaries, are grouped by as one combining them. The
+    /// aggregation then looks up the distinct combinations of the dictionary positions once per block.
+    Names keys = grouping_keys;
+    Block keys_header;
+    String combined_key;
+    auto input_header = plan->getCurrentDataStream().header;
+    auto is_low_cardinality = [&](const String & key) { return input_header.getByName(key).type->lowCardinality(); };
+    if (grouping_keys.size() > 1 && getContext()->getConfigRef().getBool("low_cardinality_aggregation.enabled", true)
+        && std::all_of(grouping_keys.begin(), grouping_keys.end(), is_low_cardinality))
+    {
+        for (const auto & key : grouping_keys)
+            keys_header.insert(input_header.getByName(key).cloneEmpty());
+        combined_key = getUniqueName("low_cardinality_keys");
+        auto combine_step = std::make_unique<CombineLowCardinalityKeysStep>(plan->getCurrentDataStream(), grouping_keys, combined_key);
+        combine_step->setStepDescription("Combine LowCardinality keys");
+        steps.emplace_back(combine_step.get());
+        plan->addStep(std::move(combine_step));
+        keys = {combined_key};
+    }
+
     Aggregator::Params params(
-        grouping_keys,
+        keys,
         aggregate_descriptions,
         false,
         settings.max_rows_to_group_by,
         settings.group_by_overflow_mode,
-        settings.group_by_two_level_threshold,
+        two_level_threshold,
         settings.group_by_two_level_threshold_bytes,
         settings.max_bytes_before_external_group_by,
         settings.empty_result_for_aggregation_by_empty_set,
-        getContext()->getTempDataOnDisk(),
+        createSpillScope(),
         settings.max_threads,
         settings.min_free_disk_space_for_temporary_data,
         true,
         3,
         settings.max_block_size,
-        false,
+        enable_prefetch,
         false);
 
     auto aggregating_step = std::make_unique<AggregatingStep>(
@@ -253,6 +312,78 @@ void AggregateRelParser::addAggregatingStep()
         false);
     steps.emplace_back(aggregating_step.get());
     plan->addStep(std::move(aggregating_step));
+
+    if (!combined_key.empty())
+    {
+        auto split_step = std::make_unique<SplitLowCardinalityKeysStep>(plan->getCurrentDataStream(), keys_header, combined_key);
+        split_step->setStepDescription("Split LowCardinality keys");
+        steps.emplace_back(split_step.get());
+        plan->addStep(std::move(split_step));
+    }
+
+    if (auto statistics_aggregation = buildStatisticsAggregation(aggregate_descriptions))
+    {
+        statistics_source->setStatisticsAggregation(statistics_aggregation);
+        auto statistics_step = std::make_unique<StatisticsAggregateStep>(plan->getCurrentDataStream(), statistics_aggregation);
+        statistics_step->setStepDescription("Aggregates answered from statistics");
+        steps.emplace_back(statistics_step.get());
+        plan->addStep(std::move(statistics_step));
+    }
+}
+
+/// The partial count, min and max without grouping keys over a scan without filters, through the buffer after it.
+SubstraitFileSourceStep * AggregateRelParser::findStatisticsSource() const
+{
+    if (!has_first_stage || has_inter_stage || !grouping_keys.empty()
+        || !getContext()->getConfigRef().getBool("statistics_aggregation.enabled", true))
+        return nullptr;
+    auto * node = plan->getRootNode();
+    while (node && node->children.size() == 1 && typeid_cast<BlocksBufferPoolStep *>(node->step.get()))
+        node = node->children.front();
+    auto * source = node ? typeid_cast<SubstraitFileSourceStep *>(node->step.get()) : nullptr;
+    if (!source || source->hasFilters())
+        return nullptr;
+    return source;
+}
+
+StatisticsAggregationPtr AggregateRelParser::buildStatisticsAggregation(const AggregateDescriptions & descriptions) const
+{
+    if (!statistics_source)
+        return nullptr;
+    const auto & source_header = statistics_source->getOutputStream().header;
+    std::vector<StatisticsAggregation::Aggregate> statistics_aggregates;
+    for (size_t i = 0; i < aggregates.size(); ++i)
+    {
+        const auto & agg_info = aggregates[i];
+        const auto & measure = agg_info.measure->measure();
+        if (agg_info.parser_func_info.has_filter || measure.arguments_size() != 1 || agg_info.arg_column_types.size() != 1)
+            return nullptr;
+
+        StatisticsAggregation::Aggregate aggregate;
+        if (agg_info.signature_function_name == "count")
+            aggregate.kind = StatisticsAggregation::Kind::Count;
+        else if (agg_info.signature_function_name == "min")
+            aggregate.kind = StatisticsAggregation::Kind::Min;
+        else if (agg_info.signature_function_name == "max")
+            aggregate.kind = StatisticsAggregation::Kind::Max;
+        else
+            return nullptr;
+
+        /// Over a column of the scan, or count(*) over a not null literal.
+        const auto & arg = measure.arguments(0).value();
+        if (arg.has_selection() && arg.selection().has_direct_reference())
+            aggregate.column = source_header.getByPosition(arg.selection().direct_reference().struct_field().field()).name;
+        else if (aggregate.kind != StatisticsAggregation::Kind::Count || !arg.has_literal() || arg.literal().has_null())
+            return nullptr;
+
+        aggregate.type = agg_info.arg_column_types[0];
+        aggregate.function = descriptions[i].function;
+        aggregate.result_name = descriptions[i].column_name;
+        if (aggregate.kind == StatisticsAggregation::Kind::Count && aggregate.function->getName() != "count")
+            return nullptr;
+        statistics_aggregates.emplace_back(std::move(aggregate));
+    }
+    return std::make_shared<StatisticsAggregation>(std::move(statistics_aggregates));
 }
 
 // Only be called in final stage.
@@ -17,12 +17,15 @@
 #pragma once
 #include <Parser/AggregateFunctionParser.h>
 #include <Parser/RelParser.h>
+#include <Storages/SubstraitSource/StatisticsAggregation.h>
 #include <Poco/Logger.h>
 #include <Common/logger_useful.h>
 
 
 namespace local_engine
 {
+class SubstraitFileSourceStep;
+
 class AggregateRelParser : public RelParser
 {
 public:
@@ -55,6 +58,10 @@ private:
     const substrait::AggregateRel * aggregate_rel = nullptr;
     std::vector<AggregateInfo> aggregates;
     Names grouping_keys;
+    /// Groups a task aggregates as estimated by Spark, 0 if unknown.
+    size_t estimated_groups = 0;
+    /// The scan the aggregation is over, if the files of it may answer the aggregation from their statistics.
+    SubstraitFileSourceStep * statistics_source = nullptr;
 
     void setup(DB::QueryPlanPtr query_plan, const substrait::Rel & rel);
     void addPreProjection();
@@ -63,5 +70,7 @@ private:
     void addPostProjection();
 
     void buildAggregateDescriptions(AggregateDescriptions & descriptions);
+    SubstraitFileSourceStep * findStatisticsSource() const;
+    StatisticsAggregationPtr buildStatisticsAggregation(const AggregateDescriptions & descriptions) const;
 };
 }
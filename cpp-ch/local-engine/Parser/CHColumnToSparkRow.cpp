@@ -21,6 +21,7 @@
 #include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnString.h>
+#include <Columns/ColumnTuple.h>
 #include <Columns/IColumn.h>
 #include <Core/Types.h>
 #include <DataTypes/DataTypeArray.h>
@@ -31,7 +32,11 @@
 #include <DataTypes/DataTypeTuple.h>
 #include <DataTypes/DataTypesDecimal.h>
 #include <DataTypes/ObjectUtils.h>
+#include <Common/CurrentThread.h>
 #include <Common/Exception.h>
+#include <Common/ThreadPool.h>
+#include <Common/assert_cast.h>
+#include <Common/scope_guard_safe.h>
 
 namespace DB
 {
@@ -83,16 +88,76 @@ ALWAYS_INLINE bool isBitSet(const char * bitmap, size_t index)
     return word & mask;
 }
 
+/// Copies the values of size N of a contiguous column into the field of the rows, skipping the null ones if null_map.
+template <size_t N>
+static void copyFixedLengthValues(
+    const char * __restrict data,
+    const NullMap * null_map,
+    char * buffer_address,
+    int64_t field_offset,
+    int32_t col_index,
+    size_t row_begin,
+    size_t row_end,
+    const std::vector<int64_t> & offsets,
+    const MaskVector & masks)
+{
+    for (size_t i = row_begin; i < row_end; i++)
+    {
+        size_t row_idx = masks == nullptr ? i : masks->at(i);
+        if (null_map && (*null_map)[row_idx])
+            bitSet(buffer_address + offsets[i], col_index);
+        else
+            memcpy(buffer_address + offsets[i] + field_offset, data + row_idx * N, N);
+    }
+}
+
+/// Whether the values of column, e.g. dates, timestamps or short decimals, were copied by copyFixedLengthValues.
+static bool tryCopyFixedLengthValues(
+    const IColumn & column,
+    const NullMap * null_map,
+    char * buffer_address,
+    int64_t field_offset,
+    int32_t col_index,
+    size_t row_begin,
+    size_t row_end,
+    const std::vector<int64_t> & offsets,
+    const MaskVector & masks)
+{
+    if (!column.isFixedAndContiguous())
+        return false;
+    const char * data = column.getRawData().data();
+    switch (column.sizeOfValueIfFixed())
+    {
+        case 1:
+            copyFixedLengthValues<1>(data, null_map, buffer_address, field_offset, col_index, row_begin, row_end, offsets, masks);
+            return true;
+        case 2:
+            copyFixedLengthValues<2>(data, null_map, buffer_address, field_offset, col_index, row_begin, row_end, offsets, masks);
+            return true;
+        case 4:
+            copyFixedLengthValues<4>(data, null_map, buffer_address, field_offset, col_index, row_begin, row_end, offsets, masks);
+            return true;
+        case 8:
+            copyFixedLengthValues<8>(data, null_map, buffer_address, field_offset, col_index, row_begin, row_end, offsets, masks);
+            return true;
+        default:
+            return false;
+    }
+}
+
 static void writeFixedLengthNonNullableValue(
     char * buffer_address,
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
-    size_t num_rows,
+    size_t row_begin,
+    size_t row_end,
     const std::vector<int64_t> & offsets,
     const MaskVector & masks = nullptr)
 {
+    if (tryCopyFixedLengthValues(*col.column, nullptr, buffer_address, field_offset, 0, row_begin, row_end, offsets, masks))
+        return;
     FixedLengthDataWriter writer(col.type);
-    for (size_t i = 0; i < num_rows; i++)
+    for (size_t i = row_begin; i < row_end; i++)
     {
         size_t row_idx = masks == nullptr ? i : masks->at(i);
         writer.unsafeWrite(col.column->getDataAt(row_idx), buffer_address + offsets[i] + field_offset);
@@ -104,15 +169,18 @@ static void writeFixedLengthNullableValue(
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
     int32_t col_index,
-    size_t num_rows,
+    size_t row_begin,
+    size_t row_end,
     const std::vector<int64_t> & offsets,
     const MaskVector & masks = nullptr)
 {
     const auto * nullable_column = checkAndGetColumn<ColumnNullable>(*col.column);
     const auto & null_map = nullable_column->getNullMapData();
     const auto & nested_column = nullable_column->getNestedColumn();
+    if (tryCopyFixedLengthValues(nested_column, &null_map, buffer_address, field_offset, col_index, row_begin, row_end, offsets, masks))
+        return;
     FixedLengthDataWriter writer(col.type);
-    for (size_t i = 0; i < num_rows; i++)
+    for (size_t i = row_begin; i < row_end; i++)
     {
         size_t row_idx = masks == nullptr ? i : masks->at(i);
         if (null_map[row_idx])
@@ -126,7 +194,8 @@ static void writeVariableLengthNonNullableValue(
     char * buffer_address,
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
-    size_t num_rows,
+    size_t row_begin,
+    size_t row_end,
     const std::vector<int64_t> & offsets,
     std::vector<int64_t> & buffer_cursor,
     const MaskVector & masks = nullptr)
@@ -139,7 +208,7 @@ static void writeVariableLengthNonNullableValue(
     {
         if (!big_endian)
         {
-            for (size_t i = 0; i < num_rows; i++)
+            for (size_t i = row_begin; i < row_end; i++)
             {
                 size_t row_idx = masks == nullptr ? i : masks->at(i);
                 StringRef str = col.column->getDataAt(row_idx);
@@ -149,26 +218,22 @@ static void writeVariableLengthNonNullableValue(
         }
         else
         {
-            Field field;
-            for (size_t i = 0; i < num_rows; i++)
+            /// The decimals are converted from the data of the column straight into the rows.
+            const char * data = col.column->getRawData().data();
+            for (size_t i = row_begin; i < row_end; i++)
             {
                 size_t row_idx = masks == nullptr ? i : masks->at(i);
-                StringRef str_view = col.column->getDataAt(row_idx);
-                String buf(str_view.data, str_view.size);
-                BackingDataLengthCalculator::swapDecimalEndianBytes(buf);
-                int64_t offset_and_size = writer.writeUnalignedBytes(i, buf.data(), buf.size(), 0);
+                int64_t offset_and_size = writer.writeBigEndianDecimal128(i, data + row_idx * sizeof(Decimal128), 0);
                 memcpy(buffer_address + offsets[i] + field_offset, &offset_and_size, 8);
             }
         }
     }
     else
     {
-        Field field;
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = row_begin; i < row_end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
-            field = (*col.column)[row_idx];
-            int64_t offset_and_size = writer.write(i, field, 0);
+            int64_t offset_and_size = writer.write(i, *col.column, row_idx, 0);
             memcpy(buffer_address + offsets[i] + field_offset, &offset_and_size, 8);
         }
     }
@@ -179,7 +244,8 @@ static void writeVariableLengthNullableValue(
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
     int32_t col_index,
-    size_t num_rows,
+    size_t row_begin,
+    size_t row_end,
     const std::vector<int64_t> & offsets,
     std::vector<int64_t> & buffer_cursor,
     const MaskVector & masks = nullptr)
@@ -191,43 +257,46 @@ static void writeVariableLengthNullableValue(
     const bool use_raw_data = BackingDataLengthCalculator::isDataTypeSupportRawData(type_without_nullable);
     const bool big_endian = BackingDataLengthCalculator::isBigEndianInSparkRow(type_without_nullable);
     VariableLengthDataWriter writer(col.type, buffer_address, offsets, buffer_cursor);
-    if (use_raw_data)
+    if (use_raw_data && big_endian)
     {
-        for (size_t i = 0; i < num_rows; i++)
+        const char * data = nested_column.getRawData().data();
+        for (size_t i = row_begin; i < row_end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             if (null_map[row_idx])
                 bitSet(buffer_address + offsets[i], col_index);
-            else if (!big_endian)
+            else
             {
-                StringRef str = nested_column.getDataAt(row_idx);
-                int64_t offset_and_size = writer.writeUnalignedBytes(i, str.data, str.size, 0);
+                int64_t offset_and_size = writer.writeBigEndianDecimal128(i, data + row_idx * sizeof(Decimal128), 0);
                 memcpy(buffer_address + offsets[i] + field_offset, &offset_and_size, 8);
             }
+        }
+    }
+    else if (use_raw_data)
+    {
+        for (size_t i = row_begin; i < row_end; i++)
+        {
+            size_t row_idx = masks == nullptr ? i : masks->at(i);
+            if (null_map[row_idx])
+                bitSet(buffer_address + offsets[i], col_index);
             else
             {
-                Field field;
-                nested_column.get(row_idx, field);
-                StringRef str_view = nested_column.getDataAt(row_idx);
-                String buf(str_view.data, str_view.size);
-                BackingDataLengthCalculator::swapDecimalEndianBytes(buf);
-                int64_t offset_and_size = writer.writeUnalignedBytes(i, buf.data(), buf.size(), 0);
+                StringRef str = nested_column.getDataAt(row_idx);
+                int64_t offset_and_size = writer.writeUnalignedBytes(i, str.data, str.size, 0);
                 memcpy(buffer_address + offsets[i] + field_offset, &offset_and_size, 8);
             }
         }
     }
     else
     {
-        Field field;
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = row_begin; i < row_end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             if (null_map[row_idx])
                 bitSet(buffer_address + offsets[i], col_index);
             else
             {
-                field = nested_column[row_idx];
-                int64_t offset_and_size = writer.write(i, field, 0);
+                int64_t offset_and_size = writer.write(i, nested_column, row_idx, 0);
                 memcpy(buffer_address + offsets[i] + field_offset, &offset_and_size, 8);
             }
         }
@@ -240,7 +309,8 @@ static void writeValue(
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
     int32_t col_index,
-    int64_t num_rows,
+    size_t row_begin,
+    size_t row_end,
     const std::vector<int64_t> & offsets,
     std::vector<int64_t> & buffer_cursor,
     const MaskVector & masks = nullptr)
@@ -250,16 +320,16 @@ static void writeValue(
     if (BackingDataLengthCalculator::isFixedLengthDataType(type_without_nullable))
     {
         if (is_nullable)
-            writeFixedLengthNullableValue(buffer_address, field_offset, col, col_index, num_rows, offsets, masks);
+            writeFixedLengthNullableValue(buffer_address, field_offset, col, col_index, row_begin, row_end, offsets, masks);
         else
-            writeFixedLengthNonNullableValue(buffer_address, field_offset, col, num_rows, offsets, masks);
+            writeFixedLengthNonNullableValue(buffer_address, field_offset, col, row_begin, row_end, offsets, masks);
     }
     else if (BackingDataLengthCalculator::isVariableLengthDataType(type_without_nullable))
     {
         if (is_nullable)
-            writeVariableLengthNullableValue(buffer_address, field_offset, col, col_index, num_rows, offsets, buffer_cursor, masks);
+            writeVariableLengthNullableValue(buffer_address, field_offset, col, col_index, row_begin, row_end, offsets, buffer_cursor, masks);
         else
-            writeVariableLengthNonNullableValue(buffer_address, field_offset, col, num_rows, offsets, buffer_cursor, masks);
+            writeVariableLengthNonNullableValue(buffer_address, field_offset, col, row_begin, row_end, offsets, buffer_cursor, masks);
     }
     else
         throw Exception(ErrorCodes::UNKNOWN_TYPE, "Doesn't support type {} for writeValue", col.type->getName());
@@ -323,12 +393,12 @@ SparkRowInfo::SparkRowInfo(
             }
             else
             {
+                auto column = col.column->convertToFullColumnIfConst();
                 BackingDataLengthCalculator calculator(col.type);
                 for (size_t i = 0; i < num_rows; ++i)
                 {
                     size_t row_idx = masks == nullptr ? i : masks->at(i);
-                    const auto field = (*col.column)[row_idx];
-                    lengths[i] += calculator.calculate(field);
+                    lengths[i] += calculator.calculate(*column, row_idx);
                 }
             }
         }
@@ -426,21 +496,80 @@ std::unique_ptr<SparkRowInfo> CHColumnToSparkRow::convertCHColumnToSparkRow(cons
     spark_row_info->setBufferAddress(reinterpret_cast<char *>(alloc(spark_row_info->getTotalBytes(), 64)));
     // spark_row_info->setBufferAddress(alignedAlloc(spark_row_info->getTotalBytes(), 64));
     memset(spark_row_info->getBufferAddress(), 0, spark_row_info->getTotalBytes());
+
+    ColumnsWithTypeAndName cols_not_const;
+    cols_not_const.reserve(spark_row_info->getNumCols());
     for (auto col_idx = 0; col_idx < spark_row_info->getNumCols(); col_idx++)
     {
         const auto & col = block.getByPosition(col_idx);
-        int64_t field_offset = spark_row_info->getFieldOffset(col_idx);
-
-        ColumnWithTypeAndName col_not_const{col.column->convertToFullColumnIfConst(), col.type, col.name};
-        writeValue(
-            spark_row_info->getBufferAddress(),
-            field_offset,
-            col_not_const,
-            col_idx,
-            spark_row_info->getNumRows(),
-            spark_row_info->getOffsets(),
-            spark_row_info->getBufferCursor(),
-            masks);
+        cols_not_const.emplace_back(col.column->convertToFullColumnIfConst(), col.type, col.name);
+    }
+
+    auto write_rows = [&](size_t row_begin, size_t row_end)
+    {
+        for (auto col_idx = 0; col_idx < spark_row_info->getNumCols(); col_idx++)
+            writeValue(
+                spark_row_info->getBufferAddress(),
+                spark_row_info->getFieldOffset(col_idx),
+                cols_not_const[col_idx],
+                col_idx,
+                row_begin,
+                row_end,
+                spark_row_info->getOffsets(),
+                spark_row_info->getBufferCursor(),
+                masks);
+    };
+
+    const size_t num_rows = spark_row_info->getNumRows();
+    if (num_threads == 0 || num_rows < std::max(parallel_threshold, num_threads + 1))
+    {
+        write_rows(0, num_rows);
+        return spark_row_info;
+    }
+
+    /// Offsets and lengths are known before values are written, so that row ranges write to disjoint parts of the buffer
+    /// and the layout is the same as in one range.
+    const size_t num_ranges = num_threads + 1;
+    const size_t range_size = (num_rows + num_ranges - 1) / num_ranges;
+    std::vector<std::exception_ptr> exceptions(num_ranges);
+    std::vector<ThreadFromGlobalPool> threads;
+    auto thread_group = CurrentThread::getGroup();
+    for (size_t range = 1; range * range_size < num_rows; ++range)
+    {
+        threads.emplace_back(
+            [&, range]
+            {
+                /// Charge the memory of the range to the query
+                if (thread_group)
+                    CurrentThread::attachToGroupIfDetached(thread_group);
+                SCOPE_EXIT_SAFE(if (thread_group) CurrentThread::detachFromGroupIfNotDetached(););
+                try
+                {
+                    write_rows(range * range_size, std::min(num_rows, (range + 1) * range_size));
+                }
+                catch (...)
+                {
+                    exceptions[range] = std::current_exception();
+                }
+            });
+    }
+    try
+    {
+        write_rows(0, range_size);
+    }
+    catch (...)
+    {
+        exceptions[0] = std::current_exception();
+    }
+    for (auto & thread : threads)
+        thread.join();
+    for (const auto & exception : exceptions)
+    {
+        if (exception)
+        {
+            freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+            std::rethrow_exception(exception);
+        }
     }
     return spark_row_info;
 }
@@ -547,6 +676,77 @@ int64_t BackingDataLengthCalculator::calculate(const Field & field) const
         ErrorCodes::UNKNOWN_TYPE, "Doesn't support type {} for BackingBufferLengthCalculator", type_without_nullable->getName());
 }
 
+int64_t BackingDataLengthCalculator::calculate(const IColumn & column, size_t row_num) const
+{
+    if (column.isNullAt(row_num))
+        return 0;
+
+    const auto * nullable_column = checkAndGetColumn<ColumnNullable>(&column);
+    const IColumn & nested_column = nullable_column ? nullable_column->getNestedColumn() : column;
+    if (isFixedLengthDataType(type_without_nullable))
+        return 0;
+
+    if (which.isStringOrFixedString())
+        return roundNumberOfBytesToNearestWord(nested_column.getDataAt(row_num).size);
+
+    if (which.isDecimal128())
+        return 16;
+
+    if (which.isArray())
+    {
+        const auto & array_column = assert_cast<const ColumnArray &>(nested_column);
+        const auto & array_offsets = array_column.getOffsets();
+        const auto * array_type = typeid_cast<const DataTypeArray *>(type_without_nullable.get());
+        const size_t elem_begin = array_offsets[row_num - 1];
+        return calculateArray(array_type->getNestedType(), array_column.getData(), elem_begin, array_offsets[row_num] - elem_begin);
+    }
+
+    if (which.isMap())
+    {
+        /// The keys and the values of a map are arrays of the same range of the nested tuple column
+        const auto & map_column = assert_cast<const ColumnMap &>(nested_column);
+        const auto & map_offsets = map_column.getNestedColumn().getOffsets();
+        const size_t elem_begin = map_offsets[row_num - 1];
+        const size_t num_keys = map_offsets[row_num] - elem_begin;
+        const auto & pairs = map_column.getNestedData();
+        const auto * map_type = typeid_cast<const DB::DataTypeMap *>(type_without_nullable.get());
+        return 8 + calculateArray(map_type->getKeyType(), pairs.getColumn(0), elem_begin, num_keys)
+            + calculateArray(map_type->getValueType(), pairs.getColumn(1), elem_begin, num_keys);
+    }
+
+    if (which.isTuple())
+    {
+        const auto & tuple_column = assert_cast<const ColumnTuple &>(nested_column);
+        const auto * type_tuple = typeid_cast<const DataTypeTuple *>(type_without_nullable.get());
+        const auto & type_fields = type_tuple->getElements();
+        const auto num_fields = type_fields.size();
+        int64_t res = calculateBitSetWidthInBytes(num_fields) + 8 * num_fields;
+        for (size_t i = 0; i < num_fields; ++i)
+        {
+            BackingDataLengthCalculator calculator(type_fields[i]);
+            res += calculator.calculate(tuple_column.getColumn(i), row_num);
+        }
+        return res;
+    }
+
+    throw Exception(
+        ErrorCodes::UNKNOWN_TYPE, "Doesn't support type {} for BackingBufferLengthCalculator", type_without_nullable->getName());
+}
+
+int64_t BackingDataLengthCalculator::calculateArray(
+    const DataTypePtr & nested_type, const IColumn & data, size_t elem_begin, size_t num_elems)
+{
+    int64_t res = 8 + calculateBitSetWidthInBytes(num_elems);
+    res += roundNumberOfBytesToNearestWord(getArrayElementSize(nested_type) * num_elems);
+    if (isFixedLengthDataType(removeNullable(nested_type)))
+        return res;
+
+    BackingDataLengthCalculator calculator(nested_type);
+    for (size_t i = elem_begin; i < elem_begin + num_elems; ++i)
+        res += calculator.calculate(data, i);
+    return res;
+}
+
 int64_t BackingDataLengthCalculator::getArrayElementSize(const DataTypePtr & nested_type)
 {
     const WhichDataType nested_which(removeNullable(nested_type));
@@ -834,6 +1034,172 @@ int64_t VariableLengthDataWriter::write(size_t row_idx, const DB::Field & field,
     throw Exception(ErrorCodes::UNKNOWN_TYPE, "Doesn't support type {} for BackingDataWriter", type_without_nullable->getName());
 }
 
+int64_t VariableLengthDataWriter::writeArray(
+    size_t row_idx, const DataTypePtr & nested_type, const IColumn & data, size_t elem_begin, size_t num_elems, int64_t parent_offset)
+{
+    /// Same layout as writeArray(Array), values are read from elem_begin-th to (elem_begin + num_elems - 1)-th rows of data
+    const auto & offset = offsets[row_idx];
+    auto & cursor = buffer_cursor[row_idx];
+
+    const auto start = cursor;
+    memcpy(buffer_address + offset + cursor, &num_elems, 8);
+    cursor += 8;
+    if (num_elems == 0)
+        return BackingDataLengthCalculator::getOffsetAndSize(start - parent_offset, 8);
+
+    const auto len_null_bitmap = calculateBitSetWidthInBytes(num_elems);
+    cursor += len_null_bitmap;
+    const auto elem_size = BackingDataLengthCalculator::getArrayElementSize(nested_type);
+    const auto len_values = roundNumberOfBytesToNearestWord(elem_size * num_elems);
+    cursor += len_values;
+
+    char * null_bitmap = buffer_address + offset + start + 8;
+    char * values = null_bitmap + len_null_bitmap;
+    const auto * nullable_data = checkAndGetColumn<ColumnNullable>(&data);
+    const IColumn & nested_data = nullable_data ? nullable_data->getNestedColumn() : data;
+    if (BackingDataLengthCalculator::isFixedLengthDataType(removeNullable(nested_type)))
+    {
+        /// Values without nulls are laid out as in the column, copy them at once
+        if (!nullable_data && nested_data.isFixedAndContiguous() && nested_data.sizeOfValueIfFixed() == static_cast<size_t>(elem_size))
+        {
+            memcpy(values, nested_data.getRawData().data() + elem_begin * elem_size, num_elems * elem_size);
+            return BackingDataLengthCalculator::getOffsetAndSize(start - parent_offset, cursor - start);
+        }
+
+        FixedLengthDataWriter writer(nested_type);
+        for (size_t i = 0; i < num_elems; ++i)
+        {
+            if (nullable_data && nullable_data->isNullAt(elem_begin + i))
+                bitSet(null_bitmap, i);
+            else
+                writer.unsafeWrite(nested_data.getDataAt(elem_begin + i), values + i * elem_size);
+        }
+    }
+    else
+    {
+        VariableLengthDataWriter writer(nested_type, buffer_address, offsets, buffer_cursor);
+        for (size_t i = 0; i < num_elems; ++i)
+        {
+            if (nullable_data && nullable_data->isNullAt(elem_begin + i))
+                bitSet(null_bitmap, i);
+            else
+            {
+                const auto offset_and_size = writer.write(row_idx, nested_data, elem_begin + i, start);
+                memcpy(values + i * elem_size, &offset_and_size, 8);
+            }
+        }
+    }
+    return BackingDataLengthCalculator::getOffsetAndSize(start - parent_offset, cursor - start);
+}
+
+int64_t VariableLengthDataWriter::writeMap(size_t row_idx, const IColumn & column, size_t row_num, int64_t parent_offset)
+{
+    const auto & offset = offsets[row_idx];
+    auto & cursor = buffer_cursor[row_idx];
+
+    /// Skip length of UnsafeArrayData of key(8B)
+    const auto start = cursor;
+    cursor += 8;
+
+    /// The keys and the values of a map are arrays of the same range of the nested tuple column
+    const auto & map_column = assert_cast<const ColumnMap &>(column);
+    const auto & map_offsets = map_column.getNestedColumn().getOffsets();
+    const size_t elem_begin = map_offsets[row_num - 1];
+    const size_t num_pairs = map_offsets[row_num] - elem_begin;
+    const auto & pairs = map_column.getNestedData();
+    const auto * map_type = typeid_cast<const DB::DataTypeMap *>(type_without_nullable.get());
+
+    const auto key_array_size = BackingDataLengthCalculator::extractSize(
+        writeArray(row_idx, map_type->getKeyType(), pairs.getColumn(0), elem_begin, num_pairs, start + 8));
+    memcpy(buffer_address + offset + start, &key_array_size, 8);
+    writeArray(row_idx, map_type->getValueType(), pairs.getColumn(1), elem_begin, num_pairs, start + 8 + key_array_size);
+    return BackingDataLengthCalculator::getOffsetAndSize(start - parent_offset, cursor - start);
+}
+
+int64_t VariableLengthDataWriter::writeStruct(size_t row_idx, const IColumn & column, size_t row_num, int64_t parent_offset)
+{
+    const auto & offset = offsets[row_idx];
+    auto & cursor = buffer_cursor[row_idx];
+    const auto start = cursor;
+
+    const auto & tuple_column = assert_cast<const ColumnTuple &>(column);
+    const auto * tuple_type = typeid_cast<const DataTypeTuple *>(type_without_nullable.get());
+    const auto & field_types = tuple_type->getElements();
+    const auto num_fields = field_types.size();
+    if (num_fields == 0)
+        return BackingDataLengthCalculator::getOffsetAndSize(start - parent_offset, 0);
+    const auto len_null_bitmap = calculateBitSetWidthInBytes(num_fields);
+    cursor += len_null_bitmap;
+    cursor += num_fields * 8;
+
+    for (size_t i = 0; i < num_fields; ++i)
+    {
+        const auto & field_column = tuple_column.getColumn(i);
+        const auto & field_type = field_types[i];
+        if (field_column.isNullAt(row_num))
+        {
+            bitSet(buffer_address + offset + start, i);
+            continue;
+        }
+
+        if (BackingDataLengthCalculator::isFixedLengthDataType(removeNullable(field_type)))
+        {
+            const auto * nullable_field = checkAndGetColumn<ColumnNullable>(&field_column);
+            const IColumn & nested_field = nullable_field ? nullable_field->getNestedColumn() : field_column;
+            FixedLengthDataWriter writer(field_type);
+            writer.unsafeWrite(nested_field.getDataAt(row_num), buffer_address + offset + start + len_null_bitmap + i * 8);
+        }
+        else
+        {
+            VariableLengthDataWriter writer(field_type, buffer_address, offsets, buffer_cursor);
+            const auto offset_and_size = writer.write(row_idx, field_column, row_num, start);
+            memcpy(buffer_address + offset + start + len_null_bitmap + 8 * i, &offset_and_size, 8);
+        }
+    }
+    return BackingDataLengthCalculator::getOffsetAndSize(start - parent_offset, cursor - start);
+}
+
+int64_t VariableLengthDataWriter::write(size_t row_idx, const DB::IColumn & column, size_t row_num, int64_t parent_offset)
+{
+    assert(row_idx < offsets.size());
+
+    if (column.isNullAt(row_num))
+        return 0;
+
+    const auto * nullable_column = checkAndGetColumn<ColumnNullable>(&column);
+    const IColumn & nested_column = nullable_column ? nullable_column->getNestedColumn() : column;
+    if (which.isStringOrFixedString())
+    {
+        const auto str = nested_column.getDataAt(row_num);
+        return writeUnalignedBytes(row_idx, str.data, str.size, parent_offset);
+    }
+
+    if (which.isDecimal128())
+        return writeBigEndianDecimal128(row_idx, nested_column.getDataAt(row_num).data, parent_offset);
+
+    if (which.isArray())
+    {
+        const auto & array_column = assert_cast<const ColumnArray &>(nested_column);
+        const auto & array_offsets = array_column.getOffsets();
+        const auto * array_type = typeid_cast<const DataTypeArray *>(type_without_nullable.get());
+        return writeArray(
+            row_idx,
+            array_type->getNestedType(),
+            array_column.getData(),
+            array_offsets[row_num - 1],
+            array_offsets[row_num] - array_offsets[row_num - 1],
+            parent_offset);
+    }
+
+    if (which.isMap())
+        return writeMap(row_idx, nested_column, row_num, parent_offset);
+
+    if (which.isTuple())
+        return writeStruct(row_idx, nested_column, row_num, parent_offset);
+
+    throw Exception(ErrorCodes::UNKNOWN_TYPE, "Doesn't support type {} for BackingDataWriter", type_without_nullable->getName());
+}
+
 int64_t BackingDataLengthCalculator::getOffsetAndSize(int64_t cursor, int64_t size)
 {
     return (cursor << 32) | size;
@@ -857,6 +1223,14 @@ int64_t VariableLengthDataWriter::writeUnalignedBytes(size_t row_idx, const char
     return res;
 }
 
+int64_t VariableLengthDataWriter::writeBigEndianDecimal128(size_t row_idx, const char * src, int64_t parent_offset)
+{
+    BackingDataLengthCalculator::writeBigEndianDecimal128(src, buffer_address + offsets[row_idx] + buffer_cursor[row_idx]);
+    auto res = BackingDataLengthCalculator::getOffsetAndSize(buffer_cursor[row_idx] - parent_offset, sizeof(Decimal128));
+    buffer_cursor[row_idx] += sizeof(Decimal128);
+    return res;
+}
+
 
 FixedLengthDataWriter::FixedLengthDataWriter(const DB::DataTypePtr & type_)
     : type_without_nullable(removeNullable(type_)), which(type_without_nullable)
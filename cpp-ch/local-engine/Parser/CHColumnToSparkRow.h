@@ -18,6 +18,7 @@
 #include <vector>
 #include <Core/Block.h>
 #include <Core/Field.h>
+#include <base/unaligned.h>
 #include <Common/Allocator.h>
 #include <Common/Arena.h>
 
@@ -88,8 +89,18 @@ class CHColumnToSparkRow : private Allocator<false/* clear_memory */>
 // class CHColumnToSparkRow : public DB::Arena
 {
 public:
+    /// Blocks of at least parallel_threshold_ rows are converted in num_threads_ + 1 row ranges concurrently if num_threads_ > 0
+    explicit CHColumnToSparkRow(size_t num_threads_ = 0, size_t parallel_threshold_ = 16384)
+        : num_threads(num_threads_), parallel_threshold(parallel_threshold_)
+    {
+    }
+
     std::unique_ptr<SparkRowInfo> convertCHColumnToSparkRow(const DB::Block & block, const MaskVector & masks = nullptr);
     void freeMem(char * address, size_t size);
+
+private:
+    const size_t num_threads;
+    const size_t parallel_threshold;
 };
 
 /// Return backing data length of values with variable-length type in bytes
@@ -104,6 +115,9 @@ public:
     /// Return length is guranteed to round up to 8
     virtual int64_t calculate(const DB::Field & field) const;
 
+    /// Same as calculate(Field) for the row_num-th value of column, read from the column without building a Field
+    int64_t calculate(const DB::IColumn & column, size_t row_num) const;
+
     static int64_t getArrayElementSize(const DB::DataTypePtr & nested_type);
 
     /// Is CH DataType can be converted to fixed-length data type in Spark?
@@ -122,12 +136,23 @@ public:
     /// Note: Spark unsafeRow biginteger is big-endian.
     ///       CH Int128 is little-endian, is same as system(std::endian::native).
     static void swapDecimalEndianBytes(String & buf);
+    /// Same as swapDecimalEndianBytes from the 16 bytes at src to those at dst.
+    static void writeBigEndianDecimal128(const char * __restrict src, char * __restrict dst)
+    {
+        UInt64 low = unalignedLoad<UInt64>(src);
+        UInt64 high = unalignedLoad<UInt64>(src + 8);
+        unalignedStore<UInt64>(dst, __builtin_bswap64(high));
+        unalignedStore<UInt64>(dst + 8, __builtin_bswap64(low));
+    }
 
     static int64_t getOffsetAndSize(int64_t cursor, int64_t size);
     static int64_t extractOffset(int64_t offset_and_size);
     static int64_t extractSize(int64_t offset_and_size);
 
 private:
+    /// Length of the array of num_elems values of nested_type read from the elem_begin-th row of data
+    static int64_t calculateArray(const DB::DataTypePtr & nested_type, const DB::IColumn & data, size_t elem_begin, size_t num_elems);
+
     // const DB::DataTypePtr type;
     const DB::DataTypePtr type_without_nullable;
     const DB::WhichDataType which;
@@ -152,13 +177,27 @@ public:
     /// parent_offset: the starting offset of current structure in which we are updating it's backing data region
     virtual int64_t write(size_t row_idx, const DB::Field & field, int64_t parent_offset);
 
+    /// Same as write(Field) for the row_num-th value of column, copied from the offsets and nested data of the column
+    virtual int64_t write(size_t row_idx, const DB::IColumn & column, size_t row_num, int64_t parent_offset);
+
     /// Only support String/FixedString/Decimal128
     int64_t writeUnalignedBytes(size_t row_idx, const char * src, size_t size, int64_t parent_offset);
+    /// Writes the little-endian Decimal128 at src big-endian, without a copy in between.
+    int64_t writeBigEndianDecimal128(size_t row_idx, const char * src, int64_t parent_offset);
 
 private:
     int64_t writeArray(size_t row_idx, const DB::Array & array, int64_t parent_offset);
     int64_t writeMap(size_t row_idx, const DB::Map & map, int64_t parent_offset);
     int64_t writeStruct(size_t row_idx, const DB::Tuple & tuple, int64_t parent_offset);
+    int64_t writeArray(
+        size_t row_idx,
+        const DB::DataTypePtr & nested_type,
+        const DB::IColumn & data,
+        size_t elem_begin,
+        size_t num_elems,
+        int64_t parent_offset);
+    int64_t writeMap(size_t row_idx, const DB::IColumn & column, size_t row_num, int64_t parent_offset);
+    int64_t writeStruct(size_t row_idx, const DB::IColumn & column, size_t row_num, int64_t parent_offset);
 
     // const DB::DataTypePtr type;
     const DB::DataTypePtr type_without_nullable;
@@ -81,7 +81,9 @@ protected:
     toFunctionNode(DB::ActionsDAGPtr & action_dag, const String & func_name, const String & result_name, const DB::ActionsDAG::NodeRawConstPtrs & args) const
     {
         auto function_builder = DB::FunctionFactory::instance().get(func_name, getContext());
-        return &action_dag->addFunction(function_builder, args, result_name);
+        const auto * function_node = &action_dag->addFunction(function_builder, args, result_name);
+        plan_parser->has_nondeterministic_functions |= !function_node->function_base->isDeterministic();
+        return function_node;
     }
 
     const DB::ActionsDAG::Node * parseExpression(DB::ActionsDAGPtr actions_dag, const substrait::Expression & rel) const
@@ -17,6 +17,9 @@
 #include <Processors/IProcessor.h>
 #include "RelMetric.h"
 #include <Processors/QueryPlan/AggregatingStep.h>
+#include <Processors/QueryPlan/JoinStep.h>
+#include <Common/ProcessorMemoryTracker.h>
+#include <Storages/SubstraitSource/SubstraitFileSource.h>
 
 using namespace rapidjson;
 
@@ -63,6 +66,30 @@ RelMetricTimes RelMetric::getTotalTime() const
     return timeMetrics;
 }
 
+RelMetricMemory RelMetric::getTotalMemory() const
+{
+    RelMetricMemory memory_metrics{0, 0};
+    for (const auto * step : steps)
+    {
+        /// The broadcast tables of FilledJoinStep are shared by the tasks, not counted.
+        if (const auto * join_step = dynamic_cast<const DB::JoinStep *>(step); join_step && join_step->getJoin())
+        {
+            size_t join_bytes = join_step->getJoin()->getTotalByteCount();
+            memory_metrics.current_bytes += join_bytes;
+            memory_metrics.peak_bytes += join_bytes;
+        }
+        for (const auto & processor : step->getProcessors())
+        {
+            if (const auto * tracked = dynamic_cast<const MemoryTrackedProcessor *>(processor.get()))
+            {
+                memory_metrics.current_bytes += tracked->getMemoryTracker().currentBytes();
+                memory_metrics.peak_bytes += tracked->getMemoryTracker().peakBytes();
+            }
+        }
+    }
+    return memory_metrics;
+}
+
 void RelMetric::serialize(Writer<StringBuffer> & writer, bool) const
 {
     writer.StartObject();
@@ -77,6 +104,18 @@ void RelMetric::serialize(Writer<StringBuffer> & writer, bool) const
     writer.Uint64(timeMetrics.input_wait_elapsed_us);
     writer.Key("output_wait_time");
     writer.Uint64(timeMetrics.output_wait_elapsed_us);
+    writer.Key("eliminated_expressions");
+    writer.Uint64(eliminated_expressions);
+    size_t spilled_bytes = 0;
+    for (const auto & spill_scope : spill_scopes)
+        spilled_bytes += spill_scope->getStat().compressed_size;
+    writer.Key("spilled_bytes");
+    writer.Uint64(spilled_bytes);
+    RelMetricMemory memory_metrics = getTotalMemory();
+    writer.Key("current_memory_bytes");
+    writer.Uint64(memory_metrics.current_bytes);
+    writer.Key("peak_memory_bytes");
+    writer.Uint64(memory_metrics.peak_bytes);
     if (!steps.empty())
     {
         writer.Key("steps");
@@ -105,6 +144,19 @@ void RelMetric::serialize(Writer<StringBuffer> & writer, bool) const
                 writer.Uint64(processor->getProcessorDataStats().input_rows);
                 writer.Key("input_bytes");
                 writer.Uint64(processor->getProcessorDataStats().input_bytes);
+                if (const auto * file_source = dynamic_cast<const SubstraitFileSource *>(processor.get()))
+                {
+                    auto page_stats = file_source->getPagePruningStats();
+                    writer.Key("pages_read");
+                    writer.Uint64(page_stats.pages_read);
+                    writer.Key("pages_skipped");
+                    writer.Uint64(page_stats.pages_skipped);
+                    auto cache_stats = file_source->getFileCacheStats();
+                    writer.Key("cache_hit_bytes");
+                    writer.Uint64(cache_stats.hit_bytes);
+                    writer.Key("cache_miss_bytes");
+                    writer.Uint64(cache_stats.miss_bytes);
+                }
                 writer.EndObject();
             }
             writer.EndArray();
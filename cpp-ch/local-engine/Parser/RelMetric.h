@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <Interpreters/TemporaryDataOnDisk.h>
 #include <Processors/QueryPlan/IQueryPlanStep.h>
 #include <rapidjson/prettywriter.h>
 
@@ -34,6 +35,13 @@ struct RelMetricTimes
     size_t output_wait_elapsed_us;
 };
 
+struct RelMetricMemory
+{
+    // Bytes held by the processors of the steps, and the most they held.
+    size_t current_bytes;
+    size_t peak_bytes;
+};
+
 class RelMetric
 {
 public:
@@ -45,6 +53,12 @@ public:
     const std::vector<DB::IQueryPlanStep *> & getSteps() const;
     const std::vector<RelMetricPtr> & getInputs() const;
     RelMetricTimes getTotalTime() const;
+    /// Of the processors tracking their memory and of the hash tables of the joins.
+    RelMetricMemory getTotalMemory() const;
+    /// Number of the repeated expressions of the relation computed once.
+    void setEliminatedExpressions(size_t eliminated_expressions_) { eliminated_expressions = eliminated_expressions_; }
+    /// The temporary data of the steps of the relation spilling to disk, whose written bytes are reported.
+    void setSpillScopes(std::vector<DB::TemporaryDataOnDiskScopePtr> spill_scopes_) { spill_scopes = std::move(spill_scopes_); }
     void serialize(rapidjson::Writer<rapidjson::StringBuffer> & writer, bool summary = true) const;
 
 private:
@@ -53,6 +67,8 @@ private:
     // query plan is from query plan
     std::vector<DB::IQueryPlanStep *> steps;
     std::vector<RelMetricPtr> inputs;
+    size_t eliminated_expressions = 0;
+    std::vector<DB::TemporaryDataOnDiskScopePtr> spill_scopes;
 };
 
 class RelMetricSerializer
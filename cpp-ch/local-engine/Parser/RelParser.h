@@ -77,6 +77,7 @@ protected:
         return plan_parser->expressionsToActionsDAG(expressions, header, header);
     }
     std::pair<DataTypePtr, Field> parseLiteral(const substrait::Expression_Literal & literal) { return plan_parser->parseLiteral(literal); }
+    DB::TemporaryDataOnDiskScopePtr createSpillScope() { return plan_parser->createSpillScope(); }
     // collect all steps for metrics
     std::vector<IQueryPlanStep *> steps;
 
@@ -36,6 +36,7 @@
 #include <DataTypes/DataTypeDateTime64.h>
 #include <DataTypes/DataTypeFactory.h>
 #include <DataTypes/DataTypeFixedString.h>
+#include <DataTypes/DataTypeLowCardinality.h>
 #include <DataTypes/DataTypeMap.h>
 #include <DataTypes/DataTypeNothing.h>
 #include <DataTypes/DataTypeNullable.h>
@@ -59,7 +60,9 @@
 #include <Interpreters/GraceHashJoin.h>
 #include <Interpreters/ProcessList.h>
 #include <Interpreters/QueryPriorities.h>
+#include <Operator/AdaptiveFilterStep.h>
 #include <Operator/BlocksBufferPoolTransform.h>
+#include <Operator/NestedLoopJoinStep.h>
 #include <Operator/PartitionColumnFillingTransform.h>
 #include <Parser/FunctionParser.h>
 #include <Parser/RelParser.h>
@@ -77,7 +80,9 @@
 #include <Processors/QueryPlan/MergingAggregatedStep.h>
 #include <Processors/QueryPlan/Optimizations/QueryPlanOptimizationSettings.h>
 #include <Processors/QueryPlan/QueryPlan.h>
+#include <Processors/QueryPlan/ReadFromMergeTree.h>
 #include <Processors/QueryPlan/ReadFromPreparedSource.h>
+#include <Processors/QueryPlan/ReadNothingStep.h>
 #include <Processors/QueryPlan/SortingStep.h>
 #include <Processors/Transforms/AggregatingTransform.h>
 #include <Processors/Transforms/MaterializingTransform.h>
@@ -85,11 +90,15 @@
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Storages/CustomStorageMergeTree.h>
 #include <Storages/IStorage.h>
+#include <Storages/MergeTree/AlterConversions.h>
 #include <Storages/MergeTree/MergeTreeData.h>
+#include <Storages/MergeTree/RangesInDataPart.h>
+#include <Storages/MergeTreeSkipIndexFilter.h>
 #include <Storages/StorageMergeTreeFactory.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #include <base/Decimal.h>
+#include <base/scope_guard.h>
 #include <base/types.h>
 #include <google/protobuf/util/json_util.h>
 #include <google/protobuf/wrappers.pb.h>
@@ -157,6 +166,18 @@ std::shared_ptr<DB::ActionsDAG> SerializedPlanParser::expressionsToActionsDAG(
     NamesWithAliases required_columns;
     std::set<String> distinct_columns;
 
+    literal_args_to_merge.clear();
+    for (const auto & expr : expressions)
+        collectCallsToMerge(expr);
+    std::erase_if(literal_args_to_merge, [](const auto & literal_args) { return literal_args.second.size() < 2; });
+    SCOPE_EXIT({ literal_args_to_merge.clear(); });
+
+    cse_actions_dag = actions_dag;
+    SCOPE_EXIT({
+        cse_actions_dag.reset();
+        cse_nodes.clear();
+    });
+
     for (const auto & expr : expressions)
     {
         if (expr.has_selection())
@@ -234,6 +255,38 @@ std::shared_ptr<DB::ActionsDAG> SerializedPlanParser::expressionsToActionsDAG(
     return actions_dag;
 }
 
+void SerializedPlanParser::collectCallsToMerge(const substrait::Expression & expr)
+{
+    if (expr.has_cast())
+        collectCallsToMerge(expr.cast().input());
+    else if (expr.has_if_then())
+    {
+        for (const auto & if_clause : expr.if_then().ifs())
+        {
+            collectCallsToMerge(if_clause.if_());
+            collectCallsToMerge(if_clause.then());
+        }
+        collectCallsToMerge(expr.if_then().else_());
+    }
+    else if (expr.has_scalar_function())
+    {
+        const auto & scalar_function = expr.scalar_function();
+        const auto & function_signature = function_mapping.at(std::to_string(scalar_function.function_reference()));
+        const auto & args = scalar_function.arguments();
+        auto function_name = function_signature.substr(0, function_signature.find(':'));
+        if ((function_name == "get_json_object" || function_name == "parse_url") && args.size() == 2
+            && args[1].value().has_literal() && args[1].value().literal().has_string())
+        {
+            auto & literal_args = literal_args_to_merge[function_name + '\0' + args[0].value().SerializeAsString()];
+            const auto & literal_arg = args[1].value().literal().string();
+            if (std::find(literal_args.begin(), literal_args.end(), literal_arg) == literal_args.end())
+                literal_args.push_back(literal_arg);
+        }
+        for (const auto & arg : args)
+            collectCallsToMerge(arg.value());
+    }
+}
+
 std::string getDecimalFunction(const substrait::Type_Decimal & decimal, bool null_on_overflow)
 {
     std::string ch_function_name;
@@ -265,6 +318,22 @@ QueryPlanStepPtr SerializedPlanParser::parseReadRealWithLocalFile(const substrai
     assert(rel.has_local_files());
     assert(rel.has_base_schema());
     auto header = TypeParser::buildBlockFromNamedStruct(rel.base_schema());
+    /// Keep the dictionaries of the Parquet string columns through the scan and its filter, see parse() for where they
+    /// are dropped.
+    const auto & items = rel.local_files().items();
+    for (const auto & item : items)
+        read_files.push_back({item.uri_file(), item.modification_time()});
+    if (context->getConfigRef().getBool("parquet.read_strings_as_low_cardinality", false) && !items.empty()
+        && std::all_of(items.begin(), items.end(), [](const auto & item) { return item.has_parquet(); }))
+    {
+        for (auto & column : header)
+        {
+            if (!isString(removeNullable(column.type)))
+                continue;
+            column.type = std::make_shared<DataTypeLowCardinality>(column.type);
+            column.column = column.type->createColumn();
+        }
+    }
     auto source = std::make_shared<SubstraitFileSource>(context, header, rel.local_files());
     auto source_pipe = Pipe(source);
     auto source_step = std::make_unique<SubstraitFileSourceStep>(context, std::move(source_pipe), "substrait local files");
@@ -284,11 +353,15 @@ QueryPlanStepPtr SerializedPlanParser::parseReadRealWithJavaIter(const substrait
     assert(rel.has_local_files());
     assert(rel.local_files().items().size() == 1);
     assert(rel.has_base_schema());
+    reads_only_files = false;
     auto iter = rel.local_files().items().at(0).uri_file();
     auto pos = iter.find(':');
     auto iter_index = std::stoi(iter.substr(pos + 1, iter.size()));
 
-    auto source = std::make_shared<SourceFromJavaIter>(TypeParser::buildBlockFromNamedStruct(rel.base_schema()), input_iters[iter_index]);
+    auto source = std::make_shared<SourceFromJavaIter>(
+        TypeParser::buildBlockFromNamedStruct(rel.base_schema()),
+        input_iters[iter_index],
+        context->getConfigRef().getUInt64("target_block_bytes", 0));
     QueryPlanStepPtr source_step = std::make_unique<ReadFromPreparedSource>(Pipe(source));
     source_step->setStepDescription("Read From Java Iter");
     return source_step;
@@ -307,12 +380,72 @@ IQueryPlanStep * SerializedPlanParser::addRemoveNullableStep(QueryPlan & plan, s
     return step_ptr;
 }
 
+void SerializedPlanParser::removeLowCardinality(QueryPlan & plan)
+{
+    const auto & header = plan.getCurrentDataStream().header;
+    if (std::none_of(header.begin(), header.end(), [](const auto & column) { return column.type->lowCardinality(); }))
+        return;
+    auto result_columns = header.getColumnsWithTypeAndName();
+    for (auto & column : result_columns)
+    {
+        column.type = recursiveRemoveLowCardinality(column.type);
+        column.column = column.type->createColumn();
+    }
+    auto actions_dag
+        = ActionsDAG::makeConvertingActions(header.getColumnsWithTypeAndName(), result_columns, ActionsDAG::MatchColumnsMode::Position);
+    auto expression_step = std::make_unique<ExpressionStep>(plan.getCurrentDataStream(), actions_dag);
+    expression_step->setStepDescription("Remove LowCardinality");
+    plan.addStep(std::move(expression_step));
+}
+
+namespace
+{
+/// The marks [begin_mark, end_mark) of a single part.
+RangesInDataParts markRange(const MergeTreeData::DataPartsVector & parts, size_t begin_mark, size_t end_mark)
+{
+    if (parts.size() != 1)
+        throw Exception(ErrorCodes::LOGICAL_ERROR, "Mark range {} to {} given for {} parts", begin_mark, end_mark, parts.size());
+    const auto & part = parts.front();
+    end_mark = std::min(end_mark, part->getMarksCount());
+    begin_mark = std::min(begin_mark, end_mark);
+    RangesInDataParts parts_with_ranges;
+    if (begin_mark < end_mark)
+        parts_with_ranges.emplace_back(part, std::make_shared<AlterConversions>(), 0, MarkRanges{MarkRange(begin_mark, end_mark)});
+    return parts_with_ranges;
+}
+
+/// The analysis result reading only the given marks of the parts, in place of the one readFromParts computes for
+/// whole parts.
+MergeTreeDataSelectAnalysisResultPtr
+analyzeMarkRanges(const MergeTreeData::DataPartsVector & parts, RangesInDataParts parts_with_ranges, const Names & column_names)
+{
+    ReadFromMergeTree::AnalysisResult result;
+    result.column_names_to_read = column_names;
+    result.total_parts = parts.size();
+    result.parts_before_pk = parts.size();
+    for (const auto & part : parts)
+        result.total_marks_pk += part->getMarksCount();
+    for (const auto & part : parts_with_ranges)
+    {
+        result.selected_ranges += part.ranges.size();
+        result.selected_marks += part.getMarksCount();
+        result.selected_rows += part.getRowsCount();
+    }
+    result.selected_parts = parts_with_ranges.size();
+    result.selected_marks_pk = result.selected_marks;
+    result.parts_with_ranges = std::move(parts_with_ranges);
+    return std::make_shared<MergeTreeDataSelectAnalysisResult>(MergeTreeDataSelectAnalysisResult{.result = std::move(result)});
+}
+}
+
 DB::QueryPlanPtr SerializedPlanParser::parseMergeTreeTable(const substrait::ReadRel & rel, std::vector<IQueryPlanStep *> & steps)
 {
     assert(rel.has_extension_table());
     google::protobuf::StringValue table;
     table.ParseFromString(rel.extension_table().detail().value());
     auto merge_tree_table = local_engine::parseMergeTreeTableString(table.value());
+    /// Parts come and go between the runs of a plan.
+    reads_only_files = false;
     DB::Block header;
     if (rel.has_base_schema() && rel.base_schema().names_size())
     {
@@ -321,12 +454,12 @@ DB::QueryPlanPtr SerializedPlanParser::parseMergeTreeTable(const substrait::Read
     else
     {
         // For count(*) case, there will be an empty base_schema, so we try to read at least once column
-        auto all_parts_dir = MergeTreeUtil::getAllMergeTreeParts(std::filesystem::path("/") / merge_tree_table.relative_path);
-        if (all_parts_dir.empty())
+        auto any_part_dir = MergeTreeUtil::getAnyMergeTreePart(std::filesystem::path("/") / merge_tree_table.relative_path);
+        if (!any_part_dir)
         {
             throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Empty mergetree directory: {}", merge_tree_table.relative_path);
         }
-        auto part_names_types_list = MergeTreeUtil::getSchemaFromMergeTreePart(all_parts_dir[0]);
+        auto part_names_types_list = MergeTreeUtil::getSchemaFromMergeTreePart(*any_part_dir);
         NamesAndTypesList one_column_name_type;
         one_column_name_type.push_back(part_names_types_list.front());
         header = BlockUtil::buildHeader(one_column_name_type);
@@ -334,7 +467,7 @@ DB::QueryPlanPtr SerializedPlanParser::parseMergeTreeTable(const substrait::Read
     }
     auto names_and_types_list = header.getNamesAndTypesList();
     auto storage_factory = StorageMergeTreeFactory::instance();
-    auto metadata = buildMetaData(names_and_types_list, context);
+    auto metadata = buildMetaData(names_and_types_list, context, merge_tree_table.skip_indexes);
     query_context.metadata = metadata;
     auto storage = storage_factory.getStorage(
         StorageID(merge_tree_table.database, merge_tree_table.table),
@@ -363,29 +496,64 @@ DB::QueryPlanPtr SerializedPlanParser::parseMergeTreeTable(const substrait::Read
         non_nullable_columns = non_nullable_columns_resolver.resolve();
         query_info->prewhere_info = parsePreWhereInfo(rel.filter(), header);
     }
-    auto data_parts = query_context.custom_storage_merge_tree->getAllDataPartsVector();
     int min_block = merge_tree_table.min_block;
     int max_block = merge_tree_table.max_block;
-    MergeTreeData::DataPartsVector selected_parts;
-    std::copy_if(
-        std::begin(data_parts),
-        std::end(data_parts),
-        std::inserter(selected_parts, std::begin(selected_parts)),
-        [min_block, max_block](MergeTreeData::DataPartPtr part)
-        { return part->info.min_block >= min_block && part->info.max_block < max_block; });
+    auto selected_parts = query_context.custom_storage_merge_tree->selectPartsByBlockRange(min_block, max_block);
     if (selected_parts.empty())
     {
         throw Exception(ErrorCodes::NO_SUCH_DATA_PART, "part {} to {} not found.", min_block, max_block);
     }
+    auto names = names_and_types_list.getNames();
+    std::optional<MergeTreeSkipIndexFilter> skip_index_filter;
+    if (query_info->prewhere_info && metadata->hasSecondaryIndices())
+    {
+        const auto & prewhere = *query_info->prewhere_info;
+        std::unordered_map<std::string, ColumnWithTypeAndName> node_name_to_input_column;
+        for (const auto & column : header.getColumnsWithTypeAndName())
+            node_name_to_input_column.emplace(column.name, column);
+        auto filter_dag = ActionsDAG::buildFilterActionsDAG(
+            {&prewhere.prewhere_actions->findInOutputs(prewhere.prewhere_column_name)}, node_name_to_input_column, context);
+        skip_index_filter.emplace(metadata, filter_dag, context);
+        if (!skip_index_filter->useful())
+            skip_index_filter.reset();
+    }
+    MergeTreeDataSelectAnalysisResultPtr mark_range_analysis;
+    if (merge_tree_table.end_mark > 0 || skip_index_filter)
+    {
+        RangesInDataParts parts_with_ranges;
+        if (merge_tree_table.end_mark > 0)
+            parts_with_ranges = markRange(selected_parts, merge_tree_table.begin_mark, merge_tree_table.end_mark);
+        else
+        {
+            for (size_t i = 0; i < selected_parts.size(); ++i)
+            {
+                const auto & part = selected_parts[i];
+                if (auto marks = part->index_granularity.getMarksCountWithoutFinal())
+                    parts_with_ranges.emplace_back(part, std::make_shared<AlterConversions>(), i, MarkRanges{MarkRange(0, marks)});
+            }
+        }
+        if (skip_index_filter)
+            parts_with_ranges = skip_index_filter->filter(std::move(parts_with_ranges));
+        mark_range_analysis = analyzeMarkRanges(selected_parts, std::move(parts_with_ranges), names);
+    }
+    // Reads on as many streams as the task has threads, like ClickHouse's max_streams.
+    const size_t num_streams = std::max<size_t>(1, context->getSettingsRef().max_threads);
     auto read_step = query_context.custom_storage_merge_tree->reader.readFromParts(
-        selected_parts,
+        mark_range_analysis ? MergeTreeData::DataPartsVector{} : selected_parts,
         /* alter_conversions = */ {},
-        names_and_types_list.getNames(),
+        names,
         query_context.storage_snapshot,
         *query_info,
         context,
         4096 * 2,
-        1);
+        num_streams,
+        /* max_block_numbers_to_read = */ nullptr,
+        mark_range_analysis);
+    if (!read_step)
+    {
+        // The mark range is past the end of the part, or the skip indexes dropped every granule.
+        read_step = std::make_unique<ReadNothingStep>(query_context.storage_snapshot->getSampleBlockForColumns(names));
+    }
     QueryPlanPtr query = std::make_unique<QueryPlan>();
     steps.emplace_back(read_step.get());
     query->addStep(std::move(read_step));
@@ -466,6 +634,7 @@ QueryPlanPtr SerializedPlanParser::parse(std::unique_ptr<substrait::Plan> plan)
         }
         std::list<const substrait::Rel *> rel_stack;
         auto query_plan = parseOp(root_rel.root().input(), rel_stack);
+        removeLowCardinality(*query_plan);
         if (root_rel.root().names_size())
         {
             ActionsDAGPtr actions_dag = std::make_shared<ActionsDAG>(blockToNameAndTypeList(query_plan->getCurrentDataStream().header));
@@ -584,7 +753,14 @@ QueryPlanPtr SerializedPlanParser::parseOp(const substrait::Rel & rel, std::list
             actions_dag->removeUnusedActions(input_with_condition);
             NonNullableColumnsResolver non_nullable_columns_resolver(query_plan->getCurrentDataStream().header, *this, filter.condition());
             auto non_nullable_columns = non_nullable_columns_resolver.resolve();
-            auto filter_step = std::make_unique<FilterStep>(query_plan->getCurrentDataStream(), actions_dag, filter_name, remove_filter_column);
+            std::vector<ActionsDAGPtr> conjuncts;
+            if (remove_filter_column && context->getConfigRef().getBool("filter.adaptive_reorder", true))
+                conjuncts = splitFilterConjuncts(*actions_dag, filter_name);
+            QueryPlanStepPtr filter_step;
+            if (conjuncts.size() > 1)
+                filter_step = std::make_unique<AdaptiveFilterStep>(query_plan->getCurrentDataStream(), std::move(conjuncts));
+            else
+                filter_step = std::make_unique<FilterStep>(query_plan->getCurrentDataStream(), actions_dag, filter_name, remove_filter_column);
             filter_step->setStepDescription("WHERE");
             steps.emplace_back(filter_step.get());
             query_plan->addStep(std::move(filter_step));
@@ -635,7 +811,8 @@ QueryPlanPtr SerializedPlanParser::parseOp(const substrait::Rel & rel, std::list
             if (read.has_local_files())
             {
                 QueryPlanStepPtr step;
-                if (isReadRelFromJava(read))
+                bool from_java = isReadRelFromJava(read);
+                if (from_java)
                     step = parseReadRealWithJavaIter(read);
                 else
                     step = parseReadRealWithLocalFile(read);
@@ -645,10 +822,14 @@ QueryPlanPtr SerializedPlanParser::parseOp(const substrait::Rel & rel, std::list
                 query_plan->addStep(std::move(step));
 
                 // Add a buffer after source, it try to preload data from source and reduce the
-                // waiting time of downstream nodes.
-                if (context->getSettingsRef().max_threads > 1)
+                // waiting time of downstream nodes. Files can be read on a thread of their own, the
+                // Java iterators are only called from the task thread.
+                const auto & config = context->getConfigRef();
+                bool async_prefetch = !from_java && config.getBool("source_prefetch.async", false);
+                if (async_prefetch || context->getSettingsRef().max_threads > 1)
                 {
-                    auto buffer_step = std::make_unique<BlocksBufferPoolStep>(query_plan->getCurrentDataStream());
+                    auto buffer_step = std::make_unique<BlocksBufferPoolStep>(
+                        query_plan->getCurrentDataStream(), 4, config.getUInt64("source_prefetch.max_bytes", 64 << 20), async_prefetch);
                     steps.emplace_back(buffer_step.get());
                     query_plan->addStep(std::move(buffer_step));
                 }
@@ -719,6 +900,10 @@ QueryPlanPtr SerializedPlanParser::parseOp(const substrait::Rel & rel, std::list
     {
         metrics = {std::make_shared<RelMetric>(String(magic_enum::enum_name(rel.rel_type_case())), metrics, steps)};
     }
+    metrics.back()->setEliminatedExpressions(eliminated_expressions);
+    eliminated_expressions = 0;
+    metrics.back()->setSpillScopes(std::move(spill_scopes));
+    spill_scopes.clear();
     return query_plan;
 }
 
@@ -1060,8 +1245,81 @@ ActionsDAG::NodeRawConstPtrs SerializedPlanParser::parseArrayJoinWithDAG(
     }
 }
 
+TemporaryDataOnDiskScopePtr SerializedPlanParser::createSpillScope()
+{
+    auto parent = context->getTempDataOnDisk();
+    if (!parent)
+        return nullptr;
+    auto spill_scope = std::make_shared<TemporaryDataOnDiskScope>(parent, /* limit */ 0);
+    spill_scopes.emplace_back(spill_scope);
+    return spill_scope;
+}
+
+std::vector<ActionsDAGPtr> SerializedPlanParser::splitFilterConjuncts(const ActionsDAG & actions_dag, const String & filter_name)
+{
+    const auto * filter_node = actions_dag.tryFindInOutputs(filter_name);
+    if (!filter_node)
+        return {};
+    ActionsDAG::NodeRawConstPtrs conjunct_nodes;
+    std::function<void(const ActionsDAG::Node *)> collect_conjuncts = [&](const ActionsDAG::Node * node)
+    {
+        while (node->type == ActionsDAG::ActionType::ALIAS)
+            node = node->children[0];
+        if (node->type == ActionsDAG::ActionType::FUNCTION && node->function_base->getName() == "and")
+        {
+            for (const auto * child : node->children)
+                collect_conjuncts(child);
+        }
+        else
+            conjunct_nodes.emplace_back(node);
+    };
+    collect_conjuncts(filter_node);
+    /// Reordering changes the rows a non-deterministic conjunct sees.
+    if (conjunct_nodes.size() < 2 || !std::all_of(conjunct_nodes.begin(), conjunct_nodes.end(), isDeterministicSubtree))
+        return {};
+
+    std::vector<ActionsDAGPtr> conjuncts;
+    for (const auto * node : conjunct_nodes)
+        conjuncts.emplace_back(ActionsDAG::cloneSubDAG({node}, false));
+    return conjuncts;
+}
+
+bool SerializedPlanParser::isDeterministicSubtree(const ActionsDAG::Node * node)
+{
+    if (node->type == ActionsDAG::ActionType::ARRAY_JOIN)
+        return false;
+    if (node->type == ActionsDAG::ActionType::FUNCTION && !node->function_base->isDeterministic())
+        return false;
+    return std::all_of(node->children.begin(), node->children.end(), isDeterministicSubtree);
+}
+
 const ActionsDAG::Node * SerializedPlanParser::parseFunctionWithDAG(
     const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag, bool keep_result)
+{
+    /// Only within the DAG of a projection, the nodes of other DAGs may be dropped before the DAG is done.
+    /// Constants need no such pass, ActionsDAG::addFunction already folds the functions of constant arguments.
+    if (!cse_actions_dag || actions_dag != cse_actions_dag)
+        return parseFunctionWithDAGImpl(rel, result_name, actions_dag, keep_result);
+
+    auto key = rel.SerializeAsString();
+    if (auto it = cse_nodes.find(key); it != cse_nodes.end())
+    {
+        const auto * node = it->second;
+        if (keep_result)
+            actions_dag->addOrReplaceInOutputs(*node);
+        result_name = node->result_name;
+        ++eliminated_expressions;
+        return node;
+    }
+
+    const auto * node = parseFunctionWithDAGImpl(rel, result_name, actions_dag, keep_result);
+    if (isDeterministicSubtree(node))
+        cse_nodes.emplace(std::move(key), node);
+    return node;
+}
+
+const ActionsDAG::Node * SerializedPlanParser::parseFunctionWithDAGImpl(
+    const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag, bool keep_result)
 {
     if (!rel.has_scalar_function())
         throw Exception(ErrorCodes::BAD_ARGUMENTS, "the root of expression should be a scalar function:\n {}", rel.DebugString());
@@ -1159,6 +1417,7 @@ const ActionsDAG::Node * SerializedPlanParser::parseFunctionWithDAG(
         std::string args_name = join(args, ',');
         result_name = ch_func_name + "(" + args_name + ")";
         const auto * function_node = &actions_dag->addFunction(function_builder, args, result_name);
+        has_nondeterministic_functions |= !function_node->function_base->isDeterministic();
         result_node = function_node;
 
         if (!TypeParser::isTypeMatched(rel.scalar_function().output_type(), function_node->result_type) && !converted_decimal_args)
@@ -1430,8 +1689,7 @@ const DB::ActionsDAG::Node * SerializedPlanParser::parseFunctionArgument(
     {
         std::string arg_name;
         bool keep_arg = FUNCTION_NEED_KEEP_ARGUMENTS.contains(function_name);
-        parseFunctionWithDAG(arg.value(), arg_name, actions_dag, keep_arg);
-        res = &actions_dag->getNodes().back();
+        res = parseFunctionWithDAG(arg.value(), arg_name, actions_dag, keep_arg);
     }
     else
     {
@@ -1566,6 +1824,7 @@ SerializedPlanParser::toFunctionNode(ActionsDAGPtr actions_dag, const String & f
     std::string args_name = join(args, ',');
     auto result_name = function + "(" + args_name + ")";
     const auto * function_node = &actions_dag->addFunction(function_builder, args, result_name);
+    has_nondeterministic_functions |= !function_node->function_base->isDeterministic();
     return function_node;
 }
 
@@ -2008,7 +2267,31 @@ DB::QueryPlanPtr SerializedPlanParser::parseJoin(
     google::protobuf::StringValue optimization;
     optimization.ParseFromString(join.advanced_extension().optimization().value());
     auto join_opt_info = parseJoinOptimizationInfo(optimization.value());
-    auto table_join = std::make_shared<TableJoin>(global_context->getSettings(), global_context->getGlobalTemporaryVolume());
+
+    /// A shuffled inner or left join whose build side is estimated larger than the memory a join may take, max_bytes_in_join
+    /// or half of the off-heap memory of the task, is a grace hash join. The build side is then hashed into buckets spilled
+    /// to disk, which are joined one by one within that memory.
+    auto join_settings = global_context->getSettings();
+    bool use_grace_hash_join = context->getSettingsRef().join_algorithm.isSet(DB::JoinAlgorithm::GRACE_HASH);
+    if (!use_grace_hash_join && !join_opt_info.is_broadcast && join_opt_info.build_side_bytes > 0 && context->getTempDataOnDisk()
+        && (join.type() == substrait::JoinRel_JoinType_JOIN_TYPE_INNER || join.type() == substrait::JoinRel_JoinType_JOIN_TYPE_LEFT))
+    {
+        UInt64 join_memory = context->getSettingsRef().max_bytes_in_join;
+        String task_memory;
+        if (!join_memory && context->getSettingsRef().tryGetString(BackendInitializerUtil::GLUTEN_TASK_OFFHEAP, task_memory))
+            join_memory = std::stoull(task_memory) / 2;
+        if (join_memory && join_opt_info.build_side_bytes > join_memory)
+        {
+            LOG_DEBUG(
+                &Poco::Logger::get("SerializedPlanParser"),
+                "Build side of {} bytes exceeds the join memory of {} bytes, joining by grace hash join",
+                join_opt_info.build_side_bytes,
+                join_memory);
+            join_settings.max_bytes_in_join = join_memory;
+            use_grace_hash_join = true;
+        }
+    }
+    auto table_join = std::make_shared<TableJoin>(join_settings, global_context->getGlobalTemporaryVolume());
     if (join.type() == substrait::JoinRel_JoinType_JOIN_TYPE_INNER)
     {
         table_join->setKind(DB::JoinKind::Inner);
@@ -2042,6 +2325,8 @@ DB::QueryPlanPtr SerializedPlanParser::parseJoin(
     if (join_opt_info.is_broadcast)
     {
         auto storage_join = BroadCastJoinBuilder::getJoin(join_opt_info.storage_join_key);
+        if (!storage_join->hasJoinKeys())
+            return parseNestedLoopJoin(join, std::move(left), std::move(right), *storage_join, *table_join, steps);
         ActionsDAGPtr project = ActionsDAG::makeConvertingActions(
             right->getCurrentDataStream().header.getColumnsWithTypeAndName(),
             storage_join->getRightSampleBlock().getColumnsWithTypeAndName(),
@@ -2149,6 +2434,11 @@ DB::QueryPlanPtr SerializedPlanParser::parseJoin(
     {
         auto storage_join = BroadCastJoinBuilder::getJoin(join_opt_info.storage_join_key);
         auto hash_join = storage_join->getJoinLocked(table_join, context);
+        // Probe rows out of the build key range match nothing, and are only dropped where the join keeps just the matches.
+        bool inner_or_semi = table_join->kind() == JoinKind::Inner
+            || (table_join->kind() == JoinKind::Left && table_join->strictness() == JoinStrictness::Semi);
+        if (inner_or_semi && table_join->oneDisjunct() && !add_filter_step)
+            addBuildKeyRangeFilter(*left, *storage_join, *table_join, steps);
         QueryPlanStepPtr join_step = std::make_unique<FilledJoinStep>(left->getCurrentDataStream(), hash_join, 8192);
 
         join_step->setStepDescription("JOIN");
@@ -2169,16 +2459,13 @@ DB::QueryPlanPtr SerializedPlanParser::parseJoin(
         ///   the memory limitation fro grace hash join. If the memory consumption exceeds the limitation,
         ///   data will be spilled to disk. Don't set the limitation too small, otherwise the buckets number
         ///   will be too large and the performance will be bad.
+        ///
+        /// Without join_algorithm=grace_hash, it is still taken when the estimated build side exceeds the join memory.
         JoinPtr hash_join = nullptr;
-        MultiEnum<DB::JoinAlgorithm> join_algorithm = context->getSettingsRef().join_algorithm;
-        if (join_algorithm.isSet(DB::JoinAlgorithm::GRACE_HASH))
+        if (use_grace_hash_join && DB::GraceHashJoin::isSupported(table_join))
         {
             hash_join = std::make_shared<DB::GraceHashJoin>(
-                context,
-                table_join,
-                left->getCurrentDataStream().header,
-                right->getCurrentDataStream().header,
-                context->getTempDataOnDisk());
+                context, table_join, left->getCurrentDataStream().header, right->getCurrentDataStream().header, createSpillScope());
         }
         else
         {
@@ -2210,6 +2497,121 @@ DB::QueryPlanPtr SerializedPlanParser::parseJoin(
     return query_plan;
 }
 
+DB::QueryPlanPtr SerializedPlanParser::parseNestedLoopJoin(
+    substrait::JoinRel & join,
+    DB::QueryPlanPtr left,
+    DB::QueryPlanPtr right,
+    const StorageJoinFromReadBuffer & storage_join,
+    const DB::TableJoin & table_join,
+    std::vector<IQueryPlanStep *> & steps)
+{
+    /// Left semi and anti joins are left joins of semi and anti strictness.
+    switch (join.type())
+    {
+        case substrait::JoinRel_JoinType_JOIN_TYPE_INNER:
+        case substrait::JoinRel_JoinType_JOIN_TYPE_LEFT:
+        case substrait::JoinRel_JoinType_JOIN_TYPE_LEFT_SEMI:
+        case substrait::JoinRel_JoinType_JOIN_TYPE_ANTI:
+            break;
+        default:
+            throw Exception(ErrorCodes::UNKNOWN_TYPE, "unsupported nested loop join type {}.", magic_enum::enum_name(join.type()));
+    }
+    auto kind = table_join.kind();
+    auto strictness = table_join.strictness();
+
+    /// The build columns follow the probe ones, renamed where their names clash, and nullable for a left join.
+    const auto & probe_header = left->getCurrentDataStream().header;
+    auto build_block = storage_join.getBuildBlock();
+    auto build_header = storage_join.getRightSampleBlock();
+    String prefix = getUniqueName("right") + ".";
+    for (size_t i = 0; i < build_block.columns(); ++i)
+    {
+        auto & column = build_block.getByPosition(i);
+        if (!column.type->equals(*build_header.getByPosition(i).type))
+            JoinCommon::convertColumnToNullable(column);
+        if (probe_header.has(column.name))
+            column.name = prefix + column.name;
+    }
+    auto header = probe_header.cloneEmpty();
+    for (const auto & column : build_block)
+        header.insert(column.cloneEmpty());
+
+    ActionsDAGPtr condition;
+    String condition_name;
+    ActionsDAG::NodeRawConstPtrs conditions;
+    for (const auto * expression : {join.has_expression() ? &join.expression() : nullptr,
+                                    join.has_post_join_filter() ? &join.post_join_filter() : nullptr})
+    {
+        if (!expression)
+            continue;
+        String result_name;
+        condition = parseFunction(header, *expression, result_name, condition, true);
+        conditions.emplace_back(&condition->findInOutputs(result_name));
+    }
+    if (conditions.size() > 1)
+    {
+        const auto * and_node = toFunctionNode(condition, "and", conditions);
+        condition->addOrReplaceInOutputs(*and_node);
+        conditions = {and_node};
+    }
+    if (condition)
+        condition_name = conditions.front()->result_name;
+
+    auto build = NestedLoopJoinBuild::create(std::move(build_block), probe_header, condition, condition_name);
+    QueryPlanStepPtr join_step
+        = std::make_unique<NestedLoopJoinStep>(left->getCurrentDataStream(), build, condition, condition_name, kind, strictness, 8192);
+    join_step->setStepDescription("NESTED LOOP JOIN");
+    steps.emplace_back(join_step.get());
+    left->addStep(std::move(join_step));
+    /// hold right plan for profile
+    extra_plan_holder.emplace_back(std::move(right));
+    return left;
+}
+
+void SerializedPlanParser::addBuildKeyRangeFilter(
+    DB::QueryPlan & probe,
+    const StorageJoinFromReadBuffer & storage_join,
+    const DB::TableJoin & table_join,
+    std::vector<IQueryPlanStep *> & steps)
+{
+    const auto & header = probe.getCurrentDataStream().header;
+    const auto & clause = table_join.getOnlyClause();
+    auto joined_names = table_join.columnsFromJoinedTable().getNames();
+    auto build_header = storage_join.getRightSampleBlock();
+    auto actions_dag = std::make_shared<ActionsDAG>(header.getColumnsWithTypeAndName());
+    ActionsDAG::NodeRawConstPtrs conditions;
+    for (size_t i = 0; i < clause.key_names_right.size(); ++i)
+    {
+        // The right keys are the deduplicated names of the build columns, unless cast to the type of the left keys.
+        auto it = std::find(joined_names.begin(), joined_names.end(), clause.key_names_right[i]);
+        const auto * probe_key = header.findByName(clause.key_names_left[i]);
+        if (it == joined_names.end() || !probe_key)
+            continue;
+        const auto & build_key = build_header.getByPosition(it - joined_names.begin());
+        auto type = removeNullable(build_key.type);
+        if (!removeNullable(probe_key->type)->equals(*type))
+            continue;
+        auto range = storage_join.getKeyRange(build_key.name);
+        if (!range)
+            continue;
+        const auto * key_node = &actions_dag->findInOutputs(probe_key->name);
+        const auto * min_node = &actions_dag->addColumn(
+            ColumnWithTypeAndName(type->createColumnConst(1, range->first), type, getUniqueName(toString(range->first))));
+        const auto * max_node = &actions_dag->addColumn(
+            ColumnWithTypeAndName(type->createColumnConst(1, range->second), type, getUniqueName(toString(range->second))));
+        conditions.emplace_back(toFunctionNode(actions_dag, "greaterOrEquals", {key_node, min_node}));
+        conditions.emplace_back(toFunctionNode(actions_dag, "lessOrEquals", {key_node, max_node}));
+    }
+    if (conditions.empty())
+        return;
+    const auto * filter_node = toFunctionNode(actions_dag, "and", conditions);
+    actions_dag->addOrReplaceInOutputs(*filter_node);
+    auto filter_step = std::make_unique<FilterStep>(probe.getCurrentDataStream(), actions_dag, filter_node->result_name, true);
+    filter_step->setStepDescription("Build Key Range Filter");
+    steps.emplace_back(filter_step.get());
+    probe.addStep(std::move(filter_step));
+}
+
 void SerializedPlanParser::parseJoinKeysAndCondition(
     std::shared_ptr<TableJoin> table_join,
     substrait::JoinRel & join,
@@ -2518,7 +2920,22 @@ LocalExecutor::~LocalExecutor()
 
 void LocalExecutor::execute(QueryPlanPtr query_plan)
 {
+    /// Before the pipeline allocates, so that its pages are faulted in on the node of the task thread.
+    if (context->getConfigRef().getBool("numa.bind_task", false))
+        numa_binding = NumaTaskBinding::bindCurrentThread();
     current_query_plan = std::move(query_plan);
+    header = current_query_plan->getCurrentDataStream().header.cloneEmpty();
+    ch_column_to_spark_row = std::make_unique<CHColumnToSparkRow>();
+    if (result_cache)
+    {
+        if (auto entry = result_cache->get(result_cache_key))
+        {
+            LOG_DEBUG(&Poco::Logger::get("LocalExecutor"), "Replaying the output of the plan from the result cache");
+            result_reader = std::make_unique<FragmentResultReader>(std::move(entry));
+            return;
+        }
+        result_writer = std::make_unique<FragmentResultWriter>(*result_cache, result_cache_key);
+    }
     Stopwatch stopwatch;
     stopwatch.start();
     QueryPlanOptimizationSettings optimization_settings{.optimize_plan = false};
@@ -2560,9 +2977,26 @@ void LocalExecutor::execute(QueryPlanPtr query_plan)
         "build pipeline {} ms; create executor {} ms;",
         t_pipeline / 1000.0,
         t_executor / 1000.0);
-    header = current_query_plan->getCurrentDataStream().header.cloneEmpty();
-    ch_column_to_spark_row = std::make_unique<CHColumnToSparkRow>();
 }
+
+bool LocalExecutor::pull(Block & block)
+{
+    if (result_reader)
+    {
+        block = result_reader->read();
+        return block.columns() > 0;
+    }
+    if (!executor->pull(block))
+    {
+        if (result_writer)
+            result_writer->finish();
+        return false;
+    }
+    if (result_writer)
+        result_writer->write(block);
+    return true;
+}
+
 std::unique_ptr<SparkRowInfo> LocalExecutor::writeBlockToSparkRow(Block & block)
 {
     return ch_column_to_spark_row->convertCHColumnToSparkRow(block);
@@ -2577,7 +3011,9 @@ bool LocalExecutor::hasNext()
         {
             auto empty_block = header.cloneEmpty();
             setCurrentBlock(empty_block);
-            has_next = executor->pull(currentBlock());
+            Stopwatch pull_watch;
+            has_next = pull(currentBlock());
+            pull_latency.record(pull_watch.elapsedNanoseconds());
             if (!has_next)
             {
                 has_next = checkAndSetDefaultBlock(columns, has_next);
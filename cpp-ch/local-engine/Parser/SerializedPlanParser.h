@@ -33,12 +33,17 @@
 #include <Storages/IStorage.h>
 #include <Storages/SourceFromJavaIter.h>
 #include <arrow/ipc/writer.h>
+#include <jni/ReservationListenerWrapper.h>
 #include <base/types.h>
 #include <substrait/plan.pb.h>
 #include <Common/BlockIterator.h>
+#include <Common/FragmentResultCache.h>
+#include <Common/LatencyHistogram.h>
+#include <Common/NumaBinding.h>
 
 namespace local_engine
 {
+class StorageJoinFromReadBuffer;
 
 static const std::map<std::string, std::string> SCALAR_FUNCTIONS
     = {{"is_not_null", "isNotNull"},
@@ -290,11 +295,24 @@ public:
 
     static std::string getFunctionName(const std::string & function_sig, const substrait::Expression_ScalarFunction & function);
 
+    /// The literal second arguments of the calls of function_name on arg to compute at once, null if not merged.
+    const std::vector<std::string> * tryGetLiteralArgsToMerge(const std::string & function_name, const substrait::Expression & arg) const
+    {
+        auto it = literal_args_to_merge.find(function_name + '\0' + arg.SerializeAsString());
+        return it == literal_args_to_merge.end() ? nullptr : &it->second;
+    }
+
     static ContextMutablePtr global_context;
     static Context::ConfigurationPtr config;
     static SharedContextHolder shared_context;
     QueryContext query_context;
     std::vector<QueryPlanPtr> extra_plan_holder;
+    /// The files the plan reads, and whether it reads nothing else, so that its output is told by the plan and the
+    /// files, see FragmentResultCache.
+    std::vector<FragmentResultCache::File> read_files;
+    bool reads_only_files = true;
+    /// Whether the plan calls functions like rand whose results differ between runs, so that its output isn't cached.
+    bool has_nondeterministic_functions = false;
 
 private:
     static DB::NamesAndTypesList blockToNameAndTypeList(const DB::Block & header);
@@ -311,6 +329,23 @@ private:
         Names & names,
         std::vector<IQueryPlanStep *>& steps);
 
+    /// Joins by a nested loop over the broadcast build side without join keys, evaluating the join condition and the
+    /// post join filter over the pairs.
+    DB::QueryPlanPtr parseNestedLoopJoin(
+        substrait::JoinRel & join,
+        DB::QueryPlanPtr left,
+        DB::QueryPlanPtr right,
+        const StorageJoinFromReadBuffer & storage_join,
+        const DB::TableJoin & table_join,
+        std::vector<IQueryPlanStep *> & steps);
+
+    /// Filters the probe side of a broadcast join by the range of each build key, which the scan below can use to
+    /// skip row groups and stripes.
+    void addBuildKeyRangeFilter(
+        DB::QueryPlan & probe,
+        const StorageJoinFromReadBuffer & storage_join,
+        const DB::TableJoin & table_join,
+        std::vector<IQueryPlanStep *> & steps);
     static void reorderJoinOutput(DB::QueryPlan & plan, DB::Names cols);
     DB::ActionsDAGPtr parseFunction(
         const Block & header,
@@ -332,6 +367,8 @@ private:
         DB::ActionsDAGPtr actions_dag = nullptr,
         bool keep_result = false,
         bool position = false);
+    /// Groups the literal second arguments of the mergeable calls on the same argument within expr into literal_args_to_merge.
+    void collectCallsToMerge(const substrait::Expression & expr);
     bool convertBinaryArithmeticFunDecimalArgs(
         ActionsDAGPtr actions_dag,
         ActionsDAG::NodeRawConstPtrs & args,
@@ -341,6 +378,15 @@ private:
         std::string & result_name,
         DB::ActionsDAGPtr actions_dag = nullptr,
         bool keep_result = false);
+    const ActionsDAG::Node * parseFunctionWithDAGImpl(
+        const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag, bool keep_result);
+    /// The temporary data on disk of an aggregation or sort of the relation being parsed, reported by its metric. Null
+    /// if the context has no temporary storage.
+    TemporaryDataOnDiskScopePtr createSpillScope();
+    /// Whether the columns of the nodes under node are the same each time they are computed on the same input.
+    static bool isDeterministicSubtree(const ActionsDAG::Node * node);
+    /// The conjuncts of the top level and of the filter each over the input, if there are several and all are deterministic.
+    static std::vector<ActionsDAGPtr> splitFilterConjuncts(const ActionsDAG & actions_dag, const String & filter_name);
     ActionsDAG::NodeRawConstPtrs parseArrayJoinWithDAG(
         const substrait::Expression & rel,
         std::vector<String> & result_name,
@@ -372,11 +418,24 @@ private:
     void wrapNullable(std::vector<String> columns, ActionsDAGPtr actionsDag, std::map<std::string, std::string> & nullable_measure_names);
 
     IQueryPlanStep * addRemoveNullableStep(QueryPlan & plan, std::vector<String> columns);
+    /// The columns leaving the native engine are of the types Spark knows.
+    static void removeLowCardinality(QueryPlan & plan);
 
     static std::pair<DB::DataTypePtr, DB::Field> convertStructFieldType(const DB::DataTypePtr & type, const DB::Field & field);
 
     int name_no = 0;
     std::unordered_map<std::string, std::string> function_mapping;
+    /// The distinct literal second arguments of the get_json_object or parse_url calls of a projection on each first
+    /// argument, keyed by the function name and the serialized first argument, if more than one. The calls on the same
+    /// argument are computed by a single function, which parses it once.
+    std::unordered_map<std::string, std::vector<std::string>> literal_args_to_merge;
+    /// The nodes of the deterministic scalar functions parsed into cse_actions_dag, keyed by the serialized expression,
+    /// which the repeated occurrences of the same expression in a projection reuse instead of computing it again.
+    ActionsDAGPtr cse_actions_dag;
+    std::unordered_map<std::string, const ActionsDAG::Node *> cse_nodes;
+    /// Number of the expressions reused from cse_nodes since the last relation parsed, reported by its metric.
+    size_t eliminated_expressions = 0;
+    std::vector<TemporaryDataOnDiskScopePtr> spill_scopes;
     std::vector<jobject> input_iters;
     ContextPtr context;
     // for parse rel node, collect steps from a rel node
@@ -409,11 +468,24 @@ public:
     {
         extra_plan_holder = std::move(extra_plan_holder_);
     }
+    /// The listener of the allocator of the task, whose JNI calls are reported with the metrics.
+    const ReservationListenerWrapperPtr & getReservationListener() const { return reservation_listener; }
+    void setReservationListener(ReservationListenerWrapperPtr reservation_listener_) { reservation_listener = std::move(reservation_listener_); }
+    /// The time of each pull of a block from the pipeline, reported as percentiles with the metrics.
+    const LatencyHistogram & getPullLatency() const { return pull_latency; }
+    /// The output is replayed from the cache if there, else set in it once done. Before execute().
+    void setResultCache(FragmentResultCache & cache, FragmentResultCache::Key key)
+    {
+        result_cache = &cache;
+        result_cache_key = key;
+    }
 
 private:
     QueryContext query_context;
     std::unique_ptr<SparkRowInfo> writeBlockToSparkRow(DB::Block & block);
     bool checkAndSetDefaultBlock(size_t current_block_columns, bool has_next_blocks);
+    /// From the pipeline, or the result cache on a hit.
+    bool pull(Block & block);
     QueryPipeline query_pipeline;
     std::unique_ptr<PullingPipelineExecutor> executor;
     Block header;
@@ -424,6 +496,13 @@ private:
     DB::QueryPlanPtr current_query_plan;
     RelMetricPtr metric;
     std::vector<QueryPlanPtr> extra_plan_holder;
+    ReservationListenerWrapperPtr reservation_listener;
+    LatencyHistogram pull_latency;
+    std::shared_ptr<NumaTaskBinding> numa_binding;
+    FragmentResultCache * result_cache = nullptr;
+    FragmentResultCache::Key result_cache_key;
+    std::unique_ptr<FragmentResultReader> result_reader;
+    std::unique_ptr<FragmentResultWriter> result_writer;
 };
 
 
@@ -39,15 +39,56 @@ SortRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, st
 {
     size_t limit = parseLimit(rel_stack_);
     const auto & sort_rel = rel.sort();
-    auto sort_descr = parseSortDescription(sort_rel.sorts(), query_plan->getCurrentDataStream().header);
-    auto sorting_step = std::make_unique<DB::SortingStep>(
-        query_plan->getCurrentDataStream(), sort_descr, limit, SortingStep::Settings(*getContext()), false);
+    const auto & input_stream = query_plan->getCurrentDataStream();
+    auto sort_descr = parseSortDescription(sort_rel.sorts(), input_stream.header);
+    SortingStep::Settings sort_settings(*getContext());
+    sort_settings.tmp_data = createSpillScope();
+
+    /// The input may already be sorted, e.g. by a sort below a window over the same keys. Then only the rows with equal
+    /// sorted keys are sorted by the rest, and the input streams merged.
+    auto prefix_descr = getSortedPrefix(input_stream, sort_descr);
+    if (prefix_descr.size() == sort_descr.size() && input_stream.sort_scope == DB::DataStream::SortScope::Global)
+    {
+        LOG_DEBUG(&Poco::Logger::get("SortRelParser"), "Input is already sorted by {}", dumpSortDescription(sort_descr));
+        return query_plan;
+    }
+    std::unique_ptr<DB::SortingStep> sorting_step;
+    if (!prefix_descr.empty())
+    {
+        LOG_DEBUG(
+            &Poco::Logger::get("SortRelParser"),
+            "Input is sorted by {}, finishing sorting by {}",
+            dumpSortDescription(prefix_descr),
+            dumpSortDescription(sort_descr));
+        sorting_step = std::make_unique<DB::SortingStep>(input_stream, prefix_descr, sort_descr, sort_settings.max_block_size, limit);
+    }
+    else
+        sorting_step = std::make_unique<DB::SortingStep>(input_stream, sort_descr, limit, sort_settings, false);
     sorting_step->setStepDescription("Sorting step");
     steps.emplace_back(sorting_step.get());
     query_plan->addStep(std::move(sorting_step));
     return query_plan;
 }
 
+DB::SortDescription SortRelParser::getSortedPrefix(const DB::DataStream & input_stream, const DB::SortDescription & sort_descr)
+{
+    /// Sorted chunks alone don't help, each stream must be sorted for its streams to be merged.
+    DB::SortDescription prefix_descr;
+    if (input_stream.sort_scope < DB::DataStream::SortScope::Stream)
+        return prefix_descr;
+    const auto & sorted_descr = input_stream.sort_description;
+    for (size_t i = 0; i < std::min(sorted_descr.size(), sort_descr.size()); ++i)
+    {
+        const auto & sorted = sorted_descr[i];
+        const auto & wanted = sort_descr[i];
+        if (sorted.column_name != wanted.column_name || sorted.direction != wanted.direction
+            || sorted.nulls_direction != wanted.nulls_direction || sorted.collator || wanted.collator)
+            break;
+        prefix_descr.push_back(wanted);
+    }
+    return prefix_descr;
+}
+
 DB::SortDescription
 SortRelParser::parseSortDescription(const google::protobuf::RepeatedPtrField<substrait::SortField> & sort_fields, const DB::Block & header)
 {
@@ -18,6 +18,7 @@
 #include <Core/Block.h>
 #include <Core/SortDescription.h>
 #include <Parser/RelParser.h>
+#include <Processors/QueryPlan/IQueryPlanStep.h>
 #include <google/protobuf/repeated_field.h>
 namespace local_engine
 {
@@ -32,6 +33,10 @@ public:
     static DB::SortDescription
     parseSortDescription(const google::protobuf::RepeatedPtrField<substrait::SortField> & sort_fields, const DB::Block & header);
 
+    /// The longest prefix of the sort description the input stream is sorted by, empty unless every stream of the input
+    /// is sorted.
+    static DB::SortDescription getSortedPrefix(const DB::DataStream & input_stream, const DB::SortDescription & sort_descr);
+
 private:
     size_t parseLimit(std::list<const substrait::Rel *> & rel_stack_);
 };
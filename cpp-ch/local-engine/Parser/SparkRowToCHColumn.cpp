@@ -16,8 +16,11 @@
  */
 #include "SparkRowToCHColumn.h"
 #include <memory>
+#include <Columns/ColumnArray.h>
+#include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnString.h>
+#include <Columns/ColumnTuple.h>
 #include <Columns/ColumnVector.h>
 #include <Core/ColumnsWithTypeAndName.h>
 #include <DataTypes/DataTypeArray.h>
@@ -29,6 +32,8 @@
 #include <Functions/FunctionHelpers.h>
 #include <Common/CHUtil.h>
 #include <Common/Exception.h>
+#include <Common/assert_cast.h>
+#include <Common/typeid_cast.h>
 
 namespace DB
 {
@@ -54,18 +59,74 @@ ALWAYS_INLINE static void writeRowToColumns(std::vector<MutableColumnPtr> & colu
 
     for (size_t i = 0; i < num_fields; i++)
     {
-        if (spark_row_reader.supportRawData(i))
+        if (spark_row_reader.supportRawData(i) && !spark_row_reader.isBigEndianInSparkRow(i))
         {
             const StringRef str_ref{spark_row_reader.getStringRef(i)};
             if (str_ref.data == nullptr)
                 columns[i]->insertData(nullptr, str_ref.size);
-            else if (!spark_row_reader.isBigEndianInSparkRow(i))
-                columns[i]->insertData(str_ref.data, str_ref.size);
             else
-                columns[i]->insert(spark_row_reader.getField(i)); // read decimal128
+                columns[i]->insertData(str_ref.data, str_ref.size);
         }
+        else if (spark_row_reader.isNullAt(i))
+            columns[i]->insertDefault();
         else
-            columns[i]->insert(spark_row_reader.getField(i));
+        {
+            /// decimal128, array, map and struct
+            const StringRef data = spark_row_reader.getString(i);
+            spark_row_reader.getVariableLengthDataReader(i)->readInto(data.data, data.size, *columns[i]);
+        }
+    }
+}
+
+/// Reserves columns for num_rows more rows, with the bytes of their strings and the elements of their arrays and maps
+/// summed over the rows by a first pass. point_to(row) points row_reader to the row-th row.
+template <typename PointTo>
+static void reserveColumns(MutableColumns & columns, SparkRowReader & row_reader, size_t num_rows, PointTo && point_to)
+{
+    std::vector<std::pair<size_t, WhichDataType>> nested_ordinals;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        columns[i]->reserve(columns[i]->size() + num_rows);
+        const WhichDataType which(removeNullable(row_reader.getFieldTypes()[i]));
+        if (which.isString() || which.isArray() || which.isMap())
+            nested_ordinals.emplace_back(i, which);
+    }
+    if (nested_ordinals.empty())
+        return;
+
+    std::vector<size_t> nested_sizes(columns.size(), 0);
+    for (size_t row = 0; row < num_rows; ++row)
+    {
+        point_to(row);
+        for (const auto & [i, which] : nested_ordinals)
+        {
+            if (row_reader.isNullAt(i))
+                continue;
+            const StringRef data = row_reader.getString(i);
+            /// Strings are stored with a terminating zero. The number of elements of the array of keys is after its length in a map.
+            const size_t num_elems_pos = which.isMap() ? 8 : 0;
+            if (which.isString())
+                nested_sizes[i] += data.size + 1;
+            else if (data.size >= num_elems_pos + 8)
+            {
+                int64_t num_elems = 0;
+                memcpy(&num_elems, data.data + num_elems_pos, 8);
+                nested_sizes[i] += num_elems;
+            }
+        }
+    }
+
+    for (const auto & [i, which] : nested_ordinals)
+    {
+        IColumn * column = columns[i].get();
+        if (auto * nullable_column = typeid_cast<ColumnNullable *>(column))
+            column = &nullable_column->getNestedColumn();
+        if (auto * string_column = typeid_cast<ColumnString *>(column))
+            string_column->getChars().reserve(string_column->getChars().size() + nested_sizes[i]);
+        else if (auto * array_column = typeid_cast<ColumnArray *>(column))
+            array_column->getData().reserve(array_column->getData().size() + nested_sizes[i]);
+        else if (auto * map_column = typeid_cast<ColumnMap *>(column))
+            map_column->getNestedData().reserve(map_column->getNestedData().size() + nested_sizes[i]);
     }
 }
 
@@ -77,15 +138,17 @@ std::unique_ptr<Block> SparkRowToCHColumn::convertSparkRowInfoToCHColumn(const S
     {
         *block = header.cloneEmpty();
         MutableColumns mutable_columns{block->mutateColumns()};
-        for (size_t col_i = 0; col_i < header.columns(); ++col_i)
-            mutable_columns[col_i]->reserve(num_rows);
-
         DataTypes types{header.getDataTypes()};
         SparkRowReader row_reader(types);
+        auto point_to = [&](size_t i)
+        {
+            row_reader.pointTo(
+                spark_row_info.getBufferAddress() + spark_row_info.getOffsets()[i], static_cast<int32_t>(spark_row_info.getLengths()[i]));
+        };
+        reserveColumns(mutable_columns, row_reader, num_rows, point_to);
         for (int64_t i = 0; i < num_rows; i++)
         {
-            row_reader.pointTo(spark_row_info.getBufferAddress() + spark_row_info.getOffsets()[i],
-                               static_cast<int32_t>(spark_row_info.getLengths()[i]));
+            point_to(i);
             writeRowToColumns(mutable_columns, row_reader);
         }
         block->setColumns(std::move(mutable_columns));
@@ -98,12 +161,31 @@ std::unique_ptr<Block> SparkRowToCHColumn::convertSparkRowInfoToCHColumn(const S
     return block;
 }
 
-void SparkRowToCHColumn::appendSparkRowToCHColumn(SparkRowToCHColumnHelper & helper, char * buffer, int32_t length)
+void SparkRowToCHColumn::appendSparkRowsToCHColumn(SparkRowToCHColumnHelper & helper, char * rows_buf_ptr)
 {
-    SparkRowReader row_reader(helper.data_types);
-    row_reader.pointTo(buffer, length);
-    writeRowToColumns(helper.mutable_columns, row_reader);
-    ++helper.rows;
+    // len = -1 means reaching the buf's end.
+    // len = 0 indicates no columns in the this row. e.g. count(1)/count(*)
+    std::vector<std::pair<const char *, int32_t>> rows;
+    int len = *(reinterpret_cast<int *>(rows_buf_ptr));
+    while (len >= 0)
+    {
+        rows_buf_ptr += 4;
+        rows.emplace_back(rows_buf_ptr, len);
+
+        rows_buf_ptr += len;
+        len = *(reinterpret_cast<int *>(rows_buf_ptr));
+    }
+
+    if (!helper.row_reader)
+        helper.row_reader = std::make_shared<SparkRowReader>(helper.data_types);
+    auto & row_reader = *helper.row_reader;
+    reserveColumns(helper.mutable_columns, row_reader, rows.size(), [&](size_t i) { row_reader.pointTo(rows[i].first, rows[i].second); });
+    for (const auto & [buffer, length] : rows)
+    {
+        row_reader.pointTo(buffer, length);
+        writeRowToColumns(helper.mutable_columns, row_reader);
+    }
+    helper.rows += rows.size();
 }
 
 Block * SparkRowToCHColumn::getBlock(SparkRowToCHColumnHelper & helper)
@@ -159,6 +241,167 @@ StringRef VariableLengthDataReader::readUnalignedBytes(const char * buffer, size
     return {buffer, length};
 }
 
+void VariableLengthDataReader::readInto(const char * buffer, size_t length, IColumn & column) const
+{
+    if (auto * nullable_column = typeid_cast<ColumnNullable *>(&column))
+    {
+        readInto(buffer, length, nullable_column->getNestedColumn());
+        nullable_column->getNullMapData().push_back(0);
+        return;
+    }
+
+    if (which.isStringOrFixedString())
+    {
+        column.insertData(buffer, length);
+        return;
+    }
+
+    if (which.isDecimal128())
+    {
+        assert(sizeof(Decimal128) >= length);
+        char decimal128_fix_data[sizeof(Decimal128)] = {};
+        memcpy(decimal128_fix_data + sizeof(Decimal128) - length, buffer, length); // padding
+        String buf(decimal128_fix_data, sizeof(Decimal128));
+        BackingDataLengthCalculator::swapDecimalEndianBytes(buf); // Big-endian to Little-endian
+        column.insertData(buf.data(), buf.size());
+        return;
+    }
+
+    if (which.isArray())
+    {
+        auto & array_column = assert_cast<ColumnArray &>(column);
+        const auto * array_type = typeid_cast<const DataTypeArray *>(type_without_nullable.get());
+        readArrayInto(buffer, length, array_type->getNestedType(), array_column.getData());
+        array_column.getOffsets().push_back(array_column.getData().size());
+        return;
+    }
+
+    if (which.isMap())
+    {
+        readMapInto(buffer, length, column);
+        return;
+    }
+
+    if (which.isTuple())
+    {
+        readStructInto(buffer, column);
+        return;
+    }
+
+    throw Exception(ErrorCodes::UNKNOWN_TYPE, "VariableLengthDataReader doesn't support type {}", type->getName());
+}
+
+size_t VariableLengthDataReader::readArrayInto(const char * buffer, size_t length, const DataTypePtr & nested_type, IColumn & data)
+{
+    /// Same layout as in readArray
+    int64_t num_elems = 0;
+    memcpy(&num_elems, buffer, 8);
+    if (num_elems == 0 || length == 0)
+        return 0;
+
+    const auto len_null_bitmap = calculateBitSetWidthInBytes(num_elems);
+    const auto elem_size = BackingDataLengthCalculator::getArrayElementSize(nested_type);
+    const char * values = buffer + 8 + len_null_bitmap;
+    if (BackingDataLengthCalculator::isFixedLengthDataType(removeNullable(nested_type)))
+    {
+        FixedLengthDataReader reader(nested_type);
+        for (int64_t i = 0; i < num_elems; ++i)
+        {
+            if (isBitSet(buffer + 8, i))
+                data.insertDefault();
+            else
+            {
+                const StringRef value = reader.unsafeRead(values + i * elem_size);
+                data.insertData(value.data, value.size);
+            }
+        }
+    }
+    else if (BackingDataLengthCalculator::isVariableLengthDataType(removeNullable(nested_type)))
+    {
+        VariableLengthDataReader reader(nested_type);
+        for (int64_t i = 0; i < num_elems; ++i)
+        {
+            if (isBitSet(buffer + 8, i))
+                data.insertDefault();
+            else
+            {
+                int64_t offset_and_size = 0;
+                memcpy(&offset_and_size, values + i * 8, 8);
+                const int64_t offset = BackingDataLengthCalculator::extractOffset(offset_and_size);
+                const int64_t size = BackingDataLengthCalculator::extractSize(offset_and_size);
+                reader.readInto(buffer + offset, size, data);
+            }
+        }
+    }
+    else
+        throw Exception(ErrorCodes::UNKNOWN_TYPE, "VariableLengthDataReader doesn't support type {}", nested_type->getName());
+    return num_elems;
+}
+
+void VariableLengthDataReader::readMapInto(const char * buffer, size_t length, IColumn & column) const
+{
+    /// Same layout as in readMap, keys and values are appended to the columns of the nested tuple column
+    auto & map_column = assert_cast<ColumnMap &>(column);
+    auto & pairs = map_column.getNestedData();
+    int64_t key_array_size = 0;
+    memcpy(&key_array_size, buffer, 8);
+    if (key_array_size != 0 && length != 0)
+    {
+        const auto * map_type = typeid_cast<const DataTypeMap *>(type_without_nullable.get());
+        const auto num_keys = readArrayInto(buffer + 8, key_array_size, map_type->getKeyType(), pairs.getColumn(0));
+        const auto num_values = readArrayInto(
+            buffer + 8 + key_array_size, length - 8 - key_array_size, map_type->getValueType(), pairs.getColumn(1));
+        if (num_keys != num_values)
+            throw Exception(ErrorCodes::LOGICAL_ERROR, "Key size {} not equal to value size {} in map", num_keys, num_values);
+    }
+    map_column.getNestedColumn().getOffsets().push_back(pairs.size());
+}
+
+void VariableLengthDataReader::readStructInto(const char * buffer, IColumn & column) const
+{
+    /// Same layout as in readStruct
+    auto & tuple_column = assert_cast<ColumnTuple &>(column);
+    const auto * tuple_type = typeid_cast<const DataTypeTuple *>(type_without_nullable.get());
+    const auto & field_types = tuple_type->getElements();
+    const auto num_fields = field_types.size();
+    if (num_fields == 0)
+    {
+        tuple_column.insertDefault();
+        return;
+    }
+
+    const auto len_null_bitmap = calculateBitSetWidthInBytes(num_fields);
+    for (size_t i = 0; i < num_fields; ++i)
+    {
+        const auto & field_type = field_types[i];
+        auto & field_column = tuple_column.getColumn(i);
+        if (isBitSet(buffer, i))
+        {
+            field_column.insertDefault();
+            continue;
+        }
+
+        if (BackingDataLengthCalculator::isFixedLengthDataType(removeNullable(field_type)))
+        {
+            FixedLengthDataReader reader(field_type);
+            const StringRef value = reader.unsafeRead(buffer + len_null_bitmap + i * 8);
+            field_column.insertData(value.data, value.size);
+        }
+        else if (BackingDataLengthCalculator::isVariableLengthDataType(removeNullable(field_type)))
+        {
+            int64_t offset_and_size = 0;
+            memcpy(&offset_and_size, buffer + len_null_bitmap + i * 8, 8);
+            const int64_t offset = BackingDataLengthCalculator::extractOffset(offset_and_size);
+            const int64_t size = BackingDataLengthCalculator::extractSize(offset_and_size);
+
+            VariableLengthDataReader reader(field_type);
+            reader.readInto(buffer + offset, size, field_column);
+        }
+        else
+            throw Exception(ErrorCodes::UNKNOWN_TYPE, "VariableLengthDataReader doesn't support type {}", field_type->getName());
+    }
+}
+
 Field VariableLengthDataReader::readDecimal(const char * buffer, size_t length) const
 {
     assert(sizeof(Decimal128) >= length);
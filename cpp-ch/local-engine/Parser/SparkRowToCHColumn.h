@@ -42,12 +42,16 @@ namespace local_engine
 {
 using namespace DB;
 using namespace std;
+class SparkRowReader;
+
 struct SparkRowToCHColumnHelper
 {
     DataTypes data_types;
     Block header;
     MutableColumns mutable_columns;
     UInt64 rows;
+    /// Reused by the batches of rows
+    std::shared_ptr<SparkRowReader> row_reader;
 
     SparkRowToCHColumnHelper(vector<string> & names, vector<string> & types) : data_types(names.size())
     {
@@ -103,18 +107,7 @@ public:
         {
             jobject rows_buf = safeCallObjectMethod(env, java_iter, spark_row_iterator_nextBatch);
             auto * rows_buf_ptr = static_cast<char *>(env->GetDirectBufferAddress(rows_buf));
-            int len = *(reinterpret_cast<int *>(rows_buf_ptr));
-
-            // len = -1 means reaching the buf's end.
-            // len = 0 indicates no columns in the this row. e.g. count(1)/count(*)
-            while (len >= 0)
-            {
-                rows_buf_ptr += 4;
-                appendSparkRowToCHColumn(helper, rows_buf_ptr, len);
-
-                rows_buf_ptr += len;
-                len = *(reinterpret_cast<int *>(rows_buf_ptr));
-            }
+            appendSparkRowsToCHColumn(helper, rows_buf_ptr);
 
             // Try to release reference.
             env->DeleteLocalRef(rows_buf);
@@ -129,7 +122,8 @@ public:
     }
 
 private:
-    static void appendSparkRowToCHColumn(SparkRowToCHColumnHelper & helper, char * buffer, int32_t length);
+    /// Appends the rows of a batch, each prefixed by its length
+    static void appendSparkRowsToCHColumn(SparkRowToCHColumnHelper & helper, char * rows_buf_ptr);
     static Block * getBlock(SparkRowToCHColumnHelper & helper);
 };
 
@@ -142,7 +136,15 @@ public:
     virtual Field read(const char * buffer, size_t length) const;
     virtual StringRef readUnalignedBytes(const char * buffer, size_t length) const;
 
+    /// Same as read, appending the value to column directly instead of building a Field
+    void readInto(const char * buffer, size_t length, IColumn & column) const;
+
 private:
+    /// Appends the elements of the array at buffer to data, returns the number of elements
+    static size_t readArrayInto(const char * buffer, size_t length, const DataTypePtr & nested_type, IColumn & data);
+    void readMapInto(const char * buffer, size_t length, IColumn & column) const;
+    void readStructInto(const char * buffer, IColumn & column) const;
+
     virtual Field readDecimal(const char * buffer, size_t length) const;
     virtual Field readString(const char * buffer, size_t length) const;
     virtual Field readArray(const char * buffer, size_t length) const;
@@ -211,13 +213,13 @@ public:
         return is_big_endians_in_spark_row[ordinal];
     }
 
-    std::shared_ptr<FixedLengthDataReader> getFixedLengthDataReader(int ordinal) const
+    const std::shared_ptr<FixedLengthDataReader> & getFixedLengthDataReader(int ordinal) const
     {
         assertIndexIsValid(ordinal);
         return fixed_length_data_readers[ordinal];
     }
 
-    std::shared_ptr<VariableLengthDataReader> getVariableLengthDataReader(int ordinal) const
+    const std::shared_ptr<VariableLengthDataReader> & getVariableLengthDataReader(int ordinal) const
     {
         assertIndexIsValid(ordinal);
         return variable_length_data_readers[ordinal];
@@ -23,6 +23,7 @@
 #include <Core/ColumnsWithTypeAndName.h>
 #include <Core/Names.h>
 #include <Core/SortDescription.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <DataTypes/DataTypesNumber.h>
 #include <DataTypes/IDataType.h>
 #include <AggregateFunctions/AggregateFunctionFactory.h>
@@ -139,12 +140,37 @@ std::unordered_map<DB::String, WindowDescription> WindowRelParser::parseWindowDe
         }
 
         auto win_func = parseWindowFunctionDescription(
-            win_info.function_name, win_function, win_info.arg_column_names, win_info.arg_column_types, win_info.params);
+            getSlidingFrameFunctionName(win_info, description->frame),
+            win_function,
+            win_info.arg_column_names,
+            win_info.arg_column_types,
+            win_info.params);
         description->window_functions.emplace_back(win_func);
     }
     return window_descriptions;
 }
 
+String WindowRelParser::getSlidingFrameFunctionName(const WindowInfo & win_info, const DB::WindowFrame & frame)
+{
+    /// WindowTransform computes an aggregate over the whole frame for each row once the frame start moves, these functions
+    /// only add the rows entering the frame and remove the rows leaving it.
+    static const std::unordered_map<String, String> sliding_frame_functions
+        = {{"sum", "slidingSumInFrame"}, {"count", "slidingCountInFrame"}, {"min", "slidingMinInFrame"}, {"max", "slidingMaxInFrame"}};
+
+    auto it = sliding_frame_functions.find(win_info.function_name);
+    if (it == sliding_frame_functions.end() || frame.type != DB::WindowFrame::FrameType::ROWS
+        || frame.begin_type != DB::WindowFrame::BoundaryType::Offset || win_info.arg_column_types.size() != 1)
+        return win_info.function_name;
+    if (win_info.function_name != "count")
+    {
+        /// The sum and the extremes of integers only, a float sum updated so would differ from the one computed anew.
+        DB::WhichDataType which(DB::removeNullable(win_info.arg_column_types[0]));
+        if (!which.isNativeInt() && !which.isNativeUInt())
+            return win_info.function_name;
+    }
+    return it->second;
+}
+
 DB::WindowFrame WindowRelParser::parseWindowFrame(const WindowInfo & win_info)
 {
     DB::WindowFrame win_frame;
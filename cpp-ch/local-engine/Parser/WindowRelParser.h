@@ -71,6 +71,8 @@ private:
     DB::WindowDescription
     parseWindowDescription(const WindowInfo & win_info);
     DB::WindowFrame parseWindowFrame(const WindowInfo & win_info);
+    /// The function computing win_info incrementally over the sliding frame, win_info.function_name if none.
+    static String getSlidingFrameFunctionName(const WindowInfo & win_info, const DB::WindowFrame & frame);
     DB::WindowFrame::FrameType
     parseWindowFrameType(const std::string & function_name, const substrait::Expression::WindowFunction & window_function);
     static void parseBoundType(
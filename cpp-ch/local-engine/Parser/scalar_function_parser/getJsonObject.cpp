@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Parser/FunctionParser.h>
+#include <Core/Field.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Functions/FunctionFactory.h>
+
+namespace local_engine
+{
+
+class FunctionParserGetJsonObject : public FunctionParser
+{
+public:
+    explicit FunctionParserGetJsonObject(SerializedPlanParser * plan_parser_) : FunctionParser(plan_parser_) { }
+    ~FunctionParserGetJsonObject() override = default;
+
+    static constexpr auto name = "get_json_object";
+
+    String getName() const override { return name; }
+
+    const ActionsDAG::Node * parse(
+        const substrait::Expression_ScalarFunction & substrait_func,
+        ActionsDAGPtr & actions_dag) const override
+    {
+        /*
+            parse get_json_object(json, path_i) of a projection also extracting the paths path_1, ..., path_n from json as
+            tupleElement(get_json_objects(json, path_1, ..., path_n), i)
+            the node of get_json_objects shared by all of them.
+        */
+        const auto & args = substrait_func.arguments();
+        if (args.size() != 2 || !args[1].value().has_literal() || !args[1].value().literal().has_string()
+            || !DB::FunctionFactory::instance().has("get_json_objects"))
+            return FunctionParser::parse(substrait_func, actions_dag);
+        const auto * merged_paths = plan_parser->tryGetLiteralArgsToMerge(name, args[0].value());
+        if (!merged_paths)
+            return FunctionParser::parse(substrait_func, actions_dag);
+
+        const auto & paths = *merged_paths;
+        const auto & path = args[1].value().literal().string();
+        const auto index = std::find(paths.begin(), paths.end(), path) - paths.begin();
+
+        const auto * json_node = parseExpression(actions_dag, args[0].value());
+        String result_name = "get_json_objects(" + json_node->result_name;
+        for (const auto & p : paths)
+            result_name += ", '" + p + "'";
+        result_name += ")";
+
+        const ActionsDAG::Node * tuple_node = nullptr;
+        for (const auto & node : actions_dag->getNodes())
+        {
+            if (node.type == ActionsDAG::ActionType::FUNCTION && node.result_name == result_name)
+            {
+                tuple_node = &node;
+                break;
+            }
+        }
+        if (!tuple_node)
+        {
+            ActionsDAG::NodeRawConstPtrs tuple_args{json_node};
+            for (const auto & p : paths)
+                tuple_args.push_back(addColumnToActionsDAG(actions_dag, std::make_shared<DataTypeString>(), p));
+            tuple_node = toFunctionNode(actions_dag, "get_json_objects", result_name, tuple_args);
+        }
+
+        const auto * index_node = addColumnToActionsDAG(actions_dag, std::make_shared<DataTypeUInt32>(), static_cast<UInt32>(index + 1));
+        const auto * result_node = toFunctionNode(actions_dag, "tupleElement", {tuple_node, index_node});
+        return convertNodeTypeIfNeeded(substrait_func, result_node, actions_dag);
+    }
+};
+
+static FunctionParserRegister<FunctionParserGetJsonObject> register_get_json_object;
+}
@@ -17,8 +17,11 @@
 #include "parseUrl.h"
 #include <iterator>
 #include <Common/Exception.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
 #include <DataTypes/IDataType.h>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace DB
 {
@@ -67,6 +70,7 @@ const static String CH_URL_HOST_FUNCTION = "spark_parse_url_host";
 const static String CH_URL_PARAMS_FUNCTION = "spark_parse_url_query";
 const static String CH_URL_ONE_PARAM_FUNCTION = "spark_parse_url_one_query";
 const static String CH_URL_INVALID_FUNCTION = "spark_parse_url_invalid";
+const static String CH_URL_PARTS_FUNCTION = "spark_parse_url_parts";
 String ParseURLParser::selectCHFunctionName(const substrait::Expression_ScalarFunction & substrait_func) const
 {
     auto query_part_name = getQueryPartName(substrait_func.arguments(1).value());
@@ -98,6 +102,55 @@ String ParseURLParser::selectCHFunctionName(const substrait::Expression_ScalarFu
     }
 }
 
+bool ParseURLParser::isFusablePart(const String & part)
+{
+    static const std::unordered_set<String> fusable_parts = {"HOST", "PATH", "QUERY", "REF", "FILE", "AUTHORITY", "USERINFO"};
+    return fusable_parts.contains(part);
+}
+
+const DB::ActionsDAG::Node *
+ParseURLParser::parse(const substrait::Expression_ScalarFunction & substrait_func, DB::ActionsDAGPtr & actions_dag) const
+{
+    const auto & args = substrait_func.arguments();
+    const auto * merged_parts = args.size() == 2 ? plan_parser->tryGetLiteralArgsToMerge(name, args[0].value()) : nullptr;
+    if (!merged_parts)
+        return FunctionParser::parse(substrait_func, actions_dag);
+
+    std::vector<String> parts;
+    std::copy_if(merged_parts->begin(), merged_parts->end(), std::back_inserter(parts), isFusablePart);
+    const auto part = getQueryPartName(args[1].value());
+    auto it = std::find(parts.begin(), parts.end(), part);
+    if (parts.size() < 2 || it == parts.end())
+        return FunctionParser::parse(substrait_func, actions_dag);
+
+    const auto * url_node = parseExpression(actions_dag, args[0].value());
+    String result_name = CH_URL_PARTS_FUNCTION + "(" + url_node->result_name;
+    for (const auto & p : parts)
+        result_name += ", '" + p + "'";
+    result_name += ")";
+
+    const DB::ActionsDAG::Node * tuple_node = nullptr;
+    for (const auto & node : actions_dag->getNodes())
+    {
+        if (node.type == DB::ActionsDAG::ActionType::FUNCTION && node.result_name == result_name)
+        {
+            tuple_node = &node;
+            break;
+        }
+    }
+    if (!tuple_node)
+    {
+        DB::ActionsDAG::NodeRawConstPtrs tuple_args{url_node};
+        for (const auto & p : parts)
+            tuple_args.push_back(addColumnToActionsDAG(actions_dag, std::make_shared<DB::DataTypeString>(), p));
+        tuple_node = toFunctionNode(actions_dag, CH_URL_PARTS_FUNCTION, result_name, tuple_args);
+    }
+
+    const auto * index_node
+        = addColumnToActionsDAG(actions_dag, std::make_shared<DB::DataTypeUInt32>(), static_cast<UInt32>(it - parts.begin() + 1));
+    return toFunctionNode(actions_dag, "tupleElement", {tuple_node, index_node});
+}
+
 DB::ActionsDAG::NodeRawConstPtrs ParseURLParser::parseFunctionArguments(
     const substrait::Expression_ScalarFunction & substrait_func, const String & /*ch_func_name*/, DB::ActionsDAGPtr & actions_dag) const
 {
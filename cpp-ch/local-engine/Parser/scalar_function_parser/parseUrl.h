@@ -26,6 +26,11 @@ public:
     ~ParseURLParser() override = default;
     String getName() const override { return name; }
 
+    /// parse_url(url, part_i) of a projection also extracting the parts part_1, ..., part_n from url is parsed as
+    /// tupleElement(spark_parse_url_parts(url, part_1, ..., part_n), i), the node of spark_parse_url_parts shared by all.
+    const DB::ActionsDAG::Node *
+    parse(const substrait::Expression_ScalarFunction & substrait_func, DB::ActionsDAGPtr & actions_dag) const override;
+
 protected:
     String getCHFunctionName(const substrait::Expression_ScalarFunction & substrait_func) const override;
 
@@ -42,5 +47,6 @@ protected:
 private:
     String getQueryPartName(const substrait::Expression & expr) const;
     String selectCHFunctionName(const substrait::Expression_ScalarFunction & substrait_func) const;
+    static bool isFusablePart(const String & part);
 };
 }
@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LocalDirSelector.h"
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <sys/statvfs.h>
+
+namespace local_engine
+{
+namespace
+{
+constexpr auto FREE_BYTES_REFRESH_INTERVAL = std::chrono::seconds(1);
+constexpr auto BACKOFF = std::chrono::seconds(10);
+/// Space left free on a dir beyond the bytes being written to it.
+constexpr Int64 MIN_FREE_BYTES = 64 << 20;
+/// Smaller writes are dominated by the syscall latency and not measured.
+constexpr size_t MIN_MEASURED_BYTES = 1 << 20;
+constexpr double COST_SMOOTHING = 0.2;
+/// A write this many times slower per byte than on the fastest dir backs its dir off.
+constexpr double SLOW_FACTOR = 8;
+}
+
+LocalDirSelector & LocalDirSelector::instance()
+{
+    static LocalDirSelector selector;
+    return selector;
+}
+
+size_t LocalDirSelector::select(const std::vector<std::string> & dirs, size_t expected_bytes)
+{
+    if (dirs.size() <= 1)
+        return 0;
+    std::lock_guard lock(mutex);
+    auto now = Clock::now();
+    Int64 expected = std::max<Int64>(expected_bytes, 1);
+
+    /// Unmeasured dirs are taken as fast as the fastest measured one, so that they get measured.
+    double fastest = 0;
+    for (const auto & dir : dirs)
+    {
+        auto cost = states[dir].ns_per_byte;
+        if (cost > 0 && (fastest == 0 || cost < fastest))
+            fastest = cost;
+    }
+
+    size_t start = next_start++ % dirs.size();
+    std::optional<size_t> selected;
+    double selected_score = 0;
+    for (size_t i = 0; i < dirs.size(); ++i)
+    {
+        size_t index = (start + i) % dirs.size();
+        auto & state = states[dirs[index]];
+        if (state.backoff_until > now)
+            continue;
+        refreshFreeBytes(dirs[index], state, now);
+        if (state.free_bytes - state.outstanding_bytes < expected + MIN_FREE_BYTES)
+            continue;
+        double cost = state.ns_per_byte > 0 ? state.ns_per_byte : (fastest > 0 ? fastest : 1);
+        double score = static_cast<double>(state.outstanding_bytes + expected) * cost;
+        if (!selected || score < selected_score)
+        {
+            selected = index;
+            selected_score = score;
+        }
+    }
+    /// Every dir is backed off or full, fall back to round robin and let the write report the error.
+    return selected.value_or(start);
+}
+
+void LocalDirSelector::beginWrite(const std::string & dir, size_t bytes)
+{
+    std::lock_guard lock(mutex);
+    states[dir].outstanding_bytes += bytes;
+}
+
+void LocalDirSelector::endWrite(const std::string & dir, size_t bytes, UInt64 elapsed_ns, bool ok)
+{
+    std::lock_guard lock(mutex);
+    auto now = Clock::now();
+    auto & state = states[dir];
+    state.outstanding_bytes -= bytes;
+    if (!ok)
+    {
+        state.backoff_until = now + BACKOFF;
+        return;
+    }
+    if (bytes < MIN_MEASURED_BYTES)
+        return;
+    double cost = static_cast<double>(std::max<UInt64>(elapsed_ns, 1)) / bytes;
+    state.ns_per_byte = state.ns_per_byte == 0 ? cost : (1 - COST_SMOOTHING) * state.ns_per_byte + COST_SMOOTHING * cost;
+
+    double fastest = 0;
+    for (const auto & [other, other_state] : states)
+        if (other != dir && other_state.ns_per_byte > 0 && (fastest == 0 || other_state.ns_per_byte < fastest))
+            fastest = other_state.ns_per_byte;
+    if (fastest > 0 && cost > SLOW_FACTOR * fastest)
+        state.backoff_until = now + BACKOFF;
+}
+
+void LocalDirSelector::refreshFreeBytes(const std::string & dir, DirState & state, Clock::time_point now)
+{
+    if (state.free_bytes_checked_at != Clock::time_point{} && now - state.free_bytes_checked_at < FREE_BYTES_REFRESH_INTERVAL)
+        return;
+    struct statvfs stat;
+    if (::statvfs(dir.c_str(), &stat) == 0)
+        state.free_bytes = static_cast<Int64>(stat.f_bavail) * static_cast<Int64>(stat.f_frsize);
+    else
+        /// Not created yet or not a local file system, leave it to the write.
+        state.free_bytes = std::numeric_limits<Int64>::max() / 2;
+    state.free_bytes_checked_at = now;
+}
+}
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <chrono>
+#include <base/types.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace local_engine
+{
+/// Executor wide load tracking of the local dirs shuffle spills are written to. A dir is picked by the bytes being
+/// written to it, its measured write cost per byte and its free space. Dirs whose writes failed or crawled are
+/// skipped for a while.
+class LocalDirSelector
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static LocalDirSelector & instance();
+
+    /// Index of the dir in dirs to write expected_bytes to next.
+    size_t select(const std::vector<std::string> & dirs, size_t expected_bytes);
+
+    /// Brackets a write of bytes to a file under dir.
+    void beginWrite(const std::string & dir, size_t bytes);
+    void endWrite(const std::string & dir, size_t bytes, UInt64 elapsed_ns, bool ok);
+
+private:
+    struct DirState
+    {
+        Int64 outstanding_bytes = 0;
+        /// Exponential moving average of the write time per byte, 0 until a write is measured.
+        double ns_per_byte = 0;
+        Int64 free_bytes = 0;
+        Clock::time_point free_bytes_checked_at{};
+        Clock::time_point backoff_until{};
+    };
+
+    void refreshFreeBytes(const std::string & dir, DirState & state, Clock::time_point now);
+
+    std::mutex mutex;
+    std::unordered_map<std::string, DirState> states;
+    /// Rotates the start of the scan so that equally loaded dirs are taken in turn.
+    size_t next_start = 0;
+};
+}
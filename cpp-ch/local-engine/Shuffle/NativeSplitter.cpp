@@ -67,6 +67,7 @@ void NativeSplitter::split(DB::Block & block)
     DB::Block out_block;
     for (size_t col = 0; col < output_header.columns(); ++col)
     {
+        // Constant columns stay constant, appendSelective repeats their value.
         out_block.insert(block.getByPosition(output_columns_indicies[col]));
     }
     for (size_t col = 0; col < output_header.columns(); ++col)
@@ -85,7 +86,7 @@ void NativeSplitter::split(DB::Block & block)
     {
         if (partition_buffer[i]->size() >= options.buffer_size)
         {
-            output_buffer.emplace(std::pair(i, std::make_unique<Block>(partition_buffer[i]->releaseColumns())));
+            output_buffer.emplace_back(i, std::make_unique<Block>(partition_buffer[i]->releaseColumns()));
         }
     }
 }
@@ -95,6 +96,7 @@ NativeSplitter::NativeSplitter(Options options_, jobject input_) : options(optio
     GET_JNIENV(env)
     input = env->NewGlobalRef(input_);
     partition_buffer.reserve(options.partition_nums);
+    output_buffer.reserve(options.partition_nums);
     for (size_t i = 0; i < options.partition_nums; ++i)
     {
         partition_buffer.emplace_back(std::make_shared<ColumnsBuffer>(options.buffer_size));
@@ -109,8 +111,12 @@ NativeSplitter::~NativeSplitter()
     CLEAN_JNIENV
 }
 
-bool NativeSplitter::hasNext()
+const NativeSplitter::OutputBlocks & NativeSplitter::nextBatch()
 {
+    /// The blocks of the last batch were consumed, their partitions accumulate again into their columns.
+    for (auto & [partition_id, block] : output_buffer)
+        partition_buffer[partition_id]->recycleColumns(std::move(*block));
+    output_buffer.clear();
     while (output_buffer.empty())
     {
         if (inputHasNext())
@@ -124,34 +130,13 @@ bool NativeSplitter::hasNext()
                 auto buffer = partition_buffer.at(i);
                 if (buffer->size() > 0)
                 {
-                    output_buffer.emplace(std::pair(i, new Block(buffer->releaseColumns())));
+                    output_buffer.emplace_back(i, std::make_unique<Block>(buffer->releaseColumns()));
                 }
             }
             break;
         }
     }
-    if (!output_buffer.empty())
-    {
-        next_partition_id = output_buffer.top().first;
-        setCurrentBlock(*output_buffer.top().second);
-        produce();
-    }
-    return !output_buffer.empty();
-}
-
-DB::Block * NativeSplitter::next()
-{
-    if (!output_buffer.empty())
-    {
-        output_buffer.pop();
-    }
-    consume();
-    return &currentBlock();
-}
-
-int32_t NativeSplitter::nextPartitionId()
-{
-    return next_partition_id;
+    return output_buffer;
 }
 
 bool NativeSplitter::inputHasNext()
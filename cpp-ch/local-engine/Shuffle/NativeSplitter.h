@@ -17,7 +17,7 @@
 #pragma once
 #include <memory>
 #include <mutex>
-#include <stack>
+#include <vector>
 #include <jni.h>
 #include <Core/ColumnWithTypeAndName.h>
 #include <Core/Defines.h>
@@ -28,11 +28,10 @@
 #include <Shuffle/SelectorBuilder.h>
 #include <Shuffle/ShuffleSplitter.h>
 #include <base/types.h>
-#include <Common/BlockIterator.h>
 
 namespace local_engine
 {
-class NativeSplitter : BlockIterator
+class NativeSplitter
 {
 public:
     struct Options
@@ -53,10 +52,12 @@ public:
     static jmethodID iterator_next;
     static std::unique_ptr<NativeSplitter> create(const std::string & short_name, Options options, jobject input);
 
+    using OutputBlocks = std::vector<std::pair<int32_t, std::unique_ptr<DB::Block>>>;
+
     NativeSplitter(Options options, jobject input);
-    bool hasNext();
-    DB::Block * next();
-    int32_t nextPartitionId();
+    /// The blocks of the partitions filled up by the next input blocks, or of all partitions left once the input ends,
+    /// with their partition ids. At most one per partition, empty at the end. Valid until the next call.
+    const OutputBlocks & nextBatch();
 
 
     virtual ~NativeSplitter();
@@ -75,8 +76,7 @@ private:
 
 
     std::vector<std::shared_ptr<ColumnsBuffer>> partition_buffer;
-    std::stack<std::pair<int32_t, std::unique_ptr<DB::Block>>> output_buffer;
-    int32_t next_partition_id = -1;
+    OutputBlocks output_buffer;
     jobject input;
 };
 
@@ -15,9 +15,13 @@
  * limitations under the License.
  */
 #include "SelectorBuilder.h"
+#include <functional>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <string_view>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <Functions/FunctionFactory.h>
 #include <Parser/SerializedPlanParser.h>
 #include <Parser/TypeParser.h>
@@ -29,6 +33,7 @@
 #include <Poco/MemoryStream.h>
 #include <Poco/StreamCopier.h>
 #include <Common/Exception.h>
+#include <Common/typeid_cast.h>
 
 namespace DB
 {
@@ -41,26 +46,33 @@ namespace local_engine
 {
 PartitionInfo PartitionInfo::fromSelector(DB::IColumn::Selector selector, size_t partition_num)
 {
-    auto rows = selector.size();
-    std::vector<size_t> partition_row_idx_start_points(partition_num + 1, 0);
-    IColumn::Selector partition_selector(rows, 0);
-    for (size_t i = 0; i < rows; ++i)
+    std::vector<size_t> partition_rows(partition_num, 0);
+    for (auto partition_id : selector)
     {
-        partition_row_idx_start_points[selector[i]]++;
+        partition_rows[partition_id]++;
     }
+    return fromSelector(selector, std::move(partition_rows));
+}
 
-    for (size_t i = 1; i <= partition_num; ++i)
+PartitionInfo PartitionInfo::fromSelector(const DB::IColumn::Selector & selector, std::vector<size_t> && partition_rows)
+{
+    auto rows = selector.size();
+    auto partition_num = partition_rows.size();
+    std::vector<size_t> partition_row_idx_start_points(partition_num + 1, 0);
+    for (size_t i = 0; i < partition_num; ++i)
     {
-        partition_row_idx_start_points[i] += partition_row_idx_start_points[i - 1];
+        partition_row_idx_start_points[i + 1] = partition_row_idx_start_points[i] + partition_rows[i];
     }
-    for (size_t i = rows; i-- > 0;)
+    // Reused as the next position of each partition.
+    std::copy(partition_row_idx_start_points.begin(), partition_row_idx_start_points.end() - 1, partition_rows.begin());
+    IColumn::Selector partition_selector(rows, 0);
+    for (size_t i = 0; i < rows; ++i)
     {
-        partition_selector[partition_row_idx_start_points[selector[i]] - 1] = i;
-        partition_row_idx_start_points[selector[i]]--;
+        partition_selector[partition_rows[selector[i]]++] = i;
     }
     return PartitionInfo{
         .partition_selector = std::move(partition_selector),
-        .partition_start_points = partition_row_idx_start_points,
+        .partition_start_points = std::move(partition_row_idx_start_points),
         .partition_num = partition_num};
 }
 
@@ -78,7 +90,10 @@ PartitionInfo RoundRobinSelectorBuilder::build(DB::Block & block)
 
 HashSelectorBuilder::HashSelectorBuilder(
     UInt32 parts_num_, const std::vector<size_t> & exprs_index_, const std::string & hash_function_name_)
-    : parts_num(parts_num_), exprs_index(exprs_index_), hash_function_name(hash_function_name_)
+    : parts_num(parts_num_)
+    , modulo_magic(~static_cast<unsigned __int128>(0) / parts_num_ + 1)
+    , exprs_index(exprs_index_)
+    , hash_function_name(hash_function_name_)
 {
 }
 
@@ -98,16 +113,32 @@ PartitionInfo HashSelectorBuilder::build(DB::Block & block)
 
         hash_function = function->build(args);
     }
-    DB::IColumn::Selector partition_ids;
-    partition_ids.reserve(rows);
     auto result_type = hash_function->getResultType();
     auto hash_column = hash_function->execute(args, result_type, rows, false);
 
-    for (size_t i = 0; i < block.rows(); i++)
+    // The partition ids and their counts in one pass over the hashes.
+    DB::IColumn::Selector partition_ids(rows);
+    std::vector<size_t> partition_rows(parts_num, 0);
+    if (const auto * hashes = typeid_cast<const DB::ColumnUInt64 *>(hash_column.get()))
     {
-        partition_ids.emplace_back(static_cast<UInt64>(hash_column->get64(i) % parts_num));
+        const auto & data = hashes->getData();
+        for (size_t i = 0; i < rows; i++)
+        {
+            auto partition_id = modulo(data[i]);
+            partition_ids[i] = partition_id;
+            partition_rows[partition_id]++;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < rows; i++)
+        {
+            auto partition_id = modulo(hash_column->get64(i));
+            partition_ids[i] = partition_id;
+            partition_rows[partition_id]++;
+        }
     }
-    return PartitionInfo::fromSelector(std::move(partition_ids), parts_num);
+    return PartitionInfo::fromSelector(partition_ids, std::move(partition_rows));
 }
 
 
@@ -250,6 +281,13 @@ void RangeSelectorBuilder::initRangeBlock(Poco::JSON::Array::Ptr range_bounds)
         columns.emplace_back(std::move(col), data_type, col_name);
     }
     range_bounds_block = DB::Block(columns);
+
+    auto bound_columns = range_bounds_block.getColumns();
+    if (std::all_of(bound_columns.begin(), bound_columns.end(), [](const auto & column) { return SortKeyEncoder::isSupported(*column); }))
+    {
+        encoded_bounds = std::make_unique<SortKeyEncoder>(sort_descriptions);
+        encoded_bounds->encode(bound_columns, range_bounds_block.rows());
+    }
 }
 
 void RangeSelectorBuilder::initActionsDAG(const DB::Block & block)
@@ -271,7 +309,82 @@ void RangeSelectorBuilder::initActionsDAG(const DB::Block & block)
     has_init_actions_dag = true;
 }
 
+namespace
+{
+/// The lower bound of each value among the sorted bounds, by the branchless binary search of Khuong and Morin. The
+/// steps only depend on the number of bounds, so a batch of rows is searched in lockstep.
+template <typename T, typename Less>
+void searchBounds(const T * bounds, size_t num_bounds, const T * values, size_t rows, Less less, DB::IColumn::Selector & selector)
+{
+    constexpr size_t batch = 8;
+    selector.resize(rows);
+    if (num_bounds == 0)
+    {
+        std::fill(selector.begin(), selector.end(), 0);
+        return;
+    }
+    auto search = [&](size_t row_begin, size_t row_count)
+    {
+        size_t pos[batch] = {};
+        for (size_t n = num_bounds; n > 1;)
+        {
+            size_t half = n / 2;
+            for (size_t k = 0; k < row_count; ++k)
+                pos[k] += less(bounds[pos[k] + half - 1], values[row_begin + k]) ? half : 0;
+            n -= half;
+        }
+        for (size_t k = 0; k < row_count; ++k)
+            selector[row_begin + k] = pos[k] + less(bounds[pos[k]], values[row_begin + k]);
+    };
+    size_t row = 0;
+    for (; row + batch <= rows; row += batch)
+        search(row, batch);
+    if (row < rows)
+        search(row, rows - row);
+}
+
+}
+
+bool RangeSelectorBuilder::computePartitionIdByEncodedKeys(DB::Block & block, DB::IColumn::Selector & selector)
+{
+    if (!encoded_bounds)
+        return false;
+    DB::Columns key_columns;
+    key_columns.reserve(sorting_key_columns.size());
+    for (size_t i = 0; i < sorting_key_columns.size(); ++i)
+    {
+        const auto & key = block.getByPosition(sorting_key_columns[i]);
+        auto column = key.column->convertToFullColumnIfConst();
+        /// Of the type of its bounds, which may be nullable when the key isn't.
+        if (!DB::removeNullable(key.type)->equals(*DB::removeNullable(range_bounds_block.getByPosition(i).type))
+            || !SortKeyEncoder::isSupported(*column))
+            return false;
+        key_columns.emplace_back(std::move(column));
+    }
+
+    SortKeyEncoder keys(sort_descriptions);
+    keys.encode(key_columns, block.rows());
+    /// The encoded keys compare bytewise in the order of the rows, so the bounds are searched as plain strings.
+    auto to_views = [](const SortKeyEncoder & encoded)
+    {
+        std::vector<std::string_view> views(encoded.size());
+        for (size_t i = 0; i < encoded.size(); ++i)
+            views[i] = encoded[i];
+        return views;
+    };
+    auto bound_keys = to_views(*encoded_bounds);
+    auto row_keys = to_views(keys);
+    searchBounds(bound_keys.data(), bound_keys.size(), row_keys.data(), row_keys.size(), std::less<std::string_view>(), selector);
+    return true;
+}
+
 void RangeSelectorBuilder::computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector)
+{
+    if (!computePartitionIdByEncodedKeys(block, selector))
+        computePartitionIdByCompareRow(block, selector);
+}
+
+void RangeSelectorBuilder::computePartitionIdByCompareRow(DB::Block & block, DB::IColumn::Selector & selector)
 {
     Chunks chunks;
     Chunk chunk(block.getColumns(), block.rows());
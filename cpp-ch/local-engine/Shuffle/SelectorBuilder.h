@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <limits>
 #include <memory>
 #include <vector>
 #include <Core/Block.h>
@@ -27,6 +28,7 @@
 #include <base/types.h>
 #include <substrait/plan.pb.h>
 #include <Common/BlockIterator.h>
+#include <Common/SortKeyEncoder.h>
 #include <Common/PODArray.h>
 
 namespace local_engine
@@ -38,6 +40,8 @@ struct PartitionInfo
     size_t partition_num;
 
     static PartitionInfo fromSelector(DB::IColumn::Selector selector, size_t partition_num);
+    /// partition_rows holds the number of rows of each partition in the selector.
+    static PartitionInfo fromSelector(const DB::IColumn::Selector & selector, std::vector<size_t> && partition_rows);
 };
 
 class RoundRobinSelectorBuilder
@@ -58,7 +62,17 @@ public:
     PartitionInfo build(DB::Block & block);
 
 private:
+    /// hash % parts_num by multiplications, see "Faster Remainder by Direct Computation" by Lemire et al.
+    UInt64 modulo(UInt64 hash) const
+    {
+        unsigned __int128 low_bits = modulo_magic * hash;
+        unsigned __int128 bottom = ((low_bits & std::numeric_limits<UInt64>::max()) * parts_num) >> 64;
+        unsigned __int128 top = (low_bits >> 64) * parts_num;
+        return static_cast<UInt64>((bottom + top) >> 64);
+    }
+
     UInt32 parts_num;
+    unsigned __int128 modulo_magic;
     std::vector<size_t> exprs_index;
     std::string hash_function_name;
     DB::FunctionBasePtr hash_function;
@@ -66,6 +80,8 @@ private:
 
 class RangeSelectorBuilder
 {
+    friend class RangeSelectorBuilderTest;
+
 public:
     explicit RangeSelectorBuilder(const std::string & options_, const size_t partition_num_);
     PartitionInfo build(DB::Block & block);
@@ -80,6 +96,8 @@ private:
     };
     std::vector<SortFieldTypeInfo> sort_field_types;
     DB::Block range_bounds_block;
+    /// The bounds as encoded sort keys, nullptr if the sort keys can't be encoded.
+    std::unique_ptr<SortKeyEncoder> encoded_bounds;
 
     // If the ordering keys have expressions, we caculate the expressions here.
     std::mutex actions_dag_mutex;
@@ -96,6 +114,9 @@ private:
     void safeInsertFloatValue(const Poco::Dynamic::Var & field_value, DB::MutableColumnPtr & col);
 
     void computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector);
+    /// Compares the encoded sort keys of the rows with the ones of the bounds. False if the sort keys can't be encoded.
+    bool computePartitionIdByEncodedKeys(DB::Block & block, DB::IColumn::Selector & selector);
+    void computePartitionIdByCompareRow(DB::Block & block, DB::IColumn::Selector & selector);
     int compareRow(
         const DB::Columns & columns,
         const std::vector<size_t> & required_columns,
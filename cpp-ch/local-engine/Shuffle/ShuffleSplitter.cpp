@@ -18,21 +18,71 @@
 #include <filesystem>
 #include <format>
 #include <memory>
+#include <optional>
 #include <string>
 #include <fcntl.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+#include <Columns/ColumnConst.h>
 #include <Compression/CompressedWriteBuffer.h>
 #include <Compression/CompressionFactory.h>
 #include <Functions/FunctionFactory.h>
 #include <IO/BrotliWriteBuffer.h>
-#include <IO/ReadBufferFromFile.h>
 #include <IO/WriteHelpers.h>
 #include <Parser/SerializedPlanParser.h>
+#include <Shuffle/LocalDirSelector.h>
+#include <base/scope_guard.h>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <Poco/StringTokenizer.h>
 #include <Common/DebugUtils.h>
 
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int CANNOT_OPEN_FILE;
+    extern const int CANNOT_READ_ALL_DATA;
+    extern const int CANNOT_WRITE_TO_FILE_DESCRIPTOR;
+}
+}
+
 namespace local_engine
 {
+namespace
+{
+/// Appends length bytes at offset of in_fd to out_fd from its current position, without a round trip through user
+/// space. sendfile covers the file systems copy_file_range doesn't.
+void copyFileRange(int in_fd, size_t offset, int out_fd, size_t length)
+{
+    off_t in_offset = offset;
+    bool use_copy_file_range = true;
+    while (length > 0)
+    {
+        ssize_t copied;
+        if (use_copy_file_range)
+        {
+            copied = ::copy_file_range(in_fd, &in_offset, out_fd, nullptr, length, 0);
+            if (copied < 0 && (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL))
+            {
+                use_copy_file_range = false;
+                continue;
+            }
+        }
+        else
+            copied = ::sendfile(out_fd, in_fd, &in_offset, length);
+        if (copied < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            DB::throwFromErrno("Cannot copy the spilled shuffle data", DB::ErrorCodes::CANNOT_WRITE_TO_FILE_DESCRIPTOR);
+        }
+        if (copied == 0)
+            throw DB::Exception(DB::ErrorCodes::CANNOT_READ_ALL_DATA, "Unexpected end of the shuffle spill file");
+        length -= copied;
+    }
+}
+}
+
 void ShuffleSplitter::split(DB::Block & block)
 {
     if (block.rows() == 0)
@@ -41,25 +91,40 @@ void ShuffleSplitter::split(DB::Block & block)
     }
     Stopwatch watch;
     watch.start();
+    splitting = true;
+    SCOPE_EXIT({ splitting = false; });
     computeAndCountPartitionId(block);
     splitBlockByPartition(block);
     split_result.total_write_time += watch.elapsedNanoseconds();
 }
+
+size_t ShuffleSplitter::evictFixedSize(size_t size)
+{
+    // Not while the buffers are being appended to, e.g. when called back for memory from within split().
+    if (splitting || stopped)
+        return 0;
+    return evictPartitions(size);
+}
+
+size_t ShuffleSplitter::evictPartitions(size_t size)
+{
+    size_t evicted = 0;
+    // The largest partitions go first, to spill as few and as large blocks as possible.
+    while (evicted < size)
+    {
+        auto largest = std::max_element(partition_buffer_bytes.begin(), partition_buffer_bytes.end());
+        if (largest == partition_buffer_bytes.end() || *largest == 0)
+            break;
+        evicted += *largest;
+        spillPartition(largest - partition_buffer_bytes.begin());
+    }
+    return evicted;
+}
 SplitResult ShuffleSplitter::stop()
 {
-    // spill all buffers
     Stopwatch watch;
     watch.start();
-    for (size_t i = 0; i < options.partition_nums; i++)
-    {
-        spillPartition(i);
-        partition_outputs[i]->flush();
-        partition_write_buffers[i].reset();
-    }
-    partition_outputs.clear();
-    partition_cached_write_buffers.clear();
-    partition_write_buffers.clear();
-    mergePartitionFiles();
+    mergeSpills();
     split_result.total_write_time += watch.elapsedNanoseconds();
     stopped = true;
     return split_result;
@@ -102,22 +167,31 @@ void ShuffleSplitter::splitBlockByPartition(DB::Block & block)
             partition_buffer[j].appendSelective(col, out_block, partition_info.partition_selector, from, length);
         }
     }
+    for (size_t j = 0; j < partition_info.partition_num; ++j)
+    {
+        if (partition_info.partition_start_points[j + 1] == partition_info.partition_start_points[j])
+            continue;
+        size_t bytes = partition_buffer[j].bytes();
+        buffered_bytes += bytes - partition_buffer_bytes[j];
+        partition_buffer_bytes[j] = bytes;
+    }
 
+    if (!options.prefer_spill)
+        return;
     for (size_t i = 0; i < options.partition_nums; ++i)
     {
         ColumnsBuffer & buffer = partition_buffer[i];
         if (buffer.size() >= options.split_size)
         {
-            spillPartition(i);
+            spillPartition(i, true);
         }
     }
 }
 void ShuffleSplitter::init()
 {
     partition_buffer.reserve(options.partition_nums);
-    partition_outputs.reserve(options.partition_nums);
-    partition_write_buffers.reserve(options.partition_nums);
-    partition_cached_write_buffers.reserve(options.partition_nums);
+    partition_spills.resize(options.partition_nums);
+    partition_buffer_bytes.resize(options.partition_nums, 0);
     split_result.partition_length.reserve(options.partition_nums);
     split_result.raw_partition_length.reserve(options.partition_nums);
     for (size_t i = 0; i < options.partition_nums; ++i)
@@ -125,52 +199,118 @@ void ShuffleSplitter::init()
         partition_buffer.emplace_back(ColumnsBuffer());
         split_result.partition_length.emplace_back(0);
         split_result.raw_partition_length.emplace_back(0);
-        partition_outputs.emplace_back(nullptr);
-        partition_write_buffers.emplace_back(nullptr);
-        partition_cached_write_buffers.emplace_back(nullptr);
     }
+    if (!options.compress_method.empty()
+        && std::find(compress_methods.begin(), compress_methods.end(), options.compress_method) != compress_methods.end())
+        codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(options.compress_method), {});
 }
 
-void ShuffleSplitter::spillPartition(size_t partition_id)
+void ShuffleSplitter::spillPartition(size_t partition_id, bool recycle)
 {
     Stopwatch watch;
     watch.start();
-    if (!partition_outputs[partition_id])
-    {
-        partition_write_buffers[partition_id] = getPartitionWriteBuffer(partition_id);
-        partition_outputs[partition_id]
-            = std::make_unique<DB::NativeWriter>(*partition_write_buffers[partition_id], 0, partition_buffer[partition_id].getHeader());
-    }
     DB::Block result = partition_buffer[partition_id].releaseColumns();
+    buffered_bytes -= partition_buffer_bytes[partition_id];
+    partition_buffer_bytes[partition_id] = 0;
     if (result.rows() > 0)
     {
-        partition_outputs[partition_id]->write(result);
+        if (!spill_buffer)
+        {
+            spill_file = getSpillFile(result.bytes());
+            spill_buffer = std::make_unique<DB::WriteBufferFromFile>(spill_file, options.io_buffer_size);
+        }
+        auto & selector = LocalDirSelector::instance();
+        size_t bytes = result.bytes();
+        selector.beginWrite(spill_dir, bytes);
+        Stopwatch write_watch;
+        try
+        {
+            size_t offset = spill_buffer->count();
+            writeBlock(result, *spill_buffer);
+            partition_spills[partition_id].push_back({offset, spill_buffer->count() - offset});
+        }
+        catch (...)
+        {
+            selector.endWrite(spill_dir, bytes, write_watch.elapsedNanoseconds(), false);
+            throw;
+        }
+        selector.endWrite(spill_dir, bytes, write_watch.elapsedNanoseconds(), true);
     }
     split_result.total_spill_time += watch.elapsedNanoseconds();
     split_result.total_bytes_spilled += result.bytes();
+    if (recycle)
+    {
+        partition_buffer[partition_id].recycleColumns(std::move(result));
+        partition_buffer_bytes[partition_id] = partition_buffer[partition_id].bytes();
+        buffered_bytes += partition_buffer_bytes[partition_id];
+    }
 }
 
-void ShuffleSplitter::mergePartitionFiles()
+void ShuffleSplitter::writeBlock(const DB::Block & block, DB::WriteBuffer & out)
 {
-    DB::WriteBufferFromFile data_write_buffer = DB::WriteBufferFromFile(options.data_file);
-    std::string buffer;
-    size_t buffer_size = options.io_buffer_size;
-    buffer.reserve(buffer_size);
+    std::optional<DB::CompressedWriteBuffer> compressed;
+    if (codec)
+        compressed.emplace(out, codec);
+    DB::NativeWriter writer(compressed ? *compressed : out, 0, block.cloneEmpty());
+    // A partition buffered beyond split_size rows is still read back in blocks of split_size rows.
+    size_t rows = block.rows();
+    size_t step = std::max<size_t>(options.split_size, 1);
+    if (rows <= step)
+        writer.write(block);
+    else
+        for (size_t start = 0; start < rows; start += step)
+            writer.write(block.cloneWithCutColumns(start, std::min(step, rows - start)));
+    if (compressed)
+        compressed->finalize();
+}
+
+void ShuffleSplitter::mergeSpills()
+{
+    int spill_fd = -1;
+    if (spill_buffer)
+    {
+        spill_buffer->finalize();
+        spill_buffer.reset();
+        spill_fd = ::open(spill_file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (spill_fd < 0)
+            DB::throwFromErrno("Cannot open file " + spill_file, DB::ErrorCodes::CANNOT_OPEN_FILE);
+    }
+    SCOPE_EXIT({
+        if (spill_fd >= 0)
+        {
+            ::close(spill_fd);
+            std::filesystem::remove(spill_file);
+        }
+    });
+
+    DB::WriteBufferFromFile data_write_buffer(options.data_file, options.io_buffer_size);
     for (size_t i = 0; i < options.partition_nums; ++i)
     {
-        auto file = getPartitionTempFile(i);
-        DB::ReadBufferFromFile reader = DB::ReadBufferFromFile(file, options.io_buffer_size);
-        while (reader.next())
+        size_t length = 0;
+        if (!partition_spills[i].empty())
+        {
+            // The copied bytes go after the ones still in the buffer.
+            data_write_buffer.next();
+            for (const auto & segment : partition_spills[i])
+            {
+                copyFileRange(spill_fd, segment.offset, data_write_buffer.getFD(), segment.length);
+                length += segment.length;
+            }
+        }
+        // The small partitions never spilled go straight into the data file.
+        DB::Block block = partition_buffer[i].releaseColumns();
+        buffered_bytes -= partition_buffer_bytes[i];
+        partition_buffer_bytes[i] = 0;
+        if (block.rows() > 0)
         {
-            auto bytes = reader.readBig(buffer.data(), buffer_size);
-            data_write_buffer.write(buffer.data(), bytes);
-            split_result.partition_length[i] += bytes;
-            split_result.total_bytes_written += bytes;
+            size_t start = data_write_buffer.count();
+            writeBlock(block, data_write_buffer);
+            length += data_write_buffer.count() - start;
         }
-        reader.close();
-        std::filesystem::remove(file);
+        split_result.partition_length[i] = length;
+        split_result.total_bytes_written += length;
     }
-    data_write_buffer.close();
+    data_write_buffer.finalize();
 }
 
 ShuffleSplitter::ShuffleSplitter(SplitOptions && options_) : options(options_)
@@ -203,38 +343,21 @@ ShuffleSplitter::Ptr ShuffleSplitter::create(const std::string & short_name, Spl
     }
 }
 
-std::string ShuffleSplitter::getPartitionTempFile(size_t partition_id)
+std::string ShuffleSplitter::getSpillFile(size_t expected_bytes)
 {
-    auto file_name = std::to_string(options.shuffle_id) + "_" + std::to_string(options.map_id) + "_" + std::to_string(partition_id);
+    auto file_name = std::to_string(options.shuffle_id) + "_" + std::to_string(options.map_id) + ".spill";
     std::hash<std::string> hasher;
     auto hash = hasher(file_name);
-    auto dir_id = hash % options.local_dirs_list.size();
+    auto dir_id = LocalDirSelector::instance().select(options.local_dirs_list, expected_bytes);
     auto sub_dir_id = (hash / options.local_dirs_list.size()) % options.num_sub_dirs;
 
-    std::string dir = std::filesystem::path(options.local_dirs_list[dir_id]) / std::format("{:02x}", sub_dir_id);
+    spill_dir = options.local_dirs_list[dir_id];
+    std::string dir = std::filesystem::path(spill_dir) / std::format("{:02x}", sub_dir_id);
     if (!std::filesystem::exists(dir))
         std::filesystem::create_directories(dir);
     return std::filesystem::path(dir) / file_name;
 }
 
-std::unique_ptr<DB::WriteBuffer> ShuffleSplitter::getPartitionWriteBuffer(size_t partition_id)
-{
-    auto file = getPartitionTempFile(partition_id);
-    if (partition_cached_write_buffers[partition_id] == nullptr)
-        partition_cached_write_buffers[partition_id]
-            = std::make_unique<DB::WriteBufferFromFile>(file, options.io_buffer_size, O_CREAT | O_WRONLY | O_APPEND);
-    if (!options.compress_method.empty()
-        && std::find(compress_methods.begin(), compress_methods.end(), options.compress_method) != compress_methods.end())
-    {
-        auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(options.compress_method), {});
-        return std::make_unique<DB::CompressedWriteBuffer>(*partition_cached_write_buffers[partition_id], codec);
-    }
-    else
-    {
-        return std::move(partition_cached_write_buffers[partition_id]);
-    }
-}
-
 const std::vector<std::string> ShuffleSplitter::compress_methods = {"", "ZSTD", "LZ4"};
 
 void ShuffleSplitter::writeIndexFile()
@@ -286,15 +409,21 @@ void ColumnsBuffer::appendSelective(
         accumulated_columns.reserve(source.columns());
         for (size_t i = 0; i < source.columns(); i++)
         {
-            auto column = source.getColumns()[i]->convertToFullColumnIfConst()->cloneEmpty();
+            const auto & source_column = source.getByPosition(i).column;
+            const auto * const_column = DB::checkAndGetColumn<DB::ColumnConst>(source_column.get());
+            auto column = const_column ? const_column->getDataColumn().cloneEmpty() : source_column->cloneEmpty();
             column->reserve(prefer_buffer_size);
             accumulated_columns.emplace_back(std::move(column));
         }
     }
     if (!accumulated_columns[column_idx]->onlyNull())
     {
-        accumulated_columns[column_idx]->insertRangeSelective(
-            *source.getByPosition(column_idx).column->convertToFullColumnIfConst(), selector, from, length);
+        const auto & source_column = *source.getByPosition(column_idx).column;
+        // Constant columns, such as partition values, are repeated without being materialized first.
+        if (const auto * const_column = DB::checkAndGetColumn<DB::ColumnConst>(&source_column))
+            accumulated_columns[column_idx]->insertManyFrom(const_column->getDataColumn(), 0, length);
+        else
+            accumulated_columns[column_idx]->insertRangeSelective(source_column, selector, from, length);
     }
     else
     {
@@ -302,6 +431,14 @@ void ColumnsBuffer::appendSelective(
     }
 }
 
+size_t ColumnsBuffer::bytes() const
+{
+    size_t bytes = 0;
+    for (const auto & column : accumulated_columns)
+        bytes += column->allocatedBytes();
+    return bytes;
+}
+
 size_t ColumnsBuffer::size() const
 {
     if (accumulated_columns.empty())
@@ -323,6 +460,18 @@ DB::Block ColumnsBuffer::releaseColumns()
     }
 }
 
+void ColumnsBuffer::recycleColumns(DB::Block && block)
+{
+    if (!accumulated_columns.empty() || !block.columns())
+        return;
+    for (const auto & elem : block)
+        if (!elem.column || elem.column->use_count() != 1)
+            return;
+    accumulated_columns = block.mutateColumns();
+    for (auto & column : accumulated_columns)
+        column->popBack(column->size());
+}
+
 DB::Block ColumnsBuffer::getHeader()
 {
     return header;
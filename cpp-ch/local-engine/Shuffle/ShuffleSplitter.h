@@ -16,6 +16,7 @@
  */
 #pragma once
 #include <Columns/IColumn.h>
+#include <Compression/ICompressionCodec.h>
 #include <Core/Block.h>
 #include <Formats/NativeWriter.h>
 #include <Functions/IFunction.h>
@@ -42,6 +43,9 @@ struct SplitOptions
     // std::vector<std::string> exprs;
     std::string compress_method = "zstd";
     int compress_level;
+    /// Spill each partition once it buffers split_size rows. Otherwise the partitions stay in memory, and the largest
+    /// ones are spilled when evictFixedSize is asked to release memory.
+    bool prefer_spill = true;
 };
 
 class ColumnsBuffer
@@ -51,7 +55,11 @@ public:
     void add(DB::Block & columns, int start, int end);
     void appendSelective(size_t column_idx, const DB::Block & source, const DB::IColumn::Selector & selector, size_t from, size_t length);
     size_t size() const;
+    size_t bytes() const;
     DB::Block releaseColumns();
+    /// Takes back the columns of a released block no longer used, cleared but keeping their capacity, as the columns
+    /// of the next accumulation. Ignored if the buffer isn't empty or the columns are shared.
+    void recycleColumns(DB::Block && block);
     DB::Block getHeader();
 
 private:
@@ -88,22 +96,48 @@ public:
     std::vector<int64_t> getPartitionLength() const { return split_result.partition_length; }
     void writeIndexFile();
     SplitResult stop();
+    /// Spills the largest partitions until at least size bytes are released, or nothing is buffered. Returns the
+    /// bytes released, 0 if called from within split().
+    size_t evictFixedSize(size_t size);
+    size_t bufferedBytes() const { return buffered_bytes; }
 
 private:
+    /// A range of the spill file holding blocks of one partition.
+    struct SpillSegment
+    {
+        size_t offset;
+        size_t length;
+    };
+
     void init();
     void splitBlockByPartition(DB::Block & block);
-    void spillPartition(size_t partition_id);
-    std::string getPartitionTempFile(size_t partition_id);
-    void mergePartitionFiles();
-    std::unique_ptr<DB::WriteBuffer> getPartitionWriteBuffer(size_t partition_id);
+    /// Appends the buffered rows of the partition to the spill file shared by all the partitions.
+    /// The columns of the partition are kept for its next rows when recycled, freed otherwise.
+    void spillPartition(size_t partition_id, bool recycle = false);
+    /// Creates the spill file in the local dir LocalDirSelector picks for expected_bytes, the first spill. The later
+    /// spills append to the same file.
+    std::string getSpillFile(size_t expected_bytes);
+    size_t evictPartitions(size_t size);
+    /// Writes the data file partition by partition, copying the spilled segments in the kernel and then the rows
+    /// still buffered in memory.
+    void mergeSpills();
+    /// A self-contained chunk of the partition stream, compressed if configured.
+    void writeBlock(const DB::Block & block, DB::WriteBuffer & out);
 
 protected:
     bool stopped = false;
     PartitionInfo partition_info;
     std::vector<ColumnsBuffer> partition_buffer;
-    std::vector<std::unique_ptr<DB::NativeWriter>> partition_outputs;
-    std::vector<std::unique_ptr<DB::WriteBuffer>> partition_write_buffers;
-    std::vector<std::unique_ptr<DB::WriteBuffer>> partition_cached_write_buffers;
+    std::string spill_file;
+    /// The local dir the spill file is under, the spill writes are accounted to.
+    std::string spill_dir;
+    std::unique_ptr<DB::WriteBufferFromFile> spill_buffer;
+    std::vector<std::vector<SpillSegment>> partition_spills;
+    DB::CompressionCodecPtr codec;
+    /// The allocated bytes of each partition buffer, as of its last append.
+    std::vector<size_t> partition_buffer_bytes;
+    size_t buffered_bytes = 0;
+    bool splitting = false;
     std::vector<size_t> output_columns_indicies;
     DB::Block output_header;
     SplitOptions options;
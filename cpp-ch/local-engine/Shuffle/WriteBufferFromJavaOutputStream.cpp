@@ -26,23 +26,17 @@ jmethodID WriteBufferFromJavaOutputStream::output_stream_flush = nullptr;
 
 void WriteBufferFromJavaOutputStream::nextImpl()
 {
+    if (!offset())
+        return;
     GET_JNIENV(env)
-    size_t bytes_write = 0;
-    while (offset() - bytes_write > 0)
-    {
-        jint copy_num = static_cast<jint>(std::min(offset() - bytes_write, buffer_size));
-        env->SetByteArrayRegion(buffer, 0, copy_num, reinterpret_cast<const jbyte *>(this->working_buffer.begin() + bytes_write));
-        safeCallVoidMethod(env, output_stream, output_stream_write, buffer, 0, copy_num);
-        bytes_write += copy_num;
-    }
+    safeCallVoidMethod(
+        env, output_stream, output_stream_write, reinterpret_cast<jlong>(working_buffer.begin()), static_cast<jint>(offset()));
     CLEAN_JNIENV
 }
-WriteBufferFromJavaOutputStream::WriteBufferFromJavaOutputStream(jobject output_stream_, jbyteArray buffer_, size_t customize_buffer_size)
+WriteBufferFromJavaOutputStream::WriteBufferFromJavaOutputStream(jobject output_stream_)
 {
     GET_JNIENV(env)
-    buffer = static_cast<jbyteArray>(env->NewWeakGlobalRef(buffer_));
     output_stream = env->NewWeakGlobalRef(output_stream_);
-    buffer_size = customize_buffer_size;
     CLEAN_JNIENV
 }
 void WriteBufferFromJavaOutputStream::finalizeImpl()
@@ -56,7 +50,6 @@ WriteBufferFromJavaOutputStream::~WriteBufferFromJavaOutputStream()
 {
     GET_JNIENV(env)
     env->DeleteWeakGlobalRef(output_stream);
-    env->DeleteWeakGlobalRef(buffer);
     CLEAN_JNIENV
 }
 }
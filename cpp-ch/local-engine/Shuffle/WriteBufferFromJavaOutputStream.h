@@ -21,6 +21,7 @@
 
 namespace local_engine
 {
+/// Writes to a NativeBufferOutputStream, which is handed the address of the buffer rather than a copy of it in a byte[].
 class WriteBufferFromJavaOutputStream : public DB::BufferWithOwnMemory<DB::WriteBuffer>
 {
 public:
@@ -28,7 +29,7 @@ public:
     static jmethodID output_stream_write;
     static jmethodID output_stream_flush;
 
-    WriteBufferFromJavaOutputStream(jobject output_stream, jbyteArray buffer, size_t customize_buffer_size);
+    explicit WriteBufferFromJavaOutputStream(jobject output_stream);
     ~WriteBufferFromJavaOutputStream() override;
 
 private:
@@ -39,7 +40,5 @@ protected:
 
 private:
     jobject output_stream;
-    jbyteArray buffer;
-    size_t buffer_size;
 };
 }
@@ -17,6 +17,8 @@
 #include "ArrowParquetBlockInputFormat.h"
 
 #if USE_PARQUET && USE_LOCAL_FORMATS
+#    include <Columns/ColumnsCommon.h>
+#    include <Columns/FilterDescription.h>
 #    include <DataTypes/NestedUtils.h>
 #    include <arrow/record_batch.h>
 #    include <arrow/table.h>
@@ -29,9 +31,20 @@ using namespace DB;
 namespace local_engine
 {
 ArrowParquetBlockInputFormat::ArrowParquetBlockInputFormat(
-    DB::ReadBuffer & in_, const DB::Block & header, const DB::FormatSettings & formatSettings, const std::vector<int> & row_group_indices_)
+    DB::ReadBuffer & in_,
+    const DB::Block & header,
+    const DB::FormatSettings & formatSettings,
+    const std::vector<int> & row_group_indices_,
+    std::shared_ptr<parquet::FileMetaData> file_metadata_)
     : OptimizedParquetBlockInputFormat(in_, header, formatSettings), row_group_indices(row_group_indices_)
 {
+    file_metadata = std::move(file_metadata_);
+}
+
+void ArrowParquetBlockInputFormat::setFilter(DB::ExpressionActionsPtr filter_actions_, const String & filter_column_name_)
+{
+    filter_actions = std::move(filter_actions_);
+    filter_column_name = filter_column_name_;
 }
 
 static size_t countIndicesForType(std::shared_ptr<arrow::DataType> type)
@@ -65,7 +78,7 @@ DB::Chunk ArrowParquetBlockInputFormat::generate()
     if (!file_reader)
     {
         prepareReader();
-        file_reader->set_batch_size(8192);
+        file_reader->set_batch_size(batch_size);
         if (row_group_indices.empty() && file_reader->num_row_groups() == 0)
         {
             return {};
@@ -75,14 +88,22 @@ DB::Chunk ArrowParquetBlockInputFormat::generate()
             auto row_group_range = boost::irange(0, file_reader->num_row_groups());
             row_group_indices = std::vector(row_group_range.begin(), row_group_range.end());
         }
-        auto read_status = file_reader->GetRecordBatchReader(row_group_indices, column_indices, &current_record_batch_reader);
-        if (!read_status.ok())
-            throw std::runtime_error{"Error while reading Parquet data: " + read_status.ToString()};
+        if (filter_actions && !prepareFilteredRead())
+            filter_actions = nullptr;
+        if (!filter_actions)
+        {
+            auto read_status = file_reader->GetRecordBatchReader(row_group_indices, column_indices, &current_record_batch_reader);
+            if (!read_status.ok())
+                throw std::runtime_error{"Error while reading Parquet data: " + read_status.ToString()};
+        }
     }
 
     if (is_stopped)
         return {};
 
+    if (filter_actions)
+        return generateFiltered();
+
 
     Stopwatch watch;
     watch.start();
@@ -115,6 +136,107 @@ DB::Chunk ArrowParquetBlockInputFormat::generate()
     return res;
 }
 
+bool ArrowParquetBlockInputFormat::prepareFilteredRead()
+{
+    const auto & header = getPort().getHeader();
+    std::unordered_set<String> predicate_columns;
+    for (const auto & required : filter_actions->getRequiredColumnsWithTypes())
+    {
+        /// E.g. partition or nested columns, which are not read as they are from the file.
+        const auto * column = header.findByName(required.name);
+        if (!column || !column->type->equals(*required.type)
+            || std::find(column_names.begin(), column_names.end(), required.name) == column_names.end())
+            return false;
+        predicate_columns.insert(required.name);
+    }
+
+    for (size_t i = 0; i < column_indices.size(); ++i)
+    {
+        if (predicate_columns.contains(column_names[i]))
+        {
+            predicate_indices.push_back(column_indices[i]);
+            predicate_names.push_back(column_names[i]);
+        }
+        else
+        {
+            remaining_indices.push_back(column_indices[i]);
+            remaining_names.push_back(column_names[i]);
+        }
+    }
+    if (predicate_indices.empty() || remaining_indices.empty())
+        return false;
+
+    for (const auto & column : header)
+    {
+        if (predicate_columns.contains(column.name))
+            predicate_header.insert(column.cloneEmpty());
+        else
+            remaining_header.insert(column.cloneEmpty());
+    }
+    predicate_converter = std::make_unique<OptimizedArrowColumnToCHColumn>(
+        predicate_header, "Parquet", format_settings.parquet.import_nested, format_settings.parquet.allow_missing_columns);
+    remaining_converter = std::make_unique<OptimizedArrowColumnToCHColumn>(
+        remaining_header, "Parquet", format_settings.parquet.import_nested, format_settings.parquet.allow_missing_columns);
+    return true;
+}
+
+DB::Chunk ArrowParquetBlockInputFormat::generateFiltered()
+{
+    const auto & header = getPort().getHeader();
+    while (next_row_group < row_group_indices.size())
+    {
+        int row_group = row_group_indices[next_row_group++];
+        auto predicate_chunk = readRowGroup(row_group, predicate_indices, predicate_names, *predicate_converter);
+        size_t num_rows = predicate_chunk.getNumRows();
+        auto predicate_columns = predicate_chunk.detachColumns();
+
+        auto block = predicate_header.cloneWithColumns(predicate_columns);
+        filter_actions->execute(block, num_rows);
+        auto filter_column = block.getByName(filter_column_name).column->convertToFullColumnIfConst();
+        FilterDescription filter_description(*filter_column);
+        size_t num_passed = countBytesInFilter(*filter_description.data);
+        if (!num_passed)
+            continue;
+
+        auto remaining_columns = readRowGroup(row_group, remaining_indices, remaining_names, *remaining_converter).detachColumns();
+        DB::Columns columns;
+        columns.reserve(header.columns());
+        for (const auto & column : header)
+        {
+            auto result = predicate_header.has(column.name) ? predicate_columns[predicate_header.getPositionByName(column.name)]
+                                                            : remaining_columns[remaining_header.getPositionByName(column.name)];
+            if (num_passed < num_rows)
+                result = result->filter(*filter_description.data, num_passed);
+            columns.emplace_back(std::move(result));
+        }
+
+        DB::Chunk res(std::move(columns), num_passed);
+        if (format_settings.defaults_for_omitted_fields)
+            for (size_t row_idx = 0; row_idx < res.getNumRows(); ++row_idx)
+                for (const auto & column_idx : missing_columns)
+                    block_missing_values.setBit(column_idx, row_idx);
+        return res;
+    }
+
+    file_reader.reset();
+    return {};
+}
+
+DB::Chunk ArrowParquetBlockInputFormat::readRowGroup(
+    int row_group, const std::vector<int> & indices, const std::vector<String> & names, DB::OptimizedArrowColumnToCHColumn & converter)
+{
+    std::shared_ptr<arrow::Table> table;
+    auto read_status = file_reader->ReadRowGroup(row_group, indices, &table);
+    if (!read_status.ok())
+        throw std::runtime_error{"Error while reading Parquet data: " + read_status.ToString()};
+    if (format_settings.use_lowercase_column_name)
+        table = *table->RenameColumns(names);
+
+    DB::Chunk chunk;
+    converter.arrowTableToCHChunk(chunk, table);
+    return chunk;
+}
+
 }
 
 #endif
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #if USE_PARQUET && USE_LOCAL_FORMATS
+#    include <Interpreters/ExpressionActions.h>
 #    include <Common/ChunkBuffer.h>
 #    include "ch_parquet/OptimizedArrowColumnToCHColumn.h"
 #    include "ch_parquet/OptimizedParquetBlockInputFormat.h"
@@ -40,15 +41,40 @@ public:
         DB::ReadBuffer & in,
         const DB::Block & header,
         const DB::FormatSettings & formatSettings,
-        const std::vector<int> & row_group_indices_ = {});
+        const std::vector<int> & row_group_indices_ = {},
+        std::shared_ptr<parquet::FileMetaData> file_metadata_ = nullptr);
+
+    /// Reads the columns of the filter of a row group first and the other columns only if some rows pass it, then
+    /// returns the passing rows only. A row group at a time rather than in batches.
+    void setFilter(DB::ExpressionActionsPtr filter_actions_, const String & filter_column_name_);
+    /// Rows of the batches read, before the first one.
+    void setBatchSize(size_t batch_size_) { batch_size = batch_size_; }
 
 private:
     DB::Chunk generate() override;
+    bool prepareFilteredRead();
+    DB::Chunk generateFiltered();
+    DB::Chunk readRowGroup(
+        int row_group, const std::vector<int> & indices, const std::vector<String> & names, DB::OptimizedArrowColumnToCHColumn & converter);
 
     int64_t convert_time = 0;
     int64_t non_convert_time = 0;
     std::shared_ptr<arrow::RecordBatchReader> current_record_batch_reader;
     std::vector<int> row_group_indices;
+    size_t batch_size = 8192;
+
+    DB::ExpressionActionsPtr filter_actions;
+    String filter_column_name;
+    /// The columns the filter reads, and the others.
+    std::vector<int> predicate_indices;
+    std::vector<String> predicate_names;
+    DB::Block predicate_header;
+    std::unique_ptr<DB::OptimizedArrowColumnToCHColumn> predicate_converter;
+    std::vector<int> remaining_indices;
+    std::vector<String> remaining_names;
+    DB::Block remaining_header;
+    std::unique_ptr<DB::OptimizedArrowColumnToCHColumn> remaining_converter;
+    size_t next_row_group = 0;
 };
 
 }
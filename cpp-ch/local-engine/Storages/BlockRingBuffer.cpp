@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BlockRingBuffer.h"
+#include <bit>
+#include <Common/Exception.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+    extern const int UNKNOWN_EXCEPTION;
+}
+}
+
+namespace local_engine
+{
+BlockRingBuffer::BlockRingBuffer(size_t capacity_) : capacity(static_cast<UInt32>(std::bit_ceil(capacity_))), slots(capacity)
+{
+    if (capacity_ == 0 || capacity_ > (1U << 30))
+        throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Invalid capacity {} of the block ring buffer", capacity_);
+}
+
+bool BlockRingBuffer::push(DB::Block && block)
+{
+    while (true)
+    {
+        const UInt32 events = consumer_events.load(std::memory_order_acquire);
+        if (cancelled.load(std::memory_order_acquire))
+            return false;
+        const UInt32 pos = tail.load(std::memory_order_relaxed);
+        if (pos - head.load(std::memory_order_acquire) < capacity)
+        {
+            slots[pos & (capacity - 1)] = std::move(block);
+            tail.store(pos + 1, std::memory_order_release);
+            producer_events.fetch_add(1, std::memory_order_release);
+            producer_events.notify_one();
+            return true;
+        }
+        consumer_events.wait(events, std::memory_order_acquire);
+    }
+}
+
+void BlockRingBuffer::finish(const String & error_)
+{
+    error = error_;
+    finished.store(true, std::memory_order_release);
+    producer_events.fetch_add(1, std::memory_order_release);
+    producer_events.notify_one();
+}
+
+std::optional<DB::Block> BlockRingBuffer::pop()
+{
+    while (true)
+    {
+        const UInt32 events = producer_events.load(std::memory_order_acquire);
+        /// Loaded before tail, so that the blocks pushed before finish are seen
+        const bool done = finished.load(std::memory_order_acquire);
+        const UInt32 pos = head.load(std::memory_order_relaxed);
+        if (pos != tail.load(std::memory_order_acquire))
+        {
+            DB::Block block = std::move(slots[pos & (capacity - 1)]);
+            head.store(pos + 1, std::memory_order_release);
+            consumer_events.fetch_add(1, std::memory_order_release);
+            consumer_events.notify_one();
+            return block;
+        }
+        if (done)
+        {
+            if (!error.empty())
+                throw DB::Exception(DB::ErrorCodes::UNKNOWN_EXCEPTION, "Failed to produce the input blocks in Java: {}", error);
+            return {};
+        }
+        producer_events.wait(events, std::memory_order_acquire);
+    }
+}
+
+void BlockRingBuffer::cancel()
+{
+    cancelled.store(true, std::memory_order_release);
+    consumer_events.fetch_add(1, std::memory_order_release);
+    consumer_events.notify_one();
+}
+}
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <atomic>
+#include <optional>
+#include <vector>
+#include <Core/Block.h>
+
+namespace local_engine
+{
+/// Single-producer single-consumer ring of blocks. A Java thread pushes the input blocks of a task through it to
+/// SourceFromJavaIter, which pulls them without calling into Java. Each side waits on a futex through atomic wait while
+/// the ring is empty or full.
+class BlockRingBuffer
+{
+public:
+    explicit BlockRingBuffer(size_t capacity_);
+
+    /// Producer side. Waits while the ring is full, returns false if the consumer cancelled it.
+    bool push(DB::Block && block);
+    /// Producer side, no more blocks. A non-empty error is thrown to the consumer once it drained the ring.
+    void finish(const String & error_ = {});
+
+    /// Consumer side. Waits while the ring is empty, returns nothing once the producer finished and the ring is drained.
+    std::optional<DB::Block> pop();
+    /// Consumer side, wakes up the producer and makes it stop.
+    void cancel();
+
+private:
+    const UInt32 capacity;
+    std::vector<DB::Block> slots;
+    /// Positions of the consumer and the producer, wrapping around. The block at head is read next, at tail written next.
+    std::atomic<UInt32> head{0};
+    std::atomic<UInt32> tail{0};
+    /// Changed by each push and finish, and by each pop and cancel, for the other side to wait on.
+    std::atomic<UInt32> producer_events{0};
+    std::atomic<UInt32> consumer_events{0};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancelled{false};
+    /// Written before finished is set
+    String error;
+};
+
+using BlockRingBufferPtr = std::shared_ptr<BlockRingBuffer>;
+}
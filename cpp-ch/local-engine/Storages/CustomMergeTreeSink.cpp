@@ -16,15 +16,120 @@
  */
 #include "CustomMergeTreeSink.h"
 
-void local_engine::CustomMergeTreeSink::consume(Chunk chunk)
+#include <Common/CurrentThread.h>
+#include <Common/ThreadPool.h>
+#include <Common/scope_guard_safe.h>
+
+namespace local_engine
+{
+void CustomMergeTreeSink::consume(Chunk chunk)
+{
+    buffered_bytes += chunk.bytes();
+    buffered_chunks.emplace_back(std::move(chunk));
+    if (buffered_bytes >= settings.min_part_bytes)
+        flush();
+}
+
+void CustomMergeTreeSink::onFinish()
+{
+    flush();
+}
+
+void CustomMergeTreeSink::flush()
 {
-    auto block = metadata_snapshot->getSampleBlock().cloneWithColumns(chunk.detachColumns());
-    DB::BlockWithPartition block_with_partition(Block(block), DB::Row{});
-    auto part = storage.writer.writeTempPart(block_with_partition, metadata_snapshot, context);
+    if (buffered_chunks.empty())
+        return;
+
+    const auto & header = getPort().getHeader();
+    Block block;
+    if (buffered_chunks.size() == 1)
+    {
+        block = header.cloneWithColumns(buffered_chunks.front().detachColumns());
+    }
+    else
+    {
+        size_t num_rows = 0;
+        for (const auto & chunk : buffered_chunks)
+            num_rows += chunk.getNumRows();
+        auto columns = header.cloneEmptyColumns();
+        for (auto & column : columns)
+            column->reserve(num_rows);
+        for (const auto & chunk : buffered_chunks)
+        {
+            const auto & chunk_columns = chunk.getColumns();
+            for (size_t i = 0; i < columns.size(); ++i)
+                columns[i]->insertRangeFrom(*chunk_columns[i], 0, chunk.getNumRows());
+        }
+        block = header.cloneWithColumns(std::move(columns));
+    }
+    buffered_chunks.clear();
+    buffered_bytes = 0;
+
+    auto blocks = MergeTreeDataWriter::splitBlockIntoParts(
+        std::move(block), context->getSettingsRef().max_partitions_per_insert_block, metadata_snapshot, context);
+    writeParts(blocks);
+}
+
+void CustomMergeTreeSink::writeParts(BlocksWithPartition & blocks)
+{
+    std::vector<MergeTreeDataWriter::TemporaryPart> parts(blocks.size());
+    auto write_parts = [&](size_t first)
+    {
+        const size_t step = std::max<size_t>(1, settings.write_threads);
+        for (size_t i = first; i < blocks.size(); i += step)
+        {
+            parts[i] = storage.writer.writeTempPart(blocks[i], metadata_snapshot, context);
+            parts[i].finalize();
+        }
+    };
+
+    /// Partitions are written on the calling thread and up to write_threads - 1 others, each thread compressing its
+    /// own parts.
+    const size_t num_threads = std::min(std::max<size_t>(1, settings.write_threads), blocks.size());
+    std::vector<std::exception_ptr> exceptions(num_threads);
+    std::vector<ThreadFromGlobalPool> threads;
+    auto thread_group = CurrentThread::getGroup();
+    for (size_t thread = 1; thread < num_threads; ++thread)
+    {
+        threads.emplace_back(
+            [&, thread]
+            {
+                if (thread_group)
+                    CurrentThread::attachToGroupIfDetached(thread_group);
+                SCOPE_EXIT_SAFE(if (thread_group) CurrentThread::detachFromGroupIfNotDetached(););
+                try
+                {
+                    write_parts(thread);
+                }
+                catch (...)
+                {
+                    exceptions[thread] = std::current_exception();
+                }
+            });
+    }
+    try
+    {
+        write_parts(0);
+    }
+    catch (...)
+    {
+        exceptions[0] = std::current_exception();
+    }
+    for (auto & thread : threads)
+        thread.join();
+    for (const auto & exception : exceptions)
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    /// All the parts of a flush become visible at once.
     MergeTreeData::Transaction transaction(storage, NO_TRANSACTION_RAW);
     {
         auto lock = storage.lockParts();
-        storage.renameTempPartAndAdd(part.part, transaction, lock);
+        for (auto & part : parts)
+            storage.renameTempPartAndAdd(part.part, transaction, lock);
         transaction.commit(&lock);
     }
 }
+}
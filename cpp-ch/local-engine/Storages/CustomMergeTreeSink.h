@@ -23,21 +23,46 @@
 
 namespace local_engine
 {
+struct CustomMergeTreeSinkSettings
+{
+    /// Chunks are buffered until they add up to this many bytes, then form one part per partition. 0 writes a part
+    /// per chunk.
+    size_t min_part_bytes = 0;
+    /// The parts of the partitions of a flush are written on up to this many threads.
+    size_t write_threads = 1;
+};
+
 class CustomMergeTreeSink : public ISink
 {
 public:
-    CustomMergeTreeSink(CustomStorageMergeTree & storage_, const StorageMetadataPtr metadata_snapshot_, ContextPtr context_)
-        : ISink(metadata_snapshot_->getSampleBlock()), storage(storage_), metadata_snapshot(metadata_snapshot_), context(context_)
+    CustomMergeTreeSink(
+        CustomStorageMergeTree & storage_,
+        const StorageMetadataPtr metadata_snapshot_,
+        ContextPtr context_,
+        CustomMergeTreeSinkSettings settings_ = {})
+        : ISink(metadata_snapshot_->getSampleBlock())
+        , storage(storage_)
+        , metadata_snapshot(metadata_snapshot_)
+        , context(context_)
+        , settings(settings_)
     {
     }
 
     String getName() const override { return "CustomMergeTreeSink"; }
     void consume(Chunk chunk) override;
+    void onFinish() override;
 
 private:
+    void flush();
+    void writeParts(BlocksWithPartition & blocks);
+
     CustomStorageMergeTree & storage;
     StorageMetadataPtr metadata_snapshot;
     ContextPtr context;
+    CustomMergeTreeSinkSettings settings;
+
+    std::vector<Chunk> buffered_chunks;
+    size_t buffered_bytes = 0;
 };
 
 }
@@ -16,6 +16,9 @@
  */
 #include "CustomStorageMergeTree.h"
 
+#include <Disks/SingleDiskVolume.h>
+#include <Storages/MergeTree/MergeTreeDataPartBuilder.h>
+
 namespace local_engine
 {
 CustomStorageMergeTree::CustomStorageMergeTree(
@@ -42,6 +45,86 @@ CustomStorageMergeTree::CustomStorageMergeTree(
 {
     initializeDirectoriesAndFormatVersion(relative_data_path_, attach, date_column_name);
 }
+
+void CustomStorageMergeTree::refreshDataParts()
+{
+    std::lock_guard refresh_lock(refresh_mutex);
+    auto disk = getStoragePolicy()->getAnyDisk();
+    std::map<String, MergeTreePartInfo> on_disk;
+    for (auto it = disk->iterateDirectory(getRelativeDataPath()); it->isValid(); it->next())
+    {
+        if (auto part_info = MergeTreePartInfo::tryParsePartName(it->name(), format_version))
+            on_disk.emplace(it->name(), *part_info);
+    }
+
+    DataPartsVector removed;
+    for (const auto & part : getDataPartsVectorForInternalUsage())
+    {
+        if (!on_disk.erase(part->name))
+            removed.push_back(part);
+    }
+
+    // What is left on disk is new, loaded outside of the parts lock.
+    MutableDataPartsVector loaded;
+    loaded.reserve(on_disk.size());
+    for (const auto & [name, part_info] : on_disk)
+    {
+        auto volume = std::make_shared<SingleDiskVolume>("volume_" + name, disk, 0);
+        auto part = getDataPartBuilder(name, volume, name).withPartInfo(part_info).withPartFormatFromDisk().build();
+        part->loadColumnsChecksumsIndexes(false, true);
+        loaded.push_back(std::move(part));
+    }
+
+    if (!removed.empty() || !loaded.empty())
+    {
+        auto lock = lockParts();
+        if (!removed.empty())
+            removePartsFromWorkingSet(NO_TRANSACTION_RAW, removed, true, lock);
+        for (const auto & part : loaded)
+        {
+            part->setState(DataPartState::Active);
+            data_parts_indexes.insert(part);
+            addPartContributionToColumnAndSecondaryIndexSizes(part);
+        }
+        LOG_DEBUG(log, "Refreshed parts of {}: {} loaded, {} removed", getStorageID().getNameForLogs(), loaded.size(), removed.size());
+    }
+    rebuildBlockRangeIndex();
+}
+
+void CustomStorageMergeTree::rebuildBlockRangeIndex()
+{
+    block_range_index_built = true;
+    parts_by_min_block.clear();
+    max_known_block = -1;
+    for (const auto & part : getDataPartsVectorForInternalUsage())
+    {
+        parts_by_min_block.emplace(part->info.min_block, part);
+        max_known_block = std::max(max_known_block, part->info.max_block);
+    }
+}
+
+MergeTreeData::DataPartsVector CustomStorageMergeTree::selectPartsByBlockRange(Int64 min_block, Int64 max_block)
+{
+    bool stale;
+    {
+        std::lock_guard refresh_lock(refresh_mutex);
+        if (!block_range_index_built)
+            rebuildBlockRangeIndex();
+        // The range ends past the newest known part when parts were written since the table was loaded.
+        stale = max_block - 1 > max_known_block;
+    }
+    if (stale)
+        refreshDataParts();
+
+    std::lock_guard refresh_lock(refresh_mutex);
+    DataPartsVector selected;
+    for (auto it = parts_by_min_block.lower_bound(min_block); it != parts_by_min_block.end() && it->first < max_block; ++it)
+    {
+        if (it->second->info.max_block < max_block)
+            selected.push_back(it->second);
+    }
+    return selected;
+}
 void CustomStorageMergeTree::dropPartNoWaitNoThrow(const String & /*part_name*/)
 {
     throw std::runtime_error("not implement");
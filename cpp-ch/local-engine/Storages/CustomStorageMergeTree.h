@@ -49,9 +49,25 @@ public:
     MergeTreeDataWriter writer;
     MergeTreeDataSelectExecutor reader;
 
+    /// Loads the part directories that appeared on disk since the last call and drops the parts whose directory is
+    /// gone, leaving the parts already loaded as they are.
+    void refreshDataParts();
+
+    /// The active parts with min_block >= min_block and max_block < max_block. Refreshes the parts first when the
+    /// range reaches past the newest block known.
+    DataPartsVector selectPartsByBlockRange(Int64 min_block, Int64 max_block);
+
 private:
     SimpleIncrement increment;
 
+    void rebuildBlockRangeIndex();
+
+    std::mutex refresh_mutex;
+    /// Active parts by their min_block, so that a block range is selected without going through every part.
+    std::multimap<Int64, DataPartPtr> parts_by_min_block;
+    Int64 max_known_block = -1;
+    bool block_range_index_built = false;
+
     void startBackgroundMovesIfNeeded() override;
     std::unique_ptr<MergeTreeSettings> getDefaultSettings() const override;
 
@@ -0,0 +1,213 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MergeTreeSkipIndexFilter.h"
+#include <DataTypes/DataTypeArray.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Interpreters/BloomFilter.h>
+#include <Interpreters/BloomFilterHash.h>
+#include <Interpreters/Context.h>
+#include <Interpreters/convertFieldToType.h>
+#include <Storages/MergeTree/MergeTreeIndexBloomFilter.h>
+#include <Storages/MergeTree/MergeTreeIndexGranuleBloomFilter.h>
+#include <Storages/MergeTree/MergeTreeIndexMinMax.h>
+#include <Storages/MergeTree/MergeTreeIndexReader.h>
+#include <Storages/MergeTree/MergeTreeIndexSet.h>
+#include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
+#include <Common/logger_useful.h>
+#include <Common/typeid_cast.h>
+
+namespace local_engine
+{
+MergeTreeSkipIndexFilter::MergeTreeSkipIndexFilter(
+    const DB::StorageMetadataPtr & metadata, const DB::ActionsDAGPtr & filter, DB::ContextPtr context_)
+    : context(context_)
+{
+    std::unordered_map<String, DB::Fields> point_values;
+    collectPointValues(filter->getOutputs().at(0), point_values);
+
+    for (const auto & description : metadata->getSecondaryIndices())
+    {
+        Index index;
+        index.helper = DB::MergeTreeIndexFactory::instance().get(description);
+        if (description.type == "minmax" || description.type == "set")
+        {
+            index.condition.emplace(filter, context, description.column_names, description.expression, DB::NameSet{});
+            if (index.condition->alwaysUnknownOrTrue())
+                continue;
+        }
+        else if (description.type == "bloom_filter")
+        {
+            for (size_t i = 0; i < description.column_names.size(); ++i)
+            {
+                auto values = point_values.find(description.column_names[i]);
+                if (values != point_values.end() && !DB::isArray(DB::removeNullable(description.data_types[i])))
+                    index.point_values.emplace(i, values->second);
+            }
+            if (index.point_values.empty())
+                continue;
+            double max_conflict_probability = description.arguments.empty() ? 0.025 : description.arguments[0].get<Float64>();
+            index.hash_functions = DB::BloomFilterHash::calculationBestPractices(max_conflict_probability).second;
+        }
+        else
+            continue;
+        indexes.emplace_back(std::move(index));
+    }
+}
+
+DB::RangesInDataParts MergeTreeSkipIndexFilter::filter(DB::RangesInDataParts parts) const
+{
+    size_t marks_before = 0;
+    size_t marks_after = 0;
+    for (auto & part : parts)
+    {
+        marks_before += part.getMarksCount();
+        for (const auto & index : indexes)
+        {
+            if (part.ranges.empty())
+                break;
+            /// Written before the index was declared.
+            if (!index.helper->getDeserializedFormat(part.data_part->getDataPartStorage(), index.helper->getFileName()))
+                continue;
+            part.ranges = filterMarks(index, part.data_part, part.ranges);
+        }
+        marks_after += part.getMarksCount();
+    }
+    std::erase_if(parts, [](const DB::RangesInDataPart & part) { return part.ranges.empty(); });
+    LOG_DEBUG(
+        &Poco::Logger::get("MergeTreeSkipIndexFilter"),
+        "Skip indexes dropped {} of {} marks",
+        marks_before - marks_after,
+        marks_before);
+    return parts;
+}
+
+DB::MarkRanges
+MergeTreeSkipIndexFilter::filterMarks(const Index & index, const DB::MergeTreeData::DataPartPtr & part, const DB::MarkRanges & ranges) const
+{
+    /// Each index granule covers index_granularity marks, the final mark of the part has none.
+    const size_t index_granularity = index.helper->index.granularity;
+    const size_t marks_count = part->index_granularity.getMarksCountWithoutFinal();
+    const size_t index_marks_count = (marks_count + index_granularity - 1) / index_granularity;
+    DB::MarkRanges index_ranges;
+    for (const auto & range : ranges)
+        index_ranges.emplace_back(
+            range.begin / index_granularity, std::min((range.end + index_granularity - 1) / index_granularity, index_marks_count));
+
+    DB::MergeTreeReaderSettings reader_settings{
+        .read_settings = context->getReadSettings(),
+        .save_marks_in_cache = true,
+        .checksum_on_read = context->getSettingsRef().checksum_on_read,
+    };
+    DB::MergeTreeIndexReader reader(
+        index.helper,
+        part,
+        index_marks_count,
+        index_ranges,
+        context->getIndexMarkCache().get(),
+        context->getIndexUncompressedCache().get(),
+        reader_settings);
+
+    DB::MarkRanges result;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        const auto & index_range = index_ranges[i];
+        if (index_range.begin >= index_range.end)
+            continue;
+        reader.seek(index_range.begin);
+        for (size_t index_mark = index_range.begin; index_mark < index_range.end; ++index_mark)
+        {
+            auto granule = reader.read();
+            if (!mayBeTrueOnGranule(index, *granule))
+                continue;
+            DB::MarkRange range(
+                std::max(ranges[i].begin, index_mark * index_granularity), std::min(ranges[i].end, (index_mark + 1) * index_granularity));
+            if (!result.empty() && result.back().end == range.begin)
+                result.back().end = range.end;
+            else
+                result.emplace_back(range);
+        }
+    }
+    return result;
+}
+
+bool MergeTreeSkipIndexFilter::mayBeTrueOnGranule(const Index & index, const DB::IMergeTreeIndexGranule & granule)
+{
+    const auto & description = index.helper->index;
+    if (granule.empty())
+        return true;
+
+    if (const auto * min_max = typeid_cast<const DB::MergeTreeIndexGranuleMinMax *>(&granule))
+    {
+        /// A range with a null bound is unknown.
+        for (const auto & range : min_max->hyperrectangle)
+            if (range.left.isNull() || range.right.isNull())
+                return true;
+        return index.condition->checkInHyperrectangle(min_max->hyperrectangle, description.data_types).can_be_true;
+    }
+
+    if (const auto * set = typeid_cast<const DB::MergeTreeIndexGranuleSet *>(&granule))
+    {
+        /// Past max_rows the granule keeps no values.
+        if (set->max_rows && set->size() > set->max_rows)
+            return true;
+        for (size_t row = 0; row < set->size(); ++row)
+        {
+            std::vector<DB::Range> point;
+            for (size_t i = 0; i < description.column_names.size(); ++i)
+            {
+                DB::Field value = (*set->block.getByPosition(i).column)[row];
+                if (value.isNull())
+                    return true;
+                point.emplace_back(value);
+            }
+            if (index.condition->checkInHyperrectangle(point, description.data_types).can_be_true)
+                return true;
+        }
+        return false;
+    }
+
+    if (const auto * bloom = typeid_cast<const DB::MergeTreeIndexGranuleBloomFilter *>(&granule))
+    {
+        /// Every index column looked for has to have one of its values in the granule.
+        const auto & filters = bloom->getFilters();
+        for (const auto & [position, values] : index.point_values)
+        {
+            auto type = DB::BloomFilter::getPrimitiveType(description.data_types[position]);
+            bool found = false;
+            for (const auto & value : values)
+            {
+                auto converted = DB::convertFieldToType(value, *type);
+                if (converted.isNull())
+                    continue;
+                UInt64 hash = DB::BloomFilterHash::hashWithField(type.get(), converted);
+                bool contains = true;
+                for (size_t i = 0; contains && i < index.hash_functions; ++i)
+                    contains = filters[position]->findHashWithSeed(hash, DB::BloomFilterHash::bf_hash_seed[i]);
+                if (contains)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                return false;
+        }
+        return true;
+    }
+    return true;
+}
+}
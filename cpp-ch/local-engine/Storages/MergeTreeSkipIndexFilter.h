@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <Interpreters/ActionsDAG.h>
+#include <Interpreters/Context_fwd.h>
+#include <Storages/MergeTree/KeyCondition.h>
+#include <Storages/MergeTree/MergeTreeData.h>
+#include <Storages/MergeTree/MergeTreeIndices.h>
+#include <Storages/MergeTree/RangesInDataPart.h>
+#include <Storages/StorageInMemoryMetadata.h>
+
+namespace local_engine
+{
+/// Drops the granules of the parts that the skip indexes of the table tell can't pass the filter of the scan: minmax
+/// indexes by the ranges of the granules, set indexes by their values, and bloom_filter indexes by the values the
+/// equals and in conjuncts of the filter look for. The parts written without an index are read whole by it.
+class MergeTreeSkipIndexFilter
+{
+public:
+    /// The filter is over the columns of the table, its only output telling the rows passing.
+    MergeTreeSkipIndexFilter(const DB::StorageMetadataPtr & metadata, const DB::ActionsDAGPtr & filter, DB::ContextPtr context_);
+
+    /// Whether any index of the table can drop granules by the filter.
+    bool useful() const { return !indexes.empty(); }
+
+    /// The marks left to read of the given ones, without the parts left with none.
+    DB::RangesInDataParts filter(DB::RangesInDataParts parts) const;
+
+private:
+    struct Index
+    {
+        DB::MergeTreeIndexPtr helper;
+        /// Of the minmax and set indexes.
+        std::optional<DB::KeyCondition> condition;
+        /// Of the bloom_filter indexes, the values looked for by the position of the index column.
+        std::unordered_map<size_t, DB::Fields> point_values;
+        size_t hash_functions = 0;
+    };
+
+    DB::ContextPtr context;
+    std::vector<Index> indexes;
+
+    DB::MarkRanges filterMarks(const Index & index, const DB::MergeTreeData::DataPartPtr & part, const DB::MarkRanges & ranges) const;
+    static bool mayBeTrueOnGranule(const Index & index, const DB::IMergeTreeIndexGranule & granule);
+};
+}
@@ -3,11 +3,94 @@
 //
 
 #include "BlockStripeSplitter.h"
+#include <cstring>
+#include <Columns/ColumnConst.h>
+#include <Columns/ColumnLowCardinality.h>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Common/PODArray.h>
+#include <Common/typeid_cast.h>
 
 
 using namespace local_engine;
 
+namespace
+{
+/// marks[j] is set for each row j whose value differs from the one of row j - 1.
+using Marks = DB::PaddedPODArray<UInt8>;
+
+template <typename T>
+void markFixedChanges(const char * data, size_t rows, Marks & marks)
+{
+    const auto * values = reinterpret_cast<const T *>(data);
+    for (size_t j = 1; j < rows; ++j)
+        marks[j] |= values[j - 1] != values[j];
+}
+
+void markValueChanges(const DB::IColumn & column, Marks & marks)
+{
+    const size_t rows = column.size();
+    if (rows < 2 || isColumnConst(column))
+        return;
+
+    if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(&column))
+    {
+        /// The nested values of the null rows are ignored.
+        Marks nested_marks(rows, 0);
+        markValueChanges(nullable->getNestedColumn(), nested_marks);
+        const auto & null_map = nullable->getNullMapData();
+        for (size_t j = 1; j < rows; ++j)
+            marks[j] |= (null_map[j - 1] != null_map[j]) | (nested_marks[j] & !null_map[j]);
+    }
+    else if (const auto * low_cardinality = typeid_cast<const DB::ColumnLowCardinality *>(&column))
+    {
+        /// The values of the dictionary are unique.
+        markValueChanges(low_cardinality->getIndexes(), marks);
+    }
+    else if (const auto * string = typeid_cast<const DB::ColumnString *>(&column))
+    {
+        const auto & offsets = string->getOffsets();
+        const auto * chars = string->getChars().data();
+        for (size_t j = 1; j < rows; ++j)
+        {
+            /// offsets[-1] is 0.
+            const size_t prev_size = offsets[j - 1] - offsets[j - 2];
+            const size_t size = offsets[j] - offsets[j - 1];
+            marks[j] |= size != prev_size || memcmp(chars + offsets[j - 2], chars + offsets[j - 1], size) != 0;
+        }
+    }
+    else if (column.isFixedAndContiguous())
+    {
+        /// Compared bitwise, so 0.0 and -0.0 differ, as do the partition paths they are written to.
+        const char * data = column.getRawData().data();
+        const size_t width = column.sizeOfValueIfFixed();
+        switch (width)
+        {
+            case 1:
+                markFixedChanges<UInt8>(data, rows, marks);
+                break;
+            case 2:
+                markFixedChanges<UInt16>(data, rows, marks);
+                break;
+            case 4:
+                markFixedChanges<UInt32>(data, rows, marks);
+                break;
+            case 8:
+                markFixedChanges<UInt64>(data, rows, marks);
+                break;
+            default:
+                for (size_t j = 1; j < rows; ++j)
+                    marks[j] |= memcmp(data + (j - 1) * width, data + j * width, width) != 0;
+        }
+    }
+    else
+    {
+        for (size_t j = 1; j < rows; ++j)
+            marks[j] |= column.compareAt(j - 1, j, column, 1) != 0;
+    }
+}
+}
+
 BlockStripes
 local_engine::BlockStripeSplitter::split(const DB::Block & block, const std::vector<size_t> partitionColIndice, const bool hasBucket)
 {
@@ -20,6 +103,7 @@ local_engine::BlockStripeSplitter::split(const DB::Block & block, const std::vec
     std::vector<size_t> columns = partitionColIndice;
     if (hasBucket)
         columns.push_back(block.columns() - 1);
+    Marks marks(block.rows(), 0);
     for (size_t i = 0; i < columns.size(); i++)
     {
         auto columnPtr = block.getColumns().at(columns.at(i));
@@ -28,23 +112,13 @@ local_engine::BlockStripeSplitter::split(const DB::Block & block, const std::vec
             // no value changes for this whole column
             continue;
         }
-
-        for (size_t j = 1; j < block.rows(); ++j)
-        {
-            if (columnPtr->compareAt(j - 1, j, *columnPtr, 1) != 0)
-            {
-                //                std::cout << "j-1(nullable): " << columnPtr->isNullAt(j - 1) << "; j(nullable):" << columnPtr->isNullAt(j) << std::endl;
-                //                std::cout << "j-1: " << static_cast<const DB::ColumnNullable *>(columnPtr.get())->getNestedColumn().getInt(j - 1) <<
-                //                    "; j:" << static_cast<const DB::ColumnNullable *>(columnPtr.get())->getNestedColumn().getInt(j ) << std::endl;
-                splitPoints.push_back(j);
-            }
-        }
+        markValueChanges(*columnPtr, marks);
     }
 
-    //sort split points
-    std::sort(splitPoints.begin(), splitPoints.end());
-    //dedup split points
-    splitPoints.erase(std::unique(splitPoints.begin(), splitPoints.end()), splitPoints.end());
+    // in order of the rows, no dups
+    for (size_t j = 1; j < block.rows(); ++j)
+        if (marks[j])
+            splitPoints.push_back(j);
     splitPoints.push_back(block.rows());
 
     //    if (splitPoints.size() == 1)
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FileColumnStats.h"
+#include <sstream>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsCommon.h>
+#include <Columns/IColumn.h>
+#include <Common/FieldVisitorToString.h>
+#include <Common/HashTable/Hash.h>
+#include <Common/WeakHash.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+
+namespace local_engine
+{
+FileColumnStats::FileColumnStats(const DB::Names & names_)
+{
+    columns.resize(names_.size());
+    for (size_t i = 0; i < names_.size(); ++i)
+        columns[i].name = names_[i];
+}
+
+void FileColumnStats::add(const DB::Block & block)
+{
+    const size_t rows = block.rows();
+    num_rows += rows;
+    for (size_t i = 0; i < columns.size() && i < block.columns(); ++i)
+    {
+        auto & stats = columns[i];
+        const auto column = block.getByPosition(i).column->convertToFullColumnIfConst();
+
+        const UInt8 * null_map = nullptr;
+        if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(column.get()))
+        {
+            null_map = nullable->getNullMapData().data();
+            stats.null_count += DB::countBytesInFilter(nullable->getNullMapData());
+        }
+
+        /// The nulls are skipped by the extremes of the nullable columns, which are null if all are.
+        DB::Field min;
+        DB::Field max;
+        column->getExtremes(min, max);
+        if (!min.isNull())
+        {
+            if (stats.min.isNull() || min < stats.min)
+                stats.min = std::move(min);
+            if (stats.max.isNull() || stats.max < max)
+                stats.max = std::move(max);
+        }
+
+        DB::WeakHash32 hash(rows);
+        column->updateWeakHash32(hash);
+        const auto & hash_data = hash.getData();
+        for (size_t row = 0; row < rows; ++row)
+            if (!null_map || !null_map[row])
+                stats.ndv.insert(hash_data[row]);
+    }
+}
+
+String FileColumnStats::toJSON() const
+{
+    Poco::JSON::Object result;
+    Poco::JSON::Array json_columns;
+    for (const auto & stats : columns)
+    {
+        Poco::JSON::Object json_column;
+        json_column.set("name", stats.name);
+        json_column.set("nullCount", stats.null_count);
+        if (!stats.min.isNull())
+        {
+            auto to_text = [](const DB::Field & field)
+            { return field.getType() == DB::Field::Types::String ? field.get<String>() : applyVisitor(DB::FieldVisitorToString(), field); };
+            json_column.set("min", to_text(stats.min));
+            json_column.set("max", to_text(stats.max));
+            json_column.set("ndv", stats.ndv.size());
+        }
+        json_columns.add(json_column);
+    }
+    result.set("numRows", num_rows);
+    result.set("columns", json_columns);
+    std::ostringstream out;
+    result.stringify(out);
+    return out.str();
+}
+}
@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+#include <Core/Block.h>
+#include <Core/Field.h>
+#include <Common/HyperLogLogCounter.h>
+
+namespace local_engine
+{
+/// The column statistics of a file accumulated from the blocks written to it: null count, min, max and the NDV estimated
+/// by a HyperLogLog sketch.
+class FileColumnStats
+{
+public:
+    /// The names reported for the columns of the blocks, by position.
+    explicit FileColumnStats(const DB::Names & names_);
+
+    void add(const DB::Block & block);
+
+    /// {"numRows": ..., "columns": [{"name": ..., "nullCount": ..., "min": ..., "max": ..., "ndv": ...}, ...]}, min and
+    /// max in their text form.
+    String toJSON() const;
+
+private:
+    struct Column
+    {
+        String name;
+        size_t null_count = 0;
+        DB::Field min;
+        DB::Field max;
+        HyperLogLogCounter<12> ndv;
+    };
+
+    std::vector<Column> columns;
+    size_t num_rows = 0;
+};
+}
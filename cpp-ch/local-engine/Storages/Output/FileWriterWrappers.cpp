@@ -21,14 +21,23 @@
 #include <Processors/QueryPlan/QueryPlan.h>
 #include <Processors/QueryPlan/ReadFromPreparedSource.h>
 #include <QueryPipeline/QueryPipeline.h>
+#include <Common/CurrentThread.h>
+#include <Common/scope_guard_safe.h>
 
 namespace local_engine
 {
 
 NormalFileWriter::NormalFileWriter(OutputFormatFilePtr file_, DB::ContextPtr context_) : FileWriterWrapper(file_), context(context_)
 {
+    max_queued_blocks = context->getConfigRef().getUInt64("file_writer.max_queued_blocks", 0);
+    collect_column_stats = context->getConfigRef().getBool("file_writer.column_stats", false);
 }
 
+NormalFileWriter::~NormalFileWriter()
+{
+    /// Not closed, e.g. the task failed.
+    stopFlusher();
+}
 
 void NormalFileWriter::consume(DB::Block & block)
 {
@@ -38,13 +47,94 @@ void NormalFileWriter::consume(DB::Block & block)
         output_format = file->createOutputFormat(block.cloneEmpty());
         pipeline = std::make_unique<DB::QueryPipeline>(output_format->output);
         writer = std::make_unique<DB::PushingPipelineExecutor>(*pipeline);
+        if (collect_column_stats)
+            column_stats = std::make_unique<FileColumnStats>(output_format->output->getHeader().getNames());
+        if (max_queued_blocks > 0)
+        {
+            auto thread_group = DB::CurrentThread::getGroup();
+            flusher = std::make_unique<ThreadFromGlobalPool>(
+                [this, thread_group]()
+                {
+                    if (thread_group)
+                        DB::CurrentThread::attachToGroupIfDetached(thread_group);
+                    SCOPE_EXIT_SAFE(if (thread_group) DB::CurrentThread::detachFromGroupIfNotDetached(););
+                    flushQueuedBlocks();
+                });
+        }
     }
+    raw_bytes += block.bytes();
+    if (column_stats)
+        column_stats->add(block);
+    if (!flusher)
+    {
+        push(std::move(block));
+        return;
+    }
+
+    std::unique_lock lock(mutex);
+    queue_changed.wait(lock, [this] { return queued_blocks.size() < max_queued_blocks || flush_error; });
+    if (flush_error)
+        std::rethrow_exception(flush_error);
+    queued_blocks.emplace_back(std::move(block));
+    queue_changed.notify_all();
+}
+
+void NormalFileWriter::push(DB::Block block)
+{
     writer->push(std::move(block));
+    written_bytes = output_format->write_buffer->count();
+}
+
+void NormalFileWriter::flushQueuedBlocks()
+{
+    while (true)
+    {
+        DB::Block block;
+        {
+            std::unique_lock lock(mutex);
+            queue_changed.wait(lock, [this] { return !queued_blocks.empty() || closing; });
+            if (queued_blocks.empty())
+                return;
+            block = std::move(queued_blocks.front());
+            queued_blocks.pop_front();
+            queue_changed.notify_all();
+        }
+        try
+        {
+            push(std::move(block));
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            flush_error = std::current_exception();
+            queued_blocks.clear();
+            queue_changed.notify_all();
+            return;
+        }
+    }
+}
+
+void NormalFileWriter::stopFlusher()
+{
+    if (!flusher)
+        return;
+    {
+        std::lock_guard lock(mutex);
+        closing = true;
+        queue_changed.notify_all();
+    }
+    /// The flusher drains the queue before it returns.
+    flusher->join();
+    flusher.reset();
 }
 
 void NormalFileWriter::close()
 {
+    stopFlusher();
+    if (flush_error)
+        std::rethrow_exception(flush_error);
     writer->finish();
+    file->onFinish(output_format, raw_bytes);
 }
 
 FileWriterWrapper *
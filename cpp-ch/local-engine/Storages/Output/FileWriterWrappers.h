@@ -16,6 +16,11 @@
  */
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <Columns/IColumn.h>
 #include <Core/Block.h>
 #include <Core/ColumnsWithTypeAndName.h>
@@ -25,10 +30,12 @@
 #include <Processors/Chunk.h>
 #include <Processors/Executors/PushingPipelineExecutor.h>
 #include <Processors/ISource.h>
+#include <Storages/Output/FileColumnStats.h>
 #include <Storages/Output/OutputFormatFile.h>
 #include <Storages/Output/WriteBufferBuilder.h>
 #include <Storages/SourceFromJavaIter.h>
 #include <base/types.h>
+#include <Common/ThreadPool.h>
 
 namespace local_engine
 {
@@ -40,6 +47,10 @@ public:
     virtual ~FileWriterWrapper() = default;
     virtual void consume(DB::Block & block) = 0;
     virtual void close() = 0;
+    /// The column statistics of the file written as JSON, empty if not collected. Called after close().
+    virtual String fileStats() const { return ""; }
+    /// The bytes of the file so far, the row group or stripe buffered by the output format excluded.
+    virtual size_t writtenBytes() const { return 0; }
 
 protected:
     OutputFormatFilePtr file;
@@ -53,16 +64,40 @@ public:
     //TODO: EmptyFileReader and ConstColumnsFileReader ?
     //TODO: to support complex types
     NormalFileWriter(OutputFormatFilePtr file_, DB::ContextPtr context_);
-    ~NormalFileWriter() override = default;
+    ~NormalFileWriter() override;
     void consume(DB::Block & block) override;
     void close() override;
+    String fileStats() const override { return column_stats ? column_stats->toJSON() : ""; }
+    size_t writtenBytes() const override { return written_bytes; }
 
 private:
+    /// Pushes the queued blocks into the pipeline until closed or failed, on the flusher thread.
+    void flushQueuedBlocks();
+    void stopFlusher();
+    /// Pushes the block into the pipeline, on either thread.
+    void push(DB::Block block);
+
     DB::ContextPtr context;
 
     OutputFormatFile::OutputFormatPtr output_format;
     std::unique_ptr<DB::QueryPipeline> pipeline;
     std::unique_ptr<DB::PushingPipelineExecutor> writer;
+    size_t raw_bytes = 0;
+    /// Of the write buffer, updated by the thread pushing the blocks.
+    std::atomic<size_t> written_bytes = 0;
+    /// Created at the first block if collected.
+    bool collect_column_stats = false;
+    std::unique_ptr<FileColumnStats> column_stats;
+
+    /// Blocks consumed but not yet pushed by the flusher, so that their encoding and the writes of the file overlap the
+    /// task producing the next ones. 0 pushes them on the task thread.
+    size_t max_queued_blocks = 0;
+    std::mutex mutex;
+    std::condition_variable queue_changed;
+    std::deque<DB::Block> queued_blocks;
+    bool closing = false;
+    std::exception_ptr flush_error;
+    std::unique_ptr<ThreadFromGlobalPool> flusher;
 };
 
 FileWriterWrapper *
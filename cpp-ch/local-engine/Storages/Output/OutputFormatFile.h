@@ -49,6 +49,9 @@ public:
 
     virtual OutputFormatPtr createOutputFormat(const DB::Block & header_) = 0;
 
+    /// Called once the output format is finished, with the bytes of the blocks written to it.
+    virtual void onFinish(const OutputFormatPtr & /*output_format*/, size_t /*raw_bytes*/) { }
+
 protected:
     DB::Block creatHeaderWithPreferredColumnNames(const DB::Block & header);
 
@@ -18,8 +18,12 @@
 
 #if USE_PARQUET
 
+#    include <algorithm>
 #    include <memory>
+#    include <mutex>
+#    include <optional>
 #    include <string>
+#    include <unordered_map>
 #    include <utility>
 
 #    include <Formats/FormatFactory.h>
@@ -32,6 +36,47 @@
 
 namespace local_engine
 {
+namespace
+{
+/// The encoded bytes per raw byte of the files written last with each header structure, learned as the row groups are
+/// sized by the raw bytes of the blocks squashed into them.
+class EncodedRatios
+{
+public:
+    static EncodedRatios & instance()
+    {
+        static EncodedRatios ratios;
+        return ratios;
+    }
+
+    std::optional<double> get(const String & structure)
+    {
+        std::lock_guard lock(mutex);
+        auto it = ratios.find(structure);
+        if (it == ratios.end())
+            return {};
+        return it->second;
+    }
+
+    void update(const String & structure, double ratio)
+    {
+        std::lock_guard lock(mutex);
+        if (ratios.size() >= max_size && !ratios.contains(structure))
+            ratios.clear();
+        auto [it, inserted] = ratios.try_emplace(structure, ratio);
+        /// Smoothed for the files of skewed contents.
+        if (!inserted)
+            it->second = (it->second + ratio) / 2;
+    }
+
+private:
+    static constexpr size_t max_size = 1024;
+
+    std::mutex mutex;
+    std::unordered_map<String, double> ratios;
+};
+}
+
 ParquetOutputFormatFile::ParquetOutputFormatFile(
     DB::ContextPtr context_,
     const std::string & file_uri_,
@@ -49,9 +94,38 @@ OutputFormatFile::OutputFormatPtr ParquetOutputFormatFile::createOutputFormat(co
     auto new_header = creatHeaderWithPreferredColumnNames(header);
     // TODO: align all spark parquet config with ch parquet config
     auto format_settings = DB::getFormatSettings(context);
+
+    /// ParquetBlockOutputFormat cuts the row groups by raw bytes, whose encoded size varies much by the column types, so
+    /// the raw bytes of a row group are derived from its target encoded size with the ratio of the previous files.
+    const auto & config = context->getConfigRef();
+    structure = new_header.getNamesAndTypesList().toString();
+    const auto target_bytes = config.getUInt64("parquet.write.row_group_target_bytes", 128UL << 20);
+    const auto max_buffer_bytes = config.getUInt64("parquet.write.row_group_max_buffer_bytes", format_settings.parquet.row_group_bytes);
+    const auto ratio = EncodedRatios::instance().get(structure).value_or(1.0);
+    format_settings.parquet.row_group_bytes
+        = std::clamp<UInt64>(static_cast<UInt64>(static_cast<double>(target_bytes) / ratio), 1, std::max(target_bytes, max_buffer_bytes));
+    format_settings.parquet.row_group_rows = config.getUInt64("parquet.write.row_group_max_rows", 100000000);
+
+    /// The column chunks of a row group are encoded in parallel by the native encoder.
+    const auto encoder_threads = config.getUInt64("parquet.write.encoder_threads", 1);
+    if (encoder_threads > 1)
+    {
+        format_settings.parquet.use_custom_encoder = true;
+        format_settings.parquet.parallel_encoding = true;
+        format_settings.max_threads = encoder_threads;
+    }
     auto output_format = std::make_shared<DB::ParquetBlockOutputFormat>(*(res->write_buffer), new_header, format_settings);
     res->output = output_format;
     return res;
 }
+
+void ParquetOutputFormatFile::onFinish(const OutputFormatPtr & output_format, size_t raw_bytes)
+{
+    if (!output_format || raw_bytes == 0)
+        return;
+    /// Including the footer, negligible for the files of big row groups, which the ratio matters for.
+    const auto encoded_bytes = output_format->write_buffer->count();
+    EncodedRatios::instance().update(structure, static_cast<double>(encoded_bytes) / raw_bytes);
+}
 }
 #endif
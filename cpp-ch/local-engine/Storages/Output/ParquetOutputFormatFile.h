@@ -37,6 +37,11 @@ public:
     ~ParquetOutputFormatFile() override = default;
 
     OutputFormatFile::OutputFormatPtr createOutputFormat(const DB::Block & header) override;
+    void onFinish(const OutputFormatPtr & output_format, size_t raw_bytes) override;
+
+private:
+    /// The structure of the header, the files of the same one share the ratio of their encoded to raw bytes.
+    String structure;
 };
 
 }
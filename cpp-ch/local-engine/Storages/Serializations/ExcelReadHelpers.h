@@ -111,7 +111,7 @@ inline bool readExcelIntegerText(T & x, DB::ReadBuffer & buf, bool has_quote, co
         return true;
     }
     else
-        return readExcelIntTextImpl(x, buf, has_quote, settings);
+        return tryReadExcelPlainIntText(x, buf, has_quote, settings) || readExcelIntTextImpl(x, buf, has_quote, settings);
 }
 
 inline bool readExcelText(is_floating_point auto & x, DB::ReadBuffer & buf, bool has_quote, const DB::FormatSettings & settings)
@@ -19,6 +19,7 @@
 #include <Core/ColumnsWithTypeAndName.h>
 #include <DataTypes/DataTypesNumber.h>
 #include <Processors/Transforms/AggregatingTransform.h>
+#include <jni/SharedPointerWrapper.h>
 #include <jni/jni_common.h>
 #include <Common/CHUtil.h>
 #include <Common/DebugUtils.h>
@@ -30,6 +31,7 @@ namespace local_engine
 jclass SourceFromJavaIter::serialized_record_batch_iterator_class = nullptr;
 jmethodID SourceFromJavaIter::serialized_record_batch_iterator_hasNext = nullptr;
 jmethodID SourceFromJavaIter::serialized_record_batch_iterator_next = nullptr;
+jmethodID SourceFromJavaIter::serialized_record_batch_iterator_ringBuffer = nullptr;
 
 
 static DB::Block getRealHeader(const DB::Block & header)
@@ -38,12 +40,51 @@ static DB::Block getRealHeader(const DB::Block & header)
         return header;
     return BlockUtil::buildRowCountHeader();
 }
-SourceFromJavaIter::SourceFromJavaIter(DB::Block header, jobject java_iter_)
-    : DB::ISource(getRealHeader(header)), java_iter(java_iter_), original_header(header)
+SourceFromJavaIter::SourceFromJavaIter(DB::Block header, jobject java_iter_, size_t target_block_bytes_)
+    : DB::ISource(getRealHeader(header)), java_iter(java_iter_), original_header(header), target_block_bytes(target_block_bytes_)
 {
+    GET_JNIENV(env)
+    jlong ring_buffer_address = safeCallLongMethod(env, java_iter, serialized_record_batch_iterator_ringBuffer);
+    if (ring_buffer_address)
+        ring_buffer = SharedPointerWrapper<BlockRingBuffer>::sharedPtr(ring_buffer_address);
+    CLEAN_JNIENV
 }
 DB::Chunk SourceFromJavaIter::generate()
 {
+    if (pending_offset >= pending.getNumRows())
+    {
+        pending_offset = 0;
+        pending = pull();
+        size_t bytes = pending.bytes();
+        if (!target_block_bytes || pending.getNumRows() <= 1 || bytes <= 2 * target_block_bytes)
+        {
+            DB::Chunk result = std::move(pending);
+            pending.clear();
+            return result;
+        }
+    }
+
+    size_t rows = pending.getNumRows();
+    size_t step = std::max<size_t>(rows * target_block_bytes / pending.bytes(), 1);
+    size_t length = std::min(step, rows - pending_offset);
+    DB::Columns columns;
+    columns.reserve(pending.getNumColumns());
+    for (const auto & column : pending.getColumns())
+        columns.emplace_back(column->cut(pending_offset, length));
+    pending_offset += length;
+    DB::Chunk result(std::move(columns), length);
+    result.setChunkInfo(pending.getChunkInfo());
+    return result;
+}
+
+DB::Chunk SourceFromJavaIter::pull()
+{
+    if (ring_buffer)
+    {
+        auto block = ring_buffer->pop();
+        return block ? toChunk(*block) : DB::Chunk{};
+    }
+
     GET_JNIENV(env)
     jboolean has_next = safeCallBooleanMethod(env, java_iter, serialized_record_batch_iterator_hasNext);
     DB::Chunk result;
@@ -51,29 +92,37 @@ DB::Chunk SourceFromJavaIter::generate()
     {
         jbyteArray block = static_cast<jbyteArray>(safeCallObjectMethod(env, java_iter, serialized_record_batch_iterator_next));
         DB::Block * data = reinterpret_cast<DB::Block *>(byteArrayToLong(env, block));
-        if (data->rows() > 0)
+        result = toChunk(*data);
+    }
+    CLEAN_JNIENV
+    return result;
+}
+DB::Chunk SourceFromJavaIter::toChunk(DB::Block & data)
+{
+    DB::Chunk result;
+    if (data.rows() > 0)
+    {
+        size_t rows = data.rows();
+        if (original_header.columns())
         {
-            size_t rows = data->rows();
-            if (original_header.columns())
-            {
-                result.setColumns(data->mutateColumns(), rows);
-                convertNullable(result);
-                auto info = std::make_shared<DB::AggregatedChunkInfo>();
-                info->is_overflows = data->info.is_overflows;
-                info->bucket_num = data->info.bucket_num;
-                result.setChunkInfo(info);
-            }
-            else
-            {
-                result = BlockUtil::buildRowCountChunk(rows);
-            }
+            result.setColumns(data.mutateColumns(), rows);
+            convertNullable(result);
+            auto info = std::make_shared<DB::AggregatedChunkInfo>();
+            info->is_overflows = data.info.is_overflows;
+            info->bucket_num = data.info.bucket_num;
+            result.setChunkInfo(info);
+        }
+        else
+        {
+            result = BlockUtil::buildRowCountChunk(rows);
         }
     }
-    CLEAN_JNIENV
     return result;
 }
 SourceFromJavaIter::~SourceFromJavaIter()
 {
+    if (ring_buffer)
+        ring_buffer->cancel();
     GET_JNIENV(env)
     env->DeleteGlobalRef(java_iter);
     CLEAN_JNIENV
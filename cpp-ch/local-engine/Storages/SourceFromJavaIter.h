@@ -17,6 +17,7 @@
 #pragma once
 #include <jni.h>
 #include <Processors/ISource.h>
+#include <Storages/BlockRingBuffer.h>
 
 namespace local_engine
 {
@@ -26,20 +27,30 @@ public:
     static jclass serialized_record_batch_iterator_class;
     static jmethodID serialized_record_batch_iterator_hasNext;
     static jmethodID serialized_record_batch_iterator_next;
+    static jmethodID serialized_record_batch_iterator_ringBuffer;
 
     static Int64 byteArrayToLong(JNIEnv * env, jbyteArray arr);
 
-    SourceFromJavaIter(DB::Block header, jobject java_iter_);
+    /// The blocks of more than twice target_block_bytes_ are split into blocks of about target_block_bytes_, unless 0.
+    SourceFromJavaIter(DB::Block header, jobject java_iter_, size_t target_block_bytes_ = 0);
     ~SourceFromJavaIter() override;
 
     String getName() const override { return "SourceFromJavaIter"; }
 
 private:
     DB::Chunk generate() override;
+    DB::Chunk pull();
+    DB::Chunk toChunk(DB::Block & data);
     void convertNullable(DB::Chunk & chunk);
 
     jobject java_iter;
     DB::Block original_header;
+    /// Set if the Java iterator pushes its blocks from a thread of its own, which are then pulled without JNI calls
+    BlockRingBufferPtr ring_buffer;
+    size_t target_block_bytes;
+    /// The chunk being split, and its rows returned already.
+    DB::Chunk pending;
+    size_t pending_offset = 0;
 };
 
 }
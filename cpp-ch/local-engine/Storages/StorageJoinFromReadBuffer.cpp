@@ -16,12 +16,16 @@
  */
 #include "StorageJoinFromReadBuffer.h"
 
+#include <DataTypes/DataTypeNullable.h>
 #include <Formats/NativeReader.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/HashJoin.h>
 #include <Interpreters/TableJoin.h>
-#include <QueryPipeline/ProfileInfo.h>
+#include <base/scope_guard.h>
+#include <Common/ConcurrentBoundedQueue.h>
 #include <Common/Exception.h>
+#include <Common/JNIUtils.h>
+#include <Common/ThreadPool.h>
 
 namespace DB
 {
@@ -47,18 +51,55 @@ void StorageJoinFromReadBuffer::restore()
     {
         throw std::runtime_error("input reader buffer is not available");
     }
-    ContextPtr ctx = nullptr;
     NativeReader block_stream(*in, 0);
 
-    ProfileInfo info;
-    {
-        while (Block block = block_stream.read())
+    /// HashJoin takes the blocks one at a time, so the next blocks are read and decoded while one is inserted.
+    ConcurrentBoundedQueue<Block> blocks(DECODED_BLOCKS_QUEUE_SIZE);
+    std::exception_ptr decode_exception;
+    ThreadFromGlobalPool decoder(
+        [&]()
         {
-            auto final_block = sample_block.cloneWithColumns(block.mutateColumns());
-            info.update(final_block);
-            join->addBlockToJoin(final_block, true);
-        }
+            /// in may read from a Java input stream. The thread is attached to the JVM once for all the reads, rather
+            /// than attached and detached by each of them.
+            int attached;
+            JNIUtils::getENV(&attached);
+            SCOPE_EXIT({
+                if (attached)
+                    JNIUtils::detachCurrentThread();
+            });
+            try
+            {
+                while (Block block = block_stream.read())
+                    if (!blocks.emplace(sample_block.cloneWithColumns(block.mutateColumns())))
+                        break;
+            }
+            catch (...)
+            {
+                decode_exception = std::current_exception();
+            }
+            blocks.finish();
+        });
+    SCOPE_EXIT({
+        blocks.clearAndFinish();
+        if (decoder.joinable())
+            decoder.join();
+    });
+
+    Block block;
+    Blocks build_blocks;
+    while (blocks.pop(block))
+    {
+        updateKeyRanges(block);
+        if (join)
+            join->addBlockToJoin(block, true);
+        else
+            build_blocks.emplace_back(std::move(block));
     }
+    decoder.join();
+    if (decode_exception)
+        std::rethrow_exception(decode_exception);
+    if (!join)
+        build_block = build_blocks.empty() ? sample_block.cloneEmpty() : concatenateBlocks(build_blocks);
     in.reset();
 }
 
@@ -90,13 +131,64 @@ StorageJoinFromReadBuffer::StorageJoinFromReadBuffer(
         if (!storage_metadata_.getColumns().hasPhysical(key))
             throw Exception(ErrorCodes::NO_SUCH_COLUMN_IN_TABLE, "Key column ({}) does not exist in table declaration.", key);
 
-    table_join = std::make_shared<TableJoin>(limits, use_nulls, kind, strictness, key_names);
-    join = std::make_shared<HashJoin>(table_join, getRightSampleBlock(), overwrite);
+    for (const auto & key : key_names)
+    {
+        // Floats are left out for NaN, which doesn't order.
+        WhichDataType which(removeNullable(sample_block.getByName(key).type));
+        if (which.isInt() || which.isUInt() || which.isDate() || which.isDate32() || which.isDecimal() || which.isStringOrFixedString())
+            key_ranges.emplace(key, std::nullopt);
+    }
+
+    if (!key_names.empty())
+    {
+        table_join = std::make_shared<TableJoin>(limits, use_nulls, kind, strictness, key_names);
+        join = std::make_shared<HashJoin>(table_join, getRightSampleBlock(), overwrite);
+    }
     restore();
 }
 
+void StorageJoinFromReadBuffer::updateKeyRanges(const Block & block)
+{
+    for (auto & [key_name, range] : key_ranges)
+    {
+        Field min;
+        Field max;
+        /// Nulls are skipped, all nulls give null extremes.
+        block.getByName(key_name).column->getExtremes(min, max);
+        if (min.isNull())
+            continue;
+        if (!range)
+            range.emplace(min, max);
+        else
+        {
+            if (min < range->first)
+                range->first = min;
+            if (range->second < max)
+                range->second = max;
+        }
+    }
+}
+
+std::optional<std::pair<DB::Field, DB::Field>> StorageJoinFromReadBuffer::getKeyRange(const String & key_name) const
+{
+    auto it = key_ranges.find(key_name);
+    return it == key_ranges.end() ? std::nullopt : it->second;
+}
+
+size_t StorageJoinFromReadBuffer::getTotalRowCount() const
+{
+    return join ? join->getTotalRowCount() : build_block.rows();
+}
+
+size_t StorageJoinFromReadBuffer::getTotalByteCount() const
+{
+    return join ? join->getTotalByteCount() : build_block.allocatedBytes();
+}
+
 DB::HashJoinPtr StorageJoinFromReadBuffer::getJoinLocked(std::shared_ptr<DB::TableJoin> analyzed_join, DB::ContextPtr /*context*/) const
 {
+    if (!join)
+        throw Exception(ErrorCodes::LOGICAL_ERROR, "Table {} has no join keys to join by hash.", storage_metadata_.comment);
     if (!analyzed_join->sameStrictnessAndKind(strictness, kind))
         throw Exception(ErrorCodes::INCOMPATIBLE_TYPE_OF_JOIN, "Table {} has incompatible type of JOIN.", storage_metadata_.comment);
 
@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <optional>
+#include <unordered_map>
 #include <Interpreters/JoinUtils.h>
 #include <Storages/StorageInMemoryMetadata.h>
 
@@ -57,10 +59,25 @@ public:
         return block;
     }
 
+    /// Without join keys the blocks read are kept instead of a hash join, for a nested loop join.
+    bool hasJoinKeys() const { return !key_names.empty(); }
+    /// All the blocks read concatenated, without join keys.
+    const DB::Block & getBuildBlock() const { return build_block; }
+
+    size_t getTotalRowCount() const;
+    size_t getTotalByteCount() const;
+
+    /// The smallest and the largest non-null values of an integral, date, decimal or string key column, absent if
+    /// the column has none or is of another type.
+    std::optional<std::pair<DB::Field, DB::Field>> getKeyRange(const String & key_name) const;
+
 protected:
     void restore();
+    void updateKeyRanges(const DB::Block & block);
 
 private:
+    static constexpr size_t DECODED_BLOCKS_QUEUE_SIZE = 16;
+
     DB::StorageInMemoryMetadata storage_metadata_;
     DB::Block sample_block;
     const DB::Names key_names;
@@ -72,7 +89,10 @@ private:
 
     std::shared_ptr<DB::TableJoin> table_join;
     DB::HashJoinPtr join;
+    DB::Block build_block;
 
     std::unique_ptr<DB::ReadBuffer> in;
+    /// By the key names with ranges collected.
+    std::unordered_map<String, std::optional<std::pair<DB::Field, DB::Field>>> key_ranges;
 };
 }
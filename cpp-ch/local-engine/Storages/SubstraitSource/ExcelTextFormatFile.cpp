@@ -31,7 +31,9 @@
 #include <Processors/Formats/IRowInputFormat.h>
 #include <Storages/HDFS/ReadBufferFromHDFS.h>
 #include <Storages/Serializations/ExcelDecimalSerialization.h>
+#include <Storages/Serializations/ExcelReadHelpers.h>
 #include <Storages/Serializations/ExcelSerialization.h>
+#include <base/find_symbols.h>
 
 
 namespace DB
@@ -236,6 +238,9 @@ bool ExcelTextFormatReader::readField(
         return false;
     }
 
+    if (tryReadFieldFast(column, type))
+        return true;
+
     char maybe_quote = *buf->position();
     bool has_quote = false;
     if ((format_settings.csv.allow_single_quotes && maybe_quote == '\'')
@@ -279,6 +284,137 @@ bool ExcelTextFormatReader::readField(
     return true;
 }
 
+namespace
+{
+template <typename T>
+bool parsePlainInteger(std::string_view cell, T & x)
+{
+    const bool negative = cell.front() == '-';
+    if (negative)
+        cell.remove_prefix(1);
+    if (cell.empty() || cell.size() > std::numeric_limits<Int64>::digits10)
+        return false;
+
+    Int64 value = 0;
+    const char * pos = cell.data();
+    const char * end = cell.data() + cell.size();
+    for (; pos + 8 <= end && DB::is_made_of_eight_digits_fast(pos); pos += 8)
+        value = value * 100000000 + parseEightDigitsFast(pos);
+    for (; pos < end; ++pos)
+    {
+        if (!isNumericASCII(*pos))
+            return false;
+        value = value * 10 + (*pos - '0');
+    }
+    if (negative)
+        value = -value;
+    if (!std::in_range<T>(value))
+        return false;
+    x = static_cast<T>(value);
+    return true;
+}
+
+template <typename T>
+bool parsePlainFloat(std::string_view cell, T & x)
+{
+    const auto res = fast_float::from_chars(cell.data(), cell.data() + cell.size(), x);
+    return res.ec == std::errc() && res.ptr == cell.data() + cell.size();
+}
+
+bool parsePlainDate(std::string_view cell, Int32 & x)
+{
+    if (cell.size() != 10 || cell[4] != '-' || cell[7] != '-')
+        return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9})
+        if (!isNumericASCII(cell[i]))
+            return false;
+
+    const UInt16 year = (cell[0] - '0') * 1000 + (cell[1] - '0') * 100 + (cell[2] - '0') * 10 + (cell[3] - '0');
+    const UInt8 month = (cell[5] - '0') * 10 + (cell[6] - '0');
+    const UInt8 day = (cell[8] - '0') * 10 + (cell[9] - '0');
+    if (!checkDate(year, month, day))
+        return false;
+    x = LocalDate(year, month, day).getExtenedDayNum();
+    return true;
+}
+
+template <typename T>
+bool insertPlainNumber(DB::IColumn & column, std::string_view cell)
+{
+    T x;
+    bool parsed;
+    if constexpr (std::is_floating_point_v<T>)
+        parsed = parsePlainFloat(cell, x);
+    else
+        parsed = parsePlainInteger(cell, x);
+    if (parsed)
+        assert_cast<DB::ColumnVector<T> &>(column).getData().push_back(x);
+    return parsed;
+}
+}
+
+/// The unquoted numbers and dates in their plain form, e.g. -12, 3.25 or 2023-01-31, which are most of the cells of these
+/// columns, parsed straight from the buffer: the end of the cell is found by a SIMD scan for the first character that
+/// isn't a digit, '-' or '.', and the cell is parsed as a whole. The others, quoted, escaped or in the lenient forms
+/// of Excel, e.g. 1,000 or $5, are read through the serializations.
+bool ExcelTextFormatReader::tryReadFieldFast(DB::IColumn & column, const DB::DataTypePtr & type)
+{
+    const auto type_id = removeNullable(type)->getTypeId();
+    if (!WhichDataType(type_id).isNativeInt() && !WhichDataType(type_id).isFloat() && !WhichDataType(type_id).isDate32())
+        return false;
+
+    char * begin = buf->position();
+    char * buffer_end = buf->buffer().end();
+    char * end = find_first_not_symbols<'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '.'>(begin, buffer_end);
+    /// A cell crossing the end of the buffer is left to the serializations, which read over it.
+    if (end == begin || end == buffer_end || (*end != format_settings.csv.delimiter && *end != '\n' && *end != '\r'))
+        return false;
+    const std::string_view cell(begin, end - begin);
+    if (cell == format_settings.csv.null_representation)
+        return false;
+
+    auto * nullable = typeid_cast<DB::ColumnNullable *>(&column);
+    DB::IColumn & nested = nullable ? nullable->getNestedColumn() : column;
+    bool parsed = false;
+    switch (type_id)
+    {
+        case TypeIndex::Int8:
+            parsed = insertPlainNumber<Int8>(nested, cell);
+            break;
+        case TypeIndex::Int16:
+            parsed = insertPlainNumber<Int16>(nested, cell);
+            break;
+        case TypeIndex::Int32:
+            parsed = insertPlainNumber<Int32>(nested, cell);
+            break;
+        case TypeIndex::Int64:
+            parsed = insertPlainNumber<Int64>(nested, cell);
+            break;
+        case TypeIndex::Float32:
+            parsed = insertPlainNumber<Float32>(nested, cell);
+            break;
+        case TypeIndex::Float64:
+            parsed = insertPlainNumber<Float64>(nested, cell);
+            break;
+        case TypeIndex::Date32: {
+            Int32 day_num;
+            parsed = parsePlainDate(cell, day_num);
+            if (parsed)
+                assert_cast<DB::ColumnInt32 &>(nested).getData().push_back(day_num);
+            break;
+        }
+        default:
+            break;
+    }
+    if (!parsed)
+        return false;
+
+    if (nullable)
+        nullable->getNullMapData().push_back(0);
+    buf->position() = end;
+    return true;
+}
+
 void ExcelTextFormatReader::preSkipNullValue()
 {
     /// null_representation is empty and value is "" or '' in spark return null
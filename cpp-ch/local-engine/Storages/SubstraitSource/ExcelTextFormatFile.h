@@ -77,6 +77,7 @@ public:
     bool readField(DB::IColumn & column, const DB::DataTypePtr & type, const DB::SerializationPtr & serialization, bool is_last_file_column, const String & column_name) override;
 
 private:
+    bool tryReadFieldFast(DB::IColumn & column, const DB::DataTypePtr & type);
     void preSkipNullValue();
     bool isEndOfLine();
     static void skipEndOfLine(DB::ReadBuffer & in);
@@ -0,0 +1,34 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FileMetaCache.h"
+#include <IO/WithFileSize.h>
+#include <Interpreters/Context.h>
+
+namespace local_engine
+{
+std::optional<String> getFileMetaCacheKey(const String & uri, DB::ReadBuffer & in)
+{
+    if (!DB::isBufferWithFileSize(in))
+        return std::nullopt;
+    return uri + "#" + std::to_string(DB::getFileSizeFromReadBuffer(in));
+}
+
+size_t getFileMetaCacheMaxSize(const DB::ContextPtr & context)
+{
+    return context->getConfigRef().getUInt64("file_meta_cache.max_size", 256UL << 20);
+}
+}
@@ -0,0 +1,32 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <optional>
+#include <IO/ReadBuffer.h>
+#include <Interpreters/Context_fwd.h>
+#include <base/types.h>
+
+namespace local_engine
+{
+/// Key of the parsed metadata of a file in the executor wide caches of the formats, shared by the tasks reading splits
+/// of the file. The plan carries no modification time, so a file is told by its path and size. Absent if the size of
+/// the file is unknown to the read buffer.
+std::optional<String> getFileMetaCacheKey(const String & uri, DB::ReadBuffer & in);
+
+/// Bound of the bytes of each format's cache, by the config file_meta_cache.max_size.
+size_t getFileMetaCacheMaxSize(const DB::ContextPtr & context);
+}
@@ -25,6 +25,7 @@
 #include <Interpreters/Context.h>
 #include <Processors/Formats/IInputFormat.h>
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
+#include <Storages/SubstraitSource/StatisticsAggregation.h>
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #include <substrait/plan.pb.h>
 #include <Parser/TypeParser.h>
@@ -39,6 +40,13 @@ namespace ErrorCodes
 
 namespace local_engine
 {
+/// Pages of the filter columns in the row groups of a split, read or skipped by the pruning of the format.
+struct PagePruningStats
+{
+    size_t pages_read = 0;
+    size_t pages_skipped = 0;
+};
+
 class FormatFile
 {
 public:
@@ -57,6 +65,16 @@ public:
     /// Create a new input format for reading this file
     virtual InputFormatPtr createInputFormat(const DB::Block & header) = 0;
 
+    /// Row groups or stripes the split reads, which the input formats of createInputFormat(header, unit) read one each,
+    /// so that they can be decoded in parallel. 0 if the format reads the split as a whole only.
+    virtual size_t getReadUnitCount() { return 0; }
+
+    /// Create a new input format for reading the unit-th row group or stripe of the split only
+    virtual InputFormatPtr createInputFormat(const DB::Block & /*header*/, size_t /*unit*/)
+    {
+        throw DB::Exception(DB::ErrorCodes::NOT_IMPLEMENTED, "Format of file({}) can't be read by row groups", file_info.uri_file());
+    }
+
     /// Get schema which describes the columns of this file
     virtual DB::NamesAndTypesList getSchema() const
     {
@@ -72,6 +90,8 @@ public:
     /// Try to get rows from file metadata
     virtual std::optional<size_t> getTotalRows() { return {}; }
 
+    virtual PagePruningStats getPagePruningStats() const { return {}; }
+
     /// Get partition keys from file path
     inline const std::vector<String> & getFilePartitionKeys() const { return partition_keys; }
 
@@ -83,6 +103,8 @@ public:
     virtual size_t getLength() const { return file_info.length(); }
     
     void setFilters(std::vector<SourceFilter> filters_) { filters = std::move(filters_); }
+    /// The formats with exact statistics add the units they answer to it and skip reading them.
+    void setStatisticsAggregation(StatisticsAggregationPtr aggregation) { statistics_aggregation = std::move(aggregation); }
     virtual String getFileFormat() const = 0;
     
 protected:
@@ -92,6 +114,7 @@ protected:
     std::vector<String> partition_keys;
     std::map<String, String> partition_values;
     std::vector<SourceFilter> filters;
+    StatisticsAggregationPtr statistics_aggregation;
 };
 using FormatFilePtr = std::shared_ptr<FormatFile>;
 using FormatFiles = std::vector<FormatFilePtr>;
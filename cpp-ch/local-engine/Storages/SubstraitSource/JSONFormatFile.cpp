@@ -16,9 +16,24 @@
  */
 #include "JSONFormatFile.h"
 
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <Formats/FormatFactory.h>
 #include <Formats/FormatSettings.h>
+#include <IO/ReadBufferFromString.h>
 #include <Processors/Formats/Impl/JSONEachRowRowInputFormat.h>
+#include <base/find_symbols.h>
+#include <Common/assert_cast.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int INCORRECT_DATA;
+}
+}
 
 
 namespace local_engine
@@ -37,10 +52,197 @@ FormatFile::InputFormatPtr JSONFormatFile::createInputFormat(const DB::Block & h
     format_settings.skip_unknown_fields = true;
     size_t max_block_size = file_info.json().max_block_size();
     DB::RowInputFormatParams in_params = {max_block_size};
+#if USE_SIMDJSON
+    if (context->getConfigRef().getBool("json.use_simdjson", true))
+    {
+        res->input = std::make_shared<SimdJSONEachRowInputFormat>(header, *(res->read_buffer), in_params, format_settings);
+        return res;
+    }
+#endif
     std::shared_ptr<DB::JSONEachRowRowInputFormat> json_input_format =
         std::make_shared<DB::JSONEachRowRowInputFormat>(*(res->read_buffer), header, in_params, format_settings, false);
     res->input = json_input_format;
     return res;
 }
 
+#if USE_SIMDJSON
+SimdJSONEachRowInputFormat::SimdJSONEachRowInputFormat(
+    const DB::Block & header_, DB::ReadBuffer & in_, const DB::RowInputFormatParams & params_, const DB::FormatSettings & format_settings_)
+    : DB::IRowInputFormat(header_, in_, params_), format_settings(format_settings_), column_names(header_.getNames())
+{
+    for (size_t i = 0; i < column_names.size(); ++i)
+    {
+        name_positions.emplace(column_names[i], i);
+        const auto nested_type = DB::removeNullable(header_.getByPosition(i).type);
+        nested_types.emplace_back(nested_type->getTypeId());
+        nested_serializations.emplace_back(nested_type->getDefaultSerialization());
+    }
+    seen.resize(column_names.size());
+}
+
+void SimdJSONEachRowInputFormat::resetParser()
+{
+    DB::IRowInputFormat::resetParser();
+    line.clear();
+}
+
+std::optional<std::string_view> SimdJSONEachRowInputFormat::readLine()
+{
+    while (!in->eof())
+    {
+        std::string_view res;
+        char * next = find_first_symbols<'\n'>(in->position(), in->buffer().end());
+        if (next != in->buffer().end())
+        {
+            res = std::string_view(in->position(), next - in->position());
+            in->position() = next + 1;
+        }
+        else
+        {
+            line.assign(in->position(), next);
+            in->position() = next;
+            while (!in->eof())
+            {
+                next = find_first_symbols<'\n'>(in->position(), in->buffer().end());
+                line.append(in->position(), next);
+                in->position() = next;
+                if (next != in->buffer().end())
+                {
+                    ++in->position();
+                    break;
+                }
+            }
+            res = line;
+        }
+
+        while (!res.empty() && (res.back() == '\r' || res.back() == ' ' || res.back() == '\t'))
+            res.remove_suffix(1);
+        if (res.find_first_not_of(" \t") != std::string_view::npos)
+            return res;
+    }
+    return {};
+}
+
+namespace
+{
+template <typename T>
+bool insertInteger(DB::IColumn & column, const DB::SimdJSONParser::Element & element)
+{
+    T value;
+    if (element.isInt64())
+        value = static_cast<T>(element.getInt64());
+    else if (element.isUInt64())
+        value = static_cast<T>(element.getUInt64());
+    else if (element.isBool())
+        value = element.getBool();
+    else
+        return false;
+    assert_cast<DB::ColumnVector<T> &>(column).getData().push_back(value);
+    return true;
+}
+
+template <typename T>
+bool insertFloat(DB::IColumn & column, const DB::SimdJSONParser::Element & element)
+{
+    T value;
+    if (element.isDouble())
+        value = static_cast<T>(element.getDouble());
+    else if (element.isInt64())
+        value = static_cast<T>(element.getInt64());
+    else if (element.isUInt64())
+        value = static_cast<T>(element.getUInt64());
+    else
+        return false;
+    assert_cast<DB::ColumnVector<T> &>(column).getData().push_back(value);
+    return true;
+}
+
+bool insertDirectly(DB::IColumn & column, DB::TypeIndex type, const DB::SimdJSONParser::Element & element)
+{
+    switch (type)
+    {
+        case DB::TypeIndex::UInt8:
+            return insertInteger<UInt8>(column, element);
+        case DB::TypeIndex::UInt16:
+            return insertInteger<UInt16>(column, element);
+        case DB::TypeIndex::UInt32:
+            return insertInteger<UInt32>(column, element);
+        case DB::TypeIndex::UInt64:
+            return insertInteger<UInt64>(column, element);
+        case DB::TypeIndex::Int8:
+            return insertInteger<Int8>(column, element);
+        case DB::TypeIndex::Int16:
+            return insertInteger<Int16>(column, element);
+        case DB::TypeIndex::Int32:
+            return insertInteger<Int32>(column, element);
+        case DB::TypeIndex::Int64:
+            return insertInteger<Int64>(column, element);
+        case DB::TypeIndex::Float32:
+            return insertFloat<Float32>(column, element);
+        case DB::TypeIndex::Float64:
+            return insertFloat<Float64>(column, element);
+        case DB::TypeIndex::String:
+            if (!element.isString())
+                return false;
+            column.insertData(element.getString().data(), element.getString().size());
+            return true;
+        default:
+            return false;
+    }
+}
+}
+
+void SimdJSONEachRowInputFormat::insertValue(size_t column_index, DB::IColumn & column, const DB::SimdJSONParser::Element & element)
+{
+    if (element.isNull())
+    {
+        column.insertDefault();
+        return;
+    }
+
+    auto * nullable = typeid_cast<DB::ColumnNullable *>(&column);
+    DB::IColumn & nested = nullable ? nullable->getNestedColumn() : column;
+    if (!insertDirectly(nested, nested_types[column_index], element))
+    {
+        const String text = simdjson::minify(element.getElement());
+        DB::ReadBufferFromString buf(text);
+        nested_serializations[column_index]->deserializeTextJSON(nested, buf, format_settings);
+    }
+    if (nullable)
+        nullable->getNullMapData().push_back(0);
+}
+
+bool SimdJSONEachRowInputFormat::readRow(DB::MutableColumns & columns, DB::RowReadExtension & ext)
+{
+    const auto row = readLine();
+    if (!row)
+        return false;
+
+    DB::SimdJSONParser::Element document;
+    if (!parser.parse(*row, document))
+        throw DB::Exception(DB::ErrorCodes::INCORRECT_DATA, "Cannot parse JSON row: {}", *row);
+    if (!document.isObject())
+        throw DB::Exception(DB::ErrorCodes::INCORRECT_DATA, "JSON row must be an object: {}", *row);
+
+    std::fill(seen.begin(), seen.end(), 0);
+    for (const auto & [key, value] : document.getObject())
+    {
+        const auto it = name_positions.find(key);
+        if (it == name_positions.end() || seen[it->second])
+            continue;
+        seen[it->second] = 1;
+        insertValue(it->second, *columns[it->second], value);
+    }
+
+    ext.read_columns.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        ext.read_columns[i] = seen[i];
+        if (!seen[i])
+            columns[i]->insertDefault();
+    }
+    return true;
+}
+#endif
+
 }
@@ -16,7 +16,12 @@
  */
 #pragma once
 
+#include <optional>
+#include <unordered_map>
+#include <Processors/Formats/IRowInputFormat.h>
 #include <Storages/SubstraitSource/FormatFile.h>
+#include <Common/JSONParsers/SimdJSONParser.h>
+#include "config.h"
 
 namespace local_engine
 {
@@ -32,4 +37,38 @@ public:
     
     DB::String getFileFormat() const override { return "json"; }
 };
+
+#if USE_SIMDJSON
+/// Reads JSON lines with simdjson, which finds the structural characters of a row in bulk. Each row is parsed once, its
+/// fields are matched to the header columns by a single pass over the keys, the ones not in the header skipped, and the
+/// numbers and strings are inserted into the columns as they are. Values of the other types are deserialized from
+/// their text as JSONEachRowRowInputFormat does.
+class SimdJSONEachRowInputFormat final : public DB::IRowInputFormat
+{
+public:
+    SimdJSONEachRowInputFormat(
+        const DB::Block & header_, DB::ReadBuffer & in_, const DB::RowInputFormatParams & params_, const DB::FormatSettings & format_settings_);
+
+    String getName() const override { return "SimdJSONEachRowInputFormat"; }
+    void resetParser() override;
+
+private:
+    bool readRow(DB::MutableColumns & columns, DB::RowReadExtension & ext) override;
+
+    /// The next non empty line, which points into the read buffer if the line doesn't cross its end.
+    std::optional<std::string_view> readLine();
+    void insertValue(size_t column_index, DB::IColumn & column, const DB::SimdJSONParser::Element & element);
+
+    const DB::FormatSettings format_settings;
+    DB::Names column_names;
+    std::unordered_map<std::string_view, size_t> name_positions;
+    /// Type of each column without Nullable, and its serialization for the values not inserted directly.
+    std::vector<DB::TypeIndex> nested_types;
+    DB::Serializations nested_serializations;
+    std::vector<UInt8> seen;
+
+    DB::SimdJSONParser parser;
+    String line;
+};
+#endif
 }
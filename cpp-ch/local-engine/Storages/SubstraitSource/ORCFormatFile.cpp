@@ -22,7 +22,10 @@
 #    include <Formats/FormatFactory.h>
 #    include <IO/SeekableReadBuffer.h>
 #    include <Processors/Formats/Impl/ArrowBufferedStreams.h>
+#    include <Storages/SubstraitSource/FileMetaCache.h>
 #    include <Storages/SubstraitSource/OrcUtil.h>
+#    include <Common/CHUtil.h>
+#    include <Common/CacheBase.h>
 
 #    if USE_LOCAL_FORMATS
 #        include <DataTypes/NestedUtils.h>
@@ -40,6 +43,25 @@ namespace ErrorCodes
 
 namespace local_engine
 {
+namespace
+{
+using StripeList = std::vector<StripeInformation>;
+
+struct StripeListWeight
+{
+    size_t operator()(const StripeList & stripes) const { return stripes.size() * sizeof(StripeInformation); }
+};
+
+/// All the stripes of a file, the splits of the file pick theirs from it.
+using StripeListCache = DB::CacheBase<String, StripeList, std::hash<String>, StripeListWeight>;
+
+StripeListCache & stripeListCache(const DB::ContextPtr & context)
+{
+    static StripeListCache cache(getFileMetaCacheMaxSize(context));
+    return cache;
+}
+}
+
 #    if USE_LOCAL_FORMATS
 ORCBlockInputFormat::ORCBlockInputFormat(
     DB::ReadBuffer & in_, DB::Block header_, const DB::FormatSettings & format_settings_, const std::vector<StripeInformation> & stripes_)
@@ -172,6 +194,22 @@ ORCFormatFile::ORCFormatFile(
 }
 
 FormatFile::InputFormatPtr ORCFormatFile::createInputFormat(const DB::Block & header)
+{
+    return createInputFormatOf(header, std::nullopt);
+}
+
+size_t ORCFormatFile::getReadUnitCount()
+{
+    UInt64 _;
+    return collectRequiredStripes(_).size();
+}
+
+FormatFile::InputFormatPtr ORCFormatFile::createInputFormat(const DB::Block & header, size_t unit)
+{
+    return createInputFormatOf(header, unit);
+}
+
+FormatFile::InputFormatPtr ORCFormatFile::createInputFormatOf(const DB::Block & header, std::optional<size_t> unit)
 {
     auto file_format = std::make_shared<FormatFile::InputFormat>();
     file_format->read_buffer = read_buffer_builder->build(file_info);
@@ -185,8 +223,13 @@ FormatFile::InputFormatPtr ORCFormatFile::createInputFormat(const DB::Block & he
     }
     else
         stripes = collectRequiredStripes(total_stripes);
+    if (unit)
+        stripes = {stripes.at(*unit)};
 
     auto format_settings = DB::getFormatSettings(context);
+    if (size_t target_block_bytes = context->getConfigRef().getUInt64("target_block_bytes", 0))
+        format_settings.orc.row_batch_size
+            = BlockUtil::adaptiveBlockRows(header, context->getSettingsRef().max_block_size, target_block_bytes);
 
 #    if USE_LOCAL_FORMATS
     format_settings.orc.import_nested = true;
@@ -245,36 +288,51 @@ std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(UInt64 & to
     return collectRequiredStripes(in.get(), total_stripes);
 }
 
-std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_stripes)
+std::shared_ptr<std::vector<StripeInformation>> ORCFormatFile::getAllStripes(DB::ReadBuffer * read_buffer)
 {
-    DB::FormatSettings format_settings{
-        .seekable_read = true,
-    };
-    std::atomic<int> is_stopped{0};
-    auto arrow_file = DB::asArrowFile(*read_buffer, format_settings, is_stopped, "ORC", ORC_MAGIC_BYTES);
-    auto orc_reader = OrcUtil::createOrcReader(arrow_file);
-    total_stripes = orc_reader->getNumberOfStripes();
-
-    size_t total_num_rows = 0;
-    std::vector<StripeInformation> stripes;
-    stripes.reserve(total_stripes);
-    for (size_t i = 0; i < total_stripes; ++i)
+    auto load = [&]()
     {
-        auto stripe_metadata = orc_reader->getStripe(i);
-
-        auto offset = stripe_metadata->getOffset();
-        if (file_info.start() <= offset && offset < file_info.start() + file_info.length())
+        DB::FormatSettings format_settings{
+            .seekable_read = true,
+        };
+        std::atomic<int> is_stopped{0};
+        auto arrow_file = DB::asArrowFile(*read_buffer, format_settings, is_stopped, "ORC", ORC_MAGIC_BYTES);
+        auto orc_reader = OrcUtil::createOrcReader(arrow_file);
+        auto num_stripes = orc_reader->getNumberOfStripes();
+
+        size_t total_num_rows = 0;
+        auto stripes = std::make_shared<std::vector<StripeInformation>>();
+        stripes->reserve(num_stripes);
+        for (size_t i = 0; i < num_stripes; ++i)
         {
+            auto stripe_metadata = orc_reader->getStripe(i);
             StripeInformation stripe_info;
             stripe_info.index = i;
-            stripe_info.offset = stripe_metadata->getLength();
+            stripe_info.offset = stripe_metadata->getOffset();
             stripe_info.length = stripe_metadata->getLength();
             stripe_info.num_rows = stripe_metadata->getNumberOfRows();
             stripe_info.start_row = total_num_rows;
-            stripes.emplace_back(stripe_info);
+            stripes->emplace_back(stripe_info);
+            total_num_rows += stripe_metadata->getNumberOfRows();
         }
+        return stripes;
+    };
+    auto key = getFileMetaCacheKey(file_info.uri_file(), *read_buffer);
+    if (!key)
+        return load();
+    return stripeListCache(context).getOrSet(*key, load).first;
+}
+
+std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_stripes)
+{
+    auto all_stripes = getAllStripes(read_buffer);
+    total_stripes = all_stripes->size();
 
-        total_num_rows += stripe_metadata->getNumberOfRows();
+    std::vector<StripeInformation> stripes;
+    for (const auto & stripe_info : *all_stripes)
+    {
+        if (file_info.start() <= stripe_info.offset && stripe_info.offset < file_info.start() + file_info.length())
+            stripes.emplace_back(stripe_info);
     }
     return stripes;
 }
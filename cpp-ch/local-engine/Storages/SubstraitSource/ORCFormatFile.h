@@ -105,6 +105,9 @@ public:
 
     FormatFile::InputFormatPtr createInputFormat(const DB::Block & header) override;
 
+    size_t getReadUnitCount() override;
+    FormatFile::InputFormatPtr createInputFormat(const DB::Block & header, size_t unit) override;
+
     std::optional<size_t> getTotalRows() override;
 
     bool supportSplit() const override { return true; }
@@ -114,7 +117,9 @@ private:
     mutable std::mutex mutex;
     std::optional<size_t> total_rows;
 
+    FormatFile::InputFormatPtr createInputFormatOf(const DB::Block & header, std::optional<size_t> unit);
     std::vector<StripeInformation> collectRequiredStripes(UInt64 & total_stripes);
+    std::shared_ptr<std::vector<StripeInformation>> getAllStripes(DB::ReadBuffer * read_buffer);
     std::vector<StripeInformation> collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_strpes);
 };
 }
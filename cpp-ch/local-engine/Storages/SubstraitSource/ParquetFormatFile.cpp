@@ -25,14 +25,26 @@
 #    include <Formats/FormatFactory.h>
 #    include <Formats/FormatSettings.h>
 #    include <IO/SeekableReadBuffer.h>
+#    include <IO/WithFileSize.h>
+#    include <Interpreters/ExpressionActions.h>
+#    include <Interpreters/convertFieldToType.h>
 #    include <Processors/Formats/Impl/ArrowBufferedStreams.h>
 #    include <Processors/Formats/Impl/ArrowColumnToCHColumn.h>
 #    include <Processors/Formats/Impl/ParquetBlockInputFormat.h>
 #    include <Storages/ArrowParquetBlockInputFormat.h>
+#    include <Storages/SubstraitSource/FileMetaCache.h>
+#    include <Storages/SubstraitSource/RangeReadFile.h>
 #    include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #    include <parquet/arrow/reader.h>
+#    include <parquet/bloom_filter.h>
+#    include <parquet/bloom_filter_reader.h>
+#    include <parquet/page_index.h>
+#    include <Common/CHUtil.h>
+#    include <Common/CacheBase.h>
 #    include <Common/Config.h>
 #    include <Common/Exception.h>
+#    include <DataTypes/DataTypeLowCardinality.h>
+#    include <DataTypes/DataTypeNullable.h>
 #    include <DataTypes/DataTypesNumber.h>
 
 namespace DB
@@ -46,6 +58,113 @@ namespace ErrorCodes
 
 namespace local_engine
 {
+namespace
+{
+struct FileMetaDataWeight
+{
+    // The serialized size, which the parsed footer is roughly proportional to.
+    size_t operator()(const parquet::FileMetaData & meta) const { return meta.size(); }
+};
+
+using FileMetaDataCache = DB::CacheBase<String, parquet::FileMetaData, std::hash<String>, FileMetaDataWeight>;
+
+FileMetaDataCache & fileMetaDataCache(const DB::ContextPtr & context)
+{
+    static FileMetaDataCache cache(getFileMetaCacheMaxSize(context));
+    return cache;
+}
+
+template <typename DType, typename ToField>
+std::vector<DB::Range> getPageMaxMins(const parquet::ColumnIndex & column_index, ToField && to_field)
+{
+    const auto & typed_index = static_cast<const parquet::TypedColumnIndex<DType> &>(column_index);
+    const auto & null_pages = column_index.null_pages();
+    std::vector<DB::Range> ranges;
+    ranges.reserve(null_pages.size());
+    for (size_t i = 0; i < null_pages.size(); ++i)
+    {
+        /// As the row group statistics, a range tells nothing of the nulls.
+        if (null_pages[i] || (column_index.has_null_counts() && column_index.null_counts()[i] > 0))
+            ranges.emplace_back(DB::Range::createWholeUniverse());
+        else
+            ranges.emplace_back(to_field(typed_index.min_values()[i]), true, to_field(typed_index.max_values()[i]), true);
+    }
+    return ranges;
+}
+
+std::vector<DB::Range> getPageMaxMins(
+    const parquet::ColumnIndex & column_index, parquet::Type::type parquet_data_type, const DB::DataTypePtr & data_type, Int32 column_type_length)
+{
+    auto to_field = [](auto value) { return DB::Field(value); };
+    switch (parquet_data_type)
+    {
+        case parquet::Type::BOOLEAN:
+            return getPageMaxMins<parquet::BooleanType>(column_index, to_field);
+        case parquet::Type::INT32:
+            return getPageMaxMins<parquet::Int32Type>(column_index, to_field);
+        case parquet::Type::INT64:
+            return getPageMaxMins<parquet::Int64Type>(column_index, to_field);
+        case parquet::Type::FLOAT:
+            return getPageMaxMins<parquet::FloatType>(column_index, to_field);
+        case parquet::Type::DOUBLE:
+            return getPageMaxMins<parquet::DoubleType>(column_index, to_field);
+        case parquet::Type::BYTE_ARRAY:
+            return getPageMaxMins<parquet::ByteArrayType>(
+                column_index, [](const parquet::ByteArray & value) { return DB::Field(parquet::ByteArrayToString(value)); });
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            if (DB::WhichDataType(data_type).isFixedString())
+                return getPageMaxMins<parquet::FLBAType>(
+                    column_index,
+                    [column_type_length](const parquet::FixedLenByteArray & value)
+                    { return DB::Field(parquet::FixedLenByteArrayToString(value, column_type_length)); });
+            break;
+        default:
+            break;
+    }
+    return {};
+}
+
+/// The hash of the value in the bloom filter of a column, absent if the value can't be probed.
+std::optional<UInt64> hashForBloomFilter(
+    const parquet::BloomFilter & bloom_filter, parquet::Type::type parquet_data_type, const DB::DataTypePtr & data_type, const DB::Field & value)
+{
+    auto type = DB::removeLowCardinalityAndNullable(data_type);
+    auto field = DB::convertFieldToType(value, *type);
+    if (field.isNull())
+        return {};
+
+    /// Floats are left out, 0.0 and -0.0 are equal but hash apart.
+    DB::WhichDataType which_data_type(type);
+    if (parquet_data_type == parquet::Type::INT32
+        && (which_data_type.isInt8() || which_data_type.isInt16() || which_data_type.isInt32() || which_data_type.isDate32()))
+        return bloom_filter.Hash(static_cast<int32_t>(field.get<Int64>()));
+    if (parquet_data_type == parquet::Type::INT64 && which_data_type.isInt64())
+        return bloom_filter.Hash(static_cast<int64_t>(field.get<Int64>()));
+    if (parquet_data_type == parquet::Type::BYTE_ARRAY && which_data_type.isString())
+    {
+        const auto & str = field.get<String>();
+        parquet::ByteArray byte_array(static_cast<uint32_t>(str.size()), reinterpret_cast<const uint8_t *>(str.data()));
+        return bloom_filter.Hash(&byte_array);
+    }
+    return {};
+}
+
+bool bloomFilterMayContainAny(
+    const parquet::BloomFilter & bloom_filter,
+    parquet::Type::type parquet_data_type,
+    const DB::DataTypePtr & data_type,
+    const DB::Fields & values)
+{
+    for (const auto & value : values)
+    {
+        auto hash = hashForBloomFilter(bloom_filter, parquet_data_type, data_type, value);
+        if (!hash || bloom_filter.FindHash(*hash))
+            return true;
+    }
+    return false;
+}
+}
+
 ParquetFormatFile::ParquetFormatFile(
     DB::ContextPtr context_, const substrait::ReadRel::LocalFiles::FileOrFiles & file_info_, ReadBufferBuilderPtr read_buffer_builder_)
     : FormatFile(context_, file_info_, read_buffer_builder_), enable_row_group_maxmin_index(file_info_.parquet().enable_row_group_maxmin_index()) 
@@ -53,40 +172,94 @@ ParquetFormatFile::ParquetFormatFile(
 }
 
 FormatFile::InputFormatPtr ParquetFormatFile::createInputFormat(const DB::Block & header)
+{
+    return createInputFormatOf(header, std::nullopt);
+}
+
+size_t ParquetFormatFile::getReadUnitCount()
+{
+    int _;
+    return collectRequiredRowGroups(_).size();
+}
+
+FormatFile::InputFormatPtr ParquetFormatFile::createInputFormat(const DB::Block & header, size_t unit)
+{
+    return createInputFormatOf(header, unit);
+}
+
+FormatFile::InputFormatPtr ParquetFormatFile::createInputFormatOf(const DB::Block & header, std::optional<size_t> unit)
 {
     auto res = std::make_shared<FormatFile::InputFormat>();
     res->read_buffer = read_buffer_builder->build(file_info);
 
-    std::vector<RowGroupInfomation> required_row_groups;
+    std::vector<RowGroupInfomation> row_groups;
     [[maybe_unused]] int total_row_groups = 0;
     if (auto * seekable_in = dynamic_cast<DB::SeekableReadBuffer *>(res->read_buffer.get()))
     {
         // reuse the read_buffer to avoid opening the file twice.
         // especially，the cost of opening a hdfs file is large.
-        required_row_groups = collectRequiredRowGroups(seekable_in, total_row_groups);
+        row_groups = collectRequiredRowGroups(seekable_in, total_row_groups);
         seekable_in->seek(0, SEEK_SET);
     }
     else
-        required_row_groups = collectRequiredRowGroups(total_row_groups);
+        row_groups = collectRequiredRowGroups(total_row_groups);
+    if (unit)
+        row_groups = {row_groups.at(*unit)};
 
     auto format_settings = DB::getFormatSettings(context);
 #    if USE_LOCAL_FORMATS
     format_settings.parquet.import_nested = true;
 
     std::vector<int> row_group_indices;
-    row_group_indices.reserve(required_row_groups.size());
-    for (const auto & row_group : required_row_groups)
+    row_group_indices.reserve(row_groups.size());
+    for (const auto & row_group : row_groups)
         row_group_indices.emplace_back(row_group.index);
 
-    auto input_format
-        = std::make_shared<local_engine::ArrowParquetBlockInputFormat>(*(res->read_buffer), header, format_settings, row_group_indices);
+    auto input_format = std::make_shared<local_engine::ArrowParquetBlockInputFormat>(
+        *(res->read_buffer), header, format_settings, row_group_indices, file_meta);
+    /// Narrow rows are read in larger batches and wide rows in smaller ones, if a target block size is set.
+    if (size_t target_block_bytes = context->getConfigRef().getUInt64("target_block_bytes", 0))
+        input_format->setBatchSize(BlockUtil::adaptiveBlockRows(header, context->getSettingsRef().max_block_size, target_block_bytes));
+    if (context->getConfigRef().getBool("parquet.late_materialization", true))
+    {
+        for (const auto & filter : filters)
+        {
+            if (!filter.actions)
+                continue;
+            auto filter_actions
+                = std::make_shared<DB::ExpressionActions>(filter.actions->clone(), DB::ExpressionActionsSettings::fromContext(context));
+            input_format->setFilter(std::move(filter_actions), filter.actions->getOutputs().front()->result_name);
+            break;
+        }
+    }
+
+    /// On S3 and HDFS the column chunks of a row group are fetched by a few concurrent requests rather than one by one.
+    const auto & config = context->getConfigRef();
+    if (read_buffer_builder->isRemote() && config.getBool("parquet.range_read.enabled", true)
+        && DB::isBufferWithFileSize(*res->read_buffer))
+    {
+        auto creator = [builder = read_buffer_builder, file = file_info]() -> std::unique_ptr<DB::SeekableReadBuffer>
+        {
+            auto in = builder->build(file);
+            if (!dynamic_cast<DB::SeekableReadBuffer *>(in.get()))
+                throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Read buffer of file({}) is not seekable", file.uri_file());
+            return std::unique_ptr<DB::SeekableReadBuffer>(static_cast<DB::SeekableReadBuffer *>(in.release()));
+        };
+        auto options = arrow::io::CacheOptions::Defaults();
+        options.hole_size_limit = config.getUInt64("parquet.range_read.hole_size", 1UL << 20);
+        options.range_size_limit = config.getUInt64("parquet.range_read.max_size", 8UL << 20);
+        input_format->setRangeReadFile(
+            std::make_shared<RangeReadFile>(std::move(creator), DB::getFileSizeFromReadBuffer(*res->read_buffer)),
+            getRangeReadIOContext(config.getUInt64("parquet.range_read.max_concurrency", 16)),
+            options);
+    }
 #    else
     std::vector<int> total_row_group_indices(total_row_groups);
     std::iota(total_row_group_indices.begin(), total_row_group_indices.end(), 0);
 
-    std::vector<int> required_row_group_indices(required_row_groups.size());
-    for (size_t i = 0; i < required_row_groups.size(); ++i)
-        required_row_group_indices[i] = required_row_groups[i].index;
+    std::vector<int> required_row_group_indices(row_groups.size());
+    for (size_t i = 0; i < row_groups.size(); ++i)
+        required_row_group_indices[i] = row_groups[i].index;
 
     std::vector<int> skip_row_group_indices;
     std::set_difference(
@@ -126,33 +299,69 @@ std::optional<size_t> ParquetFormatFile::getTotalRows()
 
 std::vector<RowGroupInfomation> ParquetFormatFile::collectRequiredRowGroups(int & total_row_groups)
 {
+    {
+        std::lock_guard lock(mutex);
+        if (required_row_groups)
+        {
+            total_row_groups = file_meta->num_row_groups();
+            return *required_row_groups;
+        }
+    }
     auto in = read_buffer_builder->build(file_info);
     return collectRequiredRowGroups(in.get(), total_row_groups);
 }
 
+std::shared_ptr<parquet::FileMetaData> ParquetFormatFile::getFileMetaData(DB::ReadBuffer * read_buffer)
+{
+    auto load = [&]()
+    {
+        DB::FormatSettings format_settings{
+            .seekable_read = true,
+        };
+        std::atomic<int> is_stopped{0};
+        std::unique_ptr<parquet::arrow::FileReader> reader;
+        auto status = parquet::arrow::OpenFile(
+            asArrowFile(*read_buffer, format_settings, is_stopped, "Parquet", PARQUET_MAGIC_BYTES), arrow::default_memory_pool(), &reader);
+        if (!status.ok())
+            throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Open file({}) failed. {}", file_info.uri_file(), status.ToString());
+        return reader->parquet_reader()->metadata();
+    };
+    auto key = getFileMetaCacheKey(file_info.uri_file(), *read_buffer);
+    if (!key)
+        return load();
+    return fileMetaDataCache(context).getOrSet(*key, load).first;
+}
+
 std::vector<RowGroupInfomation> ParquetFormatFile::collectRequiredRowGroups(DB::ReadBuffer * read_buffer, int & total_row_groups)
 {
+    std::shared_ptr<parquet::FileMetaData> meta;
+    {
+        std::lock_guard lock(mutex);
+        if (required_row_groups)
+        {
+            total_row_groups = file_meta->num_row_groups();
+            return *required_row_groups;
+        }
+        if (!file_meta)
+            file_meta = getFileMetaData(read_buffer);
+        meta = file_meta;
+    }
+    total_row_groups = meta->num_row_groups();
+
+    /// Reads the page index and the bloom filters, opened on the first row group of the split passing the statistics.
     DB::FormatSettings format_settings{
         .seekable_read = true,
     };
     std::atomic<int> is_stopped{0};
-    std::unique_ptr<parquet::arrow::FileReader> reader;
-    auto status = parquet::arrow::OpenFile(
-        asArrowFile(*read_buffer, format_settings, is_stopped, "Parquet", PARQUET_MAGIC_BYTES), arrow::default_memory_pool(), &reader);
-    if (!status.ok())
-        throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Open file({}) failed. {}", file_info.uri_file(), status.ToString());
-
-    auto file_meta = reader->parquet_reader()->metadata();
-    total_row_groups = file_meta->num_row_groups();
+    std::unique_ptr<parquet::ParquetFileReader> index_reader;
+    bool use_indexes = enable_row_group_maxmin_index && !filters.empty() && dynamic_cast<DB::SeekableReadBuffer *>(read_buffer);
+    PagePruningStats stats;
 
     std::vector<RowGroupInfomation> row_group_metadatas;
     row_group_metadatas.reserve(total_row_groups);
     for (int i = 0; i < total_row_groups; ++i)
-    {   
-        if (enable_row_group_maxmin_index && !checkRowGroupIfRequired(file_meta->RowGroup(i)))
-            continue;
-        
-        auto row_group_meta = file_meta->RowGroup(i);
+    {
+        auto row_group_meta = meta->RowGroup(i);
         auto offset = static_cast<UInt64>(row_group_meta->file_offset());
         if (!offset)
             offset = static_cast<UInt64>(row_group_meta->ColumnChunk(0)->file_offset());
@@ -160,6 +369,20 @@ std::vector<RowGroupInfomation> ParquetFormatFile::collectRequiredRowGroups(DB::
         /// Current row group has intersection with the required range.
         if (file_info.start() <= offset && offset < file_info.start() + file_info.length())
         {
+            if (enable_row_group_maxmin_index && !checkRowGroupIfRequired(meta->RowGroup(i)))
+                continue;
+
+            if (use_indexes)
+            {
+                if (!index_reader)
+                    index_reader = parquet::ParquetFileReader::Open(
+                        asArrowFile(*read_buffer, format_settings, is_stopped, "Parquet", PARQUET_MAGIC_BYTES),
+                        parquet::default_reader_properties(),
+                        meta);
+                if (!checkRowGroupByIndexes(*index_reader, i, stats))
+                    continue;
+            }
+
             RowGroupInfomation info;
             info.index = i;
             info.num_rows = row_group_meta->num_rows();
@@ -169,9 +392,150 @@ std::vector<RowGroupInfomation> ParquetFormatFile::collectRequiredRowGroups(DB::
             row_group_metadatas.emplace_back(std::move(info));
         }
     }
+
+    {
+        std::lock_guard lock(mutex);
+        if (required_row_groups)
+            return *required_row_groups;
+        /// Under the lock, so that a row group is answered once.
+        if (statistics_aggregation)
+            std::erase_if(
+                row_group_metadatas,
+                [&](const RowGroupInfomation & info)
+                {
+                    auto row_group_meta = meta->RowGroup(info.index);
+                    return statistics_aggregation->tryAdd(
+                        info.num_rows,
+                        [&](const String & column, const DB::DataTypePtr & type)
+                        { return getColumnStatistics(*row_group_meta, column, type); });
+                });
+        page_pruning_stats = stats;
+        required_row_groups = row_group_metadatas;
+    }
     return row_group_metadatas;
 }
 
+std::optional<StatisticsAggregation::ColumnStatistics>
+ParquetFormatFile::getColumnStatistics(const parquet::RowGroupMetaData & meta, const String & column, const DB::DataTypePtr & type)
+{
+    int column_index = meta.schema()->ColumnIndex(column);
+    if (column_index < 0)
+        return {};
+    auto column_chunk_meta = meta.ColumnChunk(column_index);
+    /// Not set either if the writer is known to order the values of the type wrongly.
+    if (!column_chunk_meta->is_stats_set())
+        return {};
+    auto statistics = column_chunk_meta->statistics();
+    if (!statistics || !statistics->HasNullCount())
+        return {};
+
+    StatisticsAggregation::ColumnStatistics result;
+    result.null_count = statistics->null_count();
+    if (!statistics->HasMinMax())
+    {
+        if (result.null_count == static_cast<UInt64>(meta.num_rows()))
+            return result;
+        return {};
+    }
+
+    /// Only the types whose bounds are values of the column, not truncated, and ordered the same in Spark. Floats are
+    /// not, their bounds leave NaN out.
+    DB::WhichDataType which(DB::removeNullable(type));
+    switch (column_chunk_meta->type())
+    {
+        case parquet::Type::type::INT32: {
+            if (!which.isInt8() && !which.isInt16() && !which.isInt32() && !which.isDate32())
+                return {};
+            auto int32_stats = std::static_pointer_cast<parquet::Int32Statistics>(statistics);
+            result.min = static_cast<Int64>(int32_stats->min());
+            result.max = static_cast<Int64>(int32_stats->max());
+            return result;
+        }
+        case parquet::Type::type::INT64: {
+            if (!which.isInt64())
+                return {};
+            auto int64_stats = std::static_pointer_cast<parquet::Int64Statistics>(statistics);
+            result.min = int64_stats->min();
+            result.max = int64_stats->max();
+            return result;
+        }
+        case parquet::Type::type::BOOLEAN: {
+            if (!DB::isBool(DB::removeNullable(type)))
+                return {};
+            auto bool_stats = std::static_pointer_cast<parquet::BoolStatistics>(statistics);
+            result.min = static_cast<UInt64>(bool_stats->min());
+            result.max = static_cast<UInt64>(bool_stats->max());
+            return result;
+        }
+        default:
+            return {};
+    }
+}
+
+PagePruningStats ParquetFormatFile::getPagePruningStats() const
+{
+    std::lock_guard lock(mutex);
+    return page_pruning_stats;
+}
+
+bool ParquetFormatFile::checkRowGroupByIndexes(parquet::ParquetFileReader & reader, int row_group, PagePruningStats & stats)
+{
+    const parquet::SchemaDescriptor * schema_desc = reader.metadata()->schema();
+    auto page_index_reader = reader.GetPageIndexReader();
+    auto row_group_page_index = page_index_reader ? page_index_reader->RowGroup(row_group) : nullptr;
+    auto row_group_bloom_filter = reader.GetBloomFilterReader().RowGroup(row_group);
+
+    bool row_group_required = true;
+    size_t num_pages = 0;
+    for (const auto & filter : filters)
+    {
+        const auto key_types = filter.keys.getTypes();
+        size_t key_pos = 0;
+        for (auto iter = filter.keys.begin(); iter != filter.keys.end(); ++iter, ++key_pos)
+        {
+            int column_index = schema_desc->ColumnIndex(iter->name);
+            if (column_index < 0)
+                continue;
+            const parquet::ColumnDescriptor * desc = schema_desc->Column(column_index);
+
+            /// Every row is in some page of the column, so no page of it in the filter rules out the row group.
+            auto page_index = row_group_page_index ? row_group_page_index->GetColumnIndex(column_index) : nullptr;
+            if (page_index)
+            {
+                auto page_ranges
+                    = getPageMaxMins(*page_index, desc->physical_type(), DB::removeLowCardinality(iter->type), desc->type_length());
+                num_pages += page_ranges.size();
+                std::vector<DB::Range> ranges(filter.keys.size(), DB::Range::createWholeUniverse());
+                bool any_page_required = page_ranges.empty();
+                for (auto & page_range : page_ranges)
+                {
+                    ranges[key_pos] = std::move(page_range);
+                    if (filter.filter.checkInHyperrectangle(ranges, key_types).can_be_true)
+                    {
+                        any_page_required = true;
+                        break;
+                    }
+                }
+                row_group_required &= any_page_required;
+            }
+
+            auto values = filter.point_values.find(iter->name);
+            if (values != filter.point_values.end() && row_group_bloom_filter)
+            {
+                auto bloom_filter = row_group_bloom_filter->GetColumnBloomFilter(column_index);
+                if (bloom_filter)
+                    row_group_required &= bloomFilterMayContainAny(*bloom_filter, desc->physical_type(), iter->type, values->second);
+            }
+        }
+    }
+
+    if (row_group_required)
+        stats.pages_read += num_pages;
+    else
+        stats.pages_skipped += num_pages;
+    return row_group_required;
+}
+
 bool ParquetFormatFile::checkRowGroupIfRequired(std::unique_ptr<parquet::RowGroupMetaData> meta)
 {
     std::vector<DB::Range> column_max_mins;
@@ -186,7 +550,7 @@ bool ParquetFormatFile::checkRowGroupIfRequired(std::unique_ptr<parquet::RowGrou
         for (size_t j = 0; j < filters[i].keys.size(); ++j)
         {
             DB::String filter_col_key = iter->name;
-            DB::DataTypePtr filter_col_type = iter->type;
+            DB::DataTypePtr filter_col_type = DB::removeLowCardinality(iter->type);
             int column_index = schema_desc->ColumnIndex(filter_col_key);
             DB::Range range = DB::Range::createWholeUniverse();
             if (column_index < 0)
@@ -22,6 +22,7 @@
 #    include <memory>
 #    include <IO/ReadBuffer.h>
 #    include <Storages/SubstraitSource/FormatFile.h>
+#    include <parquet/file_reader.h>
 #    include <parquet/metadata.h>
 #    include <parquet/statistics.h>
 #    include <DataTypes/DataTypesNumber.h>
@@ -47,18 +48,35 @@ public:
 
     FormatFile::InputFormatPtr createInputFormat(const DB::Block & header) override;
 
+    size_t getReadUnitCount() override;
+    FormatFile::InputFormatPtr createInputFormat(const DB::Block & header, size_t unit) override;
+
     std::optional<size_t> getTotalRows() override;
 
+    PagePruningStats getPagePruningStats() const override;
+
     bool supportSplit() const override { return true; }
     DB::String getFileFormat() const override { return "parquet"; }
 
 private:
-    std::mutex mutex;
+    mutable std::mutex mutex;
     std::optional<size_t> total_rows;
     bool enable_row_group_maxmin_index;
+    PagePruningStats page_pruning_stats;
+    /// Parsed once per file, shared with the input format.
+    std::shared_ptr<parquet::FileMetaData> file_meta;
+    /// Row groups of the split passing the filters, collected once.
+    std::optional<std::vector<RowGroupInfomation>> required_row_groups;
+    FormatFile::InputFormatPtr createInputFormatOf(const DB::Block & header, std::optional<size_t> unit);
     std::vector<RowGroupInfomation> collectRequiredRowGroups(int & total_row_groups);
+    std::shared_ptr<parquet::FileMetaData> getFileMetaData(DB::ReadBuffer * read_buffer);
     std::vector<RowGroupInfomation> collectRequiredRowGroups(DB::ReadBuffer * read_buffer, int & total_row_groups);
     bool checkRowGroupIfRequired(std::unique_ptr<parquet::RowGroupMetaData> meta);
+    /// The exact statistics of a column of the row group, for the aggregates answered from them.
+    static std::optional<StatisticsAggregation::ColumnStatistics>
+    getColumnStatistics(const parquet::RowGroupMetaData & meta, const String & column, const DB::DataTypePtr & type);
+    /// By the page index and the bloom filters of the filter columns, if the file has them.
+    bool checkRowGroupByIndexes(parquet::ParquetFileReader & reader, int row_group, PagePruningStats & stats);
     DB::Range getColumnMaxMin(std::shared_ptr<parquet::Statistics> statistics,
                     parquet::Type::type parquet_data_type,
                     DB::DataTypePtr data_type,
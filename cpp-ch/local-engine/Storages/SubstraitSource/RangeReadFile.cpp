@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RangeReadFile.h"
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/util/thread_pool.h>
+#include <Common/Exception.h>
+
+namespace local_engine
+{
+RangeReadFile::RangeReadFile(ReadBufferCreator creator_, size_t file_size_)
+    : creator(std::move(creator_)), file_size(static_cast<int64_t>(file_size_))
+{
+}
+
+arrow::Status RangeReadFile::Close()
+{
+    std::lock_guard lock(mutex);
+    is_closed = true;
+    idle_buffers.clear();
+    return arrow::Status::OK();
+}
+
+bool RangeReadFile::closed() const
+{
+    std::lock_guard lock(mutex);
+    return is_closed;
+}
+
+arrow::Result<int64_t> RangeReadFile::Tell() const
+{
+    return position;
+}
+
+arrow::Status RangeReadFile::Seek(int64_t position_)
+{
+    position = position_;
+    return arrow::Status::OK();
+}
+
+arrow::Result<int64_t> RangeReadFile::GetSize()
+{
+    return file_size;
+}
+
+arrow::Result<int64_t> RangeReadFile::Read(int64_t nbytes, void * out)
+{
+    ARROW_ASSIGN_OR_RAISE(auto bytes_read, ReadAt(position, nbytes, out));
+    position += bytes_read;
+    return bytes_read;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> RangeReadFile::Read(int64_t nbytes)
+{
+    ARROW_ASSIGN_OR_RAISE(auto buffer, ReadAt(position, nbytes));
+    position += buffer->size();
+    return buffer;
+}
+
+arrow::Result<int64_t> RangeReadFile::ReadAt(int64_t position_, int64_t nbytes, void * out)
+{
+    nbytes = std::max<int64_t>(0, std::min(nbytes, file_size - position_));
+    if (nbytes == 0)
+        return 0;
+    try
+    {
+        auto in = acquire();
+        /// No more than the range is fetched from the remote file.
+        in->setReadUntilPosition(position_ + nbytes);
+        in->seek(position_, SEEK_SET);
+        auto bytes_read = in->readBig(static_cast<char *>(out), nbytes);
+        release(std::move(in));
+        return bytes_read;
+    }
+    catch (...)
+    {
+        return arrow::Status::IOError(DB::getCurrentExceptionMessage(false));
+    }
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> RangeReadFile::ReadAt(int64_t position_, int64_t nbytes)
+{
+    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateResizableBuffer(nbytes));
+    ARROW_ASSIGN_OR_RAISE(auto bytes_read, ReadAt(position_, nbytes, buffer->mutable_data()));
+    if (bytes_read < nbytes)
+        RETURN_NOT_OK(buffer->Resize(bytes_read));
+    return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+}
+
+std::unique_ptr<DB::SeekableReadBuffer> RangeReadFile::acquire()
+{
+    {
+        std::lock_guard lock(mutex);
+        if (!idle_buffers.empty())
+        {
+            auto in = std::move(idle_buffers.back());
+            idle_buffers.pop_back();
+            return in;
+        }
+    }
+    return creator();
+}
+
+void RangeReadFile::release(std::unique_ptr<DB::SeekableReadBuffer> in)
+{
+    std::lock_guard lock(mutex);
+    if (!is_closed)
+        idle_buffers.emplace_back(std::move(in));
+}
+
+arrow::io::IOContext getRangeReadIOContext(size_t max_concurrency)
+{
+    static std::shared_ptr<arrow::internal::ThreadPool> pool
+        = arrow::internal::ThreadPool::Make(static_cast<int>(std::max<size_t>(1, max_concurrency))).ValueOrDie();
+    return arrow::io::IOContext(arrow::default_memory_pool(), pool.get());
+}
+}
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <IO/SeekableReadBuffer.h>
+#include <arrow/io/interfaces.h>
+
+namespace local_engine
+{
+/// Arrow file over a remote file whose ReadAt calls run concurrently, each over a read buffer of its own taken from a
+/// pool, unlike the file over a single SeekableReadBuffer which serializes them. The Parquet reader pre-buffering the
+/// column chunks of a row group issues its coalesced range reads through it on the io threads.
+class RangeReadFile : public arrow::io::RandomAccessFile
+{
+public:
+    using ReadBufferCreator = std::function<std::unique_ptr<DB::SeekableReadBuffer>()>;
+
+    RangeReadFile(ReadBufferCreator creator_, size_t file_size_);
+
+    arrow::Status Close() override;
+    bool closed() const override;
+    arrow::Result<int64_t> Tell() const override;
+    arrow::Status Seek(int64_t position) override;
+    arrow::Result<int64_t> GetSize() override;
+    arrow::Result<int64_t> Read(int64_t nbytes, void * out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override;
+    arrow::Result<int64_t> ReadAt(int64_t position, int64_t nbytes, void * out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(int64_t position, int64_t nbytes) override;
+
+private:
+    std::unique_ptr<DB::SeekableReadBuffer> acquire();
+    void release(std::unique_ptr<DB::SeekableReadBuffer> in);
+
+    ReadBufferCreator creator;
+    const int64_t file_size;
+    /// Of Read and Seek, which aren't called concurrently.
+    int64_t position = 0;
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<DB::SeekableReadBuffer>> idle_buffers;
+    bool is_closed = false;
+};
+
+/// Executor of the range reads of all files, whose threads bound the reads in flight.
+arrow::io::IOContext getRangeReadIOContext(size_t max_concurrency);
+}
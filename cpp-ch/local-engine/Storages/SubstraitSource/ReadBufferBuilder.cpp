@@ -15,6 +15,9 @@
  * limitations under the License.
  */
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include <Disks/IO/AsynchronousBoundedReadBuffer.h>
 #include <Disks/IO/ReadBufferFromAzureBlobStorage.h>
 #include <Disks/IO/ReadBufferFromRemoteFSGather.h>
@@ -24,6 +27,7 @@
 #include <IO/S3/getObjectInfo.h>
 #include <IO/S3Common.h>
 #include <IO/SeekableReadBuffer.h>
+#include <IO/WithFileSize.h>
 #include <IO/BoundedReadBuffer.h>
 #include <Interpreters/Context_fwd.h>
 #include <Storages/HDFS/HDFSCommon.h>
@@ -52,17 +56,11 @@
 #include <aws/s3/model/ListObjectsV2Request.h>
 #include <Common/CHUtil.h>
 
-#include <boost/compute/detail/lru_cache.hpp>
-
 namespace DB
 {
 namespace ErrorCodes
 {
     extern const int BAD_ARGUMENTS;
-    extern const int CANNOT_OPEN_FILE;
-    extern const int UNKNOWN_FILE_SIZE;
-    extern const int CANNOT_SEEK_THROUGH_FILE;
-    extern const int CANNOT_READ_FROM_FILE_DESCRIPTOR;
 }
 }
 
@@ -161,6 +159,41 @@ public:
     }
 };
 
+DB::ReadSettings getReadSettingsWithLocalCache(const Poco::Util::AbstractConfiguration & config, const String & enabled_key)
+{
+    DB::ReadSettings settings;
+    settings.enable_filesystem_cache = config.getBool(enabled_key, false);
+    if (!settings.enable_filesystem_cache)
+        return settings;
+
+    DB::FileCacheSettings file_cache_settings;
+    file_cache_settings.max_size = static_cast<size_t>(config.getUInt64("s3.local_cache.max_size", 100L << 30));
+    auto cache_base_path = config.getString("s3.local_cache.cache_path", "/tmp/gluten/local_cache");
+    if (!fs::exists(cache_base_path))
+        fs::create_directories(cache_base_path);
+    file_cache_settings.base_path = cache_base_path;
+    auto cache = DB::FileCacheFactory::instance().getOrCreate("s3_local_cache", file_cache_settings);
+    cache->initialize();
+    settings.remote_fs_cache = cache;
+    return settings;
+}
+
+std::unique_ptr<DB::SeekableReadBuffer> buildCachedReadBuffer(
+    const String & uri,
+    size_t file_size,
+    std::function<std::unique_ptr<DB::ReadBufferFromFileBase>(size_t read_until_position)> creator,
+    const DB::ReadSettings & settings)
+{
+    /// Keyed by the whole uri, so that the paths of different storages don't collide.
+    DB::StoredObjects stored_objects{DB::StoredObject{uri, file_size}};
+    return std::make_unique<DB::ReadBufferFromRemoteFSGather>(
+        [creator](const std::string &, size_t read_until_position) { return creator(read_until_position); },
+        stored_objects,
+        settings,
+        /* cache_log */ nullptr,
+        /* use_external_buffer */ false);
+}
+
 #if USE_HDFS
 class HDFSFileReadBufferBuilder : public ReadBufferBuilder
 {
@@ -168,6 +201,8 @@ public:
     explicit HDFSFileReadBufferBuilder(DB::ContextPtr context_) : ReadBufferBuilder(context_) { }
     ~HDFSFileReadBufferBuilder() override = default;
 
+    bool isRemote() const override { return true; }
+
     std::unique_ptr<DB::ReadBuffer>
     build(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, bool set_read_util_position) override
     {
@@ -176,12 +211,26 @@ public:
         if (file_uri.getPort())
             uri_path += ":" + std::to_string(file_uri.getPort());
 
-        DB::ReadSettings read_settings;
-        std::unique_ptr<DB::ReadBuffer> read_buffer;
+        DB::ReadSettings read_settings = getReadSettingsWithLocalCache(context->getConfigRef(), "hdfs.local_cache.enabled");
+        std::unique_ptr<DB::SeekableReadBuffer> read_buffer
+            = std::make_unique<DB::ReadBufferFromHDFS>(uri_path, file_uri.getPath(), context->getConfigRef(), read_settings);
+        if (read_settings.enable_filesystem_cache)
+        {
+            auto creator = [uri_path, file_path = file_uri.getPath(), read_settings, this](size_t read_until_position)
+            {
+                return std::make_unique<DB::ReadBufferFromHDFS>(
+                    uri_path, file_path, context->getConfigRef(), read_settings, read_until_position, /* use_external_buffer */ true);
+            };
+            read_buffer = buildCachedReadBuffer(
+                file_info.uri_file(), DB::getFileSizeFromReadBuffer(*read_buffer), std::move(creator), read_settings);
+        }
+        else if (set_read_util_position)
+            read_buffer = std::make_unique<DB::BoundedReadBuffer>(std::move(read_buffer));
+
         if (set_read_util_position)
         {
-            std::pair<size_t, size_t> start_end_pos
-                = adjustFileReadStartAndEndPos(file_info.start(), file_info.start() + file_info.length(), uri_path, file_uri.getPath());
+            /// The boundaries are found over the buffer that reads the split, without a connection and an open of its own.
+            auto start_end_pos = adjustFileReadPosition(*read_buffer, file_info.start(), file_info.start() + file_info.length());
             LOG_DEBUG(
                 &Poco::Logger::get("ReadBufferBuilder"),
                 "File read start and end position adjusted from {},{} to {},{}",
@@ -189,124 +238,12 @@ public:
                 file_info.start() + file_info.length(),
                 start_end_pos.first,
                 start_end_pos.second);
-            read_buffer = std::make_unique<DB::ReadBufferFromHDFS>(
-                uri_path, file_uri.getPath(), context->getConfigRef(), read_settings, start_end_pos.second);
 
-            if (auto * seekable_in = dynamic_cast<DB::SeekableReadBuffer *>(read_buffer.get()))
-                if (start_end_pos.first)
-                    seekable_in->seek(start_end_pos.first, SEEK_SET);
-        }
-        else
-        {
-            read_buffer = std::make_unique<DB::ReadBufferFromHDFS>(uri_path, file_uri.getPath(), context->getConfigRef(), read_settings);
+            read_buffer->seek(start_end_pos.first, SEEK_SET);
+            read_buffer->setReadUntilPosition(start_end_pos.second);
         }
         return read_buffer;
     }
-
-    std::pair<size_t, size_t>
-    adjustFileReadStartAndEndPos(size_t read_start_pos, size_t read_end_pos, std::string uri_path, std::string file_path)
-    {
-        std::string hdfs_file_path = uri_path + file_path;
-        auto builder = DB::createHDFSBuilder(hdfs_file_path, context->getConfigRef());
-        auto fs = DB::createHDFSFS(builder.get());
-        hdfsFile fin = hdfsOpenFile(fs.get(), file_path.c_str(), O_RDONLY, 0, 0, 0);
-        if (!fin)
-            throw DB::Exception(
-                DB::ErrorCodes::CANNOT_OPEN_FILE, "Cannot open hdfs file:{}, error: {}", hdfs_file_path, std::string(hdfsGetLastError()));
-
-        /// Always close hdfs file before exit function.
-        SCOPE_EXIT({ hdfsCloseFile(fs.get(), fin); });
-
-        auto hdfs_file_info = hdfsGetPathInfo(fs.get(), file_path.c_str());
-        if (!hdfs_file_info)
-            throw DB::Exception(
-                DB::ErrorCodes::UNKNOWN_FILE_SIZE,
-                "Cannot find out file size for :{}, error: {}",
-                hdfs_file_path,
-                std::string(hdfsGetLastError()));
-        size_t hdfs_file_size = hdfs_file_info->mSize;
-
-        /// initial_pos maybe in the middle of a row, so we need to find the next row start position.
-        auto get_next_line_pos = [&](hdfsFS hdfsFs, hdfsFile file, size_t initial_pos, size_t file_size) -> size_t
-        {
-            if (initial_pos == 0 || initial_pos == file_size)
-                return initial_pos;
-
-            int seek_ret = hdfsSeek(hdfsFs, file, initial_pos);
-            if (seek_ret < 0)
-                throw DB::Exception(
-                    DB::ErrorCodes::CANNOT_SEEK_THROUGH_FILE,
-                    "Fail to seek HDFS file: {}, error: {}",
-                    file_path,
-                    std::string(hdfsGetLastError()));
-
-            static constexpr size_t buf_size = 1024;
-            char buf[buf_size];
-
-            auto do_read = [&]() -> int
-            {
-                auto n = hdfsRead(hdfsFs, file, buf, buf_size);
-                if (n < 0)
-                    throw DB::Exception(
-                        DB::ErrorCodes::CANNOT_READ_FROM_FILE_DESCRIPTOR,
-                        "Fail to read HDFS file: {}, error: {}",
-                        file_path,
-                        std::string(hdfsGetLastError()));
-
-                return n;
-            };
-
-            auto pos = initial_pos;
-            while (true)
-            {
-                auto n = do_read();
-
-                /// If read to the end of file, return directly.
-                if (n == 0)
-                    return pos;
-
-                /// Search for \n or \r\n or \n\r in buffer.
-                int i = 0;
-                while (i < n)
-                {
-                    if (buf[i] == '\n')
-                    {
-                        if (i + 1 < n)
-                            return buf[i + 1] == '\r' ? pos + i + 2 : pos + i + 1;
-
-                        /// read again if buffer is not enough.
-                        auto m = do_read();
-                        if (m == 0)
-                            return pos + i + 1;
-
-                        return buf[0] == '\r' ? pos + i + 2 : pos + i + 1;
-                    }
-                    else if (buf[i] == '\r')
-                    {
-                        if (i + 1 < n)
-                            return buf[i + 1] == '\n' ? pos + i + 2 : pos + i + 1;
-
-                        /// read again if buffer is not enough.
-                        auto m = do_read();
-                        if (m == 0)
-                            return pos + i + 1;
-
-                        return buf[0] == '\n' ? pos + i + 2 : pos + i + 1;
-                    }
-                    else
-                        ++i;
-                }
-
-                /// Can't find \n or \r\n or \n\r in current buffer, read again.
-                pos += n;
-            }
-        };
-
-        std::pair<size_t, size_t> result;
-        result.first = get_next_line_pos(fs.get(), fin, read_start_pos, hdfs_file_size);
-        result.second = get_next_line_pos(fs.get(), fin, read_end_pos, hdfs_file_size);
-        return result;
-    }
 };
 #endif
 
@@ -318,25 +255,13 @@ class S3FileReadBufferBuilder : public ReadBufferBuilder
 public:
     explicit S3FileReadBufferBuilder(DB::ContextPtr context_) : ReadBufferBuilder(context_)
     {
-        DB::FileCacheSettings file_cache_settings;
-        file_cache_settings.max_size = static_cast<size_t>(context->getConfigRef().getUInt64("s3.local_cache.max_size", 100L << 30));
-        auto cache_base_path = context->getConfigRef().getString("s3.local_cache.cache_path", "/tmp/gluten/local_cache");
-        if (!fs::exists(cache_base_path))
-            fs::create_directories(cache_base_path);
-        file_cache_settings.base_path = cache_base_path;
-        new_settings = DB::ReadSettings();
-        new_settings.enable_filesystem_cache = context->getConfigRef().getBool("s3.local_cache.enabled", false);
-        if (new_settings.enable_filesystem_cache)
-        {
-            auto cache = DB::FileCacheFactory::instance().getOrCreate("s3_local_cache", file_cache_settings);
-            cache->initialize();
-
-            new_settings.remote_fs_cache = cache;
-        }
+        new_settings = getReadSettingsWithLocalCache(context->getConfigRef(), "s3.local_cache.enabled");
     }
 
     ~S3FileReadBufferBuilder() override = default;
 
+    bool isRemote() const override { return true; }
+
     std::unique_ptr<DB::ReadBuffer>
     build(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, bool set_read_util_position) override
     {
@@ -397,8 +322,6 @@ public:
     }
 
 private:
-    static boost::compute::detail::lru_cache<std::string, std::shared_ptr<DB::S3::Client>> per_bucket_clients;
-    static std::shared_ptr<DB::S3::Client> shared_client;
     DB::ReadSettings new_settings;
 
     std::string & stripQuote(std::string & s)
@@ -447,15 +370,42 @@ private:
         }
     }
 
-    void cacheClient(const std::string & bucket_name, const bool is_per_bucket, std::shared_ptr<DB::S3::Client> client)
+    struct CachedClient
     {
-        if (is_per_bucket)
-        {
-            per_bucket_clients.insert(bucket_name, client);
-        }
-        else
+        std::shared_ptr<DB::S3::Client> client;
+        std::atomic<UInt64> last_used = 0;
+    };
+
+    /// Clients by the settings they are created from, so that the buckets with the same settings share one client and a
+    /// new client is created when the settings of a bucket change, e.g. the credentials are rotated. Lookups only take
+    /// the lock shared, the least recently used client is evicted beyond s3.client_cache.max_size.
+    static std::shared_mutex clients_mutex;
+    static std::unordered_map<String, CachedClient> clients;
+    static std::atomic<UInt64> clients_tick;
+
+    static std::shared_ptr<DB::S3::Client> getCachedClient(const String & client_key)
+    {
+        std::shared_lock lock(clients_mutex);
+        auto it = clients.find(client_key);
+        if (it == clients.end())
+            return nullptr;
+        it->second.last_used.store(++clients_tick, std::memory_order_relaxed);
+        return it->second.client;
+    }
+
+    static void cacheClient(const String & client_key, std::shared_ptr<DB::S3::Client> client, size_t max_clients)
+    {
+        std::unique_lock lock(clients_mutex);
+        auto & cached = clients[client_key];
+        cached.client = std::move(client);
+        cached.last_used.store(++clients_tick, std::memory_order_relaxed);
+        while (clients.size() > std::max<size_t>(max_clients, 1))
         {
-            shared_client = client;
+            auto lru = clients.begin();
+            for (auto it = clients.begin(); it != clients.end(); ++it)
+                if (it->second.last_used.load(std::memory_order_relaxed) < lru->second.last_used.load(std::memory_order_relaxed))
+                    lru = it;
+            clients.erase(lru);
         }
     }
 
@@ -463,29 +413,44 @@ private:
     {
         const auto & config = context->getConfigRef();
         const auto & settings = context->getSettingsRef();
-        bool use_assumed_role = false;
-        bool is_per_bucket = false;
-
-        if (!getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_ROLE).empty())
-            use_assumed_role = true;
-
-        if (!getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_ROLE, "", true).empty())
-            is_per_bucket = true;
+        String config_prefix = "s3";
 
-        if (is_per_bucket && per_bucket_clients.contains(bucket_name)
-            && "true" != getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_CLIENT_CACHE_IGNORE))
-        {
-            return per_bucket_clients.get(bucket_name).get();
-        }
+        const auto role_arn = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_ROLE);
+        const auto session_name = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_SESSION_NAME);
+        const auto external_id = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_EXTERNAL_ID);
+        auto endpoint = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ENDPOINT, "https://s3.us-west-2.amazonaws.com");
+        std::string ak;
+        std::string sk;
+        settings.tryGetString(BackendInitializerUtil::HADOOP_S3_ACCESS_KEY, ak);
+        settings.tryGetString(BackendInitializerUtil::HADOOP_S3_SECRET_KEY, sk);
+        stripQuote(ak);
+        stripQuote(sk);
 
-        if (!is_per_bucket && shared_client
-            && "true" != getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_CLIENT_CACHE_IGNORE))
-        {
-            return shared_client;
-        }
+        const auto connect_timeout_ms = config.getUInt(config_prefix + ".connect_timeout_ms", 10000);
+        const auto request_timeout_ms = config.getUInt(config_prefix + ".request_timeout_ms", 5000);
+        const auto max_connections = config.getUInt(config_prefix + ".max_connections", 100);
+        const auto http_connection_pool_size = config.getUInt64(config_prefix + ".http_connection_pool_size", 0);
+        const auto http_keep_alive_timeout_ms = config.getUInt64(config_prefix + ".http_keep_alive_timeout_ms", 0);
+        const auto retry_attempts = config.getUInt(config_prefix + ".retry_attempts", 10);
+
+        const String client_key = fmt::format(
+            "{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}",
+            endpoint,
+            ak,
+            sk,
+            role_arn,
+            session_name,
+            external_id,
+            connect_timeout_ms,
+            request_timeout_ms,
+            max_connections,
+            http_connection_pool_size,
+            http_keep_alive_timeout_ms,
+            retry_attempts);
+        if ("true" != getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_CLIENT_CACHE_IGNORE))
+            if (auto client = getCachedClient(client_key))
+                return client;
 
-        String config_prefix = "s3";
-        auto endpoint = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ENDPOINT, "https://s3.us-west-2.amazonaws.com");
         if (!endpoint.starts_with("https://"))
         {
             if (endpoint.starts_with("s3"))
@@ -516,23 +481,22 @@ private:
             nullptr,
             nullptr);
 
-        client_configuration.connectTimeoutMs = config.getUInt(config_prefix + ".connect_timeout_ms", 10000);
-        client_configuration.requestTimeoutMs = config.getUInt(config_prefix + ".request_timeout_ms", 5000);
-        client_configuration.maxConnections = config.getUInt(config_prefix + ".max_connections", 100);
+        client_configuration.connectTimeoutMs = connect_timeout_ms;
+        client_configuration.requestTimeoutMs = request_timeout_ms;
+        client_configuration.maxConnections = max_connections;
+        /// Connections kept alive to the endpoint, which the reads of the splits reuse rather than shaking hands again.
+        if (http_connection_pool_size)
+            client_configuration.http_connection_pool_size = http_connection_pool_size;
+        if (http_keep_alive_timeout_ms)
+            client_configuration.http_keep_alive_timeout_ms = http_keep_alive_timeout_ms;
         client_configuration.endpointOverride = endpoint;
 
-        client_configuration.retryStrategy
-            = std::make_shared<Aws::Client::DefaultRetryStrategy>(config.getUInt(config_prefix + ".retry_attempts", 10));
+        client_configuration.retryStrategy = std::make_shared<Aws::Client::DefaultRetryStrategy>(retry_attempts);
 
-        std::string ak;
-        std::string sk;
-        settings.tryGetString(BackendInitializerUtil::HADOOP_S3_ACCESS_KEY, ak);
-        settings.tryGetString(BackendInitializerUtil::HADOOP_S3_SECRET_KEY, sk);
-        stripQuote(ak);
-        stripQuote(sk);
-        if (use_assumed_role)
+        std::shared_ptr<DB::S3::Client> client;
+        if (!role_arn.empty())
         {
-            auto new_client = DB::S3::ClientFactory::instance().create(
+            client = DB::S3::ClientFactory::instance().create(
                 client_configuration,
                 false,
                 ak,
@@ -542,57 +506,127 @@ private:
                 {},
                 {.use_environment_credentials = true,
                  .use_insecure_imds_request = false,
-                 .role_arn = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_ROLE),
-                 .session_name = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_SESSION_NAME),
-                 .external_id = getSetting(settings, bucket_name, BackendInitializerUtil::HADOOP_S3_ASSUMED_EXTERNAL_ID)});
-
-            //TODO: support online change config for cached per_bucket_clients
-            std::shared_ptr<DB::S3::Client> ret = std::move(new_client);
-            cacheClient(bucket_name, is_per_bucket, ret);
-            return ret;
+                 .role_arn = role_arn,
+                 .session_name = session_name,
+                 .external_id = external_id});
         }
         else
         {
-            auto new_client = DB::S3::ClientFactory::instance().create(
+            client = DB::S3::ClientFactory::instance().create(
                 client_configuration, false, ak, sk, "", {}, {}, {.use_environment_credentials = true, .use_insecure_imds_request = false});
-
-            std::shared_ptr<DB::S3::Client> ret = std::move(new_client);
-            cacheClient(bucket_name, is_per_bucket, ret);
-            return ret;
         }
+        cacheClient(client_key, client, config.getUInt64(config_prefix + ".client_cache.max_size", 1000));
+        return client;
     }
 };
-boost::compute::detail::lru_cache<std::string, std::shared_ptr<DB::S3::Client>> S3FileReadBufferBuilder::per_bucket_clients(100);
-std::shared_ptr<DB::S3::Client> S3FileReadBufferBuilder::shared_client;
+std::shared_mutex S3FileReadBufferBuilder::clients_mutex;
+std::unordered_map<String, S3FileReadBufferBuilder::CachedClient> S3FileReadBufferBuilder::clients;
+std::atomic<UInt64> S3FileReadBufferBuilder::clients_tick = 0;
 
 #endif
 
 #if USE_AZURE_BLOB_STORAGE
 class AzureBlobReadBuffer : public ReadBufferBuilder
 {
+    friend void registerReadBufferBuilders();
+
 public:
-    explicit AzureBlobReadBuffer(DB::ContextPtr context_) : ReadBufferBuilder(context_) { }
+    explicit AzureBlobReadBuffer(DB::ContextPtr context_) : ReadBufferBuilder(context_)
+    {
+        const auto & config = context->getConfigRef();
+        read_settings = getReadSettingsWithLocalCache(context->getConfigRef(), "azure.local_cache.enabled");
+        read_settings.remote_fs_buffer_size = config.getUInt64("azure.max_read_buffer_size", read_settings.remote_fs_buffer_size);
+        read_settings.remote_fs_prefetch = config.getBool("azure.prefetch", read_settings.remote_fs_prefetch);
+        max_single_read_retries = config.getUInt64("azure.max_single_read_retries", 5);
+        max_single_download_retries = config.getUInt64("azure.max_single_download_retries", 5);
+    }
     ~AzureBlobReadBuffer() override = default;
 
-    std::unique_ptr<DB::ReadBuffer> build(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, bool) override
+    bool isRemote() const override { return true; }
+
+    std::unique_ptr<DB::ReadBuffer> build(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, bool set_read_util_position) override
     {
         Poco::URI file_uri(file_info.uri_file());
-        std::unique_ptr<DB::ReadBuffer> read_buffer;
-        read_buffer = std::make_unique<DB::ReadBufferFromAzureBlobStorage>(getClient(), file_uri.getPath(), DB::ReadSettings(), 5, 5);
-        return read_buffer;
+        auto client = getClient();
+        auto path = file_uri.getPath();
+        size_t object_size = client->GetBlobClient(path).GetProperties().Value.BlobSize;
+
+        auto read_buffer_creator = [client, path, this](const std::string &, size_t read_until_position) -> std::unique_ptr<DB::ReadBufferFromFileBase>
+        {
+            return std::make_unique<DB::ReadBufferFromAzureBlobStorage>(
+                client,
+                path,
+                read_settings,
+                max_single_read_retries,
+                max_single_download_retries,
+                /* use_external_buffer */ true,
+                /* restricted_seek */ true,
+                read_until_position);
+        };
+
+        /// Read as the S3 files are, the reads of a split coalesced into ranges and prefetched. Keyed by the whole uri in
+        /// the local cache, so that the paths of different storages don't collide.
+        DB::StoredObjects stored_objects{DB::StoredObject{file_info.uri_file(), object_size}};
+        auto azure_impl = std::make_unique<DB::ReadBufferFromRemoteFSGather>(
+            std::move(read_buffer_creator), stored_objects, read_settings, /* cache_log */ nullptr, /* use_external_buffer */ false);
+
+        auto & pool_reader = context->getThreadPoolReader(DB::FilesystemReaderType::ASYNCHRONOUS_REMOTE_FS_READER);
+        auto async_reader
+            = std::make_unique<DB::AsynchronousBoundedReadBuffer>(std::move(azure_impl), pool_reader, read_settings, nullptr, nullptr);
+
+        if (set_read_util_position)
+        {
+            auto start_end_pos = adjustFileReadPosition(*async_reader, file_info.start(), file_info.start() + file_info.length());
+            LOG_DEBUG(
+                &Poco::Logger::get("ReadBufferBuilder"),
+                "File read start and end position adjusted from {},{} to {},{}",
+                file_info.start(),
+                file_info.start() + file_info.length(),
+                start_end_pos.first,
+                start_end_pos.second);
+
+            async_reader->seek(start_end_pos.first, SEEK_SET);
+            async_reader->setReadUntilPosition(start_end_pos.second);
+        }
+        else
+        {
+            async_reader->setReadUntilEnd();
+        }
+
+        if (read_settings.remote_fs_prefetch)
+            async_reader->prefetch(Priority{});
+
+        return async_reader;
     }
 
 private:
-    std::shared_ptr<Azure::Storage::Blobs::BlobContainerClient> shared_client;
+    DB::ReadSettings read_settings;
+    size_t max_single_read_retries;
+    size_t max_single_download_retries;
+
+    /// Clients by account and container, shared by the builders of all tasks, so that the connections of a client are
+    /// reused by the splits rather than set up for each of them.
+    static std::mutex clients_mutex;
+    static std::unordered_map<String, std::shared_ptr<Azure::Storage::Blobs::BlobContainerClient>> clients;
 
     std::shared_ptr<Azure::Storage::Blobs::BlobContainerClient> getClient()
     {
-        if (shared_client)
-            return shared_client;
-        shared_client = DB::getAzureBlobContainerClient(context->getConfigRef(), "blob");
-        return shared_client;
+        const auto & config = context->getConfigRef();
+        const String client_key = fmt::format(
+            "{}\n{}\n{}",
+            config.getString("blob.connection_string", ""),
+            config.getString("blob.storage_account_url", ""),
+            config.getString("blob.container_name", ""));
+
+        std::lock_guard lock(clients_mutex);
+        auto & client = clients[client_key];
+        if (!client)
+            client = DB::getAzureBlobContainerClient(config, "blob");
+        return client;
     }
 };
+std::mutex AzureBlobReadBuffer::clients_mutex;
+std::unordered_map<String, std::shared_ptr<Azure::Storage::Blobs::BlobContainerClient>> AzureBlobReadBuffer::clients;
 #endif
 
 void registerReadBufferBuilders()
@@ -610,14 +644,20 @@ void registerReadBufferBuilders()
     factory.registerCleaner(
         []()
         {
-            S3FileReadBufferBuilder::per_bucket_clients.clear();
-            S3FileReadBufferBuilder::shared_client.reset();
+            std::unique_lock lock(S3FileReadBufferBuilder::clients_mutex);
+            S3FileReadBufferBuilder::clients.clear();
         });
 #endif
 
 #if USE_AZURE_BLOB_STORAGE
     factory.registerBuilder("wasb", [](DB::ContextPtr context_) { return std::make_shared<AzureBlobReadBuffer>(context_); });
     factory.registerBuilder("wasbs", [](DB::ContextPtr context_) { return std::make_shared<AzureBlobReadBuffer>(context_); });
+    factory.registerCleaner(
+        []()
+        {
+            std::lock_guard lock(AzureBlobReadBuffer::clients_mutex);
+            AzureBlobReadBuffer::clients.clear();
+        });
 #endif
 }
 
@@ -18,6 +18,9 @@
 #include <functional>
 #include <memory>
 #include <IO/ReadBuffer.h>
+#include <IO/ReadBufferFromFileBase.h>
+#include <IO/ReadSettings.h>
+#include <IO/SeekableReadBuffer.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/Context_fwd.h>
 #include <boost/core/noncopyable.hpp>
@@ -25,6 +28,22 @@
 
 namespace local_engine
 {
+/// The positions past the first line end at or after the start and the end of a text file split, so that the splits
+/// of a file read each line once.
+std::pair<size_t, size_t> adjustFileReadPosition(DB::SeekableReadBuffer & buffer, size_t read_start_pos, size_t read_end_pos);
+
+/// Read settings through the filesystem cache on local disks if the config enabled_key is set. The remote storages
+/// share the one cache, bounded by s3.local_cache.max_size in total.
+DB::ReadSettings getReadSettingsWithLocalCache(const Poco::Util::AbstractConfiguration & config, const String & enabled_key);
+
+/// Reads the file of uri through the local cache, a segment at a time, each missed segment read by a buffer of
+/// creator bounded by the segment.
+std::unique_ptr<DB::SeekableReadBuffer> buildCachedReadBuffer(
+    const String & uri,
+    size_t file_size,
+    std::function<std::unique_ptr<DB::ReadBufferFromFileBase>(size_t read_until_position)> creator,
+    const DB::ReadSettings & settings);
+
 class ReadBufferBuilder
 {
 public:
@@ -47,6 +66,10 @@ public:
                                                           : std::move(in);
     }
 
+    /// Whether build() reads over the network, where columnar formats fetch the byte ranges they need over buffers
+    /// of their own concurrently, see RangeReadFile.
+    virtual bool isRemote() const { return false; }
+
 protected:
     DB::ContextPtr context;
 };
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StatisticsAggregation.h"
+#include <Columns/ColumnAggregateFunction.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/VarInt.h>
+#include <IO/WriteBufferFromString.h>
+#include <Interpreters/convertFieldToType.h>
+#include <Common/assert_cast.h>
+
+namespace local_engine
+{
+StatisticsAggregation::StatisticsAggregation(std::vector<Aggregate> aggregates_) : aggregates(std::move(aggregates_))
+{
+    states.reserve(aggregates.size());
+    for (const auto & aggregate : aggregates)
+    {
+        auto * place = arena.alignedAlloc(aggregate.function->sizeOfData(), aggregate.function->alignOfData());
+        aggregate.function->create(place);
+        states.emplace_back(place);
+    }
+}
+
+StatisticsAggregation::~StatisticsAggregation()
+{
+    for (size_t i = 0; i < aggregates.size(); ++i)
+        aggregates[i].function->destroy(states[i]);
+}
+
+bool StatisticsAggregation::tryAdd(size_t num_rows, const StatisticsGetter & get_statistics)
+{
+    std::vector<std::optional<ColumnStatistics>> column_statistics(aggregates.size());
+    for (size_t i = 0; i < aggregates.size(); ++i)
+    {
+        if (aggregates[i].column.empty())
+            continue;
+        column_statistics[i] = get_statistics(aggregates[i].column, aggregates[i].type);
+        if (!column_statistics[i] || column_statistics[i]->null_count > num_rows)
+            return false;
+    }
+
+    std::lock_guard lock(mutex);
+    for (size_t i = 0; i < aggregates.size(); ++i)
+    {
+        if (aggregates[i].kind == Kind::Count)
+            addCount(i, column_statistics[i] ? num_rows - column_statistics[i]->null_count : num_rows);
+        else
+            addMinMax(i, *column_statistics[i]);
+    }
+    ++added_row_groups;
+    return true;
+}
+
+size_t StatisticsAggregation::getAddedRowGroups() const
+{
+    std::lock_guard lock(mutex);
+    return added_row_groups;
+}
+
+bool StatisticsAggregation::appendTo(DB::MutableColumns & columns)
+{
+    std::lock_guard lock(mutex);
+    if (!added_row_groups || appended)
+        return false;
+    for (size_t i = 0; i < aggregates.size(); ++i)
+        assert_cast<DB::ColumnAggregateFunction &>(*columns[i]).insertFrom(states[i]);
+    appended = true;
+    return true;
+}
+
+void StatisticsAggregation::addCount(size_t i, UInt64 rows)
+{
+    /// The state of count is its number varint encoded, also for the not null count over a nullable column. Rows are
+    /// counted without a column of them.
+    DB::WriteBufferFromOwnString out;
+    DB::writeVarUInt(rows, out);
+    String serialized = out.str();
+    DB::ReadBufferFromString in(serialized);
+
+    const auto & function = aggregates[i].function;
+    auto * place = arena.alignedAlloc(function->sizeOfData(), function->alignOfData());
+    function->create(place);
+    function->deserialize(place, in, std::nullopt, &arena);
+    function->merge(states[i], place, &arena);
+    function->destroy(place);
+}
+
+void StatisticsAggregation::addMinMax(size_t i, const ColumnStatistics & statistics)
+{
+    /// Nothing to add for a row group of nulls.
+    if (statistics.min.isNull())
+        return;
+    const auto & aggregate = aggregates[i];
+    auto column = aggregate.type->createColumn();
+    column->insert(DB::convertFieldToType(statistics.min, *aggregate.type));
+    column->insert(DB::convertFieldToType(statistics.max, *aggregate.type));
+    const DB::IColumn * columns[] = {column.get()};
+    aggregate.function->addBatchSinglePlace(0, 2, states[i], columns, &arena);
+}
+}
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <AggregateFunctions/IAggregateFunction.h>
+#include <Columns/IColumn.h>
+#include <Common/Arena.h>
+#include <Core/Field.h>
+#include <DataTypes/IDataType.h>
+
+namespace local_engine
+{
+/// The count, min and max partial aggregates without grouping keys over the columns of a scan, answered from the
+/// statistics of the row groups where they are exact. The scan skips the row groups added here, and the states of them
+/// are appended to the aggregated result as one more row by the StatisticsAggregateStep after the aggregation.
+class StatisticsAggregation
+{
+public:
+    enum class Kind
+    {
+        Count,
+        Min,
+        Max,
+    };
+
+    struct Aggregate
+    {
+        Kind kind;
+        /// The column of the scan aggregated, empty for count(*).
+        String column;
+        /// The argument type of function, maybe the nullable of the column type.
+        DB::DataTypePtr type;
+        DB::AggregateFunctionPtr function;
+        /// The name of the state column in the aggregated result.
+        String result_name;
+    };
+
+    /// The statistics of a column in a row group, all of them exact.
+    struct ColumnStatistics
+    {
+        UInt64 null_count = 0;
+        /// Null if every value is null.
+        DB::Field min;
+        DB::Field max;
+    };
+
+    /// The statistics of a column of the row group, or nothing if they are missing or inexact for the type.
+    using StatisticsGetter = std::function<std::optional<ColumnStatistics>(const String & column, const DB::DataTypePtr & type)>;
+
+    explicit StatisticsAggregation(std::vector<Aggregate> aggregates_);
+    ~StatisticsAggregation();
+
+    const std::vector<Aggregate> & getAggregates() const { return aggregates; }
+
+    /// Adds a row group of num_rows rows if its statistics answer every aggregate, otherwise it has to be read.
+    bool tryAdd(size_t num_rows, const StatisticsGetter & get_statistics);
+
+    size_t getAddedRowGroups() const;
+
+    /// Appends the states of the row groups added as one row to the state columns of the aggregates, once. False if
+    /// nothing was added or it was appended already.
+    bool appendTo(DB::MutableColumns & columns);
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Aggregate> aggregates;
+    DB::Arena arena;
+    std::vector<DB::AggregateDataPtr> states;
+    size_t added_row_groups = 0;
+    bool appended = false;
+
+    void addCount(size_t i, UInt64 rows);
+    void addMinMax(size_t i, const ColumnStatistics & statistics);
+};
+using StatisticsAggregationPtr = std::shared_ptr<StatisticsAggregation>;
+}
@@ -37,14 +37,24 @@
 #include <Storages/SubstraitSource/FormatFile.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
+#include <base/scope_guard.h>
+#include <Common/scope_guard_safe.h>
 #include <Common/CHUtil.h>
+#include <Common/CurrentThread.h>
 #include <Common/Exception.h>
+#include <Common/ProfileEvents.h>
 #include <Common/StringUtils.h>
 #include <Common/typeid_cast.h>
 #include "DataTypes/DataTypesDecimal.h"
 #include "IO/readDecimalText.h"
 #include <boost/stacktrace.hpp>
 
+namespace ProfileEvents
+{
+    extern const Event CachedReadBufferReadFromCacheBytes;
+    extern const Event CachedReadBufferReadFromSourceBytes;
+}
+
 namespace DB
 {
 namespace ErrorCodes
@@ -121,6 +131,8 @@ SubstraitFileSource::SubstraitFileSource(
                 to_read_header.erase(key);
         }
     }
+    max_prefetched_readers = context->getConfigRef().getUInt64("file_source.prefetch_files", 2);
+    max_parallel_units = context->getConfigRef().getUInt64("file_source.max_parallel_units", 1);
 }
 
 void SubstraitFileSource::applyFilters(std::vector<SourceFilter> filters_) const
@@ -132,6 +144,24 @@ void SubstraitFileSource::applyFilters(std::vector<SourceFilter> filters_) const
     }
 }
 
+void SubstraitFileSource::setStatisticsAggregation(StatisticsAggregationPtr aggregation) const
+{
+    for (const auto & file : files)
+        file->setStatisticsAggregation(aggregation);
+}
+
+PagePruningStats SubstraitFileSource::getPagePruningStats() const
+{
+    PagePruningStats stats;
+    for (const auto & file : files)
+    {
+        auto file_stats = file->getPagePruningStats();
+        stats.pages_read += file_stats.pages_read;
+        stats.pages_skipped += file_stats.pages_skipped;
+    }
+    return stats;
+}
+
 std::vector<String> SubstraitFileSource::getPartitionKeys() const
 {
     return files.size() > 0 ? files[0]->getFilePartitionKeys() : std::vector<String>();
@@ -143,6 +173,27 @@ DB::String SubstraitFileSource::getFileFormat() const
 }
 
 DB::Chunk SubstraitFileSource::generate()
+{
+    /// The cached read buffers count the bytes into the profile events of the thread reading through them.
+    auto & events = DB::CurrentThread::getProfileEvents();
+    auto hit_bytes = events[ProfileEvents::CachedReadBufferReadFromCacheBytes].load(std::memory_order_relaxed);
+    auto miss_bytes = events[ProfileEvents::CachedReadBufferReadFromSourceBytes].load(std::memory_order_relaxed);
+    SCOPE_EXIT({
+        file_cache_stats.hit_bytes += events[ProfileEvents::CachedReadBufferReadFromCacheBytes].load(std::memory_order_relaxed) - hit_bytes;
+        file_cache_stats.miss_bytes
+            += events[ProfileEvents::CachedReadBufferReadFromSourceBytes].load(std::memory_order_relaxed) - miss_bytes;
+    });
+    /// The reader buffers stay counted, the chunks go downstream.
+    DB::Chunk chunk;
+    {
+        ProcessorMemoryTracker::Scope memory_scope(memory_tracker);
+        chunk = generateImpl();
+    }
+    memory_tracker.release(chunk.allocatedBytes());
+    return chunk;
+}
+
+DB::Chunk SubstraitFileSource::generateImpl()
 {
     while (true)
     {
@@ -181,34 +232,77 @@ bool SubstraitFileSource::tryPrepareReader()
     if (current_file_index >= files.size())
         return false;
 
-    auto current_file = files[current_file_index];
+    if (!prefetched_readers.empty())
+    {
+        file_reader = prefetched_readers.front().reader.get();
+        prefetched_readers.front().thread.join();
+        prefetched_readers.pop_front();
+    }
+    else
+        file_reader = createFileReader(files[current_file_index]);
     current_file_index += 1;
+    prefetchReaders();
+    return true;
+}
 
-    if (!current_file->supportSplit() && current_file->getStartOffset())
+std::unique_ptr<FileReaderWrapper> SubstraitFileSource::createFileReader(FormatFilePtr file) const
+{
+    if (!file->supportSplit() && file->getStartOffset())
     {
         /// For the files do not support split strategy, the task with not 0 offset will generate empty data
-        file_reader = std::make_unique<EmptyFileReader>(current_file);
-        return true;
+        return std::make_unique<EmptyFileReader>(file);
     }
 
     if (!to_read_header.columns())
     {
-        auto total_rows = current_file->getTotalRows();
+        auto total_rows = file->getTotalRows();
         if (total_rows)
-            file_reader = std::make_unique<ConstColumnsFileReader>(current_file, context, flatten_output_header, *total_rows);
-        else
-        {
-            /// For text/json format file, we can't get total rows from file metadata.
-            /// So we add a dummy column to indicate the number of rows.
-            auto dummy_header = BlockUtil::buildRowCountHeader();
-            auto flatten_output_header_contains_dummy = flatten_output_header;
-            flatten_output_header_contains_dummy.insertUnique(dummy_header.getByPosition(0));
-            file_reader = std::make_unique<NormalFileReader>(current_file, context, dummy_header, flatten_output_header_contains_dummy);
-        }
+            return std::make_unique<ConstColumnsFileReader>(file, context, flatten_output_header, *total_rows);
+
+        /// For text/json format file, we can't get total rows from file metadata.
+        /// So we add a dummy column to indicate the number of rows.
+        auto dummy_header = BlockUtil::buildRowCountHeader();
+        auto flatten_output_header_contains_dummy = flatten_output_header;
+        flatten_output_header_contains_dummy.insertUnique(dummy_header.getByPosition(0));
+        return std::make_unique<NormalFileReader>(file, context, dummy_header, flatten_output_header_contains_dummy);
     }
-    else
-        file_reader = std::make_unique<NormalFileReader>(current_file, context, to_read_header, flatten_output_header);
-    return true;
+    if (max_parallel_units > 1)
+    {
+        if (auto units = file->getReadUnitCount(); units > 1)
+            return std::make_unique<ParallelFileReader>(file, context, to_read_header, flatten_output_header, units, max_parallel_units);
+    }
+    return std::make_unique<NormalFileReader>(file, context, to_read_header, flatten_output_header);
+}
+
+void SubstraitFileSource::prefetchReaders()
+{
+    /// The next files are opened, their footers fetched and their first chunks read on other threads, so that their
+    /// latency overlaps the decoding of the current file.
+    next_prefetch_index = std::max(next_prefetch_index, current_file_index);
+    auto thread_group = DB::CurrentThread::getGroup();
+    while (prefetched_readers.size() < max_prefetched_readers && next_prefetch_index < files.size())
+    {
+        auto task = std::make_shared<std::packaged_task<std::unique_ptr<FileReaderWrapper>()>>(
+            [this, file = files[next_prefetch_index], thread_group]()
+            {
+                if (thread_group)
+                    DB::CurrentThread::attachToGroupIfDetached(thread_group);
+                SCOPE_EXIT_SAFE(if (thread_group) DB::CurrentThread::detachFromGroupIfNotDetached(););
+                auto reader = createFileReader(file);
+                reader->prefetch();
+                return reader;
+            });
+        auto & prefetched = prefetched_readers.emplace_back();
+        prefetched.reader = task->get_future();
+        prefetched.thread = ThreadFromGlobalPool([task]() { (*task)(); });
+        next_prefetch_index += 1;
+    }
+}
+
+SubstraitFileSource::~SubstraitFileSource()
+{
+    for (auto & prefetched : prefetched_readers)
+        prefetched.thread.join();
 }
 
 DB::Block SubstraitFileSource::foldFlattenColumns(
@@ -271,12 +365,8 @@ SubstraitFileSource::foldFlattenColumn(DB::DataTypePtr col_type, const std::stri
 
 DB::ColumnPtr FileReaderWrapper::createConstColumn(DB::DataTypePtr data_type, const DB::Field & field, size_t rows)
 {
-    auto nested_type = DB::removeNullable(data_type);
-    auto column = nested_type->createColumnConst(rows, field);
-
-    if (data_type->isNullable())
-        column = DB::ColumnNullable::create(column, DB::ColumnUInt8::create(rows, 0));
-    return column;
+    // Const(Nullable) for nullable types, so that the column stays constant downstream.
+    return data_type->createColumnConst(rows, field);
 }
 
 DB::ColumnPtr FileReaderWrapper::createColumn(const String & value, DB::DataTypePtr type, size_t rows)
@@ -287,9 +377,7 @@ DB::ColumnPtr FileReaderWrapper::createColumn(const String & value, DB::DataType
         {
             throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Partition column is null value,but column data type is not nullable.");
         }
-        auto nested_type = static_cast<const DB::DataTypeNullable &>(*type).getNestedType();
-        auto column = nested_type->createColumnConstWithDefaultValue(rows);
-        return DB::ColumnNullable::create(column, DB::ColumnUInt8::create(rows, 1));
+        return type->createColumnConstWithDefaultValue(rows);
     }
     else
     {
@@ -298,6 +386,23 @@ DB::ColumnPtr FileReaderWrapper::createColumn(const String & value, DB::DataType
     }
 }
 
+DB::ColumnPtr FileReaderWrapper::getPartitionColumn(const String & name, const DB::DataTypePtr & type, size_t rows)
+{
+    auto it = partition_columns.find(name);
+    if (it == partition_columns.end())
+    {
+        const auto & partition_values = file->getFilePartitionValues();
+        auto value = partition_values.find(name);
+        if (value == partition_values.end())
+        {
+            throw DB::Exception(
+                DB::ErrorCodes::LOGICAL_ERROR, "Not found column({}) from file({}) partition keys.", name, file->getURIPath());
+        }
+        it = partition_columns.emplace(name, createColumn(value->second, type, 1)).first;
+    }
+    return it->second->cloneResized(rows);
+}
+
 #define BUILD_INT_FIELD(type) \
     [](DB::ReadBuffer & in, const String &) \
     { \
@@ -432,18 +537,10 @@ bool ConstColumnsFileReader::pull(DB::Chunk & chunk)
     if (columns_num)
     {
         res_columns.reserve(columns_num);
-        const auto & partition_values = file->getFilePartitionValues();
         for (size_t pos = 0; pos < columns_num; ++pos)
         {
-            auto col_with_name_and_type = header.getByPosition(pos);
-            auto type = col_with_name_and_type.type;
-            const auto & name = col_with_name_and_type.name;
-            auto it = partition_values.find(name);
-            if (it == partition_values.end()) [[unlikely]]
-            {
-                throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Unknow partition column : {}", name);
-            }
-            res_columns.emplace_back(createColumn(it->second, type, to_read_rows));
+            const auto & col_with_name_and_type = header.getByPosition(pos);
+            res_columns.emplace_back(getPartitionColumn(col_with_name_and_type.name, col_with_name_and_type.type, to_read_rows));
         }
     }
     else
@@ -458,20 +555,44 @@ bool ConstColumnsFileReader::pull(DB::Chunk & chunk)
 
 NormalFileReader::NormalFileReader(
     FormatFilePtr file_, DB::ContextPtr context_, const DB::Block & to_read_header_, const DB::Block & output_header_)
-    : FileReaderWrapper(file_), context(context_), to_read_header(to_read_header_), output_header(output_header_)
+    : NormalFileReader(file_, context_, to_read_header_, output_header_, file_->createInputFormat(to_read_header_))
+{
+}
+
+NormalFileReader::NormalFileReader(
+    FormatFilePtr file_,
+    DB::ContextPtr context_,
+    const DB::Block & to_read_header_,
+    const DB::Block & output_header_,
+    FormatFile::InputFormatPtr input_format_)
+    : FileReaderWrapper(file_)
+    , context(context_)
+    , to_read_header(to_read_header_)
+    , output_header(output_header_)
+    , input_format(std::move(input_format_))
 {
-    input_format = file->createInputFormat(to_read_header);
     DB::Pipe pipe(input_format->input);
     pipeline = std::make_unique<DB::QueryPipeline>(std::move(pipe));
     reader = std::make_unique<DB::PullingPipelineExecutor>(*pipeline);
 }
 
 
+void NormalFileReader::prefetch()
+{
+    DB::Chunk tmp_chunk;
+    reader->pull(tmp_chunk);
+    prefetched_chunk = std::move(tmp_chunk);
+}
+
 bool NormalFileReader::pull(DB::Chunk & chunk)
 {
     DB::Chunk tmp_chunk;
-    auto status = reader->pull(tmp_chunk);
-    if (!status)
+    if (prefetched_chunk)
+    {
+        tmp_chunk = std::move(*prefetched_chunk);
+        prefetched_chunk.reset();
+    }
+    else if (!reader->pull(tmp_chunk))
         return false;
 
     size_t rows = tmp_chunk.getNumRows();
@@ -479,11 +600,10 @@ bool NormalFileReader::pull(DB::Chunk & chunk)
         return false;
 
     auto read_columns = tmp_chunk.detachColumns();
-    auto columns_with_name_and_type = output_header.getColumnsWithTypeAndName();
-    auto partition_values = file->getFilePartitionValues();
+    const auto & columns_with_name_and_type = output_header.getColumnsWithTypeAndName();
 
     DB::Columns res_columns;
-    for (auto & column : columns_with_name_and_type)
+    for (const auto & column : columns_with_name_and_type)
     {
         if (to_read_header.has(column.name))
         {
@@ -491,19 +611,75 @@ bool NormalFileReader::pull(DB::Chunk & chunk)
             res_columns.push_back(read_columns[pos]);
         }
         else
-        {
-            auto it = partition_values.find(column.name);
-            if (it == partition_values.end())
-            {
-                throw DB::Exception(
-                    DB::ErrorCodes::LOGICAL_ERROR, "Not found column({}) from file({}) partition keys.", column.name, file->getURIPath());
-            }
-            res_columns.push_back(createColumn(it->second, column.type, rows));
-        }
+            res_columns.push_back(getPartitionColumn(column.name, column.type, rows));
     }
 
     chunk = DB::Chunk(std::move(res_columns), rows);
     return true;
 }
 
+ParallelFileReader::ParallelFileReader(
+    FormatFilePtr file_,
+    DB::ContextPtr context_,
+    const DB::Block & to_read_header_,
+    const DB::Block & output_header_,
+    size_t units_,
+    size_t max_parallelism_)
+    : FileReaderWrapper(file_)
+    , context(context_)
+    , to_read_header(to_read_header_)
+    , output_header(output_header_)
+    , units(units_)
+    , max_parallelism(max_parallelism_)
+{
+    decodeNextUnits();
+}
+
+ParallelFileReader::~ParallelFileReader()
+{
+    for (auto & unit : decoding_units)
+        unit.thread.join();
+}
+
+void ParallelFileReader::decodeNextUnits()
+{
+    auto thread_group = DB::CurrentThread::getGroup();
+    while (decoding_units.size() < max_parallelism && next_unit < units)
+    {
+        auto task = std::make_shared<std::packaged_task<DB::Chunks()>>(
+            [this, unit = next_unit, thread_group]()
+            {
+                if (thread_group)
+                    DB::CurrentThread::attachToGroupIfDetached(thread_group);
+                SCOPE_EXIT_SAFE(if (thread_group) DB::CurrentThread::detachFromGroupIfNotDetached(););
+                NormalFileReader reader(file, context, to_read_header, output_header, file->createInputFormat(to_read_header, unit));
+                DB::Chunks chunks;
+                DB::Chunk chunk;
+                while (reader.pull(chunk))
+                    chunks.emplace_back(std::move(chunk));
+                return chunks;
+            });
+        auto & decoding = decoding_units.emplace_back();
+        decoding.chunks = task->get_future();
+        decoding.thread = ThreadFromGlobalPool([task]() { (*task)(); });
+        ++next_unit;
+    }
+}
+
+bool ParallelFileReader::pull(DB::Chunk & chunk)
+{
+    while (current_chunk >= current_chunks.size())
+    {
+        if (decoding_units.empty())
+            return false;
+        current_chunks = decoding_units.front().chunks.get();
+        current_chunk = 0;
+        decoding_units.front().thread.join();
+        decoding_units.pop_front();
+        decodeNextUnits();
+    }
+    chunk = std::move(current_chunks[current_chunk++]);
+    return true;
+}
+
 }
@@ -29,6 +29,10 @@
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #include <base/types.h>
+#include <Common/ProcessorMemoryTracker.h>
+#include <Common/ThreadPool.h>
+#include <deque>
+#include <future>
 
 namespace local_engine
 {
@@ -38,6 +42,8 @@ public:
     explicit FileReaderWrapper(FormatFilePtr file_) : file(file_) { }
     virtual ~FileReaderWrapper() = default;
     virtual bool pull(DB::Chunk & chunk) = 0;
+    /// Fetches ahead what the first pull needs, called on the thread opening the reader ahead of its turn.
+    virtual void prefetch() { }
 
 protected:
     FormatFilePtr file;
@@ -45,25 +51,75 @@ protected:
     static DB::ColumnPtr createConstColumn(DB::DataTypePtr type, const DB::Field & field, size_t rows);
     static DB::ColumnPtr createColumn(const String & value, DB::DataTypePtr type, size_t rows);
     static DB::Field buildFieldFromString(const String & value, DB::DataTypePtr type);
+
+    /// The constant column of a partition value of the file, parsed once and resized for each chunk.
+    DB::ColumnPtr getPartitionColumn(const String & name, const DB::DataTypePtr & type, size_t rows);
+
+private:
+    std::unordered_map<String, DB::ColumnPtr> partition_columns;
 };
 
 class NormalFileReader : public FileReaderWrapper
 {
 public:
     NormalFileReader(FormatFilePtr file_, DB::ContextPtr context_, const DB::Block & to_read_header_, const DB::Block & output_header_);
+    /// Over input_format_, made by file_ for to_read_header_.
+    NormalFileReader(
+        FormatFilePtr file_,
+        DB::ContextPtr context_,
+        const DB::Block & to_read_header_,
+        const DB::Block & output_header_,
+        FormatFile::InputFormatPtr input_format_);
     ~NormalFileReader() override = default;
     bool pull(DB::Chunk & chunk) override;
+    void prefetch() override;
 
 private:
     DB::ContextPtr context;
     DB::Block to_read_header;
     DB::Block output_header;
+    std::optional<DB::Chunk> prefetched_chunk;
 
     FormatFile::InputFormatPtr input_format;
     std::unique_ptr<DB::QueryPipeline> pipeline;
     std::unique_ptr<DB::PullingPipelineExecutor> reader;
 };
 
+/// Decodes the row groups or stripes of a file on up to max_parallelism threads at once and returns their chunks in the
+/// order of the file. Up to max_parallelism units are held decoded ahead.
+class ParallelFileReader : public FileReaderWrapper
+{
+public:
+    ParallelFileReader(
+        FormatFilePtr file_,
+        DB::ContextPtr context_,
+        const DB::Block & to_read_header_,
+        const DB::Block & output_header_,
+        size_t units_,
+        size_t max_parallelism_);
+    ~ParallelFileReader() override;
+    bool pull(DB::Chunk & chunk) override;
+
+private:
+    struct DecodingUnit
+    {
+        std::future<DB::Chunks> chunks;
+        ThreadFromGlobalPool thread;
+    };
+
+    void decodeNextUnits();
+
+    DB::ContextPtr context;
+    DB::Block to_read_header;
+    DB::Block output_header;
+    const size_t units;
+    const size_t max_parallelism;
+    size_t next_unit = 0;
+    std::deque<DecodingUnit> decoding_units;
+    DB::Chunks current_chunks;
+    size_t current_chunk = 0;
+};
+
 class EmptyFileReader : public FileReaderWrapper
 {
 public:
@@ -87,15 +143,25 @@ private:
     size_t block_size;
 };
 
-class SubstraitFileSource : public DB::ISource
+/// Bytes the reads of a source got from the local filesystem cache, and from the remote storage through it.
+struct FileCacheStats
+{
+    size_t hit_bytes = 0;
+    size_t miss_bytes = 0;
+};
+
+class SubstraitFileSource : public DB::ISource, public MemoryTrackedProcessor
 {
 public:
     SubstraitFileSource(DB::ContextPtr context_, const DB::Block & header_, const substrait::ReadRel::LocalFiles & file_infos);
-    ~SubstraitFileSource() override = default;
+    ~SubstraitFileSource() override;
 
     String getName() const override { return "SubstraitFileSource"; }
 
     void applyFilters(std::vector<SourceFilter> filters) const;
+    void setStatisticsAggregation(StatisticsAggregationPtr aggregation) const;
+    PagePruningStats getPagePruningStats() const;
+    FileCacheStats getFileCacheStats() const { return file_cache_stats; }
     std::vector<String> getPartitionKeys() const;
     DB::String getFileFormat() const;
 
@@ -120,8 +186,23 @@ private:
     UInt32 current_file_index = 0;
     std::unique_ptr<FileReaderWrapper> file_reader;
     ReadBufferBuilderPtr read_buffer_builder;
-
+    FileCacheStats file_cache_stats;
+
+    /// Readers of the next files opened in the background while the current file is read, in the order of files.
+    struct PrefetchedReader
+    {
+        std::future<std::unique_ptr<FileReaderWrapper>> reader;
+        ThreadFromGlobalPool thread;
+    };
+    std::deque<PrefetchedReader> prefetched_readers;
+    size_t max_prefetched_readers = 0;
+    size_t max_parallel_units = 1;
+    UInt32 next_prefetch_index = 0;
+
+    DB::Chunk generateImpl();
     bool tryPrepareReader();
+    std::unique_ptr<FileReaderWrapper> createFileReader(FormatFilePtr file) const;
+    void prefetchReaders();
 
     // E.g we have flatten columns correspond to header {a:int, b.x.i: int, b.x.j: string, b.y: string}
     // but we want to fold all the flatten struct columns into one struct column,
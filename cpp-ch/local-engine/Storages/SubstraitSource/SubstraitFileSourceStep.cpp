@@ -17,6 +17,9 @@
 
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
+#include <Columns/ColumnConst.h>
+#include <Columns/ColumnSet.h>
+#include <Interpreters/Set.h>
 #include <Storages/SelectQueryInfo.h>
 #include <Storages/MergeTree/KeyCondition.h>
 #include <Functions/IFunction.h>
@@ -42,6 +45,57 @@ namespace ErrorCodes
 
 namespace local_engine
 {
+void collectPointValues(const DB::ActionsDAG::Node * node, std::unordered_map<String, DB::Fields> & point_values)
+{
+    while (node->type == DB::ActionsDAG::ActionType::ALIAS)
+        node = node->children[0];
+    if (node->type != DB::ActionsDAG::ActionType::FUNCTION)
+        return;
+
+    const auto & function_name = node->function_base->getName();
+    if (function_name == "and")
+    {
+        for (const auto * child : node->children)
+            collectPointValues(child, point_values);
+        return;
+    }
+    if (node->children.size() != 2)
+        return;
+
+    const auto * input = node->children[0];
+    const auto * constant = node->children[1];
+    if (function_name == "equals" && input->type == DB::ActionsDAG::ActionType::COLUMN)
+        std::swap(input, constant);
+    if (input->type != DB::ActionsDAG::ActionType::INPUT || constant->type != DB::ActionsDAG::ActionType::COLUMN || !constant->column)
+        return;
+
+    DB::Fields values;
+    if (function_name == "equals")
+    {
+        if (!isColumnConst(*constant->column))
+            return;
+        values.emplace_back((*constant->column)[0]);
+    }
+    else if (function_name == "in")
+    {
+        const DB::IColumn * set_column = constant->column.get();
+        if (const auto * const_column = typeid_cast<const DB::ColumnConst *>(set_column))
+            set_column = &const_column->getDataColumn();
+        const auto * column_set = typeid_cast<const DB::ColumnSet *>(set_column);
+        auto set = column_set && column_set->getData() ? column_set->getData()->get() : nullptr;
+        if (!set || !set->hasExplicitSetElements() || set->getSetElements().size() != 1)
+            return;
+        const auto & elements = *set->getSetElements()[0];
+        for (size_t i = 0; i < elements.size(); ++i)
+            values.emplace_back(elements[i]);
+    }
+    else
+        return;
+
+    /// Null equals nothing.
+    std::erase_if(values, [](const DB::Field & value) { return value.isNull(); });
+    point_values.try_emplace(input->result_name, std::move(values));
+}
 
 SubstraitFileSourceStep::SubstraitFileSourceStep(DB::ContextPtr context_, DB::Pipe pipe_, const String &)
     : SourceStepWithFilter(DB::DataStream{.header = pipe_.getHeader()}), pipe(std::move(pipe_)), context(context_) 
@@ -68,6 +122,15 @@ void SubstraitFileSourceStep::initializePipeline(DB::QueryPipelineBuilder & pipe
     pipeline.init(std::move(pipe));
 }
 
+void SubstraitFileSourceStep::setStatisticsAggregation(std::shared_ptr<StatisticsAggregation> aggregation)
+{
+    for (const auto & processor : pipe.getProcessors())
+    {
+        if (const auto * source = dynamic_cast<const SubstraitFileSource *>(processor.get()))
+            source->setStatisticsAggregation(aggregation);
+    }
+}
+
 DB::NamesAndTypesList SubstraitFileSourceStep::extractParquetFileColumnPathAndTypeForComplexType(const DB::String & column_name, const DB::DataTypePtr & column_type)
 {
     DB::NamesAndTypesList path_and_type;
@@ -156,7 +219,9 @@ void SubstraitFileSourceStep::applyFilters()
         std::shared_ptr<DB::ExpressionActions> filter_expr = std::make_shared<DB::ExpressionActions>(filter_dags[0], DB::ExpressionActionsSettings::fromContext(context));
         DB::ActionsDAGPtr filter_actions_dag = DB::ActionsDAG::buildFilterActionsDAG(filter_nodes.nodes, node_name_to_input_column, context);
         DB::KeyCondition filter_condition(filter_actions_dag, context, filter_column_keys.getNames(), filter_expr, DB::NameSet{});
-        SourceFilter filter{filter_condition, filter_column_keys};
+        SourceFilter filter{filter_condition, filter_column_keys, {}, filter_actions_dag};
+        for (const auto * node : filter_nodes.nodes)
+            collectPointValues(node, filter.point_values);
         filters.push_back(filter);
     }
     DB::Processors processors = pipe.getProcessors();
@@ -20,11 +20,15 @@
 #include <Processors/QueryPlan/ReadFromPreparedSource.h>
 #include <Processors/QueryPlan/SourceStepWithFilter.h>
 #include <Storages/MergeTree/KeyCondition.h>
+#include <Interpreters/ActionsDAG.h>
 #include <Interpreters/Context_fwd.h>
 #include <Core/NamesAndTypes.h>
+#include <unordered_map>
 
 namespace local_engine
 {
+class StatisticsAggregation;
+
 class SubstraitFileSourceStep : public DB::SourceStepWithFilter
 {
 public:
@@ -36,6 +40,10 @@ public:
 
     void initializePipeline(DB::QueryPipelineBuilder &, const DB::BuildQueryPipelineSettings &) override;
 
+    bool hasFilters() const { return !filter_dags.empty(); }
+    /// The files of the step answer the aggregation over it from their statistics where they can.
+    void setStatisticsAggregation(std::shared_ptr<StatisticsAggregation> aggregation);
+
 private:
     DB::Pipe pipe;
     DB::ContextPtr context;
@@ -49,7 +57,14 @@ struct SourceFilter
 {
     DB::KeyCondition filter;
     DB::NamesAndTypesList keys;
+    /// The values a key column must be one of, by the equals and in conjuncts of the filter. Probes the bloom filters.
+    std::unordered_map<String, DB::Fields> point_values;
+    /// The filter over the columns of the source, its only output telling the rows passing.
+    DB::ActionsDAGPtr actions;
 };
 
+/// Adds the values the inputs must be one of by the equals and in conjuncts under the filter node, by input name.
+void collectPointValues(const DB::ActionsDAG::Node * node, std::unordered_map<String, DB::Fields> & point_values);
+
 }
 
@@ -354,15 +354,25 @@ static std::shared_ptr<arrow::ChunkedArray> getNestedArrowColumn(std::shared_ptr
     return std::make_shared<arrow::ChunkedArray>(array_vector);
 }
 
+static ColumnWithTypeAndName readColumnWithDictionary(
+    const std::shared_ptr<arrow::Field> & arrow_field,
+    std::shared_ptr<arrow::ChunkedArray> & arrow_column,
+    const std::string & format_name,
+    OptimizedArrowColumnToCHColumn::DictionaryValuesMap & dictionary_values,
+    bool read_ints_as_dates);
+
 static ColumnWithTypeAndName readColumnFromArrowColumn(
     const std::shared_ptr<arrow::Field> & arrow_field,
     std::shared_ptr<arrow::ChunkedArray> & arrow_column,
     const std::string & format_name,
-    std::unordered_map<String, std::shared_ptr<ColumnWithTypeAndName>> & dictionary_values,
+    OptimizedArrowColumnToCHColumn::DictionaryValuesMap & dictionary_values,
     bool read_ints_as_dates)
 {
     const auto is_nullable = arrow_field->nullable();
     const auto column_name = arrow_field->name();
+    /// LowCardinality(Nullable) but not Nullable(LowCardinality).
+    if (is_nullable && arrow_field->type()->id() == arrow::Type::DICTIONARY)
+        return readColumnWithDictionary(arrow_field, arrow_column, format_name, dictionary_values, read_ints_as_dates);
     if (is_nullable)
     {
         auto nested_column
@@ -467,46 +477,8 @@ static ColumnWithTypeAndName readColumnFromArrowColumn(
             auto tuple_type = std::make_shared<DataTypeTuple>(std::move(tuple_types), std::move(tuple_names));
             return {std::move(tuple_column), std::move(tuple_type), column_name};
         }
-        case arrow::Type::DICTIONARY: {
-            auto & dict_values = dictionary_values[column_name];
-            /// Load dictionary values only once and reuse it.
-            if (!dict_values)
-            {
-                arrow::ArrayVector dict_array;
-                for (size_t chunk_i = 0, num_chunks = static_cast<size_t>(arrow_column->num_chunks()); chunk_i < num_chunks; ++chunk_i)
-                {
-                    arrow::DictionaryArray & dict_chunk = dynamic_cast<arrow::DictionaryArray &>(*(arrow_column->chunk(chunk_i)));
-                    dict_array.emplace_back(dict_chunk.dictionary());
-                }
-
-                auto * arrow_dict_type = assert_cast<arrow::DictionaryType *>(arrow_field->type().get());
-                auto arrow_dict_field = arrow::field("dict", arrow_dict_type->value_type());
-                auto arrow_dict_column = std::make_shared<arrow::ChunkedArray>(dict_array);
-                auto dict_column
-                    = readColumnFromArrowColumn(arrow_dict_field, arrow_dict_column, format_name, dictionary_values, read_ints_as_dates);
-
-                /// We should convert read column to ColumnUnique.
-                auto tmp_lc_column = DataTypeLowCardinality(dict_column.type).createColumn();
-                auto tmp_dict_column = IColumn::mutate(assert_cast<ColumnLowCardinality *>(tmp_lc_column.get())->getDictionaryPtr());
-                static_cast<IColumnUnique *>(tmp_dict_column.get())
-                    ->uniqueInsertRangeFrom(*dict_column.column, 0, dict_column.column->size());
-                dict_column.column = std::move(tmp_dict_column);
-                dict_values = std::make_shared<ColumnWithTypeAndName>(std::move(dict_column));
-            }
-
-            arrow::ArrayVector indexes_array;
-            for (size_t chunk_i = 0, num_chunks = static_cast<size_t>(arrow_column->num_chunks()); chunk_i < num_chunks; ++chunk_i)
-            {
-                arrow::DictionaryArray & dict_chunk = dynamic_cast<arrow::DictionaryArray &>(*(arrow_column->chunk(chunk_i)));
-                indexes_array.emplace_back(dict_chunk.indices());
-            }
-
-            auto arrow_indexes_column = std::make_shared<arrow::ChunkedArray>(indexes_array);
-            auto indexes_column = readColumnWithIndexesData(arrow_indexes_column);
-            auto lc_column = ColumnLowCardinality::create(dict_values->column, indexes_column);
-            auto lc_type = std::make_shared<DataTypeLowCardinality>(dict_values->type);
-            return {std::move(lc_column), std::move(lc_type), column_name};
-        }
+        case arrow::Type::DICTIONARY:
+            return readColumnWithDictionary(arrow_field, arrow_column, format_name, dictionary_values, read_ints_as_dates);
 #        define DISPATCH(ARROW_NUMERIC_TYPE, CPP_NUMERIC_TYPE) \
             case ARROW_NUMERIC_TYPE: \
                 return readColumnWithNumericData<CPP_NUMERIC_TYPE>(arrow_column, column_name);
@@ -534,6 +506,83 @@ static void checkStatus(const arrow::Status & status, const String & column_name
         throw Exception{ErrorCodes::UNKNOWN_EXCEPTION, "Error with a {} column '{}': {}.", format_name, column_name, status.ToString()};
 }
 
+static ColumnWithTypeAndName readColumnWithDictionary(
+    const std::shared_ptr<arrow::Field> & arrow_field,
+    std::shared_ptr<arrow::ChunkedArray> & arrow_column,
+    const std::string & format_name,
+    OptimizedArrowColumnToCHColumn::DictionaryValuesMap & dictionary_values,
+    bool read_ints_as_dates)
+{
+    const auto column_name = arrow_field->name();
+    const bool is_nullable = arrow_field->nullable();
+    auto * arrow_dict_type = assert_cast<arrow::DictionaryType *>(arrow_field->type().get());
+    auto & dict_values = dictionary_values[column_name];
+
+    auto load_dictionary = [&](const std::shared_ptr<arrow::Array> & arrow_dictionary)
+    {
+        auto arrow_dict_field = arrow::field("dict", arrow_dict_type->value_type(), false);
+        auto arrow_dict_column = std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{arrow_dictionary});
+        auto dict_column
+            = readColumnFromArrowColumn(arrow_dict_field, arrow_dict_column, format_name, dictionary_values, read_ints_as_dates);
+
+        /// ColumnUnique keeps the default value, and null if nullable, ahead of the values, so the Arrow indexes are
+        /// mapped to the positions the values are inserted at.
+        auto lc_type = std::make_shared<DataTypeLowCardinality>(is_nullable ? makeNullable(dict_column.type) : dict_column.type);
+        auto lc_column = lc_type->createColumn();
+        auto unique_column = IColumn::mutate(assert_cast<ColumnLowCardinality &>(*lc_column).getDictionaryPtr());
+        auto * unique = static_cast<IColumnUnique *>(unique_column.get());
+        auto positions = unique->uniqueInsertRangeFrom(*dict_column.column, 0, dict_column.column->size());
+
+        dict_values.arrow_dictionary = arrow_dictionary;
+        dict_values.null_position = is_nullable ? unique->getNullValueIndex() : 0;
+        dict_values.positions.resize(positions->size());
+        for (size_t i = 0; i < positions->size(); ++i)
+            dict_values.positions[i] = positions->getUInt(i);
+        dict_values.dictionary = {std::move(unique_column), std::move(lc_type), column_name};
+    };
+
+    if (!arrow_column->num_chunks() && !dict_values.arrow_dictionary)
+        load_dictionary(arrow::MakeEmptyArray(arrow_dict_type->value_type()).ValueOrDie());
+
+    /// The chunks of consecutive row groups may have different dictionaries.
+    Columns parts;
+    MutableColumnPtr indexes_column;
+    auto flush = [&]()
+    {
+        if (indexes_column)
+            parts.emplace_back(ColumnLowCardinality::create(dict_values.dictionary.column, std::move(indexes_column)));
+        indexes_column = nullptr;
+    };
+    for (size_t chunk_i = 0, num_chunks = static_cast<size_t>(arrow_column->num_chunks()); chunk_i < num_chunks; ++chunk_i)
+    {
+        arrow::DictionaryArray & dict_chunk = dynamic_cast<arrow::DictionaryArray &>(*(arrow_column->chunk(chunk_i)));
+        const auto & arrow_dictionary = dict_chunk.dictionary();
+        if (!dict_values.arrow_dictionary
+            || (dict_values.arrow_dictionary != arrow_dictionary && !dict_values.arrow_dictionary->Equals(*arrow_dictionary)))
+        {
+            flush();
+            load_dictionary(arrow_dictionary);
+        }
+
+        if (!indexes_column)
+            indexes_column = ColumnUInt64::create();
+        auto & indexes = assert_cast<ColumnUInt64 &>(*indexes_column).getData();
+        indexes.reserve(indexes.size() + dict_chunk.length());
+        for (int64_t i = 0; i < dict_chunk.length(); ++i)
+            indexes.push_back(dict_chunk.IsNull(i) ? dict_values.null_position : dict_values.positions[dict_chunk.GetValueIndex(i)]);
+    }
+    if (!indexes_column && parts.empty())
+        indexes_column = ColumnUInt64::create();
+    flush();
+
+    if (parts.size() == 1)
+        return {std::move(parts.front()), dict_values.dictionary.type, column_name};
+    auto result = dict_values.dictionary.type->createColumn();
+    for (const auto & part : parts)
+        result->insertRangeFrom(*part, 0, part->size());
+    return {std::move(result), dict_values.dictionary.type, column_name};
+}
+
 Block OptimizedArrowColumnToCHColumn::arrowSchemaToCHHeader(const arrow::Schema & schema, const std::string & format_name)
 {
     ColumnsWithTypeAndName sample_columns;
@@ -551,7 +600,7 @@ Block OptimizedArrowColumnToCHColumn::arrowSchemaToCHHeader(const arrow::Schema
 
         arrow::ArrayVector array_vector = {arrow_array};
         auto arrow_column = std::make_shared<arrow::ChunkedArray>(array_vector);
-        std::unordered_map<std::string, std::shared_ptr<ColumnWithTypeAndName>> dict_values;
+        DictionaryValuesMap dict_values;
         ColumnWithTypeAndName sample_column = readColumnFromArrowColumn(field, arrow_column, format_name, dict_values, false);
         // std::cerr << "field:" << field->ToString() << ", datatype:" << sample_column.type->getName() << std::endl;
 
@@ -38,6 +38,18 @@ class OptimizedArrowColumnToCHColumn
 public:
     using NameToColumnPtr = std::unordered_map<std::string, std::shared_ptr<arrow::ChunkedArray>>;
 
+    /// The dictionary of a LowCardinality column converted from an Arrow dictionary, reused by the chunks with the same
+    /// dictionary, e.g. those of a column chunk.
+    struct DictionaryValues
+    {
+        std::shared_ptr<arrow::Array> arrow_dictionary;
+        ColumnWithTypeAndName dictionary;
+        /// Position in the dictionary of each value of the Arrow dictionary.
+        std::vector<UInt64> positions;
+        UInt64 null_position = 0;
+    };
+    using DictionaryValuesMap = std::unordered_map<std::string, DictionaryValues>;
+
     OptimizedArrowColumnToCHColumn(
         const Block & header_, const std::string & format_name_, bool import_nested_, bool allow_missing_columns_);
 
@@ -63,7 +75,7 @@ private:
     /// Map {column name : dictionary column}.
     /// To avoid converting dictionary from Arrow Dictionary
     /// to LowCardinality every chunk we save it and reuse.
-    std::unordered_map<std::string, std::shared_ptr<ColumnWithTypeAndName>> dictionary_values;
+    DictionaryValuesMap dictionary_values;
 };
 
 }
@@ -23,6 +23,7 @@
 #    include <Processors/Formats/Impl/ArrowBufferedStreams.h>
 #    include <Storages/ch_parquet/OptimizedArrowColumnToCHColumn.h>
 #    include <Storages/ch_parquet/arrow/reader.h>
+#    include <parquet/schema.h>
 
 namespace DB
 {
@@ -45,6 +46,14 @@ OptimizedParquetBlockInputFormat::OptimizedParquetBlockInputFormat(ReadBuffer &
 {
 }
 
+void OptimizedParquetBlockInputFormat::setRangeReadFile(
+    std::shared_ptr<arrow::io::RandomAccessFile> file, const arrow::io::IOContext & io_context, const arrow::io::CacheOptions & options)
+{
+    range_read_file = std::move(file);
+    range_read_io_context = io_context;
+    range_read_options = options;
+}
+
 Chunk OptimizedParquetBlockInputFormat::generate()
 {
     Chunk res;
@@ -124,12 +133,38 @@ static void getFileReaderAndSchema(
     std::unique_ptr<ch_parquet::arrow::FileReader> & file_reader,
     std::shared_ptr<arrow::Schema> & schema,
     const FormatSettings & format_settings,
-    std::atomic<int> & is_stopped)
+    std::atomic<int> & is_stopped,
+    std::shared_ptr<parquet::FileMetaData> file_metadata = nullptr,
+    const Block * header = nullptr,
+    parquet::ArrowReaderProperties arrow_properties = parquet::default_arrow_reader_properties(),
+    std::shared_ptr<arrow::io::RandomAccessFile> arrow_file = nullptr)
 {
-    auto arrow_file = asArrowFile(in, format_settings, is_stopped, "Parquet", PARQUET_MAGIC_BYTES);
+    if (!arrow_file)
+        arrow_file = asArrowFile(in, format_settings, is_stopped, "Parquet", PARQUET_MAGIC_BYTES);
     if (is_stopped)
         return;
-    THROW_ARROW_NOT_OK(ch_parquet::arrow::OpenFile(std::move(arrow_file), arrow::default_memory_pool(), &file_reader));
+    ch_parquet::arrow::FileReaderBuilder builder;
+    THROW_ARROW_NOT_OK(builder.Open(std::move(arrow_file), parquet::default_reader_properties(), std::move(file_metadata)));
+
+    /// Read the string columns wanted as LowCardinality as Arrow dictionaries, which keep the dictionary pages.
+    if (header)
+    {
+        const auto * parquet_schema = builder.raw_reader()->metadata()->schema();
+        for (int i = 0; i < parquet_schema->num_columns(); ++i)
+        {
+            const auto * column_descr = parquet_schema->Column(i);
+            if (column_descr->physical_type() != parquet::Type::BYTE_ARRAY || column_descr->path()->ToDotVector().size() != 1)
+                continue;
+            auto name = column_descr->name();
+            if (format_settings.use_lowercase_column_name)
+                boost::to_lower(name);
+            const auto * column = header->findByName(name);
+            if (column && column->type->lowCardinality())
+                arrow_properties.set_read_dictionary(i, true);
+        }
+    }
+    builder.properties(arrow_properties);
+    THROW_ARROW_NOT_OK(builder.memory_pool(arrow::default_memory_pool())->Build(&file_reader));
     THROW_ARROW_NOT_OK(file_reader->GetSchema(&schema));
 
     if (format_settings.use_lowercase_column_name)
@@ -150,7 +185,15 @@ static void getFileReaderAndSchema(
 void OptimizedParquetBlockInputFormat::prepareReader()
 {
     std::shared_ptr<arrow::Schema> schema;
-    getFileReaderAndSchema(*in, file_reader, schema, format_settings, is_stopped);
+    auto arrow_properties = parquet::default_arrow_reader_properties();
+    if (range_read_file)
+    {
+        arrow_properties.set_pre_buffer(true);
+        arrow_properties.set_io_context(range_read_io_context);
+        arrow_properties.set_cache_options(range_read_options);
+    }
+    getFileReaderAndSchema(
+        *in, file_reader, schema, format_settings, is_stopped, file_metadata, &getPort().getHeader(), arrow_properties, range_read_file);
     if (is_stopped)
         return;
 
@@ -22,6 +22,8 @@
 #    include <Formats/FormatSettings.h>
 #    include <Processors/Formats/IInputFormat.h>
 #    include <Processors/Formats/ISchemaReader.h>
+#    include <arrow/io/caching.h>
+#    include <arrow/io/interfaces.h>
 
 namespace ch_parquet::arrow
 {
@@ -33,6 +35,11 @@ namespace arrow
 class Buffer;
 }
 
+namespace parquet
+{
+class FileMetaData;
+}
+
 namespace DB
 {
 class OptimizedArrowColumnToCHColumn;
@@ -48,6 +55,11 @@ public:
 
     const BlockMissingValues & getMissingValues() const override;
 
+    /// Reads the file through file rather than in, fetching the column chunks of the row groups to read ahead by
+    /// reads concurrent over the threads of io_context, the chunks coalesced by options.
+    void setRangeReadFile(
+        std::shared_ptr<arrow::io::RandomAccessFile> file, const arrow::io::IOContext & io_context, const arrow::io::CacheOptions & options);
+
 private:
     Chunk generate() override;
 
@@ -57,6 +69,11 @@ protected:
     void onCancel() override { is_stopped = 1; }
 
     std::unique_ptr<ch_parquet::arrow::FileReader> file_reader;
+    /// Footer parsed before, if any, to open the file without reading it again.
+    std::shared_ptr<parquet::FileMetaData> file_metadata;
+    std::shared_ptr<arrow::io::RandomAccessFile> range_read_file;
+    arrow::io::IOContext range_read_io_context;
+    arrow::io::CacheOptions range_read_options = arrow::io::CacheOptions::Defaults();
     int row_group_total = 0;
     // indices of columns to read from Parquet file
     std::vector<int> column_indices;
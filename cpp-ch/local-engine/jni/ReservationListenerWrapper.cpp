@@ -15,8 +15,11 @@
  * limitations under the License.
  */
 #include "ReservationListenerWrapper.h"
+#include <algorithm>
 #include <jni/jni_common.h>
+#include <base/scope_guard.h>
 #include <Common/JNIUtils.h>
+#include <Common/Stopwatch.h>
 
 namespace local_engine
 {
@@ -24,6 +27,7 @@ jclass ReservationListenerWrapper::reservation_listener_class = nullptr;
 jmethodID ReservationListenerWrapper::reservation_listener_reserve = nullptr;
 jmethodID ReservationListenerWrapper::reservation_listener_reserve_or_throw = nullptr;
 jmethodID ReservationListenerWrapper::reservation_listener_unreserve = nullptr;
+int64_t ReservationListenerWrapper::reservation_block_size = 8 << 20;
 
 ReservationListenerWrapper::ReservationListenerWrapper(jobject listener_) : listener(listener_)
 {
@@ -38,22 +42,64 @@ ReservationListenerWrapper::~ReservationListenerWrapper()
 
 void ReservationListenerWrapper::reserve(int64_t size)
 {
-    GET_JNIENV(env)
-    safeCallVoidMethod(env, listener, reservation_listener_reserve, size);
-    CLEAN_JNIENV
+    reserveImpl(size, reservation_listener_reserve);
 }
 
 void ReservationListenerWrapper::reserveOrThrow(int64_t size)
 {
-    GET_JNIENV(env)
-    safeCallVoidMethod(env, listener, reservation_listener_reserve_or_throw, size);
-    CLEAN_JNIENV
+    reserveImpl(size, reservation_listener_reserve_or_throw);
 }
 
 void ReservationListenerWrapper::free(int64_t size)
 {
+    std::lock_guard lock(mutex);
+    usage -= size;
+    /// Keeps a block reserved ahead of the usage, so that allocations around a block boundary don't reserve and release
+    /// in turns.
+    int64_t unused = reserved - std::max<int64_t>(usage, 0);
+    int64_t to_release = reservation_block_size > 0 ? (unused / reservation_block_size - 1) * reservation_block_size : unused;
+    if (to_release > 0)
+    {
+        reserved -= to_release;
+        callListener(reservation_listener_unreserve, to_release);
+    }
+}
+
+void ReservationListenerWrapper::releaseUnused()
+{
+    std::lock_guard lock(mutex);
+    int64_t unused = reserved - std::max<int64_t>(usage, 0);
+    if (unused > 0)
+    {
+        reserved -= unused;
+        callListener(reservation_listener_unreserve, unused);
+    }
+}
+
+void ReservationListenerWrapper::reserveImpl(int64_t size, jmethodID method)
+{
+    std::lock_guard lock(mutex);
+    if (usage + size > reserved)
+    {
+        int64_t to_reserve = usage + size - reserved;
+        if (reservation_block_size > 0)
+            to_reserve = (to_reserve + reservation_block_size - 1) / reservation_block_size * reservation_block_size;
+        /// Counted once granted, reserveOrThrow throws otherwise.
+        callListener(method, to_reserve);
+        reserved += to_reserve;
+    }
+    usage += size;
+}
+
+void ReservationListenerWrapper::callListener(jmethodID method, int64_t size)
+{
+    Stopwatch watch;
+    SCOPE_EXIT({
+        jni_calls.fetch_add(1, std::memory_order_relaxed);
+        jni_time_ns.fetch_add(watch.elapsedNanoseconds(), std::memory_order_relaxed);
+    });
     GET_JNIENV(env)
-    safeCallVoidMethod(env, listener, reservation_listener_unreserve, size);
+    safeCallVoidMethod(env, listener, method, size);
     CLEAN_JNIENV
 }
 }
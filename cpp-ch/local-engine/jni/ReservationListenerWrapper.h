@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 #pragma once
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <jni.h>
 #include <stdint.h>
 
@@ -29,14 +31,33 @@ public:
     static jmethodID reservation_listener_reserve_or_throw;
     static jmethodID reservation_listener_unreserve;
 
+    /// Bytes reserved from Spark at once, 0 to reserve and release the bytes of each call.
+    static int64_t reservation_block_size;
+
     explicit ReservationListenerWrapper(jobject listener);
     ~ReservationListenerWrapper();
     void reserve(int64_t size);
     void reserveOrThrow(int64_t size);
     void free(int64_t size);
+    /// Releases the bytes reserved ahead of the usage.
+    void releaseUnused();
+
+    /// Of the calls into the listener.
+    size_t getJniCalls() const { return jni_calls.load(std::memory_order_relaxed); }
+    size_t getJniTimeNs() const { return jni_time_ns.load(std::memory_order_relaxed); }
 
 private:
     jobject listener;
+    /// Recursive as Spark may spill the native memory of the task within a reservation.
+    std::recursive_mutex mutex;
+    /// Bytes allocated natively, and reserved from Spark in blocks for them.
+    int64_t usage = 0;
+    int64_t reserved = 0;
+    std::atomic<size_t> jni_calls = 0;
+    std::atomic<size_t> jni_time_ns = 0;
+
+    void reserveImpl(int64_t size, jmethodID method);
+    void callListener(jmethodID method, int64_t size);
 };
 using ReservationListenerWrapperPtr = std::shared_ptr<ReservationListenerWrapper>;
 }
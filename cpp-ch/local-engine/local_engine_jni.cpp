@@ -21,6 +21,7 @@
 #include <Builder/BroadCastJoinBuilder.h>
 #include <Builder/SerializedPlanBuilder.h>
 #include <DataTypes/DataTypeNullable.h>
+#include <IO/ReadBufferFromMemory.h>
 #include <Operator/BlockCoalesceOperator.h>
 #include <Parser/CHColumnToSparkRow.h>
 #include <Parser/RelParser.h>
@@ -31,6 +32,7 @@
 #include <Shuffle/ShuffleReader.h>
 #include <Shuffle/ShuffleSplitter.h>
 #include <Shuffle/ShuffleWriter.h>
+#include <Storages/BlockRingBuffer.h>
 #include <Storages/Output/BlockStripeSplitter.h>
 #include <Storages/Output/FileWriterWrappers.h>
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
@@ -43,6 +45,7 @@
 #include <Common/CHUtil.h>
 #include <Common/CurrentThread.h>
 #include <Common/ExceptionUtils.h>
+#include <Common/FragmentResultCache.h>
 #include <Common/JNIUtils.h>
 #include <Common/QueryContext.h>
 
@@ -128,13 +131,15 @@ JNIEXPORT jint JNI_OnLoad(JavaVM * vm, void * /*reserved*/)
     local_engine::NativeSplitter::iterator_class
         = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/vectorized/IteratorWrapper;");
     local_engine::WriteBufferFromJavaOutputStream::output_stream_class
-        = local_engine::CreateGlobalClassReference(env, "Ljava/io/OutputStream;");
+        = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/vectorized/NativeBufferOutputStream;");
     local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class
         = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/execution/ColumnarNativeIterator;");
     local_engine::SourceFromJavaIter::serialized_record_batch_iterator_hasNext
         = local_engine::GetMethodID(env, local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class, "hasNext", "()Z");
     local_engine::SourceFromJavaIter::serialized_record_batch_iterator_next
         = local_engine::GetMethodID(env, local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class, "next", "()[B");
+    local_engine::SourceFromJavaIter::serialized_record_batch_iterator_ringBuffer
+        = local_engine::GetMethodID(env, local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class, "ringBuffer", "()J");
 
     local_engine::ShuffleReader::input_stream_read = env->GetMethodID(local_engine::ShuffleReader::input_stream_class, "read", "(JJ)J");
 
@@ -144,7 +149,7 @@ JNIEXPORT jint JNI_OnLoad(JavaVM * vm, void * /*reserved*/)
         = local_engine::GetMethodID(env, local_engine::NativeSplitter::iterator_class, "next", "()J");
 
     local_engine::WriteBufferFromJavaOutputStream::output_stream_write
-        = local_engine::GetMethodID(env, local_engine::WriteBufferFromJavaOutputStream::output_stream_class, "write", "([BII)V");
+        = local_engine::GetMethodID(env, local_engine::WriteBufferFromJavaOutputStream::output_stream_class, "write", "(JI)V");
     local_engine::WriteBufferFromJavaOutputStream::output_stream_flush
         = local_engine::GetMethodID(env, local_engine::WriteBufferFromJavaOutputStream::output_stream_class, "flush", "()V");
 
@@ -168,7 +173,7 @@ JNIEXPORT jint JNI_OnLoad(JavaVM * vm, void * /*reserved*/)
         = local_engine::GetMethodID(env, local_engine::ReservationListenerWrapper::reservation_listener_class, "unreserve", "(J)J");
 
     native_metrics_class = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/metrics/NativeMetrics;");
-    native_metrics_constructor = local_engine::GetMethodID(env, native_metrics_class, "<init>", "(Ljava/lang/String;)V");
+    native_metrics_constructor = local_engine::GetMethodID(env, native_metrics_class, "<init>", "(Ljava/lang/String;JJ[Ljava/lang/String;[J)V");
 
     local_engine::BroadCastJoinBuilder::init(env);
 
@@ -245,6 +250,15 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_ExpressionEvaluatorJniWrapper_n
     local_engine::LocalExecutor * executor = new local_engine::LocalExecutor(parser.query_context, query_context, materialize);
     executor->setMetric(parser.getMetric());
     executor->setExtraPlanHolder(parser.extra_plan_holder);
+    executor->setReservationListener(local_engine::getAllocator(allocator_id)->listener);
+    /// A fragment over files only, no input from Java, has the same output while the plan and the files are the same,
+    /// unless it calls nondeterministic functions.
+    auto * result_cache = local_engine::FragmentResultCache::instance(query_context);
+    if (result_cache && iter_num == 0 && parser.reads_only_files && !parser.has_nondeterministic_functions)
+    {
+        if (auto key = local_engine::FragmentResultCache::getKey(plan_string, plan_str, parser.read_files))
+            executor->setResultCache(*result_cache, *key);
+    }
     executor->execute(std::move(query_plan));
     env->ReleaseByteArrayElements(plan, plan_address, JNI_ABORT);
     return reinterpret_cast<jlong>(executor);
@@ -322,7 +336,36 @@ JNIEXPORT jobject Java_io_glutenproject_vectorized_BatchIterator_nativeFetchMetr
     local_engine::LocalExecutor * executor = reinterpret_cast<local_engine::LocalExecutor *>(executor_address);
     String metrics_json = local_engine::RelMetricSerializer::serializeRelMetric(executor->getMetric());
     LOG_DEBUG(&Poco::Logger::get("jni"), "{}", metrics_json);
-    jobject native_metrics = env->NewObject(native_metrics_class, native_metrics_constructor, stringTojstring(env, metrics_json.c_str()));
+    const auto & listener = executor->getReservationListener();
+    jlong reservation_calls = listener ? listener->getJniCalls() : 0;
+    jlong reservation_time_ns = listener ? listener->getJniTimeNs() : 0;
+    const auto & pull_latency = executor->getPullLatency();
+    const std::vector<std::pair<String, UInt64>> task_values
+        = {{"pullLatencyCount", pull_latency.count()},
+           {"pullLatencyP50Nanos", pull_latency.percentile(50)},
+           {"pullLatencyP90Nanos", pull_latency.percentile(90)},
+           {"pullLatencyP99Nanos", pull_latency.percentile(99)},
+           {"pullLatencyMaxNanos", pull_latency.max()}};
+    jclass string_class = env->FindClass("java/lang/String");
+    jobjectArray task_value_names = env->NewObjectArray(task_values.size(), string_class, nullptr);
+    env->DeleteLocalRef(string_class);
+    jlongArray task_value_array = env->NewLongArray(task_values.size());
+    for (size_t i = 0; i < task_values.size(); ++i)
+    {
+        jstring name = stringTojstring(env, task_values[i].first.c_str());
+        env->SetObjectArrayElement(task_value_names, i, name);
+        env->DeleteLocalRef(name);
+        jlong value = task_values[i].second;
+        env->SetLongArrayRegion(task_value_array, i, 1, &value);
+    }
+    jobject native_metrics = env->NewObject(
+        native_metrics_class,
+        native_metrics_constructor,
+        stringTojstring(env, metrics_json.c_str()),
+        reservation_calls,
+        reservation_time_ns,
+        task_value_names,
+        task_value_array);
     return native_metrics;
     LOCAL_ENGINE_JNI_METHOD_END(env, nullptr)
 }
@@ -378,6 +421,43 @@ Java_io_glutenproject_vectorized_CHColumnVector_nativeNumNulls(JNIEnv * env, job
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
 
+JNIEXPORT jboolean Java_io_glutenproject_vectorized_CHColumnVector_nativeGetBuffers(
+    JNIEnv * env, jobject obj, jlong block_address, jint column_position, jlongArray buffers)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    auto col = getColumnFromColumnVector(env, obj, block_address, column_position);
+    // |data address|data bytes|null map address|offsets address|value width|, read by the JVM with Unsafe while the
+    // block lives.
+    jlong result[5] = {0, 0, 0, 0, 0};
+    const DB::IColumn * nested_col = col.column.get();
+    if (const auto * nullable_col = checkAndGetColumn<DB::ColumnNullable>(nested_col))
+    {
+        result[2] = reinterpret_cast<jlong>(nullable_col->getNullMapData().data());
+        nested_col = &nullable_col->getNestedColumn();
+    }
+    if (const auto * string_col = checkAndGetColumn<DB::ColumnString>(nested_col))
+    {
+        result[0] = reinterpret_cast<jlong>(string_col->getChars().data());
+        result[1] = string_col->getChars().size();
+        result[3] = reinterpret_cast<jlong>(string_col->getOffsets().data());
+    }
+    else if (nested_col->isNumeric() && nested_col->isFixedAndContiguous())
+    {
+        auto data = nested_col->getRawData();
+        result[0] = reinterpret_cast<jlong>(data.data());
+        result[1] = data.size();
+        result[4] = nested_col->sizeOfValueIfFixed();
+    }
+    else
+    {
+        // Constant, low cardinality, decimal and nested columns are read value by value.
+        return false;
+    }
+    env->SetLongArrayRegion(buffers, 0, 5, result);
+    return true;
+    LOCAL_ENGINE_JNI_METHOD_END(env, false)
+}
+
 JNIEXPORT jboolean Java_io_glutenproject_vectorized_CHColumnVector_nativeIsNullAt(
     JNIEnv * env, jobject obj, jint row_id, jlong block_address, jint column_position)
 {
@@ -508,6 +588,47 @@ JNIEXPORT jstring Java_io_glutenproject_vectorized_CHColumnVector_nativeGetStrin
     LOCAL_ENGINE_JNI_METHOD_END(env, local_engine::charTojstring(env, ""))
 }
 
+// ring buffer of the input blocks of ColumnarNativeIterator
+JNIEXPORT jlong Java_io_glutenproject_execution_ColumnarNativeIterator_nativeCreateRingBuffer(JNIEnv * env, jclass, jint capacity)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    auto * ring_buffer = local_engine::make_wrapper(std::make_shared<local_engine::BlockRingBuffer>(capacity));
+    return ring_buffer->instance();
+    LOCAL_ENGINE_JNI_METHOD_END(env, 0)
+}
+
+JNIEXPORT jboolean
+Java_io_glutenproject_execution_ColumnarNativeIterator_nativePush(JNIEnv * env, jclass, jlong ring_buffer, jlong block_address)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    /// The columns are moved out of the block, which the Java side may close right after
+    auto * block = reinterpret_cast<DB::Block *>(block_address);
+    return local_engine::SharedPointerWrapper<local_engine::BlockRingBuffer>::sharedPtr(ring_buffer)->push(std::move(*block));
+    LOCAL_ENGINE_JNI_METHOD_END(env, false)
+}
+
+JNIEXPORT void Java_io_glutenproject_execution_ColumnarNativeIterator_nativeFinish(JNIEnv * env, jclass, jlong ring_buffer, jstring error)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    String error_message = error ? jstring2string(env, error) : "";
+    local_engine::SharedPointerWrapper<local_engine::BlockRingBuffer>::sharedPtr(ring_buffer)->finish(error_message);
+    LOCAL_ENGINE_JNI_METHOD_END(env, )
+}
+
+JNIEXPORT void Java_io_glutenproject_execution_ColumnarNativeIterator_nativeCancel(JNIEnv * env, jclass, jlong ring_buffer)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    local_engine::SharedPointerWrapper<local_engine::BlockRingBuffer>::sharedPtr(ring_buffer)->cancel();
+    LOCAL_ENGINE_JNI_METHOD_END(env, )
+}
+
+JNIEXPORT void Java_io_glutenproject_execution_ColumnarNativeIterator_nativeReleaseRingBuffer(JNIEnv * env, jclass, jlong ring_buffer)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    local_engine::SharedPointerWrapper<local_engine::BlockRingBuffer>::dispose(ring_buffer);
+    LOCAL_ENGINE_JNI_METHOD_END(env, )
+}
+
 // native block
 JNIEXPORT void Java_io_glutenproject_vectorized_CHNativeBlock_nativeClose(JNIEnv * /*env*/, jobject /*obj*/, jlong /*block_address*/)
 {
@@ -560,6 +681,17 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHStreamReader_createNativeShuf
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
 
+JNIEXPORT jlong Java_io_glutenproject_vectorized_CHStreamReader_createNativeShuffleReaderFromMemory(
+    JNIEnv * env, jclass /*clazz*/, jlong address, jlong size, jboolean compressed)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    // The compressed chunks are decompressed straight from the memory, which the Java stream keeps alive.
+    auto read_buffer = std::make_unique<DB::ReadBufferFromMemory>(reinterpret_cast<const char *>(address), size);
+    auto * shuffle_reader = new local_engine::ShuffleReader(std::move(read_buffer), compressed);
+    return reinterpret_cast<jlong>(shuffle_reader);
+    LOCAL_ENGINE_JNI_METHOD_END(env, -1)
+}
+
 JNIEXPORT jlong Java_io_glutenproject_vectorized_CHStreamReader_nativeNext(JNIEnv * env, jobject /*obj*/, jlong shuffle_reader)
 {
     LOCAL_ENGINE_JNI_METHOD_START
@@ -637,7 +769,8 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_nat
     jstring codec,
     jstring data_file,
     jstring local_dirs,
-    jint num_sub_dirs)
+    jint num_sub_dirs,
+    jboolean prefer_spill)
 {
     LOCAL_ENGINE_JNI_METHOD_START
     std::string hash_exprs;
@@ -677,21 +810,31 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_nat
         .partition_nums = static_cast<size_t>(num_partitions),
         .hash_exprs = hash_exprs,
         .out_exprs = out_exprs,
-        .compress_method = jstring2string(env, codec)};
+        .compress_method = jstring2string(env, codec),
+        .prefer_spill = static_cast<bool>(prefer_spill)};
     local_engine::SplitterHolder * splitter
         = new local_engine::SplitterHolder{.splitter = local_engine::ShuffleSplitter::create(jstring2string(env, short_name), options)};
     return reinterpret_cast<jlong>(splitter);
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
 
-JNIEXPORT void
+JNIEXPORT jlong
 Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_split(JNIEnv * env, jobject, jlong splitterId, jint, jlong block)
 {
     LOCAL_ENGINE_JNI_METHOD_START
     local_engine::SplitterHolder * splitter = reinterpret_cast<local_engine::SplitterHolder *>(splitterId);
     DB::Block * data = reinterpret_cast<DB::Block *>(block);
     splitter->splitter->split(*data);
-    LOCAL_ENGINE_JNI_METHOD_END(env, )
+    return splitter->splitter->bufferedBytes();
+    LOCAL_ENGINE_JNI_METHOD_END(env, -1)
+}
+
+JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_evict(JNIEnv * env, jobject, jlong splitterId, jlong size)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    local_engine::SplitterHolder * splitter = reinterpret_cast<local_engine::SplitterHolder *>(splitterId);
+    return splitter->splitter->evictFixedSize(size);
+    LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
 
 JNIEXPORT jobject Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_stop(JNIEnv * env, jobject, jlong splitterId)
@@ -738,7 +881,9 @@ JNIEXPORT jobject
 Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_convertColumnarToRow(JNIEnv * env, jclass, jlong block_address, jintArray masks)
 {
     LOCAL_ENGINE_JNI_METHOD_START
-    local_engine::CHColumnToSparkRow converter;
+    const auto & config = local_engine::SerializedPlanParser::global_context->getConfigRef();
+    local_engine::CHColumnToSparkRow converter(
+        config.getUInt64("columnar_to_row_threads", 0), config.getUInt64("columnar_to_row_parallel_threshold", 16384));
 
     std::unique_ptr<local_engine::SparkRowInfo> spark_row_info = nullptr;
     local_engine::MaskVector mask = nullptr;
@@ -896,13 +1041,24 @@ Java_org_apache_spark_sql_execution_datasources_CHDatasourceJniWrapper_write(JNI
     LOCAL_ENGINE_JNI_METHOD_END(env, )
 }
 
-JNIEXPORT void Java_org_apache_spark_sql_execution_datasources_CHDatasourceJniWrapper_close(JNIEnv * env, jobject, jlong instanceId)
+JNIEXPORT jlong
+Java_org_apache_spark_sql_execution_datasources_CHDatasourceJniWrapper_writtenBytes(JNIEnv * env, jobject, jlong instanceId)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    auto * writer = reinterpret_cast<local_engine::NormalFileWriter *>(instanceId);
+    return writer->writtenBytes();
+    LOCAL_ENGINE_JNI_METHOD_END(env, 0)
+}
+
+JNIEXPORT jstring Java_org_apache_spark_sql_execution_datasources_CHDatasourceJniWrapper_close(JNIEnv * env, jobject, jlong instanceId)
 {
     LOCAL_ENGINE_JNI_METHOD_START
     auto * writer = reinterpret_cast<local_engine::NormalFileWriter *>(instanceId);
     writer->close();
+    auto file_stats = writer->fileStats();
     delete writer;
-    LOCAL_ENGINE_JNI_METHOD_END(env, )
+    return stringTojstring(env, file_stats.c_str());
+    LOCAL_ENGINE_JNI_METHOD_END(env, nullptr)
 }
 
 JNIEXPORT jobject Java_org_apache_spark_sql_execution_datasources_CHDatasourceJniWrapper_splitBlockByPartitionAndBucket(
@@ -968,6 +1124,13 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_StorageJoinBuilder_nativeCloneB
     LOCAL_ENGINE_JNI_METHOD_END(env, 0)
 }
 
+JNIEXPORT jlong Java_io_glutenproject_vectorized_StorageJoinBuilder_nativeHashTableBytes(JNIEnv * env, jclass, jlong instance)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    return local_engine::SharedPointerWrapper<local_engine::StorageJoinFromReadBuffer>::sharedPtr(instance)->getTotalByteCount();
+    LOCAL_ENGINE_JNI_METHOD_END(env, 0)
+}
+
 JNIEXPORT void
 Java_io_glutenproject_vectorized_StorageJoinBuilder_nativeCleanBuildHashTable(JNIEnv * env, jclass, jstring hash_table_id_, jlong instance)
 {
@@ -1007,36 +1170,32 @@ JNIEXPORT void Java_io_glutenproject_vectorized_BlockSplitIterator_nativeClose(J
     LOCAL_ENGINE_JNI_METHOD_END(env, )
 }
 
-JNIEXPORT jboolean Java_io_glutenproject_vectorized_BlockSplitIterator_nativeHasNext(JNIEnv * env, jobject, jlong instance)
+JNIEXPORT jint Java_io_glutenproject_vectorized_BlockSplitIterator_nativeNextBatch(
+    JNIEnv * env, jobject, jlong instance, jlongArray blocks, jintArray partition_ids)
 {
     LOCAL_ENGINE_JNI_METHOD_START
     local_engine::NativeSplitter::Holder * splitter = reinterpret_cast<local_engine::NativeSplitter::Holder *>(instance);
-    return splitter->splitter->hasNext();
-    LOCAL_ENGINE_JNI_METHOD_END(env, false)
-}
-
-JNIEXPORT jlong Java_io_glutenproject_vectorized_BlockSplitIterator_nativeNext(JNIEnv * env, jobject, jlong instance)
-{
-    LOCAL_ENGINE_JNI_METHOD_START
-    local_engine::NativeSplitter::Holder * splitter = reinterpret_cast<local_engine::NativeSplitter::Holder *>(instance);
-    return reinterpret_cast<jlong>(splitter->splitter->next());
-    LOCAL_ENGINE_JNI_METHOD_END(env, false)
-}
-
-JNIEXPORT jint Java_io_glutenproject_vectorized_BlockSplitIterator_nativeNextPartitionId(JNIEnv * env, jobject, jlong instance)
-{
-    LOCAL_ENGINE_JNI_METHOD_START
-    local_engine::NativeSplitter::Holder * splitter = reinterpret_cast<local_engine::NativeSplitter::Holder *>(instance);
-    return reinterpret_cast<jint>(splitter->splitter->nextPartitionId());
+    const auto & batch = splitter->splitter->nextBatch();
+    std::vector<jlong> block_addresses;
+    std::vector<jint> block_partition_ids;
+    block_addresses.reserve(batch.size());
+    block_partition_ids.reserve(batch.size());
+    for (const auto & [partition_id, block] : batch)
+    {
+        block_addresses.push_back(reinterpret_cast<jlong>(block.get()));
+        block_partition_ids.push_back(partition_id);
+    }
+    env->SetLongArrayRegion(blocks, 0, block_addresses.size(), block_addresses.data());
+    env->SetIntArrayRegion(partition_ids, 0, block_partition_ids.size(), block_partition_ids.data());
+    return static_cast<jint>(batch.size());
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
 
 JNIEXPORT jlong Java_io_glutenproject_vectorized_BlockOutputStream_nativeCreate(
-    JNIEnv * env, jobject, jobject output_stream, jbyteArray buffer, jstring codec, jboolean compressed, jint customize_buffer_size)
+    JNIEnv * env, jobject, jobject output_stream, jstring codec, jboolean compressed)
 {
     LOCAL_ENGINE_JNI_METHOD_START
-    local_engine::ShuffleWriter * writer
-        = new local_engine::ShuffleWriter(output_stream, buffer, jstring2string(env, codec), compressed, customize_buffer_size);
+    local_engine::ShuffleWriter * writer = new local_engine::ShuffleWriter(output_stream, jstring2string(env, codec), compressed);
     return reinterpret_cast<jlong>(writer);
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
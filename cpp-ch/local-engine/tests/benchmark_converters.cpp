@@ -0,0 +1,314 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <filesystem>
+#include <optional>
+#include <DataTypes/DataTypeFactory.h>
+#include <Formats/FormatSettings.h>
+#include <IO/ReadBufferFromFile.h>
+#include <Parser/CHColumnToSparkRow.h>
+#include <Parser/SparkRowToCHColumn.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
+#include <Processors/Formats/Impl/ParquetBlockInputFormat.h>
+#include <QueryPipeline/QueryPipeline.h>
+#include <Shuffle/ShuffleReader.h>
+#include <Shuffle/ShuffleSplitter.h>
+#include <base/scope_guard.h>
+#include <benchmark/benchmark.h>
+#include <Common/CHUtil.h>
+#include <Common/Exception.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+    extern const int FILE_DOESNT_EXIST;
+}
+}
+
+/// Columnar to row, row to columnar and shuffle benchmark over the synthetic schemas of the velox converter_benchmark,
+/// to compare the backends on identical data. converter_benchmark generates the schemas into
+/// --data_dir/<schema>.parquet, run it first. Both report the same benchmark names and counters, merge their
+/// --benchmark_out_format=json results with dev/compare_converter_benchmarks.py.
+///
+///   benchmark_converters [--data_dir=/tmp/gluten_converter_benchmark] [--batch_rows=4096] [--partitions=200]
+///       [--iterations=0] [google benchmark flags]
+
+namespace local_engine
+{
+namespace
+{
+    struct ConverterOptions
+    {
+        String data_dir = "/tmp/gluten_converter_benchmark";
+        size_t batch_rows = 4096;
+        size_t partitions = 200;
+        int iterations = 0;
+    };
+
+    ConverterOptions options;
+
+    struct SyntheticSchema
+    {
+        String name;
+        DB::Block header;
+    };
+
+    DB::Block makeHeader(const std::vector<std::pair<String, String>> & name_types)
+    {
+        auto & factory = DB::DataTypeFactory::instance();
+        DB::ColumnsWithTypeAndName columns;
+        for (const auto & [name, type] : name_types)
+            columns.emplace_back(factory.get(type), name);
+        return DB::Block(std::move(columns));
+    }
+
+    /// Keep in sync with the schemas of cpp/velox/benchmarks/ConverterBenchmark.cc.
+    const std::vector<SyntheticSchema> & syntheticSchemas()
+    {
+        static const std::vector<SyntheticSchema> schemas = []
+        {
+            std::vector<std::pair<String, String>> strings;
+            for (size_t i = 0; i < 16; ++i)
+                strings.emplace_back("c_string" + std::to_string(i), "Nullable(String)");
+            return std::vector<SyntheticSchema>{
+                {"narrow_numeric",
+                 makeHeader(
+                     {{"c_bigint", "Nullable(Int64)"},
+                      {"c_int", "Nullable(Int32)"},
+                      {"c_double", "Nullable(Float64)"},
+                      {"c_date", "Nullable(Date32)"}})},
+                {"wide_strings", makeHeader(strings)},
+                {"nested",
+                 makeHeader(
+                     {{"c_bigint", "Nullable(Int64)"}, {"c_array", "Array(Nullable(Int64))"}, {"c_map", "Map(String, Nullable(Int64))"}})},
+                {"decimals",
+                 makeHeader({{"c_short_decimal", "Nullable(Decimal(12, 2))"}, {"c_long_decimal", "Nullable(Decimal(38, 10))"}})}};
+        }();
+        return schemas;
+    }
+
+    String dataFile(const SyntheticSchema & schema)
+    {
+        return options.data_dir + "/" + schema.name + ".parquet";
+    }
+
+    /// The blocks of the schema's data file, read once.
+    const DB::Blocks & inputBlocks(const SyntheticSchema & schema)
+    {
+        static std::unordered_map<String, DB::Blocks> cache;
+        auto & blocks = cache[schema.name];
+        if (!blocks.empty())
+            return blocks;
+        if (!std::filesystem::exists(dataFile(schema)))
+            throw DB::Exception(
+                DB::ErrorCodes::FILE_DOESNT_EXIST, "{} doesn't exist, generate it with the velox converter_benchmark", dataFile(schema));
+        auto in = std::make_unique<DB::ReadBufferFromFile>(dataFile(schema));
+        DB::FormatSettings format_settings;
+        auto format = std::make_shared<DB::ParquetBlockInputFormat>(*in, schema.header, format_settings, 1, options.batch_rows);
+        DB::QueryPipeline pipeline(std::move(format));
+        DB::PullingPipelineExecutor reader(pipeline);
+        DB::Block block;
+        while (reader.pull(block))
+            if (block.rows())
+                blocks.push_back(std::move(block));
+        return blocks;
+    }
+
+    size_t numInputRows(const SyntheticSchema & schema)
+    {
+        size_t rows = 0;
+        for (const auto & block : inputBlocks(schema))
+            rows += block.rows();
+        return rows;
+    }
+
+    void setCounters(benchmark::State & state, size_t rows, size_t bytes)
+    {
+        state.counters["rows_per_second"] = benchmark::Counter(static_cast<double>(rows), benchmark::Counter::kIsRate);
+        state.counters["bytes_per_row"] = benchmark::Counter(static_cast<double>(bytes) / std::max<size_t>(rows, 1));
+    }
+
+    void columnarToRow(benchmark::State & state, const SyntheticSchema & schema)
+    {
+        const auto & blocks = inputBlocks(schema);
+        CHColumnToSparkRow converter;
+        size_t rows = 0;
+        size_t bytes = 0;
+        for (auto _ : state)
+        {
+            for (const auto & block : blocks)
+            {
+                auto spark_row_info = converter.convertCHColumnToSparkRow(block);
+                rows += block.rows();
+                bytes += spark_row_info->getTotalBytes();
+                converter.freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+            }
+        }
+        setCounters(state, rows, bytes);
+    }
+
+    void rowToColumnar(benchmark::State & state, const SyntheticSchema & schema)
+    {
+        CHColumnToSparkRow converter;
+        std::vector<std::unique_ptr<SparkRowInfo>> row_infos;
+        for (const auto & block : inputBlocks(schema))
+            row_infos.push_back(converter.convertCHColumnToSparkRow(block));
+        SCOPE_EXIT({
+            for (const auto & row_info : row_infos)
+                converter.freeMem(row_info->getBufferAddress(), row_info->getTotalBytes());
+        });
+
+        size_t rows = 0;
+        size_t bytes = 0;
+        for (auto _ : state)
+        {
+            for (const auto & row_info : row_infos)
+            {
+                auto block = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*row_info, schema.header);
+                benchmark::DoNotOptimize(block);
+                rows += row_info->getNumRows();
+                bytes += row_info->getTotalBytes();
+            }
+        }
+        setCounters(state, rows, bytes);
+    }
+
+    /// Round robin into options.partitions partitions, buffered until stop() and compressed with LZ4 as the velox
+    /// benchmark does.
+    SplitResult writeShuffle(const SyntheticSchema & schema, const String & data_file)
+    {
+        SplitOptions split_options{
+            .split_size = options.batch_rows,
+            .io_buffer_size = DBMS_DEFAULT_BUFFER_SIZE,
+            .data_file = data_file,
+            .local_dirs_list = {options.data_dir},
+            .num_sub_dirs = 1,
+            .map_id = 0,
+            .partition_nums = options.partitions,
+            .compress_method = "LZ4",
+            .prefer_spill = false};
+        auto splitter = ShuffleSplitter::create("rr", split_options);
+        for (const auto & block : inputBlocks(schema))
+        {
+            auto copy = block;
+            splitter->split(copy);
+        }
+        return splitter->stop();
+    }
+
+    String shuffleFile(const SyntheticSchema & schema)
+    {
+        return options.data_dir + "/" + schema.name + ".shuffle";
+    }
+
+    void shuffleWrite(benchmark::State & state, const SyntheticSchema & schema)
+    {
+        size_t rows = 0;
+        size_t bytes = 0;
+        for (auto _ : state)
+        {
+            auto result = writeShuffle(schema, shuffleFile(schema));
+            rows += numInputRows(schema);
+            bytes += result.total_bytes_written;
+            state.PauseTiming();
+            std::filesystem::remove(shuffleFile(schema));
+            state.ResumeTiming();
+        }
+        setCounters(state, rows, bytes);
+    }
+
+    /// Reads back a shuffle written once. The partitions are read as one stream, the reader stops at the end of the
+    /// file.
+    void shuffleRead(benchmark::State & state, const SyntheticSchema & schema)
+    {
+        auto result = writeShuffle(schema, shuffleFile(schema));
+        SCOPE_EXIT({ std::filesystem::remove(shuffleFile(schema)); });
+
+        size_t rows = 0;
+        size_t bytes = 0;
+        for (auto _ : state)
+        {
+            ShuffleReader reader(std::make_unique<DB::ReadBufferFromFile>(shuffleFile(schema)), true);
+            for (auto * block = reader.read(); block->columns(); block = reader.read())
+                rows += block->rows();
+            bytes += result.total_bytes_written;
+        }
+        setCounters(state, rows, bytes);
+    }
+
+    void parseOptions(int argc, char ** argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg(argv[i]);
+            auto value = [&](std::string_view key) -> std::optional<String>
+            {
+                if (arg.starts_with(key) && arg.size() > key.size() && arg[key.size()] == '=')
+                    return String(arg.substr(key.size() + 1));
+                return {};
+            };
+            if (auto data_dir = value("--data_dir"))
+                options.data_dir = *data_dir;
+            else if (auto batch_rows = value("--batch_rows"))
+                options.batch_rows = std::stoul(*batch_rows);
+            else if (auto partitions = value("--partitions"))
+                options.partitions = std::stoul(*partitions);
+            else if (auto iterations = value("--iterations"))
+                options.iterations = std::stoi(*iterations);
+            else
+                throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Unknown argument {}", arg);
+        }
+    }
+
+    void registerConverterBenchmarks()
+    {
+        using Benchmark = void (*)(benchmark::State &, const SyntheticSchema &);
+        const std::vector<std::pair<String, Benchmark>> benchmarks
+            = {{"columnar_to_row", columnarToRow},
+               {"row_to_columnar", rowToColumnar},
+               {"shuffle_write", shuffleWrite},
+               {"shuffle_read", shuffleRead}};
+        for (const auto & schema : syntheticSchemas())
+        {
+            for (const auto & [name, fn] : benchmarks)
+            {
+                auto * bm = benchmark::RegisterBenchmark((schema.name + "/" + name).c_str(), fn, schema)
+                                ->MeasureProcessCPUTime()
+                                ->UseRealTime()
+                                ->Unit(benchmark::kMillisecond);
+                if (options.iterations > 0)
+                    bm->Iterations(options.iterations);
+            }
+        }
+    }
+}
+}
+
+int main(int argc, char ** argv)
+{
+    ::benchmark::Initialize(&argc, argv);
+    local_engine::parseOptions(argc, argv);
+
+    local_engine::BackendInitializerUtil::init(nullptr);
+    SCOPE_EXIT({ local_engine::BackendFinalizerUtil::finalizeGlobally(); });
+
+    local_engine::registerConverterBenchmarks();
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <Interpreters/Context.h>
+#include <Parser/RelMetric.h>
+#include <Parser/SerializedPlanParser.h>
+#include <base/scope_guard.h>
+#include <benchmark/benchmark.h>
+#include <Common/CHUtil.h>
+#include <Common/Exception.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+    extern const int CANNOT_OPEN_FILE;
+}
+}
+
+/// Runs the substrait json plans of a directory through SerializedPlanParser and LocalExecutor, as the velox
+/// GenericBenchmark does, so that the backends can be compared on the same plans. The plans read their input from
+/// local files, ${DATA_DIR} in a plan is replaced by --data_dir.
+///
+///   benchmark_plan_runner --plan_dir=<dir of *.json> [--data_dir=<dir>] [--threads=1] [--iterations=0]
+///       [google benchmark flags, e.g. --benchmark_filter=q6 --benchmark_out_format=json --benchmark_out=<file>]
+///
+/// Besides the time of each plan, the time of each relation of its RelMetric is reported in microseconds.
+
+namespace local_engine
+{
+namespace
+{
+    struct RunnerOptions
+    {
+        String plan_dir;
+        String data_dir;
+        int threads = 1;
+        int iterations = 0;
+    };
+
+    String readPlan(const std::filesystem::path & path, const String & data_dir)
+    {
+        std::ifstream in(path);
+        if (!in)
+            throw DB::Exception(DB::ErrorCodes::CANNOT_OPEN_FILE, "Can't read plan {}", path.string());
+        String plan((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        static const String placeholder = "${DATA_DIR}";
+        for (auto pos = plan.find(placeholder); pos != String::npos; pos = plan.find(placeholder, pos + data_dir.size()))
+            plan.replace(pos, placeholder.size(), data_dir);
+        return plan;
+    }
+
+    /// Times of the relation and of its inputs, averaged over the threads.
+    void addRelCounters(benchmark::State & state, const RelMetricPtr & metric)
+    {
+        for (const auto & input : metric->getInputs())
+            addRelCounters(state, input);
+        auto times = metric->getTotalTime();
+        auto name = std::to_string(metric->getId()) + "_" + metric->getName();
+        state.counters[name + "_us"] += static_cast<double>(times.time) / state.threads();
+        state.counters[name + "_input_wait_us"] += static_cast<double>(times.input_wait_elapsed_us) / state.threads();
+        state.counters[name + "_output_wait_us"] += static_cast<double>(times.output_wait_elapsed_us) / state.threads();
+    }
+
+    void runPlan(benchmark::State & state, const String & plan)
+    {
+        for (auto _ : state)
+        {
+            auto context = DB::Context::createCopy(SerializedPlanParser::global_context);
+            SerializedPlanParser parser(context);
+            auto query_plan = parser.parseJson(plan);
+            LocalExecutor executor(parser.query_context, context, false);
+            executor.setMetric(parser.getMetric());
+            executor.setExtraPlanHolder(parser.extra_plan_holder);
+            executor.execute(std::move(query_plan));
+            size_t rows = 0;
+            while (executor.hasNext())
+                rows += executor.nextColumnar()->rows();
+            state.counters["rows"] += static_cast<double>(rows) / state.threads();
+            if (auto metric = executor.getMetric())
+                addRelCounters(state, metric);
+        }
+        /// Per iteration, as the time is.
+        for (auto & [name, counter] : state.counters)
+            counter = benchmark::Counter(counter.value / state.iterations());
+    }
+
+    RunnerOptions parseOptions(int argc, char ** argv)
+    {
+        RunnerOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg(argv[i]);
+            auto value = [&](std::string_view key) -> std::optional<String>
+            {
+                if (arg.starts_with(key) && arg.size() > key.size() && arg[key.size()] == '=')
+                    return String(arg.substr(key.size() + 1));
+                return {};
+            };
+            if (auto plan_dir = value("--plan_dir"))
+                options.plan_dir = *plan_dir;
+            else if (auto data_dir = value("--data_dir"))
+                options.data_dir = *data_dir;
+            else if (auto threads = value("--threads"))
+                options.threads = std::stoi(*threads);
+            else if (auto iterations = value("--iterations"))
+                options.iterations = std::stoi(*iterations);
+            else
+                throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Unknown argument {}", arg);
+        }
+        if (options.plan_dir.empty())
+            throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "--plan_dir is required");
+        return options;
+    }
+
+    void registerPlans(const RunnerOptions & options)
+    {
+        std::vector<std::filesystem::path> paths;
+        for (const auto & entry : std::filesystem::directory_iterator(options.plan_dir))
+            if (entry.is_regular_file() && entry.path().extension() == ".json")
+                paths.push_back(entry.path());
+        std::sort(paths.begin(), paths.end());
+        for (const auto & path : paths)
+        {
+            auto plan = readPlan(path, options.data_dir);
+            auto * bm = benchmark::RegisterBenchmark(path.stem().c_str(), runPlan, plan)
+                            ->Threads(options.threads)
+                            ->UseRealTime()
+                            ->Unit(benchmark::kMillisecond);
+            if (options.iterations > 0)
+                bm->Iterations(options.iterations);
+        }
+    }
+}
+}
+
+int main(int argc, char ** argv)
+{
+    ::benchmark::Initialize(&argc, argv);
+    auto options = local_engine::parseOptions(argc, argv);
+
+    local_engine::BackendInitializerUtil::init(nullptr);
+    SCOPE_EXIT({ local_engine::BackendFinalizerUtil::finalizeGlobally(); });
+
+    local_engine::registerPlans(options);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -133,5 +133,63 @@ static void BM_SparkRowToCHColumn_Lineitem(benchmark::State & state)
         auto out_block = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*spark_row_info, header);
 }
 
+/// Arrays, maps and structs of up to 15 elements, some of them null
+static Block getNestedBlock(size_t rows)
+{
+    const NameTypes name_types = {
+        {"array_int", "Array(Nullable(Int64))"},
+        {"array_string", "Array(Nullable(String))"},
+        {"map", "Map(String, Nullable(Int64))"},
+        {"struct", "Tuple(Nullable(Int32), Nullable(String), Array(Nullable(Float64)))"},
+    };
+
+    Block block = getLineitemHeader(name_types);
+    MutableColumns columns = block.cloneEmptyColumns();
+    for (size_t row = 0; row < rows; ++row)
+    {
+        Array ints;
+        Array strings;
+        Map map;
+        Array doubles;
+        for (size_t i = 0; i < row % 16; ++i)
+        {
+            const bool is_null = (row + i) % 7 == 0;
+            ints.emplace_back(is_null ? Field() : Field(static_cast<Int64>(row * i)));
+            strings.emplace_back(is_null ? Field() : Field("value_" + std::to_string(row + i)));
+            map.emplace_back(Tuple{"key_" + std::to_string(i), is_null ? Field() : Field(static_cast<Int64>(i))});
+            doubles.emplace_back(is_null ? Field() : Field(static_cast<Float64>(row) / (i + 1)));
+        }
+        columns[0]->insert(ints);
+        columns[1]->insert(strings);
+        columns[2]->insert(map);
+        columns[3]->insert(Tuple{static_cast<Int32>(row), "struct_" + std::to_string(row), doubles});
+    }
+    block.setColumns(std::move(columns));
+    return block;
+}
+
+static void BM_CHColumnToSparkRow_Nested(benchmark::State & state)
+{
+    const Block block = getNestedBlock(65536);
+    CHColumnToSparkRow converter;
+    for (auto _ : state)
+    {
+        auto spark_row_info = converter.convertCHColumnToSparkRow(block);
+        converter.freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+    }
+}
+
+static void BM_SparkRowToCHColumn_Nested(benchmark::State & state)
+{
+    const Block block = getNestedBlock(65536);
+    CHColumnToSparkRow spark_row_converter;
+    auto spark_row_info = spark_row_converter.convertCHColumnToSparkRow(block);
+    for (auto _ : state) [[maybe_unused]]
+        auto out_block = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*spark_row_info, block.cloneEmpty());
+    spark_row_converter.freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+}
+
 BENCHMARK(BM_CHColumnToSparkRow_Lineitem)->Unit(benchmark::kMillisecond)->Iterations(10);
 BENCHMARK(BM_SparkRowToCHColumn_Lineitem)->Unit(benchmark::kMillisecond)->Iterations(10);
+BENCHMARK(BM_CHColumnToSparkRow_Nested)->Unit(benchmark::kMillisecond)->Iterations(10);
+BENCHMARK(BM_SparkRowToCHColumn_Nested)->Unit(benchmark::kMillisecond)->Iterations(10);
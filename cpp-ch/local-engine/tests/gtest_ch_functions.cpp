@@ -14,14 +14,31 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <Columns/ColumnDecimal.h>
 #include <Columns/ColumnSet.h>
+#include <DataTypes/DataTypeArray.h>
+#include <DataTypes/DataTypesDecimal.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <DataTypes/DataTypeSet.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
 #include <Functions/FunctionFactory.h>
+#include <Functions/SparkStringKernels.h>
 #include <Interpreters/Set.h>
 #include <Parser/SerializedPlanParser.h>
 #include <gtest/gtest.h>
 #include <Common/DebugUtils.h>
 
+namespace
+{
+DB::ColumnPtr executeFunction(const DB::String & name, const DB::ColumnsWithTypeAndName & arguments)
+{
+    auto function = DB::FunctionFactory::instance().get(name, local_engine::SerializedPlanParser::global_context);
+    auto executable = function->build(arguments);
+    return executable->execute(arguments, executable->getResultType(), arguments.front().column->size());
+}
+}
+
 TEST(TestFuntion, Hash)
 {
     using namespace DB;
@@ -182,3 +199,177 @@ TEST(TestFunction, NotIn2)
     debug::headColumn(result2);
     ASSERT_EQ(result2->getUInt(3), 1);
 }
+
+TEST(TestFunction, SparkStringKernels)
+{
+    using namespace local_engine;
+    /// Longer than a vector, with the match and the runs crossing its boundary.
+    std::string haystack = "   abcabcabcabcabcabxabcd   ";
+    const auto * begin = reinterpret_cast<const UInt8 *>(haystack.data());
+    const auto * end = begin + haystack.size();
+    auto find = [&](const std::string & needle)
+    { return static_cast<size_t>(findSubstring(begin, end, reinterpret_cast<const UInt8 *>(needle.data()), needle.size()) - begin); };
+    ASSERT_EQ(find("abx"), haystack.find("abx"));
+    ASSERT_EQ(find("abcd"), haystack.find("abcd"));
+    ASSERT_EQ(find("d "), haystack.find("d "));
+    ASSERT_EQ(find("abd"), haystack.size());
+    ASSERT_EQ(skipByteForward(begin, end, ' ') - begin, 3);
+    ASSERT_EQ(end - skipByteBackward(begin, end, ' '), 3);
+    ASSERT_TRUE(isAllASCII(begin, haystack.size()));
+    haystack[20] = '\xC3';
+    ASSERT_FALSE(isAllASCII(begin, haystack.size()));
+}
+
+TEST(TestFunction, ArrayDistinctSpark)
+{
+    using namespace DB;
+    const Field null;
+    const Float64 nan = std::numeric_limits<Float64>::quiet_NaN();
+    const Float64 inf = std::numeric_limits<Float64>::infinity();
+    const Int64 max = std::numeric_limits<Int64>::max();
+    const Int64 min = std::numeric_limits<Int64>::min();
+    /// The arrays and their distinct elements, NaN equal to NaN and -0.0 distinct from 0.0 as they are bitwise.
+    const std::vector<std::tuple<DataTypePtr, Array, Array>> cases = {
+        {std::make_shared<DataTypeInt32>(), Array{3, 1, 3, 2, 1, 2}, Array{3, 1, 2}},
+        {makeNullable(std::make_shared<DataTypeInt64>()), Array{max, null, min, max, 0, null, min, -1}, Array{max, null, min, 0, -1}},
+        {makeNullable(std::make_shared<DataTypeInt64>()), Array{null, null}, Array{null}},
+        {makeNullable(std::make_shared<DataTypeInt64>()), Array{}, Array{}},
+        {makeNullable(std::make_shared<DataTypeFloat64>()),
+         Array{nan, 0.0, -0.0, nan, inf, null, -inf, 0.0, -0.0},
+         Array{nan, 0.0, -0.0, inf, null, -inf}},
+        {std::make_shared<DataTypeFloat32>(), Array{-0.0f, nan, 0.0f, nan, -0.0f, 1.5f}, Array{-0.0f, nan, 0.0f, 1.5f}},
+    };
+    for (const auto & [element_type, input, expected] : cases)
+    {
+        /// Alone and repeated three times, the longer arrays deduplicated by a hash set rather than a scan.
+        Array repeated;
+        for (size_t i = 0; i < 3; ++i)
+            repeated.insert(repeated.end(), input.begin(), input.end());
+        auto type = std::make_shared<DataTypeArray>(element_type);
+        auto column = type->createColumn();
+        column->insert(input);
+        column->insert(repeated);
+        auto result = executeFunction("arrayDistinctSpark", {ColumnWithTypeAndName(std::move(column), type, "array")});
+        for (size_t row = 0; row < 2; ++row)
+            EXPECT_TRUE((*result)[row] == Field(expected)) << (*result)[row].dump() << " != " << Field(expected).dump();
+    }
+}
+
+TEST(TestFunction, ArraySortSpark)
+{
+    using namespace DB;
+    const Field null;
+    const Float64 nan = std::numeric_limits<Float64>::quiet_NaN();
+    const Float64 inf = std::numeric_limits<Float64>::infinity();
+    const Int64 max = std::numeric_limits<Int64>::max();
+    const Int64 min = std::numeric_limits<Int64>::min();
+    /// The arrays sorted ascending, NULL and NaN being the least values as compareAt orders them.
+    const std::vector<std::tuple<DataTypePtr, Array, Array>> cases = {
+        {std::make_shared<DataTypeInt64>(), Array{3, min, max, 0, -1, 3}, Array{min, -1, 0, 3, 3, max}},
+        {std::make_shared<DataTypeUInt8>(), Array{255UL, 0UL, 128UL, 1UL}, Array{0UL, 1UL, 128UL, 255UL}},
+        {makeNullable(std::make_shared<DataTypeInt32>()), Array{2, null, -5, null, 7}, Array{null, null, -5, 2, 7}},
+        {makeNullable(std::make_shared<DataTypeString>()), Array{"b", null, "", "ab", "a\xff"}, Array{null, "", "ab", "a\xff", "b"}},
+        {std::make_shared<DataTypeString>(), Array{"ba", "b", "a", "ab"}, Array{"a", "ab", "b", "ba"}},
+        {std::make_shared<DataTypeFloat64>(), Array{1.5, nan, 0.0, -inf, inf}, Array{nan, -inf, 0.0, 1.5, inf}},
+    };
+    for (const auto & [element_type, input, ascending] : cases)
+    {
+        const Array descending(ascending.rbegin(), ascending.rend());
+        /// With an empty and a single element array in the same column.
+        auto type = std::make_shared<DataTypeArray>(element_type);
+        auto column = type->createColumn();
+        column->insert(Array{});
+        column->insert(input);
+        column->insert(Array{input.front()});
+        const ColumnsWithTypeAndName arguments = {ColumnWithTypeAndName(std::move(column), type, "array")};
+        for (const auto & [name, expected] : {std::pair{"arraySortSpark", ascending}, std::pair{"arrayReverseSortSpark", descending}})
+        {
+            auto result = executeFunction(name, arguments);
+            EXPECT_TRUE((*result)[0] == Field(Array{})) << name;
+            EXPECT_TRUE((*result)[1] == Field(expected)) << name << ": " << (*result)[1].dump() << " != " << Field(expected).dump();
+            EXPECT_TRUE((*result)[2] == Field(Array{input.front()})) << name;
+        }
+    }
+}
+
+TEST(TestFunction, CheckDecimalOverflowSpark)
+{
+    using namespace DB;
+    struct Case
+    {
+        UInt32 scale_from;
+        UInt32 precision_to;
+        UInt32 scale_to;
+        Int64 value;
+        bool overflow;
+    };
+    /// The raw Decimal64 values on both sides of the bound the range check derives, exactly at it included.
+    const std::vector<Case> cases = {
+        /// 99.99 fits Decimal(5, 3) but 100.00 doesn't, the bound 10^(5 + 2 - 3).
+        {2, 5, 3, 9999, false},
+        {2, 5, 3, 10000, true},
+        {2, 5, 3, -9999, false},
+        {2, 5, 3, -10000, true},
+        {2, 5, 3, 0, false},
+        /// scale_to < scale_from, 99.9999 is truncated to 99.9 of Decimal(3, 1) but 100.0000 doesn't fit.
+        {4, 3, 1, 999999, false},
+        {4, 3, 1, 1000000, true},
+        {4, 3, 1, -999999, false},
+        {4, 3, 1, -1000000, true},
+        /// No digit left for the integral part, digits <= 0: only zero fits.
+        {0, 2, 5, 0, false},
+        {0, 2, 5, 1, true},
+        {0, 2, 5, -1, true},
+        /// A bound beyond Decimal64, checked exactly.
+        {10, 18, 0, std::numeric_limits<Int64>::max(), false},
+        {10, 18, 0, std::numeric_limits<Int64>::min(), false},
+        /// The bound 10^18 of Decimal64 itself.
+        {0, 18, 0, std::numeric_limits<Int64>::max(), true},
+        {0, 18, 0, 999999999999999999, false},
+    };
+    auto make_arguments = [](UInt32 scale_from, UInt32 precision_to, UInt32 scale_to, const std::vector<Int64> & values)
+    {
+        auto type = std::make_shared<DataTypeDecimal64>(18, scale_from);
+        auto column = type->createColumn();
+        for (auto value : values)
+            assert_cast<ColumnDecimal<Decimal64> &>(*column).getData().push_back(Decimal64(value));
+        auto uint_type = std::make_shared<DataTypeUInt32>();
+        return ColumnsWithTypeAndName{
+            ColumnWithTypeAndName(std::move(column), type, "value"),
+            ColumnWithTypeAndName(uint_type->createColumnConst(values.size(), precision_to), uint_type, "precision"),
+            ColumnWithTypeAndName(uint_type->createColumnConst(values.size(), scale_to), uint_type, "scale")};
+    };
+    for (const auto & c : cases)
+    {
+        SCOPED_TRACE(fmt::format("{} scale {} to Decimal({}, {})", c.value, c.scale_from, c.precision_to, c.scale_to));
+        auto arguments = make_arguments(c.scale_from, c.precision_to, c.scale_to, {c.value});
+        auto result = executeFunction("checkDecimalOverflowSparkOrNull", arguments);
+        EXPECT_EQ(result->isNullAt(0), c.overflow);
+        if (c.overflow)
+            EXPECT_THROW(executeFunction("checkDecimalOverflowSpark", arguments), Exception);
+        else
+        {
+            auto checked = executeFunction("checkDecimalOverflowSpark", arguments);
+            EXPECT_EQ(assert_cast<const ColumnDecimal<Decimal64> &>(*checked).getData()[0].value, c.value);
+        }
+    }
+
+    /// A rescaling overflowing Int64 keeps its value, as the exact check did before the range check.
+    auto arguments = make_arguments(0, 18, 10, {100000000000000000});
+    EXPECT_FALSE(executeFunction("checkDecimalOverflowSparkOrNull", arguments)->isNullAt(0));
+    EXPECT_THROW(executeFunction("checkDecimalOverflowSpark", arguments), Exception);
+
+    /// The overflows of several blocks of the range check, at their first and last rows.
+    std::vector<Int64> values(1000);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const Int64 value = static_cast<Int64>(i) * 10;
+        values[i] = i % 2 ? value : -value;
+    }
+    const std::set<size_t> overflows = {0, 255, 256, 511, 999};
+    for (auto row : overflows)
+        values[row] = row % 2 ? 10000 : -10000;
+    auto result = executeFunction("checkDecimalOverflowSparkOrNull", make_arguments(2, 5, 3, values));
+    for (size_t row = 0; row < values.size(); ++row)
+        EXPECT_EQ(result->isNullAt(row), overflows.contains(row)) << "row " << row;
+}
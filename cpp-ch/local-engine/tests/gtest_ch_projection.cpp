@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <Builder/SerializedPlanBuilder.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Interpreters/ExpressionActions.h>
+#include <Parser/SerializedPlanParser.h>
+#include <gtest/gtest.h>
+#include <substrait/algebra.pb.h>
+#include <substrait/extensions/extensions.pb.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+substrait::Expression field(Int32 position)
+{
+    substrait::Expression expr;
+    expr.mutable_selection()->mutable_direct_reference()->mutable_struct_field()->set_field(position);
+    return expr;
+}
+
+substrait::Expression call(UInt32 function_reference, const DataTypePtr & output_type, const std::vector<substrait::Expression> & args)
+{
+    substrait::Expression expr;
+    auto * scalar_function = expr.mutable_scalar_function();
+    scalar_function->set_function_reference(function_reference);
+    *scalar_function->mutable_output_type() = *SerializedPlanBuilder::buildType(output_type);
+    for (const auto & arg : args)
+        *scalar_function->add_arguments()->mutable_value() = arg;
+    return expr;
+}
+
+size_t countFunctions(const ActionsDAG & actions_dag, const String & name)
+{
+    return std::count_if(
+        actions_dag.getNodes().begin(),
+        actions_dag.getNodes().end(),
+        [&](const auto & node) { return node.type == ActionsDAG::ActionType::FUNCTION && node.function_base->getName() == name; });
+}
+
+/// Equal values of the same sign, or both NaN, or both NULL.
+void expectColumn(const ColumnPtr & column, const std::vector<std::optional<Float64>> & expected)
+{
+    ASSERT_EQ(column->size(), expected.size());
+    for (size_t row = 0; row < expected.size(); ++row)
+    {
+        SCOPED_TRACE(fmt::format("row {}", row));
+        ASSERT_EQ(column->isNullAt(row), !expected[row].has_value());
+        if (!expected[row])
+            continue;
+        const Float64 value = (*column)[row].get<Float64>();
+        if (std::isnan(*expected[row]))
+            EXPECT_TRUE(std::isnan(value));
+        else
+        {
+            EXPECT_EQ(value, *expected[row]);
+            EXPECT_EQ(std::signbit(value), std::signbit(*expected[row]));
+        }
+    }
+}
+}
+
+TEST(ProjectionDAG, ReuseRepeatedExpressions)
+{
+    SerializedPlanParser parser(SerializedPlanParser::global_context);
+    google::protobuf::RepeatedPtrField<substrait::extensions::SimpleExtensionDeclaration> extensions;
+    const std::vector<String> signatures = {"add:opt_fp64_fp64", "multiply:opt_fp64_fp64", "negative:fp64", "abs:fp64"};
+    for (size_t i = 0; i < signatures.size(); ++i)
+    {
+        auto * function = extensions.Add()->mutable_extension_function();
+        function->set_function_anchor(static_cast<UInt32>(i));
+        function->set_name(signatures[i]);
+    }
+    parser.parseExtensions(extensions);
+
+    const auto float64 = std::make_shared<DataTypeFloat64>();
+    const auto nullable_float64 = makeNullable(float64);
+    auto a = ColumnNullable::create(ColumnFloat64::create(), ColumnUInt8::create());
+    auto b = ColumnFloat64::create();
+    const Float64 nan = std::numeric_limits<Float64>::quiet_NaN();
+    const Float64 max = std::numeric_limits<Float64>::max();
+    const Float64 inf = std::numeric_limits<Float64>::infinity();
+    for (Field value : {Field(1.5), Field(), Field(nan), Field(-0.0), Field(max)})
+        a->insert(value);
+    for (Float64 value : {2.0, 3.0, 1.0, 0.0, max})
+        b->insert(value);
+    Block block{{std::move(a), nullable_float64, "a"}, {std::move(b), float64, "b"}};
+
+    auto a_plus_b = call(0, nullable_float64, {field(0), field(1)});
+    auto negative_b = call(2, float64, {field(1)});
+    const std::vector<substrait::Expression> expressions = {
+        a_plus_b,
+        call(1, nullable_float64, {a_plus_b, a_plus_b}),
+        a_plus_b,
+        negative_b,
+        call(3, float64, {negative_b}),
+        /// The arguments swapped, another expression.
+        call(0, nullable_float64, {field(1), field(0)}),
+        field(0),
+    };
+    auto actions_dag = parser.expressionsToActionsDAG(expressions, block.cloneEmpty(), block.cloneEmpty());
+
+    /// a + b is computed once for its four occurrences, b + a once more, -b once for both.
+    EXPECT_EQ(countFunctions(*actions_dag, "plus"), 2UL);
+    EXPECT_EQ(countFunctions(*actions_dag, "multiply"), 1UL);
+    EXPECT_EQ(countFunctions(*actions_dag, "negate"), 1UL);
+    EXPECT_EQ(countFunctions(*actions_dag, "abs"), 1UL);
+
+    ExpressionActions(actions_dag).execute(block);
+    const auto & outputs = actions_dag->getOutputs();
+    ASSERT_EQ(outputs.size(), expressions.size());
+    auto result = [&](size_t i) { return block.getByName(outputs[i]->result_name).column; };
+    const std::vector<std::optional<Float64>> sums = {3.5, std::nullopt, nan, 0.0, inf};
+    expectColumn(result(0), sums);
+    expectColumn(result(1), {12.25, std::nullopt, nan, 0.0, inf});
+    expectColumn(result(2), sums);
+    expectColumn(result(3), {-2.0, -3.0, -1.0, -0.0, -max});
+    expectColumn(result(4), {2.0, 3.0, 1.0, 0.0, max});
+    expectColumn(result(5), sums);
+    expectColumn(result(6), {1.5, std::nullopt, nan, -0.0, max});
+}
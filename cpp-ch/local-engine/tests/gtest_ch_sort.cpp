@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Parser/SerializedPlanParser.h>
+#include <Parser/SortRelParser.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
+#include <Processors/QueryPlan/BuildQueryPipelineSettings.h>
+#include <Processors/QueryPlan/Optimizations/QueryPlanOptimizationSettings.h>
+#include <Processors/QueryPlan/ReadFromPreparedSource.h>
+#include <Processors/QueryPlan/SortingStep.h>
+#include <Processors/Sources/SourceFromSingleChunk.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <gtest/gtest.h>
+#include <substrait/plan.pb.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// A source whose streams are sorted as given.
+class SortedSourceStep : public ReadFromPreparedSource
+{
+public:
+    SortedSourceStep(Pipe pipe, SortDescription sort_description, DataStream::SortScope sort_scope)
+        : ReadFromPreparedSource(std::move(pipe))
+    {
+        output_stream->sort_description = std::move(sort_description);
+        output_stream->sort_scope = sort_scope;
+    }
+};
+
+Block makeBlock(const std::vector<Int64> & a, const std::vector<Int64> & b)
+{
+    auto a_column = ColumnInt64::create();
+    auto b_column = ColumnInt64::create();
+    a_column->getData().assign(a.begin(), a.end());
+    b_column->getData().assign(b.begin(), b.end());
+    return Block{
+        {std::move(a_column), std::make_shared<DataTypeInt64>(), "a"}, {std::move(b_column), std::make_shared<DataTypeInt64>(), "b"}};
+}
+
+/// A plan reading the blocks, one stream each, sorted as given.
+QueryPlanPtr makePlan(const Blocks & blocks, const SortDescription & sort_description, DataStream::SortScope sort_scope)
+{
+    Pipes pipes;
+    for (const auto & block : blocks)
+        pipes.emplace_back(std::make_shared<SourceFromSingleChunk>(block));
+    auto plan = std::make_unique<QueryPlan>();
+    plan->addStep(std::make_unique<SortedSourceStep>(Pipe::unitePipes(std::move(pipes)), sort_description, sort_scope));
+    return plan;
+}
+
+/// Sorts by the columns, ascending and nulls first.
+substrait::Rel makeSortRel(const std::vector<int32_t> & fields)
+{
+    substrait::Rel rel;
+    for (auto field : fields)
+    {
+        auto * sort = rel.mutable_sort()->add_sorts();
+        sort->mutable_expr()->mutable_selection()->mutable_direct_reference()->mutable_struct_field()->set_field(field);
+        sort->set_direction(substrait::SortField::SORT_DIRECTION_ASC_NULLS_FIRST);
+    }
+    return rel;
+}
+
+const SortingStep * parseSort(SortRelParser & parser, QueryPlanPtr & plan, const substrait::Rel & rel)
+{
+    std::list<const substrait::Rel *> rel_stack;
+    plan = parser.parse(std::move(plan), rel, rel_stack);
+    return parser.getSteps().empty() ? nullptr : dynamic_cast<const SortingStep *>(parser.getSteps().back());
+}
+
+void assertSortedOutput(QueryPlan & plan, size_t rows)
+{
+    auto builder = plan.buildQueryPipeline(QueryPlanOptimizationSettings(), BuildQueryPipelineSettings());
+    auto pipeline = QueryPipelineBuilder::getPipeline(std::move(*builder));
+    PullingPipelineExecutor executor(pipeline);
+    std::vector<std::pair<Int64, Int64>> result;
+    Block block;
+    while (executor.pull(block))
+        for (size_t row = 0; row < block.rows(); ++row)
+            result.emplace_back(block.getByName("a").column->getInt(row), block.getByName("b").column->getInt(row));
+    ASSERT_EQ(result.size(), rows);
+    ASSERT_TRUE(std::is_sorted(result.begin(), result.end()));
+}
+
+const SortColumnDescription a_asc("a", 1, -1);
+const SortColumnDescription b_asc("b", 1, -1);
+}
+
+TEST(SortRelParser, DropSortOfGloballySortedInput)
+{
+    SerializedPlanParser plan_parser(SerializedPlanParser::global_context);
+    SortRelParser parser(&plan_parser);
+    auto plan = makePlan({makeBlock({1, 1, 2, 3}, {1, 2, 0, 5})}, {a_asc, b_asc}, DataStream::SortScope::Global);
+    const auto * source = plan->getRootNode()->step.get();
+
+    /// Sorted by a prefix of the keys the input is sorted by.
+    ASSERT_EQ(parseSort(parser, plan, makeSortRel({0})), nullptr);
+    ASSERT_EQ(plan->getRootNode()->step.get(), source);
+    ASSERT_EQ(parseSort(parser, plan, makeSortRel({0, 1})), nullptr);
+    ASSERT_EQ(plan->getRootNode()->step.get(), source);
+    assertSortedOutput(*plan, 4);
+}
+
+TEST(SortRelParser, FinishSortingOfPrefixSortedStreams)
+{
+    SerializedPlanParser plan_parser(SerializedPlanParser::global_context);
+    SortRelParser parser(&plan_parser);
+    /// Each stream sorted by a only, the rows of equal a in any order of b.
+    auto plan = makePlan(
+        {makeBlock({1, 1, 2, 4, 4}, {3, 1, 2, 9, 0}), makeBlock({0, 1, 1, 4}, {5, 7, 0, 4})}, {a_asc}, DataStream::SortScope::Stream);
+
+    const auto * sorting_step = parseSort(parser, plan, makeSortRel({0, 1}));
+    ASSERT_NE(sorting_step, nullptr);
+    ASSERT_EQ(sorting_step->getType(), SortingStep::Type::FinishSorting);
+    assertSortedOutput(*plan, 9);
+}
+
+TEST(SortRelParser, FullSortOfDifferentlySortedInput)
+{
+    const Blocks blocks = {makeBlock({3, 1, 2}, {0, 1, 2}), makeBlock({2, 0, 1}, {3, 4, 5})};
+    /// Sorted by another key, by the same key in another direction, or sorted chunks only.
+    const std::vector<std::pair<SortDescription, DataStream::SortScope>> inputs = {
+        {{b_asc}, DataStream::SortScope::Global},
+        {{SortColumnDescription("a", -1, 1)}, DataStream::SortScope::Stream},
+        {{a_asc}, DataStream::SortScope::Chunk},
+        {{}, DataStream::SortScope::None},
+    };
+    for (const auto & [sort_description, sort_scope] : inputs)
+    {
+        SCOPED_TRACE(dumpSortDescription(sort_description));
+        SerializedPlanParser plan_parser(SerializedPlanParser::global_context);
+        SortRelParser parser(&plan_parser);
+        auto plan = makePlan(blocks, sort_description, sort_scope);
+
+        const auto * sorting_step = parseSort(parser, plan, makeSortRel({0, 1}));
+        ASSERT_NE(sorting_step, nullptr);
+        ASSERT_EQ(sorting_step->getType(), SortingStep::Type::Full);
+        assertSortedOutput(*plan, 6);
+    }
+}
@@ -14,17 +14,51 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <chrono>
+#include <filesystem>
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <Columns/ColumnAggregateFunction.h>
+#include <Columns/ColumnConst.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeArray.h>
+#include <DataTypes/DataTypeLowCardinality.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Formats/FormatFactory.h>
 #include <Functions/FunctionFactory.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/ReadHelpers.h>
+#include <IO/BufferWithOwnMemory.h>
+#include <IO/WriteBufferFromFile.h>
+#include <IO/WriteBufferFromString.h>
 #include <Parser/SerializedPlanParser.h>
 #include <Parsers/ASTFunction.h>
 #include <Processors/Executors/PipelineExecutor.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Storages/CustomMergeTreeSink.h>
+#include <Storages/Output/BlockStripeSplitter.h>
+#include <Storages/Output/FileColumnStats.h>
+#include <Storages/Output/FileWriterWrappers.h>
+#include <Storages/Serializations/ExcelReadHelpers.h>
+#include <Storages/SubstraitSource/JSONFormatFile.h>
+#include <Storages/SubstraitSource/RangeReadFile.h>
+#include <Storages/SubstraitSource/ReadBufferBuilder.h>
+#include <Storages/SubstraitSource/StatisticsAggregation.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
 #include <gtest/gtest.h>
+#include <arrow/buffer.h>
+#include <base/scope_guard.h>
 #include <substrait/plan.pb.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/Util/MapConfiguration.h>
 #include <Common/DebugUtils.h>
 #include <Common/MergeTreeTool.h>
+#include <Common/ThreadPool.h>
 
 using namespace DB;
 using namespace local_engine;
@@ -285,3 +319,533 @@ TEST(TestWrite, MergeTreeWriteTest)
     auto executor = query_pipeline_builder.execute();
     executor->execute(1);
 }
+
+TEST(TestWrite, MergeTreeTableSkipIndexes)
+{
+    MergeTreeTable table;
+    table.database = "default";
+    table.table = "test";
+    table.relative_path = "tmp/test-write/";
+    table.min_block = 1;
+    table.max_block = 3;
+    table.skip_indexes = {"idx_a a TYPE minmax GRANULARITY 1", "idx_b b TYPE bloom_filter(0.01) GRANULARITY 2"};
+    auto parsed = parseMergeTreeTableString(table.toString());
+    EXPECT_EQ(parsed.end_mark, 0);
+    EXPECT_EQ(parsed.skip_indexes, table.skip_indexes);
+
+    table.begin_mark = 2;
+    table.end_mark = 5;
+    parsed = parseMergeTreeTableString(table.toString());
+    EXPECT_EQ(parsed.begin_mark, 2);
+    EXPECT_EQ(parsed.end_mark, 5);
+    EXPECT_EQ(parsed.skip_indexes, table.skip_indexes);
+
+    auto names_and_types_list = NamesAndTypesList::parse("columns format version: 1\n"
+                                                         "2 columns:\n"
+                                                         "`a` Int64\n"
+                                                         "`b` Nullable(String)\n");
+    auto metadata = buildMetaData(names_and_types_list, global_context, parsed.skip_indexes);
+    const auto & indices = metadata->getSecondaryIndices();
+    ASSERT_EQ(indices.size(), 2);
+    EXPECT_EQ(indices[0].name, "idx_a");
+    EXPECT_EQ(indices[0].type, "minmax");
+    EXPECT_EQ(indices[1].type, "bloom_filter");
+    EXPECT_EQ(indices[1].granularity, 2);
+}
+
+#if USE_SIMDJSON
+TEST(TestJSONInputFormat, SimdJSONEachRow)
+{
+    Block header{
+        {makeNullable(std::make_shared<DataTypeInt64>()), "id"},
+        {makeNullable(std::make_shared<DataTypeString>()), "name"},
+        {makeNullable(std::make_shared<DataTypeFloat64>()), "score"},
+        {std::make_shared<DataTypeArray>(std::make_shared<DataTypeInt32>()), "tags"}};
+    ReadBufferFromString in("{\"id\": 1, \"name\": \"a\", \"unknown\": {\"x\": 1}, \"score\": 1.5, \"tags\": [1, 2]}\n"
+                            "\r\n"
+                            "{\"score\": 2, \"id\": null}\r\n"
+                            "{\"name\": \"c\", \"id\": 3}");
+    auto format = std::make_shared<SimdJSONEachRowInputFormat>(header, in, RowInputFormatParams{8192}, FormatSettings{});
+    QueryPipeline pipeline(Pipe(format));
+    PullingPipelineExecutor executor(pipeline);
+    Block block;
+    ASSERT_TRUE(executor.pull(block));
+    ASSERT_EQ(block.rows(), 3);
+    EXPECT_EQ((*block.getByName("id").column)[0], Field(1));
+    EXPECT_TRUE((*block.getByName("id").column)[1].isNull());
+    EXPECT_EQ((*block.getByName("id").column)[2], Field(3));
+    EXPECT_EQ((*block.getByName("name").column)[0], Field("a"));
+    EXPECT_TRUE((*block.getByName("name").column)[1].isNull());
+    EXPECT_EQ((*block.getByName("score").column)[1], Field(2.0));
+    EXPECT_EQ((*block.getByName("tags").column)[0], Field(Array{Field(1), Field(2)}));
+    EXPECT_EQ((*block.getByName("tags").column)[2], Field(Array{}));
+}
+#endif
+
+TEST(TestStatisticsAggregation, AnswerFromRowGroupStatistics)
+{
+    auto type = makeNullable(std::make_shared<DataTypeInt32>());
+    auto literal_type = std::make_shared<DataTypeUInt8>();
+    auto & factory = AggregateFunctionFactory::instance();
+    AggregateFunctionProperties properties;
+    std::vector<StatisticsAggregation::Aggregate> aggregates{
+        {StatisticsAggregation::Kind::Count, "a", type, factory.get("count", {type}, {}, properties), "count(a)"},
+        {StatisticsAggregation::Kind::Count, "", literal_type, factory.get("count", {literal_type}, {}, properties), "count(1)"},
+        {StatisticsAggregation::Kind::Min, "a", type, factory.get("min", {type}, {}, properties), "min(a)"},
+        {StatisticsAggregation::Kind::Max, "a", type, factory.get("max", {type}, {}, properties), "max(a)"}};
+    StatisticsAggregation aggregation(aggregates);
+
+    auto statistics_of = [](UInt64 null_count, Field min, Field max)
+    {
+        return [=](const String &, const DataTypePtr &) -> std::optional<StatisticsAggregation::ColumnStatistics>
+        { return StatisticsAggregation::ColumnStatistics{null_count, min, max}; };
+    };
+    EXPECT_TRUE(aggregation.tryAdd(10, statistics_of(2, Int64(3), Int64(7))));
+    EXPECT_TRUE(aggregation.tryAdd(5, statistics_of(0, Int64(-1), Int64(4))));
+    EXPECT_TRUE(aggregation.tryAdd(4, statistics_of(4, Field(), Field())));
+    /// Missing statistics, the row group is read.
+    EXPECT_FALSE(aggregation.tryAdd(8, [](const String &, const DataTypePtr &) { return std::nullopt; }));
+    EXPECT_EQ(aggregation.getAddedRowGroups(), 3);
+
+    MutableColumns columns;
+    for (const auto & aggregate : aggregates)
+        columns.emplace_back(ColumnAggregateFunction::create(aggregate.function));
+    ASSERT_TRUE(aggregation.appendTo(columns));
+    EXPECT_FALSE(aggregation.appendTo(columns));
+
+    std::vector<Field> results;
+    for (size_t i = 0; i < aggregates.size(); ++i)
+    {
+        const auto & states = assert_cast<const ColumnAggregateFunction &>(*columns[i]);
+        ASSERT_EQ(states.size(), 1);
+        auto result = aggregates[i].function->getResultType()->createColumn();
+        aggregates[i].function->insertResultInto(states.getData()[0], *result, nullptr);
+        results.emplace_back((*result)[0]);
+    }
+    EXPECT_EQ(results[0], Field(UInt64(13)));
+    EXPECT_EQ(results[1], Field(UInt64(19)));
+    EXPECT_EQ(results[2], Field(Int64(-1)));
+    EXPECT_EQ(results[3], Field(Int64(7)));
+}
+
+TEST(TestRangeReadFile, ConcurrentReadAt)
+{
+    String data(1 << 20, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i * 31 % 251);
+    std::atomic<size_t> created = 0;
+    RangeReadFile file(
+        [&]
+        {
+            ++created;
+            return std::make_unique<ReadBufferFromString>(data);
+        },
+        data.size());
+
+    constexpr size_t num_threads = 8;
+    std::atomic<size_t> mismatches = 0;
+    std::vector<ThreadFromGlobalPool> threads;
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                for (size_t i = 0; i < 100; ++i)
+                {
+                    int64_t position = (t * 100 + i) * 1021 % data.size();
+                    int64_t nbytes = 4096 + i * 97;
+                    auto buffer = file.ReadAt(position, nbytes).ValueOrDie();
+                    /// Cut at the end of the file.
+                    auto expected = std::string_view(data).substr(position, nbytes);
+                    if (std::string_view(reinterpret_cast<const char *>(buffer->data()), buffer->size()) != expected)
+                        ++mismatches;
+                }
+            });
+    }
+    for (auto & thread : threads)
+        thread.join();
+    EXPECT_EQ(mismatches, 0);
+    /// The buffers are reused, never more than the reads at once.
+    EXPECT_LE(created, num_threads);
+
+    ASSERT_TRUE(file.Seek(data.size() - 10).ok());
+    char tail[16];
+    EXPECT_EQ(file.Read(sizeof(tail), tail).ValueOrDie(), 10);
+    EXPECT_EQ(std::string_view(tail, 10), std::string_view(data).substr(data.size() - 10));
+    EXPECT_EQ(file.Tell().ValueOrDie(), static_cast<int64_t>(data.size()));
+    EXPECT_EQ(file.Read(sizeof(tail), tail).ValueOrDie(), 0);
+
+    ASSERT_TRUE(file.Close().ok());
+    EXPECT_TRUE(file.closed());
+}
+
+TEST(TestReadBufferBuilder, AdjustTextSplitBoundaries)
+{
+    const String text = "a,1\nbb,22\r\nccc,333\rdddd,4444\n\r\nee,5\nlast";
+    for (size_t split_size : {1, 2, 3, 7, 16, 64})
+    {
+        String read;
+        for (size_t start = 0; start < text.size(); start += split_size)
+        {
+            ReadBufferFromString buffer(text);
+            auto [begin, end] = adjustFileReadPosition(buffer, start, std::min(start + split_size, text.size()));
+            ASSERT_LE(begin, end);
+            /// Each boundary starts a line, never between the \r and the \n of one line end.
+            for (auto pos : {begin, end})
+            {
+                if (pos == 0 || pos == text.size())
+                    continue;
+                ASSERT_TRUE(text[pos - 1] == '\n' || text[pos - 1] == '\r') << split_size << " " << pos;
+                ASSERT_FALSE(text[pos - 1] == '\r' && text[pos] == '\n') << split_size << " " << pos;
+            }
+            read += text.substr(begin, end - begin);
+        }
+        EXPECT_EQ(read, text) << split_size;
+    }
+}
+
+TEST(TestReadBufferBuilder, CachedReadBuffer)
+{
+    auto path = std::filesystem::temp_directory_path() / "cached_read_buffer.bin";
+    String data(3 << 20, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i * 7 % 253);
+    {
+        WriteBufferFromFile out(path.string());
+        out.write(data.data(), data.size());
+        out.finalize();
+    }
+
+    Poco::AutoPtr<Poco::Util::MapConfiguration> config(new Poco::Util::MapConfiguration);
+    config->setBool("hdfs.local_cache.enabled", true);
+    config->setString("s3.local_cache.cache_path", (std::filesystem::temp_directory_path() / "gluten_local_cache_test").string());
+    EXPECT_FALSE(getReadSettingsWithLocalCache(*config, "azure.local_cache.enabled").enable_filesystem_cache);
+    auto settings = getReadSettingsWithLocalCache(*config, "hdfs.local_cache.enabled");
+    ASSERT_TRUE(settings.enable_filesystem_cache);
+
+    size_t opened = 0;
+    auto creator = [&](size_t read_until_position)
+    {
+        ++opened;
+        auto in = std::make_unique<ReadBufferFromFile>(path.string());
+        in->setReadUntilPosition(read_until_position);
+        return in;
+    };
+    /// Unique per run, the cache outlives the test.
+    auto uri = "hdfs://test" + path.string() + "?" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    auto read_all = [&]
+    {
+        auto in = buildCachedReadBuffer(uri, data.size(), creator, settings);
+        String read;
+        readStringUntilEOF(read, *in);
+        return read;
+    };
+    ASSERT_EQ(read_all(), data);
+    ASSERT_GT(opened, 0);
+
+    /// The second read is served from the cache alone.
+    auto opened_on_miss = opened;
+    ASSERT_EQ(read_all(), data);
+    EXPECT_EQ(opened, opened_on_miss);
+    std::filesystem::remove(path);
+}
+
+TEST(TestExcelNumberReader, ParseEightDigitsFast)
+{
+    for (const char * digits : {"00000000", "12345678", "99999999", "10000001", "07060504"})
+        EXPECT_EQ(parseEightDigitsFast(digits), std::stoul(digits)) << digits;
+}
+
+TEST(TestExcelNumberReader, PlainIntegersAsGeneralParser)
+{
+    FormatSettings settings;
+    settings.csv.delimiter = ',';
+    auto read = [&](const String & field, bool has_quote, auto & x, bool fast)
+    {
+        ReadBufferFromString buf(field);
+        bool ok = fast ? tryReadExcelPlainIntText(x, buf, has_quote, settings) : readExcelIntTextImpl(x, buf, has_quote, settings);
+        return std::make_pair(ok, buf.count());
+    };
+
+    /// Plain integers take the fast path and end where the general parser ends.
+    for (const String & field :
+         {"0,", "7\n", "-42,", "+42,", "12345678,", "123456789012,", "-999999999999999999,", "100000000\r\n", "12\"", "5'"})
+    {
+        Int64 fast_value = 0;
+        Int64 value = 0;
+        auto [fast_ok, fast_end] = read(field, false, fast_value, true);
+        auto [ok, end] = read(field, false, value, false);
+        ASSERT_TRUE(fast_ok) << field;
+        ASSERT_TRUE(ok) << field;
+        EXPECT_EQ(fast_value, value) << field;
+        EXPECT_EQ(fast_end, end) << field;
+    }
+
+    /// Anything else is left untouched to the general parser.
+    for (const String & field : {"1,234\"", "12abc,", "$12,", "12", "-,", "9999999999999999999,", "1.5,", " 12,"})
+    {
+        Int64 value = 0;
+        ReadBufferFromString buf(field);
+        EXPECT_FALSE(tryReadExcelPlainIntText(value, buf, true, settings)) << field;
+        EXPECT_EQ(buf.count(), 0) << field;
+    }
+
+    UInt32 unsigned_value = 0;
+    ReadBufferFromString negative("-1,");
+    EXPECT_FALSE(tryReadExcelPlainIntText(unsigned_value, negative, false, settings));
+    Int8 small_value = 0;
+    ReadBufferFromString overflow("300,");
+    EXPECT_FALSE(tryReadExcelPlainIntText(small_value, overflow, false, settings));
+}
+
+TEST(TestExcelNumberReader, FloatsWithLongDigitRuns)
+{
+    FormatSettings settings;
+    settings.csv.delimiter = ',';
+    for (const String & field : {"12345678901234.5678,", "0.000000012345678,", "-98765432.12345678,", "1234567812345678,", "3.25,"})
+    {
+        Float64 value = 0;
+        ReadBufferFromString buf(field);
+        ASSERT_TRUE(readExcelFloatTextFastImpl(value, buf, false, settings)) << field;
+        EXPECT_DOUBLE_EQ(value, std::stod(field)) << field;
+        EXPECT_EQ(*buf.position(), ',') << field;
+    }
+}
+
+TEST(TestBlockStripeSplitter, SplitAtValueChangesOfEachType)
+{
+    constexpr size_t rows = 64;
+    auto data = ColumnUInt64::create();
+    auto sorted = ColumnInt32::create();
+    auto nested = ColumnString::create();
+    auto null_map = ColumnUInt8::create();
+    const auto low_cardinality_type = std::make_shared<DataTypeLowCardinality>(std::make_shared<DataTypeString>());
+    auto low_cardinality = low_cardinality_type->createColumn();
+    auto bucket = ColumnInt32::create();
+    for (size_t j = 0; j < rows; ++j)
+    {
+        data->insertValue(j);
+        sorted->insertValue(static_cast<Int32>(j / 16));
+        /// The nested values of the null rows differ, but are no boundaries.
+        const bool is_null = (j / 4) % 3 == 0;
+        nested->insert(is_null ? std::to_string(j) : "s" + std::to_string(j / 8));
+        null_map->insertValue(is_null);
+        low_cardinality->insert(Field("v" + std::to_string((j / 5) % 2)));
+        bucket->insertValue(static_cast<Int32>(j / 6));
+    }
+    const auto string_type = std::make_shared<DataTypeString>();
+    Block block(
+        {{std::move(sorted), std::make_shared<DataTypeInt32>(), "sorted"},
+         {std::move(data), std::make_shared<DataTypeUInt64>(), "data"},
+         {ColumnNullable::create(std::move(nested), std::move(null_map)), makeNullable(string_type), "nullable"},
+         {std::move(low_cardinality), low_cardinality_type, "low_cardinality"},
+         {string_type->createColumnConst(rows, Field("c")), string_type, "const"},
+         {std::move(bucket), std::make_shared<DataTypeInt32>(), "__bucket_value__"}});
+
+    for (const bool has_bucket : {false, true})
+    {
+        const std::vector<size_t> partition_columns{0, 2, 3, 4};
+        std::vector<size_t> compared = partition_columns;
+        if (has_bucket)
+            compared.push_back(block.columns() - 1);
+        std::vector<int32_t> expected{0};
+        for (size_t j = 1; j < rows; ++j)
+            if (std::any_of(
+                    compared.begin(),
+                    compared.end(),
+                    [&](size_t i)
+                    {
+                        const auto & column = *block.getByPosition(i).column;
+                        return column.compareAt(j - 1, j, column, 1) != 0;
+                    }))
+                expected.push_back(static_cast<int32_t>(j));
+
+        BlockStripes stripes = BlockStripeSplitter::split(block, partition_columns, has_bucket);
+        EXPECT_EQ(stripes.headingRowIndice, expected) << has_bucket;
+        ASSERT_EQ(stripes.blockAddresses.size(), expected.size());
+        for (size_t i = 0; i < stripes.blockAddresses.size(); ++i)
+        {
+            std::unique_ptr<Block> stripe(reinterpret_cast<Block *>(stripes.blockAddresses[i]));
+            const size_t to = i + 1 < expected.size() ? expected[i + 1] : rows;
+            /// The partition and bucket columns are not written to the files.
+            ASSERT_EQ(stripe->columns(), has_bucket ? 1 : 2);
+            ASSERT_EQ(stripe->rows(), to - expected[i]);
+            for (size_t j = 0; j < stripe->rows(); ++j)
+                EXPECT_EQ(stripe->getByPosition(0).column->getUInt(j), expected[i] + j);
+        }
+    }
+}
+
+namespace
+{
+/// Fails at the first flush, i.e. once 16 bytes are written.
+class FailingWriteBuffer : public BufferWithOwnMemory<WriteBuffer>
+{
+public:
+    FailingWriteBuffer() : BufferWithOwnMemory<WriteBuffer>(16) { }
+
+private:
+    void nextImpl() override { throw std::runtime_error("write failed"); }
+};
+
+/// Writes the rows as TSV into memory.
+class MemoryOutputFormatFile : public OutputFormatFile
+{
+public:
+    explicit MemoryOutputFormatFile(bool fail_)
+        : OutputFormatFile(SerializedPlanParser::global_context, "memory://", nullptr, {}), fail(fail_)
+    {
+    }
+
+    OutputFormatPtr createOutputFormat(const Block & header) override
+    {
+        auto res = std::make_shared<OutputFormat>();
+        if (fail)
+        {
+            res->write_buffer = std::make_unique<FailingWriteBuffer>();
+        }
+        else
+        {
+            auto buffer = std::make_unique<WriteBufferFromOwnString>();
+            out = buffer.get();
+            res->write_buffer = std::move(buffer);
+        }
+        res->output = FormatFactory::instance().getOutputFormat("TabSeparated", *res->write_buffer, header, context);
+        return res;
+    }
+
+    WriteBufferFromOwnString * out = nullptr;
+
+private:
+    bool fail;
+};
+
+/// Writes 100 blocks of 100 rows with the blocks queued to the flusher up to max_queued_blocks.
+std::pair<String, std::exception_ptr> writeQueuedBlocks(size_t max_queued_blocks, bool fail)
+{
+    /// The config of the global context is mutable, only the reference returned is const.
+    auto & config = const_cast<Poco::Util::AbstractConfiguration &>(SerializedPlanParser::global_context->getConfigRef());
+    config.setUInt64("file_writer.max_queued_blocks", max_queued_blocks);
+    SCOPE_EXIT({ config.remove("file_writer.max_queued_blocks"); });
+
+    auto file = std::make_shared<MemoryOutputFormatFile>(fail);
+    NormalFileWriter writer(file, SerializedPlanParser::global_context);
+    try
+    {
+        for (size_t i = 0; i < 100; ++i)
+        {
+            auto column = ColumnUInt64::create();
+            for (size_t j = 0; j < 100; ++j)
+                column->insertValue(i * 100 + j);
+            Block block({{std::move(column), std::make_shared<DataTypeUInt64>(), "id"}});
+            writer.consume(block);
+        }
+        writer.close();
+    }
+    catch (...)
+    {
+        return {"", std::current_exception()};
+    }
+    return {file->out->str(), nullptr};
+}
+}
+
+TEST(TestNormalFileWriter, QueuedBlocksWrittenInOrder)
+{
+    auto [expected, expected_error] = writeQueuedBlocks(0, false);
+    ASSERT_FALSE(expected_error);
+    auto [written, error] = writeQueuedBlocks(2, false);
+    ASSERT_FALSE(error);
+    EXPECT_EQ(written, expected);
+
+    String rows;
+    for (size_t i = 0; i < 100 * 100; ++i)
+        rows += std::to_string(i) + "\n";
+    EXPECT_EQ(expected, rows);
+}
+
+TEST(TestNormalFileWriter, RethrowsFlusherError)
+{
+    /// By a later consume or by close.
+    for (size_t max_queued_blocks : {0, 1, 4})
+        EXPECT_TRUE(writeQueuedBlocks(max_queued_blocks, true).second) << max_queued_blocks;
+}
+
+TEST(TestFileColumnStats, AccumulatesBlocks)
+{
+    const auto int_type = makeNullable(std::make_shared<DataTypeInt64>());
+    const auto float_type = std::make_shared<DataTypeFloat64>();
+    const auto string_type = makeNullable(std::make_shared<DataTypeString>());
+    const auto const_type = std::make_shared<DataTypeString>();
+    auto make_block = [&](const std::vector<Field> & ints, const std::vector<Field> & floats, const std::vector<Field> & strings)
+    {
+        auto int_column = int_type->createColumn();
+        auto float_column = float_type->createColumn();
+        auto string_column = string_type->createColumn();
+        for (size_t i = 0; i < ints.size(); ++i)
+        {
+            int_column->insert(ints[i]);
+            float_column->insert(floats[i]);
+            string_column->insert(strings[i]);
+        }
+        return Block(
+            {{std::move(int_column), int_type, "i"},
+             {std::move(float_column), float_type, "d"},
+             {std::move(string_column), string_type, "s"},
+             {const_type->createColumnConst(ints.size(), Field("c")), const_type, "c"}});
+    };
+
+    FileColumnStats stats({"i", "d", "s", "c"});
+    stats.add(make_block({Int64(3), Field(), Int64(-7)}, {1.5, 0.5, -2.5}, {"pear", "apple", Field()}));
+    /// All null in a block, which bounds nothing.
+    stats.add(make_block({Field(), Field()}, {0.25, 8.0}, {Field(), Field()}));
+    stats.add(make_block({Int64(11)}, {1.5}, {"zebra"}));
+
+    Poco::JSON::Parser parser;
+    auto json = parser.parse(stats.toJSON()).extract<Poco::JSON::Object::Ptr>();
+    EXPECT_EQ(json->getValue<size_t>("numRows"), 6);
+    auto columns = json->getArray("columns");
+    ASSERT_EQ(columns->size(), 4);
+
+    auto column = columns->getObject(0);
+    EXPECT_EQ(column->getValue<String>("name"), "i");
+    EXPECT_EQ(column->getValue<size_t>("nullCount"), 3);
+    EXPECT_EQ(column->getValue<String>("min"), "-7");
+    EXPECT_EQ(column->getValue<String>("max"), "11");
+    EXPECT_EQ(column->getValue<size_t>("ndv"), 3);
+
+    column = columns->getObject(1);
+    EXPECT_EQ(column->getValue<size_t>("nullCount"), 0);
+    EXPECT_EQ(column->getValue<String>("min"), "-2.5");
+    EXPECT_EQ(column->getValue<String>("max"), "8");
+    EXPECT_EQ(column->getValue<size_t>("ndv"), 5);
+
+    column = columns->getObject(2);
+    EXPECT_EQ(column->getValue<size_t>("nullCount"), 3);
+    EXPECT_EQ(column->getValue<String>("min"), "apple");
+    EXPECT_EQ(column->getValue<String>("max"), "zebra");
+    EXPECT_EQ(column->getValue<size_t>("ndv"), 3);
+
+    column = columns->getObject(3);
+    EXPECT_EQ(column->getValue<String>("min"), "c");
+    EXPECT_EQ(column->getValue<String>("max"), "c");
+    EXPECT_EQ(column->getValue<size_t>("ndv"), 1);
+}
+
+TEST(TestFileColumnStats, EstimatesLargeNdv)
+{
+    constexpr size_t distinct = 100000;
+    auto column = ColumnUInt64::create();
+    /// Each value twice.
+    for (size_t i = 0; i < 2 * distinct; ++i)
+        column->insertValue(i % distinct);
+    FileColumnStats stats({"id"});
+    stats.add(Block({{std::move(column), std::make_shared<DataTypeUInt64>(), "id"}}));
+
+    Poco::JSON::Parser parser;
+    auto json = parser.parse(stats.toJSON()).extract<Poco::JSON::Object::Ptr>();
+    auto stats_column = json->getArray("columns")->getObject(0);
+    EXPECT_NEAR(stats_column->getValue<double>("ndv"), distinct, distinct * 0.05);
+    EXPECT_EQ(stats_column->getValue<String>("min"), "0");
+    EXPECT_EQ(stats_column->getValue<String>("max"), std::to_string(distinct - 1));
+}
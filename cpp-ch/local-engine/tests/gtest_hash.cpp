@@ -14,7 +14,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Functions/FunctionFactory.h>
 #include <Functions/SparkFunctionHashingExtended.h>
+#include <Parser/SerializedPlanParser.h>
 #include <base/types.h>
 #include <gtest/gtest.h>
 #include <MurmurHash3.h>
@@ -36,3 +42,94 @@ TEST(Hash, SparkMurmurHash3_32)
         EXPECT_EQ(static_cast<Int32>(result), -1346355085);
     }
 }
+
+namespace
+{
+ColumnPtr executeHash(const String & name, const ColumnsWithTypeAndName & arguments, size_t rows)
+{
+    auto function = FunctionFactory::instance().get(name, SerializedPlanParser::global_context);
+    auto executable = function->build(arguments);
+    return executable->execute(arguments, executable->getResultType(), rows);
+}
+}
+
+TEST(Hash, SparkHashValues)
+{
+    auto int_type = std::make_shared<DataTypeInt32>();
+    auto nullable_int_type = makeNullable(int_type);
+    /// hash(1) and hash(null) of Spark.
+    ColumnsWithTypeAndName one = {{int_type->createColumnConst(1, Int32(1))->convertToFullColumnIfConst(), int_type, "one"}};
+    /// The hashes are unsigned, of the bits of Spark's signed ones.
+    EXPECT_EQ(static_cast<Int32>(executeHash("sparkMurmurHash3_32", one, 1)->getUInt(0)), -559580957);
+    auto null_column = nullable_int_type->createColumnConst(1, Field())->convertToFullColumnIfConst();
+    ColumnsWithTypeAndName null = {{null_column, nullable_int_type, "null"}};
+    EXPECT_EQ(executeHash("sparkMurmurHash3_32", null, 1)->getUInt(0), 42);
+    EXPECT_EQ(executeHash("sparkXxHash64", null, 1)->getUInt(0), 42);
+
+    /// -0.0 is hashed as 0.0.
+    auto double_type = std::make_shared<DataTypeFloat64>();
+    auto doubles = ColumnFloat64::create();
+    doubles->insertValue(-0.0);
+    doubles->insertValue(0.0);
+    ColumnsWithTypeAndName zeros = {{std::move(doubles), double_type, "zeros"}};
+    for (const auto * name : {"sparkMurmurHash3_32", "sparkXxHash64"})
+    {
+        auto result = executeHash(name, zeros, 2);
+        EXPECT_EQ(result->getUInt(0), result->getUInt(1)) << name;
+    }
+}
+
+/// Hashed block by block, the rows get the hashes they get alone.
+TEST(Hash, SparkHashBlockByBlock)
+{
+    /// More rows than a block, with NULLs, NaN, -0.0 and the bounds of the types.
+    constexpr size_t rows = 2500;
+    const std::vector<Int32> special_ints
+        = {0, 1, -1, std::numeric_limits<Int32>::min(), std::numeric_limits<Int32>::max()};
+    const std::vector<Float64> special_doubles
+        = {std::numeric_limits<Float64>::quiet_NaN(),
+           -0.0,
+           0.0,
+           std::numeric_limits<Float64>::infinity(),
+           -std::numeric_limits<Float64>::infinity(),
+           std::numeric_limits<Float64>::min(),
+           std::numeric_limits<Float64>::max(),
+           std::numeric_limits<Float64>::lowest(),
+           std::numeric_limits<Float64>::denorm_min()};
+    auto ints = ColumnNullable::create(ColumnInt32::create(), ColumnUInt8::create());
+    auto doubles = ColumnFloat64::create();
+    auto strings = ColumnNullable::create(ColumnString::create(), ColumnUInt8::create());
+    for (size_t i = 0; i < rows; ++i)
+    {
+        if (i % 7 == 3)
+            ints->insertDefault();
+        else if (i % 11 == 0)
+            ints->insert(special_ints[i / 11 % special_ints.size()]);
+        else
+            ints->insert(static_cast<Int32>(i * 2654435761U));
+        doubles->insertValue(i % 5 == 0 ? special_doubles[i / 5 % special_doubles.size()] : static_cast<Float64>(i) * 0.25);
+        if (i % 13 == 6)
+            strings->insertDefault();
+        else
+            strings->insert(String(i % 17, static_cast<char>('a' + i % 26)));
+    }
+    auto long_type = std::make_shared<DataTypeInt64>();
+    const ColumnsWithTypeAndName arguments
+        = {{std::move(ints), makeNullable(std::make_shared<DataTypeInt32>()), "ints"},
+           {std::move(doubles), std::make_shared<DataTypeFloat64>(), "doubles"},
+           {long_type->createColumnConst(rows, Int64(-7)), long_type, "const"},
+           {std::move(strings), makeNullable(std::make_shared<DataTypeString>()), "strings"}};
+
+    for (const auto * name : {"sparkMurmurHash3_32", "sparkXxHash64"})
+    {
+        auto result = executeHash(name, arguments, rows);
+        ASSERT_EQ(result->size(), rows);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            ColumnsWithTypeAndName row_arguments;
+            for (const auto & argument : arguments)
+                row_arguments.emplace_back(argument.column->cut(row, 1), argument.type, argument.name);
+            ASSERT_EQ(result->getUInt(row), executeHash(name, row_arguments, 1)->getUInt(0)) << name << " row " << row;
+        }
+    }
+}
@@ -460,3 +460,30 @@ TEST(SparkRow, NullableComplexTypes)
     assertReadConsistentWithWritten(*spark_row_info, *block, type_and_fields);
     EXPECT_TRUE(spark_row_info->getTotalBytes() == 8 + 3 * 8);
 }
+
+TEST(SparkRow, ParallelRowRanges)
+{
+    const auto string_type = std::make_shared<DataTypeNullable>(std::make_shared<DataTypeString>());
+    Block block({{std::make_shared<DataTypeInt64>(), "a"}, {string_type, "b"}});
+    auto mutable_colums = block.mutateColumns();
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        mutable_colums[0]->insert(static_cast<Int64>(i));
+        mutable_colums[1]->insert(i % 7 == 0 ? Field(Null{}) : Field(String(i % 20, 'a' + i % 26)));
+    }
+    block.setColumns(std::move(mutable_colums));
+
+    CHColumnToSparkRow serial_converter;
+    CHColumnToSparkRow parallel_converter(3, 100);
+    auto serial = serial_converter.convertCHColumnToSparkRow(block);
+    auto parallel = parallel_converter.convertCHColumnToSparkRow(block);
+
+    /// The layout doesn't depend on the number of threads
+    EXPECT_TRUE(parallel->getOffsets() == serial->getOffsets());
+    EXPECT_TRUE(parallel->getLengths() == serial->getLengths());
+    ASSERT_EQ(parallel->getTotalBytes(), serial->getTotalBytes());
+    EXPECT_EQ(memcmp(parallel->getBufferAddress(), serial->getBufferAddress(), serial->getTotalBytes()), 0);
+
+    serial_converter.freeMem(serial->getBufferAddress(), serial->getTotalBytes());
+    parallel_converter.freeMem(parallel->getBufferAddress(), parallel->getTotalBytes());
+}
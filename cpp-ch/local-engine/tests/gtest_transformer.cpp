@@ -14,9 +14,20 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <Columns/ColumnConst.h>
+#include <Columns/ColumnLowCardinality.h>
 #include <Core/Field.h>
 #include <DataTypes/DataTypeFactory.h>
+#include <Functions/FunctionFactory.h>
+#include <Operator/AdaptiveFilterStep.h>
+#include <Operator/BlocksBufferPoolTransform.h>
+#include <Operator/LowCardinalityKeysStep.h>
+#include <Operator/NestedLoopJoinStep.h>
 #include <Operator/PartitionColumnFillingTransform.h>
+#include <Parser/SerializedPlanParser.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
+#include <Processors/Sources/SourceFromSingleChunk.h>
+#include <QueryPipeline/QueryPipeline.h>
 #include <gtest/gtest.h>
 
 using namespace DB;
@@ -44,6 +55,7 @@ TEST(TestPartitionColumnFillingTransform, TestInt32)
     ASSERT_EQ(2, chunk.getNumColumns());
     WhichDataType which(chunk.getColumns().at(0)->getDataType());
     ASSERT_TRUE(which.isInt32());
+    ASSERT_TRUE(isColumnConst(*chunk.getColumns().at(0)));
 }
 
 
@@ -127,3 +139,207 @@ TEST(TestPartitionColumnFillingTransform, TestString)
     WhichDataType which(chunk.getColumns().at(1)->getDataType());
     ASSERT_TRUE(which.isString());
 }
+
+TEST(TestBlocksPrefetchSource, PullsUpstreamOnItsThread)
+{
+    auto int_type = DataTypeFactory::instance().get("Int32");
+    Block header({ColumnWithTypeAndName(int_type, "colA")});
+    Pipes pipes;
+    for (Int32 i = 1; i <= 3; ++i)
+    {
+        auto column = int_type->createColumn();
+        column->insert(i);
+        pipes.emplace_back(std::make_shared<SourceFromSingleChunk>(Block({ColumnWithTypeAndName(std::move(column), int_type, "colA")})));
+    }
+    auto pipe = Pipe::unitePipes(std::move(pipes));
+    pipe.resize(1);
+    QueryPipeline upstream(std::move(pipe));
+    // A bound below the size of a chunk still lets one chunk at a time through.
+    QueryPipeline pipeline(Pipe(std::make_shared<local_engine::BlocksPrefetchSource>(header, std::move(upstream), 1)));
+    PullingPipelineExecutor executor(pipeline);
+
+    Chunk chunk;
+    size_t rows = 0;
+    Int64 sum = 0;
+    while (executor.pull(chunk))
+    {
+        rows += chunk.getNumRows();
+        if (chunk.getNumRows())
+            sum += chunk.getColumns()[0]->getInt(0);
+    }
+    ASSERT_EQ(3, rows);
+    ASSERT_EQ(6, sum);
+}
+
+TEST(TestAdaptiveFilterTransform, EvaluatesSelectiveConjunctFirst)
+{
+    auto int_type = DataTypeFactory::instance().get("Int32");
+    Block header({ColumnWithTypeAndName(int_type, "colA"), ColumnWithTypeAndName(int_type, "colB")});
+    auto context = local_engine::SerializedPlanParser::global_context;
+    auto build_conjunct = [&](const String & input_name, const String & function_name, Int32 value)
+    {
+        auto dag = std::make_shared<ActionsDAG>(NamesAndTypesList{{input_name, int_type}});
+        const auto * input = dag->getInputs().front();
+        const auto & constant = dag->addColumn(ColumnWithTypeAndName(int_type->createColumnConst(1, value), int_type, std::to_string(value)));
+        const auto & condition = dag->addFunction(FunctionFactory::instance().get(function_name, context), {input, &constant}, "");
+        dag->getOutputs() = {&condition};
+        return std::make_shared<ExpressionActions>(dag);
+    };
+    // colB > 0 keeps every row, colA = 1 one in ten.
+    std::vector<ExpressionActionsPtr> conjuncts{build_conjunct("colB", "greater", 0), build_conjunct("colA", "equals", 1)};
+    local_engine::AdaptiveFilterTransform transform(header, conjuncts);
+    ASSERT_EQ(transform.getOrder(), std::vector<size_t>({0, 1}));
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        auto col_a = int_type->createColumn();
+        auto col_b = int_type->createColumn();
+        for (Int32 row = 0; row < 100; ++row)
+        {
+            col_a->insert(row % 10);
+            col_b->insert(row + 1);
+        }
+        Columns columns{std::move(col_a), std::move(col_b)};
+        Chunk chunk(std::move(columns), 100);
+        transform.transform(chunk);
+        ASSERT_EQ(chunk.getNumRows(), 10);
+        ASSERT_EQ(chunk.getColumns()[0]->getInt(0), 1);
+        ASSERT_EQ(chunk.getColumns()[1]->getInt(0), 2);
+    }
+    ASSERT_EQ(transform.getOrder(), std::vector<size_t>({1, 0}));
+}
+
+TEST(TestNestedLoopJoinTransform, LeftJoinOnRange)
+{
+    auto int_type = DataTypeFactory::instance().get("Int32");
+    auto context = local_engine::SerializedPlanParser::global_context;
+    auto build_column = int_type->createColumn();
+    for (Int32 value : {3, 7, 2, 9})
+        build_column->insert(value);
+    Block build_block({ColumnWithTypeAndName(std::move(build_column), int_type, "colB")});
+    Block probe_header({ColumnWithTypeAndName(int_type, "colA")});
+
+    // colB < colA
+    auto dag = std::make_shared<ActionsDAG>(NamesAndTypesList{{"colA", int_type}, {"colB", int_type}});
+    const auto & condition = dag->addFunction(
+        FunctionFactory::instance().get("less", context), {dag->getInputs()[1], dag->getInputs()[0]}, "colB < colA");
+    dag->getOutputs() = {&condition};
+    auto build = local_engine::NestedLoopJoinBuild::create(std::move(build_block), probe_header, dag, condition.result_name);
+    ASSERT_TRUE(build->range.has_value());
+    ASSERT_TRUE(build->range->upper_bound);
+    ASSERT_EQ(build->block.getByPosition(0).column->getInt(0), 2);
+
+    auto probe_column = int_type->createColumn();
+    for (Int32 value : {1, 5, 10})
+        probe_column->insert(value);
+    auto output_header = probe_header.cloneEmpty();
+    output_header.insert(ColumnWithTypeAndName(int_type, "colB"));
+    // Pairs are joined two at a time.
+    auto transform = std::make_shared<local_engine::NestedLoopJoinTransform>(
+        probe_header, output_header, build, std::make_shared<ExpressionActions>(dag), condition.result_name, JoinKind::Left,
+        JoinStrictness::All, 2);
+    Pipe pipe(std::make_shared<SourceFromSingleChunk>(Block({ColumnWithTypeAndName(std::move(probe_column), int_type, "colA")})));
+    pipe.addTransform(transform);
+    QueryPipeline pipeline(std::move(pipe));
+    PullingPipelineExecutor executor(pipeline);
+
+    Chunk chunk;
+    size_t rows = 0;
+    Int64 sum = 0;
+    while (executor.pull(chunk))
+    {
+        rows += chunk.getNumRows();
+        for (size_t i = 0; i < chunk.getNumRows(); ++i)
+            sum += chunk.getColumns()[1]->getInt(i);
+    }
+    // 1 joins nothing, 5 joins 2 and 3, 10 joins all.
+    ASSERT_EQ(7, rows);
+    ASSERT_EQ(26, sum);
+}
+
+TEST(TestNestedLoopJoinTransform, LeftSemiAndAntiJoin)
+{
+    auto int_type = DataTypeFactory::instance().get("Int32");
+    auto context = local_engine::SerializedPlanParser::global_context;
+    auto build_column = int_type->createColumn();
+    for (Int32 value : {3, 7, 2, 9})
+        build_column->insert(value);
+    Block build_block({ColumnWithTypeAndName(std::move(build_column), int_type, "colB")});
+    Block probe_header({ColumnWithTypeAndName(int_type, "colA")});
+
+    // colB < colA
+    auto dag = std::make_shared<ActionsDAG>(NamesAndTypesList{{"colA", int_type}, {"colB", int_type}});
+    const auto & condition = dag->addFunction(
+        FunctionFactory::instance().get("less", context), {dag->getInputs()[1], dag->getInputs()[0]}, "colB < colA");
+    dag->getOutputs() = {&condition};
+    auto build = local_engine::NestedLoopJoinBuild::create(std::move(build_block), probe_header, dag, condition.result_name);
+    auto output_header = probe_header.cloneEmpty();
+    output_header.insert(ColumnWithTypeAndName(int_type, "colB"));
+
+    auto join = [&](JoinStrictness strictness)
+    {
+        auto probe_column = int_type->createColumn();
+        for (Int32 value : {1, 5, 10})
+            probe_column->insert(value);
+        auto transform = std::make_shared<local_engine::NestedLoopJoinTransform>(
+            probe_header, output_header, build, std::make_shared<ExpressionActions>(dag), condition.result_name, JoinKind::Left,
+            strictness, 2);
+        Pipe pipe(std::make_shared<SourceFromSingleChunk>(Block({ColumnWithTypeAndName(std::move(probe_column), int_type, "colA")})));
+        pipe.addTransform(transform);
+        QueryPipeline pipeline(std::move(pipe));
+        PullingPipelineExecutor executor(pipeline);
+        std::vector<Int64> probe_values;
+        Chunk chunk;
+        while (executor.pull(chunk))
+            for (size_t i = 0; i < chunk.getNumRows(); ++i)
+                probe_values.push_back(chunk.getColumns()[0]->getInt(i));
+        return probe_values;
+    };
+    // 1 joins nothing, 5 and 10 join at least one build row, each output once.
+    ASSERT_EQ(std::vector<Int64>({5, 10}), join(JoinStrictness::Semi));
+    ASSERT_EQ(std::vector<Int64>({1}), join(JoinStrictness::Anti));
+}
+
+TEST(TestLowCardinalityKeysTransform, CombineAndSplit)
+{
+    auto int_type = DataTypeFactory::instance().get("Int32");
+    auto string_type = DataTypeFactory::instance().get("LowCardinality(String)");
+    auto nullable_string_type = DataTypeFactory::instance().get("LowCardinality(Nullable(String))");
+    auto col_a = string_type->createColumn();
+    auto col_b = nullable_string_type->createColumn();
+    auto col_c = int_type->createColumn();
+    std::vector<std::pair<String, Field>> keys{{"us", "ok"}, {"fr", "ok"}, {"us", "ok"}, {"de", Null()}, {"fr", "ko"}};
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        col_a->insert(keys[i].first);
+        col_b->insert(keys[i].second);
+        col_c->insert(static_cast<Int32>(i));
+    }
+    Block header({ColumnWithTypeAndName(string_type, "colA"), ColumnWithTypeAndName(nullable_string_type, "colB"),
+                  ColumnWithTypeAndName(int_type, "colC")});
+    Names key_names{"colA", "colB"};
+    auto combined_header = local_engine::CombineLowCardinalityKeysStep::buildOutputHeader(header, key_names, "keys");
+    ASSERT_EQ(combined_header.getNames(), Names({"colC", "keys"}));
+
+    Chunk chunk(Columns{std::move(col_a), std::move(col_b), std::move(col_c)}, keys.size());
+    local_engine::CombineLowCardinalityKeysTransform combine(header, combined_header, key_names);
+    combine.transform(chunk);
+    ASSERT_EQ(chunk.getNumColumns(), 2);
+    const auto & combined = assert_cast<const ColumnLowCardinality &>(*chunk.getColumns()[1]);
+    ASSERT_EQ(combined.getIndexAt(0), combined.getIndexAt(2));
+    ASSERT_NE(combined.getIndexAt(0), combined.getIndexAt(1));
+    ASSERT_NE(combined.getIndexAt(1), combined.getIndexAt(4));
+    ASSERT_NE(combined.getIndexAt(3), combined.getIndexAt(4));
+
+    Block split_header({ColumnWithTypeAndName(int_type, "colC"), ColumnWithTypeAndName(string_type, "colA"),
+                        ColumnWithTypeAndName(nullable_string_type, "colB")});
+    local_engine::SplitLowCardinalityKeysTransform split_back(combined_header, split_header, 1);
+    split_back.transform(chunk);
+    ASSERT_EQ(chunk.getNumColumns(), 3);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(chunk.getColumns()[0]->getInt(i), static_cast<Int64>(i));
+        ASSERT_EQ((*chunk.getColumns()[1])[i], Field(keys[i].first));
+        ASSERT_EQ((*chunk.getColumns()[2])[i], keys[i].second);
+    }
+}
@@ -14,7 +14,20 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <filesystem>
+#include <fstream>
+#include <optional>
 #include <gtest/gtest.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Shuffle/LocalDirSelector.h>
+#include <Shuffle/SelectorBuilder.h>
+#include <Common/FragmentResultCache.h>
+#include <Common/SortKeyEncoder.h>
 #include <Common/StringUtils.h>
 
 using namespace local_engine;
@@ -29,3 +42,264 @@ TEST(TestStringUtils, TestExtractPartitionValues)
     ASSERT_EQ("col2", values[1].first);
     ASSERT_EQ("test", values[1].second);
 }
+
+TEST(TestSortKeyEncoder, OrderedAsCompareAt)
+{
+    auto ints = DB::ColumnNullable::create(DB::ColumnInt32::create(), DB::ColumnUInt8::create());
+    auto strings = DB::ColumnString::create();
+    auto doubles = DB::ColumnFloat64::create();
+    std::vector<std::optional<Int32>> int_values = {1, -1, std::nullopt, 0, 1, std::numeric_limits<Int32>::min(), -1, std::nullopt};
+    std::vector<String> string_values = {"a", String("a\0b", 3), "", "ab", String("a\0", 2), "b", "a", "ab"};
+    std::vector<Float64> double_values = {0.5, -0.0, 0.0, std::numeric_limits<Float64>::quiet_NaN(), -1e300, 1, 0.5, -0.5};
+    for (size_t i = 0; i < int_values.size(); ++i)
+    {
+        ints->insert(int_values[i] ? DB::Field(*int_values[i]) : DB::Field());
+        strings->insert(string_values[i]);
+        doubles->insert(double_values[i]);
+    }
+    DB::Columns columns{std::move(ints), std::move(strings), std::move(doubles)};
+
+    for (int direction : {1, -1})
+    {
+        for (int nulls_direction : {1, -1})
+        {
+            DB::SortDescription description;
+            description.emplace_back("i", direction, nulls_direction);
+            description.emplace_back("s", -direction, nulls_direction);
+            description.emplace_back("d", direction, -nulls_direction);
+            SortKeyEncoder keys(description);
+            keys.encode(columns, int_values.size());
+            for (size_t l = 0; l < int_values.size(); ++l)
+            {
+                for (size_t r = 0; r < int_values.size(); ++r)
+                {
+                    int expected = 0;
+                    for (size_t c = 0; c < columns.size() && !expected; ++c)
+                        expected = columns[c]->compareAt(l, r, *columns[c], description[c].nulls_direction) * description[c].direction;
+                    int actual = keys[l].compare(keys[r]);
+                    ASSERT_EQ(expected < 0, actual < 0) << l << " " << r;
+                    ASSERT_EQ(expected > 0, actual > 0) << l << " " << r;
+                }
+            }
+        }
+    }
+}
+
+namespace local_engine
+{
+class RangeSelectorBuilderTest : public ::testing::Test
+{
+protected:
+    static void assertSameAsCompareRow(RangeSelectorBuilder & builder, DB::Block & block)
+    {
+        DB::IColumn::Selector encoded;
+        ASSERT_TRUE(builder.computePartitionIdByEncodedKeys(block, encoded));
+        DB::IColumn::Selector expected;
+        builder.computePartitionIdByCompareRow(block, expected);
+        ASSERT_EQ(expected.size(), encoded.size());
+        for (size_t row = 0; row < expected.size(); ++row)
+            ASSERT_EQ(expected[row], encoded[row]) << row;
+    }
+};
+}
+
+TEST_F(RangeSelectorBuilderTest, EncodedKeysAsCompareRow)
+{
+    /// Nullable ints ascending with nulls first, then strings descending.
+    std::string options = R"({
+        "ordering": [
+            {"column_ref": 0, "column_name": "i", "data_type": "IntegerType", "is_nullable": true, "direction": 1},
+            {"column_ref": 1, "column_name": "s", "data_type": "StringType", "is_nullable": false, "direction": 4}],
+        "range_bounds": [
+            [{"is_null": true}, {"is_null": false, "value": "x"}],
+            [{"is_null": false, "value": 1}, {"is_null": false, "value": "b"}],
+            [{"is_null": false, "value": 1}, {"is_null": false, "value": "a"}],
+            [{"is_null": false, "value": 5}, {"is_null": false, "value": "z"}],
+            [{"is_null": false, "value": 9}, {"is_null": false, "value": ""}]]
+    })";
+    RangeSelectorBuilder builder(options, 6);
+
+    auto ints = DB::ColumnNullable::create(DB::ColumnInt32::create(), DB::ColumnUInt8::create());
+    auto strings = DB::ColumnString::create();
+    std::vector<std::optional<Int32>> int_values = {std::nullopt, 0, 1, 5, 9, 10};
+    std::vector<String> string_values = {"", "a", "b", "c", "x", "z"};
+    for (const auto & int_value : int_values)
+    {
+        for (const auto & string_value : string_values)
+        {
+            ints->insert(int_value ? DB::Field(*int_value) : DB::Field());
+            strings->insert(string_value);
+        }
+    }
+    DB::Block block(
+        {{std::move(ints), DB::makeNullable(std::make_shared<DB::DataTypeInt32>()), "i"},
+         {std::move(strings), std::make_shared<DB::DataTypeString>(), "s"}});
+    assertSameAsCompareRow(builder, block);
+}
+
+TEST_F(RangeSelectorBuilderTest, EncodedSingleKeyAsCompareRow)
+{
+    /// A single descending long, more rows than a lockstep batch and values beyond both ends.
+    std::string options = R"({
+        "ordering": [{"column_ref": 0, "column_name": "l", "data_type": "LongType", "is_nullable": false, "direction": 4}],
+        "range_bounds": [
+            [{"is_null": false, "value": 100}],
+            [{"is_null": false, "value": 10}],
+            [{"is_null": false, "value": 0}],
+            [{"is_null": false, "value": -10}]]
+    })";
+    RangeSelectorBuilder builder(options, 5);
+
+    auto longs = DB::ColumnInt64::create();
+    for (Int64 value = -20; value <= 110; value += 5)
+        longs->insert(value);
+    DB::Block block({{std::move(longs), std::make_shared<DB::DataTypeInt64>(), "l"}});
+    assertSameAsCompareRow(builder, block);
+}
+
+TEST(TestFragmentResultCache, KeyOfFiles)
+{
+    auto path = std::filesystem::temp_directory_path() / "fragment_result_cache_key.txt";
+    FragmentResultCache::File uri{"file://" + path.string()};
+    std::ofstream(path) << "a";
+    auto key = FragmentResultCache::getKey("plan", "conf", {uri});
+    ASSERT_TRUE(key);
+    ASSERT_EQ(key, FragmentResultCache::getKey("plan", "conf", {uri}));
+    ASSERT_NE(key, FragmentResultCache::getKey("plan", "other conf", {uri}));
+
+    /// Rewritten with the same size.
+    std::ofstream(path) << "b";
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+    auto rewritten_key = FragmentResultCache::getKey("plan", "conf", {uri});
+    ASSERT_TRUE(rewritten_key);
+    ASSERT_NE(key, rewritten_key);
+
+    std::filesystem::remove(path);
+    ASSERT_FALSE(FragmentResultCache::getKey("plan", "conf", {uri}));
+    ASSERT_FALSE(FragmentResultCache::getKey("plan", "conf", {{"hdfs://namenode:8020/a.parquet"}}));
+    ASSERT_FALSE(FragmentResultCache::getKey("plan", "conf", {{"s3a://bucket/a.parquet"}}));
+
+    /// Remote files are told by the modification time the plan carries.
+    auto remote_key = FragmentResultCache::getKey("plan", "conf", {{"hdfs://namenode:8020/a.parquet", 1700000000000}});
+    ASSERT_TRUE(remote_key);
+    ASSERT_EQ(remote_key, FragmentResultCache::getKey("plan", "conf", {{"hdfs://namenode:8020/a.parquet", 1700000000000}}));
+    ASSERT_NE(remote_key, FragmentResultCache::getKey("plan", "conf", {{"hdfs://namenode:8020/a.parquet", 1700000001000}}));
+    ASSERT_TRUE(FragmentResultCache::getKey("plan", "conf", {{"s3a://bucket/a.parquet", 1700000000000}}));
+}
+
+TEST(TestFragmentResultCache, WriteAndRead)
+{
+    FragmentResultCache cache(1 << 20, 1 << 16);
+    DB::Block block({DB::ColumnWithTypeAndName(DB::ColumnInt64::create(), std::make_shared<DB::DataTypeInt64>(), "a")});
+    auto column = DB::ColumnInt64::create();
+    for (Int64 i = 0; i < 100; ++i)
+        column->insertValue(i);
+    block.getByPosition(0).column = std::move(column);
+
+    {
+        FragmentResultWriter writer(cache, 1);
+        writer.write(block);
+        writer.write(block);
+        writer.finish();
+    }
+    auto entry = cache.get(1);
+    ASSERT_TRUE(entry);
+    FragmentResultReader reader(entry);
+    size_t rows = 0;
+    for (auto read_block = reader.read(); read_block.columns(); read_block = reader.read())
+    {
+        ASSERT_EQ(read_block.getByPosition(0).column->getInt(read_block.rows() - 1), 99);
+        rows += read_block.rows();
+    }
+    ASSERT_EQ(rows, 200);
+
+    /// Not finished.
+    {
+        FragmentResultWriter writer(cache, 2);
+        writer.write(block);
+    }
+    ASSERT_FALSE(cache.get(2));
+
+    /// Over the size of an entry.
+    FragmentResultCache small_cache(1 << 20, 64);
+    {
+        FragmentResultWriter writer(small_cache, 3);
+        writer.write(block);
+        writer.finish();
+    }
+    ASSERT_FALSE(small_cache.get(3));
+}
+
+class LocalDirSelectorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        for (size_t i = 0; i < 2; ++i)
+        {
+            auto dir = std::filesystem::temp_directory_path() / ("local_dir_selector_" + std::to_string(i));
+            std::filesystem::create_directories(dir);
+            dirs.push_back(dir.string());
+        }
+    }
+
+    void TearDown() override
+    {
+        for (const auto & dir : dirs)
+            std::filesystem::remove_all(dir);
+    }
+
+    static constexpr size_t write_bytes = 4 << 20;
+
+    LocalDirSelector selector;
+    std::vector<std::string> dirs;
+};
+
+TEST_F(LocalDirSelectorTest, RoundRobinWhenIdle)
+{
+    auto first = selector.select(dirs, write_bytes);
+    ASSERT_NE(selector.select(dirs, write_bytes), first);
+    ASSERT_EQ(selector.select(dirs, write_bytes), first);
+}
+
+TEST_F(LocalDirSelectorTest, AvoidOutstandingWrites)
+{
+    selector.beginWrite(dirs[0], write_bytes);
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(selector.select(dirs, write_bytes), 1);
+    selector.endWrite(dirs[0], write_bytes, write_bytes, true);
+    /// Equally loaded again.
+    auto first = selector.select(dirs, write_bytes);
+    ASSERT_NE(selector.select(dirs, write_bytes), first);
+}
+
+TEST_F(LocalDirSelectorTest, PreferFasterDir)
+{
+    selector.beginWrite(dirs[0], write_bytes);
+    selector.endWrite(dirs[0], write_bytes, write_bytes, true);
+    selector.beginWrite(dirs[1], write_bytes);
+    selector.endWrite(dirs[1], write_bytes, 4 * write_bytes, true);
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(selector.select(dirs, write_bytes), 0);
+    /// A large write in flight on the fast dir makes the slow one cheaper.
+    selector.beginWrite(dirs[0], 4 * write_bytes);
+    ASSERT_EQ(selector.select(dirs, write_bytes), 1);
+}
+
+TEST_F(LocalDirSelectorTest, BackoffFailedOrSlowDir)
+{
+    selector.beginWrite(dirs[1], write_bytes);
+    selector.endWrite(dirs[1], write_bytes, 0, false);
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(selector.select(dirs, write_bytes), 0);
+
+    /// 16 times slower per byte than dir 1 once it's back, even with dir 1 loaded.
+    LocalDirSelector slow_selector;
+    slow_selector.beginWrite(dirs[1], write_bytes);
+    slow_selector.endWrite(dirs[1], write_bytes, write_bytes, true);
+    slow_selector.beginWrite(dirs[0], write_bytes);
+    slow_selector.endWrite(dirs[0], write_bytes, 16 * write_bytes, true);
+    slow_selector.beginWrite(dirs[1], 16 * write_bytes);
+    for (size_t i = 0; i < 4; ++i)
+        ASSERT_EQ(slow_selector.select(dirs, write_bytes), 1);
+}
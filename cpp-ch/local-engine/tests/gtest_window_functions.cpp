@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Interpreters/WindowDescription.h>
+#include <Interpreters/concatenateBlocks.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
+#include <Processors/Sources/SourceFromChunks.h>
+#include <Processors/Transforms/WindowTransform.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <gtest/gtest.h>
+
+using namespace DB;
+
+namespace
+{
+/// The rows sorted by the partition p and the order n, with the arguments x Nullable(Int64) and y Int32.
+Block makeInput(const std::vector<size_t> & partition_sizes)
+{
+    auto p = ColumnUInt64::create();
+    auto n = ColumnUInt64::create();
+    auto x = ColumnNullable::create(ColumnInt64::create(), ColumnUInt8::create());
+    auto y = ColumnInt32::create();
+    for (size_t partition = 0; partition < partition_sizes.size(); ++partition)
+    {
+        for (size_t row = 0; row < partition_sizes[partition]; ++row)
+        {
+            p->insertValue(partition);
+            n->insertValue(row);
+            /// Some NULLs, a partition of NULLs only, and values whose sums overflow.
+            if (partition == 5 || row % 3 == 1)
+                x->insertDefault();
+            else if (row % 2 == 0)
+                x->insert(std::numeric_limits<Int64>::max() - static_cast<Int64>(row));
+            else
+                x->insert(std::numeric_limits<Int64>::min() + static_cast<Int64>(row * 7));
+            y->insertValue(row % 2 == 0 ? std::numeric_limits<Int32>::max() - static_cast<Int32>(row) : -static_cast<Int32>(row));
+        }
+    }
+    return Block{
+        {std::move(p), std::make_shared<DataTypeUInt64>(), "p"},
+        {std::move(n), std::make_shared<DataTypeUInt64>(), "n"},
+        {std::move(x), makeNullable(std::make_shared<DataTypeInt64>()), "x"},
+        {std::move(y), std::make_shared<DataTypeInt32>(), "y"}};
+}
+
+WindowFrame makeRowsFrame(
+    UInt64 begin_offset, bool begin_preceding, WindowFrame::BoundaryType end_type, UInt64 end_offset, bool end_preceding)
+{
+    WindowFrame frame;
+    frame.is_default = false;
+    frame.type = WindowFrame::FrameType::ROWS;
+    frame.begin_type = WindowFrame::BoundaryType::Offset;
+    frame.begin_offset = begin_offset;
+    frame.begin_preceding = begin_preceding;
+    frame.end_type = end_type;
+    frame.end_offset = end_offset;
+    frame.end_preceding = end_preceding;
+    return frame;
+}
+
+WindowFunctionDescription makeFunction(const String & name, const Block & input, const String & argument)
+{
+    WindowFunctionDescription description;
+    description.column_name = name + "(" + argument + ")";
+    description.function_node = nullptr;
+    description.argument_names = {argument};
+    description.argument_types = {input.getByName(argument).type};
+    AggregateFunctionProperties properties;
+    description.aggregate_function = AggregateFunctionFactory::instance().get(name, description.argument_types, {}, properties);
+    return description;
+}
+
+/// Runs the window over chunks of rows_per_chunk rows of the input, the frames spanning several of them.
+Block runWindow(
+    const Block & input, const WindowFrame & frame, const std::vector<WindowFunctionDescription> & functions, size_t rows_per_chunk)
+{
+    WindowDescription description;
+    description.partition_by = {SortColumnDescription("p", 1, 1)};
+    description.order_by = {SortColumnDescription("n", 1, 1)};
+    description.full_sort_description = description.partition_by;
+    description.full_sort_description.insert(
+        description.full_sort_description.end(), description.order_by.begin(), description.order_by.end());
+    description.frame = frame;
+    description.window_functions = functions;
+
+    Block output_header = input.cloneEmpty();
+    for (const auto & function : functions)
+        output_header.insert({function.aggregate_function->getResultType(), function.column_name});
+
+    Chunks chunks;
+    for (size_t offset = 0; offset < input.rows(); offset += rows_per_chunk)
+    {
+        const size_t length = std::min(rows_per_chunk, input.rows() - offset);
+        Columns columns;
+        for (const auto & column : input.getColumns())
+            columns.emplace_back(column->cut(offset, length));
+        chunks.emplace_back(std::move(columns), length);
+    }
+
+    QueryPipelineBuilder builder;
+    builder.init(Pipe(std::make_shared<SourceFromChunks>(input.cloneEmpty(), std::move(chunks))));
+    builder.addSimpleTransform([&](const Block & header)
+                               { return std::make_shared<WindowTransform>(header, output_header, description, functions); });
+    auto pipeline = QueryPipelineBuilder::getPipeline(std::move(builder));
+    PullingPipelineExecutor executor(pipeline);
+    Blocks blocks;
+    Block block;
+    while (executor.pull(block))
+        if (block.rows())
+            blocks.emplace_back(std::move(block));
+    return concatenateBlocks(blocks);
+}
+}
+
+/// The sliding frame functions give the results of the aggregate functions computed over each frame by WindowTransform.
+TEST(WindowFunctionSlidingFrame, MatchesWindowTransform)
+{
+    /// Partitions shorter and longer than the frames, which slide past their start and end.
+    const Block input = makeInput({1, 2, 5, 9, 1, 4, 12});
+    const std::vector<WindowFrame> frames = {
+        makeRowsFrame(2, true, WindowFrame::BoundaryType::Current, 0, false),
+        makeRowsFrame(3, true, WindowFrame::BoundaryType::Offset, 1, true),
+        makeRowsFrame(1, true, WindowFrame::BoundaryType::Offset, 2, false),
+        makeRowsFrame(1, false, WindowFrame::BoundaryType::Offset, 3, false),
+        makeRowsFrame(2, true, WindowFrame::BoundaryType::Unbounded, 0, false),
+    };
+    const std::vector<std::pair<String, String>> functions = {
+        {"sum", "slidingSumInFrame"}, {"count", "slidingCountInFrame"}, {"min", "slidingMinInFrame"}, {"max", "slidingMaxInFrame"}};
+
+    for (const auto & frame : frames)
+    {
+        for (const auto & argument : {"x", "y"})
+        {
+            for (const auto & [stock, sliding] : functions)
+            {
+                SCOPED_TRACE(frame.toString() + " " + sliding + "(" + argument + ")");
+                const auto stock_function = makeFunction(stock, input, argument);
+                const auto sliding_function = makeFunction(sliding, input, argument);
+                const auto & result_type = stock_function.aggregate_function->getResultType();
+                ASSERT_TRUE(result_type->equals(*sliding_function.aggregate_function->getResultType()));
+                for (size_t rows_per_chunk : {3, 64})
+                {
+                    const auto result = runWindow(input, frame, {stock_function, sliding_function}, rows_per_chunk);
+                    ASSERT_EQ(result.rows(), input.rows());
+                    const auto & expected = *result.getByName(stock_function.column_name).column;
+                    const auto & actual = *result.getByName(sliding_function.column_name).column;
+                    for (size_t row = 0; row < result.rows(); ++row)
+                        ASSERT_TRUE(expected[row] == actual[row])
+                            << "row " << row << ": " << expected[row].dump() << " != " << actual[row].dump();
+                }
+            }
+        }
+    }
+}
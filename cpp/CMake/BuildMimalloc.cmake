@@ -0,0 +1,59 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+include(ExternalProject)
+
+macro(build_mimalloc)
+  message(STATUS "Building mimalloc from source")
+  set(MIMALLOC_BUILD_VERSION "v2.1.2")
+  set(MIMALLOC_SOURCE_URL
+          "https://github.com/microsoft/mimalloc/archive/refs/tags/${MIMALLOC_BUILD_VERSION}.tar.gz")
+  set(MIMALLOC_PREFIX "${CMAKE_CURRENT_BINARY_DIR}/mimalloc_ep-install")
+  set(MIMALLOC_INCLUDE_DIR "${MIMALLOC_PREFIX}/include")
+  set(MIMALLOC_STATIC_LIB
+          "${MIMALLOC_PREFIX}/lib/${CMAKE_STATIC_LIBRARY_PREFIX}mimalloc${CMAKE_STATIC_LIBRARY_SUFFIX}")
+  # Don't override malloc of the process, only the mi_ API is used.
+  set(MIMALLOC_CMAKE_ARGS
+          "-DCMAKE_INSTALL_PREFIX=${MIMALLOC_PREFIX}"
+          "-DCMAKE_BUILD_TYPE=Release"
+          "-DCMAKE_POSITION_INDEPENDENT_CODE=ON"
+          "-DMI_OVERRIDE=OFF"
+          "-DMI_BUILD_SHARED=OFF"
+          "-DMI_BUILD_OBJECT=OFF"
+          "-DMI_BUILD_TESTS=OFF"
+          "-DMI_INSTALL_TOPLEVEL=ON")
+  ExternalProject_Add(mimalloc_ep
+          PREFIX ${MIMALLOC_PREFIX}
+          URL ${MIMALLOC_SOURCE_URL}
+          CMAKE_ARGS ${MIMALLOC_CMAKE_ARGS}
+          BUILD_BYPRODUCTS ${MIMALLOC_STATIC_LIB})
+
+  # The include directory must exist before it is referenced by a target.
+  file(MAKE_DIRECTORY "${MIMALLOC_INCLUDE_DIR}")
+
+  add_library(mimalloc::mimalloc STATIC IMPORTED)
+  set_target_properties(mimalloc::mimalloc
+          PROPERTIES IMPORTED_LOCATION
+          "${MIMALLOC_STATIC_LIB}"
+          INTERFACE_INCLUDE_DIRECTORIES
+          "${MIMALLOC_INCLUDE_DIR}")
+  target_link_libraries(mimalloc::mimalloc INTERFACE pthread)
+
+  add_dependencies(mimalloc::mimalloc mimalloc_ep)
+endmacro()
+
+build_mimalloc()
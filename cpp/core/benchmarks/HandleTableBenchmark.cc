@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "jni/ConcurrentMap.h"
+
+namespace {
+
+// The single lock handle table the JNI layer used before being sharded.
+template <typename Holder>
+class GlobalLockMap {
+ public:
+  jlong insert(Holder holder) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    jlong result = moduleId_++;
+    map_.insert(std::pair<jlong, Holder>(result, std::move(holder)));
+    return result;
+  }
+
+  void erase(jlong moduleId) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    map_.erase(moduleId);
+  }
+
+  Holder lookup(jlong moduleId) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = map_.find(moduleId);
+    if (it != map_.end()) {
+      return it->second;
+    }
+    return nullptr;
+  }
+
+ private:
+  jlong moduleId_ = 4;
+  std::mutex mtx_;
+  std::unordered_map<jlong, Holder> map_;
+};
+
+constexpr int kNumHandles = 1024;
+
+// Every thread looks up its own handles, as concurrent tasks do for their iterators and batches.
+template <typename Map>
+void lookup(benchmark::State& state) {
+  static Map* map;
+  static std::vector<jlong> handles;
+  if (state.thread_index() == 0) {
+    map = new Map();
+    handles.clear();
+    for (int i = 0; i < kNumHandles; ++i) {
+      handles.push_back(map->insert(std::make_shared<int>(i)));
+    }
+  }
+  auto i = state.thread_index();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->lookup(handles[i % kNumHandles]));
+    i += state.threads();
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete map;
+  }
+}
+
+// One insert, lookup and erase per batch, like the batch handles exported to Java.
+template <typename Map>
+void insertLookupErase(benchmark::State& state) {
+  static Map* map;
+  if (state.thread_index() == 0) {
+    map = new Map();
+  }
+  auto holder = std::make_shared<int>(0);
+  for (auto _ : state) {
+    auto handle = map->insert(holder);
+    benchmark::DoNotOptimize(map->lookup(handle));
+    map->erase(handle);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete map;
+  }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(lookup, GlobalLockMap<std::shared_ptr<int>>)->Threads(1)->Threads(8)->Threads(32);
+BENCHMARK_TEMPLATE(lookup, gluten::ConcurrentMap<std::shared_ptr<int>>)->Threads(1)->Threads(8)->Threads(32);
+BENCHMARK_TEMPLATE(insertLookupErase, GlobalLockMap<std::shared_ptr<int>>)->Threads(1)->Threads(8)->Threads(32);
+BENCHMARK_TEMPLATE(insertLookupErase, gluten::ConcurrentMap<std::shared_ptr<int>>)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32);
+
+BENCHMARK_MAIN();
@@ -102,6 +102,15 @@ class Backend : public std::enable_shared_from_this<Backend> {
     throw GlutenException("Not implement getDatasource");
   }
 
+  // Splits a batch sorted by the partition columns, and the bucket column last if hasBucket, into its runs of rows of
+  // the same partition and bucket.
+  virtual std::shared_ptr<BlockStripes> splitBlockByPartitionAndBucket(
+      std::shared_ptr<ColumnarBatch> batch,
+      const std::vector<int32_t>& partitionColIndice,
+      bool hasBucket) {
+    throw GlutenException("Not implement splitBlockByPartitionAndBucket");
+  }
+
   virtual std::shared_ptr<Reader> getShuffleReader(
       std::shared_ptr<arrow::io::InputStream> in,
       std::shared_ptr<arrow::Schema> schema,
@@ -117,6 +126,12 @@ class Backend : public std::enable_shared_from_this<Backend> {
     throw GlutenException("Not implement getColumnarBatchSerializer");
   }
 
+  /// Concatenates batches of the same row count side by side. Backends override it to build their native batch
+  /// referencing the columns of the inputs, instead of a CompositeColumnarBatch that is exported to compose.
+  virtual std::shared_ptr<ColumnarBatch> composeColumnarBatches(std::vector<std::shared_ptr<ColumnarBatch>> batches) {
+    return CompositeColumnarBatch::create(std::move(batches));
+  }
+
   std::unordered_map<std::string, std::string> getConfMap() {
     return confMap_;
   }
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PrefetchingColumnarBatchIterator.h"
+
+#include <algorithm>
+
+namespace gluten {
+
+PrefetchingColumnarBatchIterator::PrefetchingColumnarBatchIterator(
+    std::unique_ptr<ColumnarBatchIterator> iter,
+    int32_t capacity,
+    std::function<void()> onThreadExit)
+    : iter_(std::move(iter)), capacity_(std::max(1, capacity)), onThreadExit_(std::move(onThreadExit)) {}
+
+PrefetchingColumnarBatchIterator::~PrefetchingColumnarBatchIterator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  notFull_.notify_all();
+  if (thread_.joinable()) {
+    // Waits for the batch being fetched, if any.
+    thread_.join();
+  }
+}
+
+std::shared_ptr<ColumnarBatch> PrefetchingColumnarBatchIterator::next() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  startLocked();
+  notEmpty_.wait(lock, [this] { return readyLocked(); });
+  if (!queue_.empty()) {
+    auto batch = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    notFull_.notify_one();
+    return batch;
+  }
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  return nullptr;
+}
+
+bool PrefetchingColumnarBatchIterator::isReady(const std::function<void()>& onReady) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  startLocked();
+  if (readyLocked()) {
+    return true;
+  }
+  if (onReady) {
+    onReady_ = onReady;
+  }
+  return false;
+}
+
+void PrefetchingColumnarBatchIterator::startLocked() {
+  if (!thread_.joinable() && !finished_) {
+    thread_ = std::thread([this] { run(); });
+  }
+}
+
+void PrefetchingColumnarBatchIterator::run() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      notFull_.wait(lock, [this] { return closed_ || queue_.size() < capacity_; });
+      if (closed_) {
+        break;
+      }
+    }
+
+    std::shared_ptr<ColumnarBatch> batch;
+    std::exception_ptr error;
+    try {
+      batch = iter_->next();
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    std::function<void()> onReady;
+    bool finished;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (batch != nullptr) {
+        queue_.push_back(std::move(batch));
+      } else {
+        finished_ = true;
+        error_ = error;
+      }
+      finished = finished_;
+      onReady = std::move(onReady_);
+      onReady_ = nullptr;
+    }
+    notEmpty_.notify_one();
+    if (onReady) {
+      onReady();
+    }
+    if (finished) {
+      break;
+    }
+  }
+  if (onThreadExit_) {
+    onThreadExit_();
+  }
+}
+
+} // namespace gluten
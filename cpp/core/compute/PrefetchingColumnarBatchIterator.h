@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "memory/ColumnarBatchIterator.h"
+
+namespace gluten {
+
+// Fetches up to capacity batches ahead from the wrapped iterator on a background thread, so that the consumer doesn't
+// wait on a slow producer, e.g. a Java iterator reading shuffle data, as long as the producer keeps up on average.
+// The background thread is started by the first call to next() or isReady().
+class PrefetchingColumnarBatchIterator final : public ColumnarBatchIterator {
+ public:
+  // onThreadExit is called on the background thread before it exits, e.g. to detach it from the JVM.
+  PrefetchingColumnarBatchIterator(
+      std::unique_ptr<ColumnarBatchIterator> iter,
+      int32_t capacity,
+      std::function<void()> onThreadExit = nullptr);
+
+  ~PrefetchingColumnarBatchIterator() override;
+
+  // Blocks until a batch is fetched. Exceptions of the wrapped iterator are rethrown after the batches fetched before.
+  std::shared_ptr<ColumnarBatch> next() override;
+
+  bool isReady(const std::function<void()>& onReady) override;
+
+  int64_t spillFixedSize(int64_t size) override {
+    return iter_->spillFixedSize(size);
+  }
+
+ private:
+  void startLocked();
+
+  void run();
+
+  bool readyLocked() const {
+    return !queue_.empty() || finished_;
+  }
+
+  const std::unique_ptr<ColumnarBatchIterator> iter_;
+  const size_t capacity_;
+  const std::function<void()> onThreadExit_;
+
+  std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+  std::deque<std::shared_ptr<ColumnarBatch>> queue_;
+  // The wrapped iterator ended or threw.
+  bool finished_ = false;
+  std::exception_ptr error_;
+  bool closed_ = false;
+  std::function<void()> onReady_;
+  std::thread thread_;
+};
+
+} // namespace gluten
@@ -42,6 +42,12 @@ class ResultIterator {
     return std::move(next_);
   }
 
+  // True if hasNext() and next() won't block. See ColumnarBatchIterator::isReady.
+  bool isReady(const std::function<void()>& onReady) {
+    checkValid();
+    return next_ != nullptr || iter_->isReady(onReady);
+  }
+
   // For testing and benchmarking.
   ColumnarBatchIterator* getInputIter() {
     return iter_.get();
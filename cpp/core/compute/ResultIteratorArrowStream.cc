@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ResultIteratorArrowStream.h"
+
+#include <arrow/c/bridge.h>
+#include <arrow/record_batch.h>
+
+#include "utils/ArrowStatus.h"
+
+namespace gluten {
+
+namespace {
+class ResultIteratorReader final : public arrow::RecordBatchReader {
+ public:
+  explicit ResultIteratorReader(std::shared_ptr<ResultIterator> iter) : iter_(std::move(iter)) {}
+
+  // Of the first batch, pulled ahead if needed.
+  std::shared_ptr<arrow::Schema> schema() const override {
+    if (schema_ == nullptr) {
+      // Reported again by ReadNext if failed.
+      schemaStatus_ = readSchema();
+      if (!schemaStatus_.ok()) {
+        return arrow::schema({});
+      }
+    }
+    return schema_;
+  }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    *batch = nullptr;
+    if (schema_ == nullptr) {
+      ARROW_RETURN_NOT_OK(schemaStatus_);
+      ARROW_RETURN_NOT_OK(readSchema());
+    }
+    try {
+      auto next = std::move(first_);
+      if (next == nullptr) {
+        next = iter_->hasNext() ? iter_->next() : nullptr;
+      }
+      if (next == nullptr) {
+        return arrow::Status::OK();
+      }
+      auto cArray = next->exportArrowArray();
+      iter_->setExportNanos(next->getExportNanos());
+      ARROW_ASSIGN_OR_RAISE(*batch, arrow::ImportRecordBatch(cArray.get(), schema_));
+      return arrow::Status::OK();
+    } catch (const std::exception& e) {
+      return arrow::Status::Invalid(e.what());
+    }
+  }
+
+ private:
+  arrow::Status readSchema() const {
+    try {
+      if (!iter_->hasNext()) {
+        schema_ = arrow::schema({});
+        return arrow::Status::OK();
+      }
+      first_ = iter_->next();
+      auto cSchema = first_->exportArrowSchema();
+      ARROW_ASSIGN_OR_RAISE(schema_, arrow::ImportSchema(cSchema.get()));
+      return arrow::Status::OK();
+    } catch (const std::exception& e) {
+      return arrow::Status::Invalid(e.what());
+    }
+  }
+
+  std::shared_ptr<ResultIterator> iter_;
+  // The first batch once pulled for the schema, until read.
+  mutable std::shared_ptr<ColumnarBatch> first_;
+  mutable std::shared_ptr<arrow::Schema> schema_;
+  mutable arrow::Status schemaStatus_;
+};
+} // namespace
+
+void exportToArrowStream(std::shared_ptr<ResultIterator> iter, struct ArrowArrayStream* out) {
+  arrowAssertOkOrThrow(arrow::ExportRecordBatchReader(std::make_shared<ResultIteratorReader>(std::move(iter)), out));
+}
+
+} // namespace gluten
@@ -0,0 +1,31 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <arrow/c/abi.h>
+
+#include "compute/ResultIterator.h"
+
+namespace gluten {
+
+/// Exports the iterator as an Arrow C stream, so that consumers pull its batches in native code, e.g. Arrow based
+/// python workers, with no trip through the JVM per batch. The stream keeps the iterator alive until released and
+/// takes over its batches: the iterator shouldn't be read besides. The schema of the stream is the one of the first
+/// batch, an empty struct if there's none.
+void exportToArrowStream(std::shared_ptr<ResultIterator> iter, struct ArrowArrayStream* out);
+
+} // namespace gluten
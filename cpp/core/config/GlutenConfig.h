@@ -37,6 +37,15 @@ const std::string kSparkTaskOffHeapMemory = "spark.gluten.memory.task.offHeap.si
 
 const std::string kSparkBatchSize = "spark.gluten.sql.columnar.maxBatchSize";
 
+// Number of batches fetched ahead from each Java input iterator on a background thread, 0 disables prefetching.
+const std::string kInputPrefetchBatches = "spark.gluten.sql.columnar.inputPrefetchBatches";
+
+// Mean bytes between two allocations sampled by AllocationProfiler, 0 disables it.
+const std::string kAllocationProfilerSampleInterval = "spark.gluten.memory.allocationProfiler.sampleInterval";
+
+// Bytes of high bandwidth memory the executor may use with HbwMemoryAllocator.
+const std::string kHbmCapacity = "spark.gluten.memory.hbm.capacity";
+
 const std::string kParquetBlockSize = "parquet.block.size";
 
 const std::string kParquetBlockRows = "parquet.block.rows";
@@ -18,6 +18,8 @@
 #pragma once
 
 #include <jni.h>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -27,6 +29,8 @@ namespace gluten {
 
 /**
  * An utility class that map module id to module pointers.
+ * Module ids are spread over shards, each guarded by its own lock, so that concurrent calls for different modules
+ * don't contend. Ids are handed out by an atomic counter.
  * @tparam Holder class of the object to hold.
  */
 template <typename Holder>
@@ -35,34 +39,43 @@ class ConcurrentMap {
   ConcurrentMap() : moduleId_(kInitModuleId) {}
 
   jlong insert(Holder holder) {
-    std::lock_guard<std::mutex> lock(mtx_);
     jlong result = moduleId_++;
-    map_.insert(std::pair<jlong, Holder>(result, holder));
+    auto& shard = shardOf(result);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    shard.map.insert(std::pair<jlong, Holder>(result, std::move(holder)));
     return result;
   }
 
   void erase(jlong moduleId) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    map_.erase(moduleId);
+    auto& shard = shardOf(moduleId);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    shard.map.erase(moduleId);
   }
 
   Holder lookup(jlong moduleId) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    auto it = map_.find(moduleId);
-    if (it != map_.end()) {
+    auto& shard = shardOf(moduleId);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.map.find(moduleId);
+    if (it != shard.map.end()) {
       return it->second;
     }
     return nullptr;
   }
 
   void clear() {
-    std::lock_guard<std::mutex> lock(mtx_);
-    map_.clear();
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      shard.map.clear();
+    }
   }
 
   size_t size() {
-    std::lock_guard<std::mutex> lock(mtx_);
-    return map_.size();
+    size_t size = 0;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      size += shard.map.size();
+    }
+    return size;
   }
 
  private:
@@ -70,11 +83,23 @@ class ConcurrentMap {
   // to allow for easier debugging of uninitialized java variables.
   static constexpr int kInitModuleId = 4;
 
-  int64_t moduleId_;
-  std::mutex mtx_;
+  // More than the task threads of an executor, so that consecutive ids, e.g. the batches of concurrent tasks, land on
+  // different shards.
+  static constexpr int kNumShards = 64;
+
+  // On its own cache line to avoid false sharing between the locks.
+  struct alignas(64) Shard {
+    std::mutex mtx;
+    // map from module ids returned to Java and module pointers
+    std::unordered_map<jlong, Holder> map;
+  };
+
+  Shard& shardOf(jlong moduleId) {
+    return shards_[static_cast<uint64_t>(moduleId) % kNumShards];
+  }
 
-  // map from module ids returned to Java and module pointers
-  std::unordered_map<jlong, Holder> map_;
+  std::atomic<int64_t> moduleId_;
+  std::array<Shard, kNumShards> shards_;
 };
 
 } // namespace gluten
@@ -213,7 +213,15 @@ class SparkAllocationListener final : public gluten::AllocationListener {
       return;
     }
     env->CallObjectMethod(javaListener_, javaReserveMethod_, granted);
-    checkException(env);
+    try {
+      checkException(env);
+    } catch (const gluten::GlutenException&) {
+      // Nothing was reserved so the caller is able to retry, e.g. after reclaiming memory from other tasks.
+      std::lock_guard<std::mutex> lock(mutex_);
+      bytesReserved_ -= diff;
+      blocksReserved_ -= granted / blockSize_;
+      throw;
+    }
   }
 
   JavaVM* vm_;
@@ -234,8 +242,14 @@ class RssClient {
 
 class CelebornClient : public RssClient {
  public:
-  CelebornClient(JavaVM* vm, jobject javaCelebornShuffleWriter, jmethodID javaCelebornPushPartitionDataMethod)
-      : vm_(vm), javaCelebornPushPartitionData_(javaCelebornPushPartitionDataMethod) {
+  CelebornClient(
+      JavaVM* vm,
+      jobject javaCelebornShuffleWriter,
+      jmethodID javaCelebornPushPartitionDataMethod,
+      jmethodID javaCelebornPushPartitionsDataMethod)
+      : vm_(vm),
+        javaCelebornPushPartitionData_(javaCelebornPushPartitionDataMethod),
+        javaCelebornPushPartitionsData_(javaCelebornPushPartitionsDataMethod) {
     JNIEnv* env;
     if (vm_->GetEnv(reinterpret_cast<void**>(&env), jniVersion) != JNI_OK) {
       throw gluten::GlutenException("JNIEnv was not attached to current thread");
@@ -244,7 +258,10 @@ class CelebornClient : public RssClient {
     javaCelebornShuffleWriter_ = env->NewGlobalRef(javaCelebornShuffleWriter);
   }
 
-  ~CelebornClient() {
+  ~CelebornClient() override {
+    if (vm_ == nullptr) {
+      return;
+    }
     JNIEnv* env;
     if (vm_->GetEnv(reinterpret_cast<void**>(&env), jniVersion) != JNI_OK) {
       std::cerr << "CelebornClient#~CelebornClient(): "
@@ -254,7 +271,7 @@ class CelebornClient : public RssClient {
     env->DeleteGlobalRef(javaCelebornShuffleWriter_);
   }
 
-  int32_t pushPartitonData(int32_t partitionId, char* bytes, int64_t size) {
+  virtual int32_t pushPartitonData(int32_t partitionId, char* bytes, int64_t size) {
     JNIEnv* env;
     if (vm_->GetEnv(reinterpret_cast<void**>(&env), jniVersion) != JNI_OK) {
       throw gluten::GlutenException("JNIEnv was not attached to current thread");
@@ -267,7 +284,41 @@ class CelebornClient : public RssClient {
     return static_cast<int32_t>(celebornBytesSize);
   }
 
-  JavaVM* vm_;
+  // Push consecutive segments of bytes, segment i belonging to partitionIds[i], in one call. Can be called from
+  // threads not attached to the JVM. Returns the bytes Celeborn accounted for each segment.
+  virtual std::vector<int32_t> pushPartitionsData(
+      const std::vector<int32_t>& partitionIds,
+      const std::vector<int32_t>& lengths,
+      const uint8_t* bytes,
+      int64_t size) {
+    JNIEnv* env;
+    attachCurrentThreadAsDaemonOrThrow(vm_, &env);
+    auto numSegments = static_cast<jsize>(partitionIds.size());
+    jintArray idArray = env->NewIntArray(numSegments);
+    env->SetIntArrayRegion(idArray, 0, numSegments, reinterpret_cast<const jint*>(partitionIds.data()));
+    jintArray lengthArray = env->NewIntArray(numSegments);
+    env->SetIntArrayRegion(lengthArray, 0, numSegments, reinterpret_cast<const jint*>(lengths.data()));
+    jbyteArray array = env->NewByteArray(size);
+    env->SetByteArrayRegion(array, 0, size, reinterpret_cast<const jbyte*>(bytes));
+    auto pushedArray = static_cast<jintArray>(env->CallObjectMethod(
+        javaCelebornShuffleWriter_, javaCelebornPushPartitionsData_, idArray, lengthArray, array));
+    // Local references are never released on natively attached threads.
+    env->DeleteLocalRef(idArray);
+    env->DeleteLocalRef(lengthArray);
+    env->DeleteLocalRef(array);
+    checkException(env);
+    std::vector<int32_t> pushed(numSegments);
+    env->GetIntArrayRegion(pushedArray, 0, numSegments, reinterpret_cast<jint*>(pushed.data()));
+    env->DeleteLocalRef(pushedArray);
+    return pushed;
+  }
+
+  JavaVM* vm_ = nullptr;
   jobject javaCelebornShuffleWriter_;
   jmethodID javaCelebornPushPartitionData_;
+  jmethodID javaCelebornPushPartitionsData_;
+
+ protected:
+  // For clients pushing somewhere else than to the JVM, e.g. in tests.
+  CelebornClient() = default;
 };
@@ -17,13 +17,17 @@
 
 #include <jni.h>
 #include <filesystem>
+#include <fstream>
 
 #include "compute/Backend.h"
+#include "compute/PrefetchingColumnarBatchIterator.h"
 #include "compute/ProtobufUtils.h"
+#include "compute/ResultIteratorArrowStream.h"
 #include "config/GlutenConfig.h"
 #include "jni/ConcurrentMap.h"
 #include "jni/JniCommon.h"
 #include "jni/JniErrors.h"
+#include "memory/AllocationProfiler.h"
 
 #include "operators/writer/Datasource.h"
 
@@ -46,6 +50,8 @@ static jclass javaReservationListenerClass;
 
 static jmethodID reserveMemoryMethod;
 static jmethodID unreserveMemoryMethod;
+// Granularity of memory reserved from Spark.
+static constexpr int64_t kReservationBlockSize = 8L << 20;
 
 static jclass byteArrayClass;
 
@@ -61,6 +67,8 @@ static jclass columnarBatchSerializeResultClass;
 static jmethodID columnarBatchSerializeResultConstructor;
 
 static jclass serializedColumnarBatchIteratorClass;
+static jclass stringClass;
+
 static jclass metricsBuilderClass;
 static jmethodID metricsBuilderConstructor;
 
@@ -76,6 +84,11 @@ static jmethodID veloxColumnarbatchScannerNext;
 
 static jclass shuffleReaderMetricsClass;
 static jmethodID shuffleReaderMetricsSetDecompressTime;
+static jmethodID shuffleReaderMetricsSetHardwareDecompressedBytes;
+static jmethodID shuffleReaderMetricsSetSoftwareDecompressedBytes;
+
+static jclass blockStripesClass;
+static jmethodID blockStripesConstructor;
 
 static ConcurrentMap<std::shared_ptr<ColumnarToRowConverter>> columnarToRowConverterHolder;
 
@@ -147,7 +160,9 @@ class JavaInputStreamAdaptor final : public arrow::io::InputStream {
   arrow::Result<int64_t> Tell() const override {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm_, &env);
-    return env->CallLongMethod(jniIn_, jniByteInputStreamTell);
+    auto position = env->CallLongMethod(jniIn_, jniByteInputStreamTell);
+    RETURN_NOT_OK(checkJavaException(env));
+    return position;
   }
 
   bool closed() const override {
@@ -157,7 +172,10 @@ class JavaInputStreamAdaptor final : public arrow::io::InputStream {
   arrow::Result<int64_t> Read(int64_t nbytes, void* out) override {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm_, &env);
-    return env->CallLongMethod(jniIn_, jniByteInputStreamRead, reinterpret_cast<jlong>(out), nbytes);
+    auto bytesRead = env->CallLongMethod(jniIn_, jniByteInputStreamRead, reinterpret_cast<jlong>(out), nbytes);
+    // The 0 returned along with an exception, e.g. of a failed fetch, isn't the end of the stream.
+    RETURN_NOT_OK(checkJavaException(env));
+    return bytesRead;
   }
 
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override {
@@ -169,6 +187,15 @@ class JavaInputStreamAdaptor final : public arrow::io::InputStream {
   }
 
  private:
+  static arrow::Status checkJavaException(JNIEnv* env) {
+    try {
+      checkException(env);
+    } catch (const gluten::GlutenException& e) {
+      return arrow::Status::IOError(e.what());
+    }
+    return arrow::Status::OK();
+  }
+
   std::shared_ptr<arrow::MemoryPool> pool_;
   JavaVM* vm_;
   jobject jniIn_;
@@ -261,17 +288,20 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   jniByteInputStreamClose = getMethodIdOrError(env, jniByteInputStreamClass, "close", "()V");
 
   splitResultClass = createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/SplitResult;");
-  splitResultConstructor = getMethodIdOrError(env, splitResultClass, "<init>", "(JJJJJJ[J[J)V");
+  splitResultConstructor =
+      getMethodIdOrError(env, splitResultClass, "<init>", "(JJJJJJ[J[J[Ljava/lang/String;[J[J)V");
 
   columnarBatchSerializeResultClass =
       createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/ColumnarBatchSerializeResult;");
   columnarBatchSerializeResultConstructor =
       getMethodIdOrError(env, columnarBatchSerializeResultClass, "<init>", "(J[B)V");
 
+  stringClass = createGlobalClassReferenceOrError(env, "Ljava/lang/String;");
+
   metricsBuilderClass = createGlobalClassReferenceOrError(env, "Lio/glutenproject/metrics/Metrics;");
 
   metricsBuilderConstructor =
-      getMethodIdOrError(env, metricsBuilderClass, "<init>", "([J[J[J[J[J[J[J[J[J[JJ[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J)V");
+      getMethodIdOrError(env, metricsBuilderClass, "<init>", "([Ljava/lang/String;Ljava/nio/ByteBuffer;JJ[Ljava/lang/String;[J)V");
 
   serializedColumnarBatchIteratorClass =
       createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/ColumnarBatchInIterator;");
@@ -304,6 +334,13 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
       createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/ShuffleReaderMetrics;");
   shuffleReaderMetricsSetDecompressTime =
       getMethodIdOrError(env, shuffleReaderMetricsClass, "setDecompressTime", "(J)V");
+  shuffleReaderMetricsSetHardwareDecompressedBytes =
+      getMethodIdOrError(env, shuffleReaderMetricsClass, "setHardwareDecompressedBytes", "(J)V");
+  shuffleReaderMetricsSetSoftwareDecompressedBytes =
+      getMethodIdOrError(env, shuffleReaderMetricsClass, "setSoftwareDecompressedBytes", "(J)V");
+
+  blockStripesClass = createGlobalClassReference(env, "Lorg/apache/spark/sql/execution/datasources/BlockStripes;");
+  blockStripesConstructor = getMethodId(env, blockStripesClass, "<init>", "(J[J[IIZ)V");
 
   return jniVersion;
 }
@@ -324,8 +361,10 @@ void JNI_OnUnload(JavaVM* vm, void* reserved) {
   env->DeleteGlobalRef(serializedColumnarBatchIteratorClass);
   env->DeleteGlobalRef(nativeColumnarToRowInfoClass);
   env->DeleteGlobalRef(byteArrayClass);
+  env->DeleteGlobalRef(stringClass);
   env->DeleteGlobalRef(veloxColumnarbatchScannerClass);
   env->DeleteGlobalRef(shuffleReaderMetricsClass);
+  env->DeleteGlobalRef(blockStripesClass);
 }
 
 JNIEXPORT jlong JNICALL
@@ -359,6 +398,15 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeCreateKernelWithI
 
   auto confs = getConfMap(env, confArr);
 
+  int32_t inputPrefetchBatches = 0;
+  if (confs.find(kInputPrefetchBatches) != confs.end()) {
+    inputPrefetchBatches = std::stoi(confs[kInputPrefetchBatches]);
+  }
+  JavaVM* vm;
+  if (env->GetJavaVM(&vm) != JNI_OK) {
+    throw gluten::GlutenException("Unable to get JavaVM instance");
+  }
+
   // Handle the Java iters
   jsize itersLen = env->GetArrayLength(iterArr);
   std::vector<std::shared_ptr<ResultIterator>> inputIters;
@@ -375,7 +423,11 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeCreateKernelWithI
       writer = std::make_shared<ArrowWriter>(file);
     }
     jobject iter = env->GetObjectArrayElement(iterArr, idx);
-    auto arrayIter = makeJniColumnarBatchIterator(env, iter, writer);
+    std::unique_ptr<ColumnarBatchIterator> arrayIter = makeJniColumnarBatchIterator(env, iter, writer);
+    if (inputPrefetchBatches > 0) {
+      arrayIter = std::make_unique<PrefetchingColumnarBatchIterator>(
+          std::move(arrayIter), inputPrefetchBatches, [vm]() { vm->DetachCurrentThread(); });
+    }
     auto resultIter = std::make_shared<ResultIterator>(std::move(arrayIter));
     inputIters.push_back(std::move(resultIter));
   }
@@ -388,6 +440,7 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeCreateKernelWithI
 JNIEXPORT jboolean JNICALL
 Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeHasNext(JNIEnv* env, jobject obj, jlong id) { // NOLINT
   JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("whole_stage");
   auto iter = getArrayIterator(env, id);
   if (iter == nullptr) {
     std::string errorMessage = "faked to get batch iterator";
@@ -400,6 +453,7 @@ Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeHasNext(JNIEnv*
 JNIEXPORT jlong JNICALL
 Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeNext(JNIEnv* env, jobject obj, jlong id) { // NOLINT
   JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("whole_stage");
   auto iter = getArrayIterator(env, id);
   if (!iter->hasNext()) {
     return -1L;
@@ -413,6 +467,39 @@ Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeNext(JNIEnv* env
   JNI_METHOD_END(-1L)
 }
 
+JNIEXPORT jint JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeNextBatch( // NOLINT
+    JNIEnv* env,
+    jobject obj,
+    jlong id,
+    jlongArray batchHandles,
+    jlong maxBytes) {
+  JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("whole_stage");
+  auto iter = getArrayIterator(env, id);
+  auto maxBatches = env->GetArrayLength(batchHandles);
+  std::vector<jlong> handles;
+  handles.reserve(maxBatches);
+  int64_t bytes = 0;
+  int64_t exportNanos = 0;
+  while (static_cast<jsize>(handles.size()) < maxBatches && iter->hasNext()) {
+    std::shared_ptr<ColumnarBatch> batch = iter->next();
+    exportNanos += batch->getExportNanos();
+    if (maxBytes > 0) {
+      bytes += batch->numBytes();
+    }
+    handles.push_back(columnarBatchHolder.insert(std::move(batch)));
+    if (maxBytes > 0 && bytes >= maxBytes) {
+      break;
+    }
+  }
+  if (!handles.empty()) {
+    env->SetLongArrayRegion(batchHandles, 0, handles.size(), handles.data());
+    iter->setExportNanos(exportNanos);
+  }
+  return handles.size();
+  JNI_METHOD_END(-1)
+}
+
 JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeFetchMetrics( // NOLINT
     JNIEnv* env,
     jobject obj,
@@ -421,96 +508,51 @@ JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutItera
   auto iter = getArrayIterator(env, id);
   std::shared_ptr<Metrics> metrics = iter->getMetrics();
 
-  int numMetrics = 0;
-  if (metrics) {
-    numMetrics = metrics->numMetrics;
+  const auto& names = metrics ? metrics->names() : Metrics::counterNames();
+  auto counterNames = env->NewObjectArray(names.size(), stringClass, nullptr);
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto name = env->NewStringUTF(names[i].c_str());
+    env->SetObjectArrayElement(counterNames, i, name);
+    env->DeleteLocalRef(name);
   }
-  auto inputRows = env->NewLongArray(numMetrics);
-  auto inputVectors = env->NewLongArray(numMetrics);
-  auto inputBytes = env->NewLongArray(numMetrics);
-  auto rawInputRows = env->NewLongArray(numMetrics);
-  auto rawInputBytes = env->NewLongArray(numMetrics);
-  auto outputRows = env->NewLongArray(numMetrics);
-  auto outputVectors = env->NewLongArray(numMetrics);
-  auto outputBytes = env->NewLongArray(numMetrics);
-  auto cpuCount = env->NewLongArray(numMetrics);
-  auto wallNanos = env->NewLongArray(numMetrics);
-  auto peakMemoryBytes = env->NewLongArray(numMetrics);
-  auto numMemoryAllocations = env->NewLongArray(numMetrics);
-  auto spilledBytes = env->NewLongArray(numMetrics);
-  auto spilledRows = env->NewLongArray(numMetrics);
-  auto spilledPartitions = env->NewLongArray(numMetrics);
-  auto spilledFiles = env->NewLongArray(numMetrics);
-  auto numDynamicFiltersProduced = env->NewLongArray(numMetrics);
-  auto numDynamicFiltersAccepted = env->NewLongArray(numMetrics);
-  auto numReplacedWithDynamicFilterRows = env->NewLongArray(numMetrics);
-  auto flushRowCount = env->NewLongArray(numMetrics);
-  auto scanTime = env->NewLongArray(numMetrics);
-  auto skippedSplits = env->NewLongArray(numMetrics);
-  auto processedSplits = env->NewLongArray(numMetrics);
-  auto skippedStrides = env->NewLongArray(numMetrics);
-  auto processedStrides = env->NewLongArray(numMetrics);
-
-  if (metrics) {
-    env->SetLongArrayRegion(inputRows, 0, numMetrics, metrics->inputRows);
-    env->SetLongArrayRegion(inputVectors, 0, numMetrics, metrics->inputVectors);
-    env->SetLongArrayRegion(inputBytes, 0, numMetrics, metrics->inputBytes);
-    env->SetLongArrayRegion(rawInputRows, 0, numMetrics, metrics->rawInputRows);
-    env->SetLongArrayRegion(rawInputBytes, 0, numMetrics, metrics->rawInputBytes);
-    env->SetLongArrayRegion(outputRows, 0, numMetrics, metrics->outputRows);
-    env->SetLongArrayRegion(outputVectors, 0, numMetrics, metrics->outputVectors);
-    env->SetLongArrayRegion(outputBytes, 0, numMetrics, metrics->outputBytes);
-    env->SetLongArrayRegion(cpuCount, 0, numMetrics, metrics->cpuCount);
-    env->SetLongArrayRegion(wallNanos, 0, numMetrics, metrics->wallNanos);
-    env->SetLongArrayRegion(peakMemoryBytes, 0, numMetrics, metrics->peakMemoryBytes);
-    env->SetLongArrayRegion(numMemoryAllocations, 0, numMetrics, metrics->numMemoryAllocations);
-    env->SetLongArrayRegion(spilledBytes, 0, numMetrics, metrics->spilledBytes);
-    env->SetLongArrayRegion(spilledRows, 0, numMetrics, metrics->spilledRows);
-    env->SetLongArrayRegion(spilledPartitions, 0, numMetrics, metrics->spilledPartitions);
-    env->SetLongArrayRegion(spilledFiles, 0, numMetrics, metrics->spilledFiles);
-    env->SetLongArrayRegion(numDynamicFiltersProduced, 0, numMetrics, metrics->numDynamicFiltersProduced);
-    env->SetLongArrayRegion(numDynamicFiltersAccepted, 0, numMetrics, metrics->numDynamicFiltersAccepted);
-    env->SetLongArrayRegion(numReplacedWithDynamicFilterRows, 0, numMetrics, metrics->numReplacedWithDynamicFilterRows);
-    env->SetLongArrayRegion(flushRowCount, 0, numMetrics, metrics->flushRowCount);
-    env->SetLongArrayRegion(scanTime, 0, numMetrics, metrics->scanTime);
-    env->SetLongArrayRegion(skippedSplits, 0, numMetrics, metrics->skippedSplits);
-    env->SetLongArrayRegion(processedSplits, 0, numMetrics, metrics->processedSplits);
-    env->SetLongArrayRegion(skippedStrides, 0, numMetrics, metrics->skippedStrides);
-    env->SetLongArrayRegion(processedStrides, 0, numMetrics, metrics->processedStrides);
+  // Java copies the counters out while constructing the object.
+  auto counters = metrics ? env->NewDirectByteBuffer(metrics->data(), metrics->byteSize())
+                          : env->NewDirectByteBuffer(nullptr, 0);
+
+  auto numTaskValues = metrics ? metrics->taskValues.size() : 0;
+  auto taskValueNames = env->NewObjectArray(numTaskValues, stringClass, nullptr);
+  auto taskValues = env->NewLongArray(numTaskValues);
+  for (size_t i = 0; i < numTaskValues; ++i) {
+    const auto& [name, value] = metrics->taskValues[i];
+    auto jname = env->NewStringUTF(name.c_str());
+    env->SetObjectArrayElement(taskValueNames, i, jname);
+    env->DeleteLocalRef(jname);
+    jlong jvalue = value;
+    env->SetLongArrayRegion(taskValues, i, 1, &jvalue);
   }
 
   return env->NewObject(
       metricsBuilderClass,
       metricsBuilderConstructor,
-      inputRows,
-      inputVectors,
-      inputBytes,
-      rawInputRows,
-      rawInputBytes,
-      outputRows,
-      outputVectors,
-      outputBytes,
-      cpuCount,
-      wallNanos,
+      counterNames,
+      counters,
       metrics ? metrics->veloxToArrow : -1,
-      peakMemoryBytes,
-      numMemoryAllocations,
-      spilledBytes,
-      spilledRows,
-      spilledPartitions,
-      spilledFiles,
-      numDynamicFiltersProduced,
-      numDynamicFiltersAccepted,
-      numReplacedWithDynamicFilterRows,
-      flushRowCount,
-      scanTime,
-      skippedSplits,
-      processedSplits,
-      skippedStrides,
-      processedStrides);
+      metrics ? metrics->arbitrationWaitNanos : 0,
+      taskValueNames,
+      taskValues);
   JNI_METHOD_END(nullptr)
 }
 
+JNIEXPORT void JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeExportToArrowStream( // NOLINT
+    JNIEnv* env,
+    jobject obj,
+    jlong id,
+    jlong cStream) {
+  JNI_METHOD_START
+  exportToArrowStream(getArrayIterator(env, id), reinterpret_cast<struct ArrowArrayStream*>(cStream));
+  JNI_METHOD_END()
+}
+
 JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeSpill( // NOLINT
     JNIEnv* env,
     jobject thisObj,
@@ -562,6 +604,7 @@ Java_io_glutenproject_vectorized_NativeColumnarToRowJniWrapper_nativeColumnarToR
     jlong batchHandle,
     jlong instanceId) {
   JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("columnar_to_row");
   auto columnarToRowConverter = columnarToRowConverterHolder.lookup(instanceId);
   std::shared_ptr<ColumnarBatch> cb = columnarBatchHolder.lookup(batchHandle);
   columnarToRowConverter->convert(cb);
@@ -619,6 +662,7 @@ Java_io_glutenproject_vectorized_NativeRowToColumnarJniWrapper_nativeConvertRowT
     jlongArray rowLength,
     jlong memoryAddress) {
   JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("row_to_columnar");
   if (rowLength == nullptr) {
     throw gluten::GlutenException("Native convert row to columnar: buf_addrs can't be null");
   }
@@ -688,12 +732,28 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_columnarbatch_ColumnarBatchJniWrap
     std::shared_ptr<ColumnarBatch> batch = columnarBatchHolder.lookup(handle);
     batches.push_back(batch);
   }
-  auto newBatch = CompositeColumnarBatch::create(std::move(batches));
+  auto backend = gluten::createBackend();
+  auto newBatch = backend->composeColumnarBatches(std::move(batches));
   env->ReleaseLongArrayElements(handles, handleArray, JNI_ABORT);
   return columnarBatchHolder.insert(newBatch);
   JNI_METHOD_END(-1L)
 }
 
+JNIEXPORT jlong JNICALL Java_io_glutenproject_columnarbatch_ColumnarBatchJniWrapper_select( // NOLINT
+    JNIEnv* env,
+    jobject,
+    jlong handle,
+    jintArray columnIndices) {
+  JNI_METHOD_START
+  std::shared_ptr<ColumnarBatch> batch = columnarBatchHolder.lookup(handle);
+  int indexCount = env->GetArrayLength(columnIndices);
+  jint* indexArray = env->GetIntArrayElements(columnIndices, nullptr);
+  std::vector<int32_t> indices(indexArray, indexArray + indexCount);
+  env->ReleaseIntArrayElements(columnIndices, indexArray, JNI_ABORT);
+  return columnarBatchHolder.insert(batch->select(indices));
+  JNI_METHOD_END(-1L)
+}
+
 JNIEXPORT void JNICALL Java_io_glutenproject_columnarbatch_ColumnarBatchJniWrapper_exportToArrow( // NOLINT
     JNIEnv* env,
     jobject,
@@ -741,6 +801,11 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
     jobject,
     jstring partitioningNameJstr,
     jint numPartitions,
+    jintArray hashPartitionKeyIdsArr,
+    jlong rangeBoundsHandle,
+    jintArray rangePartitionKeyIdsArr,
+    jbooleanArray rangePartitionAscendingArr,
+    jbooleanArray rangePartitionNullsFirstArr,
     jlong offheapPerTask,
     jint bufferSize,
     jstring codecJstr,
@@ -769,6 +834,25 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
   auto shuffleWriterOptions = ShuffleWriterOptions::defaults();
   shuffleWriterOptions.partitioning_name = partitioningName;
   shuffleWriterOptions.buffered_write = true;
+  if (hashPartitionKeyIdsArr != nullptr) {
+    auto numKeys = env->GetArrayLength(hashPartitionKeyIdsArr);
+    shuffleWriterOptions.hash_partition_key_ids.resize(numKeys);
+    env->GetIntArrayRegion(hashPartitionKeyIdsArr, 0, numKeys, shuffleWriterOptions.hash_partition_key_ids.data());
+  }
+  if (rangePartitionKeyIdsArr != nullptr) {
+    auto numKeys = env->GetArrayLength(rangePartitionKeyIdsArr);
+    std::vector<jint> keyIds(numKeys);
+    std::vector<jboolean> ascending(numKeys);
+    std::vector<jboolean> nullsFirst(numKeys);
+    env->GetIntArrayRegion(rangePartitionKeyIdsArr, 0, numKeys, keyIds.data());
+    env->GetBooleanArrayRegion(rangePartitionAscendingArr, 0, numKeys, ascending.data());
+    env->GetBooleanArrayRegion(rangePartitionNullsFirstArr, 0, numKeys, nullsFirst.data());
+    for (jsize i = 0; i < numKeys; ++i) {
+      shuffleWriterOptions.range_partition_keys.push_back(
+          {keyIds[i], ascending[i] == JNI_TRUE, nullsFirst[i] == JNI_TRUE});
+    }
+    shuffleWriterOptions.range_bounds = columnarBatchHolder.lookup(rangeBoundsHandle);
+  }
   if (bufferSize > 0) {
     shuffleWriterOptions.buffer_size = bufferSize;
   }
@@ -837,6 +921,8 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
         createGlobalClassReferenceOrError(env, "Lorg/apache/spark/shuffle/CelebornPartitionPusher;");
     jmethodID celebornPushPartitionDataMethod =
         getMethodIdOrError(env, celebornPartitionPusherClass, "pushPartitionData", "(I[B)I");
+    jmethodID celebornPushPartitionsDataMethod =
+        getMethodIdOrError(env, celebornPartitionPusherClass, "pushPartitionsData", "([I[I[B)[I");
     if (pushBufferMaxSize > 0) {
       shuffleWriterOptions.push_buffer_max_size = pushBufferMaxSize;
     }
@@ -844,8 +930,8 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
     if (env->GetJavaVM(&vm) != JNI_OK) {
       throw gluten::GlutenException("Unable to get JavaVM instance");
     }
-    std::shared_ptr<CelebornClient> celebornClient =
-        std::make_shared<CelebornClient>(vm, partitionPusher, celebornPushPartitionDataMethod);
+    std::shared_ptr<CelebornClient> celebornClient = std::make_shared<CelebornClient>(
+        vm, partitionPusher, celebornPushPartitionDataMethod, celebornPushPartitionsDataMethod);
     partitionWriterCreator = std::make_shared<CelebornPartitionWriterCreator>(std::move(celebornClient));
   } else {
     throw gluten::GlutenException("Unrecognizable partition writer type: " + partitionWriterType);
@@ -885,6 +971,7 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
     jint numRows,
     jlong handle) {
   JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("shuffle_writer");
   auto shuffleWriter = shuffleWriterHolder.lookup(shuffleWriterId);
   if (!shuffleWriter) {
     std::string errorMessage = "Invalid shuffle writer id " + std::to_string(shuffleWriterId);
@@ -920,6 +1007,22 @@ Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper_stop(JNIEnv* env, jobje
   auto rawSrc = reinterpret_cast<const jlong*>(rawPartitionLengths.data());
   env->SetLongArrayRegion(rawPartitionLengthArr, 0, rawPartitionLengths.size(), rawSrc);
 
+  const auto& partitionChunkLengths = shuffleWriter->partitionChunkLengths();
+  auto partitionChunkLengthArr = env->NewLongArray(partitionChunkLengths.size());
+  auto chunkSrc = reinterpret_cast<const jlong*>(partitionChunkLengths.data());
+  env->SetLongArrayRegion(partitionChunkLengthArr, 0, partitionChunkLengths.size(), chunkSrc);
+
+  const auto phaseTimes = shuffleWriter->splitPhaseTimes();
+  auto phaseNameArr = env->NewObjectArray(phaseTimes.size(), stringClass, nullptr);
+  auto phaseTimeArr = env->NewLongArray(phaseTimes.size());
+  for (size_t i = 0; i < phaseTimes.size(); ++i) {
+    auto name = env->NewStringUTF(phaseTimes[i].first.c_str());
+    env->SetObjectArrayElement(phaseNameArr, i, name);
+    env->DeleteLocalRef(name);
+    jlong time = phaseTimes[i].second;
+    env->SetLongArrayRegion(phaseTimeArr, i, 1, &time);
+  }
+
   jobject splitResult = env->NewObject(
       splitResultClass,
       splitResultConstructor,
@@ -930,7 +1033,10 @@ Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper_stop(JNIEnv* env, jobje
       shuffleWriter->totalBytesWritten(),
       shuffleWriter->totalBytesEvicted(),
       partitionLengthArr,
-      rawPartitionLengthArr);
+      rawPartitionLengthArr,
+      phaseNameArr,
+      phaseTimeArr,
+      partitionChunkLengthArr);
 
   return splitResult;
   JNI_METHOD_END(nullptr)
@@ -990,6 +1096,7 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper
 JNIEXPORT jlong JNICALL
 Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper_next(JNIEnv* env, jobject, jlong handle) { // NOLINT
   JNI_METHOD_START
+  AllocationProfiler::ScopedPool profilerPool("shuffle_reader");
   auto reader = shuffleReaderHolder.lookup(handle);
   GLUTEN_ASSIGN_OR_THROW(auto gluten_batch, reader->next())
   if (gluten_batch == nullptr) {
@@ -1009,6 +1116,12 @@ JNIEXPORT void JNICALL Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper_
   auto reader = shuffleReaderHolder.lookup(handle);
   env->CallVoidMethod(metrics, shuffleReaderMetricsSetDecompressTime, reader->getDecompressTime());
   checkException(env);
+  env->CallVoidMethod(
+      metrics, shuffleReaderMetricsSetHardwareDecompressedBytes, reader->getHardwareDecompressedBytes());
+  checkException(env);
+  env->CallVoidMethod(
+      metrics, shuffleReaderMetricsSetSoftwareDecompressedBytes, reader->getSoftwareDecompressedBytes());
+  checkException(env);
   JNI_METHOD_END()
 }
 
@@ -1062,15 +1175,26 @@ Java_io_glutenproject_spark_sql_execution_datasources_velox_DatasourceJniWrapper
   JNI_METHOD_END()
 }
 
-JNIEXPORT void JNICALL Java_io_glutenproject_spark_sql_execution_datasources_velox_DatasourceJniWrapper_close( // NOLINT
+JNIEXPORT jstring JNICALL Java_io_glutenproject_spark_sql_execution_datasources_velox_DatasourceJniWrapper_close( // NOLINT
     JNIEnv* env,
     jobject obj,
     jlong instanceId) {
   JNI_METHOD_START
   auto datasource = glutenDatasourceHolder.lookup(instanceId);
   datasource->close();
+  auto fileStats = datasource->fileStats();
   glutenDatasourceHolder.erase(instanceId);
-  JNI_METHOD_END()
+  return env->NewStringUTF(fileStats.c_str());
+  JNI_METHOD_END(nullptr)
+}
+
+JNIEXPORT jlong JNICALL Java_io_glutenproject_spark_sql_execution_datasources_velox_DatasourceJniWrapper_writtenBytes( // NOLINT
+    JNIEnv* env,
+    jobject obj,
+    jlong instanceId) {
+  JNI_METHOD_START
+  return glutenDatasourceHolder.lookup(instanceId)->writtenBytes();
+  JNI_METHOD_END(-1)
 }
 
 JNIEXPORT void JNICALL Java_io_glutenproject_spark_sql_execution_datasources_velox_DatasourceJniWrapper_write( // NOLINT
@@ -1092,6 +1216,36 @@ JNIEXPORT void JNICALL Java_io_glutenproject_spark_sql_execution_datasources_vel
   JNI_METHOD_END()
 }
 
+JNIEXPORT jobject JNICALL
+Java_io_glutenproject_spark_sql_execution_datasources_velox_DatasourceJniWrapper_splitBlockByPartitionAndBucket( // NOLINT
+    JNIEnv* env,
+    jobject obj,
+    jlong batchHandle,
+    jintArray partitionColIndice,
+    jboolean hasBucket) {
+  JNI_METHOD_START
+  auto batch = columnarBatchHolder.lookup(batchHandle);
+  std::vector<int32_t> partitionColIndiceVec(env->GetArrayLength(partitionColIndice));
+  env->GetIntArrayRegion(partitionColIndice, 0, partitionColIndiceVec.size(), partitionColIndiceVec.data());
+  auto backend = gluten::createBackend();
+  auto stripes = backend->splitBlockByPartitionAndBucket(batch, partitionColIndiceVec, hasBucket);
+
+  // The heading rows take the place of the origin block of the CH backend, that they are converted from.
+  jlong headingRowsHandle = columnarBatchHolder.insert(stripes->headingRows);
+  std::vector<jlong> stripeHandles;
+  stripeHandles.reserve(stripes->stripes.size());
+  for (auto& stripe : stripes->stripes) {
+    stripeHandles.push_back(columnarBatchHolder.insert(std::move(stripe)));
+  }
+  auto addresses = env->NewLongArray(stripeHandles.size());
+  env->SetLongArrayRegion(addresses, 0, stripeHandles.size(), stripeHandles.data());
+  auto indice = env->NewIntArray(stripes->headingRowIndice.size());
+  env->SetIntArrayRegion(indice, 0, stripes->headingRowIndice.size(), stripes->headingRowIndice.data());
+  return env->NewObject(
+      blockStripesClass, blockStripesConstructor, headingRowsHandle, addresses, indice, batch->numColumns(), false);
+  JNI_METHOD_END(nullptr)
+}
+
 JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator_getAllocator( // NOLINT
     JNIEnv* env,
     jclass,
@@ -1124,10 +1278,12 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator
   if (delegatedAllocator == nullptr) {
     throw gluten::GlutenException("Allocator does not exist or has been closed");
   }
-  auto listener =
-      std::make_shared<SparkAllocationListener>(vm, jlistener, reserveMemoryMethod, unreserveMemoryMethod, 8L << 20);
+  auto listener = std::make_shared<SparkAllocationListener>(
+      vm, jlistener, reserveMemoryMethod, unreserveMemoryMethod, kReservationBlockSize);
   std::shared_ptr<MemoryAllocator>* allocator = new std::shared_ptr<MemoryAllocator>;
-  *allocator = std::make_shared<ListenableMemoryAllocator>((*delegatedAllocator).get(), listener);
+  // Reserve in the listener's block size so that the JNI upcall is only made when a block is taken or given back.
+  *allocator =
+      std::make_shared<ListenableMemoryAllocator>((*delegatedAllocator).get(), listener, kReservationBlockSize);
   return reinterpret_cast<jlong>(allocator);
   JNI_METHOD_END(-1L)
 }
@@ -1154,6 +1310,48 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator
   JNI_METHOD_END(-1L)
 }
 
+JNIEXPORT jlongArray JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator_backendStats( // NOLINT
+    JNIEnv* env,
+    jclass,
+    jlong allocatorId) {
+  JNI_METHOD_START
+  auto* alloc = reinterpret_cast<std::shared_ptr<MemoryAllocator>*>(allocatorId);
+  if (alloc == nullptr) {
+    throw gluten::GlutenException("Memory allocator instance not found. It may not exist nor has been closed");
+  }
+  auto stats = (*alloc)->backendStats();
+  jlong values[] = {stats.allocated, stats.resident, stats.retained};
+  auto array = env->NewLongArray(3);
+  env->SetLongArrayRegion(array, 0, 3, values);
+  return array;
+  JNI_METHOD_END(nullptr)
+}
+
+JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator_dumpAllocationProfile0( // NOLINT
+    JNIEnv* env,
+    jclass,
+    jstring jPath,
+    jstring jPool) {
+  JNI_METHOD_START
+  auto path = jStringToCString(env, jPath);
+  std::ofstream out(path);
+  if (!out) {
+    throw gluten::GlutenException("Failed to open " + path + " for the allocation profile");
+  }
+  auto* profiler = AllocationProfiler::instance();
+  profiler->writeProfile(out, jStringToCString(env, jPool));
+  return profiler->numLiveSamples();
+  JNI_METHOD_END(-1L)
+}
+
+JNIEXPORT jstring JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator_allocationProfileSummary0( // NOLINT
+    JNIEnv* env,
+    jclass) {
+  JNI_METHOD_START
+  return env->NewStringUTF(AllocationProfiler::instance()->poolSummary().c_str());
+  JNI_METHOD_END(nullptr)
+}
+
 JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_serialize( // NOLINT
     JNIEnv* env,
     jobject,
@@ -1187,6 +1385,42 @@ JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializ
   JNI_METHOD_END(nullptr)
 }
 
+JNIEXPORT jlongArray JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_statistics( // NOLINT
+    JNIEnv* env,
+    jobject,
+    jlongArray handles,
+    jlong allocId) {
+  JNI_METHOD_START
+  int32_t numBatches = env->GetArrayLength(handles);
+  jlong* batchHandles = env->GetLongArrayElements(handles, nullptr);
+  auto* allocator = reinterpret_cast<std::shared_ptr<MemoryAllocator>*>(allocId);
+  GLUTEN_DCHECK(allocator != nullptr, "Memory pool does not exist or has been closed");
+  std::vector<std::shared_ptr<ColumnarBatch>> batches;
+  for (int32_t i = 0; i < numBatches; i++) {
+    auto batch = columnarBatchHolder.lookup(batchHandles[i]);
+    GLUTEN_DCHECK(batch != nullptr, "Cannot find the ColumnarBatch with handle " + std::to_string(batchHandles[i]));
+    batches.emplace_back(batch);
+  }
+  env->ReleaseLongArrayElements(handles, batchHandles, JNI_ABORT);
+
+  auto backend = createBackend();
+  auto serializer = backend->getColumnarBatchSerializer((*allocator).get(), nullptr);
+  auto statistics = serializer->computeStatistics(batches);
+  // |hasBounds|lowerBound|upperBound|nullCount| of each column.
+  std::vector<jlong> values;
+  values.reserve(statistics.size() * 4);
+  for (const auto& column : statistics) {
+    values.push_back(column.hasBounds ? 1 : 0);
+    values.push_back(column.lowerBound);
+    values.push_back(column.upperBound);
+    values.push_back(column.nullCount);
+  }
+  auto statisticsArr = env->NewLongArray(values.size());
+  env->SetLongArrayRegion(statisticsArr, 0, values.size(), values.data());
+  return statisticsArr;
+  JNI_METHOD_END(nullptr)
+}
+
 JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_init( // NOLINT
     JNIEnv* env,
     jobject,
@@ -1218,6 +1452,24 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializer
   JNI_METHOD_END(-1L)
 }
 
+JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_deserializeShared( // NOLINT
+    JNIEnv* env,
+    jobject,
+    jlong handle,
+    jstring key,
+    jbyteArray data) {
+  JNI_METHOD_START
+  std::shared_ptr<ColumnarBatchSerializer> serializer = columnarBatchSerializerHolder.lookup(handle);
+  GLUTEN_DCHECK(serializer != nullptr, "ColumnarBatchSerializer cannot be null");
+  int32_t size = env->GetArrayLength(data);
+  jbyte* serialized = env->GetByteArrayElements(data, nullptr);
+  auto batch =
+      serializer->deserializeShared(jStringToCString(env, key), reinterpret_cast<uint8_t*>(serialized), size);
+  env->ReleaseByteArrayElements(data, serialized, JNI_ABORT);
+  return columnarBatchHolder.insert(batch);
+  JNI_METHOD_END(-1L)
+}
+
 JNIEXPORT void JNICALL
 Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_close(JNIEnv* env, jobject, jlong handle) { // NOLINT
   JNI_METHOD_START
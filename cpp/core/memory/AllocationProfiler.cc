@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AllocationProfiler.h"
+
+#include <execinfo.h>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace gluten {
+
+namespace {
+thread_local const char* tlsPool = nullptr;
+thread_local bool tlsSamplerInitialized = false;
+thread_local int64_t tlsBytesUntilSample = 0;
+
+// Exponentially distributed so that every allocated byte is equally likely to be sampled, as pprof assumes when
+// unsampling heap_v2 profiles.
+int64_t nextSampleDistance(int64_t sampleInterval) {
+  thread_local std::mt19937_64 rng(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  std::exponential_distribution<double> distribution(1.0 / static_cast<double>(sampleInterval));
+  return std::max<int64_t>(1, static_cast<int64_t>(distribution(rng)));
+}
+
+uint64_t hashSite(void* const* frames, int32_t numFrames, const char* pool) {
+  // FNV-1a.
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+  for (int32_t i = 0; i < numFrames; ++i) {
+    mix(reinterpret_cast<uint64_t>(frames[i]));
+  }
+  for (const char* c = pool; *c; ++c) {
+    mix(static_cast<uint8_t>(*c));
+  }
+  return hash;
+}
+} // namespace
+
+AllocationProfiler::ScopedPool::ScopedPool(const char* name) : previous_(tlsPool) {
+  tlsPool = name;
+}
+
+AllocationProfiler::ScopedPool::~ScopedPool() {
+  tlsPool = previous_;
+}
+
+AllocationProfiler* AllocationProfiler::instance() {
+  static AllocationProfiler profiler;
+  return &profiler;
+}
+
+void AllocationProfiler::setSampleInterval(int64_t sampleInterval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sampleInterval_ = std::max<int64_t>(0, sampleInterval);
+  if (sampleInterval_ == 0) {
+    sites_.clear();
+    liveSamples_.clear();
+    numLiveSamples_ = 0;
+  }
+}
+
+void AllocationProfiler::recordAllocation(const void* p, int64_t size, const char* pool) {
+  if (p == nullptr || size <= 0) {
+    return;
+  }
+  auto interval = sampleInterval();
+  if (!tlsSamplerInitialized) {
+    tlsBytesUntilSample = nextSampleDistance(interval);
+    tlsSamplerInitialized = true;
+  }
+  tlsBytesUntilSample -= size;
+  if (tlsBytesUntilSample > 0) {
+    return;
+  }
+  tlsBytesUntilSample = nextSampleDistance(interval);
+
+  void* frames[kMaxFrames];
+  auto numFrames = backtrace(frames, kMaxFrames);
+  // Skip this function.
+  auto* callerFrames = frames + 1;
+  auto numCallerFrames = std::max(0, numFrames - 1);
+  const char* poolName = tlsPool ? tlsPool : pool;
+  auto siteId = hashSite(callerFrames, numCallerFrames, poolName);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& site = sites_[siteId];
+  if (site.allocCount == 0) {
+    site.frames.assign(callerFrames, callerFrames + numCallerFrames);
+    site.pool = poolName;
+  }
+  site.inUseCount++;
+  site.inUseBytes += size;
+  site.allocCount++;
+  site.allocBytes += size;
+  auto [it, inserted] = liveSamples_.insert({p, {size, siteId}});
+  if (!inserted) {
+    // The earlier allocation at p was freed without being seen, e.g. by another allocator.
+    auto& stale = sites_[it->second.siteId];
+    stale.inUseCount--;
+    stale.inUseBytes -= it->second.size;
+    it->second = {size, siteId};
+  } else {
+    numLiveSamples_++;
+  }
+}
+
+void AllocationProfiler::recordFree(const void* p) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = liveSamples_.find(p);
+  if (it == liveSamples_.end()) {
+    return;
+  }
+  auto& site = sites_[it->second.siteId];
+  site.inUseCount--;
+  site.inUseBytes -= it->second.size;
+  liveSamples_.erase(it);
+  numLiveSamples_--;
+}
+
+void AllocationProfiler::writeProfile(std::ostream& out, const std::string& pool) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<const Site*> sites;
+  Site total;
+  for (const auto& [id, site] : sites_) {
+    if (!pool.empty() && site.pool != pool) {
+      continue;
+    }
+    sites.push_back(&site);
+    total.inUseCount += site.inUseCount;
+    total.inUseBytes += site.inUseBytes;
+    total.allocCount += site.allocCount;
+    total.allocBytes += site.allocBytes;
+  }
+
+  out << "heap profile: " << total.inUseCount << ": " << total.inUseBytes << " [" << total.allocCount << ": "
+      << total.allocBytes << "] @ heap_v2/" << sampleInterval() << "\n";
+  for (const auto* site : sites) {
+    out << site->inUseCount << ": " << site->inUseBytes << " [" << site->allocCount << ": " << site->allocBytes
+        << "] @";
+    for (auto* frame : site->frames) {
+      out << " " << frame;
+    }
+    out << "\n";
+  }
+  // For pprof to symbolize the addresses.
+  out << "\nMAPPED_LIBRARIES:\n";
+  std::ifstream maps("/proc/self/maps");
+  out << maps.rdbuf();
+}
+
+std::string AllocationProfiler::poolSummary() const {
+  std::map<std::string, std::pair<int64_t, int64_t>> pools;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [id, site] : sites_) {
+      auto& [bytes, count] = pools[site.pool];
+      bytes += site.inUseBytes;
+      count += site.inUseCount;
+    }
+  }
+  std::ostringstream oss;
+  for (const auto& [name, usage] : pools) {
+    oss << name << ": " << usage.first << " bytes in " << usage.second << " samples\n";
+  }
+  return oss.str();
+}
+
+} // namespace gluten
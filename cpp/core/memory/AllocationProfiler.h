@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+// Executor wide sampling profiler of native allocations. Allocations are sampled on average once every
+// sampleInterval bytes, recording the call stack and the pool the allocation is made for. The live samples can be
+// written in the legacy heap profile format of gperftools, which pprof reads and unsamples.
+class AllocationProfiler {
+ public:
+  // Names the pool of the allocations made on the current thread within its lifetime.
+  class ScopedPool {
+   public:
+    explicit ScopedPool(const char* name);
+
+    ~ScopedPool();
+
+   private:
+    const char* previous_;
+  };
+
+  static AllocationProfiler* instance();
+
+  // Mean bytes between two samples. 0 disables the profiler and drops the samples.
+  void setSampleInterval(int64_t sampleInterval);
+
+  int64_t sampleInterval() const {
+    return sampleInterval_.load(std::memory_order_relaxed);
+  }
+
+  // pool is used if the thread isn't in a ScopedPool.
+  void onAllocation(const void* p, int64_t size, const char* pool) {
+    if (sampleInterval() > 0) {
+      recordAllocation(p, size, pool);
+    }
+  }
+
+  void onFree(const void* p) {
+    if (numLiveSamples_.load(std::memory_order_relaxed) > 0) {
+      recordFree(p);
+    }
+  }
+
+  void onReallocation(const void* oldP, const void* p, int64_t newSize, const char* pool) {
+    onFree(oldP);
+    onAllocation(p, newSize, pool);
+  }
+
+  // Writes the samples of the given pool, all pools if empty.
+  void writeProfile(std::ostream& out, const std::string& pool = "") const;
+
+  // Sampled bytes in use and number of live samples per pool, one pool per line.
+  std::string poolSummary() const;
+
+  int64_t numLiveSamples() const {
+    return numLiveSamples_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int32_t kMaxFrames = 32;
+
+  struct Site {
+    std::vector<void*> frames;
+    std::string pool;
+    int64_t inUseCount = 0;
+    int64_t inUseBytes = 0;
+    int64_t allocCount = 0;
+    int64_t allocBytes = 0;
+  };
+
+  struct Sample {
+    int64_t size;
+    uint64_t siteId;
+  };
+
+  void recordAllocation(const void* p, int64_t size, const char* pool);
+
+  void recordFree(const void* p);
+
+  std::atomic_int64_t sampleInterval_{0};
+  std::atomic_int64_t numLiveSamples_{0};
+
+  mutable std::mutex mutex_;
+  // Keyed by the hash of the stack and the pool.
+  std::unordered_map<uint64_t, Site> sites_;
+  std::unordered_map<const void*, Sample> liveSamples_;
+};
+
+} // namespace gluten
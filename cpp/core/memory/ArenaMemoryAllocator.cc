@@ -0,0 +1,167 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ArenaMemoryAllocator.h"
+
+#include <algorithm>
+
+namespace gluten {
+
+namespace {
+// Same as malloc.
+static constexpr uint64_t kDefaultArenaAlignment = 16;
+static constexpr uint64_t kChunkAlignment = 64;
+
+uint8_t* alignUp(uint8_t* p, uint64_t alignment) {
+  auto address = reinterpret_cast<uintptr_t>(p);
+  return reinterpret_cast<uint8_t*>((address + alignment - 1) & ~(alignment - 1));
+}
+
+uint64_t nextArenaId() {
+  static std::atomic_uint64_t nextId{1};
+  return nextId++;
+}
+} // namespace
+
+ArenaMemoryAllocator::ArenaMemoryAllocator(MemoryAllocator* delegated, int64_t chunkSize)
+    : delegated_(delegated), chunkSize_(chunkSize), id_(nextArenaId()) {}
+
+ArenaMemoryAllocator::~ArenaMemoryAllocator() {
+  for (auto& [threadId, arena] : arenas_) {
+    for (auto& chunk : arena->chunks) {
+      delegated_->free(chunk.data, chunk.size);
+    }
+  }
+}
+
+ArenaMemoryAllocator::ThreadArena& ArenaMemoryAllocator::threadArena() {
+  struct CachedArena {
+    uint64_t id = 0;
+    ThreadArena* arena = nullptr;
+  };
+  thread_local CachedArena cached;
+  if (cached.id != id_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& arena = arenas_[std::this_thread::get_id()];
+    if (arena == nullptr) {
+      arena = std::make_unique<ThreadArena>();
+    }
+    cached.id = id_;
+    cached.arena = arena.get();
+  }
+  return *cached.arena;
+}
+
+bool ArenaMemoryAllocator::allocateFrom(ThreadArena& arena, uint64_t alignment, int64_t size, void** out) {
+  auto* start = arena.head == nullptr ? nullptr : alignUp(arena.head, alignment);
+  if (start == nullptr || start + size > arena.end) {
+    // Allocations larger than a chunk get a chunk of their own.
+    auto chunkSize = std::max<int64_t>(chunkSize_, size + std::max(alignment, kChunkAlignment));
+    chunkSize = (chunkSize + kChunkAlignment - 1) / kChunkAlignment * kChunkAlignment;
+    void* data;
+    if (!delegated_->allocateAligned(kChunkAlignment, chunkSize, &data)) {
+      return false;
+    }
+    arena.chunks.push_back({static_cast<uint8_t*>(data), chunkSize});
+    bytes_ += chunkSize;
+    arena.end = static_cast<uint8_t*>(data) + chunkSize;
+    start = alignUp(static_cast<uint8_t*>(data), alignment);
+  }
+  arena.last = start;
+  arena.head = start + size;
+  *out = start;
+  return true;
+}
+
+bool ArenaMemoryAllocator::reallocateFrom(
+    ThreadArena& arena,
+    void* p,
+    uint64_t alignment,
+    int64_t size,
+    int64_t newSize,
+    void** out) {
+  auto* data = static_cast<uint8_t*>(p);
+  if (data != nullptr && data == arena.last && data + newSize <= arena.end &&
+      reinterpret_cast<uintptr_t>(data) % alignment == 0) {
+    arena.head = data + newSize;
+    *out = p;
+    return true;
+  }
+  if (!allocateFrom(arena, alignment, newSize, out)) {
+    return false;
+  }
+  if (data != nullptr) {
+    memcpy(*out, data, std::min(size, newSize));
+  }
+  return true;
+}
+
+bool ArenaMemoryAllocator::allocate(int64_t size, void** out) {
+  return allocateFrom(threadArena(), kDefaultArenaAlignment, size, out);
+}
+
+bool ArenaMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  if (!allocateFrom(threadArena(), kDefaultArenaAlignment, nmemb * size, out)) {
+    return false;
+  }
+  memset(*out, 0, nmemb * size);
+  return true;
+}
+
+bool ArenaMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  return allocateFrom(threadArena(), alignment, size, out);
+}
+
+bool ArenaMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  return reallocateFrom(threadArena(), p, kDefaultArenaAlignment, size, newSize, out);
+}
+
+bool ArenaMemoryAllocator::reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) {
+  return reallocateFrom(threadArena(), p, alignment, size, newSize, out);
+}
+
+bool ArenaMemoryAllocator::free(void* p, int64_t size) {
+  auto& arena = threadArena();
+  if (p != nullptr && p == arena.last) {
+    arena.head = arena.last;
+    arena.last = nullptr;
+  }
+  return true;
+}
+
+int64_t ArenaMemoryAllocator::getBytes() const {
+  return bytes_;
+}
+
+void ArenaMemoryAllocator::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [threadId, arena] : arenas_) {
+    if (arena->chunks.empty()) {
+      continue;
+    }
+    for (size_t i = 1; i < arena->chunks.size(); ++i) {
+      delegated_->free(arena->chunks[i].data, arena->chunks[i].size);
+      bytes_ -= arena->chunks[i].size;
+    }
+    arena->chunks.resize(1);
+    arena->head = arena->chunks[0].data;
+    arena->end = arena->chunks[0].data + arena->chunks[0].size;
+    arena->last = nullptr;
+  }
+}
+
+} // namespace gluten
@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryAllocator.h"
+
+namespace gluten {
+
+// Bump pointer allocator for buffers that die together, e.g. the buffers of one batch being converted. Memory is
+// taken from the delegated allocator in chunks, one chain of chunks per thread, so a listener behind it only sees
+// chunk sized allocations. free() only gives memory back if it was the latest allocation of the thread, everything
+// else is released by reset(). Allocating is thread safe, reset() must not run concurrently with it.
+class ArenaMemoryAllocator final : public MemoryAllocator {
+ public:
+  static constexpr int64_t kDefaultChunkSize = 1 << 20;
+
+  explicit ArenaMemoryAllocator(MemoryAllocator* delegated, int64_t chunkSize = kDefaultChunkSize);
+
+  ~ArenaMemoryAllocator() override;
+
+  bool allocate(int64_t size, void** out) override;
+
+  bool allocateZeroFilled(int64_t nmemb, int64_t size, void** out) override;
+
+  bool allocateAligned(uint64_t alignment, int64_t size, void** out) override;
+
+  bool reallocate(void* p, int64_t size, int64_t newSize, void** out) override;
+
+  bool reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) override;
+
+  bool free(void* p, int64_t size) override;
+
+  // Bytes of the chunks held.
+  int64_t getBytes() const override;
+
+  // Invalidate all memory handed out. Each thread keeps its first chunk for the next round.
+  void reset();
+
+ private:
+  struct Chunk {
+    uint8_t* data;
+    int64_t size;
+  };
+
+  struct ThreadArena {
+    std::vector<Chunk> chunks;
+    uint8_t* head = nullptr;
+    uint8_t* end = nullptr;
+    // Start of the latest allocation, which can be grown or freed in place.
+    uint8_t* last = nullptr;
+  };
+
+  ThreadArena& threadArena();
+
+  bool allocateFrom(ThreadArena& arena, uint64_t alignment, int64_t size, void** out);
+
+  bool reallocateFrom(ThreadArena& arena, void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out);
+
+  MemoryAllocator* delegated_;
+  const int64_t chunkSize_;
+  // Distinguishes arenas in the thread local lookup cache.
+  const uint64_t id_;
+  std::mutex mutex_;
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadArena>> arenas_;
+  std::atomic_int64_t bytes_{0};
+};
+
+} // namespace gluten
@@ -20,8 +20,8 @@
 
 namespace gluten {
 
-std::shared_ptr<arrow::MemoryPool> asArrowMemoryPool(MemoryAllocator* allocator) {
-  return std::make_shared<ArrowMemoryPool>(allocator);
+std::shared_ptr<arrow::MemoryPool> asArrowMemoryPool(MemoryAllocator* allocator, MemoryTier tier) {
+  return std::make_shared<ArrowMemoryPool>(allocator, tier);
 }
 
 std::shared_ptr<arrow::MemoryPool> defaultArrowMemoryPool() {
@@ -30,6 +30,7 @@ std::shared_ptr<arrow::MemoryPool> defaultArrowMemoryPool() {
 }
 
 arrow::Status ArrowMemoryPool::Allocate(int64_t size, int64_t alignment, uint8_t** out) {
+  ScopedMemoryTier scopedTier(tier_);
   if (!allocator_->allocateAligned(alignment, size, reinterpret_cast<void**>(out))) {
     return arrow::Status::Invalid("WrappedMemoryPool: Error allocating " + std::to_string(size) + " bytes");
   }
@@ -37,6 +38,7 @@ arrow::Status ArrowMemoryPool::Allocate(int64_t size, int64_t alignment, uint8_t
 }
 
 arrow::Status ArrowMemoryPool::Reallocate(int64_t oldSize, int64_t newSize, int64_t alignment, uint8_t** ptr) {
+  ScopedMemoryTier scopedTier(tier_);
   if (!allocator_->reallocateAligned(*ptr, alignment, oldSize, newSize, reinterpret_cast<void**>(ptr))) {
     return arrow::Status::Invalid("WrappedMemoryPool: Error reallocating " + std::to_string(newSize) + " bytes");
   }
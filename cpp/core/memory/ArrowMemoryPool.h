@@ -18,16 +18,20 @@
 #pragma once
 
 #include "MemoryAllocator.h"
+#include "MemoryTier.h"
 
 namespace gluten {
 
-std::shared_ptr<arrow::MemoryPool> asArrowMemoryPool(MemoryAllocator* allocator);
+std::shared_ptr<arrow::MemoryPool> asArrowMemoryPool(
+    MemoryAllocator* allocator,
+    MemoryTier tier = MemoryTier::kDefault);
 
 std::shared_ptr<arrow::MemoryPool> defaultArrowMemoryPool();
 
 class ArrowMemoryPool final : public arrow::MemoryPool {
  public:
-  explicit ArrowMemoryPool(MemoryAllocator* allocator) : allocator_(allocator) {}
+  explicit ArrowMemoryPool(MemoryAllocator* allocator, MemoryTier tier = MemoryTier::kDefault)
+      : allocator_(allocator), tier_(tier) {}
 
   arrow::Status Allocate(int64_t size, int64_t alignment, uint8_t** out) override;
 
@@ -43,8 +47,18 @@ class ArrowMemoryPool final : public arrow::MemoryPool {
 
   std::string backend_name() const override;
 
+  MemoryAllocator* allocator() const {
+    return allocator_;
+  }
+
+  MemoryTier tier() const {
+    return tier_;
+  }
+
  private:
   MemoryAllocator* allocator_;
+  // Preferred by the allocations of this pool.
+  MemoryTier tier_;
 };
 
 } // namespace gluten
@@ -42,6 +42,10 @@ int64_t ColumnarBatch::getExportNanos() const {
   return exportNanos_;
 }
 
+std::shared_ptr<ColumnarBatch> ColumnarBatch::select(const std::vector<int32_t>& columnIndices) {
+  throw gluten::GlutenException("Not implemented select for " + getType() + " batch");
+}
+
 std::ostream& operator<<(std::ostream& os, const ColumnarBatch& columnarBatch) {
   return os << "NumColumns: " << std::to_string(columnarBatch.numColumns())
             << "NumRows: " << std::to_string(columnarBatch.numRows());
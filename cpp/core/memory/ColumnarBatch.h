@@ -49,6 +49,9 @@ class ColumnarBatch {
   virtual int64_t getExportNanos() const;
   ;
 
+  /// A batch of the given columns of this one, in that order. Not all batch types support it.
+  virtual std::shared_ptr<ColumnarBatch> select(const std::vector<int32_t>& columnIndices);
+
   friend std::ostream& operator<<(std::ostream& os, const ColumnarBatch& columnarBatch);
 
  private:
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "ColumnarBatch.h"
 
 namespace gluten {
@@ -30,6 +32,11 @@ class ColumnarBatchIterator {
   // null means stream end
   virtual std::shared_ptr<ColumnarBatch> next() = 0;
 
+  // True if next() won't block. Otherwise onReady, if set, is called once it won't, possibly from another thread.
+  virtual bool isReady(const std::function<void()>& onReady) {
+    return true;
+  }
+
   virtual int64_t spillFixedSize(int64_t size) {
     return 0L;
   }
@@ -17,10 +17,11 @@
 
 #include "HbwAllocator.h"
 
-#include <hbwmalloc.h>
+#include <memkind.h>
 #include <cstdlib>
 #include <iostream>
 #include "MemoryAllocator.h"
+#include "MemoryTier.h"
 
 namespace gluten {
 
@@ -30,34 +31,82 @@ std::shared_ptr<MemoryAllocator> HbwMemoryAllocator::newInstance() {
     std::cout << "MEMKIND_HBW_NODES not set. Use StdMemoryAllocator." << std::endl;
     return std::make_shared<StdMemoryAllocator>();
   }
-  std::cout << "MEMKIND_HBW_NODES set. Use StdMemoryAllocator." << std::endl;
+  std::cout << "MEMKIND_HBW_NODES set. Use HbwMemoryAllocator with " << hbmCapacity() << " bytes of HBM." << std::endl;
   return std::make_shared<HbwMemoryAllocator>();
 }
 
-bool HbwMemoryAllocator::allocate(int64_t size, void** out) {
-  *out = hbw_malloc(size);
-  bytes_ += size;
+bool HbwMemoryAllocator::reserveHbm(int64_t size) {
+  auto used = hbmBytes_.load();
+  do {
+    if (used + size > hbmCapacity()) {
+      return false;
+    }
+  } while (!hbmBytes_.compare_exchange_weak(used, used + size));
   return true;
 }
 
-bool HbwMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
-  *out = hbw_calloc(nmemb, size);
+bool HbwMemoryAllocator::allocateTiered(uint64_t alignment, int64_t size, bool zeroFilled, void** out) {
+  auto tryAllocate = [&](memkind_t kind) {
+    if (alignment > 0) {
+      if (memkind_posix_memalign(kind, out, alignment, size) != 0) {
+        return false;
+      }
+      if (zeroFilled) {
+        memset(*out, 0, size);
+      }
+      return true;
+    }
+    *out = zeroFilled ? memkind_calloc(kind, 1, size) : memkind_malloc(kind, size);
+    return *out != nullptr;
+  };
+  if (currentMemoryTier() == MemoryTier::kHbm) {
+    if (reserveHbm(size)) {
+      if (tryAllocate(MEMKIND_HBW)) {
+        bytes_ += size;
+        return true;
+      }
+      hbmBytes_ -= size;
+    }
+    // Over the budget, or HBM is exhausted, e.g. by other processes.
+    numFallbacks_++;
+  }
+  if (!tryAllocate(MEMKIND_DEFAULT)) {
+    return false;
+  }
   bytes_ += size;
   return true;
 }
 
+bool HbwMemoryAllocator::allocate(int64_t size, void** out) {
+  return allocateTiered(0, size, false, out);
+}
+
+bool HbwMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  return allocateTiered(0, nmemb * size, true, out);
+}
+
 bool HbwMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
-  if (hbw_posix_memalign(out, alignment, size) != 0) {
-    return false;
-  }
-  bytes_ += size;
-  return true;
+  return allocateTiered(alignment, size, false, out);
 }
 
 bool HbwMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
-  *out = hbw_realloc(p, newSize);
-  bytes_ += (newSize - size);
-  return true;
+  auto kind = memkind_detect_kind(p);
+  // Grow in place if the buffer is already in the preferred tier.
+  auto tier = currentMemoryTier();
+  bool inPlace =
+      kind == MEMKIND_HBW ? tier == MemoryTier::kHbm && reserveHbm(newSize - size) : tier != MemoryTier::kHbm;
+  if (inPlace) {
+    auto reallocatedP = memkind_realloc(kind, p, newSize);
+    if (reallocatedP != nullptr) {
+      *out = reallocatedP;
+      bytes_ += (newSize - size);
+      return true;
+    }
+    if (kind == MEMKIND_HBW) {
+      hbmBytes_ -= (newSize - size);
+    }
+  }
+  return reallocateAligned(p, 0, size, newSize, out);
 }
 
 bool HbwMemoryAllocator::reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) {
@@ -65,18 +114,21 @@ bool HbwMemoryAllocator::reallocateAligned(void* p, uint64_t alignment, int64_t
     return false;
   }
   void* reallocatedP = nullptr;
-  if (hbw_posix_memalign(&reallocatedP, alignment, newSize) != 0) {
+  if (!allocateTiered(alignment, newSize, false, &reallocatedP)) {
     return false;
   }
   memcpy(reallocatedP, p, std::min(size, newSize));
-  hbw_free(p);
+  free(p, size);
   *out = reallocatedP;
-  bytes_ += (newSize - size);
   return true;
 }
 
 bool HbwMemoryAllocator::free(void* p, int64_t size) {
-  hbw_free(p);
+  auto kind = memkind_detect_kind(p);
+  if (kind == MEMKIND_HBW) {
+    hbmBytes_ -= size;
+  }
+  memkind_free(kind, p);
   bytes_ -= size;
   return true;
 }
@@ -85,4 +137,12 @@ int64_t HbwMemoryAllocator::getBytes() const {
   return bytes_;
 }
 
+int64_t HbwMemoryAllocator::hbmBytes() const {
+  return hbmBytes_;
+}
+
+int64_t HbwMemoryAllocator::numFallbacks() const {
+  return numFallbacks_;
+}
+
 } // namespace gluten
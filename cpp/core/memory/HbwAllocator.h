@@ -21,6 +21,9 @@
 
 namespace gluten {
 
+// Tiered allocator over high bandwidth memory and DDR. Allocations made within ScopedMemoryTier(MemoryTier::kHbm) go
+// to HBM as long as the HBM in use stays within hbmCapacity() and HBM isn't exhausted, others go to DDR. The tier of
+// a buffer is detected on free, so a buffer may be freed outside of the scope it was allocated in.
 class HbwMemoryAllocator final : public MemoryAllocator {
  public:
   static std::shared_ptr<MemoryAllocator> newInstance();
@@ -39,8 +42,22 @@ class HbwMemoryAllocator final : public MemoryAllocator {
 
   int64_t getBytes() const override;
 
+  // Bytes of the allocations served from HBM.
+  int64_t hbmBytes() const;
+
+  // Number of HBM tier allocations served from DDR as the budget or HBM was exhausted.
+  int64_t numFallbacks() const;
+
  private:
+  // Reserves size bytes of the HBM budget.
+  bool reserveHbm(int64_t size);
+
+  // alignment 0 means malloc alignment.
+  bool allocateTiered(uint64_t alignment, int64_t size, bool zeroFilled, void** out);
+
   std::atomic_int64_t bytes_{0};
+  std::atomic_int64_t hbmBytes_{0};
+  std::atomic_int64_t numFallbacks_{0};
 };
 
 } // namespace gluten
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JemallocAllocator.h"
+
+#include <jemalloc/jemalloc.h>
+#include <cstring>
+#include <string>
+
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+int64_t arenaStat(unsigned arena, const char* name) {
+  auto key = "stats.arenas." + std::to_string(arena) + "." + name;
+  size_t value;
+  size_t size = sizeof(value);
+  if (je_gluten_mallctl(key.c_str(), &value, &size, nullptr, 0) != 0) {
+    return -1;
+  }
+  return static_cast<int64_t>(value);
+}
+} // namespace
+
+JemallocMemoryAllocator::JemallocMemoryAllocator() {
+  size_t size = sizeof(arena_);
+  if (je_gluten_mallctl("arenas.create", &arena_, &size, nullptr, 0) != 0) {
+    throw GlutenException("Failed to create jemalloc arena");
+  }
+  flags_ = MALLOCX_ARENA(arena_);
+}
+
+bool JemallocMemoryAllocator::allocate(int64_t size, void** out) {
+  // mallocx doesn't take 0.
+  *out = je_gluten_mallocx(size > 0 ? size : 1, flags_);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool JemallocMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  auto total = nmemb * size;
+  *out = je_gluten_mallocx(total > 0 ? total : 1, flags_ | MALLOCX_ZERO);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += total;
+  return true;
+}
+
+bool JemallocMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  *out = je_gluten_mallocx(size > 0 ? size : 1, flags_ | MALLOCX_ALIGN(alignment));
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool JemallocMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  if (newSize <= 0) {
+    return false;
+  }
+  *out = je_gluten_rallocx(p, newSize, flags_);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += (newSize - size);
+  return true;
+}
+
+bool JemallocMemoryAllocator::reallocateAligned(
+    void* p,
+    uint64_t alignment,
+    int64_t size,
+    int64_t newSize,
+    void** out) {
+  if (newSize <= 0) {
+    return false;
+  }
+  *out = je_gluten_rallocx(p, newSize, flags_ | MALLOCX_ALIGN(alignment));
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += (newSize - size);
+  return true;
+}
+
+bool JemallocMemoryAllocator::free(void* p, int64_t size) {
+  je_gluten_dallocx(p, flags_);
+  bytes_ -= size;
+  if (purgeTrigger_.onFree(size)) {
+    purge();
+  }
+  return true;
+}
+
+int64_t JemallocMemoryAllocator::getBytes() const {
+  return bytes_;
+}
+
+MemoryAllocatorStats JemallocMemoryAllocator::backendStats() const {
+  // Stats are snapshots, refreshed by advancing the epoch.
+  uint64_t epoch = 1;
+  size_t size = sizeof(epoch);
+  je_gluten_mallctl("epoch", &epoch, &size, &epoch, size);
+  MemoryAllocatorStats stats;
+  auto small = arenaStat(arena_, "small.allocated");
+  auto large = arenaStat(arena_, "large.allocated");
+  if (small >= 0 && large >= 0) {
+    stats.allocated = small + large;
+  }
+  stats.resident = arenaStat(arena_, "resident");
+  stats.retained = arenaStat(arena_, "retained");
+  return stats;
+}
+
+void JemallocMemoryAllocator::purge() {
+  je_gluten_mallctl("thread.tcache.flush", nullptr, nullptr, nullptr, 0);
+  auto key = "arena." + std::to_string(arena_) + ".purge";
+  je_gluten_mallctl(key.c_str(), nullptr, nullptr, nullptr, 0);
+}
+
+} // namespace gluten
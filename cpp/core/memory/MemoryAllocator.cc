@@ -16,56 +16,119 @@
  */
 
 #include "MemoryAllocator.h"
+
+#include <iostream>
+
+#include "AllocationProfiler.h"
 #include "HbwAllocator.h"
+#include "JemallocAllocator.h"
+#include "MimallocAllocator.h"
 #include "utils/macros.h"
 
 namespace gluten {
 
+namespace {
+// Pool of the sampled allocations made outside of any AllocationProfiler::ScopedPool.
+const char* kProfilerPool = "listenable";
+} // namespace
+
+ListenableMemoryAllocator::~ListenableMemoryAllocator() {
+  if (reservationBlockSize_ > 0 && reservedBytes_ > 0) {
+    try {
+      notifyListener(-reservedBytes_);
+    } catch (const std::exception& e) {
+      std::cerr << "ListenableMemoryAllocator#~ListenableMemoryAllocator(): failed to release reservation: "
+                << e.what() << std::endl;
+    }
+  }
+}
+
+void ListenableMemoryAllocator::notifyListener(int64_t diff) {
+  listenerInvocations_++;
+  listener_->allocationChanged(diff);
+}
+
+void ListenableMemoryAllocator::updateReservation(int64_t diff) {
+  if (reservationBlockSize_ <= 0) {
+    notifyListener(diff);
+    return;
+  }
+  int64_t granted = 0;
+  {
+    std::lock_guard<std::mutex> lock(reservationMutex_);
+    usedBytes_ += diff;
+    auto blocks = usedBytes_ <= 0 ? 0 : (usedBytes_ - 1) / reservationBlockSize_ + 1;
+    if (usedBytes_ > reservedBytes_) {
+      granted = blocks * reservationBlockSize_ - reservedBytes_;
+    } else if (reservedBytes_ - usedBytes_ >= 2 * reservationBlockSize_) {
+      // Keep one spare block.
+      granted = (blocks + 1) * reservationBlockSize_ - reservedBytes_;
+    }
+    reservedBytes_ += granted;
+  }
+  if (granted == 0) {
+    return;
+  }
+  // The listener is called without the lock held as it may trigger spilling, which frees memory of this allocator.
+  try {
+    notifyListener(granted);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(reservationMutex_);
+    usedBytes_ -= diff;
+    reservedBytes_ -= granted;
+    throw;
+  }
+}
+
 bool ListenableMemoryAllocator::allocate(int64_t size, void** out) {
-  listener_->allocationChanged(size);
+  updateReservation(size);
   bool succeed = delegated_->allocate(size, out);
   if (!succeed) {
-    listener_->allocationChanged(-size);
+    updateReservation(-size);
   }
   if (succeed) {
     bytes_ += size;
+    AllocationProfiler::instance()->onAllocation(*out, size, kProfilerPool);
   }
   return succeed;
 }
 
 bool ListenableMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
-  listener_->allocationChanged(size * nmemb);
+  updateReservation(size * nmemb);
   bool succeed = delegated_->allocateZeroFilled(nmemb, size, out);
   if (!succeed) {
-    listener_->allocationChanged(-size * nmemb);
+    updateReservation(-size * nmemb);
   }
   if (succeed) {
     bytes_ += size * nmemb;
+    AllocationProfiler::instance()->onAllocation(*out, size * nmemb, kProfilerPool);
   }
   return succeed;
 }
 
 bool ListenableMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
-  listener_->allocationChanged(size);
+  updateReservation(size);
   bool succeed = delegated_->allocateAligned(alignment, size, out);
   if (!succeed) {
-    listener_->allocationChanged(-size);
+    updateReservation(-size);
   }
   if (succeed) {
     bytes_ += size;
+    AllocationProfiler::instance()->onAllocation(*out, size, kProfilerPool);
   }
   return succeed;
 }
 
 bool ListenableMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
   int64_t diff = newSize - size;
-  listener_->allocationChanged(diff);
+  updateReservation(diff);
   bool succeed = delegated_->reallocate(p, size, newSize, out);
   if (!succeed) {
-    listener_->allocationChanged(-diff);
+    updateReservation(-diff);
   }
   if (succeed) {
     bytes_ += diff;
+    AllocationProfiler::instance()->onReallocation(p, *out, newSize, kProfilerPool);
   }
   return succeed;
 }
@@ -77,25 +140,27 @@ bool ListenableMemoryAllocator::reallocateAligned(
     int64_t newSize,
     void** out) {
   int64_t diff = newSize - size;
-  listener_->allocationChanged(diff);
+  updateReservation(diff);
   bool succeed = delegated_->reallocateAligned(p, alignment, size, newSize, out);
   if (!succeed) {
-    listener_->allocationChanged(-diff);
+    updateReservation(-diff);
   }
   if (succeed) {
     bytes_ += diff;
+    AllocationProfiler::instance()->onReallocation(p, *out, newSize, kProfilerPool);
   }
   return succeed;
 }
 
 bool ListenableMemoryAllocator::free(void* p, int64_t size) {
-  listener_->allocationChanged(-size);
+  updateReservation(-size);
   bool succeed = delegated_->free(p, size);
   if (!succeed) {
-    listener_->allocationChanged(size);
+    updateReservation(size);
   }
   if (succeed) {
     bytes_ -= size;
+    AllocationProfiler::instance()->onFree(p);
   }
   return succeed;
 }
@@ -104,6 +169,14 @@ int64_t ListenableMemoryAllocator::getBytes() const {
   return bytes_;
 }
 
+MemoryAllocatorStats ListenableMemoryAllocator::backendStats() const {
+  return delegated_->backendStats();
+}
+
+void ListenableMemoryAllocator::purge() {
+  delegated_->purge();
+}
+
 MemoryAllocator* ListenableMemoryAllocator::delegatedAllocator() {
   return delegated_;
 }
@@ -112,6 +185,15 @@ AllocationListener* ListenableMemoryAllocator::listener() {
   return listener_.get();
 }
 
+int64_t ListenableMemoryAllocator::reservedBytes() const {
+  std::lock_guard<std::mutex> lock(reservationMutex_);
+  return reservedBytes_;
+}
+
+int64_t ListenableMemoryAllocator::listenerInvocations() const {
+  return listenerInvocations_;
+}
+
 bool StdMemoryAllocator::allocate(int64_t size, void** out) {
   *out = std::malloc(size);
   bytes_ += size;
@@ -180,11 +262,38 @@ AllocationListener* AllocationListener::noop() {
   return instance;
 };
 
+namespace {
+// Chosen by environment variable since the default allocator is created before any Spark conf reaches native code.
+// Set it through spark.executorEnv.GLUTEN_MEMORY_ALLOCATOR.
+const char* kMemoryAllocatorEnv = "GLUTEN_MEMORY_ALLOCATOR";
+
+std::shared_ptr<MemoryAllocator> newMallocAllocator() {
+  auto name = std::getenv(kMemoryAllocatorEnv);
+  if (name == nullptr || std::strcmp(name, "std") == 0) {
+    return std::make_shared<StdMemoryAllocator>();
+  }
+#if defined(GLUTEN_ENABLE_JEMALLOC)
+  if (std::strcmp(name, "jemalloc") == 0) {
+    std::cout << kMemoryAllocatorEnv << " set. Use JemallocMemoryAllocator." << std::endl;
+    return std::make_shared<JemallocMemoryAllocator>();
+  }
+#endif
+#if defined(GLUTEN_ENABLE_MIMALLOC)
+  if (std::strcmp(name, "mimalloc") == 0) {
+    std::cout << kMemoryAllocatorEnv << " set. Use MimallocMemoryAllocator." << std::endl;
+    return std::make_shared<MimallocMemoryAllocator>();
+  }
+#endif
+  std::cout << kMemoryAllocatorEnv << "=" << name << " is not built in. Use StdMemoryAllocator." << std::endl;
+  return std::make_shared<StdMemoryAllocator>();
+}
+} // namespace
+
 std::shared_ptr<MemoryAllocator> defaultMemoryAllocator() {
 #if defined(GLUTEN_ENABLE_HBM)
   static std::shared_ptr<MemoryAllocator> alloc = HbwMemoryAllocator::newInstance();
 #else
-  static std::shared_ptr<MemoryAllocator> alloc = std::make_shared<StdMemoryAllocator>();
+  static std::shared_ptr<MemoryAllocator> alloc = newMallocAllocator();
 #endif
   return alloc;
 }
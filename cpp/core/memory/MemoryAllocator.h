@@ -21,12 +21,23 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "arrow/memory_pool.h"
 
 namespace gluten {
 
+// Statistics of the malloc implementation behind an allocator, -1 if unknown.
+struct MemoryAllocatorStats {
+  // Bytes of live allocations as seen by the malloc implementation, including its size class rounding.
+  int64_t allocated = -1;
+  // Bytes of physically resident pages held by the malloc implementation.
+  int64_t resident = -1;
+  // Bytes of virtual memory kept mapped but not resident, for reuse.
+  int64_t retained = -1;
+};
+
 class MemoryAllocator {
  public:
   virtual ~MemoryAllocator() = default;
@@ -41,6 +52,35 @@ class MemoryAllocator {
   virtual bool free(void* p, int64_t size) = 0;
 
   virtual int64_t getBytes() const = 0;
+
+  virtual MemoryAllocatorStats backendStats() const {
+    return {};
+  }
+
+  // Returns the unused pages cached by the malloc implementation to the OS.
+  virtual void purge() {}
+};
+
+// Tells a malloc backend shared by all tasks when to purge: once the bytes freed since the last purge reach the
+// threshold, so the cost of a purge is spread over a large amount of freed memory rather than paid per task.
+class FreedBytesPurgeTrigger {
+ public:
+  // Bytes freed between two purges by default.
+  static constexpr int64_t kDefaultThreshold = 256 << 20;
+
+  explicit FreedBytesPurgeTrigger(int64_t threshold = kDefaultThreshold) : threshold_(threshold) {}
+
+  // Returns true if the caller should purge now. Only one of the concurrent callers crossing the threshold gets true.
+  bool onFree(int64_t size) {
+    if (freedBytes_.fetch_add(size) + size < threshold_) {
+      return false;
+    }
+    return freedBytes_.exchange(0) >= threshold_;
+  }
+
+ private:
+  const int64_t threshold_;
+  std::atomic_int64_t freedBytes_{0};
 };
 
 class AllocationListener {
@@ -56,10 +96,18 @@ class AllocationListener {
   AllocationListener() = default;
 };
 
+// With reservationBlockSize > 0, memory is reserved from the listener in whole blocks and allocations are served
+// from the reservation. Surplus is only given back once usage drops a full block below the last reserved block, and
+// one spare block is kept, so the listener isn't called back and forth around a block boundary.
 class ListenableMemoryAllocator final : public MemoryAllocator {
  public:
-  explicit ListenableMemoryAllocator(MemoryAllocator* delegated, std::shared_ptr<AllocationListener> listener)
-      : delegated_(delegated), listener_(std::move(listener)) {}
+  explicit ListenableMemoryAllocator(
+      MemoryAllocator* delegated,
+      std::shared_ptr<AllocationListener> listener,
+      int64_t reservationBlockSize = 0)
+      : delegated_(delegated), listener_(std::move(listener)), reservationBlockSize_(reservationBlockSize) {}
+
+  ~ListenableMemoryAllocator() override;
 
  public:
   bool allocate(int64_t size, void** out) override;
@@ -80,10 +128,32 @@ class ListenableMemoryAllocator final : public MemoryAllocator {
 
   int64_t getBytes() const override;
 
+  MemoryAllocatorStats backendStats() const override;
+
+  void purge() override;
+
+  // Bytes reserved from the listener in reservation block mode.
+  int64_t reservedBytes() const;
+
+  // Number of calls made to the listener.
+  int64_t listenerInvocations() const;
+
  private:
+  // Account diff bytes of usage, calling the listener if the reservation changes.
+  void updateReservation(int64_t diff);
+
+  void notifyListener(int64_t diff);
+
   MemoryAllocator* delegated_;
   std::shared_ptr<AllocationListener> listener_;
+  const int64_t reservationBlockSize_;
   std::atomic_int64_t bytes_{0};
+  std::atomic_int64_t listenerInvocations_{0};
+
+  // Guards below. Only used in reservation block mode.
+  mutable std::mutex reservationMutex_;
+  int64_t usedBytes_ = 0;
+  int64_t reservedBytes_ = 0;
 };
 
 class StdMemoryAllocator final : public MemoryAllocator {
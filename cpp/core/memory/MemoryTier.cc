@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MemoryTier.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+thread_local MemoryTier tlsTier = MemoryTier::kDefault;
+
+// Initial capacity before any Spark conf reaches native code, unlimited if not set.
+const char* kHbmCapacityEnv = "GLUTEN_HBM_CAPACITY";
+
+int64_t initialHbmCapacity() {
+  auto capacity = std::getenv(kHbmCapacityEnv);
+  return capacity == nullptr ? std::numeric_limits<int64_t>::max() : std::stoll(capacity);
+}
+
+std::atomic_int64_t& hbmCapacityRef() {
+  static std::atomic_int64_t capacity{initialHbmCapacity()};
+  return capacity;
+}
+} // namespace
+
+MemoryTier toMemoryTier(const std::string& name) {
+  if (name == "default") {
+    return MemoryTier::kDefault;
+  }
+  if (name == "hbm") {
+    return MemoryTier::kHbm;
+  }
+  throw GlutenException("Unknown memory tier: " + name);
+}
+
+ScopedMemoryTier::ScopedMemoryTier(MemoryTier tier) : previous_(tlsTier) {
+  tlsTier = tier;
+}
+
+ScopedMemoryTier::~ScopedMemoryTier() {
+  tlsTier = previous_;
+}
+
+MemoryTier currentMemoryTier() {
+  return tlsTier;
+}
+
+void setHbmCapacity(int64_t capacity) {
+  hbmCapacityRef() = capacity;
+}
+
+int64_t hbmCapacity() {
+  return hbmCapacityRef();
+}
+
+} // namespace gluten
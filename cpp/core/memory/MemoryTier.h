@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace gluten {
+
+// Kind of memory an allocation prefers. Only tiered allocators, i.e. HbwMemoryAllocator, tell the tiers apart, other
+// allocators serve every tier from the same memory.
+enum class MemoryTier {
+  kDefault,
+  // High bandwidth memory, for hot bandwidth-bound buffers such as shuffle partition buffers and hash tables.
+  kHbm
+};
+
+// "default" or "hbm".
+MemoryTier toMemoryTier(const std::string& name);
+
+// Sets the tier preferred by the allocations made on the current thread within its lifetime. Tier-aware pools hold
+// one over each allocation, so that the tier is selected per pool.
+class ScopedMemoryTier {
+ public:
+  explicit ScopedMemoryTier(MemoryTier tier);
+
+  ~ScopedMemoryTier();
+
+ private:
+  MemoryTier previous_;
+};
+
+MemoryTier currentMemoryTier();
+
+// Executor wide budget of high bandwidth memory. Allocations beyond it fall back to the default tier.
+void setHbmCapacity(int64_t capacity);
+
+int64_t hbmCapacity();
+
+} // namespace gluten
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MimallocAllocator.h"
+
+#include <mimalloc.h>
+
+namespace gluten {
+
+bool MimallocMemoryAllocator::allocate(int64_t size, void** out) {
+  *out = mi_malloc(size);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool MimallocMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  *out = mi_calloc(nmemb, size);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += nmemb * size;
+  return true;
+}
+
+bool MimallocMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  *out = mi_malloc_aligned(size, alignment);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool MimallocMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  *out = mi_realloc(p, newSize);
+  if (*out == nullptr && newSize > 0) {
+    return false;
+  }
+  bytes_ += (newSize - size);
+  return true;
+}
+
+bool MimallocMemoryAllocator::reallocateAligned(
+    void* p,
+    uint64_t alignment,
+    int64_t size,
+    int64_t newSize,
+    void** out) {
+  if (newSize <= 0) {
+    return false;
+  }
+  *out = mi_realloc_aligned(p, newSize, alignment);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += (newSize - size);
+  return true;
+}
+
+bool MimallocMemoryAllocator::free(void* p, int64_t size) {
+  mi_free(p);
+  bytes_ -= size;
+  if (purgeTrigger_.onFree(size)) {
+    purge();
+  }
+  return true;
+}
+
+int64_t MimallocMemoryAllocator::getBytes() const {
+  return bytes_;
+}
+
+MemoryAllocatorStats MimallocMemoryAllocator::backendStats() const {
+  // mimalloc only publishes process wide numbers. Committed memory is the closest to what it keeps resident.
+  size_t elapsedMs, userMs, systemMs, currentRss, peakRss, currentCommit, peakCommit, pageFaults;
+  mi_process_info(&elapsedMs, &userMs, &systemMs, &currentRss, &peakRss, &currentCommit, &peakCommit, &pageFaults);
+  MemoryAllocatorStats stats;
+  stats.resident = static_cast<int64_t>(currentCommit);
+  return stats;
+}
+
+void MimallocMemoryAllocator::purge() {
+  // Frees the pages cached by the calling thread and the abandoned ones of exited threads.
+  mi_collect(true);
+}
+
+} // namespace gluten
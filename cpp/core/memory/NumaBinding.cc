@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NumaBinding.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace gluten {
+
+namespace {
+// From linux/mempolicy.h, glibc has no wrappers for the NUMA syscalls.
+static constexpr int kMpolDefault = 0;
+static constexpr int kMpolPreferred = 1;
+static constexpr int32_t kMaxNumaNodes = 64;
+
+struct NumaNode {
+  int32_t id;
+  std::vector<int32_t> cpus;
+};
+
+std::string readSysfs(const std::string& path) {
+  std::ifstream in(path);
+  std::string content;
+  std::getline(in, content);
+  return content;
+}
+
+// Nodes with CPUs, memory-only nodes can't run a task.
+const std::vector<NumaNode>& numaNodes() {
+  static const std::vector<NumaNode> nodes = [] {
+    std::vector<NumaNode> result;
+    for (auto id : parseCpuList(readSysfs("/sys/devices/system/node/online"))) {
+      auto cpus = parseCpuList(readSysfs("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"));
+      if (id < kMaxNumaNodes && !cpus.empty()) {
+        result.push_back({id, std::move(cpus)});
+      }
+    }
+    return result;
+  }();
+  return nodes;
+}
+
+thread_local std::weak_ptr<NumaTaskBinding> tlsBinding;
+
+std::mutex boundTasksMutex;
+std::vector<int32_t> boundTasksPerNode;
+size_t nextNode = 0;
+} // namespace
+
+std::vector<int32_t> parseCpuList(const std::string& cpuList) {
+  std::vector<int32_t> cpus;
+  std::stringstream ss(cpuList);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    auto first = std::stoi(range.substr(0, dash));
+    auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::shared_ptr<NumaTaskBinding> NumaTaskBinding::bindCurrentThread() {
+  if (auto binding = tlsBinding.lock()) {
+    return binding;
+  }
+  auto binding = std::make_shared<NumaTaskBinding>();
+  tlsBinding = binding;
+  return binding;
+}
+
+NumaTaskBinding::NumaTaskBinding() {
+  const auto& nodes = numaNodes();
+  if (nodes.size() <= 1) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(boundTasksMutex);
+    boundTasksPerNode.resize(nodes.size(), 0);
+    // Rotate the start so that ties are broken in turn.
+    auto start = nextNode++ % nodes.size();
+    nodeIndex_ = start;
+    for (size_t i = 1; i < nodes.size(); ++i) {
+      auto index = (start + i) % nodes.size();
+      if (boundTasksPerNode[index] < boundTasksPerNode[nodeIndex_]) {
+        nodeIndex_ = index;
+      }
+    }
+    ++boundTasksPerNode[nodeIndex_];
+  }
+  node_ = nodes[nodeIndex_].id;
+  tid_ = static_cast<pid_t>(syscall(SYS_gettid));
+
+  // Stay within the CPUs the executor is allowed to run on.
+  if (sched_getaffinity(0, sizeof(previousCpus_), &previousCpus_) == 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (auto cpu : nodes[nodeIndex_].cpus) {
+      if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &previousCpus_)) {
+        CPU_SET(cpu, &cpus);
+      }
+    }
+    restoreCpus_ = CPU_COUNT(&cpus) > 0 && sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+  }
+  unsigned long nodeMask = 1UL << node_;
+  // The kernel reads one bit less than maxnode.
+  syscall(SYS_set_mempolicy, kMpolPreferred, &nodeMask, kMaxNumaNodes + 1);
+}
+
+NumaTaskBinding::~NumaTaskBinding() {
+  if (node_ < 0) {
+    return;
+  }
+  // Spark task threads are pooled, the next task on the thread may not be a native one.
+  if (restoreCpus_) {
+    sched_setaffinity(tid_, sizeof(previousCpus_), &previousCpus_);
+  }
+  // The memory policy is per thread and can only be reset from the thread itself.
+  if (static_cast<pid_t>(syscall(SYS_gettid)) == tid_) {
+    syscall(SYS_set_mempolicy, kMpolDefault, nullptr, 0);
+  }
+  std::lock_guard<std::mutex> lock(boundTasksMutex);
+  --boundTasksPerNode[nodeIndex_];
+}
+
+std::vector<int32_t> NumaTaskBinding::boundTasks() {
+  std::lock_guard<std::mutex> lock(boundTasksMutex);
+  return boundTasksPerNode;
+}
+
+} // namespace gluten
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sched.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gluten {
+
+// CPUs of a cpulist of sysfs, e.g. "0-3,8-11".
+std::vector<int32_t> parseCpuList(const std::string& cpuList);
+
+// Binds the calling thread and the pages it faults in to one NUMA node within its lifetime. The node is the one with
+// the fewest bound tasks, so that the tasks of the executor spread evenly across sockets. Allocations of the task
+// memory pools made on the thread land on that node, as long as the allocator hands out fresh pages. Nothing is bound
+// on single-node hosts.
+class NumaTaskBinding {
+ public:
+  // The binding of the calling thread, shared by the iterators of one task on the thread.
+  static std::shared_ptr<NumaTaskBinding> bindCurrentThread();
+
+  NumaTaskBinding();
+
+  ~NumaTaskBinding();
+
+  // -1 if nothing is bound.
+  int32_t node() const {
+    return node_;
+  }
+
+  // Tasks bound to each node with a CPU, in node order.
+  static std::vector<int32_t> boundTasks();
+
+ private:
+  int32_t node_ = -1;
+  size_t nodeIndex_ = 0;
+  pid_t tid_ = 0;
+  cpu_set_t previousCpus_;
+  bool restoreCpus_ = false;
+};
+
+} // namespace gluten
@@ -23,6 +23,16 @@
 
 namespace gluten {
 
+// Statistics of a column of batches, to prune cached batches. Integral, boolean, date and timestamp bounds hold the
+// int64 value, timestamps in microseconds, floating point bounds the bits of the double.
+struct ColumnStatistics {
+  // False if the column has no non null value or its type has no bounds.
+  bool hasBounds = false;
+  int64_t lowerBound = 0;
+  int64_t upperBound = 0;
+  int64_t nullCount = 0;
+};
+
 class ColumnarBatchSerializer {
  public:
   ColumnarBatchSerializer(std::shared_ptr<arrow::MemoryPool> arrowPool, struct ArrowSchema* cSchema)
@@ -35,6 +45,17 @@ class ColumnarBatchSerializer {
 
   virtual std::shared_ptr<ColumnarBatch> deserialize(uint8_t* data, int32_t size) = 0;
 
+  // One entry per column of the batches, empty if the serializer doesn't compute them.
+  virtual std::vector<ColumnStatistics> computeStatistics(const std::vector<std::shared_ptr<ColumnarBatch>>& batches) {
+    return {};
+  }
+
+  // Deserializes a batch shared by all callers in the process passing the same key while any of them holds it. The
+  // batch must not be modified.
+  virtual std::shared_ptr<ColumnarBatch> deserializeShared(const std::string& key, uint8_t* data, int32_t size) {
+    return deserialize(data, size);
+  }
+
  protected:
   std::shared_ptr<arrow::MemoryPool> arrowPool_;
 };
@@ -29,6 +29,16 @@
 
 namespace gluten {
 
+// A batch of a partitioned write split into the runs of rows of the same partition, see BlockStripes of the JVM side.
+struct BlockStripes {
+  // The first row of each stripe, with all the columns of the batch split.
+  std::shared_ptr<ColumnarBatch> headingRows;
+  // The rows of each stripe, without the partition and bucket columns, which aren't written to the files.
+  std::vector<std::shared_ptr<ColumnarBatch>> stripes;
+  // The index of the first row of each stripe in the batch split.
+  std::vector<int32_t> headingRowIndice;
+};
+
 class Datasource {
  public:
   Datasource(const std::string& filePath, std::shared_ptr<arrow::Schema> schema)
@@ -40,6 +50,14 @@ class Datasource {
   virtual void inspectSchema(struct ArrowSchema* out) = 0;
   virtual void write(const std::shared_ptr<ColumnarBatch>& cb) {}
   virtual void close() {}
+  // The column statistics of the file written as JSON, empty if not collected. Called after close().
+  virtual std::string fileStats() {
+    return "";
+  }
+  // The estimated encoded bytes of the file so far, the rows buffered included. Called concurrently with write().
+  virtual int64_t writtenBytes() {
+    return 0;
+  }
   virtual std::shared_ptr<arrow::Schema> getSchema() = 0;
 
  private:
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/LocalDirSelector.h"
+
+#include <sys/statvfs.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+namespace gluten {
+
+namespace {
+static constexpr auto kFreeBytesRefreshInterval = std::chrono::seconds(1);
+static constexpr auto kBackoff = std::chrono::seconds(10);
+// Space left free on a dir beyond the bytes being written to it.
+static constexpr int64_t kMinFreeBytes = 64 << 20;
+// Smaller writes are dominated by the syscall latency and not measured.
+static constexpr int64_t kMinMeasuredBytes = 1 << 20;
+static constexpr double kCostSmoothing = 0.2;
+// A write this many times slower per byte than on the fastest dir backs its dir off.
+static constexpr double kSlowFactor = 8;
+} // namespace
+
+LocalDirSelector* LocalDirSelector::instance() {
+  static auto selector = std::make_unique<LocalDirSelector>();
+  return selector.get();
+}
+
+size_t LocalDirSelector::select(const std::vector<std::string>& dirs, int64_t expectedBytes, bool* exhausted) {
+  if (exhausted != nullptr) {
+    *exhausted = false;
+  }
+  if (dirs.empty() || (dirs.size() == 1 && exhausted == nullptr)) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = Clock::now();
+  expectedBytes = std::max<int64_t>(expectedBytes, 1);
+
+  // Unmeasured dirs are taken as fast as the fastest measured one, so that they get measured.
+  double fastest = 0;
+  for (const auto& dir : dirs) {
+    auto cost = stateOf(dir).nanosPerByte;
+    if (cost > 0 && (fastest == 0 || cost < fastest)) {
+      fastest = cost;
+    }
+  }
+
+  auto start = nextStart_++ % dirs.size();
+  int64_t selected = -1;
+  double selectedScore = 0;
+  for (size_t i = 0; i < dirs.size(); ++i) {
+    auto index = (start + i) % dirs.size();
+    auto& state = stateOf(dirs[index]);
+    if (state.backoffUntil > now) {
+      continue;
+    }
+    refreshFreeBytes(dirs[index], state, now);
+    if (state.freeBytes - state.outstandingBytes < expectedBytes + kMinFreeBytes) {
+      continue;
+    }
+    auto cost = state.nanosPerByte > 0 ? state.nanosPerByte : (fastest > 0 ? fastest : 1);
+    auto score = static_cast<double>(state.outstandingBytes + expectedBytes) * cost;
+    if (selected < 0 || score < selectedScore) {
+      selected = index;
+      selectedScore = score;
+    }
+  }
+  // Every dir is backed off or full, fall back to round robin and let the write report the error.
+  if (selected < 0 && exhausted != nullptr) {
+    *exhausted = true;
+  }
+  return selected < 0 ? start : selected;
+}
+
+void LocalDirSelector::beginWrite(const std::string& dir, int64_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stateOf(dir).outstandingBytes += bytes;
+}
+
+void LocalDirSelector::endWrite(const std::string& dir, int64_t bytes, int64_t elapsedNanos, bool ok) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = Clock::now();
+  auto& state = stateOf(dir);
+  state.outstandingBytes -= bytes;
+  if (!ok) {
+    state.backoffUntil = now + kBackoff;
+    return;
+  }
+  if (bytes < kMinMeasuredBytes) {
+    return;
+  }
+  auto cost = static_cast<double>(std::max<int64_t>(elapsedNanos, 1)) / bytes;
+  state.nanosPerByte =
+      state.nanosPerByte == 0 ? cost : (1 - kCostSmoothing) * state.nanosPerByte + kCostSmoothing * cost;
+
+  double fastest = 0;
+  for (const auto& [other, otherState] : states_) {
+    if (other != dir && otherState.nanosPerByte > 0 && (fastest == 0 || otherState.nanosPerByte < fastest)) {
+      fastest = otherState.nanosPerByte;
+    }
+  }
+  if (fastest > 0 && cost > kSlowFactor * fastest) {
+    state.backoffUntil = now + kBackoff;
+  }
+}
+
+int64_t LocalDirSelector::outstandingBytes(const std::string& dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stateOf(dir).outstandingBytes;
+}
+
+LocalDirSelector::DirState& LocalDirSelector::stateOf(const std::string& dir) {
+  return states_[dir];
+}
+
+void LocalDirSelector::refreshFreeBytes(const std::string& dir, DirState& state, Clock::time_point now) {
+  if (state.freeBytesCheckedAt != Clock::time_point{} && now - state.freeBytesCheckedAt < kFreeBytesRefreshInterval) {
+    return;
+  }
+  struct statvfs stat;
+  if (::statvfs(dir.c_str(), &stat) == 0) {
+    state.freeBytes = static_cast<int64_t>(stat.f_bavail) * static_cast<int64_t>(stat.f_frsize);
+  } else {
+    // Not created yet or not a local file system, leave it to the write.
+    state.freeBytes = std::numeric_limits<int64_t>::max() / 2;
+  }
+  state.freeBytesCheckedAt = now;
+}
+
+} // namespace gluten
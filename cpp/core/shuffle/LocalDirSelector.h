@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+// Executor wide load tracking of the local dirs the shuffle writers spill to. A dir is picked by the bytes being
+// written to it, its measured write cost per byte and its free space; dirs whose writes failed are skipped for a
+// while. Thread safe.
+class LocalDirSelector {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static LocalDirSelector* instance();
+
+  // Returns the index of the dir in dirs to write expectedBytes to next, 0 if unknown. If exhausted is given, it is set
+  // to whether every dir is backed off or lacks the space.
+  size_t select(const std::vector<std::string>& dirs, int64_t expectedBytes, bool* exhausted = nullptr);
+
+  // Brackets a write of bytes to a file under dir.
+  void beginWrite(const std::string& dir, int64_t bytes);
+
+  void endWrite(const std::string& dir, int64_t bytes, int64_t elapsedNanos, bool ok);
+
+  int64_t outstandingBytes(const std::string& dir);
+
+ private:
+  struct DirState {
+    int64_t outstandingBytes = 0;
+    // Exponential moving average of the write time per byte, 0 until a write is measured.
+    double nanosPerByte = 0;
+    int64_t freeBytes = 0;
+    Clock::time_point freeBytesCheckedAt{};
+    Clock::time_point backoffUntil{};
+  };
+
+  DirState& stateOf(const std::string& dir);
+
+  void refreshFreeBytes(const std::string& dir, DirState& state, Clock::time_point now);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, DirState> states_;
+  // Rotates the start of the scan so that equally loaded dirs are taken in turn.
+  size_t nextStart_ = 0;
+};
+
+} // namespace gluten
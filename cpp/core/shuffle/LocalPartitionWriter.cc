@@ -16,39 +16,75 @@
  */
 
 #include "shuffle/LocalPartitionWriter.h"
-#include <thread>
+#include "shuffle/LocalDirSelector.h"
+#include "shuffle/UringFileOutputStream.h"
+#include <deque>
 
 namespace gluten {
 
-std::string LocalPartitionWriterBase::nextSpilledFileDir() {
-  auto spilledFileDir = getSpilledShuffleFileDir(configuredDirs_[dirSelection_], subDirSelection_[dirSelection_]);
-  subDirSelection_[dirSelection_] = (subDirSelection_[dirSelection_] + 1) % shuffleWriter_->options().num_sub_dirs;
-  dirSelection_ = (dirSelection_ + 1) % configuredDirs_.size();
-  return spilledFileDir;
+LocalPartitionWriterBase::SpillDir LocalPartitionWriterBase::nextSpillDir(int64_t expectedBytes) {
+  bool exhausted = false;
+  auto dirSelection = LocalDirSelector::instance()->select(
+      configuredDirs_, expectedBytes, remoteSpillFs_ != nullptr ? &exhausted : nullptr);
+  auto numSubDirs = shuffleWriter_->options().num_sub_dirs;
+  if (exhausted) {
+    auto spillDir = getSpilledShuffleFileDir(remoteSpillPath_, remoteSubDirSelection_);
+    remoteSubDirSelection_ = (remoteSubDirSelection_ + 1) % numSubDirs;
+    return {std::move(spillDir), shuffleWriter_->options().remote_spill_dir, true};
+  }
+  auto spillDir = getSpilledShuffleFileDir(configuredDirs_[dirSelection], subDirSelection_[dirSelection]);
+  subDirSelection_[dirSelection] = (subDirSelection_[dirSelection] + 1) % numSubDirs;
+  return {std::move(spillDir), configuredDirs_[dirSelection], false};
+}
+
+arrow::Result<SpilledFile> LocalPartitionWriterBase::createSpilledFile(const SpillDir& dir) {
+  if (dir.remote) {
+    return createRemoteSpilledFile(remoteSpillFs_, dir.dir);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto path, createTempShuffleFile(dir.dir));
+  return SpilledFile{std::make_shared<arrow::fs::LocalFileSystem>(), std::move(path), false};
 }
 
 arrow::Status LocalPartitionWriterBase::setLocalDirs() {
   ARROW_ASSIGN_OR_RAISE(configuredDirs_, getConfiguredLocalDirs());
   subDirSelection_.assign(configuredDirs_.size(), 0);
+  if (!shuffleWriter_->options().remote_spill_dir.empty()) {
+    ARROW_ASSIGN_OR_RAISE(auto remote, getRemoteSpillFileSystem(shuffleWriter_->options().remote_spill_dir));
+    std::tie(remoteSpillFs_, remoteSpillPath_) = std::move(remote);
+  }
 
   // Both data_file and shuffle_index_file should be set through jni.
   // For test purpose, Create a temporary subdirectory in the system temporary
   // dir with prefix "columnar-shuffle"
   if (shuffleWriter_->options().data_file.length() == 0) {
     std::string dataFileTemp;
-    size_t id = std::hash<std::thread::id>{}(std::this_thread::get_id()) % configuredDirs_.size();
+    auto id = LocalDirSelector::instance()->select(configuredDirs_, 0);
     ARROW_ASSIGN_OR_RAISE(shuffleWriter_->options().data_file, createTempShuffleFile(configuredDirs_[id]));
   }
   return arrow::Status::OK();
 }
 
+arrow::Result<std::shared_ptr<arrow::io::OutputStream>> LocalPartitionWriterBase::openSpillOutputStream(
+    const SpilledFile& file) {
+  const auto& options = shuffleWriter_->options();
+  if (options.io_uring && !file.remote) {
+    return UringFileOutputStream::open(file.path, options.io_uring_direct);
+  }
+  return openSpilledFileForWrite(file, options.remote_spill_buffer_size, options.memory_pool.get());
+}
+
 arrow::Status LocalPartitionWriterBase::openDataFile() {
   // open data file output stream
+  const auto& options = shuffleWriter_->options();
+  if (options.io_uring) {
+    // Buffered by the stream itself.
+    ARROW_ASSIGN_OR_RAISE(dataFileOs_, UringFileOutputStream::open(options.data_file, options.io_uring_direct));
+    return arrow::Status::OK();
+  }
   std::shared_ptr<arrow::io::FileOutputStream> fout;
-  ARROW_ASSIGN_OR_RAISE(fout, arrow::io::FileOutputStream::Open(shuffleWriter_->options().data_file, true));
-  if (shuffleWriter_->options().buffered_write) {
-    ARROW_ASSIGN_OR_RAISE(
-        dataFileOs_, arrow::io::BufferedOutputStream::Create(16384, shuffleWriter_->options().memory_pool.get(), fout));
+  ARROW_ASSIGN_OR_RAISE(fout, arrow::io::FileOutputStream::Open(options.data_file, true));
+  if (options.buffered_write) {
+    ARROW_ASSIGN_OR_RAISE(dataFileOs_, arrow::io::BufferedOutputStream::Create(16384, options.memory_pool.get(), fout));
   } else {
     dataFileOs_ = fout;
   }
@@ -63,6 +99,67 @@ arrow::Status LocalPartitionWriterBase::clearResource() {
   return arrow::Status::OK();
 }
 
+arrow::Status LocalPartitionWriterBase::writeSchemaPayload(arrow::io::OutputStream* os) {
+  std::shared_ptr<arrow::ipc::IpcPayload> payload;
+  if (shuffleWriter_->options().compression_type == arrow::Compression::type::UNCOMPRESSED) {
+    ARROW_ASSIGN_OR_RAISE(payload, getSchemaPayload(shuffleWriter_->writeSchema()));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(payload, getSchemaPayload(shuffleWriter_->compressWriteSchema()));
+  }
+  int32_t metadataLength = 0; // unused
+  RETURN_NOT_OK(
+      arrow::ipc::WriteIpcPayload(*payload, shuffleWriter_->options().ipc_write_options, os, &metadataLength));
+  return arrow::Status::OK();
+}
+
+arrow::Status LocalPartitionWriterBase::writeEos(arrow::io::OutputStream* os) {
+  // This 0xFFFFFFFF value is the first 4 bytes of a valid IPC message
+  constexpr int32_t kIpcContinuationToken = -1;
+  constexpr int32_t kZeroLength = 0;
+  RETURN_NOT_OK(os->Write(&kIpcContinuationToken, sizeof(int32_t)));
+  RETURN_NOT_OK(os->Write(&kZeroLength, sizeof(int32_t)));
+  return arrow::Status::OK();
+}
+
+arrow::Status LocalPartitionWriterBase::beginChunk() {
+  if (chunkOpened_) {
+    return arrow::Status::OK();
+  }
+  ARROW_ASSIGN_OR_RAISE(chunkStart_, dataFileOs_->Tell());
+  if (shuffleWriter_->options().write_schema) {
+    RETURN_NOT_OK(writeSchemaPayload(dataFileOs_.get()));
+  }
+  chunkOpened_ = true;
+  return arrow::Status::OK();
+}
+
+arrow::Status LocalPartitionWriterBase::endChunkIfFull() {
+  auto chunkSize = shuffleWriter_->options().push_merge_chunk_size;
+  if (chunkSize <= 0) {
+    return arrow::Status::OK();
+  }
+  ARROW_ASSIGN_OR_RAISE(auto position, dataFileOs_->Tell());
+  if (position - chunkStart_ < chunkSize) {
+    return arrow::Status::OK();
+  }
+  return endChunk();
+}
+
+arrow::Status LocalPartitionWriterBase::endChunk() {
+  if (!chunkOpened_) {
+    return arrow::Status::OK();
+  }
+  if (shuffleWriter_->options().write_eos) {
+    RETURN_NOT_OK(writeEos(dataFileOs_.get()));
+  }
+  if (shuffleWriter_->options().push_merge_chunk_size > 0) {
+    ARROW_ASSIGN_OR_RAISE(auto chunkEnd, dataFileOs_->Tell());
+    shuffleWriter_->addPartitionChunkLength(chunkEnd - chunkStart_);
+  }
+  chunkOpened_ = false;
+  return arrow::Status::OK();
+}
+
 class PreferEvictPartitionWriter::LocalPartitionWriterInstance {
  public:
   LocalPartitionWriterInstance(
@@ -72,24 +169,83 @@ class PreferEvictPartitionWriter::LocalPartitionWriterInstance {
       : partitionWriter_(partitionWriter), shuffleWriter_(shuffleWriter), partitionId_(partitionId) {}
 
   arrow::Status spill() {
-#ifndef SKIPWRITE
-    RETURN_NOT_OK(ensureOpened());
-#endif
-    RETURN_NOT_OK(writeRecordBatchPayload(spilledFileOs_.get()));
+    auto size = shuffleWriter_->partitionCachedRecordbatchSize()[partitionId_];
+    RETURN_NOT_OK(writeSpill(shuffleWriter_->partitionCachedRecordbatch()[partitionId_], size));
     clearCache();
     return arrow::Status::OK();
   }
 
+  // Pick the spilled file dir on the task thread, nextSpillDir() is not thread safe. The dir is picked by the load of
+  // the local dirs when the partition first spills, its later spills append to the same file.
+  void prepareSpill(int64_t expectedBytes) {
+    if (spillDir_.dir.empty()) {
+      spillDir_ = partitionWriter_->nextSpillDir(expectedBytes);
+    }
+  }
+
+  // Must be called with partitionWriter_->spillMutex_ held. Returns true if the caller should schedule
+  // drainPendingSpills() on the spill executor.
+  bool enqueueSpill(std::vector<std::shared_ptr<arrow::ipc::IpcPayload>> payloads, int64_t size) {
+    pendingSpills_.push_back({std::move(payloads), size});
+    if (spillScheduled_) {
+      return false;
+    }
+    spillScheduled_ = true;
+    return true;
+  }
+
+  // Runs on the spill executor. At most one drain is scheduled per partition, so pending spills are written to the
+  // spilled file in eviction order.
+  void drainPendingSpills() {
+    while (true) {
+      PendingSpill pending;
+      {
+        std::lock_guard<std::mutex> lock(partitionWriter_->spillMutex_);
+        if (pendingSpills_.empty() || !partitionWriter_->spillStatus_.ok()) {
+          for (const auto& dropped : pendingSpills_) {
+            partitionWriter_->inflightSpillBytes_ -= dropped.size;
+          }
+          pendingSpills_.clear();
+          spillScheduled_ = false;
+          --partitionWriter_->activeSpillTasks_;
+          partitionWriter_->spillCv_.notify_all();
+          return;
+        }
+        pending = std::move(pendingSpills_.front());
+        pendingSpills_.pop_front();
+      }
+
+      auto status = writeSpill(pending.payloads, pending.size);
+      // Release the payload memory before giving back the budget.
+      pending.payloads.clear();
+
+      std::lock_guard<std::mutex> lock(partitionWriter_->spillMutex_);
+      partitionWriter_->inflightSpillBytes_ -= pending.size;
+      if (!status.ok() && partitionWriter_->spillStatus_.ok()) {
+        partitionWriter_->spillStatus_ = status;
+      }
+      partitionWriter_->spillCv_.notify_all();
+    }
+  }
+
+  // Closes the spilled file and opens it for the merge, so that a remote one is read ahead of
+  // writeCachedRecordBatchAndClose().
+  arrow::Status openSpilledForMerge() {
+    if (!spilledFileOpened_ || spilledFileReader_ != nullptr) {
+      return arrow::Status::OK();
+    }
+    ARROW_ASSIGN_OR_RAISE(spilledBytes_, spilledFileOs_->Tell());
+    RETURN_NOT_OK(spilledFileOs_->Close());
+    ARROW_ASSIGN_OR_RAISE(spilledFileReader_, SpilledFileReader::open(spilledFile_, {{0, spilledBytes_}}));
+    return arrow::Status::OK();
+  }
+
   arrow::Status writeCachedRecordBatchAndClose() {
     const auto& dataFileOs = partitionWriter_->dataFileOs_;
     ARROW_ASSIGN_OR_RAISE(auto before_write, dataFileOs->Tell());
 
-    if (shuffleWriter_->options().write_schema) {
-      RETURN_NOT_OK(writeSchemaPayload(dataFileOs.get()));
-    }
-
     if (spilledFileOpened_) {
-      RETURN_NOT_OK(spilledFileOs_->Close());
+      RETURN_NOT_OK(openSpilledForMerge());
       RETURN_NOT_OK(mergeSpilled());
     } else {
       if (shuffleWriter_->partitionCachedRecordbatchSize()[partitionId_] == 0) {
@@ -97,10 +253,12 @@ class PreferEvictPartitionWriter::LocalPartitionWriterInstance {
       }
     }
 
-    RETURN_NOT_OK(writeRecordBatchPayload(dataFileOs.get()));
-    if (shuffleWriter_->options().write_eos) {
-      RETURN_NOT_OK(writeEos(dataFileOs.get()));
+    for (auto& payload : shuffleWriter_->partitionCachedRecordbatch()[partitionId_]) {
+      RETURN_NOT_OK(partitionWriter_->beginChunk());
+      RETURN_NOT_OK(writePayload(dataFileOs.get(), payload));
+      RETURN_NOT_OK(partitionWriter_->endChunkIfFull());
     }
+    RETURN_NOT_OK(partitionWriter_->endChunk());
     clearCache();
 
     ARROW_ASSIGN_OR_RAISE(auto after_write, dataFileOs->Tell());
@@ -115,66 +273,88 @@ class PreferEvictPartitionWriter::LocalPartitionWriterInstance {
   int64_t compress_time = 0;
 
  private:
+  struct PendingSpill {
+    std::vector<std::shared_ptr<arrow::ipc::IpcPayload>> payloads;
+    int64_t size = 0;
+  };
+
+  // Appends the payloads to the spilled file, accounting the write to its dir for LocalDirSelector.
+  arrow::Status writeSpill(std::vector<std::shared_ptr<arrow::ipc::IpcPayload>>& payloads, int64_t size) {
+    prepareSpill(size);
+    auto* selector = LocalDirSelector::instance();
+    selector->beginWrite(spillDir_.accountedDir, size);
+    int64_t writeTime = 0;
+    TIME_NANO_START(writeTime)
+    arrow::Status status;
+#ifndef SKIPWRITE
+    status = ensureOpened();
+#endif
+    if (status.ok()) {
+      status = writePayloads(spilledFileOs_.get(), payloads);
+    }
+    TIME_NANO_END(writeTime)
+    selector->endWrite(spillDir_.accountedDir, size, writeTime, status.ok());
+    return status;
+  }
+
   arrow::Status ensureOpened() {
     if (!spilledFileOpened_) {
-      ARROW_ASSIGN_OR_RAISE(spilledFile_, createTempShuffleFile(partitionWriter_->nextSpilledFileDir()));
-      ARROW_ASSIGN_OR_RAISE(spilledFileOs_, arrow::io::FileOutputStream::Open(spilledFile_, true));
+      ARROW_ASSIGN_OR_RAISE(spilledFile_, partitionWriter_->createSpilledFile(spillDir_));
+      // Each partition has its own spilled file open, too many for a large buffer each. A spill writes the cached
+      // payloads of the partition at once.
+      ARROW_ASSIGN_OR_RAISE(
+          spilledFileOs_, openSpilledFileForWrite(spilledFile_, 0, shuffleWriter_->options().memory_pool.get()));
       spilledFileOpened_ = true;
     }
     return arrow::Status::OK();
   }
 
   arrow::Status mergeSpilled() {
-    ARROW_ASSIGN_OR_RAISE(
-        auto spilled_file_is_, arrow::io::MemoryMappedFile::Open(spilledFile_, arrow::io::FileMode::READ));
     // copy spilled data blocks
-    ARROW_ASSIGN_OR_RAISE(auto nbytes, spilled_file_is_->GetSize());
-    ARROW_ASSIGN_OR_RAISE(auto buffer, spilled_file_is_->Read(nbytes));
-    RETURN_NOT_OK(partitionWriter_->dataFileOs_->Write(buffer));
+    ARROW_ASSIGN_OR_RAISE(auto buffer, spilledFileReader_->next());
+    int64_t offset = 0;
+    for (auto length : spilledPayloadLengths_) {
+      RETURN_NOT_OK(partitionWriter_->beginChunk());
+      RETURN_NOT_OK(partitionWriter_->dataFileOs_->Write(arrow::SliceBuffer(buffer, offset, length)));
+      RETURN_NOT_OK(partitionWriter_->endChunkIfFull());
+      offset += length;
+    }
 
     // close spilled file streams and delete the file
-    RETURN_NOT_OK(spilled_file_is_->Close());
-    auto fs = std::make_shared<arrow::fs::LocalFileSystem>();
-    RETURN_NOT_OK(fs->DeleteFile(spilledFile_));
-    bytes_spilled += nbytes;
+    buffer.reset();
+    RETURN_NOT_OK(spilledFileReader_->close());
+    spilledFileReader_.reset();
+    RETURN_NOT_OK(deleteSpilledFile(spilledFile_));
+    bytes_spilled += spilledBytes_;
     return arrow::Status::OK();
   }
 
-  arrow::Status writeSchemaPayload(arrow::io::OutputStream* os) {
-    std::shared_ptr<arrow::ipc::IpcPayload> payload;
-    if (shuffleWriter_->options().compression_type == arrow::Compression::type::UNCOMPRESSED) {
-      ARROW_ASSIGN_OR_RAISE(payload, partitionWriter_->getSchemaPayload(shuffleWriter_->writeSchema()));
-    } else {
-      ARROW_ASSIGN_OR_RAISE(payload, partitionWriter_->getSchemaPayload(shuffleWriter_->compressWriteSchema()));
-    }
-
+  arrow::Status writePayload(arrow::io::OutputStream* os, std::shared_ptr<arrow::ipc::IpcPayload>& payload) {
+#ifndef SKIPWRITE
     int32_t metadataLength = 0; // unused
     RETURN_NOT_OK(
         arrow::ipc::WriteIpcPayload(*payload, shuffleWriter_->options().ipc_write_options, os, &metadataLength));
+    payload = nullptr;
+#endif
     return arrow::Status::OK();
   }
 
-  arrow::Status writeRecordBatchPayload(arrow::io::OutputStream* os) {
-    int32_t metadataLength = 0; // unused
+  // Only writes to the spilled file, recording the payload lengths to cut push-merge chunks at.
+  arrow::Status writePayloads(
+      arrow::io::OutputStream* os,
+      std::vector<std::shared_ptr<arrow::ipc::IpcPayload>>& payloads) {
 #ifndef SKIPWRITE
-    for (auto& payload : shuffleWriter_->partitionCachedRecordbatch()[partitionId_]) {
-      RETURN_NOT_OK(
-          arrow::ipc::WriteIpcPayload(*payload, shuffleWriter_->options().ipc_write_options, os, &metadataLength));
-      payload = nullptr;
+    ARROW_ASSIGN_OR_RAISE(auto start, os->Tell());
+    for (auto& payload : payloads) {
+      RETURN_NOT_OK(writePayload(os, payload));
+      ARROW_ASSIGN_OR_RAISE(auto end, os->Tell());
+      spilledPayloadLengths_.push_back(end - start);
+      start = end;
     }
 #endif
     return arrow::Status::OK();
   }
 
-  arrow::Status writeEos(arrow::io::OutputStream* os) {
-    // This 0xFFFFFFFF value is the first 4 bytes of a valid IPC message
-    constexpr int32_t kIpcContinuationToken = -1;
-    constexpr int32_t kZeroLength = 0;
-    RETURN_NOT_OK(os->Write(&kIpcContinuationToken, sizeof(int32_t)));
-    RETURN_NOT_OK(os->Write(&kZeroLength, sizeof(int32_t)));
-    return arrow::Status::OK();
-  }
-
   void clearCache() {
     shuffleWriter_->partitionCachedRecordbatch()[partitionId_].clear();
     shuffleWriter_->setPartitionCachedRecordbatchSize(partitionId_, 0);
@@ -183,15 +363,35 @@ class PreferEvictPartitionWriter::LocalPartitionWriterInstance {
   PreferEvictPartitionWriter* partitionWriter_;
   ShuffleWriter* shuffleWriter_;
   uint32_t partitionId_;
-  std::string spilledFile_;
-  std::shared_ptr<arrow::io::FileOutputStream> spilledFileOs_;
+  LocalPartitionWriterBase::SpillDir spillDir_;
+  SpilledFile spilledFile_;
+  std::shared_ptr<arrow::io::OutputStream> spilledFileOs_;
+  std::unique_ptr<SpilledFileReader> spilledFileReader_;
+  int64_t spilledBytes_ = 0;
 
   bool spilledFileOpened_ = false;
+  // Written to spilledFile_ by one spill at a time.
+  std::vector<int64_t> spilledPayloadLengths_;
+
+  // Guarded by partitionWriter_->spillMutex_.
+  std::deque<PendingSpill> pendingSpills_;
+  bool spillScheduled_ = false;
 };
 
+PreferEvictPartitionWriter::~PreferEvictPartitionWriter() {
+  // Spill tasks hold a raw pointer to this writer.
+  if (spillExecutor_ != nullptr) {
+    (void)waitForSpills();
+  }
+}
+
 arrow::Status PreferEvictPartitionWriter::init() {
   partitionWriterInstances_.resize(shuffleWriter_->numPartitions());
   RETURN_NOT_OK(setLocalDirs());
+  if (shuffleWriter_->options().num_spill_threads > 0) {
+    ARROW_ASSIGN_OR_RAISE(
+        spillExecutor_, arrow::internal::ThreadPool::Make(shuffleWriter_->options().num_spill_threads));
+  }
   return arrow::Status::OK();
 }
 
@@ -213,13 +413,68 @@ arrow::Status PreferEvictPartitionWriter::evictPartition(int32_t partitionId) {
         std::make_shared<LocalPartitionWriterInstance>(this, shuffleWriter_, partitionId);
   }
   int64_t tempTotalEvictTime = 0;
-  TIME_NANO_OR_RAISE(tempTotalEvictTime, partitionWriterInstances_[partitionId]->spill());
+  if (spillExecutor_ != nullptr) {
+    // Only the time blocked on the in-flight budget is counted.
+    TIME_NANO_OR_RAISE(tempTotalEvictTime, evictPartitionAsync(partitionId));
+  } else {
+    TIME_NANO_OR_RAISE(tempTotalEvictTime, partitionWriterInstances_[partitionId]->spill());
+  }
   shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalEvictTime);
 
   return arrow::Status::OK();
 }
 
+arrow::Status PreferEvictPartitionWriter::evictPartitionAsync(int32_t partitionId) {
+  auto& cached = shuffleWriter_->partitionCachedRecordbatch()[partitionId];
+  if (cached.empty()) {
+    return arrow::Status::OK();
+  }
+  const auto& instance = partitionWriterInstances_[partitionId];
+  instance->prepareSpill(shuffleWriter_->partitionCachedRecordbatchSize()[partitionId]);
+
+  // Take over the payloads so that the task thread can keep caching into this partition.
+  auto size = shuffleWriter_->partitionCachedRecordbatchSize()[partitionId];
+  auto payloads = std::move(cached);
+  cached.clear();
+  shuffleWriter_->setPartitionCachedRecordbatchSize(partitionId, 0);
+
+  std::unique_lock<std::mutex> lock(spillMutex_);
+  auto maxInflightBytes = shuffleWriter_->options().max_inflight_spill_bytes;
+  spillCv_.wait(lock, [&] {
+    return !spillStatus_.ok() || inflightSpillBytes_ == 0 || inflightSpillBytes_ + size <= maxInflightBytes;
+  });
+  RETURN_NOT_OK(spillStatus_);
+
+  inflightSpillBytes_ += size;
+  if (instance->enqueueSpill(std::move(payloads), size)) {
+    ++activeSpillTasks_;
+    auto status = spillExecutor_->Spawn([instance]() { instance->drainPendingSpills(); });
+    if (!status.ok()) {
+      --activeSpillTasks_;
+      spillStatus_ = status;
+    }
+  }
+  return spillStatus_;
+}
+
+arrow::Status PreferEvictPartitionWriter::waitForSpills() {
+  std::unique_lock<std::mutex> lock(spillMutex_);
+  spillCv_.wait(lock, [this] { return activeSpillTasks_ == 0; });
+  return spillStatus_;
+}
+
+arrow::Status PreferEvictPartitionWriter::finishEvict() {
+  if (spillExecutor_ == nullptr) {
+    return arrow::Status::OK();
+  }
+  int64_t tempTotalEvictTime = 0;
+  TIME_NANO_OR_RAISE(tempTotalEvictTime, waitForSpills());
+  shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalEvictTime);
+  return arrow::Status::OK();
+}
+
 arrow::Status PreferEvictPartitionWriter::stop() {
+  RETURN_NOT_OK(finishEvict());
   RETURN_NOT_OK(openDataFile());
   // stop PartitionWriter and collect metrics
   for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
@@ -231,6 +486,13 @@ arrow::Status PreferEvictPartitionWriter::stop() {
     }
     if (partitionWriterInstances_[pid] != nullptr) {
       const auto& writer = partitionWriterInstances_[pid];
+      // Start reading the spill of the next spilled partition while merging this one.
+      for (auto next = pid + 1; next < shuffleWriter_->numPartitions(); ++next) {
+        if (partitionWriterInstances_[next] != nullptr) {
+          RETURN_NOT_OK(partitionWriterInstances_[next]->openSpilledForMerge());
+          break;
+        }
+      }
       int64_t tempTotalWriteTime = 0;
       TIME_NANO_OR_RAISE(tempTotalWriteTime, writer->writeCachedRecordBatchAndClose());
       shuffleWriter_->setTotalWriteTime(shuffleWriter_->totalWriteTime() + tempTotalWriteTime);
@@ -269,28 +531,46 @@ arrow::Status PreferCachePartitionWriter::evictPartition(int32_t partitionId /*
   int64_t evictTime = 0;
   TIME_NANO_START(evictTime)
 
-  ARROW_ASSIGN_OR_RAISE(auto spilledFile, createTempShuffleFile(nextSpilledFileDir()));
-  SpillInfo spillInfo{spilledFile};
+  int64_t cachedSize = 0;
+  for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
+    cachedSize += shuffleWriter_->partitionCachedRecordbatchSize()[pid];
+  }
+  auto spillDir = nextSpillDir(cachedSize);
+  SpillInfo spillInfo;
 
   // Spill all cached batches into one file, record their start and length.
-  ARROW_ASSIGN_OR_RAISE(auto spilledFileOs, arrow::io::FileOutputStream::Open(spilledFile, true));
-  for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
-    auto cachedPayloadSize = shuffleWriter_->partitionCachedRecordbatchSize()[pid];
-    if (cachedPayloadSize > 0) {
-      ARROW_ASSIGN_OR_RAISE(auto start, spilledFileOs->Tell());
-      RETURN_NOT_OK(flushCachedPayloads(spilledFileOs.get(), shuffleWriter_->partitionCachedRecordbatch()[pid]));
-      ARROW_ASSIGN_OR_RAISE(auto end, spilledFileOs->Tell());
-      spillInfo.partitionSpillInfos.push_back({pid, start, end - start});
+  auto spillAll = [&]() -> arrow::Status {
+    ARROW_ASSIGN_OR_RAISE(spillInfo.spilledFile, createSpilledFile(spillDir));
+    ARROW_ASSIGN_OR_RAISE(auto spilledFileOs, openSpillOutputStream(spillInfo.spilledFile));
+    for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
+      auto cachedPayloadSize = shuffleWriter_->partitionCachedRecordbatchSize()[pid];
+      if (cachedPayloadSize > 0) {
+        ARROW_ASSIGN_OR_RAISE(auto start, spilledFileOs->Tell());
+        std::vector<int64_t> payloadLengths;
+        RETURN_NOT_OK(flushCachedPayloads(
+            spilledFileOs.get(), shuffleWriter_->partitionCachedRecordbatch()[pid], payloadLengths));
+        ARROW_ASSIGN_OR_RAISE(auto end, spilledFileOs->Tell());
+        spillInfo.partitionSpillInfos.push_back({pid, start, end - start, std::move(payloadLengths)});
 #ifdef GLUTEN_PRINT_DEBUG
-      std::cout << "Spilled partition " << pid << " file start: " << start << ", file end: " << end
-                << ", cachedPayloadSize: " << cachedPayloadSize << std::endl;
+        std::cout << "Spilled partition " << pid << " file start: " << start << ", file end: " << end
+                  << ", cachedPayloadSize: " << cachedPayloadSize << std::endl;
 #endif
-      // clearCache();
-      shuffleWriter_->partitionCachedRecordbatch()[pid].clear();
-      shuffleWriter_->setPartitionCachedRecordbatchSize(pid, 0);
+        // clearCache();
+        shuffleWriter_->partitionCachedRecordbatch()[pid].clear();
+        shuffleWriter_->setPartitionCachedRecordbatchSize(pid, 0);
+      }
     }
-  }
-  RETURN_NOT_OK(spilledFileOs->Close());
+    ARROW_ASSIGN_OR_RAISE(spillInfo.spilledBytes, spilledFileOs->Tell());
+    return spilledFileOs->Close();
+  };
+  auto* selector = LocalDirSelector::instance();
+  selector->beginWrite(spillDir.accountedDir, cachedSize);
+  int64_t writeTime = 0;
+  TIME_NANO_START(writeTime)
+  auto status = spillAll();
+  TIME_NANO_END(writeTime)
+  selector->endWrite(spillDir.accountedDir, cachedSize, writeTime, status.ok());
+  RETURN_NOT_OK(status);
 
   TIME_NANO_END(evictTime)
   shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + evictTime);
@@ -310,39 +590,42 @@ arrow::Status PreferCachePartitionWriter::stop() {
   int64_t totalBytesWritten = 0;
   int64_t lastPayloadCompressTime = 0;
   auto numPartitions = shuffleWriter_->numPartitions();
-  auto writeSchema = shuffleWriter_->options().write_schema;
 
   TIME_NANO_START(totalWriteTime)
   // 0. Open final file
   RETURN_NOT_OK(openDataFile());
-  // 1. Open all spilled files, update totalBytesEvicted.
+  // 1. Open all spilled files to read their partitions in order, update totalBytesEvicted.
   std::vector<int32_t> spillInfoOffsets(spills_.size(), 0);
-  std::vector<std::shared_ptr<arrow::io::MemoryMappedFile>> spilledFiles;
+  std::vector<std::unique_ptr<SpilledFileReader>> spilledFiles;
   for (const auto& spill : spills_) {
-    ARROW_ASSIGN_OR_RAISE(auto is, arrow::io::MemoryMappedFile::Open(spill.spilledFile, arrow::io::FileMode::READ));
-    ARROW_ASSIGN_OR_RAISE(auto spilledSize, is->GetSize());
-    totalBytesEvicted += spilledSize;
-    spilledFiles.push_back(std::move(is));
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    for (const auto& partitionSpillInfo : spill.partitionSpillInfos) {
+      ranges.emplace_back(partitionSpillInfo.start, partitionSpillInfo.length);
+    }
+    ARROW_ASSIGN_OR_RAISE(auto reader, SpilledFileReader::open(spill.spilledFile, std::move(ranges)));
+    totalBytesEvicted += spill.spilledBytes;
+    spilledFiles.push_back(std::move(reader));
   }
   // 2. Iterator over pid
   for (auto pid = 0; pid < numPartitions; ++pid) {
-    bool firstWrite = true;
     // 3. Record start offset.
     ARROW_ASSIGN_OR_RAISE(auto startInFinalFile, dataFileOs_->Tell());
     // 4. Iterator over all spilled files
     for (auto i = 0; i < spills_.size(); ++i) {
-      auto partitionSpillInfo = spills_[i].partitionSpillInfos[spillInfoOffsets[i]];
+      if (spillInfoOffsets[i] == spills_[i].partitionSpillInfos.size()) {
+        continue;
+      }
+      auto& partitionSpillInfo = spills_[i].partitionSpillInfos[spillInfoOffsets[i]];
       // 5. read if partition exists in the spilled file and write to the final file
       if (partitionSpillInfo.partitionId == pid) { // A hit
-        if (firstWrite) {
-          // Write schema payload for this partition
-          if (writeSchema) {
-            RETURN_NOT_OK(writeSchemaPayload(dataFileOs_.get()));
-          }
-          firstWrite = false;
+        ARROW_ASSIGN_OR_RAISE(auto partition, spilledFiles[i]->next());
+        int64_t offset = 0;
+        for (auto length : partitionSpillInfo.payloadLengths) {
+          RETURN_NOT_OK(beginChunk());
+          RETURN_NOT_OK(dataFileOs_->Write(arrow::SliceBuffer(partition, offset, length)));
+          RETURN_NOT_OK(endChunkIfFull());
+          offset += length;
         }
-        ARROW_ASSIGN_OR_RAISE(auto raw, spilledFiles[i]->ReadAt(partitionSpillInfo.start, partitionSpillInfo.length));
-        RETURN_NOT_OK(dataFileOs_->Write(raw));
         // Goto next partition in this spillInfo
         spillInfoOffsets[i]++;
       }
@@ -350,14 +633,12 @@ arrow::Status PreferCachePartitionWriter::stop() {
     // 6. Write cached batches
     auto cachedPayloadSize = shuffleWriter_->partitionCachedRecordbatchSize()[pid];
     if (cachedPayloadSize > 0) {
-      if (firstWrite) {
-        // Write schema payload for this partition
-        if (writeSchema) {
-          RETURN_NOT_OK(writeSchemaPayload(dataFileOs_.get()));
-        }
-        firstWrite = false;
+      int32_t metadataLength = 0; // unused
+      for (auto& payload : shuffleWriter_->partitionCachedRecordbatch()[pid]) {
+        RETURN_NOT_OK(beginChunk());
+        RETURN_NOT_OK(flushCachedPayload(dataFileOs_.get(), payload, &metadataLength));
+        RETURN_NOT_OK(endChunkIfFull());
       }
-      RETURN_NOT_OK(flushCachedPayloads(dataFileOs_.get(), shuffleWriter_->partitionCachedRecordbatch()[pid]));
       // clearCache();
       shuffleWriter_->partitionCachedRecordbatch()[pid].clear();
       shuffleWriter_->setPartitionCachedRecordbatchSize(pid, 0);
@@ -365,13 +646,7 @@ arrow::Status PreferCachePartitionWriter::stop() {
     // 7. Write the last payload.
     ARROW_ASSIGN_OR_RAISE(auto rb, shuffleWriter_->createArrowRecordBatchFromBuffer(pid, true));
     if (rb) {
-      if (firstWrite) {
-        // Write schema payload for this partition
-        if (writeSchema) {
-          RETURN_NOT_OK(writeSchemaPayload(dataFileOs_.get()));
-        }
-        firstWrite = false;
-      }
+      RETURN_NOT_OK(beginChunk());
       // Record rawPartitionLength and flush the last payload.
       TIME_NANO_START(lastPayloadCompressTime)
       ARROW_ASSIGN_OR_RAISE(auto lastPayload, shuffleWriter_->createArrowIpcPayload(*rb, false));
@@ -383,25 +658,20 @@ arrow::Status PreferCachePartitionWriter::stop() {
       RETURN_NOT_OK(flushCachedPayload(dataFileOs_.get(), lastPayload, &metadataLength));
     }
     // 8. Write EOS if any payload written.
-    if (!firstWrite) {
-      if (shuffleWriter_->options().write_eos) {
-        RETURN_NOT_OK(writeEos(dataFileOs_.get()));
-      }
-    }
+    RETURN_NOT_OK(endChunk());
     ARROW_ASSIGN_OR_RAISE(auto endInFinalFile, dataFileOs_->Tell());
 
     shuffleWriter_->setPartitionLengths(pid, endInFinalFile - startInFinalFile);
   }
 
   // 9. close spilled file streams and delete the file
-  auto fs = std::make_shared<arrow::fs::LocalFileSystem>();
   for (auto i = 0; i < spills_.size(); ++i) {
     // Check if all spilled data are merged.
     if (spillInfoOffsets[i] != spills_[i].partitionSpillInfos.size()) {
       return arrow::Status::Invalid("Merging from spilled file NO." + std::to_string(i) + " is not exhausted.");
     }
-    RETURN_NOT_OK(spilledFiles[i]->Close());
-    RETURN_NOT_OK(fs->DeleteFile(spills_[i].spilledFile));
+    RETURN_NOT_OK(spilledFiles[i]->close());
+    RETURN_NOT_OK(deleteSpilledFile(spills_[i].spilledFile));
   }
 
   ARROW_ASSIGN_OR_RAISE(totalBytesWritten, dataFileOs_->Tell());
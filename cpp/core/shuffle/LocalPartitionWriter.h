@@ -18,9 +18,13 @@
 #pragma once
 
 #include <arrow/io/api.h>
+#include <arrow/util/thread_pool.h>
+#include <condition_variable>
+#include <mutex>
 
 #include "shuffle/PartitionWriter.h"
 #include "shuffle/ShuffleWriter.h"
+#include "shuffle/SpilledFile.h"
 
 #include "PartitionWriterCreator.h"
 #include "utils.h"
@@ -34,7 +38,22 @@ class LocalPartitionWriterBase : public ShuffleWriter::PartitionWriter {
 
   arrow::Status setLocalDirs();
 
-  std::string nextSpilledFileDir();
+  struct SpillDir {
+    std::string dir;
+    // The configured dir the writes are accounted to with LocalDirSelector.
+    std::string accountedDir;
+    bool remote = false;
+  };
+
+  // Picks the local dir to spill expectedBytes to with LocalDirSelector and a sub dir of it in turn. Once every local
+  // dir is full, picks a sub dir of the remote spill dir if configured. No IO, not thread safe.
+  SpillDir nextSpillDir(int64_t expectedBytes);
+
+  // Creates a new file under the dir. Thread safe.
+  arrow::Result<SpilledFile> createSpilledFile(const SpillDir& dir);
+
+  // Opens a spilled file of the non prefer-evict writer, through io_uring if enabled and local.
+  arrow::Result<std::shared_ptr<arrow::io::OutputStream>> openSpillOutputStream(const SpilledFile& file);
 
   arrow::Result<std::shared_ptr<arrow::ipc::IpcPayload>> getSchemaPayload(std::shared_ptr<arrow::Schema> schema);
 
@@ -42,24 +61,47 @@ class LocalPartitionWriterBase : public ShuffleWriter::PartitionWriter {
 
   virtual arrow::Status clearResource();
 
+  arrow::Status writeSchemaPayload(arrow::io::OutputStream* os);
+
+  arrow::Status writeEos(arrow::io::OutputStream* os);
+
+  // A partition is written to the data file as push-merge chunks of whole payloads, see
+  // ShuffleWriterOptions::push_merge_chunk_size. Call beginChunk() before writing each part of the partition,
+  // endChunkIfFull() after it and endChunk() after the last one. The schema and EOS are written here.
+  arrow::Status beginChunk();
+
+  arrow::Status endChunkIfFull();
+
+  arrow::Status endChunk();
+
   // configured local dirs for spilled file
-  int32_t dirSelection_ = 0;
   std::vector<int32_t> subDirSelection_;
   std::vector<std::string> configuredDirs_;
+  // Null if no remote spill dir is configured.
+  std::shared_ptr<arrow::fs::FileSystem> remoteSpillFs_;
+  std::string remoteSpillPath_;
+  int32_t remoteSubDirSelection_ = 0;
 
   // shared among all partitions
   std::shared_ptr<arrow::ipc::IpcPayload> schemaPayload_;
   std::shared_ptr<arrow::io::OutputStream> dataFileOs_;
+
+  bool chunkOpened_ = false;
+  int64_t chunkStart_ = 0;
 };
 
 class PreferEvictPartitionWriter : public LocalPartitionWriterBase {
  public:
   explicit PreferEvictPartitionWriter(ShuffleWriter* shuffleWriter) : LocalPartitionWriterBase(shuffleWriter) {}
 
+  ~PreferEvictPartitionWriter() override;
+
   arrow::Status init() override;
 
   arrow::Status evictPartition(int32_t partitionId) override;
 
+  arrow::Status finishEvict() override;
+
   arrow::Status stop() override;
 
   class LocalPartitionWriterInstance;
@@ -68,6 +110,23 @@ class PreferEvictPartitionWriter : public LocalPartitionWriterBase {
 
  private:
   arrow::Status clearResource() override;
+
+  // Hand the cached payloads of the partition over to the spill executor. Only blocks when the in-flight budget is
+  // exhausted.
+  arrow::Status evictPartitionAsync(int32_t partitionId);
+
+  // Wait for all pending spills to be written out.
+  arrow::Status waitForSpills();
+
+  // Background spill. Null if spilling synchronously.
+  std::shared_ptr<arrow::internal::ThreadPool> spillExecutor_;
+
+  // Guards all below, together with the pending spills of each LocalPartitionWriterInstance.
+  std::mutex spillMutex_;
+  std::condition_variable spillCv_;
+  int64_t inflightSpillBytes_ = 0;
+  int32_t activeSpillTasks_ = 0;
+  arrow::Status spillStatus_;
 };
 
 class PreferCachePartitionWriter : public LocalPartitionWriterBase {
@@ -83,20 +142,6 @@ class PreferCachePartitionWriter : public LocalPartitionWriterBase {
  private:
   arrow::Status clearResource() override;
 
-  // TODO: helper methods
-  arrow::Status writeSchemaPayload(arrow::io::OutputStream* os) {
-    std::shared_ptr<arrow::ipc::IpcPayload> payload;
-    if (shuffleWriter_->options().compression_type == arrow::Compression::type::UNCOMPRESSED) {
-      ARROW_ASSIGN_OR_RAISE(payload, getSchemaPayload(shuffleWriter_->writeSchema()));
-    } else {
-      ARROW_ASSIGN_OR_RAISE(payload, getSchemaPayload(shuffleWriter_->compressWriteSchema()));
-    }
-    int32_t metadataLength = 0; // unused
-    RETURN_NOT_OK(
-        arrow::ipc::WriteIpcPayload(*payload, shuffleWriter_->options().ipc_write_options, os, &metadataLength));
-    return arrow::Status::OK();
-  }
-
   arrow::Status flushCachedPayload(
       arrow::io::OutputStream* os,
       std::shared_ptr<arrow::ipc::IpcPayload>& payload,
@@ -110,33 +155,33 @@ class PreferCachePartitionWriter : public LocalPartitionWriterBase {
     return arrow::Status::OK();
   }
 
+  // Appends the length of each payload to payloadLengths.
   arrow::Status flushCachedPayloads(
       arrow::io::OutputStream* os,
-      std::vector<std::shared_ptr<arrow::ipc::IpcPayload>>& payloads) {
+      std::vector<std::shared_ptr<arrow::ipc::IpcPayload>>& payloads,
+      std::vector<int64_t>& payloadLengths) {
     int32_t metadataLength = 0; // unused
+    ARROW_ASSIGN_OR_RAISE(auto start, os->Tell());
     for (auto& payload : payloads) {
       RETURN_NOT_OK(flushCachedPayload(os, payload, &metadataLength));
+      ARROW_ASSIGN_OR_RAISE(auto end, os->Tell());
+      payloadLengths.push_back(end - start);
+      start = end;
     }
     return arrow::Status::OK();
   }
 
-  arrow::Status writeEos(arrow::io::OutputStream* os) {
-    // write EOS
-    constexpr int32_t kIpcContinuationToken = -1;
-    constexpr int32_t kZeroLength = 0;
-    RETURN_NOT_OK(os->Write(&kIpcContinuationToken, sizeof(int32_t)));
-    RETURN_NOT_OK(os->Write(&kZeroLength, sizeof(int32_t)));
-    return arrow::Status::OK();
-  }
-
   struct PartitionSpillInfo {
     int32_t partitionId;
     int64_t start;
     int64_t length; // in Bytes
+    // Where push-merge chunks may be cut.
+    std::vector<int64_t> payloadLengths;
   };
 
   struct SpillInfo {
-    std::string spilledFile;
+    SpilledFile spilledFile;
+    int64_t spilledBytes = 0;
     std::vector<PartitionSpillInfo> partitionSpillInfos;
   };
 
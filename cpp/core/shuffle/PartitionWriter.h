@@ -30,6 +30,11 @@ class ShuffleWriter::PartitionWriter {
 
   virtual arrow::Status evictPartition(int32_t partitionId) = 0;
 
+  // Block until all evicted partitions are written out and their memory is released.
+  virtual arrow::Status finishEvict() {
+    return arrow::Status::OK();
+  }
+
   virtual arrow::Status stop() = 0;
 
   ShuffleWriter* shuffleWriter_;
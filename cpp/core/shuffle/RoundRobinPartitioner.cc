@@ -26,6 +26,23 @@ arrow::Status gluten::RoundRobinPartitioner::compute(
     std::vector<uint32_t>& partitionIdCnt) {
   std::fill(std::begin(partitionIdCnt), std::end(partitionIdCnt), 0);
   partitionId.resize(numRows);
+  if (pidArr != nullptr) {
+    // pidArr holds the rank of each row in a clustering order. Consecutive ranks go to the same partition, and each
+    // partition gets as many rows as without clustering: numRows / numPartitions_, one more for the first
+    // numRows % numPartitions_ partitions from pidSelection_.
+    const int64_t base = numRows / numPartitions_;
+    const int64_t extra = numRows % numPartitions_;
+    const int64_t extraRows = extra * (base + 1);
+    for (auto i = 0; i < numRows; ++i) {
+      const int64_t rank = pidArr[i];
+      auto group = rank < extraRows ? rank / (base + 1) : extra + (rank - extraRows) / base;
+      auto pid = (pidSelection_ + group) % numPartitions_;
+      partitionId[i] = pid;
+      partitionIdCnt[pid]++;
+    }
+    pidSelection_ = (pidSelection_ + extra) % numPartitions_;
+    return arrow::Status::OK();
+  }
   for (auto& pid : partitionId) {
     pid = pidSelection_;
     partitionIdCnt[pidSelection_]++;
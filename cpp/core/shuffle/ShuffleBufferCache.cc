@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/ShuffleBufferCache.h"
+
+#include "memory/ArrowMemoryPool.h"
+
+namespace gluten {
+
+namespace {
+static constexpr int32_t kMinSizeClass = 6;
+static constexpr int32_t kMaxSizeClass = 40;
+static constexpr int64_t kCacheBufferAlignment = 64;
+} // namespace
+
+// Hands its block back to the cache and uncharges the task once destroyed.
+class ShuffleBufferCache::CachedBuffer final : public arrow::MutableBuffer {
+ public:
+  CachedBuffer(uint8_t* data, int32_t sizeClass, ShuffleBufferCache* cache, AllocationListener* listener)
+      : arrow::MutableBuffer(data, 1LL << sizeClass),
+        block_(data),
+        sizeClass_(sizeClass),
+        cache_(cache),
+        listener_(listener) {}
+
+  ~CachedBuffer() override {
+    cache_->release(block_, sizeClass_);
+    listener_->allocationChanged(-(1LL << sizeClass_));
+  }
+
+ private:
+  uint8_t* block_;
+  const int32_t sizeClass_;
+  ShuffleBufferCache* cache_;
+  AllocationListener* listener_;
+};
+
+ShuffleBufferCache* ShuffleBufferCache::instance(int64_t capacity) {
+  static auto cache = std::make_unique<ShuffleBufferCache>(capacity);
+  return cache.get();
+}
+
+ShuffleBufferCache::ShuffleBufferCache(int64_t capacity)
+    : capacity_(capacity), pool_(defaultArrowMemoryPool()), freeLists_(kMaxSizeClass + 1) {}
+
+ShuffleBufferCache::~ShuffleBufferCache() {
+  for (int32_t sizeClass = 0; sizeClass <= kMaxSizeClass; ++sizeClass) {
+    for (auto* data : freeLists_[sizeClass]) {
+      pool_->Free(data, 1LL << sizeClass, kCacheBufferAlignment);
+    }
+  }
+}
+
+int32_t ShuffleBufferCache::sizeClassOf(int64_t size) {
+  int32_t sizeClass = kMinSizeClass;
+  while (sizeClass < kMaxSizeClass && (1LL << sizeClass) < size) {
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+
+int64_t ShuffleBufferCache::cachedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cachedBytes_;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+ShuffleBufferCache::allocate(int64_t size, AllocationListener* listener, bool& hit) {
+  auto sizeClass = sizeClassOf(size);
+  if ((1LL << sizeClass) < size) {
+    return arrow::Status::Invalid("Shuffle buffer of ", size, " bytes exceeds the largest size class.");
+  }
+  // Charge first so that the task may spill before it owns more memory.
+  listener->allocationChanged(1LL << sizeClass);
+  auto data = acquire(sizeClass, hit);
+  if (!data.ok()) {
+    listener->allocationChanged(-(1LL << sizeClass));
+    return data.status();
+  }
+  return std::make_shared<CachedBuffer>(*data, sizeClass, this, listener);
+}
+
+arrow::Result<uint8_t*> ShuffleBufferCache::acquire(int32_t sizeClass, bool& hit) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& freeList = freeLists_[sizeClass];
+    if (!freeList.empty()) {
+      auto* data = freeList.back();
+      freeList.pop_back();
+      cachedBytes_ -= 1LL << sizeClass;
+      hit = true;
+      return data;
+    }
+  }
+  hit = false;
+  uint8_t* data;
+  RETURN_NOT_OK(pool_->Allocate(1LL << sizeClass, kCacheBufferAlignment, &data));
+  return data;
+}
+
+void ShuffleBufferCache::release(uint8_t* data, int32_t sizeClass) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cachedBytes_ + (1LL << sizeClass) <= capacity_) {
+      freeLists_[sizeClass].push_back(data);
+      cachedBytes_ += 1LL << sizeClass;
+      return;
+    }
+  }
+  pool_->Free(data, 1LL << sizeClass, kCacheBufferAlignment);
+}
+
+} // namespace gluten
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/result.h>
+
+#include <mutex>
+#include <vector>
+
+#include "memory/MemoryAllocator.h"
+
+namespace gluten {
+
+// Executor wide free lists of shuffle buffer memory, one per power of two size class. Buffers released by a finished
+// writer are handed to the next task instead of going back to the allocator. The memory is taken from the process
+// pool; while a task holds a block it is charged to the task through its AllocationListener, blocks on the free
+// lists are charged to nobody. Thread safe.
+class ShuffleBufferCache {
+ public:
+  // Shared by all shuffle writers in the executor, sized by the first writer asking for it.
+  static ShuffleBufferCache* instance(int64_t capacity);
+
+  // capacity is the maximum number of bytes kept on the free lists.
+  explicit ShuffleBufferCache(int64_t capacity);
+
+  ~ShuffleBufferCache();
+
+  // Returns a buffer of at least size bytes charged to listener. The memory goes back to the cache when the buffer
+  // and all slices of it are destroyed, so listener must outlive them.
+  arrow::Result<std::shared_ptr<arrow::Buffer>> allocate(int64_t size, AllocationListener* listener, bool& hit);
+
+  static int32_t sizeClassOf(int64_t size);
+
+  int64_t cachedBytes() const;
+
+ private:
+  class CachedBuffer;
+
+  arrow::Result<uint8_t*> acquire(int32_t sizeClass, bool& hit);
+
+  void release(uint8_t* data, int32_t sizeClass);
+
+  const int64_t capacity_;
+  // Taken at construction so that the process pool outlives the cache.
+  std::shared_ptr<arrow::MemoryPool> pool_;
+  mutable std::mutex mutex_;
+  std::vector<std::vector<uint8_t*>> freeLists_;
+  int64_t cachedBytes_ = 0;
+};
+
+} // namespace gluten
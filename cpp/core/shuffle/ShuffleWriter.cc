@@ -33,20 +33,49 @@ ShuffleWriterOptions ShuffleWriterOptions::defaults() {
   return {};
 }
 
+ShuffleBufferPool::ShuffleBufferPool(std::shared_ptr<arrow::MemoryPool> pool, int64_t cacheCapacity)
+    : pool_(std::move(pool)) {
+  if (cacheCapacity <= 0) {
+    return;
+  }
+  // Cached blocks bypass pool, so they can only be used if the task's listener can be charged directly.
+  if (auto* arrowPool = dynamic_cast<ArrowMemoryPool*>(pool_.get())) {
+    if (auto* allocator = dynamic_cast<ListenableMemoryAllocator*>(arrowPool->allocator())) {
+      listener_ = allocator->listener();
+      cache_ = ShuffleBufferCache::instance(cacheCapacity);
+    }
+  }
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> ShuffleBufferPool::allocateBlock(int64_t size) {
+  if (cache_ == nullptr) {
+    ARROW_ASSIGN_OR_RAISE(std::shared_ptr<arrow::Buffer> buffer, arrow::AllocateBuffer(size, pool_.get()));
+    return buffer;
+  }
+  bool hit;
+  ARROW_ASSIGN_OR_RAISE(auto buffer, cache_->allocate(size, listener_, hit));
+  ++cacheRequests_;
+  cacheHits_ += hit;
+  return buffer;
+}
+
 arrow::Status ShuffleBufferPool::allocate(std::shared_ptr<arrow::Buffer>& buffer, int64_t size) {
   // if size is already larger than buffer pool size, allocate it directly
   // make size 64byte aligned
   size = ROUND_TO_LINE(size, kDefaultBufferAlignment);
   if (size > SPLIT_BUFFER_SIZE) {
-    ARROW_ASSIGN_OR_RAISE(buffer, arrow::AllocateResizableBuffer(size, pool_.get()));
+    ARROW_ASSIGN_OR_RAISE(buffer, allocateBlock(size));
+    if (buffer->size() != size) {
+      buffer = arrow::SliceMutableBuffer(buffer, 0, size);
+    }
     return arrow::Status::OK();
-  } else if (combineBuffer_->capacity() - combineBuffer_->size() < size) {
+  } else if (combineBuffer_ == nullptr || combineBuffer_->size() - combineBufferUsed_ < size) {
     // memory pool is not enough
-    ARROW_ASSIGN_OR_RAISE(combineBuffer_, arrow::AllocateResizableBuffer(SPLIT_BUFFER_SIZE, pool_.get()));
-    RETURN_NOT_OK(combineBuffer_->Resize(0, /*shrink_to_fit = */ false));
+    ARROW_ASSIGN_OR_RAISE(combineBuffer_, allocateBlock(SPLIT_BUFFER_SIZE));
+    combineBufferUsed_ = 0;
   }
-  buffer = arrow::SliceMutableBuffer(combineBuffer_, combineBuffer_->size(), size);
-  RETURN_NOT_OK(combineBuffer_->Resize(combineBuffer_->size() + size, /*shrink_to_fit = */ false));
+  buffer = arrow::SliceMutableBuffer(combineBuffer_, combineBufferUsed_, size);
+  combineBufferUsed_ += size;
   return arrow::Status::OK();
 }
 
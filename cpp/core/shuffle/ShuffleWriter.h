@@ -23,8 +23,13 @@
 
 #include "memory/ArrowMemoryPool.h"
 #include "memory/ColumnarBatch.h"
+#include "shuffle/ShuffleBufferCache.h"
 #include "utils/compression.h"
 
+namespace folly {
+class Executor;
+} // namespace folly
+
 namespace gluten {
 
 namespace {
@@ -32,8 +37,27 @@ static constexpr int32_t kDefaultShuffleWriterBufferSize = 4096;
 static constexpr int32_t kDefaultNumSubDirs = 64;
 static constexpr int32_t kDefaultBufferCompressThreshold = 1024;
 static constexpr int32_t kDefaultBufferAlignment = 64;
+static constexpr int64_t kDefaultSortBufferThreshold = 64 << 20;
+static constexpr int64_t kDefaultMaxInflightSpillBytes = 64 << 20;
+static constexpr int64_t kDefaultRemoteSpillBufferSize = 8 << 20;
+static constexpr int32_t kDefaultParallelSplitThreshold = 8192;
+static constexpr int64_t kDefaultPushBatchSize = 1 << 20;
+static constexpr int64_t kDefaultMaxInflightPushBytes = 64 << 20;
 } // namespace
 
+// Shuffle writer types.
+// "hash": split each input batch into per-partition buffers.
+// "sort": buffer input batches, sort the row references by partition id and write one run per partition.
+const std::string kHashShuffleWriterType = "hash";
+const std::string kSortShuffleWriterType = "sort";
+
+// A key of range partitioning: the input column and its ordering.
+struct RangePartitionKey {
+  int32_t column;
+  bool ascending = true;
+  bool nulls_first = true;
+};
+
 struct ShuffleWriterOptions {
   int64_t offheap_per_task = 0;
   int32_t buffer_size = kDefaultShuffleWriterBufferSize;
@@ -43,13 +67,76 @@ struct ShuffleWriterOptions {
   arrow::Compression::type compression_type = arrow::Compression::LZ4_FRAME;
   CodecBackend codec_backend = CodecBackend::NONE;
   std::shared_ptr<arrow::util::Codec> codec = createArrowIpcCodec(compression_type, codec_backend);
+  // Choose raw, LZ4, ZSTD or bit packing for each buffer with compression_type LZ4_FRAME or ZSTD.
+  bool adaptive_compression = false;
+  // With adaptive_compression, train a ZSTD dictionary for each buffer index of the payloads from its first buffers.
+  // Helps small partitions. 0 disables dictionaries.
+  int32_t zstd_dictionary_training_buffers = 0;
+  // Send the string columns that come dictionary encoded as per payload dictionaries and indices when it's smaller.
+  bool string_dictionary_encoding = false;
+  // Send the columns that come constant or all null as their one value, or no value, when a payload has no other.
+  bool elide_constant_columns = false;
+  // Only for round robin partitioning. Order the rows of each batch by the hashes of their columns and send runs of
+  // consecutive rows to each partition, so that similar rows share a partition and compress better. The partition
+  // sizes stay those of plain round robin.
+  bool round_robin_clustering = false;
+  // Carry the CRC32C of each payload in its header, which the reader verifies before decompressing it.
+  bool block_checksum = false;
   bool prefer_evict = false;
   bool write_schema = false;
   bool buffered_write = false;
   bool write_eos = true;
+  // Only for local partition writer. Cut the output of each partition into chunks at payload boundaries, once a chunk
+  // reaches this many bytes. Each chunk starts with the schema and ends with EOS as configured and can be read on its
+  // own, so that push based shuffle can push and merge them as blocks. 0 writes each partition as one block.
+  int64_t push_merge_chunk_size = 0;
 
   std::string data_file;
   std::string partition_writer_type = "local";
+  std::string shuffle_writer_type = kHashShuffleWriterType;
+
+  // Only for sort based shuffle writer. Buffered input size in bytes that triggers sorting and caching.
+  int64_t sort_buffer_threshold = kDefaultSortBufferThreshold;
+
+  // Only for prefer evict local partition writer. Number of background threads writing evicted partitions.
+  // 0 means evicted partitions are written synchronously on the task thread.
+  int32_t num_spill_threads = 0;
+  // Evicted bytes not yet written out. Eviction blocks the task thread once this budget is exhausted.
+  int64_t max_inflight_spill_bytes = kDefaultMaxInflightSpillBytes;
+  // Only for local partition writer. URI of the dir to spill to once every local dir is full, e.g. hdfs://host/tmp.
+  // Empty fails the spill on the local dir instead.
+  std::string remote_spill_dir;
+  // Writes of the non prefer-evict writer to the remote spill dir are buffered to this many bytes.
+  int64_t remote_spill_buffer_size = kDefaultRemoteSpillBufferSize;
+  // Only for local partition writer. Writes the data file and the local spills of the non prefer-evict writer through
+  // io_uring, overlapping the writes with the serialization. Falls back to plain writes if io_uring isn't available.
+  bool io_uring = false;
+  // With io_uring, bypasses the page cache with O_DIRECT where the file system supports it.
+  bool io_uring_direct = false;
+
+  // Column groups of a batch split concurrently on split_executor besides the task thread. 0 splits on the task
+  // thread only.
+  int32_t num_split_threads = 0;
+  // Owned by the backend, shared by the writers of the executor.
+  folly::Executor* split_executor = nullptr;
+  // Batches with fewer rows are always split on the task thread.
+  int32_t parallel_split_threshold = kDefaultParallelSplitThreshold;
+
+  // Only for celeborn partition writer. Push evicted partitions from a background thread, several partitions per
+  // call, overlapping with split.
+  bool async_push = false;
+  // Serialized bytes of evicted partitions collected before they are pushed together.
+  int64_t push_batch_size = kDefaultPushBatchSize;
+  // Serialized bytes not yet pushed. Eviction blocks the task thread once this budget is exhausted.
+  int64_t max_inflight_push_bytes = kDefaultMaxInflightPushBytes;
+
+  // Bytes of split buffers kept by the executor wide ShuffleBufferCache for later tasks. 0 disables the cache.
+  int64_t buffer_cache_capacity = 0;
+
+  // Back the large IPC buffers of the non prefer-evict writer with transparent huge pages, and prefer the NUMA node
+  // of the task thread for them.
+  bool ipc_huge_pages = false;
+  bool ipc_numa_bind = false;
 
   int64_t thread_id = -1;
   int64_t task_attempt_id = -1;
@@ -63,17 +150,28 @@ struct ShuffleWriterOptions {
 
   std::string partitioning_name;
 
+  // Only for hash partitioning. If set, the writer computes Spark's murmur3 hash of these columns itself instead of
+  // reading it from a leading partition id column.
+  std::vector<int32_t> hash_partition_key_ids;
+
+  // Only for range partitioning. If range_bounds is set, the writer computes the partition id of each row itself, as
+  // the number of bounds less than the keys of the row, instead of reading it from a leading partition id batch. The
+  // bounds hold one column per key of range_partition_keys and are sorted by them.
+  std::vector<RangePartitionKey> range_partition_keys;
+  std::shared_ptr<ColumnarBatch> range_bounds;
+
   static ShuffleWriterOptions defaults();
 };
 
 class ShuffleBufferPool {
  public:
-  explicit ShuffleBufferPool(std::shared_ptr<arrow::MemoryPool> pool) : pool_(pool) {}
+  // With cacheCapacity > 0, split buffers are recycled through the executor wide ShuffleBufferCache if the memory of
+  // pool is tracked by an AllocationListener.
+  explicit ShuffleBufferPool(std::shared_ptr<arrow::MemoryPool> pool, int64_t cacheCapacity = 0);
 
   arrow::Status init() {
-    // Allocate first buffer for split reducer
-    ARROW_ASSIGN_OR_RAISE(combineBuffer_, arrow::AllocateResizableBuffer(0, pool_.get()));
-    RETURN_NOT_OK(combineBuffer_->Resize(0, /*shrink_to_fit =*/false));
+    combineBuffer_.reset();
+    combineBufferUsed_ = 0;
     return arrow::Status::OK();
   }
 
@@ -85,13 +183,30 @@ class ShuffleBufferPool {
     if (combineBuffer_ != nullptr) {
       combineBuffer_.reset();
     }
+    combineBufferUsed_ = 0;
+  }
+
+  // Blocks taken from / found in the ShuffleBufferCache.
+  int64_t cacheRequests() const {
+    return cacheRequests_;
+  }
+
+  int64_t cacheHits() const {
+    return cacheHits_;
   }
 
  private:
+  arrow::Result<std::shared_ptr<arrow::Buffer>> allocateBlock(int64_t size);
+
   std::shared_ptr<arrow::MemoryPool> pool_;
+  ShuffleBufferCache* cache_ = nullptr;
+  AllocationListener* listener_ = nullptr;
   // slice the buffer for each reducer's column, in this way we can combine into
   // large page
-  std::shared_ptr<arrow::ResizableBuffer> combineBuffer_;
+  std::shared_ptr<arrow::Buffer> combineBuffer_;
+  int64_t combineBufferUsed_ = 0;
+  int64_t cacheRequests_ = 0;
+  int64_t cacheHits_ = 0;
 };
 
 class ShuffleWriter {
@@ -154,6 +269,11 @@ class ShuffleWriter {
     return totalCompressTime_;
   }
 
+  // Nanos spent in the phases of split by name, reported to Spark as the metrics of the same names if defined.
+  virtual std::vector<std::pair<std::string, int64_t>> splitPhaseTimes() const {
+    return {};
+  }
+
   const std::vector<int64_t>& partitionLengths() const {
     return partitionLengths_;
   }
@@ -162,6 +282,12 @@ class ShuffleWriter {
     return rawPartitionLengths_;
   }
 
+  // The lengths of the push-merge chunks of all partitions in partition order. The chunks of a partition add up to its
+  // length. Empty without ShuffleWriterOptions::push_merge_chunk_size.
+  const std::vector<int64_t>& partitionChunkLengths() const {
+    return partitionChunkLengths_;
+  }
+
   const std::vector<int64_t>& partitionCachedRecordbatchSize() const {
     return partitionCachedRecordbatchSize_;
   }
@@ -194,6 +320,10 @@ class ShuffleWriter {
     rawPartitionLengths_[index] = length;
   }
 
+  void addPartitionChunkLength(int64_t length) {
+    partitionChunkLengths_.push_back(length);
+  }
+
   void setTotalWriteTime(int64_t totalWriteTime) {
     totalWriteTime_ = totalWriteTime;
   }
@@ -228,7 +358,7 @@ class ShuffleWriter {
       : numPartitions_(numPartitions),
         partitionWriterCreator_(std::move(partitionWriterCreator)),
         options_(std::move(options)),
-        pool_(std::make_shared<ShuffleBufferPool>(options_.memory_pool)) {}
+        pool_(std::make_shared<ShuffleBufferPool>(options_.memory_pool, options_.buffer_cache_capacity)) {}
   virtual ~ShuffleWriter() = default;
 
   int32_t numPartitions_;
@@ -246,6 +376,7 @@ class ShuffleWriter {
 
   std::vector<int64_t> partitionLengths_;
   std::vector<int64_t> rawPartitionLengths_;
+  std::vector<int64_t> partitionChunkLengths_;
 
   std::shared_ptr<arrow::Schema> schema_;
   std::shared_ptr<arrow::Schema> writeSchema_;
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/SpilledFile.h"
+#include "shuffle/utils.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace gluten {
+
+arrow::Result<std::pair<std::shared_ptr<arrow::fs::FileSystem>, std::string>> getRemoteSpillFileSystem(
+    const std::string& uri) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::pair<std::shared_ptr<arrow::fs::FileSystem>, std::string>> fileSystems;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = fileSystems.find(uri);
+  if (it != fileSystems.end()) {
+    return it->second;
+  }
+  std::string path;
+  ARROW_ASSIGN_OR_RAISE(auto fs, arrow::fs::FileSystemFromUri(uri, &path));
+  auto result = std::make_pair(std::move(fs), std::move(path));
+  fileSystems.emplace(uri, result);
+  return result;
+}
+
+arrow::Result<SpilledFile> createRemoteSpilledFile(std::shared_ptr<arrow::fs::FileSystem> fs, const std::string& dir) {
+  RETURN_NOT_OK(fs->CreateDir(dir, true));
+  // The name is unique, no need for a round trip to the remote storage to check it.
+  auto path = arrow::fs::internal::ConcatAbstractPath(dir, "temp_shuffle_" + generateUuid());
+  return SpilledFile{std::move(fs), std::move(path), true};
+}
+
+arrow::Result<std::shared_ptr<arrow::io::OutputStream>>
+openSpilledFileForWrite(const SpilledFile& file, int64_t bufferSize, arrow::MemoryPool* pool) {
+  if (!file.remote) {
+    return arrow::io::FileOutputStream::Open(file.path, true);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto os, file.fs->OpenOutputStream(file.path));
+  if (bufferSize <= 0) {
+    return os;
+  }
+  return arrow::io::BufferedOutputStream::Create(bufferSize, pool, std::move(os));
+}
+
+arrow::Status deleteSpilledFile(const SpilledFile& file) {
+  return file.fs->DeleteFile(file.path);
+}
+
+arrow::Result<std::unique_ptr<SpilledFileReader>> SpilledFileReader::open(
+    const SpilledFile& file,
+    std::vector<std::pair<int64_t, int64_t>> ranges) {
+  std::shared_ptr<arrow::io::RandomAccessFile> in;
+  if (file.remote) {
+    ARROW_ASSIGN_OR_RAISE(in, file.fs->OpenInputFile(file.path));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(in, arrow::io::MemoryMappedFile::Open(file.path, arrow::io::FileMode::READ));
+  }
+  std::unique_ptr<SpilledFileReader> reader(new SpilledFileReader(std::move(in), std::move(ranges), file.remote));
+  reader->prefetch();
+  return reader;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> SpilledFileReader::next() {
+  if (nextRange_ >= ranges_.size()) {
+    return arrow::Status::Invalid("Spilled file has no range left to read.");
+  }
+  if (!remote_) {
+    auto [offset, length] = ranges_[nextRange_++];
+    return file_->ReadAt(offset, length);
+  }
+  auto pending = std::move(*pending_);
+  pending_.reset();
+  ++nextRange_;
+  prefetch();
+  return pending.result();
+}
+
+arrow::Status SpilledFileReader::close() {
+  if (pending_.has_value()) {
+    // The file must outlive the read in flight.
+    (void)pending_->result();
+    pending_.reset();
+  }
+  return file_->Close();
+}
+
+void SpilledFileReader::prefetch() {
+  if (!remote_ || nextRange_ >= ranges_.size()) {
+    return;
+  }
+  auto [offset, length] = ranges_[nextRange_];
+  pending_ = file_->ReadAsync(arrow::io::default_io_context(), offset, length);
+}
+
+} // namespace gluten
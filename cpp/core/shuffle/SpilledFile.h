@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/filesystem/filesystem.h>
+#include <arrow/io/api.h>
+#include <arrow/util/future.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gluten {
+
+// A file the local partition writer spills to, under a local dir or under the remote spill dir once the local dirs
+// are full.
+struct SpilledFile {
+  std::shared_ptr<arrow::fs::FileSystem> fs;
+  std::string path;
+  bool remote = false;
+};
+
+// The file system of the remote spill dir uri and the path of the dir on it. The file systems are shared by the
+// writers of the executor. The scheme must be one Arrow is built with, e.g. hdfs with ARROW_HDFS.
+arrow::Result<std::pair<std::shared_ptr<arrow::fs::FileSystem>, std::string>> getRemoteSpillFileSystem(
+    const std::string& uri);
+
+// Creates the dir if needed and names a new file under it, created when opened for write.
+arrow::Result<SpilledFile> createRemoteSpilledFile(std::shared_ptr<arrow::fs::FileSystem> fs, const std::string& dir);
+
+// Remote files are written through a buffer of bufferSize, for large sequential writes. 0 writes them unbuffered.
+arrow::Result<std::shared_ptr<arrow::io::OutputStream>>
+openSpilledFileForWrite(const SpilledFile& file, int64_t bufferSize, arrow::MemoryPool* pool);
+
+arrow::Status deleteSpilledFile(const SpilledFile& file);
+
+// Reads the ranges of a spilled file in order. A local file is mapped. The next range of a remote file is read in the
+// background while the current one is consumed.
+class SpilledFileReader {
+ public:
+  // A range is an offset and a length.
+  static arrow::Result<std::unique_ptr<SpilledFileReader>> open(
+      const SpilledFile& file,
+      std::vector<std::pair<int64_t, int64_t>> ranges);
+
+  // The next range.
+  arrow::Result<std::shared_ptr<arrow::Buffer>> next();
+
+  arrow::Status close();
+
+ private:
+  SpilledFileReader(
+      std::shared_ptr<arrow::io::RandomAccessFile> file,
+      std::vector<std::pair<int64_t, int64_t>> ranges,
+      bool remote)
+      : file_(std::move(file)), ranges_(std::move(ranges)), remote_(remote) {}
+
+  // Remote only. Starts reading the next range.
+  void prefetch();
+
+  std::shared_ptr<arrow::io::RandomAccessFile> file_;
+  std::vector<std::pair<int64_t, int64_t>> ranges_;
+  bool remote_;
+  size_t nextRange_ = 0;
+  // The read of ranges_[nextRange_] once prefetched.
+  std::optional<arrow::Future<std::shared_ptr<arrow::Buffer>>> pending_;
+};
+
+} // namespace gluten
@@ -0,0 +1,344 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/UringFileOutputStream.h"
+
+#include <arrow/io/file.h>
+#include <arrow/util/io_util.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace gluten {
+
+namespace {
+// Direct IO needs the buffers, their sizes and the file offsets aligned to the logical block size of the device.
+static constexpr int64_t kDirectIoAlignment = 4096;
+} // namespace
+
+// The submission and completion queues shared with the kernel, set up with the raw syscalls so that liburing isn't
+// needed. Only the stream owning the ring submits to it and reaps it.
+struct UringFileOutputStream::Ring {
+  int fd = -1;
+  void* sqRing = MAP_FAILED;
+  size_t sqRingSize = 0;
+  void* cqRing = MAP_FAILED;
+  size_t cqRingSize = 0;
+  io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqesSize = 0;
+
+  unsigned* sqTail = nullptr;
+  unsigned* sqMask = nullptr;
+  unsigned* sqArray = nullptr;
+  unsigned* cqHead = nullptr;
+  unsigned* cqTail = nullptr;
+  unsigned* cqMask = nullptr;
+  io_uring_cqe* cqes = nullptr;
+  // Queued and not yet passed to io_uring_enter.
+  unsigned toSubmit = 0;
+
+  static arrow::Result<std::unique_ptr<Ring>> make(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    auto ring = std::make_unique<Ring>();
+    ring->fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->fd < 0) {
+      return arrow::internal::IOErrorFromErrno(errno, "Failed to set up io_uring");
+    }
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+      ring->sqRingSize = ring->cqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+    }
+    ring->sqRing = mmap(
+        nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+      return arrow::internal::IOErrorFromErrno(errno, "Failed to map the io_uring submission queue");
+    }
+    if (singleMmap) {
+      ring->cqRing = ring->sqRing;
+    } else {
+      ring->cqRing = mmap(
+          nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+      if (ring->cqRing == MAP_FAILED) {
+        return arrow::internal::IOErrorFromErrno(errno, "Failed to map the io_uring completion queue");
+      }
+    }
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe*>(
+        mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+    if (ring->sqes == MAP_FAILED) {
+      return arrow::internal::IOErrorFromErrno(errno, "Failed to map the io_uring submission entries");
+    }
+
+    auto* sq = static_cast<uint8_t*>(ring->sqRing);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    auto* cq = static_cast<uint8_t*>(ring->cqRing);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return ring;
+  }
+
+  ~Ring() {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqesSize);
+    }
+    if (cqRing != MAP_FAILED && cqRing != sqRing) {
+      munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != MAP_FAILED) {
+      munmap(sqRing, sqRingSize);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  // The caller keeps no more entries in flight than the ring holds.
+  io_uring_sqe* nextSqe() {
+    auto tail = *sqTail;
+    auto index = tail & *sqMask;
+    sqArray[index] = index;
+    auto* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  void commit() {
+    __atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+    ++toSubmit;
+  }
+
+  // Submits the queued entries and waits for minComplete completions.
+  arrow::Status enter(unsigned minComplete) {
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (true) {
+      auto ret = syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+      if (ret >= 0) {
+        toSubmit -= std::min<unsigned>(toSubmit, ret);
+        return arrow::Status::OK();
+      }
+      if (errno != EINTR) {
+        return arrow::internal::IOErrorFromErrno(errno, "Failed to enter io_uring");
+      }
+    }
+  }
+};
+
+arrow::Result<std::shared_ptr<arrow::io::OutputStream>> UringFileOutputStream::open(
+    const std::string& path,
+    bool directIo,
+    int32_t numBuffers,
+    int64_t bufferSize) {
+  auto ring = Ring::make(numBuffers);
+  if (!ring.ok()) {
+    return arrow::io::FileOutputStream::Open(path, true);
+  }
+  int bufferedFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+  if (bufferedFd < 0) {
+    return arrow::internal::IOErrorFromErrno(errno, "Failed to open ", path);
+  }
+  auto position = lseek(bufferedFd, 0, SEEK_END);
+  if (position < 0) {
+    auto status = arrow::internal::IOErrorFromErrno(errno, "Failed to seek ", path);
+    close(bufferedFd);
+    return status;
+  }
+  int fd = bufferedFd;
+  if (directIo && position % kDirectIoAlignment == 0 && bufferSize % kDirectIoAlignment == 0) {
+    // EINVAL on file systems without direct IO, e.g. tmpfs.
+    int directFd = ::open(path.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+    if (directFd >= 0) {
+      fd = directFd;
+    }
+  }
+  std::shared_ptr<UringFileOutputStream> stream(
+      new UringFileOutputStream(std::move(*ring), fd, bufferedFd, position, bufferSize));
+  RETURN_NOT_OK(stream->init(numBuffers));
+  return stream;
+}
+
+UringFileOutputStream::UringFileOutputStream(
+    std::unique_ptr<Ring> ring,
+    int fd,
+    int bufferedFd,
+    int64_t position,
+    int64_t bufferSize)
+    : ring_(std::move(ring)),
+      fd_(fd),
+      bufferedFd_(bufferedFd),
+      direct_(fd != bufferedFd),
+      position_(position),
+      bufferSize_(bufferSize) {}
+
+UringFileOutputStream::~UringFileOutputStream() {
+  (void)Close();
+  for (auto& buffer : buffers_) {
+    free(buffer.data);
+  }
+}
+
+arrow::Status UringFileOutputStream::init(int32_t numBuffers) {
+  buffers_.resize(numBuffers);
+  std::vector<iovec> iovecs;
+  for (auto& buffer : buffers_) {
+    void* data = nullptr;
+    if (posix_memalign(&data, kDirectIoAlignment, bufferSize_) != 0) {
+      return arrow::Status::OutOfMemory("Failed to allocate io_uring buffer of ", bufferSize_, " bytes");
+    }
+    buffer.data = static_cast<uint8_t*>(data);
+    iovecs.push_back({buffer.data, static_cast<size_t>(bufferSize_)});
+  }
+  // Registered buffers are pinned once instead of on every write. Counted against RLIMIT_MEMLOCK on older kernels,
+  // plain writes are submitted if it's exceeded.
+  registered_ =
+      syscall(__NR_io_uring_register, ring_->fd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) == 0;
+  return arrow::Status::OK();
+}
+
+arrow::Status UringFileOutputStream::Write(const void* data, int64_t nbytes) {
+  RETURN_NOT_OK(error_);
+  auto* src = static_cast<const uint8_t*>(data);
+  while (nbytes > 0) {
+    auto& buffer = buffers_[current_];
+    while (buffer.inflight) {
+      RETURN_NOT_OK(reap(false));
+    }
+    if (buffer.size == 0) {
+      buffer.offset = position_;
+    }
+    auto n = std::min(nbytes, bufferSize_ - buffer.size);
+    memcpy(buffer.data + buffer.size, src, n);
+    buffer.size += n;
+    position_ += n;
+    src += n;
+    nbytes -= n;
+    if (buffer.size == bufferSize_) {
+      RETURN_NOT_OK(submit(current_));
+      current_ = (current_ + 1) % buffers_.size();
+    }
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status UringFileOutputStream::Flush() {
+  RETURN_NOT_OK(reap(true));
+  // The partial buffer stays, it is written again in full once filled.
+  const auto& buffer = buffers_[current_];
+  if (buffer.size > 0) {
+    RETURN_NOT_OK(writeThrough(buffer, 0));
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status UringFileOutputStream::Close() {
+  if (closed_) {
+    return arrow::Status::OK();
+  }
+  auto status = Flush();
+  ring_.reset();
+  if (direct_) {
+    close(fd_);
+  }
+  close(bufferedFd_);
+  closed_ = true;
+  return status;
+}
+
+arrow::Status UringFileOutputStream::submit(int32_t index) {
+  auto& buffer = buffers_[index];
+  auto* sqe = ring_->nextSqe();
+  sqe->fd = fd_;
+  sqe->off = buffer.offset;
+  sqe->user_data = index;
+  if (registered_) {
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer.data);
+    sqe->len = buffer.size;
+    sqe->buf_index = index;
+  } else {
+    buffer.iov = {buffer.data, static_cast<size_t>(buffer.size)};
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->addr = reinterpret_cast<uint64_t>(&buffer.iov);
+    sqe->len = 1;
+  }
+  ring_->commit();
+  buffer.inflight = true;
+  ++inflight_;
+  // Submitted right away so that the kernel writes it while the next buffer fills.
+  return ring_->enter(0);
+}
+
+arrow::Status UringFileOutputStream::reap(bool waitAll) {
+  while (inflight_ > 0) {
+    auto head = *ring_->cqHead;
+    auto tail = __atomic_load_n(ring_->cqTail, __ATOMIC_ACQUIRE);
+    auto completed = head != tail;
+    for (; head != tail; ++head) {
+      const auto& cqe = ring_->cqes[head & *ring_->cqMask];
+      auto& buffer = buffers_[cqe.user_data];
+      if (cqe.res < 0) {
+        if (error_.ok()) {
+          error_ = arrow::internal::IOErrorFromErrno(-cqe.res, "Failed to write with io_uring");
+        }
+      } else if (cqe.res < buffer.size) {
+        auto status = writeThrough(buffer, cqe.res);
+        if (!status.ok() && error_.ok()) {
+          error_ = status;
+        }
+      }
+      buffer.inflight = false;
+      buffer.size = 0;
+      --inflight_;
+    }
+    __atomic_store_n(ring_->cqHead, head, __ATOMIC_RELEASE);
+    if (inflight_ == 0 || (completed && !waitAll)) {
+      break;
+    }
+    RETURN_NOT_OK(ring_->enter(1));
+  }
+  return error_;
+}
+
+arrow::Status UringFileOutputStream::writeThrough(const Buffer& buffer, int64_t from) {
+  while (from < buffer.size) {
+    auto ret = pwrite(bufferedFd_, buffer.data + from, buffer.size - from, buffer.offset + from);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return arrow::internal::IOErrorFromErrno(errno, "Failed to write");
+    }
+    from += ret;
+  }
+  return arrow::Status::OK();
+}
+
+} // namespace gluten
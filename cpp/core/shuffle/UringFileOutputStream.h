@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/io/interfaces.h>
+#include <arrow/result.h>
+
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gluten {
+
+// Appends to a local file through io_uring, so that the writes overlap with the caller filling the next buffer. The
+// data is copied into a ring of buffers registered with the kernel, each submitted once full. Direct IO bypasses the
+// page cache for the full buffers, the unaligned tail is written through it on flush and close.
+//
+// Not thread safe, like arrow::io::FileOutputStream.
+class UringFileOutputStream final : public arrow::io::OutputStream {
+ public:
+  static constexpr int32_t kDefaultNumBuffers = 4;
+  static constexpr int64_t kDefaultBufferSize = 1 << 20;
+
+  // Opens the file to append to. Falls back to arrow::io::FileOutputStream if io_uring isn't available, e.g. on an
+  // old kernel or when seccomp forbids it, and to buffered IO if the file system doesn't support direct IO.
+  static arrow::Result<std::shared_ptr<arrow::io::OutputStream>> open(
+      const std::string& path,
+      bool directIo,
+      int32_t numBuffers = kDefaultNumBuffers,
+      int64_t bufferSize = kDefaultBufferSize);
+
+  ~UringFileOutputStream() override;
+
+  arrow::Status Write(const void* data, int64_t nbytes) override;
+
+  // Waits for the submitted buffers and writes the partial one.
+  arrow::Status Flush() override;
+
+  arrow::Status Close() override;
+
+  bool closed() const override {
+    return closed_;
+  }
+
+  arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+ private:
+  struct Ring;
+
+  struct Buffer {
+    uint8_t* data = nullptr;
+    int64_t size = 0;
+    // File offset of data.
+    int64_t offset = 0;
+    bool inflight = false;
+    // For the write of an unregistered buffer.
+    iovec iov{};
+  };
+
+  UringFileOutputStream(std::unique_ptr<Ring> ring, int fd, int bufferedFd, int64_t position, int64_t bufferSize);
+
+  arrow::Status init(int32_t numBuffers);
+
+  arrow::Status submit(int32_t index);
+
+  // Waits until at least one submitted buffer completes, or all with waitAll.
+  arrow::Status reap(bool waitAll);
+
+  // Writes the buffer at its offset with pwrite through the page cache.
+  arrow::Status writeThrough(const Buffer& buffer, int64_t from);
+
+  std::unique_ptr<Ring> ring_;
+  // With O_DIRECT if the file system supports it, else the same as bufferedFd_.
+  int fd_;
+  int bufferedFd_;
+  bool direct_;
+  int64_t position_;
+  int64_t bufferSize_;
+  std::vector<Buffer> buffers_;
+  int32_t current_ = 0;
+  int32_t inflight_ = 0;
+  bool registered_ = false;
+  arrow::Status error_;
+  bool closed_ = false;
+};
+
+} // namespace gluten
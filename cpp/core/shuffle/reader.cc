@@ -61,6 +61,18 @@ arrow::Result<std::shared_ptr<ColumnarBatch>> Reader::next() {
   } else {
     GLUTEN_ASSIGN_OR_THROW(messageToRead, arrow::ipc::ReadMessage(in_.get()))
   }
+  while (options_.read_merged_chunks) {
+    if (messageToRead != nullptr && messageToRead->type() != arrow::ipc::MessageType::SCHEMA) {
+      break;
+    }
+    // Only the end of the stream reads nothing.
+    GLUTEN_ASSIGN_OR_THROW(auto position, in_->Tell())
+    GLUTEN_ASSIGN_OR_THROW(messageToRead, arrow::ipc::ReadMessage(in_.get()))
+    GLUTEN_ASSIGN_OR_THROW(auto nextPosition, in_->Tell())
+    if (messageToRead == nullptr && nextPosition == position) {
+      break;
+    }
+  }
   if (messageToRead == nullptr) {
     return nullptr;
   }
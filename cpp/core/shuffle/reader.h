@@ -30,6 +30,15 @@ struct ReaderOptions {
   arrow::ipc::IpcReadOptions ipc_read_options = arrow::ipc::IpcReadOptions::Defaults();
   arrow::Compression::type compression_type = arrow::Compression::type::LZ4_FRAME;
   CodecBackend codec_backend = CodecBackend::NONE;
+  // Decompress all buffers of a batch into one slab that is reused across batches.
+  bool decompress_into_slab = false;
+  // Blocks read from the stream and decoded ahead on the executor of the reader, if it has one. 0 reads synchronously.
+  int32_t prefetch_blocks = 0;
+  // Merge consecutive batches until they have at least this many rows. 0 returns the batches as written.
+  int32_t merge_batch_rows = 0;
+  // The stream is several blocks back to back, such as the push-merge chunks merged by push based shuffle. Skip the
+  // schema messages and EOS markers between them.
+  bool read_merged_chunks = false;
 
   static ReaderOptions defaults();
 };
@@ -48,6 +57,14 @@ class Reader {
   arrow::Status close();
   int64_t getDecompressTime();
 
+  // Bytes decompressed on an accelerator and in software by hybrid codecs, see HybridDecompressCodec.
+  virtual int64_t getHardwareDecompressedBytes() {
+    return 0;
+  }
+  virtual int64_t getSoftwareDecompressedBytes() {
+    return 0;
+  }
+
  protected:
   std::shared_ptr<arrow::MemoryPool> pool_;
   int64_t decompressTime_ = 0;
@@ -17,15 +17,111 @@
 
 #include "CelebornPartitionWriter.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace gluten {
 
+// Output stream appending to a buffer that keeps its capacity when cleared, so that pushes don't reallocate.
+class CelebornPartitionWriter::PushBuffer final : public arrow::io::OutputStream {
+ public:
+  static arrow::Result<std::shared_ptr<PushBuffer>> make(int64_t initialCapacity, arrow::MemoryPool* pool) {
+    ARROW_ASSIGN_OR_RAISE(std::shared_ptr<arrow::ResizableBuffer> buffer, arrow::AllocateResizableBuffer(0, pool));
+    RETURN_NOT_OK(buffer->Reserve(initialCapacity));
+    return std::make_shared<PushBuffer>(std::move(buffer));
+  }
+
+  explicit PushBuffer(std::shared_ptr<arrow::ResizableBuffer> buffer) : buffer_(std::move(buffer)) {}
+
+  arrow::Status Write(const void* data, int64_t nbytes) override {
+    if (size_ + nbytes > buffer_->capacity()) {
+      RETURN_NOT_OK(buffer_->Reserve(std::max(size_ + nbytes, buffer_->capacity() * 2)));
+    }
+    memcpy(buffer_->mutable_data() + size_, data, nbytes);
+    size_ += nbytes;
+    return arrow::Status::OK();
+  }
+
+  arrow::Result<int64_t> Tell() const override {
+    return size_;
+  }
+
+  arrow::Status Close() override {
+    return arrow::Status::OK();
+  }
+
+  bool closed() const override {
+    return false;
+  }
+
+  uint8_t* data() {
+    return buffer_->mutable_data();
+  }
+
+  int64_t size() const {
+    return size_;
+  }
+
+  int64_t capacity() const {
+    return buffer_->capacity();
+  }
+
+  void clear() {
+    size_ = 0;
+  }
+
+ private:
+  std::shared_ptr<arrow::ResizableBuffer> buffer_;
+  int64_t size_ = 0;
+};
+
+// Serialized payloads of several partitions pushed in one call.
+struct CelebornPartitionWriter::PushBatch {
+  std::shared_ptr<PushBuffer> data;
+  std::vector<int32_t> partitionIds;
+  std::vector<int32_t> lengths;
+
+  void clear() {
+    data->clear();
+    partitionIds.clear();
+    lengths.clear();
+  }
+};
+
+CelebornPartitionWriter::~CelebornPartitionWriter() {
+  // Push tasks hold a raw pointer to this writer.
+  if (pushExecutor_ != nullptr) {
+    std::unique_lock<std::mutex> lock(pushMutex_);
+    pushCv_.wait(lock, [this] { return !pushScheduled_; });
+  }
+}
+
 arrow::Status CelebornPartitionWriter::init() {
+  const auto& options = shuffleWriter_->options();
+  ARROW_ASSIGN_OR_RAISE(pushBuffer_, PushBuffer::make(options.buffer_size, options.memory_pool.get()));
+  if (options.async_push) {
+    ARROW_ASSIGN_OR_RAISE(pushExecutor_, arrow::internal::ThreadPool::Make(1));
+    pushedBytes_.resize(shuffleWriter_->numPartitions(), 0);
+    // Eviction runs when the task is short of memory, so it takes its batches from the ones allocated here. The
+    // in-flight budget holds numBatches - 1 of them, one more is being filled. A batch is submitted before it would
+    // outgrow its capacity, so only a partition larger than that reallocates.
+    auto numBatches = std::max<int64_t>(1, options.max_inflight_push_bytes / options.push_batch_size) + 1;
+    for (int64_t i = 0; i < numBatches; ++i) {
+      auto batch = std::make_shared<PushBatch>();
+      ARROW_ASSIGN_OR_RAISE(batch->data, PushBuffer::make(2 * options.push_batch_size, options.memory_pool.get()));
+      freeBatches_.push_back(std::move(batch));
+    }
+  }
   return arrow::Status::OK();
 }
 
 arrow::Status CelebornPartitionWriter::evictPartition(int32_t partitionId) {
+  if (pushExecutor_ != nullptr) {
+    return evictPartitionAsync(partitionId);
+  }
   int64_t tempTotalTime = 0;
-  TIME_NANO_OR_RAISE(tempTotalTime, writeArrowToOutputStream(partitionId));
+  pushBuffer_->clear();
+  TIME_NANO_OR_RAISE(tempTotalTime, writeArrowToOutputStream(partitionId, pushBuffer_.get()));
   shuffleWriter_->setTotalWriteTime(shuffleWriter_->totalWriteTime() + tempTotalTime);
   TIME_NANO_OR_RAISE(tempTotalTime, pushPartition(partitionId));
   shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalTime);
@@ -33,16 +129,148 @@ arrow::Status CelebornPartitionWriter::evictPartition(int32_t partitionId) {
 };
 
 arrow::Status CelebornPartitionWriter::pushPartition(int32_t partitionId) {
-  auto buffer = celebornBufferOs_->Finish();
-  int32_t size = buffer->get()->size();
-  char* dst = reinterpret_cast<char*>(buffer->get()->mutable_data());
+  int32_t size = pushBuffer_->size();
+  char* dst = reinterpret_cast<char*>(pushBuffer_->data());
   int32_t celebornBytesSize = celebornClient_->pushPartitonData(partitionId, dst, size);
-  shuffleWriter_->partitionCachedRecordbatch()[partitionId].clear();
-  shuffleWriter_->setPartitionCachedRecordbatchSize(partitionId, 0);
   shuffleWriter_->setPartitionLengths(partitionId, shuffleWriter_->partitionLengths()[partitionId] + celebornBytesSize);
   return arrow::Status::OK();
 };
 
+arrow::Status CelebornPartitionWriter::evictPartitionAsync(int32_t partitionId) {
+  if (shuffleWriter_->partitionCachedRecordbatch()[partitionId].empty()) {
+    return arrow::Status::OK();
+  }
+  int64_t tempTotalTime = 0;
+  // The cached size leaves out the IPC metadata, which is small next to the bodies.
+  auto estimatedSize = shuffleWriter_->partitionCachedRecordbatchSize()[partitionId];
+  if (currentBatch_ != nullptr && currentBatch_->data->size() > 0 &&
+      currentBatch_->data->size() + estimatedSize > currentBatch_->data->capacity()) {
+    TIME_NANO_OR_RAISE(tempTotalTime, submitBatch());
+    shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalTime);
+  }
+  if (currentBatch_ == nullptr) {
+    tempTotalTime = 0;
+    TIME_NANO_OR_RAISE(tempTotalTime, takeFreeBatch());
+    shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalTime);
+  }
+
+  tempTotalTime = 0;
+  auto offset = currentBatch_->data->size();
+  TIME_NANO_OR_RAISE(tempTotalTime, writeArrowToOutputStream(partitionId, currentBatch_->data.get()));
+  shuffleWriter_->setTotalWriteTime(shuffleWriter_->totalWriteTime() + tempTotalTime);
+  currentBatch_->partitionIds.push_back(partitionId);
+  currentBatch_->lengths.push_back(currentBatch_->data->size() - offset);
+
+  if (currentBatch_->data->size() >= shuffleWriter_->options().push_batch_size) {
+    // Only the time blocked on the in-flight budget is counted.
+    tempTotalTime = 0;
+    TIME_NANO_OR_RAISE(tempTotalTime, submitBatch());
+    shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalTime);
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status CelebornPartitionWriter::takeFreeBatch() {
+  std::unique_lock<std::mutex> lock(pushMutex_);
+  pushCv_.wait(lock, [this] { return !pushStatus_.ok() || !freeBatches_.empty(); });
+  RETURN_NOT_OK(pushStatus_);
+  currentBatch_ = std::move(freeBatches_.back());
+  freeBatches_.pop_back();
+  return arrow::Status::OK();
+}
+
+arrow::Status CelebornPartitionWriter::submitBatch() {
+  auto size = currentBatch_->data->size();
+  std::unique_lock<std::mutex> lock(pushMutex_);
+  auto maxInflightBytes = shuffleWriter_->options().max_inflight_push_bytes;
+  pushCv_.wait(lock, [&] {
+    return !pushStatus_.ok() || inflightPushBytes_ == 0 || inflightPushBytes_ + size <= maxInflightBytes;
+  });
+  RETURN_NOT_OK(pushStatus_);
+
+  inflightPushBytes_ += size;
+  pendingBatches_.push_back(std::move(currentBatch_));
+  if (!pushScheduled_) {
+    pushScheduled_ = true;
+    auto status = pushExecutor_->Spawn([this]() { drainPendingBatches(); });
+    if (!status.ok()) {
+      pushScheduled_ = false;
+      pushStatus_ = status;
+    }
+  }
+  return pushStatus_;
+}
+
+void CelebornPartitionWriter::drainPendingBatches() {
+  while (true) {
+    std::shared_ptr<PushBatch> batch;
+    {
+      std::lock_guard<std::mutex> lock(pushMutex_);
+      if (pendingBatches_.empty() || !pushStatus_.ok()) {
+        for (auto& dropped : pendingBatches_) {
+          inflightPushBytes_ -= dropped->data->size();
+          dropped->clear();
+          freeBatches_.push_back(std::move(dropped));
+        }
+        pendingBatches_.clear();
+        pushScheduled_ = false;
+        pushCv_.notify_all();
+        return;
+      }
+      batch = std::move(pendingBatches_.front());
+      pendingBatches_.pop_front();
+    }
+
+    std::vector<int32_t> pushed;
+    arrow::Status status;
+    try {
+      pushed = celebornClient_->pushPartitionsData(
+          batch->partitionIds, batch->lengths, batch->data->data(), batch->data->size());
+    } catch (const std::exception& e) {
+      status = arrow::Status::IOError("Failed to push partitions to celeborn: ", e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(pushMutex_);
+    inflightPushBytes_ -= batch->data->size();
+    if (status.ok()) {
+      for (size_t i = 0; i < pushed.size(); ++i) {
+        pushedBytes_[batch->partitionIds[i]] += pushed[i];
+      }
+    } else if (pushStatus_.ok()) {
+      pushStatus_ = status;
+    }
+    batch->clear();
+    freeBatches_.push_back(std::move(batch));
+    pushCv_.notify_all();
+  }
+}
+
+arrow::Status CelebornPartitionWriter::waitForPushes() {
+  std::unique_lock<std::mutex> lock(pushMutex_);
+  pushCv_.wait(lock, [this] { return !pushScheduled_; });
+  RETURN_NOT_OK(pushStatus_);
+  for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
+    if (pushedBytes_[pid] > 0) {
+      shuffleWriter_->setPartitionLengths(pid, shuffleWriter_->partitionLengths()[pid] + pushedBytes_[pid]);
+      pushedBytes_[pid] = 0;
+    }
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status CelebornPartitionWriter::finishEvict() {
+  if (pushExecutor_ == nullptr) {
+    return arrow::Status::OK();
+  }
+  int64_t tempTotalTime = 0;
+  if (currentBatch_ != nullptr && currentBatch_->data->size() > 0) {
+    TIME_NANO_OR_RAISE(tempTotalTime, submitBatch());
+  }
+  TIME_NANO_OR_RAISE(tempTotalTime, waitForPushes());
+  shuffleWriter_->setTotalEvictTime(shuffleWriter_->totalEvictTime() + tempTotalTime);
+  return arrow::Status::OK();
+}
+
 arrow::Status CelebornPartitionWriter::stop() {
   // push data and collect metrics
   for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
@@ -50,26 +278,30 @@ arrow::Status CelebornPartitionWriter::stop() {
     if (shuffleWriter_->partitionCachedRecordbatchSize()[pid] > 0) {
       RETURN_NOT_OK(evictPartition(pid));
     }
+  }
+  RETURN_NOT_OK(finishEvict());
+  for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
     shuffleWriter_->setTotalBytesWritten(shuffleWriter_->totalBytesWritten() + shuffleWriter_->partitionLengths()[pid]);
   }
+  pushBuffer_.reset();
+  currentBatch_.reset();
+  freeBatches_.clear();
   shuffleWriter_->pool()->reset();
   shuffleWriter_->partitionBuffer().clear();
   return arrow::Status::OK();
 };
 
-arrow::Status CelebornPartitionWriter::writeArrowToOutputStream(int32_t partitionId) {
-  ARROW_ASSIGN_OR_RAISE(
-      celebornBufferOs_,
-      arrow::io::BufferOutputStream::Create(
-          shuffleWriter_->options().buffer_size, shuffleWriter_->options().memory_pool.get()));
+arrow::Status CelebornPartitionWriter::writeArrowToOutputStream(int32_t partitionId, arrow::io::OutputStream* os) {
   int32_t metadataLength = 0; // unused
 #ifndef SKIPWRITE
   for (auto& payload : shuffleWriter_->partitionCachedRecordbatch()[partitionId]) {
-    RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(
-        *payload, shuffleWriter_->options().ipc_write_options, celebornBufferOs_.get(), &metadataLength));
+    RETURN_NOT_OK(
+        arrow::ipc::WriteIpcPayload(*payload, shuffleWriter_->options().ipc_write_options, os, &metadataLength));
     payload = nullptr;
   }
 #endif
+  shuffleWriter_->partitionCachedRecordbatch()[partitionId].clear();
+  shuffleWriter_->setPartitionCachedRecordbatchSize(partitionId, 0);
   return arrow::Status::OK();
 }
 
@@ -18,6 +18,10 @@
 #pragma once
 
 #include <arrow/io/api.h>
+#include <arrow/util/thread_pool.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #include "shuffle/rss/RemotePartitionWriter.h"
 
@@ -35,19 +39,59 @@ class CelebornPartitionWriter : public RemotePartitionWriter {
     celebornClient_ = celebornClient;
   }
 
+  ~CelebornPartitionWriter() override;
+
   arrow::Status init() override;
 
   arrow::Status evictPartition(int32_t partitionId) override;
 
+  arrow::Status finishEvict() override;
+
   arrow::Status stop() override;
 
   arrow::Status pushPartition(int32_t partitionId);
 
-  arrow::Status writeArrowToOutputStream(int32_t partitionId);
-
-  std::shared_ptr<arrow::io::BufferOutputStream> celebornBufferOs_;
+  arrow::Status writeArrowToOutputStream(int32_t partitionId, arrow::io::OutputStream* os);
 
   std::shared_ptr<CelebornClient> celebornClient_;
+
+ private:
+  class PushBuffer;
+  struct PushBatch;
+
+  // Serialize the partition into the current batch and queue the batch once it reaches push_batch_size. Only blocks
+  // when the in-flight budget is exhausted.
+  arrow::Status evictPartitionAsync(int32_t partitionId);
+
+  // Waits for a free batch to fill.
+  arrow::Status takeFreeBatch();
+
+  arrow::Status submitBatch();
+
+  // Runs on the push executor. Pushes the queued batches in order.
+  void drainPendingBatches();
+
+  // Wait for all queued batches to be pushed and account the pushed bytes to the partitions.
+  arrow::Status waitForPushes();
+
+  // Reused by all synchronous pushes.
+  std::shared_ptr<PushBuffer> pushBuffer_;
+
+  // Background push. Null if pushing synchronously.
+  std::shared_ptr<arrow::internal::ThreadPool> pushExecutor_;
+  // Owned by the task thread.
+  std::shared_ptr<PushBatch> currentBatch_;
+
+  // Guards all below.
+  std::mutex pushMutex_;
+  std::condition_variable pushCv_;
+  std::deque<std::shared_ptr<PushBatch>> pendingBatches_;
+  // Allocated by init() and returned once pushed, so that eviction doesn't allocate them.
+  std::vector<std::shared_ptr<PushBatch>> freeBatches_;
+  std::vector<int64_t> pushedBytes_;
+  int64_t inflightPushBytes_ = 0;
+  bool pushScheduled_ = false;
+  arrow::Status pushStatus_;
 };
 
 class CelebornPartitionWriterCreator : public ShuffleWriter::PartitionWriterCreator {
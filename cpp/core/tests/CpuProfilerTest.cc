@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "utils/CpuProfiler.h"
+
+namespace gluten {
+
+namespace {
+__attribute__((noinline)) int64_t spin(std::chrono::milliseconds duration) {
+  auto deadline = std::chrono::steady_clock::now() + duration;
+  volatile int64_t sum = 0;
+  while (std::chrono::steady_clock::now() < deadline) {
+    sum = sum + 1;
+  }
+  return sum;
+}
+} // namespace
+
+TEST(CpuProfilerTest, sampleWithinScope) {
+  CpuProfiler profiler(1000, CpuProfiler::Clock::kCpu);
+  auto tag = profiler.addTag("task_1;node_2");
+  {
+    CpuProfiler::Scope scope(&profiler, tag);
+    spin(std::chrono::milliseconds(200));
+  }
+  auto numSamples = profiler.numSamples();
+  ASSERT_GT(numSamples, 0);
+  // Outside a scope the thread isn't sampled.
+  spin(std::chrono::milliseconds(100));
+  ASSERT_EQ(profiler.numSamples(), numSamples);
+
+  std::ostringstream folded;
+  profiler.writeFolded(folded);
+  ASSERT_EQ(folded.str().rfind("task_1;node_2;", 0), 0);
+  // The symbols of the test binary may not be exported, while the ones of libstdc++ are.
+  ASSERT_NE(folded.str().find("steady_clock::now()"), std::string::npos);
+  ASSERT_EQ(profiler.numDroppedSamples(), 0);
+}
+
+TEST(CpuProfilerTest, sampleOtherThreads) {
+  CpuProfiler profiler(1000, CpuProfiler::Clock::kWall);
+  auto tagA = profiler.addTag("a");
+  auto tagB = profiler.addTag("b");
+  std::thread thread([&]() {
+    CpuProfiler::Scope scope(&profiler, tagA);
+    // Blocked time is sampled on the wall clock.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+      CpuProfiler::Scope nested(&profiler, tagB);
+      spin(std::chrono::milliseconds(100));
+    }
+  });
+  thread.join();
+
+  std::ostringstream folded;
+  profiler.writeFolded(folded);
+  ASSERT_EQ(folded.str().rfind("a;", 0), 0);
+  ASSERT_NE(folded.str().find("\nb;"), std::string::npos);
+  // Stopped, later scopes aren't sampled.
+  auto numSamples = profiler.numSamples();
+  {
+    CpuProfiler::Scope scope(&profiler, tagA);
+    spin(std::chrono::milliseconds(50));
+  }
+  ASSERT_EQ(profiler.numSamples(), numSamples);
+}
+
+} // namespace gluten
@@ -20,6 +20,7 @@
 
 #include "memory/HbwAllocator.h"
 #include "memory/MemoryAllocator.h"
+#include "memory/MemoryTier.h"
 
 class TestHbwAllocator : public ::testing::Test {
  protected:
@@ -92,3 +93,38 @@ TEST_F(TestHbwAllocatorEnabled, TestAllocateHbm) {
   allocator_->reallocateAligned(buf, 64, size, size << 1, &buf);
   checkBytesAndFree(buf, size << 1);
 }
+
+TEST_F(TestHbwAllocatorEnabled, TestTierAndBudget) {
+  gluten::HbwMemoryAllocator allocator;
+  const int64_t size = 1024 * 1024;
+  auto capacity = gluten::hbmCapacity();
+  gluten::setHbmCapacity(size << 1);
+
+  // Default tier goes to DDR.
+  void* cold = nullptr;
+  ASSERT_TRUE(allocator.allocate(size, &cold));
+  ASSERT_EQ(allocator.hbmBytes(), 0);
+
+  void* hot = nullptr;
+  void* overflow = nullptr;
+  {
+    gluten::ScopedMemoryTier scopedTier(gluten::MemoryTier::kHbm);
+    ASSERT_TRUE(allocator.allocateAligned(64, size, &hot));
+    ASSERT_EQ(allocator.hbmBytes(), size);
+    ASSERT_TRUE(allocator.reallocate(hot, size, size << 1, &hot));
+    ASSERT_EQ(allocator.hbmBytes(), size << 1);
+    // Over the budget.
+    ASSERT_TRUE(allocator.allocate(size, &overflow));
+    ASSERT_EQ(allocator.hbmBytes(), size << 1);
+    ASSERT_EQ(allocator.numFallbacks(), 1);
+  }
+  ASSERT_EQ(allocator.getBytes(), size * 4);
+
+  // The tier is detected on free.
+  allocator.free(hot, size << 1);
+  ASSERT_EQ(allocator.hbmBytes(), 0);
+  allocator.free(overflow, size);
+  allocator.free(cold, size);
+  ASSERT_EQ(allocator.getBytes(), 0);
+  gluten::setHbmCapacity(capacity);
+}
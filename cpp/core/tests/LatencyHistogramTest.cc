@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "utils/LatencyHistogram.h"
+
+namespace gluten {
+
+TEST(LatencyHistogramTest, percentiles) {
+  LatencyHistogram histogram;
+  ASSERT_EQ(histogram.percentile(50), 0);
+  for (int64_t i = 1; i <= 1000; ++i) {
+    histogram.record(i * 1000);
+  }
+  // One stall dominates the max but not the percentiles.
+  histogram.record(30'000'000'000);
+  ASSERT_EQ(histogram.count(), 1001);
+  ASSERT_EQ(histogram.max(), 30'000'000'000);
+  ASSERT_NEAR(histogram.percentile(50), 501'000, 501'000 * 0.035);
+  ASSERT_NEAR(histogram.percentile(99), 991'000, 991'000 * 0.035);
+  ASSERT_EQ(histogram.percentile(100), 30'000'000'000);
+}
+
+TEST(LatencyHistogramTest, smallValuesAreExact) {
+  LatencyHistogram histogram;
+  for (int64_t i = 0; i < 32; ++i) {
+    histogram.record(i);
+  }
+  histogram.record(-1);
+  ASSERT_EQ(histogram.percentile(50), 15);
+  ASSERT_EQ(histogram.max(), 31);
+}
+
+} // namespace gluten
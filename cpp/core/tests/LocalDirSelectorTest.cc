@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/LocalDirSelector.h"
+
+#include <arrow/util/io_util.h>
+#include <gtest/gtest.h>
+
+namespace gluten {
+
+class LocalDirSelectorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (auto i = 0; i < 2; ++i) {
+      auto tmpDir = arrow::internal::TemporaryDir::Make("local-dir-selector-").ValueOrDie();
+      dirs_.push_back(tmpDir->path().ToString());
+      tmpDirs_.push_back(std::move(tmpDir));
+    }
+  }
+
+  static constexpr int64_t kWriteBytes = 4 << 20;
+
+  LocalDirSelector selector_;
+  std::vector<std::unique_ptr<arrow::internal::TemporaryDir>> tmpDirs_;
+  std::vector<std::string> dirs_;
+};
+
+TEST_F(LocalDirSelectorTest, roundRobinWhenIdle) {
+  auto first = selector_.select(dirs_, kWriteBytes);
+  ASSERT_NE(selector_.select(dirs_, kWriteBytes), first);
+  ASSERT_EQ(selector_.select(dirs_, kWriteBytes), first);
+}
+
+TEST_F(LocalDirSelectorTest, avoidOutstandingWrites) {
+  selector_.beginWrite(dirs_[0], kWriteBytes);
+  for (auto i = 0; i < 4; ++i) {
+    ASSERT_EQ(selector_.select(dirs_, kWriteBytes), 1u);
+  }
+  selector_.endWrite(dirs_[0], kWriteBytes, kWriteBytes, true);
+  ASSERT_EQ(selector_.outstandingBytes(dirs_[0]), 0);
+}
+
+TEST_F(LocalDirSelectorTest, preferFasterDir) {
+  selector_.beginWrite(dirs_[0], kWriteBytes);
+  selector_.endWrite(dirs_[0], kWriteBytes, kWriteBytes, true);
+  selector_.beginWrite(dirs_[1], kWriteBytes);
+  selector_.endWrite(dirs_[1], kWriteBytes, 4 * kWriteBytes, true);
+  for (auto i = 0; i < 4; ++i) {
+    ASSERT_EQ(selector_.select(dirs_, kWriteBytes), 0u);
+  }
+  // A large write in flight on the fast dir makes the slow one cheaper.
+  selector_.beginWrite(dirs_[0], 4 * kWriteBytes);
+  ASSERT_EQ(selector_.select(dirs_, kWriteBytes), 1u);
+}
+
+TEST_F(LocalDirSelectorTest, backoffFailedDir) {
+  selector_.beginWrite(dirs_[1], kWriteBytes);
+  selector_.endWrite(dirs_[1], kWriteBytes, 0, false);
+  for (auto i = 0; i < 4; ++i) {
+    ASSERT_EQ(selector_.select(dirs_, kWriteBytes), 0u);
+  }
+}
+
+TEST_F(LocalDirSelectorTest, backoffSlowDir) {
+  selector_.beginWrite(dirs_[1], kWriteBytes);
+  selector_.endWrite(dirs_[1], kWriteBytes, kWriteBytes, true);
+  // 16 times slower per byte than the other dir, which is then taken even though loaded.
+  selector_.beginWrite(dirs_[0], kWriteBytes);
+  selector_.endWrite(dirs_[0], kWriteBytes, 16 * kWriteBytes, true);
+  selector_.beginWrite(dirs_[1], 16 * kWriteBytes);
+  for (auto i = 0; i < 4; ++i) {
+    ASSERT_EQ(selector_.select(dirs_, kWriteBytes), 1u);
+  }
+}
+
+TEST_F(LocalDirSelectorTest, reportExhausted) {
+  bool exhausted = true;
+  selector_.select(dirs_, kWriteBytes, &exhausted);
+  ASSERT_FALSE(exhausted);
+  for (const auto& dir : dirs_) {
+    selector_.beginWrite(dir, kWriteBytes);
+    selector_.endWrite(dir, kWriteBytes, 0, false);
+  }
+  selector_.select(dirs_, kWriteBytes, &exhausted);
+  ASSERT_TRUE(exhausted);
+}
+
+} // namespace gluten
@@ -0,0 +1,281 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory/AllocationProfiler.h"
+#include "memory/ArenaMemoryAllocator.h"
+#include "memory/MemoryAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+namespace gluten {
+
+class RecordingListener final : public AllocationListener {
+ public:
+  void allocationChanged(int64_t diff) override {
+    reserved += diff;
+  }
+
+  int64_t reserved = 0;
+};
+
+class PurgeCountingAllocator final : public MemoryAllocator {
+ public:
+  bool allocate(int64_t size, void** out) override {
+    return std_.allocate(size, out);
+  }
+
+  bool allocateZeroFilled(int64_t nmemb, int64_t size, void** out) override {
+    return std_.allocateZeroFilled(nmemb, size, out);
+  }
+
+  bool allocateAligned(uint64_t alignment, int64_t size, void** out) override {
+    return std_.allocateAligned(alignment, size, out);
+  }
+
+  bool reallocate(void* p, int64_t size, int64_t newSize, void** out) override {
+    return std_.reallocate(p, size, newSize, out);
+  }
+
+  bool reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) override {
+    return std_.reallocateAligned(p, alignment, size, newSize, out);
+  }
+
+  bool free(void* p, int64_t size) override {
+    return std_.free(p, size);
+  }
+
+  int64_t getBytes() const override {
+    return std_.getBytes();
+  }
+
+  MemoryAllocatorStats backendStats() const override {
+    MemoryAllocatorStats stats;
+    stats.allocated = std_.getBytes();
+    return stats;
+  }
+
+  void purge() override {
+    purges++;
+  }
+
+  int32_t purges = 0;
+
+ private:
+  StdMemoryAllocator std_;
+};
+
+TEST(ListenableMemoryAllocatorTest, notifyEveryAllocation) {
+  auto listener = std::make_shared<RecordingListener>();
+  ListenableMemoryAllocator allocator(defaultMemoryAllocator().get(), listener);
+  void* p;
+  ASSERT_TRUE(allocator.allocate(100, &p));
+  ASSERT_EQ(listener->reserved, 100);
+  ASSERT_TRUE(allocator.free(p, 100));
+  ASSERT_EQ(listener->reserved, 0);
+  ASSERT_EQ(allocator.listenerInvocations(), 2);
+}
+
+TEST(ListenableMemoryAllocatorTest, reservationBlocks) {
+  constexpr int64_t kBlockSize = 1 << 20;
+  auto listener = std::make_shared<RecordingListener>();
+  ListenableMemoryAllocator allocator(defaultMemoryAllocator().get(), listener, kBlockSize);
+
+  // Small allocations are served from the first block.
+  std::vector<void*> buffers(100);
+  for (auto& p : buffers) {
+    ASSERT_TRUE(allocator.allocate(1024, &p));
+  }
+  ASSERT_EQ(listener->reserved, kBlockSize);
+  ASSERT_EQ(allocator.reservedBytes(), kBlockSize);
+  ASSERT_EQ(allocator.listenerInvocations(), 1);
+
+  // Crossing the block boundary back and forth only reserves the second block once.
+  void* large;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(allocator.allocate(kBlockSize, &large));
+    ASSERT_EQ(listener->reserved, 2 * kBlockSize);
+    ASSERT_TRUE(allocator.free(large, kBlockSize));
+  }
+  ASSERT_EQ(allocator.listenerInvocations(), 2);
+  ASSERT_EQ(allocator.getBytes(), 100 * 1024);
+
+  // Surplus is given back once usage is a full block below the last reserved block. One spare block is kept.
+  for (auto& p : buffers) {
+    ASSERT_TRUE(allocator.free(p, 1024));
+  }
+  ASSERT_EQ(listener->reserved, kBlockSize);
+  ASSERT_EQ(allocator.reservedBytes(), kBlockSize);
+  ASSERT_EQ(allocator.listenerInvocations(), 3);
+}
+
+TEST(ListenableMemoryAllocatorTest, releaseReservationOnDestruction) {
+  auto listener = std::make_shared<RecordingListener>();
+  {
+    ListenableMemoryAllocator allocator(defaultMemoryAllocator().get(), listener, 1 << 20);
+    void* p;
+    ASSERT_TRUE(allocator.allocate(100, &p));
+    ASSERT_TRUE(allocator.free(p, 100));
+    ASSERT_EQ(listener->reserved, 1 << 20);
+  }
+  ASSERT_EQ(listener->reserved, 0);
+}
+
+TEST(ListenableMemoryAllocatorTest, backendStatsAndPurge) {
+  PurgeCountingAllocator delegated;
+  {
+    ListenableMemoryAllocator allocator(&delegated, std::make_shared<RecordingListener>());
+    void* p;
+    ASSERT_TRUE(allocator.allocate(100, &p));
+    ASSERT_EQ(allocator.backendStats().allocated, 100);
+    ASSERT_EQ(allocator.backendStats().resident, -1);
+    ASSERT_TRUE(allocator.free(p, 100));
+    allocator.purge();
+    ASSERT_EQ(delegated.purges, 1);
+  }
+  // The delegate is shared by all tasks, so the end of a task doesn't purge it.
+  ASSERT_EQ(delegated.purges, 1);
+}
+
+TEST(FreedBytesPurgeTriggerTest, purgeOncePerThreshold) {
+  FreedBytesPurgeTrigger trigger(1000);
+  ASSERT_FALSE(trigger.onFree(600));
+  ASSERT_TRUE(trigger.onFree(600));
+  // Counting restarts after a purge.
+  ASSERT_FALSE(trigger.onFree(600));
+  ASSERT_TRUE(trigger.onFree(400));
+
+  std::atomic_int32_t purges{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 1000; ++j) {
+        if (trigger.onFree(1)) {
+          purges++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_GE(purges, 1);
+  ASSERT_LE(purges, 4);
+}
+
+TEST(ArenaMemoryAllocatorTest, chunkLevelAccounting) {
+  auto listener = std::make_shared<RecordingListener>();
+  ListenableMemoryAllocator listenable(defaultMemoryAllocator().get(), listener);
+  ArenaMemoryAllocator arena(&listenable, 4096);
+
+  void* p;
+  for (int i = 0; i < 32; ++i) {
+    ASSERT_TRUE(arena.allocate(100, &p));
+    memset(p, i, 100);
+  }
+  // 32 * 112 bytes fit in one chunk.
+  ASSERT_EQ(arena.getBytes(), 4096);
+  ASSERT_EQ(listener->reserved, 4096);
+  ASSERT_EQ(listenable.listenerInvocations(), 1);
+
+  ASSERT_TRUE(arena.allocateAligned(64, 10000, &p));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+  ASSERT_GT(arena.getBytes(), 4096 + 10000);
+
+  arena.reset();
+  ASSERT_EQ(arena.getBytes(), 4096);
+  ASSERT_EQ(listener->reserved, 4096);
+}
+
+TEST(ArenaMemoryAllocatorTest, reallocateInPlace) {
+  ArenaMemoryAllocator arena(defaultMemoryAllocator().get(), 4096);
+  void* p;
+  void* q;
+  ASSERT_TRUE(arena.allocate(100, &p));
+  memset(p, 1, 100);
+  ASSERT_TRUE(arena.reallocate(p, 100, 200, &q));
+  ASSERT_EQ(p, q);
+
+  void* other;
+  ASSERT_TRUE(arena.allocate(100, &other));
+  // p is no longer the latest allocation, so it is copied.
+  ASSERT_TRUE(arena.reallocate(p, 200, 300, &q));
+  ASSERT_NE(p, q);
+  ASSERT_EQ(static_cast<uint8_t*>(q)[99], 1);
+
+  // Freeing the latest allocation gives its memory back.
+  ASSERT_TRUE(arena.free(q, 300));
+  ASSERT_TRUE(arena.allocate(300, &p));
+  ASSERT_EQ(p, q);
+}
+
+TEST(ArenaMemoryAllocatorTest, threads) {
+  ArenaMemoryAllocator arena(defaultMemoryAllocator().get(), 4096);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&arena, t] {
+      for (int i = 0; i < 1000; ++i) {
+        void* p;
+        ASSERT_TRUE(arena.allocate(64, &p));
+        memset(p, t, 64);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  arena.reset();
+  // Every thread keeps its first chunk.
+  ASSERT_EQ(arena.getBytes(), 4 * 4096);
+}
+
+TEST(AllocationProfilerTest, sampleAndDump) {
+  auto* profiler = AllocationProfiler::instance();
+  // Every allocation is sampled.
+  profiler->setSampleInterval(1);
+  auto listenable = std::make_shared<ListenableMemoryAllocator>(
+      defaultMemoryAllocator().get(), std::make_shared<RecordingListener>());
+  void* p;
+  void* q;
+  {
+    AllocationProfiler::ScopedPool pool("profiler_test");
+    ASSERT_TRUE(listenable->allocate(100, &p));
+    ASSERT_TRUE(listenable->allocate(200, &q));
+  }
+  ASSERT_EQ(profiler->numLiveSamples(), 2);
+  ASSERT_NE(profiler->poolSummary().find("profiler_test: 300 bytes in 2 samples"), std::string::npos);
+
+  ASSERT_TRUE(listenable->reallocate(q, 200, 400, &q));
+  ASSERT_TRUE(listenable->free(p, 100));
+  ASSERT_EQ(profiler->numLiveSamples(), 1);
+  // Outside a scope the allocator names the pool.
+  ASSERT_NE(profiler->poolSummary().find("listenable: 400 bytes in 1 samples"), std::string::npos);
+
+  std::ostringstream profile;
+  profiler->writeProfile(profile, "listenable");
+  ASSERT_EQ(profile.str().rfind("heap profile: 1: 400 [1: 400] @ heap_v2/1\n", 0), 0);
+  ASSERT_NE(profile.str().find("MAPPED_LIBRARIES:"), std::string::npos);
+
+  ASSERT_TRUE(listenable->free(q, 400));
+  ASSERT_EQ(profiler->numLiveSamples(), 0);
+  profiler->setSampleInterval(0);
+  ASSERT_TRUE(profiler->poolSummary().empty());
+}
+
+} // namespace gluten
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory/NumaBinding.h"
+
+#include <gtest/gtest.h>
+
+namespace gluten {
+
+TEST(NumaBindingTest, parseCpuList) {
+  ASSERT_EQ(parseCpuList(""), std::vector<int32_t>{});
+  ASSERT_EQ(parseCpuList("3"), std::vector<int32_t>{3});
+  ASSERT_EQ(parseCpuList("0-2,8-9,12"), (std::vector<int32_t>{0, 1, 2, 8, 9, 12}));
+}
+
+TEST(NumaBindingTest, sharedPerThreadAndRestored) {
+  cpu_set_t before;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+  {
+    auto binding = NumaTaskBinding::bindCurrentThread();
+    ASSERT_EQ(NumaTaskBinding::bindCurrentThread(), binding);
+    if (binding->node() >= 0) {
+      unsigned cpu;
+      unsigned node;
+      ASSERT_EQ(getcpu(&cpu, &node), 0);
+      ASSERT_EQ(static_cast<int32_t>(node), binding->node());
+    }
+  }
+  cpu_set_t after;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+  ASSERT_TRUE(CPU_EQUAL(&before, &after));
+  for (auto tasks : NumaTaskBinding::boundTasks()) {
+    ASSERT_EQ(tasks, 0);
+  }
+}
+
+} // namespace gluten
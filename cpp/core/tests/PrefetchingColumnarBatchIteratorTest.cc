@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compute/PrefetchingColumnarBatchIterator.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace gluten {
+
+namespace {
+// Produces batches of 1, 2, ... numBatches rows, throwing after them if failAtEnd.
+class CountingIterator : public ColumnarBatchIterator {
+ public:
+  CountingIterator(int32_t numBatches, bool failAtEnd = false) : numBatches_(numBatches), failAtEnd_(failAtEnd) {}
+
+  std::shared_ptr<ColumnarBatch> next() override {
+    if (produced_ == numBatches_) {
+      if (failAtEnd_) {
+        throw GlutenException("input failed");
+      }
+      return nullptr;
+    }
+    produced_++;
+    auto schema = arrow::schema({arrow::field("f_int32", arrow::int32())});
+    auto rb = arrow::RecordBatch::Make(schema, produced_, std::vector<std::shared_ptr<arrow::Array>>{});
+    return std::make_shared<ArrowColumnarBatch>(rb);
+  }
+
+  std::atomic<int32_t> produced_{0};
+
+ private:
+  const int32_t numBatches_;
+  const bool failAtEnd_;
+};
+} // namespace
+
+TEST(PrefetchingColumnarBatchIteratorTest, keepOrderAndBound) {
+  auto input = std::make_unique<CountingIterator>(10);
+  auto* rawInput = input.get();
+  std::atomic<int32_t> numExits{0};
+  {
+    PrefetchingColumnarBatchIterator iter(std::move(input), 3, [&numExits]() { numExits++; });
+    ASSERT_EQ(rawInput->produced_, 0);
+    ASSERT_EQ(iter.next()->numRows(), 1);
+    // At most 3 batches are buffered.
+    while (rawInput->produced_ < 4) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(rawInput->produced_, 4);
+    ASSERT_TRUE(iter.isReady(nullptr));
+    for (int32_t i = 2; i <= 10; ++i) {
+      ASSERT_EQ(iter.next()->numRows(), i);
+    }
+    ASSERT_EQ(iter.next(), nullptr);
+    ASSERT_EQ(iter.next(), nullptr);
+  }
+  ASSERT_EQ(numExits, 1);
+}
+
+TEST(PrefetchingColumnarBatchIteratorTest, notifyWhenReady) {
+  PrefetchingColumnarBatchIterator iter(std::make_unique<CountingIterator>(1), 1);
+  std::atomic<bool> notified{false};
+  if (!iter.isReady([&notified]() { notified = true; })) {
+    while (!notified) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_TRUE(iter.isReady(nullptr));
+  ASSERT_EQ(iter.next()->numRows(), 1);
+  ASSERT_EQ(iter.next(), nullptr);
+  ASSERT_TRUE(iter.isReady(nullptr));
+}
+
+TEST(PrefetchingColumnarBatchIteratorTest, rethrowAfterBatches) {
+  PrefetchingColumnarBatchIterator iter(std::make_unique<CountingIterator>(2, true), 4);
+  ASSERT_EQ(iter.next()->numRows(), 1);
+  ASSERT_EQ(iter.next()->numRows(), 2);
+  ASSERT_THROW(iter.next(), GlutenException);
+}
+
+TEST(PrefetchingColumnarBatchIteratorTest, closeWhileFull) {
+  // The background thread waiting for room in the queue must not block the destruction.
+  auto iter = std::make_unique<PrefetchingColumnarBatchIterator>(std::make_unique<CountingIterator>(100), 2);
+  ASSERT_EQ(iter->next()->numRows(), 1);
+  iter.reset();
+}
+
+} // namespace gluten
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "compute/ResultIteratorArrowStream.h"
+
+#include <arrow/array/builder_primitive.h>
+#include <arrow/c/bridge.h>
+#include <gtest/gtest.h>
+
+#include "utils/ArrowStatus.h"
+
+namespace gluten {
+
+namespace {
+// Produces batches of 1, 2, ... numBatches rows.
+class CountingIterator : public ColumnarBatchIterator {
+ public:
+  explicit CountingIterator(int32_t numBatches) : numBatches_(numBatches) {}
+
+  std::shared_ptr<ColumnarBatch> next() override {
+    if (produced_ == numBatches_) {
+      return nullptr;
+    }
+    produced_++;
+    arrow::Int32Builder builder;
+    for (int32_t i = 0; i < produced_; ++i) {
+      arrowAssertOkOrThrow(builder.Append(i));
+    }
+    auto schema = arrow::schema({arrow::field("f_int32", arrow::int32())});
+    return std::make_shared<ArrowColumnarBatch>(
+        arrow::RecordBatch::Make(schema, produced_, {arrowGetOrThrow(builder.Finish())}));
+  }
+
+ private:
+  const int32_t numBatches_;
+  int32_t produced_ = 0;
+};
+
+std::shared_ptr<arrow::RecordBatchReader> exportAndImport(int32_t numBatches) {
+  struct ArrowArrayStream stream;
+  exportToArrowStream(std::make_shared<ResultIterator>(std::make_unique<CountingIterator>(numBatches)), &stream);
+  return arrowGetOrThrow(arrow::ImportRecordBatchReader(&stream));
+}
+} // namespace
+
+TEST(ResultIteratorArrowStreamTest, readBatches) {
+  auto reader = exportAndImport(3);
+  ASSERT_EQ(reader->schema()->num_fields(), 1);
+  for (int32_t i = 1; i <= 3; ++i) {
+    auto batch = arrowGetOrThrow(reader->Next());
+    ASSERT_NE(batch, nullptr);
+    ASSERT_EQ(batch->num_rows(), i);
+  }
+  ASSERT_EQ(arrowGetOrThrow(reader->Next()), nullptr);
+}
+
+TEST(ResultIteratorArrowStreamTest, empty) {
+  auto reader = exportAndImport(0);
+  ASSERT_EQ(reader->schema()->num_fields(), 0);
+  ASSERT_EQ(arrowGetOrThrow(reader->Next()), nullptr);
+}
+
+} // namespace gluten
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/ShuffleBufferCache.h"
+#include "shuffle/ShuffleWriter.h"
+#include "utils/TestUtils.h"
+
+#include <gtest/gtest.h>
+
+namespace gluten {
+
+class CountingListener final : public AllocationListener {
+ public:
+  void allocationChanged(int64_t diff) override {
+    bytes += diff;
+  }
+
+  int64_t bytes = 0;
+};
+
+TEST(ShuffleBufferCacheTest, sizeClass) {
+  ASSERT_EQ(ShuffleBufferCache::sizeClassOf(1), 6);
+  ASSERT_EQ(ShuffleBufferCache::sizeClassOf(64), 6);
+  ASSERT_EQ(ShuffleBufferCache::sizeClassOf(65), 7);
+  ASSERT_EQ(ShuffleBufferCache::sizeClassOf(16 << 20), 24);
+}
+
+TEST(ShuffleBufferCacheTest, recycleAcrossTasks) {
+  ShuffleBufferCache cache(1 << 20);
+  CountingListener task1;
+  CountingListener task2;
+  bool hit;
+  std::shared_ptr<arrow::Buffer> buffer;
+  std::shared_ptr<arrow::Buffer> other;
+
+  ARROW_ASSIGN_OR_THROW(buffer, cache.allocate(1000, &task1, hit));
+  ASSERT_FALSE(hit);
+  ASSERT_EQ(buffer->size(), 1024);
+  ASSERT_EQ(task1.bytes, 1024);
+  auto* data = buffer->data();
+  buffer.reset();
+  ASSERT_EQ(task1.bytes, 0);
+  ASSERT_EQ(cache.cachedBytes(), 1024);
+
+  ARROW_ASSIGN_OR_THROW(buffer, cache.allocate(1024, &task2, hit));
+  ASSERT_TRUE(hit);
+  ASSERT_EQ(buffer->data(), data);
+  ASSERT_EQ(task2.bytes, 1024);
+  ASSERT_EQ(cache.cachedBytes(), 0);
+
+  // A different size class misses.
+  ARROW_ASSIGN_OR_THROW(other, cache.allocate(2048, &task2, hit));
+  ASSERT_FALSE(hit);
+  ASSERT_EQ(task2.bytes, 3072);
+}
+
+TEST(ShuffleBufferCacheTest, capacity) {
+  ShuffleBufferCache cache(1024);
+  CountingListener listener;
+  bool hit;
+  std::shared_ptr<arrow::Buffer> first;
+  std::shared_ptr<arrow::Buffer> second;
+  ARROW_ASSIGN_OR_THROW(first, cache.allocate(1024, &listener, hit));
+  ARROW_ASSIGN_OR_THROW(second, cache.allocate(1024, &listener, hit));
+  first.reset();
+  second.reset();
+  // Only one block fits, the other one is freed.
+  ASSERT_EQ(cache.cachedBytes(), 1024);
+  ASSERT_EQ(listener.bytes, 0);
+}
+
+TEST(ShuffleBufferCacheTest, bufferPool) {
+  auto listener = std::make_shared<CountingListener>();
+  auto* counting = listener.get();
+  ListenableMemoryAllocator allocator(defaultMemoryAllocator().get(), listener);
+  auto memoryPool = asArrowMemoryPool(&allocator);
+
+  for (int i = 0; i < 2; ++i) {
+    ShuffleBufferPool pool(memoryPool, 64 << 20);
+    ASSERT_NOT_OK(pool.init());
+    std::shared_ptr<arrow::Buffer> small;
+    std::shared_ptr<arrow::Buffer> large;
+    ASSERT_NOT_OK(pool.allocate(small, 100));
+    ASSERT_NOT_OK(pool.allocate(large, 17 << 20));
+    ASSERT_EQ(small->size(), 128);
+    ASSERT_EQ(large->size(), 17 << 20);
+    ASSERT_EQ(counting->bytes, (16 << 20) + (32 << 20));
+    ASSERT_EQ(pool.cacheRequests(), 2);
+    // The second writer gets the blocks released by the first one.
+    ASSERT_EQ(pool.cacheHits(), i == 0 ? 0 : 2);
+    pool.reset();
+  }
+  ASSERT_EQ(counting->bytes, 0);
+}
+
+} // namespace gluten
@@ -0,0 +1,47 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/SpilledFile.h"
+
+#include <arrow/util/io_util.h>
+#include <gtest/gtest.h>
+
+namespace gluten {
+
+TEST(SpilledFileTest, readRemoteRangesInOrder) {
+  auto tmpDir = arrow::internal::TemporaryDir::Make("remote-spill-").ValueOrDie();
+  // A local dir through its uri takes the remote path.
+  auto [fs, dir] = getRemoteSpillFileSystem("file://" + tmpDir->path().ToString()).ValueOrDie();
+  auto file = createRemoteSpilledFile(fs, dir + "/00").ValueOrDie();
+  ASSERT_TRUE(file.remote);
+
+  auto os = openSpilledFileForWrite(file, 4, arrow::default_memory_pool()).ValueOrDie();
+  ASSERT_TRUE(os->Write("0123456789", 10).ok());
+  ASSERT_TRUE(os->Close().ok());
+
+  auto reader = SpilledFileReader::open(file, {{0, 3}, {3, 5}, {8, 2}}).ValueOrDie();
+  for (const auto* expected : {"012", "34567", "89"}) {
+    auto buffer = reader->next().ValueOrDie();
+    ASSERT_EQ(buffer->ToString(), expected);
+  }
+  ASSERT_FALSE(reader->next().ok());
+  ASSERT_TRUE(reader->close().ok());
+  ASSERT_TRUE(deleteSpilledFile(file).ok());
+  ASSERT_EQ(fs->GetFileInfo(file.path).ValueOrDie().type(), arrow::fs::FileType::NotFound);
+}
+
+} // namespace gluten
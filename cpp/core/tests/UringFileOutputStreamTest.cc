@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/UringFileOutputStream.h"
+
+#include <arrow/io/file.h>
+#include <arrow/util/io_util.h>
+#include <gtest/gtest.h>
+
+namespace gluten {
+
+class UringFileOutputStreamTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(UringFileOutputStreamTest, writeAcrossBuffers) {
+  auto tmpDir = arrow::internal::TemporaryDir::Make("uring-").ValueOrDie();
+  auto path = tmpDir->path().ToString() + "data";
+  constexpr int64_t kBufferSize = 8192;
+  auto os = UringFileOutputStream::open(path, GetParam(), 2, kBufferSize).ValueOrDie();
+
+  std::string expected;
+  for (int i = 0; i < 64; ++i) {
+    std::string chunk(1000 + i * 37, 'a' + i % 26);
+    ASSERT_TRUE(os->Write(chunk.data(), chunk.size()).ok());
+    expected += chunk;
+    ASSERT_EQ(os->Tell().ValueOrDie(), static_cast<int64_t>(expected.size()));
+    // The partial buffer is written on flush and again once full.
+    if (i == 20) {
+      ASSERT_TRUE(os->Flush().ok());
+    }
+  }
+  ASSERT_GT(static_cast<int64_t>(expected.size()), 4 * kBufferSize);
+  ASSERT_TRUE(os->Close().ok());
+  ASSERT_TRUE(os->closed());
+
+  auto in = arrow::io::ReadableFile::Open(path).ValueOrDie();
+  auto buffer = in->Read(expected.size() + 1).ValueOrDie();
+  ASSERT_EQ(buffer->ToString(), expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(DirectIo, UringFileOutputStreamTest, ::testing::Bool());
+
+} // namespace gluten
@@ -72,4 +72,15 @@ std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
   }
   return codec;
 }
+
+arrow::Status compressBatch(arrow::util::Codec* codec, std::vector<CompressJob>& jobs) {
+  if (auto* batchCodec = dynamic_cast<BatchCompressCodec*>(codec)) {
+    return batchCodec->compressBatch(jobs);
+  }
+  for (auto& job : jobs) {
+    ARROW_ASSIGN_OR_RAISE(
+        job.compressedLength, codec->Compress(job.inputLength, job.input, job.outputLength, job.output));
+  }
+  return arrow::Status::OK();
+}
 } // namespace gluten
\ No newline at end of file
@@ -0,0 +1,252 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CpuProfiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "utils/exception.h"
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace gluten {
+
+namespace {
+// The timers of all profilers carry this in the high bits of their signal value, to tell their signals from the
+// SIGPROF of others sharing the process, e.g. a JVM profiler.
+constexpr uint64_t kTimerMagic = 0x676c7574ULL << 32;
+constexpr uint64_t kTimerMagicMask = 0xffffffffULL << 32;
+// The signal handler and the signal trampoline.
+constexpr int32_t kSkippedFrames = 2;
+
+std::atomic_uint32_t nextProfilerId{0};
+std::once_flag installHandlerFlag;
+struct sigaction previousAction;
+
+// Touched by Scope before the timer of the thread is armed, so that the handler doesn't allocate them.
+thread_local CpuProfiler* tlsProfiler = nullptr;
+thread_local int32_t tlsTagId = 0;
+thread_local uint64_t tlsArmedId = 0;
+thread_local void* tlsBuffer = nullptr;
+
+std::string symbolize(void* pc) {
+  Dl_info info;
+  if (dladdr(pc, &info) == 0) {
+    return "[unknown]";
+  }
+  if (info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : info.dli_sname;
+    std::free(demangled);
+    return name;
+  }
+  const char* file = info.dli_fname ? std::strrchr(info.dli_fname, '/') : nullptr;
+  return std::string("[") + (file ? file + 1 : (info.dli_fname ? info.dli_fname : "unknown")) + "]";
+}
+} // namespace
+
+CpuProfiler::Scope::Scope(CpuProfiler* profiler, int32_t tagId)
+    : profiler_(profiler), previous_(tlsProfiler), previousTagId_(tlsTagId) {
+  profiler_->armCurrentThread();
+  tlsTagId = tagId;
+  tlsProfiler = profiler_;
+}
+
+CpuProfiler::Scope::~Scope() {
+  // Samples are dropped from here on, so the buffer can be drained without racing the handler.
+  tlsProfiler = previous_;
+  tlsTagId = previousTagId_;
+  auto* buffer = static_cast<ThreadBuffer*>(tlsBuffer);
+  if (previous_ != profiler_ && buffer != nullptr && tlsArmedId == profiler_->id_ &&
+      buffer->size.load(std::memory_order_relaxed) >= kSamplesPerThread / 2) {
+    std::lock_guard<std::mutex> lock(profiler_->mutex_);
+    profiler_->drainLocked(buffer);
+  }
+}
+
+CpuProfiler::CpuProfiler(int64_t intervalMicros, Clock clock)
+    : intervalMicros_(std::max<int64_t>(1, intervalMicros)), clock_(clock), id_(kTimerMagic | ++nextProfilerId) {
+  // The first backtrace may load the unwinder, which isn't safe in the signal handler.
+  void* frames[1];
+  backtrace(frames, 1);
+  std::call_once(installHandlerFlag, []() {
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &CpuProfiler::onSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+      throw GlutenException(std::string("Failed to install the SIGPROF handler: ") + std::strerror(errno));
+    }
+  });
+}
+
+CpuProfiler::~CpuProfiler() {
+  stop();
+}
+
+int32_t CpuProfiler::addTag(const std::string& tag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tags_.push_back(tag);
+  return tags_.size() - 1;
+}
+
+void CpuProfiler::armCurrentThread() {
+  if (tlsArmedId == id_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_) {
+    return;
+  }
+  buffers_.push_back(std::make_unique<ThreadBuffer>());
+  tlsBuffer = buffers_.back().get();
+
+  struct sigevent event;
+  std::memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = SIGPROF;
+  event.sigev_notify_thread_id = syscall(SYS_gettid);
+  event.sigev_value.sival_ptr = reinterpret_cast<void*>(id_);
+  timer_t timer;
+  auto clockId = clock_ == Clock::kCpu ? CLOCK_THREAD_CPUTIME_ID : CLOCK_MONOTONIC;
+  if (timer_create(clockId, &event, &timer) != 0) {
+    throw GlutenException(std::string("Failed to create the profiling timer: ") + std::strerror(errno));
+  }
+  struct itimerspec spec;
+  spec.it_interval.tv_sec = intervalMicros_ / 1000000;
+  spec.it_interval.tv_nsec = (intervalMicros_ % 1000000) * 1000;
+  spec.it_value = spec.it_interval;
+  if (timer_settime(timer, 0, &spec, nullptr) != 0) {
+    timer_delete(timer);
+    throw GlutenException(std::string("Failed to start the profiling timer: ") + std::strerror(errno));
+  }
+  timers_.push_back(timer);
+  tlsArmedId = id_;
+}
+
+void CpuProfiler::onSignal(int signo, siginfo_t* info, void* context) {
+  auto value = reinterpret_cast<uint64_t>(info->si_value.sival_ptr);
+  if (info->si_code != SI_TIMER || (value & kTimerMagicMask) != kTimerMagic) {
+    if (previousAction.sa_flags & SA_SIGINFO) {
+      if (previousAction.sa_sigaction != nullptr) {
+        previousAction.sa_sigaction(signo, info, context);
+      }
+    } else if (previousAction.sa_handler != SIG_DFL && previousAction.sa_handler != SIG_IGN) {
+      previousAction.sa_handler(signo);
+    }
+    return;
+  }
+  auto* profiler = tlsProfiler;
+  if (profiler == nullptr || profiler->id_ != value || tlsArmedId != value) {
+    // Out of any scope of the profiler the timer is armed for.
+    return;
+  }
+  auto savedErrno = errno;
+  auto* buffer = static_cast<ThreadBuffer*>(tlsBuffer);
+  auto size = buffer->size.load(std::memory_order_relaxed);
+  if (size >= kSamplesPerThread) {
+    profiler->numDropped_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    void* frames[kMaxFrames + kSkippedFrames];
+    auto numFrames = backtrace(frames, kMaxFrames + kSkippedFrames);
+    auto& sample = buffer->samples[size];
+    sample.tagId = tlsTagId;
+    sample.numFrames = std::max(0, numFrames - kSkippedFrames);
+    std::memcpy(sample.frames, frames + kSkippedFrames, sample.numFrames * sizeof(void*));
+    buffer->size.store(size + 1, std::memory_order_release);
+  }
+  errno = savedErrno;
+}
+
+void CpuProfiler::drainLocked(ThreadBuffer* buffer) {
+  auto size = buffer->size.load(std::memory_order_acquire);
+  for (int32_t i = 0; i < size; ++i) {
+    const auto& sample = buffer->samples[i];
+    stacks_[{sample.tagId, std::vector<void*>(sample.frames, sample.frames + sample.numFrames)}]++;
+  }
+  buffer->size.store(0, std::memory_order_relaxed);
+}
+
+void CpuProfiler::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_) {
+    return;
+  }
+  stopped_ = true;
+  for (auto& timer : timers_) {
+    timer_delete(timer);
+  }
+  timers_.clear();
+}
+
+int64_t CpuProfiler::numSamples() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t numSamples = 0;
+  for (const auto& [stack, count] : stacks_) {
+    numSamples += count;
+  }
+  for (const auto& buffer : buffers_) {
+    numSamples += buffer->size.load(std::memory_order_acquire);
+  }
+  return numSamples;
+}
+
+void CpuProfiler::writeFolded(std::ostream& out) {
+  stop();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& buffer : buffers_) {
+    drainLocked(buffer.get());
+  }
+  std::unordered_map<void*, std::string> symbols;
+  auto symbolOf = [&symbols](void* pc) -> const std::string& {
+    auto it = symbols.find(pc);
+    if (it == symbols.end()) {
+      it = symbols.emplace(pc, symbolize(pc)).first;
+    }
+    return it->second;
+  };
+  // Distinct pcs within the same functions fold into one stack.
+  std::map<std::string, int64_t> folded;
+  for (const auto& [stack, count] : stacks_) {
+    const auto& [tagId, frames] = stack;
+    std::string line = tags_[tagId];
+    for (auto i = static_cast<int32_t>(frames.size()) - 1; i >= 0; --i) {
+      // The outer frames are return addresses, which may belong to the next function.
+      auto* pc = i == 0 ? frames[i] : static_cast<char*>(frames[i]) - 1;
+      line += ";" + symbolOf(pc);
+    }
+    folded[line] += count;
+  }
+  for (const auto& [line, count] : folded) {
+    out << line << " " << count << "\n";
+  }
+}
+
+} // namespace gluten
@@ -0,0 +1,112 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <signal.h>
+#include <time.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace gluten {
+
+// Sampling profiler of the native call stacks of a task. Only the threads within a Scope are sampled, by a SIGPROF
+// timer of each thread firing every interval of its CPU time, or of wall time. The signal handler records the stacks
+// into a fixed buffer of the thread, which is aggregated when the thread leaves the scope. The stacks can be written
+// as folded stacks, the input of flamegraph.pl, each prefixed by the tag of its scope.
+class CpuProfiler {
+ public:
+  enum class Clock { kCpu, kWall };
+
+  // Samples the calling thread within its lifetime, tagging the stacks with the tag of tagId. The profiler must
+  // outlive it.
+  class Scope {
+   public:
+    Scope(CpuProfiler* profiler, int32_t tagId);
+
+    ~Scope();
+
+   private:
+    CpuProfiler* profiler_;
+    CpuProfiler* previous_;
+    int32_t previousTagId_;
+  };
+
+  CpuProfiler(int64_t intervalMicros, Clock clock);
+
+  ~CpuProfiler();
+
+  int32_t addTag(const std::string& tag);
+
+  // Stops the timers of the sampled threads. No thread may be within a scope of the profiler.
+  void stop();
+
+  // One line per distinct stack: "tag;outermost frame;...;innermost frame count". Stops the profiler.
+  void writeFolded(std::ostream& out);
+
+  int64_t numSamples();
+
+  // Samples lost because the buffer of a thread filled up within a scope.
+  int64_t numDroppedSamples() const {
+    return numDropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int32_t kMaxFrames = 32;
+  static constexpr int32_t kSamplesPerThread = 4096;
+
+  struct Sample {
+    int32_t tagId;
+    int32_t numFrames;
+    void* frames[kMaxFrames];
+  };
+
+  struct ThreadBuffer {
+    std::unique_ptr<Sample[]> samples{new Sample[kSamplesPerThread]};
+    std::atomic_int32_t size{0};
+  };
+
+  static void onSignal(int signo, siginfo_t* info, void* context);
+
+  // Creates the timer and the buffer of the calling thread, once per thread.
+  void armCurrentThread();
+
+  void drainLocked(ThreadBuffer* buffer);
+
+  const int64_t intervalMicros_;
+  const Clock clock_;
+  // Identifies the timers of this profiler in the signal handler.
+  const uint64_t id_;
+  std::atomic_int64_t numDropped_{0};
+
+  std::mutex mutex_;
+  std::vector<std::string> tags_;
+  std::vector<timer_t> timers_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  // Sample counts by the tag id and the frames, innermost first.
+  std::map<std::pair<int32_t, std::vector<void*>>, int64_t> stacks_;
+  bool stopped_ = false;
+};
+
+} // namespace gluten
@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+namespace gluten {
+
+// Histogram of latencies in nanos, in buckets whose width is 1/32 of their lower bound, so that a percentile is
+// reported within about 3% of its value, as an HDR histogram does. Recording is lock free and may race with reading.
+class LatencyHistogram {
+ public:
+  void record(int64_t nanos) {
+    auto value = static_cast<uint64_t>(std::max<int64_t>(nanos, 0));
+    buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    auto max = max_.load(std::memory_order_relaxed);
+    while (static_cast<int64_t>(value) > max &&
+           !max_.compare_exchange_weak(max, static_cast<int64_t>(value), std::memory_order_relaxed)) {
+    }
+  }
+
+  int64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  int64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  // The upper bound of the bucket holding the percentile-th latency, 0 if none was recorded.
+  int64_t percentile(double percentile) const {
+    auto total = count();
+    if (total == 0) {
+      return 0;
+    }
+    auto rank = std::max<int64_t>(1, static_cast<int64_t>(percentile / 100 * total + 0.5));
+    int64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += buckets_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(upperBoundOf(i), max());
+      }
+    }
+    return max();
+  }
+
+  // Records the time from construction to destruction into histogram, if not null.
+  class Timer {
+   public:
+    explicit Timer(LatencyHistogram* histogram)
+        : histogram_(histogram),
+          start_(histogram ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+
+    ~Timer() {
+      if (histogram_) {
+        histogram_->record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+      }
+    }
+
+   private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+ private:
+  static constexpr int32_t kSubBucketBits = 5;
+  static constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+  // Values below kSubBuckets get a bucket each, then each power of 2 gets kSubBuckets.
+  static constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  static size_t bucketOf(uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    int32_t msb = 63 - __builtin_clzll(value);
+    auto subBucket = (value >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+    return (msb - kSubBucketBits + 1) * kSubBuckets + subBucket;
+  }
+
+  static int64_t upperBoundOf(size_t bucket) {
+    auto group = bucket / kSubBuckets;
+    auto subBucket = bucket % kSubBuckets;
+    if (group == 0) {
+      return subBucket;
+    }
+    auto upper = ((kSubBuckets + subBucket + 1) << (group - 1)) - 1;
+    return upper > static_cast<uint64_t>(INT64_MAX) ? INT64_MAX : static_cast<int64_t>(upper);
+  }
+
+  std::array<std::atomic<int64_t>, kNumBuckets> buckets_{};
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> max_{0};
+};
+
+} // namespace gluten
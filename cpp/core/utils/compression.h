@@ -19,10 +19,43 @@
 
 #include <arrow/util/compression.h>
 
+#include <vector>
+
 namespace gluten {
 
 enum CodecBackend { NONE, QAT, IAA };
 
+struct CompressJob {
+  const uint8_t* input;
+  int64_t inputLength;
+  uint8_t* output;
+  int64_t outputLength;
+  // Set by compressBatch().
+  int64_t compressedLength;
+};
+
+// Codecs that can have several buffers in flight on an accelerator.
+class BatchCompressCodec {
+ public:
+  virtual ~BatchCompressCodec() = default;
+
+  // Submits the jobs as fast as the device takes them, then waits for the rest to complete.
+  virtual arrow::Status compressBatch(std::vector<CompressJob>& jobs) = 0;
+};
+
+// Codecs that decompress on an accelerator when it takes the buffer, and in software otherwise, per buffer.
+class HybridDecompressCodec {
+ public:
+  virtual ~HybridDecompressCodec() = default;
+
+  // Decompressed bytes by path.
+  virtual int64_t hardwareDecompressedBytes() const = 0;
+  virtual int64_t softwareDecompressedBytes() const = 0;
+};
+
+// Compresses the jobs as a batch if codec is a BatchCompressCodec, one by one otherwise.
+arrow::Status compressBatch(arrow::util::Codec* codec, std::vector<CompressJob>& jobs);
+
 std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
     arrow::Compression::type compressedType,
     CodecBackend codecBackend);
@@ -17,71 +17,125 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utils/LatencyHistogram.h"
+
 namespace gluten {
 
+// Per-operator counters of a native pipeline. The counters of an operator are stored contiguously, in the order of
+// names(), and the whole table is exported to Java in one buffer, which looks the counters up by name. A backend
+// reports counters of its own by passing their names as extraNames, without changing the JNI signature.
 struct Metrics {
+  // Counters all backends report, in the order of their names.
+  enum Counter : int32_t {
+    kInputRows = 0,
+    kInputVectors,
+    kInputBytes,
+    kRawInputRows,
+    kRawInputBytes,
+    kOutputRows,
+    kOutputVectors,
+    kOutputBytes,
+    // CpuWallTiming.
+    kCpuCount,
+    kWallNanos,
+    kPeakMemoryBytes,
+    kNumMemoryAllocations,
+    // Spill
+    kSpilledBytes,
+    kSpilledRows,
+    kSpilledPartitions,
+    kSpilledFiles,
+    // Runtime metrics.
+    kNumDynamicFiltersProduced,
+    kNumDynamicFiltersAccepted,
+    kNumReplacedWithDynamicFilterRows,
+    kFlushRowCount,
+    kAbandonedPartialAggregation,
+    kScanTime,
+    kSkippedSplits,
+    kProcessedSplits,
+    kSkippedStrides,
+    kProcessedStrides,
+    // Split preloading and I/O of the scans.
+    kPreloadedSplits,
+    kPreloadHits,
+    kIoWaitNanos,
+    kReadAheadBytes,
+    // Bytes the scans read from the memory cache, the ssd cache and the storage.
+    kRamReadBytes,
+    kLocalReadBytes,
+    kStorageReadBytes,
+    kNumCounters
+  };
+
+  static const std::vector<std::string>& counterNames() {
+    static const std::vector<std::string> names = {
+        "inputRows",
+        "inputVectors",
+        "inputBytes",
+        "rawInputRows",
+        "rawInputBytes",
+        "outputRows",
+        "outputVectors",
+        "outputBytes",
+        "cpuCount",
+        "wallNanos",
+        "peakMemoryBytes",
+        "numMemoryAllocations",
+        "spilledBytes",
+        "spilledRows",
+        "spilledPartitions",
+        "spilledFiles",
+        "numDynamicFiltersProduced",
+        "numDynamicFiltersAccepted",
+        "numReplacedWithDynamicFilterRows",
+        "flushRowCount",
+        "abandonedPartialAggregation",
+        "scanTime",
+        "skippedSplits",
+        "processedSplits",
+        "skippedStrides",
+        "processedStrides",
+        "preloadedSplits",
+        "preloadHits",
+        "ioWaitNanos",
+        "readAheadBytes",
+        "ramReadBytes",
+        "localReadBytes",
+        "storageReadBytes"};
+    return names;
+  }
+
   int numMetrics = 0;
 
-  long* inputRows;
-  long* inputVectors;
-  long* inputBytes;
-  long* rawInputRows;
-  long* rawInputBytes;
-  long* outputRows;
-  long* outputVectors;
-  long* outputBytes;
-
-  // CpuWallTiming.
-  long* cpuCount;
-  long* wallNanos;
   long veloxToArrow;
 
-  long* peakMemoryBytes;
-  long* numMemoryAllocations;
-
-  // Spill
-  long* spilledBytes;
-  long* spilledRows;
-  long* spilledPartitions;
-  long* spilledFiles;
-
-  // Runtime metrics.
-  long* numDynamicFiltersProduced;
-  long* numDynamicFiltersAccepted;
-  long* numReplacedWithDynamicFilterRows;
-  long* flushRowCount;
-  long* scanTime;
-  long* skippedSplits;
-  long* processedSplits;
-  long* skippedStrides;
-  long* processedStrides;
-
-  Metrics(int size) : numMetrics(size) {
-    inputRows = new long[numMetrics]();
-    inputVectors = new long[numMetrics]();
-    inputBytes = new long[numMetrics]();
-    rawInputRows = new long[numMetrics]();
-    rawInputBytes = new long[numMetrics]();
-    outputRows = new long[numMetrics]();
-    outputVectors = new long[numMetrics]();
-    outputBytes = new long[numMetrics]();
-    cpuCount = new long[numMetrics]();
-    wallNanos = new long[numMetrics]();
-    peakMemoryBytes = new long[numMetrics]();
-    numMemoryAllocations = new long[numMetrics]();
-    spilledBytes = new long[numMetrics]();
-    spilledRows = new long[numMetrics]();
-    spilledFiles = new long[numMetrics]();
-    spilledPartitions = new long[numMetrics]();
-    numDynamicFiltersProduced = new long[numMetrics]();
-    numDynamicFiltersAccepted = new long[numMetrics]();
-    numReplacedWithDynamicFilterRows = new long[numMetrics]();
-    flushRowCount = new long[numMetrics]();
-    scanTime = new long[numMetrics]();
-    skippedSplits = new long[numMetrics]();
-    processedSplits = new long[numMetrics]();
-    skippedStrides = new long[numMetrics]();
-    processedStrides = new long[numMetrics]();
+  // Time spent waiting for ExecutorMemoryArbitrator to reclaim memory from other tasks.
+  long arbitrationWaitNanos = 0;
+
+  // Task-wide values exported by name, e.g. the percentiles of the latency histograms.
+  std::vector<std::pair<std::string, int64_t>> taskValues;
+
+  // Adds <name>Count, <name>P50Nanos, <name>P90Nanos, <name>P99Nanos and <name>MaxNanos.
+  void addLatencies(const std::string& name, const LatencyHistogram& histogram) {
+    taskValues.emplace_back(name + "Count", histogram.count());
+    taskValues.emplace_back(name + "P50Nanos", histogram.percentile(50));
+    taskValues.emplace_back(name + "P90Nanos", histogram.percentile(90));
+    taskValues.emplace_back(name + "P99Nanos", histogram.percentile(99));
+    taskValues.emplace_back(name + "MaxNanos", histogram.max());
+  }
+
+  // The extra counters get the ids from kNumCounters on, in the order of extraNames.
+  explicit Metrics(int size, const std::vector<std::string>& extraNames = {})
+      : numMetrics(size), names_(counterNames()) {
+    names_.insert(names_.end(), extraNames.begin(), extraNames.end());
+    values_.resize(static_cast<size_t>(numMetrics) * names_.size());
   }
 
   Metrics(const Metrics&) = delete;
@@ -89,33 +143,30 @@ struct Metrics {
   Metrics& operator=(const Metrics&) = delete;
   Metrics& operator=(Metrics&&) = delete;
 
-  ~Metrics() {
-    delete[] inputRows;
-    delete[] inputVectors;
-    delete[] inputBytes;
-    delete[] rawInputRows;
-    delete[] rawInputBytes;
-    delete[] outputRows;
-    delete[] outputVectors;
-    delete[] outputBytes;
-    delete[] cpuCount;
-    delete[] wallNanos;
-    delete[] peakMemoryBytes;
-    delete[] numMemoryAllocations;
-    delete[] spilledBytes;
-    delete[] spilledRows;
-    delete[] spilledFiles;
-    delete[] spilledPartitions;
-    delete[] numDynamicFiltersProduced;
-    delete[] numDynamicFiltersAccepted;
-    delete[] numReplacedWithDynamicFilterRows;
-    delete[] flushRowCount;
-    delete[] scanTime;
-    delete[] skippedSplits;
-    delete[] processedSplits;
-    delete[] skippedStrides;
-    delete[] processedStrides;
+  int64_t& at(int metricIdx, int32_t counter) {
+    return values_[static_cast<size_t>(metricIdx) * names_.size() + counter];
   }
+
+  int64_t at(int metricIdx, int32_t counter) const {
+    return values_[static_cast<size_t>(metricIdx) * names_.size() + counter];
+  }
+
+  const std::vector<std::string>& names() const {
+    return names_;
+  }
+
+  // numMetrics rows of names().size() counters.
+  int64_t* data() {
+    return values_.data();
+  }
+
+  size_t byteSize() const {
+    return values_.size() * sizeof(int64_t);
+  }
+
+ private:
+  std::vector<std::string> names_;
+  std::vector<int64_t> values_;
 };
 
 } // namespace gluten
@@ -25,6 +25,7 @@
 #include <mutex>
 
 #include "QatCodec.h"
+#include "utils/compression.h"
 
 #define QZ_INIT_FAIL(rc) (QZ_OK != rc && QZ_DUPLICATE != rc)
 
@@ -33,24 +34,35 @@
 namespace gluten {
 namespace qat {
 
-class QatZipCodec : public arrow::util::Codec {
+class QatZipCodec : public arrow::util::Codec, public HybridDecompressCodec {
  protected:
   explicit QatZipCodec(int compressionLevel) : compressionLevel_(compressionLevel) {}
 
+  // Buffers the device fails to decompress are decompressed by zlib, which reads the same gzip stream.
   arrow::Result<int64_t> Decompress(int64_t inputLen, const uint8_t* input, int64_t outputLen, uint8_t* output)
       override {
     uint32_t compressedSize = static_cast<uint32_t>(inputLen);
     uint32_t uncompressedSize = static_cast<uint32_t>(outputLen);
     int ret = qzDecompress(&qzSession_, input, &compressedSize, output, &uncompressedSize);
     if (ret == QZ_OK) {
+      hardwareDecompressedBytes_ += uncompressedSize;
       return static_cast<int64_t>(uncompressedSize);
-    } else if (ret == QZ_PARAMS) {
-      return arrow::Status::IOError("QAT decompression failure: params is invalid");
-    } else if (ret == QZ_FAIL) {
-      return arrow::Status::IOError("QAT decompression failure: Function did not succeed");
-    } else {
-      return arrow::Status::IOError("QAT decompression failure with error:", ret);
     }
+    ARROW_LOG(WARNING) << "QAT decompression failed with error: " << ret << ", falling back to zlib.";
+    if (softwareCodec_ == nullptr) {
+      ARROW_ASSIGN_OR_RAISE(softwareCodec_, arrow::util::Codec::Create(arrow::Compression::GZIP));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto decompressedSize, softwareCodec_->Decompress(inputLen, input, outputLen, output));
+    softwareDecompressedBytes_ += decompressedSize;
+    return decompressedSize;
+  }
+
+  int64_t hardwareDecompressedBytes() const override {
+    return hardwareDecompressedBytes_;
+  }
+
+  int64_t softwareDecompressedBytes() const override {
+    return softwareDecompressedBytes_;
   }
 
   int64_t MaxCompressedLen(int64_t inputLen, const uint8_t* ARROW_ARG_UNUSED(input)) override {
@@ -87,6 +99,9 @@ class QatZipCodec : public arrow::util::Codec {
 
   int compressionLevel_;
   QzSession_T qzSession_ = {0};
+  std::unique_ptr<arrow::util::Codec> softwareCodec_;
+  int64_t hardwareDecompressedBytes_ = 0;
+  int64_t softwareDecompressedBytes_ = 0;
 };
 
 class QatGZipCodec final : public QatZipCodec {
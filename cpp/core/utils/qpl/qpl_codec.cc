@@ -19,8 +19,10 @@
 #include <arrow/util/logging.h>
 #include <utils/qpl/qpl_codec.h>
 #include <utils/qpl/qpl_job_pool.h>
+#include <deque>
 #include <iostream>
 #include <map>
+#include "utils/compression.h"
 
 namespace gluten {
 namespace qpl {
@@ -41,13 +43,7 @@ class HardwareCodecDeflateQpl {
       return RET_ERROR;
     }
 
-    jobPtr->op = qpl_op_compress;
-    jobPtr->next_in_ptr = const_cast<uint8_t*>(source);
-    jobPtr->next_out_ptr = dest;
-    jobPtr->available_in = source_size;
-    jobPtr->level = compressionLevel_;
-    jobPtr->available_out = dest_size;
-    jobPtr->flags = QPL_FLAG_FIRST | QPL_FLAG_DYNAMIC_HUFFMAN | QPL_FLAG_LAST | QPL_FLAG_OMIT_VERIFY;
+    prepareCompressJob(jobPtr, source, source_size, dest, dest_size);
 
     if (auto status = qpl_execute_job(jobPtr); status == QPL_STS_OK) {
       auto compressed_size = jobPtr->total_out;
@@ -62,6 +58,56 @@ class HardwareCodecDeflateQpl {
     }
   }
 
+  /// Submits the jobs to the IAA hardware while job objects are free, waiting for the oldest submitted job when none
+  /// is, then waits for the rest. Jobs that couldn't be run on the hardware are left with RET_ERROR.
+  void doCompressBatch(std::vector<CompressJob>& jobs) const {
+    struct InFlightJob {
+      size_t index;
+      uint32_t jobId;
+      qpl_job* jobPtr;
+    };
+    auto& pool = QplJobHWPool::GetInstance();
+    std::deque<InFlightJob> inFlight;
+    auto completeOldest = [&]() {
+      auto job = inFlight.front();
+      inFlight.pop_front();
+      if (auto status = qpl_wait_job(job.jobPtr); status == QPL_STS_OK) {
+        jobs[job.index].compressedLength = job.jobPtr->total_out;
+      } else {
+        ARROW_LOG(WARNING)
+            << "DeflateQpl HW codec failed, falling back to SW codec. (Details: doCompressBatch->qpl_wait_job with error code: "
+            << status << " - please refer to qpl_status in ./contrib/qpl/include/qpl/c_api/status.h)";
+        jobs[job.index].compressedLength = RET_ERROR;
+      }
+      pool.ReleaseJob(job.jobId);
+    };
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      uint32_t jobId = 0;
+      qpl_job* jobPtr;
+      while (!(jobPtr = pool.AcquireJob(jobId)) && !inFlight.empty()) {
+        completeOldest();
+      }
+      if (!jobPtr) {
+        jobs[i].compressedLength = RET_ERROR;
+        continue;
+      }
+      prepareCompressJob(jobPtr, jobs[i].input, jobs[i].inputLength, jobs[i].output, jobs[i].outputLength);
+      if (auto status = qpl_submit_job(jobPtr); status != QPL_STS_OK) {
+        ARROW_LOG(WARNING)
+            << "DeflateQpl HW codec failed, falling back to SW codec. (Details: doCompressBatch->qpl_submit_job with error code: "
+            << status << " - please refer to qpl_status in ./contrib/qpl/include/qpl/c_api/status.h)";
+        pool.ReleaseJob(jobId);
+        jobs[i].compressedLength = RET_ERROR;
+        continue;
+      }
+      inFlight.push_back({i, jobId, jobPtr});
+    }
+    while (!inFlight.empty()) {
+      completeOldest();
+    }
+  }
+
   /// Submit job request to the IAA hardware and then busy waiting till it complete.
   int64_t doDecompressData(const uint8_t* source, uint32_t source_size, uint8_t* dest, uint32_t uncompressed_size) {
     uint32_t job_id = 0;
@@ -94,6 +140,21 @@ class HardwareCodecDeflateQpl {
   }
 
  private:
+  void prepareCompressJob(
+      qpl_job* jobPtr,
+      const uint8_t* source,
+      uint32_t source_size,
+      uint8_t* dest,
+      uint32_t dest_size) const {
+    jobPtr->op = qpl_op_compress;
+    jobPtr->next_in_ptr = const_cast<uint8_t*>(source);
+    jobPtr->next_out_ptr = dest;
+    jobPtr->available_in = source_size;
+    jobPtr->level = compressionLevel_;
+    jobPtr->available_out = dest_size;
+    jobPtr->flags = QPL_FLAG_FIRST | QPL_FLAG_DYNAMIC_HUFFMAN | QPL_FLAG_LAST | QPL_FLAG_OMIT_VERIFY;
+  }
+
   qpl_compression_levels compressionLevel_ = qpl_default_level;
 };
 
@@ -170,7 +231,7 @@ class SoftwareCodecDeflateQpl final {
   }
 };
 
-class QplGzipCodec final : public arrow::util::Codec {
+class QplGzipCodec final : public arrow::util::Codec, public BatchCompressCodec, public HybridDecompressCodec {
  public:
   explicit QplGzipCodec(qpl_compression_levels compressionLevel)
       : hwCodec_(std::make_unique<HardwareCodecDeflateQpl>(compressionLevel)),
@@ -188,6 +249,21 @@ class QplGzipCodec final : public arrow::util::Codec {
     return res;
   }
 
+  arrow::Status compressBatch(std::vector<CompressJob>& jobs) override {
+    for (auto& job : jobs) {
+      job.compressedLength = HardwareCodecDeflateQpl::RET_ERROR;
+    }
+    if (QplJobHWPool::GetInstance().IsJobPoolReady()) {
+      hwCodec_->doCompressBatch(jobs);
+    }
+    for (auto& job : jobs) {
+      if (job.compressedLength == HardwareCodecDeflateQpl::RET_ERROR) {
+        job.compressedLength = swCodec_->doCompressData(job.input, job.inputLength, job.output, job.outputLength);
+      }
+    }
+    return arrow::Status::OK();
+  }
+
   arrow::Result<int64_t>
   Decompress(int64_t input_len, const uint8_t* input, int64_t output_buffer_len, uint8_t* output_buffer) override {
     auto res = HardwareCodecDeflateQpl::RET_ERROR;
@@ -195,11 +271,22 @@ class QplGzipCodec final : public arrow::util::Codec {
       res = hwCodec_->doDecompressData(input, input_len, output_buffer, output_buffer_len);
     }
     if (res == HardwareCodecDeflateQpl::RET_ERROR) {
-      return swCodec_->doDecompressData(input, input_len, output_buffer, output_buffer_len);
+      res = swCodec_->doDecompressData(input, input_len, output_buffer, output_buffer_len);
+      softwareDecompressedBytes_ += res;
+      return res;
     }
+    hardwareDecompressedBytes_ += res;
     return res;
   }
 
+  int64_t hardwareDecompressedBytes() const override {
+    return hardwareDecompressedBytes_;
+  }
+
+  int64_t softwareDecompressedBytes() const override {
+    return softwareDecompressedBytes_;
+  }
+
   int64_t MaxCompressedLen(int64_t input_len, const uint8_t* ARROW_ARG_UNUSED(input)) override {
     ARROW_DCHECK_GE(input_len, 0);
     /// Aligned with ZLIB
@@ -231,6 +318,8 @@ class QplGzipCodec final : public arrow::util::Codec {
  private:
   std::unique_ptr<HardwareCodecDeflateQpl> hwCodec_;
   std::unique_ptr<SoftwareCodecDeflateQpl> swCodec_;
+  int64_t hardwareDecompressedBytes_ = 0;
+  int64_t softwareDecompressedBytes_ = 0;
 };
 
 bool SupportsCodec(const std::string& codec) {
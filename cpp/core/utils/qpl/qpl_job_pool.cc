@@ -25,7 +25,8 @@ namespace gluten {
 namespace qpl {
 
 std::array<qpl_job*, QplJobHWPool::MAX_JOB_NUMBER> QplJobHWPool::jobPool;
-std::array<std::atomic_bool, QplJobHWPool::MAX_JOB_NUMBER> QplJobHWPool::jobLocks;
+std::array<std::atomic<uint32_t>, QplJobHWPool::MAX_JOB_NUMBER> QplJobHWPool::nextFreeJob;
+std::atomic<uint64_t> QplJobHWPool::freeJobHead{QplJobHWPool::kNoJob};
 bool QplJobHWPool::jobPoolReady = false;
 std::unique_ptr<uint8_t[]> QplJobHWPool::hwJobsBuffer;
 
@@ -34,7 +35,7 @@ QplJobHWPool& QplJobHWPool::GetInstance() {
   return pool;
 }
 
-QplJobHWPool::QplJobHWPool() : randomEngine(std::random_device()()), distribution(0, MAX_JOB_NUMBER - 1) {
+QplJobHWPool::QplJobHWPool() {
   uint64_t initTime = 0;
   TIME_NANO(initTime, InitJobPool());
 #ifdef GLUTEN_PRINT_DEBUG
@@ -45,10 +46,7 @@ QplJobHWPool::QplJobHWPool() : randomEngine(std::random_device()()), distributio
 QplJobHWPool::~QplJobHWPool() {
   for (uint32_t i = 0; i < MAX_JOB_NUMBER; ++i) {
     if (jobPool[i]) {
-      while (!tryLockJob(i))
-        ;
       qpl_fini_job(jobPool[i]);
-      unLockJob(i);
       jobPool[i] = nullptr;
     }
   }
@@ -78,7 +76,9 @@ void QplJobHWPool::InitJobPool() {
       return;
     }
     jobPool[index] = qplJobPtr;
-    jobLocks[index].store(false);
+  }
+  for (uint32_t index = 0; index < MAX_JOB_NUMBER; ++index) {
+    pushFreeJob(index);
   }
   ARROW_LOG(WARNING) << "Initialization of hardware-assisted DeflateQpl codec succeeded.";
   jobPoolReady = true;
@@ -88,38 +88,43 @@ qpl_job* QplJobHWPool::AcquireJob(uint32_t& jobId) {
   if (!IsJobPoolReady()) {
     return nullptr;
   }
-  uint32_t retry = 0;
-  auto index = distribution(randomEngine);
-  while (!tryLockJob(index)) {
-    index = distribution(randomEngine);
-    retry++;
-    if (retry > MAX_JOB_NUMBER) {
-      return nullptr;
-    }
+  auto index = popFreeJob();
+  if (index == kNoJob) {
+    return nullptr;
   }
   jobId = MAX_JOB_NUMBER - index;
-#ifdef GLUTEN_PRINT_DEBUG
-  std::cout << "Acquired job index " << index << " after " << retry << " retries." << std::endl;
-#endif
   return jobPool[index];
 }
 
 void QplJobHWPool::ReleaseJob(uint32_t jobId) {
   if (IsJobPoolReady()) {
     auto index = MAX_JOB_NUMBER - jobId;
-    unLockJob(index);
+    CheckJobIndex(index);
+    pushFreeJob(index);
   }
 }
 
-bool QplJobHWPool::tryLockJob(uint32_t index) {
-  CheckJobIndex(index);
-  bool expected = false;
-  return jobLocks[index].compare_exchange_strong(expected, true);
+uint32_t QplJobHWPool::popFreeJob() {
+  auto head = freeJobHead.load(std::memory_order_acquire);
+  while (true) {
+    auto index = static_cast<uint32_t>(head);
+    if (index == kNoJob) {
+      return kNoJob;
+    }
+    uint64_t next = (((head >> 32) + 1) << 32) | nextFreeJob[index].load(std::memory_order_relaxed);
+    if (freeJobHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return index;
+    }
+  }
 }
 
-void QplJobHWPool::unLockJob(uint32_t index) {
-  CheckJobIndex(index);
-  jobLocks[index].store(false);
+void QplJobHWPool::pushFreeJob(uint32_t index) {
+  auto head = freeJobHead.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    nextFreeJob[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    next = (((head >> 32) + 1) << 32) | index;
+  } while (!freeJobHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
 }
 
 } // namespace qpl
@@ -20,7 +20,6 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
-#include <random>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -58,8 +57,9 @@ class QplJobHWPool {
   QplJobHWPool();
   ~QplJobHWPool();
   static void InitJobPool();
-  bool tryLockJob(uint32_t index);
-  void unLockJob(uint32_t index);
+  /// Pops the index of a free job, kNoJob if all are in use.
+  static uint32_t popFreeJob();
+  static void pushFreeJob(uint32_t index);
 
   static inline void CheckJobIndex(uint32_t index) {
     if (index >= MAX_JOB_NUMBER) {
@@ -67,18 +67,19 @@ class QplJobHWPool {
     }
   }
 
-  /// Max jobs in QPL_JOB_POOL
-  static constexpr auto MAX_JOB_NUMBER = 64;
+  /// Max jobs in QPL_JOB_POOL, enough to keep the queues of the device full with batches of submitted jobs
+  static constexpr auto MAX_JOB_NUMBER = 512;
+  static constexpr uint32_t kNoJob = UINT32_MAX;
   /// Entire buffer for storing all job objects
   static std::unique_ptr<uint8_t[]> hwJobsBuffer;
   /// Job pool for storing all job object pointers
   static std::array<qpl_job*, MAX_JOB_NUMBER> jobPool;
-  /// Locks for accessing each job object pointers
-  static std::array<std::atomic_bool, MAX_JOB_NUMBER> jobLocks;
+  /// The free jobs form a stack linked by nextFreeJob. Its head holds the index of the top job in the low 32 bits and
+  /// a counter of the updates in the high ones, so a pop racing with a pop and a push of the same job fails.
+  static std::array<std::atomic<uint32_t>, MAX_JOB_NUMBER> nextFreeJob;
+  static std::atomic<uint64_t> freeJobHead;
 
   static bool jobPoolReady;
-  std::mt19937 randomEngine;
-  std::uniform_int_distribution<int> distribution;
 };
 
 } //  namespace qpl
@@ -16,6 +16,9 @@
  */
 
 #include "BenchmarkUtils.h"
+
+#include <algorithm>
+
 #include "compute/VeloxBackend.h"
 #include "compute/VeloxInitializer.h"
 #include "config/GlutenConfig.h"
@@ -30,6 +33,7 @@ DEFINE_string(batch_size, "4096", "To set velox::core::QueryConfig::kPreferredOu
 DEFINE_int32(cpu, -1, "Run benchmark on specific CPU");
 DEFINE_int32(threads, 1, "The number of threads to run this benchmark");
 DEFINE_int32(iterations, 1, "The number of iterations to run this benchmark");
+DEFINE_bool(scaling, false, "Run with 1, 2, 4... up to the number of cores threads, ignoring --threads");
 
 namespace {
 
@@ -140,6 +144,52 @@ std::shared_ptr<arrow::RecordBatchReader> createReader(const std::string& path)
 }
 #endif
 
+void setBenchmarkThreads(benchmark::internal::Benchmark* bm) {
+  if (FLAGS_scaling) {
+    bm->ThreadRange(1, std::thread::hardware_concurrency());
+  } else if (FLAGS_threads > 0) {
+    bm->Threads(FLAGS_threads);
+  } else {
+    bm->ThreadRange(1, std::thread::hardware_concurrency());
+  }
+  if (FLAGS_iterations > 0) {
+    bm->Iterations(FLAGS_iterations);
+  }
+}
+
+void IterationLatencies::start(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_.clear();
+  }
+}
+
+void IterationLatencies::record(int64_t nanos) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  latencies_.push_back(nanos);
+}
+
+void IterationLatencies::report(benchmark::State& state) {
+  // Summed over the threads.
+  state.counters["tasks_per_second"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  if (state.thread_index() != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (latencies_.empty()) {
+    return;
+  }
+  std::sort(latencies_.begin(), latencies_.end());
+  auto percentile = [&](double p) {
+    auto index = std::min<size_t>(latencies_.size() - 1, p * latencies_.size());
+    return benchmark::Counter(latencies_[index] / 1e6);
+  };
+  state.counters["latency_p50_ms"] = percentile(0.5);
+  state.counters["latency_p90_ms"] = percentile(0.9);
+  state.counters["latency_p99_ms"] = percentile(0.99);
+  state.counters["latency_max_ms"] = benchmark::Counter(latencies_.back() / 1e6);
+}
+
 void setCpu(uint32_t cpuindex) {
   static const auto kTotalCores = std::thread::hardware_concurrency();
   cpuindex = cpuindex % kTotalCores;
@@ -21,12 +21,14 @@
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <thread>
 #include <utility>
 #include "substrait/SubstraitToVeloxPlan.h"
 
 #include "compute/ProtobufUtils.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "utils/TaskContext.h"
 #include "utils/exception.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
@@ -37,6 +39,7 @@ DECLARE_string(batch_size);
 DECLARE_int32(cpu);
 DECLARE_int32(threads);
 DECLARE_int32(iterations);
+DECLARE_bool(scaling);
 
 /// Initilize the Velox backend with default value.
 void initVeloxBackend();
@@ -103,3 +106,37 @@ inline std::shared_ptr<gluten::ColumnarBatch> convertBatch(std::shared_ptr<glute
 bool endsWith(const std::string& data, const std::string& suffix);
 
 void setCpu(uint32_t cpuindex);
+
+/// Run the benchmark with --threads, or with 1, 2, 4... up to the number of cores with --scaling, for
+/// --iterations.
+void setBenchmarkThreads(benchmark::internal::Benchmark* bm);
+
+/// The task context storage of one benchmark iteration, as each Spark task creates on its thread. Declare it first
+/// in the iteration, so that the objects bound to the task are released last.
+class BenchmarkTaskContext {
+ public:
+  BenchmarkTaskContext() {
+    gluten::createTaskContextStorage("benchmark_task");
+  }
+
+  ~BenchmarkTaskContext() {
+    gluten::deleteTaskContextStorage();
+  }
+};
+
+/// Latencies of the iterations of all the threads of a benchmark, reported as percentiles by thread 0 along with
+/// the throughput of all the threads. The thread count to compare them by is in the benchmark name.
+class IterationLatencies {
+ public:
+  /// Call before the iteration loop.
+  void start(benchmark::State& state);
+
+  void record(int64_t nanos);
+
+  /// Call after the iteration loop, which the threads leave together.
+  void report(benchmark::State& state);
+
+ private:
+  std::mutex mutex_;
+  std::vector<int64_t> latencies_;
+};
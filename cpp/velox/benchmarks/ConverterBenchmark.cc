@@ -0,0 +1,432 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Columnar to row, row to columnar and shuffle benchmark over synthetic schemas, shared with benchmark_converters of
+// the ClickHouse backend to compare the backends on identical data. The schemas are generated once into
+// --data_dir/<schema>.parquet, which benchmark_converters reads, so run this benchmark first. Both report the same
+// benchmark names and counters; merge their --benchmark_out_format=json results with
+// dev/compare_converter_benchmarks.py.
+
+#include <arrow/c/bridge.h>
+#include <arrow/filesystem/localfs.h>
+#include <arrow/io/file.h>
+#include <arrow/record_batch.h>
+#include <benchmark/benchmark.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/file_reader.h>
+
+#include <filesystem>
+#include <numeric>
+#include <random>
+
+#include "benchmarks/BenchmarkUtils.h"
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryPool.h"
+#include "operators/serializer/VeloxColumnarToRowConverter.h"
+#include "operators/serializer/VeloxRowToColumnarConverter.h"
+#include "operators/writer/ArrowWriter.h"
+#include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/VeloxShuffleReader.h"
+#include "shuffle/VeloxShuffleWriter.h"
+#include "utils/ArrowTypeUtils.h"
+#include "utils/VeloxArrowUtils.h"
+#include "utils/macros.h"
+
+using namespace facebook;
+
+DEFINE_string(data_dir, "/tmp/gluten_converter_benchmark", "Directory of the generated <schema>.parquet files");
+DEFINE_int32(rows, 1 << 20, "Rows of each generated schema");
+DEFINE_int32(batch_rows, 4096, "Rows of each generated row group, read as one batch");
+DEFINE_int32(partitions, 200, "Shuffle partitions");
+
+namespace gluten {
+
+namespace {
+
+struct SyntheticSchema {
+  std::string name;
+  velox::RowTypePtr type;
+};
+
+// Keep in sync with the headers of cpp-ch/local-engine/tests/benchmark_converters.cpp.
+const std::vector<SyntheticSchema>& syntheticSchemas() {
+  static const std::vector<SyntheticSchema> schemas = [] {
+    std::vector<std::string> stringNames;
+    for (int32_t i = 0; i < 16; ++i) {
+      stringNames.push_back("c_string" + std::to_string(i));
+    }
+    return std::vector<SyntheticSchema>{
+        {"narrow_numeric",
+         velox::ROW(
+             {"c_bigint", "c_int", "c_double", "c_date"},
+             {velox::BIGINT(), velox::INTEGER(), velox::DOUBLE(), velox::DATE()})},
+        {"wide_strings", velox::ROW(std::move(stringNames), std::vector<velox::TypePtr>(16, velox::VARCHAR()))},
+        {"nested",
+         velox::ROW(
+             {"c_bigint", "c_array", "c_map"},
+             {velox::BIGINT(), velox::ARRAY(velox::BIGINT()), velox::MAP(velox::VARCHAR(), velox::BIGINT())})},
+        {"decimals",
+         velox::ROW({"c_short_decimal", "c_long_decimal"}, {velox::DECIMAL(12, 2), velox::DECIMAL(38, 10)})}};
+  }();
+  return schemas;
+}
+
+std::string dataFile(const SyntheticSchema& schema) {
+  return FLAGS_data_dir + "/" + schema.name + ".parquet";
+}
+
+// Strings of 0 to 64 characters, the values of the string columns are prefixes of them.
+const std::vector<std::string>& words() {
+  static const std::vector<std::string> words = [] {
+    std::mt19937_64 gen(1);
+    std::vector<std::string> result;
+    for (int32_t i = 0; i < 4096; ++i) {
+      std::string word(gen() % 65, ' ');
+      for (auto& c : word) {
+        c = 'a' + gen() % 26;
+      }
+      result.push_back(std::move(word));
+    }
+    return result;
+  }();
+  return words;
+}
+
+template <typename T, typename F>
+velox::VectorPtr makeFlatVector(velox::TypePtr type, int32_t size, velox::memory::MemoryPool* pool, F&& valueAt) {
+  auto vector = velox::BaseVector::create<velox::FlatVector<T>>(type, size, pool);
+  for (int32_t row = 0; row < size; ++row) {
+    if (row % 17 == 0) {
+      vector->setNull(row, true);
+    } else {
+      vector->set(row, valueAt(row));
+    }
+  }
+  return vector;
+}
+
+// String values of at most maxLength characters.
+velox::VectorPtr
+makeStringVector(int32_t size, int32_t maxLength, std::mt19937_64& gen, velox::memory::MemoryPool* pool) {
+  return makeFlatVector<velox::StringView>(velox::VARCHAR(), size, pool, [&](auto) {
+    const auto& word = words()[gen() % words().size()];
+    return velox::StringView(word.data(), std::min<int32_t>(word.size(), gen() % (maxLength + 1)));
+  });
+}
+
+// Offsets and sizes of 0 to maxElements elements per row. The rows aren't null, the ClickHouse backend has no nullable
+// arrays or maps.
+void makeSizes(
+    int32_t size,
+    int32_t maxElements,
+    std::mt19937_64& gen,
+    velox::memory::MemoryPool* pool,
+    velox::BufferPtr& offsets,
+    velox::BufferPtr& sizes,
+    int32_t& numElements) {
+  offsets = velox::allocateOffsets(size, pool);
+  sizes = velox::allocateSizes(size, pool);
+  auto* rawOffsets = offsets->asMutable<velox::vector_size_t>();
+  auto* rawSizes = sizes->asMutable<velox::vector_size_t>();
+  numElements = 0;
+  for (int32_t row = 0; row < size; ++row) {
+    rawOffsets[row] = numElements;
+    rawSizes[row] = gen() % (maxElements + 1);
+    numElements += rawSizes[row];
+  }
+}
+
+velox::VectorPtr makeColumn(
+    const velox::TypePtr& type,
+    int32_t column,
+    int32_t size,
+    std::mt19937_64& gen,
+    velox::memory::MemoryPool* pool) {
+  switch (type->kind()) {
+    case velox::TypeKind::BIGINT:
+      // Fits the precision of DECIMAL(12, 2) as well.
+      return makeFlatVector<int64_t>(type, size, pool, [&](auto) { return gen() % 1'000'000'000'000L; });
+    case velox::TypeKind::HUGEINT:
+      return makeFlatVector<velox::int128_t>(type, size, pool, [&](auto) {
+        auto high = static_cast<velox::int128_t>(gen() % 1'000'000'000'000'000'000UL);
+        return high * 1'000'000'000 + gen() % 1'000'000'000;
+      });
+    case velox::TypeKind::INTEGER:
+      return makeFlatVector<int32_t>(type, size, pool, [&](auto) { return gen() % 1'000'000; });
+    case velox::TypeKind::DOUBLE:
+      return makeFlatVector<double>(type, size, pool, [&](auto) { return gen() / 1e9; });
+    case velox::TypeKind::DATE:
+      return makeFlatVector<velox::Date>(type, size, pool, [&](auto) { return velox::Date(gen() % 20000); });
+    case velox::TypeKind::VARCHAR:
+      // The wide string columns range from short to long values.
+      return makeStringVector(size, 8 << (column % 4), gen, pool);
+    case velox::TypeKind::ARRAY: {
+      velox::BufferPtr offsets, sizes;
+      int32_t numElements;
+      makeSizes(size, 8, gen, pool, offsets, sizes, numElements);
+      auto elements = makeColumn(type->childAt(0), column, numElements, gen, pool);
+      return std::make_shared<velox::ArrayVector>(pool, type, nullptr, size, offsets, sizes, elements);
+    }
+    case velox::TypeKind::MAP: {
+      velox::BufferPtr offsets, sizes;
+      int32_t numEntries;
+      makeSizes(size, 4, gen, pool, offsets, sizes, numEntries);
+      // Keys must not be null.
+      auto keys = velox::BaseVector::create<velox::FlatVector<velox::StringView>>(velox::VARCHAR(), numEntries, pool);
+      for (int32_t i = 0; i < numEntries; ++i) {
+        keys->set(i, velox::StringView(words()[gen() % words().size()]));
+      }
+      auto values = makeColumn(type->childAt(1), column, numEntries, gen, pool);
+      return std::make_shared<velox::MapVector>(pool, type, nullptr, size, offsets, sizes, keys, values);
+    }
+    default:
+      VELOX_UNSUPPORTED("Unsupported synthetic column type {}", type->toString());
+  }
+}
+
+// Writes the schema's rows into its data file, unless it exists.
+void generateDataFile(const SyntheticSchema& schema) {
+  auto path = dataFile(schema);
+  if (std::filesystem::exists(path)) {
+    return;
+  }
+  std::filesystem::create_directories(FLAGS_data_dir);
+  // Renamed when complete, so that an interrupted run doesn't leave a partial file behind.
+  auto tmpPath = path + ".tmp";
+  ArrowWriter writer(tmpPath);
+  auto arrowSchema = toArrowSchema(schema.type);
+  GLUTEN_THROW_NOT_OK(writer.initWriter(*arrowSchema));
+  auto* pool = defaultLeafVeloxMemoryPool().get();
+  std::mt19937_64 gen(0);
+  for (int32_t offset = 0; offset < FLAGS_rows; offset += FLAGS_batch_rows) {
+    auto rows = std::min(FLAGS_batch_rows, FLAGS_rows - offset);
+    std::vector<velox::VectorPtr> children;
+    for (int32_t i = 0; i < schema.type->size(); ++i) {
+      children.push_back(makeColumn(schema.type->childAt(i), i, rows, gen, pool));
+    }
+    VeloxColumnarBatch batch(std::make_shared<velox::RowVector>(pool, schema.type, nullptr, rows, std::move(children)));
+    auto cSchema = batch.exportArrowSchema();
+    auto cArray = batch.exportArrowArray();
+    GLUTEN_ASSIGN_OR_THROW(auto recordBatch, arrow::ImportRecordBatch(cArray.get(), cSchema.get()));
+    GLUTEN_THROW_NOT_OK(writer.writeInBatches(recordBatch));
+  }
+  GLUTEN_THROW_NOT_OK(writer.closeWriter());
+  std::filesystem::rename(tmpPath, path);
+}
+
+// The batches of the schema's data file, one per row group, read once.
+const std::vector<std::shared_ptr<ColumnarBatch>>& inputBatches(const SyntheticSchema& schema) {
+  static std::unordered_map<std::string, std::vector<std::shared_ptr<ColumnarBatch>>> cache;
+  auto& batches = cache[schema.name];
+  if (!batches.empty()) {
+    return batches;
+  }
+  GLUTEN_ASSIGN_OR_THROW(auto file, arrow::io::ReadableFile::Open(dataFile(schema)));
+  parquet::ArrowReaderProperties properties;
+  properties.set_batch_size(FLAGS_batch_rows);
+  std::unique_ptr<parquet::arrow::FileReader> parquetReader;
+  GLUTEN_THROW_NOT_OK(parquet::arrow::FileReader::Make(
+      arrow::default_memory_pool(), parquet::ParquetFileReader::Open(file), properties, &parquetReader));
+  std::shared_ptr<arrow::RecordBatchReader> recordBatchReader;
+  std::vector<int32_t> rowGroups(parquetReader->num_row_groups());
+  std::iota(rowGroups.begin(), rowGroups.end(), 0);
+  GLUTEN_THROW_NOT_OK(parquetReader->GetRecordBatchReader(rowGroups, &recordBatchReader));
+  while (true) {
+    GLUTEN_ASSIGN_OR_THROW(auto recordBatch, recordBatchReader->Next());
+    if (recordBatch == nullptr) {
+      break;
+    }
+    GLUTEN_ASSIGN_OR_THROW(auto batch, recordBatch2VeloxColumnarBatch(*recordBatch));
+    batches.push_back(std::move(batch));
+  }
+  return batches;
+}
+
+struct RowBatch {
+  int64_t numRows;
+  std::vector<int64_t> lengths;
+  std::vector<uint8_t> data;
+};
+
+// The input batches as unsafe rows, converted once.
+const std::vector<RowBatch>& inputRows(const SyntheticSchema& schema) {
+  static std::unordered_map<std::string, std::vector<RowBatch>> cache;
+  auto& rowBatches = cache[schema.name];
+  if (!rowBatches.empty()) {
+    return rowBatches;
+  }
+  VeloxColumnarToRowConverter converter(defaultLeafVeloxMemoryPool());
+  for (const auto& batch : inputBatches(schema)) {
+    converter.convert(batch);
+    const auto& lengths = converter.getLengths();
+    auto numBytes = converter.getOffsets().back() + lengths.back();
+    rowBatches.push_back(
+        {batch->numRows(),
+         std::vector<int64_t>(lengths.begin(), lengths.end()),
+         std::vector<uint8_t>(converter.getBufferAddress(), converter.getBufferAddress() + numBytes)});
+  }
+  return rowBatches;
+}
+
+void setCounters(benchmark::State& state, int64_t numRows, int64_t numBytes) {
+  state.counters["rows_per_second"] = benchmark::Counter(numRows, benchmark::Counter::kIsRate);
+  state.counters["bytes_per_row"] = benchmark::Counter(static_cast<double>(numBytes) / std::max<int64_t>(numRows, 1));
+}
+
+void columnarToRow(benchmark::State& state, const SyntheticSchema& schema) {
+  const auto& batches = inputBatches(schema);
+  VeloxColumnarToRowConverter converter(defaultLeafVeloxMemoryPool());
+  int64_t numRows = 0;
+  int64_t numBytes = 0;
+  for (auto _ : state) {
+    for (const auto& batch : batches) {
+      converter.convert(batch);
+      numRows += batch->numRows();
+      numBytes += converter.getOffsets().back() + converter.getLengths().back();
+    }
+  }
+  setCounters(state, numRows, numBytes);
+}
+
+void rowToColumnar(benchmark::State& state, const SyntheticSchema& schema) {
+  const auto& rowBatches = inputRows(schema);
+  int64_t numRows = 0;
+  int64_t numBytes = 0;
+  for (auto _ : state) {
+    ArrowSchema cSchema;
+    toArrowSchema(schema.type, &cSchema);
+    VeloxRowToColumnarConverter converter(&cSchema, defaultLeafVeloxMemoryPool());
+    for (const auto& rows : rowBatches) {
+      auto batch = converter.convert(
+          rows.numRows, const_cast<int64_t*>(rows.lengths.data()), const_cast<uint8_t*>(rows.data.data()));
+      benchmark::DoNotOptimize(batch);
+      numRows += rows.numRows;
+      numBytes += rows.data.size();
+    }
+  }
+  setCounters(state, numRows, numBytes);
+}
+
+std::shared_ptr<VeloxShuffleWriter> writeShuffle(const SyntheticSchema& schema) {
+  auto options = ShuffleWriterOptions::defaults();
+  options.partitioning_name = "rr";
+  // Partitions are buffered until stop(), as the ClickHouse splitter is configured.
+  options.prefer_evict = false;
+  options.compression_type = arrow::Compression::LZ4_FRAME;
+  std::shared_ptr<VeloxShuffleWriter> shuffleWriter;
+  GLUTEN_ASSIGN_OR_THROW(
+      shuffleWriter,
+      VeloxShuffleWriter::create(FLAGS_partitions, std::make_shared<LocalPartitionWriterCreator>(false), options));
+  for (const auto& batch : inputBatches(schema)) {
+    GLUTEN_THROW_NOT_OK(shuffleWriter->split(batch));
+  }
+  GLUTEN_THROW_NOT_OK(shuffleWriter->stop());
+  return shuffleWriter;
+}
+
+int64_t numInputRows(const SyntheticSchema& schema) {
+  int64_t numRows = 0;
+  for (const auto& batch : inputBatches(schema)) {
+    numRows += batch->numRows();
+  }
+  return numRows;
+}
+
+void shuffleWrite(benchmark::State& state, const SyntheticSchema& schema) {
+  auto fs = std::make_shared<arrow::fs::LocalFileSystem>();
+  int64_t numRows = 0;
+  int64_t numBytes = 0;
+  for (auto _ : state) {
+    auto shuffleWriter = writeShuffle(schema);
+    numRows += numInputRows(schema);
+    numBytes += shuffleWriter->totalBytesWritten();
+    state.PauseTiming();
+    GLUTEN_THROW_NOT_OK(fs->DeleteFile(shuffleWriter->dataFile()));
+    state.ResumeTiming();
+  }
+  setCounters(state, numRows, numBytes);
+}
+
+// Reads every partition of a shuffle written once, as a reduce task fetches it.
+void shuffleRead(benchmark::State& state, const SyntheticSchema& schema) {
+  auto shuffleWriter = writeShuffle(schema);
+  auto arrowSchema = toArrowSchema(schema.type);
+  auto readerOptions = ReaderOptions::defaults();
+  readerOptions.compression_type = arrow::Compression::LZ4_FRAME;
+  int64_t numRows = 0;
+  int64_t numBytes = 0;
+  for (auto _ : state) {
+    GLUTEN_ASSIGN_OR_THROW(auto file, arrow::io::ReadableFile::Open(shuffleWriter->dataFile()));
+    int64_t offset = 0;
+    for (auto length : shuffleWriter->partitionLengths()) {
+      if (length == 0) {
+        continue;
+      }
+      GLUTEN_ASSIGN_OR_THROW(auto in, arrow::io::RandomAccessFile::GetStream(file, offset, length));
+      offset += length;
+      VeloxShuffleReader reader(in, arrowSchema, readerOptions, defaultArrowMemoryPool(), defaultLeafVeloxMemoryPool());
+      while (true) {
+        GLUTEN_ASSIGN_OR_THROW(auto batch, reader.next());
+        if (batch == nullptr) {
+          break;
+        }
+        numRows += batch->numRows();
+      }
+    }
+    GLUTEN_THROW_NOT_OK(file->Close());
+    numBytes += shuffleWriter->totalBytesWritten();
+  }
+  setCounters(state, numRows, numBytes);
+  auto fs = std::make_shared<arrow::fs::LocalFileSystem>();
+  GLUTEN_THROW_NOT_OK(fs->DeleteFile(shuffleWriter->dataFile()));
+}
+
+void registerConverterBenchmarks() {
+  using Benchmark = void (*)(benchmark::State&, const SyntheticSchema&);
+  const std::vector<std::pair<std::string, Benchmark>> benchmarks = {
+      {"columnar_to_row", columnarToRow},
+      {"row_to_columnar", rowToColumnar},
+      {"shuffle_write", shuffleWrite},
+      {"shuffle_read", shuffleRead}};
+  for (const auto& schema : syntheticSchemas()) {
+    generateDataFile(schema);
+    for (const auto& [name, fn] : benchmarks) {
+      auto bm = benchmark::RegisterBenchmark((schema.name + "/" + name).c_str(), fn, schema)
+                    ->MeasureProcessCPUTime()
+                    ->UseRealTime()
+                    ->Unit(benchmark::kMillisecond);
+      if (FLAGS_iterations > 0) {
+        bm->Iterations(FLAGS_iterations);
+      }
+    }
+  }
+}
+
+} // namespace
+
+} // namespace gluten
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  initVeloxBackend();
+  gluten::registerConverterBenchmarks();
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
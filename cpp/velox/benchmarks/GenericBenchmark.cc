@@ -124,8 +124,13 @@ auto BM_Generic = [](::benchmark::State& state,
   auto startTime = std::chrono::steady_clock::now();
   int64_t collectBatchTime = 0;
   WriterMetrics writerMetrics{};
+  // Shared by the threads of the run.
+  static IterationLatencies latencies;
+  latencies.start(state);
 
   for (auto _ : state) {
+    auto iterationStart = std::chrono::steady_clock::now();
+    BenchmarkTaskContext taskContext;
     auto backend = gluten::createBackend();
     std::vector<std::shared_ptr<gluten::ResultIterator>> inputIters;
     std::vector<BatchIterator*> inputItersRaw;
@@ -196,9 +201,15 @@ auto BM_Generic = [](::benchmark::State& state,
     auto* rawIter = static_cast<gluten::WholeStageResultIterator*>(resultIter->getInputIter());
     const auto& task = rawIter->task_;
     const auto& planNode = rawIter->veloxPlan_;
-    auto statsStr = facebook::velox::exec::printPlanWithStats(*planNode, task->taskStats(), true);
-    std::cout << statsStr << std::endl;
+    if (!FLAGS_scaling) {
+      auto statsStr = facebook::velox::exec::printPlanWithStats(*planNode, task->taskStats(), true);
+      std::cout << statsStr << std::endl;
+    }
+    latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - iterationStart)
+                         .count());
   }
+  latencies.report(state);
 
   auto endTime = std::chrono::steady_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
@@ -335,14 +346,7 @@ int main(int argc, char** argv) {
     auto* bm = ::benchmark::RegisterBenchmark(NAME, BM_Generic, substraitJsonFile, inputFiles, conf, FUNC) \
                    ->MeasureProcessCPUTime()                                                               \
                    ->UseRealTime();                                                                        \
-    if (FLAGS_threads > 0) {                                                                               \
-      bm->Threads(FLAGS_threads);                                                                          \
-    } else {                                                                                               \
-      bm->ThreadRange(1, std::thread::hardware_concurrency());                                             \
-    }                                                                                                      \
-    if (FLAGS_iterations > 0) {                                                                            \
-      bm->Iterations(FLAGS_iterations);                                                                    \
-    }                                                                                                      \
+    setBenchmarkThreads(bm);                                                                               \
   } while (0)
 
 #if 0
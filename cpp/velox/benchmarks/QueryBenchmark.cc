@@ -17,11 +17,13 @@
 
 #include <benchmark/benchmark.h>
 #include <compute/VeloxBackend.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
 
 #include "BenchmarkUtils.h"
 #include "compute/VeloxPlanConverter.h"
 #include "utils/ArrowTypeUtils.h"
-#include "utils/TaskContext.h"
 
 using namespace facebook;
 using namespace gluten;
@@ -85,7 +87,12 @@ auto BM = [](::benchmark::State& state,
     }
   }
 
+  static IterationLatencies latencies;
+  latencies.start(state);
+
   for (auto _ : state) {
+    auto iterationStart = std::chrono::steady_clock::now();
+    BenchmarkTaskContext taskContext;
     state.PauseTiming();
     auto backend = std::dynamic_pointer_cast<gluten::VeloxBackend>(gluten::createBackend());
     state.ResumeTiming();
@@ -101,28 +108,34 @@ auto BM = [](::benchmark::State& state,
         state.SkipWithError(maybeBatch.status().message().c_str());
         return;
       }
-      std::cout << maybeBatch.ValueOrDie()->ToString() << std::endl;
+      if (!FLAGS_scaling) {
+        std::cout << maybeBatch.ValueOrDie()->ToString() << std::endl;
+      }
     }
+    latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - iterationStart)
+                         .count());
   }
+  latencies.report(state);
 };
 
+#define QUERY_BENCHMARK(...) \
+  setBenchmarkThreads(::benchmark::RegisterBenchmark(__VA_ARGS__)->MeasureProcessCPUTime()->UseRealTime())
+
 #define orc_reader_decimal 1
 
 int main(int argc, char** argv) {
-  initVeloxBackend();
-  gluten::createTaskContextStorage("test");
   ::benchmark::Initialize(&argc, argv);
-  // Threads cannot work well, use ThreadRange instead.
-  // The multi-thread performance is not correct.
-  // BENCHMARK(BM)->ThreadRange(36, 36);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  initVeloxBackend();
 
 #if 0
   const auto& lineitemParquetPath = getFilePath("bm_lineitem/parquet/");
   if (argc < 2) {
-    ::benchmark::RegisterBenchmark(
+    QUERY_BENCHMARK(
         "select", BM, std::vector<std::string>{lineitemParquetPath}, "select.json", "parquet");
   } else {
-    ::benchmark::RegisterBenchmark(
+    QUERY_BENCHMARK(
         "select", BM, std::vector<std::string>{std::string(argv[1]) + "/"}, "select.json", "parquet");
   }
 #else
@@ -130,24 +143,23 @@ int main(int argc, char** argv) {
   if (argc < 2) {
     auto lineitemOrcPath = getFilePath("bm_lineitem/orc/");
 #if orc_reader_decimal == 0
-    ::benchmark::RegisterBenchmark("select", BM, std::vector<std::string>{lineitemOrcPath}, "select.json", "orc");
+    QUERY_BENCHMARK("select", BM, std::vector<std::string>{lineitemOrcPath}, "select.json", "orc");
 #else
     auto fileName1 = lineitemOrcPath + "short_decimal_nonull.orc";
-    ::benchmark::RegisterBenchmark(
+    QUERY_BENCHMARK(
         "select", BM, std::vector<std::string>{fileName1}, "select_short_decimal.json", "orc");
     auto fileName2 = lineitemOrcPath + "long_decimal_nonull.orc";
-    ::benchmark::RegisterBenchmark(
+    QUERY_BENCHMARK(
         "select", BM, std::vector<std::string>{fileName2}, "select_long_decimal.json", "orc");
 #endif
   } else {
-    ::benchmark::RegisterBenchmark(
+    QUERY_BENCHMARK(
         "select", BM, std::vector<std::string>{std::string(argv[1]) + "/"}, "select.json", "orc");
   }
 #endif
 
   ::benchmark::RunSpecifiedBenchmarks();
   ::benchmark::Shutdown();
-  gluten::deleteTaskContextStorage();
 
   return 0;
 }
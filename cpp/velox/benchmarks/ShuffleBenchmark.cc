@@ -0,0 +1,280 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// End to end shuffle benchmark: splits generated batches with VeloxShuffleWriter, spilling under a memory limit,
+// then reads every partition back through VeloxShuffleReader. Runs over partition counts, spill modes, codecs and
+// column mixes. Use --benchmark_out=<file> --benchmark_out_format=json to keep the results for regression tracking.
+
+#include <arrow/filesystem/localfs.h>
+#include <arrow/io/file.h>
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <random>
+#include <sstream>
+
+#include "benchmarks/BenchmarkUtils.h"
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryPool.h"
+#include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/VeloxShuffleReader.h"
+#include "shuffle/VeloxShuffleWriter.h"
+#include "utils/ArrowTypeUtils.h"
+#include "utils/VeloxArrowUtils.h"
+#include "utils/macros.h"
+
+using namespace facebook;
+
+DEFINE_string(partition_counts, "10,200,2000,10000", "Comma separated shuffle partition counts");
+DEFINE_int32(batch_rows, 4096, "Rows of each input batch");
+DEFINE_int32(num_batches, 256, "Input batches split by each iteration");
+DEFINE_int64(memory_limit, 256 << 20, "Memory available to the shuffle writer, forces spills if exceeded");
+
+namespace gluten {
+
+namespace {
+
+enum class ColumnMix { kFixedWidth, kString, kMixed };
+
+struct ShuffleCodec {
+  std::string name;
+  arrow::Compression::type type;
+  CodecBackend backend;
+};
+
+std::vector<ShuffleCodec> shuffleCodecs() {
+  std::vector<ShuffleCodec> codecs = {
+      {"lz4", arrow::Compression::LZ4_FRAME, CodecBackend::NONE},
+      {"zstd", arrow::Compression::ZSTD, CodecBackend::NONE},
+  };
+#ifdef GLUTEN_ENABLE_QAT
+  codecs.push_back({"qat_gzip", arrow::Compression::GZIP, CodecBackend::QAT});
+  codecs.push_back({"qat_zstd", arrow::Compression::ZSTD, CodecBackend::QAT});
+#endif
+#ifdef GLUTEN_ENABLE_IAA
+  codecs.push_back({"iaa_gzip", arrow::Compression::GZIP, CodecBackend::IAA});
+#endif
+  return codecs;
+}
+
+std::string columnMixName(ColumnMix mix) {
+  switch (mix) {
+    case ColumnMix::kFixedWidth:
+      return "fixed_width";
+    case ColumnMix::kString:
+      return "string";
+    default:
+      return "mixed";
+  }
+}
+
+template <typename T, typename F>
+velox::VectorPtr makeFlatVector(velox::TypePtr type, int32_t size, velox::memory::MemoryPool* pool, F&& valueAt) {
+  auto vector = velox::BaseVector::create<velox::FlatVector<T>>(type, size, pool);
+  for (int32_t row = 0; row < size; ++row) {
+    if (row % 17 == 0) {
+      vector->setNull(row, true);
+    } else {
+      vector->set(row, valueAt(row));
+    }
+  }
+  return vector;
+}
+
+// Batches of the column mix, the same for every iteration and configuration.
+const std::vector<velox::RowVectorPtr>& inputBatches(ColumnMix mix) {
+  static std::unordered_map<int32_t, std::vector<velox::RowVectorPtr>> cache;
+  auto& batches = cache[static_cast<int32_t>(mix)];
+  if (!batches.empty()) {
+    return batches;
+  }
+  auto* pool = defaultLeafVeloxMemoryPool().get();
+  std::mt19937_64 gen(0);
+  std::vector<std::string> words;
+  for (int32_t i = 0; i < 1000; ++i) {
+    words.push_back("shuffle_benchmark_value_" + std::to_string(gen() % 100000));
+  }
+  for (int32_t i = 0; i < FLAGS_num_batches; ++i) {
+    std::vector<std::string> names;
+    std::vector<velox::VectorPtr> children;
+    auto addColumn = [&](velox::VectorPtr child) {
+      names.push_back("c" + std::to_string(children.size()));
+      children.push_back(std::move(child));
+    };
+    auto rows = FLAGS_batch_rows;
+    if (mix != ColumnMix::kString) {
+      addColumn(makeFlatVector<int64_t>(velox::BIGINT(), rows, pool, [&](auto) { return gen(); }));
+      addColumn(makeFlatVector<int32_t>(velox::INTEGER(), rows, pool, [&](auto) { return gen() % 1000; }));
+      addColumn(makeFlatVector<double>(velox::DOUBLE(), rows, pool, [&](auto) { return gen() / 1e9; }));
+      addColumn(makeFlatVector<bool>(velox::BOOLEAN(), rows, pool, [&](auto) { return gen() % 2 == 0; }));
+    }
+    if (mix != ColumnMix::kFixedWidth) {
+      for (int32_t j = 0; j < 2; ++j) {
+        addColumn(makeFlatVector<velox::StringView>(
+            velox::VARCHAR(), rows, pool, [&](auto) { return velox::StringView(words[gen() % words.size()]); }));
+      }
+    }
+    std::vector<velox::TypePtr> types;
+    for (auto& child : children) {
+      types.push_back(child->type());
+    }
+    batches.push_back(std::make_shared<velox::RowVector>(
+        pool, velox::ROW(std::move(names), std::move(types)), nullptr, rows, std::move(children)));
+  }
+  return batches;
+}
+
+int64_t peakRssBytes() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss * 1024L;
+}
+
+void shuffleBenchmark(
+    benchmark::State& state,
+    int32_t numPartitions,
+    bool preferEvict,
+    ShuffleCodec codec,
+    ColumnMix mix) {
+  const auto& batches = inputBatches(mix);
+  auto arrowSchema = toArrowSchema(batches[0]->type());
+
+  int64_t numRows = 0;
+  int64_t rowsRead = 0;
+  int64_t bytesWritten = 0;
+  int64_t bytesEvicted = 0;
+  int64_t peakPoolBytes = 0;
+  int64_t writeTime = 0;
+  int64_t readTime = 0;
+  int64_t decompressTime = 0;
+  for (auto _ : state) {
+    auto pool = std::make_shared<MyMemoryPool>(FLAGS_memory_limit);
+    auto options = ShuffleWriterOptions::defaults();
+    options.partitioning_name = "rr";
+    options.prefer_evict = preferEvict;
+    options.compression_type = codec.type;
+    options.codec_backend = codec.backend;
+    options.memory_pool = pool;
+    auto partitionWriterCreator = std::make_shared<LocalPartitionWriterCreator>(preferEvict);
+
+    std::shared_ptr<VeloxShuffleWriter> shuffleWriter;
+    TIME_NANO_START(writeTime);
+    GLUTEN_ASSIGN_OR_THROW(
+        shuffleWriter, VeloxShuffleWriter::create(numPartitions, std::move(partitionWriterCreator), options));
+    for (auto& batch : batches) {
+      GLUTEN_THROW_NOT_OK(shuffleWriter->split(std::make_shared<VeloxColumnarBatch>(batch)));
+      numRows += batch->size();
+    }
+    GLUTEN_THROW_NOT_OK(shuffleWriter->stop());
+    TIME_NANO_END(writeTime);
+    bytesWritten += shuffleWriter->totalBytesWritten();
+    bytesEvicted += shuffleWriter->totalBytesEvicted();
+    peakPoolBytes = std::max(peakPoolBytes, pool->max_memory());
+
+    // Each partition is a separate stream, as a reduce task fetches it.
+    TIME_NANO_START(readTime);
+    GLUTEN_ASSIGN_OR_THROW(auto file, arrow::io::ReadableFile::Open(shuffleWriter->dataFile()));
+    auto readerOptions = ReaderOptions::defaults();
+    readerOptions.compression_type = codec.type;
+    readerOptions.codec_backend = codec.backend;
+    int64_t offset = 0;
+    for (auto length : shuffleWriter->partitionLengths()) {
+      if (length == 0) {
+        continue;
+      }
+      GLUTEN_ASSIGN_OR_THROW(auto in, arrow::io::RandomAccessFile::GetStream(file, offset, length));
+      offset += length;
+      VeloxShuffleReader reader(in, arrowSchema, readerOptions, defaultArrowMemoryPool(), defaultLeafVeloxMemoryPool());
+      while (true) {
+        GLUTEN_ASSIGN_OR_THROW(auto batch, reader.next());
+        if (batch == nullptr) {
+          break;
+        }
+        rowsRead += batch->numRows();
+      }
+      decompressTime += reader.getDecompressTime();
+    }
+    GLUTEN_THROW_NOT_OK(file->Close());
+    TIME_NANO_END(readTime);
+
+    auto fs = std::make_shared<arrow::fs::LocalFileSystem>();
+    GLUTEN_THROW_NOT_OK(fs->DeleteFile(shuffleWriter->dataFile()));
+  }
+  GLUTEN_CHECK(rowsRead == numRows, "Shuffle read back " + std::to_string(rowsRead) + " of " + std::to_string(numRows));
+
+  state.counters["rows_per_second"] = benchmark::Counter(numRows, benchmark::Counter::kIsRate);
+  state.counters["bytes_per_row"] = benchmark::Counter(static_cast<double>(bytesWritten) / numRows);
+  state.counters["spill_amplification"] =
+      benchmark::Counter(static_cast<double>(bytesEvicted + bytesWritten) / std::max<int64_t>(bytesWritten, 1));
+  state.counters["write_time"] =
+      benchmark::Counter(writeTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
+  state.counters["read_time"] =
+      benchmark::Counter(readTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
+  state.counters["decompress_time"] =
+      benchmark::Counter(decompressTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
+  state.counters["peak_pool_bytes"] =
+      benchmark::Counter(peakPoolBytes, benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+  // Of the process so far, run one configuration per process with --benchmark_filter to compare it.
+  state.counters["peak_rss"] =
+      benchmark::Counter(peakRssBytes(), benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+}
+
+std::vector<int32_t> parsePartitionCounts(const std::string& counts) {
+  std::vector<int32_t> result;
+  std::stringstream stream(counts);
+  std::string count;
+  while (std::getline(stream, count, ',')) {
+    result.push_back(std::stoi(count));
+  }
+  return result;
+}
+
+void registerShuffleBenchmarks() {
+  for (auto mix : {ColumnMix::kFixedWidth, ColumnMix::kString, ColumnMix::kMixed}) {
+    for (auto& codec : shuffleCodecs()) {
+      for (auto preferEvict : {true, false}) {
+        for (auto numPartitions : parsePartitionCounts(FLAGS_partition_counts)) {
+          auto name = "Shuffle/" + columnMixName(mix) + "/" + codec.name + "/" +
+              (preferEvict ? "prefer_evict" : "prefer_cache") + "/" + std::to_string(numPartitions);
+          auto bm = benchmark::RegisterBenchmark(name.c_str(), shuffleBenchmark, numPartitions, preferEvict, codec, mix)
+                        ->MeasureProcessCPUTime()
+                        ->UseRealTime()
+                        ->Unit(benchmark::kMillisecond);
+          if (FLAGS_iterations > 0) {
+            bm->Iterations(FLAGS_iterations);
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+} // namespace gluten
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  initVeloxBackend();
+  gluten::registerShuffleBenchmarks();
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
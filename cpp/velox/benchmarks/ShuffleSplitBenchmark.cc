@@ -27,10 +27,12 @@
 #include <sched.h>
 
 #include <chrono>
+#include <random>
 
 #include "benchmarks/BenchmarkUtils.h"
 #include "memory/ColumnarBatch.h"
 #include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/ShuffleSplitKernels.h"
 #include "shuffle/VeloxShuffleWriter.h"
 #include "utils/TestUtils.h"
 #include "utils/VeloxArrowUtils.h"
@@ -350,6 +352,53 @@ class BenchmarkShuffleSplitIterateScanBenchmark : public BenchmarkShuffleSplit {
   }
 };
 
+// Gathers kSplitKernelRows random rows of one fixed width type with a single kernel, the same access pattern as
+// splitting one partition of a batch. byteWidth 0 benchmarks the packed boolean kernel.
+const uint32_t kSplitKernelRows = 4096;
+
+void splitKernelBenchmark(benchmark::State& state, SplitKernelIsa isa, uint32_t byteWidth) {
+  auto srcWidth = std::max(byteWidth, 1u);
+  std::vector<uint8_t> src(kSplitBufferSize * 8 * srcWidth);
+  std::vector<uint32_t> rowIds(kSplitKernelRows);
+  std::vector<uint8_t> dst(kSplitKernelRows * srcWidth);
+  std::mt19937 gen(0);
+  auto numSrcRows = byteWidth == 0 ? src.size() * 8 : src.size() / byteWidth;
+  std::uniform_int_distribution<uint32_t> dist(0, numSrcRows - 1);
+  for (auto& b : src) {
+    b = gen();
+  }
+  for (auto& rowId : rowIds) {
+    rowId = dist(gen);
+  }
+
+  for (auto _ : state) {
+    if (byteWidth == 0) {
+      gatherBits(isa, src.data(), rowIds.data(), kSplitKernelRows / 8, dst.data());
+    } else {
+      gatherFixedWidth(isa, byteWidth, src.data(), rowIds.data(), kSplitKernelRows, dst.data());
+    }
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  // Count the bytes written, so the reported rate is the split output bandwidth.
+  auto bytesPerIteration = byteWidth == 0 ? kSplitKernelRows / 8 : kSplitKernelRows * byteWidth;
+  state.SetBytesProcessed(state.iterations() * bytesPerIteration);
+}
+
+void registerSplitKernelBenchmarks() {
+  auto maxIsa = detectSplitKernelIsa();
+  for (auto isa : {SplitKernelIsa::kScalar, SplitKernelIsa::kAvx2, SplitKernelIsa::kAvx512}) {
+    if (isa > maxIsa) {
+      break;
+    }
+    for (uint32_t byteWidth : {0, 1, 2, 4, 8, 16}) {
+      auto name = std::string("ShuffleSplitKernel/") + splitKernelIsaName(isa) + "/" +
+          (byteWidth == 0 ? "bool" : std::to_string(byteWidth * 8) + "bit");
+      benchmark::RegisterBenchmark(name.c_str(), splitKernelBenchmark, isa, byteWidth);
+    }
+  }
+}
+
 } // namespace gluten
 
 int main(int argc, char** argv) {
@@ -364,6 +413,8 @@ int main(int argc, char** argv) {
     FLAGS_partitions = std::thread::hardware_concurrency();
   }
 
+  gluten::registerSplitKernelBenchmarks();
+
   gluten::BenchmarkShuffleSplitIterateScanBenchmark iterateScanBenchmark(FLAGS_file);
 
   auto bm = benchmark::RegisterBenchmark("BenchmarkShuffleSplit::IterateScan", iterateScanBenchmark)
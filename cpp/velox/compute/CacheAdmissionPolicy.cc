@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CacheAdmissionPolicy.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+const uint64_t kSeeds[] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL, 0xd6e8feb86659fd93ULL};
+} // namespace
+
+CacheAdmissionPolicy::Mode CacheAdmissionPolicy::parseMode(const std::string& mode) {
+  if (mode == "all") {
+    return Mode::kAll;
+  }
+  if (mode == "frequency") {
+    return Mode::kFrequency;
+  }
+  if (mode == "none") {
+    return Mode::kNone;
+  }
+  throw GlutenException("Unknown cache admission mode: " + mode);
+}
+
+CacheAdmissionPolicy* CacheAdmissionPolicy::instance() {
+  static CacheAdmissionPolicy policy;
+  return &policy;
+}
+
+void CacheAdmissionPolicy::configure(int32_t minFrequency, int32_t sketchWidth) {
+  std::lock_guard<std::mutex> l(mutex_);
+  minFrequency_ = std::clamp<int32_t>(minFrequency, 1, kMaxCount);
+  width_ = 1;
+  while (width_ < static_cast<size_t>(std::max(sketchWidth, 1))) {
+    width_ <<= 1;
+  }
+  counters_.assign(width_ * kDepth, 0);
+  accesses_ = 0;
+  resetAccesses_ = std::max<int64_t>(width_ / 2, 1);
+}
+
+size_t CacheAdmissionPolicy::index(uint64_t hash, int32_t row) const {
+  uint64_t h = (hash ^ kSeeds[row]) * kSeeds[(row + 1) % kDepth];
+  return row * width_ + ((h ^ (h >> 32)) & (width_ - 1));
+}
+
+int32_t CacheAdmissionPolicy::frequencyLocked(uint64_t hash) const {
+  if (width_ == 0) {
+    return 0;
+  }
+  uint8_t count = kMaxCount;
+  for (int32_t row = 0; row < kDepth; ++row) {
+    count = std::min(count, counters_[index(hash, row)]);
+  }
+  return count;
+}
+
+void CacheAdmissionPolicy::incrementLocked(uint64_t hash) {
+  if (width_ == 0) {
+    return;
+  }
+  // Conservative update, only the minimal counters grow.
+  auto count = frequencyLocked(hash);
+  if (count == kMaxCount) {
+    return;
+  }
+  for (int32_t row = 0; row < kDepth; ++row) {
+    auto& counter = counters_[index(hash, row)];
+    if (counter == count) {
+      ++counter;
+    }
+  }
+  if (++accesses_ >= resetAccesses_) {
+    for (auto& counter : counters_) {
+      counter >>= 1;
+    }
+    accesses_ /= 2;
+  }
+}
+
+bool CacheAdmissionPolicy::admit(Mode mode, const std::vector<std::string>& paths, const std::vector<uint64_t>& lengths) {
+  if (mode == Mode::kNone) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  uint64_t bytes = 0;
+  uint64_t frequentBytes = 0;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto hash = std::hash<std::string>{}(paths[i]);
+    // The access being admitted counts.
+    incrementLocked(hash);
+    bytes += lengths[i];
+    if (frequencyLocked(hash) >= minFrequency_) {
+      frequentBytes += lengths[i];
+    }
+  }
+  return mode == Mode::kAll || width_ == 0 || frequentBytes * 2 >= bytes;
+}
+
+int32_t CacheAdmissionPolicy::frequency(const std::string& path) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return frequencyLocked(std::hash<std::string>{}(path));
+}
+
+} // namespace gluten
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gluten {
+
+/// Decides whether the scans of a task read through AsyncDataCache, so that the files scanned once, e.g. by a large
+/// ETL job, don't evict the working set of the files scanned repeatedly. AsyncDataCache admits whatever is read
+/// through it, so the admission is per task: the files read are counted in a TinyLFU like frequency sketch, and the
+/// task caches if most of the bytes of its splits are of files read at least minFrequency times recently.
+class CacheAdmissionPolicy {
+ public:
+  enum class Mode {
+    // Every task caches.
+    kAll,
+    // The tasks of frequently read files cache.
+    kFrequency,
+    // No task caches.
+    kNone
+  };
+
+  /// "all", "frequency" or "none".
+  static Mode parseMode(const std::string& mode);
+
+  static CacheAdmissionPolicy* instance();
+
+  /// Counters of the sketch per hash function, rounded up to a power of 2. The counts are halved every sketchWidth / 2
+  /// accesses to files, so that the old accesses fade out and few files read once collide into a frequent count.
+  void configure(int32_t minFrequency, int32_t sketchWidth);
+
+  /// Counts the accesses to the files of the splits of a task and returns whether it caches them.
+  bool admit(Mode mode, const std::vector<std::string>& paths, const std::vector<uint64_t>& lengths);
+
+  /// Estimated number of recent accesses to the file.
+  int32_t frequency(const std::string& path) const;
+
+ private:
+  static constexpr int32_t kDepth = 4;
+  // Counters saturate at, as 4 bits counters of TinyLFU do.
+  static constexpr uint8_t kMaxCount = 15;
+
+  size_t index(uint64_t hash, int32_t row) const;
+
+  int32_t frequencyLocked(uint64_t hash) const;
+
+  void incrementLocked(uint64_t hash);
+
+  mutable std::mutex mutex_;
+  int32_t minFrequency_ = 2;
+  size_t width_ = 0;
+  std::vector<uint8_t> counters_;
+  int64_t accesses_ = 0;
+  int64_t resetAccesses_ = 0;
+};
+
+} // namespace gluten
@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CachedFileTracker.h"
+
+#include <algorithm>
+
+namespace gluten {
+
+CachedFileTracker* CachedFileTracker::instance() {
+  static CachedFileTracker tracker;
+  return &tracker;
+}
+
+void CachedFileTracker::setCapacity(int32_t capacity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  capacity_ = std::max(capacity, 0);
+  while (lru_.size() > static_cast<size_t>(capacity_)) {
+    positions_.erase(lru_.back());
+    lru_.pop_back();
+    ++version_;
+  }
+}
+
+bool CachedFileTracker::enabled() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return capacity_ > 0;
+}
+
+void CachedFileTracker::record(const std::string& path) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (capacity_ == 0) {
+    return;
+  }
+  auto it = positions_.find(path);
+  if (it != positions_.end()) {
+    // Reordering doesn't change the set of files reported.
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  lru_.push_front(path);
+  positions_[path] = lru_.begin();
+  if (lru_.size() > static_cast<size_t>(capacity_)) {
+    positions_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  ++version_;
+}
+
+std::vector<std::string> CachedFileTracker::files() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return {lru_.begin(), lru_.end()};
+}
+
+int64_t CachedFileTracker::version() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return version_;
+}
+
+} // namespace gluten
@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+/// The files most recently read by the scans of the executor through AsyncDataCache. The cache holds its entries by
+/// file and offset but doesn't enumerate them, so the files are recorded as the splits are added and the least
+/// recently read ones are forgotten beyond the capacity, as the cache evicts the least recently used data. Reported
+/// to the driver, which prefers the executors that cached a file for its splits.
+class CachedFileTracker {
+ public:
+  static CachedFileTracker* instance();
+
+  /// Number of files tracked. 0 disables the tracking.
+  void setCapacity(int32_t capacity);
+
+  bool enabled() const;
+
+  void record(const std::string& path);
+
+  /// Most recently read first.
+  std::vector<std::string> files() const;
+
+  /// Changes whenever the files do, to skip the reports of unchanged files.
+  int64_t version() const;
+
+ private:
+  mutable std::mutex mutex_;
+  int32_t capacity_ = 0;
+  // Most recently read first.
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, std::list<std::string>::iterator> positions_;
+  int64_t version_ = 0;
+};
+
+} // namespace gluten
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IOScheduler.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace gluten {
+
+namespace {
+// Items whose mean run time is compared with the best mean seen.
+static constexpr int32_t kAdaptWindowItems = 32;
+static constexpr double kThrottleRatio = 2.0;
+static constexpr double kRecoverRatio = 1.25;
+// Lets the best mean drift up, so that a short fast period isn't the baseline forever.
+static constexpr double kBaselineDecay = 1.05;
+
+thread_local IOPriority tlsPriority = IOPriority::kPrefetch;
+// The task of the item running on an IO thread, 0 elsewhere.
+thread_local uint64_t tlsTask = 0;
+
+uint64_t currentTask() {
+  if (tlsTask != 0) {
+    return tlsTask;
+  }
+  return std::max<uint64_t>(1, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+}
+} // namespace
+
+ScopedIOPriority::ScopedIOPriority(IOPriority priority) : previous_(tlsPriority) {
+  tlsPriority = priority;
+}
+
+ScopedIOPriority::~ScopedIOPriority() {
+  tlsPriority = previous_;
+}
+
+IOScheduler::IOScheduler(folly::Executor* pool, IOSchedulerOptions options)
+    : pool_(pool),
+      options_(options),
+      maxInflightPerTask_(
+          options.maxInflightPerTask > 0 ? options.maxInflightPerTask : std::max(1, options.maxInflight / 2)),
+      limit_(std::max(1, options.maxInflight)) {}
+
+void IOScheduler::add(folly::Func func) {
+  addWithPriority(std::move(func), folly::Executor::MID_PRI);
+}
+
+void IOScheduler::addWithPriority(folly::Func func, int8_t priority) {
+  auto itemPriority = priority > folly::Executor::MID_PRI ? IOPriority::kDemand : tlsPriority;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto task = currentTask();
+    auto [it, inserted] = tasks_.try_emplace(task);
+    if (inserted) {
+      order_.push_back(task);
+    }
+    auto& items = itemPriority == IOPriority::kDemand ? it->second.demand : it->second.prefetch;
+    items.push_back({std::move(func), itemPriority});
+    ++numQueued_;
+  }
+  dispatch();
+}
+
+int32_t IOScheduler::inflightLimit() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return limit_;
+}
+
+int64_t IOScheduler::numQueued() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numQueued_;
+}
+
+bool IOScheduler::nextLocked(uint64_t& task, Item& item) {
+  if (inflight_ >= limit_ || numQueued_ == 0) {
+    return false;
+  }
+  // Demand work first, then prefetches within the per task limit, then any prefetch rather than idle threads.
+  for (auto pass = 0; pass < 3; ++pass) {
+    for (size_t i = 0; i < order_.size(); ++i) {
+      auto index = (nextTask_ + i) % order_.size();
+      auto& queue = tasks_[order_[index]];
+      auto& items = pass == 0 ? queue.demand : queue.prefetch;
+      if (items.empty() || (pass == 1 && queue.inflight >= maxInflightPerTask_)) {
+        continue;
+      }
+      task = order_[index];
+      item = std::move(items.front());
+      items.pop_front();
+      --numQueued_;
+      ++queue.inflight;
+      ++inflight_;
+      nextTask_ = index + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+void IOScheduler::dispatch() {
+  while (true) {
+    uint64_t task;
+    Item item;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!nextLocked(task, item)) {
+        return;
+      }
+    }
+    pool_->add([this, task, item = std::move(item)]() mutable { run(task, std::move(item)); });
+  }
+}
+
+void IOScheduler::run(uint64_t task, Item item) {
+  auto previousTask = tlsTask;
+  auto previousPriority = tlsPriority;
+  // Work added by the item belongs to its task, with its priority.
+  tlsTask = task;
+  tlsPriority = item.priority;
+  auto start = std::chrono::steady_clock::now();
+  try {
+    item.func();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "IO work failed: " << e.what();
+  }
+  item.func = nullptr;
+  auto runNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  tlsTask = previousTask;
+  tlsPriority = previousPriority;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --inflight_;
+    auto it = tasks_.find(task);
+    auto& queue = it->second;
+    if (--queue.inflight == 0 && queue.demand.empty() && queue.prefetch.empty()) {
+      tasks_.erase(it);
+      auto index = std::find(order_.begin(), order_.end(), task) - order_.begin();
+      order_.erase(order_.begin() + index);
+      if (static_cast<size_t>(index) < nextTask_) {
+        --nextTask_;
+      }
+    }
+    if (options_.adaptive) {
+      adaptLocked(runNanos);
+    }
+  }
+  dispatch();
+}
+
+void IOScheduler::adaptLocked(int64_t runNanos) {
+  windowNanos_ += runNanos;
+  if (++windowItems_ < kAdaptWindowItems) {
+    return;
+  }
+  auto mean = static_cast<double>(windowNanos_) / windowItems_;
+  windowNanos_ = 0;
+  windowItems_ = 0;
+  if (baselineNanos_ == 0 || mean < baselineNanos_) {
+    baselineNanos_ = mean;
+    return;
+  }
+  if (mean > kThrottleRatio * baselineNanos_) {
+    limit_ = std::max(1, limit_ * 3 / 4);
+  } else if (mean < kRecoverRatio * baselineNanos_ && limit_ < options_.maxInflight) {
+    ++limit_;
+  }
+  baselineNanos_ = std::min(mean, baselineNanos_ * kBaselineDecay);
+}
+
+} // namespace gluten
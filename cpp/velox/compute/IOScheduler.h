@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+enum class IOPriority {
+  // Work a task thread is about to block on.
+  kDemand,
+  // Work ahead of the reads of a task, split preloads and shuffle block prefetches.
+  kPrefetch
+};
+
+// Sets the priority of the work the current thread adds to an IOScheduler within its lifetime. Work added without one
+// is prefetch, unless added with a priority above folly::Executor::MID_PRI.
+class ScopedIOPriority {
+ public:
+  explicit ScopedIOPriority(IOPriority priority);
+
+  ~ScopedIOPriority();
+
+ private:
+  IOPriority previous_;
+};
+
+struct IOSchedulerOptions {
+  // Work items run on the pool at a time, the number of threads of the pool.
+  int32_t maxInflight = 1;
+  // Work items of one task run at a time while other tasks have work queued, 0 for half of maxInflight.
+  int32_t maxInflightPerTask = 0;
+  // Cut the items in flight while their run time grows beyond the best seen, e.g. on a saturated NIC or disk.
+  bool adaptive = false;
+};
+
+// Executor wide scheduler of the work the tasks hand to the IO executor. The work is queued per task and dispatched to
+// the pool round robin across the tasks, demand work first. A task has at most maxInflightPerTask items running while
+// other tasks wait, so that the preloads of one scan heavy task don't hold every thread. The task of the work is the
+// thread adding it: Spark task threads run their drivers, and work added from the pool belongs to the task of the item
+// adding it.
+class IOScheduler final : public folly::Executor {
+ public:
+  IOScheduler(folly::Executor* pool, IOSchedulerOptions options);
+
+  void add(folly::Func func) override;
+
+  void addWithPriority(folly::Func func, int8_t priority) override;
+
+  uint8_t getNumPriorities() const override {
+    return 2;
+  }
+
+  // Items allowed in flight, below maxInflight while throttled.
+  int32_t inflightLimit() const;
+
+  int64_t numQueued() const;
+
+ private:
+  struct Item {
+    folly::Func func;
+    IOPriority priority = IOPriority::kPrefetch;
+  };
+
+  struct TaskQueue {
+    std::deque<Item> demand;
+    std::deque<Item> prefetch;
+    int32_t inflight = 0;
+  };
+
+  // Pops the next item to run, false if none may run now. Called with mutex_ held.
+  bool nextLocked(uint64_t& task, Item& item);
+
+  void dispatch();
+
+  void run(uint64_t task, Item item);
+
+  void adaptLocked(int64_t runNanos);
+
+  folly::Executor* const pool_;
+  const IOSchedulerOptions options_;
+  const int32_t maxInflightPerTask_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, TaskQueue> tasks_;
+  // Tasks in the order they are served, rotated on each dispatch.
+  std::vector<uint64_t> order_;
+  size_t nextTask_ = 0;
+  int32_t inflight_ = 0;
+  int32_t limit_;
+  int64_t numQueued_ = 0;
+
+  // Run time of the items of the current window, and the best window mean seen.
+  int64_t windowNanos_ = 0;
+  int32_t windowItems_ = 0;
+  double baselineNanos_ = 0;
+};
+
+} // namespace gluten
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SplitPreloadController.h"
+
+#include <algorithm>
+
+namespace gluten {
+
+SplitPreloadController* SplitPreloadController::instance() {
+  static SplitPreloadController controller;
+  return &controller;
+}
+
+void SplitPreloadController::enable(
+    int32_t initialDepth,
+    int32_t minDepth,
+    int32_t maxDepth,
+    std::function<void(int32_t)> setDepth) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  minDepth_ = std::max(1, minDepth);
+  maxDepth_ = std::max(minDepth_, maxDepth);
+  depth_ = std::clamp(initialDepth, minDepth_, maxDepth_);
+  setDepth_ = std::move(setDepth);
+  windowIoWaitNanos_ = 0;
+  windowWallNanos_ = 0;
+  setDepth_(depth_);
+  enabled_ = true;
+}
+
+void SplitPreloadController::report(int64_t ioWaitNanos, int64_t wallNanos) {
+  if (!enabled() || wallNanos <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  windowIoWaitNanos_ += std::max<int64_t>(0, ioWaitNanos);
+  windowWallNanos_ += wallNanos;
+  if (windowWallNanos_ < kWindowNanos) {
+    return;
+  }
+  auto ratio = static_cast<double>(windowIoWaitNanos_) / static_cast<double>(windowWallNanos_);
+  windowIoWaitNanos_ = 0;
+  windowWallNanos_ = 0;
+  auto depth = depth_;
+  if (ratio > kRaiseIoWaitRatio) {
+    depth = std::min(maxDepth_, depth_ + 1);
+  } else if (ratio < kLowerIoWaitRatio) {
+    depth = std::max(minDepth_, depth_ - 1);
+  }
+  if (depth != depth_) {
+    depth_ = depth;
+    setDepth_(depth_);
+  }
+}
+
+int32_t SplitPreloadController::depth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return depth_;
+}
+
+} // namespace gluten
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace gluten {
+
+// Executor wide split preload depth of the table scans, adapted to the I/O wait reported by the scan nodes of the
+// tasks. The depth is raised while the scans spend a large part of their time waiting for I/O, which preloading more
+// splits can hide, and lowered while they don't, to save the memory of the preloaded splits.
+class SplitPreloadController {
+ public:
+  // The depth is adapted once the scans reported this much wall time since the previous adaptation.
+  static constexpr int64_t kWindowNanos = 1'000'000'000;
+  static constexpr double kRaiseIoWaitRatio = 0.2;
+  static constexpr double kLowerIoWaitRatio = 0.05;
+
+  static SplitPreloadController* instance();
+
+  // Starts adapting the depth within [minDepth, maxDepth] from initialDepth. setDepth is called on every change.
+  void enable(int32_t initialDepth, int32_t minDepth, int32_t maxDepth, std::function<void(int32_t)> setDepth);
+
+  bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // I/O wait and wall time of a scan node since its previous report.
+  void report(int64_t ioWaitNanos, int64_t wallNanos);
+
+  int32_t depth() const;
+
+ private:
+  std::atomic<bool> enabled_{false};
+
+  mutable std::mutex mutex_;
+  int32_t depth_ = 0;
+  int32_t minDepth_ = 0;
+  int32_t maxDepth_ = 0;
+  std::function<void(int32_t)> setDepth_;
+  int64_t windowIoWaitNanos_ = 0;
+  int64_t windowWallNanos_ = 0;
+};
+
+} // namespace gluten
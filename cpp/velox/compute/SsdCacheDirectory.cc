@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SsdCacheDirectory.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <folly/hash/Checksum.h>
+#include <glog/logging.h>
+
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+const std::string kManifestSuffix = "manifest";
+const std::string kLockSuffix = "lock";
+// The checkpoints of the shards and the logs of the evictions since.
+const std::string kCheckpointExtension = ".cpt";
+const std::string kEvictLogExtension = ".log";
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+uint32_t fileChecksum(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  return folly::crc32c(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+}
+} // namespace
+
+SsdCacheDirectory::SsdCacheDirectory(std::string path, int32_t numSlots) : path_(std::move(path)), numSlots_(numSlots) {}
+
+SsdCacheDirectory::~SsdCacheDirectory() {
+  if (lockFd_ >= 0) {
+    ::close(lockFd_);
+  }
+}
+
+std::string SsdCacheDirectory::open(const Layout& layout) {
+  GLUTEN_CHECK(lockFd_ < 0, "SsdCacheDirectory is already open");
+  layout_ = layout;
+  std::filesystem::create_directories(path_);
+  for (int32_t slot = 0; slot < numSlots_; ++slot) {
+    auto prefix = "cache." + std::to_string(slot) + ".";
+    int fd = ::open((path_ + "/" + prefix + kLockSuffix).c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      continue;
+    }
+    // Released when the executor exits whatever the way.
+    if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+      ::close(fd);
+      continue;
+    }
+    lockFd_ = fd;
+    prefix_ = prefix;
+    break;
+  }
+  GLUTEN_CHECK(lockFd_ >= 0, "All the " + std::to_string(numSlots_) + " ssd cache slots of " + path_ + " are taken");
+
+  if (!validate()) {
+    LOG(INFO) << "Discarding the ssd cache files " << path_ << "/" << prefix_ << "*";
+    removeFiles();
+  }
+  // The checkpoints change from now on, a crash leaves them to the validation of SsdCache.
+  writeManifest(false);
+  return path_ + "/" + prefix_;
+}
+
+void SsdCacheDirectory::close() {
+  if (lockFd_ >= 0) {
+    writeManifest(true);
+  }
+}
+
+uint64_t SsdCacheDirectory::fileBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(path_)) {
+    if (entry.path().filename().string().rfind(prefix_, 0) == 0 && entry.is_regular_file()) {
+      bytes += entry.file_size();
+    }
+  }
+  return bytes;
+}
+
+std::map<std::string, uint32_t> SsdCacheDirectory::checkpointChecksums() const {
+  std::map<std::string, uint32_t> checksums;
+  for (const auto& entry : std::filesystem::directory_iterator(path_)) {
+    auto name = entry.path().filename().string();
+    if (name.rfind(prefix_, 0) == 0 && (endsWith(name, kCheckpointExtension) || endsWith(name, kEvictLogExtension))) {
+      checksums[name] = fileChecksum(entry.path().string());
+    }
+  }
+  return checksums;
+}
+
+std::string SsdCacheDirectory::manifestPath() const {
+  return path_ + "/" + prefix_ + kManifestSuffix;
+}
+
+void SsdCacheDirectory::writeManifest(bool withChecksums) const {
+  // Replaced at once, a torn manifest would discard the files.
+  auto tmpPath = manifestPath() + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::trunc);
+    out << "maxBytes " << layout_.maxBytes << "\n";
+    out << "numShards " << layout_.numShards << "\n";
+    if (withChecksums) {
+      for (const auto& [name, checksum] : checkpointChecksums()) {
+        out << "checksum " << name << " " << checksum << "\n";
+      }
+    }
+  }
+  std::filesystem::rename(tmpPath, manifestPath());
+}
+
+bool SsdCacheDirectory::validate() const {
+  std::ifstream in(manifestPath());
+  if (!in) {
+    return false;
+  }
+  Layout layout{};
+  bool hasChecksums = false;
+  std::map<std::string, uint32_t> checksums;
+  std::string key;
+  while (in >> key) {
+    if (key == "maxBytes") {
+      in >> layout.maxBytes;
+    } else if (key == "numShards") {
+      in >> layout.numShards;
+    } else if (key == "checksum") {
+      std::string name;
+      uint32_t checksum;
+      in >> name >> checksum;
+      checksums[name] = checksum;
+      hasChecksums = true;
+    } else {
+      return false;
+    }
+  }
+  // SsdCache maps the entries to the shards and to the regions of the files by the layout.
+  if (layout.maxBytes != layout_.maxBytes || layout.numShards != layout_.numShards) {
+    return false;
+  }
+  return !hasChecksums || checksums == checkpointChecksums();
+}
+
+void SsdCacheDirectory::removeFiles() const {
+  auto lockName = prefix_ + kLockSuffix;
+  for (const auto& entry : std::filesystem::directory_iterator(path_)) {
+    auto name = entry.path().filename().string();
+    if (name.rfind(prefix_, 0) == 0 && name != lockName) {
+      std::filesystem::remove(entry.path());
+    }
+  }
+}
+
+} // namespace gluten
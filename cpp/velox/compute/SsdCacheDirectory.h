@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace gluten {
+
+/// Lays out the SsdCache files of the executor under the ssd cache path so that the next executors on the host reuse
+/// them and the checkpoints SsdCache reloads them from. An executor holds the lock of the first free slot of the
+/// path for its lifetime, a restarted one takes over the slot of a stopped one with its files. The manifest of a slot
+/// records the layout of its files and, on a clean shutdown, the checksums of their checkpoints, the files are
+/// discarded when it doesn't match.
+class SsdCacheDirectory {
+ public:
+  struct Layout {
+    uint64_t maxBytes;
+    int32_t numShards;
+  };
+
+  SsdCacheDirectory(std::string path, int32_t numSlots);
+
+  /// Releases the slot.
+  ~SsdCacheDirectory();
+
+  /// Locks a free slot and validates its files against the layout, removing them if they don't match. Returns the
+  /// prefix of the files of the slot, throws if all the slots are taken.
+  std::string open(const Layout& layout);
+
+  /// Records the checksums of the checkpoints, once SsdCache stopped writing them.
+  void close();
+
+  /// Bytes of the files of the slot.
+  uint64_t fileBytes() const;
+
+  /// Names of the checkpoints of the slot and their checksums.
+  std::map<std::string, uint32_t> checkpointChecksums() const;
+
+ private:
+  std::string manifestPath() const;
+
+  void writeManifest(bool withChecksums) const;
+
+  // Whether the files of the slot were written with the layout and their checkpoints are complete.
+  bool validate() const;
+
+  void removeFiles() const;
+
+  const std::string path_;
+  const int32_t numSlots_;
+  int lockFd_ = -1;
+  // "cache.<slot>.", SsdCache names its files "<prefix><shard>" and their checkpoints "<prefix><shard>.cpt".
+  std::string prefix_;
+  Layout layout_{};
+};
+
+} // namespace gluten
@@ -21,10 +21,16 @@
 #include "arrow/c/bridge.h"
 #include "compute/Backend.h"
 #include "compute/ResultIterator.h"
+#include "compute/VeloxFragmentResultCache.h"
+#include "compute/VeloxInitializer.h"
+#include "compute/VeloxPlanCache.h"
 #include "compute/VeloxPlanConverter.h"
 #include "config/GlutenConfig.h"
+#include "memory/ArrowMemoryPool.h"
+#include "memory/VeloxColumnarBatch.h"
 #include "operators/serializer/VeloxRowToColumnarConverter.h"
 #include "shuffle/VeloxShuffleWriter.h"
+#include "utils/ConfigExtractor.h"
 #include "utils/TaskContext.h"
 #include "velox/common/file/FileSystems.h"
 
@@ -34,6 +40,62 @@ namespace gluten {
 
 namespace {
 
+// shuffle
+const std::string kShuffleWriterType = "spark.gluten.sql.columnar.backend.velox.shuffleWriterType";
+const std::string kSortShuffleBufferThreshold = "spark.gluten.sql.columnar.backend.velox.sortShuffleBufferThreshold";
+const std::string kShuffleSpillThreads = "spark.gluten.sql.columnar.backend.velox.shuffleSpillThreads";
+const std::string kShuffleMaxInflightSpillBytes =
+    "spark.gluten.sql.columnar.backend.velox.shuffleMaxInflightSpillBytes";
+const std::string kShuffleParallelSplitThreshold =
+    "spark.gluten.sql.columnar.backend.velox.shuffleParallelSplitThreshold";
+const std::string kShuffleAdaptiveCompression = "spark.gluten.sql.columnar.backend.velox.shuffleAdaptiveCompression";
+const std::string kShuffleStringDictionaryEncoding =
+    "spark.gluten.sql.columnar.backend.velox.shuffleStringDictionaryEncoding";
+const std::string kShuffleElideConstantColumns = "spark.gluten.sql.columnar.backend.velox.shuffleElideConstantColumns";
+const std::string kShuffleRoundRobinClustering = "spark.gluten.sql.columnar.backend.velox.shuffleRoundRobinClustering";
+const std::string kShuffleBlockChecksum = "spark.gluten.sql.columnar.backend.velox.shuffleBlockChecksum";
+const std::string kShuffleRemoteSpillBufferSize =
+    "spark.gluten.sql.columnar.backend.velox.shuffleRemoteSpillBufferSize";
+const std::string kShuffleIoUring = "spark.gluten.sql.columnar.backend.velox.shuffleIoUring";
+const std::string kShuffleIoUringDirect = "spark.gluten.sql.columnar.backend.velox.shuffleIoUringDirect";
+const std::string kShufflePushMergeChunkSize = "spark.gluten.sql.columnar.backend.velox.shufflePushMergeChunkSize";
+const std::string kShuffleZstdDictionaryTrainingBuffers =
+    "spark.gluten.sql.columnar.backend.velox.shuffleZstdDictionaryTrainingBuffers";
+const std::string kShuffleBufferCacheCapacity = "spark.gluten.sql.columnar.backend.velox.shuffleBufferCacheCapacity";
+const std::string kShuffleHugePages = "spark.gluten.sql.columnar.backend.velox.shuffleHugePages";
+const std::string kShuffleNumaBind = "spark.gluten.sql.columnar.backend.velox.shuffleNumaBind";
+const std::string kCelebornAsyncPush = "spark.gluten.sql.columnar.backend.velox.celebornAsyncPush";
+const std::string kCelebornPushBatchSize = "spark.gluten.sql.columnar.backend.velox.celebornPushBatchSize";
+const std::string kCelebornMaxInflightPushBytes =
+    "spark.gluten.sql.columnar.backend.velox.celebornMaxInflightPushBytes";
+const std::string kArenaAllocator = "spark.gluten.sql.columnar.backend.velox.arenaAllocator";
+
+// columnar to row
+const std::string kColumnarToRowParallelThreshold =
+    "spark.gluten.sql.columnar.backend.velox.columnarToRowParallelThreshold";
+const std::string kShuffleReaderDecompressIntoSlab =
+    "spark.gluten.sql.columnar.backend.velox.shuffleReaderDecompressIntoSlab";
+const std::string kShuffleReaderPrefetchBlocks = "spark.gluten.sql.columnar.backend.velox.shuffleReaderPrefetchBlocks";
+const std::string kShuffleReaderMergeBatchRows = "spark.gluten.sql.columnar.backend.velox.shuffleReaderMergeBatchRows";
+
+// broadcast, codec of the buffers of serialized relations, "lz4" or "zstd", empty for none
+const std::string kBroadcastCodec = "spark.gluten.sql.columnar.backend.velox.broadcastCodec";
+
+// memory tiers, "default" or "hbm"
+const std::string kTaskMemoryTier = "spark.gluten.sql.columnar.backend.velox.taskMemoryTier";
+const std::string kShuffleWriterMemoryTier = "spark.gluten.sql.columnar.backend.velox.shuffleWriterMemoryTier";
+
+// NUMA, bind the task thread and the memory it faults in to the least loaded node
+const std::string kNumaBindTask = "spark.gluten.sql.columnar.backend.velox.numaBindTask";
+
+// remote spill, uri of the dir the operators and the shuffle writer spill to once the local disks are full, e.g.
+// hdfs://host/tmp/spill
+const std::string kRemoteSpillDir = "spark.gluten.sql.columnar.backend.velox.remoteSpillDir";
+// operators spill under the remote dir when the local disk of their spill dir has less free space at task start
+const std::string kRemoteSpillMinLocalFreeBytes =
+    "spark.gluten.sql.columnar.backend.velox.remoteSpillMinLocalFreeBytes";
+const std::string kRemoteSpillMinLocalFreeBytesDefault = std::to_string(1L << 30);
+
 void printSessionConf(const std::unordered_map<std::string, std::string>& conf) {
   std::ostringstream oss;
   oss << "session conf = {\n";
@@ -44,6 +106,30 @@ void printSessionConf(const std::unordered_map<std::string, std::string>& conf)
   LOG(INFO) << oss.str();
 }
 
+// The spill dir of the task, moved under the remote spill dir when the local disk is low on space. Velox writes and
+// reads the spill files through the file system registered for the dir.
+std::string selectSpillDir(const std::string& localSpillDir, const std::unordered_map<std::string, std::string>& conf) {
+  auto remoteSpillDir = getConfigValue(conf, kRemoteSpillDir, "");
+  if (remoteSpillDir.empty()) {
+    return localSpillDir;
+  }
+  auto path = std::filesystem::path(localSpillDir);
+  if (!path.has_filename()) {
+    path = path.parent_path();
+  }
+  // The spill dir is created with the task, its parent is on the same disk.
+  std::error_code ec;
+  auto space = std::filesystem::space(path.parent_path(), ec);
+  auto minFreeBytes =
+      std::stoull(getConfigValue(conf, kRemoteSpillMinLocalFreeBytes, kRemoteSpillMinLocalFreeBytesDefault));
+  if (ec || space.available >= minFreeBytes) {
+    return localSpillDir;
+  }
+  auto spillDir = remoteSpillDir + (remoteSpillDir.back() == '/' ? "" : "/") + path.filename().string();
+  LOG(INFO) << "Only " << space.available << " bytes free for " << localSpillDir << ", spilling to " << spillDir;
+  return spillDir;
+}
+
 } // namespace
 
 VeloxBackend::VeloxBackend(const std::unordered_map<std::string, std::string>& confMap) : Backend(confMap) {}
@@ -69,6 +155,44 @@ void VeloxBackend::getInfoAndIds(
   }
 }
 
+std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> VeloxBackend::toVeloxPlan(
+    const std::unordered_map<std::string, std::string>& sessionConf) {
+  auto* cache = VeloxPlanCache::instance();
+  std::optional<std::string> cacheKey;
+  if (cache->capacity() > 0) {
+    cacheKey = VeloxPlanCache::makeKey(substraitPlan_, sessionConf);
+  }
+  auto readRels = VeloxPlanCache::readRels(substraitPlan_);
+  if (cacheKey.has_value()) {
+    if (auto cached = cache->get(*cacheKey)) {
+      // Only the splits differ from the plan the cached one is converted from.
+      GLUTEN_CHECK(cached->scanNodeIds.size() == readRels.size(), "Cached plan doesn't match the Substrait plan");
+      veloxPlan_ = cached->plan;
+      std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfos;
+      for (size_t i = 0; i < readRels.size(); ++i) {
+        if (!cached->scanNodeIds[i].empty()) {
+          splitInfos[cached->scanNodeIds[i]] = SubstraitToVeloxPlanConverter::parseSplitInfo(*readRels[i]);
+        }
+      }
+      return splitInfos;
+    }
+  }
+
+  VeloxPlanConverter veloxPlanConverter(inputIters_, sessionConf);
+  veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_);
+  if (cacheKey.has_value()) {
+    auto entry = std::make_shared<VeloxPlanCache::Entry>();
+    entry->plan = veloxPlan_;
+    const auto& scanNodeIds = veloxPlanConverter.scanNodeIds();
+    for (const auto* readRel : readRels) {
+      auto it = scanNodeIds.find(readRel);
+      entry->scanNodeIds.push_back(it == scanNodeIds.end() ? "" : it->second);
+    }
+    cache->put(*cacheKey, std::move(entry));
+  }
+  return veloxPlanConverter.splitInfos();
+}
+
 std::shared_ptr<ResultIterator> VeloxBackend::getResultIterator(
     MemoryAllocator* allocator,
     const std::string& spillDir,
@@ -81,11 +205,18 @@ std::shared_ptr<ResultIterator> VeloxBackend::getResultIterator(
     inputIters_ = std::move(inputs);
   }
 
-  auto veloxPool = asAggregateVeloxMemoryPool(allocator);
+  // Before the task pools allocate, so that their pages are faulted in on the node of the thread.
+  if (getConfigValue(confMap_, kNumaBindTask, "false") == "true") {
+    numaBinding_ = NumaTaskBinding::bindCurrentThread();
+  }
+
+  // Hash tables of joins and aggregations are the hot buffers of the task.
+  auto tier = toMemoryTier(getConfigValue(confMap_, kTaskMemoryTier, "hbm"));
+  auto veloxPool = asAggregateVeloxMemoryPool(allocator, tier);
   auto ctxPool = veloxPool->addAggregateChild("result_iterator", facebook::velox::memory::MemoryReclaimer::create());
 
-  VeloxPlanConverter veloxPlanConverter(inputIters_, sessionConf);
-  veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_);
+  auto splitInfos = toVeloxPlan(sessionConf);
+  auto taskSpillDir = selectSpillDir(spillDir, confMap_);
 
   // Scan node can be required.
   std::vector<std::shared_ptr<SplitInfo>> scanInfos;
@@ -93,24 +224,47 @@ std::shared_ptr<ResultIterator> VeloxBackend::getResultIterator(
   std::vector<velox::core::PlanNodeId> streamIds;
 
   // Separate the scan ids and stream ids, and get the scan infos.
-  getInfoAndIds(veloxPlanConverter.splitInfos(), veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
+  getInfoAndIds(splitInfos, veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
 
   if (scanInfos.size() == 0) {
     // Source node is not required.
     auto wholestageIter = std::make_unique<WholeStageResultIteratorMiddleStage>(
-        ctxPool, veloxPlan_, streamIds, spillDir, sessionConf, taskInfo_);
+        ctxPool, veloxPlan_, streamIds, taskSpillDir, sessionConf, taskInfo_);
     return std::make_shared<ResultIterator>(std::move(wholestageIter), shared_from_this());
   } else {
     auto wholestageIter = std::make_unique<WholeStageResultIteratorFirstStage>(
-        ctxPool, veloxPlan_, scanIds, scanInfos, streamIds, spillDir, sessionConf, taskInfo_);
+        ctxPool, veloxPlan_, scanIds, scanInfos, streamIds, taskSpillDir, sessionConf, taskInfo_);
+    // A fragment over files only has the same output while the plan and the files are the same.
+    if (streamIds.empty() && VeloxFragmentResultCache::instance()->maxBytes() > 0) {
+      if (auto key = VeloxFragmentResultCache::makeKey(substraitPlan_, sessionConf)) {
+        wholestageIter->useResultCache(std::move(*key));
+      }
+    }
     return std::make_shared<ResultIterator>(std::move(wholestageIter), shared_from_this());
   }
 }
 
+std::shared_ptr<ArenaMemoryAllocator> VeloxBackend::makeArenaAllocator(MemoryAllocator* allocator) {
+  if (getConfigValue(confMap_, kArenaAllocator, "false") != "true") {
+    return nullptr;
+  }
+  auto arena = std::make_shared<ArenaMemoryAllocator>(allocator);
+  bindToTask(arena); // pools over the arena are kept alive until task ends
+  return arena;
+}
+
 std::shared_ptr<ColumnarToRowConverter> VeloxBackend::getColumnar2RowConverter(MemoryAllocator* allocator) {
+  auto* executor = VeloxInitializer::get()->getColumnarToRowExecutor();
+  int32_t numThreads = executor != nullptr ? executor->numThreads() : 0;
+  auto parallelThreshold = std::stoi(getConfigValue(confMap_, kColumnarToRowParallelThreshold, "16384"));
+  if (auto arena = makeArenaAllocator(allocator)) {
+    auto ctxVeloxPool = asAggregateVeloxMemoryPool(arena.get())->addLeafChild("columnar_to_row_velox");
+    return std::make_shared<VeloxColumnarToRowConverter>(
+        ctxVeloxPool, std::move(arena), executor, numThreads, parallelThreshold);
+  }
   auto veloxPool = asAggregateVeloxMemoryPool(allocator);
   auto ctxVeloxPool = veloxPool->addLeafChild("columnar_to_row_velox");
-  return std::make_shared<VeloxColumnarToRowConverter>(ctxVeloxPool);
+  return std::make_shared<VeloxColumnarToRowConverter>(ctxVeloxPool, nullptr, executor, numThreads, parallelThreshold);
 }
 
 std::shared_ptr<RowToColumnarConverter> VeloxBackend::getRowToColumnarConverter(
@@ -126,19 +280,106 @@ std::shared_ptr<ShuffleWriter> VeloxBackend::makeShuffleWriter(
     int numPartitions,
     std::shared_ptr<ShuffleWriter::PartitionWriterCreator> partitionWriterCreator,
     const ShuffleWriterOptions& options) {
+  auto veloxOptions = options;
+  veloxOptions.shuffle_writer_type = getConfigValue(confMap_, kShuffleWriterType, options.shuffle_writer_type);
+  veloxOptions.sort_buffer_threshold = std::stol(
+      getConfigValue(confMap_, kSortShuffleBufferThreshold, std::to_string(options.sort_buffer_threshold)));
+  veloxOptions.num_spill_threads =
+      std::stoi(getConfigValue(confMap_, kShuffleSpillThreads, std::to_string(options.num_spill_threads)));
+  veloxOptions.max_inflight_spill_bytes = std::stol(
+      getConfigValue(confMap_, kShuffleMaxInflightSpillBytes, std::to_string(options.max_inflight_spill_bytes)));
+  veloxOptions.remote_spill_dir = getConfigValue(confMap_, kRemoteSpillDir, options.remote_spill_dir);
+  veloxOptions.remote_spill_buffer_size = std::stol(getConfigValue(
+      confMap_, kShuffleRemoteSpillBufferSize, std::to_string(options.remote_spill_buffer_size)));
+  veloxOptions.io_uring = getConfigValue(confMap_, kShuffleIoUring, "false") == "true";
+  veloxOptions.io_uring_direct = getConfigValue(confMap_, kShuffleIoUringDirect, "false") == "true";
+  if (auto* splitExecutor = VeloxInitializer::get()->getShuffleSplitExecutor()) {
+    veloxOptions.split_executor = splitExecutor;
+    veloxOptions.num_split_threads = splitExecutor->numThreads();
+  }
+  veloxOptions.parallel_split_threshold = std::stoi(
+      getConfigValue(confMap_, kShuffleParallelSplitThreshold, std::to_string(options.parallel_split_threshold)));
+  veloxOptions.adaptive_compression = getConfigValue(confMap_, kShuffleAdaptiveCompression, "false") == "true";
+  veloxOptions.zstd_dictionary_training_buffers = std::stoi(getConfigValue(
+      confMap_,
+      kShuffleZstdDictionaryTrainingBuffers,
+      std::to_string(options.zstd_dictionary_training_buffers)));
+  veloxOptions.string_dictionary_encoding =
+      getConfigValue(confMap_, kShuffleStringDictionaryEncoding, "false") == "true";
+  veloxOptions.elide_constant_columns = getConfigValue(confMap_, kShuffleElideConstantColumns, "false") == "true";
+  veloxOptions.round_robin_clustering = getConfigValue(confMap_, kShuffleRoundRobinClustering, "false") == "true";
+  veloxOptions.block_checksum = getConfigValue(confMap_, kShuffleBlockChecksum, "false") == "true";
+  veloxOptions.push_merge_chunk_size = std::stol(
+      getConfigValue(confMap_, kShufflePushMergeChunkSize, std::to_string(options.push_merge_chunk_size)));
+  veloxOptions.buffer_cache_capacity = std::stol(
+      getConfigValue(confMap_, kShuffleBufferCacheCapacity, std::to_string(options.buffer_cache_capacity)));
+  veloxOptions.ipc_huge_pages = getConfigValue(confMap_, kShuffleHugePages, "false") == "true";
+  // The writer runs on the task thread, bound by the result iterator feeding it.
+  veloxOptions.ipc_numa_bind =
+      getConfigValue(confMap_, kShuffleNumaBind, getConfigValue(confMap_, kNumaBindTask, "false")) == "true";
+  // Partition buffers are written on every split. The ipc pool keeps its tier.
+  auto tier = toMemoryTier(getConfigValue(confMap_, kShuffleWriterMemoryTier, "hbm"));
+  if (auto pool = std::dynamic_pointer_cast<ArrowMemoryPool>(options.memory_pool)) {
+    veloxOptions.memory_pool = asArrowMemoryPool(pool->allocator(), tier);
+  }
+  veloxOptions.async_push = getConfigValue(confMap_, kCelebornAsyncPush, "false") == "true";
+  veloxOptions.push_batch_size =
+      std::stol(getConfigValue(confMap_, kCelebornPushBatchSize, std::to_string(options.push_batch_size)));
+  veloxOptions.max_inflight_push_bytes = std::stol(
+      getConfigValue(confMap_, kCelebornMaxInflightPushBytes, std::to_string(options.max_inflight_push_bytes)));
   GLUTEN_ASSIGN_OR_THROW(
       auto shuffle_writer,
-      VeloxShuffleWriter::create(numPartitions, std::move(partitionWriterCreator), std::move(options)));
+      VeloxShuffleWriter::create(numPartitions, std::move(partitionWriterCreator), std::move(veloxOptions)));
   return shuffle_writer;
 }
 
+std::shared_ptr<Reader> VeloxBackend::getShuffleReader(
+    std::shared_ptr<arrow::io::InputStream> in,
+    std::shared_ptr<arrow::Schema> schema,
+    ReaderOptions options,
+    std::shared_ptr<arrow::MemoryPool> pool,
+    MemoryAllocator* allocator) {
+  auto veloxPool = asAggregateVeloxMemoryPool(allocator);
+  auto ctxVeloxPool = veloxPool->addLeafChild("velox_shuffle_reader");
+  auto decompressIntoSlab = getConfigValue(confMap_, kShuffleReaderDecompressIntoSlab, "false");
+  options.decompress_into_slab = decompressIntoSlab == "true";
+  options.prefetch_blocks = std::stoi(getConfigValue(confMap_, kShuffleReaderPrefetchBlocks, "0"));
+  options.merge_batch_rows = std::stoi(getConfigValue(confMap_, kShuffleReaderMergeBatchRows, "0"));
+  options.read_merged_chunks = std::stol(getConfigValue(confMap_, kShufflePushMergeChunkSize, "0")) > 0;
+  // Blocks are prefetched on the IO executor, read synchronously without one.
+  return std::make_shared<VeloxShuffleReader>(
+      in, schema, options, pool, ctxVeloxPool, VeloxInitializer::get()->getIOExecutor());
+}
+
 std::shared_ptr<ColumnarBatchSerializer> VeloxBackend::getColumnarBatchSerializer(
     MemoryAllocator* allocator,
     struct ArrowSchema* cSchema) {
   auto arrowPool = asArrowMemoryPool(allocator);
   auto veloxPool = asAggregateVeloxMemoryPool(allocator);
   auto ctxVeloxPool = veloxPool->addLeafChild("velox_columnar_batch_serializer");
-  return std::make_shared<VeloxColumnarBatchSerializer>(arrowPool, ctxVeloxPool, cSchema);
+  auto codec = arrow::Compression::UNCOMPRESSED;
+  auto codecName = getConfigValue(confMap_, kBroadcastCodec, "");
+  if (!codecName.empty()) {
+    GLUTEN_ASSIGN_OR_THROW(codec, arrow::util::Codec::GetCompressionType(codecName));
+    if (codec == arrow::Compression::LZ4) {
+      codec = arrow::Compression::LZ4_FRAME;
+    }
+  }
+  if (auto arena = makeArenaAllocator(allocator)) {
+    auto arenaVeloxPool =
+        asAggregateVeloxMemoryPool(arena.get())->addLeafChild("velox_columnar_batch_serializer_arena");
+    return std::make_shared<VeloxColumnarBatchSerializer>(
+        arrowPool, ctxVeloxPool, cSchema, std::move(arena), std::move(arenaVeloxPool), codec);
+  }
+  return std::make_shared<VeloxColumnarBatchSerializer>(arrowPool, ctxVeloxPool, cSchema, nullptr, nullptr, codec);
+}
+
+std::shared_ptr<ColumnarBatch> VeloxBackend::composeColumnarBatches(
+    std::vector<std::shared_ptr<ColumnarBatch>> batches) {
+  // The row vector references the children of the Velox inputs and owns the imported buffers of the Arrow ones, so
+  // composing copies no data.
+  auto composite = CompositeColumnarBatch::create(std::move(batches));
+  return VeloxColumnarBatch::from(defaultLeafVeloxMemoryPool().get(), composite);
 }
 
 } // namespace gluten
@@ -25,8 +25,10 @@
 
 #include "WholeStageResultIterator.h"
 #include "compute/Backend.h"
+#include "memory/NumaBinding.h"
 #include "operators/serializer/VeloxColumnarBatchSerializer.h"
 #include "operators/serializer/VeloxColumnarToRowConverter.h"
+#include "operators/writer/VeloxBlockStripeSplitter.h"
 #include "operators/writer/VeloxParquetDatasource.h"
 #include "shuffle/ShuffleWriter.h"
 #include "shuffle/VeloxShuffleReader.h"
@@ -67,21 +69,26 @@ class VeloxBackend final : public Backend {
     return std::make_shared<VeloxParquetDatasource>(filePath, schema);
   }
 
+  std::shared_ptr<BlockStripes> splitBlockByPartitionAndBucket(
+      std::shared_ptr<ColumnarBatch> batch,
+      const std::vector<int32_t>& partitionColIndice,
+      bool hasBucket) override {
+    return VeloxBlockStripeSplitter::split(batch, partitionColIndice, hasBucket);
+  }
+
   std::shared_ptr<Reader> getShuffleReader(
       std::shared_ptr<arrow::io::InputStream> in,
       std::shared_ptr<arrow::Schema> schema,
       ReaderOptions options,
       std::shared_ptr<arrow::MemoryPool> pool,
-      MemoryAllocator* allocator) override {
-    auto veloxPool = asAggregateVeloxMemoryPool(allocator);
-    auto ctxVeloxPool = veloxPool->addLeafChild("velox_shuffle_reader");
-    return std::make_shared<VeloxShuffleReader>(in, schema, options, pool, ctxVeloxPool);
-  }
+      MemoryAllocator* allocator) override;
 
   std::shared_ptr<ColumnarBatchSerializer> getColumnarBatchSerializer(
       MemoryAllocator* allocator,
       struct ArrowSchema* cSchema) override;
 
+  std::shared_ptr<ColumnarBatch> composeColumnarBatches(std::vector<std::shared_ptr<ColumnarBatch>> batches) override;
+
   std::shared_ptr<const facebook::velox::core::PlanNode> getVeloxPlan() {
     return veloxPlan_;
   }
@@ -93,9 +100,19 @@ class VeloxBackend final : public Backend {
       std::vector<facebook::velox::core::PlanNodeId>& scanIds,
       std::vector<facebook::velox::core::PlanNodeId>& streamIds);
 
+  // Converts substraitPlan_ into veloxPlan_, or takes it from the VeloxPlanCache. Returns the splits of the plan.
+  std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> toVeloxPlan(
+      const std::unordered_map<std::string, std::string>& sessionConf);
+
  private:
+
+  // Null unless converter and serializer buffers are configured to be taken from an arena.
+  std::shared_ptr<ArenaMemoryAllocator> makeArenaAllocator(MemoryAllocator* allocator);
+
   std::vector<std::shared_ptr<ResultIterator>> inputIters_;
   std::shared_ptr<const facebook::velox::core::PlanNode> veloxPlan_;
+  // Held as long as the result iterator, null unless numaBindTask is set.
+  std::shared_ptr<NumaTaskBinding> numaBinding_;
 };
 
 } // namespace gluten
@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VeloxFragmentResultCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <map>
+#include <unordered_set>
+
+#include "VeloxPlanCache.h"
+
+namespace gluten {
+
+namespace {
+// Functions whose results differ between runs over the same input.
+const std::unordered_set<std::string> kNondeterministicFunctions = {
+    "rand",
+    "uuid",
+    "shuffle",
+    "monotonically_increasing_id",
+    "spark_partition_id"};
+
+bool callsNondeterministicFunctions(const ::substrait::Plan& plan) {
+  for (const auto& extension : plan.extensions()) {
+    if (!extension.has_extension_function()) {
+      continue;
+    }
+    // The signature follows the name, e.g. rand:i64.
+    const auto& signature = extension.extension_function().name();
+    if (kNondeterministicFunctions.count(signature.substr(0, signature.find(':'))) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+VeloxFragmentResultCache* VeloxFragmentResultCache::instance() {
+  static VeloxFragmentResultCache cache;
+  return &cache;
+}
+
+void VeloxFragmentResultCache::setMaxBytes(int64_t maxBytes, int64_t maxEntryBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxBytes_ = std::max<int64_t>(0, maxBytes);
+  maxEntryBytes_ = std::min(maxBytes_, maxEntryBytes);
+  evictLocked();
+}
+
+int64_t VeloxFragmentResultCache::maxBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return maxBytes_;
+}
+
+int64_t VeloxFragmentResultCache::maxEntryBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return maxEntryBytes_;
+}
+
+std::optional<std::string> VeloxFragmentResultCache::makeKey(
+    const ::substrait::Plan& plan,
+    const std::unordered_map<std::string, std::string>& conf) {
+  auto readRels = VeloxPlanCache::readRels(plan);
+  if (readRels.empty() || callsNondeterministicFunctions(plan)) {
+    return std::nullopt;
+  }
+  for (const auto* readRel : readRels) {
+    if (!readRel->has_local_files()) {
+      return std::nullopt;
+    }
+    for (const auto& file : readRel->local_files().items()) {
+      // Input streams have no modification time either.
+      if (file.modification_time() == 0) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  std::string key;
+  {
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream output(&stream);
+    output.SetSerializationDeterministic(true);
+    plan.SerializeToCodedStream(&output);
+  }
+  for (const auto& [name, value] : std::map<std::string, std::string>(conf.begin(), conf.end())) {
+    key.append(name).push_back('\0');
+    key.append(value).push_back('\0');
+  }
+  return key;
+}
+
+std::shared_ptr<const VeloxFragmentResultCache::Entry> VeloxFragmentResultCache::get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+  return it->second.entry;
+}
+
+void VeloxFragmentResultCache::put(const std::string& key, std::shared_ptr<const Entry> entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entry->bytes > maxEntryBytes_) {
+    return;
+  }
+  auto [it, inserted] = slots_.try_emplace(key);
+  if (inserted) {
+    lru_.push_front(&it->first);
+  } else {
+    usedBytes_ -= it->second.entry->bytes;
+    lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+  }
+  usedBytes_ += entry->bytes;
+  it->second.entry = std::move(entry);
+  it->second.lruPosition = lru_.begin();
+  evictLocked();
+}
+
+int64_t VeloxFragmentResultCache::usedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return usedBytes_;
+}
+
+void VeloxFragmentResultCache::evictLocked() {
+  while (usedBytes_ > maxBytes_ && !lru_.empty()) {
+    auto it = slots_.find(*lru_.back());
+    lru_.pop_back();
+    usedBytes_ -= it->second.entry->bytes;
+    slots_.erase(it);
+  }
+}
+
+} // namespace gluten
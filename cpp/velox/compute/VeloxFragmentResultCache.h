@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arrow/buffer.h>
+
+#include "substrait/plan.pb.h"
+
+namespace gluten {
+
+/// Executor wide cache of the output of the fragments reading only files, so that a fragment run again over the same
+/// splits of unchanged files replays its output instead of executing. An entry holds the output batches serialized by
+/// VeloxColumnarBatchSerializer with LZ4. The cache is bounded by maxBytes, 0 turning it off, and the output of a
+/// fragment over maxEntryBytes isn't kept.
+class VeloxFragmentResultCache {
+ public:
+  struct Entry {
+    std::vector<std::shared_ptr<arrow::Buffer>> batches;
+    int64_t bytes = 0;
+    /// Number of operator metrics of the task that produced the output, reported as zeros on a replay.
+    int32_t numMetrics = 0;
+  };
+
+  static VeloxFragmentResultCache* instance();
+
+  /// The least recently used entries are evicted beyond maxBytes.
+  void setMaxBytes(int64_t maxBytes, int64_t maxEntryBytes);
+
+  int64_t maxBytes() const;
+
+  int64_t maxEntryBytes() const;
+
+  /// The plan serialized with the splits and the modification times of its files, and the confs the task runs with.
+  /// Null if the plan reads input streams or calls nondeterministic functions, or if a file has no modification time
+  /// to tell it apart from a changed one.
+  static std::optional<std::string> makeKey(
+      const ::substrait::Plan& plan,
+      const std::unordered_map<std::string, std::string>& conf);
+
+  /// Null if absent.
+  std::shared_ptr<const Entry> get(const std::string& key);
+
+  void put(const std::string& key, std::shared_ptr<const Entry> entry);
+
+  int64_t usedBytes() const;
+
+ private:
+  struct Slot {
+    std::shared_ptr<const Entry> entry;
+    std::list<const std::string*>::iterator lruPosition;
+  };
+
+  void evictLocked();
+
+  mutable std::mutex mutex_;
+  int64_t maxBytes_ = 0;
+  int64_t maxEntryBytes_ = 0;
+  int64_t usedBytes_ = 0;
+  std::unordered_map<std::string, Slot> slots_;
+  // Keys of slots_, most recently used first.
+  std::list<const std::string*> lru_;
+};
+
+} // namespace gluten
@@ -14,15 +14,27 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <chrono>
 #include <filesystem>
+#include <future>
+#include <thread>
 
 #include "VeloxInitializer.h"
+#include "CacheAdmissionPolicy.h"
+#include "CachedFileTracker.h"
+#include "IOScheduler.h"
+#include "SplitPreloadController.h"
+#include "VeloxFragmentResultCache.h"
+#include "VeloxPlanCache.h"
 
 #include <folly/executors/IOThreadPoolExecutor.h>
 
 #include "config/GlutenConfig.h"
+#include "memory/AllocationProfiler.h"
+#include "memory/MemoryTier.h"
 #include "operators/functions/RegistrationAllFunctions.h"
 #include "operators/plannodes/RowVectorStream.h"
+#include "substrait/SubstraitToVeloxPlanValidator.h"
 #ifdef GLUTEN_ENABLE_QAT
 #include "utils/qat/QatCodec.h"
 #endif
@@ -75,20 +87,111 @@ const std::string kVeloxSsdCacheShardsDefault = "1";
 const std::string kVeloxSsdCacheIOThreads = "spark.gluten.sql.columnar.backend.velox.ssdCacheIOThreads";
 const std::string kVeloxSsdCacheIOThreadsDefault = "1";
 const std::string kVeloxSsdODirectEnabled = "spark.gluten.sql.columnar.backend.velox.ssdODirect";
+// Keep the ssd cache files and their checkpoints for the next executors on the host reading the same ssdCachePath, up
+// to kVeloxSsdCacheSlots executors at once. SsdCache checkpoints every kVeloxSsdCheckpointIntervalBytes written.
+const std::string kVeloxSsdCachePersistent = "spark.gluten.sql.columnar.backend.velox.ssdCachePersistent";
+const std::string kVeloxSsdCacheSlots = "spark.gluten.sql.columnar.backend.velox.ssdCacheSlots";
+const std::string kVeloxSsdCacheSlotsDefault = "16";
+const std::string kVeloxSsdCheckpointIntervalBytes =
+    "spark.gluten.sql.columnar.backend.velox.ssdCheckpointIntervalBytes";
+const std::string kVeloxSsdCheckpointIntervalBytesDefault = "268435456";
+
+// Number of files read through the cache reported to the driver for the cache aware soft affinity.
+const std::string kVeloxCachedFilesTrackerCapacity =
+    "spark.gluten.sql.columnar.backend.velox.cachedFilesTrackerCapacity";
+const std::string kVeloxCachedFilesTrackerCapacityDefault = "10000";
+
+// The tasks of "frequency" cacheAdmission cache the files read kVeloxCacheAdmissionMinFrequency times within about
+// kVeloxCacheAdmissionSketchWidth / 2 file reads.
+const std::string kVeloxCacheAdmissionMinFrequency =
+    "spark.gluten.sql.columnar.backend.velox.cacheAdmissionMinFrequency";
+const std::string kVeloxCacheAdmissionMinFrequencyDefault = "2";
+const std::string kVeloxCacheAdmissionSketchWidth = "spark.gluten.sql.columnar.backend.velox.cacheAdmissionSketchWidth";
+const std::string kVeloxCacheAdmissionSketchWidthDefault = "1048576";
 
 const std::string kVeloxIOThreads = "spark.gluten.sql.columnar.backend.velox.IOThreads";
 const std::string kVeloxIOThreadsDefault = "0";
 
+// Threads writing the buffered appends of the JNI files in the background, 0 writes them on the caller threads.
+const std::string kJniFileWriteThreads = "spark.gluten.sql.columnar.backend.velox.jniFileWriteThreads";
+const std::string kJniFileWriteThreadsDefault = "2";
+
+const std::string kShuffleSplitThreads = "spark.gluten.sql.columnar.backend.velox.shuffleSplitThreads";
+const std::string kColumnarToRowThreads = "spark.gluten.sql.columnar.backend.velox.columnarToRowThreads";
+const std::string kNumDriversPerTask = "spark.gluten.sql.columnar.backend.velox.numDriversPerTask";
+const std::string kDriverThreads = "spark.gluten.sql.columnar.backend.velox.driverThreads";
+
+// Schedule the IO executor fairly across the tasks, see IOScheduler.
+const std::string kVeloxIOFairScheduling = "spark.gluten.sql.columnar.backend.velox.IOFairScheduling";
+const std::string kVeloxIOMaxInflightPerTask = "spark.gluten.sql.columnar.backend.velox.IOMaxInflightPerTask";
+const std::string kVeloxIOAdaptiveThrottling = "spark.gluten.sql.columnar.backend.velox.IOAdaptiveThrottling";
 const std::string kVeloxSplitPreloadPerDriver = "spark.gluten.sql.columnar.backend.velox.SplitPreloadPerDriver";
 const std::string kVeloxSplitPreloadPerDriverDefault = "2";
 
+// Adapt the split preload depth to the I/O wait of the scans, up to kVeloxSplitPreloadMaxPerDriver.
+const std::string kVeloxSplitPreloadAdaptive = "spark.gluten.sql.columnar.backend.velox.splitPreloadAdaptive";
+const std::string kVeloxSplitPreloadMaxPerDriver = "spark.gluten.sql.columnar.backend.velox.splitPreloadMaxPerDriver";
+const std::string kVeloxSplitPreloadMaxPerDriverDefault = "8";
+
+// Number of converted plans cached for the following tasks of their stages, 0 disables the cache.
+const std::string kVeloxPlanCacheCapacity = "spark.gluten.sql.columnar.backend.velox.planCacheCapacity";
+const std::string kVeloxPlanCacheCapacityDefault = "32";
+
+// Bytes of the fragment outputs cached for the tasks running the same fragments over the same files, 0 disables the
+// cache. The output of a fragment over the entry size, 1/16 of the cache by default, isn't kept.
+const std::string kVeloxFragmentResultCacheSize = "spark.gluten.sql.columnar.backend.velox.fragmentResultCacheSize";
+const std::string kVeloxFragmentResultCacheEntrySize =
+    "spark.gluten.sql.columnar.backend.velox.fragmentResultCacheEntrySize";
+
+// Number of rel subtree validation results cached on the driver, 0 disables the cache.
+const std::string kVeloxValidationCacheCapacity = "spark.gluten.sql.columnar.backend.velox.validationCacheCapacity";
+const std::string kVeloxValidationCacheCapacityDefault = "1024";
+
 // udf
 const std::string kVeloxUdfLibraryPaths = "spark.gluten.sql.columnar.backend.velox.udfLibraryPaths";
 
+// Register the window functions when a plan first uses them, instead of at startup.
+const std::string kVeloxLazyFunctionRegistration = "spark.gluten.sql.columnar.backend.velox.lazyFunctionRegistration";
+const std::string kVeloxLazyFunctionRegistrationDefault = "true";
+
 // spill
 const std::string kMaxSpillFileSize = "spark.gluten.sql.columnar.backend.velox.maxSpillFileSize";
 const std::string kMaxSpillFileSizeDefault = std::to_string(20L * 1024 * 1024);
 
+int64_t elapsedMillis(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The time of each startup phase, logged once the initialization is done.
+class StartupTimer {
+ public:
+  // Ends the current phase.
+  void phase(const std::string& name) {
+    add(name, elapsedMillis(phaseStart_));
+    phaseStart_ = std::chrono::steady_clock::now();
+  }
+
+  // A phase run concurrently with the others.
+  void add(const std::string& name, int64_t millis) {
+    phases_.emplace_back(name, millis);
+  }
+
+  std::string toString() const {
+    std::ostringstream oss;
+    oss << elapsedMillis(start_) << " ms {";
+    for (const auto& [name, millis] : phases_) {
+      oss << " " << name << ": " << millis << " ms";
+    }
+    oss << " }";
+    return oss.str();
+  }
+
+ private:
+  const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point phaseStart_ = start_;
+  std::vector<std::pair<std::string, int64_t>> phases_;
+};
+
 } // namespace
 
 namespace gluten {
@@ -104,6 +207,7 @@ void VeloxInitializer::printConf(const std::unordered_map<std::string, std::stri
 }
 
 void VeloxInitializer::init(const std::unordered_map<std::string, std::string>& conf) {
+  StartupTimer timer;
   // In spark, planner takes care the parititioning and sorting, so the rows are sorted.
   // There is no need to sort the rows in window op again.
   FLAGS_SkipRowSortInWindowOp = true;
@@ -116,6 +220,35 @@ void VeloxInitializer::init(const std::unordered_map<std::string, std::string>&
     }
     FLAGS_velox_exception_user_stacktrace_enabled = (enableUserExceptionStacktrace == "true");
   }
+  {
+    auto got = conf.find(kAllocationProfilerSampleInterval);
+    if (got != conf.end()) {
+      AllocationProfiler::instance()->setSampleInterval(std::stol(got->second));
+    }
+  }
+  {
+    auto got = conf.find(kHbmCapacity);
+    if (got != conf.end()) {
+      setHbmCapacity(std::stoll(got->second));
+    }
+  }
+  VeloxPlanCache::instance()->setCapacity(
+      std::stoi(getConfigValue(conf, kVeloxPlanCacheCapacity, kVeloxPlanCacheCapacityDefault)));
+  {
+    auto maxBytes = std::stoll(getConfigValue(conf, kVeloxFragmentResultCacheSize, "0"));
+    VeloxFragmentResultCache::instance()->setMaxBytes(
+        maxBytes, std::stoll(getConfigValue(conf, kVeloxFragmentResultCacheEntrySize, std::to_string(maxBytes / 16))));
+  }
+  SubstraitToVeloxPlanValidator::setCacheCapacity(
+      std::stoi(getConfigValue(conf, kVeloxValidationCacheCapacity, kVeloxValidationCacheCapacityDefault)));
+  timer.phase("conf");
+
+  // The caches don't depend on the registrations below, the ssd cache files are created meanwhile.
+  auto cacheInit = std::async(std::launch::async, [&]() {
+    auto start = std::chrono::steady_clock::now();
+    initCache(conf);
+    return elapsedMillis(start);
+  });
 
   // Setup and register.
   velox::filesystems::registerLocalFileSystem();
@@ -184,9 +317,10 @@ void VeloxInitializer::init(const std::unordered_map<std::string, std::string>&
 
   configurationValues.merge(s3Config);
 #endif
+  timer.phase("fileSystems");
 
-  initCache(conf);
   initIOExecutor(conf);
+  initCpuExecutors(conf);
 
 #ifdef GLUTEN_PRINT_DEBUG
   printConf(conf);
@@ -196,27 +330,46 @@ void VeloxInitializer::init(const std::unordered_map<std::string, std::string>&
   velox::connector::registerConnectorFactory(std::make_shared<velox::connector::hive::HiveConnectorFactory>());
   auto hiveConnector =
       velox::connector::getConnectorFactory(velox::connector::hive::HiveConnectorFactory::kHiveConnectorName)
-          ->newConnector(kHiveConnectorId, properties, ioExecutor_.get());
+          ->newConnector(kHiveConnectorId, properties, getIOExecutor());
 
   registerConnector(hiveConnector);
   velox::parquet::registerParquetReaderFactory(velox::parquet::ParquetReaderType::NATIVE);
   velox::dwrf::registerDwrfReaderFactory();
   velox::dwrf::registerOrcReaderFactory();
+  timer.phase("connectors");
+
   // Register Velox functions
-  registerAllFunctions();
+  if (getConfigValue(conf, kVeloxLazyFunctionRegistration, kVeloxLazyFunctionRegistrationDefault) == "true") {
+    registerFunctionsExceptWindow();
+  } else {
+    registerAllFunctions();
+  }
   if (!facebook::velox::isRegisteredVectorSerde()) {
     // serde, for spill
     facebook::velox::serializer::presto::PrestoVectorSerde::registerVectorSerde();
   }
   velox::exec::Operator::registerOperator(std::make_unique<RowVectorStreamOperatorTranslator>());
+  timer.phase("functions");
+
+  timer.add("cache", cacheInit.get());
+  timer.phase("cacheWait");
 
   initUdf(conf);
+  timer.phase("udf");
+  LOG(INFO) << "STARTUP: VeloxInitializer took " << timer.toString();
 }
 
 velox::memory::MemoryAllocator* VeloxInitializer::getAsyncDataCache() const {
   return asyncDataCache_.get();
 }
 
+folly::Executor* VeloxInitializer::getIOExecutor() const {
+  if (ioScheduler_ != nullptr) {
+    return ioScheduler_.get();
+  }
+  return ioExecutor_.get();
+}
+
 // JNI-or-local filesystem, for spilling-to-heap if we have extra JVM heap spaces
 void VeloxInitializer::initJolFilesystem(const std::unordered_map<std::string, std::string>& conf) {
   int64_t maxSpillFileSize = std::stol(kMaxSpillFileSizeDefault);
@@ -227,7 +380,12 @@ void VeloxInitializer::initJolFilesystem(const std::unordered_map<std::string, s
   // FIMXE It's known that if spill compression is disabled, the actual spill file size may
   //   in crease beyond this limit a little (maximum 64 rows which is by default
   //   one compression page)
-  gluten::registerJolFileSystem(maxSpillFileSize);
+  int32_t writeThreads = std::stoi(getConfigValue(conf, kJniFileWriteThreads, kJniFileWriteThreadsDefault));
+  if (writeThreads > 0) {
+    jniFileWriteExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(writeThreads);
+    LOG(INFO) << "STARTUP: Using JNI file write threads: " << writeThreads;
+  }
+  gluten::registerJolFileSystem(maxSpillFileSize, jniFileWriteExecutor_.get());
 }
 
 void VeloxInitializer::initCache(const std::unordered_map<std::string, std::string>& conf) {
@@ -256,15 +414,29 @@ void VeloxInitializer::initCache(const std::unordered_map<std::string, std::stri
         ssdCacheIOThreads = std::stoi(v);
     }
     cachePathPrefix_ = ssdCachePathPrefix;
-    cacheFilePrefix_ = getCacheFilePrefix();
-    std::string ssdCachePath = ssdCachePathPrefix + "/" + cacheFilePrefix_;
+    std::string ssdCachePath;
+    int64_t checkpointIntervalBytes = 0;
+    // The files kept from the previous executors already take their space.
+    uint64_t reusedBytes = 0;
+    if (ssdCacheSize > 0 && getConfigValue(conf, kVeloxSsdCachePersistent, "false") == "true") {
+      ssdCacheDirectory_ = std::make_unique<SsdCacheDirectory>(
+          ssdCachePathPrefix, std::stoi(getConfigValue(conf, kVeloxSsdCacheSlots, kVeloxSsdCacheSlotsDefault)));
+      ssdCachePath = ssdCacheDirectory_->open({ssdCacheSize, ssdCacheShards});
+      reusedBytes = ssdCacheDirectory_->fileBytes();
+      checkpointIntervalBytes = std::stol(
+          getConfigValue(conf, kVeloxSsdCheckpointIntervalBytes, kVeloxSsdCheckpointIntervalBytesDefault));
+    } else {
+      cacheFilePrefix_ = getCacheFilePrefix();
+      ssdCachePath = ssdCachePathPrefix + "/" + cacheFilePrefix_;
+    }
     ssdCacheExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(ssdCacheIOThreads);
-    auto ssd =
-        std::make_unique<velox::cache::SsdCache>(ssdCachePath, ssdCacheSize, ssdCacheShards, ssdCacheExecutor_.get());
+    // Reloads the entries of the checkpoints, if any.
+    auto ssd = std::make_unique<velox::cache::SsdCache>(
+        ssdCachePath, ssdCacheSize, ssdCacheShards, ssdCacheExecutor_.get(), checkpointIntervalBytes);
 
     std::error_code ec;
     const std::filesystem::space_info si = std::filesystem::space(ssdCachePathPrefix, ec);
-    if (si.available < ssdCacheSize) {
+    if (si.available + reusedBytes < ssdCacheSize) {
       VELOX_FAIL(
           "not enough space for ssd cache in " + ssdCachePath + " cache size: " + std::to_string(ssdCacheSize) +
           "free space: " + std::to_string(si.available))
@@ -283,7 +455,13 @@ void VeloxInitializer::initCache(const std::unordered_map<std::string, std::stri
     VELOX_CHECK_NOT_NULL(dynamic_cast<velox::cache::AsyncDataCache*>(asyncDataCache_.get()))
     LOG(INFO) << "STARTUP: Using AsyncDataCache memory cache size: " << memCacheSize
               << ", ssdCache prefix: " << ssdCachePath << ", ssdCache size: " << ssdCacheSize
-              << ", ssdCache shards: " << ssdCacheShards << ", ssdCache IO threads: " << ssdCacheIOThreads;
+              << ", ssdCache shards: " << ssdCacheShards << ", ssdCache IO threads: " << ssdCacheIOThreads
+              << ", ssdCache checkpoint interval bytes: " << checkpointIntervalBytes;
+    CacheAdmissionPolicy::instance()->configure(
+        std::stoi(getConfigValue(conf, kVeloxCacheAdmissionMinFrequency, kVeloxCacheAdmissionMinFrequencyDefault)),
+        std::stoi(getConfigValue(conf, kVeloxCacheAdmissionSketchWidth, kVeloxCacheAdmissionSketchWidthDefault)));
+    CachedFileTracker::instance()->setCapacity(
+        std::stoi(getConfigValue(conf, kVeloxCachedFilesTrackerCapacity, kVeloxCachedFilesTrackerCapacityDefault)));
   }
 }
 
@@ -294,11 +472,48 @@ void VeloxInitializer::initIOExecutor(const std::unordered_map<std::string, std:
   if (ioThreads > 0) {
     ioExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(ioThreads);
     FLAGS_split_preload_per_driver = splitPreloadPerDriver;
+    if (getConfigValue(conf, kVeloxIOFairScheduling, "true") == "true") {
+      IOSchedulerOptions options;
+      options.maxInflight = ioThreads;
+      options.maxInflightPerTask = std::stoi(getConfigValue(conf, kVeloxIOMaxInflightPerTask, "0"));
+      options.adaptive = getConfigValue(conf, kVeloxIOAdaptiveThrottling, "false") == "true";
+      ioScheduler_ = std::make_unique<IOScheduler>(ioExecutor_.get(), options);
+      LOG(INFO) << "STARTUP: Scheduling IO across tasks, max in flight per task: " << options.maxInflightPerTask
+                << ", adaptive throttling: " << options.adaptive;
+    }
   }
 
   if (splitPreloadPerDriver > 0 && ioThreads > 0) {
     LOG(INFO) << "STARTUP: Using split preloading, Split preload per driver: " << splitPreloadPerDriver
               << ", IO threads: " << ioThreads;
+    if (getConfigValue(conf, kVeloxSplitPreloadAdaptive, "false") == "true") {
+      auto maxPerDriver =
+          std::stoi(getConfigValue(conf, kVeloxSplitPreloadMaxPerDriver, kVeloxSplitPreloadMaxPerDriverDefault));
+      // TableScan reads the flag whenever it looks for splits to preload.
+      SplitPreloadController::instance()->enable(
+          splitPreloadPerDriver, 1, maxPerDriver, [](int32_t depth) { FLAGS_split_preload_per_driver = depth; });
+      LOG(INFO) << "STARTUP: Adapting split preload per driver up to " << maxPerDriver;
+    }
+  }
+}
+
+void VeloxInitializer::initCpuExecutors(const std::unordered_map<std::string, std::string>& conf) {
+  int32_t shuffleSplitThreads = std::stoi(getConfigValue(conf, kShuffleSplitThreads, "0"));
+  if (shuffleSplitThreads > 0) {
+    shuffleSplitExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(shuffleSplitThreads);
+    LOG(INFO) << "STARTUP: Using shuffle split threads: " << shuffleSplitThreads;
+  }
+  int32_t columnarToRowThreads = std::stoi(getConfigValue(conf, kColumnarToRowThreads, "0"));
+  if (columnarToRowThreads > 0) {
+    columnarToRowExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(columnarToRowThreads);
+    LOG(INFO) << "STARTUP: Using columnar to row threads: " << columnarToRowThreads;
+  }
+  auto multipleDrivers = std::stoi(getConfigValue(conf, kNumDriversPerTask, "1")) > 1;
+  auto defaultDriverThreads = multipleDrivers ? std::max(1u, std::thread::hardware_concurrency()) : 0;
+  int32_t driverThreads = std::stoi(getConfigValue(conf, kDriverThreads, std::to_string(defaultDriverThreads)));
+  if (driverThreads > 0) {
+    driverExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(driverThreads);
+    LOG(INFO) << "STARTUP: Using driver threads: " << driverThreads;
   }
 }
 
@@ -21,9 +21,12 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <filesystem>
 
+#include "IOScheduler.h"
+#include "SsdCacheDirectory.h"
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/memory/MemoryPool.h"
 
@@ -35,6 +38,12 @@ class VeloxInitializer {
   ~VeloxInitializer() {
     if (dynamic_cast<facebook::velox::cache::AsyncDataCache*>(asyncDataCache_.get())) {
       LOG(INFO) << asyncDataCache_->toString();
+      if (ssdCacheDirectory_) {
+        // Kept for the next executors, once the pending writes and checkpoints are done.
+        ssdCacheExecutor_->join();
+        ssdCacheDirectory_->close();
+        return;
+      }
       for (const auto& entry : std::filesystem::directory_iterator(cachePathPrefix_)) {
         if (entry.path().filename().string().find(cacheFilePrefix_) != std::string::npos) {
           LOG(INFO) << "Removing cache file " << entry.path().filename().string();
@@ -50,6 +59,28 @@ class VeloxInitializer {
 
   facebook::velox::memory::MemoryAllocator* getAsyncDataCache() const;
 
+  // Null without spark.gluten.sql.columnar.backend.velox.IOThreads. The IOScheduler over the IO threads unless
+  // spark.gluten.sql.columnar.backend.velox.IOFairScheduling is false.
+  folly::Executor* getIOExecutor() const;
+
+  // Null without spark.gluten.sql.columnar.backend.velox.shuffleSplitThreads. Shared by the shuffle writers.
+  folly::CPUThreadPoolExecutor* getShuffleSplitExecutor() const {
+    return shuffleSplitExecutor_.get();
+  }
+
+  // Null without spark.gluten.sql.columnar.backend.velox.columnarToRowThreads. Shared by the columnar to row
+  // converters.
+  folly::CPUThreadPoolExecutor* getColumnarToRowExecutor() const {
+    return columnarToRowExecutor_.get();
+  }
+
+  // Runs the drivers of the multi-driver tasks. Sized by spark.gluten.sql.columnar.backend.velox.driverThreads, the
+  // number of cores by default if spark.gluten.sql.columnar.backend.velox.numDriversPerTask is set at startup, and
+  // null otherwise.
+  folly::CPUThreadPoolExecutor* getDriverExecutor() const {
+    return driverExecutor_.get();
+  }
+
  private:
   explicit VeloxInitializer(const std::unordered_map<std::string, std::string>& conf) {
     init(conf);
@@ -58,6 +89,7 @@ class VeloxInitializer {
   void init(const std::unordered_map<std::string, std::string>& conf);
   void initCache(const std::unordered_map<std::string, std::string>& conf);
   void initIOExecutor(const std::unordered_map<std::string, std::string>& conf);
+  void initCpuExecutors(const std::unordered_map<std::string, std::string>& conf);
   void initUdf(const std::unordered_map<std::string, std::string>& conf);
 
   void initJolFilesystem(const std::unordered_map<std::string, std::string>& conf);
@@ -76,7 +108,16 @@ class VeloxInitializer {
       facebook::velox::memory::MemoryAllocator::createDefaultInstance();
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ssdCacheExecutor_;
+  // Set if the ssd cache files persist across the executors.
+  std::unique_ptr<SsdCacheDirectory> ssdCacheDirectory_;
+  // Declared before ioExecutor_, so that the IO threads running its items are joined first.
+  std::unique_ptr<IOScheduler> ioScheduler_;
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> shuffleSplitExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> columnarToRowExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> driverExecutor_;
+  // Shared by the JNI files of the jol file system.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> jniFileWriteExecutor_;
 
   std::string cachePathPrefix_;
   std::string cacheFilePrefix_;
@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VeloxPlanCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <map>
+
+namespace gluten {
+
+namespace {
+// Relations only, expressions don't hold ReadRels the converter scans.
+bool isRel(const google::protobuf::Descriptor* descriptor) {
+  return descriptor->name().find("Rel") != std::string::npos;
+}
+
+template <typename Fn>
+void forEachReadRel(const google::protobuf::Message& message, Fn&& fn) {
+  if (message.GetDescriptor() == ::substrait::ReadRel::descriptor()) {
+    fn(static_cast<const ::substrait::ReadRel&>(message));
+    return;
+  }
+  const auto* reflection = message.GetReflection();
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  // In the order of the field numbers.
+  reflection->ListFields(message, &fields);
+  for (const auto* field : fields) {
+    if (field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE || !isRel(field->message_type())) {
+      continue;
+    }
+    if (field->is_repeated()) {
+      for (int i = 0; i < reflection->FieldSize(message, field); ++i) {
+        forEachReadRel(reflection->GetRepeatedMessage(message, field, i), fn);
+      }
+    } else {
+      forEachReadRel(reflection->GetMessage(message, field), fn);
+    }
+  }
+}
+
+template <typename Fn>
+void forEachMutableReadRel(google::protobuf::Message* message, Fn&& fn) {
+  if (message->GetDescriptor() == ::substrait::ReadRel::descriptor()) {
+    fn(static_cast<::substrait::ReadRel*>(message));
+    return;
+  }
+  const auto* reflection = message->GetReflection();
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  reflection->ListFields(*message, &fields);
+  for (const auto* field : fields) {
+    if (field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE || !isRel(field->message_type())) {
+      continue;
+    }
+    if (field->is_repeated()) {
+      for (int i = 0; i < reflection->FieldSize(*message, field); ++i) {
+        forEachMutableReadRel(reflection->MutableRepeatedMessage(message, field, i), fn);
+      }
+    } else {
+      forEachMutableReadRel(reflection->MutableMessage(message, field), fn);
+    }
+  }
+}
+
+bool readsStream(const ::substrait::ReadRel& readRel) {
+  // See SubstraitToVeloxPlanConverter::getStreamIndex.
+  return readRel.has_local_files() && readRel.local_files().items_size() > 0 &&
+      readRel.local_files().items(0).uri_file().find("iterator:") != std::string::npos;
+}
+} // namespace
+
+VeloxPlanCache* VeloxPlanCache::instance() {
+  static VeloxPlanCache cache;
+  return &cache;
+}
+
+void VeloxPlanCache::setCapacity(int32_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = std::max(0, capacity);
+  evictLocked();
+}
+
+int32_t VeloxPlanCache::capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+std::optional<std::string> VeloxPlanCache::makeKey(
+    const ::substrait::Plan& plan,
+    const std::unordered_map<std::string, std::string>& conf) {
+  bool hasStream = false;
+  forEachReadRel(plan, [&hasStream](const ::substrait::ReadRel& readRel) { hasStream |= readsStream(readRel); });
+  if (hasStream) {
+    return std::nullopt;
+  }
+
+  ::substrait::Plan stripped = plan;
+  forEachMutableReadRel(&stripped, [](::substrait::ReadRel* readRel) {
+    if (!readRel->has_local_files()) {
+      return;
+    }
+    auto* items = readRel->mutable_local_files()->mutable_items();
+    if (items->size() == 0) {
+      return;
+    }
+    // The converter takes the format of the last file.
+    items->DeleteSubrange(0, items->size() - 1);
+    auto* file = items->Mutable(0);
+    file->clear_path_type();
+    file->clear_partition_index();
+    file->clear_start();
+    file->clear_length();
+    file->clear_partition_columns();
+  });
+
+  std::string key;
+  {
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream output(&stream);
+    output.SetSerializationDeterministic(true);
+    stripped.SerializeToCodedStream(&output);
+  }
+  for (const auto& [name, value] : std::map<std::string, std::string>(conf.begin(), conf.end())) {
+    key.append(name).push_back('\0');
+    key.append(value).push_back('\0');
+  }
+  return key;
+}
+
+std::vector<const ::substrait::ReadRel*> VeloxPlanCache::readRels(const ::substrait::Plan& plan) {
+  std::vector<const ::substrait::ReadRel*> readRels;
+  forEachReadRel(plan, [&readRels](const ::substrait::ReadRel& readRel) { readRels.push_back(&readRel); });
+  return readRels;
+}
+
+std::shared_ptr<const VeloxPlanCache::Entry> VeloxPlanCache::get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) {
+    numMisses_++;
+    return nullptr;
+  }
+  numHits_++;
+  lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+  return it->second.entry;
+}
+
+void VeloxPlanCache::put(const std::string& key, std::shared_ptr<const Entry> entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity_ == 0) {
+    return;
+  }
+  auto [it, inserted] = slots_.try_emplace(key);
+  if (inserted) {
+    lru_.push_front(&it->first);
+  } else {
+    lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+  }
+  it->second.entry = std::move(entry);
+  it->second.lruPosition = lru_.begin();
+  evictLocked();
+}
+
+void VeloxPlanCache::evictLocked() {
+  while (lru_.size() > static_cast<size_t>(capacity_)) {
+    auto it = slots_.find(*lru_.back());
+    lru_.pop_back();
+    slots_.erase(it);
+  }
+}
+
+int64_t VeloxPlanCache::numHits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numHits_;
+}
+
+int64_t VeloxPlanCache::numMisses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numMisses_;
+}
+
+} // namespace gluten
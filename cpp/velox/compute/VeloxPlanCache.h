@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "substrait/plan.pb.h"
+#include "velox/core/PlanNode.h"
+
+namespace gluten {
+
+/// Executor wide cache of the Velox plans converted from the Substrait plans of the tasks. The tasks of a stage send
+/// the same plan but for the files they scan, so the plan converted for one of them is reused by the others, which
+/// only bind their own splits to it.
+class VeloxPlanCache {
+ public:
+  struct Entry {
+    std::shared_ptr<const facebook::velox::core::PlanNode> plan;
+    /// The id of the TableScanNode converted from each ReadRel in the order of readRels(), empty if not a scan.
+    std::vector<facebook::velox::core::PlanNodeId> scanNodeIds;
+  };
+
+  static VeloxPlanCache* instance();
+
+  /// Number of plans kept, the least recently used one is evicted beyond. 0 disables the cache.
+  void setCapacity(int32_t capacity);
+
+  int32_t capacity() const;
+
+  /// The plan serialized with the files of its scans stripped but the formats, and the confs the plan is converted
+  /// with. Null if the plan reads input streams, whose nodes are bound to the input iterators of a task.
+  static std::optional<std::string> makeKey(
+      const ::substrait::Plan& plan,
+      const std::unordered_map<std::string, std::string>& conf);
+
+  /// All the ReadRels of the plan, in the same order for the plans of the same key.
+  static std::vector<const ::substrait::ReadRel*> readRels(const ::substrait::Plan& plan);
+
+  /// Null if absent.
+  std::shared_ptr<const Entry> get(const std::string& key);
+
+  void put(const std::string& key, std::shared_ptr<const Entry> entry);
+
+  int64_t numHits() const;
+
+  int64_t numMisses() const;
+
+ private:
+  struct Slot {
+    std::shared_ptr<const Entry> entry;
+    std::list<const std::string*>::iterator lruPosition;
+  };
+
+  void evictLocked();
+
+  mutable std::mutex mutex_;
+  int32_t capacity_ = 0;
+  std::unordered_map<std::string, Slot> slots_;
+  // Keys of slots_, most recently used first.
+  std::list<const std::string*> lru_;
+  int64_t numHits_ = 0;
+  int64_t numMisses_ = 0;
+};
+
+} // namespace gluten
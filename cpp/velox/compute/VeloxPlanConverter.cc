@@ -22,16 +22,29 @@
 #include "compute/ResultIterator.h"
 #include "config/GlutenConfig.h"
 #include "operators/plannodes/RowVectorStream.h"
+#include "utils/ConfigExtractor.h"
 #include "velox/common/file/FileSystems.h"
 
 using namespace facebook;
 
 namespace gluten {
 
+namespace {
+const std::string kCoalesceInputBatches = "spark.gluten.sql.columnar.backend.velox.coalesceInputBatches";
+const std::string kCoalesceInputBatchBytes = "spark.gluten.sql.columnar.backend.velox.coalesceInputBatchBytes";
+const std::string kCoalesceInputBatchBytesDefault = std::to_string(64 << 20);
+} // namespace
+
 VeloxPlanConverter::VeloxPlanConverter(
     std::vector<std::shared_ptr<ResultIterator>>& inputIters,
     const std::unordered_map<std::string, std::string>& confMap)
-    : inputIters_(inputIters), substraitVeloxPlanConverter_(defaultLeafVeloxMemoryPool().get(), confMap) {}
+    : inputIters_(inputIters), substraitVeloxPlanConverter_(defaultLeafVeloxMemoryPool().get(), confMap) {
+  if (getConfigValue(confMap, kCoalesceInputBatches, "false") == "true") {
+    coalesceBatchRows_ = std::stoi(getConfigValue(confMap, kSparkBatchSize, "4096"));
+    coalesceBatchBytes_ =
+        std::stol(getConfigValue(confMap, kCoalesceInputBatchBytes, kCoalesceInputBatchBytesDefault));
+  }
+}
 
 void VeloxPlanConverter::setInputPlanNode(const ::substrait::FetchRel& fetchRel) {
   if (fetchRel.has_input()) {
@@ -135,7 +148,8 @@ void VeloxPlanConverter::setInputPlanNode(const ::substrait::ReadRel& sread) {
     veloxTypeList.push_back(toVeloxType(subType->type));
   }
   auto outputType = ROW(std::move(outNames), std::move(veloxTypeList));
-  auto vectorStream = std::make_shared<RowVectorStream>(std::move(inputIters_[iterIdx]), outputType);
+  auto vectorStream = std::make_shared<RowVectorStream>(
+      std::move(inputIters_[iterIdx]), outputType, coalesceBatchRows_, coalesceBatchBytes_);
   auto valuesNode = std::make_shared<ValueStreamNode>(nextPlanNodeId(), outputType, std::move(vectorStream));
   substraitVeloxPlanConverter_.insertInputNode(iterIdx, valuesNode, planNodeId_);
 }
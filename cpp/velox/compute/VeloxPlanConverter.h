@@ -38,6 +38,10 @@ class VeloxPlanConverter {
     return substraitVeloxPlanConverter_.splitInfos();
   }
 
+  const std::unordered_map<const ::substrait::ReadRel*, facebook::velox::core::PlanNodeId>& scanNodeIds() {
+    return substraitVeloxPlanConverter_.scanNodeIds();
+  }
+
  private:
   void setInputPlanNode(const ::substrait::FetchRel& fetchRel);
 
@@ -65,6 +69,10 @@ class VeloxPlanConverter {
 
   int planNodeId_ = 0;
 
+  // Row and byte thresholds for coalescing small input batches. Disabled if rows is 0.
+  int32_t coalesceBatchRows_ = 0;
+  int64_t coalesceBatchBytes_ = 0;
+
   std::vector<std::shared_ptr<ResultIterator>> inputIters_;
 
   SubstraitToVeloxPlanConverter substraitVeloxPlanConverter_;
@@ -15,15 +15,27 @@
  * limitations under the License.
  */
 #include "WholeStageResultIterator.h"
+#include "CacheAdmissionPolicy.h"
+#include "CachedFileTracker.h"
+#include "SplitPreloadController.h"
 #include "VeloxBackend.h"
 #include "VeloxInitializer.h"
 #include "config/GlutenConfig.h"
+#include "memory/ArrowMemoryPool.h"
+#include "operators/plannodes/RowVectorStream.h"
 #include "utils/URLDecoder.h"
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/vector/arrow/Bridge.h"
+
+#include <filesystem>
+#include <folly/ScopeGuard.h>
+#include <fstream>
+#include <numeric>
+#include <optional>
 
 #include "utils/ConfigExtractor.h"
 
@@ -56,23 +68,273 @@ const std::string kSpillStartPartitionBit = "spark.gluten.sql.columnar.backend.v
 const std::string kSpillPartitionBits = "spark.gluten.sql.columnar.backend.velox.spillPartitionBits";
 const std::string kSpillableReservationGrowthPct =
     "spark.gluten.sql.columnar.backend.velox.spillableReservationGrowthPct";
+const std::string kMemoryArbitration = "spark.gluten.sql.columnar.backend.velox.memoryArbitration";
+
+// cache
+// Which tasks read through the cache: "all", "frequency" for those of the frequently read files, or "none", e.g. to
+// keep a large one-off scan out of it.
+const std::string kCacheAdmission = "spark.gluten.sql.columnar.backend.velox.cacheAdmission";
+const std::string kCacheAdmissionDefault = "all";
+
+// partial aggregation
+const std::string kAbandonPartialAggregationMinRows =
+    "spark.gluten.sql.columnar.backend.velox.abandonPartialAggregationMinRows";
+const std::string kAbandonPartialAggregationMinPct =
+    "spark.gluten.sql.columnar.backend.velox.abandonPartialAggregationMinPct";
+
+// parallelism
+const std::string kNumDriversPerTask = "spark.gluten.sql.columnar.backend.velox.numDriversPerTask";
+const std::string kDriverOutputQueueSize = "spark.gluten.sql.columnar.backend.velox.driverOutputQueueSize";
+
+// profiling
+// Sampling interval of the CPU profiler of the task, 0 disables it.
+const std::string kCpuProfileIntervalMicros = "spark.gluten.sql.columnar.backend.velox.cpuProfileIntervalMicros";
+// cpu or wall, the clock the sampling interval is measured by.
+const std::string kCpuProfileClock = "spark.gluten.sql.columnar.backend.velox.cpuProfileClock";
+// Histograms of the latencies of next(), of the waits on the input and of the spills, reported as percentiles.
+const std::string kLatencyHistograms = "spark.gluten.sql.columnar.backend.velox.latencyHistograms";
 
 // metrics
 const std::string kDynamicFiltersProduced = "dynamicFiltersProduced";
 const std::string kDynamicFiltersAccepted = "dynamicFiltersAccepted";
 const std::string kReplacedWithDynamicFilterRows = "replacedWithDynamicFilterRows";
 const std::string kFlushRowCount = "flushRowCount";
+const std::string kAbandonedPartialAggregation = "abandonedPartialAggregation";
 const std::string kTotalScanTime = "totalScanTime";
 const std::string kSkippedSplits = "skippedSplits";
 const std::string kProcessedSplits = "processedSplits";
 const std::string kSkippedStrides = "skippedStrides";
 const std::string kProcessedStrides = "processedStrides";
+const std::string kPreloadedSplits = "preloadedSplits";
+const std::string kReadyPreloadedSplits = "readyPreloadedSplits";
+const std::string kQueryThreadIoLatency = "queryThreadIoLatency";
+const std::string kPrefetchBytes = "prefetchBytes";
+const std::string kRamReadBytes = "ramReadBytes";
+const std::string kLocalReadBytes = "localReadBytes";
+const std::string kStorageReadBytes = "storageReadBytes";
+// Counters taken from the operator runtime stats.
+const std::vector<std::pair<Metrics::Counter, std::string>> kRuntimeStatCounters = {
+    {Metrics::kNumDynamicFiltersProduced, kDynamicFiltersProduced},
+    {Metrics::kNumDynamicFiltersAccepted, kDynamicFiltersAccepted},
+    {Metrics::kNumReplacedWithDynamicFilterRows, kReplacedWithDynamicFilterRows},
+    {Metrics::kFlushRowCount, kFlushRowCount},
+    {Metrics::kAbandonedPartialAggregation, kAbandonedPartialAggregation},
+    {Metrics::kScanTime, kTotalScanTime},
+    {Metrics::kSkippedSplits, kSkippedSplits},
+    {Metrics::kProcessedSplits, kProcessedSplits},
+    {Metrics::kSkippedStrides, kSkippedStrides},
+    {Metrics::kProcessedStrides, kProcessedStrides},
+    {Metrics::kPreloadedSplits, kPreloadedSplits},
+    {Metrics::kPreloadHits, kReadyPreloadedSplits},
+    {Metrics::kIoWaitNanos, kQueryThreadIoLatency},
+    {Metrics::kReadAheadBytes, kPrefetchBytes},
+    {Metrics::kRamReadBytes, kRamReadBytes},
+    {Metrics::kLocalReadBytes, kLocalReadBytes},
+    {Metrics::kStorageReadBytes, kStorageReadBytes}};
+
+// Operator runtime stats exported as they are, under their Velox names.
+const std::vector<std::string> kExtraRuntimeStats = {
+    "hashtable.capacity",
+    "hashtable.numDistinct",
+    "nativeInputBatches",
+    "arrowInputBatches"};
+
+// Batches between two reports of the scan stats to SplitPreloadController.
+const int64_t kScanStatsReportInterval = 32;
 
 // others
 const std::string kHiveDefaultPartition = "__HIVE_DEFAULT_PARTITION__";
 
+// Whether running the plan with multiple drivers, each processing a part of the splits, gives the same result as one.
+// That's the case for a single pipeline whose operators are independent of the batches seen by other drivers.
+bool canRunWithMultipleDrivers(const std::shared_ptr<const velox::core::PlanNode>& planNode) {
+  if (auto aggregation = std::dynamic_pointer_cast<const velox::core::AggregationNode>(planNode)) {
+    if (aggregation->step() != velox::core::AggregationNode::Step::kPartial) {
+      return false;
+    }
+  } else if (
+      !std::dynamic_pointer_cast<const velox::core::TableScanNode>(planNode) &&
+      !std::dynamic_pointer_cast<const velox::core::FilterNode>(planNode) &&
+      !std::dynamic_pointer_cast<const velox::core::ProjectNode>(planNode)) {
+    return false;
+  }
+  for (const auto& source : planNode->sources()) {
+    if (!canRunWithMultipleDrivers(source)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Columnar files decode to a few times their size in memory.
+const uint64_t kDecodedToFileSizeRatio = 3;
+// The partition bits of a spill level Velox allows at most.
+const int32_t kMaxSpillPartitionBits = 3;
+
+// The partition bits of each spill level and the number of levels for an operator spilling all of inputBytes to
+// restore each partition within half of memoryBudget, rather than spilling it again.
+std::pair<int32_t, int32_t> adaptiveSpillPartitioning(uint64_t inputBytes, uint64_t memoryBudget) {
+  const uint64_t partitionBytes = std::max<uint64_t>(memoryBudget / 2, 1);
+  const uint64_t numPartitions = (inputBytes * kDecodedToFileSizeRatio + partitionBytes - 1) / partitionBytes;
+  int32_t totalBits = 0;
+  while ((uint64_t{1} << totalBits) < numPartitions && totalBits < 24) {
+    ++totalBits;
+  }
+  const int32_t numLevels = std::max(1, (totalBits + kMaxSpillPartitionBits - 1) / kMaxSpillPartitionBits);
+  const int32_t bits = std::clamp((totalBits + numLevels - 1) / numLevels, 1, kMaxSpillPartitionBits);
+  return {bits, numLevels};
+}
+
+struct SpillCandidate {
+  velox::memory::MemoryPool* pool;
+  uint64_t reclaimableBytes;
+  int32_t cost;
+};
+
+// Relative cost of spilling an operator, by the type at the end of its pool name. An order by writes sorted runs and
+// merges them, an aggregation also has to merge its groups back, a join build is partitioned and makes its probe side
+// spill along, both read back partition by partition.
+int32_t spillCost(const std::string& poolName) {
+  if (poolName.find("OrderBy") != std::string::npos) {
+    return 0;
+  }
+  if (poolName.find("HashBuild") != std::string::npos) {
+    return 2;
+  }
+  return 1;
+}
+
+void collectSpillCandidates(velox::memory::MemoryPool* pool, std::vector<SpillCandidate>& candidates) {
+  pool->visitChildren([&](velox::memory::MemoryPool* child) {
+    if (child->kind() == velox::memory::MemoryPool::Kind::kLeaf) {
+      uint64_t reclaimableBytes = 0;
+      if (child->reclaimableBytes(reclaimableBytes) && reclaimableBytes > 0) {
+        candidates.push_back({child, reclaimableBytes, spillCost(child->name())});
+      }
+    } else {
+      collectSpillCandidates(child, candidates);
+    }
+    return true;
+  });
+}
+
+// The operators to spill for targetBytes, cheapest first: the smallest one of the cheapest cost that frees enough
+// alone, otherwise the largest ones of that cost and then those of the next.
+std::vector<SpillCandidate> selectSpillVictims(std::vector<SpillCandidate> candidates, uint64_t targetBytes) {
+  std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+    return a.cost != b.cost ? a.cost < b.cost : a.reclaimableBytes > b.reclaimableBytes;
+  });
+  std::vector<SpillCandidate> victims;
+  uint64_t selectedBytes = 0;
+  for (auto begin = candidates.begin(); begin != candidates.end() && selectedBytes < targetBytes;) {
+    auto end = std::find_if(begin, candidates.end(), [&](const auto& c) { return c.cost != begin->cost; });
+    const uint64_t needed = targetBytes - selectedBytes;
+    // The largest come first, so the last one freeing enough is the smallest of them.
+    auto sufficient = end;
+    for (auto it = begin; it != end && it->reclaimableBytes >= needed; ++it) {
+      sufficient = it;
+    }
+    if (sufficient != end) {
+      victims.push_back(*sufficient);
+      break;
+    }
+    for (auto it = begin; it != end && selectedBytes < targetBytes; ++it) {
+      victims.push_back(*it);
+      selectedBytes += it->reclaimableBytes;
+    }
+    begin = end;
+  }
+  return victims;
+}
+
 } // namespace
 
+DriverOutputQueue::DriverOutputQueue(int32_t maxSize) : maxSize_(std::max(1, maxSize)) {}
+
+void DriverOutputQueue::setNumProducers(int32_t numProducers) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    numProducers_ = numProducers;
+  }
+  notEmpty_.notify_one();
+}
+
+velox::exec::BlockingReason DriverOutputQueue::enqueue(velox::RowVectorPtr vector, velox::ContinueFuture* future) {
+  if (vector != nullptr) {
+    // The vectors may be lazy, load them on the driver threads.
+    for (auto& child : vector->children()) {
+      child->loadedVector();
+    }
+  }
+  auto reason = velox::exec::BlockingReason::kNotBlocked;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      return reason;
+    }
+    if (vector == nullptr) {
+      numFinishedProducers_++;
+    } else {
+      queue_.push_back(std::move(vector));
+      if (queue_.size() >= maxSize_ && future != nullptr) {
+        auto [promise, blockedFuture] = velox::makeVeloxContinuePromiseContract("DriverOutputQueue::enqueue");
+        producerPromises_.emplace_back(std::move(promise));
+        *future = std::move(blockedFuture);
+        reason = velox::exec::BlockingReason::kWaitForConsumer;
+      }
+    }
+  }
+  notEmpty_.notify_one();
+  return reason;
+}
+
+velox::RowVectorPtr DriverOutputQueue::dequeue() {
+  std::vector<velox::ContinuePromise> promises;
+  velox::RowVectorPtr vector;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notEmpty_.wait(lock, [this] { return !queue_.empty() || closed_ || numFinishedProducers_ == numProducers_; });
+    if (!queue_.empty()) {
+      vector = std::move(queue_.front());
+      queue_.pop_front();
+      promises = takePromisesLocked();
+    } else if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+  return vector;
+}
+
+void DriverOutputQueue::close(std::exception_ptr error) {
+  std::vector<velox::ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    error_ = error;
+    promises = std::move(producerPromises_);
+    producerPromises_.clear();
+  }
+  notEmpty_.notify_all();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+std::vector<velox::ContinuePromise> DriverOutputQueue::takePromisesLocked() {
+  std::vector<velox::ContinuePromise> promises;
+  if (queue_.size() < maxSize_) {
+    promises = std::move(producerPromises_);
+    producerPromises_.clear();
+  }
+  return promises;
+}
+
 WholeStageResultIterator::WholeStageResultIterator(
     std::shared_ptr<facebook::velox::memory::MemoryPool> pool,
     const std::shared_ptr<const facebook::velox::core::PlanNode>& planNode,
@@ -83,28 +345,185 @@ WholeStageResultIterator::WholeStageResultIterator(
 #endif
   spillStrategy_ = getConfigValue(confMap_, kSpillStrategy, kSpillStrategyDefaultValue);
   getOrderedNodeIds(veloxPlan_, orderedNodeIds_);
+  if (getConfigValue(confMap_, kLatencyHistograms, "false") == "true") {
+    nextLatency_ = std::make_unique<LatencyHistogram>();
+    spillLatency_ = std::make_unique<LatencyHistogram>();
+    inputWaitLatency_ = std::make_shared<LatencyHistogram>();
+    trackInputWait(veloxPlan_);
+  }
+}
+
+void WholeStageResultIterator::trackInputWait(const std::shared_ptr<const velox::core::PlanNode>& planNode) {
+  if (auto valueStream = std::dynamic_pointer_cast<const ValueStreamNode>(planNode)) {
+    valueStream->rowVectorStream()->trackInputWait(inputWaitLatency_);
+  }
+  for (const auto& source : planNode->sources()) {
+    trackInputWait(source);
+  }
 }
 
-std::shared_ptr<velox::core::QueryCtx> WholeStageResultIterator::createNewVeloxQueryCtx() {
+std::shared_ptr<velox::core::QueryCtx> WholeStageResultIterator::createNewVeloxQueryCtx(folly::Executor* executor) {
   std::unordered_map<std::string, std::shared_ptr<velox::Config>> connectorConfigs;
   connectorConfigs[kHiveConnectorId] = createConnectorConfig();
   std::shared_ptr<velox::core::QueryCtx> ctx = std::make_shared<velox::core::QueryCtx>(
-      nullptr,
+      executor,
       getQueryContextConf(),
       connectorConfigs,
-      gluten::VeloxInitializer::get()->getAsyncDataCache(),
+      // The scans read through the cache only if it's the allocator of the query, the pools allocate from the
+      // default one anyway.
+      useCache_ ? gluten::VeloxInitializer::get()->getAsyncDataCache() : velox::memory::MemoryAllocator::getInstance(),
       pool_,
       nullptr,
       "");
   return ctx;
 }
 
+void WholeStageResultIterator::createTask(
+    const SparkTaskInfo& taskInfo,
+    const std::shared_ptr<const velox::core::PlanNode>& planNode,
+    int32_t numDrivers) {
+  numDrivers_ = numDrivers;
+  std::unordered_set<velox::core::PlanNodeId> emptySet;
+  velox::core::PlanFragment planFragment{planNode, velox::core::ExecutionStrategy::kUngrouped, 1, emptySet};
+  auto taskId = fmt::format("Gluten stage-{} task-{}", taskInfo.stageId, taskInfo.taskId);
+  if (numDrivers_ <= 1) {
+    task_ = velox::exec::Task::create(taskId, std::move(planFragment), 0, createNewVeloxQueryCtx());
+    if (!task_->supportsSingleThreadedExecution()) {
+      throw std::runtime_error("Task doesn't support single thread execution: " + planNode->toString());
+    }
+    return;
+  }
+
+  outputQueue_ =
+      std::make_shared<DriverOutputQueue>(std::stoi(getConfigValue(confMap_, kDriverOutputQueueSize, "4")));
+  task_ = velox::exec::Task::create(
+      taskId,
+      std::move(planFragment),
+      0,
+      createNewVeloxQueryCtx(VeloxInitializer::get()->getDriverExecutor()),
+      [queue = outputQueue_](velox::RowVectorPtr vector, velox::ContinueFuture* future) {
+        return queue->enqueue(std::move(vector), future);
+      },
+      [queue = outputQueue_](std::exception_ptr error) { queue->close(error); });
+}
+
+void WholeStageResultIterator::enableCpuProfile(const SparkTaskInfo& taskInfo, const std::string& spillDir) {
+  auto intervalMicros = std::stol(getConfigValue(confMap_, kCpuProfileIntervalMicros, "0"));
+  if (intervalMicros <= 0) {
+    return;
+  }
+  auto clock = getConfigValue(confMap_, kCpuProfileClock, "cpu") == "wall" ? CpuProfiler::Clock::kWall
+                                                                            : CpuProfiler::Clock::kCpu;
+  cpuProfiler_ = std::make_unique<CpuProfiler>(intervalMicros, clock);
+  // Only the drivers run by next() on the Spark task thread are sampled, not the ones of a multi-driver task.
+  cpuProfileTagId_ = cpuProfiler_->addTag(fmt::format(
+      "stage-{} task-{};node-{} {}", taskInfo.stageId, taskInfo.taskId, veloxPlan_->id(), veloxPlan_->name()));
+  // The spill directory is removed with the task, its parent is shared by the tasks of the executor.
+  cpuProfilePath_ = (std::filesystem::path(spillDir).parent_path() /
+                     fmt::format("cpu-profile-stage-{}-task-{}.folded", taskInfo.stageId, taskInfo.taskId))
+                        .string();
+}
+
+void WholeStageResultIterator::writeCpuProfile() {
+  std::ofstream out(cpuProfilePath_);
+  cpuProfiler_->writeFolded(out);
+  out.close();
+  if (!out) {
+    LOG(WARNING) << "Failed to write the CPU profile to " << cpuProfilePath_;
+    return;
+  }
+  LOG(INFO) << "CPU profile of " << cpuProfiler_->numSamples() << " samples written to " << cpuProfilePath_ << ", "
+            << cpuProfiler_->numDroppedSamples() << " samples dropped.";
+}
+
+int32_t WholeStageResultIterator::numDriversFor(const std::shared_ptr<const velox::core::PlanNode>& planNode) {
+  auto numDrivers = std::stoi(getConfigValue(confMap_, kNumDriversPerTask, "1"));
+  if (numDrivers <= 1 || VeloxInitializer::get()->getDriverExecutor() == nullptr ||
+      !canRunWithMultipleDrivers(planNode)) {
+    return 1;
+  }
+  return numDrivers;
+}
+
+void WholeStageResultIterator::useResultCache(std::string key) {
+  resultCachePool_ = pool_->addLeafChild("fragment_result_cache");
+  ArrowSchema cSchema;
+  velox::exportToArrow(velox::BaseVector::create(veloxPlan_->outputType(), 0, resultCachePool_.get()), cSchema);
+  resultCacheSerializer_ = std::make_unique<VeloxColumnarBatchSerializer>(
+      defaultArrowMemoryPool(), resultCachePool_, &cSchema, nullptr, nullptr, arrow::Compression::LZ4_FRAME);
+  cachedOutput_ = VeloxFragmentResultCache::instance()->get(key);
+  if (cachedOutput_ == nullptr) {
+    outputToCache_ = std::make_shared<VeloxFragmentResultCache::Entry>();
+    resultCacheKey_ = std::move(key);
+  }
+}
+
 std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
+  LatencyHistogram::Timer timer(nextLatency_.get());
+  if (cachedOutput_ != nullptr) {
+    // The task never starts.
+    if (numReplayedBatches_ == cachedOutput_->batches.size()) {
+      return nullptr;
+    }
+    const auto& buffer = cachedOutput_->batches[numReplayedBatches_++];
+    return resultCacheSerializer_->deserialize(const_cast<uint8_t*>(buffer->data()), buffer->size());
+  }
+  auto batch = nextFromTask();
+  if (outputToCache_ != nullptr) {
+    cacheOutput(batch);
+  }
+  return batch;
+}
+
+void WholeStageResultIterator::cacheOutput(const std::shared_ptr<ColumnarBatch>& batch) {
+  auto* cache = VeloxFragmentResultCache::instance();
+  if (batch == nullptr) {
+    collectMetrics();
+    outputToCache_->numMetrics = metrics_->numMetrics;
+    cache->put(resultCacheKey_, std::move(outputToCache_));
+    return;
+  }
+  auto buffer = resultCacheSerializer_->serializeColumnarBatches({batch});
+  outputToCache_->bytes += buffer->size();
+  if (outputToCache_->bytes > cache->maxEntryBytes()) {
+    outputToCache_ = nullptr;
+    return;
+  }
+  outputToCache_->batches.push_back(std::move(buffer));
+}
+
+std::shared_ptr<ColumnarBatch> WholeStageResultIterator::nextFromTask() {
   addSplits_(task_.get());
+  if (++numBatches_ % kScanStatsReportInterval == 0 && SplitPreloadController::instance()->enabled()) {
+    reportScanStats();
+  }
+  if (numDrivers_ > 1) {
+    if (!started_) {
+      velox::exec::Task::start(task_, numDrivers_);
+      outputQueue_->setNumProducers(task_->numOutputDrivers());
+      started_ = true;
+    }
+    velox::RowVectorPtr vector;
+    do {
+      vector = outputQueue_->dequeue();
+    } while (vector != nullptr && vector->size() == 0);
+    if (vector == nullptr) {
+      return nullptr;
+    }
+    return std::make_shared<VeloxColumnarBatch>(vector);
+  }
+
   if (task_->isFinished()) {
     return nullptr;
   }
-  velox::RowVectorPtr vector = task_->next();
+  velox::RowVectorPtr vector;
+  {
+    std::optional<CpuProfiler::Scope> profileScope;
+    if (cpuProfiler_ != nullptr) {
+      profileScope.emplace(cpuProfiler_.get(), cpuProfileTagId_);
+    }
+    vector = task_->next();
+  }
   if (vector == nullptr) {
     return nullptr;
   }
@@ -120,6 +539,7 @@ std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
 }
 
 int64_t WholeStageResultIterator::spillFixedSize(int64_t size) {
+  LatencyHistogram::Timer timer(spillLatency_.get());
   std::string poolName{pool_->root()->name() + "/" + pool_->name()};
   std::string logPrefix{"Spill[" + poolName + "]: "};
   LOG(INFO) << logPrefix << "Trying to reclaim " << size << " bytes of data...";
@@ -129,38 +549,98 @@ int64_t WholeStageResultIterator::spillFixedSize(int64_t size) {
   int64_t shrunk = pool_->shrinkManaged(pool_.get(), size);
   LOG(INFO) << logPrefix << shrunk << " bytes released from shrinking.";
 
-  // todo return the actual spilled size?
-  if (spillStrategy_ == "auto") {
+  if (spillStrategy_ == "auto" && shrunk < size) {
     int64_t remaining = size - shrunk;
     LOG(INFO) << logPrefix << "Trying to request spilling for remaining " << remaining << " bytes...";
-    // if we are on one of the driver of the spilled task, suspend it
-    velox::exec::Driver* thisDriver = nullptr;
-    task_->testingVisitDrivers([&](velox::exec::Driver* driver) {
-      if (driver->isOnThread()) {
-        thisDriver = driver;
-      }
-    });
-    if (thisDriver == nullptr) {
-      // not the driver, no need to suspend
-      uint64_t spilledOut = pool_->reclaim(remaining);
-      LOG(INFO) << logPrefix << "Successfully spilled out " << spilledOut << " bytes.";
-      uint64_t total = shrunk + spilledOut;
-      LOG(INFO) << logPrefix << "Successfully reclaimed total " << total << " bytes.";
-      return shrunk + spilledOut;
-    }
-    // suspend since we are on driver
-    velox::exec::SuspendedSection noCancel(thisDriver);
-    uint64_t spilledOut = pool_->reclaim(remaining);
+    uint64_t spilledOut = 0;
+    runSuspended([&]() { spilledOut = spillOperators(remaining); });
     LOG(INFO) << logPrefix << "Successfully spilled out " << spilledOut << " bytes.";
-    uint64_t total = shrunk + spilledOut;
-    LOG(INFO) << logPrefix << "Successfully reclaimed total " << total << " bytes.";
-    return shrunk + spilledOut;
+    // The spilled memory is only returned to Spark as the pool shrinks, which is what the caller can count on.
+    int64_t released = pool_->shrinkManaged(pool_.get(), remaining);
+    LOG(INFO) << logPrefix << released << " bytes released after spilling.";
+    LOG(INFO) << logPrefix << "Successfully reclaimed total " << shrunk + released << " bytes.";
+    return shrunk + released;
   }
 
   LOG(INFO) << logPrefix << "Successfully reclaimed total " << shrunk << " bytes.";
   return shrunk;
 }
 
+uint64_t WholeStageResultIterator::spillOperators(uint64_t targetBytes) {
+  if (!task_->isRunning()) {
+    return pool_->reclaim(targetBytes);
+  }
+  std::vector<SpillCandidate> candidates;
+  uint64_t spilledOut = 0;
+  {
+    // The operators can only be spilled while the drivers are paused. Resume them even if spilling throws.
+    task_->requestPause().wait();
+    SCOPE_EXIT {
+      velox::exec::Task::resume(task_);
+    };
+    collectSpillCandidates(pool_.get(), candidates);
+    for (const auto& victim : selectSpillVictims(candidates, targetBytes)) {
+      uint64_t spilled = victim.pool->reclaim(targetBytes - std::min(spilledOut, targetBytes));
+      LOG(INFO) << "Spill[" << pool_->name() << "]: spilled out " << spilled << " of " << victim.reclaimableBytes
+                << " reclaimable bytes from " << victim.pool->name() << ".";
+      spilledOut += spilled;
+      if (spilledOut >= targetBytes) {
+        break;
+      }
+    }
+  }
+  if (candidates.empty()) {
+    // No operator tells what it can free, leave it to the reclaimers of the task, which pause it themselves.
+    spilledOut = pool_->reclaim(targetBytes);
+  }
+  return spilledOut;
+}
+
+void WholeStageResultIterator::joinArbitration() {
+  if (getConfigValue(confMap_, kMemoryArbitration, "false") == "true") {
+    arbitrationEnabled_ = true;
+    ExecutorMemoryArbitrator::instance()->addParticipant(pool_.get(), this);
+  }
+}
+
+int64_t WholeStageResultIterator::reclaimableBytes() const {
+  return pool_->capacity();
+}
+
+int64_t WholeStageResultIterator::reclaimForOthers(int64_t size) {
+  LatencyHistogram::Timer timer(spillLatency_.get());
+  int64_t shrunk = pool_->shrinkManaged(pool_.get(), size);
+  if (shrunk >= size || spillStrategy_ != "auto" || !task_->isRunning()) {
+    return shrunk;
+  }
+  uint64_t spilledOut;
+  {
+    // The operators can only be spilled from another thread while the drivers are paused.
+    task_->requestPause().wait();
+    SCOPE_EXIT {
+      velox::exec::Task::resume(task_);
+    };
+    spilledOut = pool_->reclaim(size - shrunk);
+  }
+  LOG(INFO) << "Spill[" << pool_->name() << "]: spilled out " << spilledOut << " bytes for another task.";
+  return shrunk + pool_->shrinkManaged(pool_.get(), size - shrunk);
+}
+
+void WholeStageResultIterator::runSuspended(const std::function<void()>& fn) {
+  velox::exec::Driver* thisDriver = nullptr;
+  task_->testingVisitDrivers([&](velox::exec::Driver* driver) {
+    if (driver->isOnThread()) {
+      thisDriver = driver;
+    }
+  });
+  if (thisDriver == nullptr) {
+    fn();
+    return;
+  }
+  velox::exec::SuspendedSection noCancel(thisDriver);
+  fn();
+}
+
 void WholeStageResultIterator::getOrderedNodeIds(
     const std::shared_ptr<const velox::core::PlanNode>& planNode,
     std::vector<velox::core::PlanNodeId>& nodeIds) {
@@ -187,6 +667,11 @@ void WholeStageResultIterator::collectMetrics() {
     // The metrics has already been created.
     return;
   }
+  if (cachedOutput_ != nullptr) {
+    // The operators did nothing.
+    metrics_ = std::make_shared<Metrics>(cachedOutput_->numMetrics, kExtraRuntimeStats);
+    return;
+  }
 
   auto planStats = velox::exec::toPlanStats(task_->taskStats());
   // Calculate the total number of metrics.
@@ -209,7 +694,7 @@ void WholeStageResultIterator::collectMetrics() {
     numOfStats += planStats.at(nodeId).operatorStats.size();
   }
 
-  metrics_ = std::make_shared<Metrics>(numOfStats);
+  metrics_ = std::make_shared<Metrics>(numOfStats, kExtraRuntimeStats);
   int metricsIdx = 0;
   for (int idx = 0; idx < orderedNodeIds_.size(); idx++) {
     const auto& nodeId = orderedNodeIds_[idx];
@@ -222,39 +707,49 @@ void WholeStageResultIterator::collectMetrics() {
     const auto& status = planStats.at(nodeId);
     // Add each operator status into metrics.
     for (const auto& entry : status.operatorStats) {
-      metrics_->inputRows[metricsIdx] = entry.second->inputRows;
-      metrics_->inputVectors[metricsIdx] = entry.second->inputVectors;
-      metrics_->inputBytes[metricsIdx] = entry.second->inputBytes;
-      metrics_->rawInputRows[metricsIdx] = entry.second->rawInputRows;
-      metrics_->rawInputBytes[metricsIdx] = entry.second->rawInputBytes;
-      metrics_->outputRows[metricsIdx] = entry.second->outputRows;
-      metrics_->outputVectors[metricsIdx] = entry.second->outputVectors;
-      metrics_->outputBytes[metricsIdx] = entry.second->outputBytes;
-      metrics_->cpuCount[metricsIdx] = entry.second->cpuWallTiming.count;
-      metrics_->wallNanos[metricsIdx] = entry.second->cpuWallTiming.wallNanos;
-      metrics_->peakMemoryBytes[metricsIdx] = entry.second->peakMemoryBytes;
-      metrics_->numMemoryAllocations[metricsIdx] = entry.second->numMemoryAllocations;
-      metrics_->spilledBytes[metricsIdx] = entry.second->spilledBytes;
-      metrics_->spilledRows[metricsIdx] = entry.second->spilledRows;
-      metrics_->spilledPartitions[metricsIdx] = entry.second->spilledPartitions;
-      metrics_->spilledFiles[metricsIdx] = entry.second->spilledFiles;
-      metrics_->numDynamicFiltersProduced[metricsIdx] =
-          runtimeMetric("sum", entry.second->customStats, kDynamicFiltersProduced);
-      metrics_->numDynamicFiltersAccepted[metricsIdx] =
-          runtimeMetric("sum", entry.second->customStats, kDynamicFiltersAccepted);
-      metrics_->numReplacedWithDynamicFilterRows[metricsIdx] =
-          runtimeMetric("sum", entry.second->customStats, kReplacedWithDynamicFilterRows);
-      metrics_->flushRowCount[metricsIdx] = runtimeMetric("sum", entry.second->customStats, kFlushRowCount);
-      metrics_->scanTime[metricsIdx] = runtimeMetric("sum", entry.second->customStats, kTotalScanTime);
-      metrics_->skippedSplits[metricsIdx] = runtimeMetric("sum", entry.second->customStats, kSkippedSplits);
-      metrics_->processedSplits[metricsIdx] = runtimeMetric("sum", entry.second->customStats, kProcessedSplits);
-      metrics_->skippedStrides[metricsIdx] = runtimeMetric("sum", entry.second->customStats, kSkippedStrides);
-      metrics_->processedStrides[metricsIdx] = runtimeMetric("sum", entry.second->customStats, kProcessedStrides);
+      metrics_->at(metricsIdx, Metrics::kInputRows) = entry.second->inputRows;
+      metrics_->at(metricsIdx, Metrics::kInputVectors) = entry.second->inputVectors;
+      metrics_->at(metricsIdx, Metrics::kInputBytes) = entry.second->inputBytes;
+      metrics_->at(metricsIdx, Metrics::kRawInputRows) = entry.second->rawInputRows;
+      metrics_->at(metricsIdx, Metrics::kRawInputBytes) = entry.second->rawInputBytes;
+      metrics_->at(metricsIdx, Metrics::kOutputRows) = entry.second->outputRows;
+      metrics_->at(metricsIdx, Metrics::kOutputVectors) = entry.second->outputVectors;
+      metrics_->at(metricsIdx, Metrics::kOutputBytes) = entry.second->outputBytes;
+      metrics_->at(metricsIdx, Metrics::kCpuCount) = entry.second->cpuWallTiming.count;
+      metrics_->at(metricsIdx, Metrics::kWallNanos) = entry.second->cpuWallTiming.wallNanos;
+      metrics_->at(metricsIdx, Metrics::kPeakMemoryBytes) = entry.second->peakMemoryBytes;
+      metrics_->at(metricsIdx, Metrics::kNumMemoryAllocations) = entry.second->numMemoryAllocations;
+      metrics_->at(metricsIdx, Metrics::kSpilledBytes) = entry.second->spilledBytes;
+      metrics_->at(metricsIdx, Metrics::kSpilledRows) = entry.second->spilledRows;
+      metrics_->at(metricsIdx, Metrics::kSpilledPartitions) = entry.second->spilledPartitions;
+      metrics_->at(metricsIdx, Metrics::kSpilledFiles) = entry.second->spilledFiles;
+      for (const auto& [counter, name] : kRuntimeStatCounters) {
+        metrics_->at(metricsIdx, counter) = runtimeMetric("sum", entry.second->customStats, name);
+      }
+      for (size_t i = 0; i < kExtraRuntimeStats.size(); ++i) {
+        metrics_->at(metricsIdx, Metrics::kNumCounters + i) =
+            runtimeMetric("sum", entry.second->customStats, kExtraRuntimeStats[i]);
+      }
       metricsIdx += 1;
     }
   }
 }
 
+void WholeStageResultIterator::reportScanStats() {
+  auto planStats = velox::exec::toPlanStats(task_->taskStats());
+  for (const auto& [nodeId, nodeStats] : planStats) {
+    auto it = nodeStats.operatorStats.find("TableScan");
+    if (it == nodeStats.operatorStats.end()) {
+      continue;
+    }
+    int64_t ioWaitNanos = runtimeMetric("sum", it->second->customStats, kQueryThreadIoLatency);
+    int64_t wallNanos = it->second->cpuWallTiming.wallNanos;
+    auto& reported = reportedScanStats_[nodeId];
+    SplitPreloadController::instance()->report(ioWaitNanos - reported.first, wallNanos - reported.second);
+    reported = {ioWaitNanos, wallNanos};
+  }
+}
+
 int64_t WholeStageResultIterator::runtimeMetric(
     const std::string& metricType,
     const std::unordered_map<std::string, velox::RuntimeMetric>& runtimeStats,
@@ -297,7 +792,12 @@ std::unordered_map<std::string, std::string> WholeStageResultIterator::getQueryC
     auto maxMemory =
         (long)(0.75 * (double)std::stol(getConfigValue(confMap_, kSparkTaskOffHeapMemory, std::to_string(facebook::velox::memory::kMaxMemory))));
     configs[velox::core::QueryConfig::kMaxPartialAggregationMemory] = std::to_string(maxMemory);
-    configs[velox::core::QueryConfig::kAbandonPartialAggregationMinPct] = std::to_string(90);
+    // A partial aggregation whose output is still over minPct% of its input after minRows input rows passes its
+    // input through to the shuffle as single-row groups rather than growing its hash table.
+    configs[velox::core::QueryConfig::kAbandonPartialAggregationMinRows] =
+        getConfigValue(confMap_, kAbandonPartialAggregationMinRows, "100000");
+    configs[velox::core::QueryConfig::kAbandonPartialAggregationMinPct] =
+        getConfigValue(confMap_, kAbandonPartialAggregationMinPct, "90");
     // Spill configs
     if (spillStrategy_ == "none") {
       configs[velox::core::QueryConfig::kSpillEnabled] = "false";
@@ -314,14 +814,30 @@ std::unordered_map<std::string, std::string> WholeStageResultIterator::getQueryC
         getConfigValue(confMap_, kJoinSpillMemoryThreshold, "0"); // spill only when input doesn't fit
     configs[velox::core::QueryConfig::kOrderBySpillMemoryThreshold] =
         getConfigValue(confMap_, kOrderBySpillMemoryThreshold, "0"); // spill only when input doesn't fit
-    configs[velox::core::QueryConfig::kMaxSpillLevel] = getConfigValue(confMap_, kMaxSpillLevel, "4");
+    // With spillPartitionBits "auto", the fan-out follows the input of the scans and the memory of the task, so that
+    // a small stage doesn't spill into many tiny files and a large one doesn't run out of spill levels.
+    auto spillPartitionBits = getConfigValue(confMap_, kSpillPartitionBits, "auto");
+    auto maxSpillLevel = std::stoi(getConfigValue(confMap_, kMaxSpillLevel, "4"));
+    if (spillPartitionBits == "auto") {
+      const auto memoryBudget = std::stoull(getConfigValue(confMap_, kSparkTaskOffHeapMemory, "0"));
+      if (estimatedInputBytes_ > 0 && memoryBudget > 0 && memoryBudget < velox::memory::kMaxMemory) {
+        const auto [bits, numLevels] = adaptiveSpillPartitioning(estimatedInputBytes_, memoryBudget);
+        spillPartitionBits = std::to_string(bits);
+        if (confMap_.find(kMaxSpillLevel) == confMap_.end()) {
+          maxSpillLevel = std::max(maxSpillLevel, numLevels);
+        }
+      } else {
+        spillPartitionBits = "2";
+      }
+    }
+    configs[velox::core::QueryConfig::kMaxSpillLevel] = std::to_string(maxSpillLevel);
     configs[velox::core::QueryConfig::kMaxSpillFileSize] =
         getConfigValue(confMap_, kMaxSpillFileSize, std::to_string(20L * 1024 * 1024));
     configs[velox::core::QueryConfig::kMinSpillRunSize] =
         getConfigValue(confMap_, kMinSpillRunSize, std::to_string(256 << 20));
     configs[velox::core::QueryConfig::kSpillStartPartitionBit] =
         getConfigValue(confMap_, kSpillStartPartitionBit, "29");
-    configs[velox::core::QueryConfig::kSpillPartitionBits] = getConfigValue(confMap_, kSpillPartitionBits, "2");
+    configs[velox::core::QueryConfig::kSpillPartitionBits] = spillPartitionBits;
     configs[velox::core::QueryConfig::kSpillableReservationGrowthPct] =
         getConfigValue(confMap_, kSpillableReservationGrowthPct, "25");
   } catch (const std::invalid_argument& err) {
@@ -374,6 +890,20 @@ WholeStageResultIteratorFirstStage::WholeStageResultIteratorFirstStage(
     throw std::runtime_error("Invalid scan information.");
   }
 
+  std::vector<std::string> scannedPaths;
+  std::vector<uint64_t> scannedLengths;
+  for (const auto& scanInfo : scanInfos) {
+    scannedPaths.insert(scannedPaths.end(), scanInfo->paths.begin(), scanInfo->paths.end());
+    scannedLengths.insert(scannedLengths.end(), scanInfo->lengths.begin(), scanInfo->lengths.end());
+  }
+  useCache_ = CacheAdmissionPolicy::instance()->admit(
+      CacheAdmissionPolicy::parseMode(getConfigValue(confMap_, kCacheAdmission, kCacheAdmissionDefault)),
+      scannedPaths,
+      scannedLengths);
+  estimatedInputBytes_ = std::accumulate(scannedLengths.begin(), scannedLengths.end(), uint64_t{0});
+
+  auto* cachedFileTracker = CachedFileTracker::instance();
+  bool trackCachedFiles = useCache_ && cachedFileTracker->enabled();
   for (const auto& scanInfo : scanInfos) {
     // Get the information for TableScan.
     // Partition index in scan info is not used.
@@ -392,6 +922,9 @@ WholeStageResultIteratorFirstStage::WholeStageResultIteratorFirstStage(
       auto split = std::make_shared<velox::connector::hive::HiveConnectorSplit>(
           kHiveConnectorId, paths[idx], format, starts[idx], lengths[idx], partitionKeys);
       connectorSplits.emplace_back(split);
+      if (trackCachedFiles) {
+        cachedFileTracker->record(paths[idx]);
+      }
     }
 
     std::vector<velox::exec::Split> scanSplits;
@@ -404,24 +937,14 @@ WholeStageResultIteratorFirstStage::WholeStageResultIteratorFirstStage(
     splits_.emplace_back(scanSplits);
   }
 
-  // Set task parameters.
-  std::unordered_set<velox::core::PlanNodeId> emptySet;
-  velox::core::PlanFragment planFragment{planNode, velox::core::ExecutionStrategy::kUngrouped, 1, emptySet};
-  std::shared_ptr<velox::core::QueryCtx> queryCtx = createNewVeloxQueryCtx();
-
-  task_ = velox::exec::Task::create(
-      fmt::format("Gluten stage-{} task-{}", taskInfo.stageId, taskInfo.taskId),
-      std::move(planFragment),
-      0,
-      std::move(queryCtx));
-
-  if (!task_->supportsSingleThreadedExecution()) {
-    throw std::runtime_error("Task doesn't support single thread execution: " + planNode->toString());
-  }
+  // The drivers of a multi-driver task pull the splits of the scans from the shared split queues of the task.
+  createTask(taskInfo, planNode, numDriversFor(planNode));
   auto fileSystem = velox::filesystems::getFileSystem(spillDir, nullptr);
   GLUTEN_CHECK(fileSystem != nullptr, "File System for spilling is null!");
   fileSystem->mkdir(spillDir);
   task_->setSpillDirectory(spillDir);
+  enableCpuProfile(taskInfo, spillDir);
+  joinArbitration();
   addSplits_ = [&](velox::exec::Task* task) {
     if (noMoreSplits_) {
       return;
@@ -461,23 +984,14 @@ WholeStageResultIteratorMiddleStage::WholeStageResultIteratorMiddleStage(
     const std::unordered_map<std::string, std::string>& confMap,
     const SparkTaskInfo taskInfo)
     : WholeStageResultIterator(pool, planNode, confMap), streamIds_(streamIds) {
-  std::unordered_set<velox::core::PlanNodeId> emptySet;
-  velox::core::PlanFragment planFragment{planNode, velox::core::ExecutionStrategy::kUngrouped, 1, emptySet};
-  std::shared_ptr<velox::core::QueryCtx> queryCtx = createNewVeloxQueryCtx();
-
-  task_ = velox::exec::Task::create(
-      fmt::format("Gluten stage-{} task-{}", taskInfo.stageId, taskInfo.taskId),
-      std::move(planFragment),
-      0,
-      std::move(queryCtx));
-
-  if (!task_->supportsSingleThreadedExecution()) {
-    throw std::runtime_error("Task doesn't support single thread execution: " + planNode->toString());
-  }
+  // The input streams can't be shared by multiple drivers.
+  createTask(taskInfo, planNode, 1);
   auto fileSystem = velox::filesystems::getFileSystem(spillDir, nullptr);
   GLUTEN_CHECK(fileSystem != nullptr, "File System for spilling is null!");
   fileSystem->mkdir(spillDir);
   task_->setSpillDirectory(spillDir);
+  enableCpuProfile(taskInfo, spillDir);
+  joinArbitration();
   addSplits_ = [&](velox::exec::Task* task) {
     if (noMoreSplits_) {
       return;
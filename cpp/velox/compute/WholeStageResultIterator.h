@@ -17,17 +17,61 @@
 #pragma once
 
 #include "compute/Backend.h"
+#include "compute/VeloxFragmentResultCache.h"
 #include "memory/ColumnarBatchIterator.h"
+#include "memory/ExecutorMemoryArbitrator.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "operators/serializer/VeloxColumnarBatchSerializer.h"
 #include "substrait/SubstraitToVeloxPlan.h"
 #include "substrait/plan.pb.h"
+#include "utils/CpuProfiler.h"
+#include "utils/LatencyHistogram.h"
 #include "utils/metrics.h"
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Task.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 namespace gluten {
 
-class WholeStageResultIterator : public ColumnarBatchIterator {
+/// Merges the output of the drivers of a multi-driver task into a single stream. A driver is blocked while the queue
+/// holds maxSize vectors or more.
+class DriverOutputQueue {
+ public:
+  explicit DriverOutputQueue(int32_t maxSize);
+
+  /// Number of drivers feeding the queue, each signalling its end with a null vector.
+  void setNumProducers(int32_t numProducers);
+
+  /// The consumer of the task.
+  facebook::velox::exec::BlockingReason enqueue(
+      facebook::velox::RowVectorPtr vector,
+      facebook::velox::ContinueFuture* future);
+
+  /// Blocks until a vector is available. Returns null once all the producers are done, or rethrows the error of the
+  /// task.
+  facebook::velox::RowVectorPtr dequeue();
+
+  /// Unblocks the producers and drops their further output.
+  void close(std::exception_ptr error = nullptr);
+
+ private:
+  std::vector<facebook::velox::ContinuePromise> takePromisesLocked();
+
+  const size_t maxSize_;
+  std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::deque<facebook::velox::RowVectorPtr> queue_;
+  std::vector<facebook::velox::ContinuePromise> producerPromises_;
+  int32_t numProducers_ = -1;
+  int32_t numFinishedProducers_ = 0;
+  bool closed_ = false;
+  std::exception_ptr error_;
+};
+
+class WholeStageResultIterator : public ColumnarBatchIterator, public ArbitrationParticipant {
  public:
   WholeStageResultIterator(
       std::shared_ptr<facebook::velox::memory::MemoryPool> pool,
@@ -35,19 +79,45 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
       const std::unordered_map<std::string, std::string>& confMap);
 
   virtual ~WholeStageResultIterator() {
+    if (outputQueue_ != nullptr) {
+      outputQueue_->close();
+    }
+    if (arbitrationEnabled_) {
+      ExecutorMemoryArbitrator::instance()->removeParticipant(pool_.get());
+    }
     if (task_ != nullptr && task_->isRunning()) {
       // calling .wait() may take no effect in single thread execution mode
       task_->requestCancel().wait();
     }
+    if (cpuProfiler_ != nullptr) {
+      writeCpuProfile();
+    }
   };
 
   std::shared_ptr<ColumnarBatch> next() override;
 
+  /// Replays the output cached under key instead of running the task, or caches the output of the task under key once
+  /// it's done.
+  void useResultCache(std::string key);
+
   int64_t spillFixedSize(int64_t size) override;
 
+  int64_t reclaimableBytes() const override;
+
+  int64_t reclaimForOthers(int64_t size) override;
+
+  void runSuspended(const std::function<void()>& fn) override;
+
   std::shared_ptr<Metrics> getMetrics(int64_t exportNanos) {
     collectMetrics();
     metrics_->veloxToArrow = exportNanos;
+    metrics_->arbitrationWaitNanos = ExecutorMemoryArbitrator::instance()->waitNanos(pool_.get());
+    if (nextLatency_ != nullptr) {
+      metrics_->taskValues.clear();
+      metrics_->addLatencies("nextLatency", *nextLatency_);
+      metrics_->addLatencies("inputWaitLatency", *inputWaitLatency_);
+      metrics_->addLatencies("spillLatency", *spillLatency_);
+    }
     return metrics_;
   }
 
@@ -60,11 +130,35 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
   std::shared_ptr<const facebook::velox::core::PlanNode> veloxPlan_;
 
  protected:
-  std::shared_ptr<facebook::velox::core::QueryCtx> createNewVeloxQueryCtx();
+  std::shared_ptr<facebook::velox::core::QueryCtx> createNewVeloxQueryCtx(folly::Executor* executor = nullptr);
+
+  /// Creates task_ to run the plan with numDrivers drivers per pipeline. With more than one driver the task runs on a
+  /// shared executor, and the output of its drivers is merged into the result stream.
+  void createTask(
+      const SparkTaskInfo& taskInfo,
+      const std::shared_ptr<const facebook::velox::core::PlanNode>& planNode,
+      int32_t numDrivers);
+
+  /// Number of drivers of the task to be created, 1 if the plan can't run with multiple drivers or VeloxInitializer has
+  /// no driver executor.
+  int32_t numDriversFor(const std::shared_ptr<const facebook::velox::core::PlanNode>& planNode);
+
+  /// Let the ExecutorMemoryArbitrator reclaim from this task on behalf of others, once task_ is created.
+  void joinArbitration();
+
+  /// Sample the stacks of task_->next() if configured, to be written as folded stacks next to the spill directory
+  /// when the iterator is destroyed.
+  void enableCpuProfile(const SparkTaskInfo& taskInfo, const std::string& spillDir);
 
   /// A map of custom configs.
   std::unordered_map<std::string, std::string> confMap_;
 
+  /// Whether the scans of the task read through AsyncDataCache, as CacheAdmissionPolicy decides.
+  bool useCache_ = true;
+
+  /// Bytes the scans of the task read, 0 if unknown, e.g. for the shuffle input of a middle stage.
+  uint64_t estimatedInputBytes_ = 0;
+
  private:
   /// Get the Spark confs to Velox query context.
   std::unordered_map<std::string, std::string> getQueryContextConf();
@@ -82,6 +176,24 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
   /// Collect Velox metrics.
   void collectMetrics();
 
+  std::shared_ptr<ColumnarBatch> nextFromTask();
+
+  /// Adds a batch of the output of the task to the entry to cache, or sets the entry in VeloxFragmentResultCache once
+  /// the batch is null.
+  void cacheOutput(const std::shared_ptr<ColumnarBatch>& batch);
+
+  /// Spill the operators that free targetBytes at the lowest cost, e.g. an order by before a join build. Returns the
+  /// bytes spilled out. Called with the current driver suspended, if any.
+  uint64_t spillOperators(uint64_t targetBytes);
+
+  void writeCpuProfile();
+
+  /// Let the input streams of the plan record their waits into inputWaitLatency_.
+  void trackInputWait(const std::shared_ptr<const facebook::velox::core::PlanNode>& planNode);
+
+  /// Report the I/O wait and wall time of the scan nodes since the previous report to the SplitPreloadController.
+  void reportScanStats();
+
   /// Return a certain type of runtime metric. Supported metric types are: sum, count, min, max.
   int64_t runtimeMetric(
       const std::string& metricType,
@@ -93,13 +205,42 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
   // spill
   std::string spillStrategy_;
 
+  bool arbitrationEnabled_ = false;
+
   std::shared_ptr<Metrics> metrics_ = nullptr;
 
+  int32_t numDrivers_ = 1;
+
+  int64_t numBatches_ = 0;
+  /// I/O wait and wall nanos of each scan node at the previous report.
+  std::unordered_map<facebook::velox::core::PlanNodeId, std::pair<int64_t, int64_t>> reportedScanStats_;
+  bool started_ = false;
+  std::shared_ptr<DriverOutputQueue> outputQueue_;
+
+  std::unique_ptr<CpuProfiler> cpuProfiler_;
+  int32_t cpuProfileTagId_ = 0;
+  std::string cpuProfilePath_;
+
+  /// Null unless latency histograms are enabled.
+  std::unique_ptr<LatencyHistogram> nextLatency_;
+  std::unique_ptr<LatencyHistogram> spillLatency_;
+  std::shared_ptr<LatencyHistogram> inputWaitLatency_;
+
   /// All the children plan node ids with postorder traversal.
   std::vector<facebook::velox::core::PlanNodeId> orderedNodeIds_;
 
   /// Node ids should be ommited in metrics.
   std::unordered_set<facebook::velox::core::PlanNodeId> omittedNodeIds_;
+
+  /// Set if the output is replayed from VeloxFragmentResultCache.
+  std::shared_ptr<const VeloxFragmentResultCache::Entry> cachedOutput_;
+  size_t numReplayedBatches_ = 0;
+  /// Set while the output of the task is to be cached under resultCacheKey_, reset once over the size of an entry.
+  std::shared_ptr<VeloxFragmentResultCache::Entry> outputToCache_;
+  std::string resultCacheKey_;
+  /// Serializes the output to cache, and deserializes the replayed one into the pool of the task.
+  std::shared_ptr<facebook::velox::memory::MemoryPool> resultCachePool_;
+  std::unique_ptr<VeloxColumnarBatchSerializer> resultCacheSerializer_;
 };
 
 class WholeStageResultIteratorFirstStage final : public WholeStageResultIterator {
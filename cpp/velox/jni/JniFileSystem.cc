@@ -18,12 +18,23 @@
 #include "JniFileSystem.h"
 #include "jni/JniCommon.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#include "velox/buffer/Buffer.h"
+
 namespace {
 constexpr std::string_view kJniFsScheme("jni:");
 constexpr std::string_view kJolFsScheme("jol:");
 
 JavaVM* vm;
 
+// Writes the chunks of the JniWriteFiles in the background if set.
+folly::Executor* writeExecutor = nullptr;
+
 jclass jniFileSystemClass;
 jclass jniReadFileClass;
 jclass jniWriteFileClass;
@@ -40,6 +51,7 @@ jmethodID jniFileSystemMkdir;
 jmethodID jniFileSystemRmdir;
 
 jmethodID jniReadFilePread;
+jmethodID jniReadFilePreadv;
 jmethodID jniReadFileShouldCoalesce;
 jmethodID jniReadFileSize;
 jmethodID jniReadFileMemoryUsage;
@@ -93,6 +105,42 @@ class JniReadFile : public facebook::velox::ReadFile {
     return std::string_view(reinterpret_cast<const char*>(buf));
   }
 
+  // Reads the ranges of a coalesced read in one JNI call. Buffers without data are the gaps between the ranges.
+  uint64_t preadv(uint64_t offset, const std::vector<folly::Range<char*>>& buffers) const override {
+    std::vector<jlong> offsets;
+    std::vector<jlong> lengths;
+    std::vector<jlong> addresses;
+    uint64_t position = offset;
+    for (const auto& buffer : buffers) {
+      if (buffer.data() != nullptr && !buffer.empty()) {
+        offsets.push_back(static_cast<jlong>(position));
+        lengths.push_back(static_cast<jlong>(buffer.size()));
+        addresses.push_back(reinterpret_cast<jlong>(buffer.data()));
+      }
+      position += buffer.size();
+    }
+    if (offsets.size() == 1) {
+      pread(offsets[0], lengths[0], reinterpret_cast<void*>(addresses[0]));
+    } else if (!offsets.empty()) {
+      JNIEnv* env;
+      attachCurrentThreadAsDaemonOrThrow(vm, &env);
+      auto toJArray = [&](const std::vector<jlong>& values) {
+        jlongArray array = env->NewLongArray(values.size());
+        env->SetLongArrayRegion(array, 0, values.size(), values.data());
+        return array;
+      };
+      jlongArray jOffsets = toJArray(offsets);
+      jlongArray jLengths = toJArray(lengths);
+      jlongArray jAddresses = toJArray(addresses);
+      env->CallVoidMethod(obj_, jniReadFilePreadv, jOffsets, jLengths, jAddresses);
+      env->DeleteLocalRef(jOffsets);
+      env->DeleteLocalRef(jLengths);
+      env->DeleteLocalRef(jAddresses);
+      checkException(env);
+    }
+    return position - offset;
+  }
+
   bool shouldCoalesce() const override {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
@@ -140,9 +188,18 @@ class JniReadFile : public facebook::velox::ReadFile {
   jobject obj_;
 };
 
+// Appends are copied into chunks of kChunkSize, so that the writer doesn't make a JNI call per small append. The chunks
+// are allocated from the memory pool the file is opened with, and without one, appends go straight to the Java file.
+// With an executor, full chunks are written to the Java file in order by a task on it, so that the writer doesn't wait
+// for the Java stream, e.g. on the acks of an HDFS pipeline. Up to kMaxPendingChunks full chunks wait to be written
+// before append blocks. An error of a background write is rethrown by the next call.
 class JniWriteFile : public facebook::velox::WriteFile {
  public:
-  explicit JniWriteFile(jobject obj) {
+  static constexpr size_t kChunkSize = 4 << 20;
+  static constexpr size_t kMaxPendingChunks = 2;
+
+  JniWriteFile(jobject obj, facebook::velox::memory::MemoryPool* pool, folly::Executor* executor)
+      : pool_(pool), executor_(executor) {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
     obj_ = env->NewGlobalRef(obj);
@@ -151,10 +208,11 @@ class JniWriteFile : public facebook::velox::WriteFile {
 
   ~JniWriteFile() override {
     try {
-      close0();
+      close();
     } catch (const std::exception& e) {
       LOG(WARNING) << "Error closing jni write file " << e.what();
     }
+    waitForWriter();
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
     env->DeleteGlobalRef(obj_);
@@ -162,15 +220,31 @@ class JniWriteFile : public facebook::velox::WriteFile {
   }
 
   void append(std::string_view data) override {
-    JNIEnv* env;
-    attachCurrentThreadAsDaemonOrThrow(vm, &env);
-    const void* bytes = data.data();
-    unsigned long len = data.size();
-    env->CallVoidMethod(obj_, jniWriteFileAppend, static_cast<jlong>(len), reinterpret_cast<jlong>(bytes));
-    checkException(env);
+    GLUTEN_CHECK(!closed_, "JniWriteFile::append: file is closed");
+    size_ += data.size();
+    if (pool_ == nullptr) {
+      append0(data);
+      return;
+    }
+    while (!data.empty()) {
+      if (chunk_ == nullptr) {
+        chunk_ = facebook::velox::AlignedBuffer::allocate<char>(kChunkSize, pool_);
+        chunk_->setSize(0);
+      }
+      auto length = std::min(data.size(), kChunkSize - chunk_->size());
+      std::memcpy(chunk_->asMutable<char>() + chunk_->size(), data.data(), length);
+      chunk_->setSize(chunk_->size() + length);
+      data.remove_prefix(length);
+      if (chunk_->size() == kChunkSize) {
+        submitChunk();
+      }
+    }
   }
 
+  // Flushes the Java file once the chunks appended before are written to it.
   void flush() override {
+    GLUTEN_CHECK(!closed_, "JniWriteFile::flush: file is closed");
+    drain();
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
     env->CallVoidMethod(obj_, jniWriteFileFlush);
@@ -178,18 +252,112 @@ class JniWriteFile : public facebook::velox::WriteFile {
   }
 
   void close() override {
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    // The Java file is closed also if a write failed.
+    std::exception_ptr error;
+    try {
+      drain();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    waitForWriter();
+    chunk_.reset();
     close0();
+    if (error) {
+      std::rethrow_exception(error);
+    }
   }
 
+  // Of the appends, written or not.
   uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  void submitChunk() {
+    if (executor_ == nullptr) {
+      append0(std::string_view(chunk_->as<char>(), chunk_->size()));
+      chunk_->setSize(0);
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [this] { return error_ || pending_.size() < kMaxPendingChunks; });
+    rethrowLocked();
+    pending_.push_back(std::move(chunk_));
+    if (!writing_) {
+      writing_ = true;
+      executor_->add([this] { writePending(); });
+    }
+  }
+
+  // Waits until the chunks appended so far are written to the Java file.
+  void drain() {
+    if (chunk_ != nullptr && chunk_->size() > 0) {
+      submitChunk();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [this] { return error_ || pending_.empty(); });
+    rethrowLocked();
+  }
+
+  void rethrowLocked() {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  void waitForWriter() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [this] { return !writing_; });
+  }
+
+  // Runs on the executor until no chunk is pending, so that the chunks of a file are written in order by one task at
+  // a time.
+  void writePending() {
+    while (true) {
+      const facebook::velox::Buffer* chunk;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) {
+          writing_ = false;
+          // Notified under the lock, as the file may be destroyed as soon as it is released.
+          notFull_.notify_all();
+          return;
+        }
+        // Stays pending until written, to bound the chunks held.
+        chunk = pending_.front().get();
+      }
+      std::exception_ptr error;
+      try {
+        append0(std::string_view(chunk->as<char>(), chunk->size()));
+      } catch (...) {
+        error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error) {
+          // The chunks after a failed one aren't written.
+          error_ = error;
+          pending_.clear();
+        } else {
+          pending_.pop_front();
+        }
+      }
+      notFull_.notify_all();
+    }
+  }
+
+  void append0(std::string_view data) {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
-    jlong out = env->CallLongMethod(obj_, jniWriteFileSize);
+    env->CallVoidMethod(
+        obj_, jniWriteFileAppend, static_cast<jlong>(data.size()), reinterpret_cast<jlong>(data.data()));
     checkException(env);
-    return static_cast<uint64_t>(out);
   }
 
- private:
   void close0() {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
@@ -198,6 +366,20 @@ class JniWriteFile : public facebook::velox::WriteFile {
   }
 
   jobject obj_;
+  facebook::velox::memory::MemoryPool* const pool_;
+  folly::Executor* const executor_;
+  // Being appended to, on the caller thread.
+  facebook::velox::BufferPtr chunk_;
+  uint64_t size_ = 0;
+  bool closed_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable notFull_;
+  // Full chunks in order, the front one being written.
+  std::deque<facebook::velox::BufferPtr> pending_;
+  std::exception_ptr error_;
+  // Whether a writePending task is scheduled or running.
+  bool writing_ = false;
 };
 
 // Convert "xxx:/a/b/c" to "/a/b/c". Probably it's Velox's job to remove the protocol when calling the member
@@ -302,7 +484,7 @@ class JniFileSystem : public facebook::velox::filesystems::FileSystem {
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm, &env);
     jobject obj = env->CallObjectMethod(obj_, jniFileSystemOpenFileForWrite, createJString(env, path));
-    auto out = std::make_unique<JniWriteFile>(obj);
+    auto out = std::make_unique<JniWriteFile>(obj, options.pool, writeExecutor);
     checkException(env);
     return out;
   }
@@ -417,6 +599,7 @@ void gluten::initVeloxJniFileSystem(JNIEnv* env) {
 
   // methods in JniFilesystem$ReadFile
   jniReadFilePread = getMethodIdOrError(env, jniReadFileClass, "pread", "(JJJ)V");
+  jniReadFilePreadv = getMethodIdOrError(env, jniReadFileClass, "preadv", "([J[J[J)V");
   jniReadFileShouldCoalesce = getMethodIdOrError(env, jniReadFileClass, "shouldCoalesce", "()Z");
   jniReadFileSize = getMethodIdOrError(env, jniReadFileClass, "size", "()J");
   jniReadFileMemoryUsage = getMethodIdOrError(env, jniReadFileClass, "memoryUsage", "()J");
@@ -441,8 +624,9 @@ void gluten::finalizeVeloxJniFileSystem(JNIEnv* env) {
 // "jol" stands for letting Gluten choose between jni fs and local fs.
 // This doesn't implement facebook::velox::filesystems::FileSystem since it just
 // act as a entry-side router to create JniFilesystem and LocalFilesystem
-void gluten::registerJolFileSystem(uint64_t maxFileSize) {
+void gluten::registerJolFileSystem(uint64_t maxFileSize, folly::Executor* executor) {
   GLUTEN_CHECK(maxFileSize > 0, "Unexpected max file size for jol fs: " + std::to_string(maxFileSize));
+  writeExecutor = executor;
 
   auto JolSchemeMatcher = [](std::string_view filePath) { return filePath.find(kJolFsScheme) == 0; };
 
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <jni.h>
 
 #include "velox/common/file/File.h"
@@ -27,7 +28,8 @@ namespace gluten {
 // Register JNI-or-local (or JVM-over-local, as long as it describes what happens here)
 //   file system. maxFileSize is necessary (!= 0) because we use this size to decide
 //   whether a new file can fit in JVM heap, otherwise we write it via local fs directly.
-void registerJolFileSystem(uint64_t maxFileSize);
+// The JNI files write their buffered appends on executor, or on the caller thread if it's null.
+void registerJolFileSystem(uint64_t maxFileSize, folly::Executor* executor = nullptr);
 
 void initVeloxJniFileSystem(JNIEnv* env);
 
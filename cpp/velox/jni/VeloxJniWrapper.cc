@@ -22,6 +22,7 @@
 #include <jni/JniCommon.h>
 #include <exception>
 #include "JniUdf.h"
+#include "compute/CachedFileTracker.h"
 #include "compute/VeloxBackend.h"
 #include "compute/VeloxInitializer.h"
 #include "config/GlutenConfig.h"
@@ -93,6 +94,30 @@ JNIEXPORT void JNICALL Java_io_glutenproject_udf_UdfJniWrapper_nativeLoadUdfLibr
   JNI_METHOD_END()
 }
 
+JNIEXPORT jobjectArray JNICALL Java_io_glutenproject_cache_CacheJniWrapper_nativeCachedFiles( // NOLINT
+    JNIEnv* env,
+    jobject obj) {
+  JNI_METHOD_START
+  auto files = gluten::CachedFileTracker::instance()->files();
+  auto stringClass = env->FindClass("java/lang/String");
+  auto cachedFiles = env->NewObjectArray(files.size(), stringClass, nullptr);
+  for (size_t i = 0; i < files.size(); ++i) {
+    auto file = env->NewStringUTF(files[i].c_str());
+    env->SetObjectArrayElement(cachedFiles, i, file);
+    env->DeleteLocalRef(file);
+  }
+  return cachedFiles;
+  JNI_METHOD_END(nullptr)
+}
+
+JNIEXPORT jlong JNICALL Java_io_glutenproject_cache_CacheJniWrapper_nativeCachedFilesVersion( // NOLINT
+    JNIEnv* env,
+    jobject obj) {
+  JNI_METHOD_START
+  return gluten::CachedFileTracker::instance()->version();
+  JNI_METHOD_END(-1L)
+}
+
 JNIEXPORT jobject JNICALL
 Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeValidateWithFailureReason( // NOLINT
     JNIEnv* env,
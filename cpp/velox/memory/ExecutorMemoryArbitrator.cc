@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ExecutorMemoryArbitrator.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace facebook;
+
+namespace gluten {
+
+ExecutorMemoryArbitrator* ExecutorMemoryArbitrator::instance() {
+  static ExecutorMemoryArbitrator arbitrator;
+  return &arbitrator;
+}
+
+void ExecutorMemoryArbitrator::addParticipant(velox::memory::MemoryPool* root, ArbitrationParticipant* participant) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  participants_[root] = {participant, 0};
+}
+
+void ExecutorMemoryArbitrator::removeParticipant(velox::memory::MemoryPool* root) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  participants_.erase(root);
+}
+
+int64_t ExecutorMemoryArbitrator::arbitrate(velox::memory::MemoryPool* requestor, int64_t size) {
+  ArbitrationParticipant* self = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = participants_.find(requestor);
+    if (it != participants_.end()) {
+      self = it->second.participant;
+    }
+    if (participants_.size() <= (self ? 1 : 0)) {
+      return 0;
+    }
+  }
+
+  int64_t freed = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto doArbitrate = [&]() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    freed = reclaimLocked(requestor, size);
+    numArbitrations_++;
+    reclaimedBytes_ += freed;
+    auto it = participants_.find(requestor);
+    if (it != participants_.end()) {
+      it->second.waitNanos +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+  };
+  if (self) {
+    // Another arbitration may be pausing this task while we wait for the lock.
+    self->runSuspended(doArbitrate);
+  } else {
+    doArbitrate();
+  }
+  LOG(INFO) << "Arbitration for " << requestor->name() << " freed " << freed << "/" << size
+            << " bytes from other tasks.";
+  return freed;
+}
+
+int64_t ExecutorMemoryArbitrator::reclaimLocked(velox::memory::MemoryPool* requestor, int64_t size) {
+  std::vector<std::pair<int64_t, ArbitrationParticipant*>> candidates;
+  for (auto& [root, entry] : participants_) {
+    if (root != requestor) {
+      candidates.emplace_back(entry.participant->reclaimableBytes(), entry.participant);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  int64_t freed = 0;
+  for (auto& [bytes, participant] : candidates) {
+    if (freed >= size) {
+      break;
+    }
+    if (bytes <= 0) {
+      continue;
+    }
+    try {
+      freed += participant->reclaimForOthers(size - freed);
+    } catch (const std::exception& e) {
+      // E.g. the task is being cancelled. Try the next one.
+      LOG(WARNING) << "Failed to reclaim memory from another task: " << e.what();
+    }
+  }
+  return freed;
+}
+
+int64_t ExecutorMemoryArbitrator::waitNanos(velox::memory::MemoryPool* root) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = participants_.find(root);
+  return it == participants_.end() ? 0 : it->second.waitNanos;
+}
+
+int64_t ExecutorMemoryArbitrator::numArbitrations() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numArbitrations_;
+}
+
+int64_t ExecutorMemoryArbitrator::reclaimedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reclaimedBytes_;
+}
+
+} // namespace gluten
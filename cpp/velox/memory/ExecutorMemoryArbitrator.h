@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "velox/common/memory/Memory.h"
+
+namespace gluten {
+
+// A Velox task of the executor whose memory can be reclaimed on behalf of other tasks.
+class ArbitrationParticipant {
+ public:
+  virtual ~ArbitrationParticipant() = default;
+
+  // Bytes currently charged to Spark for this participant.
+  virtual int64_t reclaimableBytes() const = 0;
+
+  // Frees up to size bytes, spilling if needed. Called from the thread of another task.
+  virtual int64_t reclaimForOthers(int64_t size) = 0;
+
+  // Runs fn with the driver of this participant on the calling thread suspended, if any, so that the participant can
+  // be paused by the arbitrations of other threads meanwhile.
+  virtual void runSuspended(const std::function<void()>& fn) = 0;
+};
+
+// Executor wide arbitrator between the Velox tasks of concurrent Spark tasks. Each task is only able to spill itself
+// when Spark runs out of memory for it. The arbitrator lets a task whose memory growth is refused ask the largest
+// other tasks to spill, instead of failing while they hold idle memory.
+class ExecutorMemoryArbitrator {
+ public:
+  static ExecutorMemoryArbitrator* instance();
+
+  // The participant is recognized by the root pool of its task.
+  void addParticipant(facebook::velox::memory::MemoryPool* root, ArbitrationParticipant* participant);
+
+  // Blocks while the participant is being reclaimed.
+  void removeParticipant(facebook::velox::memory::MemoryPool* root);
+
+  // Asks the participants other than the one of the requestor to free size bytes, in descending order of their
+  // reclaimable bytes. Returns the bytes freed.
+  int64_t arbitrate(facebook::velox::memory::MemoryPool* requestor, int64_t size);
+
+  // Accumulated wall time of the arbitrations requested by the participant.
+  int64_t waitNanos(facebook::velox::memory::MemoryPool* root) const;
+
+  int64_t numArbitrations() const;
+
+  int64_t reclaimedBytes() const;
+
+ private:
+  struct Entry {
+    ArbitrationParticipant* participant;
+    int64_t waitNanos;
+  };
+
+  int64_t reclaimLocked(facebook::velox::memory::MemoryPool* requestor, int64_t size);
+
+  // Also serializes the arbitrations.
+  mutable std::mutex mutex_;
+  std::unordered_map<facebook::velox::memory::MemoryPool*, Entry> participants_;
+  int64_t numArbitrations_ = 0;
+  int64_t reclaimedBytes_ = 0;
+};
+
+} // namespace gluten
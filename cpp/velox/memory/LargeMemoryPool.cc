@@ -18,12 +18,50 @@
 #include "LargeMemoryPool.h"
 #include <arrow/util/logging.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include "utils/macros.h"
 
+#include <fstream>
 #include <numeric>
+#include <sstream>
 
 namespace gluten {
 
+namespace {
+// From linux/mempolicy.h, glibc has no wrappers for the NUMA syscalls.
+static constexpr int kMpolPreferred = 1;
+static constexpr int32_t kMaxNumaNodes = 64;
+
+int32_t currentNumaNode() {
+  unsigned cpu;
+  unsigned node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return -1;
+  }
+  return static_cast<int32_t>(node);
+}
+
+void preferNumaNode(void* addr, uint64_t size, int32_t node) {
+  if (node < 0 || node >= kMaxNumaNodes) {
+    return;
+  }
+  unsigned long nodeMask = 1UL << node;
+  // The kernel reads one bit less than maxnode.
+  syscall(SYS_mbind, addr, size, kMpolPreferred, &nodeMask, kMaxNumaNodes + 1, 0);
+}
+
+// NUMA node of the page at addr, -1 if it isn't resident or unknown.
+int32_t numaNodeOf(void* addr) {
+  void* pages[1] = {addr};
+  int status[1] = {-1};
+  if (syscall(SYS_move_pages, 0, 1, pages, nullptr, status, 0) != 0) {
+    return -1;
+  }
+  return status[0] < 0 ? -1 : status[0];
+}
+} // namespace
+
 arrow::Status LargeMemoryPool::Allocate(int64_t size, int64_t alignment, uint8_t** out) {
   if (size == 0) {
     return delegated_->Allocate(0, alignment, out);
@@ -39,8 +77,19 @@ arrow::Status LargeMemoryPool::Allocate(int64_t size, int64_t alignment, uint8_t
     if (!allocAddr) {
       return arrow::Status::Invalid("doAlloc failed.");
     }
+    int32_t node = -1;
+    if (options_.bind_to_local_node) {
+      // Before the advice below faults the pages in.
+      node = currentNumaNode();
+      preferNumaNode(allocAddr, allocSize, node);
+    }
+    if (options_.transparent_huge_pages && madvise(allocAddr, allocSize, MADV_HUGEPAGE) == 0) {
+      stats_.hugePageAdvisedBytes += allocSize;
+    }
     madvise(allocAddr, size, MADV_WILLNEED);
-    buffers_.push_back({allocAddr, allocAddr, allocSize, 0, 0});
+    buffers_.push_back({allocAddr, allocAddr, allocSize, 0, 0, node});
+    stats_.numBuffers++;
+    stats_.bufferBytes += allocSize;
   }
   auto& last = buffers_.back();
   *out = last.startAddr + last.allocated;
@@ -62,6 +111,13 @@ void LargeMemoryPool::Free(uint8_t* buffer, int64_t size, int64_t alignment) {
   ARROW_CHECK_NE(its, buffers_.end());
   its->freed += size;
   if (its->freed && its->freed == its->allocated) {
+    if (its->node >= 0) {
+      auto node = numaNodeOf(its->startAddr);
+      if (node >= 0) {
+        stats_.numLocalityChecked++;
+        stats_.numCrossNodeBuffers += node != its->node;
+      }
+    }
     doFree(its->startAddr, its->size);
     buffers_.erase(its);
   }
@@ -117,6 +173,41 @@ int64_t LargeMemoryPool::num_allocations() const {
   return delegated_->num_allocations();
 }
 
+int64_t LargeMemoryPool::hugePageBytes() const {
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  uint64_t overlap = 0;
+  int64_t bytes = 0;
+  while (std::getline(smaps, line)) {
+    uint64_t start;
+    uint64_t end;
+    char dash;
+    std::istringstream header(line);
+    if (header >> std::hex >> start >> dash >> end && dash == '-') {
+      // A new mapping.
+      overlap = 0;
+      for (const auto& buffer : buffers_) {
+        auto bufferStart = reinterpret_cast<uint64_t>(buffer.startAddr);
+        auto bufferEnd = bufferStart + buffer.size;
+        if (bufferStart < end && start < bufferEnd) {
+          overlap += std::min(end, bufferEnd) - std::max(start, bufferStart);
+        }
+      }
+      continue;
+    }
+    if (overlap == 0) {
+      continue;
+    }
+    std::istringstream field(line);
+    std::string name;
+    int64_t kb;
+    if (field >> name >> kb && (name == "AnonHugePages:" || name == "Private_Hugetlb:")) {
+      bytes += std::min<int64_t>(kb << 10, overlap);
+    }
+  }
+  return bytes;
+}
+
 arrow::Status LargeMemoryPool::doAlloc(int64_t size, int64_t alignment, uint8_t** out) {
   return delegated_->Allocate(size, alignment, out);
 }
@@ -134,6 +225,14 @@ MMapMemoryPool::~MMapMemoryPool() {
 }
 
 arrow::Status MMapMemoryPool::doAlloc(int64_t size, int64_t alignment, uint8_t** out) {
+  if (options_.hugetlb && size % kHugePageSize == 0) {
+    auto* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr != MAP_FAILED) {
+      *out = static_cast<uint8_t*>(addr);
+      stats_.hugetlbBytes += size;
+      return arrow::Status::OK();
+    }
+  }
   *out = static_cast<uint8_t*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
   if (*out == MAP_FAILED) {
     return arrow::Status::OutOfMemory(" mmap error ", size);
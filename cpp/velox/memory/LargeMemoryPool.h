@@ -21,12 +21,33 @@
 
 namespace gluten {
 
+struct LargeMemoryPoolOptions {
+  // madvise(MADV_HUGEPAGE) the buffers so that they are backed by transparent huge pages.
+  bool transparent_huge_pages = false;
+  // Prefer the NUMA node of the allocating thread for the pages of the buffers.
+  bool bind_to_local_node = false;
+  // Only for MMapMemoryPool. Map the buffers from hugetlbfs, falling back to regular pages if no huge page is free.
+  bool hugetlb = false;
+};
+
+struct LargeMemoryPoolStats {
+  int64_t numBuffers = 0;
+  int64_t bufferBytes = 0;
+  // Bytes advised for transparent huge pages, and bytes mapped from hugetlbfs.
+  int64_t hugePageAdvisedBytes = 0;
+  int64_t hugetlbBytes = 0;
+  // Freed buffers whose first page was resident, and those of them not on the NUMA node of the allocating thread.
+  int64_t numLocalityChecked = 0;
+  int64_t numCrossNodeBuffers = 0;
+};
+
 class LargeMemoryPool : public arrow::MemoryPool {
  public:
   constexpr static uint64_t kHugePageSize = 1 << 21;
   constexpr static uint64_t kLargeBufferSize = 4 << 21;
 
-  explicit LargeMemoryPool(MemoryPool* pool) : delegated_(pool) {}
+  explicit LargeMemoryPool(MemoryPool* pool, LargeMemoryPoolOptions options = {})
+      : delegated_(pool), options_(options) {}
 
   ~LargeMemoryPool();
 
@@ -46,6 +67,14 @@ class LargeMemoryPool : public arrow::MemoryPool {
 
   int64_t num_allocations() const override;
 
+  const LargeMemoryPoolStats& stats() const {
+    return stats_;
+  }
+
+  // Bytes of the live buffers actually backed by huge pages, read from /proc/self/smaps. Approximate if the buffers
+  // share mappings with other memory. Expensive, meant for metrics at the end of a task.
+  int64_t hugePageBytes() const;
+
  protected:
   virtual arrow::Status doAlloc(int64_t size, int64_t alignment, uint8_t** out);
 
@@ -57,17 +86,22 @@ class LargeMemoryPool : public arrow::MemoryPool {
     uint64_t size;
     uint64_t allocated;
     uint64_t freed;
+    // NUMA node of the allocating thread, -1 if unknown.
+    int32_t node;
   };
 
   std::vector<BufferAllocated> buffers_;
 
   MemoryPool* delegated_;
+  const LargeMemoryPoolOptions options_;
+  LargeMemoryPoolStats stats_;
 };
 
 // MMapMemoryPool can't be tracked by Spark. Currently only used for test purpose.
 class MMapMemoryPool : public LargeMemoryPool {
  public:
-  explicit MMapMemoryPool() : LargeMemoryPool(arrow::default_memory_pool()) {}
+  explicit MMapMemoryPool(LargeMemoryPoolOptions options = {})
+      : LargeMemoryPool(arrow::default_memory_pool(), options) {}
 
   ~MMapMemoryPool() override;
 
@@ -39,39 +39,75 @@ RowVectorPtr makeRowVector(
 
   return std::make_shared<RowVector>(pool, rowType, BufferPtr(nullptr), vectorSize, std::move(children));
 }
+
+// Whether the vector is flat down to its leaves, so that it's exported as it is and Arrow shares its buffers. Arrays
+// and maps are copied, the copy compacts the elements their offsets skip.
+bool isFlat(const VectorPtr& vector, vector_size_t size) {
+  if (vector->size() != size) {
+    return false;
+  }
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return true;
+    case VectorEncoding::Simple::ROW:
+      for (const auto& child : vector->as<RowVector>()->children()) {
+        if (!isFlat(child, size)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t nanosSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
 } // namespace
 
 void VeloxColumnarBatch::ensureFlattened() {
   if (flattened_ != nullptr) {
     return;
   }
-  auto startTime = std::chrono::steady_clock::now();
-  // Make sure to load lazy vector if not loaded already.
-  for (auto& child : rowVector_->children()) {
-    child->loadedVector();
+  // Make sure to load lazy vector if not loaded already, the loaded ones replace the lazy wrappers.
+  std::vector<VectorPtr> children;
+  children.reserve(rowVector_->childrenSize());
+  bool flat = true;
+  for (const auto& child : rowVector_->children()) {
+    children.push_back(BaseVector::loadedVectorShared(child));
+    flat = flat && isFlat(children.back(), rowVector_->size());
+  }
+  if (flat) {
+    flattened_ = std::make_shared<RowVector>(
+        rowVector_->pool(), rowVector_->type(), rowVector_->nulls(), rowVector_->size(), std::move(children));
+    return;
   }
 
+  auto startTime = std::chrono::steady_clock::now();
   // Perform copy to flatten dictionary vectors.
   velox::RowVectorPtr copy = std::dynamic_pointer_cast<velox::RowVector>(
       velox::BaseVector::create(rowVector_->type(), rowVector_->size(), rowVector_->pool()));
   copy->copy(rowVector_.get(), 0, 0, rowVector_->size());
   flattened_ = copy;
-  auto endTime = std::chrono::steady_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
-  exportNanos_ += duration;
+  exportNanos_ += nanosSince(startTime);
 }
 
 std::shared_ptr<ArrowSchema> VeloxColumnarBatch::exportArrowSchema() {
   auto out = std::make_shared<ArrowSchema>();
   ensureFlattened();
+  auto startTime = std::chrono::steady_clock::now();
   velox::exportToArrow(flattened_, *out);
+  exportNanos_ += nanosSince(startTime);
   return out;
 }
 
 std::shared_ptr<ArrowArray> VeloxColumnarBatch::exportArrowArray() {
   auto out = std::make_shared<ArrowArray>();
   ensureFlattened();
+  auto startTime = std::chrono::steady_clock::now();
   velox::exportToArrow(flattened_, *out, defaultLeafVeloxMemoryPool().get());
+  exportNanos_ += nanosSince(startTime);
   return out;
 }
 
@@ -89,6 +125,27 @@ velox::RowVectorPtr VeloxColumnarBatch::getFlattenedRowVector() {
   return flattened_;
 }
 
+std::shared_ptr<ColumnarBatch> VeloxColumnarBatch::select(const std::vector<int32_t>& columnIndices) {
+  auto rowType = facebook::velox::asRowType(rowVector_->type());
+  std::vector<std::string> childNames;
+  std::vector<TypePtr> childTypes;
+  std::vector<VectorPtr> childVectors;
+  for (auto index : columnIndices) {
+    VELOX_CHECK(index >= 0 && index < rowVector_->childrenSize(), "Column index {} out of range", index);
+    childNames.push_back(rowType->nameOf(index));
+    childTypes.push_back(rowType->childAt(index));
+    childVectors.push_back(rowVector_->childAt(index));
+  }
+  // Keeps the row count when no column is selected, as for count(*).
+  auto selected = std::make_shared<RowVector>(
+      rowVector_->pool(),
+      ROW(std::move(childNames), std::move(childTypes)),
+      BufferPtr(nullptr),
+      rowVector_->size(),
+      std::move(childVectors));
+  return std::make_shared<VeloxColumnarBatch>(selected);
+}
+
 std::shared_ptr<VeloxColumnarBatch> VeloxColumnarBatch::from(
     facebook::velox::memory::MemoryPool* pool,
     std::shared_ptr<ColumnarBatch> cb) {
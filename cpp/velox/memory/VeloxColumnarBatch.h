@@ -42,7 +42,11 @@ class VeloxColumnarBatch final : public ColumnarBatch {
   std::shared_ptr<ArrowSchema> exportArrowSchema() override;
   std::shared_ptr<ArrowArray> exportArrowArray() override;
 
+  /// Shares the selected children of the row vector, nothing is copied.
+  std::shared_ptr<ColumnarBatch> select(const std::vector<int32_t>& columnIndices) override;
+
   facebook::velox::RowVectorPtr getRowVector() const;
+  /// The row vector with flat children, sharing those of getRowVector() if they already are. Computed once.
   facebook::velox::RowVectorPtr getFlattenedRowVector();
 
  private:
@@ -16,9 +16,11 @@
  */
 
 #include "VeloxMemoryPool.h"
+#include "ExecutorMemoryArbitrator.h"
 #include "compute/Backend.h"
 #include "compute/VeloxBackend.h"
 #include "compute/VeloxInitializer.h"
+#include "memory/AllocationProfiler.h"
 #include "utils/TaskContext.h"
 #include "velox/common/memory/MemoryAllocator.h"
 
@@ -28,12 +30,15 @@ using namespace facebook;
 
 namespace gluten {
 
-// So far HbmMemoryAllocator would not work correctly since the underlying
-//   gluten allocator is only used to do allocation-reporting to Spark in mmap case
+// Only allocateBytes() goes to the gluten allocator, so HbwMemoryAllocator places the allocations below Velox's mmap
+//   threshold only. The mmap case uses the gluten allocator for allocation-reporting to Spark only
 class VeloxMemoryAllocator final : public velox::memory::MemoryAllocator {
  public:
-  VeloxMemoryAllocator(gluten::MemoryAllocator* glutenAlloc, velox::memory::MemoryAllocator* veloxAlloc)
-      : glutenAlloc_(glutenAlloc), veloxAlloc_(veloxAlloc) {}
+  VeloxMemoryAllocator(
+      gluten::MemoryAllocator* glutenAlloc,
+      velox::memory::MemoryAllocator* veloxAlloc,
+      MemoryTier tier = MemoryTier::kDefault)
+      : glutenAlloc_(glutenAlloc), veloxAlloc_(veloxAlloc), tier_(tier) {}
 
   Kind kind() const override {
     return veloxAlloc_->kind();
@@ -66,11 +71,14 @@ class VeloxMemoryAllocator final : public velox::memory::MemoryAllocator {
 
   void* allocateBytes(uint64_t bytes, uint16_t alignment) override {
     void* out;
+    ScopedMemoryTier scopedTier(tier_);
     VELOX_CHECK(glutenAlloc_->allocateAligned(alignment, bytes, &out))
+    AllocationProfiler::instance()->onAllocation(out, bytes, "velox");
     return out;
   }
 
   void freeBytes(void* p, uint64_t size) noexcept override {
+    AllocationProfiler::instance()->onFree(p);
     VELOX_CHECK(glutenAlloc_->free(p, size));
   }
 
@@ -97,6 +105,7 @@ class VeloxMemoryAllocator final : public velox::memory::MemoryAllocator {
  private:
   gluten::MemoryAllocator* glutenAlloc_;
   velox::memory::MemoryAllocator* veloxAlloc_;
+  const MemoryTier tier_;
 };
 
 // We assume in a single Spark task. No thread-safety should be guaranteed.
@@ -146,7 +155,15 @@ class ListenableArbitrator : public velox::memory::MemoryArbitrator {
 
  private:
   void growPool(memory::MemoryPool* pool, uint64_t bytes) {
-    listener_->allocationChanged(bytes);
+    try {
+      listener_->allocationChanged(bytes);
+    } catch (const std::exception&) {
+      // Spark refused to grow after spilling this task. Other tasks of the executor may hold the memory.
+      if (ExecutorMemoryArbitrator::instance()->arbitrate(pool->root(), bytes) == 0) {
+        throw;
+      }
+      listener_->allocationChanged(bytes);
+    }
     pool->grow(bytes);
   }
 
@@ -183,7 +200,9 @@ std::shared_ptr<velox::memory::MemoryPool> defaultLeafVeloxMemoryPool() {
   return leaf;
 }
 
-std::shared_ptr<velox::memory::MemoryPool> asAggregateVeloxMemoryPool(gluten::MemoryAllocator* allocator) {
+std::shared_ptr<velox::memory::MemoryPool> asAggregateVeloxMemoryPool(
+    gluten::MemoryAllocator* allocator,
+    MemoryTier tier) {
   // this pool is tracked by Spark
   static std::atomic_uint32_t id = 0;
   velox::memory::MemoryAllocator* veloxAlloc = velox::memory::MemoryAllocator::getInstance();
@@ -199,7 +218,7 @@ std::shared_ptr<velox::memory::MemoryPool> asAggregateVeloxMemoryPool(gluten::Me
     glutenAlloc = allocator;
     listener = AllocationListener::noop();
   }
-  auto wrappedAlloc = std::make_shared<VeloxMemoryAllocator>(glutenAlloc, veloxAlloc);
+  auto wrappedAlloc = std::make_shared<VeloxMemoryAllocator>(glutenAlloc, veloxAlloc, tier);
   bindToTask(wrappedAlloc); // keep alive util task ends
   velox::memory::MemoryArbitrator::Config arbitratorConfig{
       velox::memory::MemoryArbitrator::Kind::kNoOp, // do not use shared arbitrator as it will mess up the thread
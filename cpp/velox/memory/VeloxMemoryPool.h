@@ -18,11 +18,16 @@
 #pragma once
 
 #include "memory/MemoryAllocator.h"
+#include "memory/MemoryTier.h"
 #include "velox/common/memory/Memory.h"
 
 namespace gluten {
 
-std::shared_ptr<facebook::velox::memory::MemoryPool> asAggregateVeloxMemoryPool(MemoryAllocator* allocator);
+// The tier is preferred by the allocations Velox makes through the gluten allocator, i.e. the ones smaller than what
+// Velox maps directly.
+std::shared_ptr<facebook::velox::memory::MemoryPool> asAggregateVeloxMemoryPool(
+    MemoryAllocator* allocator,
+    MemoryTier tier = MemoryTier::kDefault);
 
 std::shared_ptr<facebook::velox::memory::MemoryPool> defaultLeafVeloxMemoryPool();
 
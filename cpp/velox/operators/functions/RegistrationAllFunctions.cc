@@ -23,11 +23,18 @@
 #include "velox/functions/sparksql/aggregates/Register.h"
 #include "velox/functions/sparksql/window/WindowFunctionsRegistration.h"
 
+#include <mutex>
+
 using namespace facebook;
 
 namespace gluten {
 
 void registerAllFunctions() {
+  registerFunctionsExceptWindow();
+  ensureWindowFunctionsRegistered();
+}
+
+void registerFunctionsExceptWindow() {
   // The registration order matters. Spark sql functions are registered after
   // presto sql functions to overwrite the registration for same named functions.
   velox::functions::prestosql::registerAllScalarFunctions();
@@ -35,8 +42,14 @@ void registerAllFunctions() {
   // registerCustomFunctions();
   velox::aggregate::prestosql::registerAllAggregateFunctions();
   velox::functions::aggregate::sparksql::registerAggregateFunctions("");
-  velox::window::prestosql::registerAllWindowFunctions();
-  velox::functions::window::sparksql::registerWindowFunctions("");
+}
+
+void ensureWindowFunctionsRegistered() {
+  static std::once_flag registered;
+  std::call_once(registered, [] {
+    velox::window::prestosql::registerAllWindowFunctions();
+    velox::functions::window::sparksql::registerWindowFunctions("");
+  });
 }
 
 } // namespace gluten
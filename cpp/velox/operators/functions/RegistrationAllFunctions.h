@@ -21,4 +21,11 @@ namespace gluten {
 
 void registerAllFunctions();
 
+// Registers the scalar and aggregate functions. The window functions, rarely used, are left to
+// ensureWindowFunctionsRegistered.
+void registerFunctionsExceptWindow();
+
+// Registers the window functions on the first call. Called by the conversion and the validation of window rels.
+void ensureWindowFunctionsRegistered();
+
 } // namespace gluten
@@ -19,30 +19,149 @@
 
 #include "compute/ResultIterator.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "utils/LatencyHistogram.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/Operator.h"
 
 namespace gluten {
 class RowVectorStream {
  public:
-  explicit RowVectorStream(std::shared_ptr<ResultIterator> iterator, const facebook::velox::RowTypePtr& outputType)
-      : iterator_(iterator), outputType_(outputType) {}
+  // Input batches are concatenated until either coalesceBatchRows rows or coalesceBatchBytes bytes are reached. The
+  // last of the concatenated batches is cut at coalesceBatchRows, its remaining rows start the next output. Batches of
+  // at least coalesceBatchRows rows are passed through. Coalescing is disabled if coalesceBatchRows is not positive.
+  explicit RowVectorStream(
+      std::shared_ptr<ResultIterator> iterator,
+      const facebook::velox::RowTypePtr& outputType,
+      int32_t coalesceBatchRows = 0,
+      int64_t coalesceBatchBytes = 0)
+      : iterator_(iterator),
+        outputType_(outputType),
+        coalesceBatchRows_(coalesceBatchRows),
+        coalesceBatchBytes_(coalesceBatchBytes) {}
 
   bool hasNext() {
-    return iterator_->hasNext();
+    if (remainder_ != nullptr) {
+      return true;
+    }
+    auto start = inputWait_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    auto hasNext = iterator_->hasNext();
+    addInputWait(start);
+    return hasNext;
+  }
+
+  // Records the time hasNext() and next() are blocked on the input iterator, one value per output vector.
+  void trackInputWait(std::shared_ptr<LatencyHistogram> histogram) {
+    inputWait_ = std::move(histogram);
+  }
+
+  // True if hasNext() and next() won't block on the input iterator. Otherwise onReady is called once they won't.
+  bool isReady(const std::function<void()>& onReady) {
+    return remainder_ != nullptr || iterator_->isReady(onReady);
   }
 
   // Convert arrow batch to rowvector and use new output columns
-  facebook::velox::RowVectorPtr next() {
-    auto vp = std::dynamic_pointer_cast<VeloxColumnarBatch>(iterator_->next())->getRowVector();
+  facebook::velox::RowVectorPtr next(facebook::velox::memory::MemoryPool* pool) {
+    auto output = nextOutput(pool);
+    if (inputWait_) {
+      inputWait_->record(pendingInputWaitNanos_);
+      pendingInputWaitNanos_ = 0;
+    }
+    return output;
+  }
+
+  int64_t numInputBatches() const {
+    return numInputBatches_;
+  }
+
+  // Of numInputBatches(), the VeloxColumnarBatches of a preceding Velox stage, taken by reference.
+  int64_t numNativeInputBatches() const {
+    return numNativeInputBatches_;
+  }
+
+  // Of numInputBatches(), the batches of other backends, imported through Arrow.
+  int64_t numArrowInputBatches() const {
+    return numInputBatches_ - numNativeInputBatches_;
+  }
+
+ private:
+  facebook::velox::RowVectorPtr nextOutput(facebook::velox::memory::MemoryPool* pool) {
+    auto vp = remainder_ != nullptr ? std::move(remainder_) : nextInput(pool);
+    if (coalesceBatchRows_ <= 0 || vp->size() >= coalesceBatchRows_) {
+      return wrap(vp);
+    }
+
+    std::vector<facebook::velox::RowVectorPtr> inputs{vp};
+    facebook::velox::vector_size_t numRows = vp->size();
+    int64_t numBytes = vp->estimateFlatSize();
+    // Don't wait on the input to coalesce.
+    while (numRows < coalesceBatchRows_ && numBytes < coalesceBatchBytes_ && iterator_->isReady(nullptr) &&
+           hasNext()) {
+      auto input = nextInput(pool);
+      if (numRows + input->size() > coalesceBatchRows_) {
+        auto taken = coalesceBatchRows_ - numRows;
+        remainder_ = std::static_pointer_cast<facebook::velox::RowVector>(input->slice(taken, input->size() - taken));
+        input = std::static_pointer_cast<facebook::velox::RowVector>(input->slice(0, taken));
+      }
+      numRows += input->size();
+      numBytes += input->estimateFlatSize();
+      inputs.emplace_back(std::move(input));
+    }
+    if (inputs.size() == 1) {
+      return wrap(vp);
+    }
+
+    auto output = std::static_pointer_cast<facebook::velox::RowVector>(
+        facebook::velox::BaseVector::create(outputType_, numRows, pool));
+    facebook::velox::vector_size_t offset = 0;
+    for (const auto& input : inputs) {
+      output->copy(input.get(), offset, 0, input->size());
+      offset += input->size();
+    }
+    return output;
+  }
+
+  facebook::velox::RowVectorPtr nextInput(facebook::velox::memory::MemoryPool* pool) {
+    auto start = inputWait_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    auto batch = iterator_->next();
+    addInputWait(start);
+    facebook::velox::RowVectorPtr vp;
+    if (batch->getType() == "velox") {
+      vp = static_cast<VeloxColumnarBatch*>(batch.get())->getRowVector();
+      ++numNativeInputBatches_;
+    } else {
+      vp = VeloxColumnarBatch::from(pool, batch)->getRowVector();
+    }
     VELOX_DCHECK(vp != nullptr);
+    ++numInputBatches_;
+    return vp;
+  }
+
+  void addInputWait(std::chrono::steady_clock::time_point start) {
+    if (inputWait_) {
+      pendingInputWaitNanos_ +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+  }
+
+  facebook::velox::RowVectorPtr wrap(const facebook::velox::RowVectorPtr& vp) {
+    // Already of the output type, e.g. from a preceding stage with the same schema.
+    if (!vp->mayHaveNulls() && (vp->type() == outputType_ || *vp->type() == *outputType_)) {
+      return vp;
+    }
     return std::make_shared<facebook::velox::RowVector>(
         vp->pool(), outputType_, facebook::velox::BufferPtr(0), vp->size(), std::move(vp->children()));
   }
 
- private:
   std::shared_ptr<ResultIterator> iterator_;
   const facebook::velox::RowTypePtr outputType_;
+  const int32_t coalesceBatchRows_;
+  const int64_t coalesceBatchBytes_;
+  // Rows of the last input past coalesceBatchRows, output first by the next call.
+  facebook::velox::RowVectorPtr remainder_;
+  int64_t numInputBatches_ = 0;
+  int64_t numNativeInputBatches_ = 0;
+  std::shared_ptr<LatencyHistogram> inputWait_;
+  int64_t pendingInputWaitNanos_ = 0;
 };
 
 class ValueStreamNode : public facebook::velox::core::PlanNode {
@@ -100,15 +219,37 @@ class ValueStream : public facebook::velox::exec::SourceOperator {
 
   facebook::velox::RowVectorPtr getOutput() override {
     if (valueStream_->hasNext()) {
-      return valueStream_->next();
+      auto numInputBatches = valueStream_->numInputBatches();
+      auto numNativeInputBatches = valueStream_->numNativeInputBatches();
+      auto output = valueStream_->next(pool());
+      // Report the batches pulled from the input iterator as input, so that the coalescing ratio can be told from
+      // inputVectors and outputVectors.
+      auto lockedStats = stats_.wlock();
+      auto numNative = valueStream_->numNativeInputBatches() - numNativeInputBatches;
+      auto numInput = valueStream_->numInputBatches() - numInputBatches;
+      lockedStats->inputVectors += numInput;
+      lockedStats->inputRows += output->size();
+      lockedStats->addRuntimeStat("nativeInputBatches", facebook::velox::RuntimeCounter(numNative));
+      lockedStats->addRuntimeStat("arrowInputBatches", facebook::velox::RuntimeCounter(numInput - numNative));
+      return output;
     } else {
       finished_ = true;
       return nullptr;
     }
   };
 
-  facebook::velox::exec::BlockingReason isBlocked(facebook::velox::ContinueFuture* /* unused */) override {
-    return facebook::velox::exec::BlockingReason::kNotBlocked;
+  facebook::velox::exec::BlockingReason isBlocked(facebook::velox::ContinueFuture* future) override {
+    if (finished_ || valueStream_->isReady(nullptr)) {
+      return facebook::velox::exec::BlockingReason::kNotBlocked;
+    }
+    auto [promise, readyFuture] = facebook::velox::makeVeloxContinuePromiseContract("ValueStream::isBlocked");
+    auto sharedPromise = std::make_shared<facebook::velox::ContinuePromise>(std::move(promise));
+    if (valueStream_->isReady([sharedPromise]() { sharedPromise->setValue(); })) {
+      // Became ready meanwhile, the callback is dropped.
+      return facebook::velox::exec::BlockingReason::kNotBlocked;
+    }
+    *future = std::move(readyFuture);
+    return facebook::velox::exec::BlockingReason::kWaitForExchange;
   }
 
   bool isFinished() override {
@@ -17,10 +17,19 @@
 
 #include "VeloxColumnarBatchSerializer.h"
 
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <string_view>
+
 #include "memory/ArrowMemory.h"
+#include "memory/ArrowMemoryPool.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryPool.h"
+#include "utils/compression.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/arrow/Bridge.h"
 
@@ -31,37 +40,518 @@ using namespace facebook::velox;
 namespace gluten {
 
 namespace {
+// The first u32 of a serialized buffer, telling its format.
+constexpr uint32_t kCompactMagic = 0x32424347; // "GCB2"
+constexpr uint32_t kPrestoMagic = 0x31535047; // "GPS1"
+
+// Buffers smaller than this are stored raw.
+constexpr int64_t kMinCompressSize = 64;
+
+// String columns are dictionary encoded when they have at least this many rows per distinct value.
+constexpr int64_t kMinRowsPerDictionaryValue = 2;
+
+// How a column is stored in the compact format.
+enum ColumnEncoding : int32_t {
+  // The nulls and the values of all rows.
+  kFlatEncoding = 0,
+  // The nulls and the value of one row, repeated for all rows.
+  kConstantEncoding = 1,
+  // Only for strings. The nulls, an i32 index per row, then the distinct values as a flat column.
+  kDictionaryEncoding = 2,
+};
+
+// The offsets of a string column are i32.
+constexpr int64_t kMaxStringColumnSize = std::numeric_limits<int32_t>::max();
+
+// Bodies start at multiples of this from the start of the payload, so the wrapped int128 values are aligned.
+constexpr int64_t kBodyAlignment = 16;
+
+// |magic u32|codec i32|numRows i64|numBuffers i64|, then |uncompressedLength i64|compressedLength i64| of each buffer,
+// compressedLength being -1 if it's stored raw, then the bodies. The first buffer holds the ColumnEncoding of each
+// column as i32, the buffers of the columns follow.
+struct CompactHeader {
+  uint32_t magic;
+  int32_t codec;
+  int64_t numRows;
+  int64_t numBuffers;
+};
+
+int64_t alignBody(int64_t size) {
+  return (size + kBodyAlignment - 1) & ~(kBodyAlignment - 1);
+}
+
+bool isCompactType(const RowTypePtr& rowType) {
+  for (auto& type : rowType->children()) {
+    switch (type->kind()) {
+      case TypeKind::BOOLEAN:
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::HUGEINT:
+      case TypeKind::REAL:
+      case TypeKind::DOUBLE:
+      case TypeKind::TIMESTAMP:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+// Appends the buffers of a column of all batches: the nulls, null if there is none, then the values, or the offsets
+// and the chars of strings.
+template <TypeKind kind>
+void collectColumn(
+    const std::vector<VectorPtr>& columns,
+    vector_size_t numRows,
+    std::vector<BufferPtr>& buffers,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<kind>::NativeType;
+  std::vector<std::unique_ptr<DecodedVector>> decoded;
+  decoded.reserve(columns.size());
+  for (auto& column : columns) {
+    decoded.emplace_back(std::make_unique<DecodedVector>(*column));
+  }
+
+  BufferPtr nulls;
+  vector_size_t offset = 0;
+  for (auto& column : decoded) {
+    for (vector_size_t i = 0; column->mayHaveNulls() && i < column->size(); ++i) {
+      if (column->isNullAt(i)) {
+        if (nulls == nullptr) {
+          nulls = allocateNulls(numRows, pool);
+        }
+        bits::setNull(nulls->asMutable<uint64_t>(), offset + i);
+      }
+    }
+    offset += column->size();
+  }
+  buffers.emplace_back(std::move(nulls));
+
+  if constexpr (std::is_same_v<T, StringView>) {
+    auto offsets = AlignedBuffer::allocate<int32_t>(numRows + 1, pool);
+    auto* rawOffsets = offsets->asMutable<int32_t>();
+    int64_t size = 0;
+    offset = 0;
+    for (auto& column : decoded) {
+      for (vector_size_t i = 0; i < column->size(); ++i) {
+        rawOffsets[offset++] = size;
+        size += column->isNullAt(i) ? 0 : column->valueAt<StringView>(i).size();
+        VELOX_CHECK_LE(size, kMaxStringColumnSize, "String column too large to serialize in one batch");
+      }
+    }
+    rawOffsets[offset] = size;
+    auto chars = AlignedBuffer::allocate<char>(size, pool);
+    auto* rawChars = chars->asMutable<char>();
+    offset = 0;
+    for (auto& column : decoded) {
+      for (vector_size_t i = 0; i < column->size(); ++i, ++offset) {
+        if (!column->isNullAt(i)) {
+          auto value = column->valueAt<StringView>(i);
+          memcpy(rawChars + rawOffsets[offset], value.data(), value.size());
+        }
+      }
+    }
+    buffers.emplace_back(std::move(offsets));
+    buffers.emplace_back(std::move(chars));
+  } else {
+    auto values = AlignedBuffer::allocate<T>(numRows, pool);
+    offset = 0;
+    for (auto& column : decoded) {
+      for (vector_size_t i = 0; i < column->size(); ++i, ++offset) {
+        if constexpr (std::is_same_v<T, bool>) {
+          bits::setBit(values->asMutable<uint64_t>(), offset, !column->isNullAt(i) && column->valueAt<bool>(i));
+        } else {
+          values->asMutable<T>()[offset] = column->isNullAt(i) ? T{} : column->valueAt<T>(i);
+        }
+      }
+    }
+    buffers.emplace_back(std::move(values));
+  }
+}
+
+// True if the column of all batches is one value.
+bool isConstantColumn(const std::vector<VectorPtr>& columns) {
+  if (columns[0]->size() == 0) {
+    return false;
+  }
+  for (auto& column : columns) {
+    if (!column->isConstantEncoding() || !column->equalValueAt(columns[0].get(), 0, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Appends the buffers of a kDictionaryEncoding string column of all batches, unless it has too many distinct values.
+bool collectStringDictionary(
+    const std::vector<VectorPtr>& columns,
+    vector_size_t numRows,
+    std::vector<BufferPtr>& buffers,
+    memory::MemoryPool* pool) {
+  auto maxDistinct = numRows / kMinRowsPerDictionaryValue;
+  std::unordered_map<std::string_view, int32_t> ids;
+  int64_t distinctSize = 0;
+  BufferPtr nulls;
+  auto indices = AlignedBuffer::allocate<int32_t>(numRows, pool);
+  auto* rawIndices = indices->asMutable<int32_t>();
+  vector_size_t offset = 0;
+  for (auto& column : columns) {
+    DecodedVector decoded(*column);
+    for (vector_size_t i = 0; i < column->size(); ++i, ++offset) {
+      if (decoded.isNullAt(i)) {
+        if (nulls == nullptr) {
+          nulls = allocateNulls(numRows, pool);
+        }
+        bits::setNull(nulls->asMutable<uint64_t>(), offset);
+        rawIndices[offset] = 0;
+        continue;
+      }
+      auto value = decoded.valueAt<StringView>(i);
+      auto [it, inserted] = ids.emplace(std::string_view(value.data(), value.size()), ids.size());
+      if (inserted) {
+        distinctSize += value.size();
+        if (static_cast<int64_t>(ids.size()) > maxDistinct || distinctSize > kMaxStringColumnSize) {
+          return false;
+        }
+      }
+      rawIndices[offset] = it->second;
+    }
+  }
+  if (ids.empty()) {
+    return false;
+  }
+
+  std::vector<std::string_view> values(ids.size());
+  for (auto& [value, id] : ids) {
+    values[id] = value;
+  }
+  auto offsets = AlignedBuffer::allocate<int32_t>(values.size() + 1, pool);
+  auto* rawOffsets = offsets->asMutable<int32_t>();
+  auto chars = AlignedBuffer::allocate<char>(distinctSize, pool);
+  int32_t size = 0;
+  for (auto i = 0; i < values.size(); ++i) {
+    rawOffsets[i] = size;
+    memcpy(chars->asMutable<char>() + size, values[i].data(), values[i].size());
+    size += values[i].size();
+  }
+  rawOffsets[values.size()] = size;
+  buffers.emplace_back(std::move(nulls));
+  buffers.emplace_back(std::move(indices));
+  // The distinct values are a flat column without nulls.
+  buffers.emplace_back(nullptr);
+  buffers.emplace_back(std::move(offsets));
+  buffers.emplace_back(std::move(chars));
+  return true;
+}
+
+template <TypeKind kind>
+ColumnStatistics columnStatistics(const std::vector<VectorPtr>& columns) {
+  using T = typename TypeTraits<kind>::NativeType;
+  ColumnStatistics stats;
+  T min{};
+  T max{};
+  bool seen = false;
+  bool nan = false;
+  for (auto& column : columns) {
+    DecodedVector decoded(*column);
+    for (vector_size_t i = 0; i < column->size(); ++i) {
+      if (decoded.isNullAt(i)) {
+        ++stats.nullCount;
+        continue;
+      }
+      auto value = decoded.valueAt<T>(i);
+      if constexpr (std::is_floating_point_v<T>) {
+        // Spark orders NaN above all values, the bounds would need it.
+        if (std::isnan(value)) {
+          nan = true;
+          continue;
+        }
+      }
+      if (!seen || value < min) {
+        min = value;
+      }
+      if (!seen || max < value) {
+        max = value;
+      }
+      seen = true;
+    }
+  }
+  stats.hasBounds = seen && !nan;
+  auto toBound = [](T value) -> int64_t {
+    if constexpr (std::is_floating_point_v<T>) {
+      double bound = value;
+      int64_t bits;
+      memcpy(&bits, &bound, sizeof(bits));
+      return bits;
+    } else if constexpr (std::is_same_v<T, Timestamp>) {
+      return value.toMicros();
+    } else if constexpr (std::is_same_v<T, Date>) {
+      return value.days();
+    } else {
+      return static_cast<int64_t>(value);
+    }
+  };
+  if (stats.hasBounds) {
+    stats.lowerBound = toBound(min);
+    stats.upperBound = toBound(max);
+  }
+  return stats;
+}
+
+ColumnStatistics nullStatistics(const std::vector<VectorPtr>& columns) {
+  ColumnStatistics stats;
+  for (auto& column : columns) {
+    DecodedVector decoded(*column);
+    for (vector_size_t i = 0; decoded.mayHaveNulls() && i < column->size(); ++i) {
+      stats.nullCount += decoded.isNullAt(i) ? 1 : 0;
+    }
+  }
+  return stats;
+}
+
+// Holds the copy of the payload that the raw buffers of the deserialized vectors point into.
+struct PayloadReleaser {
+  void addRef() const {}
+  void release() const {}
+
+  BufferPtr payload;
+};
+
+BufferPtr wrapPayload(const BufferPtr& payload, int64_t offset, int64_t length) {
+  return BufferView<PayloadReleaser>::create(payload->as<uint8_t>() + offset, length, {payload});
+}
+
+template <TypeKind kind>
+VectorPtr readColumn(
+    std::vector<BufferPtr>& buffers,
+    size_t& bufferIdx,
+    vector_size_t numRows,
+    const TypePtr& type,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<kind>::NativeType;
+  auto nulls = std::move(buffers[bufferIdx++]);
+  if constexpr (std::is_same_v<T, StringView>) {
+    auto offsets = std::move(buffers[bufferIdx++]);
+    auto chars = std::move(buffers[bufferIdx++]);
+    auto values = AlignedBuffer::allocate<StringView>(numRows, pool);
+    auto* rawValues = values->asMutable<StringView>();
+    auto* rawOffsets = offsets->as<int32_t>();
+    auto* rawChars = chars == nullptr ? nullptr : chars->as<char>();
+    for (vector_size_t i = 0; i < numRows; ++i) {
+      rawValues[i] = StringView(rawChars + rawOffsets[i], rawOffsets[i + 1] - rawOffsets[i]);
+    }
+    std::vector<BufferPtr> stringBuffers;
+    if (chars != nullptr) {
+      stringBuffers.emplace_back(std::move(chars));
+    }
+    return std::make_shared<FlatVector<StringView>>(
+        pool, type, std::move(nulls), numRows, std::move(values), std::move(stringBuffers));
+  } else {
+    auto values = std::move(buffers[bufferIdx++]);
+    if (values == nullptr) {
+      values = AlignedBuffer::allocate<T>(numRows, pool);
+    }
+    return std::make_shared<FlatVector<T>>(
+        pool, type, std::move(nulls), numRows, std::move(values), std::vector<BufferPtr>{});
+  }
+}
+
 std::unique_ptr<ByteStream> toByteStream(uint8_t* data, int32_t size) {
   auto byteStream = std::make_unique<ByteStream>();
   ByteRange byteRange{data, size, 0};
   byteStream->resetInput({byteRange});
   return byteStream;
 }
+
+// The batches deserialized by deserializeShared(), kept while any caller holds them.
+class SharedBatchCache {
+ public:
+  static SharedBatchCache& instance() {
+    static SharedBatchCache cache;
+    return cache;
+  }
+
+  template <typename F>
+  std::shared_ptr<ColumnarBatch> getOrCreate(const std::string& key, F&& create) {
+    std::shared_ptr<Entry> entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& slot = entries_[key];
+      if (slot == nullptr) {
+        // Drops the entries of the batches released since, so the map doesn't grow with the broadcasts.
+        for (auto it = entries_.begin(); it != entries_.end();) {
+          it = it->second != nullptr && it->second->batch.expired() ? entries_.erase(it) : std::next(it);
+        }
+        slot = std::make_shared<Entry>();
+      }
+      entry = slot;
+    }
+    // Concurrent callers of a key wait for the first one to deserialize it.
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto batch = entry->batch.lock();
+    if (batch == nullptr) {
+      batch = create();
+      entry->batch = batch;
+    }
+    return batch;
+  }
+
+ private:
+  struct Entry {
+    std::mutex mutex;
+    std::weak_ptr<ColumnarBatch> batch;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+};
 } // namespace
 
 VeloxColumnarBatchSerializer::VeloxColumnarBatchSerializer(
     std::shared_ptr<arrow::MemoryPool> arrowPool,
     std::shared_ptr<memory::MemoryPool> veloxPool,
-    struct ArrowSchema* cSchema)
-    : ColumnarBatchSerializer(arrowPool, cSchema), veloxPool_(std::move(veloxPool)) {
+    struct ArrowSchema* cSchema,
+    std::shared_ptr<ArenaMemoryAllocator> arena,
+    std::shared_ptr<memory::MemoryPool> arenaVeloxPool,
+    arrow::Compression::type codec)
+    : ColumnarBatchSerializer(arrowPool, cSchema),
+      arena_(std::move(arena)),
+      veloxPool_(std::move(veloxPool)),
+      arenaVeloxPool_(std::move(arenaVeloxPool)),
+      codecType_(codec) {
   // serializeColumnarBatches don't need rowType_
   if (cSchema != nullptr) {
     rowType_ = asRowType(importFromArrow(*cSchema));
     ArrowSchemaRelease(cSchema); // otherwise the c schema leaks memory
   }
   serde_ = std::make_unique<serializer::presto::PrestoVectorSerde>();
+  if (auto* arrowPool = dynamic_cast<ArrowMemoryPool*>(arrowPool_.get())) {
+    if (auto* allocator = dynamic_cast<ListenableMemoryAllocator*>(arrowPool->allocator())) {
+      listener_ = allocator->listener();
+    }
+  }
+}
+
+arrow::util::Codec* VeloxColumnarBatchSerializer::getCodec(arrow::Compression::type type) {
+  if (type == arrow::Compression::UNCOMPRESSED) {
+    return nullptr;
+  }
+  auto& codec = codecs_[type];
+  if (codec == nullptr) {
+    codec = createArrowIpcCodec(type, CodecBackend::NONE);
+  }
+  return codec.get();
 }
 
 std::shared_ptr<arrow::Buffer> VeloxColumnarBatchSerializer::serializeColumnarBatches(
     const std::vector<std::shared_ptr<ColumnarBatch>>& batches) {
   VELOX_DCHECK(batches.size() != 0, "Should serialize at least 1 vector");
-  auto firstRowVector = std::dynamic_pointer_cast<VeloxColumnarBatch>(batches[0])->getRowVector();
-  auto numRows = firstRowVector->size();
-  auto arena = std::make_unique<StreamArena>(veloxPool_.get());
-  auto rowType = asRowType(firstRowVector->type());
-  auto serializer = serde_->createSerializer(rowType, numRows, arena.get(), /* serdeOptions */ nullptr);
+  std::vector<RowVectorPtr> rowVectors;
+  int64_t numRows = 0;
   for (auto& batch : batches) {
-    auto rowVector = std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector();
+    rowVectors.emplace_back(std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector());
+    numRows += rowVectors.back()->size();
+  }
+  auto* pool = veloxPool_.get();
+  if (arena_ != nullptr) {
+    // Buffers of the previous call are gone.
+    arena_->reset();
+    pool = arenaVeloxPool_.get();
+  }
+  if (isCompactType(asRowType(rowVectors[0]->type()))) {
+    return serializeCompact(rowVectors, numRows, pool);
+  }
+  return serializePresto(rowVectors, numRows, pool);
+}
+
+std::shared_ptr<arrow::Buffer> VeloxColumnarBatchSerializer::serializeCompact(
+    const std::vector<RowVectorPtr>& rowVectors,
+    int64_t numRows,
+    memory::MemoryPool* pool) {
+  VELOX_CHECK_LE(numRows, std::numeric_limits<vector_size_t>::max(), "Too many rows to serialize in one batch");
+  auto rowType = asRowType(rowVectors[0]->type());
+  std::vector<BufferPtr> buffers;
+  auto encodings = AlignedBuffer::allocate<int32_t>(rowType->size(), pool);
+  buffers.emplace_back(encodings);
+  std::vector<VectorPtr> columns(rowVectors.size());
+  for (auto i = 0; i < rowType->size(); ++i) {
+    for (auto j = 0; j < rowVectors.size(); ++j) {
+      columns[j] = rowVectors[j]->childAt(i);
+    }
+    auto kind = rowType->childAt(i)->kind();
+    auto& encoding = encodings->asMutable<int32_t>()[i];
+    if (numRows > 0 && isConstantColumn(columns)) {
+      encoding = kConstantEncoding;
+      std::vector<VectorPtr> value = {columns[0]->slice(0, 1)};
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(collectColumn, kind, value, 1, buffers, pool);
+    } else if (
+        (kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY) &&
+        collectStringDictionary(columns, numRows, buffers, pool)) {
+      encoding = kDictionaryEncoding;
+    } else {
+      encoding = kFlatEncoding;
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(collectColumn, kind, columns, numRows, buffers, pool);
+    }
+  }
+
+  auto* codec = getCodec(codecType_);
+  auto headerSize = alignBody(sizeof(CompactHeader) + sizeof(int64_t) * 2 * buffers.size());
+  auto maxSize = headerSize;
+  for (auto& buffer : buffers) {
+    auto size = buffer == nullptr ? 0 : static_cast<int64_t>(buffer->size());
+    auto maxBodySize = codec == nullptr || size == 0 ? size : codec->MaxCompressedLen(size, buffer->as<uint8_t>());
+    maxSize += alignBody(std::max(size, maxBodySize));
+  }
+  std::shared_ptr<arrow::ResizableBuffer> output;
+  GLUTEN_ASSIGN_OR_THROW(output, arrow::AllocateResizableBuffer(maxSize, arrowPool_.get()));
+  auto* data = output->mutable_data();
+  memset(data, 0, headerSize);
+  auto* header = reinterpret_cast<CompactHeader*>(data);
+  header->magic = kCompactMagic;
+  header->codec = codec == nullptr ? arrow::Compression::UNCOMPRESSED : codecType_;
+  header->numRows = numRows;
+  header->numBuffers = buffers.size();
+  auto* lengths = reinterpret_cast<int64_t*>(data + sizeof(CompactHeader));
+
+  int64_t offset = headerSize;
+  for (auto i = 0; i < buffers.size(); ++i) {
+    auto size = buffers[i] == nullptr ? 0 : static_cast<int64_t>(buffers[i]->size());
+    lengths[2 * i] = size;
+    lengths[2 * i + 1] = -1;
+    if (codec != nullptr && size >= kMinCompressSize) {
+      int64_t compressedSize;
+      GLUTEN_ASSIGN_OR_THROW(
+          compressedSize,
+          codec->Compress(size, buffers[i]->as<uint8_t>(), maxSize - offset, data + offset));
+      // Stored raw if compression doesn't pay.
+      if (compressedSize < size) {
+        lengths[2 * i + 1] = compressedSize;
+        offset += alignBody(compressedSize);
+        continue;
+      }
+    }
+    if (size > 0) {
+      memcpy(data + offset, buffers[i]->as<uint8_t>(), size);
+    }
+    offset += alignBody(size);
+  }
+  GLUTEN_THROW_NOT_OK(output->Resize(offset, /* shrink_to_fit */ false));
+  return output;
+}
+
+std::shared_ptr<arrow::Buffer> VeloxColumnarBatchSerializer::serializePresto(
+    const std::vector<RowVectorPtr>& rowVectors,
+    int64_t numRows,
+    memory::MemoryPool* pool) {
+  auto arena = std::make_unique<StreamArena>(pool);
+  auto rowType = asRowType(rowVectors[0]->type());
+  auto serializer = serde_->createSerializer(rowType, numRows, arena.get(), /* serdeOptions */ nullptr);
+  for (auto& rowVector : rowVectors) {
     auto numRows = rowVector->size();
     std::vector<IndexRange> rows(numRows);
     for (int i = 0; i < numRows; i++) {
@@ -70,10 +560,13 @@ std::shared_ptr<arrow::Buffer> VeloxColumnarBatchSerializer::serializeColumnarBa
     serializer->append(rowVector, folly::Range(rows.data(), numRows));
   }
 
-  std::shared_ptr<arrow::Buffer> valueBuffer;
+  std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
   GLUTEN_ASSIGN_OR_THROW(
-      valueBuffer, arrow::AllocateResizableBuffer(serializer->maxSerializedSize(), arrowPool_.get()));
+      valueBuffer,
+      arrow::AllocateResizableBuffer(sizeof(kPrestoMagic) + serializer->maxSerializedSize(), arrowPool_.get()));
+  memcpy(valueBuffer->mutable_data(), &kPrestoMagic, sizeof(kPrestoMagic));
   auto output = std::make_shared<arrow::io::FixedSizeBufferWriter>(valueBuffer);
+  GLUTEN_THROW_NOT_OK(output->Seek(sizeof(kPrestoMagic)));
   serializer::presto::PrestoOutputStreamListener listener;
   ArrowFixedSizeBufferOutputStream out(output, &listener);
   serializer->flush(&out);
@@ -81,10 +574,158 @@ std::shared_ptr<arrow::Buffer> VeloxColumnarBatchSerializer::serializeColumnarBa
   return valueBuffer;
 }
 
+RowVectorPtr VeloxColumnarBatchSerializer::deserializeRowVector(uint8_t* data, int32_t size, memory::MemoryPool* pool) {
+  uint32_t magic;
+  VELOX_CHECK_GE(size, sizeof(magic), "Serialized batch too short");
+  memcpy(&magic, data, sizeof(magic));
+  if (magic == kPrestoMagic) {
+    RowVectorPtr result;
+    auto byteStream = toByteStream(data + sizeof(magic), size - sizeof(magic));
+    serde_->deserialize(byteStream.get(), pool, rowType_, &result, /* serdeOptions */ nullptr);
+    return result;
+  }
+  VELOX_CHECK_EQ(magic, kCompactMagic, "Unknown format of serialized batch");
+
+  // The only copy of the raw buffers, as the caller releases data.
+  auto payload = AlignedBuffer::allocate<char>(size, pool);
+  memcpy(payload->asMutable<char>(), data, size);
+  auto* base = payload->as<uint8_t>();
+  const auto* header = reinterpret_cast<const CompactHeader*>(base);
+  const auto* lengths = reinterpret_cast<const int64_t*>(base + sizeof(CompactHeader));
+  auto* codec = getCodec(static_cast<arrow::Compression::type>(header->codec));
+
+  std::vector<BufferPtr> buffers;
+  buffers.reserve(header->numBuffers);
+  int64_t offset = alignBody(sizeof(CompactHeader) + sizeof(int64_t) * 2 * header->numBuffers);
+  for (auto i = 0; i < header->numBuffers; ++i) {
+    auto uncompressedLength = lengths[2 * i];
+    auto compressedLength = lengths[2 * i + 1];
+    if (compressedLength == -1) {
+      buffers.emplace_back(uncompressedLength == 0 ? nullptr : wrapPayload(payload, offset, uncompressedLength));
+      offset += alignBody(uncompressedLength);
+      continue;
+    }
+    VELOX_CHECK_NOT_NULL(codec, "Compressed buffer without codec");
+    auto buffer = AlignedBuffer::allocate<char>(uncompressedLength, pool);
+    GLUTEN_ASSIGN_OR_THROW(
+        auto decompressedLength,
+        codec->Decompress(compressedLength, base + offset, uncompressedLength, buffer->asMutable<uint8_t>()));
+    VELOX_CHECK_EQ(decompressedLength, uncompressedLength, "Corrupted compressed buffer");
+    buffers.emplace_back(std::move(buffer));
+    offset += alignBody(compressedLength);
+  }
+
+  auto numRows = static_cast<vector_size_t>(header->numRows);
+  std::vector<VectorPtr> children;
+  children.reserve(rowType_->size());
+  auto encodings = std::move(buffers[0]);
+  size_t bufferIdx = 1;
+  for (auto i = 0; i < rowType_->size(); ++i) {
+    const auto& type = rowType_->childAt(i);
+    switch (encodings->as<int32_t>()[i]) {
+      case kConstantEncoding: {
+        auto value =
+            VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(readColumn, type->kind(), buffers, bufferIdx, 1, type, pool);
+        children.emplace_back(BaseVector::wrapInConstant(numRows, 0, value));
+        break;
+      }
+      case kDictionaryEncoding: {
+        auto nulls = std::move(buffers[bufferIdx++]);
+        auto indices = std::move(buffers[bufferIdx++]);
+        // The offsets follow the nulls of the distinct values.
+        auto numValues = static_cast<vector_size_t>(buffers[bufferIdx + 1]->size() / sizeof(int32_t) - 1);
+        auto values = readColumn<TypeKind::VARCHAR>(buffers, bufferIdx, numValues, type, pool);
+        children.emplace_back(
+            BaseVector::wrapInDictionary(std::move(nulls), std::move(indices), numRows, std::move(values)));
+        break;
+      }
+      default:
+        children.emplace_back(
+            VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(readColumn, type->kind(), buffers, bufferIdx, numRows, type, pool));
+    }
+  }
+  return std::make_shared<RowVector>(pool, rowType_, BufferPtr(nullptr), numRows, std::move(children));
+}
+
+std::vector<ColumnStatistics> VeloxColumnarBatchSerializer::computeStatistics(
+    const std::vector<std::shared_ptr<ColumnarBatch>>& batches) {
+  std::vector<RowVectorPtr> rowVectors;
+  for (auto& batch : batches) {
+    rowVectors.emplace_back(std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector());
+  }
+  auto rowType = asRowType(rowVectors[0]->type());
+  std::vector<ColumnStatistics> statistics;
+  std::vector<VectorPtr> columns(rowVectors.size());
+  for (auto i = 0; i < rowType->size(); ++i) {
+    for (auto j = 0; j < rowVectors.size(); ++j) {
+      columns[j] = rowVectors[j]->childAt(i);
+    }
+    const auto& type = rowType->childAt(i);
+    if (type->isDecimal()) {
+      statistics.emplace_back(nullStatistics(columns));
+      continue;
+    }
+    switch (type->kind()) {
+      case TypeKind::BOOLEAN:
+        statistics.emplace_back(columnStatistics<TypeKind::BOOLEAN>(columns));
+        break;
+      case TypeKind::TINYINT:
+        statistics.emplace_back(columnStatistics<TypeKind::TINYINT>(columns));
+        break;
+      case TypeKind::SMALLINT:
+        statistics.emplace_back(columnStatistics<TypeKind::SMALLINT>(columns));
+        break;
+      case TypeKind::INTEGER:
+        statistics.emplace_back(columnStatistics<TypeKind::INTEGER>(columns));
+        break;
+      case TypeKind::BIGINT:
+        statistics.emplace_back(columnStatistics<TypeKind::BIGINT>(columns));
+        break;
+      case TypeKind::REAL:
+        statistics.emplace_back(columnStatistics<TypeKind::REAL>(columns));
+        break;
+      case TypeKind::DOUBLE:
+        statistics.emplace_back(columnStatistics<TypeKind::DOUBLE>(columns));
+        break;
+      case TypeKind::TIMESTAMP:
+        statistics.emplace_back(columnStatistics<TypeKind::TIMESTAMP>(columns));
+        break;
+      case TypeKind::DATE:
+        statistics.emplace_back(columnStatistics<TypeKind::DATE>(columns));
+        break;
+      default:
+        statistics.emplace_back(nullStatistics(columns));
+    }
+  }
+  return statistics;
+}
+
 std::shared_ptr<ColumnarBatch> VeloxColumnarBatchSerializer::deserialize(uint8_t* data, int32_t size) {
-  RowVectorPtr result;
-  auto byteStream = toByteStream(data, size);
-  serde_->deserialize(byteStream.get(), veloxPool_.get(), rowType_, &result, /* serdeOptions */ nullptr);
-  return std::make_shared<VeloxColumnarBatch>(result);
+  return std::make_shared<VeloxColumnarBatch>(deserializeRowVector(data, size, veloxPool_.get()));
+}
+
+std::shared_ptr<ColumnarBatch>
+VeloxColumnarBatchSerializer::deserializeShared(const std::string& key, uint8_t* data, int32_t size) {
+  auto shared = SharedBatchCache::instance().getOrCreate(key, [&]() -> std::shared_ptr<ColumnarBatch> {
+    return std::make_shared<VeloxColumnarBatch>(deserializeRowVector(data, size, defaultLeafVeloxMemoryPool().get()));
+  });
+  // Each caller gets its own row vector over the shared children. As the children are referenced by the shared batch
+  // too, Velox doesn't reuse them in place.
+  auto rowVector = std::dynamic_pointer_cast<VeloxColumnarBatch>(shared)->getRowVector();
+  auto wrapper = std::make_shared<RowVector>(
+      rowVector->pool(), rowVector->type(), rowVector->nulls(), rowVector->size(), rowVector->children());
+  // The default leaf pool isn't tracked by Spark, so every caller's task is charged the batch while it holds it.
+  auto bytes = static_cast<int64_t>(rowVector->retainedSize());
+  auto* listener = listener_;
+  if (listener != nullptr) {
+    listener->allocationChanged(bytes);
+  }
+  auto release = [shared, listener, bytes](ColumnarBatch* batch) {
+    delete batch;
+    if (listener != nullptr) {
+      listener->allocationChanged(-bytes);
+    }
+  };
+  return std::shared_ptr<ColumnarBatch>(new VeloxColumnarBatch(wrapper), release);
 }
 } // namespace gluten
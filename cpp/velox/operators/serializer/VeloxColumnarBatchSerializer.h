@@ -18,29 +18,71 @@
 #pragma once
 
 #include <arrow/c/abi.h>
+#include <arrow/util/compression.h>
 
+#include "memory/ArenaMemoryAllocator.h"
 #include "memory/ColumnarBatch.h"
 #include "operators/serializer/ColumnarBatchSerializer.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 namespace gluten {
 
+// Batches whose columns are all of scalar types are serialized in a compact columnar format: the raw nulls and values
+// buffers of each column, each compressed with codec if it's set. Constant columns keep one value and string columns
+// with few distinct values keep them once with an index per row, and are deserialized as constant and dictionary
+// vectors. Deserialized vectors wrap one copy of the received buffer, or the decompressed buffers. Batches with
+// complex types are serialized with the Presto serde.
 class VeloxColumnarBatchSerializer final : public ColumnarBatchSerializer {
  public:
+  // If arena is set, serializeColumnarBatches() allocates its temporary streams from arenaVeloxPool, a pool over
+  // arena, and resets the arena before each call.
   VeloxColumnarBatchSerializer(
       std::shared_ptr<arrow::MemoryPool> arrowPool,
       std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool,
-      struct ArrowSchema* cSchema);
+      struct ArrowSchema* cSchema,
+      std::shared_ptr<ArenaMemoryAllocator> arena = nullptr,
+      std::shared_ptr<facebook::velox::memory::MemoryPool> arenaVeloxPool = nullptr,
+      arrow::Compression::type codec = arrow::Compression::UNCOMPRESSED);
 
   std::shared_ptr<arrow::Buffer> serializeColumnarBatches(
       const std::vector<std::shared_ptr<ColumnarBatch>>& batches) override;
 
   std::shared_ptr<ColumnarBatch> deserialize(uint8_t* data, int32_t size) override;
 
+  // Bounds of the integral, boolean, date, timestamp and floating point columns. Decimal and string columns, and
+  // floating point columns holding NaN, have none.
+  std::vector<ColumnStatistics> computeStatistics(const std::vector<std::shared_ptr<ColumnarBatch>>& batches) override;
+
+  // Shared batches are allocated from the default leaf pool since they outlive the task deserializing them. The task of
+  // each caller is charged their retained size through the listener of arrowPool while it holds the returned batch, a
+  // row vector of its own over the shared children.
+  std::shared_ptr<ColumnarBatch> deserializeShared(const std::string& key, uint8_t* data, int32_t size) override;
+
  private:
+  std::shared_ptr<arrow::Buffer> serializeCompact(
+      const std::vector<facebook::velox::RowVectorPtr>& rowVectors,
+      int64_t numRows,
+      facebook::velox::memory::MemoryPool* pool);
+
+  std::shared_ptr<arrow::Buffer> serializePresto(
+      const std::vector<facebook::velox::RowVectorPtr>& rowVectors,
+      int64_t numRows,
+      facebook::velox::memory::MemoryPool* pool);
+
+  facebook::velox::RowVectorPtr
+  deserializeRowVector(uint8_t* data, int32_t size, facebook::velox::memory::MemoryPool* pool);
+
+  arrow::util::Codec* getCodec(arrow::Compression::type type);
+
+  std::shared_ptr<ArenaMemoryAllocator> arena_;
+  // Of arrowPool, null if it isn't over a ListenableMemoryAllocator.
+  AllocationListener* listener_ = nullptr;
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
+  std::shared_ptr<facebook::velox::memory::MemoryPool> arenaVeloxPool_;
   facebook::velox::RowTypePtr rowType_;
   std::unique_ptr<facebook::velox::serializer::presto::PrestoVectorSerde> serde_;
+  arrow::Compression::type codecType_;
+  std::unordered_map<arrow::Compression::type, std::unique_ptr<arrow::util::Codec>> codecs_;
 };
 
 } // namespace gluten
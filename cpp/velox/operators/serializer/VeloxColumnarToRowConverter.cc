@@ -21,23 +21,77 @@
 #include "velox/row/UnsafeRowDeserializers.h"
 #include "velox/row/UnsafeRowFast.h"
 
+#include <folly/futures/Future.h>
+
 using namespace facebook;
 
 namespace gluten {
 
+namespace {
+int32_t alignToWord(int32_t size) {
+  return (size + 7) & ~7;
+}
+
+bool isStringKind(velox::TypeKind kind) {
+  return kind == velox::TypeKind::VARCHAR || kind == velox::TypeKind::VARBINARY;
+}
+} // namespace
+
+bool VeloxColumnarToRowConverter::decodeStringColumns(const velox::RowVectorPtr& rowVector) {
+  stringColumns_.clear();
+  velox::SelectivityVector rows(numRows_);
+  for (const auto& child : rowVector->children()) {
+    if (isStringKind(child->typeKind())) {
+      stringColumns_.push_back(std::make_unique<velox::DecodedVector>(*child, rows));
+    } else if (!velox::row::UnsafeRowFast::fixedRowSize(velox::ROW({child->type()}))) {
+      stringColumns_.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
 void VeloxColumnarToRowConverter::refreshStates(facebook::velox::RowVectorPtr rowVector) {
   numRows_ = rowVector->size();
   numCols_ = rowVector->childrenSize();
 
   fast_ = std::make_unique<velox::row::UnsafeRowFast>(rowVector);
 
-  size_t totalMemorySize = 0;
+  lengths_.resize(numRows_);
+  offsets_.resize(numRows_);
+  fixedRegionSize_ = velox::bits::nwords(numCols_) * 8 + numCols_ * 8;
   if (auto fixedRowSize = velox::row::UnsafeRowFast::fixedRowSize(velox::asRowType(rowVector->type()))) {
-    totalMemorySize += fixedRowSize.value() * numRows_;
+    stringColumns_.clear();
+    std::fill(lengths_.begin(), lengths_.end(), fixedRowSize.value());
+    exactRowSizes_ = true;
+  } else if (decodeStringColumns(rowVector)) {
+    // Column by column, each string value takes its length rounded up to a word.
+    std::fill(lengths_.begin(), lengths_.end(), fixedRegionSize_);
+    for (const auto& decoded : stringColumns_) {
+      for (auto i = 0; i < numRows_; ++i) {
+        if (!decoded->isNullAt(i)) {
+          lengths_[i] += alignToWord(decoded->valueAt<velox::StringView>(i).size());
+        }
+      }
+    }
+    exactRowSizes_ = true;
   } else {
     for (auto i = 0; i < numRows_; ++i) {
-      totalMemorySize += fast_->rowSize(i);
+      lengths_[i] = fast_->rowSize(i);
     }
+    exactRowSizes_ = false;
+  }
+
+  size_t totalMemorySize = 0;
+  for (auto i = 0; i < numRows_; ++i) {
+    offsets_[i] = totalMemorySize;
+    totalMemorySize += lengths_[i];
+  }
+
+  if (arena_ != nullptr) {
+    // The rows of the previous batch have been consumed.
+    veloxBuffers_ = nullptr;
+    arena_->reset();
   }
 
   if (veloxBuffers_ == nullptr) {
@@ -50,27 +104,65 @@ void VeloxColumnarToRowConverter::refreshStates(facebook::velox::RowVectorPtr ro
   }
 
   bufferAddress_ = veloxBuffers_->asMutable<uint8_t>();
-  memset(bufferAddress_, 0, sizeof(int8_t) * totalMemorySize);
+  if (!exactRowSizes_) {
+    memset(bufferAddress_, 0, sizeof(int8_t) * totalMemorySize);
+  }
+}
+
+void VeloxColumnarToRowConverter::zeroUnwrittenBytes(int32_t rowIdx, uint8_t* row) {
+  memset(row, 0, fixedRegionSize_);
+  auto offset = fixedRegionSize_;
+  for (const auto& decoded : stringColumns_) {
+    if (decoded->isNullAt(rowIdx)) {
+      continue;
+    }
+    auto size = alignToWord(decoded->valueAt<velox::StringView>(rowIdx).size());
+    if (size > 0) {
+      // The value overwrites the head of its last word.
+      memset(row + offset + size - 8, 0, 8);
+    }
+    offset += size;
+  }
 }
 
 void VeloxColumnarToRowConverter::convert(std::shared_ptr<ColumnarBatch> cb) {
   auto veloxBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
   refreshStates(veloxBatch->getRowVector());
 
-  // Initialize the offsets_ , lengths_
-  lengths_.clear();
-  offsets_.clear();
-  lengths_.resize(numRows_, 0);
-  offsets_.resize(numRows_, 0);
-
-  size_t offset = 0;
-  for (auto rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
-    auto rowSize = fast_->serialize(rowIdx, (char*)(bufferAddress_ + offset));
-    lengths_[rowIdx] = rowSize;
-    if (rowIdx > 0) {
-      offsets_[rowIdx] = offsets_[rowIdx - 1] + lengths_[rowIdx - 1];
+  if (executor_ != nullptr && numThreads_ > 0 && numRows_ >= std::max(parallelThreshold_, numThreads_ + 1)) {
+    serializeRowsParallel();
+  } else {
+    serializeRows(0, numRows_);
+  }
+}
+
+void VeloxColumnarToRowConverter::serializeRowsParallel() {
+  int32_t numRanges = numThreads_ + 1;
+  int32_t rangeSize = (numRows_ + numRanges - 1) / numRanges;
+
+  // UnsafeRowFast and the decoded string columns are only read while serializing.
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(numRanges);
+  for (int32_t begin = rangeSize; begin < numRows_; begin += rangeSize) {
+    auto end = std::min(begin + rangeSize, numRows_);
+    futures.emplace_back(folly::via(executor_, [this, begin, end]() { serializeRows(begin, end); }));
+  }
+  // The first range runs on the calling thread.
+  futures.emplace_back(folly::makeFutureWith([this, rangeSize]() { serializeRows(0, std::min(rangeSize, numRows_)); }));
+  // Wait for all ranges before rethrowing, they write to the buffer.
+  for (auto& result : folly::collectAll(futures).get()) {
+    result.throwIfFailed();
+  }
+}
+
+void VeloxColumnarToRowConverter::serializeRows(int32_t begin, int32_t end) {
+  for (auto rowIdx = begin; rowIdx < end; ++rowIdx) {
+    auto* row = bufferAddress_ + offsets_[rowIdx];
+    if (exactRowSizes_) {
+      zeroUnwrittenBytes(rowIdx, row);
     }
-    offset += rowSize;
+    auto rowSize = fast_->serialize(rowIdx, reinterpret_cast<char*>(row));
+    VELOX_DCHECK_EQ(rowSize, lengths_[rowIdx]);
   }
 }
 
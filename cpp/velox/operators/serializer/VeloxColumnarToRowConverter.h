@@ -19,27 +19,67 @@
 
 #include <arrow/memory_pool.h>
 #include <arrow/type.h>
+#include <folly/Executor.h>
 
+#include "memory/ArenaMemoryAllocator.h"
 #include "operators/c2r/ColumnarToRow.h"
 #include "velox/buffer/Buffer.h"
 #include "velox/row/UnsafeRowFast.h"
 #include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace gluten {
 
 class VeloxColumnarToRowConverter final : public ColumnarToRowConverter {
  public:
-  explicit VeloxColumnarToRowConverter(std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool)
-      : ColumnarToRowConverter(), veloxPool_(veloxPool) {}
+  // If arena is set, veloxPool allocates from it and the arena is reset before each batch. Otherwise the row buffer is
+  // reused across batches and only grows.
+  // Batches of at least parallelThreshold rows are serialized in numThreads + 1 row ranges concurrently on executor,
+  // if set and numThreads > 0.
+  explicit VeloxColumnarToRowConverter(
+      std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool,
+      std::shared_ptr<ArenaMemoryAllocator> arena = nullptr,
+      folly::Executor* executor = nullptr,
+      int32_t numThreads = 0,
+      int32_t parallelThreshold = 0)
+      : ColumnarToRowConverter(),
+        arena_(std::move(arena)),
+        veloxPool_(veloxPool),
+        executor_(executor),
+        numThreads_(numThreads),
+        parallelThreshold_(parallelThreshold) {}
 
   void convert(std::shared_ptr<ColumnarBatch> cb) override;
 
  private:
   void refreshStates(facebook::velox::RowVectorPtr rowVector);
 
+  // Decodes the string columns into stringColumns_. Returns false if a column is neither fixed width nor a string.
+  bool decodeStringColumns(const facebook::velox::RowVectorPtr& rowVector);
+
+  // Zeroes the bytes of the row that UnsafeRowFast doesn't write: the null bitset, the fixed-width slots and the
+  // padding of the string values.
+  void zeroUnwrittenBytes(int32_t rowIdx, uint8_t* row);
+
+  void serializeRows(int32_t begin, int32_t end);
+
+  // The offsets are known before serialization, so the ranges write to disjoint parts of the buffer.
+  void serializeRowsParallel();
+
+  std::shared_ptr<ArenaMemoryAllocator> arena_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
+  folly::Executor* const executor_;
+  const int32_t numThreads_;
+  const int32_t parallelThreshold_;
   std::shared_ptr<facebook::velox::row::UnsafeRowFast> fast_;
   facebook::velox::BufferPtr veloxBuffers_;
+
+  // Whether the row sizes are computed from the column lengths, so that only the bytes UnsafeRowFast doesn't write
+  // need to be zeroed.
+  bool exactRowSizes_ = false;
+  // Null bitset and fixed-width slots.
+  int32_t fixedRegionSize_ = 0;
+  std::vector<std::unique_ptr<facebook::velox::DecodedVector>> stringColumns_;
 };
 
 } // namespace gluten
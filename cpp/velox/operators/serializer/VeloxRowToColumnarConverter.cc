@@ -22,16 +22,122 @@
 
 using namespace facebook::velox;
 namespace gluten {
+
+namespace {
+bool isFlatKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Sets the nulls of the vector from bit col of the null bitsets. The nulls buffer is only allocated if there is any.
+void readNulls(int32_t col, const std::vector<const uint8_t*>& rows, BaseVector* vector) {
+  uint64_t* rawNulls = nullptr;
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (bits::isBitSet(reinterpret_cast<const uint64_t*>(rows[i]), col)) {
+      if (rawNulls == nullptr) {
+        rawNulls = vector->mutableRawNulls();
+      }
+      bits::setNull(rawNulls, i);
+    }
+  }
+}
+
+template <typename T>
+VectorPtr readFixedWidth(
+    int32_t col,
+    int32_t fieldOffset,
+    const TypePtr& type,
+    const std::vector<const uint8_t*>& rows,
+    memory::MemoryPool* pool) {
+  auto vector = BaseVector::create<FlatVector<T>>(type, rows.size(), pool);
+  readNulls(col, rows, vector.get());
+  // Values of null fields are zeroes.
+  auto* values = vector->mutableRawValues();
+  for (auto i = 0; i < rows.size(); ++i) {
+    memcpy(values + i, rows[i] + fieldOffset, sizeof(T));
+  }
+  return vector;
+}
+
+template <>
+VectorPtr readFixedWidth<bool>(
+    int32_t col,
+    int32_t fieldOffset,
+    const TypePtr& type,
+    const std::vector<const uint8_t*>& rows,
+    memory::MemoryPool* pool) {
+  auto vector = BaseVector::create<FlatVector<bool>>(type, rows.size(), pool);
+  // Bit-packed, so no strided copy. Nulls are read afterwards as set() clears them.
+  for (auto i = 0; i < rows.size(); ++i) {
+    vector->set(i, rows[i][fieldOffset] != 0);
+  }
+  readNulls(col, rows, vector.get());
+  return vector;
+}
+
+VectorPtr readString(
+    int32_t col,
+    int32_t fieldOffset,
+    const TypePtr& type,
+    const std::vector<const uint8_t*>& rows,
+    memory::MemoryPool* pool) {
+  auto vector = BaseVector::create<FlatVector<StringView>>(type, rows.size(), pool);
+  readNulls(col, rows, vector.get());
+  // The field holds the offset of the value in the row in the upper half and its size in the lower half.
+  auto offsetAndSize = [&](auto i) {
+    uint64_t field;
+    memcpy(&field, rows[i] + fieldOffset, sizeof(field));
+    return std::make_pair(static_cast<int32_t>(field >> 32), static_cast<int32_t>(field));
+  };
+  size_t totalSize = 0;
+  for (auto i = 0; i < rows.size(); ++i) {
+    totalSize += offsetAndSize(i).second;
+  }
+  // One buffer for the values of all rows.
+  auto buffer = AlignedBuffer::allocate<char>(totalSize, pool);
+  auto* bufferAddress = buffer->asMutable<char>();
+  auto* rawValues = vector->mutableRawValues();
+  for (auto i = 0; i < rows.size(); ++i) {
+    auto [offset, size] = offsetAndSize(i);
+    memcpy(bufferAddress, rows[i] + offset, size);
+    rawValues[i] = StringView(bufferAddress, size);
+    bufferAddress += size;
+  }
+  vector->addStringBuffer(std::move(buffer));
+  return vector;
+}
+} // namespace
+
 VeloxRowToColumnarConverter::VeloxRowToColumnarConverter(
     struct ArrowSchema* cSchema,
     std::shared_ptr<memory::MemoryPool> memoryPool)
     : RowToColumnarConverter(), pool_(memoryPool) {
   rowType_ = importFromArrow(*cSchema); // otherwise the c schema leaks memory
   ArrowSchemaRelease(cSchema);
+  flatSchema_ = true;
+  for (const auto& child : asRowType(rowType_)->children()) {
+    flatSchema_ &= isFlatKind(child->kind());
+  }
+  nullBitsetWidth_ = bits::nwords(rowType_->size()) * 8;
 }
 
 std::shared_ptr<ColumnarBatch>
 VeloxRowToColumnarConverter::convert(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress) {
+  if (flatSchema_) {
+    return std::make_shared<VeloxColumnarBatch>(convertFlat(numRows, rowLength, memoryAddress));
+  }
   std::vector<std::optional<std::string_view>> data;
   int64_t offset = 0;
   for (auto i = 0; i < numRows; i++) {
@@ -41,4 +147,51 @@ VeloxRowToColumnarConverter::convert(int64_t numRows, int64_t* rowLength, uint8_
   auto vp = row::UnsafeRowDeserializer::deserialize(data, rowType_, pool_.get());
   return std::make_shared<VeloxColumnarBatch>(std::dynamic_pointer_cast<RowVector>(vp));
 }
+
+RowVectorPtr VeloxRowToColumnarConverter::convertFlat(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress) {
+  std::vector<const uint8_t*> rows(numRows);
+  int64_t offset = 0;
+  for (auto i = 0; i < numRows; i++) {
+    rows[i] = memoryAddress + offset;
+    offset += rowLength[i];
+  }
+
+  const auto& type = asRowType(rowType_);
+  std::vector<VectorPtr> children(type->size());
+  for (auto col = 0; col < type->size(); ++col) {
+    const auto& childType = type->childAt(col);
+    auto fieldOffset = nullBitsetWidth_ + col * 8;
+    switch (childType->kind()) {
+      case TypeKind::BOOLEAN:
+        children[col] = readFixedWidth<bool>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::TINYINT:
+        children[col] = readFixedWidth<int8_t>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::SMALLINT:
+        children[col] = readFixedWidth<int16_t>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::INTEGER:
+        children[col] = readFixedWidth<int32_t>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::BIGINT:
+        children[col] = readFixedWidth<int64_t>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::REAL:
+        children[col] = readFixedWidth<float>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::DOUBLE:
+        children[col] = readFixedWidth<double>(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        children[col] = readString(col, fieldOffset, childType, rows, pool_.get());
+        break;
+      default:
+        VELOX_UNREACHABLE("Unexpected type {} in flat schema", childType->toString());
+    }
+  }
+  return std::make_shared<RowVector>(pool_.get(), rowType_, nullptr, numRows, std::move(children));
+}
+
 } // namespace gluten
@@ -34,8 +34,15 @@ class VeloxRowToColumnarConverter final : public RowToColumnarConverter {
   std::shared_ptr<ColumnarBatch> convert(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress);
 
  protected:
+  // Transposes the rows column by column at the field offsets known from the schema, instead of deserializing them
+  // field by field.
+  facebook::velox::RowVectorPtr convertFlat(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress);
+
   facebook::velox::TypePtr rowType_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
+  // Whether all columns are of fixed-width types or strings, i.e. supported by convertFlat.
+  bool flatSchema_;
+  int32_t nullBitsetWidth_;
 };
 
 } // namespace gluten
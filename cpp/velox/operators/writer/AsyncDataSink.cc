@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncDataSink.h"
+
+#include <algorithm>
+
+#include <folly/executors/IOThreadPoolExecutor.h>
+
+using namespace facebook;
+using namespace facebook::velox::dwio::common;
+
+namespace gluten {
+
+namespace {
+// Shared by the sinks of all writers in the executor, sized by the first sink asking for it.
+folly::Executor* writeExecutor(int32_t numThreads) {
+  static auto executor = std::make_unique<folly::IOThreadPoolExecutor>(numThreads);
+  return executor.get();
+}
+} // namespace
+
+WriteFileDataSink::WriteFileDataSink(std::unique_ptr<velox::WriteFile> file, const std::string& name)
+    : DataSink(name), file_(std::move(file)) {}
+
+void WriteFileDataSink::write(std::vector<DataBuffer<char>>& buffers) {
+  for (auto& buffer : buffers) {
+    file_->append(std::string_view(buffer.data(), buffer.size()));
+    size_ += buffer.size();
+  }
+  buffers.clear();
+}
+
+void WriteFileDataSink::doClose() {
+  file_->close();
+}
+
+AsyncDataSink::AsyncDataSink(
+    std::unique_ptr<DataSink> sink,
+    const std::string& name,
+    int64_t maxBufferedBytes,
+    int32_t numIOThreads)
+    : DataSink(name),
+      sink_(std::move(sink)),
+      maxBufferedBytes_(maxBufferedBytes),
+      executor_(writeExecutor(std::max(1, numIOThreads))) {}
+
+AsyncDataSink::~AsyncDataSink() {
+  // The drain task refers to this.
+  std::unique_lock<std::mutex> lock(mutex_);
+  waitDrainedLocked(lock);
+}
+
+void AsyncDataSink::write(std::vector<DataBuffer<char>>& buffers) {
+  int64_t bytes = 0;
+  for (const auto& buffer : buffers) {
+    bytes += buffer.size();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A single flush larger than the limit is still taken once the queue is empty.
+  cv_.wait(lock, [&]() { return error_ || bufferedBytes_ == 0 || bufferedBytes_ + bytes <= maxBufferedBytes_; });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  pending_.push_back({std::move(buffers), bytes});
+  buffers.clear();
+  bufferedBytes_ += bytes;
+  size_ += bytes;
+  if (!draining_) {
+    draining_ = true;
+    executor_->add([this]() { drain(); });
+  }
+}
+
+void AsyncDataSink::drain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!pending_.empty()) {
+    auto pending = std::move(pending_.front());
+    pending_.pop_front();
+    if (!error_) {
+      lock.unlock();
+      try {
+        sink_->write(pending.buffers);
+      } catch (...) {
+        lock.lock();
+        error_ = std::current_exception();
+        lock.unlock();
+      }
+      // Frees the buffers out of the lock.
+      pending.buffers.clear();
+      lock.lock();
+    }
+    bufferedBytes_ -= pending.bytes;
+    cv_.notify_all();
+  }
+  draining_ = false;
+  cv_.notify_all();
+}
+
+void AsyncDataSink::waitDrainedLocked(std::unique_lock<std::mutex>& lock) {
+  cv_.wait(lock, [&]() { return !draining_; });
+}
+
+void AsyncDataSink::doClose() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitDrainedLocked(lock);
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+  sink_->close();
+}
+
+} // namespace gluten
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include <folly/Executor.h>
+
+#include "velox/common/file/File.h"
+#include "velox/dwio/common/DataSink.h"
+
+namespace gluten {
+
+// DataSink over the WriteFile of the file system registered in Velox for the path, e.g. S3.
+class WriteFileDataSink final : public facebook::velox::dwio::common::DataSink {
+ public:
+  WriteFileDataSink(std::unique_ptr<facebook::velox::WriteFile> file, const std::string& name);
+
+  void write(std::vector<facebook::velox::dwio::common::DataBuffer<char>>& buffers) override;
+
+ protected:
+  void doClose() override;
+
+ private:
+  std::unique_ptr<facebook::velox::WriteFile> file_;
+};
+
+// Hands the buffers flushed by the writer, a row group at a time, over to an IO thread that writes them to the sink,
+// so that encoding the next row group overlaps with the upload of the last one. Up to maxBufferedBytes are queued,
+// beyond which write() blocks. Errors of the sink are rethrown by the next write() or by close().
+class AsyncDataSink final : public facebook::velox::dwio::common::DataSink {
+ public:
+  AsyncDataSink(
+      std::unique_ptr<facebook::velox::dwio::common::DataSink> sink,
+      const std::string& name,
+      int64_t maxBufferedBytes,
+      int32_t numIOThreads);
+
+  ~AsyncDataSink() override;
+
+  void write(std::vector<facebook::velox::dwio::common::DataBuffer<char>>& buffers) override;
+
+ protected:
+  void doClose() override;
+
+ private:
+  struct Pending {
+    std::vector<facebook::velox::dwio::common::DataBuffer<char>> buffers;
+    int64_t bytes;
+  };
+
+  void drain();
+
+  void waitDrainedLocked(std::unique_lock<std::mutex>& lock);
+
+  std::unique_ptr<facebook::velox::dwio::common::DataSink> sink_;
+  const int64_t maxBufferedBytes_;
+  folly::Executor* executor_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Pending> pending_;
+  int64_t bufferedBytes_ = 0;
+  bool draining_ = false;
+  std::exception_ptr error_;
+};
+
+} // namespace gluten
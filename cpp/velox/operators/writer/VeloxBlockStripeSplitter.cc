@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VeloxBlockStripeSplitter.h"
+
+#include <algorithm>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryPool.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+std::shared_ptr<BlockStripes> VeloxBlockStripeSplitter::split(
+    std::shared_ptr<ColumnarBatch> batch,
+    const std::vector<int32_t>& partitionColIndice,
+    bool hasBucket) {
+  auto pool = defaultLeafVeloxMemoryPool().get();
+  auto rowVector = VeloxColumnarBatch::from(pool, batch)->getFlattenedRowVector();
+  auto numRows = rowVector->size();
+  auto numColumns = static_cast<int32_t>(rowVector->childrenSize());
+
+  std::vector<int32_t> keyColumns = partitionColIndice;
+  if (hasBucket) {
+    // The bucket id, not written to the files either.
+    keyColumns.push_back(numColumns - 1);
+  }
+
+  auto stripes = std::make_shared<BlockStripes>();
+  if (numRows > 0) {
+    stripes->headingRowIndice.push_back(0);
+  }
+  for (velox::vector_size_t row = 1; row < numRows; ++row) {
+    for (auto column : keyColumns) {
+      const auto& key = rowVector->childAt(column);
+      if (!key->equalValueAt(key.get(), row - 1, row)) {
+        stripes->headingRowIndice.push_back(row);
+        break;
+      }
+    }
+  }
+
+  std::vector<std::string> names;
+  std::vector<velox::TypePtr> types;
+  std::vector<int32_t> dataColumns;
+  const auto& rowType = velox::asRowType(rowVector->type());
+  for (int32_t column = 0; column < numColumns; ++column) {
+    if (std::find(keyColumns.begin(), keyColumns.end(), column) == keyColumns.end()) {
+      names.push_back(rowType->nameOf(column));
+      types.push_back(rowType->childAt(column));
+      dataColumns.push_back(column);
+    }
+  }
+  auto dataType = velox::ROW(std::move(names), std::move(types));
+
+  auto numStripes = static_cast<int32_t>(stripes->headingRowIndice.size());
+  auto headingRows = velox::BaseVector::create<velox::RowVector>(rowVector->type(), numStripes, pool);
+  for (int32_t i = 0; i < numStripes; ++i) {
+    auto from = stripes->headingRowIndice[i];
+    auto to = i + 1 < numStripes ? stripes->headingRowIndice[i + 1] : numRows;
+    headingRows->copy(rowVector.get(), i, from, 1);
+
+    std::vector<velox::VectorPtr> children;
+    children.reserve(dataColumns.size());
+    for (auto column : dataColumns) {
+      // Zero copy, and none at all for a batch of one partition.
+      children.push_back(
+          numStripes == 1 ? rowVector->childAt(column) : rowVector->childAt(column)->slice(from, to - from));
+    }
+    stripes->stripes.push_back(std::make_shared<VeloxColumnarBatch>(
+        std::make_shared<velox::RowVector>(pool, dataType, nullptr, to - from, std::move(children))));
+  }
+  stripes->headingRows = std::make_shared<VeloxColumnarBatch>(headingRows);
+  return stripes;
+}
+
+} // namespace gluten
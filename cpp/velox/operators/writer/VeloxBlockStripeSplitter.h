@@ -0,0 +1,33 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "memory/ColumnarBatch.h"
+#include "operators/writer/Datasource.h"
+
+namespace gluten {
+
+// Splits the batches of a partitioned write into BlockStripes natively, so that the writer of each partition is
+// switched by stripe rather than by row. Counterpart of the BlockStripeSplitter of the CH backend.
+class VeloxBlockStripeSplitter {
+ public:
+  static std::shared_ptr<BlockStripes>
+  split(std::shared_ptr<ColumnarBatch> batch, const std::vector<int32_t>& partitionColIndice, bool hasBucket);
+};
+
+} // namespace gluten
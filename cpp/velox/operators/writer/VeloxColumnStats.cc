@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VeloxColumnStats.h"
+
+#include <folly/hash/Hash.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/json.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/vector/SimpleVector.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+void VeloxColumnStats::HyperLogLog::insertHash(uint64_t hash) {
+  auto index = hash >> (64 - kIndexBits);
+  // The leading zeros of the rest, plus one. The low bit set bounds it.
+  auto rank = static_cast<uint8_t>(__builtin_clzll((hash << kIndexBits) | (1ULL << (kIndexBits - 1))) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+int64_t VeloxColumnStats::HyperLogLog::cardinality() const {
+  const double m = registers_.size();
+  double sum = 0;
+  int32_t numZeros = 0;
+  for (auto r : registers_) {
+    sum += std::ldexp(1.0, -r);
+    numZeros += r == 0;
+  }
+  auto estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  // Linear counting for the small cardinalities.
+  if (estimate <= 2.5 * m && numZeros > 0) {
+    estimate = m * std::log(m / numZeros);
+  }
+  return std::llround(estimate);
+}
+
+VeloxColumnStats::VeloxColumnStats(const velox::RowTypePtr& type) {
+  columns_.resize(type->size());
+  for (auto i = 0; i < type->size(); ++i) {
+    columns_[i].name = type->nameOf(i);
+    columns_[i].type = type->childAt(i);
+  }
+}
+
+template <typename T>
+void VeloxColumnStats::addValues(const velox::VectorPtr& vector, Column& column) {
+  auto* values = vector->as<velox::SimpleVector<T>>();
+  for (auto row = 0; row < vector->size(); ++row) {
+    if (values->isNullAt(row)) {
+      column.nullCount++;
+      continue;
+    }
+    auto value = values->valueAt(row);
+    if constexpr (std::is_same_v<T, velox::StringView>) {
+      column.ndv.insertHash(folly::hash::SpookyHashV2::Hash64(value.data(), value.size(), 0));
+      if (!column.hasMinMax || value < velox::StringView(column.minString)) {
+        column.minString = value.str();
+      }
+      if (!column.hasMinMax || velox::StringView(column.maxString) < value) {
+        column.maxString = value.str();
+      }
+    } else if constexpr (std::is_floating_point_v<T>) {
+      double d = value;
+      uint64_t bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      column.ndv.insertHash(folly::hash::twang_mix64(bits));
+      if (std::isnan(d)) {
+        continue;
+      }
+      column.minDouble = column.hasMinMax ? std::min(column.minDouble, d) : d;
+      column.maxDouble = column.hasMinMax ? std::max(column.maxDouble, d) : d;
+    } else {
+      int64_t i = value;
+      column.ndv.insertHash(folly::hash::twang_mix64(static_cast<uint64_t>(i)));
+      column.minInt = column.hasMinMax ? std::min(column.minInt, i) : i;
+      column.maxInt = column.hasMinMax ? std::max(column.maxInt, i) : i;
+    }
+    column.hasMinMax = true;
+  }
+}
+
+void VeloxColumnStats::add(const velox::RowVectorPtr& batch) {
+  numRows_ += batch->size();
+  for (auto i = 0; i < columns_.size(); ++i) {
+    const auto& child = batch->childAt(i);
+    auto& column = columns_[i];
+    // The unscaled values of the short decimals are of BIGINT.
+    auto kind = column.type->isDecimal() ? velox::TypeKind::UNKNOWN : column.type->kind();
+    switch (kind) {
+      case velox::TypeKind::BOOLEAN:
+        addValues<bool>(child, column);
+        break;
+      case velox::TypeKind::TINYINT:
+        addValues<int8_t>(child, column);
+        break;
+      case velox::TypeKind::SMALLINT:
+        addValues<int16_t>(child, column);
+        break;
+      case velox::TypeKind::INTEGER:
+        addValues<int32_t>(child, column);
+        break;
+      case velox::TypeKind::BIGINT:
+        addValues<int64_t>(child, column);
+        break;
+      case velox::TypeKind::REAL:
+        addValues<float>(child, column);
+        break;
+      case velox::TypeKind::DOUBLE:
+        addValues<double>(child, column);
+        break;
+      case velox::TypeKind::VARCHAR:
+      case velox::TypeKind::VARBINARY:
+        addValues<velox::StringView>(child, column);
+        break;
+      default:
+        // Complex types, timestamps and decimals, only their nulls are counted.
+        for (auto row = 0; row < child->size(); ++row) {
+          column.nullCount += child->isNullAt(row);
+        }
+    }
+  }
+}
+
+std::string VeloxColumnStats::toJson() const {
+  auto columns = folly::dynamic::array();
+  for (const auto& column : columns_) {
+    auto stats = folly::dynamic::object("name", column.name)("nullCount", column.nullCount);
+    if (column.hasMinMax) {
+      switch (column.type->kind()) {
+        case velox::TypeKind::VARCHAR:
+          stats("min", column.minString)("max", column.maxString);
+          break;
+        case velox::TypeKind::VARBINARY:
+          // Not UTF-8, which JSON takes only.
+          break;
+        case velox::TypeKind::REAL:
+        case velox::TypeKind::DOUBLE:
+          stats("min", column.minDouble)("max", column.maxDouble);
+          break;
+        default:
+          stats("min", column.minInt)("max", column.maxInt);
+      }
+      stats("ndv", column.ndv.cardinality());
+    }
+    columns.push_back(std::move(stats));
+  }
+  return folly::toJson(folly::dynamic::object("numRows", numRows_)("columns", std::move(columns)));
+}
+
+} // namespace gluten
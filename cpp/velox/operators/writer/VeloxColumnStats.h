@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "velox/vector/ComplexVector.h"
+
+namespace gluten {
+
+// The column statistics of a file accumulated from the batches written to it: null count, min, max and the NDV
+// estimated by a HyperLogLog sketch. Min and max are only kept for the columns of the primitive types.
+class VeloxColumnStats {
+ public:
+  explicit VeloxColumnStats(const facebook::velox::RowTypePtr& type);
+
+  void add(const facebook::velox::RowVectorPtr& batch);
+
+  // {"numRows": ..., "columns": [{"name": ..., "nullCount": ..., "min": ..., "max": ..., "ndv": ...}, ...]}.
+  std::string toJson() const;
+
+ private:
+  // Of precision 12, with a standard error about 1.6%.
+  class HyperLogLog {
+   public:
+    void insertHash(uint64_t hash);
+    int64_t cardinality() const;
+
+   private:
+    static constexpr int32_t kIndexBits = 12;
+    std::vector<uint8_t> registers_ = std::vector<uint8_t>(1 << kIndexBits, 0);
+  };
+
+  struct Column {
+    std::string name;
+    facebook::velox::TypePtr type;
+    int64_t nullCount = 0;
+    bool hasMinMax = false;
+    // Of the integral and the floating types and the strings resp.
+    int64_t minInt = 0;
+    int64_t maxInt = 0;
+    double minDouble = 0;
+    double maxDouble = 0;
+    std::string minString;
+    std::string maxString;
+    HyperLogLog ndv;
+  };
+
+  template <typename T>
+  static void addValues(const facebook::velox::VectorPtr& vector, Column& column);
+
+  std::vector<Column> columns_;
+  int64_t numRows_ = 0;
+};
+
+} // namespace gluten
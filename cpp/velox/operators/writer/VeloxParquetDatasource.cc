@@ -16,11 +16,13 @@
  */
 
 #include "VeloxParquetDatasource.h"
+#include "AsyncDataSink.h"
 
 #include <arrow/array/array_base.h>
 #include <arrow/buffer.h>
 #include <arrow/type_traits.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <string>
@@ -42,6 +44,23 @@ using namespace facebook::velox::dwio::common;
 
 namespace gluten {
 
+namespace {
+// Bytes of the row groups flushed by the writer queued to be written to the file on an IO thread, 0 writes them on the
+// task thread.
+const std::string kWriteBufferBytes = "spark.gluten.sql.columnar.backend.velox.writeBufferBytes";
+const int64_t kWriteBufferBytesDefault = 128 << 20;
+
+// The IO threads writing the queued row groups of all the writers in the executor.
+const std::string kWriteIOThreads = "spark.gluten.sql.columnar.backend.velox.writeIOThreads";
+const int32_t kWriteIOThreadsDefault = 8;
+
+// Raw bytes a writer may buffer before flushing a row group whatever its estimated encoded size.
+const std::string kMaxRowGroupBufferBytes = "spark.gluten.sql.columnar.backend.velox.maxRowGroupBufferBytes";
+
+// Whether the column statistics of the files are collected while writing them, and returned on close.
+const std::string kWriteColumnStats = "spark.gluten.sql.columnar.backend.velox.writeColumnStats";
+} // namespace
+
 void VeloxParquetDatasource::init(const std::unordered_map<std::string, std::string>& sparkConfs) {
   auto backend = std::dynamic_pointer_cast<gluten::VeloxBackend>(gluten::createBackend());
 
@@ -59,8 +78,21 @@ void VeloxParquetDatasource::init(const std::unordered_map<std::string, std::str
 #endif
 
   } else {
-    throw std::runtime_error(
-        "The file path is not local or hdfs when writing data with parquet format in velox backend!");
+    // Any other file system registered in Velox, e.g. S3, which may not support writing.
+    auto fs = velox::filesystems::getFileSystem(filePath_, nullptr);
+    sink_ = std::make_unique<WriteFileDataSink>(fs->openFileForWrite(filePath_), filePath_);
+  }
+
+  int64_t writeBufferBytes = kWriteBufferBytesDefault;
+  if (sparkConfs.find(kWriteBufferBytes) != sparkConfs.end()) {
+    writeBufferBytes = std::stoll(sparkConfs.find(kWriteBufferBytes)->second);
+  }
+  int32_t writeIOThreads = kWriteIOThreadsDefault;
+  if (sparkConfs.find(kWriteIOThreads) != sparkConfs.end()) {
+    writeIOThreads = std::stoi(sparkConfs.find(kWriteIOThreads)->second);
+  }
+  if (writeBufferBytes > 0) {
+    sink_ = std::make_unique<AsyncDataSink>(std::move(sink_), filePath_, writeBufferBytes, writeIOThreads);
   }
 
   if (sparkConfs.find(kParquetBlockSize) != sparkConfs.end()) {
@@ -69,6 +101,13 @@ void VeloxParquetDatasource::init(const std::unordered_map<std::string, std::str
   if (sparkConfs.find(kParquetBlockRows) != sparkConfs.end()) {
     maxRowGroupRows_ = static_cast<int64_t>(stoi(sparkConfs.find(kParquetBlockRows)->second));
   }
+  if (sparkConfs.find(kMaxRowGroupBufferBytes) != sparkConfs.end()) {
+    maxRowGroupBufferBytes_ = std::stoll(sparkConfs.find(kMaxRowGroupBufferBytes)->second);
+  }
+  maxRowGroupBufferBytes_ = std::max(maxRowGroupBufferBytes_, maxRowGroupBytes_);
+  if (sparkConfs.find(kWriteColumnStats) != sparkConfs.end()) {
+    collectColumnStats_ = boost::iequals(sparkConfs.find(kWriteColumnStats)->second, "true");
+  }
   auto compressionCodec = CompressionKind::CompressionKind_SNAPPY;
   if (sparkConfs.find(kParquetCompressionCodec) != sparkConfs.end()) {
     auto compressionCodecStr = sparkConfs.find(kParquetCompressionCodec)->second;
@@ -95,12 +134,14 @@ void VeloxParquetDatasource::init(const std::unordered_map<std::string, std::str
 
   velox::parquet::WriterOptions writeOption;
   writeOption.maxRowGroupLength = maxRowGroupRows_;
-  writeOption.bytesInRowGroup = maxRowGroupBytes_;
+  // The writer only sees the raw bytes, the row groups are flushed by maybeFlushRowGroup() before the cap.
+  writeOption.bytesInRowGroup = maxRowGroupBufferBytes_;
   writeOption.compression = compressionCodec;
   // Setting the ratio to 2 here refers to the grow strategy in the reserve() method of MemoryPool on the arrow side.
   std::unordered_map<std::string, std::string> configData({{velox::core::QueryConfig::kDataBufferGrowRatio, "2"}});
   auto queryCtx = std::make_shared<velox::core::QueryCtx>(nullptr, configData);
 
+  sinkPtr_ = sink_.get();
   parquetWriter_ = std::make_unique<velox::parquet::Writer>(std::move(sink_), writeOption, pool_, schema_);
 }
 
@@ -131,7 +172,36 @@ void VeloxParquetDatasource::close() {
 void VeloxParquetDatasource::write(const std::shared_ptr<ColumnarBatch>& cb) {
   auto veloxBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
   VELOX_DCHECK(veloxBatch != nullptr, "Write batch should be VeloxColumnarBatch");
-  parquetWriter_->write(veloxBatch->getFlattenedRowVector());
+  auto rowVector = veloxBatch->getFlattenedRowVector();
+  stagedBytes_ += rowVector->estimateFlatSize();
+  if (collectColumnStats_) {
+    if (!columnStats_) {
+      columnStats_ = std::make_unique<VeloxColumnStats>(velox::asRowType(rowVector->type()));
+    }
+    columnStats_->add(rowVector);
+  }
+  parquetWriter_->write(rowVector);
+  maybeFlushRowGroup();
+  writtenBytes_ = encodedBytes_ + static_cast<int64_t>(stagedBytes_ * encodedRatio_);
+}
+
+void VeloxParquetDatasource::maybeFlushRowGroup() {
+  // The writer may have flushed on its own caps.
+  updateEncodedRatio();
+  if (stagedBytes_ >= maxRowGroupBufferBytes_ || stagedBytes_ * encodedRatio_ >= maxRowGroupBytes_) {
+    parquetWriter_->flush();
+    updateEncodedRatio();
+  }
+}
+
+void VeloxParquetDatasource::updateEncodedRatio() {
+  auto encodedBytes = static_cast<int64_t>(sinkPtr_->size());
+  if (encodedBytes <= encodedBytes_ || stagedBytes_ == 0) {
+    return;
+  }
+  encodedRatio_ = static_cast<double>(encodedBytes - encodedBytes_) / stagedBytes_;
+  encodedBytes_ = encodedBytes;
+  stagedBytes_ = 0;
 }
 
 } // namespace gluten
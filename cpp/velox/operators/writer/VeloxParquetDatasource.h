@@ -27,9 +27,12 @@
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <parquet/properties.h>
 
+#include <atomic>
+
 #include "memory/ColumnarBatch.h"
 #include "memory/VeloxColumnarBatch.h"
 #include "operators/writer/Datasource.h"
+#include "operators/writer/VeloxColumnStats.h"
 
 #include "velox/common/file/FileSystems.h"
 #ifdef ENABLE_HDFS
@@ -52,13 +55,41 @@ class VeloxParquetDatasource final : public Datasource {
   void inspectSchema(struct ArrowSchema* out) override;
   void write(const std::shared_ptr<ColumnarBatch>& cb) override;
   void close() override;
+  std::string fileStats() override {
+    return columnStats_ ? columnStats_->toJson() : "";
+  }
+  int64_t writtenBytes() override {
+    return writtenBytes_;
+  }
   std::shared_ptr<arrow::Schema> getSchema() override {
     return schema_;
   }
 
  private:
+  // Flushes the row group once its estimated encoded bytes reach maxRowGroupBytes_ or its raw bytes reach
+  // maxRowGroupBufferBytes_.
+  void maybeFlushRowGroup();
+
+  // Learns the ratio of the encoded to the raw bytes from the row groups the writer has flushed to the sink.
+  void updateEncodedRatio();
+
+  // Target of the encoded bytes of a row group.
   int64_t maxRowGroupBytes_ = 134217728; // 128MB
   int64_t maxRowGroupRows_ = 100000000; // 100M
+  // Cap of the raw bytes buffered by the writer.
+  int64_t maxRowGroupBufferBytes_ = 536870912; // 512MB
+
+  // Raw bytes written since the sink last grew, and the sink size then.
+  int64_t stagedBytes_ = 0;
+  int64_t encodedBytes_ = 0;
+  // Encoded bytes per raw byte of the last row group, 1 until one is flushed.
+  double encodedRatio_ = 1.0;
+  // The sink size plus the staged bytes estimated encoded, of the last write().
+  std::atomic<int64_t> writtenBytes_{0};
+
+  // Created at the first batch if the column statistics are collected.
+  bool collectColumnStats_ = false;
+  std::unique_ptr<VeloxColumnStats> columnStats_;
 
   std::string filePath_;
   std::shared_ptr<arrow::Schema> schema_;
@@ -66,6 +97,8 @@ class VeloxParquetDatasource final : public Datasource {
   std::shared_ptr<facebook::velox::parquet::Writer> parquetWriter_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
   std::unique_ptr<facebook::velox::dwio::common::DataSink> sink_;
+  // The sink owned by the writer.
+  facebook::velox::dwio::common::DataSink* sinkPtr_ = nullptr;
 };
 
 } // namespace gluten
@@ -0,0 +1,404 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/AdaptiveCompression.h"
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "utils/compression.h"
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+
+// Leading bytes of a buffer compressed to pick its encoding.
+constexpr int64_t kSampleSize = 4096;
+// Keep buffers raw unless the best encoding saves at least 10%.
+constexpr double kMaxEncodedRatio = 0.9;
+// ZSTD decompresses slower than LZ4, only use it if it is 20% smaller.
+constexpr double kZstdPreferRatio = 0.8;
+
+// |valueWidth u8|bitWidth u8|padding|base i64|
+constexpr int64_t kBitPackHeaderSize = 16;
+
+// Each partition sends the dictionaries it uses once, keep them small.
+constexpr int64_t kDictionaryCapacity = 8 << 10;
+// Leading bytes of a buffer added to the training samples.
+constexpr int64_t kMaxDictionarySampleSize = 16 << 10;
+
+template <typename T>
+void planBitPacking(const uint8_t* input, int64_t inputLength, BitPacking& best) {
+  using U = std::make_unsigned_t<T>;
+  auto numValues = inputLength / sizeof(T);
+  T minValue;
+  T maxValue;
+  memcpy(&minValue, input, sizeof(T));
+  maxValue = minValue;
+  for (int64_t i = 1; i < numValues; ++i) {
+    T value;
+    memcpy(&value, input + i * sizeof(T), sizeof(T));
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+  }
+  uint64_t range = static_cast<U>(static_cast<U>(maxValue) - static_cast<U>(minValue));
+  int32_t bitWidth = range == 0 ? 0 : 64 - __builtin_clzll(range);
+  int64_t encodedLength = kBitPackHeaderSize + (numValues * bitWidth + 7) / 8;
+  if (best.encodedLength < 0 || encodedLength < best.encodedLength) {
+    best = {static_cast<int32_t>(sizeof(T)), bitWidth, static_cast<int64_t>(minValue), encodedLength};
+  }
+}
+
+template <typename T>
+void bitPack(const BitPacking& packing, const uint8_t* input, int64_t inputLength, uint8_t* output) {
+  using U = std::make_unsigned_t<T>;
+  auto base = static_cast<U>(packing.base);
+  auto bitWidth = packing.bitWidth;
+  auto numValues = inputLength / sizeof(T);
+  uint64_t acc = 0;
+  int32_t accBits = 0;
+  for (int64_t i = 0; i < numValues; ++i) {
+    T value;
+    memcpy(&value, input + i * sizeof(T), sizeof(T));
+    uint64_t delta = static_cast<U>(static_cast<U>(value) - base);
+    acc |= delta << accBits;
+    if (accBits + bitWidth >= 64) {
+      memcpy(output, &acc, sizeof(acc));
+      output += sizeof(acc);
+      acc = accBits == 0 ? 0 : delta >> (64 - accBits);
+      accBits = accBits + bitWidth - 64;
+    } else {
+      accBits += bitWidth;
+    }
+  }
+  memcpy(output, &acc, (accBits + 7) / 8);
+}
+
+template <typename T>
+void bitUnpack(
+    const BitPacking& packing,
+    const uint8_t* input,
+    int64_t inputLength,
+    uint8_t* output,
+    int64_t numValues) {
+  using U = std::make_unsigned_t<T>;
+  auto base = static_cast<U>(packing.base);
+  auto bitWidth = packing.bitWidth;
+  uint64_t mask = bitWidth == 64 ? ~0ULL : (1ULL << bitWidth) - 1;
+  const uint8_t* end = input + inputLength;
+  uint64_t acc = 0;
+  int32_t accBits = 0;
+  for (int64_t i = 0; i < numValues; ++i) {
+    uint64_t delta;
+    if (accBits >= bitWidth) {
+      delta = acc & mask;
+      acc = bitWidth == 64 ? 0 : acc >> bitWidth;
+      accBits -= bitWidth;
+    } else {
+      uint64_t next = 0;
+      auto loaded = std::min<int64_t>(sizeof(next), end - input);
+      memcpy(&next, input, loaded);
+      input += loaded;
+      delta = (acc | (next << accBits)) & mask;
+      auto consumed = bitWidth - accBits;
+      acc = consumed == 64 ? 0 : next >> consumed;
+      accBits = loaded * 8 - consumed;
+    }
+    U value = static_cast<U>(delta) + base;
+    memcpy(output + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+// 64 random bits, so that no two map tasks of an application are expected to share a scope.
+uint64_t randomDictionaryScope() {
+  std::random_device device;
+  return static_cast<uint64_t>(device()) << 32 | device();
+}
+
+} // namespace
+
+BitPacking planBitPacking(const uint8_t* input, int64_t inputLength) {
+  BitPacking best;
+  if (inputLength == 0 || inputLength % sizeof(int32_t) != 0) {
+    return best;
+  }
+  planBitPacking<int32_t>(input, inputLength, best);
+  if (inputLength % sizeof(int64_t) == 0) {
+    planBitPacking<int64_t>(input, inputLength, best);
+  }
+  return best;
+}
+
+void bitPack(const BitPacking& packing, const uint8_t* input, int64_t inputLength, uint8_t* output) {
+  memset(output, 0, kBitPackHeaderSize);
+  output[0] = static_cast<uint8_t>(packing.valueWidth);
+  output[1] = static_cast<uint8_t>(packing.bitWidth);
+  memcpy(output + 8, &packing.base, sizeof(int64_t));
+  if (packing.valueWidth == sizeof(int32_t)) {
+    bitPack<int32_t>(packing, input, inputLength, output + kBitPackHeaderSize);
+  } else {
+    bitPack<int64_t>(packing, input, inputLength, output + kBitPackHeaderSize);
+  }
+}
+
+arrow::Status bitUnpack(const uint8_t* input, int64_t inputLength, uint8_t* output, int64_t outputLength) {
+  if (inputLength < kBitPackHeaderSize) {
+    return arrow::Status::Invalid("Bit packed buffer is truncated.");
+  }
+  BitPacking packing;
+  packing.valueWidth = input[0];
+  packing.bitWidth = input[1];
+  memcpy(&packing.base, input + 8, sizeof(int64_t));
+  if ((packing.valueWidth != sizeof(int32_t) && packing.valueWidth != sizeof(int64_t)) ||
+      packing.bitWidth > packing.valueWidth * 8 || outputLength % packing.valueWidth != 0) {
+    return arrow::Status::Invalid("Corrupted bit packed buffer header.");
+  }
+  auto numValues = outputLength / packing.valueWidth;
+  auto dataLength = inputLength - kBitPackHeaderSize;
+  if (dataLength < (numValues * packing.bitWidth + 7) / 8) {
+    return arrow::Status::Invalid("Bit packed buffer is truncated.");
+  }
+  if (packing.valueWidth == sizeof(int32_t)) {
+    bitUnpack<int32_t>(packing, input + kBitPackHeaderSize, dataLength, output, numValues);
+  } else {
+    bitUnpack<int64_t>(packing, input + kBitPackHeaderSize, dataLength, output, numValues);
+  }
+  return arrow::Status::OK();
+}
+
+ZstdDictionary::ZstdDictionary(std::vector<uint8_t> bytes, int32_t compressionLevel)
+    : bytes_(std::move(bytes)),
+      id_(ZSTD_getDictID_fromDict(bytes_.data(), bytes_.size())),
+      cdict_(ZSTD_createCDict(bytes_.data(), bytes_.size(), compressionLevel)) {
+  GLUTEN_CHECK(cdict_ != nullptr, "Failed to create ZSTD dictionary.");
+}
+
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeCDict(cdict_);
+}
+
+AdaptiveBufferCompressor::AdaptiveBufferCompressor(arrow::util::Codec* codec, int32_t numDictionaryTrainingBuffers)
+    : numDictionaryTrainingBuffers_(numDictionaryTrainingBuffers),
+      dictionaryScope_(randomDictionaryScope()) {
+  if (codec->compression_type() == arrow::Compression::LZ4_FRAME) {
+    lz4_ = codec;
+    ownedCodec_ = createArrowIpcCodec(arrow::Compression::ZSTD, CodecBackend::NONE);
+    zstd_ = ownedCodec_.get();
+  } else {
+    GLUTEN_CHECK(codec->compression_type() == arrow::Compression::ZSTD, "Adaptive compression requires lz4 or zstd.");
+    zstd_ = codec;
+    ownedCodec_ = createArrowIpcCodec(arrow::Compression::LZ4_FRAME, CodecBackend::NONE);
+    lz4_ = ownedCodec_.get();
+  }
+  sampleOutput_.resize(std::max(
+      {lz4_->MaxCompressedLen(kSampleSize, nullptr),
+       zstd_->MaxCompressedLen(kSampleSize, nullptr),
+       static_cast<int64_t>(ZSTD_compressBound(kSampleSize))}));
+  if (numDictionaryTrainingBuffers_ > 0) {
+    cctx_ = ZSTD_createCCtx();
+    GLUTEN_CHECK(cctx_ != nullptr, "Failed to create ZSTD compression context.");
+  }
+}
+
+AdaptiveBufferCompressor::~AdaptiveBufferCompressor() {
+  ZSTD_freeCCtx(cctx_);
+}
+
+int64_t AdaptiveBufferCompressor::maxCompressedLength(int64_t size) const {
+  return std::max(
+      {lz4_->MaxCompressedLen(size, nullptr),
+       zstd_->MaxCompressedLen(size, nullptr),
+       static_cast<int64_t>(ZSTD_compressBound(size)),
+       size + kBitPackHeaderSize});
+}
+
+int64_t AdaptiveBufferCompressor::maxDictionaryLength() const {
+  return numDictionaryTrainingBuffers_ > 0 ? kDictionaryCapacity : 0;
+}
+
+void AdaptiveBufferCompressor::sample(const arrow::Buffer& buffer, DictionaryTrainer& trainer) {
+  auto sampleSize = std::min(buffer.size(), kMaxDictionarySampleSize);
+  trainer.samples.insert(trainer.samples.end(), buffer.data(), buffer.data() + sampleSize);
+  trainer.sampleSizes.push_back(sampleSize);
+  if (trainer.sampleSizes.size() < numDictionaryTrainingBuffers_) {
+    return;
+  }
+  trainer.trained = true;
+  std::vector<uint8_t> bytes(kDictionaryCapacity);
+  auto size = ZDICT_trainFromBuffer(
+      bytes.data(), bytes.size(), trainer.samples.data(), trainer.sampleSizes.data(), trainer.sampleSizes.size());
+  std::vector<uint8_t>().swap(trainer.samples);
+  std::vector<size_t>().swap(trainer.sampleSizes);
+  if (ZDICT_isError(size)) {
+    // Too few or too uniform samples, the buffers of this index are compressed without a dictionary.
+    return;
+  }
+  bytes.resize(size);
+  auto id = ZSTD_getDictID_fromDict(bytes.data(), bytes.size());
+  if (id == 0) {
+    return;
+  }
+  for (auto& other : trainers_) {
+    // The reader looks dictionaries up by id.
+    if (other.dictionary != nullptr && other.dictionary->id() == id) {
+      return;
+    }
+  }
+  trainer.dictionary = std::make_unique<ZstdDictionary>(std::move(bytes), zstd_->compression_level());
+}
+
+arrow::Result<int64_t> AdaptiveBufferCompressor::compressWithDictionary(
+    const ZstdDictionary& dictionary,
+    const uint8_t* input,
+    int64_t inputLength,
+    uint8_t* output) {
+  auto length = ZSTD_compress_usingCDict(
+      cctx_, output, ZSTD_compressBound(inputLength), input, inputLength, dictionary.cdict());
+  if (ZSTD_isError(length)) {
+    return arrow::Status::IOError("ZSTD compression with dictionary failed: ", ZSTD_getErrorName(length));
+  }
+  return static_cast<int64_t>(length);
+}
+
+arrow::Result<int64_t> AdaptiveBufferCompressor::compress(
+    const arrow::Buffer& buffer,
+    size_t index,
+    uint8_t* output,
+    BufferEncoding& encoding,
+    const ZstdDictionary*& dictionary) {
+  dictionary = nullptr;
+  const ZstdDictionary* trained = nullptr;
+  if (numDictionaryTrainingBuffers_ > 0) {
+    if (index >= trainers_.size()) {
+      trainers_.resize(index + 1);
+    }
+    auto& trainer = trainers_[index];
+    if (!trainer.trained) {
+      sample(buffer, trainer);
+    }
+    trained = trainer.dictionary.get();
+  }
+
+  auto size = buffer.size();
+  auto sampleSize = std::min(size, kSampleSize);
+  ARROW_ASSIGN_OR_RAISE(
+      auto lz4Sample, lz4_->Compress(sampleSize, buffer.data(), sampleOutput_.size(), sampleOutput_.data()));
+  int64_t zstdSample;
+  if (trained != nullptr) {
+    ARROW_ASSIGN_OR_RAISE(
+        zstdSample, compressWithDictionary(*trained, buffer.data(), sampleSize, sampleOutput_.data()));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(
+        zstdSample, zstd_->Compress(sampleSize, buffer.data(), sampleOutput_.size(), sampleOutput_.data()));
+  }
+  auto lz4Estimate = static_cast<double>(lz4Sample) / sampleSize * size;
+  auto zstdEstimate = static_cast<double>(zstdSample) / sampleSize * size;
+  auto bitPacking = planBitPacking(buffer.data(), size);
+
+  auto best = std::min(lz4Estimate, zstdEstimate);
+  if (bitPacking.encodedLength >= 0 && bitPacking.encodedLength <= best) {
+    if (bitPacking.encodedLength <= size * kMaxEncodedRatio) {
+      encoding = BufferEncoding::kBitPacked;
+      bitPack(bitPacking, buffer.data(), size, output);
+      return bitPacking.encodedLength;
+    }
+  } else if (best <= size * kMaxEncodedRatio) {
+    auto useZstd = zstdEstimate < lz4Estimate * kZstdPreferRatio;
+    int64_t length;
+    if (useZstd && trained != nullptr) {
+      ARROW_ASSIGN_OR_RAISE(length, compressWithDictionary(*trained, buffer.data(), size, output));
+    } else {
+      auto* codec = useZstd ? zstd_ : lz4_;
+      ARROW_ASSIGN_OR_RAISE(
+          length, codec->Compress(size, buffer.data(), codec->MaxCompressedLen(size, nullptr), output));
+    }
+    if (length < size) {
+      if (!useZstd) {
+        encoding = BufferEncoding::kLz4;
+      } else if (trained != nullptr) {
+        encoding = BufferEncoding::kZstdDict;
+        dictionary = trained;
+      } else {
+        encoding = BufferEncoding::kZstd;
+      }
+      return length;
+    }
+  }
+  encoding = BufferEncoding::kRaw;
+  memcpy(output, buffer.data(), size);
+  return size;
+}
+
+ZstdDictionaryCache::~ZstdDictionaryCache() {
+  for (auto& [key, entry] : ddicts_) {
+    ZSTD_freeDDict(entry.ddict);
+  }
+}
+
+arrow::Status ZstdDictionaryCache::add(uint64_t scope, uint32_t id, const uint8_t* data, int64_t size) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto it = ddicts_.find({scope, id});
+  if (it != ddicts_.end()) {
+    if (it->second.bytes.size() != size || memcmp(it->second.bytes.data(), data, size) != 0) {
+      return arrow::Status::Invalid("Received two different ZSTD dictionaries with id ", id, ".");
+    }
+    return arrow::Status::OK();
+  }
+  auto* ddict = ZSTD_createDDict(data, size);
+  if (ddict == nullptr) {
+    return arrow::Status::Invalid("Corrupted ZSTD dictionary ", id, ".");
+  }
+  ddicts_.emplace(std::make_pair(scope, id), Entry{std::vector<uint8_t>(data, data + size), ddict});
+  return arrow::Status::OK();
+}
+
+arrow::Result<int64_t> ZstdDictionaryCache::decompress(
+    uint64_t scope,
+    const uint8_t* input,
+    int64_t inputLength,
+    uint8_t* output,
+    int64_t outputLength) {
+  ZSTD_DDict* ddict;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ddicts_.find({scope, ZSTD_getDictID_fromFrame(input, inputLength)});
+    if (it == ddicts_.end()) {
+      return arrow::Status::Invalid("Shuffle buffer uses a ZSTD dictionary that wasn't received.");
+    }
+    ddict = it->second.ddict;
+  }
+  // One context per thread, blocks of a stream may be decoded in parallel.
+  static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(nullptr, &ZSTD_freeDCtx);
+  if (dctx == nullptr) {
+    dctx.reset(ZSTD_createDCtx());
+    if (dctx == nullptr) {
+      return arrow::Status::OutOfMemory("Failed to create ZSTD decompression context.");
+    }
+  }
+  auto length = ZSTD_decompress_usingDDict(dctx.get(), output, outputLength, input, inputLength, ddict);
+  if (ZSTD_isError(length)) {
+    return arrow::Status::IOError("ZSTD decompression with dictionary failed: ", ZSTD_getErrorName(length));
+  }
+  return static_cast<int64_t>(length);
+}
+
+} // namespace gluten
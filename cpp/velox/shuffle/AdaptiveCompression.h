@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/result.h>
+#include <arrow/util/compression.h>
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+typedef struct ZSTD_DDict_s ZSTD_DDict;
+
+namespace gluten {
+
+// Encoding of one buffer of a shuffle payload written with adaptive compression. kZstdDict buffers are ZSTD frames
+// compressed with a trained dictionary, whose id the frame records.
+enum class BufferEncoding : int64_t { kRaw = 0, kLz4 = 1, kZstd = 2, kBitPacked = 3, kZstdDict = 4 };
+
+// Third int32 of the payload header of adaptively compressed batches. The length buffer then holds
+// |buffers.size()|buffer1 encoding|buffer1 unCompressedLength|buffer1 compressedLength|buffer2...
+constexpr int32_t kAdaptiveCompressionLayout = 1;
+
+// Same as kAdaptiveCompressionLayout, for batches with kZstdDict buffers. The length buffer is followed by
+// |dictionary scope|numDictionaries|dictionary1 id|dictionary1 length|dictionary2... listing the dictionaries their
+// partition hasn't sent before, and the value buffer by those dictionaries. A dictionary id is a 31-bit content hash
+// that dictionaries of different map tasks may share, so the reader looks dictionaries up by the scope, a random id
+// of the compressor that trained them, and the id.
+constexpr int32_t kAdaptiveDictionaryLayout = 2;
+
+// A ZSTD dictionary trained from the buffers of one index of the payloads of a map task.
+class ZstdDictionary {
+ public:
+  ZstdDictionary(std::vector<uint8_t> bytes, int32_t compressionLevel);
+
+  ~ZstdDictionary();
+
+  ZstdDictionary(const ZstdDictionary&) = delete;
+  ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+  uint32_t id() const {
+    return id_;
+  }
+
+  const std::vector<uint8_t>& bytes() const {
+    return bytes_;
+  }
+
+  const ZSTD_CDict* cdict() const {
+    return cdict_;
+  }
+
+ private:
+  std::vector<uint8_t> bytes_;
+  uint32_t id_;
+  ZSTD_CDict* cdict_;
+};
+
+// Picks the encoding of each buffer from a sample of it: raw for incompressible data, frame-of-reference bit packing
+// for narrow ranged 4 or 8 byte values, otherwise LZ4, or ZSTD if it compresses the sample markedly better.
+// With numDictionaryTrainingBuffers > 0, the first buffers of each index train a ZSTD dictionary used for the later
+// ones. Not thread safe.
+class AdaptiveBufferCompressor {
+ public:
+  // codec is the configured shuffle codec, either LZ4_FRAME or ZSTD. It compresses the buffers of its own type, a
+  // software codec the others.
+  AdaptiveBufferCompressor(arrow::util::Codec* codec, int32_t numDictionaryTrainingBuffers = 0);
+
+  ~AdaptiveBufferCompressor();
+
+  // Upper bound of the bytes compress() writes for a buffer of the given size.
+  int64_t maxCompressedLength(int64_t size) const;
+
+  // Upper bound of the bytes of one dictionary, 0 without dictionary training.
+  int64_t maxDictionaryLength() const;
+
+  // The scope of the dictionaries of this compressor, see kAdaptiveDictionaryLayout.
+  uint64_t dictionaryScope() const {
+    return dictionaryScope_;
+  }
+
+  // Encode the buffer at index of its payload into output and return the encoded length. dictionary is set to the
+  // dictionary of kZstdDict buffers.
+  arrow::Result<int64_t> compress(
+      const arrow::Buffer& buffer,
+      size_t index,
+      uint8_t* output,
+      BufferEncoding& encoding,
+      const ZstdDictionary*& dictionary);
+
+ private:
+  struct DictionaryTrainer {
+    std::vector<uint8_t> samples;
+    std::vector<size_t> sampleSizes;
+    bool trained = false;
+    std::unique_ptr<ZstdDictionary> dictionary;
+  };
+
+  void sample(const arrow::Buffer& buffer, DictionaryTrainer& trainer);
+
+  arrow::Result<int64_t>
+  compressWithDictionary(const ZstdDictionary& dictionary, const uint8_t* input, int64_t inputLength, uint8_t* output);
+
+  arrow::util::Codec* lz4_;
+  arrow::util::Codec* zstd_;
+  std::unique_ptr<arrow::util::Codec> ownedCodec_;
+  std::vector<uint8_t> sampleOutput_;
+  int32_t numDictionaryTrainingBuffers_;
+  uint64_t dictionaryScope_;
+  // By buffer index.
+  std::vector<DictionaryTrainer> trainers_;
+  ZSTD_CCtx* cctx_ = nullptr;
+};
+
+// The ZSTD dictionaries a shuffle reader received, by scope and id. Thread safe.
+class ZstdDictionaryCache {
+ public:
+  ZstdDictionaryCache() = default;
+
+  ~ZstdDictionaryCache();
+
+  ZstdDictionaryCache(const ZstdDictionaryCache&) = delete;
+  ZstdDictionaryCache& operator=(const ZstdDictionaryCache&) = delete;
+
+  // Ignores dictionaries already received, fails on a different dictionary under the same scope and id.
+  arrow::Status add(uint64_t scope, uint32_t id, const uint8_t* data, int64_t size);
+
+  // Decompress a kZstdDict frame with the dictionary of the scope its header names.
+  arrow::Result<int64_t>
+  decompress(uint64_t scope, const uint8_t* input, int64_t inputLength, uint8_t* output, int64_t outputLength);
+
+ private:
+  struct Entry {
+    std::vector<uint8_t> bytes;
+    ZSTD_DDict* ddict;
+  };
+
+  std::shared_mutex mutex_;
+  std::map<std::pair<uint64_t, uint32_t>, Entry> ddicts_;
+};
+
+// Frame-of-reference bit packing of 4 or 8 byte values: each value is stored as its offset from the minimum in
+// bitWidth bits, after a header with the value width, bit width and minimum.
+struct BitPacking {
+  int32_t valueWidth = 0;
+  int32_t bitWidth = 0;
+  int64_t base = 0;
+  // -1 if the input can't be bit packed.
+  int64_t encodedLength = -1;
+};
+
+// Choose the value width packing the input smallest.
+BitPacking planBitPacking(const uint8_t* input, int64_t inputLength);
+
+void bitPack(const BitPacking& packing, const uint8_t* input, int64_t inputLength, uint8_t* output);
+
+arrow::Status bitUnpack(const uint8_t* input, int64_t inputLength, uint8_t* output, int64_t outputLength);
+
+} // namespace gluten
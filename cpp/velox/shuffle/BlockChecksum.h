@@ -0,0 +1,42 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <arrow/buffer.h>
+#include <folly/hash/Checksum.h>
+
+#include <cstdint>
+
+namespace gluten {
+
+// Header of a shuffle payload with a block checksum: |numRows u32|compressionType i32|layout i32|crc32c u32|. The
+// layout is 0 for uncompressed and legacy compressed batches. The checksum covers the buffers of all other columns, in
+// order.
+constexpr int64_t kChecksumHeaderSize = sizeof(uint32_t) * 2 + sizeof(int32_t) * 2;
+
+constexpr uint32_t kBlockChecksumSeed = ~0U;
+
+// Continue the CRC32C of a block with buffer. folly computes it with the SSE4.2 or ARMv8 CRC instructions where the
+// CPU has them.
+inline uint32_t extendBlockChecksum(uint32_t checksum, const arrow::Buffer* buffer) {
+  if (buffer == nullptr || buffer->size() == 0) {
+    return checksum;
+  }
+  return folly::crc32c(buffer->data(), buffer->size(), checksum);
+}
+
+} // namespace gluten
@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/RangePartitionBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/SelectivityVector.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+
+// The null byte sorts nulls before or after every value whatever the direction of the key.
+constexpr char kNullFirst = 0x00;
+constexpr char kNotNull = 0x01;
+constexpr char kNullLast = 0x02;
+
+template <typename U>
+inline void appendBigEndian(U value, std::string& out) {
+  for (int32_t shift = (sizeof(U) - 1) * 8; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>(value >> shift));
+  }
+}
+
+// Two's complement integers with the sign bit flipped compare as unsigned big endian bytes.
+template <typename T, typename U>
+inline void appendSigned(T value, std::string& out) {
+  appendBigEndian<U>(static_cast<U>(value) ^ (U(1) << (sizeof(U) * 8 - 1)), out);
+}
+
+inline void appendValue(bool value, std::string& out) {
+  out.push_back(value ? 1 : 0);
+}
+
+inline void appendValue(int8_t value, std::string& out) {
+  appendSigned<int8_t, uint8_t>(value, out);
+}
+
+inline void appendValue(int16_t value, std::string& out) {
+  appendSigned<int16_t, uint16_t>(value, out);
+}
+
+inline void appendValue(int32_t value, std::string& out) {
+  appendSigned<int32_t, uint32_t>(value, out);
+}
+
+// Also short decimals, ordered by their unscaled value.
+inline void appendValue(int64_t value, std::string& out) {
+  appendSigned<int64_t, uint64_t>(value, out);
+}
+
+inline void appendValue(int128_t value, std::string& out) {
+  appendSigned<int128_t, __uint128_t>(value, out);
+}
+
+// Spark orders -0.0 equal to 0.0 and NaN above all the other values.
+template <typename T, typename U>
+inline void appendFloatingPoint(T value, std::string& out) {
+  if (value == 0) {
+    value = 0;
+  } else if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(bits));
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  appendBigEndian<U>((bits & kSignBit) ? ~bits : bits ^ kSignBit, out);
+}
+
+inline void appendValue(float value, std::string& out) {
+  appendFloatingPoint<float, uint32_t>(value, out);
+}
+
+inline void appendValue(double value, std::string& out) {
+  appendFloatingPoint<double, uint64_t>(value, out);
+}
+
+// 0x00 is escaped and the string terminated by 0x00 0x00, so that no normalized string is the prefix of another and
+// a following key never takes part in the comparison of two different strings.
+inline void appendValue(const StringView& value, std::string& out) {
+  for (int32_t i = 0; i < value.size(); ++i) {
+    auto c = value.data()[i];
+    out.push_back(c);
+    if (c == 0) {
+      out.push_back(static_cast<char>(0xff));
+    }
+  }
+  out.push_back(0);
+  out.push_back(0);
+}
+
+inline void appendValue(const Timestamp& value, std::string& out) {
+  appendValue(value.toMicros(), out);
+}
+
+inline void appendValue(const Date& value, std::string& out) {
+  appendValue(value.days(), out);
+}
+
+template <typename T>
+void appendColumn(const BaseVector& vector, const RangePartitionKey& key, std::vector<std::string>& normalizedKeys) {
+  auto numRows = vector.size();
+  SelectivityVector rows(numRows);
+  DecodedVector decoded(vector, rows);
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    auto& out = normalizedKeys[i];
+    if (decoded.isNullAt(i)) {
+      out.push_back(key.nulls_first ? kNullFirst : kNullLast);
+      continue;
+    }
+    out.push_back(kNotNull);
+    auto begin = out.size();
+    appendValue(decoded.valueAt<T>(i), out);
+    if (!key.ascending) {
+      // The normalized values are prefix free, so the inverted bytes compare in the reverse order.
+      for (auto j = begin; j < out.size(); ++j) {
+        out[j] = ~out[j];
+      }
+    }
+  }
+}
+
+} // namespace
+
+arrow::Result<std::unique_ptr<RangePartitionBounds>> RangePartitionBounds::make(
+    const RowVector& bounds,
+    std::vector<RangePartitionKey> keys) {
+  if (keys.empty() || keys.size() != bounds.childrenSize()) {
+    return arrow::Status::Invalid(
+        "Range bounds have " + std::to_string(bounds.childrenSize()) + " columns for " + std::to_string(keys.size()) +
+        " keys.");
+  }
+  std::unique_ptr<RangePartitionBounds> rangeBounds(new RangePartitionBounds(std::move(keys)));
+  for (const auto& key : rangeBounds->keys_) {
+    rangeBounds->keyColumns_.push_back(key.column);
+  }
+
+  std::vector<int32_t> boundColumns(bounds.childrenSize());
+  std::iota(boundColumns.begin(), boundColumns.end(), 0);
+  RETURN_NOT_OK(rangeBounds->normalize(bounds, boundColumns));
+  rangeBounds->bounds_ = std::move(rangeBounds->normalizedKeys_);
+  if (!std::is_sorted(rangeBounds->bounds_.begin(), rangeBounds->bounds_.end())) {
+    return arrow::Status::Invalid("Range bounds are not sorted by the ordering of the keys.");
+  }
+  return rangeBounds;
+}
+
+arrow::Status RangePartitionBounds::compute(const RowVector& rv, std::vector<int32_t>& pids) {
+  RETURN_NOT_OK(normalize(rv, keyColumns_));
+  pids.resize(rv.size());
+  for (vector_size_t i = 0; i < rv.size(); ++i) {
+    pids[i] = std::lower_bound(bounds_.begin(), bounds_.end(), normalizedKeys_[i]) - bounds_.begin();
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status RangePartitionBounds::normalize(const RowVector& rv, const std::vector<int32_t>& columns) {
+  normalizedKeys_.resize(rv.size());
+  for (auto& normalizedKey : normalizedKeys_) {
+    normalizedKey.clear();
+  }
+  for (size_t i = 0; i < columns.size(); ++i) {
+    auto column = columns[i];
+    if (column < 0 || column >= rv.childrenSize()) {
+      return arrow::Status::Invalid(
+          "Range partition key index " + std::to_string(column) + " is out of range of " +
+          std::to_string(rv.childrenSize()) + " columns.");
+    }
+    auto* vector = rv.childAt(column)->loadedVector();
+    const auto& key = keys_[i];
+    switch (vector->typeKind()) {
+      case TypeKind::BOOLEAN:
+        appendColumn<bool>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::TINYINT:
+        appendColumn<int8_t>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::SMALLINT:
+        appendColumn<int16_t>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::INTEGER:
+        appendColumn<int32_t>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::BIGINT:
+        appendColumn<int64_t>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::HUGEINT:
+        appendColumn<int128_t>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::REAL:
+        appendColumn<float>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::DOUBLE:
+        appendColumn<double>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        appendColumn<StringView>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::TIMESTAMP:
+        appendColumn<Timestamp>(*vector, key, normalizedKeys_);
+        break;
+      case TypeKind::DATE:
+        appendColumn<Date>(*vector, key, normalizedKeys_);
+        break;
+      default:
+        return arrow::Status::NotImplemented(
+            "Range partitioning on key type " + vector->type()->toString() + " is not supported.");
+    }
+  }
+  return arrow::Status::OK();
+}
+
+} // namespace gluten
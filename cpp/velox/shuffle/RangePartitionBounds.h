@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/result.h>
+#include <arrow/status.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "shuffle/ShuffleWriter.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace gluten {
+
+// Partition ids of Spark's RangePartitioner, computed in the writer from the sampled bounds instead of in the JVM.
+// The partition id of a row is the number of bounds less than its keys. The keys and the bounds are compared as
+// normalized keys, byte strings whose memcmp order is the ordering of the keys, so that each comparison of the binary
+// search is one memcmp whatever the number and the types of the keys.
+class RangePartitionBounds {
+ public:
+  // bounds holds one column per key, in the order of keys, sorted by the ordering of the keys.
+  static arrow::Result<std::unique_ptr<RangePartitionBounds>> make(
+      const facebook::velox::RowVector& bounds,
+      std::vector<RangePartitionKey> keys);
+
+  arrow::Status compute(const facebook::velox::RowVector& rv, std::vector<int32_t>& pids);
+
+  int32_t numBounds() const {
+    return bounds_.size();
+  }
+
+ private:
+  explicit RangePartitionBounds(std::vector<RangePartitionKey> keys) : keys_(std::move(keys)) {}
+
+  // The normalized keys of the rows into normalizedKeys_, from the key columns at columns.
+  arrow::Status normalize(const facebook::velox::RowVector& rv, const std::vector<int32_t>& columns);
+
+  std::vector<RangePartitionKey> keys_;
+  std::vector<int32_t> keyColumns_;
+  std::vector<std::string> bounds_;
+  std::vector<std::string> normalizedKeys_;
+};
+
+} // namespace gluten
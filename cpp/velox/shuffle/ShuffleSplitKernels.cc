@@ -0,0 +1,288 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShuffleSplitKernels.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define GLUTEN_TARGET_AVX2 __attribute__((target("avx2")))
+#define GLUTEN_TARGET_AVX512 __attribute__((target("avx2,avx512f")))
+#endif
+
+namespace gluten {
+
+namespace {
+
+// In rows. Ahead of the rows being gathered, so that the random source reads hit the cache.
+constexpr uint32_t kPrefetchDistance = 16;
+
+template <uint32_t kWidth, uint32_t kLanes>
+inline void prefetchAhead(const uint8_t* src, const uint32_t* rowIds, uint32_t i, uint32_t numRows) {
+  if (i + kPrefetchDistance + kLanes <= numRows) {
+    for (uint32_t k = 0; k < kLanes; ++k) {
+      __builtin_prefetch(src + static_cast<uint64_t>(rowIds[i + kPrefetchDistance + k]) * kWidth);
+    }
+  }
+}
+
+template <uint32_t kWidth>
+void gatherScalar(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  for (uint32_t i = 0; i < numRows; ++i) {
+    prefetchAhead<kWidth, 1>(src, rowIds, i, numRows);
+    // memcpy, as the destination is not necessarily aligned for 16 bytes values.
+    memcpy(dst + static_cast<uint64_t>(i) * kWidth, src + static_cast<uint64_t>(rowIds[i]) * kWidth, kWidth);
+  }
+}
+
+void gatherBitsScalar(const uint8_t* src, const uint32_t* rowIds, uint32_t numBytes, uint8_t* dst) {
+  for (uint32_t b = 0; b < numBytes; ++b) {
+    const auto* ids = rowIds + b * 8;
+    uint8_t byte = 0;
+    for (uint32_t k = 0; k < 8; ++k) {
+      byte |= ((src[ids[k] >> 3] >> (ids[k] & 7)) & 1) << k;
+    }
+    dst[b] = byte;
+  }
+}
+
+#if defined(__x86_64__)
+
+// 1 and 2 bytes values are read through the aligned 32-bit word holding them. An aligned word never crosses a page
+// boundary, so reading its bytes past the end of the buffer is safe.
+inline const int* alignedWords(const uint8_t* src) {
+  return reinterpret_cast<const int*>(reinterpret_cast<uintptr_t>(src) & ~static_cast<uintptr_t>(3));
+}
+
+inline int32_t wordMisalignment(const uint8_t* src) {
+  return static_cast<int32_t>(reinterpret_cast<uintptr_t>(src) & 3);
+}
+
+template <uint32_t kWidth>
+GLUTEN_TARGET_AVX2 void gatherAvx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  if constexpr (kWidth == 1 || kWidth == 2) {
+    if (reinterpret_cast<uintptr_t>(src) % kWidth != 0) {
+      return gatherScalar<kWidth>(src, rowIds, numRows, dst);
+    }
+    const auto* words = alignedWords(src);
+    const auto misalignment = _mm256_set1_epi32(wordMisalignment(src));
+    const auto mask = _mm256_set1_epi32(kWidth == 1 ? 0xff : 0xffff);
+    for (; i + 8 <= numRows; i += 8) {
+      prefetchAhead<kWidth, 8>(src, rowIds, i, numRows);
+      auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+      auto byteOffsets = _mm256_add_epi32(kWidth == 1 ? idx : _mm256_slli_epi32(idx, 1), misalignment);
+      auto values = _mm256_i32gather_epi32(words, _mm256_srli_epi32(byteOffsets, 2), 4);
+      auto shifts = _mm256_slli_epi32(_mm256_and_si256(byteOffsets, _mm256_set1_epi32(3)), 3);
+      values = _mm256_and_si256(_mm256_srlv_epi32(values, shifts), mask);
+      // 8 x 32-bit to 8 x 16-bit. packus works per 128-bit lane, permute the two halves together.
+      auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(values, values), 0x08);
+      auto narrow = _mm256_castsi256_si128(packed);
+      if constexpr (kWidth == 2) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), narrow);
+      } else {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(narrow, narrow));
+      }
+    }
+  } else if constexpr (kWidth == 4) {
+    const auto* base = reinterpret_cast<const int*>(src);
+    for (; i + 8 <= numRows; i += 8) {
+      prefetchAhead<kWidth, 8>(src, rowIds, i, numRows);
+      auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_i32gather_epi32(base, idx, 4));
+    }
+  } else if constexpr (kWidth == 8) {
+    const auto* base = reinterpret_cast<const long long*>(src);
+    for (; i + 4 <= numRows; i += 4) {
+      prefetchAhead<kWidth, 4>(src, rowIds, i, numRows);
+      auto idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowIds + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8), _mm256_i32gather_epi64(base, idx, 8));
+    }
+  } else {
+    static_assert(kWidth == 16);
+    // A 16 bytes value is gathered as two 8 bytes halves.
+    const auto* base = reinterpret_cast<const long long*>(src);
+    for (; i + 2 <= numRows; i += 2) {
+      prefetchAhead<kWidth, 2>(src, rowIds, i, numRows);
+      auto r0 = static_cast<int32_t>(rowIds[i] * 2);
+      auto r1 = static_cast<int32_t>(rowIds[i + 1] * 2);
+      auto idx = _mm_setr_epi32(r0, r0 + 1, r1, r1 + 1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 16), _mm256_i32gather_epi64(base, idx, 8));
+    }
+  }
+  gatherScalar<kWidth>(src, rowIds + i, numRows - i, dst + static_cast<uint64_t>(i) * kWidth);
+}
+
+template <uint32_t kWidth>
+GLUTEN_TARGET_AVX512 void gatherAvx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  if constexpr (kWidth == 1 || kWidth == 2) {
+    if (reinterpret_cast<uintptr_t>(src) % kWidth != 0) {
+      return gatherScalar<kWidth>(src, rowIds, numRows, dst);
+    }
+    const auto* words = alignedWords(src);
+    const auto misalignment = _mm512_set1_epi32(wordMisalignment(src));
+    for (; i + 16 <= numRows; i += 16) {
+      prefetchAhead<kWidth, 16>(src, rowIds, i, numRows);
+      auto idx = _mm512_loadu_si512(rowIds + i);
+      auto byteOffsets = _mm512_add_epi32(kWidth == 1 ? idx : _mm512_slli_epi32(idx, 1), misalignment);
+      auto values = _mm512_i32gather_epi32(_mm512_srli_epi32(byteOffsets, 2), words, 4);
+      auto shifts = _mm512_slli_epi32(_mm512_and_si512(byteOffsets, _mm512_set1_epi32(3)), 3);
+      values = _mm512_srlv_epi32(values, shifts);
+      // The truncating conversions drop the neighbouring bytes.
+      if constexpr (kWidth == 2) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), _mm512_cvtepi32_epi16(values));
+      } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_cvtepi32_epi8(values));
+      }
+    }
+  } else if constexpr (kWidth == 4) {
+    for (; i + 16 <= numRows; i += 16) {
+      prefetchAhead<kWidth, 16>(src, rowIds, i, numRows);
+      auto idx = _mm512_loadu_si512(rowIds + i);
+      _mm512_storeu_si512(dst + i * 4, _mm512_i32gather_epi32(idx, src, 4));
+    }
+  } else if constexpr (kWidth == 8) {
+    for (; i + 8 <= numRows; i += 8) {
+      prefetchAhead<kWidth, 8>(src, rowIds, i, numRows);
+      auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+      _mm512_storeu_si512(dst + i * 8, _mm512_i32gather_epi64(idx, src, 8));
+    }
+  } else {
+    static_assert(kWidth == 16);
+    for (; i + 4 <= numRows; i += 4) {
+      prefetchAhead<kWidth, 4>(src, rowIds, i, numRows);
+      auto rows = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rowIds + i)), 1);
+      auto nextRows = _mm_add_epi32(rows, _mm_set1_epi32(1));
+      auto idx =
+          _mm256_set_m128i(_mm_unpackhi_epi32(rows, nextRows), _mm_unpacklo_epi32(rows, nextRows)); // r0, r0 + 1, ...
+      _mm512_storeu_si512(dst + i * 16, _mm512_i32gather_epi64(idx, src, 8));
+    }
+  }
+  gatherScalar<kWidth>(src, rowIds + i, numRows - i, dst + static_cast<uint64_t>(i) * kWidth);
+}
+
+GLUTEN_TARGET_AVX2 void gatherBitsAvx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numBytes, uint8_t* dst) {
+  const auto* words = alignedWords(src);
+  const auto misalignment = _mm256_set1_epi32(wordMisalignment(src) * 8);
+  for (uint32_t b = 0; b < numBytes; ++b) {
+    auto idx = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + b * 8)), misalignment);
+    auto values = _mm256_i32gather_epi32(words, _mm256_srli_epi32(idx, 5), 4);
+    auto bits = _mm256_srlv_epi32(values, _mm256_and_si256(idx, _mm256_set1_epi32(31)));
+    dst[b] = static_cast<uint8_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(bits, 31))));
+  }
+}
+
+GLUTEN_TARGET_AVX512 void
+gatherBitsAvx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numBytes, uint8_t* dst) {
+  const auto* words = alignedWords(src);
+  const auto misalignment = _mm512_set1_epi32(wordMisalignment(src) * 8);
+  uint32_t b = 0;
+  for (; b + 2 <= numBytes; b += 2) {
+    auto idx = _mm512_add_epi32(_mm512_loadu_si512(rowIds + b * 8), misalignment);
+    auto values = _mm512_i32gather_epi32(_mm512_srli_epi32(idx, 5), words, 4);
+    auto bits = _mm512_srlv_epi32(values, _mm512_and_si512(idx, _mm512_set1_epi32(31)));
+    __mmask16 mask = _mm512_test_epi32_mask(bits, _mm512_set1_epi32(1));
+    // Lane k is bit k of the mask, little endian puts lanes 0-7 into the first byte.
+    memcpy(dst + b, &mask, sizeof(mask));
+  }
+  gatherBitsScalar(src, rowIds + b * 8, numBytes - b, dst + b);
+}
+
+#endif
+
+template <uint32_t kWidth>
+void gatherDispatch(SplitKernelIsa isa, const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+#if defined(__x86_64__)
+  switch (isa) {
+    case SplitKernelIsa::kAvx512:
+      return gatherAvx512<kWidth>(src, rowIds, numRows, dst);
+    case SplitKernelIsa::kAvx2:
+      return gatherAvx2<kWidth>(src, rowIds, numRows, dst);
+    default:
+      break;
+  }
+#endif
+  gatherScalar<kWidth>(src, rowIds, numRows, dst);
+}
+
+} // namespace
+
+SplitKernelIsa detectSplitKernelIsa() {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx512f")) {
+    return SplitKernelIsa::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SplitKernelIsa::kAvx2;
+  }
+#endif
+  return SplitKernelIsa::kScalar;
+}
+
+const char* splitKernelIsaName(SplitKernelIsa isa) {
+  switch (isa) {
+    case SplitKernelIsa::kAvx512:
+      return "avx512";
+    case SplitKernelIsa::kAvx2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+void gatherFixedWidth(
+    SplitKernelIsa isa,
+    uint32_t byteWidth,
+    const uint8_t* src,
+    const uint32_t* rowIds,
+    uint32_t numRows,
+    uint8_t* dst) {
+  switch (byteWidth) {
+    case 1:
+      return gatherDispatch<1>(isa, src, rowIds, numRows, dst);
+    case 2:
+      return gatherDispatch<2>(isa, src, rowIds, numRows, dst);
+    case 4:
+      return gatherDispatch<4>(isa, src, rowIds, numRows, dst);
+    case 8:
+      return gatherDispatch<8>(isa, src, rowIds, numRows, dst);
+    case 16:
+      return gatherDispatch<16>(isa, src, rowIds, numRows, dst);
+    default:
+      throw std::invalid_argument("Unsupported byte width for gather: " + std::to_string(byteWidth));
+  }
+}
+
+void gatherBits(SplitKernelIsa isa, const uint8_t* src, const uint32_t* rowIds, uint32_t numBytes, uint8_t* dst) {
+#if defined(__x86_64__)
+  switch (isa) {
+    case SplitKernelIsa::kAvx512:
+      return gatherBitsAvx512(src, rowIds, numBytes, dst);
+    case SplitKernelIsa::kAvx2:
+      return gatherBitsAvx2(src, rowIds, numBytes, dst);
+    default:
+      break;
+  }
+#endif
+  gatherBitsScalar(src, rowIds, numBytes, dst);
+}
+
+} // namespace gluten
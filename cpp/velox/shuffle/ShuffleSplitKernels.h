@@ -0,0 +1,44 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace gluten {
+
+// Instruction sets of the shuffle split kernels. The kernels are compiled for all of them and picked at runtime.
+enum class SplitKernelIsa { kScalar, kAvx2, kAvx512 };
+
+// Best instruction set supported by the running CPU.
+SplitKernelIsa detectSplitKernelIsa();
+
+const char* splitKernelIsaName(SplitKernelIsa isa);
+
+// dst[i] = src[rowIds[i]] for i in [0, numRows). Values are byteWidth bytes wide, one of 1, 2, 4, 8 or 16.
+void gatherFixedWidth(
+    SplitKernelIsa isa,
+    uint32_t byteWidth,
+    const uint8_t* src,
+    const uint32_t* rowIds,
+    uint32_t numRows,
+    uint8_t* dst);
+
+// Bit i of dst is bit rowIds[i] of src, for i in [0, numBytes * 8). Writes numBytes whole bytes.
+void gatherBits(SplitKernelIsa isa, const uint8_t* src, const uint32_t* rowIds, uint32_t numBytes, uint8_t* dst);
+
+} // namespace gluten
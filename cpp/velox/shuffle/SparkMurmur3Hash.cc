@@ -0,0 +1,286 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/SparkMurmur3Hash.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+#include "velox/vector/SelectivityVector.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+
+// Port of org.apache.spark.unsafe.hash.Murmur3_x86_32. All arithmetic is on uint32_t to get Java's wrapping int
+// semantics.
+inline uint32_t rotateLeft(uint32_t x, int32_t r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t mixK1(uint32_t k1) {
+  k1 *= 0xcc9e2d51;
+  k1 = rotateLeft(k1, 15);
+  return k1 * 0x1b873593;
+}
+
+inline uint32_t mixH1(uint32_t h1, uint32_t k1) {
+  h1 ^= k1;
+  h1 = rotateLeft(h1, 13);
+  return h1 * 5 + 0xe6546b64;
+}
+
+inline uint32_t fmix(uint32_t h1, uint32_t length) {
+  h1 ^= length;
+  h1 ^= h1 >> 16;
+  h1 *= 0x85ebca6b;
+  h1 ^= h1 >> 13;
+  h1 *= 0xc2b2ae35;
+  h1 ^= h1 >> 16;
+  return h1;
+}
+
+inline uint32_t hashInt(int32_t input, uint32_t seed) {
+  return fmix(mixH1(seed, mixK1(input)), 4);
+}
+
+inline uint32_t hashLong(int64_t input, uint32_t seed) {
+  auto h1 = mixH1(seed, mixK1(static_cast<uint32_t>(input)));
+  h1 = mixH1(h1, mixK1(static_cast<uint32_t>(static_cast<uint64_t>(input) >> 32)));
+  return fmix(h1, 8);
+}
+
+// Murmur3_x86_32.hashUnsafeBytes, which mixes each trailing byte as a sign extended int instead of following the
+// reference tail handling.
+inline uint32_t hashBytes(const char* data, int32_t length, uint32_t seed) {
+  auto lengthAligned = length - length % 4;
+  auto h1 = seed;
+  for (int32_t i = 0; i < lengthAligned; i += 4) {
+    uint32_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h1 = mixH1(h1, mixK1(word));
+  }
+  for (int32_t i = lengthAligned; i < length; ++i) {
+    h1 = mixH1(h1, mixK1(static_cast<int32_t>(static_cast<int8_t>(data[i]))));
+  }
+  return fmix(h1, length);
+}
+
+// Value hashing of Spark's HashExpression.
+inline uint32_t hashValue(bool value, uint32_t seed) {
+  return hashInt(value ? 1 : 0, seed);
+}
+
+inline uint32_t hashValue(int8_t value, uint32_t seed) {
+  return hashInt(value, seed);
+}
+
+inline uint32_t hashValue(int16_t value, uint32_t seed) {
+  return hashInt(value, seed);
+}
+
+inline uint32_t hashValue(int32_t value, uint32_t seed) {
+  return hashInt(value, seed);
+}
+
+// Also short decimals, hashed by their unscaled value.
+inline uint32_t hashValue(int64_t value, uint32_t seed) {
+  return hashLong(value, seed);
+}
+
+// Long decimals are hashed over BigInteger.toByteArray() of the unscaled value: the shortest big endian two's
+// complement representation.
+inline uint32_t hashValue(int128_t value, uint32_t seed) {
+  char bytes[sizeof(int128_t)];
+  for (int32_t i = 0; i < sizeof(int128_t); ++i) {
+    bytes[sizeof(int128_t) - 1 - i] = static_cast<char>(value >> (i * 8));
+  }
+  int32_t start = 0;
+  while (start < sizeof(int128_t) - 1) {
+    auto byte = static_cast<uint8_t>(bytes[start]);
+    auto nextSignBit = static_cast<uint8_t>(bytes[start + 1]) & 0x80;
+    if ((byte == 0x00 && nextSignBit == 0) || (byte == 0xff && nextSignBit != 0)) {
+      ++start;
+    } else {
+      break;
+    }
+  }
+  return hashBytes(bytes + start, sizeof(int128_t) - start, seed);
+}
+
+// -0.0 hashes as 0.0 and all NaNs as the canonical NaN, like Float.floatToIntBits.
+inline uint32_t hashValue(float value, uint32_t seed) {
+  int32_t bits;
+  if (value == 0.0f) {
+    bits = 0;
+  } else if (std::isnan(value)) {
+    bits = 0x7fc00000;
+  } else {
+    memcpy(&bits, &value, sizeof(bits));
+  }
+  return hashInt(bits, seed);
+}
+
+inline uint32_t hashValue(double value, uint32_t seed) {
+  int64_t bits;
+  if (value == 0.0) {
+    bits = 0;
+  } else if (std::isnan(value)) {
+    bits = 0x7ff8000000000000L;
+  } else {
+    memcpy(&bits, &value, sizeof(bits));
+  }
+  return hashLong(bits, seed);
+}
+
+inline uint32_t hashValue(const StringView& value, uint32_t seed) {
+  return hashBytes(value.data(), value.size(), seed);
+}
+
+inline uint32_t hashValue(const Timestamp& value, uint32_t seed) {
+  return hashLong(value.toMicros(), seed);
+}
+
+inline uint32_t hashValue(const Date& value, uint32_t seed) {
+  return hashInt(value.days(), seed);
+}
+
+// Fold one key column into the running hashes.
+template <typename T>
+void hashColumn(const BaseVector& vector, bool firstKey, uint32_t* hashes, vector_size_t numRows) {
+  if (vector.isFlatEncoding()) {
+    auto* flat = vector.asUnchecked<FlatVector<T>>();
+    auto* rawNulls = flat->rawNulls();
+    for (vector_size_t i = 0; i < numRows; ++i) {
+      if (rawNulls == nullptr || !bits::isBitNull(rawNulls, i)) {
+        hashes[i] = hashValue(flat->valueAtFast(i), hashes[i]);
+      }
+    }
+    return;
+  }
+
+  SelectivityVector rows(numRows);
+  DecodedVector decoded(vector, rows);
+  if (decoded.isConstantMapping()) {
+    if (decoded.isNullAt(0)) {
+      return;
+    }
+    auto value = decoded.valueAt<T>(0);
+    if (firstKey) {
+      std::fill(hashes, hashes + numRows, hashValue(value, kSparkMurmur3Seed));
+    } else {
+      for (vector_size_t i = 0; i < numRows; ++i) {
+        hashes[i] = hashValue(value, hashes[i]);
+      }
+    }
+    return;
+  }
+
+  auto baseSize = decoded.base()->size();
+  if (firstKey && !decoded.isIdentityMapping() && baseSize < numRows) {
+    // All rows start from the seed, so each dictionary entry needs to be hashed only once.
+    std::vector<uint32_t> baseHashes(baseSize);
+    std::vector<bool> hashed(baseSize, false);
+    for (vector_size_t i = 0; i < numRows; ++i) {
+      if (decoded.isNullAt(i)) {
+        continue;
+      }
+      auto index = decoded.index(i);
+      if (!hashed[index]) {
+        baseHashes[index] = hashValue(decoded.valueAt<T>(i), kSparkMurmur3Seed);
+        hashed[index] = true;
+      }
+      hashes[i] = baseHashes[index];
+    }
+    return;
+  }
+
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    if (!decoded.isNullAt(i)) {
+      hashes[i] = hashValue(decoded.valueAt<T>(i), hashes[i]);
+    }
+  }
+}
+
+} // namespace
+
+arrow::Status computeSparkMurmur3Hash(
+    const RowVector& rv,
+    const std::vector<int32_t>& keyIndices,
+    std::vector<int32_t>& hashes) {
+  auto numRows = rv.size();
+  hashes.resize(numRows);
+  std::fill(hashes.begin(), hashes.end(), kSparkMurmur3Seed);
+  auto* rawHashes = reinterpret_cast<uint32_t*>(hashes.data());
+
+  for (size_t i = 0; i < keyIndices.size(); ++i) {
+    auto keyIndex = keyIndices[i];
+    if (keyIndex < 0 || keyIndex >= rv.childrenSize()) {
+      return arrow::Status::Invalid(
+          "Hash partition key index " + std::to_string(keyIndex) + " is out of range of " +
+          std::to_string(rv.childrenSize()) + " columns.");
+    }
+    auto* key = rv.childAt(keyIndex)->loadedVector();
+    auto firstKey = i == 0;
+    switch (key->typeKind()) {
+      case TypeKind::BOOLEAN:
+        hashColumn<bool>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::TINYINT:
+        hashColumn<int8_t>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::SMALLINT:
+        hashColumn<int16_t>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::INTEGER:
+        hashColumn<int32_t>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::BIGINT:
+        hashColumn<int64_t>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::HUGEINT:
+        hashColumn<int128_t>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::REAL:
+        hashColumn<float>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::DOUBLE:
+        hashColumn<double>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        hashColumn<StringView>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::TIMESTAMP:
+        hashColumn<Timestamp>(*key, firstKey, rawHashes, numRows);
+        break;
+      case TypeKind::DATE:
+        hashColumn<Date>(*key, firstKey, rawHashes, numRows);
+        break;
+      default:
+        return arrow::Status::NotImplemented(
+            "Hash partitioning on key type " + key->type()->toString() + " is not supported.");
+    }
+  }
+  return arrow::Status::OK();
+}
+
+} // namespace gluten
@@ -0,0 +1,39 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/status.h>
+#include <cstdint>
+#include <vector>
+
+#include "velox/vector/ComplexVector.h"
+
+namespace gluten {
+
+// Seed of Spark's Murmur3Hash expression, which HashPartitioning uses for partition ids.
+constexpr int32_t kSparkMurmur3Seed = 42;
+
+// Compute Spark's murmur3 hash of the given key columns for every row of rv, the same value as
+// pmod(hash(keys...), n) would be computed from in a projection. Nulls leave the running hash unchanged.
+// Flat, dictionary and constant encoded keys are hashed without flattening.
+arrow::Status computeSparkMurmur3Hash(
+    const facebook::velox::RowVector& rv,
+    const std::vector<int32_t>& keyIndices,
+    std::vector<int32_t>& hashes);
+
+} // namespace gluten
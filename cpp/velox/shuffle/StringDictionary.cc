@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StringDictionary.h"
+
+namespace gluten {
+
+bool StringDictionaryEncoder::encode(
+    const int32_t* offsets,
+    const uint8_t* values,
+    uint32_t numRows,
+    double maxDistinctRatio) {
+  auto maxDistinct = static_cast<size_t>(numRows * maxDistinctRatio);
+  if (numRows == 0 || maxDistinct == 0) {
+    return false;
+  }
+  ids_.clear();
+  ids_.reserve(maxDistinct + 1);
+  indicesAndOffsets_.resize(numRows);
+  dictionaryOffsets_.assign(1, 0);
+  dictionary_.clear();
+  for (uint32_t row = 0; row < numRows; ++row) {
+    std::string_view value(reinterpret_cast<const char*>(values) + offsets[row], offsets[row + 1] - offsets[row]);
+    auto [it, inserted] = ids_.emplace(value, static_cast<int32_t>(ids_.size()));
+    if (inserted) {
+      if (ids_.size() > maxDistinct) {
+        return false;
+      }
+      dictionary_.insert(dictionary_.end(), value.begin(), value.end());
+      dictionaryOffsets_.push_back(static_cast<int32_t>(dictionary_.size()));
+    }
+    indicesAndOffsets_[row] = it->second;
+  }
+  // The indices take as much as the offsets they replace, the dictionary must be smaller than the values.
+  auto encodedBytes = dictionary_.size() + ids_.size() * sizeof(int32_t);
+  if (encodedBytes >= static_cast<size_t>(offsets[numRows] - offsets[0])) {
+    return false;
+  }
+  indicesAndOffsets_.insert(indicesAndOffsets_.end(), dictionaryOffsets_.begin(), dictionaryOffsets_.end());
+  return true;
+}
+
+} // namespace gluten
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+// Dictionary encoding of the string columns of shuffle payloads. An encoded column keeps its three buffers: the
+// validity buffer, |numRows indices i32|numDistinct + 1 dictionary offsets i32| in place of the offsets, and the
+// distinct values in place of the values. The reader tells an encoded column by its offset buffer holding more than
+// numRows + 1 offsets.
+class StringDictionaryEncoder {
+ public:
+  // Encodes the numRows strings given by their offsets and values if at most numRows * maxDistinctRatio of them are
+  // distinct and the encoding is smaller. Returns false otherwise. Not thread safe.
+  bool encode(const int32_t* offsets, const uint8_t* values, uint32_t numRows, double maxDistinctRatio);
+
+  // The indices followed by the dictionary offsets, valid after a successful encode().
+  const std::vector<int32_t>& indicesAndOffsets() const {
+    return indicesAndOffsets_;
+  }
+
+  const std::vector<uint8_t>& dictionary() const {
+    return dictionary_;
+  }
+
+ private:
+  std::unordered_map<std::string_view, int32_t> ids_;
+  std::vector<int32_t> indicesAndOffsets_;
+  std::vector<int32_t> dictionaryOffsets_;
+  std::vector<uint8_t> dictionary_;
+};
+
+// Number of distinct values of an encoded column with numRows rows and an offset buffer of offsetBufferSize bytes,
+// 0 if the column isn't encoded.
+inline int64_t numDictionaryValues(int64_t offsetBufferSize, int64_t numRows) {
+  auto numOffsets = offsetBufferSize / static_cast<int64_t>(sizeof(int32_t));
+  return numOffsets > numRows + 1 ? numOffsets - numRows - 1 : 0;
+}
+
+} // namespace gluten
@@ -18,10 +18,16 @@
 #include "VeloxShuffleReader.h"
 
 #include <arrow/array/array_binary.h>
+#include <optional>
 
+#include "compute/IOScheduler.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "shuffle/AdaptiveCompression.h"
+#include "shuffle/BlockChecksum.h"
+#include "shuffle/StringDictionary.h"
 #include "utils/ArrowTypeUtils.h"
 #include "utils/compression.h"
+#include "utils/exception.h"
 #include "utils/macros.h"
 #include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/ComplexVector.h"
@@ -60,6 +66,39 @@ BufferPtr convertToVeloxBuffer(std::shared_ptr<arrow::Buffer> buffer) {
   return wrapInBufferViewAsOwner(buffer->data(), buffer->size(), buffer);
 }
 
+// The writer elides a fixed width column whose rows are all null to no values, one whose rows all have the same value
+// to that value. Boolean columns of up to 8 rows are never elided.
+template <TypeKind kind>
+bool isElided(int64_t valueSize, uint32_t length) {
+  if (valueSize == 0) {
+    return true;
+  }
+  if constexpr (kind == TypeKind::BOOLEAN) {
+    return length > 8 && valueSize == 1;
+  } else {
+    return length > 1 && valueSize == sizeof(typename TypeTraits<kind>::NativeType);
+  }
+}
+
+template <TypeKind kind>
+VectorPtr readConstantVector(
+    const arrow::Buffer& values,
+    uint32_t length,
+    std::shared_ptr<const Type> type,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<kind>::NativeType;
+  if (values.size() == 0) {
+    return BaseVector::createNullConstant(type, length, pool);
+  }
+  T value;
+  if constexpr (kind == TypeKind::BOOLEAN) {
+    value = values.data()[0] & 1;
+  } else {
+    memcpy(&value, values.data(), sizeof(T));
+  }
+  return std::make_shared<ConstantVector<T>>(pool, length, false, type, std::move(value));
+}
+
 template <TypeKind kind>
 VectorPtr readFlatVector(
     std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
@@ -67,6 +106,10 @@ VectorPtr readFlatVector(
     uint32_t length,
     std::shared_ptr<const Type> type,
     memory::MemoryPool* pool) {
+  if (isElided<kind>(buffers[bufferIdx + 1]->size(), length)) {
+    bufferIdx += 2;
+    return readConstantVector<kind>(*buffers[bufferIdx - 1], length, type, pool);
+  }
   auto nulls = convertToVeloxBuffer(buffers[bufferIdx]);
   bufferIdx++;
   auto values = convertToVeloxBuffer(buffers[bufferIdx]);
@@ -88,6 +131,10 @@ VectorPtr readFlatVector<TypeKind::HUGEINT>(
     uint32_t length,
     std::shared_ptr<const Type> type,
     memory::MemoryPool* pool) {
+  if (isElided<TypeKind::HUGEINT>(buffers[bufferIdx + 1]->size(), length)) {
+    bufferIdx += 2;
+    return readConstantVector<TypeKind::HUGEINT>(*buffers[bufferIdx - 1], length, type, pool);
+  }
   auto nulls = convertToVeloxBuffer(buffers[bufferIdx]);
   bufferIdx++;
   auto arrowValueBuffer = buffers[bufferIdx];
@@ -112,14 +159,67 @@ VectorPtr readFlatVector<TypeKind::HUGEINT>(
       pool, type, std::move(nulls), length, std::move(values), std::move(stringBuffers));
 }
 
+VectorPtr readConstantStringView(
+    const arrow::Buffer& offsets,
+    const arrow::Buffer& values,
+    uint32_t length,
+    std::shared_ptr<const Type> type,
+    memory::MemoryPool* pool) {
+  if (offsets.size() == 0) {
+    return BaseVector::createNullConstant(type, length, pool);
+  }
+  auto size = reinterpret_cast<const int32_t*>(offsets.data())[1];
+  // Copies the value.
+  return std::make_shared<ConstantVector<StringView>>(
+      pool, length, false, type, StringView(reinterpret_cast<const char*>(values.data()), size));
+}
+
+// A string column sent dictionary encoded, see StringDictionary.h.
+VectorPtr readDictionaryStringView(
+    BufferPtr nulls,
+    const std::shared_ptr<arrow::Buffer>& indicesAndOffsets,
+    const std::shared_ptr<arrow::Buffer>& dictionaryValues,
+    uint32_t length,
+    std::shared_ptr<const Type> type,
+    memory::MemoryPool* pool) {
+  auto numDistinct = numDictionaryValues(indicesAndOffsets->size(), length);
+  auto indices = wrapInBufferViewAsOwner(indicesAndOffsets->data(), length * sizeof(vector_size_t), indicesAndOffsets);
+  auto rawOffset = reinterpret_cast<const int32_t*>(indicesAndOffsets->data()) + length;
+  auto values = AlignedBuffer::allocate<StringView>(numDistinct, pool);
+  auto rawValues = values->asMutable<StringView>();
+  auto rawChars = reinterpret_cast<const char*>(dictionaryValues->data());
+  for (int64_t i = 0; i < numDistinct; ++i) {
+    rawValues[i] = StringView(rawChars + rawOffset[i], rawOffset[i + 1] - rawOffset[i]);
+  }
+  std::vector<BufferPtr> stringBuffers{convertToVeloxBuffer(dictionaryValues)};
+  auto dictionary = std::make_shared<FlatVector<StringView>>(
+      pool, type, BufferPtr(nullptr), numDistinct, std::move(values), std::move(stringBuffers));
+  if (nulls != nullptr && nulls->size() == 0) {
+    nulls = nullptr;
+  }
+  return BaseVector::wrapInDictionary(std::move(nulls), std::move(indices), length, std::move(dictionary));
+}
+
 VectorPtr readFlatVectorStringView(
     std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
     int32_t& bufferIdx,
     uint32_t length,
     std::shared_ptr<const Type> type,
     memory::MemoryPool* pool) {
+  auto offsetSize = buffers[bufferIdx + 1]->size();
+  if (offsetSize == 0 || (length > 1 && offsetSize == sizeof(int32_t) * 2)) {
+    // Elided by the writer, all null or one value.
+    auto vector = readConstantStringView(*buffers[bufferIdx + 1], *buffers[bufferIdx + 2], length, type, pool);
+    bufferIdx += 3;
+    return vector;
+  }
   auto nulls = convertToVeloxBuffer(buffers[bufferIdx]);
   bufferIdx++;
+  if (numDictionaryValues(buffers[bufferIdx]->size(), length) > 0) {
+    auto vector = readDictionaryStringView(nulls, buffers[bufferIdx], buffers[bufferIdx + 1], length, type, pool);
+    bufferIdx += 2;
+    return vector;
+  }
   auto offsetBuffers = convertToVeloxBuffer(buffers[bufferIdx]);
   bufferIdx++;
   auto valueBuffers = convertToVeloxBuffer(buffers[bufferIdx]);
@@ -243,38 +343,194 @@ std::shared_ptr<arrow::Buffer> readColumnBuffer(const arrow::RecordBatch& batch,
   return std::dynamic_pointer_cast<arrow::LargeStringArray>(batch.column(fieldIdx))->value_data();
 }
 
+// Slice of the decompression slab. Keeps the slab alive so it's only reused once all vectors are released.
+class SlabSliceBuffer : public arrow::Buffer {
+ public:
+  SlabSliceBuffer(BufferPtr slab, int64_t offset, int64_t size)
+      : arrow::Buffer(slab->as<uint8_t>() + offset, size), slab_(std::move(slab)) {}
+
+ private:
+  BufferPtr slab_;
+};
+
+constexpr int64_t kSlabAlignment = 64;
+
+// Header of a compressed batch: |numRows u32|compressionType i32|, followed by the layout i32 if it's not the legacy
+// pairs of lengths.
+constexpr int64_t kAdaptiveHeaderSize = sizeof(uint32_t) + sizeof(int32_t) * 2;
+
+struct CompressedBuffer {
+  BufferEncoding encoding;
+  // Decompresses kLz4 and kZstd buffers. Buffers of legacy batches are all marked kLz4 and use the header codec.
+  arrow::util::Codec* codec;
+  int64_t uncompressedLength;
+  int64_t compressedLength;
+};
+
+arrow::util::Codec* getCodec(CodecCache& codecs, arrow::Compression::type type, CodecBackend codecBackend) {
+  // Prefetching readers decode their blocks in parallel.
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& codec = codecs[type];
+  if (codec == nullptr) {
+    codec = createArrowIpcCodec(type, codecBackend);
+  }
+  return codec.get();
+}
+
+std::vector<CompressedBuffer> readCompressedBuffers(
+    const int64_t* lengthPtr,
+    bool adaptive,
+    arrow::Compression::type compressType,
+    CodecBackend codecBackend,
+    CodecCache& codecs) {
+  auto numBuffers = lengthPtr[0];
+  std::vector<CompressedBuffer> compressedBuffers;
+  compressedBuffers.reserve(numBuffers);
+  if (!adaptive) {
+    // |buffers.size()|buffer1 unCompressedLength|buffer1 compressedLength| buffer2...
+    // Small buffers are stored uncompressed with unCompressedLength -1, all others with the header codec.
+    auto* codec = getCodec(codecs, compressType, codecBackend);
+    for (int64_t i = 0, j = 1; i < numBuffers; i++, j = j + 2) {
+      if (lengthPtr[j] == -1) {
+        compressedBuffers.push_back({BufferEncoding::kRaw, nullptr, lengthPtr[j + 1], lengthPtr[j + 1]});
+      } else {
+        auto encoding = lengthPtr[j] == 0 ? BufferEncoding::kRaw : BufferEncoding::kLz4;
+        compressedBuffers.push_back({encoding, codec, lengthPtr[j], lengthPtr[j + 1]});
+      }
+    }
+    return compressedBuffers;
+  }
+  for (int64_t i = 0, j = 1; i < numBuffers; i++, j = j + 3) {
+    auto encoding = static_cast<BufferEncoding>(lengthPtr[j]);
+    arrow::util::Codec* codec = nullptr;
+    if (encoding == BufferEncoding::kLz4 || encoding == BufferEncoding::kZstd) {
+      // Only buffers of the configured codec type are compressed with the configured codec backend.
+      auto type = encoding == BufferEncoding::kLz4 ? arrow::Compression::LZ4_FRAME : arrow::Compression::ZSTD;
+      codec = getCodec(codecs, type, type == compressType ? codecBackend : CodecBackend::NONE);
+    }
+    compressedBuffers.push_back({encoding, codec, lengthPtr[j + 1], lengthPtr[j + 2]});
+  }
+  return compressedBuffers;
+}
+
+bool needsDecoding(const CompressedBuffer& buffer) {
+  return buffer.encoding != BufferEncoding::kRaw && buffer.uncompressedLength > 0;
+}
+
+void prepareDecompressionSlab(
+    const std::vector<CompressedBuffer>& compressedBuffers,
+    BufferPtr& slab,
+    memory::MemoryPool* pool) {
+  int64_t slabSize = 0;
+  for (auto& buffer : compressedBuffers) {
+    if (needsDecoding(buffer)) {
+      slabSize += ROUND_TO_LINE(buffer.uncompressedLength, kSlabAlignment);
+    }
+  }
+  if (slabSize == 0) {
+    return;
+  }
+  if (slab == nullptr || slab->refCount() > 1 || slab->capacity() < slabSize) {
+    slab = AlignedBuffer::allocate<uint8_t>(slabSize, pool);
+  }
+}
+
+// Register the dictionaries a kAdaptiveDictionaryLayout batch carries after its buffers and return their scope.
+uint64_t
+readDictionaries(const int64_t* lengthPtr, const arrow::Buffer& valueBuffer, ZstdDictionaryCache& dictionaries) {
+  auto numBuffers = lengthPtr[0];
+  int64_t valueOffset = 0;
+  for (int64_t i = 0; i < numBuffers; ++i) {
+    valueOffset += lengthPtr[1 + i * 3 + 2];
+  }
+  auto* entries = lengthPtr + 1 + numBuffers * 3;
+  auto scope = static_cast<uint64_t>(entries[0]);
+  auto numDictionaries = entries[1];
+  for (int64_t i = 0, j = 2; i < numDictionaries; i++, j = j + 2) {
+    auto length = entries[j + 1];
+    GLUTEN_CHECK(valueOffset + length <= valueBuffer.size(), "Shuffle ZSTD dictionary is truncated.");
+    GLUTEN_THROW_NOT_OK(
+        dictionaries.add(scope, static_cast<uint32_t>(entries[j]), valueBuffer.data() + valueOffset, length));
+    valueOffset += length;
+  }
+  return scope;
+}
+
 void getUncompressedBuffers(
     const arrow::RecordBatch& batch,
+    const std::vector<CompressedBuffer>& compressedBuffers,
+    ZstdDictionaryCache& dictionaries,
+    uint64_t dictionaryScope,
     arrow::MemoryPool* arrowPool,
-    const arrow::Compression::type compressType,
-    CodecBackend codecBackend,
+    BufferPtr* slab,
+    memory::MemoryPool* pool,
     std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
-  auto lengthBuffer = readColumnBuffer(batch, 1);
-  const int64_t* lengthPtr = reinterpret_cast<const int64_t*>(lengthBuffer->data());
-  auto valueBufferLength = lengthPtr[0];
   auto valueBuffer = readColumnBuffer(batch, 2);
   int64_t valueOffset = 0;
-  auto codec = createArrowIpcCodec(compressType, codecBackend);
-  for (int64_t i = 0, j = 1; i < valueBufferLength; i++, j = j + 2) {
-    int64_t uncompressLength = lengthPtr[j];
-    int64_t compressLength = lengthPtr[j + 1];
+  int64_t slabOffset = 0;
+  if (slab != nullptr) {
+    prepareDecompressionSlab(compressedBuffers, *slab, pool);
+  }
+  for (auto& compressed : compressedBuffers) {
+    auto compressLength = compressed.compressedLength;
+    auto uncompressLength = compressed.uncompressedLength;
     auto compressBuffer = arrow::SliceBuffer(valueBuffer, valueOffset, compressLength);
     valueOffset += compressLength;
-    // Small buffer, not compressed
-    if (uncompressLength == -1) {
+    if (compressed.encoding == BufferEncoding::kRaw && uncompressLength > 0) {
+      // Small or incompressible buffer, stored as is
       buffers.emplace_back(compressBuffer);
-    } else {
-      std::shared_ptr<arrow::Buffer> uncompressBuffer = std::make_shared<arrow::Buffer>(nullptr, 0);
-      if (uncompressLength != 0) {
+      continue;
+    }
+    std::shared_ptr<arrow::Buffer> uncompressBuffer = std::make_shared<arrow::Buffer>(nullptr, 0);
+    if (needsDecoding(compressed)) {
+      uint8_t* output;
+      if (slab != nullptr) {
+        output = (*slab)->asMutable<uint8_t>() + slabOffset;
+        uncompressBuffer = std::make_shared<SlabSliceBuffer>(*slab, slabOffset, uncompressLength);
+        slabOffset += ROUND_TO_LINE(uncompressLength, kSlabAlignment);
+      } else {
         GLUTEN_ASSIGN_OR_THROW(uncompressBuffer, arrow::AllocateBuffer(uncompressLength, arrowPool));
+        output = uncompressBuffer->mutable_data();
+      }
+      if (compressed.encoding == BufferEncoding::kBitPacked) {
+        GLUTEN_THROW_NOT_OK(bitUnpack(compressBuffer->data(), compressLength, output, uncompressLength));
+      } else if (compressed.encoding == BufferEncoding::kZstdDict) {
         GLUTEN_ASSIGN_OR_THROW(
             auto actualDecompressLength,
-            codec->Decompress(
-                compressLength, compressBuffer->data(), uncompressLength, uncompressBuffer->mutable_data()));
+            dictionaries.decompress(dictionaryScope, compressBuffer->data(), compressLength, output, uncompressLength));
+        VELOX_DCHECK_EQ(actualDecompressLength, uncompressLength);
+      } else {
+        GLUTEN_ASSIGN_OR_THROW(
+            auto actualDecompressLength,
+            compressed.codec->Decompress(compressLength, compressBuffer->data(), uncompressLength, output));
         VELOX_DCHECK_EQ(actualDecompressLength, uncompressLength);
       }
-      buffers.emplace_back(uncompressBuffer);
     }
+    buffers.emplace_back(uncompressBuffer);
+  }
+}
+
+int32_t readLayout(const arrow::Buffer& header) {
+  int32_t layout = 0;
+  if (header.size() >= kAdaptiveHeaderSize) {
+    memcpy(&layout, header.data() + sizeof(uint32_t) + sizeof(int32_t), sizeof(int32_t));
+  }
+  return layout;
+}
+
+// Verified when the batch is read, before any of its buffers is decompressed or deserialized.
+void verifyBlockChecksum(const arrow::RecordBatch& batch, const arrow::Buffer& header) {
+  uint32_t expected;
+  memcpy(&expected, header.data() + kChecksumHeaderSize - sizeof(uint32_t), sizeof(uint32_t));
+  auto checksum = kBlockChecksumSeed;
+  for (int32_t i = 1; i < batch.num_columns(); ++i) {
+    checksum = extendBlockChecksum(checksum, readColumnBuffer(batch, i).get());
+  }
+  if (checksum != expected) {
+    throw GlutenException(
+        "Shuffle block checksum mismatch, expected " + std::to_string(expected) + " but got " +
+        std::to_string(checksum) + ". The block is corrupted.");
   }
 }
 
@@ -284,8 +540,14 @@ RowVectorPtr readRowVectorInternal(
     CodecBackend codecBackend,
     int64_t& decompressTime,
     arrow::MemoryPool* arrowPool,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    CodecCache& codecs,
+    ZstdDictionaryCache& dictionaries,
+    BufferPtr* slab) {
   auto header = readColumnBuffer(batch, 0);
+  if (header->size() >= kChecksumHeaderSize) {
+    verifyBlockChecksum(batch, *header);
+  }
   uint32_t length;
   memcpy(&length, header->data(), sizeof(uint32_t));
   int32_t compressTypeValue;
@@ -301,11 +563,34 @@ RowVectorPtr readRowVectorInternal(
     }
   } else {
     TIME_NANO_START(decompressTime);
-    getUncompressedBuffers(batch, arrowPool, compressType, codecBackend, buffers);
+    auto layout = readLayout(*header);
+    auto lengthBuffer = readColumnBuffer(batch, 1);
+    auto* lengthPtr = reinterpret_cast<const int64_t*>(lengthBuffer->data());
+    auto compressedBuffers = readCompressedBuffers(
+        lengthPtr,
+        layout == kAdaptiveCompressionLayout || layout == kAdaptiveDictionaryLayout,
+        compressType,
+        codecBackend,
+        codecs);
+    uint64_t dictionaryScope = 0;
+    if (layout == kAdaptiveDictionaryLayout) {
+      dictionaryScope = readDictionaries(lengthPtr, *readColumnBuffer(batch, 2), dictionaries);
+    }
+    getUncompressedBuffers(batch, compressedBuffers, dictionaries, dictionaryScope, arrowPool, slab, pool, buffers);
     TIME_NANO_END(decompressTime);
   }
   return deserialize(rowType, length, buffers, pool);
 }
+
+RowVectorPtr mergeRowVectors(const std::vector<RowVectorPtr>& vectors, vector_size_t numRows, memory::MemoryPool* pool) {
+  auto merged = BaseVector::create<RowVector>(vectors[0]->type(), numRows, pool);
+  vector_size_t offset = 0;
+  for (const auto& vector : vectors) {
+    merged->copy(vector.get(), offset, 0, vector->size());
+    offset += vector->size();
+  }
+  return merged;
+}
 } // namespace
 
 VeloxShuffleReader::VeloxShuffleReader(
@@ -313,20 +598,151 @@ VeloxShuffleReader::VeloxShuffleReader(
     std::shared_ptr<arrow::Schema> schema,
     ReaderOptions options,
     std::shared_ptr<arrow::MemoryPool> pool,
-    std::shared_ptr<memory::MemoryPool> veloxPool)
+    std::shared_ptr<memory::MemoryPool> veloxPool,
+    folly::Executor* executor)
     : Reader(in, schema, options, pool), veloxPool_(std::move(veloxPool)) {
   rowType_ = asRowType(gluten::fromArrowSchema(schema));
+  if (executor != nullptr && options_.prefetch_blocks > 0) {
+    executor_ = executor;
+    serialExecutor_ = folly::SerialExecutor::create(folly::getKeepAliveToken(executor));
+  }
+}
+
+VeloxShuffleReader::~VeloxShuffleReader() {
+  // The blocks in flight use the stream and the caches of the reader.
+  for (auto& block : pending_) {
+    block.wait();
+  }
 }
 
 arrow::Result<std::shared_ptr<ColumnarBatch>> VeloxShuffleReader::next() {
-  ARROW_ASSIGN_OR_RAISE(auto batch, Reader::next());
+  auto vector = nextRowVector();
+  if (vector == nullptr) {
+    return nullptr;
+  }
+  if (vector->size() < options_.merge_batch_rows) {
+    // Many small blocks of many mappers become one batch.
+    std::vector<RowVectorPtr> vectors{vector};
+    vector_size_t numRows = vector->size();
+    while (numRows < options_.merge_batch_rows) {
+      auto more = nextRowVector();
+      if (more == nullptr) {
+        break;
+      }
+      numRows += more->size();
+      vectors.push_back(std::move(more));
+    }
+    if (vectors.size() > 1) {
+      vector = mergeRowVectors(vectors, numRows, veloxPool_.get());
+    }
+  }
+  return std::make_shared<VeloxColumnarBatch>(vector);
+}
+
+RowVectorPtr VeloxShuffleReader::nextRowVector() {
+  if (reachedEnd_) {
+    return nullptr;
+  }
+  if (executor_ == nullptr) {
+    GLUTEN_ASSIGN_OR_THROW(auto batch, Reader::next());
+    if (batch == nullptr) {
+      reachedEnd_ = true;
+      return nullptr;
+    }
+    auto rb = std::dynamic_pointer_cast<ArrowColumnarBatch>(batch)->getRecordBatch();
+    return readRowVectorInternal(
+        *rb,
+        rowType_,
+        options_.codec_backend,
+        decompressTime_,
+        pool_.get(),
+        veloxPool_.get(),
+        codecs_,
+        dictionaries_,
+        options_.decompress_into_slab ? &decompressionSlab_ : nullptr);
+  }
+  prefetch();
+  if (pending_.empty()) {
+    reachedEnd_ = true;
+    return nullptr;
+  }
+  auto block = std::move(pending_.front()).get();
+  pending_.pop_front();
+  decompressTime_ += block.decompressTime;
+  prefetch();
+  return block.vector;
+}
+
+void VeloxShuffleReader::prefetch() {
+  // Hardware codecs queue their own jobs, their blocks are decoded one at a time.
+  auto* decodeExecutor = options_.codec_backend == CodecBackend::NONE ? executor_ : serialExecutor_.get();
+  while (!streamEnded_ && pending_.size() < static_cast<size_t>(options_.prefetch_blocks)) {
+    auto batch = readRecordBatch();
+    if (batch == nullptr) {
+      break;
+    }
+    // The first block is waited for right away.
+    std::optional<ScopedIOPriority> demand;
+    if (pending_.empty()) {
+      demand.emplace(IOPriority::kDemand);
+    }
+    pending_.push_back(
+        folly::via(folly::getKeepAliveToken(decodeExecutor), [this, batch] { return decodeBlock(batch); }).semi());
+  }
+}
+
+std::shared_ptr<arrow::RecordBatch> VeloxShuffleReader::readRecordBatch() {
+  GLUTEN_ASSIGN_OR_THROW(auto batch, Reader::next());
   if (batch == nullptr) {
+    streamEnded_ = true;
     return nullptr;
   }
   auto rb = std::dynamic_pointer_cast<ArrowColumnarBatch>(batch)->getRecordBatch();
-  auto vp =
-      readRowVectorInternal(*rb, rowType_, options_.codec_backend, decompressTime_, pool_.get(), veloxPool_.get());
-  return std::make_shared<VeloxColumnarBatch>(vp);
+  // A block may use the dictionaries of any block before it, register them in stream order.
+  auto header = readColumnBuffer(*rb, 0);
+  int32_t compressType;
+  memcpy(&compressType, header->data() + sizeof(uint32_t), sizeof(int32_t));
+  if (compressType != arrow::Compression::UNCOMPRESSED && readLayout(*header) == kAdaptiveDictionaryLayout) {
+    auto lengthBuffer = readColumnBuffer(*rb, 1);
+    readDictionaries(reinterpret_cast<const int64_t*>(lengthBuffer->data()), *readColumnBuffer(*rb, 2), dictionaries_);
+  }
+  return rb;
+}
+
+VeloxShuffleReader::DecodedBlock VeloxShuffleReader::decodeBlock(const std::shared_ptr<arrow::RecordBatch>& batch) {
+  DecodedBlock block;
+  // Blocks decoded in parallel can't share the slab.
+  block.vector = readRowVectorInternal(
+      *batch,
+      rowType_,
+      options_.codec_backend,
+      block.decompressTime,
+      pool_.get(),
+      veloxPool_.get(),
+      codecs_,
+      dictionaries_,
+      nullptr);
+  return block;
+}
+
+int64_t VeloxShuffleReader::getHardwareDecompressedBytes() {
+  int64_t bytes = 0;
+  for (auto& [type, codec] : codecs_) {
+    if (auto* hybridCodec = dynamic_cast<HybridDecompressCodec*>(codec.get())) {
+      bytes += hybridCodec->hardwareDecompressedBytes();
+    }
+  }
+  return bytes;
+}
+
+int64_t VeloxShuffleReader::getSoftwareDecompressedBytes() {
+  int64_t bytes = 0;
+  for (auto& [type, codec] : codecs_) {
+    if (auto* hybridCodec = dynamic_cast<HybridDecompressCodec*>(codec.get())) {
+      bytes += hybridCodec->softwareDecompressedBytes();
+    }
+  }
+  return bytes;
 }
 
 RowVectorPtr VeloxShuffleReader::readRowVector(
@@ -334,9 +750,21 @@ RowVectorPtr VeloxShuffleReader::readRowVector(
     RowTypePtr rowType,
     CodecBackend codecBackend,
     arrow::MemoryPool* arrowPool,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    ZstdDictionaryCache* dictionaries) {
   int64_t decompressTime = 0;
-  return readRowVectorInternal(rb, rowType, codecBackend, decompressTime, arrowPool, pool);
+  CodecCache codecs;
+  ZstdDictionaryCache batchDictionaries;
+  return readRowVectorInternal(
+      rb,
+      rowType,
+      codecBackend,
+      decompressTime,
+      arrowPool,
+      pool,
+      codecs,
+      dictionaries != nullptr ? *dictionaries : batchDictionaries,
+      nullptr);
 }
 
 } // namespace gluten
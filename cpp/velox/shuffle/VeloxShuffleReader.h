@@ -17,11 +17,23 @@
 
 #pragma once
 
+#include <deque>
+#include <unordered_map>
+
+#include <folly/executors/SerialExecutor.h>
+#include <folly/futures/Future.h>
+
+#include "shuffle/AdaptiveCompression.h"
 #include "shuffle/reader.h"
+#include "velox/buffer/Buffer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
 
 namespace gluten {
+
+// Decompression codecs by compression type, reused across batches.
+using CodecCache = std::unordered_map<arrow::Compression::type, std::shared_ptr<arrow::util::Codec>>;
+
 class VeloxShuffleReader final : public Reader {
  public:
   explicit VeloxShuffleReader(
@@ -29,21 +41,60 @@ class VeloxShuffleReader final : public Reader {
       std::shared_ptr<arrow::Schema> schema,
       ReaderOptions options,
       std::shared_ptr<arrow::MemoryPool> pool,
-      std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool);
+      std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool,
+      folly::Executor* executor = nullptr);
+
+  ~VeloxShuffleReader() override;
 
   arrow::Result<std::shared_ptr<ColumnarBatch>> next() override;
 
-  // Visiable for testing
+  int64_t getHardwareDecompressedBytes() override;
+
+  int64_t getSoftwareDecompressedBytes() override;
+
+  // Visiable for testing. The batches of a partition share the dictionaries.
   static facebook::velox::RowVectorPtr readRowVector(
       const arrow::RecordBatch& batch,
       facebook::velox::RowTypePtr rowType,
       CodecBackend codecBackend,
       arrow::MemoryPool* arrowPool,
-      facebook::velox::memory::MemoryPool* pool);
+      facebook::velox::memory::MemoryPool* pool,
+      ZstdDictionaryCache* dictionaries = nullptr);
 
  private:
+  struct DecodedBlock {
+    // Null at the end of the stream.
+    facebook::velox::RowVectorPtr vector;
+    int64_t decompressTime = 0;
+  };
+
+  facebook::velox::RowVectorPtr nextRowVector();
+
+  // Keep ReaderOptions::prefetch_blocks blocks in flight.
+  void prefetch();
+
+  // Reads the next batch of the stream and registers its dictionaries. The stream is only read on the thread of the
+  // task, which is the one the JVM input stream expects and where its exceptions reach Spark.
+  std::shared_ptr<arrow::RecordBatch> readRecordBatch();
+
+  DecodedBlock decodeBlock(const std::shared_ptr<arrow::RecordBatch>& batch);
+
   facebook::velox::RowTypePtr rowType_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
+
+  CodecCache codecs_;
+  // Received from kAdaptiveDictionaryLayout batches of the stream.
+  ZstdDictionaryCache dictionaries_;
+  // Only used with ReaderOptions::decompress_into_slab. Reused when no vector of the previous batch holds it.
+  facebook::velox::BufferPtr decompressionSlab_;
+
+  // Set with ReaderOptions::prefetch_blocks. The blocks read ahead are decoded in parallel on executor_, or one at a
+  // time on serialExecutor_ with hardware codecs.
+  folly::Executor* executor_ = nullptr;
+  folly::Executor::KeepAlive<folly::SerialExecutor> serialExecutor_;
+  std::deque<folly::SemiFuture<DecodedBlock>> pending_;
+  bool reachedEnd_ = false;
+  bool streamEnded_ = false;
 };
 
 } // namespace gluten
@@ -16,9 +16,17 @@
  */
 
 #include "VeloxShuffleWriter.h"
+
+#include <arrow/util/bitmap_ops.h>
+#include <chrono>
+#include <cmath>
+
 #include "memory/ArrowMemory.h"
+#include "memory/ArrowMemoryPool.h"
 #include "memory/VeloxColumnarBatch.h"
 #include "memory/VeloxMemoryPool.h"
+#include "shuffle/BlockChecksum.h"
+#include "shuffle/SparkMurmur3Hash.h"
 #include "utils/ArrowTypeUtils.h"
 #include "velox/vector/arrow/Bridge.h"
 
@@ -35,7 +43,10 @@
 #include <arm_neon.h>
 #endif
 
+#include <folly/futures/Future.h>
 #include <iostream>
+#include <limits>
+#include <numeric>
 
 using namespace facebook;
 using namespace facebook::velox;
@@ -82,6 +93,119 @@ std::string m128iToString(const __m128i var) {
 
 namespace {
 
+// String payloads with more distinct values than this share of their rows are sent as they are.
+constexpr double kMaxDictionaryDistinctRatio = 0.5;
+
+// Weight of the latest RowVector in the moving averages of the row rates and string widths of the partitions.
+constexpr float kRateSmoothing = 0.2;
+// The buffers of a partition hold the rows it gets over this many RowVectors at its rate, at least
+// kMinPartitionBufferSize rows.
+constexpr double kRowVectorsPerPartitionBuffer = 32;
+constexpr uint32_t kMinPartitionBufferSize = 64;
+// Full buffers this many times larger than the partition needs are reallocated smaller instead of reused.
+constexpr uint32_t kPartitionBufferShrinkRatio = 4;
+
+bool allNull(const std::shared_ptr<arrow::Buffer>& validity, uint32_t numRows) {
+  return validity != nullptr && arrow::internal::CountSetBits(validity->data(), 0, numRows) == 0;
+}
+
+bool noNull(const std::shared_ptr<arrow::Buffer>& validity, uint32_t numRows) {
+  return validity == nullptr || arrow::internal::CountSetBits(validity->data(), 0, numRows) == numRows;
+}
+
+// A fixed width column of a payload whose rows are all null is sent without validity and values, one whose rows all
+// have the same value without validity and with only that value. Boolean columns of up to 8 rows are sent as they
+// are, their one value couldn't be told from their bits. Returns true if the column was elided.
+bool elideFixedWidthColumn(
+    std::shared_ptr<arrow::Buffer>& validity,
+    std::shared_ptr<arrow::Buffer>& values,
+    uint32_t numRows,
+    bool isBool,
+    ShuffleBufferPool* pool) {
+  if (allNull(validity, numRows)) {
+    validity = nullptr;
+    values = nullptr;
+    return true;
+  }
+  if (numRows < 2 || !noNull(validity, numRows)) {
+    return false;
+  }
+  if (isBool) {
+    auto numSet = arrow::internal::CountSetBits(values->data(), 0, numRows);
+    if (numRows <= 8 || (numSet != 0 && numSet != numRows)) {
+      return false;
+    }
+    std::shared_ptr<arrow::ResizableBuffer> value;
+    GLUTEN_THROW_NOT_OK(pool->allocateDirectly(value, 1));
+    value->mutable_data()[0] = numSet == 0 ? 0 : 1;
+    values = std::move(value);
+  } else {
+    auto width = values->size() / numRows;
+    auto* data = values->data();
+    for (uint32_t row = 1; row < numRows; ++row) {
+      if (memcmp(data, data + row * width, width) != 0) {
+        return false;
+      }
+    }
+    values = arrow::SliceBuffer(values, 0, width);
+  }
+  validity = nullptr;
+  return true;
+}
+
+// A string column of a payload whose rows are all null is sent without buffers, one whose rows all have the same
+// value without validity and as that one string. Returns true if the column was elided.
+bool elideStringColumn(
+    std::shared_ptr<arrow::Buffer>& validity,
+    std::shared_ptr<arrow::Buffer>& offsets,
+    std::shared_ptr<arrow::Buffer>& values,
+    uint32_t numRows,
+    ShuffleBufferPool* pool) {
+  if (allNull(validity, numRows)) {
+    validity = nullptr;
+    offsets = nullptr;
+    values = nullptr;
+    return true;
+  }
+  if (numRows < 2 || !noNull(validity, numRows)) {
+    return false;
+  }
+  auto* rawOffsets = reinterpret_cast<const int32_t*>(offsets->data());
+  auto length = rawOffsets[1] - rawOffsets[0];
+  auto* data = values != nullptr ? values->data() : nullptr;
+  for (uint32_t row = 1; row < numRows; ++row) {
+    if (rawOffsets[row + 1] - rawOffsets[row] != length ||
+        (length > 0 && memcmp(data, data + rawOffsets[row], length) != 0)) {
+      return false;
+    }
+  }
+  std::shared_ptr<arrow::ResizableBuffer> valueOffsets;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(valueOffsets, sizeof(int32_t) * 2));
+  auto* rawValueOffsets = reinterpret_cast<int32_t*>(valueOffsets->mutable_data());
+  rawValueOffsets[0] = 0;
+  rawValueOffsets[1] = length;
+  validity = nullptr;
+  offsets = std::move(valueOffsets);
+  values = length > 0 ? arrow::SliceBuffer(values, 0, length) : nullptr;
+  return true;
+}
+
+// Adds the time from construction to destruction to nanos.
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(std::atomic<int64_t>& nanos) : nanos_(nanos), start_(std::chrono::steady_clock::now()) {}
+
+  ~PhaseTimer() {
+    nanos_.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count(),
+        std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<int64_t>& nanos_;
+  std::chrono::steady_clock::time_point start_;
+};
+
 bool vectorHasNull(const velox::VectorPtr& vp) {
   if (!vp->mayHaveNulls()) {
     return false;
@@ -212,6 +336,47 @@ std::shared_ptr<arrow::RecordBatch> makeCompressedRecordBatch(
   std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
   GLUTEN_THROW_NOT_OK(pool->allocateDirectly(valueBuffer, compressedBufferMaxSize));
   int64_t compressValueOffset = 0;
+  if (dynamic_cast<BatchCompressCodec*>(codec) != nullptr) {
+    // All buffers of the payload are in flight on the accelerator at once, each compressed into its worst case slot of
+    // valueBuffer. Packing them then never overwrites a slot not moved yet.
+    std::vector<CompressJob> jobs;
+    int64_t slotOffset = 0;
+    for (auto& buffer : buffers) {
+      if (buffer != nullptr && buffer->size() != 0) {
+        int64_t maxLength = codec->MaxCompressedLen(buffer->size(), nullptr);
+        if (buffer->size() >= bufferCompressThreshold) {
+          jobs.push_back({buffer->data(), buffer->size(), valueBuffer->mutable_data() + slotOffset, maxLength, 0});
+        }
+        slotOffset += maxLength;
+      }
+    }
+    GLUTEN_THROW_NOT_OK(compressBatch(codec, jobs));
+    auto job = jobs.begin();
+    for (auto& buffer : buffers) {
+      if (buffer != nullptr && buffer->size() != 0) {
+        int64_t actualLength;
+        if (buffer->size() >= bufferCompressThreshold) {
+          writeInt64(lengthBuffer, offset, buffer->size());
+          actualLength = job->compressedLength;
+          memmove(valueBuffer->mutable_data() + compressValueOffset, job->output, actualLength);
+          ++job;
+        } else {
+          writeInt64(lengthBuffer, offset, -1);
+          memcpy(valueBuffer->mutable_data() + compressValueOffset, buffer->data(), buffer->size());
+          actualLength = buffer->size();
+        }
+        compressValueOffset += actualLength;
+        writeInt64(lengthBuffer, offset, actualLength);
+      } else {
+        writeInt64(lengthBuffer, offset, 0);
+        writeInt64(lengthBuffer, offset, 0);
+      }
+    }
+    GLUTEN_THROW_NOT_OK(valueBuffer->Resize(compressValueOffset, /*shrink*/ true));
+    arrays.emplace_back(makeBinaryArray(compressWriteSchema->field(1)->type(), lengthBuffer, pool));
+    arrays.emplace_back(makeBinaryArray(compressWriteSchema->field(2)->type(), valueBuffer, pool));
+    return arrow::RecordBatch::Make(compressWriteSchema, 1, {arrays});
+  }
   for (auto& buffer : buffers) {
     if (buffer != nullptr && buffer->size() != 0) {
       int64_t actualLength;
@@ -241,6 +406,100 @@ std::shared_ptr<arrow::RecordBatch> makeCompressedRecordBatch(
   return arrow::RecordBatch::Make(compressWriteSchema, 1, {arrays});
 }
 
+// Same as makeCompressedRecordBatch, but each buffer records the encoding the compressor chose for it. A batch with
+// kZstdDict buffers records the dictionary scope, and appends the dictionaries not in the sentDictionaryIds of the
+// partition.
+std::shared_ptr<arrow::RecordBatch> makeAdaptiveCompressedRecordBatch(
+    uint32_t numRows,
+    const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    const std::shared_ptr<arrow::Schema> compressWriteSchema,
+    ShuffleBufferPool* pool,
+    arrow::Compression::type compressionType,
+    AdaptiveBufferCompressor* compressor,
+    int32_t bufferCompressThreshold,
+    std::vector<uint32_t>& sentDictionaryIds) {
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  // header col, numRows, compressionType, layout
+  std::shared_ptr<arrow::ResizableBuffer> headerBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(headerBuffer, sizeof(uint32_t) + sizeof(int32_t) * 2));
+  memcpy(headerBuffer->mutable_data(), &numRows, sizeof(uint32_t));
+  int32_t compressType = static_cast<int32_t>(compressionType);
+  memcpy(headerBuffer->mutable_data() + sizeof(uint32_t), &compressType, sizeof(int32_t));
+
+  auto maxDictionaryLength = compressor->maxDictionaryLength();
+  auto maxLengthEntries = buffers.size() * 3 + 1;
+  if (maxDictionaryLength > 0) {
+    maxLengthEntries += buffers.size() * 2 + 2;
+  }
+  std::shared_ptr<arrow::ResizableBuffer> lengthBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(lengthBuffer, maxLengthEntries * sizeof(int64_t)));
+  int64_t offset = 0;
+  writeInt64(lengthBuffer, offset, buffers.size());
+
+  int64_t compressedBufferMaxSize = 0;
+  for (auto& buffer : buffers) {
+    if (buffer != nullptr && buffer->size() != 0) {
+      compressedBufferMaxSize += compressor->maxCompressedLength(buffer->size()) + maxDictionaryLength;
+    }
+  }
+  std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(valueBuffer, compressedBufferMaxSize));
+  int64_t compressValueOffset = 0;
+  std::vector<const ZstdDictionary*> newDictionaries;
+  bool usesDictionary = false;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    auto& buffer = buffers[i];
+    if (buffer != nullptr && buffer->size() != 0) {
+      auto encoding = BufferEncoding::kRaw;
+      int64_t actualLength;
+      if (buffer->size() >= bufferCompressThreshold) {
+        const ZstdDictionary* dictionary;
+        GLUTEN_ASSIGN_OR_THROW(
+            actualLength,
+            compressor->compress(*buffer, i, valueBuffer->mutable_data() + compressValueOffset, encoding, dictionary));
+        usesDictionary |= dictionary != nullptr;
+        if (dictionary != nullptr &&
+            std::find(sentDictionaryIds.begin(), sentDictionaryIds.end(), dictionary->id()) ==
+                sentDictionaryIds.end()) {
+          sentDictionaryIds.push_back(dictionary->id());
+          newDictionaries.push_back(dictionary);
+        }
+      } else {
+        memcpy(valueBuffer->mutable_data() + compressValueOffset, buffer->data(), buffer->size());
+        actualLength = buffer->size();
+      }
+      compressValueOffset += actualLength;
+      writeInt64(lengthBuffer, offset, static_cast<int64_t>(encoding));
+      writeInt64(lengthBuffer, offset, buffer->size());
+      writeInt64(lengthBuffer, offset, actualLength);
+    } else {
+      writeInt64(lengthBuffer, offset, static_cast<int64_t>(BufferEncoding::kRaw));
+      writeInt64(lengthBuffer, offset, 0);
+      writeInt64(lengthBuffer, offset, 0);
+    }
+  }
+  auto layout = kAdaptiveCompressionLayout;
+  if (usesDictionary) {
+    layout = kAdaptiveDictionaryLayout;
+    writeInt64(lengthBuffer, offset, static_cast<int64_t>(compressor->dictionaryScope()));
+    writeInt64(lengthBuffer, offset, newDictionaries.size());
+    for (auto* dictionary : newDictionaries) {
+      auto& bytes = dictionary->bytes();
+      writeInt64(lengthBuffer, offset, dictionary->id());
+      writeInt64(lengthBuffer, offset, bytes.size());
+      memcpy(valueBuffer->mutable_data() + compressValueOffset, bytes.data(), bytes.size());
+      compressValueOffset += bytes.size();
+    }
+  }
+  memcpy(headerBuffer->mutable_data() + sizeof(uint32_t) + sizeof(int32_t), &layout, sizeof(int32_t));
+  GLUTEN_THROW_NOT_OK(lengthBuffer->Resize(offset, /*shrink*/ true));
+  GLUTEN_THROW_NOT_OK(valueBuffer->Resize(compressValueOffset, /*shrink*/ true));
+  arrays.emplace_back(makeBinaryArray(compressWriteSchema->field(0)->type(), headerBuffer, pool));
+  arrays.emplace_back(makeBinaryArray(compressWriteSchema->field(1)->type(), lengthBuffer, pool));
+  arrays.emplace_back(makeBinaryArray(compressWriteSchema->field(2)->type(), valueBuffer, pool));
+  return arrow::RecordBatch::Make(compressWriteSchema, 1, {arrays});
+}
+
 // generate the new big one row several columns binary recordbatch
 std::shared_ptr<arrow::RecordBatch> makeUncompressedRecordBatch(
     uint32_t numRows,
@@ -264,6 +523,28 @@ std::shared_ptr<arrow::RecordBatch> makeUncompressedRecordBatch(
   }
   return arrow::RecordBatch::Make(writeSchema, 1, {arrays});
 }
+
+// The batch with its header extended to kChecksumHeaderSize, carrying the CRC32C of the buffers of the other columns.
+std::shared_ptr<arrow::RecordBatch> addBlockChecksum(const arrow::RecordBatch& rb, ShuffleBufferPool* pool) {
+  auto columnBuffer = [&rb](int32_t i) {
+    return std::static_pointer_cast<arrow::LargeStringArray>(rb.column(i))->value_data();
+  };
+  auto checksum = kBlockChecksumSeed;
+  for (int32_t i = 1; i < rb.num_columns(); ++i) {
+    checksum = extendBlockChecksum(checksum, columnBuffer(i).get());
+  }
+  auto header = columnBuffer(0);
+  std::shared_ptr<arrow::ResizableBuffer> headerBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(headerBuffer, kChecksumHeaderSize));
+  // Uncompressed and legacy compressed batches have no layout, theirs is 0.
+  memset(headerBuffer->mutable_data(), 0, kChecksumHeaderSize);
+  memcpy(headerBuffer->mutable_data(), header->data(), header->size());
+  memcpy(headerBuffer->mutable_data() + kChecksumHeaderSize - sizeof(uint32_t), &checksum, sizeof(uint32_t));
+  GLUTEN_ASSIGN_OR_THROW(
+      auto withChecksum,
+      rb.SetColumn(0, rb.schema()->field(0), makeBinaryArray(rb.schema()->field(0)->type(), headerBuffer, pool)));
+  return withChecksum;
+}
 } // namespace
 
 // VeloxShuffleWriter
@@ -277,12 +558,13 @@ arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxShuffleWriter::create(
   return res;
 }
 
+VeloxShuffleWriter::~VeloxShuffleWriter() {
+  // The vectors are still buffered if the task failed.
+  chargeSortBufferedBytes(-sortBufferedBytes_);
+}
+
 arrow::Status VeloxShuffleWriter::init() {
-#if defined(__x86_64__)
-  supportAvx512_ = __builtin_cpu_supports("avx512bw");
-#else
-  supportAvx512_ = false;
-#endif
+  splitKernelIsa_ = detectSplitKernelIsa();
 
   // partition number should be less than 64k
   VELOX_CHECK_LE(numPartitions_, 64 * 1024);
@@ -293,18 +575,44 @@ arrow::Status VeloxShuffleWriter::init() {
   ARROW_ASSIGN_OR_RAISE(partitionWriter_, partitionWriterCreator_->make(this));
 
   ARROW_ASSIGN_OR_RAISE(partitioner_, Partitioner::make(options_.partitioning_name, numPartitions_));
+  if (!options_.hash_partition_key_ids.empty() && options_.partitioning_name != "hash") {
+    return arrow::Status::Invalid("Hash partition keys are only supported by hash partitioning.");
+  }
+  if (options_.round_robin_clustering && options_.partitioning_name != "rr") {
+    return arrow::Status::Invalid("Clustering is only supported by round robin partitioning.");
+  }
+  if (options_.range_bounds != nullptr) {
+    if (options_.partitioning_name != "range") {
+      return arrow::Status::Invalid("Range bounds are only supported by range partitioning.");
+    }
+    auto bounds = VeloxColumnarBatch::from(veloxPool_.get(), options_.range_bounds);
+    ARROW_ASSIGN_OR_RAISE(
+        rangePartitionBounds_,
+        RangePartitionBounds::make(*bounds->getFlattenedRowVector(), options_.range_partition_keys));
+    if (rangePartitionBounds_->numBounds() >= numPartitions_) {
+      return arrow::Status::Invalid("Too many range bounds for ", numPartitions_, " partitions.");
+    }
+  }
 
   // pre-allocated buffer size for each partition, unit is row count
   // when partitioner is SinglePart, partial variables don`t need init
   if (options_.partitioning_name != "single") {
     partition2RowCount_.resize(numPartitions_);
     partition2BufferSize_.resize(numPartitions_);
-    partitionBufferIdxOffset_.resize(numPartitions_);
     partition2RowOffset_.resize(numPartitions_ + 1);
   }
 
   partitionBufferIdxBase_.resize(numPartitions_);
 
+  if (isSortBased()) {
+    sortBufferedPartition2RowCount_.resize(numPartitions_, 0);
+    if (auto arrowPool = std::dynamic_pointer_cast<ArrowMemoryPool>(options_.memory_pool)) {
+      if (auto allocator = dynamic_cast<ListenableMemoryAllocator*>(arrowPool->allocator())) {
+        sortBufferedBytesListener_ = allocator->listener();
+      }
+    }
+  }
+
   partitionCachedRecordbatch_.resize(numPartitions_);
   partitionCachedRecordbatchSize_.resize(numPartitions_);
 
@@ -312,6 +620,15 @@ arrow::Status VeloxShuffleWriter::init() {
   rawPartitionLengths_.resize(numPartitions_);
 
   options_.codec = createArrowIpcCodec(options_.compression_type, options_.codec_backend);
+  if (options_.adaptive_compression && options_.codec != nullptr) {
+    if (options_.compression_type != arrow::Compression::LZ4_FRAME &&
+        options_.compression_type != arrow::Compression::ZSTD) {
+      return arrow::Status::Invalid("Adaptive shuffle compression only supports lz4 and zstd.");
+    }
+    adaptiveCompressor_ = std::make_unique<AdaptiveBufferCompressor>(
+        options_.codec.get(), options_.zstd_dictionary_training_buffers);
+    partitionDictionaryIds_.resize(numPartitions_);
+  }
 
   RETURN_NOT_OK(pool_->init());
   RETURN_NOT_OK(initIpcWriteOptions());
@@ -325,7 +642,10 @@ arrow::Status VeloxShuffleWriter::initIpcWriteOptions() {
     ipcWriteOptions.memory_pool = options_.memory_pool.get();
   } else {
     if (!options_.ipc_memory_pool) {
-      auto ipcMemoryPool = std::make_shared<LargeMemoryPool>(options_.memory_pool.get());
+      LargeMemoryPoolOptions poolOptions;
+      poolOptions.transparent_huge_pages = options_.ipc_huge_pages;
+      poolOptions.bind_to_local_node = options_.ipc_numa_bind;
+      auto ipcMemoryPool = std::make_shared<LargeMemoryPool>(options_.memory_pool.get(), poolOptions);
       options_.ipc_memory_pool = std::move(ipcMemoryPool);
     }
     ipcWriteOptions.memory_pool = options_.ipc_memory_pool.get();
@@ -359,6 +679,9 @@ arrow::Status VeloxShuffleWriter::initPartitions() {
     v.resize(numPartitions_);
   });
 
+  partitionBinaryWidths_.assign(binaryColumnIndices_.size(), std::vector<float>(numPartitions_, 0));
+  partitionRowRates_.assign(numPartitions_, 0);
+
   return arrow::Status::OK();
 }
 
@@ -432,16 +755,199 @@ void collectFlatVectorBuffer<velox::TypeKind::VARBINARY>(
   collectFlatVectorBufferStringView(vector, buffers, pool);
 }
 
+// The rows of the buffered vectors of the sort based shuffle writer are referenced as
+// |batch index (32 bits)|row index (32 bits)|.
+std::shared_ptr<arrow::Buffer> gatherBits(
+    const std::vector<const uint64_t*>& sources,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    ShuffleBufferPool* pool) {
+  std::shared_ptr<arrow::ResizableBuffer> buffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(buffer, velox::bits::nbytes(numRows)));
+  auto raw = buffer->mutable_data();
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    auto source = sources[rowRefs[i] >> 32];
+    velox::bits::setBit(raw, i, source == nullptr || velox::bits::isBitSet(source, rowRefs[i] & 0xffffffff));
+  }
+  return buffer;
+}
+
+std::shared_ptr<arrow::Buffer> gatherNulls(
+    const std::vector<RowVectorPtr>& vectors,
+    column_index_t column,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    ShuffleBufferPool* pool) {
+  std::vector<const uint64_t*> nulls;
+  nulls.reserve(vectors.size());
+  bool mayHaveNulls = false;
+  for (const auto& vector : vectors) {
+    nulls.push_back(vector->childAt(column)->rawNulls());
+    mayHaveNulls |= nulls.back() != nullptr;
+  }
+  return mayHaveNulls ? gatherBits(nulls, rowRefs, numRows, pool) : nullptr;
+}
+
+template <velox::TypeKind kind>
+void gatherFlatVectorBuffer(
+    const std::vector<RowVectorPtr>& vectors,
+    column_index_t column,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    ShuffleBufferPool* pool) {
+  using T = typename velox::TypeTraits<kind>::NativeType;
+  buffers.emplace_back(gatherNulls(vectors, column, rowRefs, numRows, pool));
+  std::vector<const T*> values;
+  values.reserve(vectors.size());
+  for (const auto& vector : vectors) {
+    values.push_back(vector->childAt(column)->asUnchecked<FlatVector<T>>()->rawValues());
+  }
+  std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(valueBuffer, sizeof(T) * numRows));
+  auto raw = reinterpret_cast<T*>(valueBuffer->mutable_data());
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    raw[i] = values[rowRefs[i] >> 32][rowRefs[i] & 0xffffffff];
+  }
+  buffers.emplace_back(valueBuffer);
+}
+
+template <>
+void gatherFlatVectorBuffer<velox::TypeKind::BOOLEAN>(
+    const std::vector<RowVectorPtr>& vectors,
+    column_index_t column,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    ShuffleBufferPool* pool) {
+  buffers.emplace_back(gatherNulls(vectors, column, rowRefs, numRows, pool));
+  std::vector<const uint64_t*> values;
+  values.reserve(vectors.size());
+  for (const auto& vector : vectors) {
+    values.push_back(vector->childAt(column)->values()->as<uint64_t>());
+  }
+  buffers.emplace_back(gatherBits(values, rowRefs, numRows, pool));
+}
+
+void gatherFlatVectorBufferStringView(
+    const std::vector<RowVectorPtr>& vectors,
+    column_index_t column,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    ShuffleBufferPool* pool) {
+  buffers.emplace_back(gatherNulls(vectors, column, rowRefs, numRows, pool));
+  std::vector<const StringView*> values;
+  values.reserve(vectors.size());
+  for (const auto& vector : vectors) {
+    values.push_back(vector->childAt(column)->asUnchecked<FlatVector<StringView>>()->rawValues());
+  }
+  std::shared_ptr<arrow::ResizableBuffer> offsetBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(offsetBuffer, sizeof(int32_t) * (numRows + 1)));
+  auto rawOffset = reinterpret_cast<int32_t*>(offsetBuffer->mutable_data());
+  rawOffset[0] = 0;
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    rawOffset[i + 1] = rawOffset[i] + values[rowRefs[i] >> 32][rowRefs[i] & 0xffffffff].size();
+  }
+  buffers.emplace_back(offsetBuffer);
+  std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
+  GLUTEN_THROW_NOT_OK(pool->allocateDirectly(valueBuffer, rawOffset[numRows]));
+  auto raw = reinterpret_cast<char*>(valueBuffer->mutable_data());
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    const auto& value = values[rowRefs[i] >> 32][rowRefs[i] & 0xffffffff];
+    memcpy(raw + rawOffset[i], value.data(), value.size());
+  }
+  buffers.emplace_back(valueBuffer);
+}
+
+template <>
+void gatherFlatVectorBuffer<velox::TypeKind::VARCHAR>(
+    const std::vector<RowVectorPtr>& vectors,
+    column_index_t column,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    ShuffleBufferPool* pool) {
+  gatherFlatVectorBufferStringView(vectors, column, rowRefs, numRows, buffers, pool);
+}
+
+template <>
+void gatherFlatVectorBuffer<velox::TypeKind::VARBINARY>(
+    const std::vector<RowVectorPtr>& vectors,
+    column_index_t column,
+    const uint64_t* rowRefs,
+    vector_size_t numRows,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    ShuffleBufferPool* pool) {
+  gatherFlatVectorBufferStringView(vectors, column, rowRefs, numRows, buffers, pool);
+}
+
 } // namespace
 
+std::vector<std::pair<std::string, int64_t>> VeloxShuffleWriter::splitPhaseTimes() const {
+  static const std::array<std::string, kNumSplitPhases> kNames = {
+      "computePidTime",
+      "createPartition2RowTime",
+      "splitFixedWidthTime",
+      "splitValidityTime",
+      "splitBinaryTime",
+      "splitComplexTime",
+      "allocateBuffersTime",
+      "createPayloadTime"};
+  std::vector<std::pair<std::string, int64_t>> times;
+  times.reserve(kNumSplitPhases);
+  for (int32_t phase = 0; phase < kNumSplitPhases; ++phase) {
+    times.emplace_back(kNames[phase], splitPhaseNanos_[phase].load(std::memory_order_relaxed));
+  }
+  return times;
+}
+
 std::shared_ptr<arrow::Buffer> VeloxShuffleWriter::generateComplexTypeBuffers(velox::RowVectorPtr vector) {
+  PhaseTimer timer(splitPhaseNanos_[kSplitComplex]);
+  return serializeComplexType(vector, complexTypeFlushBuffer_[0]);
+}
+
+std::shared_ptr<arrow::Buffer> VeloxShuffleWriter::serializeComplexType(
+    const velox::RowVectorPtr& vector,
+    std::shared_ptr<arrow::ResizableBuffer>& flushBuffer) {
   auto arena = std::make_unique<StreamArena>(veloxPool_.get());
   auto serializer =
       serde_->createSerializer(asRowType(vector->type()), vector->size(), arena.get(), /* serdeOptions */ nullptr);
   const IndexRange allRows{0, vector->size()};
   serializer->append(vector, folly::Range(&allRows, 1));
-  auto serializedSize = serializer->maxSerializedSize();
-  auto flushBuffer = complexTypeFlushBuffer_[0];
+  return flushComplexType(*serializer, flushBuffer);
+}
+
+std::shared_ptr<arrow::Buffer> VeloxShuffleWriter::serializeComplexRows(
+    const std::vector<velox::RowVectorPtr>& complexVectors,
+    const uint64_t* rowRefs,
+    vector_size_t numRows) {
+  PhaseTimer timer(splitPhaseNanos_[kSplitComplex]);
+  auto arena = std::make_unique<StreamArena>(veloxPool_.get());
+  auto serializer = serde_->createSerializer(complexWriteType_, numRows, arena.get(), /* serdeOptions */ nullptr);
+  // The rows of a partition are in the order of the buffered vectors, appended by the ranges of each vector.
+  std::vector<IndexRange> ranges;
+  vector_size_t i = 0;
+  while (i < numRows) {
+    auto batchIdx = rowRefs[i] >> 32;
+    ranges.clear();
+    for (; i < numRows && rowRefs[i] >> 32 == batchIdx; ++i) {
+      auto rowIdx = static_cast<vector_size_t>(rowRefs[i] & 0xffffffff);
+      if (!ranges.empty() && ranges.back().begin + ranges.back().size == rowIdx) {
+        ranges.back().size++;
+      } else {
+        ranges.push_back({rowIdx, 1});
+      }
+    }
+    serializer->append(complexVectors[batchIdx], folly::Range(ranges.data(), ranges.size()));
+  }
+  return flushComplexType(*serializer, complexTypeFlushBuffer_[0]);
+}
+
+std::shared_ptr<arrow::Buffer> VeloxShuffleWriter::flushComplexType(
+    VectorSerializer& serializer,
+    std::shared_ptr<arrow::ResizableBuffer>& flushBuffer) {
+  auto serializedSize = serializer.maxSerializedSize();
   if (flushBuffer == nullptr) {
     GLUTEN_ASSIGN_OR_THROW(flushBuffer, arrow::AllocateResizableBuffer(serializedSize, options_.memory_pool.get()));
   } else if (serializedSize > flushBuffer->capacity()) {
@@ -452,7 +958,7 @@ std::shared_ptr<arrow::Buffer> VeloxShuffleWriter::generateComplexTypeBuffers(ve
   auto output = std::make_shared<arrow::io::FixedSizeBufferWriter>(valueBuffer);
   serializer::presto::PrestoOutputStreamListener listener;
   ArrowFixedSizeBufferOutputStream out(output, &listener);
-  serializer->flush(&out);
+  serializer.flush(&out);
   return valueBuffer;
 }
 
@@ -462,57 +968,274 @@ arrow::Status VeloxShuffleWriter::split(std::shared_ptr<ColumnarBatch> cb) {
     VELOX_DCHECK_NOT_NULL(veloxColumnBatch);
     auto& rv = *veloxColumnBatch->getFlattenedRowVector();
     RETURN_NOT_OK(initFromRowVector(rv));
-    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
-    std::vector<VectorPtr> complexChildren;
-    for (auto& child : rv.children()) {
-      if (child->encoding() == VectorEncoding::Simple::FLAT) {
-        VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
-            collectFlatVectorBuffer, child->typeKind(), child.get(), buffers, pool_.get());
-      } else {
-        complexChildren.emplace_back(child);
-      }
-    }
-    if (complexChildren.size() > 0) {
-      auto rowVector = std::make_shared<RowVector>(
-          veloxPool_.get(), complexWriteType_, BufferPtr(nullptr), rv.size(), std::move(complexChildren));
-      buffers.emplace_back(generateComplexTypeBuffers(rowVector));
+    RETURN_NOT_OK(cacheRowVector(0, rv));
+  } else if (rangePartitionBounds_ != nullptr) {
+    auto veloxColumnBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
+    VELOX_DCHECK_NOT_NULL(veloxColumnBatch);
+    auto rv = veloxColumnBatch->getFlattenedRowVector();
+    {
+      PhaseTimer timer(splitPhaseNanos_[kComputePid]);
+      RETURN_NOT_OK(rangePartitionBounds_->compute(*rv, rangePartitionIds_));
+      RETURN_NOT_OK(partitioner_->compute(rangePartitionIds_.data(), rv->size(), row2Partition_, partition2RowCount_));
     }
-
-    auto rb = makeRecordBatch(rv.size(), buffers);
-    RETURN_NOT_OK(cacheRecordBatch(0, *rb, false));
+    RETURN_NOT_OK(initFromRowVector(*rv));
+    updateColumnEncodings(*veloxColumnBatch->getRowVector(), 0);
+    RETURN_NOT_OK(splitOrBuffer(rv));
   } else if (options_.partitioning_name == "range") {
-    auto compositeBatch = std::dynamic_pointer_cast<CompositeColumnarBatch>(cb);
-    VELOX_DCHECK_NOT_NULL(compositeBatch);
-    auto batches = compositeBatch->getBatches();
-    VELOX_DCHECK_EQ(batches.size(), 2);
-    auto pidBatch = VeloxColumnarBatch::from(defaultLeafVeloxMemoryPool().get(), batches[0]);
-    auto pidArr = getFirstColumn(*(pidBatch->getRowVector()));
-    RETURN_NOT_OK(partitioner_->compute(pidArr, pidBatch->numRows(), row2Partition_, partition2RowCount_));
-    auto rvBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(batches[1]);
-    auto& rv = *rvBatch->getFlattenedRowVector();
-    RETURN_NOT_OK(initFromRowVector(rv));
-    RETURN_NOT_OK(doSplit(rv));
+    // The pid column composed in front of the data columns, either as a composite batch or natively.
+    auto composedBatch = VeloxColumnarBatch::from(defaultLeafVeloxMemoryPool().get(), cb);
+    auto pidArr = getFirstColumn(*(composedBatch->getRowVector()));
+    {
+      PhaseTimer timer(splitPhaseNanos_[kComputePid]);
+      RETURN_NOT_OK(partitioner_->compute(pidArr, composedBatch->numRows(), row2Partition_, partition2RowCount_));
+    }
+    std::vector<int32_t> dataColumns(composedBatch->numColumns() - 1);
+    std::iota(dataColumns.begin(), dataColumns.end(), 1);
+    auto rvBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(composedBatch->select(dataColumns));
+    auto rv = rvBatch->getFlattenedRowVector();
+    RETURN_NOT_OK(initFromRowVector(*rv));
+    updateColumnEncodings(*rvBatch->getRowVector(), 0);
+    RETURN_NOT_OK(splitOrBuffer(rv));
   } else {
     auto veloxColumnBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
     VELOX_DCHECK_NOT_NULL(veloxColumnBatch);
-    auto& rv = *veloxColumnBatch->getFlattenedRowVector();
+    if (!options_.hash_partition_key_ids.empty()) {
+      // Hash the keys before flattening, so that dictionary encoded keys are hashed once per distinct value.
+      {
+        PhaseTimer timer(splitPhaseNanos_[kComputePid]);
+        RETURN_NOT_OK(computeSparkMurmur3Hash(
+            *veloxColumnBatch->getRowVector(), options_.hash_partition_key_ids, partitionKeyHashes_));
+      }
+      auto rv = veloxColumnBatch->getFlattenedRowVector();
+      {
+        PhaseTimer timer(splitPhaseNanos_[kComputePid]);
+        RETURN_NOT_OK(
+            partitioner_->compute(partitionKeyHashes_.data(), rv->size(), row2Partition_, partition2RowCount_));
+      }
+      RETURN_NOT_OK(initFromRowVector(*rv));
+      updateColumnEncodings(*veloxColumnBatch->getRowVector(), 0);
+      RETURN_NOT_OK(splitOrBuffer(rv));
+      return arrow::Status::OK();
+    }
+    auto rv = veloxColumnBatch->getFlattenedRowVector();
     if (partitioner_->hasPid()) {
-      auto pidArr = getFirstColumn(rv);
-      RETURN_NOT_OK(partitioner_->compute(pidArr, rv.size(), row2Partition_, partition2RowCount_));
-      auto strippedRv = getStrippedRowVector(rv);
+      auto pidArr = getFirstColumn(*rv);
+      {
+        PhaseTimer timer(splitPhaseNanos_[kComputePid]);
+        RETURN_NOT_OK(partitioner_->compute(pidArr, rv->size(), row2Partition_, partition2RowCount_));
+      }
+      auto strippedRv = getStrippedRowVector(*rv);
       RETURN_NOT_OK(initFromRowVector(*strippedRv));
-      RETURN_NOT_OK(doSplit(*strippedRv));
+      updateColumnEncodings(*veloxColumnBatch->getRowVector(), 1);
+      RETURN_NOT_OK(splitOrBuffer(strippedRv));
+    } else {
+      RETURN_NOT_OK(initFromRowVector(*rv));
+      updateColumnEncodings(*veloxColumnBatch->getRowVector(), 0);
+      {
+        PhaseTimer timer(splitPhaseNanos_[kComputePid]);
+        const int32_t* ranks = nullptr;
+        if (options_.round_robin_clustering) {
+          ARROW_ASSIGN_OR_RAISE(auto clustered, computeClusterRanks(*veloxColumnBatch->getRowVector()));
+          ranks = clustered ? clusterRanks_.data() : nullptr;
+        }
+        RETURN_NOT_OK(partitioner_->compute(ranks, rv->size(), row2Partition_, partition2RowCount_));
+      }
+      RETURN_NOT_OK(splitOrBuffer(rv));
+    }
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Result<bool> VeloxShuffleWriter::computeClusterRanks(const velox::RowVector& rv) {
+  size_t numHashed = 0;
+  for (int32_t i = 0; i < rv.childrenSize(); ++i) {
+    if (numHashed == clusterHashes_.size()) {
+      clusterHashes_.emplace_back();
+    }
+    // Columns of types murmur3 doesn't hash, the complex ones, don't take part in the order.
+    if (computeSparkMurmur3Hash(rv, {i}, clusterHashes_[numHashed]).ok()) {
+      ++numHashed;
+    }
+  }
+  if (numHashed == 0) {
+    return false;
+  }
+  clusterHashes_.resize(numHashed);
+  // Equal values of the first column end up adjacent, ties are ordered by the next columns, then by row.
+  clusterOrder_.resize(rv.size());
+  std::iota(clusterOrder_.begin(), clusterOrder_.end(), 0);
+  std::sort(clusterOrder_.begin(), clusterOrder_.end(), [this](int32_t a, int32_t b) {
+    for (const auto& hashes : clusterHashes_) {
+      if (hashes[a] != hashes[b]) {
+        return hashes[a] < hashes[b];
+      }
+    }
+    return a < b;
+  });
+  clusterRanks_.resize(rv.size());
+  for (auto rank = 0; rank < rv.size(); ++rank) {
+    clusterRanks_[clusterOrder_[rank]] = rank;
+  }
+  return true;
+}
+
+arrow::Status VeloxShuffleWriter::splitOrBuffer(velox::RowVectorPtr rv) {
+  if (isSortBased()) {
+    return bufferRowVector(std::move(rv));
+  }
+  return doSplit(*rv);
+}
+
+arrow::Status VeloxShuffleWriter::cacheRowVector(uint32_t partitionId, const velox::RowVector& rv) {
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  std::vector<VectorPtr> complexChildren;
+  for (auto& child : rv.children()) {
+    if (child->encoding() == VectorEncoding::Simple::FLAT) {
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          collectFlatVectorBuffer, child->typeKind(), child.get(), buffers, pool_.get());
+    } else {
+      complexChildren.emplace_back(child);
+    }
+  }
+  if (complexChildren.size() > 0) {
+    auto rowVector = std::make_shared<RowVector>(
+        veloxPool_.get(), complexWriteType_, BufferPtr(nullptr), rv.size(), std::move(complexChildren));
+    buffers.emplace_back(generateComplexTypeBuffers(rowVector));
+  }
+
+  std::shared_ptr<arrow::RecordBatch> rb;
+  {
+    PhaseTimer timer(splitPhaseNanos_[kCreatePayload]);
+    rb = makeRecordBatch(partitionId, rv.size(), buffers);
+  }
+  RETURN_NOT_OK(cacheRecordBatch(partitionId, *rb, false));
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxShuffleWriter::bufferRowVector(velox::RowVectorPtr rv) {
+  // the output RowVector of one partition can't exceed vector_size_t
+  if (sortBufferedRow2Partition_.size() + rv->size() > std::numeric_limits<vector_size_t>::max()) {
+    RETURN_NOT_OK(sortAndCacheBufferedRows());
+  }
+
+  // Charged before rv is buffered, as the charge may evict the vectors buffered so far.
+  auto bytes = static_cast<int64_t>(rv->retainedSize());
+  chargeSortBufferedBytes(bytes);
+  sortBufferedRow2Partition_.insert(sortBufferedRow2Partition_.end(), row2Partition_.begin(), row2Partition_.end());
+  for (auto pid = 0; pid < numPartitions_; ++pid) {
+    sortBufferedPartition2RowCount_[pid] += partition2RowCount_[pid];
+  }
+  sortBufferedBytes_ += bytes;
+  sortBufferedVectors_.emplace_back(std::move(rv));
+
+  if (sortBufferedBytes_ >= options_.sort_buffer_threshold) {
+    RETURN_NOT_OK(sortAndCacheBufferedRows());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxShuffleWriter::sortAndCacheBufferedRows() {
+  if (sorting_ || sortBufferedVectors_.empty()) {
+    return arrow::Status::OK();
+  }
+  sorting_ = true;
+
+  // Counting sort by partition id. Row references keep the input order within one partition.
+  // Row reference layout: |batch index (32 bits)|row index (32 bits)|
+  std::vector<uint64_t> partition2Offset(numPartitions_ + 1, 0);
+  for (auto pid = 0; pid < numPartitions_; ++pid) {
+    partition2Offset[pid + 1] = partition2Offset[pid] + sortBufferedPartition2RowCount_[pid];
+  }
+  std::vector<uint64_t> sortedRowRefs(sortBufferedRow2Partition_.size());
+  {
+    std::vector<uint64_t> offsets(partition2Offset.begin(), std::prev(partition2Offset.end()));
+    uint64_t row = 0;
+    for (uint64_t batchIdx = 0; batchIdx < sortBufferedVectors_.size(); ++batchIdx) {
+      auto numRows = sortBufferedVectors_[batchIdx]->size();
+      for (uint64_t rowIdx = 0; rowIdx < numRows; ++rowIdx, ++row) {
+        auto pid = sortBufferedRow2Partition_[row];
+        sortedRowRefs[offsets[pid]++] = (batchIdx << 32) | rowIdx;
+      }
+    }
+  }
+  // release the row -> partition mapping before gathering the partitions
+  std::vector<uint16_t>().swap(sortBufferedRow2Partition_);
+
+  // The flat columns are gathered into the buffers of the partitions, and the complex ones serialized, as
+  // cacheRowVector lays them out.
+  const auto& firstVector = sortBufferedVectors_[0];
+  std::vector<column_index_t> flatColumns;
+  std::vector<column_index_t> complexColumns;
+  for (column_index_t col = 0; col < firstVector->childrenSize(); ++col) {
+    if (firstVector->childAt(col)->encoding() == VectorEncoding::Simple::FLAT) {
+      flatColumns.push_back(col);
     } else {
-      RETURN_NOT_OK(initFromRowVector(rv));
-      RETURN_NOT_OK(partitioner_->compute(nullptr, rv.size(), row2Partition_, partition2RowCount_));
-      RETURN_NOT_OK(doSplit(rv));
+      complexColumns.push_back(col);
     }
   }
+  std::vector<RowVectorPtr> complexVectors;
+  if (!complexColumns.empty()) {
+    for (const auto& vector : sortBufferedVectors_) {
+      std::vector<VectorPtr> children;
+      for (auto col : complexColumns) {
+        children.emplace_back(vector->childAt(col));
+      }
+      complexVectors.emplace_back(std::make_shared<RowVector>(
+          veloxPool_.get(), complexWriteType_, BufferPtr(nullptr), vector->size(), std::move(children)));
+    }
+  }
+
+  for (auto pid = 0; pid < numPartitions_; ++pid) {
+    auto begin = partition2Offset[pid];
+    auto end = partition2Offset[pid + 1];
+    if (begin == end) {
+      continue;
+    }
+    auto numRows = static_cast<vector_size_t>(end - begin);
+    const auto* rowRefs = sortedRowRefs.data() + begin;
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+    for (auto col : flatColumns) {
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          gatherFlatVectorBuffer,
+          firstVector->childAt(col)->typeKind(),
+          sortBufferedVectors_,
+          col,
+          rowRefs,
+          numRows,
+          buffers,
+          pool_.get());
+    }
+    if (!complexVectors.empty()) {
+      buffers.emplace_back(serializeComplexRows(complexVectors, rowRefs, numRows));
+    }
+    std::shared_ptr<arrow::RecordBatch> rb;
+    {
+      PhaseTimer timer(splitPhaseNanos_[kCreatePayload]);
+      rb = makeRecordBatch(pid, numRows, buffers);
+    }
+    RETURN_NOT_OK(cacheRecordBatch(pid, *rb, false));
+  }
+
+  complexVectors.clear();
+  sortBufferedVectors_.clear();
+  std::fill(sortBufferedPartition2RowCount_.begin(), sortBufferedPartition2RowCount_.end(), 0);
+  chargeSortBufferedBytes(-sortBufferedBytes_);
+  sortBufferedBytes_ = 0;
+  sorting_ = false;
   return arrow::Status::OK();
 }
 
+void VeloxShuffleWriter::chargeSortBufferedBytes(int64_t diff) {
+  if (sortBufferedBytesListener_ != nullptr && diff != 0) {
+    sortBufferedBytesListener_->allocationChanged(diff);
+  }
+}
+
 arrow::Status VeloxShuffleWriter::stop() {
   EVAL_START("write", options_.thread_id)
+  if (isSortBased()) {
+    RETURN_NOT_OK(sortAndCacheBufferedRows());
+  }
   RETURN_NOT_OK(partitionWriter_->stop());
   if (options_.ipc_memory_pool != options_.memory_pool) {
     options_.ipc_memory_pool.reset();
@@ -523,6 +1246,7 @@ arrow::Status VeloxShuffleWriter::stop() {
 }
 
 arrow::Status VeloxShuffleWriter::createPartition2Row(uint32_t rowNum) {
+  PhaseTimer timer(splitPhaseNanos_[kCreatePartition2Row]);
   // calc partition2RowOffset_
   partition2RowOffset_[0] = 0;
   for (auto pid = 1; pid <= numPartitions_; ++pid) {
@@ -572,21 +1296,24 @@ arrow::Status VeloxShuffleWriter::doSplit(const velox::RowVector& rv) {
 
   RETURN_NOT_OK(updateInputHasNull(rv));
 
+  updatePartitionRowRates(rowNum);
+
   for (auto pid = 0; pid < numPartitions_; ++pid) {
     if (partition2RowCount_[pid] > 0) {
       // make sure the size to be allocated is larger than the size to be filled
       // partitionBufferManager[pid]->prepareNextSplit();
       if (partition2BufferSize_[pid] == 0) {
         // allocate buffer if it's not yet allocated
-        auto newSize = std::max(calculatePartitionBufferSize(rv), partition2RowCount_[pid]);
+        auto newSize = std::max(calculatePartitionBufferSize(rv, pid), partition2RowCount_[pid]);
         RETURN_NOT_OK(allocatePartitionBuffersWithRetry(pid, newSize));
       } else if (partitionBufferIdxBase_[pid] + partition2RowCount_[pid] > partition2BufferSize_[pid]) {
-        auto newSize = std::max(calculatePartitionBufferSize(rv), partition2RowCount_[pid]);
+        auto newSize = std::max(calculatePartitionBufferSize(rv, pid), partition2RowCount_[pid]);
         // if the size to be filled + allready filled > the buffer size, need to free current buffers and allocate new
         // buffer
-        if (newSize > partition2BufferSize_[pid]) {
-          // if the partition size after split is already larger than
-          // allocated buffer size, need reallocate
+        auto shrink = newSize * kPartitionBufferShrinkRatio <= partition2BufferSize_[pid];
+        if (newSize > partition2BufferSize_[pid] || shrink) {
+          // if the partition size after split is already larger than allocated buffer size, or the partition cooled
+          // down to a much smaller size, need reallocate
           {
             bool reuseBuffers = false;
             ARROW_ASSIGN_OR_RAISE(auto rb, createArrowRecordBatchFromBuffer(pid, /*resetBuffers = */ !reuseBuffers));
@@ -636,15 +1363,87 @@ arrow::Status VeloxShuffleWriter::doSplit(const velox::RowVector& rv) {
 
 arrow::Status VeloxShuffleWriter::splitRowVector(const velox::RowVector& rv) {
   // now start to split the RowVector
-  RETURN_NOT_OK(splitFixedWidthValueBuffer(rv));
-  RETURN_NOT_OK(splitValidityBuffer(rv));
-  RETURN_NOT_OK(splitBinaryArray(rv));
+  RETURN_NOT_OK(allocateValidityBuffers(rv));
+  if (shouldSplitInParallel(rv)) {
+    RETURN_NOT_OK(splitSimpleColumnsParallel(rv));
+  } else {
+    RETURN_NOT_OK(splitSimpleColumns(rv, 0, simpleColumnIndices_.size()));
+  }
   RETURN_NOT_OK(splitComplexType(rv));
   return arrow::Status::OK();
 }
 
-arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVector& rv) {
-  for (auto col = 0; col < fixedWidthColumnCount_; ++col) {
+arrow::Status VeloxShuffleWriter::splitSimpleColumns(const velox::RowVector& rv, uint32_t begin, uint32_t end) {
+  {
+    PhaseTimer timer(splitPhaseNanos_[kSplitFixedWidth]);
+    RETURN_NOT_OK(splitFixedWidthValueBuffer(rv, begin, end));
+  }
+  {
+    PhaseTimer timer(splitPhaseNanos_[kSplitValidity]);
+    RETURN_NOT_OK(splitValidityBuffer(rv, begin, end));
+  }
+  PhaseTimer timer(splitPhaseNanos_[kSplitBinary]);
+  return splitBinaryArray(rv, begin, end);
+}
+
+bool VeloxShuffleWriter::shouldSplitInParallel(const velox::RowVector& rv) const {
+  return options_.split_executor != nullptr && options_.num_split_threads > 0 &&
+      simpleColumnIndices_.size() > 1 && rv.size() >= options_.parallel_split_threshold;
+}
+
+arrow::Status VeloxShuffleWriter::reserveBinaryValueBuffers(const velox::RowVector& rv) {
+  PhaseTimer timer(splitPhaseNanos_[kAllocateBuffers]);
+  for (auto col = fixedWidthColumnCount_; col < simpleColumnIndices_.size(); ++col) {
+    auto binaryIdx = col - fixedWidthColumnCount_;
+    auto rawValues = rv.childAt(simpleColumnIndices_[col])->asFlatVector<velox::StringView>()->rawValues();
+    for (auto pid = 0; pid < numPartitions_; ++pid) {
+      uint64_t bytes = 0;
+      for (auto x = partition2RowOffset_[pid]; x < partition2RowOffset_[pid + 1]; ++x) {
+        bytes += rawValues[rowOffset2RowId_[x]].size();
+      }
+      auto& binaryBuf = partitionBinaryAddrs_[binaryIdx][pid];
+      if (binaryBuf.valueOffset + bytes <= binaryBuf.valueCapacity) {
+        continue;
+      }
+      auto valueBuffer =
+          std::static_pointer_cast<arrow::ResizableBuffer>(partitionBuffers_[col][pid][kValueBufferIndex]);
+      RETURN_NOT_OK(valueBuffer->Reserve(binaryBuf.valueOffset + bytes));
+      binaryBuf.valuePtr = valueBuffer->mutable_data();
+      binaryBuf.valueCapacity = valueBuffer->capacity();
+    }
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxShuffleWriter::splitSimpleColumnsParallel(const velox::RowVector& rv) {
+  // Growing a buffer goes through the memory pool, which may spill this writer. Only do it on the task thread.
+  RETURN_NOT_OK(reserveBinaryValueBuffers(rv));
+
+  auto* executor = options_.split_executor;
+  uint32_t numColumns = simpleColumnIndices_.size();
+  uint32_t numGroups = std::min<uint32_t>(numColumns, options_.num_split_threads + 1);
+  uint32_t groupSize = (numColumns + numGroups - 1) / numGroups;
+
+  std::vector<folly::Future<arrow::Status>> futures;
+  futures.reserve(numGroups - 1);
+  for (uint32_t begin = groupSize; begin < numColumns; begin += groupSize) {
+    auto end = std::min(begin + groupSize, numColumns);
+    futures.emplace_back(
+        folly::via(executor, [this, &rv, begin, end]() { return splitSimpleColumns(rv, begin, end); }));
+  }
+  auto status = splitSimpleColumns(rv, 0, std::min(groupSize, numColumns));
+  // Wait for all groups before returning, they reference rv and the partition buffers.
+  for (auto& future : futures) {
+    auto groupStatus = std::move(future).get();
+    if (status.ok()) {
+      status = std::move(groupStatus);
+    }
+  }
+  return status;
+}
+
+arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVector& rv, uint32_t begin, uint32_t end) {
+  for (auto col = begin; col < std::min(end, fixedWidthColumnCount_); ++col) {
     auto colIdx = simpleColumnIndices_[col];
     auto column = rv.childAt(colIdx);
     assert(column->isFlatEncoding());
@@ -670,65 +1469,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
           RETURN_NOT_OK(splitFixedType<int128_t>(srcAddr, dstAddrs));
           break;
         } else {
-#ifdef PROCESSAVX
-          std::transform(
-              dstAddrs.begin(),
-              dstAddrs.end(),
-              partitionBufferIdxBase_.begin(),
-              partitionBufferIdxOffset_.begin(),
-              [](uint8_t* x, row_offset_type y) { return x + y * sizeof(uint64_t); });
-          for (auto pid = 0; pid < numPartitions_; pid++) {
-            auto dstPidBase = reinterpret_cast<uint64_t*>(partitionBufferIdxOffset_[pid]); /*32k*/
-            auto r = partition2RowOffset_[pid]; /*8k*/
-            auto size = partition2RowOffset_[pid + 1];
-#if 1
-            for (r; r < size && (((uint64_t)dstPidBase & 0x1f) > 0); r++) {
-              auto srcOffset = rowOffset2RowId_[r]; /*16k*/
-              *dstPidBase = reinterpret_cast<uint64_t*>(srcAddr)[srcOffset]; /*64k*/
-              _mm_prefetch(&(srcAddr)[srcOffset * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              dstPidBase += 1;
-            }
-#if 0
-          for (r; r+4<size; r+=4)                              
-          {                                                                                    
-            auto srcOffset = rowOffset2RowId_[r];                                 /*16k*/
-            __m128i srcLd = _mm_loadl_epi64((__m128i*)(&rowOffset2RowId_[r]));
-            __m128i srcOffset4x = _mm_cvtepu16_epi32(srcLd);
-            
-            __m256i src4x = _mm256_i32gather_epi64((const long long int*)srcAddr,srcOffset4x,8);
-            //_mm256_store_si256((__m256i*)dstPidBase,src4x);
-            _mm_stream_si128((__m128i*)dstPidBase,src2x);
-                                                         
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r+1]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r+2]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r+3]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            dstPidBase+=4;
-          }
-#endif
-            for (r; r + 2 < size; r += 2) {
-              __m128i srcOffset2x = _mm_cvtsi32_si128(*((int32_t*)(rowOffset2RowId_.data() + r)));
-              srcOffset2x = _mm_shufflelo_epi16(srcOffset2x, 0x98);
-
-              __m128i src2x = _mm_i32gather_epi64((const long long int*)srcAddr, srcOffset2x, 8);
-              _mm_store_si128((__m128i*)dstPidBase, src2x);
-              //_mm_stream_si128((__m128i*)dstPidBase,src2x);
-
-              _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r] * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r + 1] * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              dstPidBase += 2;
-            }
-#endif
-            for (r; r < size; r++) {
-              auto srcOffset = rowOffset2RowId_[r]; /*16k*/
-              *dstPidBase = reinterpret_cast<const uint64_t*>(srcAddr)[srcOffset]; /*64k*/
-              _mm_prefetch(&(srcAddr)[srcOffset * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              dstPidBase += 1;
-            }
-            break;
-#else
           RETURN_NOT_OK(splitFixedType<uint64_t>(srcAddr, dstAddrs));
-#endif
             break;
           }
         }
@@ -788,46 +1529,11 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
           continue;
         }
         dstOffset += dstOffsetInByte;
-        // now dst_offset is 8 aligned
-        for (; r + 8 < size; r += 8) {
-          uint8_t src = 0;
-          auto srcOffset = rowOffset2RowId_[r]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          // PREFETCHT0((&(srcAddr)[(srcOffset >> 3) + 64]));
-          dst = src >> (srcOffset & 7) | 0xfe; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 1]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 1 | 0xfd; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 2]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 2 | 0xfb; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 3]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 3 | 0xf7; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 4]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 4 | 0xef; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 5]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 5 | 0xdf; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 6]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 6 | 0xbf; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 7]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 7 | 0x7f; // get the bit in bit 0, other bits set to 1
-
-          dstaddr[dstOffset >> 3] = dst;
-          dstOffset += 8;
-          //_mm_prefetch(dstaddr + (dst_offset >> 3) + 64, _MM_HINT_T0);
-        }
+        // now dst_offset is 8 aligned, gather whole bytes but leave at least one row for the last byte
+        auto numBytes = (size - r - 1) / 8;
+        gatherBits(splitKernelIsa_, srcAddr, rowOffset2RowId_.data() + r, numBytes, dstaddr + (dstOffset >> 3));
+        r += numBytes * 8;
+        dstOffset += numBytes * 8;
         // last byte, set it to 0xff is ok
         dst = 0xff;
         dstIdxByte = 0;
@@ -848,7 +1554,8 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
     return arrow::Status::OK();
   }
 
-  arrow::Status VeloxShuffleWriter::splitValidityBuffer(const velox::RowVector& rv) {
+  arrow::Status VeloxShuffleWriter::allocateValidityBuffers(const velox::RowVector& rv) {
+    PhaseTimer timer(splitPhaseNanos_[kAllocateBuffers]);
     for (size_t col = 0; col < simpleColumnIndices_.size(); ++col) {
       auto colIdx = simpleColumnIndices_[col];
       auto column = rv.childAt(colIdx);
@@ -857,7 +1564,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
         for (auto pid = 0; pid < numPartitions_; ++pid) {
           if (partition2RowCount_[pid] > 0 && dstAddrs[pid] == nullptr) {
             // init bitmap if it's null, initialize the buffer as true
-            auto newSize = std::max(partition2RowCount_[pid], (uint32_t)options_.buffer_size);
+            auto newSize = std::max(partition2RowCount_[pid], partition2BufferSize_[pid]);
             std::shared_ptr<arrow::Buffer> validityBuffer;
             auto status = pool_->allocate(validityBuffer, arrow::bit_util::BytesForBits(newSize));
             ARROW_RETURN_NOT_OK(status);
@@ -866,9 +1573,18 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
             partitionBuffers_[col][pid][kValidityBufferIndex] = std::move(validityBuffer);
           }
         }
+      }
+    }
+    return arrow::Status::OK();
+  }
 
+  arrow::Status VeloxShuffleWriter::splitValidityBuffer(const velox::RowVector& rv, uint32_t begin, uint32_t end) {
+    for (size_t col = begin; col < end; ++col) {
+      auto colIdx = simpleColumnIndices_[col];
+      auto column = rv.childAt(colIdx);
+      if (vectorHasNull(column)) {
         auto srcAddr = (const uint8_t*)(column->mutableRawNulls());
-        RETURN_NOT_OK(splitBoolType(srcAddr, dstAddrs));
+        RETURN_NOT_OK(splitBoolType(srcAddr, partitionValidityAddrs_[col]));
       } else {
         VsPrintLF(colIdx, " column hasn't null");
       }
@@ -903,7 +1619,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
         // 1. copy offset
         valueOffset = dstOffsetBase[x + 1] = valueOffset + stringLen;
 
-        if (valueOffset >= capacity) {
+        if (valueOffset > capacity) {
           auto oldCapacity = capacity;
           (void)oldCapacity; // suppress warning
           capacity = capacity + std::max((capacity >> multiply), (uint64_t)stringLen);
@@ -933,14 +1649,19 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
         dstValuePtr += stringLen;
       }
 
+      if (size > 0) {
+        auto& width = partitionBinaryWidths_[binaryIdx][pid];
+        auto observed = static_cast<float>(valueOffset - binaryBuf.valueOffset) / size;
+        width = width == 0 ? observed : width + kRateSmoothing * (observed - width);
+      }
       binaryBuf.valueOffset = valueOffset;
     }
 
     return arrow::Status::OK();
   }
 
-  arrow::Status VeloxShuffleWriter::splitBinaryArray(const velox::RowVector& rv) {
-    for (auto col = fixedWidthColumnCount_; col < simpleColumnIndices_.size(); ++col) {
+  arrow::Status VeloxShuffleWriter::splitBinaryArray(const velox::RowVector& rv, uint32_t begin, uint32_t end) {
+    for (auto col = std::max(begin, fixedWidthColumnCount_); col < end; ++col) {
       auto binaryIdx = col - fixedWidthColumnCount_;
       auto& dstAddrs = partitionBinaryAddrs_[binaryIdx];
       auto colIdx = simpleColumnIndices_[col];
@@ -953,23 +1674,10 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
   }
 
   arrow::Status VeloxShuffleWriter::splitComplexType(const velox::RowVector& rv) {
+    PhaseTimer timer(splitPhaseNanos_[kSplitComplex]);
     if (complexColumnIndices_.size() == 0) {
       return arrow::Status::OK();
     }
-    auto numRows = rv.size();
-    std::vector<std::vector<facebook::velox::IndexRange>> rowIndexs;
-    rowIndexs.resize(numPartitions_);
-    // TODO: maybe an estimated row is more reasonable
-    for (auto row = 0; row < numRows; ++row) {
-      auto partition = row2Partition_[row];
-      if (complexTypeData_[partition] == nullptr) {
-        // TODO: maybe memory issue, copy many times
-        complexTypeData_[partition] = std::move(serde_->createSerializer(
-            complexWriteType_, partition2RowCount_[partition], arena_.get(), /* serdeOptions */ nullptr));
-      }
-      rowIndexs[partition].emplace_back(IndexRange{row, 1});
-    }
-
     std::vector<VectorPtr> childrens;
     for (size_t i = 0; i < complexColumnIndices_.size(); ++i) {
       auto colIdx = complexColumnIndices_[i];
@@ -978,10 +1686,33 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
     }
     auto rowVector = std::make_shared<RowVector>(
         veloxPool_.get(), complexWriteType_, BufferPtr(nullptr), rv.size(), std::move(childrens));
+
+    // Gather the rows of each partition into its vector column by column, the consecutive row ids of a partition
+    // as one range. The rows are serialized once, when the payload of the partition is created.
+    std::vector<BaseVector::CopyRange> ranges;
     for (auto pid = 0; pid < numPartitions_; pid++) {
-      if (rowIndexs[pid].size() != 0) {
-        complexTypeData_[pid]->append(rowVector, folly::Range(rowIndexs[pid].data(), rowIndexs[pid].size()));
+      auto begin = partition2RowOffset_[pid];
+      auto end = partition2RowOffset_[pid + 1];
+      if (begin == end) {
+        continue;
+      }
+      auto& target = complexTypeData_[pid];
+      if (target == nullptr) {
+        target = std::static_pointer_cast<RowVector>(BaseVector::create(complexWriteType_, 0, veloxPool_.get()));
       }
+      vector_size_t targetIndex = target->size();
+      ranges.clear();
+      for (auto offset = begin; offset < end; ++offset) {
+        vector_size_t rowId = rowOffset2RowId_[offset];
+        if (!ranges.empty() && ranges.back().sourceIndex + ranges.back().count == rowId) {
+          ranges.back().count++;
+        } else {
+          ranges.push_back({rowId, targetIndex, 1});
+        }
+        targetIndex++;
+      }
+      target->resize(targetIndex);
+      target->copyRanges(rowVector.get(), folly::Range<const BaseVector::CopyRange*>(ranges.data(), ranges.size()));
     }
 
     return arrow::Status::OK();
@@ -1028,6 +1759,8 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
     printColumnsInfo();
 
     binaryArrayEmpiricalSize_.resize(binaryColumnIndices_.size(), 0);
+    dictionaryBinaryColumns_.resize(binaryColumnIndices_.size(), false);
+    constantColumns_.resize(simpleColumnIndices_.size(), false);
 
     inputHasNull_.resize(simpleColumnIndices_.size(), false);
 
@@ -1047,8 +1780,45 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
     return arrow::Status::OK();
   }
 
-  uint32_t VeloxShuffleWriter::calculatePartitionBufferSize(const velox::RowVector& rv) {
-    uint32_t sizePerRow = 0;
+  void VeloxShuffleWriter::updateColumnEncodings(const velox::RowVector& input, uint32_t columnOffset) {
+    if (options_.string_dictionary_encoding) {
+      for (size_t i = 0; i < binaryColumnIndices_.size(); ++i) {
+        auto encoding = input.childAt(binaryColumnIndices_[i] + columnOffset)->loadedVector()->encoding();
+        if (encoding == VectorEncoding::Simple::DICTIONARY || encoding == VectorEncoding::Simple::CONSTANT) {
+          dictionaryBinaryColumns_[i] = true;
+        }
+      }
+    }
+    if (options_.elide_constant_columns) {
+      for (size_t i = 0; i < simpleColumnIndices_.size(); ++i) {
+        auto* column = input.childAt(simpleColumnIndices_[i] + columnOffset)->loadedVector();
+        if (column->encoding() == VectorEncoding::Simple::CONSTANT ||
+            (column->encoding() == VectorEncoding::Simple::FLAT && column->mayHaveNulls() &&
+             BaseVector::countNulls(column->nulls(), column->size()) == column->size())) {
+          constantColumns_[i] = true;
+        }
+      }
+    }
+  }
+
+  void VeloxShuffleWriter::updatePartitionRowRates(uint32_t numRows) {
+    if (rowRate_ == 0) {
+      std::copy(partition2RowCount_.begin(), partition2RowCount_.end(), partitionRowRates_.begin());
+      rowRate_ = numRows;
+      return;
+    }
+    for (auto pid = 0; pid < numPartitions_; ++pid) {
+      partitionRowRates_[pid] += kRateSmoothing * (partition2RowCount_[pid] - partitionRowRates_[pid]);
+    }
+    rowRate_ += kRateSmoothing * (numRows - rowRate_);
+  }
+
+  double VeloxShuffleWriter::binaryWidth(uint32_t binaryIdx, uint32_t partitionId) const {
+    auto width = partitionBinaryWidths_[binaryIdx][partitionId];
+    return width > 0 ? width : binaryArrayEmpiricalSize_[binaryIdx];
+  }
+
+  uint32_t VeloxShuffleWriter::calculatePartitionBufferSize(const velox::RowVector& rv, uint32_t partitionId) {
     auto numRows = rv.size();
     for (size_t i = fixedWidthColumnCount_; i < simpleColumnIndices_.size(); ++i) {
       auto index = i - fixedWidthColumnCount_;
@@ -1069,7 +1839,10 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
 
     VS_PRINT_VECTOR_MAPPING(binaryArrayEmpiricalSize_);
 
-    sizePerRow = std::accumulate(binaryArrayEmpiricalSize_.begin(), binaryArrayEmpiricalSize_.end(), 0);
+    double sizePerRow = 0;
+    for (size_t index = 0; index < binaryColumnIndices_.size(); ++index) {
+      sizePerRow += binaryWidth(index, partitionId);
+    }
 
     for (size_t col = 0; col < simpleColumnIndices_.size(); ++col) {
       auto colIdx = simpleColumnIndices_[col];
@@ -1079,14 +1852,20 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
 
     VS_PRINTLF(sizePerRow);
 
-    uint64_t preAllocRowCnt = options_.offheap_per_task > 0 && sizePerRow > 0
-        ? options_.offheap_per_task / sizePerRow / numPartitions_ >> 2
-        : options_.buffer_size;
-    preAllocRowCnt = std::min(preAllocRowCnt, (uint64_t)options_.buffer_size);
+    // Enough rows for the partition to fill its buffers over several RowVectors at its rate.
+    double minRowCnt = std::min<uint32_t>(kMinPartitionBufferSize, options_.buffer_size);
+    double preAllocRowCnt = partitionRowRates_[partitionId] * kRowVectorsPerPartitionBuffer;
+    if (options_.offheap_per_task > 0 && sizePerRow > 0) {
+      // A quarter of the memory for all partitions, shared by their rates.
+      auto share = rowRate_ > 0 ? partitionRowRates_[partitionId] / rowRate_ : 1.0 / numPartitions_;
+      auto budgetRowCnt = options_.offheap_per_task / sizePerRow / 4 * share;
+      preAllocRowCnt = std::min(preAllocRowCnt, std::max(budgetRowCnt, minRowCnt));
+    }
+    preAllocRowCnt = std::clamp(preAllocRowCnt, minRowCnt, (double)options_.buffer_size);
 
-    VS_PRINTLF(preallocRowCnt);
+    VS_PRINTLF(preAllocRowCnt);
 
-    return preAllocRowCnt;
+    return static_cast<uint32_t>(preAllocRowCnt);
   }
 
   arrow::Status VeloxShuffleWriter::allocatePartitionBuffers(uint32_t partitionId, uint32_t newSize) {
@@ -1102,7 +1881,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
         case arrow::StringType::type_id: {
           std::shared_ptr<arrow::Buffer> offsetBuffer;
           std::shared_ptr<arrow::Buffer> validityBuffer = nullptr;
-          auto valueBufSize = binaryArrayEmpiricalSize_[binaryIdx] * newSize + 1024;
+          auto valueBufSize = static_cast<uint64_t>(std::ceil(binaryWidth(binaryIdx, partitionId) * newSize)) + 1024;
           ARROW_ASSIGN_OR_RAISE(
               std::shared_ptr<arrow::Buffer> valueBuffer,
               arrow::AllocateResizableBuffer(valueBufSize, options_.memory_pool.get()));
@@ -1169,6 +1948,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
   }
 
   arrow::Status VeloxShuffleWriter::allocatePartitionBuffersWithRetry(uint32_t partitionId, uint32_t newSize) {
+    PhaseTimer timer(splitPhaseNanos_[kAllocateBuffers]);
     auto retry = 0;
     auto status = allocatePartitionBuffers(partitionId, newSize);
     while (status.IsOutOfMemory() && retry < 3) {
@@ -1235,6 +2015,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
     if (partitionBufferIdxBase_[partitionId] <= 0) {
       return nullptr;
     }
+    PhaseTimer timer(splitPhaseNanos_[kCreatePayload]);
 
     auto numRows = partitionBufferIdxBase_[partitionId];
 
@@ -1272,6 +2053,34 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
                 reinterpret_cast<const int32_t*>(buffers[kOffsetBufferIndex]->data())[numRows]);
           }
 
+          auto simpleIdx = fixedWidthColumnCount_ + binaryIdx;
+          auto elided = constantColumns_[simpleIdx] && buffers[kOffsetBufferIndex] != nullptr &&
+              elideStringColumn(
+                  buffers[kValidityBufferIndex],
+                  buffers[kOffsetBufferIndex],
+                  buffers[kValueBufferIndex],
+                  numRows,
+                  pool_.get());
+          if (!elided && dictionaryBinaryColumns_[binaryIdx] && buffers[kValueBufferIndex] != nullptr &&
+              stringDictionaryEncoder_.encode(
+                  reinterpret_cast<const int32_t*>(buffers[kOffsetBufferIndex]->data()),
+                  buffers[kValueBufferIndex]->data(),
+                  numRows,
+                  kMaxDictionaryDistinctRatio)) {
+            // New buffers, the partition buffers may be reused.
+            auto& indicesAndOffsets = stringDictionaryEncoder_.indicesAndOffsets();
+            auto& dictionary = stringDictionaryEncoder_.dictionary();
+            auto offsetBytes = indicesAndOffsets.size() * sizeof(int32_t);
+            std::shared_ptr<arrow::ResizableBuffer> encodedOffsets;
+            std::shared_ptr<arrow::ResizableBuffer> encodedValues;
+            RETURN_NOT_OK(pool_->allocateDirectly(encodedOffsets, offsetBytes));
+            RETURN_NOT_OK(pool_->allocateDirectly(encodedValues, dictionary.size()));
+            memcpy(encodedOffsets->mutable_data(), indicesAndOffsets.data(), offsetBytes);
+            memcpy(encodedValues->mutable_data(), dictionary.data(), dictionary.size());
+            buffers[kOffsetBufferIndex] = std::move(encodedOffsets);
+            buffers[kValueBufferIndex] = std::move(encodedValues);
+          }
+
           allBuffers.emplace_back(buffers[kValidityBufferIndex]);
           allBuffers.emplace_back(buffers[kOffsetBufferIndex]);
           allBuffers.emplace_back(buffers[kValueBufferIndex]);
@@ -1311,6 +2120,14 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
                   arrow::SliceBuffer(buffers[1], 0, numRows * (arrow::bit_width(arrowColumnTypes_[i]->id()) >> 3));
             }
           }
+          if (constantColumns_[fixedWidthIdx] && buffers[1] != nullptr) {
+            elideFixedWidthColumn(
+                buffers[kValidityBufferIndex],
+                buffers[1],
+                numRows,
+                arrowColumnTypes_[i]->id() == arrow::BooleanType::type_id,
+                pool_.get());
+          }
           allBuffers.emplace_back(buffers[kValidityBufferIndex]);
           allBuffers.emplace_back(buffers[1]);
           if (resetBuffers) {
@@ -1324,32 +2141,34 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
       }
     }
     if (hasComplexType && complexTypeData_[partitionId] != nullptr) {
-      auto flushBuffer = complexTypeFlushBuffer_[partitionId];
-      auto serializedSize = complexTypeData_[partitionId]->maxSerializedSize();
-      if (flushBuffer == nullptr) {
-        GLUTEN_ASSIGN_OR_THROW(flushBuffer, arrow::AllocateResizableBuffer(serializedSize, options_.memory_pool.get()));
-      } else if (serializedSize > flushBuffer->capacity()) {
-        GLUTEN_THROW_NOT_OK(flushBuffer->Reserve(serializedSize));
-      }
-      auto valueBuffer = arrow::SliceMutableBuffer(flushBuffer, 0, serializedSize);
-      auto output = std::make_shared<arrow::io::FixedSizeBufferWriter>(valueBuffer);
-      serializer::presto::PrestoOutputStreamListener listener;
-      ArrowFixedSizeBufferOutputStream out(output, &listener);
-      complexTypeData_[partitionId]->flush(&out);
-      allBuffers.emplace_back(valueBuffer);
+      allBuffers.emplace_back(
+          serializeComplexType(complexTypeData_[partitionId], complexTypeFlushBuffer_[partitionId]));
       complexTypeData_[partitionId] = nullptr;
     }
 
-    return makeRecordBatch(numRows, allBuffers);
+    return makeRecordBatch(partitionId, numRows, allBuffers);
   }
 
   std::shared_ptr<arrow::RecordBatch> VeloxShuffleWriter::makeRecordBatch(
-      uint32_t numRows, const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+      uint32_t partitionId, uint32_t numRows, const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+    std::shared_ptr<arrow::RecordBatch> rb;
     if (options_.codec == nullptr) {
-      return makeUncompressedRecordBatch(numRows, buffers, writeSchema(), pool_.get());
+      rb = makeUncompressedRecordBatch(numRows, buffers, writeSchema(), pool_.get());
+    } else if (adaptiveCompressor_ != nullptr) {
+      TIME_NANO_START(totalCompressTime_);
+      rb = makeAdaptiveCompressedRecordBatch(
+          numRows,
+          buffers,
+          compressWriteSchema(),
+          pool_.get(),
+          options_.compression_type,
+          adaptiveCompressor_.get(),
+          options_.buffer_compress_threshold,
+          partitionDictionaryIds_[partitionId]);
+      TIME_NANO_END(totalCompressTime_);
     } else {
       TIME_NANO_START(totalCompressTime_);
-      auto rb = makeCompressedRecordBatch(
+      rb = makeCompressedRecordBatch(
           numRows,
           buffers,
           compressWriteSchema(),
@@ -1357,12 +2176,13 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
           options_.codec.get(),
           options_.buffer_compress_threshold);
       TIME_NANO_END(totalCompressTime_);
-      return rb;
     }
+    return options_.block_checksum ? addBlockChecksum(*rb, pool_.get()) : rb;
   }
 
   arrow::Status VeloxShuffleWriter::cacheRecordBatch(
       uint32_t partitionId, const arrow::RecordBatch& rb, bool reuseBuffers) {
+    PhaseTimer timer(splitPhaseNanos_[kCreatePayload]);
     rawPartitionLengths_[partitionId] += getBatchNbytes(rb);
     ARROW_ASSIGN_OR_RAISE(auto payload, createArrowIpcPayload(rb, reuseBuffers));
     partitionCachedRecordbatchSize_[partitionId] += payload->body_length;
@@ -1373,6 +2193,16 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
 
   arrow::Status VeloxShuffleWriter::evictFixedSize(int64_t size, int64_t * actual) {
     int64_t currentEvicted = 0L;
+    if (isSortBased()) {
+      // buffered input can only be released after it's converted to cached payloads, evicted below
+      auto bufferedBytes = sortBufferedBytes_;
+      auto cachedBytes = totalCachedPayloadSize();
+      RETURN_NOT_OK(sortAndCacheBufferedRows());
+      if (sortBufferedBytesListener_ != nullptr) {
+        // The charge of the buffered vectors is released, the payloads made of them are charged instead.
+        currentEvicted += bufferedBytes - sortBufferedBytes_ - (totalCachedPayloadSize() - cachedBytes);
+      }
+    }
     auto tryCount = 0;
     while (currentEvicted < size && tryCount < 5) {
       tryCount++;
@@ -1400,6 +2230,8 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const velox::RowVec
       }
       if (partitionToEvict != -1) {
         RETURN_NOT_OK(evictPartition(partitionToEvict));
+        // Caller expects the memory to be released on return.
+        RETURN_NOT_OK(partitionWriter_->finishEvict());
 #ifdef GLUTEN_PRINT_DEBUG
         std::cout << "Evicted partition " << std::to_string(partitionToEvict) << ", " << std::to_string(maxSize)
                   << " bytes released" << std::endl;
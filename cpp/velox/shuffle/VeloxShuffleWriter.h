@@ -18,6 +18,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -45,9 +47,13 @@
 #include "arrow/result.h"
 
 #include "memory/VeloxMemoryPool.h"
+#include "shuffle/AdaptiveCompression.h"
 #include "shuffle/PartitionWriterCreator.h"
 #include "shuffle/Partitioner.h"
+#include "shuffle/RangePartitionBounds.h"
+#include "shuffle/ShuffleSplitKernels.h"
 #include "shuffle/ShuffleWriter.h"
+#include "shuffle/StringDictionary.h"
 #include "shuffle/utils.h"
 
 #include "utils/Print.h"
@@ -113,11 +119,30 @@ class VeloxShuffleWriter final : public ShuffleWriter {
     uint64_t valueOffset;
   };
 
+  // Phases of split whose time is reported by splitPhaseTimes(). The split of the simple columns may run on several
+  // threads, their times are then summed over the threads.
+  enum SplitPhase : int32_t {
+    kComputePid = 0,
+    kCreatePartition2Row,
+    kSplitFixedWidth,
+    kSplitValidity,
+    kSplitBinary,
+    // Serializing the complex columns, on split and when their buffers are flushed.
+    kSplitComplex,
+    // Allocating partition and validity buffers, including any eviction it triggers.
+    kAllocateBuffers,
+    // Making the record batches and payloads of partitions, including their compression.
+    kCreatePayload,
+    kNumSplitPhases
+  };
+
   static arrow::Result<std::shared_ptr<VeloxShuffleWriter>> create(
       uint32_t numPartitions,
       std::shared_ptr<PartitionWriterCreator> partitionWriterCreator,
       ShuffleWriterOptions options);
 
+  ~VeloxShuffleWriter() override;
+
   arrow::Status split(std::shared_ptr<ColumnarBatch> cb) override;
 
   arrow::Status stop() override;
@@ -134,10 +159,18 @@ class VeloxShuffleWriter final : public ShuffleWriter {
       const arrow::RecordBatch& rb,
       bool reuseBuffers) override;
 
+  std::vector<std::pair<std::string, int64_t>> splitPhaseTimes() const override;
+
   int64_t rawPartitionBytes() const {
     return std::accumulate(rawPartitionLengths_.begin(), rawPartitionLengths_.end(), 0LL);
   }
 
+  // Huge page and NUMA locality counters of the IPC memory pool, nullptr if it isn't a LargeMemoryPool.
+  const LargeMemoryPoolStats* ipcMemoryPoolStats() const {
+    auto largePool = dynamic_cast<LargeMemoryPool*>(options_.ipc_write_options.memory_pool);
+    return largePool ? &largePool->stats() : nullptr;
+  }
+
   // for testing
   const std::string& dataFile() const {
     return options_.data_file;
@@ -196,8 +229,7 @@ class VeloxShuffleWriter final : public ShuffleWriter {
       std::shared_ptr<PartitionWriterCreator> partitionWriterCreator,
       const ShuffleWriterOptions& options)
       : ShuffleWriter(numPartitions, partitionWriterCreator, std::move(options)),
-        veloxPool_(defaultLeafVeloxMemoryPool()),
-        arena_(std::make_unique<facebook::velox::StreamArena>(veloxPool_.get())) {}
+        veloxPool_(defaultLeafVeloxMemoryPool()) {}
 
   arrow::Status init();
 
@@ -211,13 +243,49 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   arrow::Status initFromRowVector(const facebook::velox::RowVector& rv);
 
+  // Mark the columns of input, the unflattened batch, whose payloads may be dictionary encoded or elided. Its column
+  // columnOffset is the first column of the split row vector.
+  void updateColumnEncodings(const facebook::velox::RowVector& input, uint32_t columnOffset);
+
+  // The rank of each row of the unflattened batch in the order of the murmur3 hashes of its columns, into
+  // clusterRanks_. Returns false if the batch has no column murmur3 can hash.
+  arrow::Result<bool> computeClusterRanks(const facebook::velox::RowVector& rv);
+
   arrow::Status createPartition2Row(uint32_t rowNum);
 
   arrow::Status updateInputHasNull(const facebook::velox::RowVector& rv);
 
   arrow::Status doSplit(const facebook::velox::RowVector& rv);
 
-  uint32_t calculatePartitionBufferSize(const facebook::velox::RowVector& rv);
+  arrow::Status splitOrBuffer(facebook::velox::RowVectorPtr rv);
+
+  // Cache the whole RowVector as one record batch of the partition.
+  arrow::Status cacheRowVector(uint32_t partitionId, const facebook::velox::RowVector& rv);
+
+  // For sort based shuffle writer. Keep the RowVector and its partition ids until the buffered size reaches
+  // sort_buffer_threshold.
+  arrow::Status bufferRowVector(facebook::velox::RowVectorPtr rv);
+
+  // For sort based shuffle writer. Sort buffered rows by partition id and cache one record batch per partition, its
+  // buffers gathered straight from the buffered vectors.
+  arrow::Status sortAndCacheBufferedRows();
+
+  // For sort based shuffle writer. Charge the task for diff bytes of buffered vectors, which may evict them.
+  void chargeSortBufferedBytes(int64_t diff);
+
+  bool isSortBased() const {
+    return options_.shuffle_writer_type == kSortShuffleWriterType;
+  }
+
+  // Updates the row rates of the partitions with the rows of the RowVector going to each.
+  void updatePartitionRowRates(uint32_t numRows);
+
+  // Rows to allocate the buffers of the partition for, by its row rate and the widths of its strings, within its share
+  // of offheap_per_task by the row rates.
+  uint32_t calculatePartitionBufferSize(const facebook::velox::RowVector& rv, uint32_t partitionId);
+
+  // Bytes per row of the binary column in the partition, the one of the column until the partition gets rows.
+  double binaryWidth(uint32_t binaryIdx, uint32_t partitionId) const;
 
   arrow::Status allocatePartitionBuffers(uint32_t partitionId, uint32_t newSize);
 
@@ -227,32 +295,44 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   arrow::Status cacheRecordBatch(uint32_t partitionId, const arrow::RecordBatch& rb, bool reuseBuffers);
 
-  arrow::Status splitFixedWidthValueBuffer(const facebook::velox::RowVector& rv);
+  // Split the simple columns simpleColumnIndices_[begin, end). Columns don't share any state, so disjoint ranges can
+  // be split concurrently.
+  arrow::Status splitSimpleColumns(const facebook::velox::RowVector& rv, uint32_t begin, uint32_t end);
+
+  // Reserve the value buffers of the binary columns for the rows of rv, so that splitting them doesn't allocate.
+  arrow::Status reserveBinaryValueBuffers(const facebook::velox::RowVector& rv);
+
+  // Fan the simple columns out to the split executor. The task thread takes the first column group.
+  arrow::Status splitSimpleColumnsParallel(const facebook::velox::RowVector& rv);
+
+  bool shouldSplitInParallel(const facebook::velox::RowVector& rv) const;
+
+  arrow::Status splitFixedWidthValueBuffer(const facebook::velox::RowVector& rv, uint32_t begin, uint32_t end);
 
   arrow::Status splitBoolType(const uint8_t* srcAddr, const std::vector<uint8_t*>& dstAddrs);
 
-  arrow::Status splitValidityBuffer(const facebook::velox::RowVector& rv);
+  // Allocate the validity buffers of partitions that get nulls from this RowVector. Not thread safe.
+  arrow::Status allocateValidityBuffers(const facebook::velox::RowVector& rv);
+
+  arrow::Status splitValidityBuffer(const facebook::velox::RowVector& rv, uint32_t begin, uint32_t end);
 
-  arrow::Status splitBinaryArray(const facebook::velox::RowVector& rv);
+  arrow::Status splitBinaryArray(const facebook::velox::RowVector& rv, uint32_t begin, uint32_t end);
 
   arrow::Status splitComplexType(const facebook::velox::RowVector& rv);
 
   template <typename T>
   arrow::Status splitFixedType(const uint8_t* srcAddr, const std::vector<uint8_t*>& dstAddrs) {
-    std::transform(
-        dstAddrs.begin(),
-        dstAddrs.end(),
-        partitionBufferIdxBase_.begin(),
-        partitionBufferIdxOffset_.begin(),
-        [](uint8_t* x, uint32_t y) { return x + y * sizeof(T); });
-
     for (uint32_t pid = 0; pid < numPartitions_; ++pid) {
-      auto dstPidBase = reinterpret_cast<T*>(partitionBufferIdxOffset_[pid]);
       auto pos = partition2RowOffset_[pid];
       auto end = partition2RowOffset_[pid + 1];
-      for (; pos < end; ++pos) {
-        auto rowId = rowOffset2RowId_[pos];
-        *dstPidBase++ = reinterpret_cast<const T*>(srcAddr)[rowId]; // copy
+      if (pos < end) {
+        gatherFixedWidth(
+            splitKernelIsa_,
+            sizeof(T),
+            srcAddr,
+            rowOffset2RowId_.data() + pos,
+            end - pos,
+            dstAddrs[pid] + partitionBufferIdxBase_[pid] * sizeof(T));
       }
     }
     return arrow::Status::OK();
@@ -267,16 +347,38 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   arrow::Status evictPartition(int32_t partitionId);
 
-  std::shared_ptr<arrow::RecordBatch> makeRecordBatch(
-      uint32_t numRows,
-      const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
+  std::shared_ptr<arrow::RecordBatch>
+  makeRecordBatch(uint32_t partitionId, uint32_t numRows, const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
 
   std::shared_ptr<arrow::Buffer> generateComplexTypeBuffers(facebook::velox::RowVectorPtr vector);
 
+  std::shared_ptr<arrow::Buffer> serializeComplexType(
+      const facebook::velox::RowVectorPtr& vector,
+      std::shared_ptr<arrow::ResizableBuffer>& flushBuffer);
+
+  // Serialize the rows of the complex columns of the buffered vectors, referenced as in sortAndCacheBufferedRows.
+  std::shared_ptr<arrow::Buffer> serializeComplexRows(
+      const std::vector<facebook::velox::RowVectorPtr>& complexVectors,
+      const uint64_t* rowRefs,
+      facebook::velox::vector_size_t numRows);
+
+  std::shared_ptr<arrow::Buffer> flushComplexType(
+      facebook::velox::VectorSerializer& serializer,
+      std::shared_ptr<arrow::ResizableBuffer>& flushBuffer);
+
  protected:
   arrow::Status resetValidityBuffers(uint32_t partitionId);
 
-  bool supportAvx512_ = false;
+  SplitKernelIsa splitKernelIsa_ = SplitKernelIsa::kScalar;
+
+  // Nanos spent in each SplitPhase.
+  std::array<std::atomic<int64_t>, kNumSplitPhases> splitPhaseNanos_{};
+
+  // Set if options_.adaptive_compression.
+  std::unique_ptr<AdaptiveBufferCompressor> adaptiveCompressor_;
+  // Ids of the ZSTD dictionaries each partition has sent, the reader of a partition receives a dictionary before the
+  // first buffer compressed with it.
+  std::vector<std::vector<uint32_t>> partitionDictionaryIds_;
 
   // store arrow column types
   std::vector<std::shared_ptr<arrow::DataType>> arrowColumnTypes_; // column_type_id_
@@ -290,6 +392,18 @@ class VeloxShuffleWriter final : public ShuffleWriter {
   // TODO: rethink, is uint16_t better?
   std::vector<uint16_t> row2Partition_; // note: partition_id_
 
+  // Murmur3 hashes of the partition keys when the writer computes them from hash_partition_key_ids.
+  std::vector<int32_t> partitionKeyHashes_;
+
+  // Set if the writer computes the range partition ids from options_.range_bounds.
+  std::unique_ptr<RangePartitionBounds> rangePartitionBounds_;
+  std::vector<int32_t> rangePartitionIds_;
+
+  // Per column hashes, row order and row ranks of options_.round_robin_clustering.
+  std::vector<std::vector<int32_t>> clusterHashes_;
+  std::vector<int32_t> clusterOrder_;
+  std::vector<int32_t> clusterRanks_;
+
   // Partition ID -> Row Count
   // subscript: Partition ID
   // value: how many rows does this partition have
@@ -324,31 +438,60 @@ class VeloxShuffleWriter final : public ShuffleWriter {
   // partid, value is reducer batch's offset, output rb rownum < 64k
   std::vector<uint32_t> partitionBufferIdxBase_;
 
-  // temp array to hold the destination pointer
-  std::vector<uint8_t*> partitionBufferIdxOffset_;
-
   typedef uint32_t row_offset_type;
 
   std::vector<std::vector<uint8_t*>> partitionValidityAddrs_;
   std::vector<std::vector<uint8_t*>> partitionFixedWidthValueAddrs_;
 
-  std::vector<uint64_t> binaryArrayEmpiricalSize_;
+  // Bytes per row of each binary column, from the first RowVector until rows are split.
+  std::vector<double> binaryArrayEmpiricalSize_;
+  // Moving average bytes per row of each binary column in each partition, 0 until the partition gets rows. Updated by
+  // the thread splitting the column.
+  std::vector<std::vector<float>> partitionBinaryWidths_;
+
+  // Moving average rows per RowVector of each partition and of all of them.
+  std::vector<float> partitionRowRates_;
+  double rowRate_ = 0;
 
   std::vector<std::vector<BinaryBuf>> partitionBinaryAddrs_;
 
+  // Binary columns whose payloads are dictionary encoded when it makes them smaller.
+  std::vector<bool> dictionaryBinaryColumns_;
+  // Simple columns whose payloads are elided when they hold only nulls or one value.
+  std::vector<bool> constantColumns_;
+  StringDictionaryEncoder stringDictionaryEncoder_;
+
   std::vector<bool> inputHasNull_;
 
-  // pid
-  std::vector<std::unique_ptr<facebook::velox::VectorSerializer>> complexTypeData_;
+  // pid, the rows of the complex columns not yet in a payload
+  std::vector<facebook::velox::RowVectorPtr> complexTypeData_;
   std::vector<std::shared_ptr<arrow::ResizableBuffer>> complexTypeFlushBuffer_;
   std::shared_ptr<const facebook::velox::RowType> complexWriteType_;
 
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
-  std::unique_ptr<facebook::velox::StreamArena> arena_;
 
   std::unique_ptr<facebook::velox::serializer::presto::PrestoVectorSerde> serde_ =
       std::make_unique<facebook::velox::serializer::presto::PrestoVectorSerde>();
 
+  // sort based shuffle writer
+  // buffered input RowVectors
+  std::vector<facebook::velox::RowVectorPtr> sortBufferedVectors_;
+
+  // Row ID of all buffered RowVectors -> Partition ID
+  std::vector<uint16_t> sortBufferedRow2Partition_;
+
+  // Partition ID -> buffered Row Count
+  std::vector<uint32_t> sortBufferedPartition2RowCount_;
+
+  int64_t sortBufferedBytes_ = 0;
+
+  // The buffered vectors are held in the pools of the upstream operators, they are charged to the task through the
+  // listener of memory_pool as well so that the writer is asked to evict them. Null if the pool isn't tracked.
+  AllocationListener* sortBufferedBytesListener_ = nullptr;
+
+  // avoid re-entering when evicting during sorting
+  bool sorting_ = false;
+
 }; // class VeloxShuffleWriter
 
 } // namespace gluten
@@ -301,7 +301,10 @@ void SubstraitParser::getSubFunctionTypes(const std::string& subFuncSpec, std::v
 std::string SubstraitParser::findVeloxFunction(
     const std::unordered_map<uint64_t, std::string>& functionMap,
     uint64_t id) {
-  std::string funcSpec = findFunctionSpec(functionMap, id);
+  return findVeloxFunction(findFunctionSpec(functionMap, id));
+}
+
+std::string SubstraitParser::findVeloxFunction(const std::string& funcSpec) {
   std::string_view funcName = getNameBeforeDelimiter(funcSpec, ":");
   std::vector<std::string> types;
   getSubFunctionTypes(funcSpec, types);
@@ -347,6 +350,26 @@ bool SubstraitParser::configSetInOptimization(
   return false;
 }
 
+std::optional<std::string> SubstraitParser::getConfigInOptimization(
+    const ::substrait::extensions::AdvancedExtension& extension,
+    const std::string& config) {
+  if (!extension.has_optimization()) {
+    return std::nullopt;
+  }
+  google::protobuf::StringValue msg;
+  extension.optimization().UnpackTo(&msg);
+  const auto& value = msg.value();
+  for (std::size_t pos = value.find(config); pos != std::string::npos; pos = value.find(config, pos + 1)) {
+    // Only a whole key, at the start of a line or after the "JoinParameters:" like prefix.
+    if (pos == 0 || value[pos - 1] == '\n' || value[pos - 1] == ':') {
+      auto begin = pos + config.size();
+      auto end = value.find('\n', begin);
+      return value.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    }
+  }
+  return std::nullopt;
+}
+
 std::unordered_map<std::string, std::string> SubstraitParser::substraitVeloxFunctionMap_ = {
     {"is_not_null", "isnotnull"}, /*Spark functions.*/
     {"is_null", "isnull"},
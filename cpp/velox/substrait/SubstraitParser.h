@@ -27,6 +27,7 @@
 #include "substrait/type_expressions.pb.h"
 
 #include <google/protobuf/wrappers.pb.h>
+#include <optional>
 
 namespace gluten {
 
@@ -85,6 +86,9 @@ class SubstraitParser {
   /// from a pre-constructed function map.
   static std::string findVeloxFunction(const std::unordered_map<uint64_t, std::string>& functionMap, uint64_t id);
 
+  /// Used to find the Velox function name of a function specification.
+  static std::string findVeloxFunction(const std::string& functionSpec);
+
   /// Map the Substrait function keyword into Velox function keyword.
   static std::string mapToVeloxFunction(const std::string& substraitFunction, bool isDecimal);
 
@@ -95,6 +99,15 @@ class SubstraitParser {
   /// @return Whether the config is set as true.
   static bool configSetInOptimization(const ::substrait::extensions::AdvancedExtension&, const std::string& config);
 
+  /// @brief Return the value of a config in AdvancedExtension optimization,
+  /// i.e. the text after the key up to the end of its line.
+  /// @param extension Substrait advanced extension.
+  /// @param config the key string of a config, ending with '='.
+  /// @return The value, or nullopt if the config is absent.
+  static std::optional<std::string> getConfigInOptimization(
+      const ::substrait::extensions::AdvancedExtension&,
+      const std::string& config);
+
  private:
   /// A map used for mapping Substrait function keywords into Velox functions'
   /// keywords. Key: the Substrait function keyword, Value: the Velox function
@@ -16,6 +16,8 @@
  */
 
 #include "SubstraitToVeloxExpr.h"
+#include <algorithm>
+#include <shared_mutex>
 #include "TypeUtils.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/VariantToVector.h"
@@ -143,6 +145,53 @@ VectorPtr constructFlatVector(
   return vector;
 }
 
+// Whether the literal holds a value of the kind as setLiteralValue reads it, or a null.
+bool isLiteralOfKind(const ::substrait::Expression::Literal& literal, TypeKind kind) {
+  using LiteralTypeCase = ::substrait::Expression_Literal::LiteralTypeCase;
+  switch (literal.literal_type_case()) {
+    case LiteralTypeCase::kNull:
+      return true;
+    case LiteralTypeCase::kBoolean:
+      return kind == TypeKind::BOOLEAN;
+    case LiteralTypeCase::kI8:
+      return kind == TypeKind::TINYINT;
+    case LiteralTypeCase::kI16:
+      return kind == TypeKind::SMALLINT;
+    case LiteralTypeCase::kI32:
+      return kind == TypeKind::INTEGER;
+    case LiteralTypeCase::kI64:
+      return kind == TypeKind::BIGINT;
+    case LiteralTypeCase::kFp32:
+      return kind == TypeKind::REAL;
+    case LiteralTypeCase::kFp64:
+      return kind == TypeKind::DOUBLE;
+    case LiteralTypeCase::kString:
+    case LiteralTypeCase::kVarChar:
+    case LiteralTypeCase::kBinary:
+      return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+    case LiteralTypeCase::kDate:
+      return kind == TypeKind::DATE;
+    case LiteralTypeCase::kTimestamp:
+      return kind == TypeKind::TIMESTAMP;
+    default:
+      return false;
+  }
+}
+
+template <TypeKind kind>
+VectorPtr constructFlatVector(
+    const std::vector<const ::substrait::Expression::Literal*>& literals,
+    const TypePtr& type,
+    memory::MemoryPool* pool) {
+  auto vector = BaseVector::create(type, literals.size(), pool);
+  using T = typename TypeTraits<kind>::NativeType;
+  auto flatVector = vector->as<FlatVector<T>>();
+  for (vector_size_t index = 0; index < literals.size(); ++index) {
+    setLiteralValue(*literals[index], flatVector, index);
+  }
+  return vector;
+}
+
 /// Whether null will be returned on cast failure.
 bool isNullOnFailure(::substrait::Expression::Cast::FailureBehavior failureBehavior) {
   switch (failureBehavior) {
@@ -179,6 +228,29 @@ makeFieldAccessExpr(const std::string& name, const TypePtr& type, core::FieldAcc
   return std::make_shared<core::FieldAccessTypedExpr>(type, name);
 }
 
+struct ResolvedFunction {
+  std::string name;
+  TypePtr returnType;
+};
+
+// The Velox function and return type of a call of the function spec with the output type, resolved once per process.
+// The tasks of an executor convert the same few signatures over and over.
+ResolvedFunction resolveFunction(const std::string& functionSpec, const std::string& outputType) {
+  static std::shared_mutex mutex;
+  static std::unordered_map<std::string, ResolvedFunction> resolved;
+  auto key = functionSpec + "->" + outputType;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = resolved.find(key);
+    if (it != resolved.end()) {
+      return it->second;
+    }
+  }
+  ResolvedFunction function{gluten::SubstraitParser::findVeloxFunction(functionSpec), gluten::toVeloxType(outputType)};
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  return resolved.emplace(std::move(key), std::move(function)).first->second;
+}
+
 } // namespace
 
 using facebook::velox::core::variantArrayToVector;
@@ -275,36 +347,77 @@ core::TypedExprPtr SubstraitVeloxExprConverter::toVeloxExpr(
   for (const auto& sArg : substraitFunc.arguments()) {
     params.emplace_back(toVeloxExpr(sArg.value(), inputType));
   }
-  const auto& veloxFunction = SubstraitParser::findVeloxFunction(functionMap_, substraitFunc.function_reference());
-  std::string typeName = SubstraitParser::parseType(substraitFunc.output_type())->type;
+  auto [veloxFunction, returnType] = resolveFunction(
+      SubstraitParser::findFunctionSpec(functionMap_, substraitFunc.function_reference()),
+      SubstraitParser::parseType(substraitFunc.output_type())->type);
 
   if (veloxFunction == "lambdafunction") {
     return toLambdaExpr(substraitFunc, inputType);
   } else if (veloxFunction == "namedlambdavariable") {
-    return makeFieldAccessExpr(substraitFunc.arguments(0).value().literal().string(), toVeloxType(typeName), nullptr);
+    return makeFieldAccessExpr(substraitFunc.arguments(0).value().literal().string(), returnType, nullptr);
   } else if (veloxFunction == "extract") {
-    return toExtractExpr(std::move(params), toVeloxType(typeName));
+    return toExtractExpr(std::move(params), returnType);
   } else {
-    return std::make_shared<const core::CallTypedExpr>(toVeloxType(typeName), std::move(params), veloxFunction);
+    return std::make_shared<const core::CallTypedExpr>(returnType, std::move(params), veloxFunction);
+  }
+}
+
+VectorPtr SubstraitVeloxExprConverter::literalsToFlatVector(
+    const TypePtr& type,
+    const std::vector<const ::substrait::Expression::Literal*>& literals) {
+  auto kind = type->kind();
+  if (std::any_of(literals.begin(), literals.end(), [&](const auto* literal) {
+        return !isLiteralOfKind(*literal, kind);
+      })) {
+    return nullptr;
+  }
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return constructFlatVector<TypeKind::BOOLEAN>(literals, type, pool_);
+    case TypeKind::TINYINT:
+      return constructFlatVector<TypeKind::TINYINT>(literals, type, pool_);
+    case TypeKind::SMALLINT:
+      return constructFlatVector<TypeKind::SMALLINT>(literals, type, pool_);
+    case TypeKind::INTEGER:
+      return constructFlatVector<TypeKind::INTEGER>(literals, type, pool_);
+    case TypeKind::BIGINT:
+      return constructFlatVector<TypeKind::BIGINT>(literals, type, pool_);
+    case TypeKind::REAL:
+      return constructFlatVector<TypeKind::REAL>(literals, type, pool_);
+    case TypeKind::DOUBLE:
+      return constructFlatVector<TypeKind::DOUBLE>(literals, type, pool_);
+    case TypeKind::VARCHAR:
+      return constructFlatVector<TypeKind::VARCHAR>(literals, type, pool_);
+    case TypeKind::VARBINARY:
+      return constructFlatVector<TypeKind::VARBINARY>(literals, type, pool_);
+    case TypeKind::DATE:
+      return constructFlatVector<TypeKind::DATE>(literals, type, pool_);
+    case TypeKind::TIMESTAMP:
+      return constructFlatVector<TypeKind::TIMESTAMP>(literals, type, pool_);
+    default:
+      return nullptr;
   }
 }
 
 std::shared_ptr<const core::ConstantTypedExpr> SubstraitVeloxExprConverter::literalsToConstantExpr(
-    const std::vector<::substrait::Expression::Literal>& literals) {
-  std::vector<variant> variants;
-  variants.reserve(literals.size());
-  VELOX_CHECK_GE(literals.size(), 0, "List should have at least one item.");
-  std::optional<TypePtr> literalType = std::nullopt;
-  for (const auto& literal : literals) {
-    auto veloxVariant = toVeloxExpr(literal)->value();
-    if (!literalType.has_value()) {
-      literalType = veloxVariant.inferType();
+    const std::vector<const ::substrait::Expression::Literal*>& literals) {
+  VELOX_CHECK_GT(literals.size(), 0, "List should have at least one item.");
+  ArrayVectorPtr arrayVector;
+  if (!literals[0]->has_null()) {
+    if (auto elements = literalsToFlatVector(toVeloxExpr(*literals[0])->type(), literals)) {
+      arrayVector = makeArrayVector(elements);
+    }
+  }
+  if (arrayVector == nullptr) {
+    // Decimals and the other types the literals are not decoded into directly.
+    std::vector<variant> variants;
+    variants.reserve(literals.size());
+    for (const auto* literal : literals) {
+      variants.emplace_back(toVeloxExpr(*literal)->value());
     }
-    variants.emplace_back(veloxVariant);
+    auto varArray = variant::array(variants);
+    arrayVector = variantArrayToVector(varArray.inferType(), varArray.array(), pool_);
   }
-  VELOX_CHECK(literalType.has_value(), "Type expected.");
-  auto varArray = variant::array(variants);
-  ArrayVectorPtr arrayVector = variantArrayToVector(varArray.inferType(), varArray.array(), pool_);
   // Wrap the array vector into constant vector.
   auto constantVector = BaseVector::wrapInConstant(1 /*length*/, 0 /*index*/, arrayVector);
   return std::make_shared<const core::ConstantTypedExpr>(constantVector);
@@ -314,12 +427,11 @@ core::TypedExprPtr SubstraitVeloxExprConverter::toVeloxExpr(
     const ::substrait::Expression::SingularOrList& singularOrList,
     const RowTypePtr& inputType) {
   VELOX_CHECK(singularOrList.options_size() > 0, "At least one option is expected.");
-  auto options = singularOrList.options();
-  std::vector<::substrait::Expression::Literal> literals;
-  literals.reserve(options.size());
-  for (const auto& option : options) {
+  std::vector<const ::substrait::Expression::Literal*> literals;
+  literals.reserve(singularOrList.options_size());
+  for (const auto& option : singularOrList.options()) {
     VELOX_CHECK(option.has_literal(), "Literal is expected as option.");
-    literals.emplace_back(option.literal());
+    literals.emplace_back(&option.literal());
   }
 
   std::vector<core::TypedExprPtr> params;
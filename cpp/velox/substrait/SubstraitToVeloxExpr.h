@@ -78,7 +78,13 @@ class SubstraitVeloxExprConverter {
   /// Wrap a constant vector from literals with an array vector inside to create
   /// the constant expression.
   std::shared_ptr<const core::ConstantTypedExpr> literalsToConstantExpr(
-      const std::vector<::substrait::Expression::Literal>& literals);
+      const std::vector<const ::substrait::Expression::Literal*>& literals);
+
+  /// Decode the literals straight into a flat vector of the primitive type, without a variant per value. Null if
+  /// the type or a literal needs the variant path, e.g. a decimal.
+  VectorPtr literalsToFlatVector(
+      const TypePtr& type,
+      const std::vector<const ::substrait::Expression::Literal*>& literals);
 
   /// Create expression for lambda.
   std::shared_ptr<const core::ITypedExpr> toLambdaExpr(
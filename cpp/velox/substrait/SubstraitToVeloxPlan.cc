@@ -20,6 +20,9 @@
 #include "VariantToVectorConverter.h"
 #include "velox/type/Type.h"
 
+#include <folly/String.h>
+
+#include "operators/functions/RegistrationAllFunctions.h"
 #include "utils/ConfigExtractor.h"
 
 #include "config/GlutenConfig.h"
@@ -27,6 +30,9 @@
 namespace gluten {
 namespace {
 
+// Whether the summaries of the build side keys sent with a hash join filter the scan of its probe side.
+const std::string kBuildKeyFilterPushdown = "spark.gluten.sql.columnar.backend.velox.buildKeyFilterPushdown";
+
 core::SortOrder toSortOrder(const ::substrait::SortField& sortField) {
   switch (sortField.direction()) {
     case ::substrait::SortField_SortDirection_SORT_DIRECTION_ASC_NULLS_FIRST:
@@ -99,9 +105,36 @@ const std::string sGt = "gt";
 const std::string sLte = "lte";
 const std::string sLt = "lt";
 const std::string sEqual = "equal";
+const std::string sEqualNullSafe = "equal_null_safe";
+const std::string sStartsWith = "starts_with";
+const std::string sLike = "like";
 const std::string sOr = "or";
 const std::string sNot = "not";
 
+// The prefix of a LIKE pattern 'prefix%' without other wildcards or escapes.
+std::optional<std::string> likePrefix(const std::string& pattern) {
+  if (pattern.size() < 2 || pattern.back() != '%') {
+    return std::nullopt;
+  }
+  auto prefix = pattern.substr(0, pattern.size() - 1);
+  if (prefix.find_first_of("%_\\") != std::string::npos) {
+    return std::nullopt;
+  }
+  return prefix;
+}
+
+// The smallest string greater than all those starting with the prefix, none if the prefix is only 0xFF bytes.
+std::optional<std::string> prefixUpperBound(std::string prefix) {
+  while (!prefix.empty() && static_cast<uint8_t>(prefix.back()) == 0xFF) {
+    prefix.pop_back();
+  }
+  if (prefix.empty()) {
+    return std::nullopt;
+  }
+  prefix.back() = static_cast<char>(static_cast<uint8_t>(prefix.back()) + 1);
+  return prefix;
+}
+
 // Substrait types.
 const std::string sI32 = "i32";
 const std::string sI64 = "i64";
@@ -221,9 +254,6 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
     VELOX_FAIL("Right Rel is expected in JoinRel.");
   }
 
-  auto leftNode = toVeloxPlan(sJoin.left());
-  auto rightNode = toVeloxPlan(sJoin.right());
-
   // Map join type.
   core::JoinType joinType;
   bool isNullAwareAntiJoin = false;
@@ -271,12 +301,19 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
       VELOX_NYI("Unsupported Join type: {}", sJoin.type());
   }
 
-  // extract join keys from join expression
+  // extract join keys from join expression, absent for a nested loop join
   std::vector<const ::substrait::Expression::FieldReference*> leftExprs, rightExprs;
-  extractJoinKeys(sJoin.expression(), leftExprs, rightExprs);
+  if (sJoin.has_expression()) {
+    extractJoinKeys(sJoin.expression(), leftExprs, rightExprs);
+  }
   VELOX_CHECK_EQ(leftExprs.size(), rightExprs.size());
   size_t numKeys = leftExprs.size();
 
+  // The probe side scan, if any, picks up the summaries of the build side keys when converted.
+  collectBuildKeyFilters(sJoin, joinType, leftExprs);
+  auto leftNode = toVeloxPlan(sJoin.left());
+  auto rightNode = toVeloxPlan(sJoin.right());
+
   std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>> leftKeys, rightKeys;
   leftKeys.reserve(numKeys);
   rightKeys.reserve(numKeys);
@@ -291,6 +328,12 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
     filter = exprConverter_->toVeloxExpr(sJoin.post_join_filter(), inputRowType);
   }
 
+  if (!sJoin.has_expression()) {
+    // Without join keys, as for BroadcastNestedLoopJoinExec, every pair of rows passing the post join filter joins.
+    return std::make_shared<core::NestedLoopJoinNode>(
+        nextPlanNodeId(), joinType, filter, leftNode, rightNode, getJoinOutputType(leftNode, rightNode, joinType));
+  }
+
   if (sJoin.has_advanced_extension() &&
       SubstraitParser::configSetInOptimization(sJoin.advanced_extension(), "isSMJ=")) {
     // Create MergeJoinNode node
@@ -531,6 +574,7 @@ const core::WindowNode::Frame createWindowFrame(
 }
 
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::WindowRel& windowRel) {
+  ensureWindowFunctionsRegistered();
   core::PlanNodePtr childNode;
   if (windowRel.has_input()) {
     childNode = toVeloxPlan(windowRel.input());
@@ -648,8 +692,126 @@ SubstraitToVeloxPlanConverter::processSortField(
   return {sortingKeys, sortingOrders};
 }
 
+core::PlanNodePtr SubstraitToVeloxPlanConverter::toTopNRowNumber(
+    const ::substrait::FilterRel& filterRel,
+    const core::PlanNodePtr& childNode) {
+  auto windowNode = std::dynamic_pointer_cast<const core::WindowNode>(childNode);
+  if (!windowNode || windowNode->windowFunctions().size() != 1 || windowNode->sortingKeys().empty() ||
+      windowNode->windowFunctions()[0].functionCall->name() != "row_number") {
+    return nullptr;
+  }
+  const auto& windowInput = windowNode->sources()[0];
+  const int32_t rowNumberIdx = windowInput->outputType()->size();
+
+  auto isRowNumber = [&](const ::substrait::Expression& expr) {
+    return expr.has_selection() && expr.selection().has_direct_reference() &&
+        SubstraitParser::parseReferenceSegment(expr.selection().direct_reference()) == rowNumberIdx;
+  };
+  auto toInt = [](const ::substrait::Expression& expr) -> std::optional<int64_t> {
+    if (!expr.has_literal()) {
+      return std::nullopt;
+    }
+    switch (expr.literal().literal_type_case()) {
+      case ::substrait::Expression_Literal::LiteralTypeCase::kI32:
+        return expr.literal().i32();
+      case ::substrait::Expression_Literal::LiteralTypeCase::kI64:
+        return expr.literal().i64();
+      default:
+        return std::nullopt;
+    }
+  };
+
+  // The conjuncts must all bound the row number, the filter is then exactly the one of the TopNRowNumber.
+  std::optional<int64_t> limit;
+  std::vector<const ::substrait::Expression*> conditions = {&filterRel.condition()};
+  while (!conditions.empty()) {
+    const auto* condition = conditions.back();
+    conditions.pop_back();
+    if (!condition->has_scalar_function()) {
+      return nullptr;
+    }
+    const auto& function = condition->scalar_function();
+    auto functionName = SubstraitParser::getSubFunctionName(findFuncSpec(function.function_reference()));
+    const auto& args = function.arguments();
+    if (functionName == "and") {
+      for (const auto& arg : args) {
+        conditions.push_back(&arg.value());
+      }
+      continue;
+    }
+    if (functionName == sIsNotNull && args.size() == 1 && isRowNumber(args[0].value())) {
+      continue;
+    }
+    if (args.size() != 2) {
+      return nullptr;
+    }
+    std::optional<int64_t> value;
+    if (isRowNumber(args[0].value())) {
+      value = toInt(args[1].value());
+    } else if (isRowNumber(args[1].value())) {
+      // K >= row_number() as row_number() <= K.
+      value = toInt(args[0].value());
+      functionName = functionName == sGte ? sLte : functionName == sGt ? sLt : functionName;
+    }
+    if (!value.has_value()) {
+      return nullptr;
+    }
+    int64_t bound;
+    if (functionName == sLte) {
+      bound = *value;
+    } else if (functionName == sLt) {
+      bound = *value - 1;
+    } else if (functionName == sEqual && *value == 1) {
+      bound = 1;
+    } else {
+      return nullptr;
+    }
+    limit = std::min(limit.value_or(bound), bound);
+  }
+  if (!limit.has_value() || *limit <= 0 || *limit > std::numeric_limits<int32_t>::max()) {
+    return nullptr;
+  }
+
+  // In place of the WindowNode, whose metrics it takes.
+  const auto& rowNumberName = windowNode->outputType()->nameOf(rowNumberIdx);
+  auto topNRowNumberNode = std::make_shared<core::TopNRowNumberNode>(
+      windowNode->id(),
+      windowNode->partitionKeys(),
+      windowNode->sortingKeys(),
+      windowNode->sortingOrders(),
+      rowNumberName,
+      static_cast<int32_t>(*limit),
+      windowInput);
+
+  // The row number of TopNRowNumberNode is a BIGINT.
+  const auto& outputType = windowNode->outputType();
+  std::vector<std::string> projectNames;
+  std::vector<core::TypedExprPtr> expressions;
+  projectNames.reserve(outputType->size());
+  expressions.reserve(outputType->size());
+  for (int32_t i = 0; i < outputType->size(); i++) {
+    const auto& topNType = topNRowNumberNode->outputType()->childAt(i);
+    core::TypedExprPtr field = std::make_shared<core::FieldAccessTypedExpr>(topNType, outputType->nameOf(i));
+    if (!topNType->equivalent(*outputType->childAt(i))) {
+      field = std::make_shared<core::CastTypedExpr>(outputType->childAt(i), field, false);
+    }
+    projectNames.emplace_back(outputType->nameOf(i));
+    expressions.emplace_back(std::move(field));
+  }
+  return std::make_shared<core::ProjectNode>(
+      nextPlanNodeId(), std::move(projectNames), std::move(expressions), std::move(topNRowNumberNode));
+}
+
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::FilterRel& filterRel) {
   auto childNode = convertSingleInput<::substrait::FilterRel>(filterRel);
+  if (filterRel.input().has_window()) {
+    if (auto topNRowNumberNode = toTopNRowNumber(filterRel, childNode)) {
+      if (filterRel.has_common()) {
+        return processEmit(filterRel.common(), std::move(topNRowNumberNode));
+      }
+      return topNRowNumberNode;
+    }
+  }
   auto filterNode = std::make_shared<core::FilterNode>(
       nextPlanNodeId(), exprConverter_->toVeloxExpr(filterRel.condition(), childNode->outputType()), childNode);
 
@@ -684,13 +846,13 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   core::PlanNodePtr childNode;
   // Check the input of fetchRel, if it's sortRel, convert them into
   // topNNode. otherwise, to limitNode.
-  ::substrait::SortRel sortRel;
+  const ::substrait::SortRel* sortRel = nullptr;
   bool topNFlag;
   if (fetchRel.has_input()) {
     topNFlag = fetchRel.input().has_sort();
     if (topNFlag) {
-      sortRel = fetchRel.input().sort();
-      childNode = toVeloxPlan(sortRel.input());
+      sortRel = &fetchRel.input().sort();
+      childNode = toVeloxPlan(sortRel->input());
     } else {
       childNode = toVeloxPlan(fetchRel.input());
     }
@@ -699,7 +861,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   }
 
   if (topNFlag) {
-    auto [sortingKeys, sortingOrders] = processSortField(sortRel.sorts(), childNode->outputType());
+    auto [sortingKeys, sortingOrders] = processSortField(sortRel->sorts(), childNode->outputType());
 
     VELOX_CHECK_EQ(fetchRel.offset(), 0);
 
@@ -712,6 +874,45 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   }
 }
 
+std::shared_ptr<SplitInfo> SubstraitToVeloxPlanConverter::parseSplitInfo(const ::substrait::ReadRel& readRel) {
+  auto splitInfo = std::make_shared<SplitInfo>();
+  using SubstraitFileFormatCase = ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
+  const auto& fileList = readRel.local_files().items();
+  splitInfo->paths.reserve(fileList.size());
+  splitInfo->starts.reserve(fileList.size());
+  splitInfo->lengths.reserve(fileList.size());
+  splitInfo->partitionColumns.reserve(fileList.size());
+  for (const auto& file : fileList) {
+    // Expect all Partitions share the same index.
+    splitInfo->partitionIndex = file.partition_index();
+
+    std::unordered_map<std::string, std::string> partitionColumnMap;
+    for (const auto& partitionColumn : file.partition_columns()) {
+      partitionColumnMap[partitionColumn.key()] = partitionColumn.value();
+    }
+    splitInfo->partitionColumns.emplace_back(partitionColumnMap);
+
+    splitInfo->paths.emplace_back(file.uri_file());
+    splitInfo->starts.emplace_back(file.start());
+    splitInfo->lengths.emplace_back(file.length());
+    switch (file.file_format_case()) {
+      case SubstraitFileFormatCase::kOrc:
+        splitInfo->format = dwio::common::FileFormat::ORC;
+        break;
+      case SubstraitFileFormatCase::kDwrf:
+        splitInfo->format = dwio::common::FileFormat::DWRF;
+        break;
+      case SubstraitFileFormatCase::kParquet:
+        splitInfo->format = dwio::common::FileFormat::PARQUET;
+        break;
+      default:
+        splitInfo->format = dwio::common::FileFormat::UNKNOWN;
+        break;
+    }
+  }
+  return splitInfo;
+}
+
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::ReadRel& readRel) {
   // emit is not allowed in TableScanNode and ValuesNode related
   // outputs
@@ -761,40 +962,8 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
 
   // Parse local files and construct split info.
   if (readRel.has_local_files()) {
-    using SubstraitFileFormatCase = ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
-    const auto& fileList = readRel.local_files().items();
-    splitInfo->paths.reserve(fileList.size());
-    splitInfo->starts.reserve(fileList.size());
-    splitInfo->lengths.reserve(fileList.size());
-    splitInfo->partitionColumns.reserve(fileList.size());
-    for (const auto& file : fileList) {
-      // Expect all Partitions share the same index.
-      splitInfo->partitionIndex = file.partition_index();
-
-      std::unordered_map<std::string, std::string> partitionColumnMap;
-      for (const auto& partitionColumn : file.partition_columns()) {
-        partitionColumnMap[partitionColumn.key()] = partitionColumn.value();
-      }
-      splitInfo->partitionColumns.emplace_back(partitionColumnMap);
-
-      splitInfo->paths.emplace_back(file.uri_file());
-      splitInfo->starts.emplace_back(file.start());
-      splitInfo->lengths.emplace_back(file.length());
-      switch (file.file_format_case()) {
-        case SubstraitFileFormatCase::kOrc:
-          splitInfo->format = dwio::common::FileFormat::ORC;
-          break;
-        case SubstraitFileFormatCase::kDwrf:
-          splitInfo->format = dwio::common::FileFormat::DWRF;
-          break;
-        case SubstraitFileFormatCase::kParquet:
-          splitInfo->format = dwio::common::FileFormat::PARQUET;
-          break;
-        default:
-          splitInfo->format = dwio::common::FileFormat::UNKNOWN;
-          break;
-      }
-
+    splitInfo = parseSplitInfo(readRel);
+    if (!splitInfo->paths.empty()) {
       fileFormat_ = splitInfo->format;
     }
   }
@@ -805,8 +974,10 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   bool filterPushdownEnabled = true;
   std::shared_ptr<connector::hive::HiveTableHandle> tableHandle;
   if (!readRel.has_filter()) {
+    connector::hive::SubfieldFilters subfieldFilters;
+    addBuildKeyFilters(readRel, colNameList, veloxTypeList, subfieldFilters);
     tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
-        kHiveConnectorId, "hive_table", filterPushdownEnabled, connector::hive::SubfieldFilters{}, nullptr);
+        kHiveConnectorId, "hive_table", filterPushdownEnabled, std::move(subfieldFilters), nullptr);
   } else {
     // Flatten the conditions connected with 'and'.
     std::vector<::substrait::Expression_ScalarFunction> scalarFunctions;
@@ -848,6 +1019,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
       remainingFilter = connectWithAnd(colNameList, veloxTypeList, scalarFunctions, singularOrLists, ifThens);
     } else {
       remainingFilter = connectWithAnd(colNameList, veloxTypeList, remainingFunctions, remainingrOrLists, ifThens);
+      addBuildKeyFilters(readRel, colNameList, veloxTypeList, subfieldFilters);
     }
 
     tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
@@ -875,6 +1047,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
         nextPlanNodeId(), std::move(outputType), std::move(tableHandle), std::move(assignments));
     // Set split info map.
     splitInfoMap_[tableScanNode->id()] = splitInfo;
+    scanNodeIds_[&readRel] = tableScanNode->id();
     return tableScanNode;
   }
 }
@@ -882,7 +1055,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(
     const ::substrait::ReadRel& readRel,
     const RowTypePtr& type) {
-  ::substrait::ReadRel_VirtualTable readVirtualTable = readRel.virtual_table();
+  const auto& readVirtualTable = readRel.virtual_table();
   int64_t numVectors = readVirtualTable.values_size();
   int64_t numColumns = type->size();
   int64_t valueFieldNums = readVirtualTable.values(numVectors - 1).fields_size();
@@ -899,20 +1072,26 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(
 
   for (int64_t index = 0; index < numVectors; ++index) {
     std::vector<VectorPtr> children;
-    ::substrait::Expression_Literal_Struct rowValue = readRel.virtual_table().values(index);
+    const auto& rowValue = readVirtualTable.values(index);
     auto fieldSize = rowValue.fields_size();
     VELOX_CHECK_EQ(fieldSize, batchSize * numColumns);
 
     for (int64_t col = 0; col < numColumns; ++col) {
       const TypePtr& outputChildType = type->childAt(col);
-      std::vector<variant> batchChild;
-      batchChild.reserve(batchSize);
+      std::vector<const ::substrait::Expression_Literal*> fields;
+      fields.reserve(batchSize);
       for (int64_t batchId = 0; batchId < batchSize; batchId++) {
-        // each value in the batch
-        auto fieldIdx = col * batchSize + batchId;
-        ::substrait::Expression_Literal field = rowValue.fields(fieldIdx);
+        fields.emplace_back(&rowValue.fields(col * batchSize + batchId));
+      }
+      if (auto child = exprConverter_->literalsToFlatVector(outputChildType, fields)) {
+        children.emplace_back(std::move(child));
+        continue;
+      }
 
-        auto expr = exprConverter_->toVeloxExpr(field);
+      std::vector<variant> batchChild;
+      batchChild.reserve(batchSize);
+      for (const auto* field : fields) {
+        auto expr = exprConverter_->toVeloxExpr(*field);
         if (auto constantExpr = std::dynamic_pointer_cast<const core::ConstantTypedExpr>(expr)) {
           if (!constantExpr->hasValueVector()) {
             batchChild.emplace_back(constantExpr->value());
@@ -1107,6 +1286,138 @@ void SubstraitToVeloxPlanConverter::extractJoinKeys(
   }
 }
 
+void SubstraitToVeloxPlanConverter::collectBuildKeyFilters(
+    const ::substrait::JoinRel& sJoin,
+    core::JoinType joinType,
+    const std::vector<const ::substrait::Expression::FieldReference*>& leftExprs) {
+  if (!sJoin.has_advanced_extension() || !folly::to<bool>(getConfigValue(confMap_, kBuildKeyFilterPushdown, "true"))) {
+    return;
+  }
+  // Only the joins dropping the probe rows without a match, the right side being the build side.
+  switch (joinType) {
+    case core::JoinType::kInner:
+    case core::JoinType::kLeftSemiFilter:
+    case core::JoinType::kRight:
+    case core::JoinType::kRightSemiFilter:
+    case core::JoinType::kRightSemiProject:
+      break;
+    default:
+      return;
+  }
+  // The columns of the probe side pass through filters unchanged.
+  const auto* rel = &sJoin.left();
+  while (rel->has_filter() && !rel->filter().common().has_emit() && rel->filter().has_input()) {
+    rel = &rel->filter().input();
+  }
+  if (!rel->has_read() || rel->read().common().has_emit() || !rel->read().has_base_schema()) {
+    return;
+  }
+  const auto& readRel = rel->read();
+  const auto numColumns = readRel.base_schema().names_size();
+  const auto& extension = sJoin.advanced_extension();
+  for (size_t i = 0; i < leftExprs.size(); ++i) {
+    if (!leftExprs[i]->has_direct_reference()) {
+      continue;
+    }
+    auto colIdx = SubstraitParser::parseReferenceSegment(leftExprs[i]->direct_reference());
+    if (colIdx < 0 || colIdx >= numColumns) {
+      continue;
+    }
+    auto range = SubstraitParser::getConfigInOptimization(extension, fmt::format("buildKeyRange{}=", i));
+    auto values = SubstraitParser::getConfigInOptimization(extension, fmt::format("buildKeyValues{}=", i));
+    if (range.has_value() || values.has_value()) {
+      buildKeyFilters_[&readRel][colIdx] = {std::move(range), std::move(values)};
+    }
+  }
+}
+
+namespace {
+// Null if the summary doesn't fit the type of the key.
+std::unique_ptr<common::Filter> makeBuildKeyFilter(
+    const TypePtr& type,
+    const std::optional<std::string>& range,
+    const std::optional<std::string>& values) {
+  // Null keys never match, the build side having no key the probe rows can be dropped altogether.
+  constexpr bool nullAllowed = false;
+  std::vector<folly::StringPiece> pieces;
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::DATE: {
+      // The IN-list is at least as selective as the range.
+      if (values.has_value()) {
+        if (values->empty()) {
+          return std::make_unique<common::AlwaysFalse>();
+        }
+        folly::split(',', *values, pieces);
+        std::vector<int64_t> bigints;
+        bigints.reserve(pieces.size());
+        for (const auto& piece : pieces) {
+          bigints.emplace_back(folly::to<int64_t>(piece));
+        }
+        return common::createBigintValues(bigints, nullAllowed);
+      }
+      folly::split(',', *range, pieces);
+      if (pieces.size() != 2) {
+        return nullptr;
+      }
+      return std::make_unique<common::BigintRange>(
+          folly::to<int64_t>(pieces[0]), folly::to<int64_t>(pieces[1]), nullAllowed);
+    }
+    case TypeKind::VARCHAR: {
+      if (!values.has_value()) {
+        return nullptr;
+      }
+      if (values->empty()) {
+        return std::make_unique<common::AlwaysFalse>();
+      }
+      // Hex encoded, the keys may hold the separator.
+      folly::split(',', *values, pieces);
+      std::vector<std::string> strings;
+      strings.reserve(pieces.size());
+      for (const auto& piece : pieces) {
+        std::string value;
+        VELOX_CHECK(folly::unhexlify(piece, value), "Invalid build key value: {}", piece);
+        strings.emplace_back(std::move(value));
+      }
+      return std::make_unique<common::BytesValues>(strings, nullAllowed);
+    }
+    default:
+      return nullptr;
+  }
+}
+} // namespace
+
+void SubstraitToVeloxPlanConverter::addBuildKeyFilters(
+    const ::substrait::ReadRel& readRel,
+    const std::vector<std::string>& inputNameList,
+    const std::vector<TypePtr>& inputTypeList,
+    connector::hive::SubfieldFilters& filters) {
+  auto it = buildKeyFilters_.find(&readRel);
+  if (it == buildKeyFilters_.end()) {
+    return;
+  }
+  for (const auto& [colIdx, summary] : it->second) {
+    if (colIdx >= static_cast<int32_t>(inputTypeList.size())) {
+      continue;
+    }
+    auto filter = makeBuildKeyFilter(inputTypeList[colIdx], summary.range, summary.values);
+    if (filter == nullptr) {
+      continue;
+    }
+    common::Subfield subfield(inputNameList[colIdx], true);
+    auto existing = filters.find(subfield);
+    if (existing == filters.end()) {
+      filters[std::move(subfield)] = std::move(filter);
+    } else {
+      existing->second = existing->second->mergeWith(filter.get());
+    }
+  }
+  buildKeyFilters_.erase(it);
+}
+
 connector::hive::SubfieldFilters SubstraitToVeloxPlanConverter::createSubfieldFilters(
     const std::vector<std::string>& inputNameList,
     const std::vector<TypePtr>& inputTypeList,
@@ -1242,15 +1553,32 @@ bool SubstraitToVeloxPlanConverter::canPushdownCommonFunction(
     const std::string& filterName,
     uint32_t& fieldIdx) {
   // Condtions can be pushed down.
-  static const std::unordered_set<std::string> supportedCommonFunctions = {sIsNotNull, sGte, sGt, sLte, sLt, sEqual};
+  static const std::unordered_set<std::string> supportedCommonFunctions = {
+      sIsNotNull, sGte, sGt, sLte, sLt, sEqual, sEqualNullSafe, sStartsWith, sLike};
 
-  bool canPushdown = false;
-  if (supportedCommonFunctions.find(filterName) != supportedCommonFunctions.end() &&
-      fieldOrWithLiteral(scalarFunction.arguments(), fieldIdx)) {
+  if (supportedCommonFunctions.find(filterName) == supportedCommonFunctions.end() ||
+      !fieldOrWithLiteral(scalarFunction.arguments(), fieldIdx)) {
     // The arg should be field or field with literal.
-    canPushdown = true;
+    return false;
   }
-  return canPushdown;
+
+  const auto& arguments = scalarFunction.arguments();
+  if (filterName == sEqualNullSafe) {
+    // Equal to a non-null literal, x <=> null is x is null.
+    for (const auto& arg : arguments) {
+      if (arg.value().has_literal() && arg.value().literal().has_null()) {
+        return false;
+      }
+    }
+  } else if (filterName == sStartsWith || filterName == sLike) {
+    // A string range, for a string field and a non-empty prefix.
+    if (!arguments[0].value().has_selection() || !arguments[1].value().literal().has_string()) {
+      return false;
+    }
+    const auto& literal = arguments[1].value().literal().string();
+    return filterName == sStartsWith ? !literal.empty() : likePrefix(literal).has_value();
+  }
+  return true;
 }
 
 bool SubstraitToVeloxPlanConverter::canPushdownNot(
@@ -1400,6 +1728,13 @@ bool SubstraitToVeloxPlanConverter::RangeRecorder::setCertainRangeForFunction(
     } else {
       return setLeftBound(forOrRelation) && setRightBound(forOrRelation);
     }
+  } else if (functionName == sEqualNullSafe || functionName == sStartsWith || functionName == sLike) {
+    if (reverse || forOrRelation) {
+      // Not supported, not(x <=> v) keeps the nulls.
+      return false;
+    } else {
+      return setLeftBound() && setRightBound();
+    }
   } else if (functionName == sOr) {
     if (reverse) {
       // Not supported.
@@ -1455,13 +1790,27 @@ void SubstraitToVeloxPlanConverter::setColumnFilterInfo(
     } else {
       columnToFilterInfo[colIdx].setUpper(literalVariant, true);
     }
-  } else if (filterName == sEqual) {
+  } else if (filterName == sEqual || filterName == sEqualNullSafe) {
     if (reverse) {
+      VELOX_CHECK(filterName == sEqual, "Reverse not supported for filter name '{}'", filterName);
       columnToFilterInfo[colIdx].setNotValue(literalVariant);
     } else {
       columnToFilterInfo[colIdx].setLower(literalVariant, false);
       columnToFilterInfo[colIdx].setUpper(literalVariant, false);
     }
+  } else if (filterName == sStartsWith || filterName == sLike) {
+    if (reverse) {
+      VELOX_NYI("Reverse not supported for filter name '{}'", filterName);
+    }
+    // The strings in [prefix, upper bound of the prefix).
+    auto prefix = literalVariant.value().value<std::string>();
+    if (filterName == sLike) {
+      prefix = likePrefix(prefix).value();
+    }
+    columnToFilterInfo[colIdx].setLower(variant(prefix), false);
+    if (auto upper = prefixUpperBound(prefix)) {
+      columnToFilterInfo[colIdx].setUpper(variant(upper.value()), true);
+    }
   } else {
     VELOX_NYI("setColumnFilterInfo not supported for filter name '{}'", filterName);
   }
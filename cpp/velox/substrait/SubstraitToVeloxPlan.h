@@ -74,6 +74,11 @@ class SubstraitToVeloxPlanConverter {
   /// Convert Substrait FilterRel into Velox PlanNode.
   core::PlanNodePtr toVeloxPlan(const ::substrait::FilterRel& filterRel);
 
+  /// Convert a FilterRel bounding row_number() of its child WindowNode into a TopNRowNumberNode, which keeps no more
+  /// than the bound number of rows per partition, with a ProjectNode casting the row number to the window type.
+  /// Returns nullptr if the FilterRel is not of that pattern.
+  core::PlanNodePtr toTopNRowNumber(const ::substrait::FilterRel& filterRel, const core::PlanNodePtr& childNode);
+
   /// Convert Substrait FetchRel into Velox LimitNode or TopNNode according the
   /// different input of fetchRel.
   core::PlanNodePtr toVeloxPlan(const ::substrait::FetchRel& fetchRel);
@@ -119,6 +124,15 @@ class SubstraitToVeloxPlanConverter {
     return splitInfoMap_;
   }
 
+  /// Return the id of the TableScanNode converted from each ReadRel of the plan, to bind the splits of another plan
+  /// of the same shape to the converted plan.
+  const std::unordered_map<const ::substrait::ReadRel*, core::PlanNodeId>& scanNodeIds() const {
+    return scanNodeIds_;
+  }
+
+  /// Parse the files of the ReadRel to be scanned.
+  static std::shared_ptr<SplitInfo> parseSplitInfo(const ::substrait::ReadRel& readRel);
+
   /// Used to insert certain plan node as input. The plan node
   /// id will start from the setted one.
   void insertInputNode(uint64_t inputIdx, const std::shared_ptr<const core::PlanNode>& inputNode, int planNodeId) {
@@ -453,6 +467,21 @@ class SubstraitToVeloxPlanConverter {
       const std::vector<::substrait::Expression_ScalarFunction>& subfieldFunctions,
       const std::vector<::substrait::Expression_SingularOrList>& singularOrLists);
 
+  /// Record the summaries of the build side keys in the JoinRel, for the scan of the probe side to filter on. The
+  /// optimization of the JoinRel may carry, for the i-th key, "buildKeyRange<i>=<min>,<max>" and
+  /// "buildKeyValues<i>=<value>,...", the values in decimal, or in hex for strings.
+  void collectBuildKeyFilters(
+      const ::substrait::JoinRel& sJoin,
+      core::JoinType joinType,
+      const std::vector<const ::substrait::Expression::FieldReference*>& leftExprs);
+
+  /// Add the filters of the build side keys recorded for the ReadRel to its subfield filters.
+  void addBuildKeyFilters(
+      const ::substrait::ReadRel& readRel,
+      const std::vector<std::string>& inputNameList,
+      const std::vector<TypePtr>& inputTypeList,
+      connector::hive::SubfieldFilters& filters);
+
   /// Connect all remaining functions with 'and' relation
   /// for the use of remaingFilter in Hive Connector.
   core::TypedExprPtr connectWithAnd(
@@ -474,7 +503,7 @@ class SubstraitToVeloxPlanConverter {
 
   /// Helper function to convert the input of Substrait Rel to Velox Node.
   template <typename T>
-  core::PlanNodePtr convertSingleInput(T rel) {
+  core::PlanNodePtr convertSingleInput(const T& rel) {
     VELOX_CHECK(rel.has_input(), "Child Rel is expected here.");
     return toVeloxPlan(rel.input());
   }
@@ -492,6 +521,18 @@ class SubstraitToVeloxPlanConverter {
   /// The map storing the split stats for each PlanNode.
   std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfoMap_;
 
+  /// The TableScanNode id of each converted ReadRel.
+  std::unordered_map<const ::substrait::ReadRel*, core::PlanNodeId> scanNodeIds_;
+
+  /// The summary of the build side values of a join key.
+  struct BuildKeySummary {
+    std::optional<std::string> range;
+    std::optional<std::string> values;
+  };
+
+  /// The build key summaries to filter each ReadRel on, by the column index.
+  std::unordered_map<const ::substrait::ReadRel*, std::unordered_map<int32_t, BuildKeySummary>> buildKeyFilters_;
+
   /// The map storing the pre-built plan nodes which can be accessed through
   /// index. This map is only used when the computation of a Substrait plan
   /// depends on other input nodes.
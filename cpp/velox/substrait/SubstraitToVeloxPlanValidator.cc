@@ -16,10 +16,16 @@
  */
 
 #include "SubstraitToVeloxPlanValidator.h"
+#include <folly/container/EvictingCacheMap.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/wrappers.pb.h>
 #include <re2/re2.h>
+#include <map>
+#include <mutex>
 #include <string>
 #include "TypeUtils.h"
+#include "operators/functions/RegistrationAllFunctions.h"
 #include "utils/Common.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/SignatureBinder.h"
@@ -69,8 +75,77 @@ bool validateColNames(const ::substrait::NamedStruct& schema) {
   return true;
 }
 
+struct ValidationResult {
+  bool supported;
+  std::vector<std::string> logs;
+};
+
+// Validation results of the rel subtrees seen by the validators of the process.
+class ValidationCache {
+ public:
+  static ValidationCache* instance() {
+    static ValidationCache cache;
+    return &cache;
+  }
+
+  void setCapacity(int32_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = std::max(0, capacity);
+    results_.setMaxSize(capacity_);
+  }
+
+  bool enabled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_ > 0;
+  }
+
+  std::optional<ValidationResult> get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = results_.find(key);
+    if (it == results_.end()) {
+      return std::nullopt;
+    }
+    numHits_++;
+    return it->second;
+  }
+
+  void put(const std::string& key, ValidationResult result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ > 0) {
+      results_.set(key, std::move(result));
+    }
+  }
+
+  int64_t numHits() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numHits_;
+  }
+
+ private:
+  std::mutex mutex_;
+  int32_t capacity_ = 0;
+  // Capacity 0 means unlimited to EvictingCacheMap, so it's only used while capacity_ is positive.
+  folly::EvictingCacheMap<std::string, ValidationResult> results_{1};
+  int64_t numHits_ = 0;
+};
+
+void appendSerialized(const google::protobuf::Message& message, std::string* out) {
+  google::protobuf::io::StringOutputStream stream(out);
+  google::protobuf::io::CodedOutputStream output(&stream);
+  output.SetSerializationDeterministic(true);
+  message.SerializeToCodedStream(&output);
+}
+
 } // namespace
 
+void SubstraitToVeloxPlanValidator::setCacheCapacity(int32_t capacity) {
+  ValidationCache::instance()->setCapacity(capacity);
+}
+
+int64_t SubstraitToVeloxPlanValidator::numCacheHits() {
+  return ValidationCache::instance()->numHits();
+}
+
 bool SubstraitToVeloxPlanValidator::validateInputTypes(
     const ::substrait::extensions::AdvancedExtension& extension,
     std::vector<TypePtr>& types) {
@@ -418,6 +493,7 @@ bool validateBoundType(::substrait::Expression_WindowFunction_Bound boundType) {
 }
 
 bool SubstraitToVeloxPlanValidator::validate(const ::substrait::WindowRel& windowRel) {
+  ensureWindowFunctionsRegistered();
   if (windowRel.has_input() && !validate(windowRel.input())) {
     logValidateMsg("native validation failed due to: windowRel input fails to validate. ");
     return false;
@@ -745,6 +821,19 @@ bool SubstraitToVeloxPlanValidator::validate(const ::substrait::JoinRel& joinRel
         return false;
     }
   }
+  if (!joinRel.has_expression()) {
+    switch (joinRel.type()) {
+      case ::substrait::JoinRel_JoinType_JOIN_TYPE_INNER:
+      case ::substrait::JoinRel_JoinType_JOIN_TYPE_OUTER:
+      case ::substrait::JoinRel_JoinType_JOIN_TYPE_LEFT:
+      case ::substrait::JoinRel_JoinType_JOIN_TYPE_RIGHT:
+        break;
+      default:
+        logValidateMsg(
+            "native validation failed due to: Nested loop join only support inner, left, right and full join");
+        return false;
+    }
+  }
   switch (joinRel.type()) {
     case ::substrait::JoinRel_JoinType_JOIN_TYPE_INNER:
     case ::substrait::JoinRel_JoinType_JOIN_TYPE_OUTER:
@@ -1115,6 +1204,24 @@ bool SubstraitToVeloxPlanValidator::validate(const ::substrait::ReadRel& readRel
 }
 
 bool SubstraitToVeloxPlanValidator::validate(const ::substrait::Rel& rel) {
+  auto* cache = ValidationCache::instance();
+  if (!cache->enabled()) {
+    return validateRel(rel);
+  }
+  // The result of a subtree only depends on it and on the functions its anchors refer to.
+  std::string key = functionMapKey_;
+  appendSerialized(rel, &key);
+  if (auto result = cache->get(key)) {
+    validateLog_.insert(validateLog_.end(), result->logs.begin(), result->logs.end());
+    return result->supported;
+  }
+  auto numLogs = validateLog_.size();
+  auto supported = validateRel(rel);
+  cache->put(key, {supported, std::vector<std::string>(validateLog_.begin() + numLogs, validateLog_.end())});
+  return supported;
+}
+
+bool SubstraitToVeloxPlanValidator::validateRel(const ::substrait::Rel& rel) {
   if (rel.has_aggregate()) {
     return validate(rel.aggregate());
   } else if (rel.has_project()) {
@@ -1150,6 +1257,12 @@ bool SubstraitToVeloxPlanValidator::validate(const ::substrait::Plan& plan) {
   // Create plan converter and expression converter to help the validation.
   planConverter_.constructFunctionMap(plan);
   exprConverter_ = planConverter_.getExprConverter();
+  functionMapKey_.clear();
+  for (const auto& [anchor, name] : std::map<uint64_t, std::string>(
+           planConverter_.getFunctionMap().begin(), planConverter_.getFunctionMap().end())) {
+    functionMapKey_.append(std::to_string(anchor)).append("=").append(name).push_back('\0');
+  }
+  functionMapKey_.push_back('\0');
 
   for (const auto& rel : plan.relations()) {
     if (rel.has_root()) {
@@ -74,6 +74,12 @@ class SubstraitToVeloxPlanValidator {
     }
   }
 
+  /// Number of rel subtree results kept across validators, the least recently used one is evicted beyond. 0
+  /// disables the cache.
+  static void setCacheCapacity(int32_t capacity);
+
+  static int64_t numCacheHits();
+
  private:
   /// A memory pool used for function validation.
   memory::MemoryPool* pool_;
@@ -93,6 +99,12 @@ class SubstraitToVeloxPlanValidator {
 
   std::vector<std::string> validateLog_;
 
+  /// The functions of the plan by their anchors, part of the cache key of its rels.
+  std::string functionMapKey_;
+
+  /// Validates the rel without the cache.
+  bool validateRel(const ::substrait::Rel& rel);
+
   /// Used to get types from advanced extension and validate them.
   bool validateInputTypes(const ::substrait::extensions::AdvancedExtension& extension, std::vector<TypePtr>& types);
 
@@ -0,0 +1,140 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <future>
+#include <limits>
+#include <thread>
+
+#include "operators/writer/AsyncDataSink.h"
+#include "velox/common/memory/Memory.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace gluten {
+
+namespace {
+// Appends what is written to data, after the gate opens if there is one.
+class RecordingSink final : public DataSink {
+ public:
+  explicit RecordingSink(std::string& data, std::shared_future<void> gate = {})
+      : DataSink("recording"), data_(data), gate_(std::move(gate)) {}
+
+  void write(std::vector<DataBuffer<char>>& buffers) override {
+    if (gate_.valid()) {
+      gate_.wait();
+    }
+    if (data_.size() >= failAfterBytes) {
+      throw std::runtime_error("sink failed");
+    }
+    for (auto& buffer : buffers) {
+      data_.append(buffer.data(), buffer.size());
+    }
+    buffers.clear();
+  }
+
+  size_t failAfterBytes = std::numeric_limits<size_t>::max();
+  bool closed = false;
+
+ protected:
+  void doClose() override {
+    closed = true;
+  }
+
+ private:
+  std::string& data_;
+  std::shared_future<void> gate_;
+};
+} // namespace
+
+class AsyncDataSinkTest : public ::testing::Test {
+ protected:
+  std::vector<DataBuffer<char>> buffers(const std::string& data) {
+    std::vector<DataBuffer<char>> result;
+    result.emplace_back(*pool_, data.size());
+    std::memcpy(result.back().data(), data.data(), data.size());
+    return result;
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_ = memory::addDefaultLeafMemoryPool();
+};
+
+TEST_F(AsyncDataSinkTest, writesInOrder) {
+  std::string data;
+  auto recording = std::make_unique<RecordingSink>(data);
+  auto* sink = recording.get();
+  AsyncDataSink async(std::move(recording), "async", 16, 2);
+  std::string expected;
+  for (int i = 0; i < 100; ++i) {
+    auto chunk = "chunk" + std::to_string(i) + ";";
+    auto flushed = buffers(chunk);
+    async.write(flushed);
+    ASSERT_TRUE(flushed.empty());
+    expected += chunk;
+  }
+  async.close();
+  ASSERT_TRUE(sink->closed);
+  ASSERT_EQ(data, expected);
+  ASSERT_EQ(async.size(), expected.size());
+}
+
+TEST_F(AsyncDataSinkTest, boundsBufferedBytes) {
+  std::string data;
+  std::promise<void> open;
+  AsyncDataSink async(std::make_unique<RecordingSink>(data, open.get_future().share()), "async", 8, 2);
+
+  // Taken while the sink is blocked, up to the limit.
+  auto first = buffers("12345678");
+  async.write(first);
+  auto blocked = std::async(std::launch::async, [&]() {
+    auto second = buffers("abcd");
+    async.write(second);
+  });
+  ASSERT_EQ(blocked.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+
+  open.set_value();
+  blocked.get();
+  async.close();
+  ASSERT_EQ(data, "12345678abcd");
+}
+
+TEST_F(AsyncDataSinkTest, rethrowsSinkError) {
+  std::string data;
+  auto recording = std::make_unique<RecordingSink>(data);
+  recording->failAfterBytes = 4;
+  AsyncDataSink async(std::move(recording), "async", 1 << 20, 2);
+
+  auto ok = buffers("1234");
+  async.write(ok);
+  auto failing = buffers("5678");
+  async.write(failing);
+  // Raised by a later write or by close, once the sink failed.
+  ASSERT_ANY_THROW({
+    for (int i = 0; i < 100; ++i) {
+      auto more = buffers("x");
+      async.write(more);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    async.close();
+  });
+  ASSERT_EQ(data, "1234");
+}
+
+} // namespace gluten
@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "compute/CacheAdmissionPolicy.h"
+#include "utils/exception.h"
+
+namespace gluten {
+
+using Mode = CacheAdmissionPolicy::Mode;
+
+TEST(CacheAdmissionPolicyTest, admitOnSecondAccess) {
+  CacheAdmissionPolicy policy;
+  policy.configure(2, 1024);
+  ASSERT_FALSE(policy.admit(Mode::kFrequency, {"hot"}, {100}));
+  ASSERT_TRUE(policy.admit(Mode::kFrequency, {"hot"}, {100}));
+  ASSERT_EQ(policy.frequency("hot"), 2);
+
+  // By the bytes of the frequent files.
+  ASSERT_TRUE(policy.admit(Mode::kFrequency, {"hot", "cold0"}, {100, 100}));
+  ASSERT_FALSE(policy.admit(Mode::kFrequency, {"hot", "cold1", "cold2"}, {100, 100, 100}));
+
+  ASSERT_TRUE(policy.admit(Mode::kAll, {"cold3"}, {100}));
+  ASSERT_FALSE(policy.admit(Mode::kNone, {"hot"}, {100}));
+  ASSERT_THROW(CacheAdmissionPolicy::parseMode("lru"), GlutenException);
+}
+
+TEST(CacheAdmissionPolicyTest, scanDoesNotEvictFrequentFiles) {
+  CacheAdmissionPolicy policy;
+  policy.configure(2, 1024);
+  for (int i = 0; i < 4; ++i) {
+    policy.admit(Mode::kFrequency, {"dashboard"}, {100});
+  }
+  // A scan of many files read once, they don't cache and the old counts fade out.
+  int admitted = 0;
+  for (int i = 0; i < 20000; ++i) {
+    admitted += policy.admit(Mode::kFrequency, {"etl" + std::to_string(i)}, {100});
+  }
+  ASSERT_LT(admitted, 2000);
+  ASSERT_LE(policy.frequency("dashboard"), 1);
+  policy.admit(Mode::kFrequency, {"dashboard"}, {100});
+  ASSERT_TRUE(policy.admit(Mode::kFrequency, {"dashboard"}, {100}));
+}
+
+} // namespace gluten
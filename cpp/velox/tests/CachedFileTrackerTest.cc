@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "compute/CachedFileTracker.h"
+
+namespace gluten {
+
+TEST(CachedFileTrackerTest, evictsLeastRecentlyRead) {
+  CachedFileTracker tracker;
+  ASSERT_FALSE(tracker.enabled());
+  tracker.record("a");
+  ASSERT_TRUE(tracker.files().empty());
+
+  tracker.setCapacity(2);
+  tracker.record("a");
+  tracker.record("b");
+  auto version = tracker.version();
+  tracker.record("a");
+  // Reading a tracked file again changes the order but not the files.
+  ASSERT_EQ(tracker.version(), version);
+  ASSERT_EQ(tracker.files(), (std::vector<std::string>{"a", "b"}));
+  tracker.record("c");
+  ASSERT_NE(tracker.version(), version);
+  ASSERT_EQ(tracker.files(), (std::vector<std::string>{"c", "a"}));
+
+  tracker.setCapacity(1);
+  ASSERT_EQ(tracker.files(), (std::vector<std::string>{"c"}));
+}
+
+} // namespace gluten
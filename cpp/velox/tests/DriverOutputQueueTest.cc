@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "compute/WholeStageResultIterator.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+class DriverOutputQueueTest : public ::testing::Test, public test::VectorTestBase {
+ protected:
+  RowVectorPtr makeInput(int32_t value) {
+    return makeRowVector({makeFlatVector<int32_t>({value})});
+  }
+};
+
+TEST_F(DriverOutputQueueTest, mergeProducers) {
+  DriverOutputQueue queue(2);
+  ContinueFuture future = ContinueFuture::makeEmpty();
+  ASSERT_EQ(queue.enqueue(makeInput(1), &future), exec::BlockingReason::kNotBlocked);
+  // Full, the producer waits for the consumer.
+  ASSERT_EQ(queue.enqueue(makeInput(2), &future), exec::BlockingReason::kWaitForConsumer);
+  ASSERT_FALSE(future.isReady());
+  ASSERT_EQ(queue.enqueue(nullptr, nullptr), exec::BlockingReason::kNotBlocked);
+  queue.setNumProducers(2);
+
+  ASSERT_EQ(queue.dequeue()->childAt(0)->asFlatVector<int32_t>()->valueAt(0), 1);
+  ASSERT_TRUE(future.isReady());
+  ASSERT_EQ(queue.dequeue()->childAt(0)->asFlatVector<int32_t>()->valueAt(0), 2);
+
+  std::thread producer([&]() { queue.enqueue(nullptr, nullptr); });
+  // Blocks until the last producer is done.
+  ASSERT_EQ(queue.dequeue(), nullptr);
+  producer.join();
+}
+
+TEST_F(DriverOutputQueueTest, closeWithError) {
+  DriverOutputQueue queue(1);
+  queue.setNumProducers(1);
+  ContinueFuture future = ContinueFuture::makeEmpty();
+  ASSERT_EQ(queue.enqueue(makeInput(1), &future), exec::BlockingReason::kWaitForConsumer);
+  queue.close(std::make_exception_ptr(std::runtime_error("driver failed")));
+  ASSERT_TRUE(future.isReady());
+  // The output produced before the error is still returned.
+  ASSERT_NE(queue.dequeue(), nullptr);
+  ASSERT_THROW(queue.dequeue(), std::runtime_error);
+  // Dropped after closing.
+  ASSERT_EQ(queue.enqueue(makeInput(2), &future), exec::BlockingReason::kNotBlocked);
+}
+
+} // namespace gluten
@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/ExecutorMemoryArbitrator.h"
+#include "memory/VeloxMemoryPool.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+namespace {
+class FakeParticipant : public ArbitrationParticipant {
+ public:
+  explicit FakeParticipant(int64_t bytes, bool fail = false) : bytes_(bytes), fail_(fail) {}
+
+  int64_t reclaimableBytes() const override {
+    return bytes_;
+  }
+
+  int64_t reclaimForOthers(int64_t size) override {
+    numReclaims++;
+    if (fail_) {
+      throw std::runtime_error("task is cancelled");
+    }
+    auto freed = std::min(size, bytes_);
+    bytes_ -= freed;
+    return freed;
+  }
+
+  void runSuspended(const std::function<void()>& fn) override {
+    numSuspended++;
+    fn();
+  }
+
+  int32_t numReclaims = 0;
+  int32_t numSuspended = 0;
+
+ private:
+  int64_t bytes_;
+  bool fail_;
+};
+} // namespace
+
+class ExecutorMemoryArbitratorTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<velox::memory::MemoryPool> addPool(const std::string& name) {
+    return defaultLeafVeloxMemoryPool()->root()->addLeafChild(name);
+  }
+
+  ExecutorMemoryArbitrator* arbitrator_ = ExecutorMemoryArbitrator::instance();
+};
+
+TEST_F(ExecutorMemoryArbitratorTest, reclaimFromLargestOthers) {
+  auto poolA = addPool("arbitration_a");
+  auto poolB = addPool("arbitration_b");
+  auto poolC = addPool("arbitration_c");
+  FakeParticipant a(1000);
+  FakeParticipant b(300);
+  FakeParticipant c(200);
+  arbitrator_->addParticipant(poolA.get(), &a);
+  arbitrator_->addParticipant(poolB.get(), &b);
+  arbitrator_->addParticipant(poolC.get(), &c);
+
+  auto numArbitrations = arbitrator_->numArbitrations();
+  // The requestor itself is never reclaimed, even if it is the largest.
+  ASSERT_EQ(arbitrator_->arbitrate(poolA.get(), 250), 250);
+  ASSERT_EQ(a.numReclaims, 0);
+  ASSERT_EQ(a.numSuspended, 1);
+  ASSERT_EQ(b.numReclaims, 1);
+  ASSERT_EQ(b.reclaimableBytes(), 50);
+  ASSERT_EQ(c.numReclaims, 0);
+
+  // C is now the largest other participant, B gives the rest.
+  ASSERT_EQ(arbitrator_->arbitrate(poolA.get(), 300), 250);
+  ASSERT_EQ(b.numReclaims, 2);
+  ASSERT_EQ(c.numReclaims, 1);
+  ASSERT_EQ(arbitrator_->numArbitrations(), numArbitrations + 2);
+  ASSERT_GT(arbitrator_->waitNanos(poolA.get()), 0);
+  ASSERT_EQ(arbitrator_->waitNanos(poolB.get()), 0);
+
+  // Nothing left to reclaim.
+  ASSERT_EQ(arbitrator_->arbitrate(poolA.get(), 100), 0);
+  ASSERT_EQ(b.numReclaims, 2);
+  ASSERT_EQ(c.numReclaims, 1);
+
+  arbitrator_->removeParticipant(poolA.get());
+  arbitrator_->removeParticipant(poolB.get());
+  arbitrator_->removeParticipant(poolC.get());
+  ASSERT_EQ(arbitrator_->waitNanos(poolA.get()), 0);
+}
+
+TEST_F(ExecutorMemoryArbitratorTest, skipFailedParticipant) {
+  auto poolA = addPool("arbitration_a");
+  auto poolB = addPool("arbitration_b");
+  auto poolC = addPool("arbitration_c");
+  FakeParticipant b(500, true);
+  FakeParticipant c(200);
+  arbitrator_->addParticipant(poolB.get(), &b);
+  arbitrator_->addParticipant(poolC.get(), &c);
+
+  // The requestor doesn't have to be a participant, e.g. the pool of a shuffle reader.
+  ASSERT_EQ(arbitrator_->arbitrate(poolA.get(), 300), 200);
+  ASSERT_EQ(b.numReclaims, 1);
+  ASSERT_EQ(c.numReclaims, 1);
+  ASSERT_EQ(c.numSuspended, 0);
+
+  arbitrator_->removeParticipant(poolB.get());
+  arbitrator_->removeParticipant(poolC.get());
+}
+
+TEST_F(ExecutorMemoryArbitratorTest, noOtherParticipant) {
+  auto poolA = addPool("arbitration_a");
+  FakeParticipant a(1000);
+  arbitrator_->addParticipant(poolA.get(), &a);
+  auto numArbitrations = arbitrator_->numArbitrations();
+  ASSERT_EQ(arbitrator_->arbitrate(poolA.get(), 100), 0);
+  ASSERT_EQ(a.numSuspended, 0);
+  ASSERT_EQ(arbitrator_->numArbitrations(), numArbitrations);
+  arbitrator_->removeParticipant(poolA.get());
+}
+
+} // namespace gluten
@@ -192,4 +192,27 @@ TEST_F(FunctionTest, getFunctionType) {
   ASSERT_EQ("str", types[0]);
   ASSERT_EQ("str", types[1]);
 }
+
+TEST_F(FunctionTest, literalsToFlatVector) {
+  SubstraitVeloxExprConverter exprConverter(pool_.get(), {});
+  std::vector<::substrait::Expression::Literal> literals(3);
+  literals[0].set_string("a long string, not inlined");
+  literals[1].mutable_null()->mutable_string();
+  literals[2].set_string("b");
+  std::vector<const ::substrait::Expression::Literal*> pointers;
+  for (const auto& literal : literals) {
+    pointers.emplace_back(&literal);
+  }
+  auto vector = exprConverter.literalsToFlatVector(VARCHAR(), pointers);
+  ASSERT_NE(vector, nullptr);
+  auto flatVector = vector->asFlatVector<StringView>();
+  ASSERT_EQ(3, flatVector->size());
+  ASSERT_EQ("a long string, not inlined", flatVector->valueAt(0).str());
+  ASSERT_TRUE(flatVector->isNullAt(1));
+  ASSERT_EQ("b", flatVector->valueAt(2).str());
+
+  // A decimal goes through the variants.
+  literals[2].mutable_decimal()->set_precision(10);
+  ASSERT_EQ(nullptr, exprConverter.literalsToFlatVector(VARCHAR(), pointers));
+}
 } // namespace gluten
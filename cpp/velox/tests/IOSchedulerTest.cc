@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/executors/ManualExecutor.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "compute/IOScheduler.h"
+
+namespace gluten {
+
+class IOSchedulerTest : public ::testing::Test {
+ protected:
+  folly::Func record(std::string name) {
+    return [this, name]() { ran_.push_back(name); };
+  }
+
+  void runAll() {
+    while (pool_.run() > 0) {
+    }
+  }
+
+  folly::ManualExecutor pool_;
+  std::vector<std::string> ran_;
+};
+
+TEST_F(IOSchedulerTest, roundRobinAcrossTasks) {
+  IOSchedulerOptions options;
+  options.maxInflight = 2;
+  options.maxInflightPerTask = 1;
+  IOScheduler scheduler(&pool_, options);
+  for (auto i = 1; i <= 4; ++i) {
+    scheduler.add(record("a" + std::to_string(i)));
+  }
+  // Another thread is another task.
+  std::thread([&] {
+    scheduler.add(record("b1"));
+    scheduler.add(record("b2"));
+  }).join();
+  ASSERT_EQ(scheduler.numQueued(), 4);
+  runAll();
+  ASSERT_EQ(ran_, (std::vector<std::string>{"a1", "a2", "b1", "a3", "b2", "a4"}));
+  ASSERT_EQ(scheduler.numQueued(), 0);
+}
+
+TEST_F(IOSchedulerTest, demandFirst) {
+  IOSchedulerOptions options;
+  options.maxInflight = 1;
+  IOScheduler scheduler(&pool_, options);
+  for (auto i = 1; i <= 3; ++i) {
+    scheduler.add(record("p" + std::to_string(i)));
+  }
+  {
+    ScopedIOPriority demand(IOPriority::kDemand);
+    scheduler.add(record("d1"));
+  }
+  scheduler.addWithPriority(record("d2"), folly::Executor::HI_PRI);
+  runAll();
+  ASSERT_EQ(ran_, (std::vector<std::string>{"p1", "d1", "d2", "p2", "p3"}));
+}
+
+TEST_F(IOSchedulerTest, nestedWorkKeepsTask) {
+  IOSchedulerOptions options;
+  options.maxInflight = 1;
+  IOScheduler scheduler(&pool_, options);
+  {
+    ScopedIOPriority demand(IOPriority::kDemand);
+    scheduler.add([&] {
+      ran_.push_back("d1");
+      // A continuation of demand work is demand work.
+      scheduler.add(record("d2"));
+    });
+  }
+  scheduler.add(record("p1"));
+  runAll();
+  ASSERT_EQ(ran_, (std::vector<std::string>{"d1", "d2", "p1"}));
+}
+
+TEST_F(IOSchedulerTest, loneTaskUsesAllThreads) {
+  IOSchedulerOptions options;
+  options.maxInflight = 2;
+  options.maxInflightPerTask = 1;
+  IOScheduler scheduler(&pool_, options);
+  for (auto i = 1; i <= 4; ++i) {
+    scheduler.add(record("a" + std::to_string(i)));
+  }
+  // No other task waits, so the task isn't held to its share.
+  ASSERT_EQ(scheduler.numQueued(), 2);
+  runAll();
+  ASSERT_EQ(ran_, (std::vector<std::string>{"a1", "a2", "a3", "a4"}));
+}
+
+TEST_F(IOSchedulerTest, failedWorkFreesThread) {
+  IOSchedulerOptions options;
+  options.maxInflight = 1;
+  IOScheduler scheduler(&pool_, options);
+  scheduler.add([] { throw std::runtime_error("read failed"); });
+  scheduler.add(record("p1"));
+  ASSERT_EQ(scheduler.numQueued(), 1);
+  runAll();
+  ASSERT_EQ(ran_, (std::vector<std::string>{"p1"}));
+  ASSERT_EQ(scheduler.numQueued(), 0);
+}
+
+TEST_F(IOSchedulerTest, adaptiveThrottling) {
+  IOSchedulerOptions options;
+  options.maxInflight = 4;
+  options.adaptive = true;
+  IOScheduler scheduler(&pool_, options);
+  auto runWindow = [&](std::chrono::microseconds runTime) {
+    for (auto i = 0; i < 32; ++i) {
+      scheduler.add([runTime] { std::this_thread::sleep_for(runTime); });
+    }
+    runAll();
+  };
+  runWindow(std::chrono::microseconds(200));
+  ASSERT_EQ(scheduler.inflightLimit(), 4);
+  // Ten times slower than the first window.
+  runWindow(std::chrono::milliseconds(2));
+  ASSERT_EQ(scheduler.inflightLimit(), 3);
+  for (auto i = 0; i < 20 && scheduler.inflightLimit() < 4; ++i) {
+    runWindow(std::chrono::microseconds(200));
+  }
+  ASSERT_EQ(scheduler.inflightLimit(), 4);
+}
+
+} // namespace gluten
@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "memory/LargeMemoryPool.h"
+
+namespace gluten {
+
+TEST(LargeMemoryPoolTest, defaultOptions) {
+  MMapMemoryPool pool;
+  uint8_t* buffer;
+  ASSERT_TRUE(pool.Allocate(1024, 64, &buffer).ok());
+  memset(buffer, 1, 1024);
+  ASSERT_EQ(pool.stats().numBuffers, 1);
+  ASSERT_EQ(pool.stats().bufferBytes, LargeMemoryPool::kLargeBufferSize);
+  ASSERT_EQ(pool.stats().hugePageAdvisedBytes, 0);
+  ASSERT_EQ(pool.stats().hugetlbBytes, 0);
+  pool.Free(buffer, 1024, 64);
+  ASSERT_EQ(pool.stats().numLocalityChecked, 0);
+  ASSERT_EQ(pool.bytes_allocated(), 0);
+}
+
+TEST(LargeMemoryPoolTest, hugePagesAndNumaBind) {
+  LargeMemoryPoolOptions options;
+  options.transparent_huge_pages = true;
+  options.bind_to_local_node = true;
+  options.hugetlb = true;
+  MMapMemoryPool pool(options);
+
+  // Larger than kLargeBufferSize, rounded up to whole huge pages.
+  const int64_t size = LargeMemoryPool::kLargeBufferSize + 1;
+  uint8_t* buffer;
+  ASSERT_TRUE(pool.Allocate(size, 64, &buffer).ok());
+  memset(buffer, 1, size);
+  const auto& stats = pool.stats();
+  ASSERT_EQ(stats.numBuffers, 1);
+  ASSERT_EQ(stats.bufferBytes, LargeMemoryPool::kLargeBufferSize + LargeMemoryPool::kHugePageSize);
+  // Whether hugetlbfs pages are reserved and THP is enabled depends on the host.
+  ASSERT_TRUE(stats.hugetlbBytes == 0 || stats.hugetlbBytes == stats.bufferBytes);
+  ASSERT_TRUE(stats.hugePageAdvisedBytes == 0 || stats.hugePageAdvisedBytes == stats.bufferBytes);
+  ASSERT_GE(pool.hugePageBytes(), 0);
+  ASSERT_LE(pool.hugePageBytes(), stats.bufferBytes);
+
+  pool.Free(buffer, size, 64);
+  ASSERT_LE(stats.numCrossNodeBuffers, stats.numLocalityChecked);
+  ASSERT_EQ(pool.bytes_allocated(), 0);
+  ASSERT_EQ(pool.hugePageBytes(), 0);
+}
+
+} // namespace gluten
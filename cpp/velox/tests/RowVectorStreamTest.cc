@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryPool.h"
+#include "operators/plannodes/RowVectorStream.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+class RowVectorIterator : public ColumnarBatchIterator {
+ public:
+  explicit RowVectorIterator(std::vector<RowVectorPtr> vectors) : vectors_(std::move(vectors)) {}
+
+  std::shared_ptr<ColumnarBatch> next() override {
+    if (idx_ >= vectors_.size()) {
+      return nullptr;
+    }
+    return std::make_shared<VeloxColumnarBatch>(vectors_[idx_++]);
+  }
+
+ private:
+  std::vector<RowVectorPtr> vectors_;
+  size_t idx_ = 0;
+};
+} // namespace
+
+class RowVectorStreamTest : public ::testing::Test, public test::VectorTestBase {
+ protected:
+  RowVectorPtr makeInput(std::vector<int32_t> ints, std::vector<std::string> strings) {
+    return makeRowVector({makeFlatVector<int32_t>(ints), makeFlatVector<std::string>(strings)});
+  }
+
+  std::shared_ptr<RowVectorStream> makeStream(
+      std::vector<RowVectorPtr> inputs,
+      int32_t coalesceBatchRows,
+      int64_t coalesceBatchBytes) {
+    auto iter = std::make_shared<ResultIterator>(std::make_unique<RowVectorIterator>(std::move(inputs)));
+    return std::make_shared<RowVectorStream>(iter, outputType_, coalesceBatchRows, coalesceBatchBytes);
+  }
+
+  RowTypePtr outputType_ = ROW({"n0_0", "n0_1"}, {INTEGER(), VARCHAR()});
+  std::shared_ptr<memory::MemoryPool> veloxPool_ = defaultLeafVeloxMemoryPool();
+};
+
+TEST_F(RowVectorStreamTest, noCoalesce) {
+  auto stream = makeStream({makeInput({1, 2}, {"a", "b"}), makeInput({3}, {"c"})}, 0, 0);
+  std::vector<RowVectorPtr> expected = {makeInput({1, 2}, {"a", "b"}), makeInput({3}, {"c"})};
+  for (const auto& vector : expected) {
+    ASSERT_TRUE(stream->hasNext());
+    auto output = stream->next(veloxPool_.get());
+    ASSERT_EQ(*output->type(), *outputType_);
+    test::assertEqualVectors(vector, output);
+  }
+  ASSERT_FALSE(stream->hasNext());
+  ASSERT_EQ(stream->numInputBatches(), 2);
+}
+
+TEST_F(RowVectorStreamTest, passThrough) {
+  // Of the output type, the input vectors are passed through as they are.
+  auto input = makeRowVector(
+      outputType_->names(), {makeFlatVector<int32_t>({1, 2}), makeFlatVector<std::string>({"a", "b"})});
+  auto stream = makeStream({input}, 0, 0);
+  ASSERT_TRUE(stream->hasNext());
+  ASSERT_EQ(stream->next(veloxPool_.get()).get(), input.get());
+  ASSERT_FALSE(stream->hasNext());
+  ASSERT_EQ(stream->numNativeInputBatches(), 1);
+  ASSERT_EQ(stream->numArrowInputBatches(), 0);
+}
+
+TEST_F(RowVectorStreamTest, coalesceByRows) {
+  auto stream = makeStream(
+      {makeInput({1, 2}, {"a", "b"}),
+       makeInput({3}, {"c"}),
+       makeInput({4, 5}, {"d", "e"}),
+       makeInput({6}, {"f"}),
+       makeInput({7, 8, 9, 10}, {"g", "h", "i", "j"})},
+      4,
+      1 << 20);
+  // The last input of an output is cut at the limit, its other rows start the next output.
+  std::vector<RowVectorPtr> expected = {
+      makeInput({1, 2, 3, 4}, {"a", "b", "c", "d"}),
+      makeInput({5, 6, 7, 8}, {"e", "f", "g", "h"}),
+      makeInput({9, 10}, {"i", "j"})};
+  for (const auto& vector : expected) {
+    ASSERT_TRUE(stream->hasNext());
+    auto output = stream->next(veloxPool_.get());
+    ASSERT_EQ(*output->type(), *outputType_);
+    test::assertEqualVectors(vector, output);
+  }
+  ASSERT_FALSE(stream->hasNext());
+  ASSERT_EQ(stream->numInputBatches(), 5);
+}
+
+TEST_F(RowVectorStreamTest, coalesceByBytes) {
+  // A byte threshold of 1 disables concatenation.
+  auto stream = makeStream({makeInput({1, 2}, {"a", "b"}), makeInput({3}, {"c"})}, 4096, 1);
+  std::vector<RowVectorPtr> expected = {makeInput({1, 2}, {"a", "b"}), makeInput({3}, {"c"})};
+  for (const auto& vector : expected) {
+    ASSERT_TRUE(stream->hasNext());
+    test::assertEqualVectors(vector, stream->next(veloxPool_.get()));
+  }
+  ASSERT_FALSE(stream->hasNext());
+}
+
+} // namespace gluten
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "shuffle/ShuffleSplitKernels.h"
+
+namespace gluten {
+
+namespace {
+const uint32_t kSrcRows = 4096;
+
+std::vector<SplitKernelIsa> supportedIsas() {
+  std::vector<SplitKernelIsa> isas;
+  for (auto isa : {SplitKernelIsa::kScalar, SplitKernelIsa::kAvx2, SplitKernelIsa::kAvx512}) {
+    if (isa <= detectSplitKernelIsa()) {
+      isas.push_back(isa);
+    }
+  }
+  return isas;
+}
+
+std::vector<uint32_t> randomRowIds(uint32_t numRows, uint32_t maxRowId, std::mt19937& gen) {
+  std::uniform_int_distribution<uint32_t> dist(0, maxRowId - 1);
+  std::vector<uint32_t> rowIds(numRows);
+  for (auto& rowId : rowIds) {
+    rowId = dist(gen);
+  }
+  return rowIds;
+}
+} // namespace
+
+TEST(ShuffleSplitKernelsTest, gatherFixedWidth) {
+  std::mt19937 gen(0);
+  std::vector<uint8_t> src(kSrcRows * 16);
+  for (auto& b : src) {
+    b = gen();
+  }
+  // Cover empty input, the vector loop remainders and rows at the end of the source buffer.
+  for (uint32_t numRows : {0, 1, 7, 8, 15, 16, 17, 100, 4097}) {
+    for (uint32_t byteWidth : {1, 2, 4, 8, 16}) {
+      auto rowIds = randomRowIds(numRows, kSrcRows, gen);
+      if (numRows > 0) {
+        rowIds.back() = kSrcRows - 1;
+      }
+      std::vector<uint8_t> expected(numRows * byteWidth);
+      for (uint32_t i = 0; i < numRows; ++i) {
+        memcpy(expected.data() + i * byteWidth, src.data() + rowIds[i] * byteWidth, byteWidth);
+      }
+      for (auto isa : supportedIsas()) {
+        std::vector<uint8_t> dst(numRows * byteWidth + 1, 0xab);
+        gatherFixedWidth(isa, byteWidth, src.data(), rowIds.data(), numRows, dst.data());
+        ASSERT_EQ(memcmp(dst.data(), expected.data(), expected.size()), 0)
+            << splitKernelIsaName(isa) << " byteWidth " << byteWidth << " numRows " << numRows;
+        // Must not write past the last row.
+        ASSERT_EQ(dst.back(), 0xab) << splitKernelIsaName(isa);
+      }
+    }
+  }
+}
+
+TEST(ShuffleSplitKernelsTest, gatherBits) {
+  std::mt19937 gen(1);
+  std::vector<uint8_t> src(kSrcRows / 8);
+  for (auto& b : src) {
+    b = gen();
+  }
+  for (uint32_t numBytes : {0, 1, 2, 3, 4, 5, 64, 129}) {
+    auto rowIds = randomRowIds(numBytes * 8, kSrcRows, gen);
+    std::vector<uint8_t> expected(numBytes, 0);
+    for (uint32_t i = 0; i < numBytes * 8; ++i) {
+      if ((src[rowIds[i] >> 3] >> (rowIds[i] & 7)) & 1) {
+        expected[i >> 3] |= 1 << (i & 7);
+      }
+    }
+    for (auto isa : supportedIsas()) {
+      std::vector<uint8_t> dst(numBytes + 1, 0xab);
+      gatherBits(isa, src.data(), rowIds.data(), numBytes, dst.data());
+      ASSERT_EQ(memcmp(dst.data(), expected.data(), numBytes), 0)
+          << splitKernelIsaName(isa) << " numBytes " << numBytes;
+      ASSERT_EQ(dst.back(), 0xab) << splitKernelIsaName(isa);
+    }
+  }
+}
+
+} // namespace gluten
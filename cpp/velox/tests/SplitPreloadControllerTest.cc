@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "compute/SplitPreloadController.h"
+
+namespace gluten {
+
+TEST(SplitPreloadControllerTest, adaptToIoWait) {
+  SplitPreloadController controller;
+  int32_t depth = 0;
+  controller.enable(2, 1, 3, [&depth](int32_t newDepth) { depth = newDepth; });
+  ASSERT_EQ(depth, 2);
+
+  constexpr auto kWindow = SplitPreloadController::kWindowNanos;
+  // Not a full window yet.
+  controller.report(kWindow / 4, kWindow / 2);
+  ASSERT_EQ(depth, 2);
+  controller.report(kWindow / 4, kWindow / 2);
+  ASSERT_EQ(depth, 3);
+  // Capped by the max depth.
+  controller.report(kWindow / 2, kWindow);
+  ASSERT_EQ(controller.depth(), 3);
+
+  // Between the ratios.
+  controller.report(kWindow / 10, kWindow);
+  ASSERT_EQ(depth, 3);
+
+  controller.report(0, kWindow);
+  ASSERT_EQ(depth, 2);
+  controller.report(0, kWindow);
+  controller.report(0, kWindow);
+  ASSERT_EQ(depth, 1);
+}
+
+TEST(SplitPreloadControllerTest, disabled) {
+  SplitPreloadController controller;
+  ASSERT_FALSE(controller.enabled());
+  controller.report(SplitPreloadController::kWindowNanos, SplitPreloadController::kWindowNanos);
+  ASSERT_EQ(controller.depth(), 0);
+}
+
+} // namespace gluten
@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "compute/SsdCacheDirectory.h"
+#include "utils/exception.h"
+
+namespace gluten {
+
+class SsdCacheDirectoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() /
+        ("SsdCacheDirectoryTest." + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+    std::filesystem::remove_all(path_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(path_);
+  }
+
+  void write(const std::string& name, const std::string& content) {
+    std::ofstream(path_ / name) << content;
+  }
+
+  bool exists(const std::string& name) {
+    return std::filesystem::exists(path_ / name);
+  }
+
+  std::filesystem::path path_;
+  const SsdCacheDirectory::Layout layout_{1 << 20, 2};
+};
+
+TEST_F(SsdCacheDirectoryTest, slots) {
+  SsdCacheDirectory first(path_.string(), 2);
+  ASSERT_EQ(first.open(layout_), path_.string() + "/cache.0.");
+  {
+    SsdCacheDirectory second(path_.string(), 2);
+    ASSERT_EQ(second.open(layout_), path_.string() + "/cache.1.");
+    SsdCacheDirectory third(path_.string(), 2);
+    ASSERT_THROW(third.open(layout_), GlutenException);
+  }
+  // Released by the stopped executor.
+  SsdCacheDirectory restarted(path_.string(), 2);
+  ASSERT_EQ(restarted.open(layout_), path_.string() + "/cache.1.");
+}
+
+TEST_F(SsdCacheDirectoryTest, reuseFilesOfCleanShutdown) {
+  {
+    SsdCacheDirectory directory(path_.string(), 1);
+    directory.open(layout_);
+    write("cache.0.0", "data");
+    write("cache.0.0.cpt", "checkpoint");
+    directory.close();
+  }
+  {
+    SsdCacheDirectory directory(path_.string(), 1);
+    directory.open(layout_);
+    ASSERT_TRUE(exists("cache.0.0"));
+    ASSERT_EQ(directory.checkpointChecksums().size(), 1);
+    directory.close();
+  }
+
+  // A checkpoint changed after the shutdown.
+  write("cache.0.0.cpt", "corrupted");
+  {
+    SsdCacheDirectory directory(path_.string(), 1);
+    directory.open(layout_);
+    ASSERT_FALSE(exists("cache.0.0"));
+    ASSERT_FALSE(exists("cache.0.0.cpt"));
+  }
+}
+
+TEST_F(SsdCacheDirectoryTest, discardFilesOfOtherLayout) {
+  {
+    SsdCacheDirectory directory(path_.string(), 1);
+    directory.open(layout_);
+    write("cache.0.0", "data");
+  }
+  // Without a clean shutdown the checkpoints are left to SsdCache.
+  {
+    SsdCacheDirectory directory(path_.string(), 1);
+    directory.open(layout_);
+    ASSERT_TRUE(exists("cache.0.0"));
+  }
+  SsdCacheDirectory directory(path_.string(), 1);
+  directory.open({layout_.maxBytes, 4});
+  ASSERT_FALSE(exists("cache.0.0"));
+}
+
+} // namespace gluten
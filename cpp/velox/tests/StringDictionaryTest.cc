@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "shuffle/StringDictionary.h"
+
+namespace gluten {
+
+namespace {
+struct Strings {
+  explicit Strings(const std::vector<std::string>& strings) {
+    offsets.push_back(0);
+    for (const auto& string : strings) {
+      values.insert(values.end(), string.begin(), string.end());
+      offsets.push_back(values.size());
+    }
+  }
+
+  std::vector<int32_t> offsets;
+  std::vector<uint8_t> values;
+};
+} // namespace
+
+TEST(StringDictionaryTest, encode) {
+  Strings strings({"shuffle", "dictionary", "shuffle", "shuffle", "", "dictionary", "", "shuffle"});
+  StringDictionaryEncoder encoder;
+  ASSERT_TRUE(encoder.encode(strings.offsets.data(), strings.values.data(), 8, 0.5));
+  // 8 indices, then the offsets of "shuffle", "dictionary" and "".
+  std::vector<int32_t> expected = {0, 1, 0, 0, 2, 1, 2, 0, 0, 7, 17, 17};
+  ASSERT_EQ(encoder.indicesAndOffsets(), expected);
+  ASSERT_EQ(std::string(encoder.dictionary().begin(), encoder.dictionary().end()), "shuffledictionary");
+  ASSERT_EQ(numDictionaryValues(expected.size() * sizeof(int32_t), 8), 3);
+  ASSERT_EQ(numDictionaryValues(strings.offsets.size() * sizeof(int32_t), 8), 0);
+}
+
+TEST(StringDictionaryTest, notBeneficial) {
+  StringDictionaryEncoder encoder;
+  // Too many distinct values.
+  Strings distinct({"a", "b", "c", "a"});
+  ASSERT_FALSE(encoder.encode(distinct.offsets.data(), distinct.values.data(), 4, 0.5));
+  // Values shorter than the indices added to the dictionary.
+  Strings shortValues({"a", "a", "b", "b"});
+  ASSERT_FALSE(encoder.encode(shortValues.offsets.data(), shortValues.values.data(), 4, 0.5));
+}
+
+} // namespace gluten
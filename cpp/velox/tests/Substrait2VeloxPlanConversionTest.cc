@@ -18,6 +18,8 @@
 #include "JsonToProtoConverter.h"
 
 #include <filesystem>
+#include "compute/VeloxBackend.h"
+#include "compute/VeloxPlanCache.h"
 #include "substrait/SubstraitToVeloxPlan.h"
 #include "substrait/SubstraitToVeloxPlanValidator.h"
 #include "velox/common/base/tests/GTestUtils.h"
@@ -278,4 +280,222 @@ TEST_F(Substrait2VeloxPlanConversionTest, filterUpper) {
       "[(key, BigintRange: [-2147483648, 2] no nulls)]] -> n0_0:INTEGER\n",
       planNode->toString(true, true));
 }
+
+TEST_F(Substrait2VeloxPlanConversionTest, planCacheBindsTaskSplits) {
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(FilePathGenerator::getDataFilePath("filter_upper.json"), substraitPlan);
+  // The scan is under single input rels, a fetch over the project over the read.
+  auto* root = substraitPlan.mutable_relations(0)->mutable_root();
+  ::substrait::Rel input = root->input();
+  auto* fetch = root->mutable_input()->mutable_fetch();
+  fetch->set_count(10);
+  *fetch->mutable_input() = input;
+
+  // The plan of a task scanning the file.
+  auto taskPlan = [&](const std::string& path) {
+    auto plan = substraitPlan;
+    auto* read = plan.mutable_relations(0)
+                     ->mutable_root()
+                     ->mutable_input()
+                     ->mutable_fetch()
+                     ->mutable_input()
+                     ->mutable_project()
+                     ->mutable_input()
+                     ->mutable_read();
+    read->mutable_local_files()->mutable_items(0)->set_uri_file(path);
+    return plan.SerializeAsString();
+  };
+  auto scannedPaths = [](VeloxBackend& backend, const std::string& plan) {
+    backend.parsePlan(reinterpret_cast<const uint8_t*>(plan.data()), plan.size());
+    auto splitInfos = backend.toVeloxPlan({});
+    std::vector<std::shared_ptr<SplitInfo>> scanInfos;
+    std::vector<core::PlanNodeId> scanIds;
+    std::vector<core::PlanNodeId> streamIds;
+    VeloxBackend::getInfoAndIds(splitInfos, backend.getVeloxPlan()->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
+    EXPECT_EQ(scanInfos.size(), 1);
+    return scanInfos.empty() ? std::vector<std::string>{} : scanInfos[0]->paths;
+  };
+
+  auto* cache = VeloxPlanCache::instance();
+  auto capacity = cache->capacity();
+  cache->setCapacity(4);
+  auto hits = cache->numHits();
+  VeloxBackend first({});
+  VeloxBackend second({});
+  ASSERT_EQ(scannedPaths(first, taskPlan("file:///tmp/a.parquet")), std::vector<std::string>{"file:///tmp/a.parquet"});
+  // The second task reuses the plan of the first but binds its own file.
+  ASSERT_EQ(scannedPaths(second, taskPlan("file:///tmp/b.parquet")), std::vector<std::string>{"file:///tmp/b.parquet"});
+  ASSERT_EQ(cache->numHits(), hits + 1);
+  ASSERT_EQ(second.getVeloxPlan(), first.getVeloxPlan());
+  cache->setCapacity(capacity);
+}
+
+TEST_F(Substrait2VeloxPlanConversionTest, buildKeyFilter) {
+  std::string subPlanPath = FilePathGenerator::getDataFilePath("broadcast_join_key_filter.json");
+
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(subPlanPath, substraitPlan);
+
+  // The probe side scan filters on the IN-list of the build side keys.
+  auto planNode = planConverter_->toVeloxPlan(substraitPlan);
+  while (!planNode->sources().empty()) {
+    planNode = planNode->sources()[0];
+  }
+  auto scanNode = std::dynamic_pointer_cast<const core::TableScanNode>(planNode);
+  ASSERT_NE(scanNode, nullptr);
+  auto tableHandle = std::dynamic_pointer_cast<const HiveTableHandle>(scanNode->tableHandle());
+  ASSERT_NE(tableHandle, nullptr);
+  const auto& filters = tableHandle->subfieldFilters();
+  ASSERT_EQ(filters.size(), 1);
+  const auto& filter = filters.begin()->second;
+  ASSERT_EQ(filters.begin()->first.toString(), "k");
+  ASSERT_TRUE(filter->testInt64(5));
+  ASSERT_FALSE(filter->testInt64(4));
+  ASSERT_FALSE(filter->testInt64(8));
+  ASSERT_FALSE(filter->testNull());
+}
+
+TEST_F(Substrait2VeloxPlanConversionTest, nestedLoopJoin) {
+  std::string subPlanPath = FilePathGenerator::getDataFilePath("broadcast_join_key_filter.json");
+
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(subPlanPath, substraitPlan);
+  // Without join keys, the condition being the post join filter.
+  auto* join = substraitPlan.mutable_relations(0)->mutable_root()->mutable_input()->mutable_join();
+  *join->mutable_post_join_filter() = join->expression();
+  join->clear_expression();
+
+  auto planNode = planConverter_->toVeloxPlan(substraitPlan);
+  auto joinNode = std::dynamic_pointer_cast<const core::NestedLoopJoinNode>(planNode);
+  ASSERT_NE(joinNode, nullptr);
+  ASSERT_EQ(joinNode->joinType(), core::JoinType::kInner);
+  ASSERT_NE(joinNode->joinCondition(), nullptr);
+  ASSERT_EQ(joinNode->outputType()->size(), 3);
+
+  // No key to summarize the build side by.
+  auto scanNode = std::dynamic_pointer_cast<const core::TableScanNode>(joinNode->sources()[0]);
+  ASSERT_NE(scanNode, nullptr);
+  auto tableHandle = std::dynamic_pointer_cast<const HiveTableHandle>(scanNode->tableHandle());
+  ASSERT_NE(tableHandle, nullptr);
+  ASSERT_TRUE(tableHandle->subfieldFilters().empty());
+}
+
+TEST_F(Substrait2VeloxPlanConversionTest, prefixFilter) {
+  std::string subPlanPath = FilePathGenerator::getDataFilePath("filter_prefix.json");
+
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(subPlanPath, substraitPlan);
+
+  // starts_with(c0, 'ab') and c1 like 'xy%' filter the scan as string ranges.
+  auto planNode = planConverter_->toVeloxPlan(substraitPlan);
+  while (!planNode->sources().empty()) {
+    planNode = planNode->sources()[0];
+  }
+  auto scanNode = std::dynamic_pointer_cast<const core::TableScanNode>(planNode);
+  ASSERT_NE(scanNode, nullptr);
+  auto tableHandle = std::dynamic_pointer_cast<const HiveTableHandle>(scanNode->tableHandle());
+  ASSERT_NE(tableHandle, nullptr);
+  ASSERT_EQ(tableHandle->remainingFilter(), nullptr);
+  const auto& filters = tableHandle->subfieldFilters();
+  ASSERT_EQ(filters.size(), 2);
+  auto test = [&](const std::string& column, const std::string& value) {
+    for (const auto& [subfield, filter] : filters) {
+      if (subfield.toString() == column) {
+        return filter->testBytes(value.data(), value.size());
+      }
+    }
+    VELOX_FAIL("No filter on {}", column);
+  };
+  ASSERT_TRUE(test("c0", "ab"));
+  ASSERT_TRUE(test("c0", "abz"));
+  ASSERT_FALSE(test("c0", "a"));
+  ASSERT_FALSE(test("c0", "ac"));
+  ASSERT_TRUE(test("c1", "xyz"));
+  ASSERT_FALSE(test("c1", "xz"));
+  ASSERT_FALSE(test("c1", "x"));
+}
+
+TEST_F(Substrait2VeloxPlanConversionTest, topNRowNumber) {
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(FilePathGenerator::getDataFilePath("row_number_filter.json"), substraitPlan);
+  // The function anchors of row_number_filter.json, and the columns of the window output.
+  enum : uint32_t { kLte = 1, kLt, kGte, kEqual, kIsNotNull, kAnd, kGt };
+  constexpr int32_t kOrderColumn = 1;
+  constexpr int32_t kRowNumberColumn = 2;
+
+  auto field = [](int32_t idx) {
+    ::substrait::Expression expr;
+    expr.mutable_selection()->mutable_direct_reference()->mutable_struct_field()->set_field(idx);
+    return expr;
+  };
+  auto i32 = [](int32_t value) {
+    ::substrait::Expression expr;
+    expr.mutable_literal()->set_i32(value);
+    return expr;
+  };
+  auto i64 = [](int64_t value) {
+    ::substrait::Expression expr;
+    expr.mutable_literal()->set_i64(value);
+    return expr;
+  };
+  auto call = [](uint32_t functionAnchor, std::vector<::substrait::Expression> args) {
+    ::substrait::Expression expr;
+    auto* function = expr.mutable_scalar_function();
+    function->set_function_reference(functionAnchor);
+    function->mutable_output_type()->mutable_bool_()->set_nullability(::substrait::Type::NULLABILITY_NULLABLE);
+    for (auto& arg : args) {
+      *function->add_arguments()->mutable_value() = std::move(arg);
+    }
+    return expr;
+  };
+  auto convert = [&](::substrait::Expression condition) {
+    auto plan = substraitPlan;
+    *plan.mutable_relations(0)->mutable_root()->mutable_input()->mutable_filter()->mutable_condition() =
+        std::move(condition);
+    return planConverter_->toVeloxPlan(plan);
+  };
+  auto rn = field(kRowNumberColumn);
+
+  // The conditions bounding the row number by 2, or by 1.
+  std::vector<std::pair<::substrait::Expression, int32_t>> bounded = {
+      {call(kLte, {rn, i32(2)}), 2},
+      {call(kLt, {rn, i32(3)}), 2},
+      {call(kGte, {i32(2), rn}), 2},
+      {call(kEqual, {rn, i32(1)}), 1},
+      {call(kAnd, {call(kIsNotNull, {rn}), call(kLte, {rn, i32(2)})}), 2},
+      {call(kAnd, {call(kLte, {rn, i32(5)}), call(kLt, {rn, i32(3)})}), 2},
+  };
+  for (auto& [condition, limit] : bounded) {
+    SCOPED_TRACE(condition.DebugString());
+    auto planNode = convert(std::move(condition));
+    // The project casting the BIGINT row number to the INTEGER of the window.
+    auto projectNode = std::dynamic_pointer_cast<const core::ProjectNode>(planNode);
+    ASSERT_NE(projectNode, nullptr);
+    auto topNRowNumberNode = std::dynamic_pointer_cast<const core::TopNRowNumberNode>(projectNode->sources()[0]);
+    ASSERT_NE(topNRowNumberNode, nullptr);
+    ASSERT_EQ(topNRowNumberNode->limit(), limit);
+    ASSERT_EQ(topNRowNumberNode->partitionKeys().size(), 1);
+    ASSERT_EQ(topNRowNumberNode->sortingKeys().size(), 1);
+    ASSERT_EQ(topNRowNumberNode->outputType()->childAt(kRowNumberColumn)->kind(), TypeKind::BIGINT);
+    ASSERT_EQ(projectNode->outputType()->childAt(kRowNumberColumn)->kind(), TypeKind::INTEGER);
+    ASSERT_NE(
+        std::dynamic_pointer_cast<const core::CastTypedExpr>(projectNode->projections()[kRowNumberColumn]), nullptr);
+    ASSERT_EQ(projectNode->outputType()->childAt(kOrderColumn)->kind(), TypeKind::BIGINT);
+    ASSERT_NE(
+        std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(projectNode->projections()[kOrderColumn]),
+        nullptr);
+  }
+
+  // A conjunct not bounding the row number, or a lower bound, keep the window and the filter.
+  std::vector<::substrait::Expression> unbounded;
+  unbounded.emplace_back(call(kAnd, {call(kLte, {rn, i32(2)}), call(kGt, {field(kOrderColumn), i64(0)})}));
+  unbounded.emplace_back(call(kGte, {rn, i32(2)}));
+  for (auto& condition : unbounded) {
+    SCOPED_TRACE(condition.DebugString());
+    auto planNode = convert(std::move(condition));
+    auto filterNode = std::dynamic_pointer_cast<const core::FilterNode>(planNode);
+    ASSERT_NE(filterNode, nullptr);
+    ASSERT_NE(std::dynamic_pointer_cast<const core::WindowNode>(filterNode->sources()[0]), nullptr);
+  }
+}
 } // namespace gluten
@@ -69,4 +69,18 @@ TEST_F(Substrait2VeloxPlanValidatorTest, group) {
 
   ASSERT_FALSE(validatePlan(substraitPlan));
 }
+
+TEST_F(Substrait2VeloxPlanValidatorTest, cachedResult) {
+  SubstraitToVeloxPlanValidator::setCacheCapacity(16);
+  std::string subPlanPath = FilePathGenerator::getDataFilePath("group.json");
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(subPlanPath, substraitPlan);
+
+  ASSERT_FALSE(validatePlan(substraitPlan));
+  auto numHits = SubstraitToVeloxPlanValidator::numCacheHits();
+  // The root rel is found, along with the failure.
+  ASSERT_FALSE(validatePlan(substraitPlan));
+  ASSERT_EQ(SubstraitToVeloxPlanValidator::numCacheHits(), numHits + 1);
+  SubstraitToVeloxPlanValidator::setCacheCapacity(0);
+}
 } // namespace gluten
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "operators/writer/VeloxBlockStripeSplitter.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+class VeloxBlockStripeSplitterTest : public ::testing::Test, public test::VectorTestBase {
+ protected:
+  static RowVectorPtr rowVector(const std::shared_ptr<ColumnarBatch>& batch) {
+    return std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector();
+  }
+};
+
+TEST_F(VeloxBlockStripeSplitterTest, splitByPartition) {
+  // Sorted by the partitions (p, q), a null partition value included.
+  auto input = makeRowVector(
+      {"c", "p", "d", "q"},
+      {makeFlatVector<int64_t>({1, 2, 3, 4, 5, 6, 7}),
+       makeNullableFlatVector<int32_t>({std::nullopt, 1, 1, 1, 2, 2, 2}),
+       makeFlatVector<std::string>({"a", "b", "c", "d", "e", "f", "g"}),
+       makeFlatVector<std::string>({"x", "x", "x", "y", "y", "y", "y"})});
+  auto stripes = VeloxBlockStripeSplitter::split(std::make_shared<VeloxColumnarBatch>(input), {1, 3}, false);
+
+  ASSERT_EQ(stripes->headingRowIndice, (std::vector<int32_t>{0, 1, 3, 4}));
+  ASSERT_EQ(stripes->stripes.size(), 4);
+
+  // The heading rows keep all the columns, for the partition values.
+  auto headingRows = rowVector(stripes->headingRows);
+  test::assertEqualVectors(
+      makeRowVector(
+          {"c", "p", "d", "q"},
+          {makeFlatVector<int64_t>({1, 2, 4, 5}),
+           makeNullableFlatVector<int32_t>({std::nullopt, 1, 1, 2}),
+           makeFlatVector<std::string>({"a", "b", "d", "e"}),
+           makeFlatVector<std::string>({"x", "x", "y", "y"})}),
+      headingRows);
+
+  // The stripes drop the partition columns.
+  std::vector<std::pair<std::vector<int64_t>, std::vector<std::string>>> expected = {
+      {{1}, {"a"}}, {{2, 3}, {"b", "c"}}, {{4}, {"d"}}, {{5, 6, 7}, {"e", "f", "g"}}};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    test::assertEqualVectors(
+        makeRowVector(
+            {"c", "d"}, {makeFlatVector<int64_t>(expected[i].first), makeFlatVector<std::string>(expected[i].second)}),
+        rowVector(stripes->stripes[i]));
+  }
+}
+
+TEST_F(VeloxBlockStripeSplitterTest, splitByBucket) {
+  // The bucket id comes last and is dropped like the partition columns.
+  auto input = makeRowVector(
+      {"c", "p", "bucket"},
+      {makeFlatVector<int64_t>({1, 2, 3, 4}),
+       makeFlatVector<int32_t>({1, 1, 1, 2}),
+       makeFlatVector<int32_t>({0, 0, 3, 3})});
+  auto stripes = VeloxBlockStripeSplitter::split(std::make_shared<VeloxColumnarBatch>(input), {1}, true);
+
+  ASSERT_EQ(stripes->headingRowIndice, (std::vector<int32_t>{0, 2, 3}));
+  test::assertEqualVectors(makeRowVector({"c"}, {makeFlatVector<int64_t>({3})}), rowVector(stripes->stripes[1]));
+}
+
+TEST_F(VeloxBlockStripeSplitterTest, onePartition) {
+  auto input = makeRowVector({"c", "p"}, {makeFlatVector<int64_t>({1, 2, 3}), makeConstant<int32_t>(7, 3)});
+  auto stripes = VeloxBlockStripeSplitter::split(std::make_shared<VeloxColumnarBatch>(input), {1}, false);
+
+  ASSERT_EQ(stripes->headingRowIndice, std::vector<int32_t>{0});
+  test::assertEqualVectors(makeRowVector({"c"}, {makeFlatVector<int64_t>({1, 2, 3})}), rowVector(stripes->stripes[0]));
+}
+
+TEST_F(VeloxBlockStripeSplitterTest, emptyBatch) {
+  auto input = makeRowVector(
+      {"c", "p"}, {makeFlatVector<int64_t>(std::vector<int64_t>{}), makeFlatVector<int32_t>(std::vector<int32_t>{})});
+  auto stripes = VeloxBlockStripeSplitter::split(std::make_shared<VeloxColumnarBatch>(input), {1}, false);
+  ASSERT_TRUE(stripes->headingRowIndice.empty());
+  ASSERT_TRUE(stripes->stripes.empty());
+  ASSERT_EQ(rowVector(stripes->headingRows)->size(), 0);
+}
+
+} // namespace gluten
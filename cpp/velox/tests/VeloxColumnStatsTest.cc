@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <folly/json.h>
+
+#include <cmath>
+#include <limits>
+
+#include "operators/writer/VeloxColumnStats.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+class VeloxColumnStatsTest : public ::testing::Test, public test::VectorTestBase {};
+
+TEST_F(VeloxColumnStatsTest, accumulatesBatches) {
+  auto first = makeRowVector(
+      {"i", "d", "s", "b", "a"},
+      {makeNullableFlatVector<int64_t>({3, std::nullopt, -7}),
+       makeFlatVector<double>({1.5, std::numeric_limits<double>::quiet_NaN(), -2.5}),
+       makeNullableFlatVector<std::string>({"pear", "apple", std::nullopt}),
+       makeFlatVector<std::string>({"\x01", "\x02", "\x03"}, VARBINARY()),
+       makeNullableArrayVector<int32_t>({{{1}}, std::nullopt, {{2, 3}}})});
+  auto second = makeRowVector(
+      {"i", "d", "s", "b", "a"},
+      {makeNullableFlatVector<int64_t>({std::nullopt, 11}),
+       makeFlatVector<double>({0.25, 8.0}),
+       makeNullableFlatVector<std::string>({"zebra", "apple"}),
+       makeFlatVector<std::string>({"\x04", "\x05"}, VARBINARY()),
+       makeNullableArrayVector<int32_t>({std::nullopt, std::nullopt})});
+
+  VeloxColumnStats stats(asRowType(first->type()));
+  stats.add(first);
+  stats.add(second);
+  auto json = folly::parseJson(stats.toJson());
+
+  ASSERT_EQ(json["numRows"].asInt(), 5);
+  const auto& columns = json["columns"];
+  ASSERT_EQ(columns.size(), 5);
+
+  EXPECT_EQ(columns[0]["name"].asString(), "i");
+  EXPECT_EQ(columns[0]["nullCount"].asInt(), 2);
+  EXPECT_EQ(columns[0]["min"].asInt(), -7);
+  EXPECT_EQ(columns[0]["max"].asInt(), 11);
+  EXPECT_EQ(columns[0]["ndv"].asInt(), 3);
+
+  // NaN is counted as a value but bounds nothing.
+  EXPECT_EQ(columns[1]["nullCount"].asInt(), 0);
+  EXPECT_EQ(columns[1]["min"].asDouble(), -2.5);
+  EXPECT_EQ(columns[1]["max"].asDouble(), 8.0);
+  EXPECT_EQ(columns[1]["ndv"].asInt(), 5);
+
+  EXPECT_EQ(columns[2]["nullCount"].asInt(), 1);
+  EXPECT_EQ(columns[2]["min"].asString(), "apple");
+  EXPECT_EQ(columns[2]["max"].asString(), "zebra");
+  EXPECT_EQ(columns[2]["ndv"].asInt(), 3);
+
+  // No bounds of the binaries, only their NDV.
+  EXPECT_EQ(columns[3].count("min"), 0);
+  EXPECT_EQ(columns[3]["ndv"].asInt(), 5);
+
+  // Only the nulls of the complex types.
+  EXPECT_EQ(columns[4]["nullCount"].asInt(), 3);
+  EXPECT_EQ(columns[4].count("min"), 0);
+  EXPECT_EQ(columns[4].count("ndv"), 0);
+}
+
+TEST_F(VeloxColumnStatsTest, estimatesLargeNdv) {
+  constexpr int32_t kDistinct = 100'000;
+  // Each value twice.
+  auto batch = makeRowVector(
+      {"i", "s"},
+      {makeFlatVector<int32_t>(2 * kDistinct, [](auto row) { return row % kDistinct; }),
+       makeFlatVector<std::string>(2 * kDistinct, [](auto row) { return fmt::format("value-{}", row % kDistinct); })});
+  VeloxColumnStats stats(asRowType(batch->type()));
+  stats.add(batch);
+  auto json = folly::parseJson(stats.toJson());
+
+  for (const auto& column : json["columns"]) {
+    // About 1.6% of standard error.
+    EXPECT_NEAR(column["ndv"].asInt(), kDistinct, kDistinct * 0.05) << column["name"].asString();
+  }
+  EXPECT_EQ(json["columns"][0]["min"].asInt(), 0);
+  EXPECT_EQ(json["columns"][0]["max"].asInt(), kDistinct - 1);
+  EXPECT_EQ(json["columns"][1]["min"].asString(), "value-0");
+  EXPECT_EQ(json["columns"][1]["max"].asString(), "value-99999");
+}
+
+} // namespace gluten
@@ -59,4 +59,107 @@ TEST_F(VeloxColumnarBatchSerializerTest, serialize) {
   test::assertEqualVectors(vector, deserializedVector);
 }
 
+TEST_F(VeloxColumnarBatchSerializerTest, serializeCompressedBatches) {
+  auto first = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 3}),
+      makeFlatVector<StringView>({"alice", "bob", "Alice4uuudeuhdhfudhfudhfudhbvudubvudfvu"}),
+  });
+  auto second = makeRowVector({
+      makeConstant<int64_t>(7, 2),
+      makeNullableFlatVector<StringView>({std::nullopt, "carol"}),
+  });
+  auto serializer = std::make_shared<VeloxColumnarBatchSerializer>(
+      arrowPool_, veloxPool_, nullptr, nullptr, nullptr, arrow::Compression::ZSTD);
+  auto buffer = serializer->serializeColumnarBatches(
+      {std::make_shared<VeloxColumnarBatch>(first), std::make_shared<VeloxColumnarBatch>(second)});
+
+  ArrowSchema cSchema;
+  exportToArrow(first, cSchema);
+  auto deserializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_, veloxPool_, &cSchema);
+  auto deserialized =
+      deserializer->deserializeShared("relation-0", const_cast<uint8_t*>(buffer->data()), buffer->size());
+  auto expected = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 3, 7, 7}),
+      makeNullableFlatVector<StringView>(
+          {"alice", "bob", "Alice4uuudeuhdhfudhfudhfudhbvudubvudfvu", std::nullopt, "carol"}),
+  });
+  test::assertEqualVectors(expected, std::dynamic_pointer_cast<VeloxColumnarBatch>(deserialized)->getRowVector());
+
+  // Shared while held, each caller getting a row vector of its own.
+  auto again = deserializer->deserializeShared("relation-0", const_cast<uint8_t*>(buffer->data()), buffer->size());
+  auto againVector = std::dynamic_pointer_cast<VeloxColumnarBatch>(again)->getRowVector();
+  ASSERT_NE(std::dynamic_pointer_cast<VeloxColumnarBatch>(deserialized)->getRowVector(), againVector);
+  ASSERT_EQ(
+      std::dynamic_pointer_cast<VeloxColumnarBatch>(deserialized)->getRowVector()->childAt(1), againVector->childAt(1));
+}
+
+TEST_F(VeloxColumnarBatchSerializerTest, chargeSharedBatches) {
+  class CountingListener final : public AllocationListener {
+   public:
+    void allocationChanged(int64_t diff) override {
+      bytes += diff;
+    }
+    int64_t bytes = 0;
+  };
+  auto vector = makeRowVector({makeFlatVector<int64_t>(1000, [](auto row) { return row; })});
+  auto serializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_, veloxPool_, nullptr);
+  auto buffer = serializer->serializeColumnarBatches({std::make_shared<VeloxColumnarBatch>(vector)});
+
+  auto listener = std::make_shared<CountingListener>();
+  ListenableMemoryAllocator allocator(defaultMemoryAllocator().get(), listener);
+  ArrowSchema cSchema;
+  exportToArrow(vector, cSchema);
+  auto deserializer =
+      std::make_shared<VeloxColumnarBatchSerializer>(asArrowMemoryPool(&allocator), veloxPool_, &cSchema);
+  auto first = deserializer->deserializeShared("relation-1", const_cast<uint8_t*>(buffer->data()), buffer->size());
+  auto charged = listener->bytes;
+  ASSERT_GE(charged, 1000 * sizeof(int64_t));
+
+  // Each holder is charged.
+  auto second = deserializer->deserializeShared("relation-1", const_cast<uint8_t*>(buffer->data()), buffer->size());
+  ASSERT_EQ(listener->bytes, 2 * charged);
+  first.reset();
+  second.reset();
+  ASSERT_EQ(listener->bytes, 0);
+}
+
+TEST_F(VeloxColumnarBatchSerializerTest, serializeEncodedColumns) {
+  auto vector = makeRowVector({
+      makeConstant<int64_t>(7, 6),
+      makeFlatVector<StringView>({"red", "green", "red", "red", "green", "red"}),
+      makeNullableFlatVector<int32_t>({3, std::nullopt, -1, 8, 2, std::nullopt}),
+      makeNullableFlatVector<double>({std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt, 1.5}),
+  });
+  auto batch = std::make_shared<VeloxColumnarBatch>(vector);
+  auto serializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_, veloxPool_, nullptr);
+  auto buffer = serializer->serializeColumnarBatches({batch});
+
+  ArrowSchema cSchema;
+  exportToArrow(vector, cSchema);
+  auto deserializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_, veloxPool_, &cSchema);
+  auto deserialized = std::dynamic_pointer_cast<VeloxColumnarBatch>(
+      deserializer->deserialize(const_cast<uint8_t*>(buffer->data()), buffer->size()));
+  auto deserializedVector = deserialized->getRowVector();
+  test::assertEqualVectors(vector, deserializedVector);
+  ASSERT_EQ(deserializedVector->childAt(0)->encoding(), VectorEncoding::Simple::CONSTANT);
+  ASSERT_EQ(deserializedVector->childAt(1)->encoding(), VectorEncoding::Simple::DICTIONARY);
+
+  auto statistics = serializer->computeStatistics({batch});
+  ASSERT_EQ(statistics.size(), 4);
+  ASSERT_TRUE(statistics[0].hasBounds);
+  ASSERT_EQ(statistics[0].lowerBound, 7);
+  ASSERT_EQ(statistics[0].upperBound, 7);
+  ASSERT_FALSE(statistics[1].hasBounds);
+  ASSERT_TRUE(statistics[2].hasBounds);
+  ASSERT_EQ(statistics[2].lowerBound, -1);
+  ASSERT_EQ(statistics[2].upperBound, 8);
+  ASSERT_EQ(statistics[2].nullCount, 2);
+  ASSERT_TRUE(statistics[3].hasBounds);
+  ASSERT_EQ(statistics[3].nullCount, 5);
+
+  auto selected = std::dynamic_pointer_cast<VeloxColumnarBatch>(deserialized->select({2, 1}));
+  test::assertEqualVectors(makeRowVector({vector->childAt(2), vector->childAt(1)}), selected->getRowVector());
+  ASSERT_EQ(deserialized->select({})->numRows(), 6);
+}
+
 } // namespace gluten
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+class VeloxColumnarBatchTest : public ::testing::Test, public test::VectorTestBase {};
+
+TEST_F(VeloxColumnarBatchTest, flattenedSharesFlatChildren) {
+  auto ints = makeFlatVector<int32_t>({1, 2, 3});
+  auto strings = makeFlatVector<std::string>({"a", "b", "c"});
+  auto batch = std::make_shared<VeloxColumnarBatch>(makeRowVector({ints, strings}));
+  auto flattened = batch->getFlattenedRowVector();
+  ASSERT_EQ(flattened->childAt(0), ints);
+  ASSERT_EQ(flattened->childAt(1), strings);
+  ASSERT_EQ(batch->getFlattenedRowVector(), flattened);
+}
+
+TEST_F(VeloxColumnarBatchTest, flattenedCopiesEncodedChildren) {
+  auto dictionary = wrapInDictionary(makeIndices({2, 0}), makeFlatVector<int32_t>({1, 2, 3}));
+  auto array = makeArrayVector<int64_t>({{1, 2}, {3}});
+  auto rowVector = makeRowVector({dictionary, array});
+  auto batch = std::make_shared<VeloxColumnarBatch>(rowVector);
+  auto flattened = batch->getFlattenedRowVector();
+  ASSERT_EQ(flattened->childAt(0)->encoding(), VectorEncoding::Simple::FLAT);
+  ASSERT_NE(flattened->childAt(1), array);
+  test::assertEqualVectors(rowVector, flattened);
+
+  // Round trips through Arrow.
+  auto cSchema = batch->exportArrowSchema();
+  auto cArray = batch->exportArrowArray();
+  auto imported = importFromArrowAsOwner(*cSchema, *cArray, pool());
+  test::assertEqualVectors(rowVector, imported);
+}
+
+TEST_F(VeloxColumnarBatchTest, composeSharesChildren) {
+  auto pids = makeFlatVector<int32_t>({0, 1, 0});
+  auto ints = makeFlatVector<int64_t>({1, 2, 3});
+  auto strings = makeFlatVector<std::string>({"a", "b", "c"});
+  auto composite = CompositeColumnarBatch::create(
+      {std::make_shared<VeloxColumnarBatch>(makeRowVector({pids})),
+       std::make_shared<VeloxColumnarBatch>(makeRowVector({ints, strings}))});
+  auto composed = VeloxColumnarBatch::from(pool(), composite)->getRowVector();
+  ASSERT_EQ(composed->size(), 3);
+  ASSERT_EQ(composed->childrenSize(), 3);
+  ASSERT_EQ(composed->childAt(0), pids);
+  ASSERT_EQ(composed->childAt(1), ints);
+  ASSERT_EQ(composed->childAt(2), strings);
+}
+
+} // namespace gluten
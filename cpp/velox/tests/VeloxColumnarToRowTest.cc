@@ -22,6 +22,7 @@
 #include "operators/serializer/VeloxRowToColumnarConverter.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 using namespace facebook;
@@ -42,7 +43,6 @@ class VeloxColumnarToRowTest : public ::testing::Test, public test::VectorTestBa
     }
   }
 
- private:
   std::shared_ptr<velox::memory::MemoryPool> veloxPool_ = defaultLeafVeloxMemoryPool();
 };
 
@@ -92,4 +92,76 @@ TEST_F(VeloxColumnarToRowTest, Buffer_int64_int64_with_null) {
   };
   testRowBufferAddr(vector, expectArr, sizeof(expectArr));
 }
+
+TEST_F(VeloxColumnarToRowTest, reuseBuffer) {
+  auto columnarToRowConverter = std::make_shared<VeloxColumnarToRowConverter>(veloxPool_);
+  // Leaves non-zero bytes everywhere the next batches don't write.
+  columnarToRowConverter->convert(std::make_shared<VeloxColumnarBatch>(makeRowVector(
+      {makeFlatVector<bool>({true, true}), makeFlatVector<StringView>({"abcdefghijklmnopq", "abcdefghijklmnopq"})})));
+  auto* address = columnarToRowConverter->getBufferAddress();
+
+  columnarToRowConverter->convert(std::make_shared<VeloxColumnarBatch>(
+      makeRowVector({makeFlatVector<bool>({false, true}), makeFlatVector<StringView>({"aa", "bb"})})));
+  uint8_t expectArr[] = {
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 24, 0, 0, 0, 97, 97, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 24, 0, 0, 0, 98, 98, 0, 0, 0, 0, 0, 0,
+  };
+  ASSERT_EQ(columnarToRowConverter->getBufferAddress(), address);
+  ASSERT_EQ(columnarToRowConverter->getOffsets(), std::vector<int32_t>({0, 32}));
+  ASSERT_EQ(columnarToRowConverter->getLengths(), std::vector<int32_t>({32, 32}));
+  for (size_t i = 0; i < sizeof(expectArr); i++) {
+    ASSERT_EQ(*(address + i), *(expectArr + i));
+  }
+
+  columnarToRowConverter->convert(std::make_shared<VeloxColumnarBatch>(
+      makeRowVector({makeFlatVector<bool>({true}), makeNullableFlatVector<StringView>({std::nullopt})})));
+  uint8_t expectNullArr[] = {
+      2, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  };
+  ASSERT_EQ(columnarToRowConverter->getLengths(), std::vector<int32_t>({24}));
+  for (size_t i = 0; i < sizeof(expectNullArr); i++) {
+    ASSERT_EQ(*(address + i), *(expectNullArr + i));
+  }
+}
+
+TEST_F(VeloxColumnarToRowTest, parallel) {
+  std::vector<std::optional<std::string>> strings;
+  for (auto i = 0; i < 1000; ++i) {
+    strings.push_back(i % 7 == 0 ? std::nullopt : std::optional<std::string>(std::string(i % 20, 'a' + i % 26)));
+  }
+  auto vector =
+      makeRowVector({makeFlatVector<int64_t>(1000, [](auto row) { return row; }), makeNullableFlatVector(strings)});
+  auto serial = std::make_shared<VeloxColumnarToRowConverter>(veloxPool_);
+  serial->convert(std::make_shared<VeloxColumnarBatch>(vector));
+  folly::CPUThreadPoolExecutor executor(3);
+  auto parallel = std::make_shared<VeloxColumnarToRowConverter>(veloxPool_, nullptr, &executor, 3, 100);
+  parallel->convert(std::make_shared<VeloxColumnarBatch>(vector));
+
+  // The layout doesn't depend on the number of threads.
+  ASSERT_EQ(parallel->getOffsets(), serial->getOffsets());
+  ASSERT_EQ(parallel->getLengths(), serial->getLengths());
+  auto totalBytes = serial->getOffsets().back() + serial->getLengths().back();
+  ASSERT_EQ(memcmp(parallel->getBufferAddress(), serial->getBufferAddress(), totalBytes), 0);
+}
+
+TEST_F(VeloxColumnarToRowTest, arenaAllocator) {
+  auto arena = std::make_shared<ArenaMemoryAllocator>(defaultMemoryAllocator().get());
+  auto arenaPool = asAggregateVeloxMemoryPool(arena.get())->addLeafChild("columnar_to_row_arena");
+  auto columnarToRowConverter = std::make_shared<VeloxColumnarToRowConverter>(arenaPool, arena);
+
+  uint8_t expectArr[] = {
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+  };
+  // The arena is reset before each batch, so the buffer of every batch comes from the same chunk.
+  for (int i = 0; i < 3; ++i) {
+    auto vector = makeRowVector({makeFlatVector<int32_t>({1, 2}), makeFlatVector<int64_t>({1, 2})});
+    columnarToRowConverter->convert(std::make_shared<VeloxColumnarBatch>(vector));
+    uint8_t* address = columnarToRowConverter->getBufferAddress();
+    for (size_t j = 0; j < sizeof(expectArr); j++) {
+      ASSERT_EQ(*(address + j), *(expectArr + j));
+    }
+    ASSERT_EQ(arena->getBytes(), ArenaMemoryAllocator::kDefaultChunkSize);
+  }
+}
 } // namespace gluten
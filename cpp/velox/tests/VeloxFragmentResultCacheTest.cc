@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "compute/VeloxFragmentResultCache.h"
+
+namespace gluten {
+
+namespace {
+// A scan of a file modified at modificationTime, filtered with the function.
+::substrait::Plan
+makePlan(const std::string& path, uint64_t modificationTime, const std::string& function = "gt:i32_i32") {
+  ::substrait::Plan plan;
+  plan.add_extensions()->mutable_extension_function()->set_name(function);
+  auto* read = plan.add_relations()->mutable_root()->mutable_input()->mutable_filter()->mutable_input()->mutable_read();
+  auto* file = read->mutable_local_files()->add_items();
+  file->set_uri_file(path);
+  file->set_start(0);
+  file->set_length(100);
+  file->set_modification_time(modificationTime);
+  file->mutable_parquet();
+  return plan;
+}
+
+std::shared_ptr<VeloxFragmentResultCache::Entry> makeEntry(int64_t bytes) {
+  auto entry = std::make_shared<VeloxFragmentResultCache::Entry>();
+  entry->bytes = bytes;
+  return entry;
+}
+} // namespace
+
+TEST(VeloxFragmentResultCacheTest, keyOfFiles) {
+  std::unordered_map<std::string, std::string> conf{{"k", "v"}};
+  auto key = VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/a", 1000), conf);
+  ASSERT_TRUE(key.has_value());
+  ASSERT_EQ(VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/a", 1000), conf), key);
+  ASSERT_NE(VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/a", 2000), conf), key);
+  ASSERT_NE(VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/b", 1000), conf), key);
+  ASSERT_NE(VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/a", 1000), {{"k", "w"}}), key);
+
+  // Files without a modification time aren't told apart from changed ones.
+  ASSERT_FALSE(VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/a", 0), conf).has_value());
+  ASSERT_FALSE(VeloxFragmentResultCache::makeKey(makePlan("iterator:0", 0), conf).has_value());
+  ASSERT_FALSE(VeloxFragmentResultCache::makeKey(makePlan("hdfs://namenode:8020/a", 1000, "rand:i64"), conf));
+}
+
+TEST(VeloxFragmentResultCacheTest, evictLeastRecentlyUsed) {
+  VeloxFragmentResultCache cache;
+  cache.setMaxBytes(100, 60);
+  cache.put("a", makeEntry(40));
+  cache.put("b", makeEntry(40));
+  ASSERT_NE(cache.get("a"), nullptr);
+  cache.put("c", makeEntry(40));
+  ASSERT_EQ(cache.get("b"), nullptr);
+  ASSERT_NE(cache.get("a"), nullptr);
+  ASSERT_NE(cache.get("c"), nullptr);
+  ASSERT_EQ(cache.usedBytes(), 80);
+
+  // Over the size of an entry.
+  cache.put("d", makeEntry(70));
+  ASSERT_EQ(cache.get("d"), nullptr);
+  ASSERT_EQ(cache.usedBytes(), 80);
+
+  cache.setMaxBytes(0, 0);
+  ASSERT_EQ(cache.get("a"), nullptr);
+  ASSERT_EQ(cache.usedBytes(), 0);
+  cache.put("a", makeEntry(1));
+  ASSERT_EQ(cache.get("a"), nullptr);
+}
+
+} // namespace gluten
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "compute/VeloxPlanCache.h"
+
+namespace gluten {
+
+namespace {
+// A join of two scans, the right one of the given files.
+::substrait::Plan makePlan(const std::vector<std::string>& rightFiles, bool orc = false) {
+  ::substrait::Plan plan;
+  auto* join = plan.add_relations()->mutable_root()->mutable_input()->mutable_join();
+  auto addFile = [](::substrait::ReadRel* read, const std::string& path, bool orc) {
+    auto* file = read->mutable_local_files()->add_items();
+    file->set_uri_file(path);
+    file->set_start(0);
+    file->set_length(100);
+    auto* partitionColumn = file->add_partition_columns();
+    partitionColumn->set_key("p");
+    partitionColumn->set_value(path);
+    if (orc) {
+      file->mutable_orc();
+    } else {
+      file->mutable_parquet();
+    }
+  };
+  addFile(join->mutable_left()->mutable_read(), "file:///left", false);
+  auto* right = join->mutable_right()->mutable_filter()->mutable_input()->mutable_read();
+  right->mutable_base_schema()->add_names("a");
+  for (const auto& path : rightFiles) {
+    addFile(right, path, orc);
+  }
+  return plan;
+}
+} // namespace
+
+TEST(VeloxPlanCacheTest, keyStripsFiles) {
+  std::unordered_map<std::string, std::string> conf{{"k", "v"}};
+  auto key = VeloxPlanCache::makeKey(makePlan({"file:///a", "file:///b"}), conf);
+  ASSERT_TRUE(key.has_value());
+  ASSERT_EQ(VeloxPlanCache::makeKey(makePlan({"file:///c"}), conf), key);
+  // The format and the confs take part in the conversion.
+  ASSERT_NE(VeloxPlanCache::makeKey(makePlan({"file:///a"}, true), conf), key);
+  ASSERT_NE(VeloxPlanCache::makeKey(makePlan({"file:///a"}), {{"k", "w"}}), key);
+  // No file is not the same as some files of unknown format.
+  ASSERT_NE(VeloxPlanCache::makeKey(makePlan({}), conf), key);
+  // Input streams are bound to the task.
+  ASSERT_FALSE(VeloxPlanCache::makeKey(makePlan({"iterator:0"}), conf).has_value());
+}
+
+TEST(VeloxPlanCacheTest, readRelsInPlanOrder) {
+  auto plan = makePlan({"file:///a", "file:///b"});
+  auto readRels = VeloxPlanCache::readRels(plan);
+  ASSERT_EQ(readRels.size(), 2);
+  ASSERT_EQ(readRels[0]->local_files().items(0).uri_file(), "file:///left");
+  ASSERT_EQ(readRels[1]->local_files().items_size(), 2);
+}
+
+TEST(VeloxPlanCacheTest, evictLeastRecentlyUsed) {
+  VeloxPlanCache cache;
+  cache.setCapacity(2);
+  auto entry = [](const std::string& scanNodeId) {
+    auto entry = std::make_shared<VeloxPlanCache::Entry>();
+    entry->scanNodeIds.push_back(scanNodeId);
+    return entry;
+  };
+  cache.put("a", entry("0"));
+  cache.put("b", entry("1"));
+  ASSERT_EQ(cache.get("a")->scanNodeIds[0], "0");
+  cache.put("c", entry("2"));
+  ASSERT_EQ(cache.get("b"), nullptr);
+  ASSERT_NE(cache.get("a"), nullptr);
+  ASSERT_NE(cache.get("c"), nullptr);
+  ASSERT_EQ(cache.numHits(), 3);
+  ASSERT_EQ(cache.numMisses(), 1);
+
+  cache.setCapacity(0);
+  ASSERT_EQ(cache.get("a"), nullptr);
+  cache.put("a", entry("0"));
+  ASSERT_EQ(cache.get("a"), nullptr);
+}
+
+} // namespace gluten
@@ -97,4 +97,22 @@ TEST_F(VeloxRowToColumnarTest, allTypes) {
   });
   testRowVectorEqual(vector);
 }
+
+TEST_F(VeloxRowToColumnarTest, flatSchemaLongStrings) {
+  auto vector = makeRowVector({
+      makeNullableFlatVector<int16_t>({1, std::nullopt, -3}),
+      makeNullableFlatVector<double>({std::nullopt, 0.5, -1.25}),
+      makeNullableFlatVector<velox::StringView>({"a string longer than inlined", std::nullopt, ""}),
+  });
+  testRowVectorEqual(vector);
+}
+
+TEST_F(VeloxRowToColumnarTest, nestedTypes) {
+  // Not a flat schema, goes through the generic deserialization.
+  auto vector = makeRowVector({
+      makeNullableFlatVector<int32_t>({1, std::nullopt, 3}),
+      makeArrayVector<int64_t>({{1, 2}, {}, {3}}),
+  });
+  testRowVectorEqual(vector);
+}
 } // namespace gluten
@@ -16,8 +16,10 @@
  */
 
 #include "shuffle/VeloxShuffleWriter.h"
+#include "memory/ArrowMemoryPool.h"
 #include "memory/VeloxColumnarBatch.h"
 #include "memory/VeloxMemoryPool.h"
+#include "utils/ArrowTypeUtils.h"
 #include "utils/TestUtils.h"
 #include "utils/VeloxArrowUtils.h"
 #include "velox/vector/arrow/Bridge.h"
@@ -33,11 +35,17 @@
 #include <arrow/record_batch.h>
 #include <arrow/util/io_util.h>
 #include <execinfo.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <unordered_set>
 
 #include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/SparkMurmur3Hash.h"
 #include "shuffle/VeloxShuffleReader.h"
+#include "shuffle/rss/CelebornPartitionWriter.h"
 
 using namespace facebook;
 using namespace facebook::velox;
@@ -140,11 +148,13 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
   }
 
   arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchReader>> getRecordBatchStreamReader(
-      const std::string& fileName) {
+      const std::string& fileName,
+      int64_t offset = 0) {
     if (file_ != nullptr && !file_->closed()) {
       RETURN_NOT_OK(file_->Close());
     }
     ARROW_ASSIGN_OR_RAISE(file_, arrow::io::ReadableFile::Open(fileName))
+    RETURN_NOT_OK(file_->Seek(offset));
     ARROW_ASSIGN_OR_RAISE(auto fileReader, arrow::ipc::RecordBatchStreamReader::Open(file_))
     return fileReader;
   }
@@ -175,7 +185,10 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
   }
 
   // 1 partitionLength
-  void testShuffleWrite(VeloxShuffleWriter& shuffleWriter, std::vector<velox::RowVectorPtr> vectors) {
+  void testShuffleWrite(
+      VeloxShuffleWriter& shuffleWriter,
+      std::vector<velox::RowVectorPtr> vectors,
+      ZstdDictionaryCache* dictionaries = nullptr) {
     for (auto& vector : vectors) {
       splitRowVector(shuffleWriter, vector);
     }
@@ -196,13 +209,45 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
     std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
     ASSERT_NOT_OK(fileReader->ReadAll(&batches));
     ASSERT_EQ(batches.size(), vectors.size());
+    ZstdDictionaryCache ownDictionaries;
     for (int32_t i = 0; i < batches.size(); i++) {
       auto deserialized = VeloxShuffleReader::readRowVector(
-          *batches[i], asRowType(vectors[i]->type()), CodecBackend::NONE, arrowPool_.get(), pool_.get());
+          *batches[i],
+          asRowType(vectors[i]->type()),
+          CodecBackend::NONE,
+          arrowPool_.get(),
+          pool_.get(),
+          dictionaries != nullptr ? dictionaries : &ownDictionaries);
       velox::test::assertEqualVectors(vectors[i], deserialized);
     }
   }
 
+  // The blocks of each partition read back from the data file of the stopped writer.
+  std::vector<std::vector<velox::RowVectorPtr>> readPartitionBlocks(
+      VeloxShuffleWriter& shuffleWriter,
+      const TypePtr& dataType) {
+    const auto& lengths = shuffleWriter.partitionLengths();
+    auto expectedSchema = getExpectedSchema(shuffleWriter);
+    std::vector<std::vector<velox::RowVectorPtr>> blocks(lengths.size());
+    int64_t offset = 0;
+    for (int32_t i = 0; i < lengths.size(); i++) {
+      if (lengths[i] == 0) {
+        continue;
+      }
+      // Each partition starts with the schema.
+      GLUTEN_ASSIGN_OR_THROW(auto fileReader, getRecordBatchStreamReader(shuffleWriter.dataFile(), offset));
+      offset += lengths[i];
+      EXPECT_TRUE(fileReader->schema()->Equals(expectedSchema, true));
+      std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+      GLUTEN_THROW_NOT_OK(fileReader->ReadAll(&batches));
+      for (const auto& batch : batches) {
+        blocks[i].push_back(VeloxShuffleReader::readRowVector(
+            *batch, asRowType(dataType), CodecBackend::NONE, arrowPool_.get(), pool_.get()));
+      }
+    }
+    return blocks;
+  }
+
   void shuffleWriteReadMultiBlocks(
       VeloxShuffleWriter& shuffleWriter,
       int32_t expectPartitionLength,
@@ -213,30 +258,16 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
     checkFileExists(shuffleWriter.dataFile());
     // verify output temporary files
     const auto& lengths = shuffleWriter.partitionLengths();
-    auto expectedSchema = getExpectedSchema(shuffleWriter);
     ASSERT_EQ(lengths.size(), expectPartitionLength);
     int64_t lengthSum = std::accumulate(lengths.begin(), lengths.end(), 0);
 
-    // verify schema
+    auto blocks = readPartitionBlocks(shuffleWriter, dataType);
+    ASSERT_EQ(*file_->GetSize(), lengthSum);
     for (int32_t i = 0; i < expectPartitionLength; i++) {
-      std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
-      GLUTEN_ASSIGN_OR_THROW(auto fileReader, getRecordBatchStreamReader(shuffleWriter_->dataFile()));
-      if (i == 0) {
-        ASSERT_EQ(*file_->GetSize(), lengthSum);
-      }
-      ASSERT_TRUE(fileReader->schema()->Equals(expectedSchema, true));
-      if (i != 0) {
-        ASSERT_NOT_OK(file_->Advance(lengths[i - 1]));
-      }
-      ASSERT_NOT_OK(fileReader->ReadAll(&batches));
-      // ASSERT_EQ(batches.size(), vectors.size()); //input batch may be empty
-      ASSERT_EQ(expectedVectors[i].size(), batches.size());
-      // auto partitionVectors = std::move(expectedVectors[i]);
-      ASSERT_EQ(expectedVectors[i].size(), batches.size());
-      for (int32_t j = 0; j < batches.size(); j++) {
-        auto deserialized = VeloxShuffleReader::readRowVector(
-            *batches[j], asRowType(dataType), CodecBackend::NONE, arrowPool_.get(), pool_.get());
-        velox::test::assertEqualVectors(expectedVectors[i][j], deserialized);
+      // The input batch may be empty.
+      ASSERT_EQ(expectedVectors[i].size(), blocks[i].size());
+      for (int32_t j = 0; j < blocks[i].size(); j++) {
+        velox::test::assertEqualVectors(expectedVectors[i][j], blocks[i][j]);
       }
     }
   }
@@ -309,6 +340,196 @@ TEST_P(VeloxShuffleWriterTest, singlePart3Vectors) {
   testShuffleWrite(*shuffleWriter, {inputVector1_, inputVector2_, inputVector1_});
 }
 
+TEST_P(VeloxShuffleWriterTest, readDecompressIntoSlab) {
+  shuffleWriterOptions_.buffer_size = 10;
+  shuffleWriterOptions_.partitioning_name = "single";
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  splitRowVector(*shuffleWriter_, inputVector2_);
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  ARROW_ASSIGN_OR_THROW(auto in, arrow::io::ReadableFile::Open(shuffleWriter_->dataFile()));
+  auto options = ReaderOptions::defaults();
+  options.compression_type = shuffleWriterOptions_.compression_type;
+  options.decompress_into_slab = true;
+  auto reader =
+      std::make_shared<VeloxShuffleReader>(in, toArrowSchema(inputVector1_->type()), options, arrowPool_, pool_);
+
+  // Keep the first batch alive while reading the others, so that its slab must not be reused.
+  ARROW_ASSIGN_OR_THROW(auto first, reader->next());
+  ASSERT_NE(first, nullptr);
+  std::vector<velox::RowVectorPtr> expected = {inputVector2_, inputVector1_};
+  for (const auto& vector : expected) {
+    ARROW_ASSIGN_OR_THROW(auto batch, reader->next());
+    ASSERT_NE(batch, nullptr);
+    velox::test::assertEqualVectors(vector, std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector());
+  }
+  ARROW_ASSIGN_OR_THROW(auto eos, reader->next());
+  ASSERT_EQ(eos, nullptr);
+  velox::test::assertEqualVectors(inputVector1_, std::dynamic_pointer_cast<VeloxColumnarBatch>(first)->getRowVector());
+}
+
+TEST_P(VeloxShuffleWriterTest, readPrefetchAndMerge) {
+  shuffleWriterOptions_.buffer_size = 10;
+  shuffleWriterOptions_.partitioning_name = "single";
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  splitRowVector(*shuffleWriter_, inputVector2_);
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  folly::CPUThreadPoolExecutor executor(4);
+  ARROW_ASSIGN_OR_THROW(auto in, arrow::io::ReadableFile::Open(shuffleWriter_->dataFile()));
+  auto options = ReaderOptions::defaults();
+  options.compression_type = shuffleWriterOptions_.compression_type;
+  options.prefetch_blocks = 2;
+  // The first two batches are merged, the last one is returned alone at the end of the stream.
+  options.merge_batch_rows = inputVector1_->size() + inputVector2_->size();
+  auto reader = std::make_shared<VeloxShuffleReader>(
+      in, toArrowSchema(inputVector1_->type()), options, arrowPool_, pool_, &executor);
+
+  auto expected = takeRows(inputVector1_, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  expected->append(inputVector2_.get());
+  ARROW_ASSIGN_OR_THROW(auto merged, reader->next());
+  ASSERT_NE(merged, nullptr);
+  velox::test::assertEqualVectors(expected, std::dynamic_pointer_cast<VeloxColumnarBatch>(merged)->getRowVector());
+  ARROW_ASSIGN_OR_THROW(auto last, reader->next());
+  ASSERT_NE(last, nullptr);
+  velox::test::assertEqualVectors(inputVector1_, std::dynamic_pointer_cast<VeloxColumnarBatch>(last)->getRowVector());
+  ARROW_ASSIGN_OR_THROW(auto eos, reader->next());
+  ASSERT_EQ(eos, nullptr);
+}
+
+// Records whether the stream is read off the thread that created it, and fails the reads past failAfter bytes.
+class TaskThreadInputStream final : public arrow::io::InputStream {
+ public:
+  TaskThreadInputStream(std::shared_ptr<arrow::io::InputStream> in, int64_t failAfter)
+      : in_(std::move(in)), failAfter_(failAfter) {}
+
+  arrow::Status Close() override {
+    return in_->Close();
+  }
+
+  bool closed() const override {
+    return in_->closed();
+  }
+
+  arrow::Result<int64_t> Tell() const override {
+    return in_->Tell();
+  }
+
+  arrow::Result<int64_t> Read(int64_t nbytes, void* out) override {
+    RETURN_NOT_OK(check(nbytes));
+    return in_->Read(nbytes, out);
+  }
+
+  arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override {
+    RETURN_NOT_OK(check(nbytes));
+    return in_->Read(nbytes);
+  }
+
+  bool readOffThread() const {
+    return readOffThread_;
+  }
+
+ private:
+  arrow::Status check(int64_t nbytes) {
+    readOffThread_ |= std::this_thread::get_id() != thread_;
+    ARROW_ASSIGN_OR_RAISE(auto position, in_->Tell());
+    if (position + nbytes > failAfter_) {
+      return arrow::Status::IOError("Fetch failed.");
+    }
+    return arrow::Status::OK();
+  }
+
+  std::shared_ptr<arrow::io::InputStream> in_;
+  int64_t failAfter_;
+  std::thread::id thread_ = std::this_thread::get_id();
+  std::atomic<bool> readOffThread_{false};
+};
+
+TEST_P(VeloxShuffleWriterTest, readPrefetchOnTaskThread) {
+  shuffleWriterOptions_.buffer_size = 10;
+  shuffleWriterOptions_.partitioning_name = "single";
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+  for (int32_t i = 0; i < 4; ++i) {
+    splitRowVector(*shuffleWriter_, inputVector1_);
+  }
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  folly::CPUThreadPoolExecutor executor(4);
+  auto options = ReaderOptions::defaults();
+  options.compression_type = shuffleWriterOptions_.compression_type;
+  options.prefetch_blocks = 2;
+  auto length = shuffleWriter_->partitionLengths()[0];
+  auto openReader = [&](int64_t failAfter) {
+    ARROW_ASSIGN_OR_THROW(auto file, arrow::io::ReadableFile::Open(shuffleWriter_->dataFile()));
+    auto in = std::make_shared<TaskThreadInputStream>(file, failAfter);
+    auto reader = std::make_shared<VeloxShuffleReader>(
+        in, toArrowSchema(inputVector1_->type()), options, arrowPool_, pool_, &executor);
+    return std::make_pair(in, reader);
+  };
+
+  // Only the blocks are decoded on the executor.
+  auto [in, reader] = openReader(length);
+  for (int32_t i = 0; i < 4; ++i) {
+    ARROW_ASSIGN_OR_THROW(auto batch, reader->next());
+    ASSERT_NE(batch, nullptr);
+    auto vector = std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector();
+    velox::test::assertEqualVectors(inputVector1_, vector);
+  }
+  ARROW_ASSIGN_OR_THROW(auto eos, reader->next());
+  ASSERT_EQ(eos, nullptr);
+  ASSERT_FALSE(in->readOffThread());
+
+  // A failed read is raised, not taken for the end of the stream.
+  auto [failingIn, failingReader] = openReader(length / 2);
+  ASSERT_THROW(
+      {
+        while (true) {
+          ARROW_ASSIGN_OR_THROW(auto batch, failingReader->next());
+          if (batch == nullptr) {
+            break;
+          }
+        }
+      },
+      GlutenException);
+  ASSERT_FALSE(failingIn->readOffThread());
+}
+
+TEST_P(VeloxShuffleWriterTest, pushMergeChunks) {
+  shuffleWriterOptions_.buffer_size = 10;
+  shuffleWriterOptions_.partitioning_name = "single";
+  // Every payload fills a chunk.
+  shuffleWriterOptions_.push_merge_chunk_size = 1;
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  splitRowVector(*shuffleWriter_, inputVector2_);
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  const auto& chunkLengths = shuffleWriter_->partitionChunkLengths();
+  ASSERT_EQ(chunkLengths.size(), 3);
+  ASSERT_EQ(std::accumulate(chunkLengths.begin(), chunkLengths.end(), 0L), shuffleWriter_->partitionLengths()[0]);
+
+  // Each chunk ends with EOS, the merged chunks read as one stream.
+  ARROW_ASSIGN_OR_THROW(auto in, arrow::io::ReadableFile::Open(shuffleWriter_->dataFile()));
+  auto options = ReaderOptions::defaults();
+  options.compression_type = shuffleWriterOptions_.compression_type;
+  options.read_merged_chunks = true;
+  auto reader =
+      std::make_shared<VeloxShuffleReader>(in, toArrowSchema(inputVector1_->type()), options, arrowPool_, pool_);
+  std::vector<velox::RowVectorPtr> expected = {inputVector1_, inputVector2_, inputVector1_};
+  for (const auto& vector : expected) {
+    ARROW_ASSIGN_OR_THROW(auto batch, reader->next());
+    ASSERT_NE(batch, nullptr);
+    velox::test::assertEqualVectors(vector, std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector());
+  }
+  ARROW_ASSIGN_OR_THROW(auto eos, reader->next());
+  ASSERT_EQ(eos, nullptr);
+}
+
 TEST_P(VeloxShuffleWriterTest, singlePartCompressSmallBuffer) {
   shuffleWriterOptions_.buffer_size = 10;
   shuffleWriterOptions_.partitioning_name = "single";
@@ -321,6 +542,88 @@ TEST_P(VeloxShuffleWriterTest, singlePartCompressSmallBuffer) {
   testShuffleWrite(*shuffleWriter, {inputVector1_, inputVector1_});
 }
 
+TEST_P(VeloxShuffleWriterTest, singlePartAdaptiveCompression) {
+  shuffleWriterOptions_.buffer_size = 4096;
+  shuffleWriterOptions_.partitioning_name = "single";
+  shuffleWriterOptions_.adaptive_compression = true;
+
+  GLUTEN_ASSIGN_OR_THROW(
+      auto shuffleWriter, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Narrow ranged ints to bit pack, repetitive strings to compress and pseudo random ones to keep raw.
+  auto vector = makeRowVector({
+      makeFlatVector<int32_t>(4096, [](vector_size_t row) { return 1000 + row % 7; }),
+      makeFlatVector<int64_t>(
+          4096, [](vector_size_t row) { return -5 + row % 11; }, nullEvery(13)),
+      makeFlatVector<velox::StringView>(4096, [](vector_size_t row) { return "gluten shuffle"; }),
+      makeFlatVector<int64_t>(
+          4096, [](vector_size_t row) { return static_cast<int64_t>((row + 1) * 0x9e3779b97f4a7c15ULL); }),
+  });
+  testShuffleWrite(*shuffleWriter, {vector, vector});
+}
+
+TEST_P(VeloxShuffleWriterTest, singlePartZstdDictionary) {
+  shuffleWriterOptions_.buffer_size = 256;
+  shuffleWriterOptions_.partitioning_name = "single";
+  shuffleWriterOptions_.compression_type = arrow::Compression::ZSTD;
+  shuffleWriterOptions_.adaptive_compression = true;
+  shuffleWriterOptions_.zstd_dictionary_training_buffers = 8;
+
+  GLUTEN_ASSIGN_OR_THROW(
+      auto shuffleWriter, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Later batches are compressed with the dictionaries trained from the earlier ones.
+  std::vector<velox::RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 16; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<velox::StringView>(
+            256,
+            [i](vector_size_t row) {
+              return velox::StringView(fmt::format("shuffle key {} of batch {}", row % 17, (i * 31 + row) % 97));
+            }),
+    }));
+  }
+  testShuffleWrite(*shuffleWriter, vectors);
+}
+
+TEST_P(VeloxShuffleWriterTest, zstdDictionariesOfTwoMapTasks) {
+  shuffleWriterOptions_.buffer_size = 256;
+  shuffleWriterOptions_.partitioning_name = "single";
+  shuffleWriterOptions_.compression_type = arrow::Compression::ZSTD;
+  shuffleWriterOptions_.adaptive_compression = true;
+  shuffleWriterOptions_.zstd_dictionary_training_buffers = 8;
+
+  // The outputs of two map tasks read through the dictionaries of one reader, each with its own dictionaries.
+  ZstdDictionaryCache dictionaries;
+  for (const auto* prefix : {"shuffle key", "other key"}) {
+    GLUTEN_ASSIGN_OR_THROW(
+        auto shuffleWriter, VeloxShuffleWriter::create(1, partitionWriterCreator_, shuffleWriterOptions_))
+    std::vector<velox::RowVectorPtr> vectors;
+    for (int32_t i = 0; i < 16; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<velox::StringView>(
+              256,
+              [prefix, i](vector_size_t row) {
+                return velox::StringView(fmt::format("{} {} of batch {}", prefix, row % 17, (i * 31 + row) % 97));
+              }),
+      }));
+    }
+    testShuffleWrite(*shuffleWriter, vectors, &dictionaries);
+  }
+}
+
+TEST(ZstdDictionaryCacheTest, sameIdOfTwoScopes) {
+  ZstdDictionaryCache dictionaries;
+  const std::string first = "shuffle key of the first map task";
+  const std::string second = "shuffle key of the second map task";
+  auto data = [](const std::string& bytes) { return reinterpret_cast<const uint8_t*>(bytes.data()); };
+  ASSERT_TRUE(dictionaries.add(1, 7, data(first), first.size()).ok());
+  ASSERT_TRUE(dictionaries.add(1, 7, data(first), first.size()).ok());
+  ASSERT_TRUE(dictionaries.add(2, 7, data(second), second.size()).ok());
+  // A different dictionary under a known scope and id is never used in place of the first one.
+  ASSERT_TRUE(dictionaries.add(1, 7, data(second), second.size()).IsInvalid());
+}
+
 TEST_P(VeloxShuffleWriterTest, singlePartNullVector) {
   shuffleWriterOptions_.buffer_size = 10;
   shuffleWriterOptions_.partitioning_name = "single";
@@ -488,6 +791,60 @@ TEST_P(VeloxShuffleWriterTest, hashPart1VectorComplexType) {
   testShuffleWriteMultiBlocks(*shuffleWriter_, {vector}, 2, dataVector->type(), {{firstBlock}, {secondBlock}});
 }
 
+TEST_P(VeloxShuffleWriterTest, hashPartComplexTypeAcrossBatches) {
+  shuffleWriterOptions_.buffer_size = 8;
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Partition 0 gets the keys 2 and 4, the runs of rows 0-1, 3-4 and 7, partition 1 the keys 1 and 3, see
+  // hashPartitionKeys.
+  auto keys = makeFlatVector<int64_t>({2, 2, 1, 4, 4, 1, 3, 2});
+  std::vector<int32_t> rows0 = {0, 1, 3, 4, 7};
+  std::vector<int32_t> rows1 = {2, 5, 6};
+  auto makeVector = [&](int32_t base) {
+    return makeRowVector({
+        keys,
+        makeArrayVector<int64_t>(
+            8, [](auto row) { return row % 3; }, [base](auto index) { return base + index; }, nullEvery(4)),
+        makeMapVector<int32_t, int64_t>(
+            8,
+            [](auto row) { return row % 2 + 1; },
+            [base](auto index) { return base + index; },
+            [](auto index) { return index * 10; },
+            nullEvery(5)),
+        makeRowVector(
+            {makeFlatVector<int32_t>(8, [base](auto row) { return base + row; }),
+             makeFlatVector<std::string>(
+                 8, [base](auto row) { return fmt::format("row {} of a struct, not inlined", base + row); })},
+            nullEvery(3)),
+    });
+  };
+  auto first = makeVector(0);
+  auto second = makeVector(100);
+  auto third = makeVector(200);
+
+  // A payload gathers the rows of the vectors that fit into the partition buffers.
+  for (const auto& vector : {first, second, third}) {
+    splitRowVector(*shuffleWriter_, vector);
+  }
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  auto blocks = readPartitionBlocks(*shuffleWriter_, first->type());
+  for (int32_t pid = 0; pid < 2; ++pid) {
+    const auto& rows = pid == 0 ? rows0 : rows1;
+    auto expected = takeRows(first, rows);
+    expected->append(takeRows(second, rows).get());
+    expected->append(takeRows(third, rows).get());
+    auto read = RowVector::createEmpty(first->type(), pool());
+    for (const auto& block : blocks[pid]) {
+      read->append(block.get());
+    }
+    velox::test::assertEqualVectors(expected, read);
+  }
+}
+
 TEST_P(VeloxShuffleWriterTest, hashPart3Vectors) {
   shuffleWriterOptions_.buffer_size = 4;
   shuffleWriterOptions_.partitioning_name = "hash";
@@ -506,6 +863,419 @@ TEST_P(VeloxShuffleWriterTest, hashPart3Vectors) {
       2,
       inputVector1_->type(),
       {{block1Pid2, block2Pid2, block1Pid2}, {block1Pid1, block1Pid1}});
+
+  auto phaseTimes = shuffleWriter_->splitPhaseTimes();
+  ASSERT_EQ(phaseTimes.size(), VeloxShuffleWriter::kNumSplitPhases);
+  ASSERT_EQ(phaseTimes[VeloxShuffleWriter::kComputePid].first, "computePidTime");
+  ASSERT_GT(phaseTimes[VeloxShuffleWriter::kComputePid].second, 0);
+  ASSERT_GT(phaseTimes[VeloxShuffleWriter::kSplitFixedWidth].second, 0);
+  ASSERT_GT(phaseTimes[VeloxShuffleWriter::kCreatePayload].second, 0);
+}
+
+TEST_P(VeloxShuffleWriterTest, parallelSplitHashPart3Vectors) {
+  // The long string of inputVector2_ outgrows the value buffer, which is reserved before the split fans out.
+  folly::CPUThreadPoolExecutor splitExecutor(3);
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.num_split_threads = 3;
+  shuffleWriterOptions_.split_executor = &splitExecutor;
+  shuffleWriterOptions_.parallel_split_threshold = 1;
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 5, 6, 7, 9});
+  auto block1Pid2 = takeRows(inputVector1_, {1, 2, 3, 4, 8});
+  auto block2Pid2 = takeRows(inputVector2_, {0, 1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter_,
+      {hashInputVector1_, hashInputVector2_, hashInputVector1_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid2, block2Pid2, block1Pid2}, {block1Pid1, block1Pid1}});
+}
+
+TEST_P(VeloxShuffleWriterTest, hashPartitionKeys) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Spark: pmod(hash(1L), 2) = 1, pmod(hash(2L), 2) = 0, pmod(hash(3L), 2) = 1, pmod(hash(4L), 2) = 0.
+  auto keys = wrapInDictionary(makeIndices({1, 0, 3, 2, 0, 1}), 6, makeFlatVector<int64_t>({1, 2, 3, 4}));
+  auto vector = makeRowVector({keys, makeFlatVector<velox::StringView>({"a", "b", "c", "d", "e", "f"})});
+
+  auto firstBlock = makeRowVector({
+      makeFlatVector<int64_t>({2, 4, 2}),
+      makeFlatVector<velox::StringView>({"a", "c", "f"}),
+  });
+  auto secondBlock = makeRowVector({
+      makeFlatVector<int64_t>({1, 3, 1}),
+      makeFlatVector<velox::StringView>({"b", "d", "e"}),
+  });
+
+  testShuffleWriteMultiBlocks(*shuffleWriter_, {vector}, 2, firstBlock->type(), {{firstBlock}, {secondBlock}});
+}
+
+TEST_P(VeloxShuffleWriterTest, hashPartSkewedKeys) {
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Partition 0 gets five rows of each vector and partition 1 one, the buffers of each are sized by its own rows.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>({2, 4, 2, 2, 4, 1}),
+      makeFlatVector<velox::StringView>({"a", "bb", "ccc", "dddd", "eeeee", "ffffffffffffffffffff"}),
+  });
+  std::vector<int64_t> hotKeys;
+  std::vector<velox::StringView> hotStrings;
+  std::vector<int64_t> coldKeys;
+  std::vector<velox::StringView> coldStrings;
+  for (auto i = 0; i < 8; ++i) {
+    hotKeys.insert(hotKeys.end(), {2, 4, 2, 2, 4});
+    hotStrings.insert(hotStrings.end(), {"a", "bb", "ccc", "dddd", "eeeee"});
+    coldKeys.push_back(1);
+    coldStrings.push_back("ffffffffffffffffffff");
+  }
+  auto hotBlock = makeRowVector({makeFlatVector<int64_t>(hotKeys), makeFlatVector<velox::StringView>(hotStrings)});
+  auto coldBlock = makeRowVector({makeFlatVector<int64_t>(coldKeys), makeFlatVector<velox::StringView>(coldStrings)});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter_, std::vector<velox::RowVectorPtr>(8, vector), 2, vector->type(), {{hotBlock}, {coldBlock}});
+}
+
+TEST_P(VeloxShuffleWriterTest, rangePartitionBounds) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "range";
+  shuffleWriterOptions_.range_partition_keys = {{0, true, true}};
+  shuffleWriterOptions_.range_bounds =
+      std::make_shared<VeloxColumnarBatch>(makeRowVector({makeFlatVector<int64_t>({2, 4})}));
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(3, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // As Spark's RangePartitioner: the partition of a key is the number of bounds less than it, nulls go first.
+  auto vector = makeRowVector({
+      makeNullableFlatVector<int64_t>({5, 1, std::nullopt, 3, 4, 2, 9}),
+      makeFlatVector<velox::StringView>({"a", "b", "c", "d", "e", "f", "g"}),
+  });
+
+  auto firstBlock = makeRowVector({
+      makeNullableFlatVector<int64_t>({1, std::nullopt, 2}),
+      makeFlatVector<velox::StringView>({"b", "c", "f"}),
+  });
+  auto secondBlock = makeRowVector({
+      makeNullableFlatVector<int64_t>({3, 4}),
+      makeFlatVector<velox::StringView>({"d", "e"}),
+  });
+  auto thirdBlock = makeRowVector({
+      makeNullableFlatVector<int64_t>({5, 9}),
+      makeFlatVector<velox::StringView>({"a", "g"}),
+  });
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter_, {vector}, 3, firstBlock->type(), {{firstBlock}, {secondBlock}, {thirdBlock}});
+}
+
+TEST_P(VeloxShuffleWriterTest, hashPartStringDictionary) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+  shuffleWriterOptions_.string_dictionary_encoding = true;
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Partition 0 gets the keys 2 and 4, partition 1 the keys 1 and 3, see hashPartitionKeys.
+  auto keys = makeFlatVector<int64_t>({2, 1, 4, 3, 2, 1, 4, 3});
+  auto names = wrapInDictionary(
+      makeIndices({0, 1, 0, 1, 0, 1, 0, 2}),
+      8,
+      makeNullableFlatVector<velox::StringView>({"gluten shuffle dictionary", "velox", std::nullopt}));
+  auto vector = makeRowVector({keys, names});
+
+  auto firstBlock = makeRowVector({
+      makeFlatVector<int64_t>({2, 4, 2, 4}),
+      makeFlatVector<velox::StringView>(
+          {"gluten shuffle dictionary",
+           "gluten shuffle dictionary",
+           "gluten shuffle dictionary",
+           "gluten shuffle dictionary"}),
+  });
+  auto secondBlock = makeRowVector({
+      makeFlatVector<int64_t>({1, 3, 1, 3}),
+      makeNullableFlatVector<velox::StringView>({"velox", "velox", "velox", std::nullopt}),
+  });
+
+  testShuffleWriteMultiBlocks(*shuffleWriter_, {vector}, 2, firstBlock->type(), {{firstBlock}, {secondBlock}});
+}
+
+TEST_P(VeloxShuffleWriterTest, hashPartStringDictionaryAcrossBatches) {
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+  shuffleWriterOptions_.string_dictionary_encoding = true;
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Partition 0 gets the keys 2 and 4, partition 1 the keys 1 and 3, see hashPartitionKeys. The payload of a partition
+  // gathers both vectors, the second flat, and is encoded by the column marked by the first.
+  auto keys = makeFlatVector<int64_t>({2, 1, 4, 3, 2, 1, 4, 3});
+  auto makeIds = [&](int32_t first) {
+    return makeFlatVector<std::string>(8, [first](auto row) { return fmt::format("shuffle id {}", first + row); });
+  };
+  auto first = makeRowVector({
+      keys,
+      wrapInDictionary(
+          makeIndices({0, 1, 0, 1, 0, 1, 0, 1}),
+          8,
+          makeFlatVector<std::string>({"gluten shuffle dictionary", "velox"})),
+      wrapInDictionary(makeIndices(8, [](auto row) { return row; }), 8, makeIds(0)),
+  });
+  auto second = makeRowVector({
+      keys,
+      makeFlatVector<std::string>(
+          8, [](auto row) { return std::string(row % 2 == 0 ? "gluten shuffle dictionary" : "velox"); }),
+      makeIds(8),
+  });
+  splitRowVector(*shuffleWriter_, first);
+  splitRowVector(*shuffleWriter_, second);
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  auto blocks = readPartitionBlocks(*shuffleWriter_, first->type());
+  std::vector<std::string> names = {"gluten shuffle dictionary", "velox"};
+  for (int32_t pid = 0; pid < 2; ++pid) {
+    ASSERT_EQ(blocks[pid].size(), 1);
+    std::vector<int64_t> expectedKeys;
+    std::vector<std::string> expectedIds;
+    for (auto row = pid; row < 16; row += 2) {
+      expectedKeys.push_back(keys->valueAt(row % 8));
+      expectedIds.push_back(fmt::format("shuffle id {}", row));
+    }
+    auto expected = makeRowVector({
+        makeFlatVector<int64_t>(expectedKeys),
+        makeFlatVector<std::string>(std::vector<std::string>(8, names[pid])),
+        makeFlatVector<std::string>(expectedIds),
+    });
+    velox::test::assertEqualVectors(expected, blocks[pid][0]);
+    // The ids are all distinct, so sent flat.
+    ASSERT_EQ(blocks[pid][0]->childAt(1)->encoding(), VectorEncoding::Simple::DICTIONARY);
+    ASSERT_EQ(blocks[pid][0]->childAt(2)->encoding(), VectorEncoding::Simple::FLAT);
+  }
+}
+
+TEST_P(VeloxShuffleWriterTest, hashPartConstantColumns) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+  shuffleWriterOptions_.elide_constant_columns = true;
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Partition 0 gets the keys 2 and 4, partition 1 the keys 1 and 3, see hashPartitionKeys.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>({2, 1, 4, 3, 2, 1, 4, 3}),
+      makeConstant<int32_t>(7, 8),
+      makeNullConstant(TypeKind::BIGINT, 8),
+      makeConstant<velox::StringView>("gluten shuffle", 8),
+      makeNullableFlatVector<velox::StringView>(std::vector<std::optional<velox::StringView>>(8, std::nullopt)),
+  });
+
+  auto firstBlock = makeRowVector({
+      makeFlatVector<int64_t>({2, 4, 2, 4}),
+      makeFlatVector<int32_t>({7, 7, 7, 7}),
+      makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, std::nullopt, std::nullopt}),
+      makeFlatVector<velox::StringView>({"gluten shuffle", "gluten shuffle", "gluten shuffle", "gluten shuffle"}),
+      makeNullableFlatVector<velox::StringView>({std::nullopt, std::nullopt, std::nullopt, std::nullopt}),
+  });
+  auto secondBlock = makeRowVector({
+      makeFlatVector<int64_t>({1, 3, 1, 3}),
+      makeFlatVector<int32_t>({7, 7, 7, 7}),
+      makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, std::nullopt, std::nullopt}),
+      makeFlatVector<velox::StringView>({"gluten shuffle", "gluten shuffle", "gluten shuffle", "gluten shuffle"}),
+      makeNullableFlatVector<velox::StringView>({std::nullopt, std::nullopt, std::nullopt, std::nullopt}),
+  });
+
+  testShuffleWriteMultiBlocks(*shuffleWriter_, {vector}, 2, firstBlock->type(), {{firstBlock}, {secondBlock}});
+}
+
+TEST_P(VeloxShuffleWriterTest, hashPartConstantColumnsAcrossBatches) {
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.hash_partition_key_ids = {0};
+  shuffleWriterOptions_.elide_constant_columns = true;
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Partition 0 gets the keys 2 and 4, partition 1 the keys 1 and 3, see hashPartitionKeys. The payload of a partition
+  // gathers the 12 rows of all vectors, so a column is elided only if it's constant across them.
+  auto keys = makeFlatVector<int64_t>({2, 1, 4, 3, 2, 1, 4, 3});
+  auto allNull = makeNullableFlatVector<int64_t>(std::vector<std::optional<int64_t>>(8, std::nullopt));
+  std::vector<velox::RowVectorPtr> vectors = {
+      makeRowVector(
+          {keys, makeConstant<int32_t>(7, 8), makeConstant(true, 8), allNull, makeConstant<std::string>("gluten", 8)}),
+      makeRowVector(
+          {keys,
+           makeConstant<int32_t>(7, 8),
+           makeConstant(true, 8),
+           makeNullConstant(TypeKind::BIGINT, 8),
+           makeConstant<std::string>("gluten", 8)}),
+      makeRowVector(
+          {keys,
+           makeConstant<int32_t>(8, 8),
+           makeConstant(true, 8),
+           allNull,
+           makeFlatVector<std::string>(8, [](auto row) { return std::string(row == 3 ? "velox" : "gluten"); })}),
+  };
+  for (const auto& vector : vectors) {
+    splitRowVector(*shuffleWriter_, vector);
+  }
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  auto blocks = readPartitionBlocks(*shuffleWriter_, vectors[0]->type());
+  // Row 3 of the last vector is the 2nd of partition 1 in it.
+  std::vector<std::vector<std::string>> strings(2, std::vector<std::string>(12, "gluten"));
+  strings[1][9] = "velox";
+  for (int32_t pid = 0; pid < 2; ++pid) {
+    ASSERT_EQ(blocks[pid].size(), 1);
+    auto expected = makeRowVector({
+        makeFlatVector<int64_t>(12, [&](auto row) { return keys->valueAt(2 * (row % 4) + pid); }),
+        makeFlatVector<int32_t>({7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8}),
+        makeFlatVector<bool>(std::vector<bool>(12, true)),
+        makeNullableFlatVector<int64_t>(std::vector<std::optional<int64_t>>(12, std::nullopt)),
+        makeFlatVector<std::string>(strings[pid]),
+    });
+    velox::test::assertEqualVectors(expected, blocks[pid][0]);
+    ASSERT_EQ(blocks[pid][0]->childAt(1)->encoding(), VectorEncoding::Simple::FLAT);
+    // The booleans of more than 8 rows, see elideFixedWidthColumn.
+    ASSERT_EQ(blocks[pid][0]->childAt(2)->encoding(), VectorEncoding::Simple::CONSTANT);
+    ASSERT_EQ(blocks[pid][0]->childAt(3)->encoding(), VectorEncoding::Simple::CONSTANT);
+    ASSERT_EQ(
+        blocks[pid][0]->childAt(4)->encoding(),
+        pid == 0 ? VectorEncoding::Simple::CONSTANT : VectorEncoding::Simple::FLAT);
+  }
+}
+
+TEST_P(VeloxShuffleWriterTest, sortBasedHashPart3Vectors) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "hash";
+  shuffleWriterOptions_.shuffle_writer_type = kSortShuffleWriterType;
+
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // All buffered rows of one partition are written as one batch on stop.
+  auto blockPid1 = takeRows(inputVector1_, {0, 5, 6, 7, 9});
+  blockPid1->append(takeRows(inputVector1_, {0, 5, 6, 7, 9}).get());
+
+  auto blockPid2 = takeRows(inputVector1_, {1, 2, 3, 4, 8});
+  blockPid2->append(takeRows(inputVector2_, {0, 1}).get());
+  blockPid2->append(takeRows(inputVector1_, {1, 2, 3, 4, 8}).get());
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter_,
+      {hashInputVector1_, hashInputVector2_, hashInputVector1_},
+      2,
+      inputVector1_->type(),
+      {{blockPid2}, {blockPid1}});
+}
+
+TEST_P(VeloxShuffleWriterTest, sortBasedRoundRobinSmallThreshold) {
+  int32_t numPartitions = 2;
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.shuffle_writer_type = kSortShuffleWriterType;
+  // sort and cache on every input batch
+  shuffleWriterOptions_.sort_buffer_threshold = 1;
+  ARROW_ASSIGN_OR_THROW(
+      shuffleWriter_, VeloxShuffleWriter::create(numPartitions, partitionWriterCreator_, shuffleWriterOptions_));
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter_,
+      {inputVector1_, inputVector2_, inputVector1_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+}
+
+TEST_P(VeloxShuffleWriterTest, sortBasedChargesBufferedVectors) {
+  class CountingListener final : public AllocationListener {
+   public:
+    void allocationChanged(int64_t diff) override {
+      bytes += diff;
+    }
+    int64_t bytes = 0;
+  };
+  auto listener = std::make_shared<CountingListener>();
+  ListenableMemoryAllocator allocator(defaultMemoryAllocator().get(), listener);
+  shuffleWriterOptions_.memory_pool = asArrowMemoryPool(&allocator);
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.shuffle_writer_type = kSortShuffleWriterType;
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_));
+
+  auto charged = listener->bytes;
+  splitRowVector(*shuffleWriter_, inputVector1_);
+  ASSERT_GT(listener->bytes, charged);
+
+  // The buffered vectors are released by eviction.
+  int64_t evicted = 0;
+  ASSERT_NOT_OK(shuffleWriter_->evictFixedSize(listener->bytes - charged, &evicted));
+  ASSERT_GT(evicted, 0);
+
+  // And by a writer that doesn't stop.
+  splitRowVector(*shuffleWriter_, inputVector2_);
+  shuffleWriter_.reset();
+  ASSERT_EQ(listener->bytes, 0);
+}
+
+TEST_P(VeloxShuffleWriterTest, celebornAsyncPush) {
+  class RecordingCelebornClient final : public CelebornClient {
+   public:
+    std::vector<int32_t> pushPartitionsData(
+        const std::vector<int32_t>& partitionIds,
+        const std::vector<int32_t>& lengths,
+        const uint8_t* bytes,
+        int64_t size) override {
+      std::lock_guard<std::mutex> lock(mutex);
+      buffers.insert(bytes);
+      for (size_t i = 0; i < partitionIds.size(); ++i) {
+        pushedBytes[partitionIds[i]] += lengths[i];
+      }
+      return lengths;
+    }
+
+    std::mutex mutex;
+    std::unordered_set<const uint8_t*> buffers;
+    std::unordered_map<int32_t, int64_t> pushedBytes;
+  };
+  auto client = std::make_shared<RecordingCelebornClient>();
+  int32_t numPartitions = 8;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.async_push = true;
+  shuffleWriterOptions_.push_batch_size = 1024;
+  shuffleWriterOptions_.max_inflight_push_bytes = 2048;
+  partitionWriterCreator_ = std::make_shared<CelebornPartitionWriterCreator>(client);
+  ARROW_ASSIGN_OR_THROW(
+      shuffleWriter_, VeloxShuffleWriter::create(numPartitions, partitionWriterCreator_, shuffleWriterOptions_));
+
+  for (int i = 0; i < 4; ++i) {
+    splitRowVector(*shuffleWriter_, inputVector1_);
+  }
+  // Evicted partitions are pushed in the background.
+  int64_t evicted = 0;
+  ASSERT_NOT_OK(shuffleWriter_->evictFixedSize(1 << 30, &evicted));
+  splitRowVector(*shuffleWriter_, inputVector2_);
+  ASSERT_NOT_OK(shuffleWriter_->stop());
+
+  for (int32_t pid = 0; pid < numPartitions; ++pid) {
+    ASSERT_GT(client->pushedBytes[pid], 0);
+    ASSERT_EQ(shuffleWriter_->partitionLengths()[pid], client->pushedBytes[pid]);
+  }
+  // The pushes only use the batches allocated when the writer started, 2048 / 1024 in flight and one being filled.
+  ASSERT_LE(client->buffers.size(), 3u);
 }
 
 TEST_P(VeloxShuffleWriterTest, roundRobin) {
@@ -529,6 +1299,196 @@ TEST_P(VeloxShuffleWriterTest, roundRobin) {
       {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
 }
 
+TEST_P(VeloxShuffleWriterTest, roundRobinClustering) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.round_robin_clustering = true;
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // Rows are ordered by the hash of the first column, each partition gets the rows of one key instead of both.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 1, 2, 1, 2}),
+      makeFlatVector<velox::StringView>({"a", "b", "c", "d", "e", "f"}),
+  });
+  std::vector<int32_t> hashes;
+  GLUTEN_THROW_NOT_OK(computeSparkMurmur3Hash(*makeRowVector({makeFlatVector<int64_t>({1, 2})}), {0}, hashes));
+
+  auto ones = makeRowVector({
+      makeFlatVector<int64_t>({1, 1, 1}),
+      makeFlatVector<velox::StringView>({"a", "c", "e"}),
+  });
+  auto twos = makeRowVector({
+      makeFlatVector<int64_t>({2, 2, 2}),
+      makeFlatVector<velox::StringView>({"b", "d", "f"}),
+  });
+  std::vector<std::vector<velox::RowVectorPtr>> expected = {{ones}, {twos}};
+  if (hashes[1] < hashes[0]) {
+    std::swap(expected[0], expected[1]);
+  }
+
+  testShuffleWriteMultiBlocks(*shuffleWriter_, {vector}, 2, vector->type(), expected);
+}
+
+TEST_P(VeloxShuffleWriterTest, roundRobinClusteringKeepsPartitionSizes) {
+  shuffleWriterOptions_.partitioning_name = "rr";
+  // Of odd sizes, so the round robin rotates across them.
+  std::vector<velox::RowVectorPtr> vectors;
+  int64_t id = 0;
+  for (auto size : {7, 5, 9}) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(size, [](auto row) { return row % 3; }),
+        makeFlatVector<int64_t>(size, [&](auto row) { return id + row; }),
+    }));
+    id += size;
+  }
+
+  auto writeAndRead = [&](bool clustering) {
+    shuffleWriterOptions_.round_robin_clustering = clustering;
+    ARROW_ASSIGN_OR_THROW(
+        shuffleWriter_, VeloxShuffleWriter::create(3, partitionWriterCreator_, shuffleWriterOptions_))
+    for (const auto& vector : vectors) {
+      splitRowVector(*shuffleWriter_, vector);
+    }
+    GLUTEN_THROW_NOT_OK(shuffleWriter_->stop());
+    return readPartitionBlocks(*shuffleWriter_, vectors[0]->type());
+  };
+  auto plain = writeAndRead(false);
+  auto clustered = writeAndRead(true);
+
+  std::vector<int64_t> ids;
+  for (int32_t pid = 0; pid < 3; ++pid) {
+    vector_size_t plainRows = 0;
+    vector_size_t clusteredRows = 0;
+    for (const auto& block : plain[pid]) {
+      plainRows += block->size();
+    }
+    for (const auto& block : clustered[pid]) {
+      clusteredRows += block->size();
+      auto blockIds = block->childAt(1)->as<SimpleVector<int64_t>>();
+      for (auto row = 0; row < block->size(); ++row) {
+        ids.push_back(blockIds->valueAt(row));
+      }
+    }
+    ASSERT_EQ(clusteredRows, plainRows) << pid;
+  }
+  // Every row exactly once.
+  std::sort(ids.begin(), ids.end());
+  ASSERT_EQ(ids.size(), static_cast<size_t>(id));
+  for (int64_t i = 0; i < id; ++i) {
+    ASSERT_EQ(ids[i], i);
+  }
+}
+
+TEST_P(VeloxShuffleWriterTest, blockChecksum) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.block_checksum = true;
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  auto blockPid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto blockPid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  testShuffleWriteMultiBlocks(*shuffleWriter_, {inputVector1_}, 2, inputVector1_->type(), {{blockPid1}, {blockPid2}});
+
+  // Flip one bit of the last non empty buffer of the first block.
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  GLUTEN_ASSIGN_OR_THROW(auto fileReader, getRecordBatchStreamReader(shuffleWriter_->dataFile()));
+  ASSERT_NOT_OK(fileReader->ReadAll(&batches));
+  auto column = batches[0]->num_columns() - 1;
+  while (std::static_pointer_cast<arrow::LargeStringArray>(batches[0]->column(column))->value_data()->size() == 0) {
+    --column;
+  }
+  auto data = batches[0]->column(column)->data()->Copy();
+  GLUTEN_ASSIGN_OR_THROW(auto corrupted, arrow::AllocateBuffer(data->buffers[2]->size()));
+  memcpy(corrupted->mutable_data(), data->buffers[2]->data(), data->buffers[2]->size());
+  corrupted->mutable_data()[0] ^= 1;
+  data->buffers[2] = std::move(corrupted);
+  GLUTEN_ASSIGN_OR_THROW(
+      auto corruptedBatch, batches[0]->SetColumn(column, batches[0]->schema()->field(column), arrow::MakeArray(data)));
+  ASSERT_THROW(
+      VeloxShuffleReader::readRowVector(
+          *corruptedBatch, asRowType(inputVector1_->type()), CodecBackend::NONE, arrowPool_.get(), pool_.get()),
+      GlutenException);
+}
+
+TEST_P(VeloxShuffleWriterTest, blockChecksumSpilled) {
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.block_checksum = true;
+  ARROW_ASSIGN_OR_THROW(shuffleWriter_, VeloxShuffleWriter::create(2, partitionWriterCreator_, shuffleWriterOptions_))
+
+  // The spilled payloads keep their checksums through the merge into the data file, verified as they are read.
+  for (const auto& vector : {inputVector1_, inputVector2_, inputVector1_}) {
+    splitRowVector(*shuffleWriter_, vector);
+    int64_t evicted = 0;
+    ASSERT_NOT_OK(shuffleWriter_->evictFixedSize(std::numeric_limits<int64_t>::max(), &evicted));
+  }
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+  shuffleWriteReadMultiBlocks(
+      *shuffleWriter_,
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+}
+
+TEST_P(VeloxShuffleWriterTest, asyncSpillRoundRobin) {
+  int32_t numPartitions = 2;
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  shuffleWriterOptions_.num_spill_threads = 2;
+  // Every eviction waits for the previous one to be written out.
+  shuffleWriterOptions_.max_inflight_spill_bytes = 1;
+  ARROW_ASSIGN_OR_THROW(
+      shuffleWriter_, VeloxShuffleWriter::create(numPartitions, partitionWriterCreator_, shuffleWriterOptions_));
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter_,
+      {inputVector1_, inputVector2_, inputVector1_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+}
+
+TEST_P(VeloxShuffleWriterTest, spillAndMerge) {
+  int32_t numPartitions = 2;
+  shuffleWriterOptions_.buffer_size = 4;
+  shuffleWriterOptions_.partitioning_name = "rr";
+  ARROW_ASSIGN_OR_THROW(
+      shuffleWriter_, VeloxShuffleWriter::create(numPartitions, partitionWriterCreator_, shuffleWriterOptions_));
+
+  // The payloads cached by each batch are spilled before the next one, stop() merges the spilled files into the
+  // data file.
+  int64_t totalEvicted = 0;
+  for (const auto& vector : {inputVector1_, inputVector2_, inputVector1_}) {
+    splitRowVector(*shuffleWriter_, vector);
+    int64_t evicted = 0;
+    ASSERT_NOT_OK(shuffleWriter_->evictFixedSize(std::numeric_limits<int64_t>::max(), &evicted));
+    totalEvicted += evicted;
+  }
+  ASSERT_GT(totalEvicted, 0);
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+
+  shuffleWriteReadMultiBlocks(
+      *shuffleWriter_,
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+}
+
 TEST_P(VeloxShuffleWriterTest, rangePartition) {
   int32_t numPartitions = 2;
   shuffleWriterOptions_.buffer_size = 4;
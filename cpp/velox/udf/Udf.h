@@ -30,6 +30,9 @@ struct UdfEntry {
 #define GLUTEN_GET_UDF_ENTRIES getUdfEntries
 #define DEFINE_GET_UDF_ENTRIES extern "C" void GLUTEN_GET_UDF_ENTRIES(gluten::UdfEntry* udfEntries)
 
+// Registers the functions of the entries to Velox, either simple functions by facebook::velox::registerFunction or
+// vector functions by facebook::velox::exec::registerVectorFunction with their signatures. Vector functions are given
+// whole batches, to decode their arguments once and set up per batch. See examples/MyUDF.cpp.
 #define GLUTEN_REGISTER_UDF registerUdf
 #define DEFINE_REGISTER_UDF extern "C" void GLUTEN_REGISTER_UDF()
 
@@ -50,6 +50,9 @@ void gluten::UdfLoader::loadUdfLibraries0(const std::vector<std::string>& libPat
   for (const auto& libPath : libPaths) {
     if (handles_.find(libPath) == handles_.end()) {
       void* handle = dlopen(libPath.c_str(), RTLD_LAZY);
+      if (!handle) {
+        throw gluten::GlutenException("Failed to load udf library " + libPath + ": " + dlerror());
+      }
       handles_[libPath] = handle;
     }
     LOG(INFO) << "Successfully loaded udf library: " << libPath;
@@ -16,6 +16,8 @@
  */
 
 #include <velox/expression/VectorFunction.h>
+#include <velox/functions/Macros.h>
+#include <velox/functions/Registerer.h>
 #include <iostream>
 #include "udf/Udf.h"
 
@@ -62,6 +64,51 @@ class PlusConstantFunction : public exec::VectorFunction {
   const int32_t addition_;
 };
 
+// The same as PlusConstantFunction over arguments of any encoding, decoded once per batch rather than read by row.
+class PlusConstantDecodedFunction : public exec::VectorFunction {
+ public:
+  explicit PlusConstantDecodedFunction(int64_t addition) : addition_(addition) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    VELOX_CHECK_EQ(args.size(), 1);
+    // The rows of null arguments are deselected by the default null behavior.
+    exec::LocalDecodedVector decoded(context, *args[0], rows);
+
+    context.ensureWritable(rows, BIGINT(), result);
+    auto* flatResult = result->asFlatVector<int64_t>();
+    auto* rawResult = flatResult->mutableRawValues();
+    flatResult->clearNulls(rows);
+
+    if (decoded->isIdentityMapping()) {
+      auto* rawInput = decoded->data<int64_t>();
+      rows.applyToSelected([&](auto row) { rawResult[row] = rawInput[row] + addition_; });
+    } else if (decoded->isConstantMapping()) {
+      auto value = decoded->valueAt<int64_t>(rows.begin());
+      rows.applyToSelected([&](auto row) { rawResult[row] = value + addition_; });
+    } else {
+      rows.applyToSelected([&](auto row) { rawResult[row] = decoded->valueAt<int64_t>(row) + addition_; });
+    }
+  }
+
+ private:
+  const int64_t addition_;
+};
+
+// The simple function of PlusConstantDecodedFunction, called by row.
+template <typename T>
+struct PlusFiveFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE void call(int64_t& result, const int64_t& value) {
+    result = value + 5;
+  }
+};
+
 static std::vector<std::shared_ptr<exec::FunctionSignature>> integerSignatures() {
   // integer -> integer
   return {exec::FunctionSignatureBuilder().returnType("integer").argumentType("integer").build()};
@@ -74,8 +121,12 @@ static std::vector<std::shared_ptr<exec::FunctionSignature>> bigintSignatures()
 
 } // namespace
 
-const int kNumMyUdf = 2;
-gluten::UdfEntry myUdf[kNumMyUdf] = {{"myudf1", "integer"}, {"myudf2", "bigint"}};
+const int kNumMyUdf = 4;
+gluten::UdfEntry myUdf[kNumMyUdf] = {
+    {"myudf1", "integer"},
+    {"myudf2", "bigint"},
+    {"myudf3", "bigint"},
+    {"myudf3_simple", "bigint"}};
 
 DEFINE_GET_NUM_UDF {
   return kNumMyUdf;
@@ -92,5 +143,8 @@ DEFINE_REGISTER_UDF {
       "myudf1", integerSignatures(), std::make_unique<PlusConstantFunction<facebook::velox::TypeKind::INTEGER>>(5));
   facebook::velox::exec::registerVectorFunction(
       "myudf2", bigintSignatures(), std::make_unique<PlusConstantFunction<facebook::velox::TypeKind::BIGINT>>(5));
-  std::cout << "registered myudf1, myudf2" << std::endl;
+  facebook::velox::exec::registerVectorFunction(
+      "myudf3", bigintSignatures(), std::make_unique<PlusConstantDecodedFunction>(5));
+  facebook::velox::registerFunction<PlusFiveFunction, int64_t, int64_t>({"myudf3_simple"});
+  std::cout << "registered myudf1, myudf2, myudf3, myudf3_simple" << std::endl;
 }
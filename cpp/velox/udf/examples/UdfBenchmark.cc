@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "udf/UdfLoader.h"
+#include "velox/core/Expressions.h"
+#include "velox/core/QueryCtx.h"
+#include "velox/expression/Expr.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+
+namespace {
+
+constexpr vector_size_t kBatchSize = 10'000;
+
+// Evaluates name(c0) over a batch of bigints, to compare the vector and the simple functions of the same body.
+void evalUdf(benchmark::State& state, const std::string& name) {
+  auto pool = memory::addDefaultLeafMemoryPool();
+  auto queryCtx = std::make_shared<core::QueryCtx>();
+  core::ExecCtx execCtx(pool.get(), queryCtx.get());
+
+  auto values = BaseVector::create<FlatVector<int64_t>>(BIGINT(), kBatchSize, pool.get());
+  for (vector_size_t i = 0; i < kBatchSize; ++i) {
+    values->set(i, i);
+  }
+  auto input = std::make_shared<RowVector>(
+      pool.get(), ROW({"c0"}, {BIGINT()}), nullptr, kBatchSize, std::vector<VectorPtr>{values});
+
+  auto call = std::make_shared<core::CallTypedExpr>(
+      BIGINT(), std::vector<core::TypedExprPtr>{std::make_shared<core::FieldAccessTypedExpr>(BIGINT(), "c0")}, name);
+  exec::ExprSet exprSet({call}, &execCtx);
+  SelectivityVector rows(kBatchSize);
+  std::vector<VectorPtr> result(1);
+
+  for (auto _ : state) {
+    exec::EvalCtx evalCtx(&execCtx, &exprSet, input.get());
+    exprSet.eval(rows, evalCtx, result);
+    benchmark::DoNotOptimize(result[0]);
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  auto udfLoader = gluten::UdfLoader::getInstance();
+  udfLoader->loadUdfLibraries("libmyudf.so");
+  udfLoader->registerUdf();
+
+  benchmark::RegisterBenchmark("UdfBenchmark::Vector", evalUdf, "myudf3");
+  benchmark::RegisterBenchmark("UdfBenchmark::Simple", evalUdf, "myudf3_simple");
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
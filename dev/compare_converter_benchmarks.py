@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Merges the --benchmark_out_format=json results of the velox converter_benchmark and of the
+# ClickHouse benchmark_converters into one table, per schema and benchmark:
+#
+#   compare_converter_benchmarks.py velox.json ch.json [--csv]
+
+import argparse
+import json
+
+
+def load(path):
+    with open(path) as f:
+        results = {}
+        for benchmark in json.load(f)["benchmarks"]:
+            if benchmark.get("run_type", "iteration") == "iteration":
+                # <schema>/<benchmark>, without the suffixes google benchmark appends.
+                results["/".join(benchmark["name"].split("/")[:2])] = benchmark
+        return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("velox")
+    parser.add_argument("clickhouse")
+    parser.add_argument("--csv", action="store_true", help="Print comma separated values")
+    args = parser.parse_args()
+
+    velox = load(args.velox)
+    clickhouse = load(args.clickhouse)
+    columns = [
+        "benchmark",
+        "velox_rows_per_s",
+        "ch_rows_per_s",
+        "ch_vs_velox",
+        "velox_bytes_per_row",
+        "ch_bytes_per_row",
+    ]
+    rows = []
+    for name in sorted(set(velox) | set(clickhouse)):
+        v = velox.get(name, {})
+        c = clickhouse.get(name, {})
+        v_rate = v.get("rows_per_second")
+        c_rate = c.get("rows_per_second")
+        ratio = c_rate / v_rate if v_rate and c_rate else None
+        rows.append([name, v_rate, c_rate, ratio, v.get("bytes_per_row"), c.get("bytes_per_row")])
+
+    def fmt(value):
+        if value is None:
+            return "-"
+        return value if isinstance(value, str) else "%.2f" % value
+
+    if args.csv:
+        print(",".join(columns))
+        for row in rows:
+            print(",".join(fmt(value) for value in row))
+        return
+    widths = [
+        max([len(columns[i])] + [len(fmt(row[i])) for row in rows]) for i in range(len(columns))
+    ]
+    print("  ".join(column.ljust(width) for column, width in zip(columns, widths)).rstrip())
+    for row in rows:
+        print("  ".join(fmt(value).ljust(width) for value, width in zip(row, widths)).rstrip())
+
+
+if __name__ == "__main__":
+    main()
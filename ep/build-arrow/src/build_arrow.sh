@@ -98,6 +98,7 @@ cmake -G Ninja \
   -DARROW_COMPUTE=ON \
   -DARROW_WITH_RE2=ON \
   -DARROW_FILESYSTEM=ON \
+  -DARROW_HDFS=ON \
   -DARROW_WITH_LZ4=ON \
   -DARROW_WITH_SNAPPY=ON \
   -DARROW_WITH_ZLIB=ON \
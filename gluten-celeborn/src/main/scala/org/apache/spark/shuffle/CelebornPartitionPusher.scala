@@ -37,15 +37,38 @@ class CelebornPartitionPusher(
   @throws[IOException]
   def pushPartitionData(partitionId: Int, buffer: Array[Byte]): Int = {
     logDebug(s"Push record, size ${buffer.length}.")
-    if (buffer.length > celebornConf.clientPushBufferMaxSize) {
+    push(partitionId, buffer, 0, buffer.length)
+  }
+
+  /**
+   * Push the data of several partitions received in one native call. Segment i of buffer has
+   * lengths(i) bytes and belongs to partitionIds(i). Returns the pushed bytes of each segment.
+   */
+  @throws[IOException]
+  def pushPartitionsData(
+      partitionIds: Array[Int],
+      lengths: Array[Int],
+      buffer: Array[Byte]): Array[Int] = {
+    logDebug(s"Push records of ${partitionIds.length} partitions, size ${buffer.length}.")
+    val pushed = new Array[Int](partitionIds.length)
+    var offset = 0
+    for (i <- partitionIds.indices) {
+      pushed(i) = push(partitionIds(i), buffer, offset, lengths(i))
+      offset += lengths(i)
+    }
+    pushed
+  }
+
+  private def push(partitionId: Int, buffer: Array[Byte], offset: Int, length: Int): Int = {
+    if (length > celebornConf.clientPushBufferMaxSize) {
       client.pushData(
         shuffleId,
         mapId,
         context.attemptNumber,
         partitionId,
         buffer,
-        0,
-        buffer.length,
+        offset,
+        length,
         numMappers,
         numPartitions)
     } else {
@@ -55,8 +78,8 @@ class CelebornPartitionPusher(
         context.attemptNumber,
         partitionId,
         buffer,
-        0,
-        buffer.length,
+        offset,
+        length,
         numMappers,
         numPartitions)
     }
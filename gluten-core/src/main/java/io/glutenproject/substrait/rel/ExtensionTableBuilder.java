@@ -16,6 +16,8 @@
  */
 package io.glutenproject.substrait.rel;
 
+import java.util.List;
+
 public class ExtensionTableBuilder {
   private ExtensionTableBuilder() {}
 
@@ -23,4 +25,36 @@ public class ExtensionTableBuilder {
       Long minPartsNum, Long maxPartsNum, String database, String tableName, String relativePath) {
     return new ExtensionTableNode(minPartsNum, maxPartsNum, database, tableName, relativePath);
   }
+
+  public static ExtensionTableNode makeExtensionTable(
+      Long minPartsNum,
+      Long maxPartsNum,
+      String database,
+      String tableName,
+      String relativePath,
+      Long beginMark,
+      Long endMark) {
+    return new ExtensionTableNode(
+        minPartsNum, maxPartsNum, database, tableName, relativePath, beginMark, endMark);
+  }
+
+  public static ExtensionTableNode makeExtensionTable(
+      Long minPartsNum,
+      Long maxPartsNum,
+      String database,
+      String tableName,
+      String relativePath,
+      Long beginMark,
+      Long endMark,
+      List<String> skipIndexes) {
+    return new ExtensionTableNode(
+        minPartsNum,
+        maxPartsNum,
+        database,
+        tableName,
+        relativePath,
+        beginMark,
+        endMark,
+        skipIndexes);
+  }
 }
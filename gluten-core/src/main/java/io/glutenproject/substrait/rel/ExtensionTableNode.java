@@ -21,6 +21,8 @@ import com.google.protobuf.StringValue;
 import io.substrait.proto.ReadRel;
 
 import java.io.Serializable;
+import java.util.Collections;
+import java.util.List;
 
 public class ExtensionTableNode implements Serializable {
   private static final String MERGE_TREE = "MergeTree;";
@@ -33,6 +35,37 @@ public class ExtensionTableNode implements Serializable {
 
   ExtensionTableNode(
       Long minPartsNum, Long maxPartsNum, String database, String tableName, String relativePath) {
+    this(minPartsNum, maxPartsNum, database, tableName, relativePath, 0L, 0L);
+  }
+
+  ExtensionTableNode(
+      Long minPartsNum,
+      Long maxPartsNum,
+      String database,
+      String tableName,
+      String relativePath,
+      Long beginMark,
+      Long endMark) {
+    this(
+        minPartsNum,
+        maxPartsNum,
+        database,
+        tableName,
+        relativePath,
+        beginMark,
+        endMark,
+        Collections.emptyList());
+  }
+
+  ExtensionTableNode(
+      Long minPartsNum,
+      Long maxPartsNum,
+      String database,
+      String tableName,
+      String relativePath,
+      Long beginMark,
+      Long endMark,
+      List<String> skipIndexes) {
     this.minPartsNum = minPartsNum;
     this.maxPartsNum = maxPartsNum;
     this.database = database;
@@ -50,6 +83,14 @@ public class ExtensionTableNode implements Serializable {
         .append("\n")
         .append(this.maxPartsNum)
         .append("\n");
+    // {begin_mark}\n{end_mark}\n to read a mark range of a single part
+    if (endMark > 0) {
+      extensionTableStr.append(beginMark).append("\n").append(endMark).append("\n");
+    }
+    // INDEX {declaration}\n for each skip index of the table, e.g. "idx a TYPE minmax GRANULARITY 1"
+    for (String skipIndex : skipIndexes) {
+      extensionTableStr.append("INDEX ").append(skipIndex).append("\n");
+    }
   }
 
   public ReadRel.ExtensionTable toProtobuf() {
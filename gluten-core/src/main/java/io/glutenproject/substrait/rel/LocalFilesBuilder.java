@@ -32,6 +32,18 @@ public class LocalFilesBuilder {
     return new LocalFilesNode(index, paths, starts, lengths, partitionColumns, fileFormat);
   }
 
+  public static LocalFilesNode makeLocalFiles(
+      Integer index,
+      List<String> paths,
+      List<Long> starts,
+      List<Long> lengths,
+      List<Long> modificationTimes,
+      List<Map<String, String>> partitionColumns,
+      LocalFilesNode.ReadFileFormat fileFormat) {
+    return new LocalFilesNode(
+        index, paths, starts, lengths, modificationTimes, partitionColumns, fileFormat);
+  }
+
   public static LocalFilesNode makeLocalFiles(String iterPath) {
     return new LocalFilesNode(iterPath);
   }
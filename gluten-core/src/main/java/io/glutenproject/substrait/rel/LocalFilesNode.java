@@ -36,6 +36,8 @@ public class LocalFilesNode implements Serializable {
   private final List<Long> starts = new ArrayList<>();
   private final List<Long> lengths = new ArrayList<>();
   private final List<Map<String, String>> partitionColumns = new ArrayList<>();
+  // Empty if the modification times of the files are unknown.
+  private final List<Long> modificationTimes = new ArrayList<>();
 
   // The format of file to read.
   public enum ReadFileFormat {
@@ -69,6 +71,18 @@ public class LocalFilesNode implements Serializable {
     this.partitionColumns.addAll(partitionColumns);
   }
 
+  LocalFilesNode(
+      Integer index,
+      List<String> paths,
+      List<Long> starts,
+      List<Long> lengths,
+      List<Long> modificationTimes,
+      List<Map<String, String>> partitionColumns,
+      ReadFileFormat fileFormat) {
+    this(index, paths, starts, lengths, partitionColumns, fileFormat);
+    this.modificationTimes.addAll(modificationTimes);
+  }
+
   LocalFilesNode(String iterPath) {
     this.index = null;
     this.paths.add(iterPath);
@@ -108,7 +122,9 @@ public class LocalFilesNode implements Serializable {
       localFilesBuilder.addItems(fileBuilder.build());
       return localFilesBuilder.build();
     }
-    if (paths.size() != starts.size() || paths.size() != lengths.size()) {
+    if (paths.size() != starts.size()
+        || paths.size() != lengths.size()
+        || (!modificationTimes.isEmpty() && paths.size() != modificationTimes.size())) {
       throw new RuntimeException("Invalid parameters.");
     }
     for (int i = 0; i < paths.size(); i++) {
@@ -130,6 +146,9 @@ public class LocalFilesNode implements Serializable {
       }
       fileBuilder.setLength(lengths.get(i));
       fileBuilder.setStart(starts.get(i));
+      if (!modificationTimes.isEmpty()) {
+        fileBuilder.setModificationTime(modificationTimes.get(i));
+      }
 
       NamedStruct namedStruct = buildNamedStruct();
       fileBuilder.setSchema(namedStruct);
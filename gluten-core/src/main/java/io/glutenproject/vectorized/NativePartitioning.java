@@ -30,6 +30,10 @@ public class NativePartitioning implements Serializable {
 
   private final byte[] schema;
 
+  private final int[] hashPartitionKeyIds;
+
+  private final RangePartitionBounds rangePartitionBounds;
+
   /**
    * Constructs a new instance.
    *
@@ -44,6 +48,40 @@ public class NativePartitioning implements Serializable {
     this.exprList = exprList;
     this.schema = null;
     this.requiredFields = null;
+    this.hashPartitionKeyIds = null;
+    this.rangePartitionBounds = null;
+  }
+
+  /**
+   * Constructs a hash partitioning whose partition ids the native shuffle writer computes itself.
+   *
+   * @param numPartitions Partitioning numPartitions
+   * @param hashPartitionKeyIds Ordinals of the key columns to compute Spark's murmur3 hash of
+   */
+  public NativePartitioning(int numPartitions, int[] hashPartitionKeyIds) {
+    this.shortName = "hash";
+    this.numPartitions = numPartitions;
+    this.exprList = null;
+    this.schema = null;
+    this.requiredFields = null;
+    this.hashPartitionKeyIds = hashPartitionKeyIds;
+    this.rangePartitionBounds = null;
+  }
+
+  /**
+   * Constructs a range partitioning whose partition ids the native shuffle writer computes itself.
+   *
+   * @param numPartitions Partitioning numPartitions
+   * @param rangePartitionBounds The sampled bounds and the keys to compare with them
+   */
+  public NativePartitioning(int numPartitions, RangePartitionBounds rangePartitionBounds) {
+    this.shortName = "range";
+    this.numPartitions = numPartitions;
+    this.exprList = null;
+    this.schema = null;
+    this.requiredFields = null;
+    this.hashPartitionKeyIds = null;
+    this.rangePartitionBounds = rangePartitionBounds;
   }
 
   public NativePartitioning(String shortName, int numPartitions) {
@@ -56,6 +94,8 @@ public class NativePartitioning implements Serializable {
     this.schema = schema;
     this.exprList = exprList;
     this.requiredFields = null;
+    this.hashPartitionKeyIds = null;
+    this.rangePartitionBounds = null;
   }
 
   public NativePartitioning(
@@ -65,6 +105,8 @@ public class NativePartitioning implements Serializable {
     this.schema = schema;
     this.exprList = exprList;
     this.requiredFields = requiredFields;
+    this.hashPartitionKeyIds = null;
+    this.rangePartitionBounds = null;
   }
 
   public String getShortName() {
@@ -86,4 +128,14 @@ public class NativePartitioning implements Serializable {
   public byte[] getSchema() {
     return schema;
   }
+
+  /** Null if the partition ids are read from a leading partition id column instead. */
+  public int[] getHashPartitionKeyIds() {
+    return hashPartitionKeyIds;
+  }
+
+  /** Null if the partition ids are read from a leading partition id batch instead. */
+  public RangePartitionBounds getRangePartitionBounds() {
+    return rangePartitionBounds;
+  }
 }
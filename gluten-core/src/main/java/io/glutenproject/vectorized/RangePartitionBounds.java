@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.glutenproject.vectorized;
+
+import org.apache.spark.sql.catalyst.InternalRow;
+import org.apache.spark.sql.types.StructType;
+
+import java.io.Serializable;
+
+/**
+ * The sampled bounds of a range partitioning, for the native shuffle writer to compute the
+ * partition id of each row itself, as Spark's RangePartitioner would.
+ */
+public class RangePartitionBounds implements Serializable {
+
+  private final int[] keyIds;
+
+  private final boolean[] ascending;
+
+  private final boolean[] nullsFirst;
+
+  private final StructType schema;
+
+  private final InternalRow[] bounds;
+
+  /**
+   * Constructs a new instance.
+   *
+   * @param keyIds Ordinals of the key columns in the shuffled batches
+   * @param ascending Whether each key is sorted ascending
+   * @param nullsFirst Whether the nulls of each key are sorted first
+   * @param schema Schema of the bounds, one field per key
+   * @param bounds The bounds, sorted by the keys
+   */
+  public RangePartitionBounds(
+      int[] keyIds,
+      boolean[] ascending,
+      boolean[] nullsFirst,
+      StructType schema,
+      InternalRow[] bounds) {
+    this.keyIds = keyIds;
+    this.ascending = ascending;
+    this.nullsFirst = nullsFirst;
+    this.schema = schema;
+    this.bounds = bounds;
+  }
+
+  public int[] getKeyIds() {
+    return keyIds;
+  }
+
+  public boolean[] getAscending() {
+    return ascending;
+  }
+
+  public boolean[] getNullsFirst() {
+    return nullsFirst;
+  }
+
+  public StructType getSchema() {
+    return schema;
+  }
+
+  public InternalRow[] getBounds() {
+    return bounds;
+  }
+}
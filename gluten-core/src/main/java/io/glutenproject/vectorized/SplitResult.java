@@ -26,6 +26,12 @@ public class SplitResult {
   private final long totalBytesEvicted;
   private final long[] partitionLengths;
   private final long[] rawPartitionLengths;
+  // Nanos spent in the phases of split by name, empty if the writer doesn't report them.
+  private final String[] splitPhaseNames;
+  private final long[] splitPhaseTimes;
+  // Lengths of the push-merge chunks of all partitions in partition order, the chunks of a partition add up to its
+  // length. Empty unless the writer cuts its partitions into chunks.
+  private final long[] partitionChunkLengths;
 
   public SplitResult(
       long totalComputePidTime,
@@ -36,6 +42,32 @@ public class SplitResult {
       long totalBytesEvicted,
       long[] partitionLengths,
       long[] rawPartitionLengths) {
+    this(
+        totalComputePidTime,
+        totalWriteTime,
+        totalEvictTime,
+        totalCompressTime,
+        totalBytesWritten,
+        totalBytesEvicted,
+        partitionLengths,
+        rawPartitionLengths,
+        new String[0],
+        new long[0],
+        new long[0]);
+  }
+
+  public SplitResult(
+      long totalComputePidTime,
+      long totalWriteTime,
+      long totalEvictTime,
+      long totalCompressTime,
+      long totalBytesWritten,
+      long totalBytesEvicted,
+      long[] partitionLengths,
+      long[] rawPartitionLengths,
+      String[] splitPhaseNames,
+      long[] splitPhaseTimes,
+      long[] partitionChunkLengths) {
     this.totalComputePidTime = totalComputePidTime;
     this.totalWriteTime = totalWriteTime;
     this.totalEvictTime = totalEvictTime;
@@ -44,6 +76,9 @@ public class SplitResult {
     this.totalBytesEvicted = totalBytesEvicted;
     this.partitionLengths = partitionLengths;
     this.rawPartitionLengths = rawPartitionLengths;
+    this.splitPhaseNames = splitPhaseNames;
+    this.splitPhaseTimes = splitPhaseTimes;
+    this.partitionChunkLengths = partitionChunkLengths;
   }
 
   public long getTotalComputePidTime() {
@@ -81,4 +116,16 @@ public class SplitResult {
   public long[] getRawPartitionLengths() {
     return rawPartitionLengths;
   }
+
+  public String[] getSplitPhaseNames() {
+    return splitPhaseNames;
+  }
+
+  public long[] getSplitPhaseTimes() {
+    return splitPhaseTimes;
+  }
+
+  public long[] getPartitionChunkLengths() {
+    return partitionChunkLengths;
+  }
 }
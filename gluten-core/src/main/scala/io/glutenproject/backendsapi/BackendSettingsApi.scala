@@ -20,7 +20,7 @@ import io.glutenproject.GlutenConfig
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 
 import org.apache.spark.SparkConf
-import org.apache.spark.sql.catalyst.expressions.NamedExpression
+import org.apache.spark.sql.catalyst.expressions.{Expression, NamedExpression}
 import org.apache.spark.sql.catalyst.plans._
 import org.apache.spark.sql.catalyst.plans.physical.Partitioning
 import org.apache.spark.sql.execution.SparkPlan
@@ -35,6 +35,7 @@ trait BackendSettingsApi {
   def supportExpandExec(): Boolean = false
   def supportSortExec(): Boolean = false
   def supportSortMergeJoinExec(): Boolean = true
+  def supportBroadcastNestedLoopJoinExec(): Boolean = false
   def supportWindowExec(windowFunctions: Seq[NamedExpression]): Boolean = {
     false
   }
@@ -64,6 +65,18 @@ trait BackendSettingsApi {
   def recreateJoinExecOnFallback(): Boolean = false
   def removeHashColumnFromColumnarShuffleExchangeExec(): Boolean = false
 
+  /**
+   * Whether the shuffle writer computes the hash of these HashPartitioning keys itself, so that no
+   * projection of the hash column has to be inserted before the shuffle.
+   */
+  def supportShuffleWriterHashKeys(exprs: Seq[Expression]): Boolean = false
+
+  /**
+   * Whether the range and the values of the build keys of a broadcast hash join are sent with the
+   * join, for the native engine to filter the scan of the probe side.
+   */
+  def supportBuildKeyFilterPushdown(): Boolean = false
+
   /**
    * A shuffle key may be an expression. We would add a projection for this expression shuffle key
    * and make it into a new column which the shuffle will refer to. But we need to remove it from
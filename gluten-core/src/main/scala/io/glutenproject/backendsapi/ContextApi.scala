@@ -49,4 +49,13 @@ trait ContextApi {
   def cleanExecutionBroadcastHashtable(
       executionId: String,
       broadcastHashIds: util.Set[String]): Unit = {}
+
+  /**
+   * Should call by executor. The files its scans read through the native cache, reported to the
+   * driver for the cache aware soft affinity. Empty if the backend doesn't track them.
+   */
+  def cachedFiles(): Array[String] = Array.empty
+
+  /** Should call by executor. Changes whenever cachedFiles() does. */
+  def cachedFilesVersion(): Long = 0L
 }
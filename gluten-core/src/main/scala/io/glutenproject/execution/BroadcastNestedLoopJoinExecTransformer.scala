@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.glutenproject.execution
+
+import io.glutenproject.extension.ValidationResult
+
+import org.apache.spark.sql.catalyst.expressions.Expression
+import org.apache.spark.sql.catalyst.optimizer.{BuildLeft, BuildRight, BuildSide}
+import org.apache.spark.sql.catalyst.plans._
+import org.apache.spark.sql.execution.SparkPlan
+
+import io.substrait.proto.JoinRel
+
+/**
+ * Joins the streamed side with every row of the broadcast build side passing the condition, for
+ * the joins without equi keys. It is a broadcast hash join without keys: the build side is
+ * broadcast and restored the same way, and the JoinRel carries no join expression, only the
+ * condition as its post join filter. The build side is the right one of the JoinRel, so left
+ * outer, left semi and left anti joins are supported building the right side, right outer joins
+ * building the left side and inner joins building either side.
+ */
+abstract class BroadcastNestedLoopJoinExecTransformer(
+    left: SparkPlan,
+    right: SparkPlan,
+    buildSide: BuildSide,
+    joinType: JoinType,
+    condition: Option[Expression])
+  extends BroadcastHashJoinExecTransformer(
+    Nil,
+    Nil,
+    joinType,
+    buildSide,
+    condition,
+    left,
+    right,
+    isNullAwareAntiJoin = false) {
+
+  override def leftKeys: Seq[Expression] = Nil
+  override def rightKeys: Seq[Expression] = Nil
+
+  override protected val substraitJoinType: JoinRel.JoinType = joinType match {
+    case _: InnerLike =>
+      // Cross joins too, which are inner joins without condition.
+      JoinRel.JoinType.JOIN_TYPE_INNER
+    case LeftOuter | RightOuter =>
+      JoinRel.JoinType.JOIN_TYPE_LEFT
+    case LeftSemi =>
+      JoinRel.JoinType.JOIN_TYPE_LEFT_SEMI
+    case LeftAnti =>
+      JoinRel.JoinType.JOIN_TYPE_ANTI
+    case _ =>
+      JoinRel.JoinType.UNRECOGNIZED
+  }
+
+  override protected def doValidateInternal(): ValidationResult = {
+    val supported = (joinType, buildSide) match {
+      case (_: InnerLike, _) => true
+      case (LeftOuter | LeftSemi | LeftAnti, BuildRight) => true
+      case (RightOuter, BuildLeft) => true
+      case _ => false
+    }
+    if (!supported) {
+      return ValidationResult.notOk(
+        s"Unsupported join type of $joinType building the $buildSide side for nested loop join")
+    }
+    super.doValidateInternal()
+  }
+}
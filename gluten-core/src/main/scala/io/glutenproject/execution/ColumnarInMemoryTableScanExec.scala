@@ -132,6 +132,13 @@ case class ColumnarInMemoryTableScanExec(
   }
 
   private def filteredCachedBatches(): RDD[CachedBatch] = {
-    relation.cacheBuilder.cachedColumnBuffers
+    val buffers = relation.cacheBuilder.cachedColumnBuffers
+    if (conf.inMemoryPartitionPruning) {
+      // Skips the batches whose statistics rule the predicates out, as InMemoryTableScanExec does.
+      val filter = relation.cacheBuilder.serializer.buildFilter(predicates, relation.output)
+      buffers.mapPartitionsWithIndexInternal(filter)
+    } else {
+      buffers
+    }
   }
 }
@@ -76,6 +76,9 @@ case class GlutenMergeTreePartition(
     tablePath: String,
     minParts: Long,
     maxParts: Long,
+    // Only the marks in [beginMark, endMark) of the single part are read when endMark > 0.
+    beginMark: Long = 0L,
+    endMark: Long = 0L,
     plan: Plan = PlanBuilder.empty().toProtobuf)
   extends BaseGlutenPartition {
   override def preferredLocations(): Array[String] = {
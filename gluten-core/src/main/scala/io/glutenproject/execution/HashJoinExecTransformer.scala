@@ -16,6 +16,7 @@
  */
 package io.glutenproject.execution
 
+import io.glutenproject.GlutenConfig
 import io.glutenproject.backendsapi.BackendsApiManager
 import io.glutenproject.expression._
 import io.glutenproject.extension.ValidationResult
@@ -32,9 +33,12 @@ import org.apache.spark.sql.catalyst.expressions._
 import org.apache.spark.sql.catalyst.optimizer.{BuildLeft, BuildRight, BuildSide}
 import org.apache.spark.sql.catalyst.plans._
 import org.apache.spark.sql.catalyst.plans.physical._
+import org.apache.spark.sql.catalyst.trees.TreeNodeTag
 import org.apache.spark.sql.execution.{SparkPlan, SQLExecution}
-import org.apache.spark.sql.execution.joins.{BaseJoinExec, BuildSideRelation, HashJoin}
+import org.apache.spark.sql.execution.joins.{BaseJoinExec, BuildKeySummary, BuildSideRelation, HashJoin}
+import org.apache.spark.sql.execution.metric.SQLMetrics
 import org.apache.spark.sql.types._
+import org.apache.spark.unsafe.types.UTF8String
 import org.apache.spark.sql.vectorized.ColumnarBatch
 
 import com.google.common.collect.Lists
@@ -45,6 +49,7 @@ import java.lang.{Long => JLong}
 import java.util.{ArrayList => JArrayList, HashMap => JHashMap}
 
 import scala.collection.JavaConverters._
+import scala.collection.mutable
 import scala.util.control.Breaks.{break, breakable}
 
 trait ColumnarShuffledJoin extends BaseJoinExec {
@@ -120,6 +125,17 @@ trait HashJoinLikeExecTransformer
     (right, left)
   }
 
+  // The bytes of the build side hashed by each task, estimated from the statistics of the nearest
+  // logical plan, 0 if unknown.
+  def buildSideBytesPerTask: Long = {
+    buildPlan.find(_.logicalLink.isDefined).flatMap(_.logicalLink) match {
+      case Some(logicalPlan) =>
+        val numPartitions = math.max(1, buildPlan.outputPartitioning.numPartitions)
+        (logicalPlan.stats.sizeInBytes / numPartitions).min(BigInt(Long.MaxValue)).toLong
+      case None => 0L
+    }
+  }
+
   def sameType(from: DataType, to: DataType): Boolean = {
     (from, to) match {
       case (ArrayType(fromElement, _), ArrayType(toElement, _)) =>
@@ -311,7 +327,7 @@ trait HashJoinLikeExecTransformer
       substraitJoinType,
       exchangeTable,
       joinType,
-      genJoinParametersBuilder(),
+      genJoinParametersBuilder(withBuildKeySummary = true),
       inputStreamedRelNode,
       inputBuildRelNode,
       inputStreamedOutput,
@@ -330,13 +346,14 @@ trait HashJoinLikeExecTransformer
       inputBuildOutput)
   }
 
-  def genJoinParametersBuilder(): Any.Builder = {
+  def genJoinParametersBuilder(withBuildKeySummary: Boolean = false): Any.Builder = {
     val (isBHJ, isNullAwareAntiJoin, buildHashTableId) = genJoinParameters()
     // Start with "JoinParameters:"
     val joinParametersStr = new StringBuffer("JoinParameters:")
     // isBHJ: 0 for SHJ, 1 for BHJ
     // isNullAwareAntiJoin: 0 for false, 1 for true
     // buildHashTableId: the unique id for the hash table of build plan
+    // buildSideBytes: the estimated bytes of the build side per task
     joinParametersStr
       .append("isBHJ=")
       .append(isBHJ)
@@ -350,6 +367,13 @@ trait HashJoinLikeExecTransformer
       .append("isExistenceJoin=")
       .append(if (joinType.isInstanceOf[ExistenceJoin]) 1 else 0)
       .append("\n")
+      .append("buildSideBytes=")
+      .append(buildSideBytesPerTask)
+      .append("\n")
+    if (withBuildKeySummary) {
+      // buildKeyRange<i>, buildKeyValues<i>: the summary of the i-th build key, if any
+      joinParametersStr.append(genBuildKeySummary())
+    }
     val message = StringValue
       .newBuilder()
       .setValue(joinParametersStr.toString)
@@ -363,6 +387,12 @@ trait HashJoinLikeExecTransformer
     (0, 0, "")
   }
 
+  /**
+   * The lines summarizing the keys of the build side, which filter the scan of the probe side.
+   * Only computed once the plan executes, when the build side is known.
+   */
+  protected def genBuildKeySummary(): String = ""
+
   override protected def doExecute(): RDD[InternalRow] = {
     throw new UnsupportedOperationException(
       s"${this.getClass.getSimpleName} doesn't support doExecute")
@@ -416,10 +446,22 @@ abstract class ShuffledHashJoinExecTransformerBase(
   override def hashJoinType: JoinType = joinType
 
   override def columnarInputRDDs: Seq[RDD[ColumnarBatch]] = {
+    if (getTagValue(ShuffledHashJoinExecTransformerBase.BUILD_SIDE_SWAPPED).isDefined) {
+      val swapped = metrics("buildSideSwapped")
+      swapped.set(1)
+      val executionId = sparkContext.getLocalProperty(SQLExecution.EXECUTION_ID_KEY)
+      SQLMetrics.postDriverMetricUpdates(sparkContext, executionId, Seq(swapped))
+    }
     getColumnarInputRDDs(streamedPlan) ++ getColumnarInputRDDs(buildPlan)
   }
 }
 
+object ShuffledHashJoinExecTransformerBase {
+  // Set on the joins whose build side was swapped from the one Spark planned, given the sizes of
+  // their materialized inputs.
+  val BUILD_SIDE_SWAPPED: TreeNodeTag[Unit] = TreeNodeTag[Unit]("gluten.buildSideSwapped")
+}
+
 case class BroadCastHashJoinContext(
     buildSideJoinKeys: Seq[Expression],
     joinType: JoinType,
@@ -448,6 +490,34 @@ abstract class BroadcastHashJoinExecTransformer(
     (1, if (isNullAwareAntiJoin) 1 else 0, buildHashTableId)
   }
 
+  override protected def genBuildKeySummary(): String = {
+    if (!BackendsApiManager.getSettings.supportBuildKeyFilterPushdown()) {
+      return ""
+    }
+    val maxValues = GlutenConfig.getConf.veloxBuildKeyFilterMaxValues
+    lazy val relation = buildPlan.executeBroadcast[BuildSideRelation]().value
+    val summary = new StringBuilder
+    buildKeyExprs.zipWithIndex.foreach {
+      case (key: AttributeReference, i) if summarizedTypes(key.dataType) =>
+        val keySummary = relation.keySummary(key) {
+          BroadcastHashJoinExecTransformer.summarize(relation, key, maxValues)
+        }
+        keySummary.range.foreach {
+          case (min, max) => summary.append(s"buildKeyRange$i=$min,$max\n")
+        }
+        keySummary.values.foreach {
+          values => summary.append(s"buildKeyValues$i=${values.mkString(",")}\n")
+        }
+      case _ =>
+    }
+    summary.toString
+  }
+
+  private def summarizedTypes(dataType: DataType): Boolean = dataType match {
+    case ByteType | ShortType | IntegerType | LongType | DateType | StringType => true
+    case _ => false
+  }
+
   override def columnarInputRDDs: Seq[RDD[ColumnarBatch]] = {
     val streamedRDD = getColumnarInputRDDs(streamedPlan)
     val broadcasted = buildSide match {
@@ -500,3 +570,46 @@ abstract class BroadcastHashJoinExecTransformer(
     streamedRDD :+ buildRDD
   }
 }
+
+object BroadcastHashJoinExecTransformer {
+
+  /**
+   * Summarizes the non-null values of the key in a single pass over the relation, keeping at most
+   * maxValues distinct values. Null keys never match.
+   */
+  def summarize(
+      relation: BuildSideRelation,
+      key: AttributeReference,
+      maxValues: Int): BuildKeySummary = {
+    val integral = key.dataType != StringType
+    val distinct = mutable.HashSet[Any]()
+    var tooManyValues = false
+    var min = Long.MaxValue
+    var max = Long.MinValue
+    relation.transform(key).iterator.filterNot(_.isNullAt(0)).foreach {
+      row =>
+        val value = if (integral) {
+          val long = row.get(0, key.dataType).asInstanceOf[Number].longValue()
+          min = math.min(min, long)
+          max = math.max(max, long)
+          long
+        } else {
+          row.getUTF8String(0)
+        }
+        if (!tooManyValues && distinct.add(value) && distinct.size > maxValues) {
+          tooManyValues = true
+          distinct.clear()
+        }
+    }
+    val range = if (integral && min <= max) Some((min, max)) else None
+    val values = if (tooManyValues) {
+      None
+    } else if (integral) {
+      Some(distinct.toSeq.map(_.asInstanceOf[Long]).sorted.map(_.toString))
+    } else {
+      // Hex encoded, the keys may hold the separator.
+      Some(distinct.toSeq.map(_.asInstanceOf[UTF8String].getBytes.map("%02x".format(_)).mkString))
+    }
+    BuildKeySummary(range, values)
+  }
+}
@@ -210,7 +210,7 @@ object JoinUtils {
       operatorId,
       validation)
 
-    // Combine join keys to make a single expression.
+    // Combine join keys to make a single expression, absent for a nested loop join.
     val joinExpressionNode = (streamedKeys
       .zip(buildKeys))
       .map {
@@ -222,7 +222,7 @@ object JoinUtils {
             rightType,
             substraitContext.registeredFunction)
       }
-      .reduce(
+      .reduceOption(
         (l, r) =>
           HashJoinLikeExecTransformer.makeAndExpression(l, r, substraitContext.registeredFunction))
 
@@ -239,7 +239,7 @@ object JoinUtils {
       streamedRelNode,
       buildRelNode,
       substraitJoinType,
-      joinExpressionNode,
+      joinExpressionNode.orNull,
       postJoinFilter.orNull,
       createJoinExtensionNode(joinParameters, streamedOutput ++ buildOutput),
       substraitContext,
@@ -430,7 +430,7 @@ object ConverterUtils extends Logging {
 
   def convertJoinType(joinType: JoinType): String = {
     joinType match {
-      case Inner =>
+      case _: InnerLike =>
         "Inner"
       case FullOuter =>
         "Outer"
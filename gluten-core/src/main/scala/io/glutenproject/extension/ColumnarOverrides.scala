@@ -29,7 +29,7 @@ import org.apache.spark.internal.Logging
 import org.apache.spark.sql.{SparkSession, SparkSessionExtensions}
 import org.apache.spark.sql.catalyst.expressions.{Alias, Attribute, AttributeReference, BindReferences, BoundReference, Expression, Murmur3Hash, NamedExpression, SortOrder}
 import org.apache.spark.sql.catalyst.optimizer.{BuildLeft, BuildRight, BuildSide}
-import org.apache.spark.sql.catalyst.plans.{LeftOuter, LeftSemi, RightOuter}
+import org.apache.spark.sql.catalyst.plans.{Inner, LeftOuter, LeftSemi, RightOuter}
 import org.apache.spark.sql.catalyst.plans.physical.{HashPartitioning, Partitioning, RangePartitioning}
 import org.apache.spark.sql.catalyst.rules.{PlanChangeLogger, Rule}
 import org.apache.spark.sql.execution._
@@ -400,6 +400,10 @@ case class TransformPreOverrides(isAdaptiveContext: Boolean)
         ) {
           if (BackendsApiManager.getSettings.removeHashColumnFromColumnarShuffleExchangeExec()) {
             plan.outputPartitioning match {
+              case HashPartitioning(exprs, _)
+                  if BackendsApiManager.getSettings.supportShuffleWriterHashKeys(exprs) =>
+                // The shuffle writer hashes the key columns itself.
+                ColumnarShuffleUtil.genColumnarShuffleExchange(plan, child, null)
               case HashPartitioning(exprs, _) =>
                 val projectChild = getProjectWithHash(exprs, child)
                 if (projectChild.supportsColumnar) {
@@ -446,16 +450,21 @@ case class TransformPreOverrides(isAdaptiveContext: Boolean)
         val left = replaceWithTransformerPlan(plan.left)
         val right = replaceWithTransformerPlan(plan.right)
         logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
-        BackendsApiManager.getSparkPlanExecApiInstance
+        val buildSide = getRuntimeBuildSide(plan)
+        val transformer = BackendsApiManager.getSparkPlanExecApiInstance
           .genShuffledHashJoinExecTransformer(
             plan.leftKeys,
             plan.rightKeys,
             plan.joinType,
-            plan.buildSide,
+            buildSide,
             plan.condition,
             left,
             right,
             plan.isSkewJoin)
+        if (buildSide != plan.buildSide) {
+          transformer.setTagValue(ShuffledHashJoinExecTransformerBase.BUILD_SIDE_SWAPPED, ())
+        }
+        transformer
       case plan: SortMergeJoinExec =>
         val left = replaceWithTransformerPlan(plan.left)
         val right = replaceWithTransformerPlan(plan.right)
@@ -485,6 +494,16 @@ case class TransformPreOverrides(isAdaptiveContext: Boolean)
             left,
             right,
             isNullAwareAntiJoin = plan.isNullAwareAntiJoin)
+      case plan: BroadcastNestedLoopJoinExec =>
+        val left = replaceWithTransformerPlan(plan.left)
+        val right = replaceWithTransformerPlan(plan.right)
+        BackendsApiManager.getSparkPlanExecApiInstance
+          .genBroadcastNestedLoopJoinExecTransformer(
+            left,
+            right,
+            plan.buildSide,
+            plan.joinType,
+            plan.condition)
       case plan: AQEShuffleReadExec
           if BackendsApiManager.getSettings.supportColumnarShuffleExec() =>
         plan.child match {
@@ -550,6 +569,40 @@ case class TransformPreOverrides(isAdaptiveContext: Boolean)
    * @return
    *   the supported build side
    */
+  /**
+   * The build side of an inner join whose inputs are both materialized query stages, swapped when
+   * the stage of the build side is clearly larger than the one of the streamed side. The build
+   * side was picked from the estimates before the stages ran.
+   */
+  private def getRuntimeBuildSide(plan: ShuffledHashJoinExec): BuildSide = {
+    val ratio = GlutenConfig.getConf.shuffledHashJoinBuildSideSwapRatio
+    if (plan.joinType != Inner || ratio <= 0 || plan.isSkewJoin) {
+      return plan.buildSide
+    }
+    def runtimeSizeInBytes(child: SparkPlan): Option[BigInt] =
+      child
+        .collectFirst { case stage: QueryStageExec => stage }
+        .flatMap(_.computeStats())
+        .map(_.sizeInBytes)
+    val (buildPlan, streamedPlan) = plan.buildSide match {
+      case BuildLeft => (plan.left, plan.right)
+      case BuildRight => (plan.right, plan.left)
+    }
+    (runtimeSizeInBytes(buildPlan), runtimeSizeInBytes(streamedPlan)) match {
+      case (Some(buildBytes), Some(streamedBytes))
+          if buildBytes > GlutenConfig.getConf.shuffledHashJoinBuildSideSwapMinBytes &&
+            BigDecimal(buildBytes) > BigDecimal(streamedBytes) * ratio =>
+        logInfo(
+          s"Swapping the build side of ${plan.nodeName}, which has $buildBytes bytes " +
+            s"against $streamedBytes bytes of the streamed side.")
+        plan.buildSide match {
+          case BuildLeft => BuildRight
+          case BuildRight => BuildLeft
+        }
+      case _ => plan.buildSide
+    }
+  }
+
   private def getSparkSupportedBuildSide(plan: ShuffledHashJoinExec): BuildSide = {
     plan.joinType match {
       case LeftOuter | LeftSemi => BuildRight
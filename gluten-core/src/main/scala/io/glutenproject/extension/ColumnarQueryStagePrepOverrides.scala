@@ -26,68 +26,101 @@ import org.apache.spark.sql.catalyst.optimizer.{BuildLeft, BuildRight}
 import org.apache.spark.sql.catalyst.rules.Rule
 import org.apache.spark.sql.execution.{ColumnarBroadcastExchangeExec, SparkPlan}
 import org.apache.spark.sql.execution.exchange.BroadcastExchangeExec
-import org.apache.spark.sql.execution.joins.BroadcastHashJoinExec
+import org.apache.spark.sql.execution.joins.{BroadcastHashJoinExec, BroadcastNestedLoopJoinExec}
 
-// BroadcastHashJoinExec and it's child BroadcastExec will be cut into different QueryStages,
+// A broadcast join and its child BroadcastExec will be cut into different QueryStages,
 // so the columnar rules will be applied to the two QueryStages separately, and they cannot
 // see each other during transformation. In order to prevent BroadcastExec being transformed
-// to columnar while BHJ fallbacks, BroadcastExec need to be tagged not transformable when applying
-// queryStagePrepRules.
+// to columnar while the join fallbacks, BroadcastExec need to be tagged not transformable when
+// applying queryStagePrepRules.
 case class FallbackBroadcastExchange(session: SparkSession) extends Rule[SparkPlan] {
   override def apply(plan: SparkPlan): SparkPlan = PhysicalPlanSelector.maybe(session, plan) {
-    val columnarConf: GlutenConfig = GlutenConfig.getConf
     plan.foreach {
       case bhj: BroadcastHashJoinExec =>
         val buildSidePlan = bhj.buildSide match {
           case BuildLeft => bhj.left
           case BuildRight => bhj.right
         }
-        val maybeExchange = buildSidePlan.find {
-          case BroadcastExchangeExec(_, _) => true
-          case _ => false
+        tagBroadcastJoin(
+          bhj,
+          buildSidePlan,
+          BackendsApiManager.getSparkPlanExecApiInstance
+            .genBroadcastHashJoinExecTransformer(
+              bhj.leftKeys,
+              bhj.rightKeys,
+              bhj.joinType,
+              bhj.buildSide,
+              bhj.condition,
+              bhj.left,
+              bhj.right,
+              bhj.isNullAwareAntiJoin)
+            .doValidate())
+      case bnlj: BroadcastNestedLoopJoinExec =>
+        val buildSidePlan = bnlj.buildSide match {
+          case BuildLeft => bnlj.left
+          case BuildRight => bnlj.right
         }
-        maybeExchange match {
-          case Some(exchange @ BroadcastExchangeExec(mode, child)) =>
-            val isTransformable =
-              if (
-                !columnarConf.enableColumnarBroadcastExchange ||
-                !columnarConf.enableColumnarBroadcastJoin
-              ) {
-                ValidationResult.notOk(
-                  "columnar broadcast exchange is disabled or " +
-                    "columnar broadcast join is disabled")
+        tagBroadcastJoin(
+          bnlj,
+          buildSidePlan,
+          if (BackendsApiManager.getSettings.supportBroadcastNestedLoopJoinExec()) {
+            BackendsApiManager.getSparkPlanExecApiInstance
+              .genBroadcastNestedLoopJoinExecTransformer(
+                bnlj.left,
+                bnlj.right,
+                bnlj.buildSide,
+                bnlj.joinType,
+                bnlj.condition)
+              .doValidate()
+          } else {
+            ValidationResult.notOk("BroadcastNestedLoopJoinExec is not supported by the backend")
+          }
+        )
+      case _ =>
+    }
+    plan
+  }
+
+  // Tags the join and the broadcast exchange of its build side not transformable unless both are,
+  // given whether the join transformer is valid.
+  private def tagBroadcastJoin(
+      join: SparkPlan,
+      buildSidePlan: SparkPlan,
+      isJoinTransformable: => ValidationResult): Unit = {
+    val columnarConf: GlutenConfig = GlutenConfig.getConf
+    val maybeExchange = buildSidePlan.find {
+      case BroadcastExchangeExec(_, _) => true
+      case _ => false
+    }
+    maybeExchange match {
+      case Some(exchange @ BroadcastExchangeExec(mode, child)) =>
+        val isTransformable =
+          if (
+            !columnarConf.enableColumnarBroadcastExchange ||
+            !columnarConf.enableColumnarBroadcastJoin
+          ) {
+            ValidationResult.notOk(
+              "columnar broadcast exchange is disabled or " +
+                "columnar broadcast join is disabled")
+          } else {
+            if (TransformHints.isAlreadyTagged(join) && TransformHints.isNotTransformable(join)) {
+              ValidationResult.notOk("broadcast join is already tagged as not transformable")
+            } else {
+              val joinValidation = isJoinTransformable
+              if (joinValidation.isValid) {
+                val exchangeTransformer = ColumnarBroadcastExchangeExec(mode, child)
+                exchangeTransformer.doValidate()
               } else {
-                if (TransformHints.isAlreadyTagged(bhj) && TransformHints.isNotTransformable(bhj)) {
-                  ValidationResult.notOk("broadcast join is already tagged as not transformable")
-                } else {
-                  val bhjTransformer = BackendsApiManager.getSparkPlanExecApiInstance
-                    .genBroadcastHashJoinExecTransformer(
-                      bhj.leftKeys,
-                      bhj.rightKeys,
-                      bhj.joinType,
-                      bhj.buildSide,
-                      bhj.condition,
-                      bhj.left,
-                      bhj.right,
-                      bhj.isNullAwareAntiJoin)
-                  val isBhjTransformable = bhjTransformer.doValidate()
-                  if (isBhjTransformable.isValid) {
-                    val exchangeTransformer = ColumnarBroadcastExchangeExec(mode, child)
-                    exchangeTransformer.doValidate()
-                  } else {
-                    isBhjTransformable
-                  }
-                }
+                joinValidation
               }
-            TransformHints.tagNotTransformable(bhj, isTransformable)
-            TransformHints.tagNotTransformable(exchange, isTransformable)
-          case _ =>
-          // Skip. This might be the case that the exchange was already
-          // executed in earlier stage
-        }
+            }
+          }
+        TransformHints.tagNotTransformable(join, isTransformable)
+        TransformHints.tagNotTransformable(exchange, isTransformable)
       case _ =>
+      // Skip. This might be the case that the exchange was already
+      // executed in earlier stage
     }
-    plan
   }
 }
 
@@ -294,6 +294,69 @@ case class AddTransformHintRule() extends Rule[SparkPlan] {
     plan.withNewChildren(plan.children.map(addTransformableTags))
   }
 
+  // Tags the broadcast exchange of the build side as the broadcast join, as they must be both
+  // columnar or both vanilla.
+  private def tagBroadcastJoin(
+      join: SparkPlan,
+      buildSidePlan: SparkPlan,
+      isTransformable: ValidationResult): Unit = {
+    val maybeExchange = buildSidePlan
+      .find {
+        case BroadcastExchangeExec(_, _) => true
+        case _ => false
+      }
+      .map(_.asInstanceOf[BroadcastExchangeExec])
+
+    maybeExchange match {
+      case Some(exchange @ BroadcastExchangeExec(mode, child)) =>
+        TransformHints.tag(join, isTransformable.toTransformHint)
+        TransformHints.tagNotTransformable(exchange, isTransformable)
+      case None =>
+        // we are in AQE, find the hidden exchange
+        // FIXME did we consider the case that AQE: OFF && Reuse: ON ?
+        var maybeHiddenExchange: Option[BroadcastExchangeLike] = None
+        breakable {
+          buildSidePlan.foreach {
+            case e: BroadcastExchangeLike =>
+              maybeHiddenExchange = Some(e)
+              break
+            case t: BroadcastQueryStageExec =>
+              t.plan.foreach {
+                case e2: BroadcastExchangeLike =>
+                  maybeHiddenExchange = Some(e2)
+                  break
+                case r: ReusedExchangeExec =>
+                  r.child match {
+                    case e2: BroadcastExchangeLike =>
+                      maybeHiddenExchange = Some(e2)
+                      break
+                    case _ =>
+                  }
+                case _ =>
+              }
+            case _ =>
+          }
+        }
+        // restriction to force the hidden exchange to be found
+        val exchange = maybeHiddenExchange.get
+        // to conform to the underlying exchange's type, columnar or vanilla
+        exchange match {
+          case BroadcastExchangeExec(mode, child) =>
+            TransformHints.tagNotTransformable(
+              join,
+              "it's a materialized broadcast exchange or reused broadcast exchange")
+          case ColumnarBroadcastExchangeExec(mode, child) =>
+            if (!isTransformable.isValid) {
+              throw new IllegalStateException(
+                s"BroadcastExchange has already been" +
+                  s" transformed to columnar version but the join is determined as" +
+                  s" non-transformable: ${join.toString()}")
+            }
+            TransformHints.tagTransformable(join)
+        }
+    }
+  }
+
   private def addTransformableTag(plan: SparkPlan): Unit = {
     if (TransformHints.isAlreadyTagged(plan)) {
       logDebug(
@@ -520,62 +583,31 @@ case class AddTransformHintRule() extends Rule[SparkPlan] {
               case BuildLeft => bhj.left
               case BuildRight => bhj.right
             }
-
-            val maybeExchange = buildSidePlan
-              .find {
-                case BroadcastExchangeExec(_, _) => true
-                case _ => false
-              }
-              .map(_.asInstanceOf[BroadcastExchangeExec])
-
-            maybeExchange match {
-              case Some(exchange @ BroadcastExchangeExec(mode, child)) =>
-                TransformHints.tag(bhj, isBhjTransformable.toTransformHint)
-                TransformHints.tagNotTransformable(exchange, isBhjTransformable)
-              case None =>
-                // we are in AQE, find the hidden exchange
-                // FIXME did we consider the case that AQE: OFF && Reuse: ON ?
-                var maybeHiddenExchange: Option[BroadcastExchangeLike] = None
-                breakable {
-                  buildSidePlan.foreach {
-                    case e: BroadcastExchangeLike =>
-                      maybeHiddenExchange = Some(e)
-                      break
-                    case t: BroadcastQueryStageExec =>
-                      t.plan.foreach {
-                        case e2: BroadcastExchangeLike =>
-                          maybeHiddenExchange = Some(e2)
-                          break
-                        case r: ReusedExchangeExec =>
-                          r.child match {
-                            case e2: BroadcastExchangeLike =>
-                              maybeHiddenExchange = Some(e2)
-                              break
-                            case _ =>
-                          }
-                        case _ =>
-                      }
-                    case _ =>
-                  }
-                }
-                // restriction to force the hidden exchange to be found
-                val exchange = maybeHiddenExchange.get
-                // to conform to the underlying exchange's type, columnar or vanilla
-                exchange match {
-                  case BroadcastExchangeExec(mode, child) =>
-                    TransformHints.tagNotTransformable(
-                      bhj,
-                      "it's a materialized broadcast exchange or reused broadcast exchange")
-                  case ColumnarBroadcastExchangeExec(mode, child) =>
-                    if (!isBhjTransformable.isValid) {
-                      throw new IllegalStateException(
-                        s"BroadcastExchange has already been" +
-                          s" transformed to columnar version but BHJ is determined as" +
-                          s" non-transformable: ${bhj.toString()}")
-                    }
-                    TransformHints.tagTransformable(bhj)
-                }
+            tagBroadcastJoin(bhj, buildSidePlan, isBhjTransformable)
+          }
+        case bnlj: BroadcastNestedLoopJoinExec =>
+          if (!enableColumnarBroadcastJoin) {
+            TransformHints.tagNotTransformable(
+              bnlj,
+              "columnar BroadcastJoin is not enabled in BroadcastNestedLoopJoinExec")
+          } else if (!BackendsApiManager.getSettings.supportBroadcastNestedLoopJoinExec()) {
+            TransformHints.tagNotTransformable(
+              bnlj,
+              "BroadcastNestedLoopJoinExec is not supported by the backend")
+          } else {
+            val isBnljTransformable = BackendsApiManager.getSparkPlanExecApiInstance
+              .genBroadcastNestedLoopJoinExecTransformer(
+                bnlj.left,
+                bnlj.right,
+                bnlj.buildSide,
+                bnlj.joinType,
+                bnlj.condition)
+              .doValidate()
+            val buildSidePlan = bnlj.buildSide match {
+              case BuildLeft => bnlj.left
+              case BuildRight => bnlj.right
             }
+            tagBroadcastJoin(bnlj, buildSidePlan, isBnljTransformable)
           }
         case plan: SortMergeJoinExec =>
           if (!enableColumnarSortMergeJoin || plan.joinType == FullOuter) {
@@ -44,6 +44,11 @@ object SoftAffinityManager extends LogLevelUtil with Logging {
   // host list
   val nodesExecutorsMap = new mutable.HashMap[String, mutable.HashSet[String]]()
 
+  // file -> ids of the executors which reported it in their native cache
+  val cachedFileExecutors = new mutable.HashMap[String, mutable.LinkedHashSet[String]]()
+  // execId -> files it reported
+  private val executorCachedFiles = new mutable.HashMap[String, Set[String]]()
+
   protected val totalRegisteredExecutors = new AtomicInteger(0)
 
   lazy val usingSoftAffinity = SparkEnv.get.conf.getBoolean(
@@ -51,6 +56,11 @@ object SoftAffinityManager extends LogLevelUtil with Logging {
     GlutenConfig.GLUTEN_SOFT_AFFINITY_ENABLED_DEFAULT_VALUE
   )
 
+  lazy val usingCacheAwareAffinity = SparkEnv.get.conf.getBoolean(
+    GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED,
+    GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED_DEFAULT_VALUE
+  )
+
   private val softAffinityLogLevel = GlutenConfig.getConf.softAffinityLogLevel
 
   def totalExecutors(): Int = totalRegisteredExecutors.intValue()
@@ -111,6 +121,7 @@ object SoftAffinityManager extends LogLevelUtil with Logging {
         }
         totalRegisteredExecutors.addAndGet(-1)
       }
+      removeCachedFiles(execId, executorCachedFiles.remove(execId).getOrElse(Set.empty))
       logOnLevel(
         softAffinityLogLevel,
         s"After removing executor $execId, " +
@@ -123,6 +134,59 @@ object SoftAffinityManager extends LogLevelUtil with Logging {
     }
   }
 
+  /** Replaces the files the executor reported in its native cache. */
+  def updateCachedFiles(execId: String, files: Array[String]): Unit = {
+    resourceRWLock.writeLock().lock()
+    try {
+      val previous = executorCachedFiles.getOrElse(execId, Set.empty)
+      val current = files.toSet
+      removeCachedFiles(execId, previous -- current)
+      (current -- previous).foreach {
+        file =>
+          cachedFileExecutors.getOrElseUpdate(file, new mutable.LinkedHashSet[String]()) += execId
+      }
+      executorCachedFiles(execId) = current
+      logOnLevel(
+        softAffinityLogLevel,
+        s"Executor $execId reported ${current.size} cached files, " +
+          s"${cachedFileExecutors.size} cached files in total.")
+    } finally {
+      resourceRWLock.writeLock().unlock()
+    }
+  }
+
+  // Must hold the write lock.
+  private def removeCachedFiles(execId: String, files: Set[String]): Unit = {
+    files.foreach {
+      file =>
+        cachedFileExecutors.get(file).foreach {
+          execs =>
+            execs -= execId
+            if (execs.isEmpty) {
+              cachedFileExecutors.remove(file)
+            }
+        }
+    }
+  }
+
+  /** The alive executors which reported the file in their native cache, as askExecutors. */
+  def askCachedExecutors(file: String): Array[(String, String)] = {
+    resourceRWLock.readLock().lock()
+    try {
+      cachedFileExecutors.get(file) match {
+        case Some(execIds) =>
+          // The reports may race with the removal of their executors, only the alive ones count.
+          fixedIdForExecutors.flatten
+            .filter(execHost => execIds.contains(execHost._1))
+            .take(softAffinityAllocation.softAffinityReplicationNum)
+            .toArray
+        case None => Array.empty
+      }
+    } finally {
+      resourceRWLock.readLock().unlock()
+    }
+  }
+
   def checkTargetHosts(hosts: Array[String]): Boolean = {
     resourceRWLock.readLock().lock()
     try {
@@ -17,6 +17,7 @@
 package org.apache.spark.rpc
 
 import io.glutenproject.GlutenConfig
+import io.glutenproject.softaffinity.SoftAffinityManager
 
 import org.apache.spark.SparkEnv
 import org.apache.spark.internal.Logging
@@ -54,6 +55,9 @@ class GlutenDriverEndpoint extends IsolatedRpcEndpoint with Logging {
       totalRegisteredExecutors.addAndGet(-1)
       logTrace(s"Executor endpoint ref $executorId is removed.")
 
+    case GlutenCachedFilesReport(executorId, files) =>
+      SoftAffinityManager.updateCachedFiles(executorId, files)
+
     case e =>
       logError(s"Received unexpected message. $e")
   }
@@ -16,6 +16,7 @@
  */
 package org.apache.spark.rpc
 
+import io.glutenproject.GlutenConfig
 import io.glutenproject.backendsapi.BackendsApiManager
 
 import org.apache.spark.{SparkConf, SparkEnv}
@@ -23,6 +24,8 @@ import org.apache.spark.internal.{config, Logging}
 import org.apache.spark.rpc.GlutenRpcMessages._
 import org.apache.spark.util.ThreadUtils
 
+import java.util.concurrent.TimeUnit
+
 import scala.util.{Failure, Success}
 
 /** Gluten executor endpoint. */
@@ -39,6 +42,23 @@ class GlutenExecutorEndpoint(val executorId: String, val conf: SparkConf)
 
   @volatile var driverEndpointRef: RpcEndpointRef = null
 
+  private val cachedFilesReporter =
+    if (
+      conf.getBoolean(
+        GlutenConfig.GLUTEN_SOFT_AFFINITY_ENABLED,
+        GlutenConfig.GLUTEN_SOFT_AFFINITY_ENABLED_DEFAULT_VALUE) &&
+      conf.getBoolean(
+        GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED,
+        GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED_DEFAULT_VALUE)
+    ) {
+      Some(ThreadUtils.newDaemonSingleThreadScheduledExecutor("gluten-cached-files-reporter"))
+    } else {
+      None
+    }
+
+  // Only accessed by the reporter thread.
+  private var reportedCachedFilesVersion = -1L
+
   rpcEnv.setupEndpoint(GlutenRpcConstants.GLUTEN_EXECUTOR_ENDPOINT_NAME, this)
 
   override def onStart(): Unit = {
@@ -54,9 +74,42 @@ class GlutenExecutorEndpoint(val executorId: String, val conf: SparkConf)
         case Success(_) => logTrace("Register GlutenExecutor listener success.")
         case Failure(e) => logError("Register GlutenExecutor listener error.", e)
       }(ThreadUtils.sameThread)
+    cachedFilesReporter.foreach {
+      reporter =>
+        val interval = conf.getTimeAsMs(
+          GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_REPORT_INTERVAL,
+          GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_REPORT_INTERVAL_DEFAULT_VALUE)
+        reporter.scheduleWithFixedDelay(
+          () => reportCachedFiles(),
+          interval,
+          interval,
+          TimeUnit.MILLISECONDS)
+    }
     logInfo("Initialized GlutenExecutorEndpoint.")
   }
 
+  override def onStop(): Unit = {
+    cachedFilesReporter.foreach(_.shutdownNow())
+  }
+
+  private def reportCachedFiles(): Unit = {
+    val ref = driverEndpointRef
+    if (ref == null) {
+      return
+    }
+    try {
+      val contextApi = BackendsApiManager.getContextApiInstance
+      // Read before the files, a change in between is reported the next time.
+      val version = contextApi.cachedFilesVersion()
+      if (version != reportedCachedFilesVersion) {
+        ref.send(GlutenCachedFilesReport(executorId, contextApi.cachedFiles()))
+        reportedCachedFilesVersion = version
+      }
+    } catch {
+      case e: Exception => logWarning("Failed to report the cached files.", e)
+    }
+  }
+
   override def receive: PartialFunction[Any, Unit] = {
     case GlutenCleanExecutionResource(executionId, hashIds) =>
       BackendsApiManager.getContextApiInstance
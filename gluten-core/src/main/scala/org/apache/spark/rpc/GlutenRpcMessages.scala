@@ -35,4 +35,7 @@ object GlutenRpcMessages {
   case class GlutenCleanExecutionResource(executionId: String, broadcastHashIds: util.Set[String])
     extends GlutenRpcMessage
 
+  case class GlutenCachedFilesReport(executorId: String, files: Array[String])
+    extends GlutenRpcMessage
+
 }
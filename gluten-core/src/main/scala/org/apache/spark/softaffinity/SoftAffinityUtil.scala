@@ -25,6 +25,9 @@ import org.apache.spark.internal.Logging
 import org.apache.spark.scheduler.ExecutorCacheTaskLocation
 import org.apache.spark.sql.execution.datasources.FilePartition
 
+import java.net.URLDecoder
+import java.nio.charset.StandardCharsets
+
 object SoftAffinityUtil extends LogLevelUtil with Logging {
 
   private lazy val softAffinityLogLevel = GlutenConfig.getConf.softAffinityLogLevel
@@ -34,7 +37,11 @@ object SoftAffinityUtil extends LogLevelUtil with Logging {
     // Get the original preferred locations
     val expectedTargets = filePartition.preferredLocations()
 
-    if (
+    val cachedLocations = getCachedLocations(filePartition)
+    if (!cachedLocations.isEmpty) {
+      // Reading the cache of an executor beats reading the local replicas.
+      cachedLocations
+    } else if (
       !filePartition.files.isEmpty && SoftAffinityManager.usingSoftAffinity
       && !SoftAffinityManager.checkTargetHosts(expectedTargets)
     ) {
@@ -62,6 +69,27 @@ object SoftAffinityUtil extends LogLevelUtil with Logging {
     }
   }
 
+  /** Get the executors which cached the first file of the partition, empty if none */
+  private def getCachedLocations(filePartition: FilePartition): Array[String] = {
+    if (
+      filePartition.files.isEmpty || !SoftAffinityManager.usingSoftAffinity ||
+      !SoftAffinityManager.usingCacheAwareAffinity
+    ) {
+      return Array.empty[String]
+    }
+    val file = filePartition.files.sortBy(_.filePath).head
+    // The native scans report the decoded paths they read.
+    val path = URLDecoder.decode(file.filePath, StandardCharsets.UTF_8.name())
+    val locations = SoftAffinityManager.askCachedExecutors(path)
+    if (!locations.isEmpty) {
+      logOnLevel(
+        softAffinityLogLevel,
+        s"SAMetrics=File ${file.filePath} - " +
+          s"the executors caching it are ${locations.mkString("_")} ")
+    }
+    locations.map(p => ExecutorCacheTaskLocation(p._2, p._1).toString)
+  }
+
   /** Get the locations by SoftAffinityManager */
   def getNativeMergeTreePartitionLocations(
       filePartition: GlutenMergeTreePartition): Array[String] = {
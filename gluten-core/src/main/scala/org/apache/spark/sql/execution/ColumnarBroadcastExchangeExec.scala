@@ -26,7 +26,7 @@ import org.apache.spark.rdd.RDD
 import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.catalyst.expressions.Attribute
 import org.apache.spark.sql.catalyst.plans.logical.Statistics
-import org.apache.spark.sql.catalyst.plans.physical.{BroadcastMode, BroadcastPartitioning, Partitioning}
+import org.apache.spark.sql.catalyst.plans.physical.{BroadcastMode, BroadcastPartitioning, IdentityBroadcastMode, Partitioning}
 import org.apache.spark.sql.execution.exchange.{BroadcastExchangeExec, BroadcastExchangeLike}
 import org.apache.spark.sql.execution.joins.HashedRelationBroadcastMode
 import org.apache.spark.sql.execution.metric.{SQLMetric, SQLMetrics}
@@ -134,9 +134,12 @@ case class ColumnarBroadcastExchangeExec(mode: BroadcastMode, child: SparkPlan)
   override protected def doValidateInternal(): ValidationResult = mode match {
     case _: HashedRelationBroadcastMode =>
       ValidationResult.ok
+    case IdentityBroadcastMode
+        if BackendsApiManager.getSettings.supportBroadcastNestedLoopJoinExec() =>
+      // Broadcast for BroadcastNestedLoopJoinExec.
+      ValidationResult.ok
     case _ =>
-      // TODO IdentityBroadcastMode not supported. Need to support BroadcastNestedLoopJoin first.
-      ValidationResult.notOk("Only support HashedRelationBroadcastMode for now.")
+      ValidationResult.notOk(s"Unsupported broadcast mode $mode.")
   }
 
   override def doPrepare(): Unit = {
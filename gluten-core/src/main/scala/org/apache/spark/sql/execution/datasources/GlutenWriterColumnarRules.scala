@@ -91,6 +91,18 @@ object GlutenWriterColumnarRules {
   val TAG: TreeNodeTag[MATERIALIZE_TAG] =
     TreeNodeTag[MATERIALIZE_TAG]("io.glutenproject.materialize")
 
+  // Neither native parquet writer writes bloom filters or page indexes but parquet-mr, which takes
+  // the bloom filter options of each column, e.g. parquet.bloom.filter.enabled#col and
+  // parquet.bloom.filter.fpp#col, and writes the page indexes by default.
+  private def needsParquetIndexes(options: Map[String, String]): Boolean = {
+    def bloomFilterEnabled(conf: Iterable[(String, String)]): Boolean = conf.exists {
+      case (key, value) =>
+        key.startsWith("parquet.bloom.filter.enabled") && "true".equalsIgnoreCase(value)
+    }
+    GlutenConfig.getConf.nativeParquetWritePageIndex || bloomFilterEnabled(options) ||
+    bloomFilterEnabled(SparkSession.active.sessionState.conf.getAllConfs)
+  }
+
   // TODO: support ctas in Spark3.4, see https://github.com/apache/spark/pull/39220
   // TODO: support dynamic partition and bucket write
   //  1. pull out `Empty2Null` and required ordering to `WriteFilesExec`, see Spark3.4 `V1Writes`
@@ -108,6 +120,9 @@ object GlutenWriterColumnarRules {
         }
 
         if ("parquet".equals(command.table.provider.get)) {
+          if (needsParquetIndexes(command.table.storage.properties)) {
+            return (false, "")
+          }
           return (true, "parquet")
         } else if ("orc".equals(command.table.provider.get)) {
           return (true, "orc")
@@ -117,14 +132,15 @@ object GlutenWriterColumnarRules {
       case command: InsertIntoHadoopFsRelationCommand
           if command.fileFormat.isInstanceOf[ParquetFileFormat] ||
             command.fileFormat.isInstanceOf[OrcFileFormat] =>
-        if (
-          GlutenConfig.isCurrentBackendVelox
-          && (command.partitionColumns.nonEmpty || command.bucketSpec.nonEmpty)
-        ) {
+        // The partitioned writes of the Velox backend are split by VeloxRowSplitter.
+        if (GlutenConfig.isCurrentBackendVelox && command.bucketSpec.nonEmpty) {
           return (false, "")
         }
 
         if (command.fileFormat.isInstanceOf[ParquetFileFormat]) {
+          if (needsParquetIndexes(command.options)) {
+            return (false, "")
+          }
           return (true, "parquet")
         } else if (command.fileFormat.isInstanceOf[OrcFileFormat]) {
           return (true, "orc")
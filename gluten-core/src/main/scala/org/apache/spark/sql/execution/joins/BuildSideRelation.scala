@@ -22,8 +22,19 @@ import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.catalyst.expressions.Expression
 import org.apache.spark.sql.vectorized.ColumnarBatch
 
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * The range of an integral build key and, if few enough, its distinct values, as sent with a
+ * broadcast hash join to filter the scan of its probe side.
+ */
+case class BuildKeySummary(range: Option[(Long, Long)], values: Option[Seq[String]])
+
 trait BuildSideRelation extends Serializable {
 
+  // The summaries of the keys already asked for, on the driver.
+  @transient private lazy val keySummaries = new ConcurrentHashMap[Expression, BuildKeySummary]()
+
   /** Deserialized relation from broadcasted value */
   def deserialized: Iterator[ColumnarBatch]
 
@@ -35,4 +46,11 @@ trait BuildSideRelation extends Serializable {
 
   /** Returns a read-only copy of this, to be safely used in current thread. */
   def asReadOnlyCopy(broadCastContext: BroadCastHashJoinContext): BuildSideRelation
+
+  /**
+   * The summary of the key, computed by summarize once per key of the relation, rather than each
+   * time a plan using the relation is transformed.
+   */
+  def keySummary(key: Expression)(summarize: => BuildKeySummary): BuildKeySummary =
+    keySummaries.computeIfAbsent(key, _ => summarize)
 }
@@ -37,6 +37,7 @@ class SoftAffinitySuite extends QueryTest with SharedSparkSession with Predicate
     .set(GlutenConfig.GLUTEN_SOFT_AFFINITY_ENABLED, "true")
     .set(GlutenConfig.GLUTEN_SOFT_AFFINITY_REPLICATIONS_NUM, "2")
     .set(GlutenConfig.GLUTEN_SOFT_AFFINITY_MIN_TARGET_HOSTS, "2")
+    .set(GlutenConfig.GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED, "true")
 
   def generateNativePartition1(): Unit = {
     val partition = FilePartition(
@@ -232,4 +233,44 @@ class SoftAffinitySuite extends QueryTest with SharedSparkSession with Predicate
     // all executors were removed, return the original hosts list
     generateNativePartition5()
   }
+
+  test("Soft Affinity Scheduler prefers the executors caching the file") {
+    val executorsListListener = new SoftAffinityListener()
+    executorsListListener.onExecutorAdded(
+      SparkListenerExecutorAdded(
+        System.currentTimeMillis(),
+        "7",
+        new ExecutorInfo("host-7", 3, null)))
+    executorsListListener.onExecutorAdded(
+      SparkListenerExecutorAdded(
+        System.currentTimeMillis(),
+        "8",
+        new ExecutorInfo("host-8", 3, null)))
+
+    // The native scans report the decoded paths.
+    SoftAffinityManager.updateCachedFiles("7", Array("cached path", "other"))
+    val partition = FilePartition(
+      0,
+      Seq(
+        PartitionedFile(InternalRow.empty, "cached%20path", 0, 100, Array("host-7", "host-8"))
+      ).toArray
+    )
+    // Even if the original hosts run executors.
+    assertResult(Set("executor_host-7_7")) {
+      SoftAffinityUtil.getFilePartitionLocations(partition).toSet
+    }
+
+    // A new report replaces the files of the executor.
+    SoftAffinityManager.updateCachedFiles("7", Array("other"))
+    assertResult(Set("host-7", "host-8")) {
+      SoftAffinityUtil.getFilePartitionLocations(partition).toSet
+    }
+
+    SoftAffinityManager.updateCachedFiles("8", Array("cached path"))
+    executorsListListener.onExecutorRemoved(
+      SparkListenerExecutorRemoved(System.currentTimeMillis(), "8", ""))
+    executorsListListener.onExecutorRemoved(
+      SparkListenerExecutorRemoved(System.currentTimeMillis(), "7", ""))
+    assert(SoftAffinityManager.cachedFileExecutors.isEmpty)
+  }
 }
@@ -33,6 +33,8 @@ public class ColumnarBatchJniWrapper extends JniInitialized {
 
   public native long compose(long[] handles);
 
+  public native long select(long handle, int[] columnIndices);
+
   public native long createWithArrowArray(long cSchema, long cArray);
 
   public native void exportToArrow(long handle, long cSchema, long cArray);
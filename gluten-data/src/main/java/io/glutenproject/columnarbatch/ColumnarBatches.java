@@ -259,6 +259,14 @@ public class ColumnarBatches {
     return ColumnarBatchJniWrapper.INSTANCE.compose(handles);
   }
 
+  /** Selects columns of a native batch without copying them. The input batch is closed. */
+  public static ColumnarBatch select(ColumnarBatch batch, int[] columnIndices) {
+    final long handle =
+        ColumnarBatchJniWrapper.INSTANCE.select(getNativeHandle(batch), columnIndices);
+    batch.close();
+    return create(handle);
+  }
+
   public static long numBytes(ColumnarBatch input) {
     return ColumnarBatchJniWrapper.INSTANCE.numBytes(ColumnarBatches.getNativeHandle(input));
   }
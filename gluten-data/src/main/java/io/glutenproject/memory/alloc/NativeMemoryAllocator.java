@@ -55,10 +55,31 @@ public class NativeMemoryAllocator {
     return bytesAllocated(this.nativeInstanceId);
   }
 
+  /** Statistics of the malloc implementation behind the allocator. Fields are -1 if unknown. */
+  public BackendStats getBackendStats() {
+    long[] values = backendStats(this.nativeInstanceId);
+    return new BackendStats(values[0], values[1], values[2]);
+  }
+
   public void close() {
     releaseAllocator(this.nativeInstanceId);
   }
 
+  /**
+   * Writes the sampled native allocations of the executor as a pprof readable heap profile. Only
+   * the allocations of the given pool are written if it's not empty. Returns the number of live
+   * samples, or -1 on failure. Sampling is enabled by
+   * spark.gluten.memory.allocationProfiler.sampleInterval.
+   */
+  public static long dumpAllocationProfile(String path, String pool) {
+    return dumpAllocationProfile0(path, pool);
+  }
+
+  /** Sampled bytes in use per pool, one pool per line. */
+  public static String allocationProfileSummary() {
+    return allocationProfileSummary0();
+  }
+
   private static native long getAllocator(String typeName);
 
   private static native long createListenableAllocator(
@@ -67,4 +88,30 @@ public class NativeMemoryAllocator {
   private static native void releaseAllocator(long allocatorId);
 
   private static native long bytesAllocated(long allocatorId);
+
+  private static native long[] backendStats(long allocatorId);
+
+  private static native long dumpAllocationProfile0(String path, String pool);
+
+  private static native String allocationProfileSummary0();
+
+  public static class BackendStats {
+    public final long allocated;
+    public final long resident;
+    public final long retained;
+
+    BackendStats(long allocated, long resident, long retained) {
+      this.allocated = allocated;
+      this.resident = resident;
+      this.retained = retained;
+    }
+
+    /** Resident bytes per allocated byte, -1 if unknown. */
+    public double fragmentation() {
+      if (allocated <= 0 || resident < 0) {
+        return -1;
+      }
+      return (double) resident / allocated;
+    }
+  }
 }
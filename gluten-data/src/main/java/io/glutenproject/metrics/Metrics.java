@@ -18,6 +18,12 @@ package io.glutenproject.metrics;
 
 import io.glutenproject.exception.GlutenException;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.LongBuffer;
+import java.util.HashMap;
+import java.util.Map;
+
 public class Metrics implements IMetrics {
   public long[] inputRows;
   public long[] inputVectors;
@@ -40,66 +46,165 @@ public class Metrics implements IMetrics {
   public long[] numDynamicFiltersAccepted;
   public long[] numReplacedWithDynamicFilterRows;
   public long[] flushRowCount;
+  public long[] abandonedPartialAggregation;
   public long[] skippedSplits;
   public long[] processedSplits;
   public long[] skippedStrides;
   public long[] processedStrides;
+  public long[] preloadedSplits;
+  public long[] preloadHits;
+  public long[] ioWaitNanos;
+  public long[] readAheadBytes;
+  public long[] ramReadBytes;
+  public long[] localReadBytes;
+  public long[] storageReadBytes;
   public SingleMetric singleMetric = new SingleMetric();
+  private final Map<String, long[]> extraCounters = new HashMap<>();
 
-  /** Create an instance for native metrics. */
+  /**
+   * Create an instance for native metrics. The counters are a table of native-ordered longs, one
+   * row per operator and one column per name. The buffer is only valid during this call, so the
+   * counters are copied. The task values are task-wide, e.g. the latency percentiles of the task.
+   */
   public Metrics(
-      long[] inputRows,
-      long[] inputVectors,
-      long[] inputBytes,
-      long[] rawInputRows,
-      long[] rawInputBytes,
-      long[] outputRows,
-      long[] outputVectors,
-      long[] outputBytes,
-      long[] cpuCount,
-      long[] wallNanos,
+      String[] names,
+      ByteBuffer counters,
       long veloxToArrow,
-      long[] peakMemoryBytes,
-      long[] numMemoryAllocations,
-      long[] spilledBytes,
-      long[] spilledRows,
-      long[] spilledPartitions,
-      long[] spilledFiles,
-      long[] numDynamicFiltersProduced,
-      long[] numDynamicFiltersAccepted,
-      long[] numReplacedWithDynamicFilterRows,
-      long[] flushRowCount,
-      long[] scanTime,
-      long[] skippedSplits,
-      long[] processedSplits,
-      long[] skippedStrides,
-      long[] processedStrides) {
-    this.inputRows = inputRows;
-    this.inputVectors = inputVectors;
-    this.inputBytes = inputBytes;
-    this.rawInputRows = rawInputRows;
-    this.rawInputBytes = rawInputBytes;
-    this.outputRows = outputRows;
-    this.outputVectors = outputVectors;
-    this.outputBytes = outputBytes;
-    this.cpuCount = cpuCount;
-    this.wallNanos = wallNanos;
-    this.scanTime = scanTime;
+      long arbitrationWaitNanos,
+      String[] taskValueNames,
+      long[] taskValues) {
     this.singleMetric.veloxToArrow = veloxToArrow;
-    this.peakMemoryBytes = peakMemoryBytes;
-    this.numMemoryAllocations = numMemoryAllocations;
-    this.spilledBytes = spilledBytes;
-    this.spilledRows = spilledRows;
-    this.spilledPartitions = spilledPartitions;
-    this.spilledFiles = spilledFiles;
-    this.numDynamicFiltersProduced = numDynamicFiltersProduced;
-    this.numDynamicFiltersAccepted = numDynamicFiltersAccepted;
-    this.numReplacedWithDynamicFilterRows = numReplacedWithDynamicFilterRows;
-    this.flushRowCount = flushRowCount;
-    this.skippedSplits = skippedSplits;
-    this.processedSplits = processedSplits;
-    this.skippedStrides = skippedStrides;
-    this.processedStrides = processedStrides;
+    this.singleMetric.arbitrationWaitNanos = arbitrationWaitNanos;
+    for (int i = 0; i < taskValueNames.length; i++) {
+      this.singleMetric.taskValues.put(taskValueNames[i], taskValues[i]);
+    }
+    LongBuffer table =
+        counters == null
+            ? LongBuffer.allocate(0)
+            : counters.order(ByteOrder.nativeOrder()).asLongBuffer();
+    int numMetrics = names.length == 0 ? 0 : table.remaining() / names.length;
+    for (int i = 0; i < names.length; i++) {
+      long[] values = new long[numMetrics];
+      for (int j = 0; j < numMetrics; j++) {
+        values[j] = table.get(j * names.length + i);
+      }
+      setCounter(names[i], values);
+    }
+  }
+
+  private void setCounter(String name, long[] values) {
+    switch (name) {
+      case "inputRows":
+        inputRows = values;
+        break;
+      case "inputVectors":
+        inputVectors = values;
+        break;
+      case "inputBytes":
+        inputBytes = values;
+        break;
+      case "rawInputRows":
+        rawInputRows = values;
+        break;
+      case "rawInputBytes":
+        rawInputBytes = values;
+        break;
+      case "outputRows":
+        outputRows = values;
+        break;
+      case "outputVectors":
+        outputVectors = values;
+        break;
+      case "outputBytes":
+        outputBytes = values;
+        break;
+      case "cpuCount":
+        cpuCount = values;
+        break;
+      case "wallNanos":
+        wallNanos = values;
+        break;
+      case "peakMemoryBytes":
+        peakMemoryBytes = values;
+        break;
+      case "numMemoryAllocations":
+        numMemoryAllocations = values;
+        break;
+      case "spilledBytes":
+        spilledBytes = values;
+        break;
+      case "spilledRows":
+        spilledRows = values;
+        break;
+      case "spilledPartitions":
+        spilledPartitions = values;
+        break;
+      case "spilledFiles":
+        spilledFiles = values;
+        break;
+      case "numDynamicFiltersProduced":
+        numDynamicFiltersProduced = values;
+        break;
+      case "numDynamicFiltersAccepted":
+        numDynamicFiltersAccepted = values;
+        break;
+      case "numReplacedWithDynamicFilterRows":
+        numReplacedWithDynamicFilterRows = values;
+        break;
+      case "flushRowCount":
+        flushRowCount = values;
+        break;
+      case "abandonedPartialAggregation":
+        abandonedPartialAggregation = values;
+        break;
+      case "scanTime":
+        scanTime = values;
+        break;
+      case "skippedSplits":
+        skippedSplits = values;
+        break;
+      case "processedSplits":
+        processedSplits = values;
+        break;
+      case "skippedStrides":
+        skippedStrides = values;
+        break;
+      case "processedStrides":
+        processedStrides = values;
+        break;
+      case "preloadedSplits":
+        preloadedSplits = values;
+        break;
+      case "preloadHits":
+        preloadHits = values;
+        break;
+      case "ioWaitNanos":
+        ioWaitNanos = values;
+        break;
+      case "readAheadBytes":
+        readAheadBytes = values;
+        break;
+      case "ramReadBytes":
+        ramReadBytes = values;
+        break;
+      case "localReadBytes":
+        localReadBytes = values;
+        break;
+      case "storageReadBytes":
+        storageReadBytes = values;
+        break;
+      default:
+        extraCounters.put(name, values);
+    }
+  }
+
+  /** Counters reported by the native side without a dedicated field, null if absent. */
+  public long[] get(String name) {
+    return extraCounters.get(name);
+  }
+
+  public Map<String, long[]> getExtraCounters() {
+    return extraCounters;
   }
 
   public OperatorMetrics getOperatorMetrics(int index) {
@@ -128,11 +233,19 @@ public class Metrics implements IMetrics {
         numDynamicFiltersAccepted[index],
         numReplacedWithDynamicFilterRows[index],
         flushRowCount[index],
+        abandonedPartialAggregation[index],
         scanTime[index],
         skippedSplits[index],
         processedSplits[index],
         skippedStrides[index],
-        processedStrides[index]);
+        processedStrides[index],
+        preloadedSplits[index],
+        preloadHits[index],
+        ioWaitNanos[index],
+        readAheadBytes[index],
+        ramReadBytes[index],
+        localReadBytes[index],
+        storageReadBytes[index]);
   }
 
   public SingleMetric getSingleMetrics() {
@@ -141,5 +254,8 @@ public class Metrics implements IMetrics {
 
   public static class SingleMetric {
     public long veloxToArrow;
+    public long arbitrationWaitNanos;
+    // E.g. nextLatencyP99Nanos, see WholeStageResultIterator.
+    public final Map<String, Long> taskValues = new HashMap<>();
   }
 }
@@ -38,10 +38,18 @@ public class OperatorMetrics implements IOperatorMetrics {
   public long numDynamicFiltersAccepted;
   public long numReplacedWithDynamicFilterRows;
   public long flushRowCount;
+  public long abandonedPartialAggregation;
   public long skippedSplits;
   public long processedSplits;
   public long skippedStrides;
   public long processedStrides;
+  public long preloadedSplits;
+  public long preloadHits;
+  public long ioWaitNanos;
+  public long readAheadBytes;
+  public long ramReadBytes;
+  public long localReadBytes;
+  public long storageReadBytes;
 
   /** Create an instance for operator metrics. */
   public OperatorMetrics(
@@ -65,11 +73,19 @@ public class OperatorMetrics implements IOperatorMetrics {
       long numDynamicFiltersAccepted,
       long numReplacedWithDynamicFilterRows,
       long flushRowCount,
+      long abandonedPartialAggregation,
       long scanTime,
       long skippedSplits,
       long processedSplits,
       long skippedStrides,
-      long processedStrides) {
+      long processedStrides,
+      long preloadedSplits,
+      long preloadHits,
+      long ioWaitNanos,
+      long readAheadBytes,
+      long ramReadBytes,
+      long localReadBytes,
+      long storageReadBytes) {
     this.inputRows = inputRows;
     this.inputVectors = inputVectors;
     this.inputBytes = inputBytes;
@@ -91,9 +107,17 @@ public class OperatorMetrics implements IOperatorMetrics {
     this.numDynamicFiltersAccepted = numDynamicFiltersAccepted;
     this.numReplacedWithDynamicFilterRows = numReplacedWithDynamicFilterRows;
     this.flushRowCount = flushRowCount;
+    this.abandonedPartialAggregation = abandonedPartialAggregation;
     this.skippedSplits = skippedSplits;
     this.processedSplits = processedSplits;
     this.skippedStrides = skippedStrides;
     this.processedStrides = processedStrides;
+    this.preloadedSplits = preloadedSplits;
+    this.preloadHits = preloadHits;
+    this.ioWaitNanos = ioWaitNanos;
+    this.readAheadBytes = readAheadBytes;
+    this.ramReadBytes = ramReadBytes;
+    this.localReadBytes = localReadBytes;
+    this.storageReadBytes = storageReadBytes;
   }
 }
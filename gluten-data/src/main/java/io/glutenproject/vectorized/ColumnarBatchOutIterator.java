@@ -25,10 +25,22 @@ import java.io.IOException;
 
 public class ColumnarBatchOutIterator extends GeneralOutIterator {
   private final long handle;
+  // Batches fetched by nativeNextBatch and not yet returned, in [nextBatch, numBatches).
+  private final long[] batchHandles;
+  private final long maxBytesPerCall;
+  private int nextBatch = 0;
+  private int numBatches = 0;
 
   public ColumnarBatchOutIterator(long handle) throws IOException {
+    this(handle, 1, 0);
+  }
+
+  public ColumnarBatchOutIterator(long handle, int batchesPerCall, long maxBytesPerCall)
+      throws IOException {
     super();
     this.handle = handle;
+    this.batchHandles = batchesPerCall > 1 ? new long[batchesPerCall] : null;
+    this.maxBytesPerCall = maxBytesPerCall;
   }
 
   @Override
@@ -41,6 +53,12 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator {
 
   private native long nativeNext(long nativeHandle);
 
+  // Fills batchHandles with up to batchHandles.length batches, stopping early once they hold
+  // maxBytes bytes if maxBytes > 0. Returns the number of batches, 0 if the stream ended.
+  private native int nativeNextBatch(long nativeHandle, long[] batchHandles, long maxBytes);
+
+  private native void nativeExportToArrowStream(long nativeHandle, long cStreamAddress);
+
   private native long nativeSpill(long nativeHandle, long size);
 
   private native void nativeClose(long nativeHandle);
@@ -49,16 +67,30 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator {
 
   @Override
   public boolean hasNextInternal() throws IOException {
+    if (nextBatch < numBatches) {
+      return true;
+    }
     return nativeHasNext(handle);
   }
 
   @Override
   public ColumnarBatch nextInternal() throws IOException {
-    long batchHandle = nativeNext(handle);
-    if (batchHandle == -1L) {
-      return null; // stream ended
+    if (batchHandles == null) {
+      long batchHandle = nativeNext(handle);
+      if (batchHandle == -1L) {
+        return null; // stream ended
+      }
+      return ColumnarBatches.create(batchHandle);
     }
-    return ColumnarBatches.create(batchHandle);
+    if (nextBatch == numBatches) {
+      nextBatch = 0;
+      numBatches = nativeNextBatch(handle, batchHandles, maxBytesPerCall);
+      if (numBatches <= 0) {
+        numBatches = 0;
+        return null; // stream ended
+      }
+    }
+    return ColumnarBatches.create(batchHandles[nextBatch++]);
   }
 
   @Override
@@ -66,12 +98,28 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator {
     return nativeFetchMetrics(handle);
   }
 
+  /**
+   * Exports the remaining batches as an Arrow C stream to the ArrowArrayStream at the address, e.g.
+   * of org.apache.arrow.c.ArrowArrayStream, for consumers pulling them in native code. The stream
+   * takes over the batches, the iterator is only to be closed once the stream is released.
+   */
+  public void exportToArrowStream(long cStreamAddress) {
+    if (nextBatch < numBatches) {
+      throw new IllegalStateException("Batches were already fetched from the iterator");
+    }
+    nativeExportToArrowStream(handle, cStreamAddress);
+  }
+
   public long spill(long size) {
     return nativeSpill(handle, size);
   }
 
   @Override
   public void closeInternal() {
+    // Release the fetched batches never handed out, e.g. after a limit.
+    while (nextBatch < numBatches) {
+      ColumnarBatches.close(batchHandles[nextBatch++]);
+    }
     nativeClose(handle);
   }
 }
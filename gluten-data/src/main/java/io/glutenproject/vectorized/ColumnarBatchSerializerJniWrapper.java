@@ -27,10 +27,17 @@ public class ColumnarBatchSerializerJniWrapper extends JniInitialized {
 
   public native ColumnarBatchSerializeResult serialize(long[] handles, long allocId);
 
+  // |hasBounds|lowerBound|upperBound|nullCount| of each column of the batches, empty if the backend doesn't compute
+  // them. Floating point bounds are the bits of the double, timestamps are in microseconds.
+  public native long[] statistics(long[] handles, long allocId);
+
   // Return the native ColumnarBatchSerializer handle
   public native long init(long cSchema, long allocId);
 
   public native long deserialize(long handle, byte[] data);
 
+  // The batch is shared by the tasks of the executor deserializing the same key
+  public native long deserializeShared(long handle, String key, byte[] data);
+
   public native void close(long handle);
 }
@@ -110,7 +110,10 @@ public class NativePlanEvaluator {
   }
 
   private ColumnarBatchOutIterator createOutIterator(long nativeHandle) throws IOException {
-    return new ColumnarBatchOutIterator(nativeHandle);
+    return new ColumnarBatchOutIterator(
+        nativeHandle,
+        GlutenConfig.getConf().outIteratorBatchesPerCall(),
+        GlutenConfig.getConf().outIteratorBytesPerCall());
   }
 
   private byte[] getPlanBytesBuf(Plan planNode) {
@@ -18,6 +18,8 @@ package io.glutenproject.vectorized;
 
 public class ShuffleReaderMetrics {
   private long decompressTime;
+  private long hardwareDecompressedBytes;
+  private long softwareDecompressedBytes;
 
   public void setDecompressTime(long decompressTime) {
     this.decompressTime = decompressTime;
@@ -26,4 +28,20 @@ public class ShuffleReaderMetrics {
   public long getDecompressTime() {
     return decompressTime;
   }
+
+  public void setHardwareDecompressedBytes(long hardwareDecompressedBytes) {
+    this.hardwareDecompressedBytes = hardwareDecompressedBytes;
+  }
+
+  public long getHardwareDecompressedBytes() {
+    return hardwareDecompressedBytes;
+  }
+
+  public void setSoftwareDecompressedBytes(long softwareDecompressedBytes) {
+    this.softwareDecompressedBytes = softwareDecompressedBytes;
+  }
+
+  public long getSoftwareDecompressedBytes() {
+    return softwareDecompressedBytes;
+  }
 }
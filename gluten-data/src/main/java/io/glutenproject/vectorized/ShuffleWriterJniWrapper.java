@@ -16,7 +16,13 @@
  */
 package io.glutenproject.vectorized;
 
+import io.glutenproject.columnarbatch.ColumnarBatches;
 import io.glutenproject.init.JniInitialized;
+import io.glutenproject.memory.arrowalloc.ArrowBufferAllocators;
+
+import org.apache.spark.sql.catalyst.InternalRow;
+import org.apache.spark.sql.types.*;
+import org.apache.spark.sql.vectorized.ColumnarBatch;
 
 import java.io.IOException;
 
@@ -54,9 +60,8 @@ public class ShuffleWriterJniWrapper extends JniInitialized {
       boolean writeEOS,
       long handle,
       long taskAttemptId) {
-    return nativeMake(
-        part.getShortName(),
-        part.getNumPartitions(),
+    return make(
+        part,
         offheapPerTask,
         bufferSize,
         codec,
@@ -97,9 +102,8 @@ public class ShuffleWriterJniWrapper extends JniInitialized {
       long handle,
       long taskAttemptId,
       String partitionWriterType) {
-    return nativeMake(
-        part.getShortName(),
-        part.getNumPartitions(),
+    return make(
+        part,
         offheapPerTask,
         bufferSize,
         codec,
@@ -119,9 +123,118 @@ public class ShuffleWriterJniWrapper extends JniInitialized {
         partitionWriterType);
   }
 
+  private long make(
+      NativePartitioning part,
+      long offheapPerTask,
+      int bufferSize,
+      String codec,
+      String codecBackend,
+      int bufferCompressThreshold,
+      String dataFile,
+      int subDirsPerLocalDir,
+      String localDirs,
+      boolean preferEvict,
+      long memoryPoolId,
+      boolean writeSchema,
+      boolean writeEOS,
+      long handle,
+      long taskAttemptId,
+      int pushBufferMaxSize,
+      Object pusher,
+      String partitionWriterType) {
+    RangePartitionBounds rangeBounds = part.getRangePartitionBounds();
+    ColumnarBatch rangeBoundsBatch = null;
+    if (rangeBounds != null) {
+      rangeBoundsBatch = offloadRangeBounds(rangeBounds);
+    }
+    try {
+      return nativeMake(
+          part.getShortName(),
+          part.getNumPartitions(),
+          part.getHashPartitionKeyIds(),
+          rangeBoundsBatch == null ? -1L : ColumnarBatches.getNativeHandle(rangeBoundsBatch),
+          rangeBounds == null ? null : rangeBounds.getKeyIds(),
+          rangeBounds == null ? null : rangeBounds.getAscending(),
+          rangeBounds == null ? null : rangeBounds.getNullsFirst(),
+          offheapPerTask,
+          bufferSize,
+          codec,
+          codecBackend,
+          bufferCompressThreshold,
+          dataFile,
+          subDirsPerLocalDir,
+          localDirs,
+          preferEvict,
+          memoryPoolId,
+          writeSchema,
+          writeEOS,
+          handle,
+          taskAttemptId,
+          pushBufferMaxSize,
+          pusher,
+          partitionWriterType);
+    } finally {
+      // The writer keeps its own reference to the bounds.
+      if (rangeBoundsBatch != null) {
+        ColumnarBatches.release(rangeBoundsBatch);
+      }
+    }
+  }
+
+  /** Offloads the sampled bounds of a range partitioning as a native batch. */
+  private static ColumnarBatch offloadRangeBounds(RangePartitionBounds rangeBounds) {
+    StructType schema = rangeBounds.getSchema();
+    InternalRow[] bounds = rangeBounds.getBounds();
+    ArrowWritableColumnVector[] vectors =
+        ArrowWritableColumnVector.allocateColumns(bounds.length, schema);
+    for (int i = 0; i < vectors.length; i++) {
+      DataType type = schema.fields()[i].dataType();
+      ArrowWritableColumnVector vector = vectors[i];
+      for (InternalRow bound : bounds) {
+        if (bound.isNullAt(i)) {
+          vector.appendNull();
+        } else if (type instanceof BooleanType) {
+          vector.appendBoolean(bound.getBoolean(i));
+        } else if (type instanceof ByteType) {
+          vector.appendByte(bound.getByte(i));
+        } else if (type instanceof ShortType) {
+          vector.appendShort(bound.getShort(i));
+        } else if (type instanceof IntegerType || type instanceof DateType) {
+          vector.appendInt(bound.getInt(i));
+        } else if (type instanceof LongType || type instanceof TimestampType) {
+          vector.appendLong(bound.getLong(i));
+        } else if (type instanceof FloatType) {
+          vector.appendFloat(bound.getFloat(i));
+        } else if (type instanceof DoubleType) {
+          vector.appendDouble(bound.getDouble(i));
+        } else if (type instanceof StringType) {
+          byte[] bytes = bound.getUTF8String(i).getBytes();
+          vector.appendString(bytes, 0, bytes.length);
+        } else if (type instanceof BinaryType) {
+          byte[] bytes = bound.getBinary(i);
+          vector.appendString(bytes, 0, bytes.length);
+        } else if (type instanceof DecimalType) {
+          DecimalType decimalType = (DecimalType) type;
+          vector.appendDecimal(
+              bound.getDecimal(i, decimalType.precision(), decimalType.scale()).toJavaBigDecimal());
+        } else {
+          throw new UnsupportedOperationException("Unsupported range partition key type " + type);
+        }
+      }
+      vector.setValueCount(bounds.length);
+    }
+    return ColumnarBatches.ensureOffloaded(
+        ArrowBufferAllocators.contextInstance(), new ColumnarBatch(vectors, bounds.length));
+  }
+
   public native long nativeMake(
       String shortName,
       int numPartitions,
+      int[] hashPartitionKeyIds,
+      long rangeBoundsHandle,
+      int[] rangePartitionKeyIds,
+      boolean[] rangePartitionAscending,
+      boolean[] rangePartitionNullsFirst,
       long offheapPerTask,
       int bufferSize,
       String codec,
@@ -48,6 +48,13 @@ class BatchScanMetricsUpdater(val metrics: Map[String, SQLMetric]) extends Metri
       metrics("processedSplits") += operatorMetrics.processedSplits
       metrics("skippedStrides") += operatorMetrics.skippedStrides
       metrics("processedStrides") += operatorMetrics.processedStrides
+      metrics("preloadedSplits") += operatorMetrics.preloadedSplits
+      metrics("preloadHits") += operatorMetrics.preloadHits
+      metrics("ioWaitNanos") += operatorMetrics.ioWaitNanos
+      metrics("readAheadBytes") += operatorMetrics.readAheadBytes
+      metrics("ramReadBytes") += operatorMetrics.ramReadBytes
+      metrics("localReadBytes") += operatorMetrics.localReadBytes
+      metrics("storageReadBytes") += operatorMetrics.storageReadBytes
     }
   }
 }
@@ -43,6 +43,13 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
   val processedSplits: SQLMetric = metrics("processedSplits")
   val skippedStrides: SQLMetric = metrics("skippedStrides")
   val processedStrides: SQLMetric = metrics("processedStrides")
+  val preloadedSplits: SQLMetric = metrics("preloadedSplits")
+  val preloadHits: SQLMetric = metrics("preloadHits")
+  val ioWaitNanos: SQLMetric = metrics("ioWaitNanos")
+  val readAheadBytes: SQLMetric = metrics("readAheadBytes")
+  val ramReadBytes: SQLMetric = metrics("ramReadBytes")
+  val localReadBytes: SQLMetric = metrics("localReadBytes")
+  val storageReadBytes: SQLMetric = metrics("storageReadBytes")
 
   override def updateInputMetrics(inputMetrics: InputMetricsWrapper): Unit = {
     inputMetrics.bridgeIncBytesRead(rawInputBytes.value)
@@ -68,6 +75,13 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
       processedSplits += operatorMetrics.processedSplits
       skippedStrides += operatorMetrics.skippedStrides
       processedStrides += operatorMetrics.processedStrides
+      preloadedSplits += operatorMetrics.preloadedSplits
+      preloadHits += operatorMetrics.preloadHits
+      ioWaitNanos += operatorMetrics.ioWaitNanos
+      readAheadBytes += operatorMetrics.readAheadBytes
+      ramReadBytes += operatorMetrics.ramReadBytes
+      localReadBytes += operatorMetrics.localReadBytes
+      storageReadBytes += operatorMetrics.storageReadBytes
     }
   }
 }
@@ -40,6 +40,7 @@ class HashAggregateMetricsUpdaterImpl(val metrics: Map[String, SQLMetric])
   val aggSpilledPartitions: SQLMetric = metrics("aggSpilledPartitions")
   val aggSpilledFiles: SQLMetric = metrics("aggSpilledFiles")
   val flushRowCount: SQLMetric = metrics("flushRowCount")
+  val abandonedPartialAggregation: SQLMetric = metrics("abandonedPartialAggregation")
 
   val preProjectionCpuCount: SQLMetric = metrics("preProjectionCpuCount")
   val preProjectionWallNanos: SQLMetric = metrics("preProjectionWallNanos")
@@ -82,6 +83,7 @@ class HashAggregateMetricsUpdaterImpl(val metrics: Map[String, SQLMetric])
     aggSpilledPartitions += aggMetrics.spilledPartitions
     aggSpilledFiles += aggMetrics.spilledFiles
     flushRowCount += aggMetrics.flushRowCount
+    abandonedPartialAggregation += aggMetrics.abandonedPartialAggregation
     idx += 1
 
     if (aggParams.preProjectionNeeded) {
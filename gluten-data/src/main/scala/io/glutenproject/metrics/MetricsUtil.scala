@@ -102,11 +102,19 @@ object MetricsUtil extends Logging {
     var numDynamicFiltersAccepted: Long = 0
     var numReplacedWithDynamicFilterRows: Long = 0
     var flushRowCount: Long = 0
+    var abandonedPartialAggregation: Long = 0
     var scanTime: Long = 0
     var skippedSplits: Long = 0
     var processedSplits: Long = 0
     var skippedStrides: Long = 0
     var processedStrides: Long = 0
+    var preloadedSplits: Long = 0
+    var preloadHits: Long = 0
+    var ioWaitNanos: Long = 0
+    var readAheadBytes: Long = 0
+    var ramReadBytes: Long = 0
+    var localReadBytes: Long = 0
+    var storageReadBytes: Long = 0
 
     val metricsIterator = operatorMetrics.iterator()
     while (metricsIterator.hasNext) {
@@ -123,11 +131,19 @@ object MetricsUtil extends Logging {
       numDynamicFiltersAccepted += metrics.numDynamicFiltersAccepted
       numReplacedWithDynamicFilterRows += metrics.numReplacedWithDynamicFilterRows
       flushRowCount += metrics.flushRowCount
+      abandonedPartialAggregation += metrics.abandonedPartialAggregation
       scanTime += metrics.scanTime
       skippedSplits += metrics.skippedSplits
       processedSplits += metrics.processedSplits
       skippedStrides += metrics.skippedStrides
       processedStrides += metrics.processedStrides
+      preloadedSplits += metrics.preloadedSplits
+      preloadHits += metrics.preloadHits
+      ioWaitNanos += metrics.ioWaitNanos
+      readAheadBytes += metrics.readAheadBytes
+      ramReadBytes += metrics.ramReadBytes
+      localReadBytes += metrics.localReadBytes
+      storageReadBytes += metrics.storageReadBytes
     }
 
     new OperatorMetrics(
@@ -151,11 +167,19 @@ object MetricsUtil extends Logging {
       numDynamicFiltersAccepted,
       numReplacedWithDynamicFilterRows,
       flushRowCount,
+      abandonedPartialAggregation,
       scanTime,
       skippedSplits,
       processedSplits,
       skippedStrides,
-      processedStrides
+      processedStrides,
+      preloadedSplits,
+      preloadHits,
+      ioWaitNanos,
+      readAheadBytes,
+      ramReadBytes,
+      localReadBytes,
+      storageReadBytes
     )
   }
 
@@ -45,7 +45,9 @@ class ColumnarBatchSerializer(
     schema: StructType,
     readBatchNumRows: SQLMetric,
     numOutputRows: SQLMetric,
-    decompressTime: SQLMetric)
+    decompressTime: SQLMetric,
+    hardwareDecompressedBytes: SQLMetric,
+    softwareDecompressedBytes: SQLMetric)
   extends Serializer
   with Serializable {
 
@@ -56,7 +58,13 @@ class ColumnarBatchSerializer(
 
   /** Creates a new [[SerializerInstance]]. */
   override def newInstance(): SerializerInstance = {
-    new ColumnarBatchSerializerInstance(schema, readBatchNumRows, numOutputRows, decompressTime)
+    new ColumnarBatchSerializerInstance(
+      schema,
+      readBatchNumRows,
+      numOutputRows,
+      decompressTime,
+      hardwareDecompressedBytes,
+      softwareDecompressedBytes)
   }
 
   override def supportsRelocationOfSerializedObjects: Boolean = supportsRelocation
@@ -66,7 +74,9 @@ private class ColumnarBatchSerializerInstance(
     schema: StructType,
     readBatchNumRows: SQLMetric,
     numOutputRows: SQLMetric,
-    decompressTime: SQLMetric)
+    decompressTime: SQLMetric,
+    hardwareDecompressedBytes: SQLMetric,
+    softwareDecompressedBytes: SQLMetric)
   extends SerializerInstance
   with Logging {
 
@@ -172,6 +182,8 @@ private class ColumnarBatchSerializerInstance(
           // Collect Metrics
           ShuffleReaderJniWrapper.INSTANCE.populateMetrics(shuffleReaderHandle, readerMetrics)
           decompressTime += readerMetrics.getDecompressTime
+          hardwareDecompressedBytes += readerMetrics.getHardwareDecompressedBytes
+          softwareDecompressedBytes += readerMetrics.getSoftwareDecompressedBytes
           if (numBatchesTotal > 0) {
             readBatchNumRows.set(numRowsTotal.toDouble / numBatchesTotal)
           }
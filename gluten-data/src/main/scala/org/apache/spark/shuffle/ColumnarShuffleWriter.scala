@@ -191,8 +191,13 @@ class ColumnarShuffleWriter[K, V](
     writeMetrics.incBytesWritten(splitResult.getTotalBytesWritten)
     writeMetrics.incWriteTime(splitResult.getTotalWriteTime + splitResult.getTotalSpillTime)
 
+    splitResult.getSplitPhaseNames.zip(splitResult.getSplitPhaseTimes).foreach {
+      case (name, time) => dep.metrics.get(name).foreach(_.add(time))
+    }
+
     partitionLengths = splitResult.getPartitionLengths
     rawPartitionLengths = splitResult.getRawPartitionLengths
+    reportPartitionSkew()
     try {
       shuffleBlockResolver.writeMetadataFileAndCommit(
         dep.shuffleId,
@@ -243,4 +248,30 @@ class ColumnarShuffleWriter[K, V](
 
   def getPartitionLengths: Array[Long] = partitionLengths
 
+  // Max and median bytes of the non-empty partitions of this map task, and its heaviest partitions
+  // once the max is SKEW_FACTOR times the median.
+  private def reportPartitionSkew(): Unit = {
+    val nonEmpty = partitionLengths.zipWithIndex.filter(_._1 > 0)
+    if (nonEmpty.nonEmpty) {
+      val sorted = nonEmpty.map(_._1).sorted
+      val median = sorted(sorted.length / 2)
+      val max = sorted.last
+      dep.metrics.get("maxPartitionBytes").foreach(_.add(max))
+      dep.metrics.get("medianPartitionBytes").foreach(_.add(median))
+      if (max >= ColumnarShuffleWriter.SKEW_FACTOR * median) {
+        val heaviest = nonEmpty
+          .sortBy(-_._1)
+          .take(ColumnarShuffleWriter.TOP_K_PARTITIONS)
+          .map { case (bytes, pid) => s"$pid: ${Utils.bytesToString(bytes)}" }
+        logInfo(
+          s"Skewed partitions of shuffle ${dep.shuffleId} map $mapId, median " +
+            s"${Utils.bytesToString(median)}, heaviest ${heaviest.mkString(", ")}")
+      }
+    }
+  }
+}
+
+object ColumnarShuffleWriter {
+  private val SKEW_FACTOR = 5
+  private val TOP_K_PARTITIONS = 5
 }
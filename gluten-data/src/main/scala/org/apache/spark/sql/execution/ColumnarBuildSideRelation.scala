@@ -35,6 +35,8 @@ import org.apache.spark.util.TaskResources
 
 import org.apache.arrow.c.ArrowSchema
 
+import java.util.UUID
+
 import scala.collection.JavaConverters.asScalaIteratorConverter
 
 case class ColumnarBuildSideRelation(
@@ -43,6 +45,9 @@ case class ColumnarBuildSideRelation(
     batches: Array[Array[Byte]])
   extends BuildSideRelation {
 
+  // Identifies the batches of this relation that the tasks of an executor share once deserialized.
+  private val relationId: String = UUID.randomUUID().toString
+
   override def deserialized: Iterator[ColumnarBatch] = {
     new Iterator[ColumnarBatch] {
       var batchId = 0
@@ -78,8 +83,8 @@ case class ColumnarBuildSideRelation(
       }
 
       override def next: ColumnarBatch = {
-        val handle =
-          ColumnarBatchSerializerJniWrapper.INSTANCE.deserialize(serializeHandle, batches(batchId))
+        val handle = ColumnarBatchSerializerJniWrapper.INSTANCE
+          .deserializeShared(serializeHandle, s"$relationId-$batchId", batches(batchId))
         if (batchId == batches.length - 1) {
           finalBatch = handle
         }
@@ -19,24 +19,24 @@ package org.apache.spark.sql.execution.utils
 import io.glutenproject.columnarbatch.ColumnarBatches
 import io.glutenproject.memory.alloc.NativeMemoryAllocators
 import io.glutenproject.memory.arrowalloc.ArrowBufferAllocators
-import io.glutenproject.vectorized.{ArrowWritableColumnVector, NativeColumnarToRowInfo, NativeColumnarToRowJniWrapper, NativePartitioning}
+import io.glutenproject.vectorized.{ArrowWritableColumnVector, NativeColumnarToRowInfo, NativeColumnarToRowJniWrapper, NativePartitioning, RangePartitionBounds}
 
-import org.apache.spark.{Partitioner, RangePartitioner, ShuffleDependency}
+import org.apache.spark.{RangePartitioner, ShuffleDependency}
 import org.apache.spark.internal.Logging
 import org.apache.spark.rdd.RDD
 import org.apache.spark.serializer.Serializer
 import org.apache.spark.shuffle.ColumnarShuffleDependency
 import org.apache.spark.sql.catalyst.InternalRow
-import org.apache.spark.sql.catalyst.expressions.{Attribute, BoundReference, UnsafeProjection, UnsafeRow}
+import org.apache.spark.sql.catalyst.expressions.{Attribute, AttributeReference, BindReferences, BoundReference, Expression, NullsFirst, SortOrder, UnsafeProjection, UnsafeRow}
 import org.apache.spark.sql.catalyst.expressions.codegen.LazilyGeneratedOrdering
 import org.apache.spark.sql.catalyst.plans.physical._
 import org.apache.spark.sql.execution.PartitionIdPassthrough
 import org.apache.spark.sql.execution.exchange.ShuffleExchangeExec
 import org.apache.spark.sql.execution.metric.SQLMetric
 import org.apache.spark.sql.internal.SQLConf
-import org.apache.spark.sql.types.{IntegerType, StructType}
+import org.apache.spark.sql.types._
 import org.apache.spark.sql.vectorized.{ColumnarBatch, ColumnVector}
-import org.apache.spark.util.{MutablePair, TaskResources}
+import org.apache.spark.util.TaskResources
 
 object ExecUtil {
 
@@ -82,39 +82,90 @@ object ExecUtil {
     }
   }
 
+  /** Whether the native shuffle writer hashes and orders keys of this type as Spark does. */
+  def isShuffleWriterKeyType(dataType: DataType): Boolean = dataType match {
+    case BooleanType | ByteType | ShortType | IntegerType | LongType | FloatType | DoubleType |
+        StringType | BinaryType | TimestampType | DateType | _: DecimalType =>
+      true
+    case _ => false
+  }
+
+  /**
+   * The bounds the partitioner sampled, for the shuffle writer to compute the partition ids with
+   * instead of the partitioner in the JVM. RangePartitioner keeps them private.
+   */
+  private def rangeBounds(partitioner: RangePartitioner[InternalRow, Null]): Array[InternalRow] = {
+    val field = classOf[RangePartitioner[_, _]].getDeclaredFields
+      .find(_.getName.endsWith("rangeBounds"))
+      .getOrElse(throw new IllegalStateException("RangePartitioner without range bounds"))
+    field.setAccessible(true)
+    field.get(partitioner).asInstanceOf[Array[InternalRow]]
+  }
+
   // scalastyle:off argcount
   def genShuffleDependency(
       rdd: RDD[ColumnarBatch],
       outputAttributes: Seq[Attribute],
+      projectOutputAttributes: Seq[Attribute],
       newPartitioning: Partitioning,
       serializer: Serializer,
       writeMetrics: Map[String, SQLMetric],
       metrics: Map[String, SQLMetric]): ShuffleDependency[Int, ColumnarBatch, ColumnarBatch] = {
     // scalastyle:on argcount
-    // only used for fallback range partitioning
-    val rangePartitioner: Option[Partitioner] = newPartitioning match {
+    // Ordinals of the keys in the shuffle input, if every key is one of its columns.
+    def keyOrdinals(keys: Seq[Expression]): Option[Seq[Int]] = {
+      val ordinals = keys.map {
+        case key: AttributeReference =>
+          BindReferences.bindReference(key, outputAttributes, allowFailures = true) match {
+            case BoundReference(ordinal, _, _) => Some(ordinal)
+            case _ => None
+          }
+        case _ => None
+      }
+      if (ordinals.forall(_.isDefined)) Some(ordinals.flatten) else None
+    }
+
+    // Ordinals of the range partitioning keys if the shuffle writer compares them with the bounds
+    val rangeKeyIds: Option[Seq[Int]] = newPartitioning match {
+      case RangePartitioning(sortingExpressions, _)
+          if sortingExpressions.forall(order => isShuffleWriterKeyType(order.dataType)) =>
+        keyOrdinals(sortingExpressions.map(_.child))
+      case _ => None
+    }
+
+    // Extract only fields used for sorting to avoid collecting large fields that does not
+    // affect sorting result when deciding partition bounds in RangePartitioner
+    def rangeKeysForSampling(sortingExpressions: Seq[SortOrder]): RDD[InternalRow] = {
+      rdd.mapPartitionsInternal {
+        iter =>
+          // Internally, RangePartitioner runs a job on the RDD that samples keys to compute
+          // partition bounds. To get accurate samples, we need to copy the mutable keys.
+          iter.flatMap(
+            batch => {
+              val rows = convertColumnarToRow(batch)
+              val projection =
+                UnsafeProjection.create(sortingExpressions.map(_.child), outputAttributes)
+              rows.map(row => projection(row).copy())
+            })
+      }
+    }
+
+    // Construct ordering on extracted sort key.
+    def rangeKeysOrdering(sortingExpressions: Seq[SortOrder]): Ordering[InternalRow] = {
+      val orderingAttributes = sortingExpressions.zipWithIndex.map {
+        case (ord, i) =>
+          ord.copy(child = BoundReference(i, ord.dataType, ord.nullable))
+      }
+      new LazilyGeneratedOrdering(orderingAttributes)
+    }
+
+    // Computes the partition ids in the JVM for fallback range partitioning, and samples the bounds
+    // otherwise.
+    val rangePartitioner: Option[RangePartitioner[InternalRow, Null]] = newPartitioning match {
       case RangePartitioning(sortingExpressions, numPartitions) =>
-        // Extract only fields used for sorting to avoid collecting large fields that does not
-        // affect sorting result when deciding partition bounds in RangePartitioner
-        val rddForSampling = rdd.mapPartitionsInternal {
-          iter =>
-            // Internally, RangePartitioner runs a job on the RDD that samples keys to compute
-            // partition bounds. To get accurate samples, we need to copy the mutable keys.
-            iter.flatMap(
-              batch => {
-                val rows = convertColumnarToRow(batch)
-                val projection =
-                  UnsafeProjection.create(sortingExpressions.map(_.child), outputAttributes)
-                val mutablePair = new MutablePair[InternalRow, Null]()
-                rows.map(row => mutablePair.update(projection(row).copy(), null))
-              })
-        }
-        // Construct ordering on extracted sort key.
-        val orderingAttributes = sortingExpressions.zipWithIndex.map {
-          case (ord, i) =>
-            ord.copy(child = BoundReference(i, ord.dataType, ord.nullable))
-        }
-        implicit val ordering = new LazilyGeneratedOrdering(orderingAttributes)
+        val rddForSampling =
+          rangeKeysForSampling(sortingExpressions).map(key => (key, null))
+        implicit val ordering = rangeKeysOrdering(sortingExpressions)
         val part = new RangePartitioner(
           numPartitions,
           rddForSampling,
@@ -155,8 +206,28 @@ object ExecUtil {
         new NativePartitioning("single", 1)
       case RoundRobinPartitioning(n) =>
         new NativePartitioning("rr", n)
+      case HashPartitioning(exprs, n) if projectOutputAttributes == null =>
+        // No projection computed the hash, the shuffle writer hashes the key columns itself.
+        val keyIds = keyOrdinals(exprs).getOrElse(
+          throw new IllegalStateException(
+            s"Hash partitioning keys ${exprs.mkString(", ")} aren't columns of the shuffle input"))
+        new NativePartitioning(n, keyIds.toArray)
       case HashPartitioning(exprs, n) =>
         new NativePartitioning("hash", n)
+      case RangePartitioning(orders, n) if rangeKeyIds.isDefined =>
+        val bounds = rangeBounds(rangePartitioner.get)
+        new NativePartitioning(
+          n,
+          new RangePartitionBounds(
+            rangeKeyIds.get.toArray,
+            orders.map(_.isAscending).toArray,
+            orders.map(_.nullOrdering == NullsFirst).toArray,
+            StructType(orders.zipWithIndex.map {
+              case (order, i) => StructField(s"bound_$i", order.dataType, order.nullable)
+            }),
+            bounds
+          )
+        )
       // range partitioning fall back to row-based partition id computation
       case RangePartitioning(orders, n) =>
         new NativePartitioning("range", n)
@@ -172,7 +243,7 @@ object ExecUtil {
     val isOrderSensitive = isRoundRobin && !SQLConf.get.sortBeforeRepartition
 
     val rddWithDummyKey: RDD[Product2[Int, ColumnarBatch]] = newPartitioning match {
-      case RangePartitioning(sortingExpressions, _) =>
+      case RangePartitioning(sortingExpressions, _) if rangeKeyIds.isEmpty =>
         rdd.mapPartitionsWithIndexInternal(
           (_, cbIter) => {
             val partitionKeyExtractor: InternalRow => Any = {
@@ -67,6 +67,12 @@ class GlutenConfig(conf: SQLConf) extends Logging {
 
   def forceShuffledHashJoin: Boolean = conf.getConf(COLUMNAR_FPRCE_SHUFFLED_HASH_JOIN_ENABLED)
 
+  def shuffledHashJoinBuildSideSwapRatio: Double =
+    conf.getConf(COLUMNAR_SHUFFLED_HASH_JOIN_BUILD_SIDE_SWAP_RATIO)
+
+  def shuffledHashJoinBuildSideSwapMinBytes: Long =
+    conf.getConf(COLUMNAR_SHUFFLED_HASH_JOIN_BUILD_SIDE_SWAP_MIN_BYTES)
+
   def enableColumnarSortMergeJoin: Boolean = conf.getConf(COLUMNAR_SORTMERGEJOIN_ENABLED)
 
   def enableColumnarUnion: Boolean = conf.getConf(COLUMNAR_UNION_ENABLED)
@@ -142,6 +148,10 @@ class GlutenConfig(conf: SQLConf) extends Logging {
 
   def maxBatchSize: Int = conf.getConf(COLUMNAR_MAX_BATCH_SIZE)
 
+  def outIteratorBatchesPerCall: Int = conf.getConf(COLUMNAR_OUT_ITERATOR_BATCHES_PER_CALL)
+
+  def outIteratorBytesPerCall: Long = conf.getConf(COLUMNAR_OUT_ITERATOR_BYTES_PER_CALL)
+
   def enableColumnarLimit: Boolean = conf.getConf(COLUMNAR_LIMIT_ENABLED)
 
   def enableColumnarGenerate: Boolean = conf.getConf(COLUMNAR_GENERATE_ENABLED)
@@ -237,6 +247,11 @@ class GlutenConfig(conf: SQLConf) extends Logging {
   def enableVeloxUserExceptionStacktrace: Boolean =
     conf.getConf(COLUMNAR_VELOX_ENABLE_USER_EXCEPTION_STACKTRACE)
 
+  def enableVeloxBuildKeyFilterPushdown: Boolean =
+    conf.getConf(COLUMNAR_VELOX_BUILD_KEY_FILTER_PUSHDOWN)
+
+  def veloxBuildKeyFilterMaxValues: Int = conf.getConf(COLUMNAR_VELOX_BUILD_KEY_FILTER_MAX_VALUES)
+
   def debug: Boolean = conf.getConf(DEBUG_LEVEL_ENABLED)
   def taskStageId: Int = conf.getConf(BENCHMARK_TASK_STAGEID)
   def taskPartitionId: Int = conf.getConf(BENCHMARK_TASK_PARTITIONID)
@@ -246,6 +261,10 @@ class GlutenConfig(conf: SQLConf) extends Logging {
     conf.getConf(ENABLE_PARQUET_ROW_GROUP_MAX_MIN_INDEX)
 
   def enableNativeWriter: Boolean = conf.getConf(NATIVE_WRITER_ENABLED)
+
+  def nativeParquetWritePageIndex: Boolean = conf.getConf(NATIVE_PARQUET_WRITE_PAGE_INDEX)
+
+  def nativeWriterMaxFileBytes: Long = conf.getConf(NATIVE_WRITER_MAX_FILE_BYTES)
 }
 
 object GlutenConfig {
@@ -319,6 +338,13 @@ object GlutenConfig {
   // and then prefer to use the orginal target hosts to schedule
   val GLUTEN_SOFT_AFFINITY_MIN_TARGET_HOSTS = "spark.gluten.soft-affinity.min.target-hosts"
   val GLUTEN_SOFT_AFFINITY_MIN_TARGET_HOSTS_DEFAULT_VALUE = 1
+  // Prefer the executors which reported a file in their native cache for its splits
+  val GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED = "spark.gluten.soft-affinity.cache-aware.enabled"
+  val GLUTEN_SOFT_AFFINITY_CACHE_AWARE_ENABLED_DEFAULT_VALUE = false
+  // How often the executors report their cached files to the driver
+  val GLUTEN_SOFT_AFFINITY_CACHE_REPORT_INTERVAL =
+    "spark.gluten.soft-affinity.cache-aware.report-interval"
+  val GLUTEN_SOFT_AFFINITY_CACHE_REPORT_INTERVAL_DEFAULT_VALUE = "30s"
 
   // Pass through to native conf
   val GLUTEN_SAVE_DIR = "spark.gluten.saveDir"
@@ -329,6 +355,7 @@ object GlutenConfig {
 
   // Batch size.
   val GLUTEN_MAX_BATCH_SIZE_KEY = "spark.gluten.sql.columnar.maxBatchSize"
+  val GLUTEN_INPUT_PREFETCH_BATCHES_KEY = "spark.gluten.sql.columnar.inputPrefetchBatches"
 
   // Controls whether to load DLL from jars. User can get dependent native libs packed into a jar
   // by executing dev/package.sh. Then, with that jar configured, Gluten can load the native libs
@@ -389,6 +416,7 @@ object GlutenConfig {
       GLUTEN_SAVE_DIR,
       GLUTEN_TASK_OFFHEAP_SIZE_IN_BYTES_KEY,
       GLUTEN_MAX_BATCH_SIZE_KEY,
+      GLUTEN_INPUT_PREFETCH_BATCHES_KEY,
       SQLConf.SESSION_LOCAL_TIMEZONE.key
     )
     keys.forEach(
@@ -586,6 +614,24 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(true)
 
+  val COLUMNAR_SHUFFLED_HASH_JOIN_BUILD_SIDE_SWAP_RATIO =
+    buildConf("spark.gluten.sql.columnar.shuffledHashJoin.buildSideSwapRatio")
+      .doc(
+        "When both inputs of a shuffled inner hash join are materialized query stages, the " +
+          "build side is swapped with the streamed side if it is larger by this ratio. " +
+          "0 disables the swap.")
+      .doubleConf
+      .checkValue(_ >= 0, "The ratio must not be negative.")
+      .createWithDefault(2.0)
+
+  val COLUMNAR_SHUFFLED_HASH_JOIN_BUILD_SIDE_SWAP_MIN_BYTES =
+    buildConf("spark.gluten.sql.columnar.shuffledHashJoin.buildSideSwapMinBytes")
+      .doc(
+        "The build side of a shuffled inner hash join is only swapped if it is larger than " +
+          "this.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("64MB")
+
   val COLUMNAR_COLUMNAR_TO_ROW_ENABLED =
     buildConf("spark.gluten.sql.columnar.columnarToRow")
       .internal()
@@ -775,6 +821,37 @@ object GlutenConfig {
       .intConf
       .createWithDefault(4096)
 
+  val COLUMNAR_INPUT_PREFETCH_BATCHES =
+    buildConf(GLUTEN_INPUT_PREFETCH_BATCHES_KEY)
+      .internal()
+      .doc(
+        "Number of batches fetched ahead from each input iterator of a native pipeline on a " +
+          "background thread, so that the pipeline doesn't wait on e.g. shuffle fetches. The " +
+          "input iterator is then called from a thread without TaskContext. 0 disables it.")
+      .intConf
+      .checkValue(n => n >= 0, "Prefetched batches should be non-negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_OUT_ITERATOR_BATCHES_PER_CALL =
+    buildConf("spark.gluten.sql.columnar.outIterator.batchesPerCall")
+      .internal()
+      .doc(
+        "Max number of batches fetched from the native result iterator per JNI call. Larger " +
+          "values save JNI transitions for queries producing many small batches, at the cost of " +
+          "holding the fetched batches in memory until consumed.")
+      .intConf
+      .checkValue(n => n >= 1, "Batches per call should be at least 1")
+      .createWithDefault(1)
+
+  val COLUMNAR_OUT_ITERATOR_BYTES_PER_CALL =
+    buildConf("spark.gluten.sql.columnar.outIterator.bytesPerCall")
+      .internal()
+      .doc(
+        "Stop fetching batches from the native result iterator in a JNI call once they hold " +
+          "this many bytes. 0 means no limit.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("8MB")
+
   val COLUMNAR_LIMIT_ENABLED =
     buildConf("spark.gluten.sql.columnar.limit")
       .internal()
@@ -817,6 +894,24 @@ object GlutenConfig {
       .longConf
       .createWithDefault(100 * 1000 * 1000)
 
+  val NATIVE_PARQUET_WRITE_PAGE_INDEX =
+    buildConf("spark.gluten.sql.native.parquet.write.pageIndex")
+      .internal()
+      .doc(
+        "Whether the parquet files written need the column and offset indexes, which the native " +
+          "writers don't write, so such writes fall back to vanilla Spark.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val NATIVE_WRITER_MAX_FILE_BYTES =
+    buildConf("spark.gluten.sql.native.writer.maxFileBytes")
+      .internal()
+      .doc(
+        "The estimated encoded size the native writers roll to a new file at, so that skewed " +
+          "tasks write files of even sizes. 0 writes one file per partition of a task.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefault(0)
+
   val COLUMNAR_FALLBACK_POLICY =
     buildConf("spark.gluten.sql.columnar.fallback.policy")
       .internal()
@@ -1092,6 +1187,25 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(true)
 
+  val COLUMNAR_VELOX_BUILD_KEY_FILTER_PUSHDOWN =
+    buildConf("spark.gluten.sql.columnar.backend.velox.buildKeyFilterPushdown")
+      .internal()
+      .doc(
+        "Send the range and the values of the keys of a broadcast hash join build side with the " +
+          "join, to filter the scan of its probe side.")
+      .booleanConf
+      .createWithDefault(true)
+
+  val COLUMNAR_VELOX_BUILD_KEY_FILTER_MAX_VALUES =
+    buildConf("spark.gluten.sql.columnar.backend.velox.buildKeyFilterMaxValues")
+      .internal()
+      .doc(
+        "The maximum number of distinct build keys sent as a list of values, only the range of " +
+          "the keys being sent beyond it.")
+      .intConf
+      .checkValue(_ >= 0, "The maximum number of build key values must not be negative.")
+      .createWithDefault(1000)
+
   val TEXT_INPUT_ROW_MAX_BLOCK_SIZE =
     buildConf("spark.gluten.sql.text.input.max.block.size")
       .internal()
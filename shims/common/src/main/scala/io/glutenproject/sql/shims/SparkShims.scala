@@ -67,4 +67,7 @@ trait SparkShims {
 
   def filesGroupedToBuckets(
       selectedPartitions: Array[PartitionDirectory]): Map[Int, Array[PartitionedFile]]
+
+  // Milliseconds since the epoch the file was last modified, 0 if the Spark version doesn't tell.
+  def getModificationTime(file: PartitionedFile): Long
 }
@@ -0,0 +1,42 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.spark.sql.execution.datasources
+
+import org.apache.spark.TaskContext
+
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * The column statistics of the files written by the native writers, as the JSON their writers
+ * return on close, so that the stats trackers of the write needn't read the files again. Kept by
+ * file path until taken or the end of the task writing the file.
+ */
+object NativeFileStats {
+  private val stats = new ConcurrentHashMap[String, String]()
+
+  def put(filePath: String, json: String): Unit = {
+    if (json == null || json.isEmpty) {
+      return
+    }
+    stats.put(filePath, json)
+    Option(TaskContext.get()).foreach {
+      _.addTaskCompletionListener[Unit](_ => stats.remove(filePath))
+    }
+  }
+
+  def take(filePath: String): Option[String] = Option(stats.remove(filePath))
+}
@@ -88,4 +88,6 @@ class Spark32Shims extends SparkShims {
             .getOrElse(throw new IllegalStateException(s"Invalid bucket file ${f.filePath}"))
       }
   }
+
+  override def getModificationTime(file: PartitionedFile): Long = 0L
 }
@@ -113,6 +113,8 @@ class Spark33Shims extends SparkShims {
       }
   }
 
+  override def getModificationTime(file: PartitionedFile): Long = file.modificationTime
+
   private def invalidBucketFile(path: String): Throwable = {
     new SparkException(
       errorClass = "INVALID_BUCKET_FILE",
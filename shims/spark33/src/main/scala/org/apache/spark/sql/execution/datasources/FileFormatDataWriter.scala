@@ -16,6 +16,7 @@
  */
 package org.apache.spark.sql.execution.datasources
 
+import io.glutenproject.GlutenConfig
 import io.glutenproject.execution.datasource.GlutenRowSplitter
 
 import org.apache.spark.internal.Logging
@@ -57,6 +58,16 @@ abstract class FileFormatDataWriter(
   protected val updatedPartitions: mutable.Set[String] = mutable.Set[String]()
   protected var currentWriter: OutputWriter = _
 
+  /** The size the files of the native writers are rolled at, 0 if not rolled. */
+  protected val maxNativeFileBytes: Long = GlutenConfig.getConf.nativeWriterMaxFileBytes
+
+  /** Whether the file of the current native writer has reached maxNativeFileBytes. */
+  protected def isCurrentFileTooLarge: Boolean = currentWriter match {
+    case writer: NativeOutputWriter =>
+      maxNativeFileBytes > 0 && writer.writtenBytes() >= maxNativeFileBytes
+    case _ => false
+  }
+
   /** Trackers for computing various statistics on the data as it's being written out. */
   protected val statsTrackers: Seq[WriteTaskStatsTracker] =
     description.statsTrackers.map(_.newTaskInstance())
@@ -166,7 +177,10 @@ class SingleDirectoryDataWriter(
   }
 
   override def write(record: InternalRow): Unit = {
-    if (description.maxRecordsPerFile > 0 && recordsInFile >= description.maxRecordsPerFile) {
+    if (
+      (description.maxRecordsPerFile > 0 && recordsInFile >= description.maxRecordsPerFile) ||
+      isCurrentFileTooLarge
+    ) {
       fileCounter += 1
       assert(
         fileCounter < MAX_FILE_COUNTER,
@@ -382,8 +396,8 @@ class DynamicPartitionDataSingleWriter(
       fileCounter = 0
       renewCurrentWriter(currentPartitionValues, currentBucketId, closeCurrentWriter = true)
     } else if (
-      description.maxRecordsPerFile > 0 &&
-      recordsInFile >= description.maxRecordsPerFile
+      (description.maxRecordsPerFile > 0 &&
+        recordsInFile >= description.maxRecordsPerFile) || isCurrentFileTooLarge
     ) {
       renewCurrentWriterIfTooManyRecords(currentPartitionValues, currentBucketId)
     }